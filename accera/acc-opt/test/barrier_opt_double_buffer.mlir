@@ -0,0 +1,32 @@
+// RUN: acc-opt --verify-each=false --optimize-barriers %s | FileCheck %s
+
+// Each iteration writes one half of the double buffer while reading the other, so the barrier between the write and
+// the read is redundant. The barrier at the end of the iteration guards the reads against the writes of the next
+// iteration, which reuse the same half two iterations later, and stays.
+
+// CHECK-LABEL: gpu.func @double_buffer
+// CHECK: affine.for %[[K:[a-z0-9]+]] = 0 to 16 {
+// CHECK-NEXT: affine.load %arg0
+// CHECK-NEXT: affine.store %{{[0-9]+}}, %[[BUFFER:[0-9]+]][(%[[K]] + 1) mod 2, %{{[0-9]+}}] : memref<2x64xf32, 3>
+// CHECK-NEXT: affine.load %[[BUFFER]][%[[K]] mod 2, {{.*}}] : memref<2x64xf32, 3>
+// CHECK-NEXT: affine.store
+// CHECK-NEXT: "accv.barrier"() {scope = "Block"} : () -> ()
+// CHECK-NEXT: }
+// CHECK-NEXT: gpu.return
+module @test_double_buffer attributes {gpu.container_module} {
+  gpu.module @double_buffer_module {
+    gpu.func @double_buffer(%arg0: memref<16x64xf32>, %arg1: memref<16x64xf32>) kernel {
+      %tid = "gpu.thread_id"() {dimension = "x"} : () -> index
+      %buffer = memref.alloc() : memref<2x64xf32, 3>
+      affine.for %k = 0 to 16 {
+        %0 = affine.load %arg0[%k, %tid] : memref<16x64xf32>
+        affine.store %0, %buffer[(%k + 1) mod 2, %tid] : memref<2x64xf32, 3>
+        "accv.barrier"() {scope = "Block"} : () -> ()
+        %1 = affine.load %buffer[%k mod 2, 63 - %tid] : memref<2x64xf32, 3>
+        affine.store %1, %arg1[%k, %tid] : memref<16x64xf32>
+        "accv.barrier"() {scope = "Block"} : () -> ()
+      }
+      gpu.return
+    }
+  }
+}
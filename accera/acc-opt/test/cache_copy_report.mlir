@@ -0,0 +1,58 @@
+// RUN: acc-opt --cache-copy-report %s -o /dev/null 2>&1 | FileCheck %s
+
+// The fill reads and writes 16x16 floats, the zeroing writes 16 vectors of 8 floats, the size of the write back depends
+// on an argument, and the region that isn't a cache copy isn't reported
+
+// CHECK: "regions": [
+// CHECK-NEXT: {
+// CHECK-NEXT: "bytes": 2048,
+// CHECK-NEXT: "function": "test_cache_copy_report",
+// CHECK-NEXT: "kind": "fill",
+// CHECK-NEXT: "name": "test_cache_copy_report_cache0_fill"
+// CHECK-NEXT: },
+// CHECK-NEXT: {
+// CHECK-NEXT: "bytes": 512,
+// CHECK-NEXT: "function": "test_cache_copy_report",
+// CHECK-NEXT: "kind": "zero",
+// CHECK-NEXT: "name": "test_cache_copy_report_cache1_zero"
+// CHECK-NEXT: },
+// CHECK-NEXT: {
+// CHECK-NEXT: "bytes": null,
+// CHECK-NEXT: "function": "test_cache_copy_report",
+// CHECK-NEXT: "kind": "write_back",
+// CHECK-NEXT: "name": "test_cache_copy_report_cache2_write_back"
+// CHECK-NEXT: }
+// CHECK-NEXT: ]
+module @test_cache_copy_report {
+  accv.module "test_cache_copy_report" {
+    accv.func nested @test_cache_copy_report(%arg0: memref<16x16xf32>, %arg1: memref<16x128xf32>, %arg2: index) attributes {exec_target = 0 : i64} {
+      %cache = memref.alloc() : memref<16x16xf32, 3>
+      %acc = memref.alloc() : memref<16x8xf32, 3>
+      %zero = constant dense<0.0> : vector<8xf32>
+      "accv.enter_profile"() {accxp.cache_copy_region = "fill", regionName = "test_cache_copy_report_cache0_fill"} : () -> ()
+      affine.for %i = 0 to 16 {
+        affine.for %j = 0 to 16 {
+          %0 = affine.load %arg0[%i, %j] : memref<16x16xf32>
+          affine.store %0, %cache[%i, %j] : memref<16x16xf32, 3>
+        }
+      }
+      "accv.exit_profile"() {accxp.cache_copy_region = "fill", regionName = "test_cache_copy_report_cache0_fill"} : () -> ()
+      "accv.enter_profile"() {accxp.cache_copy_region = "zero", regionName = "test_cache_copy_report_cache1_zero"} : () -> ()
+      affine.for %i = 0 to 16 {
+        affine.vector_store %zero, %acc[%i, 0] : memref<16x8xf32, 3>, vector<8xf32>
+      }
+      "accv.exit_profile"() {accxp.cache_copy_region = "zero", regionName = "test_cache_copy_report_cache1_zero"} : () -> ()
+      "accv.enter_profile"() {accxp.cache_copy_region = "write_back", regionName = "test_cache_copy_report_cache2_write_back"} : () -> ()
+      affine.for %i = 0 to 16 {
+        affine.for %j = 0 to %arg2 {
+          %0 = affine.load %cache[%i, 0] : memref<16x16xf32, 3>
+          affine.store %0, %arg1[%i, %j] : memref<16x128xf32>
+        }
+      }
+      "accv.exit_profile"() {accxp.cache_copy_region = "write_back", regionName = "test_cache_copy_report_cache2_write_back"} : () -> ()
+      "accv.enter_profile"() {regionName = "test_cache_copy_report_compute"} : () -> ()
+      "accv.exit_profile"() {regionName = "test_cache_copy_report_compute"} : () -> ()
+      accv.return
+    }
+  }
+}
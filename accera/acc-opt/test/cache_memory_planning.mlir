@@ -0,0 +1,84 @@
+// RUN: acc-opt --plan-cache-memory -split-input-file %s | FileCheck %s
+
+// The caches of the two nests are never live at the same time, so they share the same arena offset
+
+// CHECK-LABEL: module @test_disjoint_cache_lifetimes
+// CHECK: "accv.global"() {accxp.cache_buffer, sym_name = "[[ARENA:cache_arena_[0-9]+]]", type = memref<1024xi8, 3>} : () -> ()
+// CHECK-NOT: "accv.global"
+// CHECK: accv.func nested @test_disjoint_cache_lifetimes
+// CHECK: %[[ARENA0:.*]] = "accv.ref_global"() {global_name = @[[ARENA]]} : () -> memref<1024xi8, 3>
+// CHECK-NEXT: %[[OFFSET0:.*]] = constant 0 : index
+// CHECK-NEXT: %[[CACHE0:.*]] = memref.view %[[ARENA0]][%[[OFFSET0]]][] : memref<1024xi8, 3> to memref<16x16xf32, 3>
+// CHECK: %[[ARENA1:.*]] = "accv.ref_global"() {global_name = @[[ARENA]]} : () -> memref<1024xi8, 3>
+// CHECK-NEXT: %[[OFFSET1:.*]] = constant 0 : index
+// CHECK-NEXT: %[[CACHE1:.*]] = memref.view %[[ARENA1]][%[[OFFSET1]]][] : memref<1024xi8, 3> to memref<16x16xf32, 3>
+// CHECK: affine.store %{{.*}}, %[[CACHE0]][%{{.*}}, %{{.*}}] : memref<16x16xf32, 3>
+// CHECK: affine.load %[[CACHE0]][%{{.*}}, %{{.*}}] : memref<16x16xf32, 3>
+// CHECK: affine.store %{{.*}}, %[[CACHE1]][%{{.*}}, %{{.*}}] : memref<16x16xf32, 3>
+// CHECK: affine.load %[[CACHE1]][%{{.*}}, %{{.*}}] : memref<16x16xf32, 3>
+module @test_disjoint_cache_lifetimes {
+  accv.module "test_disjoint_cache_lifetimes" {
+    "accv.global"() {accxp.cache_buffer, sym_name = "cache_0", type = memref<16x16xf32, 3>} : () -> ()
+    "accv.global"() {accxp.cache_buffer, sym_name = "cache_1", type = memref<16x16xf32, 3>} : () -> ()
+    accv.func nested @test_disjoint_cache_lifetimes(%arg0: memref<16x16xf32>, %arg1: memref<16x16xf32>) attributes {exec_target = 0 : i64} {
+      %0 = "accv.ref_global"() {global_name = @cache_0} : () -> memref<16x16xf32, 3>
+      %1 = "accv.ref_global"() {global_name = @cache_1} : () -> memref<16x16xf32, 3>
+      affine.for %arg2 = 0 to 16 {
+        affine.for %arg3 = 0 to 16 {
+          %2 = affine.load %arg0[%arg2, %arg3] : memref<16x16xf32>
+          affine.store %2, %0[%arg2, %arg3] : memref<16x16xf32, 3>
+        }
+      }
+      affine.for %arg2 = 0 to 16 {
+        affine.for %arg3 = 0 to 16 {
+          %2 = affine.load %0[%arg2, %arg3] : memref<16x16xf32, 3>
+          affine.store %2, %arg0[%arg2, %arg3] : memref<16x16xf32>
+        }
+      }
+      affine.for %arg2 = 0 to 16 {
+        affine.for %arg3 = 0 to 16 {
+          %2 = affine.load %arg1[%arg2, %arg3] : memref<16x16xf32>
+          affine.store %2, %1[%arg2, %arg3] : memref<16x16xf32, 3>
+        }
+      }
+      affine.for %arg2 = 0 to 16 {
+        affine.for %arg3 = 0 to 16 {
+          %2 = affine.load %1[%arg2, %arg3] : memref<16x16xf32, 3>
+          affine.store %2, %arg1[%arg2, %arg3] : memref<16x16xf32>
+        }
+      }
+      accv.return
+    }
+  }
+}
+
+// -----
+
+// The caches are used in the same outer loop, so the data of one could be read after the other is written
+
+// CHECK-LABEL: module @test_overlapping_cache_lifetimes
+// CHECK-NOT: cache_arena
+// CHECK: "accv.global"() {accxp.cache_buffer, sym_name = "cache_0", type = memref<16xf32, 3>} : () -> ()
+// CHECK: "accv.global"() {accxp.cache_buffer, sym_name = "cache_1", type = memref<16xf32, 3>} : () -> ()
+// CHECK-NOT: cache_arena
+module @test_overlapping_cache_lifetimes {
+  accv.module "test_overlapping_cache_lifetimes" {
+    "accv.global"() {accxp.cache_buffer, sym_name = "cache_0", type = memref<16xf32, 3>} : () -> ()
+    "accv.global"() {accxp.cache_buffer, sym_name = "cache_1", type = memref<16xf32, 3>} : () -> ()
+    accv.func nested @test_overlapping_cache_lifetimes(%arg0: memref<16x16xf32>, %arg1: memref<16x16xf32>) attributes {exec_target = 0 : i64} {
+      %0 = "accv.ref_global"() {global_name = @cache_0} : () -> memref<16xf32, 3>
+      %1 = "accv.ref_global"() {global_name = @cache_1} : () -> memref<16xf32, 3>
+      affine.for %arg2 = 0 to 16 {
+        affine.for %arg3 = 0 to 16 {
+          %2 = affine.load %arg0[%arg2, %arg3] : memref<16x16xf32>
+          affine.store %2, %0[%arg3] : memref<16xf32, 3>
+        }
+        affine.for %arg3 = 0 to 16 {
+          %2 = affine.load %1[%arg3] : memref<16xf32, 3>
+          affine.store %2, %arg1[%arg2, %arg3] : memref<16x16xf32>
+        }
+      }
+      accv.return
+    }
+  }
+}
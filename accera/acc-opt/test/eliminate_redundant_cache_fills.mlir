@@ -0,0 +1,103 @@
+// RUN: acc-opt --eliminate-redundant-cache-fills -split-input-file %s | FileCheck %s
+
+// The accumulators of the zero-filled cache are loaded once per element before the reduction loop, so they start from
+// zero instead and the fill is dead
+
+// CHECK-LABEL: func @zero_filled_accumulators
+// CHECK: %[[CACHE:.*]] = "accv.alloc"() : () -> memref<4x8xf32>
+// CHECK-NOT: affine.store %{{.*}}, %[[CACHE]]
+// CHECK: affine.for %{{.*}} = 0 to 4 {
+// CHECK-NEXT: affine.for %{{.*}} = 0 to 8 {
+// CHECK-NEXT: %[[ZERO:.*]] = constant 0.000000e+00 : f32
+// CHECK-NEXT: affine.for %{{.*}} = 0 to 16 iter_args(%{{.*}} = %[[ZERO]]) -> (f32) {
+module @test_zero_filled_accumulators {
+  func @zero_filled_accumulators(%arg0: memref<4x16xf32>, %arg1: memref<16x8xf32>, %arg2: memref<4x8xf32>) {
+    %cst = constant 0.000000e+00 : f32
+    %cache = "accv.alloc"() : () -> memref<4x8xf32>
+    affine.for %i = 0 to 4 {
+      affine.for %j = 0 to 8 {
+        affine.store %cst, %cache[%i, %j] : memref<4x8xf32>
+      }
+    }
+    affine.for %i = 0 to 4 {
+      affine.for %j = 0 to 8 {
+        %init = affine.load %cache[%i, %j] : memref<4x8xf32>
+        %sum = affine.for %k = 0 to 16 iter_args(%acc = %init) -> (f32) {
+          %a = affine.load %arg0[%i, %k] : memref<4x16xf32>
+          %b = affine.load %arg1[%k, %j] : memref<16x8xf32>
+          %prod = mulf %a, %b : f32
+          %next = addf %acc, %prod : f32
+          affine.yield %next : f32
+        }
+        affine.store %sum, %cache[%i, %j] : memref<4x8xf32>
+      }
+    }
+    affine.for %i = 0 to 4 {
+      affine.for %j = 0 to 8 {
+        %0 = affine.load %cache[%i, %j] : memref<4x8xf32>
+        %1 = affine.load %arg2[%i, %j] : memref<4x8xf32>
+        %2 = addf %0, %1 : f32
+        affine.store %2, %arg2[%i, %j] : memref<4x8xf32>
+      }
+    }
+    return
+  }
+}
+
+// -----
+
+// The kernel overwrites the cache in an unrolled loop, two columns at a time, before it reads it, so the copy into the
+// cache is dead
+
+// CHECK-LABEL: func @overwritten_copy
+// CHECK: %[[CACHE:.*]] = "accv.alloc"() : () -> memref<4x4xf32>
+// CHECK-NEXT: affine.for %[[I:.*]] = 0 to 4 {
+// CHECK-NEXT: affine.for %[[J:.*]] = 0 to 4 step 2 {
+// CHECK-NEXT: affine.store %{{.*}}, %[[CACHE]][%[[I]], %[[J]]]
+module @test_overwritten_copy {
+  func @overwritten_copy(%arg0: memref<4x4xf32>, %arg1: memref<4x4xf32>) {
+    %cst = constant 1.000000e+00 : f32
+    %cache = "accv.alloc"() : () -> memref<4x4xf32>
+    affine.for %i = 0 to 4 {
+      affine.for %j = 0 to 4 {
+        %0 = affine.load %arg0[%i, %j] : memref<4x4xf32>
+        affine.store %0, %cache[%i, %j] : memref<4x4xf32>
+      }
+    }
+    affine.for %i = 0 to 4 {
+      affine.for %j = 0 to 4 step 2 {
+        affine.store %cst, %cache[%i, %j] : memref<4x4xf32>
+        affine.store %cst, %cache[%i, %j + 1] : memref<4x4xf32>
+        %0 = affine.load %cache[%i, %j + 1] : memref<4x4xf32>
+        affine.store %0, %arg1[%i, %j] : memref<4x4xf32>
+      }
+    }
+    return
+  }
+}
+
+// -----
+
+// The kernel accumulates into the cache in every iteration of the reduction loop, which reads the zeros of the fill
+
+// CHECK-LABEL: func @accumulate_in_reduction_loop
+// CHECK: affine.store %{{.*}}, %{{.*}}[%{{.*}}] : memref<4xf32>
+// CHECK: affine.for %{{.*}} = 0 to 16 {
+module @test_accumulate_in_reduction_loop {
+  func @accumulate_in_reduction_loop(%arg0: memref<4x16xf32>) {
+    %cst = constant 0.000000e+00 : f32
+    %cache = "accv.alloc"() : () -> memref<4xf32>
+    affine.for %i = 0 to 4 {
+      affine.store %cst, %cache[%i] : memref<4xf32>
+    }
+    affine.for %i = 0 to 4 {
+      affine.for %k = 0 to 16 {
+        %0 = affine.load %cache[%i] : memref<4xf32>
+        %1 = affine.load %arg0[%i, %k] : memref<4x16xf32>
+        %2 = addf %0, %1 : f32
+        affine.store %2, %cache[%i] : memref<4xf32>
+      }
+    }
+    return
+  }
+}
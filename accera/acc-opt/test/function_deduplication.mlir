@@ -0,0 +1,46 @@
+// RUN: acc-opt --deduplicate-functions %s | FileCheck %s
+
+// The implementations only differ by name, so the second one is erased. The API functions then only differ by name
+// too, and the second one keeps its symbol and attributes but calls the first one.
+
+// CHECK-LABEL: module @test_function_deduplication
+// CHECK: func nested @variant_a_impl(%arg0: memref<16xf32>)
+// CHECK-NOT: func nested @variant_b_impl
+// CHECK: func @variant_a(%arg0: memref<16xf32>) attributes {accv.base_name = "variant", accv.emit_raw_pointer_api}
+// CHECK-NEXT: call @variant_a_impl(%arg0) : (memref<16xf32>) -> ()
+// CHECK: func @variant_b(%arg0: memref<16xf32>) attributes {accv.base_name = "variant", accv.emit_raw_pointer_api}
+// CHECK-NEXT: call @variant_a(%arg0) : (memref<16xf32>) -> ()
+// CHECK-NEXT: return
+// CHECK: func nested @variant_c_impl(%arg0: memref<16xf32>)
+// CHECK: mulf
+module @test_function_deduplication {
+  func nested @variant_a_impl(%arg0: memref<16xf32>) {
+    %c0 = constant 0 : index
+    %0 = memref.load %arg0[%c0] : memref<16xf32>
+    %1 = addf %0, %0 : f32
+    memref.store %1, %arg0[%c0] : memref<16xf32>
+    return
+  }
+  func @variant_a(%arg0: memref<16xf32>) attributes {accv.base_name = "variant", accv.emit_raw_pointer_api} {
+    call @variant_a_impl(%arg0) : (memref<16xf32>) -> ()
+    return
+  }
+  func nested @variant_b_impl(%arg0: memref<16xf32>) {
+    %c0 = constant 0 : index
+    %0 = memref.load %arg0[%c0] : memref<16xf32>
+    %1 = addf %0, %0 : f32
+    memref.store %1, %arg0[%c0] : memref<16xf32>
+    return
+  }
+  func @variant_b(%arg0: memref<16xf32>) attributes {accv.base_name = "variant", accv.emit_raw_pointer_api} {
+    call @variant_b_impl(%arg0) : (memref<16xf32>) -> ()
+    return
+  }
+  func nested @variant_c_impl(%arg0: memref<16xf32>) {
+    %c0 = constant 0 : index
+    %0 = memref.load %arg0[%c0] : memref<16xf32>
+    %1 = mulf %0, %0 : f32
+    memref.store %1, %arg0[%c0] : memref<16xf32>
+    return
+  }
+}
@@ -0,0 +1,47 @@
+// RUN: acc-opt --gpu-resource-report %s -o /dev/null 2>&1 | FileCheck %s
+
+// Consecutive threads along x read consecutive elements of a row of arg0, or consecutive vectors of 4 elements, and so
+// does the loop that starts at the thread id. The stores of arg1 are a column, 64 elements apart, and the loads in the
+// loop over k are every other row of arg0, 128 elements apart.
+
+// CHECK: "uncoalesced_accesses": [
+// CHECK-NEXT: {
+// CHECK-NEXT: "access": "store",
+// CHECK-NEXT: "array": "arg1",
+// CHECK-NEXT: "elements_per_access": 1,
+// CHECK-NEXT: "stride": 64,
+// CHECK-NEXT: "thread_dim": "x"
+// CHECK-NEXT: },
+// CHECK-NEXT: {
+// CHECK-NEXT: "access": "load",
+// CHECK-NEXT: "array": "arg0",
+// CHECK-NEXT: "elements_per_access": 1,
+// CHECK-NEXT: "stride": 128,
+// CHECK-NEXT: "thread_dim": "x"
+// CHECK-NEXT: }
+// CHECK-NEXT: ]
+module @test_uncoalesced_accesses attributes {gpu.container_module} {
+  gpu.module @test_uncoalesced_accesses_module {
+    gpu.func @test_uncoalesced_accesses(%arg0: memref<64x64xf32>, %arg1: memref<64x64xf32>) kernel attributes {blockSize = [16 : i32, 16 : i32, 1 : i32], gridSize = [4 : i32, 4 : i32, 1 : i32]} {
+      %c0 = constant 0 : index
+      %c2 = constant 2 : index
+      %c4 = constant 4 : index
+      %c16 = constant 16 : index
+      %c64 = constant 64 : index
+      %tx = "gpu.thread_id"() {dimension = "x"} : () -> index
+      %ty = "gpu.thread_id"() {dimension = "y"} : () -> index
+      %0 = memref.load %arg0[%ty, %tx] : memref<64x64xf32>
+      %1 = muli %tx, %c4 : index
+      %2 = vector.load %arg0[%ty, %1] : memref<64x64xf32>, vector<4xf32>
+      memref.store %0, %arg1[%tx, %ty] : memref<64x64xf32>
+      scf.for %i = %tx to %c64 step %c16 {
+        %3 = memref.load %arg0[%c0, %i] : memref<64x64xf32>
+      }
+      scf.for %k = %c0 to %c64 step %c4 {
+        %3 = muli %tx, %c2 : index
+        %4 = memref.load %arg0[%3, %k] : memref<64x64xf32>
+      }
+      gpu.return
+    }
+  }
+}
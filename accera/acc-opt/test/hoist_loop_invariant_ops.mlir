@@ -0,0 +1,48 @@
+// RUN: acc-opt --hoist-loop-invariant-ops -split-input-file %s | FileCheck %s
+
+// The scale only depends on the arguments and moves out of both loops, the offset only depends on %i and moves out of
+// the loop over %j
+
+// CHECK-LABEL: func @hoist_invariant_ops
+// CHECK-NEXT: %[[SCALE:.*]] = mulf %arg1, %arg1 : f32
+// CHECK-NEXT: affine.for %[[I:.*]] = 0 to 16 {
+// CHECK-NEXT: %[[INT:.*]] = index_cast %[[I]] : index to i32
+// CHECK-NEXT: %[[FLOAT:.*]] = sitofp %[[INT]] : i32 to f32
+// CHECK-NEXT: %[[OFFSET:.*]] = addf %[[SCALE]], %[[FLOAT]] : f32
+// CHECK-NEXT: affine.for %[[J:.*]] = 0 to 16 {
+// CHECK-NEXT: %[[VALUE:.*]] = affine.load %arg0[%[[I]], %[[J]]] : memref<16x16xf32>
+// CHECK-NEXT: %[[RESULT:.*]] = mulf %[[VALUE]], %[[OFFSET]] : f32
+// CHECK-NEXT: affine.store %[[RESULT]], %arg0[%[[I]], %[[J]]] : memref<16x16xf32>
+module @test_hoist_invariant_ops {
+  func @hoist_invariant_ops(%arg0: memref<16x16xf32>, %arg1: f32) {
+    affine.for %i = 0 to 16 {
+      affine.for %j = 0 to 16 {
+        %scale = mulf %arg1, %arg1 : f32
+        %int = index_cast %i : index to i32
+        %float = sitofp %int : i32 to f32
+        %offset = addf %scale, %float : f32
+        %value = affine.load %arg0[%i, %j] : memref<16x16xf32>
+        %result = mulf %value, %offset : f32
+        affine.store %result, %arg0[%i, %j] : memref<16x16xf32>
+      }
+    }
+    return
+  }
+}
+
+// -----
+
+// The loop may not run, so the division by a value that may be zero stays in it
+
+// CHECK-LABEL: func @keep_division_in_loop
+// CHECK-NEXT: affine.for
+// CHECK-NEXT: divi_signed %arg1, %arg2 : i32
+module @test_keep_division_in_loop {
+  func @keep_division_in_loop(%arg0: memref<?xi32>, %arg1: i32, %arg2: i32, %arg3: index) {
+    affine.for %k = 0 to %arg3 {
+      %quotient = divi_signed %arg1, %arg2 : i32
+      affine.store %quotient, %arg0[%k] : memref<?xi32>
+    }
+    return
+  }
+}
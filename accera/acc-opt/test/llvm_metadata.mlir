@@ -0,0 +1,33 @@
+// RUN: acc-opt --value-to-llvm %s | FileCheck %s
+
+// The branch back to the header of the loop tells LLVM not to unroll or interleave it again. The arguments of the
+// function don't alias, so the loads from one and the stores to the other are given different alias scopes that are
+// declared not to overlap
+
+// CHECK-LABEL: llvm.func @copy
+// CHECK: llvm.load %{{.*}} {alias_scopes = [@accera_alias_scopes::@copy_alias_scope_0], noalias_scopes = [@accera_alias_scopes::@copy_alias_scope_1]} : !llvm.ptr<f32>
+// CHECK: llvm.store %{{.*}}, %{{.*}} {alias_scopes = [@accera_alias_scopes::@copy_alias_scope_1], noalias_scopes = [@accera_alias_scopes::@copy_alias_scope_0]} : !llvm.ptr<f32>
+// CHECK: llvm.br ^bb1(%{{.*}} : i64) {llvm.loop = {options = #llvm.loopopts<disable_unroll = true, interleave_count = 1>}}
+// CHECK: llvm.metadata @accera_alias_scopes {
+// CHECK-NEXT: llvm.alias_scope_domain @copy_alias_domain
+// CHECK-NEXT: llvm.alias_scope @copy_alias_scope_0 {domain = @copy_alias_domain}
+// CHECK-NEXT: llvm.alias_scope @copy_alias_scope_1 {domain = @copy_alias_domain}
+// CHECK-NEXT: llvm.return
+module @test_llvm_metadata {
+  func @copy(%arg0: memref<16xf32>, %arg1: memref<16xf32>) attributes {accv.no_alias} {
+    %c0 = constant 0 : index
+    %c1 = constant 1 : index
+    %c16 = constant 16 : index
+    br ^bb1(%c0 : index)
+  ^bb1(%i: index):
+    %cond = cmpi slt, %i, %c16 : index
+    cond_br %cond, ^bb2, ^bb3
+  ^bb2:
+    %v = memref.load %arg0[%i] : memref<16xf32>
+    memref.store %v, %arg1[%i] : memref<16xf32>
+    %next = addi %i, %c1 : index
+    br ^bb1(%next : index)
+  ^bb3:
+    return
+  }
+}
@@ -0,0 +1,37 @@
+// RUN: acc-opt --memory-traffic-instrumentation %s | FileCheck %s
+
+// Each block counts the bytes it moves once per array, the cache is named by the attribute of its allocation and
+// the other buffers by the order they're accessed in
+
+// CHECK-LABEL: accv.func nested @test_memory_traffic_instrumentation
+// CHECK: affine.for
+// CHECK-NEXT: affine.for
+// CHECK-NEXT: "accv.count_memory_traffic"() {arrayName = "test_memory_traffic_instrumentation:arg0", loadedBytes = 4 : i64, storedBytes = 0 : i64} : () -> ()
+// CHECK-NEXT: "accv.count_memory_traffic"() {arrayName = "test_memory_traffic_instrumentation:cache0", loadedBytes = 0 : i64, storedBytes = 4 : i64} : () -> ()
+// CHECK: affine.for
+// CHECK-NEXT: "accv.count_memory_traffic"() {arrayName = "test_memory_traffic_instrumentation:cache0", loadedBytes = 64 : i64, storedBytes = 0 : i64} : () -> ()
+// CHECK-NEXT: "accv.count_memory_traffic"() {arrayName = "test_memory_traffic_instrumentation:buffer0", loadedBytes = 32 : i64, storedBytes = 32 : i64} : () -> ()
+// CHECK-NEXT: "accv.count_memory_traffic"() {arrayName = "test_memory_traffic_instrumentation:arg1", loadedBytes = 0 : i64, storedBytes = 32 : i64} : () -> ()
+module @test_memory_traffic_instrumentation {
+  accv.module "test_memory_traffic_instrumentation" {
+    accv.func nested @test_memory_traffic_instrumentation(%arg0: memref<16x16xf32>, %arg1: memref<16x8xf32>) attributes {exec_target = 0 : i64} {
+      %cache = memref.alloc() {accxp.cache_buffer} : memref<16x16xf32, 3>
+      %acc = memref.alloc() : memref<16x8xf32>
+      affine.for %i = 0 to 16 {
+        affine.for %j = 0 to 16 {
+          %0 = affine.load %arg0[%i, %j] : memref<16x16xf32>
+          affine.store %0, %cache[%i, %j] : memref<16x16xf32, 3>
+        }
+      }
+      affine.for %i = 0 to 16 {
+        %0 = affine.vector_load %cache[%i, 0] : memref<16x16xf32, 3>, vector<16xf32>
+        %1 = affine.vector_load %acc[%i, 0] : memref<16x8xf32>, vector<8xf32>
+        %2 = vector.extract_strided_slice %0 {offsets = [0], sizes = [8], strides = [1]} : vector<16xf32> to vector<8xf32>
+        %3 = addf %1, %2 : vector<8xf32>
+        affine.vector_store %3, %acc[%i, 0] : memref<16x8xf32>, vector<8xf32>
+        affine.vector_store %3, %arg1[%i, 0] : memref<16x8xf32>, vector<8xf32>
+      }
+      accv.return
+    }
+  }
+}
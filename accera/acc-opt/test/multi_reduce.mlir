@@ -0,0 +1,35 @@
+// RUN: acc-opt --convert-value-to-std-function %s | FileCheck %s
+
+// The sum and the sum of squares of a vector are computed in a single loop over it, which reduces 4 interleaved lanes
+// of both values. The lanes are combined pairwise after the loop, and the 2 elements left over go into the combined
+// values.
+
+// CHECK-LABEL: func @sum_and_sum_of_squares
+// CHECK: %[[LANES:.*]]:8 = scf.for %[[I:.*]] = %{{.*}} to %{{.*}} step %{{.*}} iter_args({{.*}}) -> (f32, f32, f32, f32, f32, f32, f32, f32) {
+// CHECK: memref.load %arg0[%[[I]]] : memref<10xf32>
+// CHECK-COUNT-3: memref.load %arg0[%{{.*}}] : memref<10xf32>
+// CHECK: scf.yield {{.*}} : f32, f32, f32, f32, f32, f32, f32, f32
+// CHECK-NEXT: }
+// CHECK-DAG: addf %[[LANES]]#0, %[[LANES]]#2 : f32
+// CHECK-DAG: addf %[[LANES]]#1, %[[LANES]]#3 : f32
+// CHECK-DAG: addf %[[LANES]]#4, %[[LANES]]#6 : f32
+// CHECK-DAG: addf %[[LANES]]#5, %[[LANES]]#7 : f32
+// CHECK-COUNT-2: memref.load %arg0[%{{.*}}] : memref<10xf32>
+// CHECK-NOT: accv.multi_reduce
+// CHECK: return
+func @sum_and_sum_of_squares(%arg0: memref<10xf32>) -> (f32, f32) {
+  %zero = constant 0.0 : f32
+  %0:2 = "accv.multi_reduce"(%arg0, %zero, %zero) ( {
+  ^bb0(%a: f32, %sum: f32, %sumSquares: f32):
+    %1 = addf %sum, %a : f32
+    %2 = mulf %a, %a : f32
+    %3 = addf %sumSquares, %2 : f32
+    "accv.yield"(%1, %3) : (f32, f32) -> ()
+  },  {
+  ^bb0(%lhsSum: f32, %lhsSumSquares: f32, %rhsSum: f32, %rhsSumSquares: f32):
+    %1 = addf %lhsSum, %rhsSum : f32
+    %2 = addf %lhsSumSquares, %rhsSumSquares : f32
+    "accv.yield"(%1, %2) : (f32, f32) -> ()
+  }) {lanes = 4 : i64} : (memref<10xf32>, f32, f32) -> (f32, f32)
+  return %0#0, %0#1 : f32, f32
+}
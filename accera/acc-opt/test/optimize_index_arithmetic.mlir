@@ -0,0 +1,45 @@
+// RUN: acc-opt --optimize-index-arithmetic -split-input-file %s | FileCheck %s
+
+// The index of a split loop composed back into the index it was split from divides and takes the modulo by the split
+// size, which the ranges of the loop indices decide
+
+// CHECK-LABEL: func @split_index_divisions
+// CHECK: affine.for %[[I:.*]] = 0 to 4 {
+// CHECK-NEXT: affine.for %[[II:.*]] = 0 to 4 {
+// CHECK-NEXT: affine.load %arg0[%[[I]], %[[II]]] : memref<4x4xf32>
+module @test_split_index_divisions {
+  func @split_index_divisions(%arg0: memref<4x4xf32>, %arg1: memref<4x4xf32>) {
+    affine.for %i = 0 to 4 {
+      affine.for %ii = 0 to 4 {
+        %0 = affine.load %arg0[(%i * 4 + %ii) floordiv 4, (%i * 4 + %ii) mod 4] : memref<4x4xf32>
+        affine.store %0, %arg1[%ii, %i] : memref<4x4xf32>
+      }
+    }
+    return
+  }
+}
+
+// -----
+
+// The part of the index that doesn't depend on the innermost loop is computed before it, and in front of the loop
+// over j since it doesn't depend on j either
+
+// CHECK-LABEL: func @hoist_invariant_index_terms
+// CHECK: affine.for %[[I:.*]] = 0 to 8 {
+// CHECK-NEXT: %[[ROW:.*]] = affine.apply #{{.*}}(%[[I]])
+// CHECK-NEXT: affine.for %{{.*}} = 0 to 4 {
+// CHECK-NEXT: affine.for %[[K:.*]] = 0 to 16 {
+// CHECK-NEXT: affine.load %arg0[%[[K]] + %[[ROW]]] : memref<1024xf32>
+module @test_hoist_invariant_index_terms {
+  func @hoist_invariant_index_terms(%arg0: memref<1024xf32>, %arg1: memref<8x4xf32>) {
+    affine.for %i = 0 to 8 {
+      affine.for %j = 0 to 4 {
+        affine.for %k = 0 to 16 {
+          %0 = affine.load %arg0[%i * 128 + %k] : memref<1024xf32>
+          affine.store %0, %arg1[%i, %j] : memref<8x4xf32>
+        }
+      }
+    }
+    return
+  }
+}
@@ -0,0 +1,44 @@
+// RUN: acc-opt --handle-out-of-bounds-access -split-input-file %s | FileCheck %s
+
+// The innermost loop reads past the end of %arg0 in its last outer iteration only, so it is versioned: the accesses
+// of the loop that runs when they are in bounds at both ends of the loop aren't guarded
+
+// CHECK-LABEL: func @version_out_of_bounds_loop
+// CHECK: affine.for %[[I:.*]] = 0 to 4 {
+// CHECK-NEXT: affine.if #{{.*}}(%[[I]]) {
+// CHECK-NEXT: affine.for %[[J:.*]] = 0 to 4 {
+// CHECK-NEXT: %[[VALUE:.*]] = affine.load %arg0[%[[I]] * 3 + %[[J]]] {accxp_bounds_checked} : memref<10xf32>
+// CHECK-NEXT: affine.store %[[VALUE]], %arg1[%[[I]] * 4 + %[[J]]] {accxp_bounds_checked} : memref<16xf32>
+// CHECK: } else {
+// CHECK-NEXT: affine.for
+// CHECK: affine.if
+// CHECK: } {accxp_out_of_bounds_versioned}
+module @test_version_out_of_bounds_loop {
+  func @version_out_of_bounds_loop(%arg0: memref<10xf32>, %arg1: memref<16xf32>) attributes {exec_target = 0 : i64} {
+    affine.for %i = 0 to 4 {
+      affine.for %j = 0 to 4 {
+        %0 = affine.load %arg0[%i * 3 + %j] : memref<10xf32>
+        affine.store %0, %arg1[%i * 4 + %j] : memref<16xf32>
+      }
+    } {accxp.access_bounds_check}
+    return
+  }
+}
+
+// -----
+
+// The range of the thread id proves that the accesses are in bounds, which the affine constraints can't
+
+// CHECK-LABEL: func @thread_id_in_bounds
+// CHECK-NOT: affine.if
+// CHECK: return
+module @test_thread_id_in_bounds {
+  func @thread_id_in_bounds(%arg0: memref<32xf32>, %arg1: memref<32x4xf32>) attributes {exec_target = 1 : i64, gpu_launch = [1, 1, 1, 32, 1, 1]} {
+    %tid = "gpu.thread_id"() {dimension = "x"} : () -> index
+    affine.for %i = 0 to 4 {
+      %0 = affine.load %arg0[%tid] : memref<32xf32>
+      affine.store %0, %arg1[%tid, %i] : memref<32x4xf32>
+    } {accxp.access_bounds_check}
+    return
+  }
+}
@@ -0,0 +1,52 @@
+// RUN: acc-opt --promote-reduction-accumulators -split-input-file %s | FileCheck %s
+
+// The C elements are loaded and stored back in every iteration of the loop over k, so they are carried in iteration
+// arguments instead, and the accumulators hoisted out of the loop over k are carried by the loop over j too
+
+// CHECK-LABEL: func @gemm_accumulators
+// CHECK: affine.for %[[I:.*]] = 0 to 4 {
+// CHECK-NEXT: %[[INIT:.*]] = affine.load %arg2[%[[I]]] : memref<4xf32>
+// CHECK-NEXT: %[[ROW_SUM:.*]] = affine.for %{{.*}} = 0 to 8 iter_args(%[[ROW_ACC:.*]] = %[[INIT]]) -> (f32) {
+// CHECK-NEXT: %[[SUM:.*]] = affine.for %[[K:.*]] = 0 to 16 iter_args(%[[ACC:.*]] = %[[ROW_ACC]]) -> (f32) {
+// CHECK-NEXT: %[[A:.*]] = affine.load %arg0[%[[I]], %[[K]]] : memref<4x16xf32>
+// CHECK-NEXT: %[[NEXT:.*]] = addf %[[ACC]], %[[A]] : f32
+// CHECK-NEXT: affine.yield %[[NEXT]] : f32
+// CHECK-NEXT: }
+// CHECK-NEXT: affine.yield %[[SUM]] : f32
+// CHECK-NEXT: }
+// CHECK-NEXT: affine.store %[[ROW_SUM]], %arg2[%[[I]]] : memref<4xf32>
+module @test_gemm_accumulators {
+  func @gemm_accumulators(%arg0: memref<4x16xf32>, %arg1: memref<16x8xf32>, %arg2: memref<4xf32>) {
+    affine.for %i = 0 to 4 {
+      affine.for %j = 0 to 8 {
+        affine.for %k = 0 to 16 {
+          %0 = affine.load %arg2[%i] : memref<4xf32>
+          %1 = affine.load %arg0[%i, %k] : memref<4x16xf32>
+          %2 = addf %0, %1 : f32
+          affine.store %2, %arg2[%i] : memref<4xf32>
+        }
+      }
+    }
+    return
+  }
+}
+
+// -----
+
+// The loop also reads another element of the accumulator's array, which would see a stale value
+
+// CHECK-LABEL: func @accumulator_read_elsewhere
+// CHECK: affine.for %{{.*}} = 0 to 16 {
+// CHECK-NEXT: affine.load %arg1[0]
+// CHECK: affine.store %{{.*}}, %arg1[0]
+module @test_accumulator_read_elsewhere {
+  func @accumulator_read_elsewhere(%arg0: memref<16xf32>, %arg1: memref<16xf32>) {
+    affine.for %k = 0 to 16 {
+      %0 = affine.load %arg1[0] : memref<16xf32>
+      %1 = affine.load %arg1[%k] : memref<16xf32>
+      %2 = addf %0, %1 : f32
+      affine.store %2, %arg1[0] : memref<16xf32>
+    }
+    return
+  }
+}
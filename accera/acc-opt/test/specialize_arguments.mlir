@@ -0,0 +1,86 @@
+// RUN: acc-opt --value-func-to-target="inline-threshold=0" -split-input-file %s | FileCheck %s
+
+// The function is specialized for alpha = 1 and beta = 0, so the loads of the scale factors are replaced by constants
+// and the multiplications by them are removed, including the load of C that beta scales
+
+// CHECK-LABEL: module @test_specialized_loads
+// CHECK: func @axpby_alpha1_beta0
+// CHECK: affine.for %[[I:.*]] = 0 to 16 {
+// CHECK-NEXT: %[[X:.*]] = affine.load %arg2[%[[I]]] : memref<16xf32>
+// CHECK-NEXT: affine.store %[[X]], %arg3[%[[I]]] : memref<16xf32>
+// CHECK-NEXT: }
+module @test_specialized_loads {
+  accv.module "test_specialized_loads" {
+    accv.func @axpby_alpha1_beta0(%arg0: memref<1xf32>, %arg1: memref<1xf32>, %arg2: memref<16xf32>, %arg3: memref<16xf32>) attributes {accv.specialized_args = [1.0 : f64, 0.0 : f64, unit, unit], exec_target = 0 : i64} {
+      affine.for %i = 0 to 16 {
+        %alpha = affine.load %arg0[0] : memref<1xf32>
+        %beta = affine.load %arg1[0] : memref<1xf32>
+        %x = affine.load %arg2[%i] : memref<16xf32>
+        %c = affine.load %arg3[%i] : memref<16xf32>
+        %0 = "accv.bin_op"(%alpha, %x) {predicate = 2 : i64} : (f32, f32) -> f32
+        %1 = "accv.bin_op"(%beta, %c) {predicate = 2 : i64} : (f32, f32) -> f32
+        %2 = "accv.bin_op"(%1, %0) {predicate = 0 : i64} : (f32, f32) -> f32
+        affine.store %2, %arg3[%i] : memref<16xf32>
+      }
+      accv.return
+    }
+  }
+}
+
+// -----
+
+// The specialized argument is passed to another function, so it is replaced by a constant global, whose loads are
+// replaced by the constant once the call is inlined
+
+// CHECK-LABEL: module @test_specialized_call
+// CHECK: "accv.global"() {constant, sym_name = "scale_alpha2_specialized_arg0", type = memref<1xf32>, value = dense<2.000000e+00> : tensor<1xf32>} : () -> ()
+// CHECK: func @scale_alpha2
+// CHECK: %[[ALPHA:.*]] = constant 2.000000e+00 : f32
+// CHECK: affine.for %[[I:.*]] = 0 to 16 {
+// CHECK-NEXT: %[[X:.*]] = affine.load %arg1[%[[I]]] : memref<16xf32>
+// CHECK-NEXT: %[[Y:.*]] = "accv.bin_op"(%[[ALPHA]], %[[X]]) {predicate = 2 : i64} : (f32, f32) -> f32
+// CHECK-NEXT: affine.store %[[Y]], %arg1[%[[I]]] : memref<16xf32>
+module @test_specialized_call {
+  accv.module "test_specialized_call" {
+    accv.func nested @kernel(%arg0: memref<1xf32>, %arg1: memref<16xf32>) attributes {exec_target = 0 : i64} {
+      affine.for %i = 0 to 16 {
+        %alpha = affine.load %arg0[0] : memref<1xf32>
+        %x = affine.load %arg1[%i] : memref<16xf32>
+        %0 = "accv.bin_op"(%alpha, %x) {predicate = 2 : i64} : (f32, f32) -> f32
+        affine.store %0, %arg1[%i] : memref<16xf32>
+      }
+      accv.return
+    }
+    accv.func @scale_alpha2(%arg0: memref<1xf32>, %arg1: memref<16xf32>) attributes {accv.specialized_args = [2.0 : f64, unit], exec_target = 0 : i64} {
+      "accv.launch_func"(%arg0, %arg1) {callee = @kernel, exec_target = 0 : i64} : (memref<1xf32>, memref<16xf32>) -> ()
+      accv.return
+    }
+  }
+}
+
+// -----
+
+// The callee is marked to be inlined by the heuristic, and is called twice and has more ops than the threshold, so
+// the calls are kept
+
+// CHECK-LABEL: module @test_inline_auto
+// CHECK: func @caller
+// CHECK-NEXT: "accv.launch_func"(%arg0) {callee = @callee, exec_target = 0 : i64} : (memref<16xf32>) -> ()
+// CHECK-NEXT: "accv.launch_func"(%arg0) {callee = @callee, exec_target = 0 : i64} : (memref<16xf32>) -> ()
+module @test_inline_auto {
+  accv.module "test_inline_auto" {
+    accv.func nested @callee(%arg0: memref<16xf32>) attributes {accv.inline_auto, exec_target = 0 : i64} {
+      affine.for %i = 0 to 16 {
+        %x = affine.load %arg0[%i] : memref<16xf32>
+        %0 = "accv.bin_op"(%x, %x) {predicate = 2 : i64} : (f32, f32) -> f32
+        affine.store %0, %arg0[%i] : memref<16xf32>
+      }
+      accv.return
+    }
+    accv.func @caller(%arg0: memref<16xf32>) attributes {exec_target = 0 : i64} {
+      "accv.launch_func"(%arg0) {callee = @callee, exec_target = 0 : i64} : (memref<16xf32>) -> ()
+      "accv.launch_func"(%arg0) {callee = @callee, exec_target = 0 : i64} : (memref<16xf32>) -> ()
+      accv.return
+    }
+  }
+}
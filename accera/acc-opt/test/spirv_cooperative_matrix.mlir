@@ -0,0 +1,49 @@
+// RUN: acc-opt --convert-accera-to-spirv %s | FileCheck %s
+
+// The 16x16x16 tiles of a tensorized kernel lower to the cooperative matrices of SPV_NV_cooperative_matrix, and the
+// warp reductions to subgroup arithmetic, when the target environment allows them. The tile loaded from arg0 starts
+// 16 columns in, its rows are 32 elements apart.
+
+// CHECK-LABEL: spv.func @tensorized
+// CHECK: spv.CompositeConstruct {{.*}}!spv.coopmatrix<16x16xf32, Subgroup>
+// CHECK: spv.CooperativeMatrixLoadNV {{.*}}!spv.coopmatrix<16x16xf16, Subgroup>
+// CHECK: spv.CooperativeMatrixLoadNV {{.*}}!spv.coopmatrix<16x16xf16, Subgroup>
+// CHECK: spv.CooperativeMatrixMulAddNV {{.*}}!spv.coopmatrix<16x16xf32, Subgroup>
+// CHECK: spv.CooperativeMatrixStoreNV
+
+// CHECK-LABEL: spv.func @warp_sum
+// CHECK: spv.GroupNonUniformFAdd "Subgroup" "Reduce" {{.*}} : f32
+module attributes {
+  accv.exec_runtime = "VULKAN",
+  gpu.container_module,
+  spv.target_env = #spv.target_env<#spv.vce<v1.3,
+    [Shader, Float16, StorageBuffer16BitAccess, CooperativeMatrixNV, GroupNonUniform, GroupNonUniformArithmetic],
+    [SPV_KHR_storage_buffer_storage_class, SPV_KHR_16bit_storage, SPV_NV_cooperative_matrix]>,
+    {max_compute_workgroup_invocations = 128 : i32, max_compute_workgroup_size = dense<[128, 128, 64]> : vector<3xi32>}>
+} {
+  gpu.module @kernels {
+    gpu.func @tensorized(%arg0: memref<16x32xf16> {spv.interface_var_abi = #spv.interface_var_abi<(0, 0)>},
+                         %arg1: memref<16x16xf16> {spv.interface_var_abi = #spv.interface_var_abi<(0, 1)>},
+                         %arg2: memref<16x16xf32> {spv.interface_var_abi = #spv.interface_var_abi<(0, 2)>}) kernel
+      attributes {spv.entry_point_abi = {local_size = dense<[32, 1, 1]> : vector<3xi32>}} {
+      %c0 = constant 0 : index
+      %c1 = constant 1 : index
+      %zero = constant 0.0 : f32
+      %acc = accv.mfma_constant_matrix %zero : f32 -> !accv.mfma_matrix<2x2x16xf32, "COp">
+      %a = accv.mfma_load_matrix %arg0[%c0, %c1] {map = affine_map<(d0, d1) -> (d0, d1 * 16)>} : memref<16x32xf16> [index, index] -> !accv.mfma_matrix<2x2x16xf16, "AOp">
+      %b = accv.mfma_load_matrix %arg1[%c0, %c0] {map = affine_map<(d0, d1) -> (d0, d1)>} : memref<16x16xf16> [index, index] -> !accv.mfma_matrix<2x2x16xf16, "BOp">
+      %d = accv.mfma_compute %a, %b, %acc, 0, 0, 0 : !accv.mfma_matrix<2x2x16xf16, "AOp">, !accv.mfma_matrix<2x2x16xf16, "BOp">, !accv.mfma_matrix<2x2x16xf32, "COp"> -> !accv.mfma_matrix<2x2x16xf32, "COp">
+      accv.mfma_store_matrix %d, %arg2[%c0, %c0] {map = affine_map<(d0, d1) -> (d0, d1)>} : !accv.mfma_matrix<2x2x16xf32, "COp">, memref<16x16xf32> [index, index]
+      gpu.return
+    }
+
+    gpu.func @warp_sum(%arg0: memref<32xf32> {spv.interface_var_abi = #spv.interface_var_abi<(0, 0)>}) kernel
+      attributes {spv.entry_point_abi = {local_size = dense<[32, 1, 1]> : vector<3xi32>}} {
+      %c0 = constant 0 : index
+      %value = memref.load %arg0[%c0] : memref<32xf32>
+      %sum = accv.gpu_reduce "Sum", "Warp", %value : f32
+      memref.store %sum, %arg0[%c0] : memref<32xf32>
+      gpu.return
+    }
+  }
+}
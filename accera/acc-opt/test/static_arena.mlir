@@ -0,0 +1,49 @@
+// RUN: acc-opt --plan-cache-memory="static-arena=true" %s | FileCheck %s
+
+// The temporary array of the caller and the cache of the callee are carved from a single static arena. The temporary
+// array is live across the call, so the buffers of the callee are placed past the end of the caller's buffers
+
+// CHECK-LABEL: module @test_static_arena
+// CHECK: "accv.global"() {accxp.cache_buffer, sym_name = "[[ARENA:static_arena_[0-9]+]]", type = memref<192xi8>} : () -> ()
+// CHECK-NOT: "accv.global"
+// CHECK: accv.func nested @callee
+// CHECK: %[[ARENA0:.*]] = "accv.ref_global"() {global_name = @[[ARENA]]} : () -> memref<192xi8>
+// CHECK-NEXT: %[[OFFSET0:.*]] = constant 128 : index
+// CHECK-NEXT: %[[CACHE:.*]] = memref.view %[[ARENA0]][%[[OFFSET0]]][] : memref<192xi8> to memref<16xf32>
+// CHECK: affine.store %{{.*}}, %[[CACHE]][%{{.*}}] : memref<16xf32>
+// CHECK: accv.func nested @caller
+// CHECK-NOT: accv.alloc
+// CHECK: %[[ARENA1:.*]] = "accv.ref_global"() {global_name = @[[ARENA]]} : () -> memref<192xi8>
+// CHECK-NEXT: %[[OFFSET1:.*]] = constant 0 : index
+// CHECK-NEXT: %[[TEMP:.*]] = memref.view %[[ARENA1]][%[[OFFSET1]]][] : memref<192xi8> to memref<32xf32>
+// CHECK: affine.store %{{.*}}, %[[TEMP]][%{{.*}}] : memref<32xf32>
+module @test_static_arena {
+  accv.module "test_static_arena" {
+    "accv.global"() {accxp.cache_buffer, sym_name = "cache_0", type = memref<16xf32>} : () -> ()
+    accv.func nested @callee(%arg0: memref<16xf32>) attributes {exec_target = 0 : i64} {
+      %0 = "accv.ref_global"() {global_name = @cache_0} : () -> memref<16xf32>
+      affine.for %arg1 = 0 to 16 {
+        %1 = affine.load %arg0[%arg1] : memref<16xf32>
+        affine.store %1, %0[%arg1] : memref<16xf32>
+      }
+      affine.for %arg1 = 0 to 16 {
+        %1 = affine.load %0[%arg1] : memref<16xf32>
+        affine.store %1, %arg0[%arg1] : memref<16xf32>
+      }
+      accv.return
+    }
+    accv.func nested @caller(%arg0: memref<16xf32>) attributes {exec_target = 0 : i64} {
+      %0 = "accv.alloc"() : () -> memref<32xf32>
+      affine.for %arg1 = 0 to 16 {
+        %1 = affine.load %arg0[%arg1] : memref<16xf32>
+        affine.store %1, %0[%arg1] : memref<32xf32>
+      }
+      "accv.launch_func"(%arg0) {callee = @callee, exec_target = 0 : i64} : (memref<16xf32>) -> ()
+      affine.for %arg1 = 0 to 16 {
+        %1 = affine.load %0[%arg1] : memref<32xf32>
+        affine.store %1, %arg0[%arg1] : memref<16xf32>
+      }
+      accv.return
+    }
+  }
+}
@@ -11,6 +11,7 @@
 #include <catch2/catch.hpp>
 
 #include <value/include/Array.h>
+#include <value/include/ArrayOperations.h>
 #include <value/include/EmitterContext.h>
 #include <value/include/FastMath.h>
 #include <value/include/IterationDomain.h>
@@ -23,7 +24,9 @@
 #include <value/include/Plan.h>
 #include <value/include/Profiling.h>
 #include <value/include/Schedule.h>
+#include <value/include/SparseOperations.h>
 #include <value/include/Tensor.h>
+#include <value/include/TriangularOperations.h>
 
 #include <utilities/include/MathUtil.h>
 
@@ -3749,6 +3752,317 @@ TEST_CASE("softmax_test")
     SUCCEED();
 }
 
+// CHECK-LABEL: module @jit_softmax_rows_test {
+// JIT-LABEL: @jit_softmax_rows_test
+TEST_CASE("jit_softmax_rows_test")
+{
+    const int M = 4;
+    const int N = 32;
+
+    DeclareFunction("main")
+        .Public(true)
+        .Decorated(false)
+        .Define([=]() {
+            Array A = MakeArray<float>({ M, N }, "A");
+            Array rowSum = MakeArray<float>({ M }, "rowSum");
+
+            // Every row grows to its max, so that the running max of each lane rescales the sum
+            {
+                Nest fillNest(MemoryShape{ M, N });
+                auto [i, j] = fillNest.GetIndices<2>();
+                fillNest.Set([&, i = i, j = j]() {
+                    auto iVal = Scalar(Cast(i, ValueType::Int32));
+                    auto jVal = Scalar(Cast(j, ValueType::Int32));
+                    A(i, j) = Scalar(Cast(iVal + jVal, ValueType::Float)) * Scalar(0.5f);
+                });
+                fillNest.CreateSchedule();
+            }
+
+            SoftmaxifyRowsVectorized(A);
+
+            ClearArray(rowSum);
+            Nest sumNest(MemoryShape{ M, N });
+            auto [i, j] = sumNest.GetIndices<2>();
+            sumNest.Set([&, i = i, j = j]() {
+                rowSum(i) += A(i, j);
+            });
+            sumNest.CreateSchedule();
+
+            // JIT-LABEL: rowSum:
+            Print("rowSum:\n"s);
+            // JIT: 1.000000 1.000000 1.000000 1.000000
+            Print(rowSum);
+        });
+
+    SUCCEED();
+}
+
+// CHECK-LABEL: module @jit_fused_attention_test {
+// JIT-LABEL: @jit_fused_attention_test
+TEST_CASE("jit_fused_attention_test")
+{
+    const int M = 4;
+    const int N = 32;
+    const int d = 8;
+    const int dv = 8;
+
+    DeclareFunction("main")
+        .Public(true)
+        .Decorated(false)
+        .Define([=]() {
+            Array Q = MakeArray<float>({ M, d }, "Q");
+            Array K = MakeArray<float>({ N, d }, "K");
+            Array V = MakeArray<float>({ N, dv }, "V");
+            Array output = MakeArray<float>({ M, dv }, "output");
+            Array outputSum = MakeArray<float>({ M }, "outputSum");
+
+            // The scores grow with the key, so that every block of keys raises the row max and rescales the
+            // previous blocks. Each row of the output is a weighted mean of rows of ones.
+            {
+                Nest fillNest(MemoryShape{ N, d });
+                auto [j, k] = fillNest.GetIndices<2>();
+                fillNest.Set([&, j = j, k = k]() {
+                    auto jVal = Scalar(Cast(j, ValueType::Int32));
+                    K(j, k) = Scalar(Cast(jVal, ValueType::Float)) * Scalar(0.25f);
+                    V(j, k) = Scalar(1.0f);
+                });
+                fillNest.CreateSchedule();
+            }
+            FillArray(Q, Scalar(1.0f));
+
+            FusedAttention(Q, K, V, output, 8);
+
+            ClearArray(outputSum);
+            Nest sumNest(MemoryShape{ M, dv });
+            auto [i, c] = sumNest.GetIndices<2>();
+            sumNest.Set([&, i = i, c = c]() {
+                outputSum(i) += output(i, c);
+            });
+            sumNest.CreateSchedule();
+
+            // JIT-LABEL: outputSum:
+            Print("outputSum:\n"s);
+            // JIT: 8.000000 8.000000 8.000000 8.000000
+            Print(outputSum);
+        });
+
+    SUCCEED();
+}
+
+// CHECK-LABEL: module @jit_argmax_topk_rows_test {
+// JIT-LABEL: @jit_argmax_topk_rows_test
+TEST_CASE("jit_argmax_topk_rows_test")
+{
+    const int M = 2;
+    const int N = 64;
+    const int k = 3;
+
+    DeclareFunction("main")
+        .Public(true)
+        .Decorated(false)
+        .Define([=]() {
+            Array A = MakeArray<float>({ M, N }, "A");
+            Array argMax = MakeArray<int>({ M }, "argMax");
+            Array topValues = MakeArray<float>({ M, k }, "topValues");
+            Array topIndices = MakeArray<int>({ M, k }, "topIndices");
+
+            // Each row is a permutation of 0..63, whose largest values are in different partitions
+            {
+                Nest fillNest(MemoryShape{ M, N });
+                auto [i, j] = fillNest.GetIndices<2>();
+                fillNest.Set([&, i = i, j = j]() {
+                    auto iVal = Scalar(Cast(i, ValueType::Int32));
+                    auto jVal = Scalar(Cast(j, ValueType::Int32));
+                    A(i, j) = Scalar(Cast((jVal * 37 + iVal * 11) % 64, ValueType::Float));
+                });
+                fillNest.CreateSchedule();
+            }
+
+            ArgMaxRows(A, argMax, 4);
+            TopKRows(A, topValues, topIndices, 4);
+
+            // JIT-LABEL: argMax:
+            Print("argMax:\n"s);
+            // JIT: 19 36
+            Print(argMax);
+
+            // JIT-LABEL: topValues:
+            Print("topValues:\n"s);
+            // JIT: 63.000000 62.000000 61.000000
+            // JIT-NEXT: 63.000000 62.000000 61.000000
+            Print(topValues);
+
+            // JIT-LABEL: topIndices:
+            Print("topIndices:\n"s);
+            // JIT: 19 38 57
+            // JIT-NEXT: 36 55 10
+            Print(topIndices);
+        });
+
+    SUCCEED();
+}
+
+// CHECK-LABEL: module @jit_sparse_dense_products_test {
+// JIT-LABEL: @jit_sparse_dense_products_test
+TEST_CASE("jit_sparse_dense_products_test")
+{
+    DeclareFunction("main")
+        .Public(true)
+        .Decorated(false)
+        .Define([=]() {
+            // A 4x4 matrix with two empty rows, one of them at the end:
+            // [ 0 1 0 2 ]
+            // [ 0 0 0 0 ]
+            // [ 3 4 5 0 ]
+            // [ 0 0 0 0 ]
+            CSRMatrix A{
+                Array(std::vector<int>{ 0, 2, 2, 5, 5 }, MemoryLayout(MemoryShape{ 5 }), "rowOffsets"),
+                Array(std::vector<int>{ 1, 3, 0, 1, 2 }, MemoryLayout(MemoryShape{ 5 }), "columns"),
+                Array(std::vector<float>{ 1, 2, 3, 4, 5 }, MemoryLayout(MemoryShape{ 5 }), "values"),
+                4
+            };
+            Array x(std::vector<float>{ 1, 2, 3, 4 }, MemoryLayout(MemoryShape{ 4 }), "x");
+            Array X(std::vector<float>{ 1, 10, 2, 20, 3, 30, 4, 40 }, MemoryLayout(MemoryShape{ 4, 2 }), "X");
+            Array y = MakeArray<float>({ 4 }, "y");
+            Array Y = MakeArray<float>({ 4, 2 }, "Y");
+
+            // The first partition gets the first row, the second one the rest
+            SpMV(A, x, y, 2);
+            SpMM(A, X, Y, 2);
+
+            // JIT-LABEL: y:
+            Print("y:\n"s);
+            // JIT: 10.000000 0.000000 26.000000 0.000000
+            Print(y);
+
+            // JIT-LABEL: Y:
+            Print("Y:\n"s);
+            // JIT: 10.000000 100.000000
+            // JIT-NEXT: 0.000000 0.000000
+            // JIT-NEXT: 26.000000 260.000000
+            // JIT-NEXT: 0.000000 0.000000
+            Print(Y);
+        });
+
+    SUCCEED();
+}
+
+// CHECK-LABEL: module @jit_embedding_bags_test {
+// JIT-LABEL: @jit_embedding_bags_test
+TEST_CASE("jit_embedding_bags_test")
+{
+    const int rows = 4;
+    const int d = 8;
+    const int bags = 3;
+
+    std::vector<float> tableData(rows * d);
+    for (int r = 0; r < rows; ++r)
+    {
+        for (int j = 0; j < d; ++j)
+        {
+            tableData[r * d + j] = static_cast<float>(10 * r + j);
+        }
+    }
+
+    DeclareFunction("main")
+        .Public(true)
+        .Decorated(false)
+        .Define([=]() {
+            Array table(tableData, MemoryLayout(MemoryShape{ rows, d }), "table");
+
+            // The second bag is empty, and the last two share a row
+            Array indices(std::vector<int>{ 0, 2, 2, 3 }, MemoryLayout(MemoryShape{ 4 }), "indices");
+            Array offsets(std::vector<int>{ 0, 2, 2, 4 }, MemoryLayout(MemoryShape{ bags + 1 }), "offsets");
+            Array sums = MakeArray<float>({ bags, d }, "sums");
+            Array gradTable = MakeArray<float>({ rows, d }, "gradTable");
+            ClearArray(gradTable);
+
+            EmbeddingBagSum(table, indices, offsets, sums, 1);
+            EmbeddingBagScatterAdd(sums, indices, offsets, gradTable, 2);
+
+            // JIT-LABEL: sums:
+            Print("sums:\n"s);
+            // JIT: 20.000000 22.000000 24.000000 26.000000 28.000000 30.000000 32.000000 34.000000
+            // JIT-NEXT: 0.000000 0.000000 0.000000 0.000000 0.000000 0.000000 0.000000 0.000000
+            // JIT-NEXT: 50.000000 52.000000 54.000000 56.000000 58.000000 60.000000 62.000000 64.000000
+            Print(sums);
+
+            // JIT-LABEL: gradTable:
+            Print("gradTable:\n"s);
+            // JIT: 20.000000 22.000000 24.000000 26.000000 28.000000 30.000000 32.000000 34.000000
+            // JIT-NEXT: 0.000000 0.000000 0.000000 0.000000 0.000000 0.000000 0.000000 0.000000
+            // JIT-NEXT: 70.000000 74.000000 78.000000 82.000000 86.000000 90.000000 94.000000 98.000000
+            // JIT-NEXT: 50.000000 52.000000 54.000000 56.000000 58.000000 60.000000 62.000000 64.000000
+            Print(gradTable);
+        });
+
+    SUCCEED();
+}
+
+// CHECK-LABEL: module @jit_triangular_operations_test {
+// JIT-LABEL: @jit_triangular_operations_test
+TEST_CASE("jit_triangular_operations_test")
+{
+    DeclareFunction("main")
+        .Public(true)
+        .Decorated(false)
+        .Define([=]() {
+            // Blocks of 2 rows, so that each triangle has a full tile and two diagonal tiles
+            Array A(std::vector<float>{ 1, 2, 3, 4, 5, 6, 7, 8 }, MemoryLayout(MemoryShape{ 4, 2 }), "A");
+            // The 100s are outside of the lower triangle, which is all that is read
+            Array L(std::vector<float>{ 1, 100, 100, 100, 1, 2, 100, 100, 1, 1, 3, 100, 1, 1, 1, 4 }, MemoryLayout(MemoryShape{ 4, 4 }), "L");
+            Array B(std::vector<float>{ 1, 1, 1, 2, 1, 3, 1, 4 }, MemoryLayout(MemoryShape{ 4, 2 }), "B");
+            Array lower = MakeArray<float>({ 4, 4 }, "lower");
+            Array upper = MakeArray<float>({ 4, 4 }, "upper");
+            Array X = MakeArray<float>({ 4, 2 }, "X");
+            ClearArray(lower);
+            ClearArray(upper);
+            ClearArray(X);
+
+            SymmetricRankKUpdate(A, lower, TriangularPart::Lower, 2);
+            SymmetricRankKUpdate(A, upper, TriangularPart::Upper, 2);
+
+            // JIT-LABEL: lower:
+            Print("lower:\n"s);
+            // JIT: 5.000000 0.000000 0.000000 0.000000
+            // JIT-NEXT: 11.000000 25.000000 0.000000 0.000000
+            // JIT-NEXT: 17.000000 39.000000 61.000000 0.000000
+            // JIT-NEXT: 23.000000 53.000000 83.000000 113.000000
+            Print(lower);
+
+            // JIT-LABEL: upper:
+            Print("upper:\n"s);
+            // JIT: 5.000000 11.000000 17.000000 23.000000
+            // JIT-NEXT: 0.000000 25.000000 39.000000 53.000000
+            // JIT-NEXT: 0.000000 0.000000 61.000000 83.000000
+            // JIT-NEXT: 0.000000 0.000000 0.000000 113.000000
+            Print(upper);
+
+            TriangularMatMul(L, B, X, TriangularPart::Lower, false, 2);
+
+            // JIT-LABEL: trmm:
+            Print("trmm:\n"s);
+            // JIT: 1.000000 1.000000
+            // JIT-NEXT: 3.000000 5.000000
+            // JIT-NEXT: 5.000000 12.000000
+            // JIT-NEXT: 7.000000 22.000000
+            Print(X);
+
+            // Solving with the product recovers B
+            TriangularSolve(L, X, TriangularPart::Lower, false, 2);
+
+            // JIT-LABEL: trsm:
+            Print("trsm:\n"s);
+            // JIT: 1.000000 1.000000
+            // JIT-NEXT: 1.000000 2.000000
+            // JIT-NEXT: 1.000000 3.000000
+            // JIT-NEXT: 1.000000 4.000000
+            Print(X);
+        });
+
+    SUCCEED();
+}
+
 // CHECK-LABEL: module @jit_reduce_n_test {
 // JIT-LABEL: @jit_reduce_n_test
 TEST_CASE("jit_reduce_n_test")
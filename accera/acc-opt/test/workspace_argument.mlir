@@ -0,0 +1,37 @@
+// RUN: acc-opt --convert-scratch-to-workspace %s | FileCheck %s
+
+// The cache buffers of the function and its callee are laid out back to back in the trailing workspace argument
+
+// CHECK-LABEL: module @test_workspace_argument
+// CHECK-NOT: memref.global
+// CHECK: func private @test_workspace_argument_impl_workspace(%arg0: memref<16xf32>, %arg1: memref<192xi8>)
+// CHECK: %[[OFFSET0:.*]] = constant 0 : index
+// CHECK-NEXT: %[[CACHE0:.*]] = memref.view %arg1[%[[OFFSET0]]][] : memref<192xi8> to memref<16xf32>
+// CHECK: %[[OFFSET1:.*]] = constant 64 : index
+// CHECK-NEXT: %[[CACHE1:.*]] = memref.view %arg1[%[[OFFSET1]]][] : memref<192xi8> to memref<4x4xf64>
+// CHECK: memref.store %{{.*}}, %[[CACHE0]][%{{.*}}] : memref<16xf32>
+// CHECK: memref.store %{{.*}}, %[[CACHE1]][%{{.*}}, %{{.*}}] : memref<4x4xf64>
+// CHECK: func @test_workspace_argument(%arg0: memref<16xf32>, %arg1: memref<192xi8>)
+// CHECK-NEXT: call @test_workspace_argument_impl_workspace(%arg0, %arg1) : (memref<16xf32>, memref<192xi8>) -> ()
+// CHECK: func @test_workspace_argument_workspace_size() -> i64
+// CHECK-NEXT: %[[SIZE:.*]] = constant 192 : i64
+// CHECK-NEXT: return %[[SIZE]] : i64
+// CHECK-NOT: memref.global
+module @test_workspace_argument {
+  "memref.global"() {accxp.cache_buffer, sym_name = "cache_0", sym_visibility = "nested", type = memref<16xf32>} : () -> ()
+  "memref.global"() {accxp.cache_buffer, sym_name = "cache_1", sym_visibility = "nested", type = memref<4x4xf64>} : () -> ()
+  func nested @test_workspace_argument_impl(%arg0: memref<16xf32>) {
+    %0 = memref.get_global @cache_0 : memref<16xf32>
+    %1 = memref.get_global @cache_1 : memref<4x4xf64>
+    %c0 = constant 0 : index
+    %2 = memref.load %arg0[%c0] : memref<16xf32>
+    memref.store %2, %0[%c0] : memref<16xf32>
+    %3 = fpext %2 : f32 to f64
+    memref.store %3, %1[%c0, %c0] : memref<4x4xf64>
+    return
+  }
+  func @test_workspace_argument(%arg0: memref<16xf32>) attributes {accv.emit_raw_pointer_api, accv.emit_workspace_api} {
+    call @test_workspace_argument_impl(%arg0) : (memref<16xf32>) -> ()
+    return
+  }
+}
@@ -32,6 +32,10 @@ llvm::cl::opt<int> indexBitwidth{ "indexBitwidth",
                                   llvm::cl::desc("The bitwidth of the unsigned integer type used to represent indices"),
                                   llvm::cl::init(32) };
 
+llvm::cl::opt<bool> headerOnly{ "header-only",
+                                llvm::cl::desc("Print a header that defines the functions static inline, so that they can be inlined into the code that includes it"),
+                                llvm::cl::init(false) };
+
 // This function should be called before creating any MLIRContext if one
 // expects all the possible translations to be made available to the context
 // automatically.
@@ -40,7 +44,7 @@ inline void registerArgoTranslations()
     [[maybe_unused]] static bool initOnce = []() {
         TranslateFromMLIRRegistration printCppRegistration(
             "print-cpp",
-            [&](Operation* m, llvm::raw_ostream& os) -> LogicalResult { return translateModuleToCpp(m, os, indexBitwidth); },
+            [&](Operation* m, llvm::raw_ostream& os) -> LogicalResult { return translateModuleToCpp(m, os, indexBitwidth, headerOnly); },
             [](DialectRegistry& registry) {
                 registerAllDialects(registry);
                 accera::ir::GetDialectRegistry().appendTo(registry);
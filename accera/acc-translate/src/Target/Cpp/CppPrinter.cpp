@@ -9,6 +9,7 @@
 #include <llvm/ADT/StringRef.h>
 #include <llvm/Support/Debug.h>
 #include <mlir/Dialect/Affine/IR/AffineOps.h>
+#include <mlir/Dialect/LLVMIR/LLVMDialect.h>
 #include <mlir/Dialect/MemRef/IR/MemRef.h>
 #include <mlir/IR/AffineExprVisitor.h>
 #include <mlir/IR/BuiltinTypes.h>
@@ -462,16 +463,52 @@ namespace cpp_printer
     }
 
     LogicalResult CppPrinter::printDecayedArrayDeclaration(MemRefType memRefType,
-                                                           StringRef arrayName)
+                                                           StringRef arrayName,
+                                                           bool isRestrict)
     {
         RETURN_IF_FAILED(checkMemRefType(memRefType));
+        os << addressSpaceQualifier(memRefType);
         RETURN_IF_FAILED(printType(memRefType.getElementType()));
-        os << " *" << arrayName;
+        os << " *";
+        if (isRestrict)
+        {
+            os << (state.hasRuntime(Runtime::OPENCL) ? "restrict " : "__restrict__ ");
+        }
+        os << arrayName;
         return success();
     }
 
+    const char* CppPrinter::addressSpaceQualifier(MemRefType memRefType)
+    {
+        if (!state.hasRuntime(Runtime::OPENCL))
+        {
+            return "";
+        }
+
+        // Kernel arguments point into global memory. Other pointers, such as the casts of element addresses, are left
+        // in the generic address space of OpenCL C 2.0.
+        auto memspace = memRefType.getMemorySpaceAsInt();
+        if (memspace == gpu::GPUDialect::getWorkgroupAddressSpace())
+        {
+            return "__local ";
+        }
+        else if (memspace == gpu::GPUDialect::getPrivateAddressSpace())
+        {
+            return "__private ";
+        }
+        return "__global ";
+    }
+
     LogicalResult CppPrinter::printVectorType(VectorType type)
     {
+        if (!state.hasRuntime(Runtime::CUDA))
+        {
+            // CPU vectors use the vector extension of the host compiler (see the prologue of the std dialect printer)
+            os << "accera_vector_t<";
+            RETURN_IF_FAILED(printType(type.getElementType()));
+            os << ", " << type.getNumElements() << ">";
+            return success();
+        }
         if (!type.getElementType().isa<Float16Type>())
         {
             // FP16 is "vhalf" but a vector of FP16 is "vhalfxN_t", so don't prepend "v" if the element type is FP16
@@ -576,11 +613,22 @@ namespace cpp_printer
             SmallString<128> nameStr("");
             llvm::raw_svector_ostream strm(nameStr);
             CppPrinter cppPrinter(strm, getPrinterState().indexBitwidth);
+            cppPrinter.getPrinterState().runtimesDetected = state.runtimesDetected;
             (void)cppPrinter.printType(targetOrSrc.getType());
             vectorTypeName = strm.str().str();
         }
-        auto memrefAccessPrefix = srcTargetsIsVectorTy ? std::string("*((") + vectorTypeName + "*)(&(" : std::string("");
-        auto memrefAccessSuffix = srcTargetsIsVectorTy ? ")))" : "";
+        // Vector accesses into arrays go through vector_access (see the GPU header), which issues a single wide load or
+        // store when the address is aligned to the vector and falls back to element accesses otherwise. OpenCL C has
+        // the vloadN and vstoreN builtins for this, which only require the alignment of the elements.
+        const bool useVectorAccess = srcTargetsIsVectorTy && rank > 0 && state.hasRuntime(Runtime::CUDA);
+        const bool useVectorBuiltins = useVectorAccess && state.hasRuntime(Runtime::OPENCL);
+        auto memrefAccessPrefix = useVectorAccess ? std::string("vector_access<") + vectorTypeName + ">(&(" : srcTargetsIsVectorTy ? std::string("*((") + vectorTypeName + "*)(&(" : std::string("");
+        auto memrefAccessSuffix = useVectorAccess ? "))" : srcTargetsIsVectorTy ? ")))" : "";
+        if (useVectorBuiltins)
+        {
+            auto vectorSize = std::to_string(targetOrSrc.getType().cast<VectorType>().getNumElements());
+            memrefAccessPrefix = isLoad ? "vload" + vectorSize + "(0, &(" : "vstore" + vectorSize + "(" + state.nameState.getName(targetOrSrc).str() + ", 0, &(";
+        }
         if (rank == 0)
         {
             if (isLoad)
@@ -665,12 +713,25 @@ namespace cpp_printer
             else
             {
                 os << memrefAccessPrefix << state.nameState.getName(memref) << offsetStr << memrefAccessSuffix;
-                os << " = " << state.nameState.getName(targetOrSrc);
+                if (!useVectorBuiltins)
+                {
+                    os << " = " << state.nameState.getName(targetOrSrc);
+                }
             }
         }
         else
         {
-            os << "const auto " << offsetVarName << " = " << offsetStr << ";\n";
+            if (state.hasRuntime(Runtime::OPENCL))
+            {
+                // OpenCL C has no type deduction
+                os << "const ";
+                RETURN_IF_FAILED(printIndexType());
+            }
+            else
+            {
+                os << "const auto";
+            }
+            os << " " << offsetVarName << " = " << offsetStr << ";\n";
             if (isLoad)
             {
                 RETURN_IF_FAILED(printDeclarationForValue(targetOrSrc));
@@ -684,7 +745,10 @@ namespace cpp_printer
                 os << memrefAccessPrefix;
                 RETURN_IF_FAILED(printMemRefAccess(memref, memRefType, offsetVarName));
                 os << memrefAccessSuffix;
-                os << " = " << state.nameState.getName(targetOrSrc);
+                if (!useVectorBuiltins)
+                {
+                    os << " = " << state.nameState.getName(targetOrSrc);
+                }
             }
         }
         return success();
@@ -823,7 +887,10 @@ namespace cpp_printer
         auto argTy = arg.getType();
         if (auto memRefType = argTy.dyn_cast<MemRefType>())
         {
-            return printDecayedArrayDeclaration(memRefType, argName);
+            // Arguments that the function declares as not aliasing each other, see ValueFuncToTargetPattern
+            auto funcOp = dyn_cast_or_null<FuncOp>(arg.getOwner()->getParentOp());
+            auto isRestrict = funcOp && funcOp.getArgAttr(arg.getArgNumber(), LLVM::LLVMDialect::getNoAliasAttrName());
+            return printDecayedArrayDeclaration(memRefType, argName, isRestrict);
         }
 
         RETURN_IF_FAILED(printType(argTy));
@@ -834,7 +901,12 @@ namespace cpp_printer
     LogicalResult CppPrinter::printFunctionDeclaration(FuncOp funcOp,
                                                        bool trailingSemiColon)
     {
-        if (funcOp->hasAttr(ir::HeaderDeclAttrName) && funcOp->hasAttr(ir::RawPointerAPIAttrName))
+        // Definitions in a header have internal linkage, so that each file that includes it gets its own copy
+        if (state.headerOnly && !funcOp.getBlocks().empty())
+        {
+            os << "static inline ";
+        }
+        else if (funcOp->hasAttr(ir::HeaderDeclAttrName) && funcOp->hasAttr(ir::RawPointerAPIAttrName))
         {
             os << "extern \"C\" ";
         }
@@ -901,7 +973,11 @@ namespace cpp_printer
             return funcOp.emitOpError() << "<<failed to print function declaration>>";
         }
 
-        if (numBlocks != 0)
+        if (numBlocks != 0 && funcOp->hasAttr(ir::GPUGraphAttrName) && state.hasRuntime(Runtime::CUDA) && !state.hasRuntime(Runtime::OPENCL))
+        {
+            RETURN_IF_FAILED(printGPUGraphFuncBody(funcOp));
+        }
+        else if (numBlocks != 0)
         {
             // print function body
             if (failed(printBlock(&(blocks.front()))))
@@ -914,6 +990,42 @@ namespace cpp_printer
         return success();
     }
 
+    // The kernels are launched on the stream that captures them, see the accera_graph helpers of the GPU prologue
+    LogicalResult CppPrinter::printGPUGraphFuncBody(FuncOp funcOp)
+    {
+        if (funcOp.getType().getNumResults() != 0)
+        {
+            return funcOp.emitOpError() << "<<only functions without results can launch their kernels from a graph>>";
+        }
+
+        auto numArgs = std::max<size_t>(funcOp.getNumArguments(), 1);
+        os << "{\n";
+        os << "static accera_graph<" << numArgs << "> accera_graph_state;\n";
+        os << "const unsigned long long accera_graph_args[" << numArgs << "] = { ";
+        if (funcOp.getNumArguments() == 0)
+        {
+            os << "0";
+        }
+        llvm::interleaveComma(funcOp.getArguments(), os, [&](BlockArgument arg) {
+            os << "accera_graph_arg(" << state.nameState.getName(arg) << ")";
+        });
+        os << " };\n";
+        os << "if (!accera_replay_graph(accera_graph_state, accera_graph_args))\n";
+        os << "{\n";
+        os << "accera_stream_t accera_graph_stream;\n";
+        os << "do\n";
+        os << "{\n";
+        os << "accera_graph_stream = accera_begin_graph_capture(accera_graph_state, accera_graph_args);\n";
+
+        // The body is run again on the default stream if its launches can't be captured, so it doesn't return early
+        if (failed(printBlock(&(funcOp.getBlocks().front()), /*printParens*/ true, /*printBlockTerminator*/ false)))
+            return funcOp.emitOpError() << "<<failed to print function body>>";
+        os << "} while (!accera_end_graph_capture(accera_graph_state));\n";
+        os << "}\n";
+        os << "}\n";
+        return success();
+    }
+
     LogicalResult CppPrinter::printGlobalOp(memref::GlobalOp globalOp)
     {
         if (globalOp.sym_visibilityAttr() == StringAttr::get(globalOp->getContext(), "nested"))
@@ -943,6 +1055,15 @@ namespace cpp_printer
         }
         auto rank = memrefType.getRank();
 
+        if (state.headerOnly)
+        {
+            os << "static ";
+        }
+        else if (state.hasRuntime(Runtime::OPENCL))
+        {
+            // Program scope variables of OpenCL C are in the constant address space
+            os << "__constant ";
+        }
         RETURN_IF_FAILED(printType(memrefType.getElementType()));
         os << " ";
         os << globalOp.getName();
@@ -975,6 +1096,11 @@ namespace cpp_printer
         // to create supporting files
         // (constant BLOBs, CUDA header files, CUDA source files, etc.)
 
+        if (state.headerOnly)
+        {
+            os << "#pragma once\n\n";
+        }
+
         for (auto& dialectPrinter : dialectPrinters)
         {
             RETURN_IF_FAILED(dialectPrinter->printHeaderFiles());
@@ -1020,6 +1146,13 @@ namespace cpp_printer
 
         if (auto funcOp = dyn_cast<FuncOp>(op))
         {
+            // An OpenCL C program only holds the kernels, which the host enqueues through the OpenCL runtime
+            if (state.hasRuntime(Runtime::OPENCL) && !funcOp->getParentOfType<gpu::GPUModuleOp>())
+            {
+                *skipped = true;
+                return success();
+            }
+
             auto iter = state.functionDefConditionalMacro.find(op);
             bool hasCondition = (iter != state.functionDefConditionalMacro.end());
             if (hasCondition)
@@ -129,8 +129,9 @@ namespace cpp_printer
         VULKAN = 1 << 2,
         OPENMP = 1 << 3,
         DEFAULT = 1 << 4,
+        OPENCL = 1 << 5,
 
-        LLVM_MARK_AS_BITMASK_ENUM(/* LargestValue = */ DEFAULT)
+        LLVM_MARK_AS_BITMASK_ENUM(/* LargestValue = */ OPENCL)
     };
 
     /// Holding the states for the printer such as SSA names, type alias, etc
@@ -176,6 +177,10 @@ namespace cpp_printer
         Runtime runtimesDetected = Runtime::NONE;
 
         int indexBitwidth = 0;
+
+        // Print the module as a header: the functions are defined static inline so that the compiler of the code
+        // that includes it can inline them, and the globals are static
+        bool headerOnly = false;
     };
 
     /// Print the given MLIR into C++ code. Formatting is not a concern
@@ -274,8 +279,10 @@ namespace cpp_printer
 
         /// print an array declaration that is decayed into a pointer, e.g.
         /// for an n-d array ``int a[2][3]'', it would become ``int (*a)[3]'';
+        /// the pointer is restrict-qualified if isRestrict is true
         LogicalResult printDecayedArrayDeclaration(MemRefType memrefType,
-                                                   StringRef arrayName);
+                                                   StringRef arrayName,
+                                                   bool isRestrict = false);
 
         /// print BlockArgument
         LogicalResult printBlockArgument(BlockArgument arg);
@@ -299,6 +306,9 @@ namespace cpp_printer
         /// print FuncOp
         LogicalResult printFuncOp(FuncOp funcOp);
 
+        /// print the body of a FuncOp whose kernel launches are replayed from a CUDA/HIP graph
+        LogicalResult printGPUGraphFuncBody(FuncOp funcOp);
+
         /// print GlobalOp
         LogicalResult printGlobalOp(memref::GlobalOp globalOp);
 
@@ -311,9 +321,15 @@ namespace cpp_printer
         /// Returns the dialect printer for the given dialect by name.
         DialectCppPrinter* getDialectPrinter(std::string dialectName);
 
+        // OpenCL C is printed as a flavor of the CUDA output (see GpuDialectCppPrinter::runPrePrintingPasses), with
+        // its own qualifiers
         const char* deviceAttrIfCuda(bool trailingSpace = true)
         {
-            if (state.hasRuntime(Runtime::CUDA))
+            if (state.hasRuntime(Runtime::OPENCL))
+            {
+                return "";
+            }
+            else if (state.hasRuntime(Runtime::CUDA))
             {
                 return trailingSpace ? "__device__ " : "__device__";
             }
@@ -325,7 +341,11 @@ namespace cpp_printer
 
         const char* sharedAttrIfCuda(bool trailingSpace = true)
         {
-            if (state.hasRuntime(Runtime::CUDA))
+            if (state.hasRuntime(Runtime::OPENCL))
+            {
+                return trailingSpace ? "__local " : "__local";
+            }
+            else if (state.hasRuntime(Runtime::CUDA))
             {
                 return trailingSpace ? "__shared__ " : "__shared__";
             }
@@ -337,7 +357,11 @@ namespace cpp_printer
 
         const char* globalAttrIfCuda(bool trailingSpace = true)
         {
-            if (state.hasRuntime(Runtime::CUDA))
+            if (state.hasRuntime(Runtime::OPENCL))
+            {
+                return trailingSpace ? "__kernel " : "__kernel";
+            }
+            else if (state.hasRuntime(Runtime::CUDA))
             {
                 return trailingSpace ? "__global__ " : "__global__";
             }
@@ -389,6 +413,9 @@ namespace cpp_printer
             }
         }
 
+        /// The address space qualifier of a pointer into a memref in OpenCL C, empty for the other runtimes
+        const char* addressSpaceQualifier(MemRefType memRefType);
+
         const char* pragmaUnroll() { return "#pragma unroll"; }
 
         llvm::raw_ostream& getOStream() { return os; }
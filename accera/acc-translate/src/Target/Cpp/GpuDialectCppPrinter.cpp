@@ -13,7 +13,9 @@
 #include <llvm/Support/raw_ostream.h>
 #include <mlir/Support/LogicalResult.h>
 
+#include <algorithm>
 #include <functional>
+#include <numeric>
 
 #include <ir/include/IRUtil.h>
 
@@ -35,6 +37,12 @@ namespace cpp_printer
             return barrierOp.emitError("non-cuda version is not supported yet");
         }
 
+        if (state.hasRuntime(Runtime::OPENCL))
+        {
+            os << "barrier(CLK_LOCAL_MEM_FENCE | CLK_GLOBAL_MEM_FENCE)";
+            return success();
+        }
+
         os << "__syncthreads()";
         return success();
     }
@@ -48,6 +56,16 @@ namespace cpp_printer
             .Default(-1);
     }
 
+    // The CUDA built-in variable, or the OpenCL C work-item function, that holds a dimension of the launch
+    static std::string getWorkItemBuiltin(bool isOpenCL, llvm::StringRef cudaName, llvm::StringRef openCLName, llvm::StringRef dim)
+    {
+        if (isOpenCL)
+        {
+            return (openCLName + "(" + std::to_string(dimIndexToInteger(dim)) + ")").str();
+        }
+        return (cudaName + "." + dim).str();
+    }
+
     static Optional<uint64_t> getGridDim(Operation* op, llvm::StringRef dim)
     {
 
@@ -81,6 +99,39 @@ namespace cpp_printer
         return llvm::None;
     }
 
+    // The number of blocks that a persistent kernel is launched with, 0 for the kernels that aren't persistent
+    static int64_t getPersistentBlocks(gpu::GPUFuncOp funcOp)
+    {
+        if (!funcOp)
+        {
+            return 0;
+        }
+        auto persistentBlocksAttr = funcOp->getAttrOfType<IntegerAttr>(ir::GPUPersistentBlocksAttrName);
+        return persistentBlocksAttr ? persistentBlocksAttr.getInt() : 0;
+    }
+
+    // The grid dimension of the split reduction index of a persistent kernel with a Stream-K decomposition, -1 for the
+    // persistent kernels that take the blocks of their grid from a work counter
+    static int64_t getStreamKDim(gpu::GPUFuncOp funcOp)
+    {
+        auto streamKDimAttr = funcOp ? funcOp->getAttrOfType<IntegerAttr>(ir::GPUStreamKDimAttrName) : IntegerAttr{};
+        return streamKDimAttr ? streamKDimAttr.getInt() : -1;
+    }
+
+    // The grid of a kernel, of which a persistent kernel runs one block at a time
+    static llvm::SmallVector<int64_t, 3> getKernelGridSize(gpu::GPUFuncOp funcOp)
+    {
+        llvm::SmallVector<int64_t, 3> gridSize;
+        if (auto gridSizeAttr = funcOp ? funcOp->getAttrOfType<ArrayAttr>("gridSize") : ArrayAttr{})
+        {
+            for (auto dim : utilir::ArrayAttrToVector<IntegerAttr>(gridSizeAttr))
+            {
+                gridSize.push_back(dim.getInt());
+            }
+        }
+        return gridSize;
+    }
+
     LogicalResult GpuDialectCppPrinter::printOp(GridDimOp gridDimOp)
     {
         if (!state.hasRuntime(Runtime::CUDA))
@@ -95,13 +146,19 @@ namespace cpp_printer
 
         os << " " << idx << " = ";
 
-        if (auto c = getGridDim(gridDimOp, gridDimOp.dimension()); c)
+        // The grid of a persistent kernel isn't the one it's launched with
+        auto funcOp = gridDimOp->getParentOfType<gpu::GPUFuncOp>();
+        if (auto gridSize = getKernelGridSize(funcOp); getPersistentBlocks(funcOp) != 0 && gridSize.size() == 3)
+        {
+            os << gridSize[dimIndexToInteger(gridDimOp.dimension())];
+        }
+        else if (auto c = getGridDim(gridDimOp, gridDimOp.dimension()); c)
         {
             os << c.getValue();
         }
         else
         {
-            os << "gridDim." << gridDimOp.dimension();
+            os << getWorkItemBuiltin(state.hasRuntime(Runtime::OPENCL), "gridDim", "get_num_groups", gridDimOp.dimension());
         }
         return success();
     }
@@ -126,7 +183,7 @@ namespace cpp_printer
         }
         else
         {
-            os << "blockDim." << blockDimOp.dimension();
+            os << getWorkItemBuiltin(state.hasRuntime(Runtime::OPENCL), "blockDim", "get_local_size", blockDimOp.dimension());
         }
         return success();
     }
@@ -145,14 +202,21 @@ namespace cpp_printer
 
         os << " " << idx << " = ";
 
+        // The blocks of a persistent kernel run the block of the grid they took from the work counter
+        if (getPersistentBlocks(bidOp->getParentOfType<gpu::GPUFuncOp>()) != 0)
+        {
+            os << "accera_block_idx." << bidOp.dimension();
+            return success();
+        }
+
+        auto blockIdx = getWorkItemBuiltin(state.hasRuntime(Runtime::OPENCL), "blockIdx", "get_group_id", bidOp.dimension());
         if (auto c = getGridDim(bidOp, bidOp.dimension()); c)
         {
-            os << "(blockIdx." << bidOp.dimension() << "%" << c.getValue() << ")";
+            os << "(" << blockIdx << "%" << c.getValue() << ")";
         }
         else
         {
-
-            os << "blockIdx." << bidOp.dimension();
+            os << blockIdx;
         }
         return success();
     }
@@ -171,17 +235,229 @@ namespace cpp_printer
 
         os << " " << idx << " = ";
 
+        auto threadIdx = getWorkItemBuiltin(state.hasRuntime(Runtime::OPENCL), "threadIdx", "get_local_id", tidOp.dimension());
         if (auto c = getBlockDim(tidOp, tidOp.dimension()); c)
         {
-            os << "(threadIdx." << tidOp.dimension() << "%" << c.getValue() << ")";
+            os << "(" << threadIdx << "%" << c.getValue() << ")";
         }
         else
         {
-            os << "threadIdx." << tidOp.dimension();
+            os << threadIdx;
+        }
+        return success();
+    }
+
+    LogicalResult GpuDialectCppPrinter::printDialectType(Type type, bool* consumed)
+    {
+        auto mmaMatrixType = type.dyn_cast<MMAMatrixType>();
+        if (!mmaMatrixType)
+        {
+            *consumed = false;
+            return success();
+        }
+        *consumed = true;
+
+        if (state.hasRuntime(Runtime::ROCM) || state.hasRuntime(Runtime::OPENCL))
+        {
+            os << "<<tensor core fragments are only supported for CUDA>>";
+            return failure();
+        }
+
+        // The fragments of the m16n16k16 WMMA instructions, the A and B tiles are loaded from row-major memory
+        auto shape = mmaMatrixType.getShape();
+        if (shape[0] != 16 || shape[1] != 16)
+        {
+            os << "<<only 16x16 tensor core fragments are supported>>";
+            return failure();
+        }
+        auto operand = mmaMatrixType.getOperand();
+        auto use = StringSwitch<StringRef>(operand)
+                       .Case("AOp", "matrix_a")
+                       .Case("BOp", "matrix_b")
+                       .Default("accumulator");
+        os << "nvcuda::wmma::fragment<nvcuda::wmma::" << use << ", 16, 16, 16, ";
+        RETURN_IF_FAILED(printer->printType(mmaMatrixType.getElementType()));
+        if (operand != "COp")
+        {
+            os << ", nvcuda::wmma::row_major";
+        }
+        os << ">";
+        return success();
+    }
+
+    LogicalResult GpuDialectCppPrinter::printMemRefElementAddress(Value memref, ValueRange indices)
+    {
+        auto memRefType = memref.getType().cast<MemRefType>();
+        int64_t offset;
+        SmallVector<int64_t, 4> strides;
+        if (failed(getStridesAndOffset(memRefType, strides, offset)) || ShapedType::isDynamicStrideOrOffset(offset) ||
+            llvm::any_of(strides, [](int64_t stride) { return ShapedType::isDynamicStrideOrOffset(stride); }))
+        {
+            os << "<<only memrefs with static strides are supported>>";
+            return failure();
+        }
+
+        os << "((";
+        RETURN_IF_FAILED(printer->printType(memRefType.getElementType()));
+        os << "*)" << state.nameState.getName(memref) << " + " << offset;
+        for (auto [index, stride] : llvm::zip(indices, strides))
+        {
+            os << " + " << state.nameState.getName(index) << " * " << stride;
+        }
+        os << ")";
+        return success();
+    }
+
+    LogicalResult GpuDialectCppPrinter::printOp(AtomicRMWOp atomicOp)
+    {
+        auto kind = atomicOp.kind();
+        if (kind != AtomicRMWKind::addf && kind != AtomicRMWKind::addi)
+        {
+            return atomicOp.emitError("only atomic additions are supported on GPUs");
+        }
+
+        if (state.hasRuntime(Runtime::OPENCL))
+        {
+            // OpenCL C only has atomic additions of integers, the 64-bit ones being an extension
+            if (kind != AtomicRMWKind::addi || atomicOp.getType().getIntOrFloatBitWidth() != 32)
+            {
+                return atomicOp.emitError("only 32-bit integer atomic additions are supported in OpenCL");
+            }
+            RETURN_IF_FAILED(printer->printDeclarationForValue(atomicOp.getResult()));
+            os << " = atomic_fetch_add_explicit((volatile atomic_int*)";
+            RETURN_IF_FAILED(printMemRefElementAddress(atomicOp.memref(), atomicOp.indices()));
+            os << ", " << state.nameState.getName(atomicOp.value()) << ", memory_order_relaxed)";
+            return success();
+        }
+
+        RETURN_IF_FAILED(printer->printDeclarationForValue(atomicOp.getResult()));
+        os << " = atomicAdd(";
+        RETURN_IF_FAILED(printMemRefElementAddress(atomicOp.memref(), atomicOp.indices()));
+        os << ", " << state.nameState.getName(atomicOp.value()) << ")";
+        return success();
+    }
+
+    LogicalResult GpuDialectCppPrinter::printOp(SubgroupMmaLoadMatrixOp loadOp)
+    {
+        auto result = loadOp.getResult();
+        RETURN_IF_FAILED(printer->printDeclarationForValue(result));
+        os << ";\n";
+
+        os << "nvcuda::wmma::load_matrix_sync(" << state.nameState.getName(result) << ", ";
+        RETURN_IF_FAILED(printMemRefElementAddress(loadOp.srcMemref(), loadOp.indices()));
+        os << ", " << loadOp.leadDimension().getZExtValue();
+        if (result.getType().cast<MMAMatrixType>().getOperand() == "COp")
+        {
+            os << ", nvcuda::wmma::mem_row_major";
+        }
+        os << ")";
+        return success();
+    }
+
+    LogicalResult GpuDialectCppPrinter::printOp(SubgroupMmaStoreMatrixOp storeOp)
+    {
+        os << "nvcuda::wmma::store_matrix_sync(";
+        RETURN_IF_FAILED(printMemRefElementAddress(storeOp.dstMemref(), storeOp.indices()));
+        os << ", " << state.nameState.getName(storeOp.src()) << ", " << storeOp.leadDimension().getZExtValue() << ", nvcuda::wmma::mem_row_major)";
+        return success();
+    }
+
+    LogicalResult GpuDialectCppPrinter::printOp(SubgroupMmaComputeOp computeOp)
+    {
+        auto result = computeOp.getResult();
+        RETURN_IF_FAILED(printer->printDeclarationForValue(result));
+        os << ";\n";
+
+        os << "nvcuda::wmma::mma_sync(" << state.nameState.getName(result) << ", "
+           << state.nameState.getName(computeOp.opA()) << ", "
+           << state.nameState.getName(computeOp.opB()) << ", "
+           << state.nameState.getName(computeOp.opC()) << ")";
+        return success();
+    }
+
+    LogicalResult GpuDialectCppPrinter::printOp(SubgroupMmaConstantMatrixOp constantOp)
+    {
+        auto result = constantOp.getResult();
+        RETURN_IF_FAILED(printer->printDeclarationForValue(result));
+        os << ";\n";
+
+        os << "nvcuda::wmma::fill_fragment(" << state.nameState.getName(result) << ", " << state.nameState.getName(constantOp.value()) << ")";
+        return success();
+    }
+
+    LogicalResult GpuDialectCppPrinter::printOp(vir::GPUAsyncCopyOp copyOp)
+    {
+        os << "async_copy(";
+        RETURN_IF_FAILED(printMemRefElementAddress(copyOp.dst(), copyOp.dstIndices()));
+        os << ", ";
+        RETURN_IF_FAILED(printMemRefElementAddress(copyOp.src(), copyOp.srcIndices()));
+        os << ")";
+        return success();
+    }
+
+    LogicalResult GpuDialectCppPrinter::printOp(vir::GPUAsyncCopyCommitOp)
+    {
+        os << "async_copy_commit()";
+        return success();
+    }
+
+    LogicalResult GpuDialectCppPrinter::printOp(vir::GPUAsyncCopyWaitOp waitOp)
+    {
+        if (state.hasRuntime(Runtime::OPENCL))
+        {
+            os << "async_copy_wait(" << waitOp.numPendingGroups() << ")";
+            return success();
+        }
+
+        os << "async_copy_wait<" << waitOp.numPendingGroups() << ">()";
+        return success();
+    }
+
+    LogicalResult GpuDialectCppPrinter::printOp(vir::GPUReduceOp reduceOp)
+    {
+        auto result = reduceOp.result();
+        RETURN_IF_FAILED(printer->printDeclarationForValue(result));
+
+        if (state.hasRuntime(Runtime::OPENCL))
+        {
+            // The collective functions of OpenCL C 2.0 and of the cl_khr_subgroups extension
+            os << " = " << (reduceOp.scope() == vir::BarrierScope::Warp ? "sub_group_reduce_" : "work_group_reduce_");
+            os << (reduceOp.kind() == vir::ReductionKind::Sum ? "add" : "max") << "(" << state.nameState.getName(reduceOp.value()) << ")";
+            return success();
+        }
+
+        os << " = " << (reduceOp.scope() == vir::BarrierScope::Warp ? "warp_reduce" : "block_reduce");
+        os << "<" << (reduceOp.kind() == vir::ReductionKind::Sum ? "reduce_sum" : "reduce_max") << ">(";
+        os << state.nameState.getName(reduceOp.value()) << ")";
+        return success();
+    }
+
+    LogicalResult GpuDialectCppPrinter::printOp(vir::GPUDevicePartitionOp partitionOp)
+    {
+        if (state.hasRuntime(Runtime::OPENCL))
+        {
+            return partitionOp.emitOpError("<<kernels can only be partitioned across CUDA or ROCm devices>>");
         }
+
+        auto result = partitionOp.result();
+        RETURN_IF_FAILED(printer->printDeclarationForValue(result));
+        os << " = accera_device_partition";
         return success();
     }
 
+    // The number of devices that a kernel is partitioned across, 1 for the kernels that aren't partitioned
+    static int64_t getNumDevicePartitions(gpu::GPUFuncOp funcOp)
+    {
+        int64_t numDevices = 1;
+        if (funcOp)
+        {
+            funcOp.walk([&](vir::GPUDevicePartitionOp partitionOp) {
+                numDevices = std::max(numDevices, static_cast<int64_t>(partitionOp.numDevices()));
+            });
+        }
+        return numDevices;
+    }
+
     LogicalResult GpuDialectCppPrinter::printDialectOperation(Operation* op,
                                                               bool* /*skipped*/,
                                                               bool* consumed)
@@ -194,6 +470,7 @@ namespace cpp_printer
 
         TypeSwitch<Operation*>(op)
             // KEEP THIS SORTED
+            .Case<AtomicRMWOp>(handler)
             .Case<BarrierOp>(handler)
             .Case<BlockDimOp>(handler)
             .Case<BlockIdOp>(handler)
@@ -203,7 +480,16 @@ namespace cpp_printer
             .Case<GridDimOp>(handler)
             .Case<LaunchFuncOp>(handler)
             .Case<ModuleEndOp>(handler)
+            .Case<SubgroupMmaComputeOp>(handler)
+            .Case<SubgroupMmaConstantMatrixOp>(handler)
+            .Case<SubgroupMmaLoadMatrixOp>(handler)
+            .Case<SubgroupMmaStoreMatrixOp>(handler)
             .Case<ThreadIdOp>(handler)
+            .Case<vir::GPUAsyncCopyOp>(handler)
+            .Case<vir::GPUAsyncCopyCommitOp>(handler)
+            .Case<vir::GPUAsyncCopyWaitOp>(handler)
+            .Case<vir::GPUDevicePartitionOp>(handler)
+            .Case<vir::GPUReduceOp>(handler)
             .Default([&](Operation*) { *consumed = false; });
 
         return success();
@@ -285,6 +571,11 @@ namespace cpp_printer
             }
             switch (*execRuntime)
             {
+            case vir::ExecutionRuntime::OPENCL:
+                state.setRuntime(Runtime::OPENCL);
+                // OpenCL C is printed as a flavor of the CUDA output
+                state.setRuntime(Runtime::CUDA);
+                break;
             case vir::ExecutionRuntime::ROCM:
                 state.setRuntime(Runtime::ROCM);
                 // TODO: Make ROCM not a subset of CUDA
@@ -311,7 +602,51 @@ namespace cpp_printer
 
     LogicalResult GpuDialectCppPrinter::printHeaderFiles()
     {
-        if (state.hasRuntime(Runtime::CUDA))
+        if (state.hasRuntime(Runtime::OPENCL))
+        {
+            os << R"OPENCL(
+
+// OpenCL C 2.0: element addresses are computed through pointers in the generic address space
+#if defined(cl_khr_fp16)
+#pragma OPENCL EXTENSION cl_khr_fp16 : enable
+#endif // defined(cl_khr_fp16)
+
+typedef char int8_t;
+typedef uchar uint8_t;
+typedef short int16_t;
+typedef ushort uint16_t;
+typedef int int32_t;
+typedef uint uint32_t;
+typedef long int64_t;
+typedef ulong uint64_t;
+
+typedef float2 vfloatx2_t;
+typedef float4 vfloatx4_t;
+typedef float8 vfloatx8_t;
+typedef float16 vfloatx16_t;
+
+#if defined(cl_khr_fp16)
+typedef half vhalf;
+typedef half2 vhalfx2_t;
+typedef half4 vhalfx4_t;
+typedef half8 vhalfx8_t;
+typedef half16 vhalfx16_t;
+#define hexp exp
+#endif // defined(cl_khr_fp16)
+
+#define __forceinline__ static inline __attribute__((always_inline))
+
+// The math functions of OpenCL C are overloaded on the types of their arguments
+#define expf exp
+
+// Work-items copy into local memory themselves, there are no asynchronous copies to wait for
+#define async_copy(dst, src) (*(dst) = *(src))
+#define async_copy_commit()
+#define async_copy_wait(numPendingGroups)
+
+)OPENCL";
+        }
+        else if (state.hasRuntime(Runtime::CUDA))
         {
             os << R"CUDA(
 
@@ -329,10 +664,436 @@ using vhalfx8_t = vhalf __attribute__((ext_vector_type(8)));
 using vhalfx16_t = vhalf __attribute__((ext_vector_type(16)));
 using vhalfx32_t = vhalf __attribute__((ext_vector_type(32)));
 using vhalfx64_t = vhalf __attribute__((ext_vector_type(64)));
+// Arithmetic on the vectors of FP16 and 16-bit integers compiles to the packed instructions of the device (v_pk_fma_f16,
+// v_pk_add_u16, ...), two lanes at a time
+using vint16_tx2_t = int16_t __attribute__((ext_vector_type(2)));
+using vint16_tx4_t = int16_t __attribute__((ext_vector_type(4)));
+using vint16_tx8_t = int16_t __attribute__((ext_vector_type(8)));
+using vint16_tx16_t = int16_t __attribute__((ext_vector_type(16)));
+using vint16_tx32_t = int16_t __attribute__((ext_vector_type(32)));
+using vint16_tx64_t = int16_t __attribute__((ext_vector_type(64)));
+using vuint16_tx2_t = uint16_t __attribute__((ext_vector_type(2)));
+using vuint16_tx4_t = uint16_t __attribute__((ext_vector_type(4)));
+using vuint16_tx8_t = uint16_t __attribute__((ext_vector_type(8)));
+using vuint16_tx16_t = uint16_t __attribute__((ext_vector_type(16)));
+using vuint16_tx32_t = uint16_t __attribute__((ext_vector_type(32)));
+using vuint16_tx64_t = uint16_t __attribute__((ext_vector_type(64)));
 #elif defined(__CUDA__)
 #include "cuda_fp16.h"
+#include "cuda_bf16.h"
+#include "cuda_pipeline.h"
+#include "mma.h"
+using vhalf = __half;
+using bfloat16 = __nv_bfloat16;
+
+// CUDA has no generic vector extension, so vectors are aligned arrays whose whole-vector loads and stores compile to
+// the widest matching memory instructions (ld.global.v4.f32 for vfloatx4_t, a 32-bit access for vhalfx2_t)
+template <typename T, int N>
+struct alignas(sizeof(T) * N) accera_vector
+{
+    T data[N];
+
+    __host__ __device__ __forceinline__ T& operator[](int i) { return data[i]; }
+    __host__ __device__ __forceinline__ const T& operator[](int i) const { return data[i]; }
+};
+
+#define ACCERA_VECTOR_BINARY_OPERATOR(OP)                                                                                      \
+    template <typename T, int N>                                                                                               \
+    __host__ __device__ __forceinline__ accera_vector<T, N> operator OP(const accera_vector<T, N>& a, const accera_vector<T, N>& b) \
+    {                                                                                                                          \
+        accera_vector<T, N> result;                                                                                            \
+        _Pragma("unroll") for (int i = 0; i < N; ++i) result[i] = a[i] OP b[i];                                                \
+        return result;                                                                                                         \
+    }
+ACCERA_VECTOR_BINARY_OPERATOR(+)
+ACCERA_VECTOR_BINARY_OPERATOR(-)
+ACCERA_VECTOR_BINARY_OPERATOR(*)
+ACCERA_VECTOR_BINARY_OPERATOR(/)
+#undef ACCERA_VECTOR_BINARY_OPERATOR
+
+// Vectors of FP16 and 16-bit integers compute two lanes at a time: the pairs of lanes are __half2 values (HADD2, HMUL2,
+// ...) or 32-bit words for the SIMD instructions on 16-bit integers, which only add and subtract
+#define ACCERA_PACKED_VECTOR_BINARY_OPERATOR(T, PACKED_T, OP, PACKED_OP)                                                       \
+    template <int N>                                                                                                           \
+    __device__ __forceinline__ accera_vector<T, N> operator OP(const accera_vector<T, N>& a, const accera_vector<T, N>& b)     \
+    {                                                                                                                          \
+        accera_vector<T, N> result;                                                                                            \
+        _Pragma("unroll") for (int i = 0; i < N / 2; ++i)                                                                      \
+            reinterpret_cast<PACKED_T*>(result.data)[i] =                                                                      \
+                PACKED_OP(reinterpret_cast<const PACKED_T*>(a.data)[i], reinterpret_cast<const PACKED_T*>(b.data)[i]);         \
+        if (N % 2 != 0) result[N - 1] = a[N - 1] OP b[N - 1];                                                                  \
+        return result;                                                                                                         \
+    }
+ACCERA_PACKED_VECTOR_BINARY_OPERATOR(vhalf, __half2, +, __hadd2)
+ACCERA_PACKED_VECTOR_BINARY_OPERATOR(vhalf, __half2, -, __hsub2)
+ACCERA_PACKED_VECTOR_BINARY_OPERATOR(vhalf, __half2, *, __hmul2)
+ACCERA_PACKED_VECTOR_BINARY_OPERATOR(vhalf, __half2, /, __h2div)
+ACCERA_PACKED_VECTOR_BINARY_OPERATOR(int16_t, unsigned int, +, __vadd2)
+ACCERA_PACKED_VECTOR_BINARY_OPERATOR(int16_t, unsigned int, -, __vsub2)
+ACCERA_PACKED_VECTOR_BINARY_OPERATOR(uint16_t, unsigned int, +, __vadd2)
+ACCERA_PACKED_VECTOR_BINARY_OPERATOR(uint16_t, unsigned int, -, __vsub2)
+#undef ACCERA_PACKED_VECTOR_BINARY_OPERATOR
+
+using vfloatx2_t = accera_vector<float, 2>;
+using vfloatx4_t = accera_vector<float, 4>;
+using vfloatx8_t = accera_vector<float, 8>;
+using vfloatx16_t = accera_vector<float, 16>;
+using vfloatx32_t = accera_vector<float, 32>;
+using vfloatx64_t = accera_vector<float, 64>;
+using vhalfx2_t = accera_vector<vhalf, 2>;
+using vhalfx4_t = accera_vector<vhalf, 4>;
+using vhalfx8_t = accera_vector<vhalf, 8>;
+using vhalfx16_t = accera_vector<vhalf, 16>;
+using vhalfx32_t = accera_vector<vhalf, 32>;
+using vhalfx64_t = accera_vector<vhalf, 64>;
+using vint16_tx2_t = accera_vector<int16_t, 2>;
+using vint16_tx4_t = accera_vector<int16_t, 4>;
+using vint16_tx8_t = accera_vector<int16_t, 8>;
+using vint16_tx16_t = accera_vector<int16_t, 16>;
+using vint16_tx32_t = accera_vector<int16_t, 32>;
+using vint16_tx64_t = accera_vector<int16_t, 64>;
+using vuint16_tx2_t = accera_vector<uint16_t, 2>;
+using vuint16_tx4_t = accera_vector<uint16_t, 4>;
+using vuint16_tx8_t = accera_vector<uint16_t, 8>;
+using vuint16_tx16_t = accera_vector<uint16_t, 16>;
+using vuint16_tx32_t = accera_vector<uint16_t, 32>;
+using vuint16_tx64_t = accera_vector<uint16_t, 64>;
 #endif // !defined(__HIP_PLATFORM_AMD__)
 
+// Vector load or store at an element address: a single wide access when the address is aligned to the vector, which
+// is the common case for unit-stride accesses into arrays, and element accesses otherwise
+template <typename V, typename T>
+struct vector_ref
+{
+    static constexpr int size = sizeof(V) / sizeof(T);
+    T* ptr;
+
+    __device__ __forceinline__ bool aligned() const { return reinterpret_cast<unsigned long long>(ptr) % sizeof(V) == 0; }
+
+    __device__ __forceinline__ operator V() const
+    {
+        if (aligned()) return *reinterpret_cast<const V*>(ptr);
+        V value;
+#pragma unroll
+        for (int i = 0; i < size; ++i) value[i] = ptr[i];
+        return value;
+    }
+
+    __device__ __forceinline__ void operator=(const V& value) const
+    {
+        if (aligned())
+        {
+            *reinterpret_cast<V*>(ptr) = value;
+            return;
+        }
+#pragma unroll
+        for (int i = 0; i < size; ++i) ptr[i] = value[i];
+    }
+};
+
+template <typename V, typename T>
+__device__ __forceinline__ vector_ref<V, T> vector_access(T* ptr)
+{
+    return { ptr };
+}
+
+#if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 800 && !defined(__HIP_PLATFORM_AMD__)
+#define ACCERA_ASYNC_COPY 1
+#endif
+
+// Global to shared memory copies that bypass the registers (cp.async) on devices of compute capability 8.0 and later,
+// and fall back to regular copies elsewhere
+template <typename T>
+__device__ __forceinline__ void async_copy(T* dst, const T* src)
+{
+#if defined(ACCERA_ASYNC_COPY)
+    if constexpr (sizeof(T) == 4 || sizeof(T) == 8 || sizeof(T) == 16)
+    {
+        __pipeline_memcpy_async(dst, src, sizeof(T));
+        return;
+    }
+#endif
+    *dst = *src;
+}
+
+__device__ __forceinline__ void async_copy_commit()
+{
+#if defined(ACCERA_ASYNC_COPY)
+    __pipeline_commit();
+#endif
+}
+
+template <int NumPendingGroups>
+__device__ __forceinline__ void async_copy_wait()
+{
+#if defined(ACCERA_ASYNC_COPY)
+    __pipeline_wait_prior(NumPendingGroups);
+#endif
+}
+
+#if defined(__HIP_PLATFORM_AMD__)
+#if defined(__AMDGCN_WAVEFRONT_SIZE)
+#define ACCERA_WARP_SIZE __AMDGCN_WAVEFRONT_SIZE
+#else
+#define ACCERA_WARP_SIZE 64
+#endif
+#else
+#define ACCERA_WARP_SIZE 32
+#endif
+
+// The partition of the kernels bound to several devices that the device runs, set by the host before each launch
+__constant__ int accera_device_partition;
+
+// The blocks of a persistent kernel take the blocks of the kernel's grid from a work counter, counters[0], one at a time.
+// counters[1] counts the blocks that ran out of work, and the last of them resets the counters for the next launch, so
+// a persistent kernel can't run concurrently with itself on the same device.
+__device__ __forceinline__ unsigned int accera_next_persistent_block(unsigned int* counters)
+{
+    __shared__ unsigned int block;
+    __syncthreads(); // the threads may still be reading the previous block
+    if (threadIdx.x == 0 && threadIdx.y == 0 && threadIdx.z == 0)
+    {
+        block = atomicAdd(&counters[0], 1u);
+    }
+    __syncthreads();
+    return block;
+}
+
+__device__ __forceinline__ void accera_finish_persistent_block(unsigned int* counters)
+{
+    if (threadIdx.x == 0 && threadIdx.y == 0 && threadIdx.z == 0)
+    {
+        if (atomicAdd(&counters[1], 1u) == gridDim.x * gridDim.y * gridDim.z - 1)
+        {
+            counters[0] = 0;
+            counters[1] = 0;
+            __threadfence();
+        }
+    }
+}
+
+#if !defined(__CUDACC_RTC__) && !defined(__HIPCC_RTC__)
+#if defined(__HIP_PLATFORM_AMD__)
+using accera_stream_t = hipStream_t;
+using accera_graph_t = hipGraph_t;
+using accera_graph_exec_t = hipGraphExec_t;
+#define ACCERA_RUNTIME(NAME) hip##NAME
+#define ACCERA_SYMBOL(SYMBOL) HIP_SYMBOL(SYMBOL)
+#else
+using accera_stream_t = cudaStream_t;
+using accera_graph_t = cudaGraph_t;
+using accera_graph_exec_t = cudaGraphExec_t;
+#define ACCERA_RUNTIME(NAME) cuda##NAME
+#define ACCERA_SYMBOL(SYMBOL) SYMBOL
+#endif
+
+inline __host__ int accera_get_device()
+{
+    int device = 0;
+    (void)ACCERA_RUNTIME(GetDevice)(&device);
+    return device;
+}
+
+// Makes the device that runs a partition the current one. The partitions are dealt round-robin when there are fewer
+// devices than partitions: the launches on the default stream of a device run one after the other.
+inline __host__ void accera_set_device_partition(int partition)
+{
+    int numDevices = 1;
+    (void)ACCERA_RUNTIME(GetDeviceCount)(&numDevices);
+    (void)ACCERA_RUNTIME(SetDevice)(partition % (numDevices > 0 ? numDevices : 1));
+    (void)ACCERA_RUNTIME(MemcpyToSymbol)(ACCERA_SYMBOL(accera_device_partition), &partition, sizeof(partition));
+}
+
+// Waits for the partitions launched on all the devices and makes `device` the current device again
+inline __host__ void accera_finish_device_partitions(int numPartitions, int device)
+{
+    for (int partition = 0; partition < numPartitions; ++partition)
+    {
+        accera_set_device_partition(partition);
+        (void)ACCERA_RUNTIME(DeviceSynchronize)();
+    }
+    (void)ACCERA_RUNTIME(SetDevice)(device);
+}
+
+// The graph that the kernels launched by a function are captured into, see the "gpu_graph" function option. The graph
+// is replayed while the function is called with the arguments it was captured with, and captured again otherwise. The
+// functions whose launches can't be captured, for instance because they call other functions that launch kernels, go
+// back to launching them on the default stream. The function must not be called by several threads at once.
+template <int NumArgs>
+struct accera_graph
+{
+    accera_graph_exec_t exec = nullptr;
+    accera_stream_t stream = nullptr; // blocking, so that it's ordered with the default stream like the launches it replaces
+    unsigned long long args[NumArgs] = {};
+    bool disabled = false;
+};
+
+// The bits of an argument that the graph is captured with
+template <typename T>
+inline __host__ unsigned long long accera_graph_arg(T* pointer)
+{
+    return reinterpret_cast<unsigned long long>(pointer);
+}
+
+template <typename T>
+inline __host__ unsigned long long accera_graph_arg(T value)
+{
+    unsigned long long bits = 0;
+    __builtin_memcpy(&bits, &value, sizeof(T) < sizeof(bits) ? sizeof(T) : sizeof(bits));
+    return bits;
+}
+
+// Launches the graph if it was captured with the same arguments
+template <int NumArgs>
+inline __host__ bool accera_replay_graph(accera_graph<NumArgs>& graph, const unsigned long long (&args)[NumArgs])
+{
+    if (graph.exec == nullptr || graph.disabled)
+    {
+        return false;
+    }
+    for (int i = 0; i < NumArgs; ++i)
+    {
+        if (graph.args[i] != args[i])
+        {
+            return false;
+        }
+    }
+    return ACCERA_RUNTIME(GraphLaunch)(graph.exec, graph.stream) == ACCERA_RUNTIME(Success);
+}
+
+// Starts capturing the launches of the function, and returns the stream to launch the kernels on
+template <int NumArgs>
+inline __host__ accera_stream_t accera_begin_graph_capture(accera_graph<NumArgs>& graph, const unsigned long long (&args)[NumArgs])
+{
+    if (graph.disabled)
+    {
+        return nullptr;
+    }
+    if (graph.exec != nullptr)
+    {
+        (void)ACCERA_RUNTIME(GraphExecDestroy)(graph.exec);
+        graph.exec = nullptr;
+    }
+    if ((graph.stream == nullptr && ACCERA_RUNTIME(StreamCreate)(&graph.stream) != ACCERA_RUNTIME(Success)) ||
+        ACCERA_RUNTIME(StreamBeginCapture)(graph.stream, ACCERA_RUNTIME(StreamCaptureModeThreadLocal)) != ACCERA_RUNTIME(Success))
+    {
+        (void)ACCERA_RUNTIME(GetLastError)();
+        graph.disabled = true;
+        return nullptr;
+    }
+    for (int i = 0; i < NumArgs; ++i)
+    {
+        graph.args[i] = args[i];
+    }
+    return graph.stream;
+}
+
+// Ends the capture and launches the graph. Returns false if the launches couldn't be captured, and have to run again
+// on the default stream.
+template <int NumArgs>
+inline __host__ bool accera_end_graph_capture(accera_graph<NumArgs>& graph)
+{
+    if (graph.disabled)
+    {
+        return true;
+    }
+    accera_graph_t captured = nullptr;
+    auto status = ACCERA_RUNTIME(StreamEndCapture)(graph.stream, &captured);
+    if (status == ACCERA_RUNTIME(Success))
+    {
+        status = ACCERA_RUNTIME(GraphInstantiateWithFlags)(&graph.exec, captured, 0);
+    }
+    if (captured != nullptr)
+    {
+        (void)ACCERA_RUNTIME(GraphDestroy)(captured);
+    }
+    if (status == ACCERA_RUNTIME(Success))
+    {
+        status = ACCERA_RUNTIME(GraphLaunch)(graph.exec, graph.stream);
+    }
+    if (status != ACCERA_RUNTIME(Success))
+    {
+        (void)ACCERA_RUNTIME(GetLastError)();
+        if (graph.exec != nullptr)
+        {
+            (void)ACCERA_RUNTIME(GraphExecDestroy)(graph.exec);
+            graph.exec = nullptr;
+        }
+        graph.disabled = true;
+        return false;
+    }
+    return true;
+}
+#undef ACCERA_SYMBOL
+#undef ACCERA_RUNTIME
+#endif
+
+struct reduce_sum
+{
+    template <typename T>
+    __device__ __forceinline__ T operator()(T a, T b) const { return a + b; }
+
+    // Value that leaves the result unchanged when combined into it
+    template <typename T>
+    __device__ __forceinline__ static T identity(T) { return T{}; }
+};
+
+struct reduce_max
+{
+    template <typename T>
+    __device__ __forceinline__ T operator()(T a, T b) const { return a > b ? a : b; }
+
+    template <typename T>
+    __device__ __forceinline__ static T identity(T value) { return value; }
+};
+
+// Butterfly reduction across the lanes of a warp through register shuffles (DPP / ds_swizzle on AMD GPUs),
+// every lane ends up with the result
+template <typename Op, typename T>
+__device__ __forceinline__ T warp_reduce(T value)
+{
+#pragma unroll
+    for (int offset = ACCERA_WARP_SIZE / 2; offset > 0; offset /= 2)
+    {
+#if defined(__HIP_PLATFORM_AMD__)
+        value = Op{}(value, __shfl_xor(value, offset));
+#else
+        value = Op{}(value, __shfl_xor_sync(0xffffffff, value, offset));
+#endif
+    }
+    return value;
+}
+
+// Reduction across the threads of a block: the warps reduce with shuffles, and only their partial results
+// go through shared memory
+template <typename Op, typename T>
+__device__ __forceinline__ T block_reduce(T value)
+{
+    __shared__ T partials[1024 / ACCERA_WARP_SIZE];
+
+    const int numThreads = blockDim.x * blockDim.y * blockDim.z;
+    const int numWarps = numThreads / ACCERA_WARP_SIZE;
+    const int threadIndex = threadIdx.x + blockDim.x * (threadIdx.y + blockDim.y * threadIdx.z);
+    const int lane = threadIndex % ACCERA_WARP_SIZE;
+
+    value = warp_reduce<Op>(value);
+    if (numWarps <= 1)
+    {
+        return value;
+    }
+
+    __syncthreads(); // a previous reduction may still be reading the partial results
+    if (lane == 0)
+    {
+        partials[threadIndex / ACCERA_WARP_SIZE] = value;
+    }
+    __syncthreads();
+
+    // Every warp combines the partial results so that no broadcast is needed
+    value = lane < numWarps ? partials[lane] : Op::identity(partials[0]);
+    return warp_reduce<Op>(value);
+}
+
 )CUDA";
         }
 
@@ -347,20 +1108,22 @@ using vhalfx64_t = vhalf __attribute__((ext_vector_type(64)));
         auto execRuntime = utilir::ResolveExecutionRuntime(funcOp, /* exact */ false);
         if (execRuntime && (execRuntime != vir::ExecutionRuntime::CUDA &&
                             execRuntime != vir::ExecutionRuntime::ROCM &&
+                            execRuntime != vir::ExecutionRuntime::OPENCL &&
                             // TODO: ugh. remove
                             execRuntime != vir::ExecutionRuntime::DEFAULT))
         {
-            return funcOp.emitError("Expected either CUDA or ROCm runtimes on GPU function");
+            return funcOp.emitError("Expected either CUDA, ROCm or OpenCL runtimes on GPU function");
         }
 
-        if (funcOp->hasAttr(ir::HeaderDeclAttrName) && funcOp->hasAttr(ir::RawPointerAPIAttrName))
+        const bool isOpenCL = state.hasRuntime(Runtime::OPENCL);
+        if (!isOpenCL && funcOp->hasAttr(ir::HeaderDeclAttrName) && funcOp->hasAttr(ir::RawPointerAPIAttrName))
         {
             os << "extern \"C\" ";
         }
 
         // TODO: We treat all functions to be CUDA global functions.
         // Need to add support for device functions
-        os << "__global__ ";
+        os << printer->globalAttrIfCuda();
 
         if (state.hasRuntime(Runtime::CUDA) && funcOp->hasAttrOfType<mlir::ArrayAttr>("blockSize"))
         {
@@ -368,7 +1131,14 @@ using vhalfx64_t = vhalf __attribute__((ext_vector_type(64)));
             auto blockSizeX = arrayAttr[0].getInt();
             auto blockSizeY = arrayAttr[1].getInt();
             auto blockSizeZ = arrayAttr[2].getInt();
-            os << " __launch_bounds__(" << blockSizeX * blockSizeY * blockSizeZ << ") ";
+            if (isOpenCL)
+            {
+                os << " __attribute__((reqd_work_group_size(" << blockSizeX << ", " << blockSizeY << ", " << blockSizeZ << "))) ";
+            }
+            else
+            {
+                os << " __launch_bounds__(" << blockSizeX * blockSizeY * blockSizeZ << ") ";
+            }
         }
 
         auto resultType = funcOp.getType().getResults();
@@ -455,13 +1225,49 @@ using vhalfx64_t = vhalf __attribute__((ext_vector_type(64)));
                 ", ");
         };
 
-        os << launchOp.getKernelName() << "<<<dim3(";
-        pprint(gridSizes);
-        os << "), dim3(";
-        pprint(blockSizes);
-        os << ")>>>(";
-        pprint(operands);
-        os << ")";
+        auto funcOp = dyn_cast_or_null<gpu::GPUFuncOp>(SymbolTable::lookupNearestSymbolFrom(launchOp, launchOp.kernel()));
+        auto persistentBlocks = getPersistentBlocks(funcOp);
+        auto printLaunch = [&] {
+            os << launchOp.getKernelName() << "<<<dim3(";
+            if (persistentBlocks != 0)
+            {
+                os << persistentBlocks << ", 1, 1";
+            }
+            else
+            {
+                pprint(gridSizes);
+            }
+            os << "), dim3(";
+            pprint(blockSizes);
+            os << ")";
+            if (auto hostFuncOp = launchOp->getParentOfType<FuncOp>(); hostFuncOp && hostFuncOp->hasAttr(ir::GPUGraphAttrName))
+            {
+                // Captured into the graph of the function, see CppPrinter::printFuncOp
+                os << ", 0, accera_graph_stream";
+            }
+            os << ">>>(";
+            pprint(operands);
+            os << ")";
+        };
+
+        auto numDevices = getNumDevicePartitions(funcOp);
+        if (numDevices == 1)
+        {
+            printLaunch();
+            return success();
+        }
+
+        // Launches the partitions of the kernel on their devices, they run concurrently
+        os << "{\n";
+        os << "const int accera_device = accera_get_device();\n";
+        os << "for (int accera_partition = 0; accera_partition < " << numDevices << "; ++accera_partition)\n";
+        os << "{\n";
+        os << "accera_set_device_partition(accera_partition);\n";
+        printLaunch();
+        os << ";\n";
+        os << "}\n";
+        os << "accera_finish_device_partitions(" << numDevices << ", accera_device);\n";
+        os << "}";
 
         return success();
     }
@@ -476,6 +1282,16 @@ using vhalfx64_t = vhalf __attribute__((ext_vector_type(64)));
         if (numBlocks > 1)
             return funcOp.emitOpError() << "<<only single block functions supported>>";
 
+        if (numBlocks != 0 && state.hasRuntime(Runtime::OPENCL))
+        {
+            RETURN_IF_FAILED(printWorkSizeComment(funcOp));
+        }
+
+        if (numBlocks != 0 && getPersistentBlocks(funcOp) != 0 && getStreamKDim(funcOp) < 0)
+        {
+            os << "__device__ unsigned int " << funcOp.getName() << "_persistent_counters[2];\n\n";
+        }
+
         // print function declaration
         if (failed(printFunctionDeclaration(funcOp,
                                             /*trailingSemicolon*/ numBlocks == 0)))
@@ -483,7 +1299,70 @@ using vhalfx64_t = vhalf __attribute__((ext_vector_type(64)));
             return funcOp.emitOpError() << "<<failed to print function declaration>>";
         }
 
-        if (numBlocks != 0)
+        auto persistentBlocks = getPersistentBlocks(funcOp);
+        if (numBlocks != 0 && persistentBlocks != 0)
+        {
+            if (state.hasRuntime(Runtime::OPENCL))
+            {
+                return funcOp.emitOpError() << "<<persistent kernels are only supported by the CUDA and ROCm runtimes>>";
+            }
+
+            // The blocks loop over the blocks of the grid, which run the body of the kernel one after the other
+            auto gridSize = getKernelGridSize(funcOp);
+            if (gridSize.size() != 3)
+            {
+                return funcOp.emitOpError() << "<<persistent kernels need a grid size>>";
+            }
+            auto numGridBlocks = std::accumulate(gridSize.begin(), gridSize.end(), int64_t{ 1 }, std::multiplies<int64_t>());
+            if (auto streamKDim = getStreamKDim(funcOp); streamKDim >= 0)
+            {
+                // Stream-K: each block runs an even share of the blocks of the grid, linearized with the split reduction
+                // dimension first so that a block runs consecutive partial sums of as few tiles as possible. The
+                // atomic accumulation of the reduction fixes up the tiles that several blocks share.
+                if (streamKDim > 2)
+                {
+                    return funcOp.emitOpError() << "<<invalid Stream-K grid dimension>>";
+                }
+                llvm::SmallVector<int64_t, 3> order{ streamKDim };
+                for (int64_t dim = 0; dim < 3; ++dim)
+                {
+                    if (dim != streamKDim)
+                    {
+                        order.push_back(dim);
+                    }
+                }
+                std::string blockIdx[3];
+                blockIdx[order[0]] = "accera_block % " + std::to_string(gridSize[order[0]]) + "u";
+                blockIdx[order[1]] = "accera_block / " + std::to_string(gridSize[order[0]]) + "u % " + std::to_string(gridSize[order[1]]) + "u";
+                blockIdx[order[2]] = "accera_block / " + std::to_string(gridSize[order[0]] * gridSize[order[1]]) + "u";
+
+                os << "{\n";
+                os << "const unsigned int accera_first_block = static_cast<unsigned int>(static_cast<unsigned long long>(blockIdx.x) * " << numGridBlocks << "ull / " << persistentBlocks << "ull);\n";
+                os << "const unsigned int accera_last_block = static_cast<unsigned int>((static_cast<unsigned long long>(blockIdx.x) + 1ull) * " << numGridBlocks << "ull / " << persistentBlocks << "ull);\n";
+                os << "for (unsigned int accera_block = accera_first_block; accera_block < accera_last_block; ++accera_block)\n";
+                os << "{\n";
+                os << "const uint3 accera_block_idx = make_uint3(" << blockIdx[0] << ", " << blockIdx[1] << ", " << blockIdx[2] << ");\n";
+                if (failed(printer->printBlock(&(blocks.front()))))
+                    return funcOp.emitOpError() << "<<failed to print function body>>";
+                os << "__syncthreads(); // the threads may still be reading the shared memory of the previous block\n";
+                os << "}\n";
+                os << "}\n";
+            }
+            else
+            {
+                auto counters = (funcOp.getName() + "_persistent_counters").str();
+                os << "{\n";
+                os << "for (unsigned int accera_block = accera_next_persistent_block(" << counters << "); accera_block < " << numGridBlocks << "u; accera_block = accera_next_persistent_block(" << counters << "))\n";
+                os << "{\n";
+                os << "const uint3 accera_block_idx = make_uint3(accera_block % " << gridSize[0] << "u, accera_block / " << gridSize[0] << "u % " << gridSize[1] << "u, accera_block / " << gridSize[0] * gridSize[1] << "u);\n";
+                if (failed(printer->printBlock(&(blocks.front()))))
+                    return funcOp.emitOpError() << "<<failed to print function body>>";
+                os << "}\n";
+                os << "accera_finish_persistent_block(" << counters << ");\n";
+                os << "}\n";
+            }
+        }
+        else if (numBlocks != 0)
         {
             // print function body
             if (failed(printer->printBlock(&(blocks.front()))))
@@ -493,6 +1372,96 @@ using vhalfx64_t = vhalf __attribute__((ext_vector_type(64)));
 
         os << "\n\n";
 
+        if (numBlocks != 0 && !state.hasRuntime(Runtime::OPENCL))
+        {
+            RETURN_IF_FAILED(printStreamLauncher(funcOp));
+        }
+
+        return success();
+    }
+
+    LogicalResult GpuDialectCppPrinter::printStreamLauncher(gpu::GPUFuncOp funcOp)
+    {
+        // Kernels launched by a public function are named after it, see CreateDeviceFuncLauncherPairPattern
+        constexpr llvm::StringLiteral kernelSuffix = "__gpu__";
+        auto kernelName = funcOp.getName();
+        auto gridSize = funcOp->getAttrOfType<ArrayAttr>("gridSize");
+        auto blockSize = funcOp->getAttrOfType<ArrayAttr>("blockSize");
+        if (!kernelName.endswith(kernelSuffix) || !funcOp->hasAttr(ir::HeaderDeclAttrName) || !gridSize || !blockSize)
+        {
+            return success();
+        }
+
+        // A stream belongs to a single device
+        if (getNumDevicePartitions(funcOp) != 1)
+        {
+            return success();
+        }
+
+        auto printDim3 = [&](ArrayAttr dims) {
+            os << "dim3(";
+            llvm::interleaveComma(utilir::ArrayAttrToVector<IntegerAttr>(dims), os, [&](IntegerAttr dim) { os << dim.getInt(); });
+            os << ")";
+        };
+
+        // Runtime compilers only build the device code
+        os << "#if !defined(__CUDACC_RTC__) && !defined(__HIPCC_RTC__)\n";
+        os << "extern \"C\" __host__ void " << kernelName.drop_back(kernelSuffix.size()) << "_stream(";
+        for (auto arg : funcOp.getArguments())
+        {
+            RETURN_IF_FAILED(printer->printBlockArgument(arg));
+            os << ", ";
+        }
+        os << "void* stream) {\n";
+
+        os << kernelName << "<<<";
+        if (auto persistentBlocks = getPersistentBlocks(funcOp); persistentBlocks != 0)
+        {
+            os << "dim3(" << persistentBlocks << ", 1, 1)";
+        }
+        else
+        {
+            printDim3(gridSize);
+        }
+        os << ", ";
+        printDim3(blockSize);
+        os << ", 0, static_cast<accera_stream_t>(stream)>>>(";
+        llvm::interleaveComma(funcOp.getArguments(), os, [&](BlockArgument arg) { os << state.nameState.getName(arg); });
+        os << ");\n";
+        os << "}\n";
+        os << "#endif\n\n";
+
+        return success();
+    }
+
+    LogicalResult GpuDialectCppPrinter::printWorkSizeComment(gpu::GPUFuncOp funcOp)
+    {
+        auto gridSize = funcOp->getAttrOfType<ArrayAttr>("gridSize");
+        auto blockSize = funcOp->getAttrOfType<ArrayAttr>("blockSize");
+        if (!gridSize || !blockSize)
+        {
+            return success();
+        }
+
+        llvm::SmallVector<int64_t, 3> gridDims, blockDims, globalDims;
+        for (auto [gridDim, blockDim] : llvm::zip(utilir::ArrayAttrToVector<IntegerAttr>(gridSize), utilir::ArrayAttrToVector<IntegerAttr>(blockSize)))
+        {
+            gridDims.push_back(gridDim.getInt());
+            blockDims.push_back(blockDim.getInt());
+            globalDims.push_back(gridDim.getInt() * blockDim.getInt());
+        }
+
+        // The CUDA notation of the launch is what the HAT packaging parses, see Package.build
+        os << "// " << funcOp.getName() << "<<<dim3(";
+        llvm::interleaveComma(gridDims, os);
+        os << "), dim3(";
+        llvm::interleaveComma(blockDims, os);
+        os << ")>>>\n";
+        os << "// Enqueued with a global work size of (";
+        llvm::interleaveComma(globalDims, os);
+        os << ") and a local work size of (";
+        llvm::interleaveComma(blockDims, os);
+        os << ")\n";
         return success();
     }
 
@@ -11,6 +11,8 @@
 #include <mlir/Dialect/GPU/GPUDialect.h>
 #include <mlir/Support/LogicalResult.h>
 
+#include <ir/include/value/ValueDialect.h>
+
 #include "CppPrinter.h"
 
 namespace mlir
@@ -37,10 +39,22 @@ namespace cpp_printer
         LogicalResult printVectorTypeArrayDecl(VectorType vecType,
                                                StringRef vecVar) override;
 
+        /// print the tensor core fragment types of the subgroup MMA ops
+        LogicalResult printDialectType(Type type, bool* consumed) override;
+
         /// print the function delcaration for the given GPUFuncOp.
         /// A trailing semicolon will be generated if trailingSemiColon is true.
         LogicalResult printFunctionDeclaration(gpu::GPUFuncOp funcOp, bool trailingSemiColon);
 
+        /// print a host function that launches the given kernel on a stream provided by the caller,
+        /// if the kernel is launched by a public function.
+        LogicalResult printStreamLauncher(gpu::GPUFuncOp funcOp);
+
+        /// print the launch configuration of an OpenCL kernel as a comment, since the host code that enqueues it
+        /// is not part of the OpenCL C program.
+        LogicalResult printWorkSizeComment(gpu::GPUFuncOp funcOp);
+
+        LogicalResult printOp(AtomicRMWOp);
         LogicalResult printOp(gpu::BarrierOp);
         LogicalResult printOp(gpu::BlockDimOp);
         LogicalResult printOp(gpu::BlockIdOp);
@@ -50,12 +64,24 @@ namespace cpp_printer
         LogicalResult printOp(gpu::LaunchFuncOp);
         LogicalResult printOp(gpu::ModuleEndOp);
         LogicalResult printOp(gpu::ReturnOp);
+        LogicalResult printOp(gpu::SubgroupMmaComputeOp);
+        LogicalResult printOp(gpu::SubgroupMmaConstantMatrixOp);
+        LogicalResult printOp(gpu::SubgroupMmaLoadMatrixOp);
+        LogicalResult printOp(gpu::SubgroupMmaStoreMatrixOp);
         LogicalResult printOp(gpu::ThreadIdOp);
+        LogicalResult printOp(accera::ir::value::GPUAsyncCopyOp);
+        LogicalResult printOp(accera::ir::value::GPUAsyncCopyCommitOp);
+        LogicalResult printOp(accera::ir::value::GPUAsyncCopyWaitOp);
+        LogicalResult printOp(accera::ir::value::GPUDevicePartitionOp);
+        LogicalResult printOp(accera::ir::value::GPUReduceOp);
 
         LogicalResult printGpuFPVectorType(VectorType vecType, StringRef vecVar);
 
         LogicalResult printGPUIndexType();
 
+        /// print a pointer to the element of memref at the given indices
+        LogicalResult printMemRefElementAddress(Value memref, ValueRange indices);
+
     private:
         llvm::SmallVector<gpu::GPUModuleOp> _gpuModuleOps;
     };
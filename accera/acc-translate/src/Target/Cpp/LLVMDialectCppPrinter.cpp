@@ -17,6 +17,11 @@ namespace cpp_printer
     {
         if (op.syncscope() == "agent" && op.ordering() == LLVM::AtomicOrdering::seq_cst)
         {
+            if (state.hasRuntime(Runtime::OPENCL))
+            {
+                os << "atomic_work_item_fence(CLK_GLOBAL_MEM_FENCE, memory_order_seq_cst, memory_scope_device)";
+                return success();
+            }
             os << "__threadfence()";
             return success();
         }
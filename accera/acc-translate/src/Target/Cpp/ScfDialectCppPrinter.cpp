@@ -106,6 +106,13 @@ namespace cpp_printer
                 RETURN_IF_FAILED(printer->printType(tp));
                 os << " " << retName << " = " << valName << ";\n";
 
+                // OpenCL C has no references, the argument is named after the result instead
+                if (state.hasRuntime(Runtime::OPENCL))
+                {
+                    state.nameState.addNameAlias(std::get<1>(e), ret);
+                    continue;
+                }
+
                 RETURN_IF_FAILED(printer->printType(tp));
                 os << " &" << argName << " = " << retName << ";\n";
             }
@@ -612,6 +612,12 @@ namespace cpp_printer
 
     LogicalResult StdDialectCppPrinter::printHeaderFiles()
     {
+        // OpenCL C has the math functions and fixed-width types built in (see the GPU header)
+        if (state.hasRuntime(Runtime::OPENCL))
+        {
+            return success();
+        }
+
         llvm::SmallVector<llvm::StringRef, 2> system_header_files = { "math.h",
                                                                       "stdint.h" };
 
@@ -654,6 +660,19 @@ namespace cpp_printer
 #endif // _MSC_VER
 #endif // __forceinline__
 
+#if !defined(_MSC_VER) && !defined(ACCERA_VECTOR_TYPES)
+#define ACCERA_VECTOR_TYPES
+// Vectors of the GCC and Clang vector extension, which the host compiler maps to the SIMD instructions of the target.
+// They are aligned to their elements, so that loads and stores at any element address are valid.
+template <typename T, int N>
+struct accera_vector_type
+{
+    typedef T type __attribute__((vector_size(sizeof(T) * N), aligned(sizeof(T))));
+};
+template <typename T, int N>
+using accera_vector_t = typename accera_vector_type<T, N>::type;
+#endif // !defined(_MSC_VER) && !defined(ACCERA_VECTOR_TYPES)
+
 )STD";
         }
 
@@ -21,9 +21,10 @@ using namespace llvm;
 namespace mlir
 {
 
-LogicalResult translateModuleToCpp(Operation* m, raw_ostream& os, int indexBitwidth)
+LogicalResult translateModuleToCpp(Operation* m, raw_ostream& os, int indexBitwidth, bool headerOnly)
 {
     cpp_printer::CppPrinter printer(os, indexBitwidth);
+    printer.getPrinterState().headerOnly = headerOnly;
 #if 1
     auto context = m->getContext();
 
@@ -19,8 +19,8 @@ namespace mlir
 {
 class Operation;
 
-/// Convert the given model operation into C++ code.
-LogicalResult translateModuleToCpp(Operation* m, raw_ostream& os, int indexBitwidth);
+/// Convert the given model operation into C++ code, or into a header of static inline functions if headerOnly is set.
+LogicalResult translateModuleToCpp(Operation* m, raw_ostream& os, int indexBitwidth, bool headerOnly = false);
 
 } // namespace mlir
 
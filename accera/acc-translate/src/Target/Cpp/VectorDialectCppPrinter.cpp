@@ -58,6 +58,36 @@ namespace cpp_printer
     {
         return printer->printMemRefLoadOrStore(false, op.base(), op.getMemRefType(), op.indices(), op.valueToStore());
     }
+
+    // Only in-bounds transfers of contiguous elements along the innermost dimension of a memref, which the vectorizer
+    // emits for unit-stride accesses, map to a single vector load or store
+    static bool isContiguousTransfer(VectorTransferOpInterface op)
+    {
+        return op.getVectorType().getRank() == 1 &&
+               op.getShapedType().isa<MemRefType>() &&
+               op.permutation_map().isMinorIdentity() &&
+               op.isDimInBounds(0);
+    }
+
+    LogicalResult VectorDialectCppPrinter::printTransferReadOp(vector::TransferReadOp op)
+    {
+        if (!isContiguousTransfer(op))
+        {
+            os << "<<non-contiguous vector.transfer_read is not supported>>";
+            return failure();
+        }
+        return printer->printMemRefLoadOrStore(true, op.source(), op.getShapedType().cast<MemRefType>(), op.indices(), op.getResult());
+    }
+
+    LogicalResult VectorDialectCppPrinter::printTransferWriteOp(vector::TransferWriteOp op)
+    {
+        if (!isContiguousTransfer(op))
+        {
+            os << "<<non-contiguous vector.transfer_write is not supported>>";
+            return failure();
+        }
+        return printer->printMemRefLoadOrStore(false, op.source(), op.getShapedType().cast<MemRefType>(), op.indices(), op.vector());
+    }
     
     LogicalResult VectorDialectCppPrinter::printBroadcastOp(vector::BroadcastOp op)
     {
@@ -76,6 +106,16 @@ namespace cpp_printer
 
         RETURN_IF_FAILED(printer->printType(vecTy));
         os << " " << idx;
+
+        // OpenCL C vector literals replicate a single scalar
+        if (state.hasRuntime(Runtime::OPENCL))
+        {
+            os << " = (";
+            RETURN_IF_FAILED(printer->printType(vecTy));
+            os << ")(" << state.nameState.getName(source) << ")";
+            return success();
+        }
+
         os << "{";
         for (int i = 0; i < vecTy.getNumElements(); i++) {
             os << " ";
@@ -103,6 +143,10 @@ namespace cpp_printer
             return printLoadOp(loadOp);
         if (auto storeOp = dyn_cast<mlir::vector::StoreOp>(op))
             return printStoreOp(storeOp);
+        if (auto transferReadOp = dyn_cast<mlir::vector::TransferReadOp>(op))
+            return printTransferReadOp(transferReadOp);
+        if (auto transferWriteOp = dyn_cast<mlir::vector::TransferWriteOp>(op))
+            return printTransferWriteOp(transferWriteOp);
         if (auto broadcastOp = dyn_cast<mlir::vector::BroadcastOp>(op))
             return printBroadcastOp(broadcastOp);
 
@@ -29,6 +29,8 @@ namespace cpp_printer
         LogicalResult printInsertElementOp(vector::InsertElementOp op);
         LogicalResult printLoadOp(vector::LoadOp op);
         LogicalResult printStoreOp(vector::StoreOp op);
+        LogicalResult printTransferReadOp(vector::TransferReadOp op);
+        LogicalResult printTransferWriteOp(vector::TransferWriteOp op);
         LogicalResult printBroadcastOp(vector::BroadcastOp op);
     };
 
@@ -5,8 +5,13 @@
 # Requires: Python 3.7+
 ####################################################################################################
 
+import copy
+import hashlib
+import json
 import os
+import re
 import shutil
+from concurrent.futures import ThreadPoolExecutor
 from enum import Enum, auto
 
 from .utilities import *
@@ -29,6 +34,9 @@ class SystemTarget(Enum):
     RPI0 = "pi0"
     ARM_CORTEX_M4 = "cortex-m4"
     ARM_CORTEX_M4F = "cortex-m4f"
+    NEOVERSE_N1 = "neoverse-n1"
+    NEOVERSE_V1 = "neoverse-v1"
+    APPLE_M1 = "apple-m1"
 
 
 class Runtime(Enum):
@@ -42,6 +50,27 @@ class Runtime(Enum):
 
 system_target_options = [t.value for t in SystemTarget]
 
+# The targets whose cache buffers and temporary arrays are placed in a single statically sized arena
+STATIC_ARENA_SYSTEM_TARGETS = [SystemTarget.ARM_CORTEX_M4.value, SystemTarget.ARM_CORTEX_M4F.value]
+
+
+def find_hipcc():
+    "Returns the path to the ROCm HIP compiler, or None if ROCm isn't installed"
+    rocm_path = os.environ.get("ROCM_PATH", "/opt/rocm")
+    hipcc_path = os.path.join(rocm_path, "bin", "hipcc")
+    if os.path.isfile(hipcc_path):
+        return hipcc_path
+    return shutil.which("hipcc")
+
+
+def find_nvcc():
+    "Returns the path to the CUDA compiler, or None if the CUDA toolkit isn't installed"
+    cuda_path = os.environ.get("CUDA_PATH", "/usr/local/cuda")
+    nvcc_path = os.path.join(cuda_path, "bin", "nvcc")
+    if os.path.isfile(nvcc_path):
+        return nvcc_path
+    return shutil.which("nvcc")
+
 # Features are modeled by a kvp where the value is an optional lambda that does verification of a feature
 # option (for example, ensuring that the number of threads is >= 0. If None is used instead, then the
 # feature does not accept a value.
@@ -71,31 +100,178 @@ OS_OPTS = {
 }
 
 
-def DEFAULT_RC_MLIR_LOWERING_PASSES(
+def RC_MLIR_LOWERING_OPTIONS(
     dump=False,
     dump_intrapass_ir=False,
     system_target=SystemTarget.HOST.value,
     profile=False,
+    profile_counters=None,
+    profile_timer=None,
+    profile_regions=None,
     runtime=Runtime.DEFAULT.value,
-    gpu_only=False
+    gpu_only=False,
+    vectorization_report_path=None,
+    gpu_chip=None,
+    gpu_resource_report_path=None,
+    cost_model_report_path=None,
+    compile_stats_report_path=None,
+    unroll_code_size_budget=None,
+    unroll_report_path=None,
+    cache_copy_report_path=None,
+    outline_cache_copies=False,
+    count_memory_traffic=False,
+    line_info_path=None,
+    arena_report_path=None,
+    analysis_only=False
 ):
     def bstr(val):
         return "true" if val else "false"
 
-    acc_to_llvm_str = " ".join([
+    acc_to_llvm_args = [
         f'dump-passes={bstr(dump)}',
         f'dump-intra-pass-ir={bstr(dump_intrapass_ir)}',
         f'runtime={str(runtime).lower()}',
         f'target={system_target}',
         f'enable-profiling={bstr(profile)}',
         f'gpu-only={bstr(gpu_only)}',
-    ])
-
-    return [f'--acc-to-llvm="{acc_to_llvm_str}"']
+    ]
+    if profile and profile_counters:
+        acc_to_llvm_args.append(f'profile-counters={",".join(profile_counters)}')
+    if profile and profile_timer:
+        acc_to_llvm_args.append(f'profile-timer={profile_timer}')
+    if profile and profile_regions:
+        # the regions are "functions", "loops" or "cache-copies"
+        acc_to_llvm_args += [f'profile-{region}=true' for region in profile_regions]
+    if vectorization_report_path:
+        acc_to_llvm_args.append(f'vectorization-report={vectorization_report_path}')
+    if gpu_chip:
+        acc_to_llvm_args.append(f'gpu-chip={gpu_chip}')
+    if gpu_resource_report_path:
+        acc_to_llvm_args.append(f'gpu-resource-report={gpu_resource_report_path}')
+    if cost_model_report_path:
+        acc_to_llvm_args.append(f'cost-model-report={cost_model_report_path}')
+    if compile_stats_report_path:
+        acc_to_llvm_args.append(f'compile-stats-report={compile_stats_report_path}')
+    if unroll_code_size_budget:
+        acc_to_llvm_args.append(f'unroll-code-size-budget={unroll_code_size_budget}')
+    if unroll_report_path:
+        acc_to_llvm_args.append(f'unroll-report={unroll_report_path}')
+    if cache_copy_report_path:
+        acc_to_llvm_args.append(f'cache-copy-report={cache_copy_report_path}')
+    if outline_cache_copies:
+        acc_to_llvm_args.append('outline-cache-copies=true')
+    if count_memory_traffic:
+        acc_to_llvm_args.append('count-memory-traffic=true')
+    if line_info_path:
+        acc_to_llvm_args.append(f'line-info={line_info_path}')
+    if system_target in STATIC_ARENA_SYSTEM_TARGETS:
+        # microcontrollers have no heap, the buffers of all functions are carved from one static arena
+        acc_to_llvm_args.append('static-arena=true')
+        if arena_report_path:
+            acc_to_llvm_args.append(f'arena-report={arena_report_path}')
+    if analysis_only:
+        acc_to_llvm_args.append('analysis-only=true')
+    return " ".join(acc_to_llvm_args)
+
+
+def DEFAULT_RC_MLIR_LOWERING_PASSES(**kwargs):
+    return [f'--acc-to-llvm="{RC_MLIR_LOWERING_OPTIONS(**kwargs)}"']
 
 
 DEFAULT_RC_OPT_ARGS = ["--verify-each=false"]
 
+# The MLIR pass timing report, which acc-opt prints to stderr once the lowering is done
+PASS_TIMING_RC_OPT_ARGS = ["--mlir-timing", "--mlir-timing-display=list"]
+
+
+def extract_pass_timing_report(log):
+    """Returns the MLIR pass timing report that is printed in the log, or None if there isn't one"""
+    lines = log.splitlines(keepends=True)
+    for i in range(1, len(lines)):
+        if "Execution time report" in lines[i] and lines[i - 1].startswith("===-"):
+            return "".join(lines[i - 1:])
+    return None
+
+
+def extract_ptxas_resource_usage(log):
+    """Returns the registers, spills, stack and shared memory of each kernel that ptxas reports in the log of a
+    compilation with `-Xptxas -v`, keyed by kernel name"""
+    usage = {}
+    kernel = None
+    for line in log.splitlines():
+        m = re.search(r"Compiling entry function '([^']+)'", line) or re.search(r"Function properties for (\S+)", line)
+        if m:
+            kernel = usage.setdefault(m[1], {"compiler": "ptxas"})
+            continue
+        if kernel is None:
+            continue
+        m = re.search(r"(\d+) bytes stack frame, (\d+) bytes spill stores, (\d+) bytes spill loads", line)
+        if m:
+            kernel["stack_bytes"], kernel["spill_stores_bytes"], kernel["spill_loads_bytes"] = map(int, m.groups())
+        m = re.search(r"Used (\d+) registers", line)
+        if m:
+            kernel["registers"] = int(m[1])
+            m = re.search(r"(\d+) bytes smem", line)
+            kernel["shared_memory_bytes"] = int(m[1]) if m else 0
+
+    for kernel in usage.values():
+        kernel["spills"] = kernel.get("spill_stores_bytes", 0) > 0 or kernel.get("spill_loads_bytes", 0) > 0
+    return usage
+
+
+# The AMDGPU kernel resource usage remarks and the keys they're reported under
+_AMDGPU_RESOURCE_REMARKS = {
+    "SGPRs": "sgprs",
+    "VGPRs": "vgprs",
+    "AGPRs": "agprs",
+    "ScratchSize [bytes/lane]": "stack_bytes",
+    "Occupancy [waves/SIMD]": "occupancy_waves_per_simd",
+    "SGPRs Spill": "sgpr_spills",
+    "VGPRs Spill": "vgpr_spills",
+    "LDS Size [bytes/block]": "shared_memory_bytes",
+}
+
+
+def extract_amdgpu_resource_usage(log):
+    """Returns the registers, spills, scratch and LDS of each kernel that the AMDGPU backend reports in the log of a
+    compilation with `-Rpass-analysis=kernel-resource-usage`, keyed by kernel name"""
+    usage = {}
+    kernel = None
+    remark = re.compile(r"remark: .*?\s(Function Name|" + "|".join(map(re.escape, _AMDGPU_RESOURCE_REMARKS)) + r"): (\S+)")
+    for line in log.splitlines():
+        m = remark.search(line)
+        if not m:
+            continue
+        if m[1] == "Function Name":
+            kernel = usage.setdefault(m[2], {"compiler": "amdgpu"})
+        elif kernel is not None:
+            kernel[_AMDGPU_RESOURCE_REMARKS[m[1]]] = int(m[2])
+
+    for kernel in usage.values():
+        # the accumulation registers of the matrix cores are allocated per thread like the vector registers
+        kernel["registers"] = kernel.get("vgprs", 0) + kernel.get("agprs", 0)
+        kernel["spills"] = kernel.get("sgpr_spills", 0) > 0 or kernel.get("vgpr_spills", 0) > 0
+    return usage
+
+
+def add_kernel_resource_usage(report_path, logs):
+    """Adds the resource usage that the backend compiler reports in its logs to the kernels of a GPU resource report,
+    as the `"compiled_resources"` of each kernel it compiled"""
+    usage = {}
+    for log in logs:
+        usage.update(extract_ptxas_resource_usage(log))
+        usage.update(extract_amdgpu_resource_usage(log))
+    if not usage:
+        return
+
+    with open(report_path) as report_file:
+        report = json.load(report_file)
+    for kernel in report["kernels"]:
+        if kernel["name"] in usage:
+            kernel["compiled_resources"] = usage[kernel["name"]]
+    with open(report_path, "w") as report_file:
+        json.dump(report, report_file, indent=2)
+
 DEFAULT_ACC_TRANSLATE_ARGS = []
 
 DEFAULT_MLIR_TRANSLATE_ARGS = ["--mlir-print-op-on-diagnostic", "--mlir-to-llvmir"]
@@ -118,6 +294,17 @@ LLVM_TOOLING_OPTS = {
     SystemTarget.ARM_CORTEX_M4F.value: [
         "-Oz", "-mcpu=cortex-m4", "--mtriple=thumbv7em-arm-none-eabi", "-mfpu=fpv4-sp-d16", "-mfloat-abi=hard"
     ],
+    SystemTarget.NEOVERSE_N1.value: [
+        "-O3", "-fp-contract=fast", "--march=aarch64", "-mcpu=neoverse-n1", "--mtriple=aarch64-unknown-linux-gnu"
+    ],
+    # 256-bit vectors are lowered to fixed-length SVE instructions instead of pairs of NEON instructions
+    SystemTarget.NEOVERSE_V1.value: [
+        "-O3", "-fp-contract=fast", "--march=aarch64", "-mcpu=neoverse-v1", "--mtriple=aarch64-unknown-linux-gnu",
+        "-aarch64-sve-vector-bits-min=256"
+    ],
+    SystemTarget.APPLE_M1.value: [
+        "-O3", "-fp-contract=fast", "--march=aarch64", "-mcpu=apple-m1", "--mtriple=arm64-apple-macosx11.0.0"
+    ],
 }
 
 DEFAULT_OPT_ARGS = []
@@ -125,6 +312,37 @@ DEFAULT_OPT_ARGS = []
 DEFAULT_LLC_ARGS = ["-relocation-model=pic"]
 
 
+def get_llvm_tooling_opts(system_target, llvm_cpu=None):
+    """Returns the opt and llc flags of the target, with its CPU replaced by llvm_cpu when given"""
+    if not llvm_cpu:
+        return LLVM_TOOLING_OPTS[system_target]
+    return [flag for flag in LLVM_TOOLING_OPTS[system_target] if not flag.startswith("-mcpu=")] + [f"-mcpu={llvm_cpu}"]
+
+
+def get_in_process_codegen_options(system_target, llvm_cpu=None):
+    """Returns the options of _Module.CompileToObject that are equivalent to the opt and llc flags of the target,
+    or None if some flag has no in-process equivalent"""
+    options = {"triple": "", "cpu": "", "opt_level": 2, "size_level": 0, "fast_fp_contract": False}
+    for flag in get_llvm_tooling_opts(system_target, llvm_cpu):
+        name, _, value = flag.lstrip("-").partition("=")
+        if name in ["O0", "O1", "O2", "O3"]:
+            options["opt_level"] = int(name[1])
+        elif name in ["Os", "Oz"]:
+            options["opt_level"] = 2
+            options["size_level"] = 1 if name == "Os" else 2
+        elif name == "fp-contract" and value == "fast":
+            options["fast_fp_contract"] = True
+        elif name == "mcpu":
+            options["cpu"] = value
+        elif name == "mtriple":
+            options["triple"] = value
+        elif name == "march":
+            pass    # the triple or the module's triple names the architecture
+        else:
+            return None
+    return options
+
+
 def get_default_deploy_shared_libraries(target=CPU_TARGET):
     if target == GPU_TARGET:
         if os.path.isfile(BuildConfig.vulkan_runtime_wrapper_shared_library):
@@ -432,6 +650,7 @@ def deploy_accera_main_project(
 class ModuleOutputType(Enum):
     OBJECT = auto()
     CPP = auto()
+    CPP_HEADER = auto()
     CUDA = auto()
 
 
@@ -446,10 +665,16 @@ class ModuleFileSet:
         ll_ext=".ll",
         opt_ext=".bc",
         cuda_ext=".cu",
-        cpp_ext=".cpp"
+        cpp_ext=".cpp",
+        header_ext=".h",
+        code_object_ext=".hsaco",
+        cubin_ext=".cubin",
+        module=None
     ):
 
         self.module_name = name
+        # The in-memory _Module, which lets object files be compiled in-process instead of from the .mlir file
+        self.module = module
         self.common_module_dir = common_module_dir
         self.output_type = output_type
         self.module_dir = os.path.join(self.common_module_dir, self.module_name)
@@ -470,12 +695,30 @@ class ModuleFileSet:
                 os.path.join(self.module_dir, self.module_name + BuildConfig.asm_extension)
             )
 
-        elif self.output_type in [ModuleOutputType.CUDA, ModuleOutputType.CPP]:
+        elif self.output_type in [ModuleOutputType.CUDA, ModuleOutputType.CPP, ModuleOutputType.CPP_HEADER]:
             ext = {
                 ModuleOutputType.CUDA: cuda_ext,
-                ModuleOutputType.CPP: cpp_ext
+                ModuleOutputType.CPP: cpp_ext,
+                ModuleOutputType.CPP_HEADER: header_ext
             }[self.output_type]
             self.translated_source_filepath = os.path.abspath(os.path.join(self.module_dir, self.module_name + ext))
+            self.code_object_filepath = os.path.abspath(
+                os.path.join(self.module_dir, self.module_name + code_object_ext)
+            )
+            self.cubin_filepath = os.path.abspath(os.path.join(self.module_dir, self.module_name + cubin_ext))
+
+    def for_system_target(self, system_target):
+        """Returns the file set of this module compiled for another system target, whose optimized LLVM IR and object
+        file are in a directory of their own and which shares the lowered MLIR and the translated LLVM IR of this one"""
+        assert self.output_type == ModuleOutputType.OBJECT, "Only object files are compiled for other system targets"
+        target_file_set = copy.copy(self)
+        target_file_set.module_dir = os.path.join(self.module_dir, system_target)
+        for attr in ["optimized_ll_filepath", "object_filepath", "asm_filepath"]:
+            setattr(
+                target_file_set, attr,
+                os.path.join(target_file_set.module_dir, os.path.basename(getattr(self, attr)))
+            )
+        return target_file_set
 
     def __repr__(self):
         desc = [
@@ -524,7 +767,8 @@ class AcceraProject:
         output_type=ModuleOutputType.OBJECT,
         print_subprocess_output=False,
         pretend=False,
-        quiet=True
+        quiet=True,
+        num_workers=1
     ):
 
         self.library_name = library_name
@@ -539,6 +783,7 @@ class AcceraProject:
         self.print_subprocess_output = print_subprocess_output
         self.pretend = pretend
         self.quiet = quiet
+        self.num_workers = num_workers
 
         # Create the logs directory
         self.log_dir = os.path.join(self.output_dir, "logs")
@@ -578,6 +823,65 @@ class AcceraProject:
             self.main_src_filepath = os.path.abspath(main_src_filepath)
             self.main_name = self.library_name + "_main"
 
+    def _for_each_module_file_set(self, fn):
+        # Each step runs in its own process or releases the GIL, so modules are processed concurrently by up to
+        # num_workers threads
+        if self.num_workers > 1 and len(self.module_file_sets) > 1:
+            with ThreadPoolExecutor(max_workers=self.num_workers) as executor:
+                # list() re-raises the first exception of the workers
+                list(executor.map(fn, self.module_file_sets))
+        else:
+            for module_file_set in self.module_file_sets:
+                fn(module_file_set)
+
+    def _get_cache_key(self, module_file_set, options, system_target, llvm_cpu=None):
+        # The key covers the emitted module, the options of each tool and the tools themselves, so that rebuilding
+        # Accera or LLVM invalidates the cached objects
+        hasher = hashlib.sha256()
+        with open(module_file_set.generated_mlir_filepath, "rb") as mlir_file:
+            hasher.update(mlir_file.read())
+
+        tool_options = options + [
+            DEFAULT_RC_OPT_ARGS, DEFAULT_MLIR_TRANSLATE_ARGS, get_llvm_tooling_opts(system_target, llvm_cpu), DEFAULT_OPT_ARGS,
+            DEFAULT_LLC_ARGS
+        ]
+        hasher.update(repr(tool_options).encode("utf-8"))
+
+        for tool in [ACCCConfig.rc_opt, ACCCConfig.mlir_translate, ACCCConfig.llvm_opt, ACCCConfig.llc]:
+            tool_path = shutil.which(tool) or tool
+            if os.path.isfile(tool_path):
+                stat = os.stat(tool_path)
+                hasher.update(f"{os.path.abspath(tool_path)}:{stat.st_size}:{stat.st_mtime_ns}".encode("utf-8"))
+        return hasher.hexdigest()
+
+    @staticmethod
+    def _get_cached_object_path(cache_dir, key):
+        return os.path.join(cache_dir, key[:2], key + BuildConfig.obj_extension)
+
+    def _restore_from_cache(self, cache_dir, key, module_file_set):
+        cached_object_path = AcceraProject._get_cached_object_path(cache_dir, key)
+        if not os.path.isfile(cached_object_path):
+            return False
+        os.makedirs(module_file_set.module_dir, exist_ok=True)
+        shutil.copyfile(cached_object_path, module_file_set.object_filepath)
+        return True
+
+    def _store_in_cache(self, cache_dir, key, module_file_set):
+        cached_object_path = AcceraProject._get_cached_object_path(cache_dir, key)
+        os.makedirs(os.path.dirname(cached_object_path), exist_ok=True)
+
+        # Copy then rename, so that concurrent builds sharing the cache never see a partially written object
+        temp_path = f"{cached_object_path}.{os.getpid()}.tmp"
+        shutil.copyfile(module_file_set.object_filepath, temp_path)
+        os.replace(temp_path, cached_object_path)
+
+    def _store_all_in_cache(self, cache_dir, cache_keys, all_module_file_sets):
+        # Stores the modules that were just built and restores the list of all the modules
+        if cache_keys:
+            for module_file_set in self.module_file_sets:
+                self._store_in_cache(cache_dir, cache_keys[module_file_set.module_name], module_file_set)
+            self.module_file_sets = all_module_file_sets
+
     def make_log_filepaths(self, tag):
         stdout_filename_template = "{}_stdout.txt"
         stderr_filename_template = "{}_stderr.txt"
@@ -717,8 +1021,25 @@ class AcceraProject:
         system_target=SystemTarget.HOST.value,
         runtime=Runtime.DEFAULT.value,
         profile=False,
+        profile_counters=None,
+        profile_timer=None,
+        profile_regions=None,
         quiet=None,
-        gpu_only=False
+        gpu_only=False,
+        vectorization_report_path=None,
+        gpu_chip=None,
+        gpu_resource_report_path=None,
+        cost_model_report_path=None,
+        compile_stats_report_path=None,
+        unroll_code_size_budget=None,
+        unroll_report_path=None,
+        cache_copy_report_path=None,
+        outline_cache_copies=False,
+        count_memory_traffic=False,
+        line_info_path=None,
+        arena_report_path=None,
+        pass_timing=False,
+        analysis_only=False
     ):
 
         quiet = quiet if quiet is not None else self.quiet
@@ -729,7 +1050,23 @@ class AcceraProject:
             system_target=system_target,
             runtime=runtime,
             profile=profile,
-            gpu_only=gpu_only
+            profile_counters=profile_counters,
+            profile_timer=profile_timer,
+            profile_regions=profile_regions,
+            gpu_only=gpu_only,
+            vectorization_report_path=vectorization_report_path,
+            gpu_chip=gpu_chip,
+            gpu_resource_report_path=gpu_resource_report_path,
+            cost_model_report_path=cost_model_report_path,
+            compile_stats_report_path=compile_stats_report_path,
+            unroll_code_size_budget=unroll_code_size_budget,
+            unroll_report_path=unroll_report_path,
+            cache_copy_report_path=cache_copy_report_path,
+            outline_cache_copies=outline_cache_copies,
+            count_memory_traffic=count_memory_traffic,
+            line_info_path=line_info_path,
+            arena_report_path=arena_report_path,
+            analysis_only=analysis_only
         )
 
         if self.print_subprocess_output:
@@ -737,8 +1074,10 @@ class AcceraProject:
 
         rc_opt_exe = os.path.abspath(ACCCConfig.rc_opt)
         rc_opt_base_args = rc_opt_args or DEFAULT_RC_OPT_ARGS
+        if pass_timing:
+            rc_opt_base_args = rc_opt_base_args + PASS_TIMING_RC_OPT_ARGS
 
-        for module_file_set in self.module_file_sets:
+        def run(module_file_set):
             current_output_path = module_file_set.module_dir
 
             makedir(current_output_path, pretend=pretend, quiet=quiet)
@@ -765,6 +1104,65 @@ class AcceraProject:
                     quiet=quiet
                 )
 
+        self._for_each_module_file_set(run)
+
+    def compile_in_process(
+        self,
+        codegen_options,
+        system_target=SystemTarget.HOST.value,
+        runtime=Runtime.DEFAULT.value,
+        profile=False,
+        profile_counters=None,
+        profile_timer=None,
+        profile_regions=None,
+        vectorization_report_path=None,
+        cost_model_report_path=None,
+        compile_stats_report_path=None,
+        unroll_code_size_budget=None,
+        unroll_report_path=None,
+        cache_copy_report_path=None,
+        outline_cache_copies=False,
+        count_memory_traffic=False,
+        line_info_path=None,
+        arena_report_path=None,
+        pass_timing_report_path=None,
+        quiet=None
+    ):
+        """Does what lower_mlir, translate_mlir_with_mlir_translate, optimize_llvm, generate_object and generate_asm
+        do, without the processes and the intermediate files in between"""
+
+        pipeline_options = RC_MLIR_LOWERING_OPTIONS(
+            system_target=system_target,
+            runtime=runtime,
+            profile=profile,
+            profile_counters=profile_counters,
+            profile_timer=profile_timer,
+            profile_regions=profile_regions,
+            vectorization_report_path=vectorization_report_path,
+            cost_model_report_path=cost_model_report_path,
+            compile_stats_report_path=compile_stats_report_path,
+            unroll_code_size_budget=unroll_code_size_budget,
+            unroll_report_path=unroll_report_path,
+            cache_copy_report_path=cache_copy_report_path,
+            outline_cache_copies=outline_cache_copies,
+            count_memory_traffic=count_memory_traffic,
+            line_info_path=line_info_path,
+            arena_report_path=arena_report_path
+        )
+        quiet = quiet if quiet is not None else self.quiet
+
+        def run(module_file_set):
+            makedir(module_file_set.module_dir, quiet=quiet)
+            module_file_set.module.CompileToObject(
+                pipeline_options=pipeline_options,
+                object_path=module_file_set.object_filepath,
+                asm_path=module_file_set.asm_filepath,
+                pass_timing_path=pass_timing_report_path or "",
+                **codegen_options
+            )
+
+        self._for_each_module_file_set(run)
+
     def translate_mlir_with_acc_translate(
         self,
         acc_translate_args=None,
@@ -780,11 +1178,12 @@ class AcceraProject:
         if self.print_subprocess_output:
             stdout = None
             stderr = None
-        for module_file_set in self.module_file_sets:
 
+        def run(module_file_set):
             output_type_args = {
                 ModuleOutputType.CUDA: ["-print-cpp"],
                 ModuleOutputType.CPP: ["-print-cpp"],
+                ModuleOutputType.CPP_HEADER: ["-print-cpp", "-header-only"],
             }
 
             acc_translate_exe = os.path.abspath(ACCCConfig.acc_translate)
@@ -802,6 +1201,76 @@ class AcceraProject:
                 quiet=quiet
             )
 
+        self._for_each_module_file_set(run)
+
+    def generate_hip_code_object(
+        self, offload_arch, resource_usage=False, stdout=None, stderr=None, pretend=False, quiet=None
+    ):
+        """Compiles the translated HIP source ahead of time into an HSACO code object, which the host
+        loads with `hipModuleLoadData`. Nothing is emitted when the ROCm compiler isn't installed.
+        With `resource_usage`, the backend reports the registers, spills and LDS of each kernel to stderr."""
+
+        quiet = quiet if quiet is not None else self.quiet
+
+        hipcc_exe = find_hipcc()
+        if not hipcc_exe:
+            return
+
+        if self.print_subprocess_output:
+            stdout = None
+            stderr = None
+
+        def run(module_file_set):
+            hipcc_args = [
+                "--genco", f"--offload-arch={offload_arch}", "-O3", "-x hip",
+                f'-o "{module_file_set.code_object_filepath}"', f'"{module_file_set.translated_source_filepath}"'
+            ]
+            if resource_usage:
+                hipcc_args.append("-Rpass-analysis=kernel-resource-usage")
+            hipcc_command = " ".join([f'"{hipcc_exe}"'] + hipcc_args)
+            run_command(
+                hipcc_command,
+                working_directory=self.intermediate_working_dir,
+                stdout=stdout,
+                stderr=stderr,
+                pretend=pretend,
+                quiet=quiet
+            )
+
+        self._for_each_module_file_set(run)
+
+    def generate_cuda_cubin(self, arch, stdout=None, stderr=None, pretend=False, quiet=None):
+        """Compiles the translated CUDA source into a cubin for the `sm_XX` architecture `arch`, with ptxas reporting
+        the registers, spills and shared memory of each kernel to stderr. The cubin isn't deployed, the kernels are
+        compiled again when the source is. Nothing is emitted when the CUDA toolkit isn't installed."""
+
+        quiet = quiet if quiet is not None else self.quiet
+
+        nvcc_exe = find_nvcc()
+        if not nvcc_exe:
+            return
+
+        if self.print_subprocess_output:
+            stdout = None
+            stderr = None
+
+        def run(module_file_set):
+            nvcc_args = [
+                "-cubin", f"-arch={arch}", "-O3", "-Xptxas -v", f'-o "{module_file_set.cubin_filepath}"',
+                f'"{module_file_set.translated_source_filepath}"'
+            ]
+            nvcc_command = " ".join([f'"{nvcc_exe}"'] + nvcc_args)
+            run_command(
+                nvcc_command,
+                working_directory=self.intermediate_working_dir,
+                stdout=stdout,
+                stderr=stderr,
+                pretend=pretend,
+                quiet=quiet
+            )
+
+        self._for_each_module_file_set(run)
+
     def translate_mlir_with_mlir_translate(
         self,
         mlir_translate_args=None,
@@ -817,7 +1286,8 @@ class AcceraProject:
         if self.print_subprocess_output:
             stdout = None
             stderr = None
-        for module_file_set in self.module_file_sets:
+
+        def run(module_file_set):
             mlir_translate_exe = os.path.abspath(ACCCConfig.mlir_translate)
             full_mlir_translate_args = []    # empty list every iteration
             full_mlir_translate_args += mlir_translate_args or DEFAULT_MLIR_TRANSLATE_ARGS
@@ -833,6 +1303,8 @@ class AcceraProject:
                 quiet=quiet
             )
 
+        self._for_each_module_file_set(run)
+
     def optimize_llvm(
         self,
         llvm_opt_args=None,
@@ -848,7 +1320,8 @@ class AcceraProject:
         if self.print_subprocess_output:
             stdout = None
             stderr = None
-        for module_file_set in self.module_file_sets:
+
+        def run(module_file_set):
             llvm_opt_exe = os.path.abspath(ACCCConfig.llvm_opt)
             full_llvm_opt_args = []    # empty list every iteration
             full_llvm_opt_args += llvm_opt_args or (LLVM_TOOLING_OPTS[system_target] + DEFAULT_OPT_ARGS)
@@ -864,6 +1337,8 @@ class AcceraProject:
                 quiet=quiet
             )
 
+        self._for_each_module_file_set(run)
+
     def generate_object(
         self,
         llc_args=None,
@@ -879,7 +1354,8 @@ class AcceraProject:
         if self.print_subprocess_output:
             stdout = None
             stderr = None
-        for module_file_set in self.module_file_sets:
+
+        def run(module_file_set):
             llc_exe = os.path.abspath(ACCCConfig.llc)
             full_llc_args = []    # empty list every iteration
             full_llc_args += llc_args or (LLVM_TOOLING_OPTS[system_target] + DEFAULT_LLC_ARGS)
@@ -896,6 +1372,8 @@ class AcceraProject:
                 quiet=quiet
             )
 
+        self._for_each_module_file_set(run)
+
     def generate_asm(
         self,
         llc_args=None,
@@ -911,7 +1389,8 @@ class AcceraProject:
         if self.print_subprocess_output:
             stdout = None
             stderr = None
-        for module_file_set in self.module_file_sets:
+
+        def run(module_file_set):
             llc_exe = os.path.abspath(ACCCConfig.llc)
             full_llc_args = []    # empty list every iteration
             full_llc_args += llc_args or (LLVM_TOOLING_OPTS[system_target] + DEFAULT_LLC_ARGS)
@@ -928,6 +1407,58 @@ class AcceraProject:
                 quiet=quiet
             )
 
+        self._for_each_module_file_set(run)
+
+    def generate_objects_for_system_targets(self, system_targets, pretend=False, quiet=None):
+        """Optimizes and compiles the translated LLVM IR of the modules for each of the system targets, which must
+        share the data layout of the target the modules were lowered for. Every module is compiled for every target
+        concurrently. Returns the module file sets of each target."""
+
+        quiet = quiet if quiet is not None else self.quiet
+
+        target_module_file_sets = {
+            system_target: [module_file_set.for_system_target(system_target) for module_file_set in self.module_file_sets]
+            for system_target in system_targets
+        }
+
+        def run(system_target, module_file_set):
+            makedir(module_file_set.module_dir, pretend=pretend, quiet=quiet)
+            log_files = self.make_log_filepaths(f"codegen_{system_target}_{module_file_set.module_name}")
+            with OpenFile(log_files[self.stdout_key], "w", pretend=pretend) as stdout_file:
+                with OpenFile(log_files[self.stderr_key], "w", pretend=pretend) as stderr_file:
+                    stdout, stderr = (None, None) if self.print_subprocess_output else (stdout_file, stderr_file)
+                    llvm_tooling_opts = get_llvm_tooling_opts(system_target)
+                    steps = [
+                        (
+                            ACCCConfig.llvm_opt, llvm_tooling_opts + DEFAULT_OPT_ARGS,
+                            module_file_set.translated_ll_filepath, module_file_set.optimized_ll_filepath
+                        ),
+                        (
+                            ACCCConfig.llc, llvm_tooling_opts + DEFAULT_LLC_ARGS + ["-filetype=obj"],
+                            module_file_set.optimized_ll_filepath, module_file_set.object_filepath
+                        ),
+                    ]
+                    for tool, args, input_filepath, output_filepath in steps:
+                        command = " ".join([f'"{os.path.abspath(tool)}"'] + args +
+                                           [f'-o="{output_filepath}"', f'"{input_filepath}"'])
+                        run_command(
+                            command,
+                            working_directory=self.intermediate_working_dir,
+                            stdout=stdout,
+                            stderr=stderr,
+                            pretend=pretend,
+                            quiet=quiet
+                        )
+
+        jobs = [(system_target, module_file_set)
+                for system_target, module_file_sets in target_module_file_sets.items()
+                for module_file_set in module_file_sets]
+        with ThreadPoolExecutor(max_workers=max(1, min(len(jobs), os.cpu_count() or 1))) as executor:
+            # list() re-raises the first exception of the workers
+            list(executor.map(lambda job: run(*job), jobs))
+
+        return target_module_file_sets
+
     def build_static_lib(
         self,
         build_dir_name="build",
@@ -962,13 +1493,35 @@ class AcceraProject:
         generator_parameters=None,
         build_config=build_config_types[0],
         profile=False,
+        profile_counters=None,
+        profile_timer=None,
+        profile_regions=None,
         dump_all_passes=False,
         dump_intrapass_ir=False,
         pretend=False,
         system_target=SystemTarget.HOST.value,
         runtime=Runtime.DEFAULT.value,
         quiet=None,
-        gpu_only=False
+        gpu_only=False,
+        vectorization_report_path=None,
+        gpu_chip=None,
+        cuda_arch=None,
+        gpu_resource_report_path=None,
+        cost_model_report_path=None,
+        compile_stats_report_path=None,
+        pass_timing_report_path=None,
+        unroll_code_size_budget=None,
+        unroll_report_path=None,
+        cache_copy_report_path=None,
+        outline_cache_copies=False,
+        count_memory_traffic=False,
+        line_info_path=None,
+        arena_report_path=None,
+        analysis_only=False,
+        cache_dir=None,
+        llvm_cpu=None,
+        emit_bitcode=False,
+        additional_system_targets=None
     ):
         # By default, save stdout and stderr for each phase to separate files
 
@@ -981,6 +1534,8 @@ class AcceraProject:
         llc_files = self.make_log_filepaths("llc")
         llc_asm_files = self.make_log_filepaths("llc_asm")
         emitted_lib_files = self.make_log_filepaths("emitted_library")
+        code_object_files = self.make_log_filepaths("code_object")
+        cubin_files = self.make_log_filepaths("cubin")
 
         if generator_parameters:
             with OpenFile(emit_files[self.stdout_key], "w", pretend=pretend) as stdout_file:
@@ -994,6 +1549,68 @@ class AcceraProject:
                         quiet=quiet
                     )
 
+        # CPU modules that are in memory are compiled in-process, the tools are only run for the dump and debug modes,
+        # for the bitcode output and for the targets whose flags have no in-process equivalent
+        codegen_options = get_in_process_codegen_options(system_target, llvm_cpu)
+        in_process = (
+            codegen_options is not None and self.output_type == ModuleOutputType.OBJECT and not analysis_only
+            and not emit_bitcode and not additional_system_targets
+            and not pretend and not dump_all_passes and not dump_intrapass_ir and not self.print_subprocess_output
+            and not gpu_only and str(runtime).lower() in [Runtime.NONE.value, Runtime.OPENMP.value, Runtime.DEFAULT.value]
+            and all(module_file_set.module is not None for module_file_set in self.module_file_sets)
+        )
+
+        # The additional system targets share the lowering and the translation to LLVM IR with the system target,
+        # only the LLVM optimizations and code generation run for each of them
+        assert not additional_system_targets or (self.output_type == ModuleOutputType.OBJECT and not cache_dir), \
+            "Additional system targets are only supported for uncached object files"
+        self.system_target_module_file_sets = {}
+
+        # Modules whose object files are in the cache skip the lowering and compilation below. Only the object files
+        # are cached, so modules whose bitcode is needed are always compiled.
+        all_module_file_sets = self.module_file_sets
+        cache_keys = {}
+        if cache_dir and self.output_type == ModuleOutputType.OBJECT and not analysis_only and not pretend \
+            and not emit_bitcode:
+            options = [
+                build_config, profile, profile_counters, profile_timer, profile_regions, system_target,
+                str(runtime).lower(), gpu_only, gpu_chip, in_process, unroll_code_size_budget, outline_cache_copies,
+                count_memory_traffic
+            ]
+            for module_file_set in all_module_file_sets:
+                cache_keys[module_file_set.module_name] = self._get_cache_key(
+                    module_file_set, options, system_target, llvm_cpu
+                )
+            self.module_file_sets = [
+                module_file_set for module_file_set in all_module_file_sets
+                if not self._restore_from_cache(cache_dir, cache_keys[module_file_set.module_name], module_file_set)
+            ]
+
+        if in_process:
+            self.compile_in_process(
+                codegen_options,
+                system_target=system_target,
+                runtime=runtime,
+                profile=profile,
+                profile_counters=profile_counters,
+                profile_timer=profile_timer,
+                profile_regions=profile_regions,
+                vectorization_report_path=vectorization_report_path,
+                cost_model_report_path=cost_model_report_path,
+                compile_stats_report_path=compile_stats_report_path,
+                unroll_code_size_budget=unroll_code_size_budget,
+                unroll_report_path=unroll_report_path,
+                cache_copy_report_path=cache_copy_report_path,
+                outline_cache_copies=outline_cache_copies,
+                count_memory_traffic=count_memory_traffic,
+                line_info_path=line_info_path,
+                arena_report_path=arena_report_path,
+                pass_timing_report_path=pass_timing_report_path,
+                quiet=quiet
+            )
+            self._store_all_in_cache(cache_dir, cache_keys, all_module_file_sets)
+            return
+
         # Note: mlir-opt doesn't appear to support the -o option correctly, so all output goes to stdout
         #       therefore we can't capture and log stdout separately as we need it for the lowering pipeling
         with OpenFile(mlir_lowering_files[self.stderr_key], "w", pretend=pretend) as stderr_file:
@@ -1005,10 +1622,39 @@ class AcceraProject:
                 system_target=system_target,
                 runtime=runtime,
                 profile=profile,
+                profile_counters=profile_counters,
+                profile_timer=profile_timer,
+                profile_regions=profile_regions,
                 quiet=quiet,
-                gpu_only=gpu_only
+                gpu_only=gpu_only,
+                vectorization_report_path=vectorization_report_path,
+                gpu_chip=gpu_chip,
+                gpu_resource_report_path=gpu_resource_report_path,
+                cost_model_report_path=cost_model_report_path,
+                compile_stats_report_path=compile_stats_report_path,
+                unroll_code_size_budget=unroll_code_size_budget,
+                unroll_report_path=unroll_report_path,
+                cache_copy_report_path=cache_copy_report_path,
+                outline_cache_copies=outline_cache_copies,
+                count_memory_traffic=count_memory_traffic,
+                line_info_path=line_info_path,
+                arena_report_path=arena_report_path,
+                pass_timing=bool(pass_timing_report_path),
+                analysis_only=analysis_only
             )
 
+        # acc-opt prints the pass timing report to stderr, which isn't logged when the output of the tools is printed
+        if pass_timing_report_path and not pretend and not self.print_subprocess_output:
+            with open(mlir_lowering_files[self.stderr_key]) as stderr_file:
+                report = extract_pass_timing_report(stderr_file.read())
+            if report:
+                with open(pass_timing_report_path, "w") as report_file:
+                    report_file.write(report)
+
+        # The analysis stops the lowering before there is anything to translate
+        if analysis_only:
+            return
+
         if self.output_type == ModuleOutputType.OBJECT:
 
             with OpenFile(translate_files[self.stdout_key], "w", pretend=pretend) as stdout_file:
@@ -1021,9 +1667,16 @@ class AcceraProject:
                         quiet=quiet
                     )
 
+            # The other system targets are compiled concurrently with the system target
+            fan_out_executor = ThreadPoolExecutor(max_workers=1)
+            fan_out = fan_out_executor.submit(
+                self.generate_objects_for_system_targets, additional_system_targets or [], pretend=pretend, quiet=quiet
+            )
+
             with OpenFile(opt_files[self.stdout_key], "w", pretend=pretend) as stdout_file:
                 with OpenFile(opt_files[self.stderr_key], "w", pretend=pretend) as stderr_file:
                     self.optimize_llvm(
+                        llvm_opt_args=get_llvm_tooling_opts(system_target, llvm_cpu) + DEFAULT_OPT_ARGS,
                         stdout=stdout_file,
                         stderr=stderr_file,
                         pretend=pretend,
@@ -1034,6 +1687,7 @@ class AcceraProject:
             with OpenFile(llc_files[self.stdout_key], "w", pretend=pretend) as stdout_file:
                 with OpenFile(llc_files[self.stderr_key], "w", pretend=pretend) as stderr_file:
                     self.generate_object(
+                        llc_args=get_llvm_tooling_opts(system_target, llvm_cpu) + DEFAULT_LLC_ARGS,
                         stdout=stdout_file,
                         stderr=stderr_file,
                         pretend=pretend,
@@ -1044,6 +1698,7 @@ class AcceraProject:
             with OpenFile(llc_asm_files[self.stdout_key], "w", pretend=pretend) as stdout_file:
                 with OpenFile(llc_asm_files[self.stderr_key], "w", pretend=pretend) as stderr_file:
                     self.generate_asm(
+                        llc_args=get_llvm_tooling_opts(system_target, llvm_cpu) + DEFAULT_LLC_ARGS,
                         stdout=stdout_file,
                         stderr=stderr_file,
                         pretend=pretend,
@@ -1051,7 +1706,10 @@ class AcceraProject:
                         quiet=quiet
                     )
 
-        elif self.output_type in [ModuleOutputType.CPP, ModuleOutputType.CUDA]:
+            self.system_target_module_file_sets = fan_out.result()
+            fan_out_executor.shutdown()
+
+        elif self.output_type in [ModuleOutputType.CPP, ModuleOutputType.CPP_HEADER, ModuleOutputType.CUDA]:
 
             with OpenFile(translate_files[self.stdout_key], "w", pretend=pretend) as stdout_file:
                 with OpenFile(translate_files[self.stderr_key], "w", pretend=pretend) as stderr_file:
@@ -1063,6 +1721,40 @@ class AcceraProject:
                         quiet=quiet
                     )
 
+            backend_logs = None
+            if gpu_chip and str(runtime).lower() == Runtime.ROCM.value and self.output_type == ModuleOutputType.CUDA:
+                with OpenFile(code_object_files[self.stdout_key], "w", pretend=pretend) as stdout_file:
+                    with OpenFile(code_object_files[self.stderr_key], "w", pretend=pretend) as stderr_file:
+                        self.generate_hip_code_object(
+                            gpu_chip,
+                            resource_usage=bool(gpu_resource_report_path),
+                            stdout=stdout_file,
+                            stderr=stderr_file,
+                            pretend=pretend,
+                            quiet=quiet
+                        )
+                backend_logs = code_object_files
+
+            # CUDA kernels are only compiled to report the resources they use, the source is what's deployed
+            elif gpu_resource_report_path and cuda_arch and str(runtime).lower() == Runtime.CUDA.value \
+                and self.output_type == ModuleOutputType.CUDA:
+                with OpenFile(cubin_files[self.stdout_key], "w", pretend=pretend) as stdout_file:
+                    with OpenFile(cubin_files[self.stderr_key], "w", pretend=pretend) as stderr_file:
+                        self.generate_cuda_cubin(
+                            cuda_arch, stdout=stdout_file, stderr=stderr_file, pretend=pretend, quiet=quiet
+                        )
+                backend_logs = cubin_files
+
+            if gpu_resource_report_path and backend_logs and not pretend:
+                logs = []
+                for log_path in [backend_logs[self.stdout_key], backend_logs[self.stderr_key]]:
+                    if os.path.isfile(log_path):
+                        with open(log_path) as log_file:
+                            logs.append(log_file.read())
+                add_kernel_resource_usage(gpu_resource_report_path, logs)
+
+        self._store_all_in_cache(cache_dir, cache_keys, all_module_file_sets)
+
 
 def accc(
     input_path,
@@ -1072,6 +1764,8 @@ def accc(
     build_config=build_config_types[0],
     target=default_target,
     profile=False,
+    profile_counters=None,
+    profile_timer=None,
     generator_custom_args=ParameterCollection([]),
     main_cpp_path=None,
     main_custom_args=ParameterCollection([]),
@@ -1118,6 +1812,8 @@ def accc(
         dump_all_passes=dump_all_passes,
         dump_intrapass_ir=dump_intrapass_ir,
         profile=profile,
+        profile_counters=profile_counters,
+        profile_timer=profile_timer,
         pretend=pretend
     )
 
@@ -373,6 +373,13 @@ public:
     }
     size_t AffineOffset() const { return _affineOffset; }
 
+    AffineArrayParameter& Alignment(size_t alignment)
+    {
+        _alignment = alignment;
+        return *this;
+    }
+    size_t Alignment() const { return _alignment; }
+
     toml::table Serialize() const
     {
         toml::table paramTable = SerializeCommonParameters();
@@ -389,6 +396,12 @@ public:
 
         paramTable.insert_or_assign("affine_offset", static_cast<int64_t>(_affineOffset));
 
+        // The byte alignment that callers guarantee for the data, only written when there is one
+        if (_alignment > 1)
+        {
+            paramTable.insert_or_assign("alignment", static_cast<int64_t>(_alignment));
+        }
+
         return paramTable;
     }
 
@@ -396,6 +409,7 @@ private:
     std::vector<size_t> _shape;
     std::vector<size_t> _affineMap;
     size_t _affineOffset;
+    size_t _alignment = 0;
 };
 
 class RuntimeArrayParameter : public Parameter
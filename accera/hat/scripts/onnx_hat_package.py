@@ -28,6 +28,7 @@ class ONNXHATPackage(HATPackage):
     NodeArgsKey = "node_args"
     NodeArgShapesKey = "node_arg_shapes"
     NodePackingFunctionsKey = "node_packing_functions"
+    NodeFusedNodesKey = "node_fused_nodes"    # the nodes of the subgraph that a fused function implements
     RequiredAuxKeys = [NodeNameKey, NodeTypeKey, NodeDomainKey, NodeArgsKey,
                        NodeArgShapesKey]
 
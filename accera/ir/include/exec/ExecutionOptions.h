@@ -75,7 +75,9 @@ namespace targets
         ROCM,
         VULKAN,
         OPENMP,
-        DEFAULT
+        DEFAULT,
+        THREAD_POOL,
+        OPENCL
     };
 
 } // namespace targets
@@ -106,6 +106,74 @@ namespace accera::ir::executionPlan
 // Unit attr name for controlling whether bounds checking is done for ops within a marked op
 const mlir::StringRef AccessBoundsCheckAttrName = "accxp.access_bounds_check";
 
+// I64 array attr name for the processors that the threads of a marked parallel loop are pinned to, indexed by thread number
+const mlir::StringRef ParallelProcessorsAttrName = "accxp.parallel_processors";
+
+// Unit attr name for MakeCacheOps whose buffer is allocated once per iteration of the enclosing parallel loop
+const mlir::StringRef ThreadLocalCacheAttrName = "accxp.thread_local_cache";
+
+// Unit attr name for parallelized loops whose iterations accumulate into the same elements of an array (e.g. split-K)
+const mlir::StringRef ParallelReductionAttrName = "accxp.parallel_reduction";
+
+// Unit attr name for parallel reduction loops whose iterations accumulate into separate partial results, which are combined in a fixed order
+const mlir::StringRef DeterministicReductionAttrName = "accxp.deterministic_reduction";
+
+// Unit attr name for MakeCacheOps whose data is copied in and out by all the threads of the parallel loop that uses the cache
+const mlir::StringRef CooperativeCacheCopyAttrName = "accxp.cooperative_cache_copy";
+
+// I64 attr name for MakeCacheOps whose copies prefetch the active block this many trigger loop iterations ahead
+const mlir::StringRef PrefetchDistanceAttrName = "accxp.prefetch_distance";
+
+// I64 attr name for MakeCacheOps whose innermost dimension is padded by this many elements, or by AutomaticCachePadding
+const mlir::StringRef CachePaddingAttrName = "accxp.cache_padding";
+
+// Value of the cache padding attr that pads the innermost dimension only when its size maps its rows onto the same cache sets or banks
+const int64_t AutomaticCachePadding = -1;
+
+// I64 array attr name for MakeCacheOps whose buffer is stored as contiguous panels of { active block dimension, panel size } elements
+const mlir::StringRef CachePanelLayoutAttrName = "accxp.cache_panel_layout";
+
+// Unit attr name for MakeCacheOps whose data is written back to the array with non-temporal stores
+const mlir::StringRef NonTemporalWriteBackCacheAttrName = "accxp.nontemporal_write_back";
+
+// Array attr name for MakeCacheOps whose output is transformed by elementwise steps when it is reduced back into the array.
+// Each step is a dictionary with a "kind" of "bias" (with the "operand" index of the epilogue array and the "dim" of the
+// output it is indexed by), "scale" (with a "value") or "clamp" (with an optional "min" and "max")
+const mlir::StringRef CacheEpilogueAttrName = "accxp.cache_epilogue";
+
+// Type attr name for MakeCacheOps whose buffer stores the elements as this type instead of the array's element type. The
+// elements are converted when the cache is filled and converted back when it is copied or reduced into the array
+const mlir::StringRef CacheElementTypeAttrName = "accxp.cache_element_type";
+
+// Unit attr name for GPU double-buffer MakeCacheOps in shared memory that are filled from global memory with asynchronous copies
+const mlir::StringRef AsyncCopyCacheAttrName = "accxp.async_copy";
+
+// Unit attr name for loops whose stores are emitted as non-temporal stores
+const mlir::StringRef NonTemporalStoresAttrName = "accxp.nontemporal_stores";
+
+// Unit attr name for global ops that hold the buffer of a cache, which the cache memory planner can place in a shared arena,
+// and for the ops that allocate the other caches
+const mlir::StringRef CacheBufferAttrName = "accxp.cache_buffer";
+
+// Array attr name for ValueFuncOps that collects a dictionary with the outcome of each of their loops marked for vectorization
+const mlir::StringRef VectorizationReportAttrName = "accxp.vectorization_report";
+
+// Str attr name for the profile region ops around the data movement of a cache, with the kind of the movement: "fill",
+// "write_back", "reduce" or "zero"
+const mlir::StringRef CacheCopyRegionAttrName = "accxp.cache_copy_region";
+
+// Unit attr name for loops that are wrapped in a profile region named after their function and index
+const mlir::StringRef ProfileLoopAttrName = "accxp.profile_loop";
+
+// Unit attr name for private MakeCacheOps of max element caches whose budget is the registers of a GPU thread. Their
+// active block stays inside the GPU-mapped loops and the cache of their source, and when even the innermost active
+// block exceeds the budget the cache isn't created, so that the accesses read the source instead of spilling
+const mlir::StringRef RegisterCacheAttrName = "accxp.register_cache";
+
+// Array attr name for ValueFuncOps, and the GPU kernels they become, that collects a dictionary with the placement of
+// each of their register caches
+const mlir::StringRef RegisterCacheReportAttrName = "accxp.register_cache_report";
+
 //
 // Utility functions and EDSC-type intrinsics
 //
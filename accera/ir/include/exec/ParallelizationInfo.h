@@ -11,16 +11,48 @@ namespace accera::ir
 {
 namespace executionPlan
 {
+    // Values are part of the printed form of ParallelizationInfoAttr, do not renumber
+    enum class ParallelSchedule : int
+    {
+        Static = 0,
+        Dynamic = 1,
+        WorkStealing = 2,
+        Guided = 3,
+    };
+
+    // Values are part of the printed form of ParallelizationInfoAttr, do not renumber
+    enum class ParallelProcBind : int
+    {
+        // Chosen by the lowering: close to the parent thread, or spread for the outermost of nested parallel levels
+        Default = 0,
+        Close = 1,
+        Spread = 2,
+        Primary = 3,
+    };
+
     struct ParallelizationInfo
     {
         int64_t numThreads = 4;
-        bool isDynamicPolicy = false;
-        // TODO: pinning
+        ParallelSchedule schedule = ParallelSchedule::Static;
+
+        // Indices parallelized together share a group and are collapsed into one parallel region,
+        // nested groups become nested parallel regions
+        int64_t group = 0;
+
+        // Thread affinity policy of the parallel region
+        ParallelProcBind procBind = ParallelProcBind::Default;
+
+        // Caches that are only used inside the parallel loop are allocated and filled by the thread that
+        // runs each iteration, so that their pages are first touched (and placed) on that thread's NUMA node
+        bool firstTouch = false;
+
+        // The number of iterations handed out at a time, 0 uses the default of the schedule
+        int64_t chunkSize = 0;
 
     private:
         friend inline bool operator==(const ParallelizationInfo& p1, const ParallelizationInfo& p2)
         {
-            return (p1.numThreads == p2.numThreads) && (p1.isDynamicPolicy == p2.isDynamicPolicy);
+            return (p1.numThreads == p2.numThreads) && (p1.schedule == p2.schedule) && (p1.group == p2.group) && (p1.procBind == p2.procBind) && (p1.firstTouch == p2.firstTouch) && (p1.chunkSize == p2.chunkSize);
         }
         friend inline bool operator!=(const ParallelizationInfo& p1, const ParallelizationInfo& p2)
         {
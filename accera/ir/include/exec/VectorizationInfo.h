@@ -11,16 +11,50 @@ namespace accera::ir
 {
 namespace executionPlan
 {
+    // Instructions that multiply groups of 4 adjacent 8-bit integers and add each group's sum to a 32-bit integer
+    enum class IntegerDotProductKind : int64_t
+    {
+        None = 0,
+        // vpdpbusd (AVX512-VNNI, AVX-VNNI), which multiplies unsigned by signed integers
+        X86VNNI = 1,
+        // sdot and udot (AArch64 dot product extension), which multiply integers of the same signedness
+        ARMDotProduct = 2,
+        // smlad (ARMv7E-M DSP extension, e.g. Cortex-M4 and M7), which multiplies the pairs of signed 16-bit integers
+        // packed in 32-bit registers. 8-bit integers of any signedness are unpacked into pairs with sxtb16 or uxtb16
+        ARMDSP = 3,
+    };
+
+    // Instructions that look up each byte of a vector in a 256-entry table of bytes held in registers
+    enum class TableLookupKind : int64_t
+    {
+        None = 0,
+        // vpermi2b (AVX512-VBMI), which selects from 2 registers of table entries with the low bits of each index
+        X86VBMI = 1,
+        // vpshufb (SSSE3, AVX2), which selects from 16 table entries with the low 4 bits of each index
+        X86Shuffle = 2,
+        // tbl and tbx (AArch64 NEON), which select from 4 registers of 16 table entries
+        ARMTable = 3,
+    };
+
     struct VectorizationInfo
     {
         int64_t vectorBytes = 0;
         int64_t vectorUnitCount = 0;
         bool unrollOnly = false;
+        // Vectorize loops that have fewer iterations than a vector holds with masked loads and stores
+        bool masked = false;
+        // The integer dot-product instructions of the target, if any
+        IntegerDotProductKind dotProduct = IntegerDotProductKind::None;
+        // The target has vdpbf16ps (AVX512-BF16), which multiplies pairs of adjacent bfloat16 values and adds each
+        // pair's sum to a float32
+        bool bfloat16DotProduct = false;
+        // The table lookup instructions of the target, if any
+        TableLookupKind tableLookup = TableLookupKind::None;
 
     private:
         friend inline bool operator==(const VectorizationInfo& v1, const VectorizationInfo& v2)
         {
-            return (v1.vectorBytes == v2.vectorBytes) && (v1.vectorUnitCount == v2.vectorUnitCount) && (v1.unrollOnly == v2.unrollOnly);
+            return (v1.vectorBytes == v2.vectorBytes) && (v1.vectorUnitCount == v2.vectorUnitCount) && (v1.unrollOnly == v2.unrollOnly) && (v1.masked == v2.masked) && (v1.dotProduct == v2.dotProduct) && (v1.bfloat16DotProduct == v2.bfloat16DotProduct) && (v1.tableLookup == v2.tableLookup);
         }
         friend inline bool operator!=(const VectorizationInfo& v1, const VectorizationInfo& v2)
         {
@@ -112,6 +112,7 @@ namespace loopnest
         std::vector<ScheduledKernelOp> GetPossiblyValidKernels(const RecursionState& state) const;
 
         PartitionList GetPartitions(const Index& loopIndex, Range loopRange, const RecursionState& state, const LoopVisitSchedule& schedule) const;
+        bool IsPredicateFalseOverRange(const Index& loopIndex, const Range& loopRange, Operation* predicate, const LoopIndexSymbolTable& runtimeIndexVariables, const LoopVisitSchedule& schedule) const;
 
         // TODO: change this to take a KernelPredicate instead of Operation*
         void AddSplits(const Index& loopIndex, const Range& loopRange, Operation* predicate, const LoopIndexSymbolTable& runtimeIndexVariables, const LoopVisitSchedule& schedule, std::set<int64_t>& splits) const;
@@ -98,10 +98,60 @@ const mlir::StringRef CInterfaceAttrName = "llvm.emit_c_interface";
 // TODO : move these to ValueFuncOp and set them as part of ValueFuncOp creation
 const mlir::StringRef RawPointerAPIAttrName = "accv.emit_raw_pointer_api";
 const mlir::StringRef HeaderDeclAttrName = "accv.emit_header_decl";
+const mlir::StringRef AsyncAPIAttrName = "accv.emit_async_api";
+const mlir::StringRef NonTemporalWriteBackAttrName = "accv.nontemporal_write_back";
+const mlir::StringRef NoAliasAttrName = "accv.no_alias"; // the array arguments of the function don't overlap
+const mlir::StringRef WorkspaceAPIAttrName = "accv.emit_workspace_api";
+const mlir::StringRef GPUGraphAttrName = "accv.gpu_graph"; // the kernels that the function launches are replayed from a graph
 const mlir::StringRef FunctionTagsAttrName = "accv.function_tags";
 const mlir::StringRef NoInlineAttrName = "accv.no_inline";
+const mlir::StringRef InlineAutoAttrName = "accv.inline_auto"; // calls are inlined if the callee is small or called once
 const mlir::StringRef BaseNameAttrName = "accv.base_name";
 
+// String attr names for the LLVM target CPU and target features that the code of a function is compiled for, instead
+// of those of the module, e.g. the versions of a function that is dispatched by the CPU features of the host
+const mlir::StringRef TargetCPUAttrName = "accv.target_cpu";
+const mlir::StringRef TargetFeaturesAttrName = "accv.target_features";
+
+// I64 attr name for the number of blocks that a persistent GPU kernel is launched with, the blocks loop over the blocks of
+// the kernel's grid
+const mlir::StringRef GPUPersistentBlocksAttrName = "accv.gpu_persistent_blocks";
+
+// I64 attr name for the grid dimension of the split reduction index of a persistent GPU kernel with a Stream-K
+// decomposition, whose blocks each run an even share of the blocks of the grid instead of taking them from a work counter
+const mlir::StringRef GPUStreamKDimAttrName = "accv.gpu_stream_k_dim";
+
+// Unit attr name for memref and vector store ops that are lowered to non-temporal (streaming) stores
+const mlir::StringRef NonTemporalAttrName = "accv.nontemporal";
+
+// String attr name for constant globals whose data is written to the named file and memory-mapped on first use
+const mlir::StringRef MappedFileAttrName = "accv.mapped_file";
+
+// Unit attr name for allocations and static buffers that are backed by huge pages, which are allocated on first use
+const mlir::StringRef HugePagesAttrName = "accv.huge_pages";
+
+// I64 attr name for the module-wide size in bytes from which static buffers are backed by huge pages
+const mlir::StringRef HugePageThresholdAttrName = "accv.huge_page_threshold";
+
+// I32 attr name for the mask of the hardware counters, in the order of AcceraPerfCounter, that a profile region op reads
+const mlir::StringRef ProfileCounterMaskAttrName = "accv.profile_counter_mask";
+
+// Unit attr name for the profile region ops that time their regions with the CPU's cycle counter
+const mlir::StringRef ProfileCycleCounterAttrName = "accv.profile_cycle_counter";
+
+// Array attr name for the records of the loops of a function that were unrolled, which the unroll report collects
+const mlir::StringRef UnrollReportAttrName = "accv.unroll_report";
+
+// I64 attr name for the number of independent vector accumulators that a vectorized reduction keeps
+const mlir::StringRef ReductionAccumulatorsAttrName = "accv.reduction_accumulators";
+
+// I64 array attr name for the byte alignment that the callers of a function guarantee for each argument, 0 for no guarantee
+const mlir::StringRef ArgumentAlignmentsAttrName = "accv.arg_alignments";
+
+// Array attr name for the constant values that a specialization of a function assumes for its single-element array
+// arguments, a float attr for each specialized argument and a unit attr for the others
+const mlir::StringRef SpecializedArgumentsAttrName = "accv.specialized_args";
+
 } // namespace accera::ir
 
 /// Include the auto-generated header file containing the declarations of the
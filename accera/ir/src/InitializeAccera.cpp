@@ -25,6 +25,8 @@
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Target/TargetMachine.h>
 
+#include <mutex>
+
 using namespace mlir;
 
 namespace accera::ir
@@ -103,7 +105,9 @@ namespace
 
 void InitializeAccera()
 {
-    InitializeLLVM();
+    // Modules can be lowered concurrently, the registries of LLVM are only initialized by the first one
+    static std::once_flag initialized;
+    std::call_once(initialized, InitializeLLVM);
 }
 
 } // namespace accera::ir
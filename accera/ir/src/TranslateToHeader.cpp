@@ -26,10 +26,12 @@
 #include <mlir/Dialect/LLVMIR/LLVMTypes.h>
 #include <mlir/IR/BuiltinOps.h>
 #include <mlir/IR/MLIRContext.h>
+#include <mlir/Interfaces/CallInterfaces.h>
 #include <mlir/Target/LLVMIR/TypeToLLVM.h>
 #include <mlir/Transforms/DialectConversion.h>
 #include <mlir/Translation.h>
 
+#include <llvm/ADT/SmallPtrSet.h>
 #include <llvm/ADT/TypeSwitch.h>
 
 #include <algorithm>
@@ -85,12 +87,22 @@ namespace ir
             os << "#include <stdint.h>\n";
             os << "#include <stdbool.h>\n\n";
 
-            // for float16_t
+            // for float16_t and bfloat16_t
             os << "#if !defined(ACCERA_FLOAT)\n";
             os << "#define ACCERA_FLOAT 1\n";
             os << "typedef uint16_t float16_t;\n";
+            os << "typedef uint16_t bfloat16_t;\n";
             os << "#endif // !defined(ACCERA_FLOAT)\n";
 
+            // for the array arguments of functions whose arguments don't alias each other
+            os << "#if !defined(ACCERA_RESTRICT)\n";
+            os << "#if defined(__cplusplus)\n";
+            os << "#define ACCERA_RESTRICT __restrict\n";
+            os << "#else\n";
+            os << "#define ACCERA_RESTRICT restrict\n";
+            os << "#endif // defined(__cplusplus)\n";
+            os << "#endif // !defined(ACCERA_RESTRICT)\n";
+
             os << "#if defined(__cplusplus)\n";
             os << "extern \"C\"\n";
             os << "{\n";
@@ -155,6 +167,82 @@ namespace ir
             });
         }
 
+        bool UsesThreadPool(std::vector<value::ValueModuleOp> valueModuleOps)
+        {
+            return std::any_of(valueModuleOps.begin(), valueModuleOps.end(), [](auto m) {
+                auto execRuntimeAttr = m->template getAttrOfType<value::ExecutionRuntimeAttr>(value::ValueModuleOp::getExecRuntimeAttrName());
+                return execRuntimeAttr && execRuntimeAttr.getValue() == value::ExecutionRuntime::THREAD_POOL;
+            });
+        }
+
+        bool UsesAsyncAPI(std::vector<value::ValueModuleOp> valueModuleOps)
+        {
+            return std::any_of(valueModuleOps.begin(), valueModuleOps.end(), [](auto m) {
+                bool found = false;
+                m.walk([&found](value::ValueFuncOp fn) { found = found || fn->hasAttr(ir::AsyncAPIAttrName); });
+                return found;
+            });
+        }
+
+        // Returns the files of the packed buffers that the generated code memory-maps, which are deployed next to the library
+        std::vector<std::string> GetMappedBufferFiles(std::vector<value::ValueModuleOp> valueModuleOps)
+        {
+            std::vector<std::string> files;
+            for (auto m : valueModuleOps)
+            {
+                m.walk([&files](value::GlobalOp globalOp) {
+                    if (auto fileAttr = globalOp->getAttrOfType<mlir::StringAttr>(ir::MappedFileAttrName))
+                    {
+                        files.push_back(fileAttr.getValue().str());
+                    }
+                });
+            }
+            return files;
+        }
+
+        std::string GetAsyncPrologue()
+        {
+            std::ostringstream os;
+
+            // Implemented by the acc-runtime library, see accera/runtime/include/AsyncTask.h
+            os << "#ifndef ACCERA_ASYNC_DECLARED\n";
+            os << "#define ACCERA_ASYNC_DECLARED\n";
+            os << "// Starts the executor of asynchronous calls, optional: the executor is started on first use otherwise.\n";
+            os << "// numThreads: the number of asynchronous calls that can run concurrently, or 0 for the default of 1.\n";
+            os << "void AcceraAsyncInitialize(int64_t numThreads);\n\n";
+            os << "// Returns 1 if the asynchronous call has completed, 0 otherwise, without blocking.\n";
+            os << "int64_t AcceraAsyncPoll(int64_t handle);\n\n";
+            os << "// Blocks until the asynchronous call has completed.\n";
+            os << "void AcceraAsyncWait(int64_t handle);\n\n";
+            os << "// Releases the handle of an asynchronous call, a call that is still running completes in the background.\n";
+            os << "void AcceraAsyncRelease(int64_t handle);\n";
+            os << "#endif // ACCERA_ASYNC_DECLARED\n\n";
+
+            return os.str();
+        }
+
+        std::string GetThreadPoolPrologue()
+        {
+            std::ostringstream os;
+
+            // Implemented by the acc-runtime library, see accera/runtime/include/ThreadPool.h
+            os << "#ifndef ACCERA_THREAD_POOL_DECLARED\n";
+            os << "#define ACCERA_THREAD_POOL_DECLARED\n";
+            os << "// Starts the persistent thread pool, optional: the pool is started on first use otherwise.\n";
+            os << "// numThreads: the number of threads including the caller, or 0 for the number of hardware threads.\n";
+            os << "// spinMicroseconds: how long idle threads spin before parking, or -1 for the default.\n";
+            os << "void AcceraThreadPoolInitialize(int64_t numThreads, int64_t spinMicroseconds);\n\n";
+            os << "// Stops and joins the thread pool threads, the pool restarts if it is used again.\n";
+            os << "void AcceraThreadPoolShutdown(void);\n\n";
+            os << "// Caps the threads of the parallel regions, of every caller or of the calling thread only, or 0 to remove the cap.\n";
+            os << "// The thread counts the functions were compiled with stay the default.\n";
+            os << "void AcceraThreadPoolSetMaxThreads(int64_t maxThreads);\n";
+            os << "void AcceraThreadPoolSetCallerMaxThreads(int64_t maxThreads);\n";
+            os << "#endif // ACCERA_THREAD_POOL_DECLARED\n\n";
+
+            return os.str();
+        }
+
         struct LLVMType
         {
             mlir::Type type;
@@ -268,6 +356,10 @@ namespace ir
             {
                 os << "float16_t";
             }
+            else if (t.type.isBF16())
+            {
+                os << "bfloat16_t";
+            }
             else if (t.type.isF32())
             {
                 os << "float";
@@ -279,7 +371,7 @@ namespace ir
         }
 
         template <typename StreamType>
-        void WriteFunctionType(StreamType& os, LLVMType t, std::optional<std::string> name = std::nullopt)
+        void WriteFunctionType(StreamType& os, LLVMType t, std::optional<std::string> name = std::nullopt, bool restrictArrays = false)
         {
             // returnType name(paramType, ...);
 
@@ -321,6 +413,10 @@ namespace ir
                 }
                 LLVMType paramType = { fnTy.getParamType(i), sourceType };
                 WriteLLVMType(os, paramType);
+                if (restrictArrays && paramType.type.isa<mlir::LLVM::LLVMPointerType>() && sourceType && sourceType->isa<mlir::ShapedType>())
+                {
+                    os << " ACCERA_RESTRICT";
+                }
             }
             os << ");";
         }
@@ -445,6 +541,83 @@ namespace ir
                 });
         }
 
+        // Returns the signature of the emitted function, which has a trailing workspace argument if the function
+        // requested the workspace API, see WorkspaceArgumentPass
+        mlir::FunctionType GetEmittedFunctionType(value::ValueFuncOp fn)
+        {
+            auto fnType = fn.getType().dyn_cast<mlir::FunctionType>();
+            if (!fn->hasAttr(ir::WorkspaceAPIAttrName))
+            {
+                return fnType;
+            }
+
+            auto context = fn.getContext();
+            auto workspaceType = mlir::MemRefType::get({ mlir::ShapedType::kDynamicSize }, mlir::IntegerType::get(context, 8, mlir::IntegerType::Unsigned));
+            std::vector<mlir::Type> inputs(fnType.getInputs().begin(), fnType.getInputs().end());
+            inputs.push_back(workspaceType);
+            return mlir::FunctionType::get(context, inputs, fnType.getResults());
+        }
+
+        std::string GetWorkspaceSizeFunctionName(const std::string& name)
+        {
+            return name + "_workspace_size";
+        }
+
+        template <typename StreamType>
+        void WriteWorkspaceSizeDeclaration(StreamType& os, mlir::MLIRContext* context, const std::string& name, std::optional<std::string> baseName)
+        {
+            auto i64Type = mlir::IntegerType::get(context, 64);
+            auto sizeLlvmType = mlir::LLVM::LLVMFunctionType::get(i64Type, {});
+            auto sizeFnType = mlir::FunctionType::get(context, {}, { i64Type });
+
+            os << "// Returns the size in bytes of the workspace argument of " << name << "\n";
+            WriteFunctionType(os, { sizeLlvmType, sizeFnType }, GetWorkspaceSizeFunctionName(name));
+            os << "\n\n";
+
+            if (baseName)
+            {
+                WriteFunctionTypeAlias(os, { sizeLlvmType, sizeFnType }, GetWorkspaceSizeFunctionName(name), GetWorkspaceSizeFunctionName(*baseName));
+                os << "\n\n";
+            }
+        }
+
+        // Returns true if fn launches a GPU function, directly or through the functions it calls
+        bool LaunchesGPUFunction(value::ValueFuncOp fn, llvm::SmallPtrSetImpl<mlir::Operation*>& visited)
+        {
+            if (!visited.insert(fn).second)
+            {
+                return false;
+            }
+            auto result = fn.walk([&](mlir::CallOpInterface callOp) {
+                auto callee = mlir::dyn_cast_or_null<value::ValueFuncOp>(callOp.resolveCallable());
+                if (callee && (callee.exec_target() == value::ExecutionTarget::GPU || LaunchesGPUFunction(callee, visited)))
+                {
+                    return mlir::WalkResult::interrupt();
+                }
+                return mlir::WalkResult::advance();
+            });
+            return result.wasInterrupted();
+        }
+
+        // Functions that launch a kernel through the CUDA or HIP runtime also get a variant that launches it on a
+        // stream provided by the caller, see GpuDialectCppPrinter::printStreamLauncher
+        bool EmitsStreamAPI(value::ValueFuncOp fn)
+        {
+            if (!fn->hasAttr(ir::HeaderDeclAttrName))
+            {
+                return false;
+            }
+            auto module = fn->getParentOfType<value::ValueModuleOp>();
+            auto execRuntimeAttr = module ? module->getAttrOfType<value::ExecutionRuntimeAttr>(value::ValueModuleOp::getExecRuntimeAttrName()) : nullptr;
+            if (!execRuntimeAttr ||
+                (execRuntimeAttr.getValue() != value::ExecutionRuntime::CUDA && execRuntimeAttr.getValue() != value::ExecutionRuntime::ROCM))
+            {
+                return false;
+            }
+            llvm::SmallPtrSet<mlir::Operation*, 4> visited;
+            return LaunchesGPUFunction(fn, visited);
+        }
+
         template <typename StreamType>
         mlir::LogicalResult WriteFunctionDeclaration(StreamType& os, value::ValueFuncOp fn, bool useBarePtrCallConv)
         {
@@ -463,7 +636,7 @@ namespace ir
                 return mlir::success();
             }
 
-            auto fnType = fn.getType().dyn_cast<mlir::FunctionType>();
+            auto fnType = GetEmittedFunctionType(fn);
             assert(fnType.getNumResults() <= 1);
 
             mlir::LowerToLLVMOptions options(context);
@@ -472,17 +645,67 @@ namespace ir
 
             mlir::TypeConverter::SignatureConversion conversion(fnType.getNumInputs());
             auto llvmType = llvmTypeConverter.convertFunctionSignature(fnType, false, conversion);
-            WriteFunctionType(os, { llvmType, fnType }, name);
+            // The arguments of functions that declare them as not aliasing are restrict-qualified
+            auto noAlias = useBarePtrCallConv && fn->hasAttr(ir::NoAliasAttrName);
+            WriteFunctionType(os, { llvmType, fnType }, name, noAlias);
 
             os << "\n\n";
 
             // if a base name is set, emit an alias for this function using the base name
-            if (auto baseName = fn->getAttrOfType<mlir::StringAttr>(ir::BaseNameAttrName))
+            auto baseName = fn->getAttrOfType<mlir::StringAttr>(ir::BaseNameAttrName);
+            if (baseName)
             {
                 WriteFunctionTypeAlias(os, { llvmType, fnType }, name, baseName.getValue().str());
                 os << "\n\n";
             }
 
+            if (fn->hasAttr(ir::AsyncAPIAttrName))
+            {
+                // The asynchronous variant takes the same arguments and returns a handle for AcceraAsyncWait / AcceraAsyncPoll,
+                // see AsyncEntryPointPass
+                auto llvmFnType = llvmType.cast<mlir::LLVM::LLVMFunctionType>();
+                auto asyncLlvmType = mlir::LLVM::LLVMFunctionType::get(mlir::IntegerType::get(context, 64), llvmFnType.getParams());
+                auto asyncFnType = mlir::FunctionType::get(context, fnType.getInputs(), {});
+
+                os << "// Enqueues a call to " << name << " and returns immediately, the arguments must stay valid until the call completes\n";
+                WriteFunctionType(os, { asyncLlvmType, asyncFnType }, name + "_async", noAlias);
+                os << "\n\n";
+
+                if (baseName)
+                {
+                    WriteFunctionTypeAlias(os, { asyncLlvmType, asyncFnType }, name + "_async", baseName.getValue().str() + "_async");
+                    os << "\n\n";
+                }
+            }
+
+            if (EmitsStreamAPI(fn))
+            {
+                // The stream variant takes a trailing cudaStream_t / hipStream_t argument
+                auto llvmFnType = llvmType.cast<mlir::LLVM::LLVMFunctionType>();
+                auto streamType = mlir::LLVM::LLVMPointerType::get(mlir::IntegerType::get(context, 8));
+                std::vector<mlir::Type> params(llvmFnType.getParams().begin(), llvmFnType.getParams().end());
+                params.push_back(streamType);
+                std::vector<mlir::Type> inputs(fnType.getInputs().begin(), fnType.getInputs().end());
+                inputs.push_back(streamType);
+                auto streamLlvmType = mlir::LLVM::LLVMFunctionType::get(llvmFnType.getReturnType(), params);
+                auto streamFnType = mlir::FunctionType::get(context, inputs, fnType.getResults());
+
+                os << "// Launches the kernel of " << name << " on the given CUDA or HIP stream and returns without waiting for it to complete\n";
+                WriteFunctionType(os, { streamLlvmType, streamFnType }, name + "_stream");
+                os << "\n\n";
+
+                if (baseName)
+                {
+                    WriteFunctionTypeAlias(os, { streamLlvmType, streamFnType }, name + "_stream", baseName.getValue().str() + "_stream");
+                    os << "\n\n";
+                }
+            }
+
+            if (fn->hasAttr(ir::WorkspaceAPIAttrName))
+            {
+                WriteWorkspaceSizeDeclaration(os, context, name, baseName ? std::optional<std::string>{ baseName.getValue().str() } : std::nullopt);
+            }
+
             return mlir::success();
         }
 
@@ -521,6 +744,16 @@ namespace ir
                 os << GetDebugPrologue();
             }
 
+            if (UsesThreadPool(valueModuleOps))
+            {
+                os << GetThreadPoolPrologue();
+            }
+
+            if (UsesAsyncAPI(valueModuleOps))
+            {
+                os << GetAsyncPrologue();
+            }
+
             for (auto& module : valueModuleOps)
             {
                 WriteModuleHeader(os, module, useBarePtrCallConv);
@@ -535,7 +768,7 @@ namespace ir
             return mlir::success();
         }
 
-        std::unique_ptr<hat::Parameter> ConvertToIncompleteHATParameter(mlir::Type type, const std::string& runtimeSizeStr = "")
+        std::unique_ptr<hat::Parameter> ConvertToIncompleteHATParameter(mlir::Type type, const std::string& runtimeSizeStr = "", int64_t alignment = 0)
         {
             std::unique_ptr<hat::Parameter> param;
             if (type.isa<mlir::ShapedType>())
@@ -579,6 +812,7 @@ namespace ir
                     affineArray->Shape(shapeVec);
                     affineArray->AffineMap(affineMap);
                     affineArray->AffineOffset(affineOffset);
+                    affineArray->Alignment(static_cast<size_t>(alignment));
                     param = std::move(affineArray);
                 }
                 else
@@ -622,7 +856,7 @@ namespace ir
                         auto context = fn.getContext();
                         auto fnName = fn.getName().str();
 
-                        auto fnType = fn.getType().dyn_cast<mlir::FunctionType>();
+                        auto fnType = GetEmittedFunctionType(fn);
                         assert(fnType.getNumResults() <= 1);
 
                         bool useBarePtrCallConv = fn->hasAttr(ir::RawPointerAPIAttrName);
@@ -641,6 +875,14 @@ namespace ir
                         function->CallingConvention(hat::CallingConventionType::CDecl); // TODO : plumb this through
 
                         auto numInputs = fnType.getNumInputs();
+                        llvm::SmallVector<int64_t, 4> alignments;
+                        if (auto alignmentsAttr = fn->getAttrOfType<mlir::ArrayAttr>(ir::ArgumentAlignmentsAttrName))
+                        {
+                            for (auto alignment : alignmentsAttr.getAsRange<mlir::IntegerAttr>())
+                            {
+                                alignments.push_back(alignment.getInt());
+                            }
+                        }
                         for (unsigned i = 0; i < numInputs; ++i)
                         {
                             // TODO : plumb name / description / usage / etc through
@@ -649,7 +891,9 @@ namespace ir
                             // as the LLVM converted version will lose shape and signness information
                             const auto llvmArgType = llvmTypeConverter.convertType(llvmType.getParamType(i));
                             const auto mlirArgType = fnType.getInput(i);
-                            std::unique_ptr<hat::Parameter> arg = ConvertToIncompleteHATParameter(mlirArgType); // TODO : plumb through size string
+                            // The workspace argument is sized by its companion query function
+                            bool isWorkspaceArg = fn->hasAttr(ir::WorkspaceAPIAttrName) && i == numInputs - 1;
+                            std::unique_ptr<hat::Parameter> arg = ConvertToIncompleteHATParameter(mlirArgType, isWorkspaceArg ? GetWorkspaceSizeFunctionName(fnName) + "()" : "", i < alignments.size() ? alignments[i] : 0); // TODO : plumb through size string
                             arg->Name(""); // TODO : plumb parameter name through
                             arg->Description(""); // TODO : plumb parameter description
                             arg->Usage(hat::UsageType::InputOutput); // TODO : plumb usage through
@@ -682,6 +926,24 @@ namespace ir
                         function->CodeDeclaration(codeDecl);
 
                         package.AddFunction(std::move(function));
+
+                        if (fn->hasAttr(ir::WorkspaceAPIAttrName))
+                        {
+                            auto sizeFunction = std::make_unique<hat::Function>();
+                            sizeFunction->Name(GetWorkspaceSizeFunctionName(fnName));
+                            sizeFunction->Description("Returns the size in bytes of the workspace argument of " + fnName);
+                            sizeFunction->CallingConvention(hat::CallingConventionType::CDecl);
+
+                            auto returnParam = ConvertToIncompleteHATParameter(mlir::IntegerType::get(context, 64));
+                            returnParam->Usage(hat::UsageType::Output);
+                            sizeFunction->Return(std::move(returnParam));
+
+                            std::ostringstream sizeCodeDecl;
+                            WriteWorkspaceSizeDeclaration(sizeCodeDecl, context, fnName, std::nullopt);
+                            sizeFunction->CodeDeclaration(sizeCodeDecl.str());
+
+                            package.AddFunction(std::move(sizeFunction));
+                        }
                     }
                 });
             }
@@ -704,7 +966,7 @@ namespace ir
 
             // TODO : plumb through dependencies or provide via accc
             package.Dependencies.LinkTarget(""); // Link target needs to be filled in by outer layer that knows both how far the lowering goes (object files vs fully built library) to get the right file extension
-            package.Dependencies.DeployFiles({});
+            package.Dependencies.DeployFiles(GetMappedBufferFiles(valueModuleOps));
 
             std::vector<hat::ExternalLibraryReference> dynamicDependencies;
             package.Dependencies.Dynamic(dynamicDependencies);
@@ -726,6 +988,16 @@ namespace ir
                 package.DebugCode(GetDebugCode());
             }
 
+            if (UsesThreadPool(valueModuleOps))
+            {
+                package.CodePrologue(package.CodePrologue() + GetThreadPoolPrologue());
+            }
+
+            if (UsesAsyncAPI(valueModuleOps))
+            {
+                package.CodePrologue(package.CodePrologue() + GetAsyncPrologue());
+            }
+
             os << package.Serialize();
 
             return mlir::success();
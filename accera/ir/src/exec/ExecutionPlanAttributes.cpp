@@ -11,8 +11,10 @@
 #include <llvm/ADT/STLExtras.h>
 #include <llvm/ADT/StringSwitch.h>
 
+#include <array>
 #include <iostream>
 #include <stdexcept>
+#include <vector>
 
 namespace accera::ir
 {
@@ -23,13 +25,37 @@ namespace executionPlan
     //
     mlir::DialectAsmPrinter& operator<<(mlir::DialectAsmPrinter& printer, VectorizationInfo vectorizationInfo)
     {
-        printer << "{" << vectorizationInfo.vectorBytes << "," << vectorizationInfo.vectorUnitCount << "," << (vectorizationInfo.unrollOnly ? 1 : 0) << '}';
+        printer << "{" << vectorizationInfo.vectorBytes << "," << vectorizationInfo.vectorUnitCount << "," << (vectorizationInfo.unrollOnly ? 1 : 0);
+
+        // The trailing fields are printed up to the last one that is not zero (the default)
+        std::vector<int64_t> optionalFields{ vectorizationInfo.masked ? 1 : 0, static_cast<int64_t>(vectorizationInfo.dotProduct), vectorizationInfo.bfloat16DotProduct ? 1 : 0, static_cast<int64_t>(vectorizationInfo.tableLookup) };
+        while (!optionalFields.empty() && optionalFields.back() == 0)
+        {
+            optionalFields.pop_back();
+        }
+        for (auto field : optionalFields)
+        {
+            printer << "," << field;
+        }
+        printer << '}';
         return printer;
     }
 
     mlir::DialectAsmPrinter& operator<<(mlir::DialectAsmPrinter& printer, ParallelizationInfo parallelizationInfo)
     {
-        printer << "{" << (parallelizationInfo.isDynamicPolicy ? 1 : 0) << "," << parallelizationInfo.numThreads << '}';
+        printer << "{" << static_cast<int>(parallelizationInfo.schedule) << "," << parallelizationInfo.numThreads;
+
+        // The trailing fields are printed up to the last one that is not zero (the default)
+        std::vector<int64_t> optionalFields{ parallelizationInfo.group, static_cast<int64_t>(parallelizationInfo.procBind), parallelizationInfo.firstTouch ? 1 : 0, parallelizationInfo.chunkSize };
+        while (!optionalFields.empty() && optionalFields.back() == 0)
+        {
+            optionalFields.pop_back();
+        }
+        for (auto field : optionalFields)
+        {
+            printer << "," << field;
+        }
+        printer << '}';
         return printer;
     }
 
@@ -61,7 +87,7 @@ namespace executionPlan
     VectorizationInfoAttr parseVectorizationInfo(mlir::DialectAsmParser& parser)
     {
         // Parse a vectorization info attribute in the following form:
-        //   vectorization-info-attr ::= `{` vectorBytes `,` vectorUnitCount `}`
+        //   vectorization-info-attr ::= `{` vectorBytes `,` vectorUnitCount (`,` unrollOnly (`,` masked (`,` dotProduct (`,` bfloat16DotProduct (`,` tableLookup)?)?)?)?)? `}`
 
         // NOTE: All MLIR parser function return a ParseResult. This is a
         // specialization of LogicalResult that auto-converts to a `true` boolean
@@ -83,15 +109,43 @@ namespace executionPlan
             return {};
 
         int unrollOnly = 0;
+        int masked = 0;
+        int dotProduct = 0;
+        int bfloat16DotProduct = 0;
+        int tableLookup = 0;
         if (succeeded(parser.parseOptionalComma()))
         {
             if (failed(parser.parseInteger(unrollOnly)))
                 return {};
+
+            if (succeeded(parser.parseOptionalComma()))
+            {
+                if (failed(parser.parseInteger(masked)))
+                    return {};
+
+                if (succeeded(parser.parseOptionalComma()))
+                {
+                    if (failed(parser.parseInteger(dotProduct)))
+                        return {};
+
+                    if (succeeded(parser.parseOptionalComma()))
+                    {
+                        if (failed(parser.parseInteger(bfloat16DotProduct)))
+                            return {};
+
+                        if (succeeded(parser.parseOptionalComma()))
+                        {
+                            if (failed(parser.parseInteger(tableLookup)))
+                                return {};
+                        }
+                    }
+                }
+            }
         }
         if (failed(parser.parseRBrace()))
             return {};
 
-        return VectorizationInfoAttr::get(VectorizationInfo{ vectorBytes, vectorUnitCount, static_cast<bool>(unrollOnly) }, parser.getBuilder().getContext());
+        return VectorizationInfoAttr::get(VectorizationInfo{ vectorBytes, vectorUnitCount, static_cast<bool>(unrollOnly), static_cast<bool>(masked), static_cast<IntegerDotProductKind>(dotProduct), static_cast<bool>(bfloat16DotProduct), static_cast<TableLookupKind>(tableLookup) }, parser.getBuilder().getContext());
     }
 
     void print(VectorizationInfoAttr attr, mlir::DialectAsmPrinter& printer)
@@ -117,14 +171,21 @@ namespace executionPlan
     ParallelizationInfoAttr parseParallelizationInfo(mlir::DialectAsmParser& parser)
     {
         // Parse a parallelization info attribute in the following form:
-        //   parallelization-info-attr ::= `{` isDynamicPolicy `,` numThreads `}`
+        //   parallelization-info-attr ::= `{` schedule `,` numThreads (`,` group (`,` procBind (`,` firstTouch (`,` chunkSize)?)?)?)? `}`
 
         if (failed(parser.parseLBrace()))
             return {};
 
-        int isDynamicPolicy = 0;
-        if (failed(parser.parseInteger(isDynamicPolicy)))
+        auto scheduleLoc = parser.getCurrentLocation();
+        int schedule = 0;
+        if (failed(parser.parseInteger(schedule)))
+            return {};
+
+        if (schedule < static_cast<int>(ParallelSchedule::Static) || schedule > static_cast<int>(ParallelSchedule::Guided))
+        {
+            parser.emitError(scheduleLoc, "unknown parallel schedule: ") << schedule;
             return {};
+        }
 
         if (failed(parser.parseComma()))
             return {};
@@ -133,10 +194,35 @@ namespace executionPlan
         if (failed(parser.parseInteger(numThreads)))
             return {};
 
+        // group, procBind, firstTouch, chunkSize
+        std::array<int64_t, 4> optionalFields{};
+        auto optionalFieldsLoc = parser.getCurrentLocation();
+        for (auto& field : optionalFields)
+        {
+            if (failed(parser.parseOptionalComma()))
+                break;
+
+            if (failed(parser.parseInteger(field)))
+                return {};
+        }
+        auto [group, procBind, firstTouch, chunkSize] = optionalFields;
+
+        if (procBind < static_cast<int>(ParallelProcBind::Default) || procBind > static_cast<int>(ParallelProcBind::Primary))
+        {
+            parser.emitError(optionalFieldsLoc, "unknown parallel proc bind: ") << procBind;
+            return {};
+        }
+
+        if (chunkSize < 0)
+        {
+            parser.emitError(optionalFieldsLoc, "parallel chunk size must be non-negative: ") << chunkSize;
+            return {};
+        }
+
         if (failed(parser.parseRBrace()))
             return {};
 
-        return ParallelizationInfoAttr::get(ParallelizationInfo{ static_cast<int64_t>(numThreads), static_cast<bool>(isDynamicPolicy) }, parser.getBuilder().getContext());
+        return ParallelizationInfoAttr::get(ParallelizationInfo{ static_cast<int64_t>(numThreads), static_cast<ParallelSchedule>(schedule), group, static_cast<ParallelProcBind>(procBind), firstTouch != 0, chunkSize }, parser.getBuilder().getContext());
     }
 
     void print(ParallelizationInfoAttr attr, mlir::DialectAsmPrinter& printer)
@@ -229,12 +315,12 @@ namespace executionPlan
     //
     llvm::hash_code hash_value(const VectorizationInfo& vectorizationInfo)
     {
-        return llvm::hash_combine(vectorizationInfo.vectorBytes, vectorizationInfo.vectorUnitCount);
+        return llvm::hash_combine(vectorizationInfo.vectorBytes, vectorizationInfo.vectorUnitCount, vectorizationInfo.unrollOnly, vectorizationInfo.masked, static_cast<int64_t>(vectorizationInfo.dotProduct), vectorizationInfo.bfloat16DotProduct, static_cast<int64_t>(vectorizationInfo.tableLookup));
     }
 
     llvm::hash_code hash_value(const ParallelizationInfo& parallelizationInfo)
     {
-        return llvm::hash_combine(parallelizationInfo.numThreads, parallelizationInfo.isDynamicPolicy);
+        return llvm::hash_combine(parallelizationInfo.numThreads, static_cast<int>(parallelizationInfo.schedule), parallelizationInfo.group, static_cast<int>(parallelizationInfo.procBind), parallelizationInfo.firstTouch, parallelizationInfo.chunkSize);
     }
 
     llvm::hash_code hash_value(const TensorizationInfo& tensorizationInfo)
@@ -986,7 +986,8 @@ namespace executionPlan
                             accera::ir::value::MemorySpace memorylocation,
                             AffineMap offsetArrayToCacheAccessMap,
                             const std::vector<Index>& offsetAccessIndices,
-                            const std::vector<Index>& multiCacheAccessIndices)
+                            const std::vector<Index>& multiCacheAccessIndices,
+                            mlir::ValueRange epilogueArrays)
     {
         auto offsetAccessIndexAttrs = util::ConvertIndexVectorToArrayAttr(offsetAccessIndices, builder.getContext());
         auto multiCacheAccessIndexAttrs = util::ConvertIndexVectorToArrayAttr(multiCacheAccessIndices, builder.getContext());
@@ -997,7 +998,8 @@ namespace executionPlan
               memorylocation,
               offsetArrayToCacheAccessMap,
               offsetAccessIndexAttrs,
-              multiCacheAccessIndexAttrs);
+              multiCacheAccessIndexAttrs,
+              epilogueArrays);
     }
 
     mlir::AffineValueMap MakeCacheOp::insertCachePosition(const std::vector<mlir::Value>& multiCacheIndexIterationCounters, const std::vector<mlir::Value>& offsetAccessIVs, const std::vector<mlir::Value>& baseArrayIndices)
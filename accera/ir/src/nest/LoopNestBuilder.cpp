@@ -778,6 +778,10 @@ namespace loopnest
         std::set<int64_t> splits;
         for (auto k : GetPossiblyValidKernels(state))
         {
+            if (IsPredicateFalseOverRange(loopIndex, loopRange, k.getPredicate(), state.loopIndices, schedule))
+            {
+                continue;
+            }
             AddSplits(loopIndex, loopRange, k.getPredicate(), state.loopIndices, schedule, splits);
         }
 
@@ -793,6 +797,30 @@ namespace loopnest
         return result;
     }
 
+    bool LoopNestBuilder::IsPredicateFalseOverRange(const Index& loopIndex, const Range& loopRange, Operation* predicateOp, const LoopIndexSymbolTable& runtimeIndexVariables, const LoopVisitSchedule& schedule) const
+    {
+        // A kernel whose predicate is false over the whole range of this loop doesn't run in any partition of it,
+        // so its split points would only fragment the loop (e.g., `first(i) && first(j)` splits `j` in the first
+        // partition of `i`, but not in the rest of the `i` loop, where the kernel is known not to run)
+        auto pred = dyn_cast_or_null<KernelPredicateOpInterface>(predicateOp);
+        if (!pred)
+        {
+            return false;
+        }
+
+        auto symbolTable = runtimeIndexVariables;
+        symbolTable.insert_or_assign(loopIndex, LoopIndexSymbolTableEntry{ nullptr, loopRange, LoopIndexState::inProgress });
+
+        const auto& domain = GetDomain();
+        auto simplifiedPredicate = dyn_cast_or_null<KernelPredicateOpInterface>(pred.simplify(domain, symbolTable, schedule));
+        if (!simplifiedPredicate)
+        {
+            return false;
+        }
+        auto result = simplifiedPredicate.evaluate(domain, symbolTable, schedule);
+        return result.has_value() && !*result;
+    }
+
     void LoopNestBuilder::AddSplits(const Index& loopIndex, const Range& loopRange, Operation* predicateOp, const LoopIndexSymbolTable& runtimeIndexVariables, const LoopVisitSchedule& schedule, std::set<int64_t>& allSplits) const
     {
         // Adds split points for a fixed loopRange. This does not change the top level boundaries of the loop.
@@ -1045,7 +1073,7 @@ namespace loopnest
             {
                 for (auto t : conjunction.values())
                 {
-                    result = result && containsFragmentPredicate(t.getDefiningOp(), type);
+                    result = result || containsFragmentPredicate(t.getDefiningOp(), type);
                 }
             }
             else if (auto disjunction = dyn_cast_or_null<DisjunctionPredicateOp>(p))
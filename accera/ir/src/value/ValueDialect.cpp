@@ -459,6 +459,43 @@ void MapReduceOp::build(OpBuilder& builder, OperationState& result, Value input,
     }
 }
 
+void MultiReduceOp::build(OpBuilder& builder, OperationState& result, Value input, ValueRange initArgs, int64_t lanes, ReduceBodyBuilderFn reduceBodyBuilder, CombineBodyBuilderFn combineBodyBuilder)
+{
+    auto elementType = input.getType().cast<ShapedType>().getElementType();
+    auto numReductions = initArgs.size();
+    result.addOperands(input);
+    result.addOperands(initArgs);
+    result.addAttribute("lanes", builder.getI64IntegerAttr(lanes));
+    result.addTypes(initArgs.getTypes());
+
+    // Reduce body: (a, p...) -> p...
+    Region* reduceBodyRegion = result.addRegion();
+    reduceBodyRegion->push_back(new Block);
+    Block& reduceBodyBlock = reduceBodyRegion->front();
+    reduceBodyBlock.addArgument(elementType);
+    reduceBodyBlock.addArguments(initArgs.getTypes());
+    {
+        OpBuilder::InsertionGuard guard(builder);
+        builder.setInsertionPointToStart(&reduceBodyBlock);
+        if (reduceBodyBuilder)
+            reduceBodyBuilder(builder, result.location, reduceBodyBlock.getArgument(0), reduceBodyBlock.getArguments().drop_front());
+    }
+
+    // Combine body: (p..., q...) -> p...
+    Region* combineBodyRegion = result.addRegion();
+    combineBodyRegion->push_back(new Block);
+    Block& combineBodyBlock = combineBodyRegion->front();
+    combineBodyBlock.addArguments(initArgs.getTypes());
+    combineBodyBlock.addArguments(initArgs.getTypes());
+    {
+        OpBuilder::InsertionGuard guard(builder);
+        builder.setInsertionPointToStart(&combineBodyBlock);
+        auto arguments = combineBodyBlock.getArguments();
+        if (combineBodyBuilder)
+            combineBodyBuilder(builder, result.location, arguments.take_front(numReductions), arguments.drop_front(numReductions));
+    }
+}
+
 //===----------------------------------------------------------------------===//
 // MFMAMatrixType
 //===----------------------------------------------------------------------===//
@@ -698,6 +735,47 @@ static LogicalResult verify(MFMAStoreOp op)
     return success();
 }
 
+//===----------------------------------------------------------------------===//
+// GPU Reduce Op
+//===----------------------------------------------------------------------===//
+
+static LogicalResult verify(GPUReduceOp op)
+{
+    auto scope = op.scope();
+    if (scope != BarrierScope::Warp && scope != BarrierScope::Block)
+        return op.emitError("only the Warp and Block scopes are supported");
+
+    if (!op.value().getType().isIntOrFloat())
+        return op.emitError("expected an integer or floating point value");
+
+    return success();
+}
+
+//===----------------------------------------------------------------------===//
+// Table Lookup Op
+//===----------------------------------------------------------------------===//
+
+static LogicalResult verify(TableLookupOp op)
+{
+    // The vector lookups load the table into registers with plain vector loads
+    auto tableType = op.table().getType().cast<MemRefType>();
+    SmallVector<int64_t, 1> strides;
+    int64_t offset;
+    if (tableType.getShape() != ArrayRef<int64_t>{ 256 } || failed(getStridesAndOffset(tableType, strides, offset)) || strides.front() != 1)
+        return op.emitError("expected a contiguous table of 256 entries");
+
+    auto indexType = op.index().getType();
+    Type expectedType = tableType.getElementType();
+    if (auto vectorType = indexType.dyn_cast<VectorType>())
+    {
+        expectedType = VectorType::get(vectorType.getShape(), expectedType);
+    }
+    if (op.result().getType() != expectedType)
+        return op.emitError("expected a result of the table element type, in the shape of the index");
+
+    return success();
+}
+
 // TableGen'd op method definitions
 #define GET_OP_CLASSES
 #include "value/ValueOps.cpp.inc"
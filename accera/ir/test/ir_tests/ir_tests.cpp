@@ -2503,6 +2503,329 @@ TEST_CASE_METHOD(Fixture, "parallelize_gemm", "[cpu][nest][parallel]")
                          << debugString(module));
 }
 
+TEST_CASE_METHOD(Fixture, "parallelize_gemm_work_stealing", "[cpu][nest][parallel]")
+{
+    auto target = GENERATE(ConversionTarget::accera, ConversionTarget::mlir, ConversionTarget::llvm);
+
+    auto [M_, N_, K_] = GENERATE(std::tuple{ 256, 256, 256 }, std::tuple{ 250, 250, 250 });
+    int64_t numThreads = GENERATE(4, 16);
+
+    using namespace accera::value;
+    using namespace accera::utilities;
+    using accera::value::Value;
+
+    DeclareFunction("NestMatMul")
+        .Public(true)
+        .Parameters(
+            Value({ ValueType::Float, MemoryLayout(MemoryShape{ M_, K_ }) }),
+            Value({ ValueType::Float, MemoryLayout(MemoryShape{ K_, N_ }) }),
+            Value({ ValueType::Float, MemoryLayout(MemoryShape{ M_, N_ }) }))
+        .Define([=](Array A, Array B, Array C) {
+            const int OutputRows = (int)(A.Shape()[0]); // M
+            const int OutputColumns = (int)(B.Shape()[1]); // N
+            const int InnerDimension = (int)(A.Shape()[1]); // K
+
+            Nest nest({ OutputRows, OutputColumns, InnerDimension });
+
+            auto indices = nest.GetIndices();
+            auto i = indices[0];
+            auto j = indices[1];
+            auto k = indices[2];
+
+            nest.Set([&]() { C(i, j) += A(i, k) * B(k, j); });
+
+            auto schedule = nest.CreateSchedule();
+
+            // Non-divisible splits create boundary fragments, which is the imbalance work-stealing is meant to absorb
+            auto [iOuter, iInner] = schedule.Split(i, 16);
+            auto [jOuter, jInner] = schedule.Split(j, 16);
+            schedule.SetOrder({ iOuter, jOuter, k, iInner, jInner });
+            auto plan = schedule.CreatePlan();
+            plan.Parallelize({ iOuter, jOuter }, numThreads, ParallelizationPolicy::WorkStealing);
+        });
+
+    accera::transforms::AcceraPassPipelineOptions options;
+
+    RunConversionPasses(target, "gemm_work_stealing_" + std::to_string(M_) + "_" + std::to_string(N_) + "_" + std::to_string(K_) + "_" + "p" + std::to_string(numThreads) + "_" + stringify(target), options);
+    SUCCEED("targeting " << stringify(target) << ":\n\n"
+                         << debugString(module));
+}
+
+TEST_CASE_METHOD(Fixture, "parallelize_gemm_nested", "[cpu][nest][parallel]")
+{
+    auto target = GENERATE(ConversionTarget::accera, ConversionTarget::mlir, ConversionTarget::llvm);
+
+    auto [M_, N_, K_] = GENERATE(std::tuple{ 256, 256, 256 }, std::tuple{ 250, 250, 250 });
+    int64_t outerThreads = 2;
+    int64_t innerThreads = GENERATE(4, 8);
+
+    using namespace accera::value;
+    using namespace accera::utilities;
+    using accera::value::Value;
+
+    DeclareFunction("NestMatMul")
+        .Public(true)
+        .Parameters(
+            Value({ ValueType::Float, MemoryLayout(MemoryShape{ M_, K_ }) }),
+            Value({ ValueType::Float, MemoryLayout(MemoryShape{ K_, N_ }) }),
+            Value({ ValueType::Float, MemoryLayout(MemoryShape{ M_, N_ }) }))
+        .Define([=](Array A, Array B, Array C) {
+            const int OutputRows = (int)(A.Shape()[0]); // M
+            const int OutputColumns = (int)(B.Shape()[1]); // N
+            const int InnerDimension = (int)(A.Shape()[1]); // K
+
+            Nest nest({ OutputRows, OutputColumns, InnerDimension });
+
+            auto indices = nest.GetIndices();
+            auto i = indices[0];
+            auto j = indices[1];
+            auto k = indices[2];
+
+            nest.Set([&]() { C(i, j) += A(i, k) * B(k, j); });
+
+            auto schedule = nest.CreateSchedule();
+
+            // The outer band is split across core clusters, the inner band across the cores of each cluster
+            auto [iOuter, iInner] = schedule.Split(i, 128);
+            auto [jOuter, jInner] = schedule.Split(j, 16);
+            schedule.SetOrder({ iOuter, jOuter, iInner, k, jInner });
+            auto plan = schedule.CreatePlan();
+            plan.Parallelize({ iOuter }, outerThreads, ParallelizationPolicy::Static);
+            plan.Parallelize({ jOuter }, innerThreads, ParallelizationPolicy::Dynamic);
+        });
+
+    accera::transforms::AcceraPassPipelineOptions options;
+
+    RunConversionPasses(target, "gemm_nested_" + std::to_string(M_) + "_" + std::to_string(N_) + "_" + std::to_string(K_) + "_" + "p" + std::to_string(outerThreads) + "x" + std::to_string(innerThreads) + "_" + stringify(target), options);
+    SUCCEED("targeting " << stringify(target) << ":\n\n"
+                         << debugString(module));
+}
+
+TEST_CASE_METHOD(Fixture, "parallelize_gemm_chunked", "[cpu][nest][parallel]")
+{
+    auto target = GENERATE(ConversionTarget::accera, ConversionTarget::mlir, ConversionTarget::llvm);
+
+    const int64_t M_ = 250, N_ = 256, K_ = 256;
+    auto policy = GENERATE(accera::value::ParallelizationPolicy::Static, accera::value::ParallelizationPolicy::Dynamic, accera::value::ParallelizationPolicy::Guided, accera::value::ParallelizationPolicy::WorkStealing);
+    int64_t chunkSize = GENERATE(1, 3, 16);
+    int64_t numThreads = 4;
+
+    using namespace accera::value;
+    using namespace accera::utilities;
+    using accera::value::Value;
+
+    DeclareFunction("NestMatMul")
+        .Public(true)
+        .Parameters(
+            Value({ ValueType::Float, MemoryLayout(MemoryShape{ M_, K_ }) }),
+            Value({ ValueType::Float, MemoryLayout(MemoryShape{ K_, N_ }) }),
+            Value({ ValueType::Float, MemoryLayout(MemoryShape{ M_, N_ }) }))
+        .Define([=](Array A, Array B, Array C) {
+            Nest nest({ M_, N_, K_ });
+
+            auto indices = nest.GetIndices();
+            auto i = indices[0];
+            auto j = indices[1];
+            auto k = indices[2];
+
+            nest.Set([&]() { C(i, j) += A(i, k) * B(k, j); });
+
+            // The collapsed (i, jOuter) band does not divide evenly into chunks, so the last chunk is partial
+            auto schedule = nest.CreateSchedule();
+            auto [jOuter, jInner] = schedule.Split(j, 64);
+            schedule.SetOrder({ i, jOuter, k, jInner });
+            auto plan = schedule.CreatePlan();
+            plan.Parallelize({ i, jOuter }, numThreads, policy, ParallelizationPinning::Default, {}, false, chunkSize);
+        });
+
+    accera::transforms::AcceraPassPipelineOptions options;
+
+    RunConversionPasses(target, "gemm_chunked_" + std::to_string(static_cast<int>(policy)) + "_c" + std::to_string(chunkSize) + "_" + stringify(target), options);
+    SUCCEED("targeting " << stringify(target) << ":\n\n"
+                         << debugString(module));
+}
+
+TEST_CASE_METHOD(Fixture, "parallelize_gemm_pinned", "[cpu][nest][parallel]")
+{
+    auto target = GENERATE(ConversionTarget::accera, ConversionTarget::mlir, ConversionTarget::llvm);
+
+    const int64_t M_ = 256, N_ = 256, K_ = 256;
+    auto [pinning, processors] = GENERATE(std::pair{ accera::value::ParallelizationPinning::Spread, std::vector<int64_t>{} }, std::pair{ accera::value::ParallelizationPinning::Close, std::vector<int64_t>{ 0, 2, 4, 6 } });
+    int64_t numThreads = 4;
+
+    using namespace accera::value;
+    using namespace accera::utilities;
+    using accera::value::Value;
+
+    DeclareFunction("NestMatMul")
+        .Public(true)
+        .Parameters(
+            Value({ ValueType::Float, MemoryLayout(MemoryShape{ M_, K_ }) }),
+            Value({ ValueType::Float, MemoryLayout(MemoryShape{ K_, N_ }) }),
+            Value({ ValueType::Float, MemoryLayout(MemoryShape{ M_, N_ }) }))
+        .Define([=, pinning = pinning, processors = processors](Array A, Array B, Array C) {
+            Nest nest({ M_, N_, K_ });
+
+            auto indices = nest.GetIndices();
+            auto i = indices[0];
+            auto j = indices[1];
+            auto k = indices[2];
+
+            nest.Set([&]() { C(i, j) += A(i, k) * B(k, j); });
+
+            auto schedule = nest.CreateSchedule();
+
+            // Each thread fills its own cache of B, allocated on the thread's NUMA node
+            auto [iOuter, iInner] = schedule.Split(i, 64);
+            auto [jOuter, jInner] = schedule.Split(j, 16);
+            schedule.SetOrder({ iOuter, jOuter, k, iInner, jInner });
+            auto plan = schedule.CreatePlan();
+            plan.AddCache(B, k);
+            plan.Parallelize({ iOuter }, numThreads, ParallelizationPolicy::Static, pinning, processors, true);
+        });
+
+    accera::transforms::AcceraPassPipelineOptions options;
+
+    RunConversionPasses(target, "gemm_pinned_" + std::to_string(processors.size()) + "_" + stringify(target), options);
+    SUCCEED("targeting " << stringify(target) << ":\n\n"
+                         << debugString(module));
+}
+
+TEST_CASE_METHOD(Fixture, "parallelize_gemm_thread_local_cache", "[cpu][nest][parallel]")
+{
+    auto target = GENERATE(ConversionTarget::accera, ConversionTarget::mlir, ConversionTarget::llvm);
+
+    const int64_t M_ = 256, N_ = 256, K_ = 256;
+    int64_t numThreads = 4;
+
+    using namespace accera::value;
+    using namespace accera::utilities;
+    using accera::value::Value;
+
+    DeclareFunction("NestMatMul")
+        .Public(true)
+        .Parameters(
+            Value({ ValueType::Float, MemoryLayout(MemoryShape{ M_, K_ }) }),
+            Value({ ValueType::Float, MemoryLayout(MemoryShape{ K_, N_ }) }),
+            Value({ ValueType::Float, MemoryLayout(MemoryShape{ M_, N_ }) }))
+        .Define([=](Array A, Array B, Array C) {
+            Nest nest({ M_, N_, K_ });
+
+            auto indices = nest.GetIndices();
+            auto i = indices[0];
+            auto j = indices[1];
+            auto k = indices[2];
+
+            nest.Set([&]() { C(i, j) += A(i, k) * B(k, j); });
+
+            auto schedule = nest.CreateSchedule();
+
+            // Each thread fills and reads its own cache of B instead of racing on a shared buffer
+            auto [iOuter, iInner] = schedule.Split(i, 64);
+            auto [jOuter, jInner] = schedule.Split(j, 16);
+            schedule.SetOrder({ iOuter, jOuter, k, iInner, jInner });
+            auto plan = schedule.CreatePlan();
+            plan.AddCache(B, k, false /* thrifty */, false /* doubleBuffer */, std::nullopt /* vectorizationInfo */, CacheIndexing::GlobalToPhysical, CacheAllocation::ThreadLocal);
+            plan.Parallelize({ iOuter }, numThreads, ParallelizationPolicy::Static);
+        });
+
+    accera::transforms::AcceraPassPipelineOptions options;
+
+    RunConversionPasses(target, "gemm_thread_local_cache_" + stringify(target), options);
+    SUCCEED("targeting " << stringify(target) << ":\n\n"
+                         << debugString(module));
+}
+
+TEST_CASE_METHOD(Fixture, "parallelize_gemm_split_k", "[cpu][nest][parallel]")
+{
+    auto target = GENERATE(ConversionTarget::accera, ConversionTarget::mlir, ConversionTarget::llvm);
+
+    const int64_t M_ = 16, N_ = 16, K_ = 4096;
+    int64_t numThreads = 8;
+
+    using namespace accera::value;
+    using namespace accera::utilities;
+    using accera::value::Value;
+
+    DeclareFunction("NestMatMul")
+        .Public(true)
+        .Parameters(
+            Value({ ValueType::Float, MemoryLayout(MemoryShape{ M_, K_ }) }),
+            Value({ ValueType::Float, MemoryLayout(MemoryShape{ K_, N_ }) }),
+            Value({ ValueType::Float, MemoryLayout(MemoryShape{ M_, N_ }) }))
+        .Define([=](Array A, Array B, Array C) {
+            Nest nest({ M_, N_, K_ });
+
+            auto indices = nest.GetIndices();
+            auto i = indices[0];
+            auto j = indices[1];
+            auto k = indices[2];
+
+            nest.Set([&]() { C(i, j) += A(i, k) * B(k, j); });
+
+            auto schedule = nest.CreateSchedule();
+
+            // Each thread accumulates a slice of K into its own cache of C, which is then atomically added to C
+            auto [kOuter, kInner] = schedule.Split(k, K_ / numThreads);
+            schedule.SetOrder({ kOuter, i, j, kInner });
+            auto plan = schedule.CreatePlan();
+            plan.AddCache(C, i, false /* thrifty */, false /* doubleBuffer */, std::nullopt /* vectorizationInfo */, CacheIndexing::GlobalToPhysical, CacheAllocation::ThreadLocal);
+            plan.Parallelize({ kOuter }, numThreads, ParallelizationPolicy::Static, ParallelizationPinning::Default, {}, false, 0, true);
+        });
+
+    accera::transforms::AcceraPassPipelineOptions options;
+
+    RunConversionPasses(target, "gemm_split_k_" + stringify(target), options);
+    SUCCEED("targeting " << stringify(target) << ":\n\n"
+                         << debugString(module));
+}
+
+TEST_CASE_METHOD(Fixture, "parallelize_gemm_cooperative_cache", "[cpu][nest][parallel]")
+{
+    auto target = GENERATE(ConversionTarget::accera, ConversionTarget::mlir, ConversionTarget::llvm);
+
+    const int64_t M_ = 256, N_ = 256, K_ = 256;
+    int64_t numThreads = 4;
+
+    using namespace accera::value;
+    using namespace accera::utilities;
+    using accera::value::Value;
+
+    DeclareFunction("NestMatMul")
+        .Public(true)
+        .Parameters(
+            Value({ ValueType::Float, MemoryLayout(MemoryShape{ M_, K_ }) }),
+            Value({ ValueType::Float, MemoryLayout(MemoryShape{ K_, N_ }) }),
+            Value({ ValueType::Float, MemoryLayout(MemoryShape{ M_, N_ }) }))
+        .Define([=](Array A, Array B, Array C) {
+            Nest nest({ M_, N_, K_ });
+
+            auto indices = nest.GetIndices();
+            auto i = indices[0];
+            auto j = indices[1];
+            auto k = indices[2];
+
+            nest.Set([&]() { C(i, j) += A(i, k) * B(k, j); });
+
+            auto schedule = nest.CreateSchedule();
+
+            // The panel of B is shared by the threads of the parallel loop over i, so they all fill it
+            auto [iOuter, iInner] = schedule.Split(i, 64);
+            auto [jOuter, jInner] = schedule.Split(j, 64);
+            schedule.SetOrder({ jOuter, iOuter, k, iInner, jInner });
+            auto plan = schedule.CreatePlan();
+            auto cache = plan.AddCache(B, iOuter);
+            cache.SetCooperativeCopy();
+            plan.Parallelize({ iOuter }, numThreads, ParallelizationPolicy::Static);
+        });
+
+    accera::transforms::AcceraPassPipelineOptions options;
+
+    RunConversionPasses(target, "gemm_cooperative_cache_" + stringify(target), options);
+    SUCCEED("targeting " << stringify(target) << ":\n\n"
+                         << debugString(module));
+}
+
 TEST_CASE_METHOD(Fixture, "parallelize_gemm_mlas_value", "[cpu][nest]")
 {
     auto target = GENERATE(ConversionTarget::accera, ConversionTarget::mlir, ConversionTarget::llvm);
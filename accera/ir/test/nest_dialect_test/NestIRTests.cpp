@@ -1139,8 +1139,6 @@ void LowerConjunctionKernelTest()
     //   for j
     //     for k
     //       print(%1)
-
-    // ERROR: currently splits 'j' loop in 2nd split of 'i'
 }
 
 void LowerDisjunctionKernelTest()
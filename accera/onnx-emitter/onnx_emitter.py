@@ -6,16 +6,21 @@
 
 import sys
 import argparse
+import math
 import onnx
 import os
 
+from collections import defaultdict
 from pathlib import Path
+from typing import List, NamedTuple
 
-from accera import Package, Target, Array
+from accera import Package, Target, Array, Nest, Scalar, fuse
+from accera import exp, sqrt, fast_gelu, fast_sigmoid, FastMathAccuracy
+from accera import max as accera_max
 from accera.hat import ONNXHATPackage
 from accera.samples import MLAS, MLASOptions
 
-from onnx import helper
+from onnx import helper, numpy_helper
 from onnxruntime.tools.symbolic_shape_infer import (SymbolicShapeInference, get_shape_from_type_proto)
 
 
@@ -272,6 +277,528 @@ def handle_matmul_node(node, model, package, target=Target.HOST):
     return package.add(plan, args, base_name=node.name, auxiliary={ONNXHATPackage.AuxTableName: emitted_info})
 
 
+# The activations that can be fused into the functions of the nodes they follow
+FUSED_ACTIVATIONS = {
+    'Relu': lambda x: accera_max(x, Scalar(0.0)),
+    'Gelu': fast_gelu,
+    'FastGelu': lambda x: fast_gelu(x, FastMathAccuracy.LOW),    # the tanh form of GELU
+    'Sigmoid': fast_sigmoid,
+}
+
+# The lowest finite float32, the initial maximum of the rows of a softmax
+FLOAT32_LOWEST = -3.4028234663852886e38
+
+
+class FusedSubgraph(NamedTuple):
+    """A subgraph of the model that is emitted as a single Accera function"""
+    pattern: str    # the kind of subgraph, recorded as the node type of the function
+    nodes: List[onnx.NodeProto]    # the nodes of the subgraph, in graph order
+    inputs: List[str]    # the tensors the function takes, in the order of its arguments
+    output: str    # the tensor the function produces
+    attributes: dict    # the values of the subgraph that are compiled into the function, such as constants
+
+
+class GraphIndex:
+    """The producers and consumers of the tensors of a graph"""
+
+    def __init__(self, model):
+        graph = model.graph
+        self.nodes = list(graph.node)
+        self.producers = {output: node for node in self.nodes for output in node.output}
+        self.consumers = defaultdict(list)
+        for node in self.nodes:
+            for input in node.input:
+                self.consumers[input].append(node)
+        self.graph_outputs = {output.name for output in graph.output}
+
+    def internal_consumers(self, name):
+        """Returns the consumers of a tensor, or an empty list if the tensor is an output of the graph, which must stay
+        visible outside of a fused subgraph"""
+        return [] if name in self.graph_outputs else self.consumers[name]
+
+    def single_consumer(self, name, op_types):
+        """Returns the only consumer of a tensor if it is one of the given operators, None otherwise"""
+        consumers = self.internal_consumers(name)
+        if len(consumers) == 1 and consumers[0].op_type in op_types:
+            return consumers[0]
+        return None
+
+
+def get_constant(model, name):
+    """Returns the value of an initializer or of the output of a Constant node as a numpy array, None otherwise"""
+    initializer = get_initializer(model, name)
+    if initializer:
+        return numpy_helper.to_array(initializer)
+    for node in model.graph.node:
+        if node.op_type == 'Constant' and node.output[0] == name:
+            value = get_attribute(node, 'value')
+            return numpy_helper.to_array(value) if value is not None else None
+    return None
+
+
+def get_scalar_constant(model, name):
+    value = get_constant(model, name)
+    return float(value.reshape(-1)[0]) if value is not None and value.size == 1 else None
+
+
+def get_static_shape(model, name):
+    """Returns the shape of a tensor if all of its dimensions are known, None otherwise"""
+    shape = get_shape(model, name)
+    if shape is None or not all(isinstance(dim, int) and dim > 0 for dim in shape):
+        return None
+    return list(shape)
+
+
+def get_other_input(node, name):
+    return node.input[1] if node.input[0] == name else node.input[0]
+
+
+def is_last_axis(axis, rank):
+    return axis == -1 or axis == rank - 1
+
+
+def match_activation(model, index, name):
+    """Matches an activation of a tensor. Returns the activation, its nodes and its output, or None"""
+    consumers = index.internal_consumers(name)
+    if len(consumers) == 1:
+        node = consumers[0]
+        if node.op_type in FUSED_ACTIVATIONS and len(node.input) == 1:
+            return node.op_type, [node], node.output[0]
+        return None
+
+    # x * (1 + erf(x / sqrt(2))) * 0.5, the form of GELU that PyTorch exports
+    if len(consumers) != 2:
+        return None
+    div = next((node for node in consumers if node.op_type == 'Div' and node.input[0] == name), None)
+    if div is None or not math.isclose(get_scalar_constant(model, div.input[1]) or 0.0, math.sqrt(2.0), rel_tol=1e-4):
+        return None
+    erf = index.single_consumer(div.output[0], ('Erf', ))
+    add = erf and index.single_consumer(erf.output[0], ('Add', ))
+    if not add or get_scalar_constant(model, get_other_input(add, erf.output[0])) != 1.0:
+        return None
+    mul = index.single_consumer(add.output[0], ('Mul', ))
+    if not mul or get_other_input(mul, add.output[0]) != name or mul not in consumers:
+        return None
+    half = index.single_consumer(mul.output[0], ('Mul', ))
+    if not half or get_scalar_constant(model, get_other_input(half, mul.output[0])) != 0.5:
+        return None
+    return 'Gelu', [div, erf, add, mul, half], half.output[0]
+
+
+def match_matmul_bias_activation(node, model, index):
+    """Matches MatMul + Add of a bias, optionally followed by an activation"""
+    if node.op_type != 'MatMul':
+        return None
+
+    A_name, B_name = node.input
+    A_shape, B_shape = get_static_shape(model, A_name), get_static_shape(model, B_name)
+    if not A_shape or not B_shape or len(A_shape) < 2 or len(B_shape) != 2:
+        return None
+
+    add = index.single_consumer(node.output[0], ('Add', ))
+    if not add:
+        return None
+    bias_name = get_other_input(add, node.output[0])
+    if get_static_shape(model, bias_name) != [B_shape[-1]]:
+        return None
+
+    nodes = [node, add]
+    output = add.output[0]
+    activation = match_activation(model, index, output)
+    if activation:
+        activation, activation_nodes, output = activation
+        nodes += activation_nodes
+
+    return FusedSubgraph(pattern='MatMulAdd' + (activation or ''),
+                         nodes=nodes,
+                         inputs=[A_name, B_name, bias_name],
+                         output=output,
+                         attributes={'activation': activation})
+
+
+def match_layer_norm(node, model, index):
+    """Matches a LayerNormalization node over the last axis, or its decomposition into
+    ReduceMean, Sub, Pow, ReduceMean, Add, Sqrt, Div, Mul and Add"""
+
+    def reduces_last_axis(reduce_node, rank):
+        axes = get_attribute(reduce_node, 'axes')
+        if axes is None and len(reduce_node.input) > 1:
+            axes = get_constant(model, reduce_node.input[1])
+            axes = list(axes.reshape(-1)) if axes is not None else None
+        return axes is not None and len(axes) == 1 and is_last_axis(axes[0], rank)
+
+    if node.op_type == 'LayerNormalization':
+        X_shape = get_static_shape(model, node.input[0])
+        if not X_shape or len(X_shape) < 2 or len(node.input) < 3 or not node.input[2] or \
+                not is_last_axis(get_attribute(node, 'axis', -1), len(X_shape)):
+            return None
+        return FusedSubgraph(pattern='LayerNormalization',
+                             nodes=[node],
+                             inputs=list(node.input[:3]),
+                             output=node.output[0],
+                             attributes={'epsilon': get_attribute(node, 'epsilon', 1e-5)})
+
+    if node.op_type != 'ReduceMean':
+        return None
+
+    X_name = node.input[0]
+    X_shape = get_static_shape(model, X_name)
+    if not X_shape or len(X_shape) < 2 or not reduces_last_axis(node, len(X_shape)):
+        return None
+
+    sub = index.single_consumer(node.output[0], ('Sub', ))
+    if not sub or list(sub.input) != [X_name, node.output[0]]:
+        return None
+
+    centered = index.internal_consumers(sub.output[0])
+    square = next((n for n in centered if n.op_type == 'Pow' and n.input[0] == sub.output[0]), None)
+    div = next((n for n in centered if n.op_type == 'Div' and n.input[0] == sub.output[0]), None)
+    if len(centered) != 2 or not square or not div or get_scalar_constant(model, square.input[1]) != 2.0:
+        return None
+
+    variance = index.single_consumer(square.output[0], ('ReduceMean', ))
+    if not variance or not reduces_last_axis(variance, len(X_shape)):
+        return None
+    add_epsilon = index.single_consumer(variance.output[0], ('Add', ))
+    epsilon = add_epsilon and get_scalar_constant(model, get_other_input(add_epsilon, variance.output[0]))
+    if epsilon is None:
+        return None
+    root = index.single_consumer(add_epsilon.output[0], ('Sqrt', ))
+    if not root or index.single_consumer(root.output[0], ('Div', )) is not div:
+        return None
+
+    scale = index.single_consumer(div.output[0], ('Mul', ))
+    shift = scale and index.single_consumer(scale.output[0], ('Add', ))
+    if not shift:
+        return None
+    scale_name = get_other_input(scale, div.output[0])
+    bias_name = get_other_input(shift, scale.output[0])
+    if get_static_shape(model, scale_name) != X_shape[-1:] or get_static_shape(model, bias_name) != X_shape[-1:]:
+        return None
+
+    return FusedSubgraph(pattern='LayerNormalization',
+                         nodes=[node, sub, square, variance, add_epsilon, root, div, scale, shift],
+                         inputs=[X_name, scale_name, bias_name],
+                         output=shift.output[0],
+                         attributes={'epsilon': epsilon})
+
+
+def match_attention(node, model, index):
+    """Matches the attention block MatMul(Q, K^T), an optional scaling by a constant and addition of a mask, Softmax
+    over the last axis and MatMul with V. K^T is either an input or the Transpose of the last two axes of K"""
+    if node.op_type != 'MatMul':
+        return None
+
+    nodes = [node]
+    Q_name, K_name = node.input
+    transposed_K = False
+    transpose = index.producers.get(K_name)
+    if transpose and transpose.op_type == 'Transpose' and index.single_consumer(K_name, ('MatMul', )) is node:
+        perm = list(get_attribute(transpose, 'perm', []))
+        rank = len(perm)
+        if rank >= 2 and perm == list(range(rank - 2)) + [rank - 1, rank - 2]:
+            nodes.insert(0, transpose)
+            K_name = transpose.input[0]
+            transposed_K = True
+
+    scores = node.output[0]
+    scale = 1.0
+    next_node = index.single_consumer(scores, ('Div', 'Mul'))
+    if next_node and next_node.input[0] == scores:
+        constant = get_scalar_constant(model, next_node.input[1])
+        if constant:
+            scale = 1.0 / constant if next_node.op_type == 'Div' else constant
+            nodes.append(next_node)
+            scores = next_node.output[0]
+
+    mask_name = None
+    next_node = index.single_consumer(scores, ('Add', ))
+    if next_node:
+        mask_name = get_other_input(next_node, scores)
+        nodes.append(next_node)
+        scores = next_node.output[0]
+
+    softmax = index.single_consumer(scores, ('Softmax', ))
+    opset = next((opset.version for opset in model.opset_import if opset.domain in ('', 'ai.onnx')), 13)
+    Q_shape = get_static_shape(model, Q_name)
+    if not softmax or not Q_shape or \
+            not is_last_axis(get_attribute(softmax, 'axis', -1 if opset >= 13 else 1), len(Q_shape)):
+        return None
+
+    pv = index.single_consumer(softmax.output[0], ('MatMul', ))
+    if not pv or pv.input[0] != softmax.output[0]:
+        return None
+    V_name = pv.input[1]
+
+    K_shape, V_shape = get_static_shape(model, K_name), get_static_shape(model, V_name)
+    if not K_shape or not V_shape or not (len(Q_shape) == len(K_shape) == len(V_shape) >= 2):
+        return None
+    stack, (S, D) = Q_shape[:-2], Q_shape[-2:]
+    S_kv, E = V_shape[-2:]
+    if K_shape != stack + ([S_kv, D] if transposed_K else [D, S_kv]) or V_shape[:-2] != stack:
+        return None
+    if mask_name:
+        # The mask is indexed by the trailing axes of the scores, without broadcasting of unit axes
+        mask_shape = get_static_shape(model, mask_name)
+        scores_shape = stack + [S, S_kv]
+        if get_constant(model, mask_name) is not None or not mask_shape or \
+                mask_shape != scores_shape[len(scores_shape) - len(mask_shape):]:
+            return None
+
+    return FusedSubgraph(pattern='Attention',
+                         nodes=nodes + [softmax, pv],
+                         inputs=[Q_name, K_name, V_name] + ([mask_name] if mask_name else []),
+                         output=pv.output[0],
+                         attributes={
+                             'scale': scale,
+                             'transposed_K': transposed_K
+                         })
+
+
+# Tried in order on each node of the graph that does not belong to a fused subgraph yet
+SUBGRAPH_MATCHERS = [match_attention, match_layer_norm, match_matmul_bias_activation]
+
+
+def find_fused_subgraphs(model):
+    """Finds the subgraphs of the model that can be emitted as single functions. The tensors that are internal to a
+    subgraph have no other consumers, so that they never need to be materialized"""
+    index = GraphIndex(model)
+    subgraphs = []
+    fused_nodes = set()    # the first output of each node, which identifies it
+    for node in index.nodes:
+        if node.output[0] in fused_nodes:
+            continue
+        for matcher in SUBGRAPH_MATCHERS:
+            subgraph = matcher(node, model, index)
+            if subgraph and not any(n.output[0] in fused_nodes for n in subgraph.nodes):
+                subgraphs.append(subgraph)
+                fused_nodes.update(n.output[0] for n in subgraph.nodes)
+                break
+    return subgraphs, fused_nodes
+
+
+def get_nest_indices(nest):
+    indices = nest.get_indices()
+    return indices if isinstance(indices, list) else [indices]
+
+
+def get_fused_function_info(subgraph, args):
+    name = subgraph.nodes[0].name or f"{subgraph.pattern}_{subgraph.output}"
+    return name, {
+        ONNXHATPackage.NodeNameKey: name,
+        ONNXHATPackage.NodeTypeKey: subgraph.pattern,
+        ONNXHATPackage.NodeDomainKey: "",
+        ONNXHATPackage.NodeArgsKey: subgraph.inputs + [subgraph.output],
+        ONNXHATPackage.NodeArgShapesKey: [list(arg.shape) for arg in args],
+        ONNXHATPackage.NodeFusedNodesKey: [node.name for node in subgraph.nodes],
+    }
+
+
+def handle_matmul_bias_activation(subgraph, model, package, target=Target.HOST):
+    A_name, B_name, bias_name = subgraph.inputs
+    A_shape = get_static_shape(model, A_name)
+    B_shape = get_static_shape(model, B_name)
+    K, N = B_shape
+
+    # The leading axes of A and Y are contiguous, so they are passed as the rows of a single matrix
+    rows = math.prod(A_shape[:-1])
+    A = Array(role=Array.Role.INPUT, element_type=float, shape=[rows, K])
+    B = Array(role=Array.Role.INPUT, element_type=float, shape=B_shape)
+    bias = Array(role=Array.Role.INPUT, element_type=float, shape=[N])
+    Y = Array(role=Array.Role.INPUT_OUTPUT, element_type=float, shape=[rows, N])
+
+    name, emitted_info = get_fused_function_info(subgraph, [A, B, bias, Y])
+    opts = get_target_options(target)
+    if get_initializer(model, B_name):
+        opts = opts._replace(PackBFuncName=f"{name}_reshape_B", PackBBufferSizeFuncName=f"{name}_reshape_B_size")
+        emitted_info[ONNXHATPackage.NodePackingFunctionsKey] = {
+            B_name: [opts.PackBFuncName, opts.PackBBufferSizeFuncName]
+        }
+
+    activation = subgraph.attributes['activation']
+    plan, args = MLAS(A,
+                      B,
+                      Y,
+                      bias=bias,
+                      zero_C=True,
+                      opts=opts,
+                      target=target,
+                      activation=FUSED_ACTIVATIONS[activation] if activation else None)
+    return package.add(plan, args=args, base_name=name, auxiliary={ONNXHATPackage.AuxTableName: emitted_info})
+
+
+def handle_layer_norm(subgraph, model, package, target=Target.HOST):
+    X_name, scale_name, bias_name = subgraph.inputs
+    X_shape = get_static_shape(model, X_name)
+    rows, N = X_shape[:-1], X_shape[-1]
+    epsilon = subgraph.attributes['epsilon']
+
+    X = Array(role=Array.Role.INPUT, element_type=float, shape=X_shape)
+    scale = Array(role=Array.Role.INPUT, element_type=float, shape=[N])
+    bias = Array(role=Array.Role.INPUT, element_type=float, shape=[N])
+    Y = Array(role=Array.Role.INPUT_OUTPUT, element_type=float, shape=X_shape)
+    mean = Array(role=Array.Role.TEMP, element_type=float, shape=rows)
+    inv_std_dev = Array(role=Array.Role.TEMP, element_type=float, shape=rows)
+
+    init_nest = Nest(shape=rows)
+    init_r = get_nest_indices(init_nest)
+
+    @init_nest.iteration_logic
+    def _():
+        mean[init_r] = Scalar(0.0)
+        inv_std_dev[init_r] = Scalar(0.0)
+
+    mean_nest = Nest(shape=X_shape)
+    *mean_r, mean_n = get_nest_indices(mean_nest)
+
+    @mean_nest.iteration_logic
+    def _():
+        mean[mean_r] += X[mean_r + [mean_n]] * Scalar(1.0 / N)
+
+    variance_nest = Nest(shape=X_shape)
+    *variance_r, variance_n = get_nest_indices(variance_nest)
+
+    @variance_nest.iteration_logic
+    def _():
+        centered = X[variance_r + [variance_n]] - mean[variance_r]
+        inv_std_dev[variance_r] += centered * centered * Scalar(1.0 / N)
+
+    inv_std_dev_nest = Nest(shape=rows)
+    inv_std_dev_r = get_nest_indices(inv_std_dev_nest)
+
+    @inv_std_dev_nest.iteration_logic
+    def _():
+        inv_std_dev[inv_std_dev_r] = Scalar(1.0) / sqrt(inv_std_dev[inv_std_dev_r] + Scalar(epsilon))
+
+    normalize_nest = Nest(shape=X_shape)
+    *normalize_r, normalize_n = get_nest_indices(normalize_nest)
+
+    @normalize_nest.iteration_logic
+    def _():
+        X_value = X[normalize_r + [normalize_n]]
+        Y[normalize_r + [normalize_n]] = (X_value - mean[normalize_r]) * inv_std_dev[normalize_r] * scale[normalize_n] + \
+            bias[normalize_n]
+
+    # Each row is read from memory once, and stays in the caches for the other passes over it
+    nests = [init_nest, mean_nest, variance_nest, inv_std_dev_nest, normalize_nest]
+    schedule = fuse(tuple(nest.create_schedule() for nest in nests), partial=len(rows))
+    f, *indices = schedule.get_indices()
+    schedule.reorder(*indices[:len(rows)], f, *indices[len(rows):])
+    plan = schedule.create_plan(target)
+
+    args = (X, scale, bias, Y)
+    name, emitted_info = get_fused_function_info(subgraph, args)
+    return package.add(plan, args=args, base_name=name, auxiliary={ONNXHATPackage.AuxTableName: emitted_info})
+
+
+def handle_attention(subgraph, model, package, target=Target.HOST):
+    Q_name, K_name, V_name = subgraph.inputs[:3]
+    mask_name = subgraph.inputs[3] if len(subgraph.inputs) > 3 else None
+    scale = subgraph.attributes['scale']
+    transposed_K = subgraph.attributes['transposed_K']
+
+    Q_shape, K_shape, V_shape = (get_static_shape(model, name) for name in (Q_name, K_name, V_name))
+    stack, (S, D) = Q_shape[:-2], Q_shape[-2:]
+    S_kv, E = V_shape[-2:]
+
+    Q = Array(role=Array.Role.INPUT, element_type=float, shape=Q_shape)
+    K = Array(role=Array.Role.INPUT, element_type=float, shape=K_shape)
+    V = Array(role=Array.Role.INPUT, element_type=float, shape=V_shape)
+    mask = Array(role=Array.Role.INPUT, element_type=float, shape=get_static_shape(model, mask_name)) \
+        if mask_name else None
+    O = Array(role=Array.Role.INPUT_OUTPUT, element_type=float, shape=stack + [S, E])
+    scores = Array(role=Array.Role.TEMP, element_type=float, shape=stack + [S, S_kv])
+    row_max = Array(role=Array.Role.TEMP, element_type=float, shape=stack + [S])
+    row_sum = Array(role=Array.Role.TEMP, element_type=float, shape=stack + [S])
+
+    # The rows of the scores are indexed by the stack and query indices, their columns by the key index
+    init_row_nest = Nest(shape=stack + [S])
+    init_row_r = get_nest_indices(init_row_nest)
+
+    @init_row_nest.iteration_logic
+    def _():
+        row_max[init_row_r] = Scalar(FLOAT32_LOWEST)
+        row_sum[init_row_r] = Scalar(0.0)
+
+    init_scores_nest = Nest(shape=stack + [S, S_kv])
+    *init_scores_r, init_scores_j = get_nest_indices(init_scores_nest)
+
+    @init_scores_nest.iteration_logic
+    def _():
+        scores[init_scores_r + [init_scores_j]] = Scalar(0.0)
+
+    qk_nest = Nest(shape=stack + [S, S_kv, D])
+    *qk_r, qk_j, qk_d = get_nest_indices(qk_nest)
+    qk_K_idxs = qk_r[:-1] + ([qk_j, qk_d] if transposed_K else [qk_d, qk_j])
+
+    @qk_nest.iteration_logic
+    def _():
+        scores[qk_r + [qk_j]] += Q[qk_r + [qk_d]] * K[qk_K_idxs]
+
+    max_nest = Nest(shape=stack + [S, S_kv])
+    *max_r, max_j = get_nest_indices(max_nest)
+    # The mask is indexed by the trailing indices of the scores
+    max_mask_idxs = (max_r + [max_j])[len(max_r) + 1 - len(mask.shape):] if mask is not None else None
+
+    @max_nest.iteration_logic
+    def _():
+        score = scores[max_r + [max_j]] * Scalar(scale)
+        if mask is not None:
+            score = score + mask[max_mask_idxs]
+        scores[max_r + [max_j]] = score
+        row_max[max_r] = accera_max(row_max[max_r], score)
+
+    exp_nest = Nest(shape=stack + [S, S_kv])
+    *exp_r, exp_j = get_nest_indices(exp_nest)
+
+    @exp_nest.iteration_logic
+    def _():
+        probability = exp(scores[exp_r + [exp_j]] - row_max[exp_r])
+        scores[exp_r + [exp_j]] = probability
+        row_sum[exp_r] += probability
+
+    init_output_nest = Nest(shape=stack + [S, E])
+    init_output_idxs = get_nest_indices(init_output_nest)
+
+    @init_output_nest.iteration_logic
+    def _():
+        O[init_output_idxs] = Scalar(0.0)
+
+    pv_nest = Nest(shape=stack + [S, S_kv, E])
+    *pv_r, pv_j, pv_e = get_nest_indices(pv_nest)
+
+    @pv_nest.iteration_logic
+    def _():
+        O[pv_r + [pv_e]] += scores[pv_r + [pv_j]] * V[pv_r[:-1] + [pv_j, pv_e]]
+
+    normalize_nest = Nest(shape=stack + [S, E])
+    *normalize_r, normalize_e = get_nest_indices(normalize_nest)
+
+    @normalize_nest.iteration_logic
+    def _():
+        O[normalize_r + [normalize_e]] = O[normalize_r + [normalize_e]] / row_sum[normalize_r]
+
+    # Each query row runs the whole block, so that its scores are never written out of the caches
+    nests = [
+        init_row_nest, init_scores_nest, qk_nest, max_nest, exp_nest, init_output_nest, pv_nest, normalize_nest
+    ]
+    fused_rank = len(stack) + 1
+    schedule = fuse(tuple(nest.create_schedule() for nest in nests), partial=fused_rank)
+    f, *indices = schedule.get_indices()
+    schedule.reorder(*indices[:fused_rank], f, *indices[fused_rank:])
+    plan = schedule.create_plan(target)
+
+    args = (Q, K, V, mask, O) if mask is not None else (Q, K, V, O)
+    name, emitted_info = get_fused_function_info(subgraph, args)
+    return package.add(plan, args=args, base_name=name, auxiliary={ONNXHATPackage.AuxTableName: emitted_info})
+
+
+FUSED_SUBGRAPH_HANDLERS = {
+    'Attention': handle_attention,
+    'LayerNormalization': handle_layer_norm,
+}
+
+
 ONNX_NODE_HANDLERS = {
     'FusedMatMul': handle_matmul_node,
     'Gemm': handle_gemm_node,
@@ -284,7 +811,8 @@ def emit_package_for_model(model,
                            large_model=False,
                            target=Target.HOST,
                            format=Package.Format.STATIC_LIBRARY | Package.Format.HAT_PACKAGE,
-                           mode=Package.Mode.RELEASE):
+                           mode=Package.Mode.RELEASE,
+                           fuse_subgraphs=True):
     model = _infer_shapes(model)
     output_path = Path(output_dir)
     output_path.mkdir(parents=True, exist_ok=True)
@@ -298,7 +826,13 @@ def emit_package_for_model(model,
     # Create a package and add our function definition to it
     package = Package()
 
-    for node in filter(lambda node: node.op_type in ONNX_NODE_HANDLERS, model.graph.node):
+    # Fused subgraphs are emitted as single functions, the remaining nodes as a function each
+    subgraphs, fused_nodes = find_fused_subgraphs(model) if fuse_subgraphs else ([], set())
+    for subgraph in subgraphs:
+        FUSED_SUBGRAPH_HANDLERS.get(subgraph.pattern, handle_matmul_bias_activation)(subgraph, model, package, target)
+
+    for node in filter(lambda node: node.op_type in ONNX_NODE_HANDLERS and node.output[0] not in fused_nodes,
+                       model.graph.node):
         ONNX_NODE_HANDLERS[node.op_type](node, model, package, target)
 
     # Build the HAT package
@@ -313,12 +847,14 @@ def main(args=[]):
                         default='host', choices=['pi3', 'host'])
     parser.add_argument(
         '-o', '--output', help='The output model file', default=None)
+    parser.add_argument('--no-fusion', help='Emit a function per node instead of fusing subgraphs',
+                        action='store_true')
     args = parser.parse_args(args)
 
     model = load_model(args.input)
     output_dir = args.output or os.getcwd()
 
-    emit_package_for_model(model, output_dir, target=get_target(args.target))
+    emit_package_for_model(model, output_dir, target=get_target(args.target), fuse_subgraphs=not args.no_fusion)
 
 
 if __name__ == "__main__":
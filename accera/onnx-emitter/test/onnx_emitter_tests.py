@@ -209,6 +209,115 @@ def make_gemm_model(M,
         return make_model()
 
 
+def make_matmul_add_gelu_model(M, N, K, batch=[], filename=None):
+    specifier = 'x'.join(map(str, batch)) + '_'.join(map(str, ['', M, N, K]))
+    expected_name = filename or f'matmul_add_gelu_{specifier}.onnx'
+
+    from onnx import helper, TensorProto
+
+    def scalar(name, value):
+        return helper.make_tensor(name, TensorProto.FLOAT, [], [value])
+
+    # The decomposition of GELU that PyTorch exports
+    graph = helper.make_graph(
+        [    # nodes
+            helper.make_node("MatMul", ["A", "B"], ["AB"], f"MatMul_{specifier}"),
+            helper.make_node("Add", ["AB", "bias"], ["X"], f"Add_{specifier}"),
+            helper.make_node("Div", ["X", "sqrt2"], ["X_scaled"], f"Div_{specifier}"),
+            helper.make_node("Erf", ["X_scaled"], ["X_erf"], f"Erf_{specifier}"),
+            helper.make_node("Add", ["X_erf", "one"], ["X_erf_1"], f"Add_1_{specifier}"),
+            helper.make_node("Mul", ["X", "X_erf_1"], ["X_gelu_2"], f"Mul_{specifier}"),
+            helper.make_node("Mul", ["X_gelu_2", "half"], ["Y"], f"Mul_1_{specifier}"),
+        ],
+        f"matmul_add_gelu_{specifier}",    # name
+        [    # inputs
+            helper.make_tensor_value_info('A', TensorProto.FLOAT, batch + [M, K]),
+        ],
+        [    # outputs
+            helper.make_tensor_value_info('Y', TensorProto.FLOAT, batch + [M, N]),
+        ],
+        [    # initializers
+            helper.make_tensor("B", TensorProto.FLOAT, [K, N],
+                               np.random.random([K, N]).astype(dtype=np.float32).flatten()),
+            helper.make_tensor("bias", TensorProto.FLOAT, [N], np.random.random([N]).astype(dtype=np.float32)),
+            scalar("sqrt2", 1.4142135381698608),
+            scalar("one", 1.0),
+            scalar("half", 0.5),
+        ])
+    model = helper.make_model(graph)
+    onnx.save(model, 'testdata/' + expected_name)
+    return get_name(expected_name)
+
+
+def make_layer_norm_model(N, batch=[], filename=None):
+    specifier = 'x'.join(map(str, batch)) + f'_{N}'
+    expected_name = filename or f'layer_norm_{specifier}.onnx'
+
+    from onnx import helper, TensorProto
+
+    # The decomposition of LayerNormalization that PyTorch exports
+    graph = helper.make_graph(
+        [    # nodes
+            helper.make_node("ReduceMean", ["X"], ["mean"], f"ReduceMean_{specifier}", axes=[-1]),
+            helper.make_node("Sub", ["X", "mean"], ["centered"], f"Sub_{specifier}"),
+            helper.make_node("Pow", ["centered", "two"], ["squared"], f"Pow_{specifier}"),
+            helper.make_node("ReduceMean", ["squared"], ["variance"], f"ReduceMean_1_{specifier}", axes=[-1]),
+            helper.make_node("Add", ["variance", "epsilon"], ["variance_epsilon"], f"Add_{specifier}"),
+            helper.make_node("Sqrt", ["variance_epsilon"], ["std_dev"], f"Sqrt_{specifier}"),
+            helper.make_node("Div", ["centered", "std_dev"], ["normalized"], f"Div_{specifier}"),
+            helper.make_node("Mul", ["normalized", "scale"], ["scaled"], f"Mul_{specifier}"),
+            helper.make_node("Add", ["scaled", "bias"], ["Y"], f"Add_1_{specifier}"),
+        ],
+        f"layer_norm_{specifier}",    # name
+        [    # inputs
+            helper.make_tensor_value_info('X', TensorProto.FLOAT, batch + [N]),
+        ],
+        [    # outputs
+            helper.make_tensor_value_info('Y', TensorProto.FLOAT, batch + [N]),
+        ],
+        [    # initializers
+            helper.make_tensor("two", TensorProto.FLOAT, [], [2.0]),
+            helper.make_tensor("epsilon", TensorProto.FLOAT, [], [1e-5]),
+            helper.make_tensor("scale", TensorProto.FLOAT, [N], np.random.random([N]).astype(dtype=np.float32)),
+            helper.make_tensor("bias", TensorProto.FLOAT, [N], np.random.random([N]).astype(dtype=np.float32)),
+        ])
+    model = helper.make_model(graph, opset_imports=[helper.make_opsetid("", 13)])
+    onnx.save(model, 'testdata/' + expected_name)
+    return get_name(expected_name)
+
+
+def make_attention_model(S, D, batch=[], filename=None):
+    specifier = 'x'.join(map(str, batch)) + '_'.join(map(str, ['', S, D]))
+    expected_name = filename or f'attention_{specifier}.onnx'
+
+    from onnx import helper, TensorProto
+
+    rank = len(batch) + 2
+    graph = helper.make_graph(
+        [    # nodes
+            helper.make_node("Transpose", ["K"], ["K_t"],
+                             f"Transpose_{specifier}",
+                             perm=list(range(rank - 2)) + [rank - 1, rank - 2]),
+            helper.make_node("MatMul", ["Q", "K_t"], ["scores"], f"MatMul_{specifier}"),
+            helper.make_node("Div", ["scores", "sqrt_d"], ["scaled_scores"], f"Div_{specifier}"),
+            helper.make_node("Softmax", ["scaled_scores"], ["probabilities"], f"Softmax_{specifier}", axis=-1),
+            helper.make_node("MatMul", ["probabilities", "V"], ["O"], f"MatMul_1_{specifier}"),
+        ],
+        f"attention_{specifier}",    # name
+        [    # inputs
+            helper.make_tensor_value_info(name, TensorProto.FLOAT, batch + [S, D]) for name in ("Q", "K", "V")
+        ],
+        [    # outputs
+            helper.make_tensor_value_info('O', TensorProto.FLOAT, batch + [S, D]),
+        ],
+        [    # initializers
+            helper.make_tensor("sqrt_d", TensorProto.FLOAT, [], [float(np.sqrt(D))]),
+        ])
+    model = helper.make_model(graph, opset_imports=[helper.make_opsetid("", 13)])
+    onnx.save(model, 'testdata/' + expected_name)
+    return get_name(expected_name)
+
+
 class ONNXEmitterTest(unittest.TestCase):
     @classmethod
     def setUpClass(cls) -> None:
@@ -267,6 +376,26 @@ class ONNXEmitterTest(unittest.TestCase):
         with verifiers.VerifyPackage(self, model.graph.name, output_dir):
             onnx_emitter.emit_package_for_model(model, output_dir)
 
+    def _emit_fused_model(self, model, output_dir, expected_patterns) -> None:
+        subgraphs, _ = onnx_emitter.find_fused_subgraphs(model)
+        self.assertEqual([subgraph.pattern for subgraph in subgraphs], expected_patterns)
+
+        output_dir = str((PACKAGE_DIR / output_dir).absolute())
+        with verifiers.VerifyPackage(self, model.graph.name, output_dir):
+            onnx_emitter.emit_package_for_model(model, output_dir)
+
+    def test_matmul_add_gelu_model(self) -> None:
+        model = onnx.load(make_matmul_add_gelu_model(M=128, N=64, K=128, batch=[2]))
+        self._emit_fused_model(model, "matmul_add_gelu", ["MatMulAddGelu"])
+
+    def test_layer_norm_model(self) -> None:
+        model = onnx.load(make_layer_norm_model(N=256, batch=[2, 16]))
+        self._emit_fused_model(model, "layer_norm", ["LayerNormalization"])
+
+    def test_attention_model(self) -> None:
+        model = onnx.load(make_attention_model(S=64, D=32, batch=[2, 4]))
+        self._emit_fused_model(model, "attention", ["Attention"])
+
 
 if __name__ == '__main__':
     unittest.main(verbosity=10)
@@ -0,0 +1,756 @@
+####################################################################################################
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License. See LICENSE in the project root for license information.
+####################################################################################################
+
+import json
+import os
+import shutil
+import subprocess
+import sys
+from dataclasses import dataclass, field
+from functools import reduce
+from typing import Dict, List, Optional, Tuple
+
+from . import _lang_python, lang
+from .lang.Plan import _ELEMENT_BYTES
+
+ScalarType = _lang_python.ScalarType
+
+
+@dataclass
+class BenchmarkOptions:
+    "Configures the benchmark harness that `Package.build` generates and runs"
+    warmup_iterations: int = 10    # untimed calls made before the timed ones
+    iterations: int = 100    # timed calls, each one timed on its own
+    seed: int = 0    # seed of the random inputs
+    flops: Dict[str, int] = field(default_factory=dict)    # floating point operations per call, by function name
+    roofline: bool = False    # also measure the memory bandwidth of the host and place each function on its roofline
+    cache_copies: bool = False    # also time the data movement of each cache and compare it to the memory bandwidth
+    memory_traffic: bool = False    # also count the bytes each call moves per array and compare them to the cost model
+    # .npy or raw files that are memory-mapped as the arguments instead of random values, by function name or base
+    # name, with None for the arguments that are random
+    inputs: Dict[str, List[Optional[str]]] = field(default_factory=dict)
+
+
+# The C type of each element type, and how its arrays are filled: "real" arrays take uniform values in [-1, 1),
+# "int" arrays take uniform integers in the given range, and 16-bit floating point arrays, which have no C type to
+# convert to, are zeroed
+_ELEMENT_TYPES = {
+    ScalarType.bool: ("uint8_t", "int", (0, 1)),
+    ScalarType.int8: ("int8_t", "int", (-16, 16)),
+    ScalarType.int16: ("int16_t", "int", (-128, 128)),
+    ScalarType.int32: ("int32_t", "int", (-128, 128)),
+    ScalarType.int64: ("int64_t", "int", (-128, 128)),
+    ScalarType.uint8: ("uint8_t", "int", (0, 16)),
+    ScalarType.uint16: ("uint16_t", "int", (0, 256)),
+    ScalarType.uint32: ("uint32_t", "int", (0, 256)),
+    ScalarType.uint64: ("uint64_t", "int", (0, 256)),
+    ScalarType.float16: ("uint16_t", "zero", None),
+    ScalarType.bfloat16: ("uint16_t", "zero", None),
+    ScalarType.float32: ("float", "real", None),
+    ScalarType.float64: ("double", "real", None),
+}
+
+# The cache sizes in KB assumed for the bandwidth probes of targets that don't know theirs
+_DEFAULT_CACHE_SIZES_KB = [32, 256, 8 * 1024]
+
+# The smallest buffer of the DRAM bandwidth probe
+_MIN_DRAM_PROBE_BYTES = 64 * 1024 * 1024
+
+_HARNESS_PROLOGUE = """// Benchmark harness generated by Accera.
+// Usage: <harness> <path to the package library>
+// Prints the latencies of each function, the memory bandwidths it measures, the time spent in the profile regions of
+// the cache copies and the memory traffic of each array per call, as JSON.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#if defined(_WIN32)
+#include <intrin.h>
+#include <windows.h>
+// Keeps the compiler from eliding the copies of the bandwidth probes
+#define CLOBBER_MEMORY() _ReadWriteBarrier()
+#else
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define CLOBBER_MEMORY() asm volatile("" ::: "memory")
+#endif
+
+// Declared by Random.h in the Accera runtime, which the harness links against
+extern "C" {
+void ResetRandomEngine(unsigned int seed);
+void GetNextNRandomValues(float* buffer, unsigned int N);
+void GetNextNRandomIntValues(int* buffer, int lo, int hi, unsigned int N);
+
+// Declared by ProfileRegions.h, the counters are the AcceraPerfCounterCount counters of PerfCounters.h
+struct AcceraProfileRecord
+{
+    int32_t thread;
+    int32_t parent;
+    const char* name;
+    int64_t count;
+    double totalSeconds;
+    double selfSeconds;
+    int64_t counters[5];
+};
+int64_t AcceraGetProfileRecords(AcceraProfileRecord* records, int64_t capacity);
+void AcceraResetProfileResults(void);
+
+struct AcceraMemoryTrafficRecord
+{
+    int32_t thread;
+    int32_t region;
+    const char* array;
+    int64_t loadedBytes;
+    int64_t storedBytes;
+};
+int64_t AcceraGetMemoryTrafficRecords(AcceraMemoryTrafficRecord* records, int64_t capacity);
+}
+
+namespace
+{
+template <typename T>
+std::vector<T> RandomReals(size_t size)
+{
+    std::vector<float> values(size);
+    GetNextNRandomValues(values.data(), static_cast<unsigned int>(size));
+    return std::vector<T>(values.begin(), values.end());
+}
+
+template <typename T>
+std::vector<T> RandomInts(size_t size, int lo, int hi)
+{
+    std::vector<int> values(size);
+    GetNextNRandomIntValues(values.data(), lo, hi, static_cast<unsigned int>(size));
+    return std::vector<T>(values.begin(), values.end());
+}
+
+template <typename T>
+std::vector<T> Zeros(size_t size)
+{
+    return std::vector<T>(size);
+}
+
+// An argument that is mapped from a file. The mapping is copy-on-write, so the calls that write to the argument don't
+// change the file, and the pages are read from the file as the warmup calls touch them instead of being copied first.
+class MappedInput
+{
+public:
+    MappedInput(const char* path, size_t offset, size_t size)
+    {
+#if defined(_WIN32)
+        auto file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file != INVALID_HANDLE_VALUE)
+        {
+            auto mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+            CloseHandle(file);
+            if (mapping)
+            {
+                _view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, offset + size);
+                CloseHandle(mapping);
+            }
+        }
+#else
+        auto file = open(path, O_RDONLY);
+        if (file >= 0)
+        {
+            _view = mmap(nullptr, offset + size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+            close(file);
+            if (_view == MAP_FAILED)
+            {
+                _view = nullptr;
+            }
+        }
+        if (_view)
+        {
+            // readahead of the whole argument, and huge pages where the file system can back the mapping with them
+            madvise(_view, offset + size, MADV_WILLNEED);
+#if defined(MADV_HUGEPAGE)
+            madvise(_view, offset + size, MADV_HUGEPAGE);
+#endif
+        }
+#endif
+        if (!_view)
+        {
+            std::fprintf(stderr, "Could not map %s\\n", path);
+            std::exit(1);
+        }
+        _data = static_cast<char*>(_view) + offset;
+        _size = offset + size;
+    }
+
+    MappedInput(const MappedInput&) = delete;
+    MappedInput& operator=(const MappedInput&) = delete;
+
+    ~MappedInput()
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile(_view);
+#else
+        munmap(_view, _size);
+#endif
+    }
+
+    void* data() { return _data; }
+
+private:
+    void* _view = nullptr;
+    void* _data = nullptr;
+    size_t _size = 0;
+};
+
+void* OpenLibrary(const char* path)
+{
+#if defined(_WIN32)
+    return reinterpret_cast<void*>(::LoadLibraryA(path));
+#else
+    return dlopen(path, RTLD_NOW);
+#endif
+}
+
+void* FindSymbol(void* library, const char* name)
+{
+#if defined(_WIN32)
+    return reinterpret_cast<void*>(::GetProcAddress(reinterpret_cast<HMODULE>(library), name));
+#else
+    return dlsym(library, name);
+#endif
+}
+
+template <typename Fn>
+void Report(const char* name, Fn&& fn, int warmupIterations, int iterations, double flops, bool last)
+{
+    for (int i = 0; i < warmupIterations; ++i)
+    {
+        fn();
+    }
+
+    std::vector<double> latencies(iterations);
+    for (auto& latency : latencies)
+    {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto stop = std::chrono::steady_clock::now();
+        latency = std::chrono::duration<double, std::milli>(stop - start).count();
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    double mean = 0;
+    for (auto latency : latencies)
+    {
+        mean += latency / iterations;
+    }
+    auto median = iterations % 2 ? latencies[iterations / 2] : (latencies[iterations / 2 - 1] + latencies[iterations / 2]) / 2;
+
+    // nearest-rank percentile
+    auto p99 = latencies[static_cast<size_t>(std::ceil(0.99 * iterations)) - 1];
+
+    std::printf("    {\\"name\\": \\"%s\\", \\"iterations\\": %d, \\"min_ms\\": %.9g, \\"median_ms\\": %.9g, "
+                "\\"p99_ms\\": %.9g, \\"mean_ms\\": %.9g, \\"gflops\\": ",
+                name, iterations, latencies.front(), median, p99, mean);
+    if (flops > 0)
+    {
+        std::printf("%.9g", flops / (median * 1e6));
+    }
+    else
+    {
+        std::printf("null");
+    }
+    std::printf("}%s\\n", last ? "" : ",");
+}
+
+// Measures the bandwidth of copying a buffer of the given size, half of which is read and half written, which stays in
+// the memory level that holds it after the first copy
+void ReportBandwidth(const char* level, size_t bytes, int iterations, bool last)
+{
+    std::vector<char> buffer(bytes, 1);
+    auto half = bytes / 2;
+    auto source = buffer.data();
+    auto destination = buffer.data() + half;
+
+    // each timed sample copies at least 64MB, so that the timer resolution doesn't matter for the small buffers
+    auto copies = std::max<size_t>(1, (size_t{ 64 } << 20) / bytes);
+    std::memcpy(destination, source, half);
+    CLOBBER_MEMORY();
+
+    std::vector<double> bandwidths(iterations);
+    for (auto& bandwidth : bandwidths)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < copies; ++i)
+        {
+            std::memcpy(destination, source, half);
+            CLOBBER_MEMORY();
+        }
+        auto stop = std::chrono::steady_clock::now();
+        bandwidth = 2.0 * half * copies / (std::chrono::duration<double>(stop - start).count() * 1e9);
+    }
+    std::sort(bandwidths.begin(), bandwidths.end());
+    auto median = iterations % 2 ? bandwidths[iterations / 2] : (bandwidths[iterations / 2 - 1] + bandwidths[iterations / 2]) / 2;
+
+    std::printf("    {\\"level\\": \\"%s\\", \\"bytes\\": %zu, \\"gbps\\": %.9g}%s\\n", level, bytes, median, last ? "" : ",");
+}
+
+// The JSON entries of the profile regions that the calls of each function recorded
+std::string cacheCopies;
+
+// Adds the regions that the calls of a function recorded, summed over the threads that ran them, to the cache copies,
+// and clears them for the next function
+void RecordCacheCopies(const char* function)
+{
+    std::vector<AcceraProfileRecord> records(AcceraGetProfileRecords(nullptr, 0));
+    AcceraGetProfileRecords(records.data(), static_cast<int64_t>(records.size()));
+
+    std::vector<std::tuple<std::string, int64_t, double>> regions;
+    for (auto& record : records)
+    {
+        auto it = std::find_if(regions.begin(), regions.end(), [&](auto& region) { return std::get<0>(region) == record.name; });
+        if (it == regions.end())
+        {
+            regions.emplace_back(record.name, record.count, record.totalSeconds);
+        }
+        else
+        {
+            std::get<1>(*it) += record.count;
+            std::get<2>(*it) += record.totalSeconds;
+        }
+    }
+
+    for (auto& [name, count, seconds] : regions)
+    {
+        char entry[512];
+        std::snprintf(entry, sizeof(entry), "    {\\"function\\": \\"%s\\", \\"name\\": \\"%s\\", \\"count\\": %lld, \\"seconds\\": %.9g}", function, name.c_str(), static_cast<long long>(count), seconds);
+        cacheCopies += (cacheCopies.empty() ? "" : ",\\n") + std::string(entry);
+    }
+    AcceraResetProfileResults();
+}
+
+// The JSON entries of the bytes that each call of each function moved to and from each array
+std::string memoryTraffic;
+
+// Adds the traffic that the calls of a function counted, summed over the threads and the regions and divided by the
+// number of calls, to the memory traffic. The results are cleared by RecordCacheCopies or before the next function.
+void RecordMemoryTraffic(const char* function, int calls)
+{
+    std::vector<AcceraMemoryTrafficRecord> records(AcceraGetMemoryTrafficRecords(nullptr, 0));
+    AcceraGetMemoryTrafficRecords(records.data(), static_cast<int64_t>(records.size()));
+
+    std::vector<std::tuple<std::string, int64_t, int64_t>> arrays;
+    for (auto& record : records)
+    {
+        auto it = std::find_if(arrays.begin(), arrays.end(), [&](auto& array) { return std::get<0>(array) == record.array; });
+        if (it == arrays.end())
+        {
+            arrays.emplace_back(record.array, record.loadedBytes, record.storedBytes);
+        }
+        else
+        {
+            std::get<1>(*it) += record.loadedBytes;
+            std::get<2>(*it) += record.storedBytes;
+        }
+    }
+
+    for (auto& [array, loadedBytes, storedBytes] : arrays)
+    {
+        char entry[512];
+        std::snprintf(entry, sizeof(entry), "    {\\"function\\": \\"%s\\", \\"array\\": \\"%s\\", \\"loaded_bytes\\": %.9g, \\"stored_bytes\\": %.9g}", function, array.c_str(), static_cast<double>(loadedBytes) / calls, static_cast<double>(storedBytes) / calls);
+        memoryTraffic += (memoryTraffic.empty() ? "" : ",\\n") + std::string(entry);
+    }
+}
+} // namespace
+"""
+
+
+def _get_input_offset(arg: lang.Array, path: str) -> int:
+    """The offset of the data of an argument in its input file, after the header of a .npy file, which must hold an
+    array of the shape and element type of the argument"""
+    size = reduce(lambda x, y: x * y, (int(s) for s in arg.shape), 1) * _ELEMENT_BYTES[arg.element_type]
+    offset = 0
+    if path.endswith(".npy"):
+        import numpy as np
+
+        with open(path, "rb") as f:
+            version = np.lib.format.read_magic(f)
+            read_header = np.lib.format.read_array_header_1_0 if version == (1, 0) else np.lib.format.read_array_header_2_0
+            shape, fortran_order, dtype = read_header(f)
+            offset = f.tell()
+        try:
+            expected_dtype = np.dtype(arg.element_type.name)
+        except TypeError:
+            expected_dtype = None    # bfloat16 has no NumPy type, it is stored as 16-bit values
+        expected_order = {lang.Array.Layout.FIRST_MAJOR: False, lang.Array.Layout.LAST_MAJOR: True}
+        expected_fortran_order = expected_order.get(arg._requested_layout, fortran_order)
+        # an array with a blocked layout is stored as its blocks
+        expected_shape = arg._blocked_layout.get_physical_shape(arg.shape) if arg._blocked_layout else arg.shape
+        if (tuple(shape) != tuple(int(s) for s in expected_shape) or fortran_order != expected_fortran_order
+                or dtype.itemsize != _ELEMENT_BYTES[arg.element_type]
+                or (expected_dtype is not None and dtype != expected_dtype)):
+            raise ValueError(
+                f"The input {path} holds a {dtype} array of shape {tuple(shape)}, the argument is a "
+                f"{arg.element_type.name} array of shape {tuple(arg.shape)}"
+            )
+    if os.path.getsize(path) < offset + size:
+        raise ValueError(f"The input {path} is smaller than the {size} bytes of its argument")
+    return offset
+
+
+def _get_buffer(arg: lang.Array, index: int, path: str = None):
+    c_type, init, bounds = _ELEMENT_TYPES[arg.element_type]
+    size = reduce(lambda x, y: x * y, (int(s) for s in arg.shape), 1)
+    if path:
+        offset = _get_input_offset(arg, path)
+        # json.dumps quotes and escapes the path like a C string literal
+        return f"MappedInput arg{index}({json.dumps(os.path.abspath(path))}, {offset}, {size * _ELEMENT_BYTES[arg.element_type]});"
+    if init == "real":
+        fill = f"RandomReals<{c_type}>({size})"
+    elif init == "int":
+        fill = f"RandomInts<{c_type}>({size}, {bounds[0]}, {bounds[1]})"
+    else:
+        fill = f"Zeros<{c_type}>({size})"
+    return f"auto arg{index} = {fill};"
+
+
+def is_benchmarkable(fn: lang.Function) -> bool:
+    "Whether the harness can call the function, which takes array arguments only"
+    if not fn.public or fn.use_workspace:
+        return False
+    for arg in fn.requested_args:
+        if not isinstance(arg, lang.Array) or arg.element_type not in _ELEMENT_TYPES:
+            return False
+        try:
+            [int(s) for s in arg.shape]
+        except (TypeError, ValueError):
+            return False
+    return True
+
+
+def get_bandwidth_probes(target) -> List[Tuple[str, int]]:
+    """The memory levels whose bandwidth the harness measures for the roofline of a target, with the size of the buffer
+    that each probe copies: half of each cache, and a multiple of the last level cache for the DRAM"""
+    cache_sizes_KB = target.cache_sizes or _DEFAULT_CACHE_SIZES_KB
+    probes = [(f"L{level}", size * 1024 // 2) for level, size in enumerate(cache_sizes_KB, start=1)]
+    probes.append(("DRAM", max(8 * cache_sizes_KB[-1] * 1024, _MIN_DRAM_PROBE_BYTES)))
+    return probes
+
+
+def generate_harness(
+    fns: List[lang.Function], options: BenchmarkOptions, bandwidth_probes: List[Tuple[str, int]] = []
+) -> str:
+    """Generates the source of a harness that calls each function with random arguments and times the calls, then
+    measures the bandwidth of each of the given memory levels. With `BenchmarkOptions.cache_copies`, the profile regions
+    that the calls of each function record are reported too, and with `BenchmarkOptions.memory_traffic`, the bytes that
+    each call moves to and from each array."""
+
+    lines = [_HARNESS_PROLOGUE]
+    lines.append("int main(int argc, char** argv)")
+    lines.append("{")
+    lines.append("    if (argc < 2)")
+    lines.append("    {")
+    lines.append('        std::fprintf(stderr, "Usage: %s <library>\\n", argv[0]);')
+    lines.append("        return 1;")
+    lines.append("    }")
+    lines.append("    auto library = OpenLibrary(argv[1]);")
+    lines.append("    if (!library)")
+    lines.append("    {")
+    lines.append('        std::fprintf(stderr, "Could not load %s\\n", argv[1]);')
+    lines.append("        return 1;")
+    lines.append("    }")
+    lines.append("")
+    lines.append(f"    ResetRandomEngine({options.seed});")
+    lines.append('    std::printf("{\\n  \\"functions\\": [\\n");')
+
+    for i, fn in enumerate(fns):
+        num_args = len(fn.requested_args)
+        lines.append("    {")
+        lines.append(f'        auto symbol = FindSymbol(library, "{fn.name}");')
+        lines.append("        if (!symbol)")
+        lines.append("        {")
+        lines.append(f'            std::fprintf(stderr, "Could not find {fn.name}\\n");')
+        lines.append("            return 1;")
+        lines.append("        }")
+        # the functions take a pointer to the data of each array
+        lines.append(f"        auto fn = reinterpret_cast<void (*)({', '.join(['void*'] * num_args)})>(symbol);")
+        inputs = options.inputs.get(fn.name, options.inputs.get(fn.base_name, []))
+        if len(inputs) > num_args:
+            raise ValueError(f"{fn.name} takes {num_args} arguments, {len(inputs)} inputs are given")
+        inputs = list(inputs) + [None] * (num_args - len(inputs))
+        for index, (arg, path) in enumerate(zip(fn.requested_args, inputs)):
+            lines.append(f"        {_get_buffer(arg, index, path)}")
+        call_args = ", ".join(f"arg{index}.data()" for index in range(num_args))
+        flops = options.flops.get(fn.name, options.flops.get(fn.base_name, 0))
+        if options.cache_copies or options.memory_traffic:
+            lines.append("        AcceraResetProfileResults();")
+        lines.append(
+            f'        Report("{fn.name}", [&] {{ fn({call_args}); }}, {options.warmup_iterations}, '
+            f"{options.iterations}, {float(flops)}, {'true' if i == len(fns) - 1 else 'false'});"
+        )
+        if options.memory_traffic:
+            lines.append(
+                f'        RecordMemoryTraffic("{fn.name}", {options.warmup_iterations + options.iterations});'
+            )
+        if options.cache_copies:
+            lines.append(f'        RecordCacheCopies("{fn.name}");')
+        lines.append("    }")
+
+    if bandwidth_probes:
+        lines.append('    std::printf("  ],\\n  \\"bandwidth\\": [\\n");')
+        for i, (level, size) in enumerate(bandwidth_probes):
+            lines.append(
+                f'    ReportBandwidth("{level}", {size}, {options.iterations}, '
+                f"{'true' if i == len(bandwidth_probes) - 1 else 'false'});"
+            )
+    if options.cache_copies:
+        lines.append('    std::printf("  ],\\n  \\"cache_copies\\": [\\n%s\\n", cacheCopies.c_str());')
+    if options.memory_traffic:
+        lines.append('    std::printf("  ],\\n  \\"memory_traffic\\": [\\n%s\\n", memoryTraffic.c_str());')
+    lines.append('    std::printf("  ]\\n}\\n");')
+    lines.append("    return 0;")
+    lines.append("}")
+    return "\n".join(lines) + "\n"
+
+
+def _find_compiler():
+    candidates = [os.environ["CXX"]] if "CXX" in os.environ else []
+    candidates += ["cl"] if sys.platform.startswith("win") else ["c++", "clang++", "g++"]
+    for candidate in candidates:
+        path = shutil.which(candidate)
+        if path:
+            return path
+    raise RuntimeError("Could not find a C++ compiler, set the CXX environment variable")
+
+
+def compile_harness(source_path: str, executable_path: str, runtime_library: str, quiet: bool = True):
+    "Compiles the harness and links it against the Accera runtime library"
+
+    compiler = _find_compiler()
+    if os.path.splitext(os.path.basename(compiler))[0].lower() == "cl":
+        command = [compiler, "/nologo", "/O2", "/EHsc", "/std:c++17", source_path, f"/Fe{executable_path}",
+                   runtime_library]
+    else:
+        command = [
+            compiler, "-O2", "-std=c++17", source_path, "-o", executable_path, runtime_library,
+            f"-Wl,-rpath,{os.path.dirname(runtime_library)}"
+        ]
+        if sys.platform.startswith("linux"):
+            command.append("-ldl")
+    subprocess.run(command, check=True, capture_output=quiet)
+
+
+def run_harness(executable_path: str, library_path: str, runtime_library: str) -> dict:
+    "Runs the harness on the package library, returns the latencies it reports"
+
+    # Windows has no rpath, the runtime DLL is found through the PATH
+    env = dict(os.environ)
+    env["PATH"] = os.pathsep.join([os.path.dirname(runtime_library), env.get("PATH", "")])
+    result = subprocess.run([executable_path, os.path.abspath(library_path)],
+                            check=True,
+                            capture_output=True,
+                            text=True,
+                            env=env)
+    return json.loads(result.stdout)
+
+
+def get_roofline(results: dict, fns: List[lang.Function], costs: Dict[str, dict],
+                 bandwidth_probes: List[Tuple[str, int]]) -> dict:
+    """Places each benchmarked function on the roofline of its target, from the floating point operations and bytes
+    that the cost model estimates for a call, the median latency that the harness measured, and the bandwidths of the
+    memory levels that it probed.
+
+    The memory roof of a function is the bandwidth of the smallest level that holds its footprint and scratch memory,
+    and its compute roof is the peak throughput of the threads it runs on, which is unknown for targets without a
+    frequency or cores. The function is bound by the lower of the two at its arithmetic intensity.
+    """
+    fns_by_name = {fn.name: fn for fn in fns}
+    bandwidths = {entry["level"]: entry["gbps"] for entry in results.get("bandwidth", [])}
+    roofline = []
+    for result in results["functions"]:
+        fn = fns_by_name[result["name"]]
+        cost = costs[fn.name]
+        flops, num_bytes = cost["flops"], cost["bytes"]
+        seconds = result["median_ms"] / 1e3
+
+        # the level that serves the accesses of the function once it is warm
+        working_set = num_bytes + cost["scratch_bytes"]
+        level = next((level for level, size in bandwidth_probes[:-1] if working_set <= 2 * size), "DRAM")
+        bandwidth_roof = bandwidths.get(level)
+
+        float_bytes = [
+            _ELEMENT_BYTES[arg.element_type] for arg in fn.requested_args
+            if arg.element_type in [ScalarType.float16, ScalarType.bfloat16, ScalarType.float32, ScalarType.float64]
+        ]
+        compute_roof = fn.target.peak_gflops(max(float_bytes, default=4), cost["num_threads"])
+
+        intensity = flops / num_bytes if num_bytes else None
+        achieved_gflops = flops / (seconds * 1e9) if seconds else None
+        achieved_gbps = num_bytes / (seconds * 1e9) if seconds else None
+
+        roofs = []
+        if compute_roof:
+            roofs.append((compute_roof, "compute"))
+        if bandwidth_roof and intensity is not None:
+            roofs.append((intensity * bandwidth_roof, "memory"))
+        attainable, bound = min(roofs) if roofs else (None, None)
+
+        entry = {
+            "name": fn.name,
+            "flops": flops,
+            "bytes": num_bytes,
+            "arithmetic_intensity": intensity,
+            "median_ms": result["median_ms"],
+            "achieved_gflops": achieved_gflops,
+            "achieved_gbps": achieved_gbps,
+            "memory_level": level,
+            "compute_roof_gflops": compute_roof,
+            "bandwidth_roof_gbps": bandwidth_roof,
+            "attainable_gflops": attainable,
+            "bound": bound,
+            "fraction_of_compute_roof": achieved_gflops / compute_roof if compute_roof and achieved_gflops is not None else None,
+            "fraction_of_attainable": achieved_gflops / attainable if attainable and achieved_gflops is not None else None,
+        }
+        entry["summary"] = _get_roofline_summary(entry)
+        roofline.append(entry)
+    return {"bandwidth": results.get("bandwidth", []), "functions": roofline}
+
+
+def _get_roofline_summary(entry: dict) -> str:
+    "A line that describes where a function is on its roofline, e.g. \"at 40% of compute roof, memory-bound at L2\""
+    if not entry["flops"]:
+        return f"no floating point operations, {entry['achieved_gbps']:.3g} GB/s from {entry['memory_level']}"
+    parts = []
+    if entry["fraction_of_compute_roof"] is not None:
+        parts.append(f"at {entry['fraction_of_compute_roof']:.0%} of compute roof")
+    if entry["bound"] == "memory":
+        parts.append(f"memory-bound at {entry['memory_level']}")
+    elif entry["bound"] == "compute":
+        parts.append("compute-bound")
+    if entry["fraction_of_attainable"] is not None:
+        parts.append(f"{entry['fraction_of_attainable']:.0%} of attainable")
+    return ", ".join(parts) or f"{entry['achieved_gflops']:.3g} GFLOP/s"
+
+
+def get_cache_copy_bandwidth(results: dict, report: dict, bandwidth_probes: List[Tuple[str, int]]) -> dict:
+    """Compares the bandwidth that the data movement of each cache achieved against the bandwidths of the memory levels
+    that the harness probed, from the bytes that the cache copy report counts in one run of each profile region, and the
+    runs of the region and the time spent in them that the harness measured.
+
+    The runs and the times of the threads that run a region are summed, so its bandwidth is that of one thread, like the
+    probes. The reference level of a region is the smallest level that holds the bytes it moves.
+    """
+    regions = {region["name"]: region for region in report["regions"]}
+    bandwidths = {entry["level"]: entry["gbps"] for entry in results.get("bandwidth", [])}
+    entries = []
+    for measurement in results.get("cache_copies", []):
+        region = regions.get(measurement["name"])
+        if region is None:
+            # a profile region that isn't around a cache copy
+            continue
+
+        num_bytes, seconds = region["bytes"], measurement["seconds"]
+        achieved_gbps = num_bytes * measurement["count"] / (seconds * 1e9) if num_bytes is not None and seconds else None
+        level = next((level for level, size in bandwidth_probes[:-1] if num_bytes is not None and num_bytes <= 2 * size),
+                     "DRAM")
+        level_gbps, dram_gbps = bandwidths.get(level), bandwidths.get("DRAM")
+
+        entry = {
+            "function": measurement["function"],
+            "name": measurement["name"],
+            "kind": region["kind"],
+            "bytes": num_bytes,
+            "count": measurement["count"],
+            "seconds": seconds,
+            "achieved_gbps": achieved_gbps,
+            "memory_level": level,
+            "level_gbps": level_gbps,
+            "fraction_of_level": achieved_gbps / level_gbps if achieved_gbps is not None and level_gbps else None,
+            "dram_gbps": dram_gbps,
+            "fraction_of_dram": achieved_gbps / dram_gbps if achieved_gbps is not None and dram_gbps else None,
+        }
+        entry["summary"] = _get_cache_copy_summary(entry)
+        entries.append(entry)
+    return {"bandwidth": results.get("bandwidth", []), "regions": entries}
+
+
+def _get_cache_copy_summary(entry: dict) -> str:
+    "A line that describes the bandwidth of a cache copy, e.g. \"fill of 32 KB at 12.5 GB/s, 40% of L2, 95% of DRAM\""
+    if entry["achieved_gbps"] is None:
+        return f"{entry['kind']} of unknown size, {entry['seconds'] * 1e3:.3g} ms in {entry['count']} runs"
+    parts = [f"{entry['kind']} of {entry['bytes'] / 1024:.3g} KB at {entry['achieved_gbps']:.3g} GB/s"]
+    if entry["fraction_of_level"] is not None:
+        parts.append(f"{entry['fraction_of_level']:.0%} of {entry['memory_level']}")
+    if entry["fraction_of_dram"] is not None and entry["memory_level"] != "DRAM":
+        parts.append(f"{entry['fraction_of_dram']:.0%} of DRAM")
+    return ", ".join(parts)
+
+
+def get_memory_traffic(results: dict, fns: List[lang.Function], cost_report: dict) -> dict:
+    """Compares the bytes that each call of each benchmarked function loaded from and stored to each array, as counted
+    by the memory traffic instrumentation, against the footprints that the cost model estimates for the arrays.
+
+    The arrays of a function are named after the function or implementation function that accesses them, e.g.
+    "matmul_impl_123:arg0" or "matmul_impl_123:cache0", and the footprints of the arguments and globals are those of the
+    same function in the cost model report. The ratio of the traffic of an array to its footprint is the number of times
+    each of its bytes is accessed per call, which a cache of the array cuts by moving the accesses to the cache.
+    """
+    footprints = {}
+    for entry in cost_report["functions"]:
+        for array in entry["arrays"]:
+            key = f"{entry['name']}:{array['name']}"
+            footprints[key] = footprints.get(key, 0) + array["bytes"]
+
+    def belongs_to(array_name: str, fn):
+        owner = array_name.split(":", 1)[0]
+        return owner == fn.name or owner.startswith(fn._impl_name)
+
+    functions = []
+    for fn in fns:
+        arrays = []
+        for measurement in results.get("memory_traffic", []):
+            if measurement["function"] != fn.name or not belongs_to(measurement["array"], fn):
+                continue
+            footprint = footprints.get(measurement["array"])
+            num_bytes = measurement["loaded_bytes"] + measurement["stored_bytes"]
+            arrays.append({
+                "name": measurement["array"],
+                "loaded_bytes": measurement["loaded_bytes"],
+                "stored_bytes": measurement["stored_bytes"],
+                "footprint_bytes": footprint,
+                "accesses_per_byte": num_bytes / footprint if footprint else None,
+            })
+
+        num_bytes = sum(array["loaded_bytes"] + array["stored_bytes"] for array in arrays)
+        footprint = sum(
+            entry["footprint_bytes"] for entry in cost_report["functions"]
+            if entry["name"] == fn.name or entry["name"].startswith(fn._impl_name)
+        )
+        entry = {
+            "name": fn.name,
+            "bytes": num_bytes,
+            "footprint_bytes": footprint,
+            "accesses_per_byte": num_bytes / footprint if footprint else None,
+            "arrays": arrays,
+        }
+        entry["summary"] = _get_memory_traffic_summary(entry)
+        functions.append(entry)
+    return {"functions": functions}
+
+
+def _get_memory_traffic_summary(entry: dict) -> str:
+    "A line that describes the traffic of a function, e.g. \"2.1e+03 KB per call, 8x its footprint, most from matmul_impl_1:arg1 (32x)\""
+    parts = [f"{entry['bytes'] / 1024:.3g} KB per call"]
+    if entry["accesses_per_byte"] is not None:
+        parts.append(f"{entry['accesses_per_byte']:.3g}x its footprint")
+    if entry["arrays"]:
+        top = max(entry["arrays"], key=lambda array: array["loaded_bytes"] + array["stored_bytes"])
+        ratio = f" ({top['accesses_per_byte']:.3g}x)" if top["accesses_per_byte"] is not None else ""
+        parts.append(f"most from {top['name']}{ratio}")
+    return ", ".join(parts)
@@ -28,6 +28,8 @@ def add_check_allclose(package: Package, array: Array, atol: float = 1e-5, targe
         package: the package to add the function
         array: the array specification
         atol: the absolute tolerance
+        target: the target of the function. The comparison of CPU targets is parallelized over the
+            outermost dimension and vectorized over the innermost dimension
     """
     from ._lang_python._lang import CheckAllClose, Scalar
 
@@ -44,7 +46,10 @@ def add_check_allclose(package: Package, array: Array, atol: float = 1e-5, targe
 
     @nest.iteration_logic
     def _():
-        CheckAllClose(actual, desired, atol)
+        if target.category == Target.Category.CPU:
+            CheckAllClose(actual, desired, atol, target.num_threads, target.vectorization_info)
+        else:
+            CheckAllClose(actual, desired, atol)
 
     plan = nest.create_plan(target)
 
@@ -10,8 +10,9 @@ import os
 import re
 import shutil
 from collections import OrderedDict
+from dataclasses import replace
 from enum import Enum, Flag, auto
-from functools import wraps, singledispatch
+from functools import wraps, singledispatch, reduce
 from hashlib import md5
 from secrets import token_hex
 from typing import *
@@ -20,7 +21,7 @@ from . import _lang_python, lang
 from .Targets import Target, Runtime
 from .Parameter import *
 from .Constants import inf
-from .Platforms import Platform, get_library_reference
+from .Platforms import LibraryDependency, Platform, get_library_reference
 
 _R_DIM3 = r'dim3\((\d+),\s*(\d+),\s*(\d+)\)'
 _R_GPU_LAUNCH = f"<<<{_R_DIM3},\s*{_R_DIM3}>>>"
@@ -76,17 +77,24 @@ def _(source, arr: lang.Array):
     _resolve_array_shape(source._sched._nest, arr)
 
 
-def _emit_module(module_to_emit, target, mode, output_dir, name):
+def _emit_module(module_to_emit, target, mode, output_dir, name, llvm_cpu=None, emit_bitcode=False, cross_targets=None):
     from . import accc
 
     assert target._device_name, "Target is unknown"
     working_dir = os.path.join(output_dir, "_tmp")
 
     proj = accc.AcceraProject(output_dir=working_dir, library_name=name)
-    proj.module_file_sets = [accc.ModuleFileSet(name=name, common_module_dir=working_dir)]
+    proj.module_file_sets = [accc.ModuleFileSet(name=name, common_module_dir=working_dir, module=module_to_emit)]
     module_to_emit.Save(proj.module_file_sets[0].generated_mlir_filepath)
 
-    proj.generate_and_emit(build_config=mode.value, system_target=target._device_name, runtime=target.runtime.name)
+    proj.generate_and_emit(
+        build_config=mode.value,
+        system_target=target._device_name,
+        runtime=target.runtime.name,
+        llvm_cpu=llvm_cpu,
+        emit_bitcode=emit_bitcode,
+        additional_system_targets=cross_targets
+    )
 
     # Create initial HAT files containing shape and type metadata that the C++ layer has access to
     header_path = os.path.join(output_dir, name + ".hat")
@@ -99,9 +107,93 @@ def _emit_module(module_to_emit, target, mode, output_dir, name):
 
     # copy HAT package files into output directory
     shutil.copy(proj.module_file_sets[0].object_filepath, output_dir)
+    if emit_bitcode:
+        shutil.copy(proj.module_file_sets[0].optimized_ll_filepath, output_dir)
+    for cross_target, module_file_sets in proj.system_target_module_file_sets.items():
+        os.makedirs(os.path.join(output_dir, cross_target), exist_ok=True)
+        shutil.copy(module_file_sets[0].object_filepath, os.path.join(output_dir, cross_target))
     return header_path
 
 
+# The (B^T, G, A^T) matrices of the Winograd algorithms F(m x m, 3 x 3), which compute an m x m tile of the output of
+# a 3 x 3 convolution from an (m + 2) x (m + 2) tile of the input as Y = A^T [(G g G^T) * (B^T d B)] A
+_WINOGRAD_TRANSFORMS = {
+    2: (
+        [[1, 0, -1, 0], [0, 1, 1, 0], [0, -1, 1, 0], [0, 1, 0, -1]],
+        [[1, 0, 0], [0.5, 0.5, 0.5], [0.5, -0.5, 0.5], [0, 0, 1]],
+        [[1, 1, 1, 0], [0, 1, -1, -1]],
+    ),
+    4: (
+        [[4, 0, -5, 0, 1, 0], [0, -4, -4, 1, 1, 0], [0, 4, -4, -1, 1, 0], [0, -2, -1, 2, 1, 0], [0, 2, -1, -2, 1, 0],
+         [0, 4, 0, -5, 0, 1]],
+        [[1 / 4, 0, 0], [-1 / 6, -1 / 6, -1 / 6], [-1 / 6, 1 / 6, -1 / 6], [1 / 24, 1 / 12, 1 / 6],
+         [1 / 24, -1 / 12, 1 / 6], [0, 0, 1]],
+        [[1, 1, 1, 1, 1, 0], [0, 1, -1, 2, -2, 0], [0, 1, 1, 4, 4, 0], [0, 1, -1, 8, -8, 1]],
+    ),
+}
+
+
+def _linear_combination(coefficients, values):
+    "The sum of the values scaled by the coefficients, without the terms of the zero coefficients or multiplications by 1 and -1"
+    result = None
+    for coefficient, value in zip(coefficients, values):
+        if coefficient == 0:
+            continue
+        term = value if coefficient == 1 else (-value if coefficient == -1 else value * coefficient)
+        result = term if result is None else result + term
+    return result
+
+
+def _winograd_transform(left, values, right):
+    "Returns left @ values @ right^T for a matrix of scalars, with the constant coefficients folded into the expressions"
+    rows = [[_linear_combination(row, [values[a][b] for a in range(len(values))]) for b in range(len(values[0]))]
+            for row in left]
+    return [[_linear_combination(column, rows[i]) for column in right] for i in range(len(left))]
+
+
+# The stages of a Winograd convolution are called from its logic functions, whose captures must not include the
+# matrices, since iterable captures are replaced by their mapped (native) elements
+def _winograd_filter_stage(Kernel, U, f, ch, m, nchw):
+    _, G, _ = _WINOGRAD_TRANSFORMS[m]
+    g = [[Kernel[f, ch, a, b] if nchw else Kernel[a, b, ch, f] for b in range(3)] for a in range(3)]
+    u = _winograd_transform(G, g, G)
+    for xi in range(m + 2):
+        for nu in range(m + 2):
+            if nchw:
+                U[xi * (m + 2) + nu, f, ch] = u[xi][nu]
+            else:
+                U[xi * (m + 2) + nu, ch, f] = u[xi][nu]
+
+
+def _winograd_input_stage(Input, V, n, tr, tc, ch, m, tiles_r, tiles_c, nchw):
+    BT, _, _ = _WINOGRAD_TRANSFORMS[m]
+    p = (n * tiles_r + tr) * tiles_c + tc
+    d = [[Input[n, ch, tr * m + a, tc * m + b] if nchw else Input[n, tr * m + a, tc * m + b, ch]
+          for b in range(m + 2)]
+         for a in range(m + 2)]
+    v = _winograd_transform(BT, d, BT)
+    for xi in range(m + 2):
+        for nu in range(m + 2):
+            if nchw:
+                V[xi * (m + 2) + nu, ch, p] = v[xi][nu]
+            else:
+                V[xi * (m + 2) + nu, p, ch] = v[xi][nu]
+
+
+def _winograd_output_stage(M, Output, n, tr, tc, f, m, tiles_r, tiles_c, nchw):
+    _, _, AT = _WINOGRAD_TRANSFORMS[m]
+    p = (n * tiles_r + tr) * tiles_c + tc
+    products = [[M[xi * (m + 2) + nu, f, p] if nchw else M[xi * (m + 2) + nu, p, f] for nu in range(m + 2)]
+                for xi in range(m + 2)]
+    y = _winograd_transform(AT, products, AT)
+    for i in range(m):
+        for j in range(m):
+            if nchw:
+                Output[n, f, tr * m + i, tc * m + j] += y[i][j]
+            else:
+                Output[n, tr * m + i, tc * m + j, f] += y[i][j]
+
+
 class SetActiveModule:
     def __init__(self, module):
         self.module = module
@@ -125,8 +217,11 @@ class Package:
         MLIR = auto()
         MLIR_VERBOSE = auto()
         CPP = auto()
+        CPP_HEADER = auto()    # header-only C++ source of static inline functions, for inlining into client code
         CUDA = auto()
         DEFAULT = auto()    # HAT_DYNAMIC on HOST targe, HAT_STATIC otherwise
+        JIT = auto()    # compiled into the memory of the process, build returns the functions
+        LLVM_BITCODE = auto()    # optimized LLVM bitcode of each module, for link-time optimization with client code
         HAT_DYNAMIC = HAT_PACKAGE | DYNAMIC_LIBRARY
         HAT_STATIC = HAT_PACKAGE | STATIC_LIBRARY
         MLIR_DYNAMIC = HAT_DYNAMIC | MLIR
@@ -136,6 +231,13 @@ class Package:
         RELEASE = "Release"    #: Release (maximally optimized)
         DEBUG = "Debug"    #: Debug mode (automatically tests logical equivalence)
 
+    class Profile(Flag):
+        NONE = 0
+        FUNCTIONS = auto()    #: the body of each function
+        LOOPS = auto()    #: the loops of the dimensions marked with `Plan.profile`
+        CACHES = auto()    #: each fill, write back, reduce and zeroing of a cache
+        ALL = FUNCTIONS | LOOPS | CACHES
+
     Platform = Platform
 
     # class attribute to track the default module
@@ -143,6 +245,7 @@ class Package:
 
     def __init__(self):
         self._fns: OrderedDict[str, Any] = OrderedDict()
+        self._fn_plans: Dict[str, lang.Plan] = {}
         self._description = {}
         self._dynamic_dependencies = set()
 
@@ -173,6 +276,7 @@ class Package:
         parameters: Union[dict, List[dict]] = {},
         function_opts: dict = {},
         auxiliary: dict = {},
+        tuning_database: "accera.TuningDatabase" = None,
     ) -> Union["accera.Function", List["accera.Function"]]:
         """Adds a function to the package. If multiple parameters are provided,
         generates and adds them according to the parameter grid.
@@ -186,14 +290,1122 @@ class Package:
                 base name followed by an automatically-generated unique identifier.
             parameters: A mapping of parameter to values for each parameter used by the function implementation (if any).
                         Optionally, can be a list of mappings, which will result in multiple functions.
-            function_opts: A dictionary of advanced options to set on the function, e.g. {"no_inline" : True}
+            function_opts: A dictionary of advanced options to set on the function, e.g. {"no_inline" : True}.
+                Set {"async" : True} to also emit an asynchronous variant of a CPU function, named with an "_async"
+                suffix, that enqueues the call on the Accera runtime and returns a handle for AcceraAsyncWait.
+                Set {"nontemporal_write_back" : True} to write the caches of a CPU function back with non-temporal stores.
+                Set {"workspace" : True} to place the scratch buffers of a CPU function in a caller-provided workspace,
+                which is passed as a trailing argument and sized by a generated "<name>_workspace_size" function.
+                Set {"no_alias" : True} to declare that the array arguments of a CPU function never overlap, which lets
+                LLVM keep loads in registers and vectorize more loops. The arguments are restrict-qualified in the header.
+                Set {"gpu_graph" : True} to capture the kernels that a GPU function, or a function that calls GPU
+                functions, launches into a CUDA/HIP graph on the first call, and replay the graph while the function is
+                called with the same arguments. Only supported by the CUDA and ROCm runtimes.
+                Set {"auto_inline" : True} to only inline the calls to the function from other functions of the package
+                where the function is small or called once, instead of always.
+                Set {"prepack" : [array, ...]} to have a CPU function of a plan take these input arguments pre-packed in
+                the layout of its schedule instead of caching them, and to emit a "<name>_pack_arg<k>" function that packs
+                the k-th argument into a buffer of "<name>_pack_arg<k>_size()" elements, e.g. once for weights that are
+                reused across many calls.
             auxiliary: A dictionary of auxiliary metadata to include in the HAT package.
+            tuning_database: A TuningDatabase to choose the parameters from. The values of `parameters` are replaced
+                by those of the fastest trial that `tune` recorded for `base_name` with the same argument signature on
+                the same target model, and are kept when there is none.
         """
+        if tuning_database is not None:
+            if not isinstance(parameters, dict):
+                raise ValueError("tuning_database requires a single mapping of parameters to default values")
+            parameters = tuning_database.choose_parameters(source, args, base_name, parameters)
+
         if parameters and not isinstance(parameters, dict):
             return [self._add_function(source, args, base_name, p, function_opts, auxiliary) for p in parameters]
         else:
             return self._add_function(source, args, base_name, parameters, function_opts, auxiliary)
 
+    def add_batched(
+        self,
+        function: "accera.Function",
+        batch_size: int,
+        batch_strides: List[int] = None,
+        base_name: str = "",
+        parallel: bool = True,
+        policy: str = "static",
+        num_threads: int = None,
+        function_opts: dict = {},
+        auxiliary: dict = {},
+    ) -> "accera.Function":
+        """Adds a batched variant of a function to the package. The batched function loops over `batch_size`
+        independent problem instances and calls `function` once per instance.
+
+        Returns the batched function added.
+
+        Args:
+            function: A function previously returned by `add`.
+            batch_size: The number of problem instances in the batch.
+            batch_strides: The batch stride of each argument of `function`, in elements. A stride of 0 shares
+                the argument across all instances (only allowed for input arrays). Any other stride must equal
+                the packed size of the argument, in which case the batched argument gains an outermost (first-major)
+                or innermost (last-major) batch dimension. Defaults to packed strides for every argument.
+            base_name: A base name for the batched function.
+            parallel: Whether to parallelize the batch loop.
+            policy: The scheduling policy of the parallel batch loop. See `Plan.parallelize`.
+            num_threads: The number of threads for the parallel batch loop. Defaults to the number of cores.
+            function_opts: A dictionary of advanced options to set on the batched function.
+            auxiliary: A dictionary of auxiliary metadata to include in the HAT package.
+        """
+        if self._fns.get(function.name) is not function:
+            raise ValueError("add_batched requires a function previously added to this package")
+        if batch_size < 1:
+            raise ValueError("batch_size must be a positive integer")
+
+        instance_args = function.requested_args
+        if batch_strides is None:
+            batch_strides = [None] * len(instance_args)
+        if len(batch_strides) != len(instance_args):
+            raise ValueError("batch_strides must contain one stride per function argument")
+
+        batched_args = []
+        slice_dims = []    # None for shared arguments
+        for arg, stride in zip(instance_args, batch_strides):
+            packed_size = reduce(lambda x, y: x * y, arg.shape, 1)
+            if stride == 0:
+                if arg.role not in [lang.Array.Role.INPUT, lang.Array.Role.CONST]:
+                    raise ValueError("Only input arrays can be shared across the batch")
+                batched_args.append(arg)
+                slice_dims.append(None)
+            elif stride is None or stride == packed_size:
+                if arg.requested_layout == lang.Array.Layout.FIRST_MAJOR:
+                    shape, dim = [batch_size] + list(arg.shape), 0
+                elif arg.requested_layout == lang.Array.Layout.LAST_MAJOR:
+                    shape, dim = list(arg.shape) + [batch_size], len(arg.shape)
+                else:
+                    raise ValueError("Batched arguments must have a first-major or last-major layout")
+                batched_args.append(
+                    lang.Array(role=arg.role, element_type=arg.element_type, shape=shape, layout=arg.requested_layout)
+                )
+                slice_dims.append(dim)
+            else:
+                raise ValueError(f"Unsupported batch stride {stride}: expected 0 or {packed_size}")
+
+        batched_args = tuple(batched_args)
+        nest = lang.Nest(shape=(batch_size, ))
+        b = nest.get_indices()
+
+        def get_instance_args(native_args, index):
+            # slice_dims is deliberately not captured by the logic function, since iterable captures
+            # are replaced by their mapped (native) elements
+            return [arr if dim is None else arr._slice([dim], [index]) for arr, dim in zip(native_args, slice_dims)]
+
+        @nest.iteration_logic
+        def _():
+            function(*get_instance_args(batched_args, b))
+
+        plan = nest.create_schedule().create_plan(function.target)
+        if parallel and batch_size > 1:
+            plan.parallelize(indices=b, policy=policy, num_threads=num_threads)
+
+        return self._add_function(plan, batched_args, base_name, {}, function_opts, auxiliary)
+
+    def add_batched_gemm(
+        self,
+        M: int,
+        N: int,
+        K: int,
+        batch_size: int,
+        batch_strides: List[int] = None,
+        transpose_A: bool = False,
+        transpose_B: bool = False,
+        element_type: "accera.ScalarType" = _lang_python.ScalarType.float32,
+        base_name: str = "",
+        parallel: bool = True,
+        num_threads: int = None,
+        function_opts: dict = {},
+        auxiliary: dict = {},
+    ) -> "accera.Function":
+        """Adds a batched GEMM, C[b] += A[b] @ B[b], with a default schedule that tiles each GEMM and runs
+        the batch in parallel. This is the Python counterpart of the accera.batched_gemm op.
+
+        Returns the batched function added. The GEMM of one instance is also added to the package.
+
+        Args:
+            M, N, K: The sizes of each GEMM, A is MxK, B is KxN and C is MxN.
+            batch_size: The number of GEMMs in the batch.
+            batch_strides: The batch strides of A, B and C, in elements, see `add_batched`. A stride of 0
+                broadcasts A or B to every GEMM. Defaults to packed strides.
+            transpose_A: Whether A is stored transposed, as KxM.
+            transpose_B: Whether B is stored transposed, as NxK.
+            element_type: The element type of the arrays.
+            base_name: A base name for the batched function.
+            parallel: Whether to parallelize the batch loop.
+            num_threads: The number of threads for the parallel batch loop. Defaults to the number of cores.
+            function_opts: A dictionary of advanced options to set on the batched function.
+            auxiliary: A dictionary of auxiliary metadata to include in the HAT package.
+        """
+        # a transposed operand is the same logical array with a last-major layout
+        def layout_of(transpose):
+            return lang.Array.Layout.LAST_MAJOR if transpose else lang.Array.Layout.FIRST_MAJOR
+
+        A = lang.Array(role=lang.Array.Role.INPUT, element_type=element_type, shape=(M, K), layout=layout_of(transpose_A))
+        B = lang.Array(role=lang.Array.Role.INPUT, element_type=element_type, shape=(K, N), layout=layout_of(transpose_B))
+        C = lang.Array(role=lang.Array.Role.INPUT_OUTPUT, element_type=element_type, shape=(M, N))
+
+        nest = lang.Nest(shape=(M, N, K))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        # Small GEMMs are tiled so that a block of rows of C stays in registers while a packed block of B is
+        # streamed from the cache, the tiles are clamped to the sizes of the GEMM
+        tile_m, tile_n, tile_k = min(M, 4), min(N, 16), min(K, 128)
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, tile_m)
+        jj = schedule.split(j, tile_n)
+        kk = schedule.split(k, tile_k)
+        schedule.reorder(j, k, i, kk, ii, jj)
+
+        plan = schedule.create_plan()
+        plan.cache(B, index=i)
+        if M % tile_m == 0:
+            plan.unroll(ii)
+        if N % tile_n == 0:
+            plan.vectorize(jj)
+
+        gemm = self.add(plan, args=(A, B, C), base_name=f"{base_name}_gemm" if base_name else "")
+        auxiliary_metadata = auxiliary.copy()
+        auxiliary_metadata["batched_gemm"] = {
+            "M": M,
+            "N": N,
+            "K": K,
+            "transpose_A": transpose_A,
+            "transpose_B": transpose_B,
+        }
+        return self.add_batched(
+            gemm,
+            batch_size,
+            batch_strides=batch_strides,
+            base_name=base_name,
+            parallel=parallel,
+            num_threads=num_threads,
+            function_opts=function_opts,
+            auxiliary=auxiliary_metadata
+        )
+
+    _QUANTIZED_TYPES = (_lang_python.ScalarType.int8, _lang_python.ScalarType.uint8)
+
+    def add_quantized_gemm(
+        self,
+        M: int,
+        N: int,
+        K: int,
+        input_type: "accera.ScalarType" = _lang_python.ScalarType.uint8,
+        output_type: "accera.ScalarType" = _lang_python.ScalarType.int8,
+        base_name: str = "",
+        function_opts: dict = {},
+        auxiliary: dict = {},
+    ) -> "accera.Function":
+        """Adds a quantized GEMM of 8-bit integers that accumulates in 32 bits and requantizes each output channel:
+
+            C[i, j] = saturate(round(scale[j] * (sum_k A[i, k] * B[k, j] + bias[j])) + zero_point[j])
+
+        The weights B are signed and stored transposed, as NxK, so that the reduction reads groups of consecutive
+        bytes of A and B, which the dot-product instructions of the target (e.g. VNNI or SDOT) consume directly.
+
+        Returns the function added. Its arguments are A, B, bias, scale, zero_point and C, in that order.
+
+        Args:
+            M, N, K: The sizes of the GEMM, A is MxK, B is KxN and C is MxN.
+            input_type: The type of A, ScalarType.uint8 or ScalarType.int8. Use uint8 for VNNI, which multiplies
+                unsigned by signed bytes, and int8 for SDOT.
+            output_type: The type of C, ScalarType.int8 or ScalarType.uint8.
+            base_name: A base name for the function.
+            function_opts: A dictionary of advanced options to set on the function.
+            auxiliary: A dictionary of auxiliary metadata to include in the HAT package.
+
+        The int32 bias of each output channel also folds in the zero point of A, -a_zero_point * sum_k B[k, j], which
+        is constant for constant weights.
+        """
+        from ._lang_python import _cast, _unsigned_cast, floor, max, min
+        from ._lang_python._lang import Scalar
+
+        if input_type not in Package._QUANTIZED_TYPES or output_type not in Package._QUANTIZED_TYPES:
+            raise ValueError("add_quantized_gemm requires int8 or uint8 inputs and outputs")
+
+        int32, float32 = _lang_python.ScalarType.int32, _lang_python.ScalarType.float32
+        A = lang.Array(role=lang.Array.Role.INPUT, element_type=input_type, shape=(M, K))
+        B = lang.Array(
+            role=lang.Array.Role.INPUT,
+            element_type=_lang_python.ScalarType.int8,
+            shape=(K, N),
+            layout=lang.Array.Layout.LAST_MAJOR
+        )
+        bias = lang.Array(role=lang.Array.Role.INPUT, element_type=int32, shape=(N, ))
+        scale = lang.Array(role=lang.Array.Role.INPUT, element_type=float32, shape=(N, ))
+        zero_point = lang.Array(role=lang.Array.Role.INPUT, element_type=int32, shape=(N, ))
+        C = lang.Array(role=lang.Array.Role.INPUT_OUTPUT, element_type=output_type, shape=(M, N))
+
+        # The int32 accumulator of one output element, which stays in a register
+        accumulator = lang.Array(role=lang.Array.Role.TEMP, element_type=int32, shape=(1, ))
+
+        init_nest = lang.Nest(shape=(M, N))
+
+        @init_nest.iteration_logic
+        def _():
+            accumulator[0] = 0
+
+        gemm_nest = lang.Nest(shape=(M, N, K))
+        i, j, k = gemm_nest.get_indices()
+        cast_input = _unsigned_cast if input_type == _lang_python.ScalarType.uint8 else _cast
+
+        @gemm_nest.iteration_logic
+        def _():
+            accumulator[0] += cast_input(A[i, k], int32) * _cast(B[k, j], int32)
+
+        requantize_nest = lang.Nest(shape=(M, N))
+        i2, j2 = requantize_nest.get_indices()
+        lowest, highest = (-128., 127.) if output_type == _lang_python.ScalarType.int8 else (0., 255.)
+
+        @requantize_nest.iteration_logic
+        def _():
+            scaled = _cast(accumulator[0] + bias[j2], float32) * scale[j2]
+            shifted = floor(scaled + _cast(Scalar(0.5), float32)) + _cast(zero_point[j2], float32)
+            saturated = max(min(shifted, _cast(Scalar(highest), float32)), _cast(Scalar(lowest), float32))
+            C[i2, j2] = _cast(saturated, output_type)
+
+        # The reduction is split into groups of the widest dot-product instruction that divides K
+        gemm_schedule = gemm_nest.create_schedule()
+        group = next((size for size in (64, 32, 16) if K % size == 0), K)
+        kk = gemm_schedule.split(k, group)
+
+        schedule = lang.fuse((init_nest.create_schedule(), gemm_schedule, requantize_nest.create_schedule()), partial=2)
+        i, j, f, k, kk = schedule.get_indices()
+        schedule.reorder(i, j, f, k, kk)
+
+        plan = schedule.create_plan()
+        plan.vectorize(kk)
+
+        auxiliary_metadata = auxiliary.copy()
+        auxiliary_metadata["quantized_gemm"] = {
+            "M": M,
+            "N": N,
+            "K": K,
+            "input_type": input_type.name,
+            "output_type": output_type.name,
+        }
+        return self.add(
+            plan,
+            args=(A, B, bias, scale, zero_point, C),
+            base_name=base_name,
+            function_opts=function_opts,
+            auxiliary=auxiliary_metadata
+        )
+
+    def add_int4_gemm(
+        self,
+        M: int,
+        N: int,
+        K: int,
+        group_size: int = 32,
+        element_type: "accera.ScalarType" = _lang_python.ScalarType.float32,
+        base_name: str = "",
+        function_opts: dict = {},
+        auxiliary: dict = {},
+    ) -> "accera.Function":
+        """Adds a GEMM with 4-bit weights, C += A @ W, where W is unpacked and dequantized as it is loaded:
+
+            W[k, j] = (B[k // 2, j] nibble - 8) * scales[k // group_size, j]
+
+        Each byte of B packs two consecutive rows of W, the even row in the low nibble. The bytes of a row of B are
+        consecutive output channels, so that a vector of channels is unpacked, dequantized and accumulated at once,
+        and the weights are read from memory at half a byte per element.
+
+        Returns the function added. Its arguments are A, B, scales and C, in that order.
+
+        Args:
+            M, N, K: The sizes of the GEMM, A is MxK, W is KxN and C is MxN. B is (K/2)xN bytes.
+            group_size: The number of consecutive rows of W that share a scale, an even divisor of K.
+            element_type: The element type of A, the scales and C.
+            base_name: A base name for the function.
+            function_opts: A dictionary of advanced options to set on the function.
+            auxiliary: A dictionary of auxiliary metadata to include in the HAT package.
+        """
+        from ._lang_python import _cast, _unsigned_cast
+        from ._lang_python._lang import Scalar
+
+        if group_size < 2 or group_size % 2 or K % group_size:
+            raise ValueError("add_int4_gemm requires an even group size that divides K")
+
+        int32 = _lang_python.ScalarType.int32
+        A = lang.Array(role=lang.Array.Role.INPUT, element_type=element_type, shape=(M, K))
+        B = lang.Array(role=lang.Array.Role.INPUT, element_type=_lang_python.ScalarType.uint8, shape=(K // 2, N))
+        scales = lang.Array(role=lang.Array.Role.INPUT, element_type=element_type, shape=(K // group_size, N))
+        C = lang.Array(role=lang.Array.Role.INPUT_OUTPUT, element_type=element_type, shape=(M, N))
+
+        # k is the index of a byte, which holds two rows of W, within a group
+        bytes_per_group = group_size // 2
+        nest = lang.Nest(shape=(M, N, K // group_size, bytes_per_group))
+        i, j, g, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            packed = _unsigned_cast(B[g * bytes_per_group + k, j], int32)
+            high = packed >> 4
+            low = packed - (high << 4)
+            offset = _cast(Scalar(8.0), int32)
+            row = g * group_size + 2 * k
+            C[i, j] += (A[i, row] * _cast(low - offset, element_type) +
+                        A[i, row + 1] * _cast(high - offset, element_type)) * scales[g, j]
+
+        # A tile of output channels is accumulated in vector registers across the whole reduction
+        tile_n = min(N, 16)
+        schedule = nest.create_schedule()
+        jj = schedule.split(j, tile_n)
+        schedule.reorder(j, i, g, k, jj)
+
+        plan = schedule.create_plan()
+        plan.cache(C, index=g)
+        if N % tile_n == 0:
+            plan.vectorize(jj)
+
+        auxiliary_metadata = auxiliary.copy()
+        auxiliary_metadata["int4_gemm"] = {
+            "M": M,
+            "N": N,
+            "K": K,
+            "group_size": group_size,
+        }
+        return self.add(
+            plan,
+            args=(A, B, scales, C),
+            base_name=base_name,
+            function_opts=function_opts,
+            auxiliary=auxiliary_metadata
+        )
+
+    def add_block_sparse_gemm(
+        self,
+        M: int,
+        N: int,
+        K: int,
+        block_shape: Tuple[int, int],
+        num_blocks: int,
+        element_type: "accera.ScalarType" = _lang_python.ScalarType.float32,
+        base_name: str = "",
+        function_opts: dict = {},
+        auxiliary: dict = {},
+    ) -> "accera.Function":
+        """Adds a GEMM with a block-sparse left operand, C += A @ B, where A is stored in block compressed sparse row
+        (BSR) format: only its non-zero blocks are stored, and only those blocks are multiplied. A block row r of A
+        has the blocks row_offsets[r] to row_offsets[r + 1] - 1 of values, and block b of values is at the block
+        column column_indices[b]. The values are already packed block by block, so they are read contiguously
+        without a cache copy.
+
+        The block structure is read when the function runs, while the number of non-zero blocks is fixed when the
+        function is added, as it is for the weights of a pruned model.
+
+        Returns the function added. Its arguments are values, column_indices, row_offsets, B and C, in that order.
+
+        Args:
+            M, N, K: The sizes of the GEMM, A is MxK, B is KxN and C is MxN.
+            block_shape: The rows and columns of the blocks of A, which divide M and K.
+            num_blocks: The number of non-zero blocks of A. values is num_blocks x block rows x block columns,
+                column_indices has num_blocks int32 elements and row_offsets has M / block rows + 1 int32 elements.
+            element_type: The element type of values, B and C.
+            base_name: A base name for the function.
+            function_opts: A dictionary of advanced options to set on the function.
+            auxiliary: A dictionary of auxiliary metadata to include in the HAT package.
+        """
+        from ._lang_python._lang import ForRange, as_index
+
+        block_rows, block_columns = block_shape
+        if block_rows < 1 or block_columns < 1 or M % block_rows or K % block_columns:
+            raise ValueError("add_block_sparse_gemm requires a block shape that divides M and K")
+        if not 0 < num_blocks <= (M // block_rows) * (K // block_columns):
+            raise ValueError("add_block_sparse_gemm requires between 1 and the number of blocks of A non-zero blocks")
+
+        int32 = _lang_python.ScalarType.int32
+        values = lang.Array(
+            role=lang.Array.Role.INPUT, element_type=element_type, shape=(num_blocks, block_rows, block_columns)
+        )
+        column_indices = lang.Array(role=lang.Array.Role.INPUT, element_type=int32, shape=(num_blocks, ))
+        row_offsets = lang.Array(role=lang.Array.Role.INPUT, element_type=int32, shape=(M // block_rows + 1, ))
+        B = lang.Array(role=lang.Array.Role.INPUT, element_type=element_type, shape=(K, N))
+        C = lang.Array(role=lang.Array.Role.INPUT_OUTPUT, element_type=element_type, shape=(M, N))
+
+        # The dense kernel of a block multiplies it with the rows of B at its block column, into the rows of C at its
+        # block row. The rows of C stay in vector registers across the block columns
+        block = lang.Array(role=lang.Array.Role.INPUT, element_type=element_type, shape=(1, block_rows, block_columns))
+        B_rows = lang.Array(role=lang.Array.Role.INPUT, element_type=element_type, shape=(block_columns, N))
+        C_rows = lang.Array(role=lang.Array.Role.INPUT_OUTPUT, element_type=element_type, shape=(block_rows, N))
+
+        nest = lang.Nest(shape=(block_rows, N, block_columns))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C_rows[i, j] += block[0, i, k] * B_rows[k, j]
+
+        tile_n = min(N, 16)
+        schedule = nest.create_schedule()
+        jj = schedule.split(j, tile_n)
+        schedule.reorder(j, i, k, jj)
+
+        plan = schedule.create_plan()
+        if N % tile_n == 0:
+            plan.vectorize(jj)
+
+        block_fn = self.add(
+            plan,
+            args=(block, B_rows, C_rows),
+            base_name=f"{base_name}_block" if base_name else "block_sparse_gemm_block",
+            function_opts=function_opts
+        )
+
+        def run(native_values, native_column_indices, native_row_offsets, native_B, native_C):
+            index = _lang_python.ScalarType.index
+            zero = as_index(0)
+
+            def multiply_block_row(r):
+                C_block_rows = native_C.sub_array([r * as_index(block_rows), zero], [block_rows, N], None)
+
+                def multiply_block(b):
+                    column = _lang_python._cast(native_column_indices[b], index)
+                    block_fn(
+                        native_values.sub_array([b, zero, zero], [1, block_rows, block_columns], None),
+                        native_B.sub_array([column * as_index(block_columns), zero], [block_columns, N], None),
+                        C_block_rows
+                    )
+
+                # Only the non-zero blocks of the block row are visited
+                start = _lang_python._cast(native_row_offsets[r], index)
+                end = _lang_python._cast(native_row_offsets[r + as_index(1)], index)
+                ForRange(start, end, as_index(1), multiply_block)
+
+            ForRange(zero, as_index(M // block_rows), as_index(1), multiply_block_row)
+
+        auxiliary_metadata = auxiliary.copy()
+        auxiliary_metadata["block_sparse_gemm"] = {
+            "M": M,
+            "N": N,
+            "K": K,
+            "block_shape": [block_rows, block_columns],
+            "num_blocks": num_blocks,
+            "block_function": block_fn.name,
+        }
+        return self._add_function(
+            run, (values, column_indices, row_offsets, B, C), base_name, {}, function_opts, auxiliary_metadata
+        )
+
+    _CONV2D_LAYOUTS = ("NCHW", "NHWC")
+
+    # The convolution algorithms and the output tile of the Winograd ones
+    _CONV2D_ALGORITHMS = {"implicit_gemm": None, "winograd_2x2": 2, "winograd_4x4": 4}
+
+    def add_conv2d(
+        self,
+        batch_size: int,
+        input_channels: int,
+        input_rows: int,
+        input_columns: int,
+        output_filters: int,
+        kernel_shape: Tuple[int, int],
+        stride: Tuple[int, int] = (1, 1),
+        padding: Tuple[int, int] = (0, 0),
+        dilation: Tuple[int, int] = (1, 1),
+        layout: str = "NCHW",
+        element_type: "accera.ScalarType" = _lang_python.ScalarType.float32,
+        algorithm: str = "implicit_gemm",
+        base_name: str = "",
+        function_opts: dict = {},
+        auxiliary: dict = {},
+    ) -> "accera.Function":
+        """Adds a 2D convolution, Output += conv2d(Input, Kernel), with a default schedule that treats it as an
+        implicit GEMM: the output pixels are the rows, the output filters are the columns and the input channels
+        and kernel taps are the reduction dimension. A packed block of the kernel is cached like the B matrix of a
+        GEMM, and the input window of each output tile is cached in place of an im2col matrix.
+
+        3x3 convolutions with unit strides and dilations can instead use the Winograd algorithm F(m x m, 3 x 3),
+        which computes each m x m tile of the output with (m + 2)^2 multiplications per input channel instead of
+        9 m^2: the kernel and the tiles of the input are transformed, multiplied by a batched GEMM per position of
+        the transformed tile, which reduces over the input channels, and the products are transformed back into the
+        output. The transforms are unrolled into additions and constant multiplications and vectorized along the
+        contiguous dimension of the layout. The transformed arrays are allocated by each call.
+
+        Returns the function added. Its arguments are Input, Kernel and Output, in that order.
+
+        Args:
+            batch_size, input_channels, input_rows, input_columns: The sizes of the input, without padding.
+            output_filters: The number of output channels.
+            kernel_shape: The rows and columns of the kernel.
+            stride: The row and column strides.
+            padding: The row and column padding. The input array includes the padding on both sides, which the
+                caller fills with zeros.
+            dilation: The row and column dilations of the kernel.
+            layout: "NCHW", where the kernel is FxCxKHxKW, or "NHWC", where the kernel is KHxKWxCxF.
+            element_type: The element type of the arrays.
+            algorithm: "implicit_gemm", or "winograd_2x2" or "winograd_4x4" for the Winograd algorithms F(2x2, 3x3)
+                and F(4x4, 3x3), whose multiplications are 44% and 25% of the implicit GEMM's. F(4x4, 3x3) is less
+                accurate, since its transforms have larger coefficients. The Winograd algorithms require a floating
+                point element type and output rows and columns that are multiples of the output tile.
+            base_name: A base name for the function.
+            function_opts: A dictionary of advanced options to set on the function.
+            auxiliary: A dictionary of auxiliary metadata to include in the HAT package.
+        """
+        if layout not in Package._CONV2D_LAYOUTS:
+            raise ValueError(f"Unknown convolution layout {layout}, expected one of {Package._CONV2D_LAYOUTS}")
+        if algorithm not in Package._CONV2D_ALGORITHMS:
+            raise ValueError(
+                f"Unknown convolution algorithm {algorithm}, expected one of {list(Package._CONV2D_ALGORITHMS)}"
+            )
+        if any(s < 1 for s in tuple(stride) + tuple(dilation)) or any(p < 0 for p in padding):
+            raise ValueError("The strides and dilations must be positive and the padding non-negative")
+
+        kernel_rows, kernel_columns = kernel_shape
+        row_stride, column_stride = stride
+        row_dilation, column_dilation = dilation
+        padded_rows = input_rows + 2 * padding[0]
+        padded_columns = input_columns + 2 * padding[1]
+        output_rows = (padded_rows - row_dilation * (kernel_rows - 1) - 1) // row_stride + 1
+        output_columns = (padded_columns - column_dilation * (kernel_columns - 1) - 1) // column_stride + 1
+        if output_rows < 1 or output_columns < 1:
+            raise ValueError("The dilated kernel is larger than the padded input")
+
+        nchw = layout == "NCHW"
+        if nchw:
+            input_shape = (batch_size, input_channels, padded_rows, padded_columns)
+            kernel_array_shape = (output_filters, input_channels, kernel_rows, kernel_columns)
+            output_shape = (batch_size, output_filters, output_rows, output_columns)
+        else:
+            input_shape = (batch_size, padded_rows, padded_columns, input_channels)
+            kernel_array_shape = (kernel_rows, kernel_columns, input_channels, output_filters)
+            output_shape = (batch_size, output_rows, output_columns, output_filters)
+
+        Input = lang.Array(role=lang.Array.Role.INPUT, element_type=element_type, shape=input_shape)
+        Kernel = lang.Array(role=lang.Array.Role.INPUT, element_type=element_type, shape=kernel_array_shape)
+        Output = lang.Array(role=lang.Array.Role.INPUT_OUTPUT, element_type=element_type, shape=output_shape)
+
+        auxiliary_metadata = auxiliary.copy()
+        auxiliary_metadata["conv2d"] = {
+            "layout": layout,
+            "kernel_shape": list(kernel_shape),
+            "stride": list(stride),
+            "padding": list(padding),
+            "dilation": list(dilation),
+            "algorithm": algorithm,
+        }
+
+        winograd_tile = Package._CONV2D_ALGORITHMS[algorithm]
+        if winograd_tile:
+            if tuple(kernel_shape) != (3, 3) or tuple(stride) != (1, 1) or tuple(dilation) != (1, 1):
+                raise ValueError("Winograd convolutions require a 3x3 kernel with unit strides and dilations")
+            if element_type not in [_lang_python.ScalarType.float16, _lang_python.ScalarType.float32,
+                                    _lang_python.ScalarType.float64]:
+                raise ValueError("Winograd convolutions require a floating point element type")
+            if output_rows % winograd_tile or output_columns % winograd_tile:
+                raise ValueError(f"Winograd convolutions require output rows and columns that are multiples of {winograd_tile}")
+            return self._add_winograd_conv2d(
+                Input, Kernel, Output, winograd_tile, nchw, base_name, function_opts, auxiliary_metadata
+            )
+
+        nest = lang.Nest(
+            shape=(batch_size, output_rows, output_columns, output_filters, input_channels, kernel_rows, kernel_columns)
+        )
+        n, r, c, f, ch, kr, kc = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            in_r = r * row_stride + kr * row_dilation
+            in_c = c * column_stride + kc * column_dilation
+            if nchw:
+                Output[n, f, r, c] += Input[n, ch, in_r, in_c] * Kernel[f, ch, kr, kc]
+            else:
+                Output[n, r, c, f] += Input[n, in_r, in_c, ch] * Kernel[kr, kc, ch, f]
+
+        # The register tile spans a few output pixels and a vector of filters. The vectorized dimension is the one
+        # that is contiguous in the output: the columns for NCHW and the filters for NHWC.
+        if nchw:
+            tile_f, tile_c = min(output_filters, 4), min(output_columns, 16)
+        else:
+            tile_f, tile_c = min(output_filters, 16), min(output_columns, 4)
+        tile_ch = min(input_channels, 64)
+
+        schedule = nest.create_schedule()
+        ff = schedule.split(f, tile_f)
+        cc = schedule.split(c, tile_c)
+        chh = schedule.split(ch, tile_ch)
+        inner_unrolled, inner_vectorized = (ff, cc) if nchw else (cc, ff)
+        schedule.reorder(n, f, ch, r, c, kr, kc, chh, inner_unrolled, inner_vectorized)
+
+        plan = schedule.create_plan()
+
+        # The kernel block of a tile of filters and channels is packed once and reused across the output pixels,
+        # the input window of a tile of output pixels is gathered into a dense cache, the im2col rows of the tile
+        plan.cache(Kernel, index=r)
+        plan.cache(Input, index=kr)
+
+        unrolled_size, vectorized_size = (output_filters, output_columns) if nchw else (output_columns, output_filters)
+        unrolled_tile, vectorized_tile = (tile_f, tile_c) if nchw else (tile_c, tile_f)
+        if unrolled_size % unrolled_tile == 0:
+            plan.unroll(inner_unrolled)
+        if vectorized_size % vectorized_tile == 0:
+            plan.vectorize(inner_vectorized)
+
+        return self.add(
+            plan,
+            args=(Input, Kernel, Output),
+            base_name=base_name,
+            function_opts=function_opts,
+            auxiliary=auxiliary_metadata
+        )
+
+    def _add_winograd_conv2d(
+        self, Input: lang.Array, Kernel: lang.Array, Output: lang.Array, m: int, nchw: bool, base_name: str,
+        function_opts: dict, auxiliary: dict
+    ) -> "accera.Function":
+        "Adds the stages of a Winograd F(m x m, 3 x 3) convolution, and the function that runs them"
+        from ._lang_python._lang import Allocate, Array as NativeArray
+
+        element_type = Input.element_type
+        if nchw:
+            batch_size, channels, _, _ = Input.shape
+            _, filters, output_rows, output_columns = Output.shape
+        else:
+            batch_size, _, _, channels = Input.shape
+            _, output_rows, output_columns, filters = Output.shape
+        alpha = m + 2
+        tiles_r, tiles_c = output_rows // m, output_columns // m
+        num_tiles = batch_size * tiles_r * tiles_c
+
+        # The transformed kernel U, input V and products M are stored by position in the transformed tile, which is the
+        # batch of the GEMMs: M = U @ V for NCHW, whose columns are the tiles, and M = V @ U for NHWC, whose columns
+        # are the filters
+        batch = alpha * alpha
+        if nchw:
+            U_shape, V_shape, M_shape = (batch, filters, channels), (batch, channels, num_tiles), \
+                (batch, filters, num_tiles)
+        else:
+            U_shape, V_shape, M_shape = (batch, channels, filters), (batch, num_tiles, channels), \
+                (batch, num_tiles, filters)
+
+        def array(role, shape):
+            return lang.Array(role=role, element_type=element_type, shape=shape)
+
+        stage_name = f"{base_name}_winograd" if base_name else "conv2d_winograd"
+        vector_size = 8
+
+        def add_stage(nest, vectorized, args, suffix):
+            # The innermost index is the contiguous dimension of the layout, which is vectorized
+            schedule = nest.create_schedule()
+            extent = nest.get_shape()[nest.get_indices().index(vectorized)]
+            tile = min(extent, vector_size)
+            inner = schedule.split(vectorized, tile)
+            plan = schedule.create_plan()
+            if extent % tile == 0:
+                plan.vectorize(inner)
+            return self.add(plan, args=args, base_name=f"{stage_name}_{suffix}", function_opts=function_opts)
+
+        K, U = array(lang.Array.Role.INPUT, Kernel.shape), array(lang.Array.Role.INPUT_OUTPUT, U_shape)
+        nest = lang.Nest(shape=(filters, channels) if nchw else (channels, filters))
+        f, ch = nest.get_indices() if nchw else reversed(nest.get_indices())
+
+        @nest.iteration_logic
+        def _():
+            _winograd_filter_stage(K, U, f, ch, m, nchw)
+
+        filter_fn = add_stage(nest, ch if nchw else f, (K, U), "filter")
+
+        I, V = array(lang.Array.Role.INPUT, Input.shape), array(lang.Array.Role.INPUT_OUTPUT, V_shape)
+        if nchw:
+            nest = lang.Nest(shape=(batch_size, channels, tiles_r, tiles_c))
+            n, ch, tr, tc = nest.get_indices()
+        else:
+            nest = lang.Nest(shape=(batch_size, tiles_r, tiles_c, channels))
+            n, tr, tc, ch = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            _winograd_input_stage(I, V, n, tr, tc, ch, m, tiles_r, tiles_c, nchw)
+
+        input_fn = add_stage(nest, tc if nchw else ch, (I, V), "input")
+
+        # The products are accumulated by the GEMMs, so they start from zero
+        M = array(lang.Array.Role.INPUT_OUTPUT, M_shape)
+        nest = lang.Nest(shape=M_shape)
+        t, i, j = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            M[t, i, j] = 0.0
+
+        clear_fn = add_stage(nest, j, (M, ), "clear")
+
+        if nchw:
+            gemm_fn = self.add_batched_gemm(
+                filters, num_tiles, channels, batch, element_type=element_type, base_name=f"{stage_name}_gemm"
+            )
+        else:
+            gemm_fn = self.add_batched_gemm(
+                num_tiles, filters, channels, batch, element_type=element_type, base_name=f"{stage_name}_gemm"
+            )
+
+        P, O = array(lang.Array.Role.INPUT, M_shape), array(lang.Array.Role.INPUT_OUTPUT, Output.shape)
+        if nchw:
+            nest = lang.Nest(shape=(batch_size, filters, tiles_r, tiles_c))
+            n, f, tr, tc = nest.get_indices()
+        else:
+            nest = lang.Nest(shape=(batch_size, tiles_r, tiles_c, filters))
+            n, tr, tc, f = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            _winograd_output_stage(P, O, n, tr, tc, f, m, tiles_r, tiles_c, nchw)
+
+        output_fn = add_stage(nest, tc if nchw else f, (P, O), "output")
+
+        U_temp, V_temp, M_temp = (array(lang.Array.Role.TEMP, shape) for shape in (U_shape, V_shape, M_shape))
+
+        def run(native_input, native_kernel, native_output):
+            native_U, native_V, native_M = (
+                NativeArray(Allocate(type=element_type, layout=temp.layout)) for temp in (U_temp, V_temp, M_temp)
+            )
+            filter_fn(native_kernel, native_U)
+            input_fn(native_input, native_V)
+            clear_fn(native_M)
+            if nchw:
+                gemm_fn(native_U, native_V, native_M)
+            else:
+                gemm_fn(native_V, native_U, native_M)
+            output_fn(native_M, native_output)
+
+        return self._add_function(run, (Input, Kernel, Output), base_name, {}, function_opts, auxiliary)
+
+    _DISPATCH_CONDITIONS = ("min", "max", "multiple_of")
+
+    def add_dispatcher(
+        self,
+        sizes: List[str],
+        cases: List[Tuple["accera.Function", Dict[str, Dict[str, int]]]],
+        base_name: str = "",
+        function_opts: dict = {},
+        auxiliary: dict = {},
+    ) -> "accera.Function":
+        """Adds a function that dispatches each call to one of several variants of a function, chosen by sizes
+        that the caller passes at runtime. The dispatcher takes the sizes as a leading array of 64-bit integers,
+        followed by the arguments of the variants.
+
+        Returns the dispatcher function added.
+
+        Args:
+            sizes: The names of the runtime sizes, in the order they are passed in the sizes array.
+            cases: A list of (function, conditions) pairs, where each function was previously returned by `add` and
+                has the same arguments as the others. The conditions map the name of a size to the bounds it must
+                satisfy for the function to be called: "min" and "max" (both inclusive) bucket the size, and
+                "multiple_of" requires it to be divisible by a value, such as the vector size or tile size a variant
+                is specialized for. The first case whose conditions all hold is called, so more specialized
+                variants go first. The last case must have no conditions, it is called when no other case applies.
+            base_name: A base name for the dispatcher.
+            function_opts: A dictionary of advanced options to set on the dispatcher.
+            auxiliary: A dictionary of auxiliary metadata to include in the HAT package.
+        """
+        from ._lang_python._lang import _If
+
+        if not sizes:
+            raise ValueError("add_dispatcher requires at least one runtime size")
+        if not cases:
+            raise ValueError("add_dispatcher requires at least one case")
+
+        functions = [function for function, _ in cases]
+        if any(self._fns.get(function.name) is not function for function in functions):
+            raise ValueError("add_dispatcher requires functions previously added to this package")
+
+        def get_signature(function):
+            return [(a.role, a.element_type, a.shape, a.requested_layout) for a in function.requested_args]
+
+        if any(get_signature(function) != get_signature(functions[0]) for function in functions[1:]):
+            raise ValueError("The dispatched functions must have the same arguments")
+
+        for _, conditions in cases:
+            for size, bounds in conditions.items():
+                if size not in sizes:
+                    raise ValueError(f"Unknown runtime size {size}")
+                unknown = set(bounds) - set(Package._DISPATCH_CONDITIONS)
+                if unknown:
+                    raise ValueError(f"Unknown dispatch conditions {sorted(unknown)}, expected {Package._DISPATCH_CONDITIONS}")
+                if bounds.get("multiple_of", 1) < 1:
+                    raise ValueError("multiple_of must be a positive integer")
+        if cases[-1][1]:
+            raise ValueError("The last case is the fallback and must have no conditions")
+        if any(not any(conditions.values()) for _, conditions in cases[:-1]):
+            raise ValueError("Only the last case can have no conditions")
+
+        sizes_arg = lang.Array(role=lang.Array.Role.INPUT, element_type=_lang_python.ScalarType.int64, shape=(len(sizes), ))
+        dispatcher_args = (sizes_arg, ) + tuple(functions[0].requested_args)
+
+        def get_test(native_sizes, conditions):
+            def constant(value):
+                return _lang_python._cast(value, _lang_python.ScalarType.int64)
+
+            tests = []
+            for size, bounds in conditions.items():
+                value = native_sizes[sizes.index(size)]
+                if "min" in bounds:
+                    tests.append(value >= constant(bounds["min"]))
+                if "max" in bounds:
+                    tests.append(value <= constant(bounds["max"]))
+                if "multiple_of" in bounds:
+                    tests.append(value % constant(bounds["multiple_of"]) == constant(0))
+            return reduce(_lang_python.logical_and, tests)
+
+        def dispatch(native_sizes, *native_args):
+            # native_args is bound through default arguments, since the branches are emitted after this returns
+            def call(function, args=native_args):
+                return lambda: function(*args)
+
+            if_ctx = None
+            for function, conditions in cases[:-1]:
+                test = get_test(native_sizes, conditions)
+                if if_ctx is None:
+                    if_ctx = _If(test, call(function))
+                else:
+                    if_ctx = if_ctx.ElseIf(test, call(function))
+
+            fallback = cases[-1][0]
+            if if_ctx is None:
+                fallback(*native_args)
+            else:
+                if_ctx.Else(call(fallback))
+
+        dispatcher = self._add_function(dispatch, dispatcher_args, base_name, {}, function_opts, auxiliary)
+
+        # Record the dispatch table so that clients can tell which variant handles which sizes
+        dispatcher.auxiliary["accera"]["dispatch"] = {
+            "sizes": list(sizes),
+            "cases": [{
+                "function": function.name,
+                "conditions": conditions
+            } for function, conditions in cases]
+        }
+        return dispatcher
+
+    def add_runtime_sized(
+        self,
+        tiles: List["accera.Function"],
+        runtime_dims: List[int],
+        max_size: int,
+        base_name: str = "",
+        function_opts: dict = {},
+        auxiliary: dict = {},
+    ) -> "accera.Function":
+        """Adds a function whose arguments have a dimension that is sized at runtime, such as a sequence length, from
+        variants of a function that are specialized for static tile sizes of that dimension. The function takes the
+        runtime size as a leading array of one 64-bit integer, followed by the arguments of the tiles, whose runtime
+        sized dimension is `max_size` long. Only the first `size` elements of that dimension are accessed, so callers
+        can pass arrays that are only as large as the runtime size.
+
+        Returns the runtime-sized function added.
+
+        Args:
+            tiles: Functions previously returned by `add` that have the same arguments except for the size of the
+                runtime-sized dimension, from the largest tile size to the smallest. The runtime size is covered by
+                full tiles of the first function, which is the fast path, and the boundary that remains by as many
+                tiles of each smaller function as fit. Runtime sizes must be multiples of the smallest tile size, which
+                is usually 1.
+            runtime_dims: The runtime-sized dimension of each argument of the tiles, or None for arguments that are
+                the same for every tile, such as weights. The runtime-sized dimension must be the outermost dimension
+                of first-major arguments or the innermost dimension of last-major arguments.
+            max_size: The largest runtime size, which is the size of the runtime-sized dimension in the signature of
+                the function.
+            base_name: A base name for the runtime-sized function.
+            function_opts: A dictionary of advanced options to set on the runtime-sized function.
+            auxiliary: A dictionary of auxiliary metadata to include in the HAT package.
+        """
+        from ._lang_python._lang import ForRange, as_index
+
+        if not tiles:
+            raise ValueError("add_runtime_sized requires at least one tile")
+        if any(self._fns.get(tile.name) is not tile for tile in tiles):
+            raise ValueError("add_runtime_sized requires functions previously added to this package")
+        if max_size < 1:
+            raise ValueError("max_size must be a positive integer")
+
+        tile_args = tiles[0].requested_args
+        if len(runtime_dims) != len(tile_args):
+            raise ValueError("runtime_dims must contain one dimension per function argument")
+        if all(dim is None for dim in runtime_dims):
+            raise ValueError("At least one argument must have a runtime-sized dimension")
+        for arg, dim in zip(tile_args, runtime_dims):
+            if dim is None:
+                continue
+            if not ((arg.requested_layout == lang.Array.Layout.FIRST_MAJOR and dim == 0) or
+                    (arg.requested_layout == lang.Array.Layout.LAST_MAJOR and dim == len(arg.shape) - 1)):
+                raise ValueError(
+                    "Runtime-sized dimensions must be the outermost dimension of first-major arguments "
+                    "or the innermost dimension of last-major arguments"
+                )
+
+        # The arguments of the tiles only differ along the runtime-sized dimension, which has the same size in each
+        def get_signature(tile):
+            return [(a.role, a.element_type, a.requested_layout, [n for d, n in enumerate(a.shape) if d != dim])
+                    for a, dim in zip(tile.requested_args, runtime_dims)]
+
+        tile_sizes = []
+        for tile in tiles:
+            if len(tile.requested_args) != len(tile_args) or get_signature(tile) != get_signature(tiles[0]):
+                raise ValueError("The tiles must have the same arguments except for their runtime-sized dimension")
+            sizes = {a.shape[dim] for a, dim in zip(tile.requested_args, runtime_dims) if dim is not None}
+            if len(sizes) != 1:
+                raise ValueError("The runtime-sized dimensions of the arguments of a tile must have the same size")
+            tile_sizes.append(sizes.pop())
+        if any(smaller >= larger for larger, smaller in zip(tile_sizes, tile_sizes[1:])):
+            raise ValueError("The tiles must go from the largest tile size to the smallest")
+        if tile_sizes[0] > max_size:
+            raise ValueError("The tile sizes must not exceed max_size")
+
+        def get_runtime_arg(arg, dim):
+            if dim is None:
+                return arg
+            shape = list(arg.shape)
+            shape[dim] = max_size
+            return lang.Array(role=arg.role, element_type=arg.element_type, shape=shape, layout=arg.requested_layout)
+
+        size_arg = lang.Array(role=lang.Array.Role.INPUT, element_type=_lang_python.ScalarType.int64, shape=(1, ))
+        runtime_args = (size_arg, ) + tuple(get_runtime_arg(arg, dim) for arg, dim in zip(tile_args, runtime_dims))
+
+        def get_tile_args(native_args, tile, offset):
+            return [
+                arr if dim is None else
+                arr.sub_array([offset if d == dim else as_index(0) for d in range(len(a.shape))], list(a.shape), None)
+                for arr, a, dim in zip(native_args, tile.requested_args, runtime_dims)
+            ]
+
+        def run(native_size, *native_args):
+            size = _lang_python._cast(native_size[0], _lang_python.ScalarType.index)
+
+            # Each tile covers what the larger tiles before it left of the runtime size
+            start = as_index(0)
+            for tile, tile_size in zip(tiles, tile_sizes):
+                step = as_index(tile_size)
+                end = start + ((size - start) // step) * step
+                ForRange(start, end, step, lambda offset: tile(*get_tile_args(native_args, tile, offset)))
+                start = end
+
+        function = self._add_function(run, runtime_args, base_name, {}, function_opts, auxiliary)
+
+        # Record the tiles so that clients can tell how the runtime size is covered
+        function.auxiliary["accera"]["runtime_size"] = {
+            "max_size": max_size,
+            "dims": list(runtime_dims),
+            "tiles": [{
+                "function": tile.name,
+                "size": tile_size
+            } for tile, tile_size in zip(tiles, tile_sizes)]
+        }
+        return function
+
+    def add_specialized(
+        self,
+        function: "accera.Function",
+        specializations: List[Dict["accera.Array", Union[int, float]]],
+        base_name: str = "",
+        function_opts: dict = {},
+        auxiliary: dict = {},
+    ) -> "accera.Function":
+        """Adds a function that calls a specialization of a function when its scalar arguments have the constant values
+        that the specialization is compiled for, such as alpha = 1 and beta = 0 in GEMM, and the function itself for
+        other values. The code of a specialization replaces the arguments with the constants, so that multiplications
+        by 1 and the branches on the values are removed. Each specialization is also added to the package as a function
+        of its own, named with a "_specialized<i>" suffix, which callers that know the values can call directly.
+
+        Returns the dispatching function added, which has the same arguments as `function`.
+
+        Args:
+            function: A function previously returned by `add`.
+            specializations: A list of mappings of argument to value, from the most specialized to the least. The first
+                specialization whose values are those of the arguments is called. The arguments are input arrays of
+                shape (1, ) from the arguments of `function`. Following the BLAS convention, the data that a
+                specialization multiplies by a 0 value is not read, e.g. C when beta is 0.
+            base_name: A base name for the dispatching function.
+            function_opts: A dictionary of advanced options to set on the dispatching function.
+            auxiliary: A dictionary of auxiliary metadata to include in the HAT package.
+        """
+        from ._lang_python._lang import _If
+
+        if self._fns.get(function.name) is not function:
+            raise ValueError("add_specialized requires a function previously added to this package")
+        if not specializations:
+            raise ValueError("add_specialized requires at least one specialization")
+
+        args = function.requested_args
+
+        def get_index(arg):
+            index = next((i for i, a in enumerate(args) if a is arg), None)
+            if index is None:
+                raise ValueError("The specialized arguments must be arguments of the function")
+            if arg.role != lang.Array.Role.INPUT or tuple(arg.shape) != (1, ):
+                raise ValueError("The specialized arguments must be input arrays of shape (1, )")
+            return index
+
+        specialized_args = [{get_index(arg): value for arg, value in values.items()} for values in specializations]
+        if any(not values for values in specialized_args):
+            raise ValueError("Each specialization must specialize at least one argument")
+
+        specialized_fns = []
+        for i, values in enumerate(specialized_args):
+            suffix = f"specialized{i}"
+            # the specializations must not be inlined into the dispatching function, they are separate entry points
+            specialized = replace(
+                function,
+                name=f"{function.name}_{suffix}",
+                base_name=f"{function.base_name}_{suffix}" if function.base_name else "",
+                no_inline=True,
+                auto_inline=False,
+                specialized_args=values,
+                instance_key=None,
+                auxiliary={
+                    **function.auxiliary, "accera": {
+                        **function.auxiliary.get("accera", {}), "specialized_args": {str(k): v
+                                                                                     for k, v in values.items()}
+                    }
+                }
+            )
+            self._fns[specialized.name] = specialized
+            if function.name in self._fn_plans:
+                self._fn_plans[specialized.name] = self._fn_plans[function.name]
+            specialized_fns.append(specialized)
+
+        def get_test(native_args, values):
+            return reduce(
+                _lang_python.logical_and, [
+                    native_args[index][0] == _lang_python._cast(value, args[index].element_type)
+                    for index, value in values.items()
+                ]
+            )
+
+        def dispatch(*native_args):
+            # native_args is bound through default arguments, since the branches are emitted after this returns
+            def call(fn, args=native_args):
+                return lambda: fn(*args)
+
+            if_ctx = None
+            for specialized, values in zip(specialized_fns, specialized_args):
+                test = get_test(native_args, values)
+                if if_ctx is None:
+                    if_ctx = _If(test, call(specialized))
+                else:
+                    if_ctx = if_ctx.ElseIf(test, call(specialized))
+            if_ctx.Else(call(function))
+
+        dispatcher = self._add_function(dispatch, args, base_name, {}, function_opts, auxiliary)
+
+        # Record the specializations so that clients can tell which function handles which values
+        dispatcher.auxiliary["accera"]["specializations"] = [{
+            "function": specialized.name,
+            "arguments": {str(k): v
+                          for k, v in values.items()}
+        } for specialized, values in zip(specialized_fns, specialized_args)]
+        return dispatcher
+
     def _add_function(
         self,
         source: Union["accera.Nest", "accera.Schedule", "accera.Plan", "accera.Function", Callable],
@@ -211,7 +1423,23 @@ class Package:
             base_name: A base name for the function. The full name for the function will be the
                 base name followed by an automatically-generated unique identifier.
             parameters: A value for each parameter if the function's implementation is parameterized.
-            function_opts: A dictionary of advanced options to set on the function, e.g. {"no_inline" : True}
+            function_opts: A dictionary of advanced options to set on the function, e.g. {"no_inline" : True}.
+                Set {"async" : True} to also emit an asynchronous variant of a CPU function, named with an "_async"
+                suffix, that enqueues the call on the Accera runtime and returns a handle for AcceraAsyncWait.
+                Set {"nontemporal_write_back" : True} to write the caches of a CPU function back with non-temporal stores.
+                Set {"workspace" : True} to place the scratch buffers of a CPU function in a caller-provided workspace,
+                which is passed as a trailing argument and sized by a generated "<name>_workspace_size" function.
+                Set {"no_alias" : True} to declare that the array arguments of a CPU function never overlap, which lets
+                LLVM keep loads in registers and vectorize more loops. The arguments are restrict-qualified in the header.
+                Set {"gpu_graph" : True} to capture the kernels that a GPU function, or a function that calls GPU
+                functions, launches into a CUDA/HIP graph on the first call, and replay the graph while the function is
+                called with the same arguments. Only supported by the CUDA and ROCm runtimes.
+                Set {"auto_inline" : True} to only inline the calls to the function from other functions of the package
+                where the function is small or called once, instead of always.
+                Set {"prepack" : [array, ...]} to have a CPU function of a plan take these input arguments pre-packed in
+                the layout of its schedule instead of caching them, and to emit a "<name>_pack_arg<k>" function that packs
+                the k-th argument into a buffer of "<name>_pack_arg<k>_size()" elements, e.g. once for weights that are
+                reused across many calls.
             auxiliary: A dictionary of auxiliary metadata to include in the HAT package.
         """
         
@@ -231,6 +1459,55 @@ class Package:
                         "Function target being added is currently incompatible with existing functions in package"
                     )
 
+        emit_async = function_opts.get("async", False)
+
+        def validate_async(target: Target):
+            if emit_async:
+                if target.category != Target.Category.CPU:
+                    raise ValueError("Asynchronous variants are only supported for CPU targets")
+                # the asynchronous variant enqueues the call on the executor in acc-runtime
+                self._dynamic_dependencies.add(LibraryDependency.ACCERA_RUNTIME)
+
+        nontemporal_write_back = function_opts.get("nontemporal_write_back", False)
+
+        def validate_nontemporal_write_back(target: Target):
+            if nontemporal_write_back and target.category != Target.Category.CPU:
+                raise ValueError("Non-temporal write-back is only supported for CPU targets")
+
+        use_workspace = function_opts.get("workspace", False)
+
+        def validate_workspace(target: Target):
+            if use_workspace and target.category != Target.Category.CPU:
+                raise ValueError("Workspace arguments are only supported for CPU targets")
+
+        no_alias = function_opts.get("no_alias", False)
+
+        def validate_no_alias(target: Target):
+            if no_alias and target.category != Target.Category.CPU:
+                raise ValueError("No-alias arguments are only supported for CPU targets")
+
+        gpu_graph = function_opts.get("gpu_graph", False)
+
+        def validate_gpu_graph(target: Target):
+            # the kernels of a host function are launched by the functions that it calls
+            if gpu_graph and target.category == Target.Category.GPU and target.runtime not in [
+                Target.Runtime.CUDA, Target.Runtime.ROCM
+            ]:
+                raise ValueError("GPU graphs are only supported by the CUDA and ROCm runtimes")
+
+        prepack = function_opts.get("prepack", [])
+
+        def validate_prepack(target: Target):
+            if not prepack:
+                return
+            if target.category != Target.Category.CPU:
+                raise ValueError("Pre-packed arguments are only supported for CPU targets")
+            for array in prepack:
+                if not any(array is arg for arg in args):
+                    raise ValueError("Pre-packed arrays must be arguments of the function")
+                if array.role != lang.Array.Role.INPUT:
+                    raise ValueError("Only input arrays can be pre-packed")
+
         def get_function_name(target: Target):
             # Get a function name using a stable hash of [base_name, signature, target, and parameters]
             # If no base_name is provided, use a unique identifier to avoid collisions (assume user
@@ -259,9 +1536,37 @@ class Package:
             source = source.create_plan(Target.HOST)
             # fall-through
 
+        if prepack and not isinstance(source, lang.Plan):
+            raise ValueError("Pre-packed arguments are only supported for the functions of plans")
+
+        instance_key = None
+        plan = None
+        name = None
         if isinstance(source, lang.Plan):
+            plan = source
             self._dynamic_dependencies.update(source._dynamic_dependencies)
-            source = source._create_function(args, public=True, no_inline=function_opts.get("no_inline", False))
+            # the variants of a plan with the same arguments and options are the same function if the parameters
+            # that the plan reads have the same values, see _add_functions_to_module
+            instance_key = (
+                id(source), str([(a.role, a.element_type, a.shape, a.layout) for a in args]),
+                str(sorted(function_opts.items()))
+            )
+
+            # the packing functions are named after the function
+            validate_prepack(source._target)
+            name = get_function_name(source._target)
+            prepacked = []
+            for array in prepack:
+                k = next(k for k, arg in enumerate(args) if arg is array)
+                prepacked.append((array, f"{name}_pack_arg{k}", f"{name}_pack_arg{k}_size"))
+                auxiliary_metadata["accera"].setdefault("prepacked", {})[f"arg{k}"] = {
+                    "pack": prepacked[-1][1],
+                    "size": prepacked[-1][2]
+                }
+
+            source = source._create_function(
+                args, public=True, no_inline=function_opts.get("no_inline", False), prepacked=prepacked
+            )
             # fall-through
 
         if isinstance(source, lang.Function):
@@ -269,24 +1574,43 @@ class Package:
 
             # due to the fall-through, we only need to validate here
             validate_target(source.target)
+            validate_async(source.target)
+            validate_nontemporal_write_back(source.target)
+            validate_workspace(source.target)
+            validate_no_alias(source.target)
+            validate_gpu_graph(source.target)
             logging.debug("Adding wrapped function")
 
             native_array_args = [arg._get_native_array() for arg in args]
 
             assert source.public
-            source.name = get_function_name(source.target)
+            source.name = name or get_function_name(source.target)
             source.base_name = base_name
             source.auxiliary = auxiliary_metadata
             source.param_overrides = parameters
             source.args = tuple(native_array_args)
             source.requested_args = args
+            source.emit_async = emit_async
+            source.nontemporal_write_back = nontemporal_write_back
+            source.use_workspace = use_workspace
+            source.no_alias = no_alias
+            source.gpu_graph = gpu_graph
+            source.auto_inline = function_opts.get("auto_inline", False)
+            source.instance_key = instance_key
             self._fns[source.name] = source
+            if plan:
+                self._fn_plans[source.name] = plan
             return source    # for composability
 
         elif isinstance(source, Callable):
 
             # due to the fall-through, we only need to validate here
             validate_target(Target.HOST)
+            validate_async(Target.HOST)
+            validate_nontemporal_write_back(Target.HOST)
+            validate_workspace(Target.HOST)
+            validate_no_alias(Target.HOST)
+            validate_gpu_graph(Target.HOST)
 
             @wraps(source)
             def wrapper_fn(args):
@@ -301,6 +1625,12 @@ class Package:
                 public=True,
                 decorated=function_opts.get("decorated", False),
                 no_inline=function_opts.get("no_inline", False),
+                auto_inline=function_opts.get("auto_inline", False),
+                emit_async=emit_async,
+                nontemporal_write_back=nontemporal_write_back,
+                use_workspace=use_workspace,
+                no_alias=no_alias,
+                gpu_graph=gpu_graph,
                 args=tuple(map(_convert_arg, args)),
                 requested_args=args,
                 definition=wrapper_fn,
@@ -314,12 +1644,129 @@ class Package:
         else:
             raise ValueError("Invalid type for source")
 
-    def _add_functions_to_module(self, module):
+    # The versions that functions can be compiled for with `cpu_versions`, from the most capable: the LLVM CPU of
+    # each, the extensions it requires and the mask of the AcceraCPUFeature bits of acc-runtime that the host must have
+    _CPU_VERSIONS = OrderedDict([
+        ("avx512_vnni",
+         ("cascadelake", ["+avx512f", "+avx512cd", "+avx512bw", "+avx512dq", "+avx512vl", "+avx512vnni"], 0b111)),
+        ("avx512", ("skylake-avx512", ["+avx512f", "+avx512cd", "+avx512bw", "+avx512dq", "+avx512vl"], 0b011)),
+        ("avx2", ("haswell", ["+avx", "+avx2", "+fma"], 0b001)),
+    ])
+
+    # Packages with CPU versions are compiled for the baseline, which any x86-64 host runs
+    _BASELINE_CPU = "x86-64"
+    _BASELINE_EXTENSIONS = ["+sse", "+sse2"]
+
+    @staticmethod
+    def _create_cpu_dispatcher(fn: lang.Function, cpu_versions: List[str]) -> lang.Function:
+        "Returns a function that replaces `fn`, which calls the version of `fn` for the CPU features of the host"
+        from ._lang_python._lang import _If, _Valor, Scalar
+
+        def create_version(suffix, cpu=""):
+            # the versions must not be inlined into the dispatcher, which is compiled for the baseline
+            return replace(fn, name=f"{fn.name}_{suffix}", public=False, no_inline=True, emit_async=False, cpu=cpu)
+
+        versions = [(create_version(level, cpu), mask)
+                    for level, (cpu, _, mask) in Package._CPU_VERSIONS.items()
+                    if level in cpu_versions]
+        baseline = create_version("baseline")
+
+        def dispatch(args):
+            for version, _ in versions:
+                version._emit()
+            baseline._emit()
+
+            # acc-runtime reads the CPU features once when it is loaded
+            get_cpu_features = _lang_python._DeclareFunction("AcceraGetCPUFeatures")
+            get_cpu_features.decorated(False).returns(_Valor(_lang_python.ScalarType.int64, _lang_python._MemoryLayout()))
+            features = Scalar(get_cpu_features([]))
+
+            def has_features(mask):
+                mask = _lang_python._cast(mask, _lang_python.ScalarType.int64)
+                return (features & mask) == mask
+
+            # args is bound through default arguments, since the branches are emitted after this returns
+            def call(version, args=args):
+                return lambda: version(*args)
+
+            if_ctx = None
+            for version, mask in versions:
+                if if_ctx is None:
+                    if_ctx = _If(has_features(mask), call(version))
+                else:
+                    if_ctx = if_ctx.ElseIf(has_features(mask), call(version))
+            if_ctx.Else(call(baseline))
+
+        return replace(fn, definition=dispatch)
+
+    def _resolve_deferred_layouts(self):
+        """Chooses the layout of each argument with a deferred layout, which functions of the package exchange, from the
+        caches of the array in the functions that take it after the first one: the consumers of the output of the first
+        function. The producer then writes the array in the layout that the consumers cache it in, and thrifty caches of
+        the consumers can read it in place. Without caches in the consumers, the caches of the producer choose it, and
+        without caches at all, the array is first-major."""
+        deferred = OrderedDict()
+        for fn in self._fns.values():
+            for arg in fn.requested_args:
+                if isinstance(arg, lang.Array) and arg.role in [lang.Array.Role.INPUT, lang.Array.Role.INPUT_OUTPUT] \
+                    and arg.layout == lang.Array.Layout.DEFERRED:
+                    fns = deferred.setdefault(id(arg), (arg, []))[1]
+                    if not any(f is fn for f in fns):
+                        fns.append(fn)
+
+        for arg, fns in deferred.values():
+
+            def get_caches(fns):
+                return [
+                    cache for fn in fns if fn.name in self._fn_plans for cache in self._fn_plans[fn.name]._array_caches
+                    if cache.target is arg and cache.layout is not None and not isinstance(cache.layout, DelayedParameter)
+                ]
+
+            caches = get_caches(fns[1:]) or get_caches(fns[:1])
+            layouts = []
+            for cache in caches:
+                if not any(cache.layout == layout for layout in layouts):
+                    layouts.append(cache.layout)
+            if len(layouts) > 1:
+                raise ValueError(
+                    f"The caches of an argument with a deferred layout have different layouts {layouts}, "
+                    "call Array.deferred_layout to choose one"
+                )
+            if caches:
+                arg.deferred_layout(caches[0])
+            else:
+                arg._layout = lang.Array.Layout.FIRST_MAJOR
+                arg._create_native_array()
+
+            for fn in fns:
+                fn.args = tuple(
+                    arg._get_native_array() if requested is arg else native
+                    for requested, native in zip(fn.requested_args, fn.args)
+                )
+
+    def _add_functions_to_module(self, module, fn_names=None, cpu_versions=None):
+        self._resolve_deferred_layouts()
+
+        # The variants of a parameter grid that read the same parameter values, e.g. the variants that only differ in
+        # a parameter that the plan doesn't use, share the implementation that the first of them emits in the module
+        instances = {}
         with SetActiveModule(module):
-            for name, wrapped_func in self._fns.items():
-                print(f"Building function {name}")
+            for name in (fn_names if fn_names is not None else self._fns):
+                wrapped_func = self._fns[name]
+                if cpu_versions and wrapped_func.public:
+                    wrapped_func = Package._create_cpu_dispatcher(wrapped_func, cpu_versions)
+                instance = None
+                if wrapped_func.instance_key is not None and not cpu_versions:
+                    instance = next((fn for fn in instances.get(wrapped_func.instance_key, [])
+                                     if wrapped_func._is_instance_of(fn)), None)
+                    if instance is None:
+                        instances.setdefault(wrapped_func.instance_key, []).append(wrapped_func)
+                print(f"Building function {name}" + (f" as a variant of {instance.name}" if instance else ""))
                 try:
-                    wrapped_func._emit()
+                    if instance:
+                        wrapped_func._emit_instance_of(instance)
+                    else:
+                        wrapped_func._emit()
                 except:
                     print(f"Compiler error when trying to build function {name}")
                     raise
@@ -374,12 +1821,23 @@ class Package:
             if "fpu" in target.extensions:
                 target._device_name += 'F'
 
+        elif target.architecture == Target.Architecture.AARCH64:
+            # Known AArch64 targets are named after their LLVM CPU, e.g. neoverse-n1
+            target_device = _lang_python._GetTargetDeviceFromName(target._device_name)
+
+            # float16 arithmetic is only kept in float16 by LLVM when the target has the ARMv8.2 FP16 instructions,
+            # otherwise each operation is promoted to float32
+            if "FP16" in target.extensions and "+fullfp16" not in target_device.features.split(","):
+                target_device.features = ",".join(f for f in [target_device.features, "+fullfp16"] if f)
+
         elif target.architecture == Target.Architecture.X86_64:
             target_device.architecture = "x86_64"
 
             if "AVX512" in target.extensions:
                 target_device.device_name = "avx512"
-                target_device.cpu = "skylake-avx512"
+                # The AVX512FP16 extension adds the +avx512fp16 feature below, which keeps float16 arithmetic in
+                # float16. LLVM versions that don't know the feature ignore it and promote float16 to float32.
+                target_device.cpu = "sapphirerapids" if "AVX512FP16" in target.extensions else "skylake-avx512"
                 # TODO: make this functionality less hidden
                 avx512_feat_str = ",".join([f"+{feature.lower()}" for feature in target.extensions])
 
@@ -394,12 +1852,193 @@ class Package:
         compiler_options.target_device = target_device
         compiler_options.debug = mode == Package.Mode.DEBUG
         compiler_options.gpu_only = target.category == Target.Category.GPU and target.runtime != Runtime.VULKAN
+        if target.runtime == Runtime.THREAD_POOL:
+            compiler_options.execution_runtime = target.runtime
+            self._dynamic_dependencies.add(LibraryDependency.ACCERA_RUNTIME)
 
         BuildConfig.obj_extension = ".obj" if target_device.is_windows() else ".o"
 
         libs = list(filter(None, [get_library_reference(dep, platform) for dep in self._dynamic_dependencies]))
         return target, target_device, compiler_options, libs
 
+    @staticmethod
+    def _add_estimated_occupancy(report_path: str, target: Target):
+        with open(report_path) as report_file:
+            report = json.load(report_file)
+
+        for kernel in report["kernels"]:
+            threads_per_block = reduce(lambda x, y: x * y, kernel["block_size"], 1)
+            # private buffers are promoted to 32-bit registers, the scalars the kernel holds come on top
+            private_registers = -(-kernel["private_memory_bytes"] // 4)
+            kernel["private_registers"] = private_registers
+            shared_memory_bytes = kernel["shared_memory_bytes"]
+
+            # the resources the backend compiler allocated, when it ran, replace the estimates
+            compiled = kernel.get("compiled_resources")
+            if compiled:
+                private_registers = compiled.get("registers", private_registers)
+                shared_memory_bytes = max(shared_memory_bytes, compiled.get("shared_memory_bytes", 0))
+                if compiled["spills"]:
+                    logging.warning(
+                        f"GPU kernel {kernel['name']} spills registers: {Package._get_spill_summary(compiled)}"
+                    )
+
+            kernel["estimated_occupancy"] = target.estimate_occupancy(
+                threads_per_block, shared_memory_bytes, private_registers
+            )
+            if shared_memory_bytes > target.max_shared_memory_per_block:
+                logging.warning(
+                    f"GPU kernel {kernel['name']} uses {shared_memory_bytes} bytes of shared memory, more than the "
+                    f"{target.max_shared_memory_per_block} bytes of a block of {target.name}, so it can't be launched: "
+                    f"consider sizing its caches with Target.CacheLevel.SHARED"
+                )
+
+            for access in kernel.get("uncoalesced_accesses", []):
+                logging.warning(
+                    f"GPU kernel {kernel['name']} has uncoalesced {access['access']}s of {access['array']}: "
+                    f"consecutive threads along {access['thread_dim']} are {access['stride']} elements apart, "
+                    f"consider binding thread {access['thread_dim']} to the index of its fastest-moving dimension"
+                )
+
+        with open(report_path, "w") as report_file:
+            json.dump(report, report_file, indent=2)
+
+    @staticmethod
+    def _get_spill_summary(compiled: dict) -> str:
+        if compiled["compiler"] == "ptxas":
+            return f"{compiled.get('spill_stores_bytes', 0)} bytes of spill stores, {compiled.get('spill_loads_bytes', 0)} bytes of spill loads"
+        return f"{compiled.get('vgpr_spills', 0)} VGPRs and {compiled.get('sgpr_spills', 0)} SGPRs spilled"
+
+    def estimate_costs(
+        self,
+        name: str = "cost_model",
+        platform: Platform = Platform.HOST,
+        output_dir: str = None,
+        _quiet=True
+    ) -> dict:
+        """Estimates the costs of the functions from their schedules and plans, without compiling them to machine code.
+
+        The loops are lowered only as far as the affine loops that implement the plans. Each loop level is modeled as
+        the level whose footprint, the active blocks of the arrays that one run of the loop accesses, is held in the
+        cache, so that the memory traffic it causes is the footprint times the number of times the loop runs.
+        Loops with trip counts that are not constant count as a single iteration.
+
+        Args:
+            name: The name of the report, which is written to `<name>.cost_model.json` in `output_dir`.
+            platform: The platform the functions are planned for.
+            output_dir: The path to an output directory. Defaults to the current directory if unspecified.
+
+        Returns:
+            A dictionary with an entry per function in `"functions"`, holding its `"ops"` (arithmetic operations
+            counted per vector lane), `"footprint_bytes"`, `"arithmetic_intensity"`, the `"arrays"` it accesses, and
+            a `"loops"` list with the `"depth"`, `"trip_count"`, `"executions"`, `"ops"`, `"footprint_bytes"`,
+            `"traffic_bytes"` and `"arithmetic_intensity"` of each loop level.
+        """
+
+        from . import accc
+
+        target, _, compiler_options, _ = self._generate_target_options(platform, Package.Mode.RELEASE)
+
+        output_dir = output_dir or os.getcwd()
+        working_dir = os.path.join(output_dir, "_tmp")
+        os.makedirs(output_dir, exist_ok=True)
+        os.makedirs(working_dir, exist_ok=True)
+
+        module = _lang_python._Module(name=name, options=compiler_options)
+        self._add_functions_to_module(module)
+
+        proj = accc.AcceraProject(output_dir=working_dir, library_name=name)
+        proj.module_file_sets = [accc.ModuleFileSet(name=name, common_module_dir=working_dir, module=module)]
+        module.Save(proj.module_file_sets[0].generated_mlir_filepath)
+
+        report_path = os.path.abspath(os.path.join(output_dir, f"{name}.cost_model.json"))
+        proj.generate_and_emit(
+            system_target=target._device_name,
+            runtime=target.runtime.name,
+            quiet=_quiet,
+            cost_model_report_path=report_path,
+            analysis_only=True
+        )
+
+        with open(report_path) as report_file:
+            return json.load(report_file)
+
+    def _build_jit(self, name: str, format: Format, mode: Mode, platform: Platform, target: Target, compiler_options,
+                   vectorization_report_path: str, cost_model_report_path: str, unroll_code_size_budget: int,
+                   unroll_report_path: str, unsupported: dict) -> dict:
+        import ctypes
+        import ctypes.util
+        import numpy as np
+        from . import accc
+
+        if format != Package.Format.JIT:
+            raise ValueError("Package.Format.JIT cannot be combined with other formats")
+        if platform != Platform.HOST or compiler_options.gpu_only or any(
+                fn.target.category == Target.Category.GPU for fn in self._fns.values()):
+            raise ValueError("Package.Format.JIT is only supported for CPU functions on the host")
+        if mode == Package.Mode.DEBUG:
+            raise ValueError("Package.Format.JIT is not supported in Package.Mode.DEBUG")
+        for arg_name, value in unsupported.items():
+            if value:
+                raise ValueError(f"{arg_name} is not supported with Package.Format.JIT")
+        if any(fn.use_workspace for fn in self._fns.values()):
+            raise ValueError("Workspace arguments are not supported with Package.Format.JIT")
+
+        package_module = _lang_python._Module(name=name, options=compiler_options)
+        self._add_functions_to_module(package_module)
+
+        # The libraries are loaded into the process, the linker flags are resolved to the libraries they name
+        shared_library_paths = []
+        for dependency in self._dynamic_dependencies:
+            reference = get_library_reference(dependency, platform)
+            library = reference.target_file if reference else None
+            if library and library.startswith("-l"):
+                library = ctypes.util.find_library(library[2:])
+            if not library:
+                raise RuntimeError(f"Couldn't find the {dependency.value} library to load")
+            shared_library_paths.append(library)
+
+        engine = package_module.JITCompile(
+            pipeline_options=accc.RC_MLIR_LOWERING_OPTIONS(
+                system_target=target._device_name,
+                runtime=target.runtime.name,
+                vectorization_report_path=vectorization_report_path,
+                cost_model_report_path=cost_model_report_path,
+                unroll_code_size_budget=unroll_code_size_budget,
+                unroll_report_path=unroll_report_path
+            ),
+            supporting_modules=[Package._default_module],
+            shared_library_paths=shared_library_paths
+        )
+
+        def make_function(fn: lang.Function):
+            arg_types = [(np.dtype(arg.element_type.name), arg.shape) for arg in fn.requested_args]
+
+            def function(*args):
+                if len(args) != len(arg_types):
+                    raise ValueError(f"{fn.name} takes {len(arg_types)} arguments, {len(args)} were given")
+
+                # The arrays are passed as the address of a pointer to their data
+                pointers = []
+                for i, (arg, (dtype, shape)) in enumerate(zip(args, arg_types)):
+                    if not isinstance(arg, np.ndarray) or arg.dtype != dtype:
+                        raise TypeError(f"Argument {i} of {fn.name} must be a numpy array of {dtype}")
+                    size = reduce(lambda x, y: x * y, shape, 1)
+                    if all(isinstance(s, int) for s in shape) and arg.size != size:
+                        raise ValueError(f"Argument {i} of {fn.name} must have {size} elements")
+                    if not (arg.flags.c_contiguous or arg.flags.f_contiguous):
+                        raise ValueError(f"Argument {i} of {fn.name} must be contiguous")
+                    pointers.append(ctypes.c_void_p(arg.ctypes.data))
+                engine.Invoke(fn.name, [ctypes.addressof(p) for p in pointers])
+
+            function.__name__ = fn.name
+            function._engine = engine    # the compiled code lives as long as the functions that call it
+            return function
+
+        return {fn.name: make_function(fn)
+                for fn in self._fns.values()
+                if fn.public}
+
     def build(
         self,
         name: str,
@@ -407,27 +2046,310 @@ class Package:
         mode: Mode = Mode.RELEASE,
         platform: Platform = Platform.HOST,
         tolerance: float = 1e-5,
+        debug_sample_stride: int = 1,
         output_dir: str = None,
+        huge_page_threshold: int = None,
+        vectorization_report: bool = False,
+        gpu_resource_report: bool = False,
+        cost_model_report: bool = False,
+        compile_report: bool = False,
+        code_size_budget: int = None,
+        unroll_report: bool = False,
+        streaming_emission: bool = False,
+        num_workers: int = 1,
+        cache_dir: str = None,
+        update: bool = False,
+        cpu_versions: List[str] = None,
+        cross_targets: List[Union[str, Target]] = None,
+        benchmark: Union[bool, "accera.BenchmarkOptions"] = False,
+        profile: Profile = Profile.NONE,
+        line_info: bool = False,
+        outline_cache_copies: bool = False,
+        count_memory_traffic: bool = False,
+        python_module: bool = False,
         _quiet=True
     ):
         """Builds a HAT package.
 
         Args:
             name: The package name.
-            format: The format of the package.
+            format: The format of the package. `Package.Format.JIT` compiles the CPU functions of a host package into
+                the memory of the process instead of building a package, which skips writing, linking and loading
+                the library, e.g. when tuning. Buffers that are memory-mapped from files are not supported.
+                `Package.Format.CPP_HEADER` writes a header of C++ source that defines the functions static inline,
+                so that the compiler of the code that includes it can inline small functions into their callers.
+                `Package.Format.LLVM_BITCODE` also writes the optimized LLVM bitcode of each module next to its object
+                file, which can be linked instead of the object with LTO so that the functions are inlined into their
+                callers. The package is a single module with `num_workers=1`, and each function is in a module of
+                its own with `update=True`.
             mode: The package mode, such as whether it is optimized or used for debugging.
             platform: The platform where the package will run.
             tolerance: The tolerance for correctness checking when `mode = Package.Mode.DEBUG`.
+            debug_sample_stride: When `mode = Package.Mode.DEBUG`, computes and checks only every n-th iteration of the
+                outermost loop of the reference implementation, if the iterations of that loop write separate
+                slices of the outputs. The other slices are taken from the results of the function. The reference
+                runs its outermost loop in parallel and vectorizes its innermost loop when their iterations are
+                independent.
             output_dir: The path to an output directory. Defaults to the current directory if unspecified.
+            huge_page_threshold: The size in bytes from which the caches and other static buffers of CPU functions
+                are backed by huge pages (2MB pages, or 1GB pages for buffers of at least 1GB), which reduces TLB
+                misses for large working sets. The buffers fall back to transparent huge pages when the system has
+                no huge pages reserved. Defaults to never using huge pages.
+            vectorization_report: Whether to write `<name>.vectorization.json` to `output_dir`, which lists the
+                outcome of each loop marked for vectorization, the vector size it used and the first op that
+                kept it from being fully vectorized.
+            gpu_resource_report: Whether to write `<name>.gpu_resources.json` to `output_dir`, which lists the grid
+                and block sizes of each GPU kernel, the shared memory per block and private memory per thread it
+                allocates, and the occupancy estimated from them. When the backend compiler is installed, the CUDA
+                kernels are also compiled with ptxas and the ROCm code objects with the AMDGPU resource usage
+                remarks, and each kernel gets the `"compiled_resources"` they report: its `"registers"` per thread,
+                `"shared_memory_bytes"`, `"stack_bytes"`, whether it `"spills"` registers and the spills themselves.
+                These also go to the `auxiliary.resources` table of the device function in the HAT file, replace the
+                estimates in the occupancy, and a warning is logged for each kernel that spills. The
+                `"register_caches"` of a kernel list the element budget of each `Target.CacheLevel.REGISTERS` cache,
+                the elements it holds and whether it was placed in `"registers"` or fell back to its `"source"`.
+                The `"uncoalesced_accesses"` of a kernel list the loads and stores of its array arguments whose
+                consecutive threads are further apart than the elements each thread accesses, with the largest
+                `"stride"` in elements, and a warning is logged for each of them. A warning is also logged for each
+                kernel that uses more shared memory than a block of the target can, so that it can't be launched.
+            cost_model_report: Whether to write `<name>.cost_model.json` to `output_dir`, which estimates the memory
+                traffic, footprint and arithmetic intensity of each loop level of the functions. See `estimate_costs`.
+                The HAT entry of each public function also gets the estimated `"flops"`, `"bytes"` (the footprint of
+                its arrays), `"scratch_bytes"` (its caches and other buffers) and `"num_threads"` in its
+                `auxiliary.accera.cost` table, to which `benchmark` adds the measured median `"latency_ms"`.
+                Unless the functions are sharded across modules, e.g. with `num_workers` or `cache_dir`, the HAT entry
+                of each public function also gets an `auxiliary.accera.threading` table whether or not the report is
+                requested: `"reentrant"` (whether it can be called concurrently with itself, i.e. neither it nor the
+                functions it calls use mutable globals such as global caches), `"parallel"` and `"num_threads"` (the
+                threads of its widest parallel region), `"scratch_bytes"` (the buffers it allocates per call) and
+                `"static_bytes"` (the mutable globals it uses).
+            compile_report: Whether to write `<name>.compile_stats.json` to `output_dir`, which lists the op count of
+                each function after each major stage of the lowering and the wall time the stage took, and
+                `<name>.pass_timing.txt`, the MLIR timing report of each pass of the lowering. An op count that
+                jumps between stages points at the schedule that blows up the IR, e.g. by unrolling. Also writes
+                `<name>.emitter_stats.json`, the number of objects the emitter kept alive for the package module.
+            code_size_budget: The number of ops that unrolling may grow each function to. A loop that would take its
+                function past the budget when it is unrolled is only unrolled by the largest factor of its trip count
+                that fits, with a warning. Loops are unrolled from the innermost out. Defaults to no budget.
+            unroll_report: Whether to write `<name>.unroll.json` to `output_dir`, which lists the trip count, the
+                requested unroll factor and the factor each loop marked for unrolling was unrolled by.
+            streaming_emission: Whether to release what the emitter keeps for the values of a loop or kernel body
+                once the body is emitted, which bounds the memory of emitting very large nests. Defaults to False.
+            num_workers: The number of modules that the functions of a CPU package are sharded across. The modules
+                are lowered and compiled concurrently, each by its own processes, and are packaged together with
+                one object file each. Defaults to a single module.
+            cache_dir: The path to a directory of compiled functions that is shared across builds. Each function of a
+                CPU package is lowered in its own module, and the object file of a module is taken from the cache
+                when the module, the compiler options and the Accera and LLVM tools are unchanged since it was cached.
+                Defaults to no caching.
+            update: Whether to update the package of the same name in `output_dir` in place, which was built with
+                `update=True`, instead of rebuilding it. Only the functions of this package are compiled, each into
+                its own object file, and they replace the functions of the same name in the package, or are added to
+                it. The library is relinked with the object files of the other functions and their HAT entries are
+                kept. The constant arrays of the other functions must be defined again before updating the package,
+                since the package globals are rebuilt. Only supported for CPU functions.
+            cpu_versions: The CPU versions that each public function of an x86-64 CPU package is also compiled for,
+                from "avx512_vnni" (Cascade Lake), "avx512" (Skylake-AVX512) and "avx2" (Haswell), so that one package
+                runs at its best on hosts with different instruction sets. The package is compiled for the x86-64
+                baseline instead of the target's CPU, and each function dispatches to the most capable version that
+                the host supports, or to its baseline version, by the CPU features that the acc-runtime library reads
+                with CPUID when it is loaded. The HAT file requires the baseline extensions, and lists the versions of
+                each function in its auxiliary data. Defaults to compiling for the target's CPU only.
+            cross_targets: The other targets that the CPU functions of the package are also compiled for, as known
+                targets or their names, e.g. "pi3" for a package of `Target.Model.RASPBERRY_PI_4B`. The functions are
+                emitted, lowered and translated to LLVM IR once, with the schedules of their target, and only the
+                LLVM optimizations and code generation run for each cross target, concurrently. The cross targets
+                must share the data layout of the target, e.g. the 32-bit ARM targets or the x86-64 targets. The
+                package of each cross target is written to a subdirectory of `output_dir` named after it, with its
+                own object files and a HAT file that requires its OS, architecture and extensions. Defaults to
+                compiling for the target only.
+            benchmark: Whether to generate, build and run a harness that times each function of a host CPU package
+                on random inputs, or the `BenchmarkOptions` to do so with. The harness is written to
+                `<name>_benchmark.cpp` in `output_dir`, and the minimum, median and 99th percentile latencies of each
+                function, and its GFLOP/s when its floating point operations per call are given, are written to
+                `<name>.benchmark.json`. The median latency is also recorded as `"latency_ms"` in the
+                `auxiliary.accera.cost` table of the HAT entry of each function. With `BenchmarkOptions.roofline`,
+                the harness also measures the bandwidth of each memory level of the host, and the roofline of each
+                function, from the operations and bytes of the cost model and the measured latency, is written to
+                `<name>.roofline.json`, e.g. "at 40% of compute roof, memory-bound at L2". With
+                `BenchmarkOptions.cache_copies`, the data movement of each CPU cache is timed in a profile region of
+                its own, and the bandwidth that each fill, write back, reduce and zeroing achieved is compared against
+                the measured bandwidth of the memory level that holds it in `<name>.cache_copies.json`. With
+                `BenchmarkOptions.memory_traffic`, the package is built with `count_memory_traffic`, and the bytes
+                that each call moved to and from each array are compared against the footprints of the cost model in
+                `<name>.memory_traffic.json`. The latencies are then those of the instrumented functions.
+            profile: The parts of the CPU functions that are timed in profile regions when they run, as a combination of
+                `Package.Profile` flags: `FUNCTIONS` times each function, `LOOPS` the loops of the dimensions marked
+                with `Plan.profile`, and `CACHES` each fill, write back, reduce and zeroing of a cache. The regions are
+                named after their function, followed by the dimension of a loop, e.g. "matmul_i_1", or by the number
+                and kind of a cache copy, e.g. "matmul_cache0_fill", and nest in each other. The package then depends on
+                the acc-runtime library, whose `AcceraPrintProfileResults`, `AcceraWriteProfileTrace` and
+                `AcceraGetProfileRecords` report the time spent in each region. Defaults to no profiling.
+            line_info: Whether to write `<name>.lines.mlir` to `output_dir`, a listing of the CPU functions once their
+                loop nests are lowered to loops, each marked with the index it iterates over, and to emit the debug
+                line info of the generated code against it, so that sampling profilers such as `perf annotate` and
+                VTune attribute the time of each instruction to a line of the listing. Not supported with the MLIR
+                formats, whose dumps replace the locations, nor with `num_workers`, `cache_dir` or `update`.
+            outline_cache_copies: Whether to move each fill, write back, reduce and zeroing of a CPU cache to an
+                internal function of its own that is never inlined, named after the function and the number and kind
+                of the copy, e.g. "matmul_cache0_fill", so that sampling profilers report its time separately. The
+                calls add a little overhead to each copy.
+            count_memory_traffic: Whether to instrument the loads and stores of the CPU functions to count the bytes
+                that they move to and from each array at runtime: each argument, e.g. "matmul_impl_123:arg0", each
+                cache, e.g. "matmul_impl_123:cache0", and each other buffer or global. The bytes are added to the
+                profile region that the thread is in, see `profile`, or outside of the regions, so that the traffic
+                of the arrays with and without caches can be compared where hardware counters aren't available. The
+                package then depends on the acc-runtime library, whose `AcceraPrintProfileResults`,
+                `AcceraWriteMemoryTraffic` and `AcceraGetMemoryTrafficRecords` report the traffic. The counting slows
+                the functions down, it is meant for validation rather than timing.
+            python_module: Whether to also build `<name>_py`, a Python extension module of the host CPU functions of a
+                dynamic library package, into `output_dir`. Each public function that takes arrays of static shapes
+                only is a function of the module that takes an object exporting a contiguous buffer, such as a NumPy
+                array, for each argument, in order. A call only checks the number of arguments, the size in bytes of
+                each buffer and that the buffers of the arrays the function writes are writable, and it releases the
+                GIL while the function runs, so that small functions can be called from latency-sensitive Python code
+                without the marshaling of `hatlib`. The element types and layouts aren't checked. The module is
+                written to `<name>_py.cpp` and compiled with the C++ compiler of the host, it loads the package
+                library from its own directory.
+
+        Packages for the ARM Cortex-M4 and M4F targets don't allocate: the caches and temporary arrays of all of their
+        functions are carved from a single statically sized arena, in which the buffers whose lifetimes don't overlap
+        share memory. The package then writes `<name>.arena.json` to `output_dir`, with the exact `"bytes"` of the
+        arena and the offset of each function's buffers in it, and the HAT entry of each public function gets an
+        `auxiliary.accera.static_arena` table with the `"arena_bytes"` of the package and the `"bytes"` its own buffers
+        take. These packages are always built as a single module, without `num_workers`, `cache_dir` or `update`.
+
+        Returns:
+            The module file sets of the package, or with `Package.Format.JIT`, a dictionary that maps the name of each
+            public function to a callable that takes the numpy arrays of its arguments.
         """
 
         from . import accc
 
+        if huge_page_threshold is not None:
+            if huge_page_threshold <= 0:
+                raise ValueError("huge_page_threshold must be positive")
+            # the huge page buffers are allocated by the acc-runtime library
+            self._dynamic_dependencies.add(LibraryDependency.ACCERA_RUNTIME)
+
+        if cpu_versions:
+            unknown = set(cpu_versions) - set(Package._CPU_VERSIONS)
+            if unknown:
+                raise ValueError(f"Unknown CPU versions {sorted(unknown)}, expected {list(Package._CPU_VERSIONS)}")
+            # the dispatchers read the CPU features from the acc-runtime library
+            self._dynamic_dependencies.add(LibraryDependency.ACCERA_RUNTIME)
+
+        profile_cache_copies = getattr(benchmark, "cache_copies", False)
+        if profile_cache_copies or profile:
+            # the profile regions are timed by the acc-runtime library
+            self._dynamic_dependencies.add(LibraryDependency.ACCERA_RUNTIME)
+
+        benchmark_memory_traffic = getattr(benchmark, "memory_traffic", False)
+        count_memory_traffic = count_memory_traffic or benchmark_memory_traffic
+        if count_memory_traffic:
+            # the traffic is counted by the acc-runtime library
+            self._dynamic_dependencies.add(LibraryDependency.ACCERA_RUNTIME)
+
         target, target_device, compiler_options, dynamic_dependencies = self._generate_target_options(platform, mode)
+        compiler_options.huge_page_threshold = huge_page_threshold or 0
+        compiler_options.streaming_emission = streaming_emission
 
         if target.category == Target.Category.GPU and target.runtime == Target.Runtime.NONE:
             raise RuntimeError("GPU targets must specify a runtime")
 
+        if format & Package.Format.JIT:
+            output_dir = output_dir or os.getcwd()
+            if vectorization_report or cost_model_report or unroll_report:
+                os.makedirs(output_dir, exist_ok=True)
+            return self._build_jit(
+                name,
+                format,
+                mode,
+                platform,
+                target,
+                compiler_options,
+                vectorization_report_path=os.path.abspath(os.path.join(output_dir, f"{name}.vectorization.json"))
+                if vectorization_report else None,
+                cost_model_report_path=os.path.abspath(os.path.join(output_dir, f"{name}.cost_model.json"))
+                if cost_model_report else None,
+                unroll_code_size_budget=code_size_budget,
+                unroll_report_path=os.path.abspath(os.path.join(output_dir, f"{name}.unroll.json"))
+                if unroll_report else None,
+                unsupported={
+                    "gpu_resource_report": gpu_resource_report,
+                    "compile_report": compile_report,
+                    "num_workers": num_workers > 1,
+                    "cache_dir": cache_dir,
+                    "cpu_versions": cpu_versions,
+                    "cross_targets": cross_targets,
+                    "benchmark": benchmark,
+                    "profile": bool(profile),
+                    "line_info": line_info,
+                    "outline_cache_copies": outline_cache_copies,
+                    "count_memory_traffic": count_memory_traffic
+                }
+            )
+
+        if debug_sample_stride < 1:
+            raise ValueError("debug_sample_stride must be positive")
+
+        if mode == Package.Mode.DEBUG and any(fn.use_workspace for fn in self._fns.values()):
+            # the debug wrappers call the functions with their declared arguments only
+            raise ValueError("Workspace arguments are not supported in Package.Mode.DEBUG")
+
+        if num_workers < 1:
+            raise ValueError("num_workers must be positive")
+        if num_workers > 1 and mode == Package.Mode.DEBUG:
+            # the debug functions are emitted in the same module as the functions they check
+            raise ValueError("num_workers is not supported in Package.Mode.DEBUG")
+        if num_workers > 1 and vectorization_report:
+            raise ValueError("vectorization_report is not supported with num_workers")
+        if num_workers > 1 and cost_model_report:
+            raise ValueError("cost_model_report is not supported with num_workers")
+        if num_workers > 1 and compile_report:
+            raise ValueError("compile_report is not supported with num_workers")
+        if num_workers > 1 and unroll_report:
+            raise ValueError("unroll_report is not supported with num_workers")
+        if code_size_budget is not None and code_size_budget <= 0:
+            raise ValueError("code_size_budget must be positive")
+        if cache_dir and mode == Package.Mode.DEBUG:
+            raise ValueError("cache_dir is not supported in Package.Mode.DEBUG")
+        if cache_dir and (vectorization_report or cost_model_report or compile_report or unroll_report):
+            # the reports are written while lowering, which cached functions skip
+            raise ValueError(
+                "cache_dir is not supported with vectorization_report, cost_model_report, compile_report or unroll_report"
+            )
+        if update and mode == Package.Mode.DEBUG:
+            raise ValueError("update is not supported in Package.Mode.DEBUG")
+        if update and (compiler_options.gpu_only
+                       or any(fn.target.category == Target.Category.GPU for fn in self._fns.values())):
+            raise ValueError("update is only supported for CPU functions")
+        if update and (vectorization_report or cost_model_report or compile_report or unroll_report):
+            # each function is lowered in its own module, which would write its own report
+            raise ValueError(
+                "update is not supported with vectorization_report, cost_model_report, compile_report or unroll_report"
+            )
+
+        if cpu_versions and (compiler_options.gpu_only or target_device.architecture != "x86_64"
+                             or any(fn.target.category == Target.Category.GPU for fn in self._fns.values())):
+            raise ValueError("cpu_versions is only supported for the CPU functions of x86-64 targets")
+        if cpu_versions and any(fn.use_workspace for fn in self._fns.values()):
+            raise ValueError("cpu_versions is not supported for functions with a workspace argument")
+
+        cross_targets = [t._device_name if isinstance(t, Target) else t for t in (cross_targets or [])]
+        unknown = [t for t in cross_targets if t not in accc.LLVM_TOOLING_OPTS]
+        if unknown:
+            raise ValueError(f"Unknown cross targets {unknown}, expected {list(accc.LLVM_TOOLING_OPTS)}")
+        if cross_targets and (compiler_options.gpu_only
+                              or any(fn.target.category == Target.Category.GPU for fn in self._fns.values())):
+            raise ValueError("cross_targets is only supported for CPU functions")
+        if cross_targets and (cpu_versions or update or cache_dir):
+            raise ValueError("cross_targets is not supported with cpu_versions, update or cache_dir")
+        for cross_target in cross_targets:
+            # the functions are lowered once, for the data layout of the target
+            if _lang_python._GetTargetDeviceFromName(cross_target).data_layout != target_device.data_layout:
+                raise ValueError(f"The cross target {cross_target} doesn't share the data layout of the target")
+
         cross_compile = platform != Platform.HOST
 
         format_is_default = bool(
@@ -440,47 +2362,191 @@ class Package:
         dynamic_link = bool(format & Package.Format.DYNAMIC_LIBRARY)
         if cross_compile and dynamic_link:
             raise ValueError("Package.Format.DYNAMIC_LIBRARY is not supported when cross-compiling")
+        if benchmark and not dynamic_link:
+            # the harness loads the functions from the package library
+            raise ValueError("benchmark requires a Package.Format.DYNAMIC_LIBRARY package built for the host")
+        if python_module and not dynamic_link:
+            # the module links against the package library
+            raise ValueError("python_module requires a Package.Format.DYNAMIC_LIBRARY package built for the host")
+        if update and not (format & Package.Format.HAT_PACKAGE
+                           and format & (Package.Format.DYNAMIC_LIBRARY | Package.Format.STATIC_LIBRARY)):
+            raise ValueError("update requires a Package.Format.HAT_DYNAMIC or Package.Format.HAT_STATIC package")
+        source_formats = Package.Format.CPP | Package.Format.CPP_HEADER | Package.Format.CUDA
+        if cpu_versions and format & source_formats:
+            raise ValueError("cpu_versions requires a package of object files")
+        emit_bitcode = bool(format & Package.Format.LLVM_BITCODE)
+        if emit_bitcode and (format & source_formats or compiler_options.gpu_only):
+            raise ValueError("Package.Format.LLVM_BITCODE requires a package of CPU object files")
+        if cross_targets and (format & source_formats or emit_bitcode):
+            raise ValueError("cross_targets requires a package of object files")
+
+        # Packages with CPU versions are compiled for the baseline, the versions override the CPU of their code
+        llvm_cpu = Package._BASELINE_CPU if cpu_versions else None
+        cpu_version_info = [{
+            "version": level,
+            "cpu": cpu,
+            "extensions": extensions
+        } for level, (cpu, extensions, _) in Package._CPU_VERSIONS.items() if level in (cpu_versions or [])] + [{
+            "version": "baseline",
+            "cpu": Package._BASELINE_CPU,
+            "extensions": Package._BASELINE_EXTENSIONS
+        }]
 
         output_dir = output_dir or os.getcwd()
         working_dir = os.path.join(output_dir, "_tmp")
         os.makedirs(output_dir, exist_ok=True)
         os.makedirs(working_dir, exist_ok=True)
 
+        # Update: the functions of the existing package that aren't rebuilt keep their object and HAT files. Each
+        # function was emitted in a module named after it, with the variants emitted along with it, e.g. its async
+        # variant.
+        kept_fn_headers = []
+        kept_hat_funcs = {}
+        if update and os.path.isfile(os.path.join(output_dir, name + ".hat")):
+            existing_hat_file = hat.HATFile.Deserialize(os.path.join(output_dir, name + ".hat"))
+            fn_modules = {}
+            for fn_name in existing_hat_file.function_map:
+                fn_header_path = os.path.join(output_dir, f"{name}_{fn_name}.hat")
+                if os.path.isfile(fn_header_path):
+                    fn_modules[fn_name] = hat.HATFile.Deserialize(fn_header_path).function_map.keys()
+                    if fn_name not in self._fns:
+                        kept_fn_headers.append(fn_header_path)
+            for fn_name, hat_func in existing_hat_file.function_map.items():
+                owner = next((owner for owner, fn_names in fn_modules.items() if fn_name in fn_names), None)
+                if owner is None:
+                    raise ValueError(f"The package {name} in {output_dir} wasn't built with update=True")
+                if owner not in self._fns:
+                    kept_hat_funcs[fn_name] = hat_func
+
+        # the debug functions take the arguments of the functions, which need their layouts
+        self._resolve_deferred_layouts()
+
         # Debug mode: add utility functions for checking results
         debug_utilities = self._add_debug_utilities(tolerance) \
             if mode == Package.Mode.DEBUG else {}
 
-        # Create the package module
-        package_module = _lang_python._Module(name=name, options=compiler_options)
-        self._add_functions_to_module(package_module)
-
-        # Debug mode: emit the debug function that uses the utility functions
-        for fn_name, utilities in debug_utilities.items():
-            package_module.EmitDebugFunction(fn_name, utilities)
-
-        # Emit the package module
         # TODO: Update Format enum to use SOURCE instead and then this should take runtime into consideration
         if format & Package.Format.CPP:
             output_type = accc.ModuleOutputType.CPP
+        elif format & Package.Format.CPP_HEADER:
+            if compiler_options.gpu_only:
+                raise ValueError("Package.Format.CPP_HEADER is only supported for CPU functions")
+            output_type = accc.ModuleOutputType.CPP_HEADER
         elif format & Package.Format.CUDA:
             output_type = accc.ModuleOutputType.CUDA
         else:
             output_type = accc.ModuleOutputType.OBJECT
 
+        # Shard the functions of CPU packages across modules that are lowered concurrently, the first shard is the
+        # package module
+        num_shards = 1
+        if not compiler_options.gpu_only and output_type == accc.ModuleOutputType.OBJECT:
+            # cached functions are reused one module each, so that a change to one function only rebuilds that function
+            num_shards = max(1, len(self._fns) if cache_dir else min(num_workers, len(self._fns)))
+        fn_shards = [list(self._fns)[i::num_shards] for i in range(num_shards)]
+        shard_names = [f"{name}_shard{i}" for i in range(1, num_shards)]
+        if update:
+            # each function is in its own module, named after it so that an update replaces its files, and the
+            # package module only holds what the functions share
+            fn_shards = [[]] + [[fn_name] for fn_name in self._fns]
+            shard_names = [f"{name}_{fn_name}" for fn_name in self._fns]
+
+        # Create the package module
+        package_module = _lang_python._Module(name=name, options=compiler_options)
+        self._add_functions_to_module(package_module, fn_shards[0], cpu_versions)
+
+        shard_modules = []
+        for shard_name, fn_shard in zip(shard_names, fn_shards[1:]):
+            shard_module = _lang_python._Module(name=shard_name, options=compiler_options)
+            self._add_functions_to_module(shard_module, fn_shard, cpu_versions)
+            shard_modules.append(shard_module)
+
+        if shard_modules and getattr(benchmark, "roofline", False):
+            # the costs of the functions come from the cost model report of the package module
+            raise ValueError("The roofline of the benchmark is not supported with num_workers, cache_dir or update")
+        if shard_modules and benchmark_memory_traffic:
+            # the footprints of the arrays come from the cost model report of the package module
+            raise ValueError("The memory traffic of the benchmark is not supported with num_workers, cache_dir or update")
+        if (shard_modules or cache_dir) and profile_cache_copies:
+            # the bytes of the copies come from the cache copy report of the package module, which cached objects skip
+            raise ValueError("The cache copies of the benchmark are not supported with num_workers, cache_dir or update")
+        if line_info and (shard_modules or cache_dir):
+            # the listing is written by the lowering of the package module, and cached objects skip it
+            raise ValueError("line_info is not supported with num_workers, cache_dir or update")
+        static_arena = target._device_name.lower() in accc.STATIC_ARENA_SYSTEM_TARGETS
+        if static_arena and (shard_modules or cache_dir):
+            # each module would have an arena of its own, and cached objects skip the lowering that writes the report
+            raise ValueError("num_workers, cache_dir and update are not supported for targets with a static arena")
+        if line_info and format & (Package.Format.MLIR | Package.Format.MLIR_VERBOSE):
+            # the dump after each pass locates the ops at their line in the dump
+            raise ValueError("line_info is not supported with the MLIR formats")
+
+        # Debug mode: emit the debug function that uses the utility functions
+        for fn_name, utilities in debug_utilities.items():
+            target = self._fns[fn_name].target
+            if target.category == Target.Category.CPU:
+                package_module.EmitDebugFunction(
+                    fn_name,
+                    utilities,
+                    num_threads=target.num_threads,
+                    vectorization_info=target.vectorization_info,
+                    sample_stride=debug_sample_stride
+                )
+            else:
+                package_module.EmitDebugFunction(fn_name, utilities, sample_stride=debug_sample_stride)
+
+        if compile_report:
+            with open(os.path.join(output_dir, f"{name}.emitter_stats.json"), "w") as f:
+                json.dump(package_module.GetEmitterStats(), f, indent=2)
+
+        # Emit the package module
+
         # Emit the supporting modules
         supporting_hats = []
         if not compiler_options.gpu_only and output_type == accc.ModuleOutputType.OBJECT:
             supporting_hats.append(
-                Package._emit_default_module(compiler_options, target, mode, output_dir, f"{name}_Globals")
+                Package._emit_default_module(
+                    compiler_options, target, mode, output_dir, f"{name}_Globals", llvm_cpu, emit_bitcode, cross_targets
+                )
             )
             if any(fn.target.category == Target.Category.GPU and fn.target.runtime == Target.Runtime.VULKAN
                    for fn in self._fns.values()):
                 supporting_hats.append(self._create_gpu_utility_module(compiler_options, target, mode, output_dir))
 
-        proj = accc.AcceraProject(output_dir=working_dir, library_name=name, output_type=output_type)
-        proj.module_file_sets = [accc.ModuleFileSet(name=name, common_module_dir=working_dir, output_type=output_type)]
+        proj = accc.AcceraProject(
+            output_dir=working_dir, library_name=name, output_type=output_type, num_workers=num_workers
+        )
+        proj.module_file_sets = [
+            accc.ModuleFileSet(
+                name=name,
+                common_module_dir=working_dir,
+                output_type=output_type,
+                # OpenCL kernels are translated to an OpenCL C program
+                cuda_ext=".cl" if target.runtime == Runtime.OPENCL else ".cu",
+                module=package_module
+            )
+        ]
         package_module.Save(proj.module_file_sets[0].generated_mlir_filepath)
 
+        # The threading metadata of the HAT entries comes from the cost model report, which is written to the working
+        # directory when it isn't requested. It is only written for the package module, so sharded builds skip it.
+        cost_model_report_path = None
+        if cost_model_report:
+            cost_model_report_path = os.path.abspath(os.path.join(output_dir, f"{name}.cost_model.json"))
+        elif not shard_modules:
+            cost_model_report_path = os.path.abspath(os.path.join(working_dir, f"{name}.cost_model.json"))
+
+        for i, (shard_name, shard_module) in enumerate(zip(shard_names, shard_modules), start=1):
+            proj.module_file_sets.append(
+                accc.ModuleFileSet(
+                    name=shard_name,
+                    common_module_dir=working_dir,
+                    output_type=output_type,
+                    module=shard_module
+                )
+            )
+            shard_module.Save(proj.module_file_sets[i].generated_mlir_filepath)
+
         # Enable dumping of IR passes based on build format
         dump_ir = bool(format & (Package.Format.MLIR | Package.Format.MLIR_VERBOSE))
         dump_ir_verbose = bool(format & Package.Format.MLIR_VERBOSE)
@@ -491,18 +2557,109 @@ class Package:
             dump_all_passes=dump_ir,
             dump_intrapass_ir=dump_ir_verbose,
             gpu_only=compiler_options.gpu_only,
-            quiet=_quiet
+            gpu_chip=target.family.lower() if target.runtime == Runtime.ROCM else None,
+            cuda_arch=f"sm_{target.family[2:]}" if target.runtime == Runtime.CUDA and gpu_resource_report else None,
+            quiet=_quiet,
+            vectorization_report_path=os.path.abspath(os.path.join(output_dir, f"{name}.vectorization.json"))
+            if vectorization_report else None,
+            gpu_resource_report_path=os.path.abspath(os.path.join(output_dir, f"{name}.gpu_resources.json"))
+            if gpu_resource_report else None,
+            cost_model_report_path=cost_model_report_path,
+            compile_stats_report_path=os.path.abspath(os.path.join(output_dir, f"{name}.compile_stats.json"))
+            if compile_report else None,
+            pass_timing_report_path=os.path.abspath(os.path.join(output_dir, f"{name}.pass_timing.txt"))
+            if compile_report else None,
+            unroll_code_size_budget=code_size_budget,
+            unroll_report_path=os.path.abspath(os.path.join(output_dir, f"{name}.unroll.json"))
+            if unroll_report else None,
+            cache_copy_report_path=os.path.abspath(os.path.join(working_dir, f"{name}.cache_copy_report.json"))
+            if profile_cache_copies else None,
+            outline_cache_copies=outline_cache_copies,
+            count_memory_traffic=count_memory_traffic,
+            line_info_path=os.path.abspath(os.path.join(output_dir, f"{name}.lines.mlir")) if line_info else None,
+            arena_report_path=os.path.abspath(os.path.join(output_dir, f"{name}.arena.json")) if static_arena else None,
+            profile=bool(profile),
+            profile_regions=[
+                region for flag, region in [
+                    (Package.Profile.FUNCTIONS, "functions"),
+                    (Package.Profile.LOOPS, "loops"),
+                    (Package.Profile.CACHES, "cache-copies"),
+                ] if profile & flag
+            ],
+            cache_dir=os.path.abspath(cache_dir) if cache_dir else None,
+            llvm_cpu=llvm_cpu,
+            emit_bitcode=emit_bitcode,
+            additional_system_targets=cross_targets
         )
 
+        compiled_resources = {}
+        if gpu_resource_report:
+            gpu_resource_report_path = os.path.join(output_dir, f"{name}.gpu_resources.json")
+            Package._add_estimated_occupancy(gpu_resource_report_path, target)
+            with open(gpu_resource_report_path) as report_file:
+                compiled_resources = {
+                    kernel["name"]: kernel["compiled_resources"]
+                    for kernel in json.load(report_file)["kernels"] if "compiled_resources" in kernel
+                }
+
         path_root = os.path.join(output_dir, name)
         extension = ".hat"
 
-        if format & (Package.Format.CUDA | Package.Format.CPP):
+        if format & source_formats:
             shutil.copy(proj.module_file_sets[0].translated_source_filepath, output_dir)
 
+        # ROCm kernels compiled ahead of time are deployed next to their source
+        code_object = None
+        if target.runtime == Runtime.ROCM and format & Package.Format.CUDA:
+            code_object_path = proj.module_file_sets[0].code_object_filepath
+            if os.path.isfile(code_object_path):
+                shutil.copy(code_object_path, output_dir)
+                code_object = os.path.basename(code_object_path)
+
         if format & (Package.Format.DYNAMIC_LIBRARY | Package.Format.STATIC_LIBRARY):
             shutil.copy(proj.module_file_sets[0].object_filepath, output_dir)
 
+            # the package of each cross target has its own object files, and shares the mapped buffers
+            for cross_target, module_file_sets in proj.system_target_module_file_sets.items():
+                os.makedirs(os.path.join(output_dir, cross_target), exist_ok=True)
+                for module_file_set in module_file_sets:
+                    shutil.copy(module_file_set.object_filepath, os.path.join(output_dir, cross_target))
+
+            # packed buffers that are memory-mapped at runtime are deployed next to the library
+            package_module.WriteMappedBuffers(output_dir)
+
+        if emit_bitcode:
+            for module_file_set in proj.module_file_sets:
+                shutil.copy(module_file_set.optimized_ll_filepath, output_dir)
+
+        # The other shards are packaged like the supporting modules, with their own object and HAT file
+        for shard_module, module_file_set in zip(shard_modules, proj.module_file_sets[1:]):
+            if format & (Package.Format.DYNAMIC_LIBRARY | Package.Format.STATIC_LIBRARY):
+                shutil.copy(module_file_set.object_filepath, output_dir)
+                shard_module.WriteMappedBuffers(output_dir)
+
+            if format & Package.Format.HAT_PACKAGE:
+                shard_header_path = os.path.join(output_dir, module_file_set.module_name + extension)
+                shard_module.WriteHeader(shard_header_path)
+                shard_hat_file = hat.HATFile.Deserialize(shard_header_path)
+                shard_hat_file.dependencies.link_target = os.path.basename(module_file_set.object_filepath)
+                shard_hat_file.Serialize(shard_header_path)
+                supporting_hats.append(shard_header_path)
+
+        # Update: the kept functions are linked from their object files like the shards
+        supporting_hats += kept_fn_headers
+
+        cost_report = None
+        if cost_model_report_path:
+            with open(cost_model_report_path) as report_file:
+                cost_report = json.load(report_file)
+
+        arena_report = None
+        arena_report_path = os.path.join(output_dir, f"{name}.arena.json")
+        if static_arena and os.path.isfile(arena_report_path):
+            with open(arena_report_path) as report_file:
+                arena_report = json.load(report_file)
+
         if format & Package.Format.HAT_PACKAGE:
             # Create initial HAT file containing shape and type metadata that the C++ layer has access to
             header_path = path_root + extension
@@ -530,6 +2687,9 @@ class Package:
                 # Merge the function maps
                 hat_file._function_table.function_map.update(support._function_table.function_map)
 
+            # The kept functions keep their entries of the existing package, e.g. their auxiliary data
+            hat_file._function_table.function_map.update(kept_hat_funcs)
+
             decl_code = hat_file.declaration.code
             hat_file.dependencies.dynamic = dynamic_dependencies + supporting_objs
             hat_file.declaration.code = decl_code._new('\n'.join(map(str, ['', decl_code] + supporting_decls)))
@@ -544,16 +2704,51 @@ class Package:
                         raise ValueError(f"Couldn't find header-declared function {fn_name} in emitted HAT file")
 
                     hat_func.auxiliary = fn.auxiliary
+                    if cpu_versions:
+                        hat_func.auxiliary = {
+                            **fn.auxiliary, "accera": {
+                                **fn.auxiliary.get("accera", {}), "cpu_versions": cpu_version_info
+                            }
+                        }
+                    if cost_model_report:
+                        hat_func.auxiliary = {
+                            **hat_func.auxiliary, "accera": {
+                                **hat_func.auxiliary.get("accera", {}), "cost": Package._get_function_cost(cost_report, fn)
+                            }
+                        }
+                    if cost_report:
+                        hat_func.auxiliary = {
+                            **hat_func.auxiliary, "accera": {
+                                **hat_func.auxiliary.get("accera", {}),
+                                "threading": Package._get_function_threading(cost_report, fn)
+                            }
+                        }
+
+                    if arena_report:
+                        hat_func.auxiliary = {
+                            **hat_func.auxiliary, "accera": {
+                                **hat_func.auxiliary.get("accera", {}),
+                                "static_arena": Package._get_function_arena(arena_report, fn)
+                            }
+                        }
 
                     if fn.target.category == Target.Category.GPU and fn.target.runtime != Target.Runtime.VULKAN:
                         # TODO: Remove this when the header is emitted as part of the compilation
                         gpu_source = proj.module_file_sets[0].translated_source_filepath
                         gpu_device_func = fn_name + "__gpu__"
                         with open(gpu_source) as gpu_source_f: 
-                            s = re.search(gpu_device_func + _R_GPU_LAUNCH, gpu_source_f.read())
+                            gpu_source_code = gpu_source_f.read()
+                            s = re.search(gpu_device_func + _R_GPU_LAUNCH, gpu_source_code)
                             if not s:
                                 raise RuntimeError("Couldn't parse emitted source code")
                             launch_parameters = list(map(int, [s[n] for n in range(1, 7)]))
+
+                            # kernels bound to devices are launched once per partition, see Plan.bind
+                            s = re.search(
+                                r"accera_partition < (\d+);[^{]*\{\s*accera_set_device_partition\(accera_partition\);\s*"
+                                + gpu_device_func + "<<<", gpu_source_code
+                            )
+                            num_devices = int(s[1]) if s else 1
                         gpu_source = os.path.split(gpu_source)[1]
 
                         hat_target: hat.Target = hat_file.target
@@ -573,19 +2768,27 @@ class Package:
                             provider=gpu_source,
                             runtime=fn.target.runtime.name
                         )
-
-            if target_device.is_windows():
-                hat_os = hat.OperatingSystem.Windows
-            elif target_device.is_macOS():
-                hat_os = hat.OperatingSystem.MacOS
-            elif target_device.is_linux():
-                hat_os = hat.OperatingSystem.Linux
-            hat_file.target.required.os = hat_os
-            hat_file.target.required.cpu.architecture = target_device.architecture
-
-            # Not all of these features are necessarily used in this module, however we don't currently have a way
-            # of determining which are and are not used so to be safe we require all of them
-            hat_file.target.required.cpu.extensions = target_device.features.split(",")
+                        if code_object:
+                            # the code object can be loaded with hipModuleLoadData instead of compiling the source
+                            hat_file.device_function_map[gpu_device_func].auxiliary = {
+                                "code_object": code_object,
+                                "offload_arch": fn.target.family.lower()
+                            }
+                        if num_devices > 1:
+                            # the partition index is set through the accera_device_partition symbol before each launch
+                            hat_file.device_function_map[gpu_device_func].auxiliary = {
+                                **hat_file.device_function_map[gpu_device_func].auxiliary,
+                                "devices": num_devices
+                            }
+                        if gpu_device_func in compiled_resources:
+                            hat_file.device_function_map[gpu_device_func].auxiliary = {
+                                **hat_file.device_function_map[gpu_device_func].auxiliary,
+                                "resources": compiled_resources[gpu_device_func]
+                            }
+
+            Package._set_required_target(hat_file, target_device)
+            if cpu_versions:
+                hat_file.target.required.cpu.extensions = Package._BASELINE_EXTENSIONS
 
             hat_file.description.author = self._description.get("author", "")
             hat_file.description.version = self._description.get("version", "")
@@ -595,6 +2798,9 @@ class Package:
 
             hat_file.Serialize(header_path)
 
+            for cross_target in cross_targets:
+                Package._write_cross_target_header(header_path, output_dir, cross_target)
+
             if dynamic_link and (format & Package.Format.DYNAMIC_LIBRARY):
                 dyn_hat_path = f"{path_root}_dyn{extension}"
                 hat.create_dynamic_package(header_path, dyn_hat_path)
@@ -605,8 +2811,182 @@ class Package:
                 shutil.move(lib_hat_path, header_path)
             # TODO: plumb cross-compilation of static libs
 
+        if benchmark:
+            results = self._benchmark(name, header_path, output_dir, benchmark, cost_report, _quiet)
+
+            # The measured latencies complete the costs in the HAT file
+            hat_file = hat.HATFile.Deserialize(header_path)
+            for result in results["functions"]:
+                hat_func = hat_file.function_map.get(result["name"])
+                if hat_func is not None:
+                    accera_aux = hat_func.auxiliary.get("accera", {})
+                    hat_func.auxiliary = {
+                        **hat_func.auxiliary, "accera": {
+                            **accera_aux, "cost": {
+                                **accera_aux.get("cost", {}), "latency_ms": result["median_ms"]
+                            }
+                        }
+                    }
+            hat_file.Serialize(header_path)
+
+        if python_module:
+            self._build_python_module(name, header_path, output_dir, _quiet)
+
         return proj.module_file_sets
 
+    @staticmethod
+    def _set_required_target(hat_file, target_device):
+        "Sets the OS, CPU architecture and extensions that a HAT package requires from its target device"
+        if target_device.is_windows():
+            hat_os = hat.OperatingSystem.Windows
+        elif target_device.is_macOS():
+            hat_os = hat.OperatingSystem.MacOS
+        elif target_device.is_linux():
+            hat_os = hat.OperatingSystem.Linux
+        hat_file.target.required.os = hat_os
+        hat_file.target.required.cpu.architecture = target_device.architecture
+
+        # Not all of these features are necessarily used in this module, however we don't currently have a way
+        # of determining which are and are not used so to be safe we require all of them
+        hat_file.target.required.cpu.extensions = target_device.features.split(",")
+
+    @staticmethod
+    def _write_cross_target_header(header_path: str, output_dir: str, cross_target: str):
+        "Writes the HAT file of the package of a cross target, which links to the object files in its subdirectory"
+        target_dir = os.path.join(output_dir, cross_target)
+        os.makedirs(target_dir, exist_ok=True)
+
+        hat_file = hat.HATFile.Deserialize(header_path)
+        for dependency in hat_file.dependencies.dynamic:
+            # the supporting modules and shards of the package were compiled for the cross target too
+            if os.path.dirname(dependency.target_file) == os.path.abspath(output_dir):
+                dependency.target_file = os.path.join(os.path.abspath(target_dir), os.path.basename(dependency.target_file))
+
+        Package._set_required_target(hat_file, _lang_python._GetTargetDeviceFromName(cross_target))
+        hat_file.Serialize(os.path.join(target_dir, os.path.basename(header_path)))
+
+    def _benchmark(self, name: str, header_path: str, output_dir: str, options, cost_report: dict, quiet: bool):
+        from . import Benchmark
+
+        if not isinstance(options, Benchmark.BenchmarkOptions):
+            options = Benchmark.BenchmarkOptions()
+        if options.iterations < 1:
+            raise ValueError("The benchmark needs at least one iteration")
+
+        runtime_library = get_library_reference(LibraryDependency.ACCERA_RUNTIME, Platform.HOST)
+        if not runtime_library:
+            raise RuntimeError("The benchmark harness requires the Accera runtime library, which is not installed")
+
+        fns = [fn for fn in self._fns.values() if fn.target.category == Target.Category.CPU]
+        skipped = [fn.name for fn in fns if not Benchmark.is_benchmarkable(fn)]
+        if skipped:
+            logging.warning(
+                f"Not benchmarking {', '.join(skipped)}, which are private or take arguments other than arrays"
+            )
+        fns = [fn for fn in fns if Benchmark.is_benchmarkable(fn)]
+
+        # the bandwidths of the memory levels of the host, which is the target of all the benchmarked functions
+        bandwidth_probes = Benchmark.get_bandwidth_probes(fns[0].target) \
+            if (options.roofline or options.cache_copies) and fns else []
+
+        source_path = os.path.join(output_dir, f"{name}_benchmark.cpp")
+        with open(source_path, "w") as source_file:
+            source_file.write(Benchmark.generate_harness(fns, options, bandwidth_probes))
+
+        executable_path = os.path.join(output_dir, "_tmp", f"{name}_benchmark")
+        Benchmark.compile_harness(source_path, executable_path, runtime_library.target_file, quiet)
+
+        library_path = os.path.join(output_dir, hat.HATFile.Deserialize(header_path).dependencies.link_target)
+        results = Benchmark.run_harness(executable_path, library_path, runtime_library.target_file)
+        with open(os.path.join(output_dir, f"{name}.benchmark.json"), "w") as results_file:
+            json.dump(results, results_file, indent=2)
+
+        if options.roofline:
+            costs = {fn.name: Package._get_function_cost(cost_report, fn) for fn in fns}
+            roofline = Benchmark.get_roofline(results, fns, costs, bandwidth_probes)
+            with open(os.path.join(output_dir, f"{name}.roofline.json"), "w") as roofline_file:
+                json.dump(roofline, roofline_file, indent=2)
+            for entry in roofline["functions"]:
+                logging.info(f"{entry['name']}: {entry['summary']}")
+
+        if options.cache_copies:
+            with open(os.path.join(output_dir, "_tmp", f"{name}.cache_copy_report.json")) as report_file:
+                cache_copy_report = json.load(report_file)
+            cache_copies = Benchmark.get_cache_copy_bandwidth(results, cache_copy_report, bandwidth_probes)
+            with open(os.path.join(output_dir, f"{name}.cache_copies.json"), "w") as cache_copies_file:
+                json.dump(cache_copies, cache_copies_file, indent=2)
+            for entry in cache_copies["regions"]:
+                logging.info(f"{entry['function']} {entry['name']}: {entry['summary']}")
+
+        if options.memory_traffic:
+            memory_traffic = Benchmark.get_memory_traffic(results, fns, cost_report)
+            with open(os.path.join(output_dir, f"{name}.memory_traffic.json"), "w") as memory_traffic_file:
+                json.dump(memory_traffic, memory_traffic_file, indent=2)
+            for entry in memory_traffic["functions"]:
+                logging.info(f"{entry['name']}: {entry['summary']}")
+        return results
+
+    def _build_python_module(self, name: str, header_path: str, output_dir: str, quiet: bool):
+        from . import PythonModule
+
+        fns = [fn for fn in self._fns.values() if PythonModule.is_bindable(fn)]
+        skipped = [fn.name for fn in self._fns.values() if fn.public and not PythonModule.is_bindable(fn)]
+        if skipped:
+            logging.warning(
+                f"Not binding {', '.join(skipped)} in the Python module, which aren't CPU functions or take arguments "
+                "other than arrays"
+            )
+
+        module_name = f"{name}_py"
+        source_path = os.path.join(output_dir, f"{module_name}.cpp")
+        with open(source_path, "w") as source_file:
+            source_file.write(PythonModule.generate_module(module_name, fns))
+
+        library_path = os.path.join(output_dir, hat.HATFile.Deserialize(header_path).dependencies.link_target)
+        PythonModule.compile_module(
+            source_path, PythonModule.get_module_path(output_dir, module_name), library_path, quiet
+        )
+
+    @staticmethod
+    def _get_function_cost(cost_report: dict, fn: lang.Function) -> dict:
+        "The estimated costs of a function from the cost model report, which has separate entries for its implementation"
+        entries = [
+            entry for entry in cost_report["functions"]
+            if entry["name"] == fn.name or entry["name"].startswith(fn._impl_name)
+        ]
+        return {
+            "flops": sum(entry["ops"] for entry in entries),
+            "bytes": sum(entry["footprint_bytes"] for entry in entries),
+            "scratch_bytes": sum(entry["scratch_bytes"] for entry in entries),
+            "num_threads": max((entry["num_threads"] for entry in entries), default=1)
+        }
+
+    @staticmethod
+    def _get_function_threading(cost_report: dict, fn: lang.Function) -> dict:
+        "Whether a function can be called concurrently with itself and the threads and memory it uses, from the cost model report"
+        entries = [
+            entry for entry in cost_report["functions"]
+            if entry["name"] == fn.name or entry["name"].startswith(fn._impl_name)
+        ]
+        num_threads = max((entry["num_threads"] for entry in entries), default=1)
+        static_bytes = sum(entry["static_bytes"] for entry in entries)
+        return {
+            "reentrant": all(entry["reentrant"] for entry in entries),
+            "parallel": num_threads > 1,
+            "num_threads": num_threads,
+            "scratch_bytes": sum(entry["scratch_bytes"] for entry in entries) - static_bytes,
+            "static_bytes": static_bytes
+        }
+
+    @staticmethod
+    def _get_function_arena(arena_report: dict, fn: lang.Function) -> dict:
+        "The bytes of the static arena of the package and the bytes of it that a function's own buffers take"
+        entries = [
+            entry for entry in arena_report["functions"]
+            if entry["name"] == fn.name or entry["name"].startswith(fn._impl_name)
+        ]
+        return {"arena_bytes": arena_report["bytes"], "bytes": sum(entry["bytes"] for entry in entries)}
+
     def add_description(
         self,
         author: str = None,
@@ -651,7 +3031,9 @@ class Package:
         _lang_python._SetActiveModule(cls._default_module)
 
     @classmethod
-    def _emit_default_module(cls, compiler_options, target, mode, output_dir, name):
+    def _emit_default_module(
+        cls, compiler_options, target, mode, output_dir, name, llvm_cpu=None, emit_bitcode=False, cross_targets=None
+    ):
         # Specializes and then emits the default module
         cls._default_module.SetDataLayout(compiler_options)
-        return _emit_module(cls._default_module, target, mode, output_dir, name)
+        return _emit_module(cls._default_module, target, mode, output_dir, name, llvm_cpu, emit_bitcode, cross_targets)
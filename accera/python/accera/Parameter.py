@@ -7,17 +7,37 @@ from typing import List, Callable
 from varname import varname
 
 class DelayedParameter:
+    # The values of the parameters that are read while a function is emitted, see read_parameters
+    _reads = None
+
     def __init__(self, name=None):
         self._value = None
         self._name = name
 
     def get_value(self):
+        if DelayedParameter._reads is not None:
+            DelayedParameter._reads[self] = self._value
         return self._value
 
     def set_value(self, value):
         self._value = value
 
 
+class read_parameters:
+    "Records the value of each parameter that is read in its scope, in the dictionary that it returns"
+
+    def __enter__(self):
+        self._outer = DelayedParameter._reads
+        DelayedParameter._reads = {}
+        return DelayedParameter._reads
+
+    def __exit__(self, exc_type, exc_val, exc_tb):
+        reads = DelayedParameter._reads
+        DelayedParameter._reads = self._outer
+        if self._outer is not None:
+            self._outer.update(reads)
+
+
 def create_parameters(count: int):
     if count < 1:
         raise ValueError("Invalid parameters count")
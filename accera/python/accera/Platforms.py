@@ -25,9 +25,10 @@ class Platform(Enum):
 class LibraryDependency(Enum):
     OPENMP = "openmp"
     VULKAN = "vulkan"
+    ACCERA_RUNTIME = "accera_runtime"
 
 
-def find_vulkan_wrapper(file_name):
+def find_packaged_library(file_name):
     try:
         from ._version import __version__
     except:
@@ -45,6 +46,10 @@ def find_vulkan_wrapper(file_name):
         return None
 
 
+def find_vulkan_wrapper(file_name):
+    return find_packaged_library(file_name)
+
+
 # TODO: rename and export so that it is updatable
 platform_libraries = {
     LibraryDependency.VULKAN: {
@@ -52,6 +57,11 @@ platform_libraries = {
         Platform.MACOS: find_vulkan_wrapper("libacc-vulkan-runtime-wrappers.dylib"),
         Platform.WINDOWS: find_vulkan_wrapper("acc-vulkan-runtime-wrappers.lib")
     },
+    LibraryDependency.ACCERA_RUNTIME: {
+        Platform.LINUX: find_packaged_library("libacc-runtime.so"),
+        Platform.MACOS: find_packaged_library("libacc-runtime.dylib"),
+        Platform.WINDOWS: find_packaged_library("acc-runtime.lib")
+    },
     LibraryDependency.OPENMP: {
         Platform.LINUX: {
             "target_file": "-lomp5",
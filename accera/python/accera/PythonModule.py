@@ -0,0 +1,174 @@
+####################################################################################################
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License. See LICENSE in the project root for license information.
+####################################################################################################
+
+import os
+import subprocess
+import sys
+import sysconfig
+from functools import reduce
+from typing import List
+
+from . import lang
+from .Benchmark import _ELEMENT_TYPES, _find_compiler
+from .lang.Plan import _ELEMENT_BYTES
+from .Targets import Target
+
+_MODULE_PROLOGUE = """// Python extension module generated by Accera.
+// Each function of the package is a module function that takes an object that exports a contiguous buffer, such as a
+// NumPy array, for each argument. The element types aren't checked, only the sizes of the buffers.
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+namespace
+{
+// Gets the buffers of the arguments of a call, releases them when the call returns
+template <int N>
+class Buffers
+{
+public:
+    Buffers() = default;
+    Buffers(const Buffers&) = delete;
+    Buffers& operator=(const Buffers&) = delete;
+
+    ~Buffers()
+    {
+        for (int i = 0; i < _count; ++i)
+        {
+            PyBuffer_Release(&_views[i]);
+        }
+    }
+
+    // Returns the data of the buffer of an argument, or nullptr with an exception set
+    void* Get(PyObject* arg, const char* fn, int index, Py_ssize_t bytes, bool writable)
+    {
+        Py_buffer& view = _views[_count];
+        if (PyObject_GetBuffer(arg, &view, PyBUF_ANY_CONTIGUOUS | (writable ? PyBUF_WRITABLE : 0)) != 0)
+        {
+            return nullptr;
+        }
+        ++_count;
+        if (view.len != bytes)
+        {
+            PyErr_Format(PyExc_ValueError, "%s: argument %d has %zd bytes, expected %zd", fn, index, view.len, bytes);
+            return nullptr;
+        }
+        return view.buf;
+    }
+
+private:
+    Py_buffer _views[N];
+    int _count = 0;
+};
+} // namespace
+"""
+
+
+def is_bindable(fn: lang.Function) -> bool:
+    "Whether the module can bind the function, which is a public CPU function that takes arrays of static shapes only"
+    if not fn.public or fn.use_workspace or fn.target.category != Target.Category.CPU:
+        return False
+    for arg in fn.requested_args:
+        if not isinstance(arg, lang.Array) or arg.element_type not in _ELEMENT_TYPES:
+            return False
+        try:
+            [int(s) for s in arg.shape]
+        except (TypeError, ValueError):
+            return False
+    return True
+
+
+def _get_num_bytes(arg: lang.Array) -> int:
+    # an array with a blocked layout is passed as its blocks
+    shape = arg._blocked_layout.get_physical_shape(arg.shape) if arg._blocked_layout else arg.shape
+    return reduce(lambda x, y: x * y, (int(s) for s in shape), 1) * _ELEMENT_BYTES[arg.element_type]
+
+
+def generate_module(module_name: str, fns: List[lang.Function]) -> str:
+    """Generates the source of a Python extension module with a function for each function of the package, which gets
+    the buffers of its arguments and calls the function with the GIL released. The arguments are positional, and the
+    only checks of a call are the number of arguments, their sizes in bytes and the writability of the buffers that the
+    function writes to."""
+
+    lines = [_MODULE_PROLOGUE]
+    lines.append('extern "C" {')
+    for fn in fns:
+        lines.append(f"void {fn.name}({', '.join(['void*'] * len(fn.requested_args))});")
+    lines.append("}")
+    lines.append("")
+    lines.append("namespace")
+    lines.append("{")
+
+    for fn in fns:
+        num_args = len(fn.requested_args)
+        lines.append(f"PyObject* Call_{fn.name}(PyObject*, PyObject* const* args, Py_ssize_t nargs)")
+        lines.append("{")
+        lines.append(f"    if (nargs != {num_args})")
+        lines.append("    {")
+        lines.append(
+            f'        PyErr_Format(PyExc_TypeError, "{fn.name}() takes {num_args} arguments (%zd given)", nargs);'
+        )
+        lines.append("        return nullptr;")
+        lines.append("    }")
+        lines.append(f"    Buffers<{max(num_args, 1)}> buffers;")
+        for index, arg in enumerate(fn.requested_args):
+            writable = "false" if arg.role == lang.Array.Role.INPUT else "true"
+            lines.append(
+                f'    auto arg{index} = buffers.Get(args[{index}], "{fn.name}", {index}, {_get_num_bytes(arg)}, {writable});'
+            )
+            lines.append(f"    if (!arg{index}) return nullptr;")
+        call_args = ", ".join(f"arg{index}" for index in range(num_args))
+        lines.append("    Py_BEGIN_ALLOW_THREADS")
+        lines.append(f"    {fn.name}({call_args});")
+        lines.append("    Py_END_ALLOW_THREADS")
+        lines.append("    Py_RETURN_NONE;")
+        lines.append("}")
+        lines.append("")
+
+    lines.append("PyMethodDef methods[] = {")
+    for fn in fns:
+        lines.append(
+            f'    {{ "{fn.name}", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(Call_{fn.name})), '
+            f'METH_FASTCALL, "Calls {fn.name} of the package" }},'
+        )
+    lines.append("    { nullptr, nullptr, 0, nullptr }")
+    lines.append("};")
+    lines.append("")
+    lines.append(f'PyModuleDef moduleDef = {{ PyModuleDef_HEAD_INIT, "{module_name}", nullptr, -1, methods }};')
+    lines.append("} // namespace")
+    lines.append("")
+    lines.append(f'extern "C" PyMODINIT_FUNC PyInit_{module_name}(void)')
+    lines.append("{")
+    lines.append("    return PyModule_Create(&moduleDef);")
+    lines.append("}")
+    return "\n".join(lines) + "\n"
+
+
+def get_module_path(output_dir: str, module_name: str) -> str:
+    "The path of the extension module, with the suffix that the running interpreter imports extension modules from"
+    return os.path.join(output_dir, module_name + sysconfig.get_config_var("EXT_SUFFIX"))
+
+
+def compile_module(source_path: str, module_path: str, library_path: str, quiet: bool = True):
+    "Compiles the extension module and links it against the package library, which it loads from its own directory"
+
+    include_dir = sysconfig.get_paths()["include"]
+    compiler = _find_compiler()
+    if os.path.splitext(os.path.basename(compiler))[0].lower() == "cl":
+        # the import library of the package DLL, and the library of the interpreter
+        python_libs = os.path.join(sysconfig.get_config_var("installed_base"), "libs")
+        command = [
+            compiler, "/nologo", "/O2", "/EHsc", "/std:c++17", "/LD", f"/I{include_dir}", source_path,
+            f"/Fe{module_path}", os.path.splitext(library_path)[0] + ".lib", "/link", f"/LIBPATH:{python_libs}"
+        ]
+    else:
+        command = [compiler, "-O2", "-std=c++17", "-shared", "-fPIC", f"-I{include_dir}", source_path, "-o", module_path]
+        if sys.platform == "darwin":
+            # the symbols of the interpreter are resolved when the module is loaded
+            command += [library_path, "-undefined", "dynamic_lookup", "-Wl,-rpath,@loader_path"]
+        else:
+            # linked by file name rather than by path, so that the package can be moved
+            command += [f"-L{os.path.dirname(library_path)}", f"-l:{os.path.basename(library_path)}", "-Wl,-rpath,$ORIGIN"]
+    subprocess.run(command, check=True, capture_output=quiet)
@@ -4,11 +4,15 @@
 ####################################################################################################
 
 import copy
-from typing import List, Union
+import os
+import platform
+import re
+from functools import lru_cache
+from typing import List, Optional, Union
 from dataclasses import dataclass, field, fields
 from enum import Enum, auto
 from ._lang_python import ScalarType
-from ._lang_python._lang import (BLOCK_X, BLOCK_Y, BLOCK_Z, THREAD_X, THREAD_Y, THREAD_Z, _MemorySpace, _ExecutionRuntime as Runtime)
+from ._lang_python._lang import (BLOCK_X, BLOCK_Y, BLOCK_Z, THREAD_X, THREAD_Y, THREAD_Z, DEVICE, _MemorySpace, _ExecutionRuntime as Runtime)
 
 
 class Category(Enum):
@@ -16,17 +20,26 @@ class Category(Enum):
     GPU = auto()
 
 
+class CacheLevel(Enum):
+    "Levels of the memory hierarchy that caches are sized against: the registers of a GPU thread, the levels of the CPU cache hierarchy, indexing Target.cache_sizes, and the shared memory of a GPU block"
+    REGISTERS = 0
+    L1 = 1
+    L2 = 2
+    L3 = 3
+    SHARED = 4
+
+
 class Architecture(Enum):
     HOST = auto()
     ARM = auto()
     X86 = auto()
     X86_64 = auto()
-    # AARCH64 = auto()
+    AARCH64 = auto()
 
 
 # Branding is currently unused
 KNOWN_CPUS_HEADER = \
-    ["Model", "Family", "Branding", "Base Freq", "Turbo Freq", "Cores", "Threads", "Cache Lines", "Cache Sizes", "Vector Bytes", "Vector Registers", "Extensions", "ISA", "Runtime"]
+    ["Model", "Family", "Branding", "Base Freq", "Turbo Freq", "Cores", "Threads", "Cache Sizes", "Cache Lines", "Vector Bytes", "Vector Registers", "Extensions", "ISA", "Runtime"]
 
 # yapf: disable
 KNOWN_CPUS = [
@@ -252,73 +265,78 @@ KNOWN_CPUS = [
     # Intel Rocket Lake
     # https://en.wikipedia.org/wiki/Rocket_Lake
     # Desktop processors
-    ["Intel 11600T",  "Rocket Lake", "Core i5", 1.7, {**{i+1:3.5 for i in range(6)}, **{1: 4.1},          }, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 11600KF", "Rocket Lake", "Core i5", 3.9, {**{i+1:4.6 for i in range(6)}, **{1: 4.9},          }, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 11600K",  "Rocket Lake", "Core i5", 3.9, {**{i+1:4.6 for i in range(6)}, **{1: 4.9},          }, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 11600",   "Rocket Lake", "Core i5", 2.8, {**{i+1:4.3 for i in range(6)}, **{1: 4.8},          }, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 11500T",  "Rocket Lake", "Core i5", 1.5, {**{i+1:3.4 for i in range(6)}, **{1: 3.9},          }, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 11500",   "Rocket Lake", "Core i5", 2.7, {**{i+1:4.2 for i in range(6)}, **{1: 4.6},          }, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 11400T",  "Rocket Lake", "Core i5", 1.3, {**{i+1:3.3 for i in range(6)}, **{1: 3.7},          }, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 11400F",  "Rocket Lake", "Core i5", 2.6, {**{i+1:4.2 for i in range(6)}, **{1: 4.4},          }, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 11400",   "Rocket Lake", "Core i5", 2.6, {**{i+1:4.2 for i in range(6)}, **{1: 4.4},          }, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 11700T",  "Rocket Lake", "Core i7", 1.4, {**{i+1:3.6 for i in range(8)}, **{1: 4.5}, **{2: 4.6}}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 11700KF", "Rocket Lake", "Core i7", 3.6, {**{i+1:4.6 for i in range(8)}, **{1: 4.9}, **{2: 5.0}}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 11700K",  "Rocket Lake", "Core i7", 3.6, {**{i+1:4.6 for i in range(8)}, **{1: 4.9}, **{2: 5.0}}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 11700F",  "Rocket Lake", "Core i7", 2.5, {**{i+1:4.4 for i in range(8)}, **{1: 4.8}, **{2: 4.9}}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 11700",   "Rocket Lake", "Core i7", 2.5, {**{i+1:4.4 for i in range(8)}, **{1: 4.8}, **{2: 4.9}}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 11900T",  "Rocket Lake", "Core i9", 1.5, {**{i+1:3.7 for i in range(8)}, **{1: 4.8}, **{2: 4.9}}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 11900KF", "Rocket Lake", "Core i9", 3.5, {**{i+1:4.8 for i in range(8)}, **{1: 5.1}, **{2: 5.2}}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 11900K",  "Rocket Lake", "Core i9", 3.5, {**{i+1:4.8 for i in range(8)}, **{1: 5.1}, **{2: 5.2}}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 11900F",  "Rocket Lake", "Core i9", 2.5, {**{i+1:4.7 for i in range(8)}, **{1: 5.0}, **{2: 5.1}}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 11900",   "Rocket Lake", "Core i9", 2.5, {**{i+1:4.7 for i in range(8)}, **{1: 5.0}, **{2: 5.1}}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
+    ["Intel 11600T",  "Rocket Lake", "Core i5", 1.7, {**{i+1:3.5 for i in range(6)}, **{1: 4.1},          }, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 11600KF", "Rocket Lake", "Core i5", 3.9, {**{i+1:4.6 for i in range(6)}, **{1: 4.9},          }, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 11600K",  "Rocket Lake", "Core i5", 3.9, {**{i+1:4.6 for i in range(6)}, **{1: 4.9},          }, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 11600",   "Rocket Lake", "Core i5", 2.8, {**{i+1:4.3 for i in range(6)}, **{1: 4.8},          }, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 11500T",  "Rocket Lake", "Core i5", 1.5, {**{i+1:3.4 for i in range(6)}, **{1: 3.9},          }, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 11500",   "Rocket Lake", "Core i5", 2.7, {**{i+1:4.2 for i in range(6)}, **{1: 4.6},          }, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 11400T",  "Rocket Lake", "Core i5", 1.3, {**{i+1:3.3 for i in range(6)}, **{1: 3.7},          }, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 11400F",  "Rocket Lake", "Core i5", 2.6, {**{i+1:4.2 for i in range(6)}, **{1: 4.4},          }, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 11400",   "Rocket Lake", "Core i5", 2.6, {**{i+1:4.2 for i in range(6)}, **{1: 4.4},          }, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 11700T",  "Rocket Lake", "Core i7", 1.4, {**{i+1:3.6 for i in range(8)}, **{1: 4.5}, **{2: 4.6}}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 11700KF", "Rocket Lake", "Core i7", 3.6, {**{i+1:4.6 for i in range(8)}, **{1: 4.9}, **{2: 5.0}}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 11700K",  "Rocket Lake", "Core i7", 3.6, {**{i+1:4.6 for i in range(8)}, **{1: 4.9}, **{2: 5.0}}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 11700F",  "Rocket Lake", "Core i7", 2.5, {**{i+1:4.4 for i in range(8)}, **{1: 4.8}, **{2: 4.9}}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 11700",   "Rocket Lake", "Core i7", 2.5, {**{i+1:4.4 for i in range(8)}, **{1: 4.8}, **{2: 4.9}}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 11900T",  "Rocket Lake", "Core i9", 1.5, {**{i+1:3.7 for i in range(8)}, **{1: 4.8}, **{2: 4.9}}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 11900KF", "Rocket Lake", "Core i9", 3.5, {**{i+1:4.8 for i in range(8)}, **{1: 5.1}, **{2: 5.2}}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 11900K",  "Rocket Lake", "Core i9", 3.5, {**{i+1:4.8 for i in range(8)}, **{1: 5.1}, **{2: 5.2}}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 11900F",  "Rocket Lake", "Core i9", 2.5, {**{i+1:4.7 for i in range(8)}, **{1: 5.0}, **{2: 5.1}}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 11900",   "Rocket Lake", "Core i9", 2.5, {**{i+1:4.7 for i in range(8)}, **{1: 5.0}, **{2: 5.1}}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
 
     # Workstation processors
-    ["Intel W-1350",  "Rocket Lake", "Xeon W", 3.3, {i+1:5.0 for i in range(6)}, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel W-1350P", "Rocket Lake", "Xeon W", 4.0, {i+1:5.1 for i in range(6)}, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel W-1370",  "Rocket Lake", "Xeon W", 2.9, {i+1:5.1 for i in range(8)}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel W-1370P", "Rocket Lake", "Xeon W", 3.6, {i+1:5.2 for i in range(8)}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel W-1390",  "Rocket Lake", "Xeon W", 2.8, {i+1:5.2 for i in range(8)}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel W-1390P", "Rocket Lake", "Xeon W", 3.5, {i+1:5.3 for i in range(8)}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel W-1390T", "Rocket Lake", "Xeon W", 1.5, {i+1:4.9 for i in range(8)}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
+    ["Intel W-1350",  "Rocket Lake", "Xeon W", 3.3, {i+1:5.0 for i in range(6)}, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel W-1350P", "Rocket Lake", "Xeon W", 4.0, {i+1:5.1 for i in range(6)}, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel W-1370",  "Rocket Lake", "Xeon W", 2.9, {i+1:5.1 for i in range(8)}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel W-1370P", "Rocket Lake", "Xeon W", 3.6, {i+1:5.2 for i in range(8)}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel W-1390",  "Rocket Lake", "Xeon W", 2.8, {i+1:5.2 for i in range(8)}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel W-1390P", "Rocket Lake", "Xeon W", 3.5, {i+1:5.3 for i in range(8)}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel W-1390T", "Rocket Lake", "Xeon W", 1.5, {i+1:4.9 for i in range(8)}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
 
     # Server processors
-    ["Intel 2314",  "Rocket Lake", "Xeon E", 2.8, {1: 4.5}, 4, 4, [48, 512, 8 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 2324G", "Rocket Lake", "Xeon E", 3.1, {1: 4.6}, 4, 4, [48, 512, 8 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 2334",  "Rocket Lake", "Xeon E", 3.4, {1: 4.8}, 4, 8, [48, 512, 8 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 2336",  "Rocket Lake", "Xeon E", 2.9, {1: 4.8}, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 2356G", "Rocket Lake", "Xeon E", 3.2, {1: 5.0}, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 2374G", "Rocket Lake", "Xeon E", 3.7, {1: 5.0}, 4, 8, [48, 512, 8 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 2378",  "Rocket Lake", "Xeon E", 2.6, {1: 4.8}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 2378G", "Rocket Lake", "Xeon E", 2.8, {1: 5.1}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 2386G", "Rocket Lake", "Xeon E", 3.5, {1: 5.1}, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 2388G", "Rocket Lake", "Xeon E", 3.2, {1: 5.1}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
+    ["Intel 2314",  "Rocket Lake", "Xeon E", 2.8, {1: 4.5}, 4, 4, [48, 512, 8 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 2324G", "Rocket Lake", "Xeon E", 3.1, {1: 4.6}, 4, 4, [48, 512, 8 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 2334",  "Rocket Lake", "Xeon E", 3.4, {1: 4.8}, 4, 8, [48, 512, 8 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 2336",  "Rocket Lake", "Xeon E", 2.9, {1: 4.8}, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 2356G", "Rocket Lake", "Xeon E", 3.2, {1: 5.0}, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 2374G", "Rocket Lake", "Xeon E", 3.7, {1: 5.0}, 4, 8, [48, 512, 8 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 2378",  "Rocket Lake", "Xeon E", 2.6, {1: 4.8}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 2378G", "Rocket Lake", "Xeon E", 2.8, {1: 5.1}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 2386G", "Rocket Lake", "Xeon E", 3.5, {1: 5.1}, 6, 12, [48, 512, 12 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 2388G", "Rocket Lake", "Xeon E", 3.2, {1: 5.1}, 8, 16, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
 
     # Intel Ice Lake
     # ref: https://en.wikipedia.org/wiki/Ice_Lake_(microprocessor)
     # ref: https://en.wikichip.org/wiki/intel/microarchitectures/ice_lake_(client)
-    ["Intel 1000G1", "Ice Lake", "Core i3", 1.1, {1: 3.2, 2: 3.2       }, 2, 4, [48, 512, 2 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX-VNNI"], "X86_64", "OPENMP"],
-    ["Intel 1000G4", "Ice Lake", "Core i3", 1.1, {1: 3.2, 2: 3.2       }, 2, 4, [48, 512, 2 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX-VNNI"], "X86_64", "OPENMP"],
-    ["Intel 1005G1", "Ice Lake", "Core i3", 1.2, {1: 3.4, 2: 3.4       }, 2, 4, [48, 512, 2 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX-VNNI"], "X86_64", "OPENMP"],
-    ["Intel 1030G4", "Ice Lake", "Core i5", 0.7, {1: 3.5,        4: 3.2}, 4, 8, [48, 512, 2 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX-VNNI"], "X86_64", "OPENMP"],
-    ["Intel 1030G7", "Ice Lake", "Core i5", 0.8, {1: 3.5,        4: 3.2}, 4, 8, [48, 512, 2 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX-VNNI"], "X86_64", "OPENMP"],
-    ["Intel 1035G1", "Ice Lake", "Core i5", 1.0, {1: 3.6,        4: 3.3}, 4, 8, [48, 512, 2 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX-VNNI"], "X86_64", "OPENMP"],
-    ["Intel 1035G4", "Ice Lake", "Core i5", 1.1, {1: 3.7,        4: 3.3}, 4, 8, [48, 512, 2 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX-VNNI"], "X86_64", "OPENMP"],
-    ["Intel 1035G7", "Ice Lake", "Core i5", 1.2, {1: 3.7,        4: 3.3}, 4, 8, [48, 512, 2 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX-VNNI"], "X86_64", "OPENMP"],
-    ["Intel 1060G7", "Ice Lake", "Core i7", 1.0, {1: 3.8,        4: 3.4}, 4, 8, [48, 512, 2 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX-VNNI"], "X86_64", "OPENMP"],
-    ["Intel 1065G7", "Ice Lake", "Core i7", 1.3, {1: 3.9, 2: 3.8, 4: 3.5}, 4, 8, [48, 512, 2 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX-VNNI"], "X86_64", "OPENMP"],
-    ["Intel 1068G7", "Ice Lake", "Core i7", 2.3, {1: 4.1,        4: 3.6}, 4, 8, [48, 512, 2 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX-VNNI"], "X86_64", "OPENMP"],
-
-    ["Intel 8351N", "Ice Lake", "Xeon Platinum", 2.40, {36: 3.10}, 36, 72, [48, 512, 54 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX-VNNI"], "X86_64", "OPENMP"],
-    ["Intel 8352S", "Ice Lake", "Xeon Platinum", 2.20, {32: 2.80}, 32, 64, [48, 512, 48 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX-VNNI"], "X86_64", "OPENMP"],
-    ["Intel 8352V", "Ice Lake", "Xeon Platinum", 2.10, {36: 2.50}, 36, 72, [48, 512, 54 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX-VNNI"], "X86_64", "OPENMP"],
-    ["Intel 8352Y", "Ice Lake", "Xeon Platinum", 2.20, {32: 2.80}, 32, 64, [48, 512, 48 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX-VNNI"], "X86_64", "OPENMP"],
-    ["Intel 8358",  "Ice Lake", "Xeon Platinum", 2.60, {32: 3.30}, 32, 64, [48, 512, 48 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX-VNNI"], "X86_64", "OPENMP"],
-    ["Intel 8358P", "Ice Lake", "Xeon Platinum", 2.60, {32: 3.20}, 32, 64, [48, 512, 48 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX-VNNI"], "X86_64", "OPENMP"],
-    ["Intel 8360Y", "Ice Lake", "Xeon Platinum", 2.40, {36: 3.10}, 36, 72, [48, 512, 54 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX-VNNI"], "X86_64", "OPENMP"],
-    ["Intel 8362",  "Ice Lake", "Xeon Platinum", 2.80, {32: 3.50}, 32, 64, [48, 512, 48 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX-VNNI"], "X86_64", "OPENMP"],
-    ["Intel 8368",  "Ice Lake", "Xeon Platinum", 2.40, {38: 3.20}, 38, 76, [48, 512, 57 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX-VNNI"], "X86_64", "OPENMP"],
-    ["Intel 8368Q", "Ice Lake", "Xeon Platinum", 2.60, {38: 3.30}, 38, 76, [48, 512, 57 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX-VNNI"], "X86_64", "OPENMP"],
-    ["Intel 8380",  "Ice Lake", "Xeon Platinum", 2.30, {40: 3.00}, 40, 80, [48, 512, 60 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX-VNNI"], "X86_64", "OPENMP"],
+    ["Intel 1000G1", "Ice Lake", "Core i3", 1.1, {1: 3.2, 2: 3.2       }, 2, 4, [48, 512, 2 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI"], "X86_64", "OPENMP"],
+    ["Intel 1000G4", "Ice Lake", "Core i3", 1.1, {1: 3.2, 2: 3.2       }, 2, 4, [48, 512, 2 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI"], "X86_64", "OPENMP"],
+    ["Intel 1005G1", "Ice Lake", "Core i3", 1.2, {1: 3.4, 2: 3.4       }, 2, 4, [48, 512, 2 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI"], "X86_64", "OPENMP"],
+    ["Intel 1030G4", "Ice Lake", "Core i5", 0.7, {1: 3.5,        4: 3.2}, 4, 8, [48, 512, 2 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI"], "X86_64", "OPENMP"],
+    ["Intel 1030G7", "Ice Lake", "Core i5", 0.8, {1: 3.5,        4: 3.2}, 4, 8, [48, 512, 2 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI"], "X86_64", "OPENMP"],
+    ["Intel 1035G1", "Ice Lake", "Core i5", 1.0, {1: 3.6,        4: 3.3}, 4, 8, [48, 512, 2 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI"], "X86_64", "OPENMP"],
+    ["Intel 1035G4", "Ice Lake", "Core i5", 1.1, {1: 3.7,        4: 3.3}, 4, 8, [48, 512, 2 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI"], "X86_64", "OPENMP"],
+    ["Intel 1035G7", "Ice Lake", "Core i5", 1.2, {1: 3.7,        4: 3.3}, 4, 8, [48, 512, 2 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI"], "X86_64", "OPENMP"],
+    ["Intel 1060G7", "Ice Lake", "Core i7", 1.0, {1: 3.8,        4: 3.4}, 4, 8, [48, 512, 2 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI"], "X86_64", "OPENMP"],
+    ["Intel 1065G7", "Ice Lake", "Core i7", 1.3, {1: 3.9, 2: 3.8, 4: 3.5}, 4, 8, [48, 512, 2 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI"], "X86_64", "OPENMP"],
+    ["Intel 1068G7", "Ice Lake", "Core i7", 2.3, {1: 4.1,        4: 3.6}, 4, 8, [48, 512, 2 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI"], "X86_64", "OPENMP"],
+
+    ["Intel 8351N", "Ice Lake", "Xeon Platinum", 2.40, {36: 3.10}, 36, 72, [48, 512, 54 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI"], "X86_64", "OPENMP"],
+    ["Intel 8352S", "Ice Lake", "Xeon Platinum", 2.20, {32: 2.80}, 32, 64, [48, 512, 48 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI"], "X86_64", "OPENMP"],
+    ["Intel 8352V", "Ice Lake", "Xeon Platinum", 2.10, {36: 2.50}, 36, 72, [48, 512, 54 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI"], "X86_64", "OPENMP"],
+    ["Intel 8352Y", "Ice Lake", "Xeon Platinum", 2.20, {32: 2.80}, 32, 64, [48, 512, 48 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI"], "X86_64", "OPENMP"],
+    ["Intel 8358",  "Ice Lake", "Xeon Platinum", 2.60, {32: 3.30}, 32, 64, [48, 512, 48 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI"], "X86_64", "OPENMP"],
+    ["Intel 8358P", "Ice Lake", "Xeon Platinum", 2.60, {32: 3.20}, 32, 64, [48, 512, 48 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI"], "X86_64", "OPENMP"],
+    ["Intel 8360Y", "Ice Lake", "Xeon Platinum", 2.40, {36: 3.10}, 36, 72, [48, 512, 54 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI"], "X86_64", "OPENMP"],
+    ["Intel 8362",  "Ice Lake", "Xeon Platinum", 2.80, {32: 3.50}, 32, 64, [48, 512, 48 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI"], "X86_64", "OPENMP"],
+    ["Intel 8368",  "Ice Lake", "Xeon Platinum", 2.40, {38: 3.20}, 38, 76, [48, 512, 57 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI"], "X86_64", "OPENMP"],
+    ["Intel 8368Q", "Ice Lake", "Xeon Platinum", 2.60, {38: 3.30}, 38, 76, [48, 512, 57 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI"], "X86_64", "OPENMP"],
+    ["Intel 8380",  "Ice Lake", "Xeon Platinum", 2.30, {40: 3.00}, 40, 80, [48, 512, 60 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI"], "X86_64", "OPENMP"],
+
+    # Intel Sapphire Rapids
+    # ref: https://en.wikichip.org/wiki/intel/microarchitectures/sapphire_rapids
+    ["Intel 8468",  "Sapphire Rapids", "Xeon Platinum", 2.10, {48: 3.10}, 48, 96,  [48, 2 * 1024, 105 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI", "AVX512BF16", "AVX512FP16", "AMX-TILE", "AMX-INT8", "AMX-BF16"], "X86_64", "OPENMP"],
+    ["Intel 8490H", "Sapphire Rapids", "Xeon Platinum", 1.90, {60: 2.90}, 60, 120, [48, 2 * 1024, 112.5 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI", "AVX-VNNI", "AVX512BF16", "AVX512FP16", "AMX-TILE", "AMX-INT8", "AMX-BF16"], "X86_64", "OPENMP"],
 
     # Intel Cascade Lake
     # ref: https://en.wikipedia.org/wiki/Cascade_Lake_(microarchitecture)
@@ -422,14 +440,14 @@ KNOWN_CPUS = [
     ["Intel 11100B",  "Tiger Lake", "Core i3", 3.6, 4.4, 4, 8,  [48, 512, 16 * 1024], [64, 64, 64], 32, 16, ["SSE4.1", "SSE4.2", "AVX2"], "X86_64", "OPENMP"],
 
     # Mobile processors
-    ["Intel 1195G7",  "Tiger Lake", "Core i7", 2.9, 5.0, 4, 8, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 1185G7",  "Tiger Lake", "Core i7", 3.0, 4.8, 4, 8, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 1165G7",  "Tiger Lake", "Core i7", 2.8, 4.7, 4, 8, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 1155G7",  "Tiger Lake", "Core i5", 2.5, 4.5, 4, 8,  [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 1145G7",  "Tiger Lake", "Core i5", 2.6, 4.4, 4, 8,  [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 1135G7",  "Tiger Lake", "Core i5", 2.4, 4.2, 4, 8,  [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 1125G7",  "Tiger Lake", "Core i3", 2.0, 3.7, 4, 8,  [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
-    ["Intel 1115G7",  "Tiger Lake", "Core i3", 3.0, 4.1, 2, 4,  [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512"], "X86_64", "OPENMP"],
+    ["Intel 1195G7",  "Tiger Lake", "Core i7", 2.9, 5.0, 4, 8, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 1185G7",  "Tiger Lake", "Core i7", 3.0, 4.8, 4, 8, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 1165G7",  "Tiger Lake", "Core i7", 2.8, 4.7, 4, 8, [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 1155G7",  "Tiger Lake", "Core i5", 2.5, 4.5, 4, 8,  [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 1145G7",  "Tiger Lake", "Core i5", 2.6, 4.4, 4, 8,  [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 1135G7",  "Tiger Lake", "Core i5", 2.4, 4.2, 4, 8,  [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 1125G7",  "Tiger Lake", "Core i3", 2.0, 3.7, 4, 8,  [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
+    ["Intel 1115G7",  "Tiger Lake", "Core i3", 3.0, 4.1, 2, 4,  [48, 512, 16 * 1024], [64, 64, 64], 64, 32, ["SSE4.1", "SSE4.2", "AVX2", "AVX512", "AVX512VBMI"], "X86_64", "OPENMP"],
     ["Intel 7505",    "Tiger Lake", "Pentium Gold", 2.0, 3.5, 2, 4,  [48, 512, 16 * 1024], [64, 64, 64], 32, 16, ["SSE4.1", "SSE4.2", "AVX2"], "X86_64", "OPENMP"],
     ["Intel 6035",    "Tiger Lake", "Celeron", 1.8, 0.0, 2, 2,  [48, 512, 16 * 1024], [64, 64, 64], 32, 16, ["SSE4.1", "SSE4.2", "AVX2"], "X86_64", "OPENMP"],
 
@@ -705,8 +723,19 @@ KNOWN_CPUS = [
     # ref: https://patchwork.kernel.org/project/linux-arm-kernel/patch/20211221224830.16746-1-rs@noreya.tech/
     ["Raspberry Pi 4B", "Pi4", "Broadcom BCM2711", 1.5, {}, 4, 8, [32, 1024], [64, 64], 0, 0, [], "ARM", "OPENMP"],
 
-    ["ARM Cortex-M4", "Cortex-M4", "ARM Cortex-M4", .008, {}, 1, 1, [], [], 0, 0, [], "ARM", ""],
-    ["ARM Cortex-M4F", "Cortex-M4", "ARM Cortex-M4F", .008, {}, 1, 1, [], [], 0, 0, ["fpu"], "ARM", ""],
+    ["ARM Cortex-M4", "Cortex-M4", "ARM Cortex-M4", .008, {}, 1, 1, [], [], 0, 0, ["DSP"], "ARM", ""],
+    ["ARM Cortex-M4F", "Cortex-M4", "ARM Cortex-M4F", .008, {}, 1, 1, [], [], 0, 0, ["DSP", "fpu"], "ARM", ""],
+
+    # AArch64 servers
+    # ref: https://en.wikichip.org/wiki/arm_holdings/microarchitectures/neoverse_n1
+    ["AWS Graviton2", "Neoverse-N1", "Graviton2", 2.5, {}, 64, 64, [64, 1024, 32 * 1024], [64, 64, 64], 16, 32, ["NEON", "DOTPROD", "FP16"], "AARCH64", "OPENMP"],
+    ["Ampere Altra Q80-30", "Neoverse-N1", "Altra", 3.0, {}, 80, 80, [64, 1024, 32 * 1024], [64, 64, 64], 16, 32, ["NEON", "DOTPROD", "FP16"], "AARCH64", "OPENMP"],
+    # ref: https://en.wikichip.org/wiki/arm_holdings/microarchitectures/neoverse_v1
+    ["AWS Graviton3", "Neoverse-V1", "Graviton3", 2.6, {}, 64, 64, [64, 1024, 32 * 1024], [64, 64, 64], 32, 32, ["NEON", "DOTPROD", "FP16", "BF16", "SVE"], "AARCH64", "OPENMP"], # 256-bit SVE vectors
+
+    # Apple silicon, performance cores
+    # ref: https://en.wikipedia.org/wiki/Apple_M1
+    ["Apple M1", "Apple-M1", "M1", 3.2, {}, 8, 8, [128, 12 * 1024], [128, 128], 16, 32, ["NEON", "DOTPROD", "FP16"], "AARCH64", "OPENMP"], # 4 performance + 4 efficiency cores
 ]
 # yapf: enable
 
@@ -741,18 +770,30 @@ MI100_TENSORCORE_INFO = TensorCoreInformation([
     TensorCoreInformationEntry(input_type=ScalarType.float32, output_type=ScalarType.float32, shape=[4,16,64]) # maps to the 16x16x1 mfma instruction
 ])
 
+# The 16x16x16 tiles are computed with the m16n16k16 WMMA instructions, one warp per tile
+NVIDIA_VOLTA_TENSORCORE_INFO = TensorCoreInformation([
+    TensorCoreInformationEntry(input_type=ScalarType.float16, output_type=ScalarType.float16, shape=[2,2,16]), # maps to the 16x16x16 wmma instruction
+    TensorCoreInformationEntry(input_type=ScalarType.float16, output_type=ScalarType.float32, shape=[2,2,16]), # maps to the 16x16x16 wmma instruction
+])
+
+NVIDIA_AMPERE_TENSORCORE_INFO = TensorCoreInformation(NVIDIA_VOLTA_TENSORCORE_INFO.entries + [
+    TensorCoreInformationEntry(input_type=ScalarType.bfloat16, output_type=ScalarType.float32, shape=[2,2,16]), # maps to the 16x16x16 wmma instruction
+])
+
 # Tensor Cores is current unused
-KNOWN_GPUS_HEADER = ["Runtime", "Model", "Branding", "Family", "Cores", "MaxThreadsPerBlock", "MaxBlockSize", "MaxSharedMemoryPerBlock", "WarpSize", "Base Freq", "MaxRegistersPerBlock", "TensorCoreInformation"]
+KNOWN_GPUS_HEADER = ["Runtime", "Model", "Branding", "Family", "Cores", "MaxThreadsPerBlock", "MaxBlockSize", "MaxSharedMemoryPerBlock", "WarpSize", "Base Freq", "MaxRegistersPerBlock", "MaxThreadsPerMultiprocessor", "TensorCoreInformation"]
 KNOWN_GPUS = [
     # NVIDIA
-    ["CUDA", "NVidia P100", "Pascal", "sm60",  56, 1024, [1024, 1024, 64], 49152, 32, 1.328500, 65536, None],
-    ["CUDA", "NVidia V100", "Volta",  "sm70",  80, 1024, [1024, 1024, 64], 49152, 32, 1.380000, 65536, None],
-    ["CUDA", "NVidia A100", "Ampere", "sm80", 108, 1024, [1024, 1024, 64], 49152, 32, 1.410000, 65536, None],
+    ["CUDA", "NVidia P100", "Pascal", "sm60",  56, 1024, [1024, 1024, 64], 49152, 32, 1.328500, 65536, 2048, None],
+    ["CUDA", "NVidia V100", "Volta",  "sm70",  80, 1024, [1024, 1024, 64], 49152, 32, 1.380000, 65536, 2048, NVIDIA_VOLTA_TENSORCORE_INFO],
+    ["CUDA", "NVidia A100", "Ampere", "sm80", 108, 1024, [1024, 1024, 64], 49152, 32, 1.410000, 65536, 2048, NVIDIA_AMPERE_TENSORCORE_INFO],
     # AMD
-    ["ROCM", "AMD Radeon7", "Vega20",    "gfx906", 60,  1024, [1024, 1024, 1024], 65536, 64, 1.801000, 65536, None],
-    ["ROCM", "AMD MI50",    "Vega20",    "gfx906", 60,  1024, [1024, 1024, 1024], 65536, 64, 1.725000, 65536, None],
-    ["ROCM", "AMD MI100",   "Arcturus",  "gfx908", 120, 1024, [1024, 1024, 1024], 65536, 64, 1.502000, 65536, MI100_TENSORCORE_INFO],
-    ["ROCM", "AMD MI200",   "Aldebaran", "gfx90a", 220, 1024, [1024, 1024, 1024], 65536, 64, 1.700000, 65536, None]
+    ["ROCM", "AMD Radeon7", "Vega20",    "gfx906", 60,  1024, [1024, 1024, 1024], 65536, 64, 1.801000, 65536, 2560, None],
+    ["ROCM", "AMD MI50",    "Vega20",    "gfx906", 60,  1024, [1024, 1024, 1024], 65536, 64, 1.725000, 65536, 2560, None],
+    ["ROCM", "AMD MI100",   "Arcturus",  "gfx908", 120, 1024, [1024, 1024, 1024], 65536, 64, 1.502000, 65536, 2560, MI100_TENSORCORE_INFO],
+    ["ROCM", "AMD MI200",   "Aldebaran", "gfx90a", 220, 1024, [1024, 1024, 1024], 65536, 64, 1.700000, 65536, 2560, None],
+    # Arm (OpenCL C kernels)
+    ["OPENCL", "ARM Mali-G78", "Valhall", "mali-g78", 24, 512, [512, 512, 512], 32768, 16, 0.848000, 65536, 1024, None]
 ]
 # yapf: enable
 
@@ -780,7 +821,7 @@ class _TargetContainer:
     max_block_size: List[int] = field(default_factory=list)
     max_shared_memory_per_block: int = 0
     max_registers_per_block: int = 0
-
+    max_threads_per_multiprocessor: int = 0
 
     _device_name: str = "host"    # used internally for emitting known targets
 
@@ -805,11 +846,56 @@ class _TargetContainer:
         self._max_vector_bytes = self.vector_bytes
         self._max_vector_registers = self.vector_registers
 
+    def peak_gflops(self, element_bytes: int = 4, num_cores: int = None) -> Optional[float]:
+        """The peak floating point throughput of the target on vectors of elements of the given size, counting a fused
+        multiply-add as two operations, or None when its frequency or cores are unknown. A core is assumed to issue
+        two vector instructions per cycle: two fused multiply-adds on targets with FMA, or an add and a multiply.
+
+        Args:
+            element_bytes: The size of the elements
+            num_cores: The number of cores that run the code, at the turbo frequency of as many active cores when it
+                is known. Defaults to all the cores of the target.
+        """
+        num_cores = min(num_cores or self.num_cores, self.num_cores)
+        if not self.frequency_GHz or not num_cores:
+            return None
+
+        turbo_cores = [n for n in self.turbo_frequency_GHz if n >= num_cores]
+        frequency_GHz = self.turbo_frequency_GHz[min(turbo_cores)] if turbo_cores else self.frequency_GHz
+        lanes = max(1, self.vector_bytes // element_bytes)
+        has_fma = any(ext in self.extensions for ext in ["FMA3", "AVX512F", "NEON", "SVE"])
+        return frequency_GHz * num_cores * lanes * (4 if has_fma else 2)
+
     @property
     def vectorization_info(self):
-        from ._lang_python._lang import _VectorizationInfo
-
-        return _VectorizationInfo(vector_bytes=self.vector_bytes, vector_units=self.vector_registers, unroll_only=False)
+        from ._lang_python._lang import _VectorizationInfo, _IntegerDotProduct, _TableLookup
+
+        if "AVX-VNNI" in self.extensions:
+            dot_product = _IntegerDotProduct.X86_VNNI
+        elif "DOTPROD" in self.extensions:
+            dot_product = _IntegerDotProduct.ARM_DOT_PRODUCT
+        elif "DSP" in self.extensions:
+            dot_product = _IntegerDotProduct.ARM_DSP
+        else:
+            dot_product = _IntegerDotProduct.NONE
+
+        if "AVX512VBMI" in self.extensions:
+            table_lookup = _TableLookup.X86_VBMI
+        elif "AVX2" in self.extensions:
+            table_lookup = _TableLookup.X86_SHUFFLE
+        elif "NEON" in self.extensions:
+            table_lookup = _TableLookup.ARM_TABLE
+        else:
+            table_lookup = _TableLookup.NONE
+
+        return _VectorizationInfo(
+            vector_bytes=self.vector_bytes,
+            vector_units=self.vector_registers,
+            unroll_only=False,
+            dot_product=dot_product,
+            bfloat16_dot_product="AVX512BF16" in self.extensions,
+            table_lookup=table_lookup
+        )
 
 
 KNOWN_DEVICES = {
@@ -869,6 +955,7 @@ def _recompute_known_devices():
             max_shared_memory_per_block=device["MaxSharedMemoryPerBlock"],
             frequency_GHz=device["Base Freq"],
             max_registers_per_block=device["MaxRegistersPerBlock"],
+            max_threads_per_multiprocessor=device["MaxThreadsPerMultiprocessor"],
             tensor_core=device["TensorCoreInformation"],
         )
         KNOWN_DEVICES[target.category][target.name] = target
@@ -893,6 +980,143 @@ class GridUnits(Enum):
     THREAD_X = THREAD_X
     THREAD_Y = THREAD_Y
     THREAD_Z = THREAD_Z
+    # Partitions the index across the GPUs of the system, see Plan.bind
+    DEVICE = DEVICE
+
+
+# The extensions of the host, keyed by the flags of /proc/cpuinfo on x86-64 and AArch64 Linux
+_X86_HOST_EXTENSIONS = {
+    "mmx": ["MMX"],
+    "sse": ["SSE"],
+    "sse2": ["SSE2"],
+    "pni": ["SSE3"],
+    "ssse3": ["SSSE3"],
+    "sse4_1": ["SSE4", "SSE4.1"],
+    "sse4_2": ["SSE4.2"],
+    "avx": ["AVX"],
+    "avx2": ["AVX2"],
+    "fma": ["FMA3"],
+    "avx512f": ["AVX512", "AVX512F"],
+    "avx512vbmi": ["AVX512VBMI"],
+    "avx512_vnni": ["AVX-VNNI"],
+    "avx_vnni": ["AVX-VNNI"],
+    "avx512_bf16": ["AVX512BF16"],
+    "avx512_fp16": ["AVX512FP16"],
+    "amx_tile": ["AMX-TILE"],
+    "amx_bf16": ["AMX-BF16"],
+    "amx_int8": ["AMX-INT8"],
+}
+
+_AARCH64_HOST_EXTENSIONS = {
+    "asimd": ["NEON"],
+    "asimddp": ["DOTPROD"],
+    "asimdhp": ["FP16"],
+    "sve": ["SVE"],
+    "bf16": ["BF16"],
+    "i8mm": ["I8MM"],
+}
+
+# The HOST defaults when the host can't be inspected
+_DEFAULT_HOST_EXTENSIONS = ["MMX", "SSE", "SSE2", "SSE3", "SSSE3", "SSE4", "SSE4.1", "SSE4.2", "AVX", "AVX2", "FMA3"]
+
+_SYSFS_CPU = "/sys/devices/system/cpu"
+
+
+def _read_sysfs(*path: str) -> Optional[str]:
+    try:
+        with open(os.path.join(_SYSFS_CPU, *path)) as f:
+            return f.read().strip()
+    except OSError:
+        return None
+
+
+def _host_cpu_flags() -> List[str]:
+    "The feature flags of the first processor in /proc/cpuinfo"
+    try:
+        with open("/proc/cpuinfo") as f:
+            for line in f:
+                key, _, value = line.partition(":")
+                if key.strip() in ["flags", "Features"]:
+                    return value.split()
+    except OSError:
+        pass
+    return []
+
+
+def _host_caches():
+    "The sizes (KB) and line sizes (bytes) of the data caches of the first processor, by level"
+    sizes, lines = {}, {}
+    for entry in sorted(os.listdir(os.path.join(_SYSFS_CPU, "cpu0", "cache"))):
+        if not entry.startswith("index") or _read_sysfs("cpu0", "cache", entry, "type") == "Instruction":
+            continue
+        level = _read_sysfs("cpu0", "cache", entry, "level")
+        size = re.fullmatch(r"(\d+)([KMG]?)", _read_sysfs("cpu0", "cache", entry, "size") or "")
+        if not level or not size:
+            continue
+        sizes[int(level)] = int(size.group(1)) * {"": 1 / 1024, "K": 1, "M": 1024, "G": 1024 * 1024}[size.group(2)]
+        lines[int(level)] = int(_read_sysfs("cpu0", "cache", entry, "coherency_line_size") or 64)
+    levels = sorted(sizes)
+    if levels != list(range(1, len(levels) + 1)):
+        return [], []
+    return [sizes[l] for l in levels], [lines[l] for l in levels]
+
+
+def _host_cores(num_threads: int) -> int:
+    "The number of physical cores that the threads available to this process run on"
+    cores = set()
+    for cpu in os.sched_getaffinity(0):
+        package = _read_sysfs(f"cpu{cpu}", "topology", "physical_package_id")
+        core = _read_sysfs(f"cpu{cpu}", "topology", "core_id")
+        if package is None or core is None:
+            return num_threads
+        cores.add((package, core))
+    return len(cores)
+
+
+@lru_cache(maxsize=None)
+def _inspect_host() -> dict:
+    """The characteristics of the host: its cache hierarchy from sysfs, its cores and SMT threads from the CPU
+    topology and its affinity mask, and its instruction set extensions from the CPUID flags in /proc/cpuinfo, so that
+    the heuristics that read Target.HOST match the machine that builds the package. Hosts that can't be inspected, such
+    as non-Linux ones, get the defaults of an AVX2 machine."""
+    host = {
+        "extensions": _DEFAULT_HOST_EXTENSIONS,
+        "num_threads": os.cpu_count() or 0,
+        "vector_bytes": 32,    # There are 32-bytes per full SIMD register
+        "vector_registers": 16,    # There are 16 YMM registers
+    }
+    if platform.system() != "Linux":
+        return host
+
+    try:
+        host["num_threads"] = len(os.sched_getaffinity(0))
+        host["num_cores"] = _host_cores(host["num_threads"])
+        host["cache_sizes"], host["cache_lines"] = _host_caches()
+    except OSError:
+        pass
+
+    base_kHz = _read_sysfs("cpu0", "cpufreq", "base_frequency")
+    max_kHz = _read_sysfs("cpu0", "cpufreq", "cpuinfo_max_freq")
+    if base_kHz:
+        host["frequency_GHz"] = int(base_kHz) / 1e6
+    if max_kHz and (not base_kHz or int(max_kHz) > int(base_kHz)):
+        host["turbo_frequency_GHz"] = {1: int(max_kHz) / 1e6}
+
+    flags = _host_cpu_flags()
+    machine = platform.machine().lower()
+    if machine in ["x86_64", "amd64"] and flags:
+        extensions = [e for flag in flags for e in _X86_HOST_EXTENSIONS.get(flag, [])]
+        host["extensions"] = list(dict.fromkeys(extensions))
+        if "AVX512" in extensions:
+            host["vector_bytes"], host["vector_registers"] = 64, 32
+        elif "AVX" not in extensions:
+            host["vector_bytes"] = 16
+    elif machine in ["aarch64", "arm64"] and flags:
+        extensions = [e for flag in flags for e in _AARCH64_HOST_EXTENSIONS.get(flag, [])]
+        host["extensions"] = list(dict.fromkeys(extensions))
+        host["vector_bytes"], host["vector_registers"] = 16, 32
+
+    return host
 
 
 class Target(_TargetContainer):
@@ -900,6 +1124,7 @@ class Target(_TargetContainer):
 
     Category = Category
     Architecture = Architecture
+    CacheLevel = CacheLevel
     Runtime = Runtime
     Model = Model
 
@@ -932,14 +1157,9 @@ class Target(_TargetContainer):
 
             if known_name == "HOST":
 
+                host = copy.deepcopy(_inspect_host())
                 super().__init__(
-                    category=category or Target.Category.CPU,
-                    architecture=Target.Architecture["HOST"],
-                    vector_bytes=32,    # There are 32-bytes per full SIMD register
-                    vector_registers=16,    # There are 16 YMM registers
-                    extensions=[
-                        "MMX", "SSE", "SSE2", "SSE3", "SSSE3", "SSE4", "SSE4.1", "SSE4.2", "AVX", "AVX2", "FMA3"
-                    ]
+                    category=category or Target.Category.CPU, architecture=Target.Architecture["HOST"], **host
                 )
             else:
 
@@ -984,7 +1204,6 @@ class Target(_TargetContainer):
         self.turbo_frequency_GHz = turbo_frequency_GHz or self.turbo_frequency_GHz
         self.vector_bytes = vector_bytes or self.vector_bytes
         self.vector_registers = vector_registers or self.vector_registers
-        # TODO: inspect target characteristics of HOST rather than assuming these defaults
         if self.category == Target.Category.GPU:
             self.GridUnit = copy.deepcopy(GridUnits)
             self.MemorySpace = copy.deepcopy(_MemorySpace)
@@ -993,6 +1212,40 @@ class Target(_TargetContainer):
         if known_name:
             super().__post_init__()
 
+    def estimate_occupancy(
+        self, threads_per_block: int, shared_memory_per_block: int = 0, registers_per_thread: int = 0
+    ) -> float:
+        """Estimates the theoretical occupancy of a kernel launch, the fraction of the warps a multiprocessor can hold
+        that are active when as many blocks as fit are resident. The per-block shared memory and register limits of
+        the target are taken as the capacity of a multiprocessor, which underestimates the occupancy of devices with
+        larger multiprocessors. This can be used to rank or filter GPU schedules before building them, for instance
+        in the `filter_func` of `create_parameter_grid`.
+
+        Args:
+            threads_per_block: The number of threads of each block
+            shared_memory_per_block: The bytes of shared memory each block uses
+            registers_per_thread: The number of registers each thread uses, or 0 if unknown
+
+        Returns:
+            The occupancy between 0 and 1, 0 if the launch exceeds the limits of the target
+        """
+        if self.category != Target.Category.GPU:
+            raise ValueError("Occupancy is only defined for GPU targets")
+
+        if threads_per_block <= 0 or threads_per_block > self.max_threads_per_block or \
+           shared_memory_per_block > self.max_shared_memory_per_block or \
+           registers_per_thread * threads_per_block > self.max_registers_per_block:
+            return 0.0
+
+        warps_per_block = -(-threads_per_block // self.warp_size)
+        max_warps = self.max_threads_per_multiprocessor // self.warp_size
+        blocks = max_warps // warps_per_block
+        if shared_memory_per_block:
+            blocks = min(blocks, self.max_shared_memory_per_block // shared_memory_per_block)
+        if registers_per_thread:
+            blocks = min(blocks, self.max_registers_per_block // (registers_per_thread * warps_per_block * self.warp_size))
+        return blocks * warps_per_block / max_warps
+
     def is_compatible_with(self, other: "Target"):
         return all([
             self.name == other.name,
@@ -0,0 +1,532 @@
+####################################################################################################
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License. See LICENSE in the project root for license information.
+####################################################################################################
+
+import json
+import logging
+import math
+import os
+import platform
+import random
+import statistics
+import time
+from dataclasses import dataclass
+from enum import Enum, auto
+from functools import reduce
+from typing import Callable, List, Optional, Tuple
+
+import numpy as np
+
+from .Parameter import DelayedParameter
+
+
+class SearchStrategy(Enum):
+    "Defines how the tuner chooses the next candidates to build"
+    RANDOM = auto()    #: Samples the parameter space uniformly
+    EVOLUTIONARY = auto()    #: Crosses over and mutates the fastest candidates measured so far
+    BAYESIAN = auto()    #: Picks the candidates with the highest expected improvement under a Gaussian process model
+
+
+@dataclass
+class Trial:
+    "A candidate that the tuner built"
+    parameters: dict
+    time: Optional[float] = None    # mean seconds per call, None if the candidate failed to build or run
+    error: Optional[str] = None
+    stats: Optional[dict] = None    # the "mean", "median", "min" and "stdev" of the seconds per call
+
+
+@dataclass
+class TuningResult:
+    "The outcome of a tuning run"
+    best_parameters: Optional[dict]
+    best_time: Optional[float]
+    trials: List[Trial]
+
+
+def _encode_value(value):
+    "Parameter values are stored as they are when JSON can hold them, and as their string otherwise"
+    return value if isinstance(value, (bool, int, float, str)) else str(value)
+
+
+def _get_target_model(target) -> str:
+    "The model of a target, or the CPU model of this machine for the host target"
+    if target.name:
+        return target.name
+    try:
+        with open("/proc/cpuinfo") as cpuinfo:
+            for line in cpuinfo:
+                if line.startswith("model name"):
+                    return line.split(":", 1)[1].strip()
+    except OSError:
+        pass
+    return platform.processor() or platform.machine()
+
+
+def _get_source_target(source):
+    from .lang import Function, Plan
+    from .Targets import Target
+
+    if isinstance(source, Plan):
+        return source._target
+    if isinstance(source, Function):
+        return source.target
+    return Target.HOST    # nests and schedules are planned for the host
+
+
+def _get_signature(args, parameters: dict) -> str:
+    "The roles, element types, shapes and layouts of the arguments, with the shapes that are parameters resolved"
+    values = {p._name: v for p, v in parameters.items()}
+
+    def dim(size):
+        return values.get(size._name, size._name) if isinstance(size, DelayedParameter) else size
+
+    return ", ".join(
+        f"{arg.role.name.lower()} {arg.element_type.name}[{'x'.join(str(dim(s)) for s in arg.shape)}] "
+        f"{getattr(arg.requested_layout, 'name', arg.requested_layout)}" for arg in args
+    )
+
+
+def _get_compiler_version() -> Optional[str]:
+    from . import __version__
+    return __version__
+
+
+class TuningDatabase:
+    """A persistent database of tuning results, which `tune` adds each trial to and reads to warm-start its
+    searches, and which `Package.add` queries for the fastest parameters known for a function.
+
+    The database is a JSON lines file with one record per trial, so that the results of several runs, machines and
+    releases can be appended to it concurrently and concatenated. Each record holds the `"function"` (the base name it
+    was tuned under), the `"signature"` of its arguments, the `"target"` model (the CPU model for the host), the
+    `"parameters"` by name, the `"time"` and `"stats"` of the seconds per call or the `"error"` of a failed trial, the
+    `"compiler_version"` and a `"timestamp"`.
+    """
+
+    def __init__(self, path: str):
+        self.path = os.path.abspath(path)
+
+    def add(self, record: dict):
+        os.makedirs(os.path.dirname(self.path), exist_ok=True)
+        with open(self.path, "a") as database_file:
+            database_file.write(json.dumps(record) + "\n")
+
+    def records(self, function: str = None, signature: str = None, target: str = None) -> List[dict]:
+        "Returns the records that match the function, signature and target model, whichever are given"
+        if not os.path.isfile(self.path):
+            return []
+        records = []
+        with open(self.path) as database_file:
+            for line in database_file:
+                if not line.strip():
+                    continue
+                record = json.loads(line)
+                if (function is None or record["function"] == function) and \
+                   (signature is None or record["signature"] == signature) and \
+                   (target is None or record["target"] == target):
+                    records.append(record)
+        return records
+
+    def best(self, function: str, signature: str, target: str) -> Optional[dict]:
+        "Returns the fastest record of a function with a signature on a target model, or None if there is none"
+        return min((r for r in self.records(function, signature, target) if r.get("time") is not None),
+                   key=lambda r: r["time"],
+                   default=None)
+
+    def choose_parameters(self, source, args, base_name: str, parameters: dict) -> dict:
+        """Returns the values of the parameters of the fastest record of the function, or the given values if the
+        database knows none for its signature and target. Values that were stored as strings can't be restored, so the
+        records that differ from the given values in those are skipped."""
+        signature = _get_signature(args, parameters)
+        target = _get_target_model(_get_source_target(source))
+        by_name = {p._name: p for p in parameters}
+
+        def restore(record):
+            recorded = record["parameters"]
+            if set(recorded) != set(by_name):
+                return None
+            chosen = {}
+            for name, value in recorded.items():
+                default = parameters[by_name[name]]
+                if isinstance(default, (bool, int, float, str)):
+                    chosen[by_name[name]] = value
+                elif str(default) == value:
+                    chosen[by_name[name]] = default
+                else:
+                    return None
+            return chosen
+
+        candidates = [r for r in self.records(base_name, signature, target) if r.get("time") is not None]
+        for record in sorted(candidates, key=lambda r: r["time"]):
+            chosen = restore(record)
+            if chosen is not None:
+                logging.info(f"[Tuning] {base_name} ({signature}) on {target}: {record['parameters']}")
+                return chosen
+        return parameters
+
+
+class _ParameterSpace:
+    "The cartesian product of the parameter choices, each point is a tuple of indices into the choices"
+
+    def __init__(self, parameter_choices: dict, filter_func: Callable, rng: random.Random):
+        self.keys = list(parameter_choices.keys())
+        self.choices = []
+        for value in parameter_choices.values():
+            try:
+                self.choices.append(list(value))
+            except TypeError:
+                self.choices.append([value])
+        self.size = reduce(lambda x, y: x * y, (len(c) for c in self.choices), 1)
+        self.filter_func = filter_func
+        self.rng = rng
+
+    def values(self, point: Tuple[int]):
+        return tuple(c[i] for c, i in zip(self.choices, point))
+
+    def parameters(self, point: Tuple[int]) -> dict:
+        return dict(zip(self.keys, self.values(point)))
+
+    def find(self, parameters: dict) -> Optional[Tuple[int]]:
+        "The point of parameters recorded by name, or None if a value isn't one of the choices"
+        point = []
+        for key, choices in zip(self.keys, self.choices):
+            if key._name not in parameters:
+                return None
+            encoded = [_encode_value(c) for c in choices]
+            if parameters[key._name] not in encoded:
+                return None
+            point.append(encoded.index(parameters[key._name]))
+        return tuple(point)
+
+    def encode(self, point: Tuple[int]) -> np.ndarray:
+        "Maps a point to [0, 1]^d, so that neighbouring choices are close"
+        return np.array([i / max(len(c) - 1, 1) for c, i in zip(self.choices, point)], dtype=np.float64)
+
+    def is_valid(self, point: Tuple[int]) -> bool:
+        return not self.filter_func or bool(self.filter_func(*self.values(point)))
+
+    def random_point(self) -> Tuple[int]:
+        return tuple(self.rng.randrange(len(c)) for c in self.choices)
+
+    def mutate(self, point: Tuple[int]) -> Tuple[int]:
+        # each dimension moves with probability 1/d, to a neighbouring choice more often than not
+        mutated = list(point)
+        for d, c in enumerate(self.choices):
+            if len(c) > 1 and self.rng.random() < 1.0 / len(self.choices):
+                if self.rng.random() < 0.5:
+                    mutated[d] = min(max(mutated[d] + self.rng.choice((-1, 1)), 0), len(c) - 1)
+                else:
+                    mutated[d] = self.rng.randrange(len(c))
+        return tuple(mutated)
+
+    def crossover(self, a: Tuple[int], b: Tuple[int]) -> Tuple[int]:
+        return tuple(x if self.rng.random() < 0.5 else y for x, y in zip(a, b))
+
+
+class _Searcher:
+    # Bounds the work spent looking for unseen candidates that pass the filter
+    MAX_ATTEMPTS_PER_CANDIDATE = 1000
+    # Number of random candidates that the Bayesian search scores with its model
+    BAYESIAN_POOL_SIZE = 512
+
+    def __init__(self, space: _ParameterSpace, strategy: SearchStrategy, rng: random.Random):
+        self.space = space
+        self.strategy = strategy
+        self.rng = rng
+        self.seen = set()
+
+    def propose(self, count: int, measured: List[Tuple[Tuple[int], float]]) -> List[Tuple[int]]:
+        if self.strategy == SearchStrategy.EVOLUTIONARY and len(measured) >= 2:
+            candidates = self._propose_evolutionary(count, measured)
+        elif self.strategy == SearchStrategy.BAYESIAN and len(measured) >= 2:
+            candidates = self._propose_bayesian(count, measured)
+        else:
+            candidates = []
+
+        # the first candidates, and any that the strategy couldn't find, are sampled at random
+        while len(candidates) < count:
+            point = self._sample(self.space.random_point)
+            if point is None:
+                break
+            candidates.append(point)
+        return candidates
+
+    def _accept(self, point: Tuple[int]) -> bool:
+        if point in self.seen:
+            return False
+        self.seen.add(point)    # points that fail the filter are never proposed again either
+        return self.space.is_valid(point)
+
+    def _sample(self, generate: Callable[[], Tuple[int]]) -> Optional[Tuple[int]]:
+        for _ in range(self.MAX_ATTEMPTS_PER_CANDIDATE):
+            if len(self.seen) >= self.space.size:
+                return None
+            point = generate()
+            if self._accept(point):
+                return point
+        return None
+
+    def _propose_evolutionary(self, count, measured):
+        ranked = [point for point, _ in sorted(measured, key=lambda m: m[1])]
+        parents = ranked[:max(2, len(ranked) // 4)]
+
+        def child():
+            a, b = self.rng.sample(parents, 2)
+            return self.space.mutate(self.space.crossover(a, b))
+
+        candidates = []
+        for _ in range(count):
+            point = self._sample(child)
+            if point is None:
+                break
+            candidates.append(point)
+        return candidates
+
+    def _propose_bayesian(self, count, measured):
+        X = np.stack([self.space.encode(point) for point, _ in measured])
+        y = np.log(np.array([t for _, t in measured]))
+
+        pool = []
+        for _ in range(self.BAYESIAN_POOL_SIZE * 4):
+            if len(pool) >= self.BAYESIAN_POOL_SIZE or len(self.seen) + len(pool) >= self.space.size:
+                break
+            point = self.space.random_point()
+            if point not in self.seen and point not in pool and self.space.is_valid(point):
+                pool.append(point)
+        if not pool:
+            return []
+
+        candidates = []
+        pool_X = np.stack([self.space.encode(point) for point in pool])
+        for _ in range(min(count, len(pool))):
+            ei = _expected_improvement(X, y, pool_X)
+            best = int(np.argmax(ei))
+            point = pool.pop(best)
+            candidates.append(point)
+            self.seen.add(point)
+
+            # Kriging believer: assume the candidate runs as fast as predicted so that the rest of the batch
+            # explores elsewhere
+            mean, _ = _gaussian_process(X, y, pool_X[best:best + 1])
+            X = np.vstack([X, pool_X[best]])
+            y = np.append(y, mean[0])
+            pool_X = np.delete(pool_X, best, axis=0)
+        return candidates
+
+
+def _gaussian_process(X: np.ndarray, y: np.ndarray, X_new: np.ndarray, length_scale=0.3, noise=1e-4):
+    "Posterior mean and standard deviation of a Gaussian process with an RBF kernel over standardized targets"
+
+    def kernel(a, b):
+        sq_dist = np.sum(a**2, 1)[:, None] + np.sum(b**2, 1)[None, :] - 2 * a @ b.T
+        return np.exp(-0.5 * np.maximum(sq_dist, 0) / length_scale**2)
+
+    y_mean, y_std = y.mean(), y.std() or 1.0
+    y_norm = (y - y_mean) / y_std
+
+    L = np.linalg.cholesky(kernel(X, X) + noise * np.eye(len(X)))
+    alpha = np.linalg.solve(L.T, np.linalg.solve(L, y_norm))
+    K_s = kernel(X, X_new)
+    v = np.linalg.solve(L, K_s)
+    mean = K_s.T @ alpha
+    var = np.maximum(1.0 - np.sum(v**2, 0), 1e-12)
+    return mean * y_std + y_mean, np.sqrt(var) * y_std
+
+
+def _expected_improvement(X: np.ndarray, y: np.ndarray, X_new: np.ndarray, xi=0.01):
+    mean, std = _gaussian_process(X, y, X_new)
+    improvement = y.min() - mean - xi
+    z = improvement / std
+    cdf = 0.5 * (1.0 + np.vectorize(math.erf)(z / math.sqrt(2.0)))
+    pdf = np.exp(-0.5 * z**2) / math.sqrt(2.0 * math.pi)
+    return improvement * cdf + std * pdf
+
+
+def _default_inputs(args, parameters: dict) -> List[np.ndarray]:
+    "Random arrays matching the shapes of the arguments once the parameters are set"
+    from .lang import Array
+
+    inputs = []
+    for arg in args:
+        shape = [parameters[s] if isinstance(s, DelayedParameter) else s for s in arg.shape]
+        dtype = np.dtype(arg.element_type.name)
+        data = np.random.random(shape) if np.issubdtype(dtype, np.floating) else np.random.randint(0, 8, shape)
+        data = data.astype(dtype)
+        if arg.layout == Array.Layout.LAST_MAJOR:
+            data = np.asfortranarray(data)
+        inputs.append(data)
+    return inputs
+
+
+def tune(
+    source,
+    args,
+    parameter_choices: dict,
+    budget: int,
+    strategy: SearchStrategy = SearchStrategy.RANDOM,
+    filter_func: Callable = None,
+    make_inputs: Callable = None,
+    batch_size: int = 8,
+    iterations: int = 10,
+    output_dir: str = None,
+    base_name: str = "tuning",
+    num_workers: int = 1,
+    seed: int = None,
+    jit: bool = False,
+    database: TuningDatabase = None
+) -> TuningResult:
+    """Searches the values of the parameters of a function for the fastest one, building and timing candidates
+    in batches until the budget is spent.
+
+    Args:
+        source: The parameterized nest, schedule or plan, as passed to `Package.add`.
+        args: The function arguments, as passed to `Package.add`.
+        parameter_choices: A dictionary that maps each parameter to its possible values, as passed to
+            `create_parameter_grid`.
+        budget: The maximum number of candidates to build.
+        strategy: How the next candidates are chosen from the ones measured so far.
+        filter_func: A callable that takes the values of a parameter combination and returns whether it should be
+            considered, e.g. to prune candidates that exceed the cache sizes or the shared memory of the target.
+            Filtered candidates don't count towards the budget.
+        make_inputs: A callable that takes the parameter dictionary of a candidate and returns the numpy arrays to
+            call it with. Defaults to random arrays shaped like `args`.
+        batch_size: The number of candidates built in one package.
+        iterations: The number of timed calls of each candidate, after a warm-up call.
+        output_dir: The directory where the candidate packages are built. Defaults to `<base_name>_tuning` in the
+            current directory.
+        base_name: The base name of the candidate functions and packages.
+        num_workers: The number of modules that each batch is sharded across, see `Package.build`.
+        seed: The seed of the random choices, for reproducible searches.
+        jit: Whether the batches are compiled into the memory of the process with `Package.Format.JIT` instead of
+            being built as packages that are loaded, which is faster for CPU functions on the host.
+        database: A TuningDatabase that each trial is added to. The search is warm-started with the trials that the
+            database holds for the same base name, argument signature and target model: their candidates aren't built
+            again, and their times seed the strategy. Candidates that failed with the same compiler version are
+            skipped too.
+
+    Returns:
+        A TuningResult with the fastest parameters, their time in seconds per call, and every trial. Candidates
+        that fail to build or run are recorded with their error and pruned. The fastest parameters may be those of a
+        trial from the database, which isn't in the trials.
+    """
+    import hatlib as hat
+    from .Package import Package
+
+    if budget < 1:
+        raise ValueError("budget must be positive")
+    if batch_size < 1:
+        raise ValueError("batch_size must be positive")
+
+    rng = random.Random(seed)
+    space = _ParameterSpace(parameter_choices, filter_func, rng)
+    searcher = _Searcher(space, strategy, rng)
+    make_inputs = make_inputs or (lambda parameters: _default_inputs(args, parameters))
+    output_dir = os.path.abspath(output_dir or f"{base_name}_tuning")
+
+    trials: List[Trial] = []
+    measured: List[Tuple[Tuple[int], float]] = []
+    target = _get_target_model(_get_source_target(source))
+    compiler_version = _get_compiler_version()
+
+    def record(trial: Trial):
+        trials.append(trial)
+        if database:
+            database.add({
+                "function": base_name,
+                "signature": _get_signature(args, trial.parameters),
+                "target": target,
+                "parameters": {p._name: _encode_value(v) for p, v in trial.parameters.items()},
+                "time": trial.time,
+                "stats": trial.stats,
+                "error": trial.error,
+                "compiler_version": compiler_version,
+                "timestamp": time.time()
+            })
+
+    if database:
+        warm_start = 0
+        for prior in database.records(base_name, target=target):
+            point = space.find(prior["parameters"])
+            if point is None or point in searcher.seen \
+                or prior["signature"] != _get_signature(args, space.parameters(point)):
+                continue
+            if prior.get("time") is not None:
+                measured.append((point, prior["time"]))
+            elif prior.get("compiler_version") != compiler_version:
+                continue    # the failure may have been fixed since
+            searcher.seen.add(point)
+            warm_start += 1
+        logging.info(f"[Tuning] Warm-started with {warm_start} trials from {database.path}")
+
+    def build(points, batch_name):
+        "Builds the points into one package, returns the names of the functions that were added and the functions"
+        package = Package()
+        names = {}
+        for point in points:
+            try:
+                function = package.add(source, args, parameters=space.parameters(point), base_name=base_name)
+                names[point] = function.name
+            except Exception as e:
+                record(Trial(space.parameters(point), error=f"{type(e).__name__}: {e}"))
+        if not names:
+            return names, {}
+        if jit:
+            return names, package.build(batch_name, format=Package.Format.JIT, output_dir=output_dir)
+        package.build(batch_name, format=Package.Format.HAT_DYNAMIC, output_dir=output_dir, num_workers=num_workers)
+        _, func_map = hat.load(os.path.join(output_dir, f"{batch_name}.hat"))
+        return names, func_map
+
+    def benchmark(point, function):
+        parameters = space.parameters(point)
+        try:
+            inputs = make_inputs(parameters)
+            function(*inputs)    # warm-up
+            times = []
+            for _ in range(iterations):
+                start = time.perf_counter()
+                function(*inputs)
+                times.append(time.perf_counter() - start)
+        except Exception as e:
+            record(Trial(parameters, error=f"{type(e).__name__}: {e}"))
+            return
+        elapsed = statistics.mean(times)
+        stats = {
+            "mean": elapsed,
+            "median": statistics.median(times),
+            "min": min(times),
+            "stdev": statistics.stdev(times) if len(times) > 1 else 0.0
+        }
+        record(Trial(parameters, time=elapsed, stats=stats))
+        measured.append((point, elapsed))
+        logging.info(f"[Tuning] {parameters}: {elapsed * 1e3:.4f} ms")
+
+    batch_index = 0
+    while len(trials) < budget:
+        points = searcher.propose(min(batch_size, budget - len(trials)), measured)
+        if not points:
+            break    # the space is exhausted
+
+        batch_name = f"{base_name}_batch{batch_index}"
+        batch_index += 1
+        try:
+            batches = [build(points, batch_name)]
+        except Exception:
+            # find the candidates that broke the build by building them one at a time
+            batches = []
+            for i, point in enumerate(points):
+                try:
+                    batches.append(build([point], f"{batch_name}_{i}"))
+                except Exception as e:
+                    record(Trial(space.parameters(point), error=f"{type(e).__name__}: {e}"))
+
+        for names, func_map in batches:
+            for point, function_name in names.items():
+                benchmark(point, func_map[function_name])
+
+    best = min(measured, key=lambda m: m[1], default=None)
+    return TuningResult(
+        best_parameters=space.parameters(best[0]) if best else None,
+        best_time=best[1] if best else None,
+        trials=trials
+    )
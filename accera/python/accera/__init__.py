@@ -13,12 +13,14 @@ from .Targets import Target
 from .Parameter import DelayedParameter, create_parameters, create_parameter_grid
 from .Constants import *
 from .Package import Package
+from .Tuning import SearchStrategy, Trial, TuningDatabase, TuningResult, tune
+from .Benchmark import BenchmarkOptions
 
 from .lang import *
 from ._lang_python import CompilerOptions, ScalarType, _GetTargetDeviceFromName
 from ._lang_python import (
     abs, max, min, ceil, floor, sqrt, exp, log, log10, log2, sin, cos, tan, sinh, cosh, tanh, logical_and, logical_or,
-    logical_not, _cast, _unsigned_cast
+    logical_not, _cast, _unsigned_cast, FastMathAccuracy, fast_log, fast_tanh, fast_sigmoid, fast_erf, fast_gelu
 )
 
 # Global initialization
@@ -9,16 +9,31 @@ from enum import Enum, auto
 from functools import partial
 from .._lang_python import ScalarType, _MemoryLayout
 from .._lang_python._lang import Array as NativeArray
-from .Layout import Layout, MemoryMapLayout
+from .Layout import BlockedLayout, Layout, MemoryMapLayout
 from ..Parameter import DelayedParameter
 from ..Constants import inf
 from .NativeLoopNestContext import NativeLoopNestContext
 
 
+class _BlockedArrayAccess:
+    "Indexes the native array of an array with a blocked layout with the indices of the array"
+
+    def __init__(self, native_array, layout: BlockedLayout):
+        self._native_array = native_array
+        self._layout = layout
+
+    def __getitem__(self, indices):
+        return self._native_array[self._layout.get_physical_indices(indices)]
+
+    def __setitem__(self, indices, value):
+        self._native_array[self._layout.get_physical_indices(indices)] = value
+
+
 class Array:
     "A multi-dimensional array"
 
     Layout = Layout
+    BlockedLayout = BlockedLayout
 
     class Role(Enum):
         "Defines the Array role"
@@ -32,9 +47,11 @@ class Array:
         role: "accera.Array.Role",
         data: Union["numpy.ndarray"] = None,
         element_type: Union["accera.ScalarType", type] = None,
-        layout: Union["accera.Array.Layout", Tuple[int]] = Layout.FIRST_MAJOR,
+        layout: Union["accera.Array.Layout", "accera.Array.BlockedLayout", Tuple[int]] = Layout.FIRST_MAJOR,
         offset: int = 0,
-        shape: Tuple[Union[int, DelayedParameter]] = None
+        shape: Tuple[Union[int, DelayedParameter]] = None,
+        alignment: int = None,
+        extent: Tuple[int] = None
     ):
         """Creates an Array
 
@@ -59,8 +76,19 @@ class Array:
                     Last-major: (1, s0, s0xs1, s0xs1xs2)
 
               In both cases, the last dimension (s3) is not used in computing the affine memory map.
+
+              An Array.BlockedLayout stores the array as blocks, e.g. Array.BlockedLayout((8, 8)) for 8x8 tiles, so that
+              functions can exchange blocked data without repacking it. The logic functions index the array with the
+              indices of its shape, and the functions take it as an array of the blocked shape. Only valid for
+              `Array.Role.INPUT` and `Array.Role.INPUT_OUTPUT` arrays.
             offset: The offset of the affine memory map | integer (positive, zero, or negative), default: 0
             shape: The array shape. Required for roles other than `Array.Role.CONST`, should not be specified for `Array.Role.CONST`
+            alignment: The byte alignment that the callers of the functions that take the array as an argument guarantee for its data,
+                a power of two, e.g. 64 for buffers aligned to cache lines. Only valid for `Array.Role.INPUT` and `Array.Role.INPUT_OUTPUT`
+                arrays, default: None (no guarantee)
+            extent: The shape of a larger array that this array is a view of, so that callers pass the address of the first element of the
+                view instead of copying it, e.g. shape=(64, 64) and extent=(64, 1024) for 64 columns of a 64x1024 array. The strides of the
+                array are those of the extent. Only valid for `Array.Role.INPUT` and `Array.Role.INPUT_OUTPUT` arrays, default: None (dense)
         """
 
         self._role = role
@@ -70,8 +98,28 @@ class Array:
         self._requested_layout = layout    # TODO : is there a better name for this? This is the layout as specified via the DSL, not the MemoryLayout object that gets produced in the C++ code
         self._offset = offset
         self._shape = shape
+        self._alignment = alignment
+        self._extent = extent
         self._native_array = None
         self._delayed_calls = {}
+        self._blocked_layout = None
+
+        if isinstance(layout, BlockedLayout):
+            if self._role not in [Array.Role.INPUT, Array.Role.INPUT_OUTPUT]:
+                raise ValueError("Blocked layouts are only supported for Array.Role.INPUT and Array.Role.INPUT_OUTPUT arrays")
+            if extent is not None or offset:
+                raise ValueError("Blocked layouts are not supported with an extent or an offset")
+            self._blocked_layout = layout
+            self._layout = Layout.FIRST_MAJOR
+
+        if alignment is not None:
+            if self._role not in [Array.Role.INPUT, Array.Role.INPUT_OUTPUT]:
+                raise ValueError("alignment is only supported for Array.Role.INPUT and Array.Role.INPUT_OUTPUT arrays")
+            if alignment <= 0 or (alignment & (alignment - 1)) != 0:
+                raise ValueError("alignment must be a power of two")
+
+        if extent is not None and self._role not in [Array.Role.INPUT, Array.Role.INPUT_OUTPUT]:
+            raise ValueError("extent is only supported for Array.Role.INPUT and Array.Role.INPUT_OUTPUT arrays")
 
         if self._role == Array.Role.CONST:
             if self._data is None:
@@ -154,6 +202,14 @@ class Array:
     def element_type(self):
         return self._element_type
 
+    @property
+    def alignment(self):
+        return self._alignment
+
+    @property
+    def extent(self):
+        return list(self._extent) if self._extent else self.shape
+
     @property
     def _value(self):
         if self._native_array:
@@ -177,8 +233,8 @@ class Array:
             raise ValueError("The cache is not created for this array")
         if self._layout != Array.Layout.DEFERRED:
             raise ValueError("Array layout is already set")
-        if self._role != Array.Role.CONST:
-            raise ValueError("Array role must be Array.Role.CONST")
+        if self._role not in [Array.Role.CONST, Array.Role.INPUT, Array.Role.INPUT_OUTPUT]:
+            raise ValueError("Array role must be Array.Role.CONST, Array.Role.INPUT or Array.Role.INPUT_OUTPUT")
 
         self._layout = cache.layout
         self._create_native_array()
@@ -205,8 +261,23 @@ class Array:
         return id(self) == id(other)
 
     def _create_native_array(self):
+        if self._blocked_layout:
+            # the native array is the array of blocks, which the logic functions index through _BlockedArrayAccess
+            memory_layout = _MemoryLayout(self._blocked_layout.get_physical_shape(self._shape))
+            self._native_array = NativeArray(self._element_type, memory_layout)
+            self._layout = self._native_array.layout
+            return
+
         mm_layout = MemoryMapLayout(self._layout, self._shape, self._offset)
-        memory_layout = _MemoryLayout(self._shape, order=mm_layout.order)
+        if self._extent:
+            if len(self._extent) != len(self._shape) or any(e < s for e, s in zip(self._extent, self._shape)):
+                raise ValueError("extent must have a size at least as large as the shape for each dimension")
+            # a view of the extent that starts at the address of its first element
+            memory_layout = _MemoryLayout(
+                self._shape, extent=list(self._extent), offset=[0] * len(self._shape), order=mm_layout.order
+            )
+        else:
+            memory_layout = _MemoryLayout(self._shape, order=mm_layout.order)
 
         if self._role == Array.Role.CONST:
             if self._layout != Array.Layout.DEFERRED:
@@ -219,10 +290,12 @@ class Array:
 
             # else defer creating native array until layout is set
 
-        else:
+        elif self._layout != Array.Layout.DEFERRED or self._role == Array.Role.TEMP:
             self._native_array = NativeArray(self._element_type, memory_layout)
             self._layout = self._native_array.layout
 
+        # else defer creating the native array of an argument until its layout is chosen, see Package
+
     def _build_native_context(self, context: NativeLoopNestContext):
         args_list = list(context.function_args)
         args_list.append(self._native_array)
@@ -4,7 +4,7 @@
 ####################################################################################################
 
 from dataclasses import dataclass
-from typing import Any, Tuple, Union
+from typing import Any, List, Tuple, Union
 from .Array import Array
 from .LoopIndex import LoopIndex
 from .._lang_python._lang import (
@@ -31,6 +31,15 @@ class Cache:
     location: _MemorySpace = _MemorySpace.NONE
     indexing: CacheIndexing = CacheIndexing.GLOBAL_TO_PHYSICAL
     allocation: _CacheAllocation = _CacheAllocation.AUTO
+    cooperative: bool = False
+    hardware_level: "accera.Target.CacheLevel" = None    # the max element budget is derived from this level
+    prefetch_distance: int = None    # trigger loop iterations to prefetch the active block ahead of its fill
+    nontemporal_write_back: bool = False
+    padding: Union[int, Any] = None    # elements added to the innermost dimension, or AUTO
+    panel: Tuple[int, Any] = None    # (dimension, size) of the contiguous panels the cache is stored as
+    epilogue: List[Any] = None    # elementwise steps applied to the output when it is reduced back into the array
+    element_type: Any = None    # the ScalarType the cache stores, if different from the array's
+    dimension_order: Tuple[int] = None    # the dimensions of the source from the outermost to the innermost of the cache, overrides the layout
 
     @property
     def target_shape(self):
@@ -39,6 +48,13 @@ class Cache:
         else:
             return self.target.shape
     @property
+    def target_element_type(self):
+        if isinstance(self.target, Cache):
+            return self.target.target_element_type
+        else:
+            return self.target.element_type
+
+    @property
     def target_role(self):
         if isinstance(self.target, Cache):
             return self.target.target_role
@@ -47,7 +63,7 @@ class Cache:
 
     @property
     def memory_map(self):
-        if isinstance(self.layout, tuple):
+        if isinstance(self.layout, tuple) and self.dimension_order is None:
             from .Layout import MemoryMapLayout
 
             mmap_layout = MemoryMapLayout(self.layout, self.target_shape, self.offset)
@@ -56,6 +72,8 @@ class Cache:
 
     @property
     def dimension_permutation(self):
+        if self.dimension_order is not None:
+            return _DimensionOrder(list(self.dimension_order))
         if isinstance(self.layout, Array.Layout) and self.layout is not Array.Layout.DEFERRED:
             first_major = list(range(len(self.target_shape)))
             dim_orders = {
@@ -87,5 +105,13 @@ class DelayedCache(Cache):
         self.location = cache.location
         self.indexing = cache.indexing
         self.allocation = cache.allocation
+        self.cooperative = cache.cooperative
+        self.hardware_level = cache.hardware_level
+        self.prefetch_distance = cache.prefetch_distance
+        self.nontemporal_write_back = cache.nontemporal_write_back
+        self.padding = cache.padding
+        self.panel = cache.panel
+        self.epilogue = cache.epilogue
+        self.element_type = cache.element_type
 
         self.completed = True
@@ -0,0 +1,140 @@
+####################################################################################################
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License. See LICENSE in the project root for license information.
+####################################################################################################
+
+from typing import *
+
+from .Array import Array
+from .LoopIndex import LoopIndex
+from .Nest import Nest
+from .Schedule import Schedule
+from .._lang_python import ScalarType, _cast
+
+_ORDERS = ("morton", "hilbert", "grouped")
+
+
+def _curve_logic(arrays, table, indices, body):
+    def _():
+        body(arrays, table, indices)
+
+    return _
+
+
+def _morton_cell(d: int) -> Tuple[int, int]:
+    "Returns the (row, column) of step d of the Morton (Z) order, whose bits interleave those of the row and the column"
+    row = col = 0
+    bit = 0
+    while d >> (2 * bit):
+        col |= ((d >> (2 * bit)) & 1) << bit
+        row |= ((d >> (2 * bit + 1)) & 1) << bit
+        bit += 1
+    return row, col
+
+
+def _hilbert_cell(n: int, d: int) -> Tuple[int, int]:
+    "Returns the (row, column) of step d of the Hilbert curve over an n x n grid, where n is a power of 2"
+    row = col = 0
+    s = 1
+    while s < n:
+        rx = 1 & (d // 2)
+        ry = 1 & (d ^ rx)
+        if ry == 0:
+            if rx == 1:
+                row, col = s - 1 - row, s - 1 - col
+            row, col = col, row
+        col += s * rx
+        row += s * ry
+        d //= 4
+        s *= 2
+    return row, col
+
+
+def _curve_order(rows: int, cols: int, order: str) -> List[Tuple[int, int]]:
+    "Returns the (row, column) of each tile of a rows x cols grid, in the order of the curve"
+    side = 1
+    while side < max(rows, cols):
+        side *= 2
+
+    # Grids that aren't a square of a power of 2 follow the curve of the enclosing one, skipping the cells outside them
+    cells = [_morton_cell(d) if order == "morton" else _hilbert_cell(side, d) for d in range(side * side)]
+    return [(r, c) for r, c in cells if r < rows and c < cols]
+
+
+def curve_tiles(
+    arrays: Sequence[Array],
+    shape: Tuple[int, int],
+    tile: Tuple[int, int],
+    body: Callable,
+    inner_shape: Tuple[int] = (),
+    order: str = "hilbert",
+    group: int = 8
+) -> Tuple[Schedule, Tuple[LoopIndex]]:
+    """Creates the schedule of a 2-D iteration space whose tiles are visited along a space-filling curve rather than row
+    by row. Consecutive tiles of a row-major order share a row of tiles but not a column, so a large GEMM or stencil
+    reloads the panel of its other operand from memory for each tile. The curves keep consecutive tiles close along both
+    dimensions, so the panels of the operands that neighboring tiles read are still in the last-level cache (or the L2
+    of a GPU):
+        "morton": the Z order, which interleaves the bits of the row and the column of the tile.
+        "hilbert": the Hilbert curve, whose consecutive tiles are always neighbors.
+        "grouped": the rows of tiles are taken `group` at a time, and each band is visited column by column. This is the
+            usual swizzle of the blocks of a GPU kernel, with the band of the first operand and a tile of the columns
+            of the second in L2.
+
+    The nest has one loop over the tiles, in the order of the curve, followed by the loops within the tile and the inner
+    loops, e.g. the reduction of a GEMM. Morton and Hilbert orders are computed when the package is built and are read
+    from a table of the row and the column of each tile. The grouped order is computed from the loop index, so it needs
+    no memory and suits the block index of a GPU kernel.
+
+    Args:
+        arrays: The arrays that the body reads and writes.
+        shape: The extents of the two dimensions of the iteration space that are tiled.
+        tile: The shape of the tiles, which must divide `shape`.
+        body: Computes an iteration, `body(*arrays, i, j, *inner)`, where `i` and `j` are the indices of the iteration
+            in `shape` and `inner` are the indices of the inner loops.
+        inner_shape: The extents of the inner loops, which each tile runs entirely.
+        order: The order of the tiles, "morton", "hilbert" or "grouped".
+        group: The number of rows of tiles of each band of the grouped order, which must divide the number of rows of
+            tiles. It is clamped to the number of rows of tiles.
+
+    Returns:
+        The schedule and its indices: the index of the tile along the curve, the two indices within the tile and the
+        inner indices. The loops within the tile and the inner loops can be transformed further; the index of the tile
+        can be parallelized or bound to the blocks of a GPU kernel, but not split, since the order of the curve is only
+        defined over all the tiles.
+    """
+    import numpy as np
+
+    if order not in _ORDERS:
+        raise ValueError(f"The order of the tiles must be one of {_ORDERS}")
+    if len(shape) != 2 or len(tile) != 2:
+        raise ValueError("Curve tiles traverse a 2-D iteration space")
+    if any(t <= 0 or s % t for s, t in zip(shape, tile)):
+        raise ValueError("The tile must divide the shape of the iteration space")
+
+    rows, cols = shape[0] // tile[0], shape[1] // tile[1]
+    if order == "grouped":
+        group = min(group, rows)
+        if group <= 0 or rows % group:
+            raise ValueError("The group must divide the number of rows of tiles")
+        table = None
+    else:
+        cells = _curve_order(rows, cols, order)
+        table = Array(role=Array.Role.CONST, element_type=ScalarType.int32, data=np.array(cells, dtype=np.int32))
+
+    def tile_body(arrays, table, indices):
+        step, ii, jj, *inner = indices
+        if table is None:
+            band = step // _cast(group * cols, ScalarType.index)
+            within = step % _cast(group * cols, ScalarType.index)
+            row = band * group + within % _cast(group, ScalarType.index)
+            col = within // _cast(group, ScalarType.index)
+        else:
+            row = _cast(table[step, 0], ScalarType.index)
+            col = _cast(table[step, 1], ScalarType.index)
+        body(*arrays, row * tile[0] + ii, col * tile[1] + jj, *inner)
+
+    nest = Nest(shape=[rows * cols, tile[0], tile[1]] + list(inner_shape))
+    indices = nest.get_indices()
+    nest.iteration_logic(_curve_logic(tuple(arrays), table, tuple(indices), tile_body))
+    return nest.create_schedule(), tuple(indices)
@@ -0,0 +1,138 @@
+####################################################################################################
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License. See LICENSE in the project root for license information.
+####################################################################################################
+
+from typing import *
+
+from .Array import Array
+from .Nest import Nest
+from .Plan import Plan
+from ..Targets import Target
+
+
+def _contraction_logic(A, B, C, a_indices, b_indices, c_indices):
+    def _():
+        C[c_indices] += A[a_indices] * B[b_indices]
+
+    return _
+
+
+def _reduction_logic(A, C, a_indices, c_indices):
+    def _():
+        C[c_indices] += A[a_indices]
+
+    return _
+
+
+def _parse_subscripts(subscripts: str, num_operands: int) -> Tuple[List[str], str]:
+    if "->" not in subscripts:
+        raise ValueError("Einsum subscripts must name the output, e.g. 'ij,jk->ik'")
+    inputs, output = subscripts.replace(" ", "").split("->")
+    inputs = inputs.split(",")
+    if len(inputs) != num_operands:
+        raise ValueError(f"Einsum subscripts name {len(inputs)} operands, but {num_operands} were given")
+    for s in inputs + [output]:
+        if not s.isalpha():
+            raise ValueError("Einsum subscripts must be letters")
+    if len(set(output)) != len(output):
+        raise ValueError("Einsum output subscripts can't repeat a letter")
+    if any(letter not in "".join(inputs) for letter in output):
+        raise ValueError("Every letter of the einsum output must index an operand")
+    return inputs, output
+
+
+def einsum(subscripts: str, *operands: Array, output: Array, target: Target = Target.HOST,
+           tile: Tuple[int, int, int] = (64, 64, 128)) -> Plan:
+    """Computes a tensor contraction given in the einsum notation, e.g. 'bij,bjk->bik', accumulating into `output`.
+
+    The letters of a contraction of two operands are classified like the dimensions of a (batched) matrix
+    multiplication: the batch letters index both operands and the output, the M letters index the first operand and
+    the output, the N letters index the second operand and the output, and the K letters index both operands but not
+    the output. When there is at least one of each of M, N and K, the loops are ordered as a GEMM over the innermost
+    M, N and K letters, which are tiled by `tile`, the block of the second operand is packed in a cache whose innermost
+    dimension is the one indexed by N when that is its first or last dimension, and the tile of the output becomes a register microkernel when the N letter
+    indexes its innermost dimension. Otherwise, e.g. for a transpose, a trace or a reduction, the contraction is a
+    direct nest.
+
+    Args:
+        subscripts: The letters of the dimensions of each operand and of the output, e.g. 'ij,jk->ik'.
+        operands: The one or two arrays to contract.
+        output: The array that the contraction is accumulated into.
+        target: The target of the plan.
+        tile: The tile sizes of the innermost M, N and K letters of a GEMM-shaped contraction, which are clamped to
+            their ranges.
+
+    Returns:
+        The plan of the contraction, which can be transformed further, and whose function takes (*operands, output).
+    """
+    if len(operands) not in [1, 2]:
+        raise ValueError("Einsum contracts one or two operands")
+
+    inputs, out_letters = _parse_subscripts(subscripts, len(operands))
+
+    extents = {}
+    for letters, array in zip(inputs + [out_letters], list(operands) + [output]):
+        if len(letters) != len(array.shape):
+            raise ValueError(f"Einsum subscripts '{letters}' don't match an array of rank {len(array.shape)}")
+        for letter, extent in zip(letters, array.shape):
+            if extents.setdefault(letter, extent) != extent:
+                raise ValueError(f"Einsum dimension '{letter}' has different sizes")
+
+    if len(operands) == 2:
+        a_letters, b_letters = inputs
+        batch = [l for l in out_letters if l in a_letters and l in b_letters]
+        m = [l for l in out_letters if l in a_letters and l not in b_letters]
+        n = [l for l in out_letters if l in b_letters and l not in a_letters]
+        k = [l for l in dict.fromkeys(a_letters + b_letters) if l in a_letters and l in b_letters and l not in out_letters]
+        summed = [l for l in dict.fromkeys(a_letters + b_letters) if l not in batch + m + n + k]
+        repeated = len(set(a_letters)) != len(a_letters) or len(set(b_letters)) != len(b_letters)
+        gemm = bool(m and n and k) and not summed and not repeated
+    else:
+        gemm = False
+
+    if gemm:
+        letters = batch + m + n + k
+    else:
+        letters = list(out_letters) + [l for l in dict.fromkeys("".join(inputs)) if l not in out_letters]
+
+    nest = Nest(shape=[extents[l] for l in letters])
+    indices = dict(zip(letters, nest.get_indices()))
+
+    def to_indices(letters_of):
+        return tuple(indices[l] for l in letters_of)
+
+    if len(operands) == 2:
+        A, B = operands
+        nest.iteration_logic(
+            _contraction_logic(A, B, output, to_indices(a_letters), to_indices(b_letters), to_indices(out_letters))
+        )
+    else:
+        nest.iteration_logic(_reduction_logic(operands[0], output, to_indices(inputs[0]), to_indices(out_letters)))
+
+    schedule = nest.create_schedule()
+    if not gemm:
+        return schedule.create_plan(target)
+
+    # The innermost letter of each kind is the GEMM dimension, the others are loops around the GEMM
+    i, j, kk = indices[m[-1]], indices[n[-1]], indices[k[-1]]
+    ii = schedule.split(i, min(tile[0], extents[m[-1]]))
+    jj = schedule.split(j, min(tile[1], extents[n[-1]]))
+    kkk = schedule.split(kk, min(tile[2], extents[k[-1]]))
+    outer = [indices[l] for l in batch + m[:-1] + n[:-1] + k[:-1]]
+    schedule.reorder(outer + [i, j, kk, ii, jj, kkk])
+
+    plan = schedule.create_plan(target)
+
+    # Pack the block of B so that the dimension indexed by N is innermost, which the vectors of the tile are read along
+    B = operands[1]
+    n_dim = b_letters.index(n[-1])
+    if n_dim == len(b_letters) - 1:
+        plan.cache(B, index=ii, layout=Array.Layout.FIRST_MAJOR)
+    elif n_dim == 0:
+        plan.cache(B, index=ii, layout=Array.Layout.LAST_MAJOR)
+
+    if out_letters[-1] == n[-1] and target.vectorization_info:
+        plan.microkernelize(ii, jj, kkk, output)
+
+    return plan
@@ -0,0 +1,129 @@
+####################################################################################################
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License. See LICENSE in the project root for license information.
+####################################################################################################
+
+from typing import *
+
+from .Array import Array
+from .Nest import Nest
+from .Plan import Plan, _ELEMENT_BYTES
+from .._lang_python import ScalarType
+from ..Targets import Target
+
+# Elementwise operations over fewer elements than this aren't worth the cost of starting threads
+_MIN_PARALLEL_ELEMENTS = 1 << 16
+
+# The number of vectors that each iteration of the vectorized loop computes
+_VECTORS_PER_ITERATION = 4
+
+
+def _elementwise_logic(arrays, indices, body):
+    def _():
+        body(arrays, indices)
+
+    return _
+
+
+def _broadcast_shape(shapes: List[Tuple[int]]) -> Tuple[List[Tuple[int]], Tuple[int]]:
+    rank = max(len(shape) for shape in shapes)
+    padded = [(1, ) * (rank - len(shape)) + tuple(shape) for shape in shapes]
+    out_shape = []
+    for d in range(rank):
+        extents = set(shape[d] for shape in padded if shape[d] != 1)
+        if len(extents) > 1:
+            raise ValueError(f"The shapes {shapes} can't be broadcast together")
+        out_shape.append(extents.pop() if extents else 1)
+    return padded, tuple(out_shape)
+
+
+def broadcast_elementwise(
+    fn: Callable,
+    shapes: List[Tuple[int]],
+    element_type: ScalarType = ScalarType.float32,
+    target: Target = Target.HOST
+) -> Tuple[Plan, Tuple[Array]]:
+    """Creates the plan of an elementwise operation on operands that are broadcast to a common shape with the rules of
+    NumPy: the shapes are aligned on their last dimension, and dimensions of 1 are repeated along the dimensions of the
+    other operands.
+
+    Adjacent dimensions that every operand either has or broadcasts along are collapsed into one, so the loops are
+    over the longest contiguous runs of elements. The innermost dimension, which is contiguous in the output and in the
+    operands that have it, is vectorized, and the outermost dimension is parallelized when there are enough elements
+    to share between the threads of the target.
+
+    Args:
+        fn: The operation, which returns the value of an element of the output given the values of the operands at it.
+        shapes: The shape of each operand, in the order of the arguments of `fn`.
+        element_type: The element type of the operands and of the output.
+        target: The target of the plan.
+
+    Returns:
+        The plan and its arguments: an input array for each operand followed by the output. The arrays have the
+        collapsed shapes, with the broadcast dimensions of each operand removed. They have the same elements in the same
+        order as the row-major operands and output, so these can be passed to the function of the plan as they are.
+    """
+    if not shapes:
+        raise ValueError("An elementwise operation needs at least one operand")
+
+    padded, out_shape = _broadcast_shape(shapes)
+
+    # Dimensions of 1 don't need loops, and neighboring dimensions that every operand has or broadcasts along in the
+    # same way are one longer dimension
+    groups = []
+    for d, extent in enumerate(out_shape):
+        if extent == 1:
+            continue
+        broadcast = tuple(shape[d] == 1 for shape in padded)
+        if groups and groups[-1][1] == broadcast:
+            groups[-1][0] *= extent
+        else:
+            groups.append([extent, broadcast])
+    if not groups:
+        groups = [[1, tuple(False for _ in shapes)]]
+
+    operand_dims = [[g for g, (_, broadcast) in enumerate(groups) if not broadcast[k]] for k in range(len(shapes))]
+    operands = [
+        Array(role=Array.Role.INPUT, element_type=element_type, shape=tuple(groups[g][0] for g in dims) or (1, ))
+        for dims in operand_dims
+    ]
+    output = Array(
+        role=Array.Role.INPUT_OUTPUT, element_type=element_type, shape=tuple(extent for extent, _ in groups)
+    )
+
+    def body(arrays, indices):
+        values = [
+            array[tuple(indices[g] for g in dims)] if dims else array[0]
+            for array, dims in zip(arrays[:-1], operand_dims)
+        ]
+        arrays[-1][tuple(indices)] = fn(*values)
+
+    nest = Nest(shape=[extent for extent, _ in groups])
+    indices = nest.get_indices()
+    nest.iteration_logic(_elementwise_logic(tuple(operands) + (output, ), tuple(indices), body))
+
+    schedule = nest.create_schedule()
+    innermost = indices[-1]
+    extent = groups[-1][0]
+    lanes = max(1, target.vector_bytes // _ELEMENT_BYTES[element_type])
+
+    vectorized = None
+    if target.vector_bytes and extent >= lanes:
+        block = lanes * _VECTORS_PER_ITERATION
+        vectorized = schedule.split(innermost, block) if extent > block else innermost
+
+    plan = schedule.create_plan(target)
+    if vectorized is not None:
+        plan.vectorize(vectorized, masked=True)
+    elif extent <= lanes:
+        plan.unroll(innermost)
+
+    # The outermost loop is either the outermost dimension or the blocks of the vectorized one
+    num_elements = 1
+    for size in out_shape:
+        num_elements *= size
+    outermost = schedule.get_indices()[0]
+    if target.num_threads > 1 and num_elements >= _MIN_PARALLEL_ELEMENTS and outermost is not vectorized:
+        plan.parallelize(outermost)
+
+    return plan, tuple(operands) + (output, )
@@ -6,8 +6,10 @@
 from typing import Callable
 from inspect import Parameter, signature
 from dataclasses import dataclass, field
+from enum import Enum
 from functools import wraps, singledispatch
 from ..Targets import Target
+from ..Parameter import read_parameters
 from ..lang.Array import Array
 from .._lang_python._lang import Array as NativeArray
 
@@ -52,6 +54,17 @@ def role_to_usage(role):
         return _FunctionParameterUsage.INPUT_OUTPUT
 
 
+def _same_value(a, b):
+    "Whether two parameter values are the same, values such as indices are the same only if they are the same object"
+    if a is b:
+        return True
+    if isinstance(a, (tuple, list)) and type(a) is type(b):
+        return len(a) == len(b) and all(_same_value(x, y) for x, y in zip(a, b))
+    if isinstance(a, dict) and isinstance(b, dict):
+        return a.keys() == b.keys() and all(_same_value(a[k], b[k]) for k in a)
+    return type(a) is type(b) and isinstance(a, (bool, int, float, str, Enum)) and a == b
+
+
 @dataclass
 class Function:
     name: str = ""    # base_name + _ + generated unique_id
@@ -64,8 +77,17 @@ class Function:
     param_overrides: dict = field(default_factory=dict)    # overrides for constants
     definition: Callable = None
     no_inline: bool = False
+    auto_inline: bool = False    # calls from other functions are only inlined if the function is small or called once
+    emit_async: bool = False    # also emit an asynchronous variant that returns a completion handle
+    nontemporal_write_back: bool = False    # write the caches back with non-temporal stores
+    use_workspace: bool = False    # place the scratch buffers in a caller-provided workspace argument
+    no_alias: bool = False    # the callers guarantee that the array arguments don't overlap
+    gpu_graph: bool = False    # replay the kernels that the function launches from a graph captured on the first call
+    cpu: str = ""    # the LLVM CPU that the code is compiled for instead of the package's, e.g. "skylake-avx512"
+    specialized_args: dict = field(default_factory=dict)    # the constant value of each specialized argument, by index
     auxiliary: dict = field(default_factory=dict)
     target: Target = Target.HOST
+    instance_key: tuple = None    # the functions with a key are the same for the same values of the parameters they read
 
     def __post_init__(self):
         # automatically fill if not specified
@@ -85,7 +107,19 @@ class Function:
         if self.args:
             usages = [role_to_usage(arg.role) for arg in self.requested_args]
             self._native_fn.parameters(self.args, usages)
-        self._native_fn.inlinable(not self.no_inline)
+            alignments = self._get_arg_alignments()
+            if alignments:
+                self._native_fn.parameterAlignments(alignments)
+        if self.auto_inline and not self.no_inline:
+            self._native_fn.autoInline()
+        else:
+            self._native_fn.inlinable(not self.no_inline)
+        if self.specialized_args:
+            self._native_fn.specializedArguments([self.specialized_args.get(i) for i in range(len(self.args))])
+        self._native_fn.nontemporalWriteBack(self.nontemporal_write_back)
+        self._native_fn.noAlias(self.no_alias)
+        if self.cpu:
+            self._native_fn.targetCPU(self.cpu, "")
 
         sig = signature(self.definition)
 
@@ -101,15 +135,55 @@ class Function:
                 else:
                     self.definition(args)
 
-        self._native_fn.define(wrapper_fn)
+        with read_parameters() as reads:
+            self._native_fn.define(wrapper_fn)
+        self._parameter_reads = reads
+
+        self._emit_api()
+
+    @property
+    def _impl_name(self):
+        "The name of the implementation that the function calls, which is the implementation of another variant if shared"
+        return getattr(self, "_impl_owner", self.name) + "_impl"
+
+    def _emit_instance_of(self, fn: "Function"):
+        "Emits the function as a variant of `fn` that is already emitted, which shares its implementation"
+        for delayed_param, value in self.param_overrides.items():
+            delayed_param.set_value(value)
+        self._native_fn = fn._native_fn
+        self._impl_owner = getattr(fn, "_impl_owner", fn.name)
+        self._parameter_reads = fn._parameter_reads
+        self._emit_api()
+
+    def _is_instance_of(self, fn: "Function"):
+        "Whether the implementation of `fn`, which is already emitted, is the implementation of this function"
+        if self.instance_key is None or self.instance_key != fn.instance_key:
+            return False
+        values = {delayed_param: delayed_param._value for delayed_param in fn._parameter_reads}
+        values.update((delayed_param, value) for delayed_param, value in self.param_overrides.items()
+                      if delayed_param in values)
+        return all(_same_value(values[p], value) for p, value in fn._parameter_reads.items())
+
+    def _emit_api(self):
+        from .._lang_python import _DeclareFunction
 
         if self.public:
             api_decl = _DeclareFunction(self.name)
             if self.args:
                 api_decl.parameters(self.args)
+                alignments = self._get_arg_alignments()
+                if alignments:
+                    api_decl.parameterAlignments(alignments)
             if self.base_name:
                 api_decl.baseName(self.base_name)
-            api_decl.public(True).decorated(False).headerDecl(True).rawPointerAPI(True).define(self._native_fn)
+            api_decl.public(True).decorated(False).headerDecl(True).rawPointerAPI(True).asyncAPI(self.emit_async)
+            api_decl.workspaceAPI(self.use_workspace).noAlias(self.no_alias).gpuGraph(self.gpu_graph)
+            api_decl.define(self._native_fn)
+
+    def _get_arg_alignments(self):
+        "The byte alignment that the callers guarantee for each argument, 0 for none, or [] if none of them has one"
+        alignments = [getattr(arg, "alignment", None) or 0 for arg in self.requested_args]
+        return alignments if any(alignments) else []
 
     def __call__(self, *args):
         self._emit()
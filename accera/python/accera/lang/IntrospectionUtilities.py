@@ -7,7 +7,9 @@ import ast
 import inspect
 import textwrap
 
+from .Array import Array
 from .LogicFunction import LogicFunction
+from .LoopIndex import LoopIndex
 
 
 class FunctionCallAssignVisitor(ast.NodeVisitor):
@@ -198,3 +200,111 @@ def get_array_access_indices(arr, func: LogicFunction):
                     raise NotImplementedError("Currently only supports one indexing pattern per array per kernel")
 
     return [func_indices[elt_name] for elt_name in access_elt_names]
+
+
+class ArrayReadWriteVisitor(ast.NodeVisitor):
+    '''
+    Visitor pattern class that traverses an AST and finds the array subscripts that are read and written.
+    Each dimension of a subscript is recorded as the name of the variable it is indexed with, or None for
+    any other expression. E.g. C[i, j] += A[i, k + 1] records a read and a write of C with ['i', 'j']
+    and a read of A with ['i', None]
+    '''
+    def __init__(self):
+        self.accesses = []    # (array name, index names, is_write)
+
+    def _record(self, node, is_write):
+        if not isinstance(node.value, ast.Name):
+            return
+        #       Python < 3.9                                          Python >= 3.9
+        slice = node.slice.value if isinstance(node.slice, getattr(ast, "Index", ())) else node.slice
+        elts = slice.elts if isinstance(slice, ast.Tuple) else [slice]
+        index_names = [self._dimension(elt) for elt in elts]
+        self.accesses.append((node.value.id, index_names, is_write))
+
+    def _dimension(self, elt):
+        return elt.id if isinstance(elt, ast.Name) else None
+
+    def visit_AugAssign(self, node):
+        # the target of an augmented assignment is read before it is written
+        if isinstance(node.target, ast.Subscript):
+            self._record(node.target, is_write=False)
+        self.generic_visit(node)
+
+    def visit_Subscript(self, node):
+        self._record(node, is_write=isinstance(node.ctx, ast.Store))
+        self.generic_visit(node)
+
+
+def get_array_reads_and_writes(func: LogicFunction):
+    '''returns the (array, indices, is_write) accesses of the arrays captured by the given logic function, where each
+    of the indices is the captured LoopIndex that the dimension is indexed with, or None for any other expression'''
+    tree = ast.parse(textwrap.dedent(inspect.getsource(func.func)))
+    visitor = ArrayReadWriteVisitor()
+    visitor.visit(tree)
+
+    # get_captures also returns the captures of the other special types, so only keep the arrays and indices
+    func_arrays = {name: arr for name, arr in func.get_args().items() if isinstance(arr, Array)}
+    func_indices = {name: index for name, index in func.get_indices().items() if isinstance(index, LoopIndex)}
+    accesses = []
+    for array_name, index_names, is_write in visitor.accesses:
+        if array_name not in func_arrays:
+            continue
+        indices = [func_indices.get(name) for name in index_names]
+        accesses.append((func_arrays[array_name], indices, is_write))
+    return accesses
+
+
+class ArrayAffineAccessVisitor(ArrayReadWriteVisitor):
+    '''
+    Visitor pattern class that finds the array subscripts that are read and written, like ArrayReadWriteVisitor.
+    Each dimension of a subscript is recorded as a (variable name, offset) tuple when it is indexed with a variable
+    plus or minus a constant, as an int when it is indexed with a constant, or as None for any other expression.
+    E.g. A[i, j - 1] = B[2, k] records a write of A with [('i', 0), ('j', -1)] and a read of B with [2, ('k', 0)]
+    '''
+    def _dimension(self, elt):
+        constant = self._constant(elt)
+        if constant is not None:
+            return constant
+        if isinstance(elt, ast.Name):
+            return (elt.id, 0)
+        if isinstance(elt, ast.BinOp) and isinstance(elt.op, (ast.Add, ast.Sub)):
+            sign = 1 if isinstance(elt.op, ast.Add) else -1
+            offset = self._constant(elt.right)
+            if isinstance(elt.left, ast.Name) and offset is not None:
+                return (elt.left.id, sign * offset)
+            offset = self._constant(elt.left)
+            if isinstance(elt.right, ast.Name) and offset is not None and sign == 1:
+                return (elt.right.id, offset)
+        return None
+
+    def _constant(self, elt):
+        if isinstance(elt, ast.Constant) and type(elt.value) is int:
+            return elt.value
+        if isinstance(elt, ast.UnaryOp) and isinstance(elt.op, ast.USub):
+            value = self._constant(elt.operand)
+            return -value if value is not None else None
+        return None
+
+
+def get_array_affine_accesses(func: LogicFunction):
+    '''returns the (array, dimensions, is_write) accesses of the arrays captured by the given logic function, where each
+    of the dimensions is a (LoopIndex, offset) tuple for a captured LoopIndex plus a constant offset, an int for a
+    constant, or None for any other expression'''
+    tree = ast.parse(textwrap.dedent(inspect.getsource(func.func)))
+    visitor = ArrayAffineAccessVisitor()
+    visitor.visit(tree)
+
+    func_arrays = {name: arr for name, arr in func.get_args().items() if isinstance(arr, Array)}
+    func_indices = {name: index for name, index in func.get_indices().items() if isinstance(index, LoopIndex)}
+    accesses = []
+    for array_name, dims, is_write in visitor.accesses:
+        if array_name not in func_arrays:
+            continue
+        resolved_dims = []
+        for dim in dims:
+            if isinstance(dim, tuple):
+                name, offset = dim
+                dim = (func_indices[name], offset) if name in func_indices else None
+            resolved_dims.append(dim)
+        accesses.append((func_arrays[array_name], resolved_dims, is_write))
+    return accesses
@@ -5,7 +5,7 @@
 
 from enum import Enum, auto
 from dataclasses import dataclass
-from typing import Tuple, Union
+from typing import List, Tuple, Union
 
 
 class Layout(Enum):
@@ -77,3 +77,42 @@ class MemoryMapLayout:
             elif self.layout == Layout.LAST_MAJOR:
                 result = range(ndim)[::-1]
         return result
+
+
+@dataclass(frozen=True)
+class BlockedLayout:
+    """A layout that stores an array as blocks, such as the 8x8 tiles of a matrix, or the blocks of 8 channels of the
+    NCHW8c format of an NCHW tensor. The array is stored first-major as the grid of its blocks, each block first-major
+    too, and the dimensions of size 1 of the block shape are not blocked. For example, a 64x32 matrix with 8x8 blocks
+    is stored as an array of shape (8, 4, 8, 8), and a (1, 64, 28, 28) tensor with (1, 8, 1, 1) blocks as an array of
+    shape (1, 8, 28, 28, 8).
+    """
+
+    block_shape: Tuple[int]
+
+    def get_physical_shape(self, shape: Tuple[int]) -> List[int]:
+        "The shape that an array of the given shape is stored as"
+        if len(shape) != len(self.block_shape):
+            raise ValueError("The block shape must have a size for each dimension of the array")
+        if any(b <= 0 or s % b for s, b in zip(shape, self.block_shape)):
+            raise ValueError(f"The shape {tuple(shape)} is not a multiple of the block shape {tuple(self.block_shape)}")
+        return [s // b for s, b in zip(shape, self.block_shape)] + [b for b in self.block_shape if b > 1]
+
+    def get_physical_indices(self, indices: Tuple) -> List:
+        "The indices of the stored array of the element at the given indices"
+        return [i // b if b > 1 else i for i, b in zip(indices, self.block_shape)
+                ] + [i % b for i, b in zip(indices, self.block_shape) if b > 1]
+
+    def pack(self, array: "numpy.ndarray") -> "numpy.ndarray":
+        "Stores a NumPy array with the layout, e.g. to pass it to a function that takes an array with the layout"
+        ndim = len(self.block_shape)
+        blocks = array.reshape(sum(((s // b, b) for s, b in zip(array.shape, self.block_shape)), ()))
+        return blocks.transpose([2 * d for d in range(ndim)] + [2 * d + 1 for d in range(ndim)]) \
+            .reshape(self.get_physical_shape(array.shape))
+
+    def unpack(self, array: "numpy.ndarray", shape: Tuple[int]) -> "numpy.ndarray":
+        "Restores a NumPy array of the given shape from its storage with the layout"
+        ndim = len(self.block_shape)
+        blocks = array.reshape([s // b for s, b in zip(shape, self.block_shape)] + list(self.block_shape))
+        return blocks.transpose(sum(((d, ndim + d) for d in range(ndim)), ())).reshape(shape)
+
@@ -0,0 +1,75 @@
+####################################################################################################
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License. See LICENSE in the project root for license information.
+####################################################################################################
+
+from typing import Callable
+
+from .._lang_python import ScalarType
+from .Array import Array
+
+_BYTE_TYPES = (ScalarType.int8, ScalarType.uint8)
+
+
+def lookup_table(
+    fn: Callable[[float], float],
+    input_scale: float,
+    input_zero_point: int,
+    output_scale: float,
+    output_zero_point: int,
+    input_type: ScalarType = ScalarType.int8,
+    output_type: ScalarType = ScalarType.int8,
+) -> Array:
+    """Builds the 256-entry table of a function of quantized 8-bit values, for `table_lookup`. Each entry dequantizes
+    its index, applies the function and requantizes the result:
+
+        table[q] = saturate(round((fn((q - input_zero_point) * input_scale)) / output_scale) + output_zero_point)
+
+    The table is computed when the package is built, so that an activation such as GELU or sigmoid in a quantized
+    epilogue becomes a single lookup per element.
+
+    Args:
+        fn: The function of the dequantized value, which is called with each of the 256 values as a Python float.
+        input_scale, input_zero_point: The quantization parameters of the indices.
+        output_scale, output_zero_point: The quantization parameters of the entries.
+        input_type: The type of the indices, ScalarType.int8 or ScalarType.uint8. The entry of a signed index q is
+            at q & 0xFF, the byte that holds it.
+        output_type: The type of the entries, ScalarType.int8 or ScalarType.uint8.
+
+    Returns:
+        An Array.Role.CONST array of 256 entries of the output type.
+    """
+    import numpy as np
+
+    if input_type not in _BYTE_TYPES or output_type not in _BYTE_TYPES:
+        raise ValueError("lookup_table requires int8 or uint8 inputs and outputs")
+
+    indices = np.arange(256, dtype=np.uint8)
+    if input_type == ScalarType.int8:
+        indices = indices.view(np.int8)
+    values = np.array([fn(float((q - input_zero_point) * input_scale)) for q in indices.astype(np.int64)])
+
+    lowest, highest = (-128, 127) if output_type == ScalarType.int8 else (0, 255)
+    entries = np.clip(np.floor(values / output_scale + 0.5) + output_zero_point, lowest, highest)
+    return Array(
+        role=Array.Role.CONST,
+        element_type=output_type,
+        data=entries.astype(np.int8 if output_type == ScalarType.int8 else np.uint8)
+    )
+
+
+def table_lookup(table: Array, index: "accera.Scalar") -> "accera.Scalar":
+    """Returns the entry of a 256-entry table of 8-bit integers at an 8-bit index, which is read as unsigned.
+
+    In a vectorized loop, the entries of a whole vector of indices are selected at once by the lookup instructions of
+    the target: vpermi2b with AVX512-VBMI, vpshufb with AVX2, or tbl and tbx on ARM. Other targets load each entry.
+
+    Args:
+        table: An array of 256 int8 or uint8 entries, such as one built by `lookup_table`.
+        index: An int8 or uint8 value.
+    """
+    from .._lang_python import _table_lookup
+
+    if isinstance(table, Array):
+        table = table._get_native_array()
+    return _table_lookup(table, index)
@@ -7,7 +7,7 @@ import logging
 from typing import Callable, List, Union, Tuple
 from functools import partial
 
-from .Array import Array
+from .Array import Array, _BlockedArrayAccess
 from .LoopIndex import LoopIndex
 from .LogicFunction import logic_function, LogicFunction
 from .NativeLoopNestContext import NativeLoopNestContext
@@ -27,6 +27,7 @@ class Nest:
         self._commands = []
         self._delayed_calls = {}
         self._logic_fns = []
+        self._conditional_logic_fns = []    # the logic functions that only run where their predicate holds
         self._shape = [(dim, LoopIndex(self)) for dim in shape]
 
         if any([isinstance(s, DelayedParameter) for s in shape]):
@@ -39,14 +40,16 @@ class Nest:
 
         return Schedule(self)
 
-    def create_plan(self, target: "accera.Target" = Target.HOST) -> "accera.Plan":
+    def create_plan(self, target: "accera.Target" = Target.HOST, auto_schedule: bool = False) -> "accera.Plan":
         """Convenience syntax to create a plan from this nest
 
         Args:
             target: Optional target specification. Defaults to the HOST
+            auto_schedule: Whether to pick the schedule and plan from a model of the nest on the target, see
+                Schedule.create_plan. Defaults to False.
         """
 
-        return self.create_schedule().create_plan(target)
+        return self.create_schedule().create_plan(target, auto_schedule)
 
     def get_shape(self) -> List[int]:
         """Gets the iteration space extents
@@ -93,6 +96,8 @@ class Nest:
         """
         wrapped_logic = logic_function(logic)
         self._logic_fns.append(wrapped_logic)
+        if predicate is not None or placement is not None:
+            self._conditional_logic_fns.append(wrapped_logic)
 
         self._commands.append(partial(self._add_iteration_logic, wrapped_logic, predicate, placement))
 
@@ -104,6 +109,8 @@ class Nest:
             value_id = id(v)
             if value_id in context.mapping:
                 captures_to_replace[k] = context.mapping[value_id]
+                if isinstance(v, Array) and v._blocked_layout:
+                    captures_to_replace[k] = _BlockedArrayAccess(context.mapping[value_id], v._blocked_layout)
             else:
                 if isinstance(v, Array):
                     from .._lang_python._lang import Allocate, Array as NativeArray
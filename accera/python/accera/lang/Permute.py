@@ -0,0 +1,186 @@
+####################################################################################################
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License. See LICENSE in the project root for license information.
+####################################################################################################
+
+from typing import *
+
+from .Array import Array
+from .Nest import Nest
+from .Plan import Plan, _ELEMENT_BYTES
+from .._lang_python import ScalarType
+from .._lang_python._lang import _MemorySpace
+from ..Constants import AUTO
+from ..Targets import Target
+
+# Permutes of fewer elements than this aren't worth the cost of starting threads
+_MIN_PARALLEL_ELEMENTS = 1 << 16
+
+# The number of vectors that each iteration of the vectorized loop of a copy of rows computes
+_VECTORS_PER_ITERATION = 4
+
+# The number of vectors along each side of the tiles that a CPU transposes through a cache
+_VECTORS_PER_TILE = 4
+
+# The tile that each block of a GPU transposes through shared memory, with one thread per element
+_GPU_TILE = 16
+
+
+def _permute_logic(input, output, indices, body):
+    def _():
+        body(input, output, indices)
+
+    return _
+
+
+def _collapse_permutation(shape: Tuple[int], axes: Tuple[int]) -> Tuple[Tuple[int], Tuple[int]]:
+    "Returns the shape and the axes of the permutation with the dimensions of 1 removed and the runs of input dimensions that stay together in the output merged"
+    kept = [d for d in range(len(shape)) if shape[d] != 1]
+    renumber = {d: n for n, d in enumerate(kept)}
+    shape = [shape[d] for d in kept]
+    axes = [renumber[a] for a in axes if a in renumber]
+
+    # runs of consecutive input dimensions in the output, in the order of the output
+    runs = []
+    for a in axes:
+        if runs and runs[-1][-1] + 1 == a:
+            runs[-1].append(a)
+        else:
+            runs.append([a])
+    by_input = sorted(range(len(runs)), key=lambda r: runs[r][0])
+
+    collapsed_shape = []
+    for r in by_input:
+        extent = 1
+        for d in runs[r]:
+            extent *= shape[d]
+        collapsed_shape.append(extent)
+    collapsed_axes = [by_input.index(r) for r in range(len(runs))]
+    return tuple(collapsed_shape) or (1, ), tuple(collapsed_axes) or (0, )
+
+
+def permute(
+    shape: Tuple[int],
+    axes: Tuple[int],
+    element_type: ScalarType = ScalarType.float32,
+    target: Target = Target.HOST,
+    tile: int = None
+) -> Tuple[Plan, Tuple[Array, Array]]:
+    """Creates the plan of a permutation of the dimensions of an array, like `numpy.transpose(input, axes)`.
+
+    Dimensions of 1 are dropped and the dimensions of the input that stay next to each other in the same order in the
+    output are collapsed into one, so e.g. swapping the two middle dimensions of a (B, S, H, D) array is a copy of rows
+    of D elements. When the innermost dimension of the input stays innermost, the rows are copied with vector loads and
+    stores. Otherwise the output is computed by square tiles that read the input through a small cache:
+        CPU: the cache is laid out like the output, so it is filled by transposing blocks of vectors in registers, and
+            the tile is written to the output with vector stores.
+        GPU: each block of threads stages its tile in shared memory, read along the input and written along the output
+            so that both are coalesced, with padding against bank conflicts.
+    The outermost loop is parallelized on CPU targets with enough threads and elements.
+
+    Args:
+        shape: The shape of the input.
+        axes: The dimension of the input that each dimension of the output is.
+        element_type: The element type of the input and the output.
+        target: The target of the plan.
+        tile: The size of the tiles of a transpose, which defaults to a few vectors on CPU targets and to 16 on GPU targets.
+
+    Returns:
+        The plan and its arguments, the input and the output. The arrays have the collapsed shapes, which have the same
+        elements in the same order as the row-major input and output, so these can be passed to the function of the
+        plan as they are.
+    """
+    if sorted(axes) != list(range(len(shape))):
+        raise ValueError("The axes of a permute must be a permutation of the dimensions of the input")
+    if tile is not None and tile < 1:
+        raise ValueError("The tile of a permute must be positive")
+
+    in_shape, axes = _collapse_permutation(tuple(shape), tuple(axes))
+    out_shape = tuple(in_shape[a] for a in axes)
+    rank = len(in_shape)
+
+    input = Array(role=Array.Role.INPUT, element_type=element_type, shape=in_shape)
+    output = Array(role=Array.Role.INPUT_OUTPUT, element_type=element_type, shape=out_shape)
+
+    def body(input, output, indices):
+        in_indices = [None] * rank
+        for d, a in enumerate(axes):
+            in_indices[a] = indices[d]
+        output[tuple(indices)] = input[tuple(in_indices)]
+
+    nest = Nest(shape=list(out_shape))
+    indices = nest.get_indices()
+    nest.iteration_logic(_permute_logic(input, output, tuple(indices), body))
+    schedule = nest.create_schedule()
+
+    # q is the innermost dimension of the output, p is the one that walks along the innermost dimension of the input
+    q = rank - 1
+    p = axes.index(rank - 1)
+    outer = [indices[d] for d in range(rank) if d not in [p, q]]
+    num_elements = 1
+    for extent in out_shape:
+        num_elements *= extent
+
+    if target.category == Target.Category.GPU:
+        tile = tile or _GPU_TILE
+        if p == q:
+            if out_shape[q] % (tile * tile):
+                raise ValueError("The innermost dimension of a GPU permute must be a multiple of the threads of a block")
+            qq = schedule.split(indices[q], tile * tile)
+            schedule.reorder(outer + [indices[q], qq])
+            plan = schedule.create_plan(target)
+            mapping = {indices[q]: target.GridUnit.BLOCK_X, qq: target.GridUnit.THREAD_X}
+            if outer:
+                mapping[outer[-1]] = target.GridUnit.BLOCK_Y
+            plan.bind(mapping=mapping)
+            return plan, (input, output)
+
+        if out_shape[p] % tile or out_shape[q] % tile:
+            raise ValueError("The transposed dimensions of a GPU permute must be multiples of the tile")
+        pp = schedule.split(indices[p], tile)
+        qq = schedule.split(indices[q], tile)
+        schedule.reorder(outer + [indices[p], indices[q], pp, qq])
+        plan = schedule.create_plan(target)
+        mapping = {
+            indices[q]: target.GridUnit.BLOCK_X,
+            indices[p]: target.GridUnit.BLOCK_Y,
+            qq: target.GridUnit.THREAD_X,
+            pp: target.GridUnit.THREAD_Y
+        }
+        if outer:
+            mapping[outer[-1]] = target.GridUnit.BLOCK_Z
+        plan.bind(mapping=mapping)
+        plan.cache(input, index=pp, location=_MemorySpace.SHARED, layout=Array.Layout.FIRST_MAJOR, padding=AUTO)
+        return plan, (input, output)
+
+    lanes = max(1, target.vector_bytes // _ELEMENT_BYTES[element_type])
+
+    vectorized = None
+    if p == q:
+        # A copy of rows
+        extent = out_shape[q]
+        block = lanes * _VECTORS_PER_ITERATION
+        if target.vector_bytes and extent >= lanes:
+            vectorized = schedule.split(indices[q], block) if extent > block else indices[q]
+        plan = schedule.create_plan(target)
+        if vectorized is not None:
+            plan.vectorize(vectorized, masked=True)
+    else:
+        tile = tile or lanes * _VECTORS_PER_TILE
+        pp = schedule.split(indices[p], min(tile, out_shape[p]))
+        qq = schedule.split(indices[q], min(tile, out_shape[q]))
+        schedule.reorder(outer + [indices[p], indices[q], pp, qq])
+        plan = schedule.create_plan(target)
+
+        # The cache of the tile of the input is contiguous along the output, which makes its fill a transpose
+        cache = plan.cache(input, index=pp, layout=Array.Layout.FIRST_MAJOR)
+        cache.dimension_order = tuple(d for d in range(rank) if d != axes[q]) + (axes[q], )
+        if target.vector_bytes:
+            vectorized = qq
+            plan.vectorize(qq, masked=True)
+
+    outermost = schedule.get_indices()[0]
+    if target.num_threads > 1 and num_elements >= _MIN_PARALLEL_ELEMENTS and outermost is not vectorized:
+        plan.parallelize(outermost)
+
+    return plan, (input, output)
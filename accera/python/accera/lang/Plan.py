@@ -19,7 +19,29 @@ from ..Targets import GridUnits, Target
 from ..Platforms import LibraryDependency
 from ..Constants import AUTO
 
-from .._lang_python._lang import BarrierScope, CacheIndexing, _MemorySpace
+from .._lang_python import ScalarType
+from .._lang_python._lang import BarrierScope, CacheIndexing, _CacheAllocation, _MemorySpace
+
+_ELEMENT_BYTES = {
+    ScalarType.bool: 1,
+    ScalarType.int8: 1,
+    ScalarType.int16: 2,
+    ScalarType.int32: 4,
+    ScalarType.int64: 8,
+    ScalarType.uint8: 1,
+    ScalarType.uint16: 2,
+    ScalarType.uint32: 4,
+    ScalarType.uint64: 8,
+    ScalarType.float16: 2,
+    ScalarType.bfloat16: 2,
+    ScalarType.float32: 4,
+    ScalarType.float64: 8,
+}
+
+# Registers of a GPU thread, which are 32 bits wide, and the share of them left to the addresses, loop counters and
+# temporaries of the kernel when register caches are sized
+_MAX_REGISTERS_PER_THREAD = 255
+_RESERVED_REGISTERS_PER_THREAD = 32
 
 class Plan:
     def __init__(self, schedule: Schedule, target: Target = Target.HOST):
@@ -30,6 +52,11 @@ class Plan:
         self._index_attrs: Mapping[LoopIndex, List[str]] = {}
         self._dynamic_dependencies = set()
         self._bindings = {}
+        self._parallel_bands: List[Tuple[List[LoopIndex], Optional[int]]] = []
+        self._hardware_level_caches: List[Cache] = []
+        self._shared_memory_caches: List[Cache] = []
+        self._array_caches: List[Cache] = []    # the caches of arrays, which choose the deferred layouts of arguments
+        self._occupancy: float = None
 
         if target.category == Target.Category.GPU and target.runtime == Target.Runtime.VULKAN:
             self._dynamic_dependencies.add(LibraryDependency.VULKAN)
@@ -52,6 +79,9 @@ class Plan:
             self._delayed_calls[partial(self.unroll)] = index
             return None
 
+        if "unroll_and_jammed" in self._index_attrs.get(index, []):
+            raise ValueError("An unrolled and jammed index can't be unrolled")
+
         self._add_index_attr(index, "unrolled")
         self._commands.append(partial(self._unroll, index))
 
@@ -61,13 +91,49 @@ class Plan:
         # TODO: Move to final location depending on where unroll should be
         context.schedule.unroll(native_index)
 
-    def vectorize(self, index: Union[LoopIndex, DelayedParameter]):
+    def unroll_and_jam(self, index: Union[LoopIndex, DelayedParameter], factor: Union[int, DelayedParameter]):
+        """Unrolls the loop along a dimension and jams the unrolled copies of its body together in the loops it contains,
+        so that the iterations of the dimension are interleaved in the inner loops instead of running one after the
+        other. Unrolling and jamming an output dimension of a reduction keeps one accumulator per copy in flight in the
+        reduction loop, which hides the latency of the accumulating instructions.
+
+        Args:
+            index: The dimension to unroll and jam, which is ordered before the loops to interleave its iterations in
+            factor: The number of iterations to interleave
+        """
+        if isinstance(index, DelayedParameter) or isinstance(factor, DelayedParameter):
+            self._delayed_calls[partial(self.unroll_and_jam)] = {"index": index, "factor": factor}
+            return None
+
+        if not isinstance(factor, int) or factor < 1:
+            raise ValueError("The unroll-and-jam factor must be an integer >= 1")
+        if "unrolled" in self._index_attrs.get(index, []):
+            raise ValueError("An unrolled index can't be unrolled and jammed")
+
+        # interleaving the iterations of the index moves a strip of them inside the loops that follow it
+        if self._sched._get_violated_dependence(self._sched._indices + [index]) is not None:
+            raise ValueError(
+                "Unrolling and jamming the index reverses a dependence between iterations of the iteration logic "
+                "that access the same array element"
+            )
+
+        self._add_index_attr(index, "unroll_and_jammed")
+        self._commands.append(partial(self._unroll_and_jam, index, factor))
+
+    def _unroll_and_jam(self, index, factor, context: NativeLoopNestContext):
+        native_index = context.mapping[id(index)]
+        context.schedule.interleaved_unroll(native_index, factor)
+
+    def vectorize(self, index: Union[LoopIndex, DelayedParameter], masked: bool = False):
         """Only available for targets that have SIMD registers and support vector instructions. Marks a dimension of the iteration-space for vectorization.
         Args:
             index: The index to vectorize
+            masked: Whether loops of this index that have fewer iterations than a vector register holds, such as the
+                boundary fragment of a split that doesn't divide the dimension evenly, are vectorized over full vector
+                registers with masked loads and stores instead of being unrolled into scalar code.
         """
         if isinstance(index, DelayedParameter):
-            self._delayed_calls[partial(self.vectorize)] = index
+            self._delayed_calls[partial(self.vectorize, masked=masked)] = index
             return None
 
         if not self._target.vectorization_info:
@@ -75,7 +141,9 @@ class Plan:
 
         self._add_index_attr(index, "vectorized")
 
-        self._commands.append(partial(self._vectorize, index, self._target.vectorization_info))
+        vectorization_info = self._target.vectorization_info
+        vectorization_info.masked = masked
+        self._commands.append(partial(self._vectorize, index, vectorization_info))
 
     def _vectorize(self, index, vectorization_info, context: NativeLoopNestContext):
         context.plan.vectorize(context.mapping[id(index)], vectorization_info)
@@ -83,8 +151,13 @@ class Plan:
     def parallelize(
         self,
         indices: Union[LoopIndex, Tuple[LoopIndex], DelayedParameter],
-        pin: Union[Tuple[Any], DelayedParameter] = None,
-        policy: Union[str, DelayedParameter] = "static"
+        pin: Union[str, Tuple[int], DelayedParameter] = None,
+        policy: Union[str, DelayedParameter] = "static",
+        num_threads: Union[int, DelayedParameter] = None,
+        chunk_size: Union[int, DelayedParameter] = None,
+        reduction: Union[Array, Tuple[Array]] = None,
+        deterministic: bool = False,
+        _check_dependences: bool = True
     ):
         """Performs one or more loops in parallel on multiple cores or processors.
         Only available for targets with multiple cores or processors.
@@ -97,17 +170,51 @@ class Plan:
                 Unsplit indices will be assigned one thread each, split indices
                 will be assigned threads based on the number of split blocks.
                 This is limited by the number of threads supported by the target.
-            pin: Pin the computation to a subset of cores or processors.
-            policy: The scheduling policy to apply ("dynamic" or "static").
+
+                Calling `parallelize` again on indices nested inside this band creates
+                a nested parallel level, which shares the threads of the enclosing level.
+            pin: Pin the threads to the cores or processors of the target, either as a placement policy
+                relative to the thread that starts the parallel region ("close", "spread" or "primary"),
+                or as a tuple of processor ids that the threads are pinned to in thread order.
+                Pinned loops allocate their private caches on the thread that uses them (first-touch),
+                so that the cache memory is local to the NUMA node that runs the thread.
+            policy: The scheduling policy to apply ("dynamic", "static", "guided" or "work_stealing").
+            num_threads: The maximum number of threads for this parallel level.
+                Defaults to the threads left by the enclosing parallel levels.
+            chunk_size: The number of iterations handed to a thread at a time. For the "guided" policy,
+                this is the minimum number of iterations. Defaults to the chunking of the policy.
+            reduction: The arrays that the iterations of the parallelized indices accumulate into, for instance the
+                output of a matrix multiplication when parallelizing its reduction index (split-K). Each iteration
+                accumulates into its own zero-initialized cache at the index that follows the parallelized indices,
+                and the caches are atomically added to the arrays.
+            deterministic: Whether the partial results of a parallel reduction are combined in a fixed order, so that
+                the result is bitwise reproducible whatever the number of threads of the target. Each iteration of the
+                parallelized indices is a chunk of the reduction, whose number is fixed by the splits of the schedule,
+                and accumulates its caches into its own copy of the arrays. The copies are summed pairwise in a fixed
+                tree order after the parallel loop, and the sum is added to the arrays. This needs a copy of each array
+                per chunk, so the parallelized indices are usually the few blocks of a split of the reduction index.
+
+        Remarks:
+            The iterations of the parallelized indices must not depend on each other: an array element that one
+            iteration writes must not be read or written by another one, unless the array is a `reduction` array.
         """
         if self._target.category == Target.Category.CPU:
             self._dynamic_dependencies.add(LibraryDependency.OPENMP)
+            if policy == "work_stealing" or self._target.runtime == Target.Runtime.THREAD_POOL or isinstance(
+                pin, (tuple, list)
+            ):
+                self._dynamic_dependencies.add(LibraryDependency.ACCERA_RUNTIME)
 
-        if any([isinstance(arg, DelayedParameter) for arg in [indices, pin, policy]]):
+        if any([isinstance(arg, DelayedParameter) for arg in [indices, pin, policy, num_threads, chunk_size]]):
             self._delayed_calls[partial(self.parallelize)] = {
                 "indices": indices,
                 "pin": pin,
-                "policy": policy
+                "policy": policy,
+                "num_threads": num_threads,
+                "chunk_size": chunk_size,
+                "reduction": reduction,
+                "deterministic": deterministic,
+                "_check_dependences": _check_dependences
             }
             return None
 
@@ -119,22 +226,112 @@ class Plan:
         if end > len(self._sched._indices) or indices != self._sched._indices[start:end]:
             raise ValueError("indices must be contiguous in the Schedule dimension order")
 
+        if any("parallelized" in self._index_attrs.get(index, []) for index in indices):
+            raise ValueError("indices can only be parallelized once")
+
+        if num_threads is not None and num_threads < 1:
+            raise ValueError("num_threads must be a positive integer")
+
+        if chunk_size is not None and chunk_size < 1:
+            raise ValueError("chunk_size must be a positive integer")
+
+        if isinstance(pin, str):
+            if pin not in ["close", "spread", "primary"]:
+                raise ValueError(f"Unsupported pin policy: {pin}")
+        elif pin is not None:
+            pin = tuple(pin)
+            if not pin or any(not isinstance(p, int) or p < 0 for p in pin):
+                raise ValueError("pin must be a non-empty tuple of processor ids")
+
+            # one thread per processor unless requested otherwise
+            num_threads = num_threads or len(pin)
+
+        if reduction is not None:
+            reduction = [reduction] if isinstance(reduction, Array) else list(reduction)
+            if self._target.category != Target.Category.CPU:
+                raise ValueError("Parallel reductions are only supported on CPU targets")
+            if end == len(self._sched._indices):
+                raise ValueError("Parallel reductions require an index after the parallelized indices")
+            if any(array.role not in [Array.Role.INPUT_OUTPUT, Array.Role.TEMP] for array in reduction):
+                raise ValueError("Parallel reductions are only supported for INPUT_OUTPUT and TEMP arrays")
+        elif deterministic:
+            raise ValueError("Only parallel reductions can be deterministic")
+
+        if _check_dependences and any(
+            not any(array is r for r in reduction or [])
+            for array in self._sched._get_carried_dependences(self._sched._indices, indices)
+        ):
+            raise ValueError(
+                "The indices carry a dependence between iterations of the iteration logic that access the same "
+                "array element, which is only allowed for reduction arrays"
+            )
+
         for index in indices:
             self._add_index_attr(index, "parallelized")
 
-        self._commands.append(partial(self._parallelize, indices, policy))
+        self._parallel_bands.append((indices, num_threads))
+        self._commands.append(
+            partial(self._parallelize, indices, policy, num_threads, pin, chunk_size, bool(reduction), deterministic)
+        )
+
+        # the partial results of each iteration are accumulated in a private cache inside the parallel loop
+        for array in reduction or []:
+            self.cache(array, index=self._sched._indices[end])
 
-    def _parallelize(self, indices, policy, context: NativeLoopNestContext):
-        from .._lang_python._lang import _ParallelizationPolicy
+    def _get_parallel_num_threads(self, indices, num_threads):
+        # Nested parallel levels share the threads of the target with the levels that enclose them
+        start = self._sched._indices.index(indices[0])
+        available_threads = self._target.num_threads
+        for outer_indices, outer_num_threads in self._parallel_bands:
+            if self._sched._indices.index(outer_indices[0]) < start:
+                available_threads //= self._get_parallel_num_threads(outer_indices, outer_num_threads)
+        available_threads = max(1, available_threads)
+
+        # num_threads = number of split blocks, clamped by the number of threads available to this level
+        requested_threads = min(num_threads, available_threads) if num_threads else available_threads
+        return min(requested_threads, self._sched._get_num_split_blocks(indices))
+
+    def _parallelize(
+        self, indices, policy, num_threads, pin, chunk_size, reduction, deterministic, context: NativeLoopNestContext
+    ):
+        from .._lang_python._lang import _ParallelizationPolicy, _ParallelizationPinning
 
-        # num_threads = number of split blocks, clamped by the number of threads supported by this target
-        num_threads = min(self._target.num_threads, self._sched._get_num_split_blocks(indices))
+        num_threads = self._get_parallel_num_threads(indices, num_threads)
         logging.debug(f"Parallelizing with {num_threads} thread(s)")
 
         idxs = [context.mapping[id(index)] for index in indices]
 
+        policies = {
+            "static": _ParallelizationPolicy.STATIC,
+            "dynamic": _ParallelizationPolicy.DYNAMIC,
+            "guided": _ParallelizationPolicy.GUIDED,
+            "work_stealing": _ParallelizationPolicy.WORK_STEALING
+        }
+        if policy not in policies:
+            raise ValueError(f"Unsupported parallelization policy: {policy}")
+
+        pinning = {
+            "close": _ParallelizationPinning.CLOSE,
+            "spread": _ParallelizationPinning.SPREAD,
+            "primary": _ParallelizationPinning.PRIMARY
+        }
+        if pin is None:
+            pin_policy, processors = _ParallelizationPinning.DEFAULT, []
+        elif isinstance(pin, str):
+            pin_policy, processors = pinning[pin], []
+        else:
+            pin_policy, processors = _ParallelizationPinning.CLOSE, list(pin)
+
         context.plan.parallelize(
-            idxs, num_threads, _ParallelizationPolicy.DYNAMIC if policy == "dynamic" else _ParallelizationPolicy.STATIC
+            idxs,
+            num_threads,
+            policies[policy],
+            pinning=pin_policy,
+            processors=processors,
+            first_touch=pin is not None,
+            chunk_size=chunk_size or 0,
+            reduction=reduction,
+            deterministic=deterministic
         )
 
 
@@ -142,8 +339,14 @@ class Plan:
         self,
         indices: Union[LoopIndex, Tuple[LoopIndex]]
     ):
-        if self._target.category != Target.Category.GPU:
-            raise ValueError("tensorization currently only supported on GPU targets")
+        if self._target.category == Target.Category.CPU:
+            if not {"AMX-INT8", "AMX-BF16"} & set(self._target.extensions):
+                raise ValueError("tensorization on CPU targets requires the AMX-INT8 or AMX-BF16 extensions")
+
+            # the permission to use the AMX tile registers is requested by the acc-runtime library
+            self._dynamic_dependencies.add(LibraryDependency.ACCERA_RUNTIME)
+        elif self._target.category != Target.Category.GPU:
+            raise ValueError("tensorization currently only supported on GPU and AMX targets")
 
         indices = [indices] if isinstance(indices, LoopIndex) else list(indices)
 
@@ -176,7 +379,18 @@ class Plan:
             if step != 1:
                 raise ValueError("The tensorization index stride must be contiguous")
             tensorize_dims.append(stop)
-        if not self._target.tensor_core.supports(input_type=ScalarType.float32, output_type=ScalarType.float32, shape=tensorize_dims) and \
+
+        if self._target.category == Target.Category.CPU:
+            # An AMX tile holds 16 rows of 64 bytes. The rows of the B tile interleave 4 bytes of each column, which
+            # is 4 8-bit integers or 2 bfloat16 values of the reduction index.
+            M, N, K = tensorize_dims
+            max_K = 64 if "AMX-INT8" in self._target.extensions else 32
+            if M > 16 or N > 16 or K > max_K or K % 2:
+                raise ValueError(
+                    f"The AMX tiles do not support the tensorization dimensions with shape={tensorize_dims}, "
+                    f"which must be at most [16, 16, {max_K}] with an even reduction dimension"
+                )
+        elif not self._target.tensor_core.supports(input_type=ScalarType.float32, output_type=ScalarType.float32, shape=tensorize_dims) and \
             not self._target.tensor_core.supports(input_type=ScalarType.float16, output_type=ScalarType.float32, shape=tensorize_dims):
             raise ValueError("The target does not support the given tensorization dimensions with shape=", tensorize_dims)
 
@@ -184,6 +398,36 @@ class Plan:
 
         context.plan.tensorize(indices=idxs, dims=tensorize_dims)
 
+    def profile(self, indices: Union[LoopIndex, Tuple[LoopIndex], DelayedParameter]):
+        """Times the loops of one or more dimensions in profile regions, when the package is built with
+        `profile=Package.Profile.LOOPS`. The region of a dimension is named after the function and the dimension, and
+        times each run of the loop with the loops it contains. The loops of a dimension that is split into several
+        loops, such as the boundary blocks, share the region. The marks are ignored when loops aren't profiled.
+
+        Args:
+            indices: The dimension or dimensions whose loops are profiled
+        """
+        if isinstance(indices, DelayedParameter):
+            self._delayed_calls[partial(self.profile)] = indices
+            return None
+
+        if self._target.category != Target.Category.CPU:
+            raise ValueError("Profiling loops is only supported on CPU targets")
+
+        indices = [indices] if isinstance(indices, LoopIndex) else list(indices)
+        for index in indices:
+            self._add_index_attr(index, "profiled")
+        self._commands.append(partial(self._profile, indices))
+
+    def _profile(self, indices, context: NativeLoopNestContext):
+        # the regions would be in the body of the vector or tile instructions, which only hold the iteration logic
+        order = self._sched._indices
+        for index in indices:
+            outer_indices = order[:order.index(index)] if index in order else []
+            if any({"vectorized", "tensorized"} & set(self._index_attrs.get(outer, [])) for outer in outer_indices):
+                raise ValueError("The loops inside a vectorized or tensorized loop can't be profiled")
+            context.plan.profile(context.mapping[id(index)])
+
     def cache(
         self,
         source: Union[Array, Cache],
@@ -193,11 +437,18 @@ class Plan:
         max_elements: int = None,
         thrifty: Union[bool, DelayedParameter] = None,
         location: _MemorySpace = _MemorySpace.NONE,
-        level: Union[int, DelayedParameter] = None,
+        level: Union[int, Target.CacheLevel, DelayedParameter] = None,
         trigger_level: Union[int, DelayedParameter] = None,
         double_buffer: Union[bool, DelayedParameter] = False,
         double_buffer_location: Union[object, _MemorySpace, DelayedParameter] = AUTO,
         vectorize: Union[bool, DelayedParameter, object] = AUTO,
+        cooperative: bool = False,
+        prefetch_distance: int = None,
+        nontemporal_write_back: bool = False,
+        padding: Union[int, object] = None,
+        panel: Tuple[int, Union[int, LoopIndex, object]] = None,
+        epilogue: List[Union[str, Tuple]] = None,
+        element_type: ScalarType = None,
         _delayed_cache: DelayedCache = None
     ):
         """Adds a cache for a view target
@@ -208,18 +459,63 @@ class Plan:
             trigger_index: The index used to determine what level to fill the cache at. `trigger_index` can't come after `index` in the schedule order, and will default to `index` if not specified. Specify at most one of `trigger_index` or `trigger_level`.
             layout: The affine memory map, if different from the source.
             level: The key-slice level to cache (the number of wildcard dimensions in a key-slice). Specify one and only one of `index`, `level`, `max_elements`.
+                Alternatively, a `Target.CacheLevel` (L1, L2 or L3) of a CPU target, in which case `max_elements` is derived from the size of that level
+                in `Target.cache_sizes`, shared evenly between all the caches of the plan placed at the same level.
+                On GPU targets, `Target.CacheLevel.REGISTERS` makes a private cache that is sized to stay in the registers of each thread: `max_elements`
+                is derived from the `max_registers_per_block` of the target and the number of threads of the block, less a share kept for the rest of
+                the kernel, shared evenly between the register caches of the plan. The cache is placed at the outermost index whose active block fits,
+                without leaving the loops bound to GPU units or the cache it is copied from, and when even the innermost active block would spill
+                the cache isn't created, so that the accesses read its source (e.g. a shared memory cache) instead. The placement of each register cache
+                is listed in the `gpu_resource_report` of `Package.build`.
+                On GPU targets, `Target.CacheLevel.SHARED` makes a shared memory cache that is sized against the `max_shared_memory_per_block` of
+                the target: the bytes left by the other shared memory caches of the plan that have a `max_elements` budget are shared evenly between
+                the caches at this level, and a cache whose `double_buffer_location` is `MemorySpace.SHARED` takes two shares. With the `occupancy`
+                of `bind`, the caches leave room for as many blocks per multiprocessor as that occupancy needs. The cache is placed at the outermost
+                index whose active block fits, without leaving the loops bound to GPU blocks. The shared memory caches at an `index` or `level` aren't
+                accounted for.
             trigger_level: The key-slice level to fill the cache at. `trigger_level` can't be smaller than `level`, and will default to `level` if not specified. Specify at most one of `trigger_index` or `trigger_level`.
             max_elements: The maximum elements to include in the cached region. Specify one and only one of `index`, `level`, `max_elements`.
             thrifty: Use thrifty caching (copy data into a cache only if the cached data differs from the original active block). This defaults to False as it slows down compilation speed so it is intended as an opt-in feature.
             double_buffer: Make this a double buffer cache by copying data one iteration ahead and using private memory on GPU for this procedure.
+                On CPU targets, the next iteration's data is prefetched instead, overlapping its transfer with the compute on the current active block.
             vectorize: Whether to vectorize the cache operations. Defaults to AUTO, which will behave like vectorize=True if the loopnest has a vectorized loop or vectorize=False if the loopnest has no vectorized loops.
             double_buffer_location: The memory space used for storing iteration data for the double buffer cache. Requires that double_buffer is set to True. Defaults to AUTO.
+                On CUDA targets, a MemorySpace.SHARED temp array of a shared memory cache is filled with asynchronous copies from global memory.
                 AUTO will configure the double buffering location based on the following:
                 | location            | double_buffer | double_buffer_location = `AUTO` |
                 | ------------------- | ------------- | ------------------------------- |
                 | MemorySpace.SHARED  | True          | MemorySpace.PRIVATE             |
                 | !MemorySpace.SHARED | True          | Same value as location          |
+            cooperative: Copy the data in and out of the cache with all the threads of the parallel loop that uses it,
+                instead of with the single thread that runs the code outside of that loop. Only available for CPU targets.
+            prefetch_distance: Issue software prefetches for the active block that the cache will be filled with this many iterations
+                of the trigger loop ahead, so that its data is already in the hardware caches when the fill runs. Only available for CPU targets.
+            nontemporal_write_back: Write the cache data back to the array with non-temporal (streaming) stores that bypass the hardware caches,
+                for outputs that are large and not read again by the function. Only available for CPU targets.
+            padding: The number of elements to add to the innermost dimension of the cache buffer, so that its rows don't map onto the same
+                hardware cache sets (CPU) or shared memory banks (GPU). AUTO pads only the caches whose row size causes this aliasing.
+                Not supported with a memory map (tuple) layout.
+            panel: A (dimension, size) pair that stores the cache as contiguous panels of `size` elements of the given dimension of the source,
+                i.e. the packed format a register-tiled kernel streams through. The size can be a LoopIndex, whose range is used, or AUTO,
+                which uses the range of the vectorized index. Not supported with a memory map (tuple) layout.
+            epilogue: Elementwise steps applied in order to each element of an accumulated output (e.g. C += A @ B) as the cache is
+                reduced back into the array, while the active block is still in the cache: ("bias", array, dimension) adds the element
+                of a rank-1 array at the position of the output's given dimension, ("scale", value) multiplies by a constant,
+                ("clamp", min, max) clamps to bounds that can be None, and "relu" is ("clamp", 0, None). The cache must be the
+                outermost cache of the array, at an index outside all of the loops of the reduction, so that each element is
+                written back once. Only available for CPU targets.
+            element_type: The element type that the cache stores, if different from the source, e.g. `ScalarType.float16` for a
+                `ScalarType.float32` array. The elements are converted when the cache is filled and converted back when it is written
+                back or reduced into the array, halving the footprint of the cache while the function keeps its interface. A wider type
+                than the array's is the accumulator type of the array, e.g. `ScalarType.float32` for a `ScalarType.float16` output: the
+                accumulations into the cache and its reduction into the array are computed in it. Converts between floating-point types,
+                or between integer types of the same signedness. The cache must be the outermost cache of the array, and can't be
+                thrifty. Only available for CPU targets.
         """
+        if isinstance(source, Array) and source._blocked_layout:
+            # the accesses of the logic divide the indices by the block shape, the cache regions are affine
+            raise ValueError("Arrays with a blocked layout can't be cached")
+
         if any([isinstance(arg, DelayedParameter) for arg in (index, trigger_index, level, trigger_level, thrifty, double_buffer, double_buffer_location, vectorize, layout)]) or \
             (isinstance(source, DelayedCache) and not source.completed):
             # If any of the cache level arguments are parameters, then this cache call is incomplete until those parameters
@@ -234,6 +530,13 @@ class Plan:
                 source=source,
                 max_elements=max_elements,
                 location=location,
+                cooperative=cooperative,
+                prefetch_distance=prefetch_distance,
+                nontemporal_write_back=nontemporal_write_back,
+                padding=padding,
+                panel=panel,
+                epilogue=epilogue,
+                element_type=element_type,
                 _delayed_cache=delayed_cache
             )] = {
                 "index": index,
@@ -251,9 +554,61 @@ class Plan:
         if sum(i is not None for i in [index, level, max_elements]) != 1:
             raise ValueError("Specify one and only one of index, level, or max_elements")
 
-        if max_elements is not None and max_elements <= 0:
+        hardware_level = None
+        if isinstance(level, Target.CacheLevel):
+            hardware_level, level = level, None
+            if trigger_level is not None or trigger_index is not None:
+                raise ValueError("A trigger level or trigger index can't be combined with a hardware cache level")
+            if hardware_level == Target.CacheLevel.REGISTERS:
+                location = self._validate_register_cache(location)
+                if layout is None:
+                    layout = source._requested_layout
+                # provisional budget, the final budget is set once the block size and all caches are known
+                max_elements = self._get_register_budget(source, num_caches=1, threads_per_block=1)
+            elif hardware_level == Target.CacheLevel.SHARED:
+                location = self._validate_shared_memory_cache(location)
+                if layout is None:
+                    layout = source._requested_layout
+                # provisional budget, the final budget is set once the block size and all caches are known
+                max_elements = self._target.max_shared_memory_per_block // _ELEMENT_BYTES[self._get_element_type(source)]
+            else:
+                # provisional budget used to validate hierarchical caches, the final budget is set once all caches are known
+                max_elements = self._get_hardware_level_budget(source, hardware_level, num_caches=1)
+
+        if cooperative and self._target.category != Target.Category.CPU:
+            raise ValueError("Cooperative cache copies are only supported on CPU targets")
+
+        if prefetch_distance is not None:
+            if self._target.category != Target.Category.CPU:
+                raise ValueError("Cache prefetching is only supported on CPU targets")
+            if prefetch_distance <= 0:
+                raise ValueError("Prefetch distance must be greater than 0")
+
+        if nontemporal_write_back and self._target.category != Target.Category.CPU:
+            raise ValueError("Non-temporal write-back is only supported on CPU targets")
+
+        if padding is not None and padding is not AUTO and (not isinstance(padding, int) or padding < 0):
+            raise ValueError("Cache padding must be AUTO or a non-negative number of elements")
+
+        if panel is not None:
+            if not isinstance(panel, tuple) or len(panel) != 2:
+                raise ValueError("A cache panel is a (dimension, size) pair")
+            panel_dim, panel_size = panel
+            source_rank = len(source.shape if isinstance(source, Array) else source.target_shape)
+            if not isinstance(panel_dim, int) or not 0 <= panel_dim < source_rank:
+                raise ValueError("Cache panel dimension is out of range")
+            if not (panel_size is AUTO or isinstance(panel_size, LoopIndex) or (isinstance(panel_size, int) and panel_size > 0)):
+                raise ValueError("Cache panel size must be AUTO, a LoopIndex, or a positive number of elements")
+
+        if max_elements is not None and max_elements <= 0 and hardware_level != Target.CacheLevel.REGISTERS:
             raise ValueError("Max element count specified as a cache budget must be greater than 0")
 
+        if epilogue:
+            epilogue = self._validate_cache_epilogue(source, epilogue, thrifty)
+
+        if element_type is not None:
+            self._validate_cache_element_type(source, element_type, thrifty)
+
         if isinstance(source, Array):
             array_role = source.role
         elif isinstance(source, Cache):
@@ -262,6 +617,9 @@ class Plan:
         if double_buffer and array_role not in [Array.Role.CONST, Array.Role.INPUT]:
             raise ValueError("Double-buffering is only supported for CONST and INPUT arrays")
 
+        if nontemporal_write_back and array_role in [Array.Role.CONST, Array.Role.INPUT]:
+            raise ValueError("Non-temporal write-back is only supported for arrays that are written")
+
         if not double_buffer and double_buffer_location != AUTO:
             raise ValueError("double_buffer_location is only valid to specify when double_buffer is set to True")
 
@@ -327,8 +685,9 @@ class Plan:
             if trigger_level <= 0:
                 raise ValueError("Cache trigger level must be greater than or equal to 1")
 
-        if isinstance(source, Cache):
-            # The outer cache must have a higher cache level and a higher trigger level than this cache, or a higher max element budget
+        if isinstance(source, Cache) and hardware_level != Target.CacheLevel.REGISTERS:
+            # The outer cache must have a higher cache level and a higher trigger level than this cache, or a higher max element budget.
+            # Register caches are kept inside the cache they are copied from when they are lowered
             if source.max_elements is None and (source.level is None or source.trigger_level is None):
                 # If the outer cache doesn't have a max element budget, then it must have both a cache level and a cache trigger_level
                 raise ValueError("Given source cache doesn't have a cache level, trigger_level, or max_elements")
@@ -350,6 +709,12 @@ class Plan:
                         "Outer cache for a hierarchical cache must have a greater or equal cache level than the inner cache's trigger_level"
                     )
 
+        if padding is not None and isinstance(layout, tuple):
+            raise ValueError("Cache padding can't be combined with a memory map layout")
+
+        if panel is not None and isinstance(layout, tuple):
+            raise ValueError("Cache panels can't be combined with a memory map layout")
+
         cache = Cache(
             plan=self,
             target=source,
@@ -363,7 +728,15 @@ class Plan:
             location=location,
             double_buffer=double_buffer,
             double_buffer_location=double_buffer_location,
-            vectorize=vectorize
+            vectorize=vectorize,
+            cooperative=cooperative,
+            hardware_level=hardware_level,
+            prefetch_distance=prefetch_distance,
+            nontemporal_write_back=nontemporal_write_back,
+            padding=padding,
+            panel=panel,
+            epilogue=epilogue,
+            element_type=element_type
         )
 
         if _delayed_cache:
@@ -375,8 +748,207 @@ class Plan:
         else:
             self._commands.append(partial(self._add_cache, cache))
 
+        if hardware_level and not any(c is cache for c in self._hardware_level_caches):
+            self._hardware_level_caches.append(cache)
+        if location == _MemorySpace.SHARED and not any(c is cache for c in self._shared_memory_caches):
+            self._shared_memory_caches.append(cache)
+        if isinstance(source, Array) and not any(c is cache for c in self._array_caches):
+            self._array_caches.append(cache)
+
         return cache
 
+    def cache_hierarchy(
+        self,
+        source: Array,
+        levels: List[Target.CacheLevel] = None,
+        layout: Array.Layout = None,
+        thrifty: bool = None,
+        vectorize: Union[bool, object] = AUTO
+    ) -> Tuple[Cache]:
+        """Adds a hierarchy of caches of an array, one for each level of the CPU cache hierarchy of the target
+
+        Args:
+            source: The array to cache.
+            levels: The `Target.CacheLevel`s (L1, L2 or L3) to add a cache for. Defaults to all the levels in `Target.cache_sizes`.
+                A level that isn't larger than the next smaller level of the hierarchy is skipped, since its cache would have the same
+                active block.
+            layout: The layout of the outermost cache, if different from the source. The inner caches keep the layout of the
+                outermost cache, so that each one is copied from a contiguous block of the cache it is copied from.
+            thrifty: Use thrifty caching for each cache of the hierarchy.
+            vectorize: Whether to vectorize the cache operations. Defaults to AUTO.
+
+        Returns:
+            The caches, from the outermost (largest) to the innermost.
+        """
+        if self._target.category != Target.Category.CPU:
+            raise ValueError("Cache hierarchies are only supported on CPU targets")
+
+        if not isinstance(source, Array):
+            raise ValueError("A cache hierarchy is added for an array")
+
+        available_levels = [Target.CacheLevel(n + 1) for n in range(min(len(self._target.cache_sizes), 3))]
+        if levels is None:
+            levels = available_levels
+        if not levels:
+            raise ValueError(f"Target {self._target.name} has no cache sizes, specify Target(cache_sizes=...)")
+        for level in levels:
+            if level not in [Target.CacheLevel.L1, Target.CacheLevel.L2, Target.CacheLevel.L3]:
+                raise ValueError("A cache hierarchy is made of the L1, L2 and L3 levels")
+            if level not in available_levels:
+                raise ValueError(
+                    f"Target {self._target.name} has no size for cache level {level.name}, specify Target(cache_sizes=...)"
+                )
+
+        # From the innermost level, keep the levels that are larger than the previous kept one, since the caches
+        # of a hierarchy must have decreasing budgets
+        kept_levels = []
+        for level in sorted(set(levels), key=lambda l: l.value):
+            if not kept_levels or self._target.cache_sizes[level.value - 1] > self._target.cache_sizes[kept_levels[-1].value - 1]:
+                kept_levels.append(level)
+
+        caches = []
+        outer = source
+        for level in reversed(kept_levels):
+            outer = self.cache(
+                outer,
+                level=level,
+                layout=layout if not caches else caches[0].layout,
+                thrifty=thrifty,
+                vectorize=vectorize
+            )
+            caches.append(outer)
+        return tuple(caches)
+
+    def _validate_cache_element_type(self, source: Union[Array, Cache], element_type: ScalarType, thrifty: bool):
+        if self._target.category != Target.Category.CPU:
+            raise ValueError("Caches that convert their element type are only supported on CPU targets")
+        if not isinstance(source, Array):
+            raise ValueError("Only the outermost cache of an array can convert its element type")
+        if thrifty:
+            raise ValueError("Caches that convert their element type can't be thrifty")
+
+        float_types = [ScalarType.float16, ScalarType.bfloat16, ScalarType.float32, ScalarType.float64]
+        signed_types = [ScalarType.int8, ScalarType.int16, ScalarType.int32, ScalarType.int64]
+        unsigned_types = [ScalarType.uint8, ScalarType.uint16, ScalarType.uint32, ScalarType.uint64]
+        if not any(source.element_type in types and element_type in types for types in [float_types, signed_types, unsigned_types]):
+            raise ValueError(
+                "A cache can only convert between floating-point types, or between integer types of the same signedness"
+            )
+
+    def _validate_cache_epilogue(self, source: Union[Array, Cache], epilogue: List[Union[str, Tuple]], thrifty: bool):
+        if self._target.category != Target.Category.CPU:
+            raise ValueError("Cache epilogues are only supported on CPU targets")
+        if not isinstance(source, Array):
+            raise ValueError("Cache epilogues are only supported for the outermost cache of an array")
+        if source.role != Array.Role.INPUT_OUTPUT:
+            raise ValueError("Cache epilogues are only supported for INPUT_OUTPUT arrays")
+        if thrifty:
+            raise ValueError("Cache epilogues can't be combined with thrifty caching")
+
+        steps = []
+        for step in epilogue:
+            if step == "relu":
+                step = ("clamp", 0, None)
+            if not isinstance(step, tuple) or not step:
+                raise ValueError(f"Invalid cache epilogue step {step}")
+
+            kind, args = step[0], step[1:]
+            if kind == "bias":
+                if len(args) != 2:
+                    raise ValueError("A cache epilogue bias is a (\"bias\", array, dimension) tuple")
+                bias, dim = args
+                if not isinstance(bias, Array) or len(bias.shape) != 1 or bias.element_type != source.element_type:
+                    raise ValueError("A cache epilogue bias must be a rank-1 array of the element type of the cached array")
+                if not isinstance(dim, int) or not 0 <= dim < len(source.shape):
+                    raise ValueError("Cache epilogue bias dimension is out of range")
+                if bias.shape[0] != source.shape[dim]:
+                    raise ValueError("A cache epilogue bias must have the size of the dimension of the cached array it is indexed by")
+            elif kind == "scale":
+                if len(args) != 1 or not isinstance(args[0], (int, float)):
+                    raise ValueError("A cache epilogue scale is a (\"scale\", value) tuple")
+            elif kind == "clamp":
+                if len(args) != 2 or all(bound is None for bound in args):
+                    raise ValueError("A cache epilogue clamp is a (\"clamp\", min, max) tuple with at least one bound")
+                lower, upper = args
+                if lower is not None and upper is not None and lower > upper:
+                    raise ValueError("A cache epilogue clamp minimum must not be greater than its maximum")
+            else:
+                raise ValueError(f"Unknown cache epilogue step {kind}")
+            steps.append(step)
+        return steps
+
+    def _validate_register_cache(self, location: _MemorySpace):
+        if self._target.category != Target.Category.GPU:
+            raise ValueError("Register caches are only supported on GPU targets")
+        if location not in [_MemorySpace.NONE, _MemorySpace.PRIVATE]:
+            raise ValueError("Register caches must be located in MemorySpace.PRIVATE")
+        return _MemorySpace.PRIVATE
+
+    def _get_register_budget(self, source: Union[Array, Cache], num_caches: int, threads_per_block: int):
+        # 0 when the block leaves no registers to the caches, which then read their source
+        registers = min(self._target.max_registers_per_block // max(threads_per_block, 1), _MAX_REGISTERS_PER_THREAD)
+        registers -= _RESERVED_REGISTERS_PER_THREAD
+        element_type = source.element_type if isinstance(source, Array) else source.target_element_type
+        return max(registers * 4 // (_ELEMENT_BYTES[element_type] * num_caches), 0)
+
+    def _validate_shared_memory_cache(self, location: _MemorySpace):
+        if self._target.category != Target.Category.GPU:
+            raise ValueError("Shared memory cache levels are only supported on GPU targets")
+        if location not in [_MemorySpace.NONE, _MemorySpace.SHARED]:
+            raise ValueError("Shared memory cache levels must be located in MemorySpace.SHARED")
+        return _MemorySpace.SHARED
+
+    @staticmethod
+    def _get_element_type(source: Union[Array, Cache]):
+        return source.element_type if isinstance(source, Array) else source.target_element_type
+
+    def _get_shared_memory_budget(self, cache: Cache, threads_per_block: int):
+        # the multiprocessor is assumed to hold as much shared memory as a block can use, as in Target.estimate_occupancy
+        available_bytes = self._target.max_shared_memory_per_block
+        if self._occupancy:
+            warps_per_block = -(-threads_per_block // self._target.warp_size)
+            max_warps = self._target.max_threads_per_multiprocessor // self._target.warp_size
+            blocks = max(-(-int(self._occupancy * max_warps) // warps_per_block), 1)
+            available_bytes //= blocks
+
+        def num_buffers(c: Cache):
+            return 2 if c.double_buffer and c.double_buffer_location == _MemorySpace.SHARED else 1
+
+        shares = 0
+        for c in self._shared_memory_caches:
+            if c.hardware_level == Target.CacheLevel.SHARED:
+                shares += num_buffers(c)
+            elif c.max_elements is not None:
+                available_bytes -= c.max_elements * _ELEMENT_BYTES[self._get_element_type(c.target)] * num_buffers(c)
+
+        budget = available_bytes // (shares * _ELEMENT_BYTES[self._get_element_type(cache.target)])
+        if budget <= 0:
+            raise ValueError(
+                f"The shared memory caches of the plan don't fit in the {self._target.max_shared_memory_per_block} bytes of shared memory of a block"
+            )
+        return budget
+
+    def _get_hardware_level_budget(self, source: Union[Array, Cache], hardware_level: Target.CacheLevel, num_caches: int):
+        if self._target.category != Target.Category.CPU:
+            raise ValueError("Hardware cache levels are only supported on CPU targets")
+        if len(self._target.cache_sizes) < hardware_level.value:
+            raise ValueError(
+                f"Target {self._target.name} has no size for cache level {hardware_level.name}, specify Target(cache_sizes=...)"
+            )
+
+        element_type = source.element_type if isinstance(source, Array) else source.target_element_type
+        budget = self._target.cache_sizes[hardware_level.value - 1] * 1024 // (_ELEMENT_BYTES[element_type] * num_caches)
+        if budget <= 0:
+            raise ValueError(f"Cache level {hardware_level.name} is too small to hold {num_caches} caches")
+        return budget
+
+    def _is_under_parallel_band(self, index: Optional[LoopIndex]):
+        if index is None:
+            return False
+        pos = self._sched._indices.index(index)
+        # a cache at a parallelized index is filled before the parallel loop starts, so it is shared by the threads
+        return any(self._sched._indices.index(indices[0]) < pos for indices, _ in self._parallel_bands)
+
     def _add_cache(self, cache, context: NativeLoopNestContext):
         from ..Targets import Target
 
@@ -391,6 +963,19 @@ class Plan:
         if cache.vectorize:
             vectorization_info = self._target.vectorization_info
 
+        if cache.hardware_level:
+            # The caches placed at a hardware level are live at the same time, so they share its capacity
+            num_caches = sum(c.hardware_level == cache.hardware_level for c in self._hardware_level_caches)
+            if cache.hardware_level in [Target.CacheLevel.REGISTERS, Target.CacheLevel.SHARED]:
+                block = context.options.block
+                threads_per_block = block.x * block.y * block.z
+                if cache.hardware_level == Target.CacheLevel.REGISTERS:
+                    cache.max_elements = self._get_register_budget(cache.target, num_caches, threads_per_block)
+                else:
+                    cache.max_elements = self._get_shared_memory_budget(cache, threads_per_block)
+            else:
+                cache.max_elements = self._get_hardware_level_budget(cache.target, cache.hardware_level, num_caches)
+
         last_in_index = context.mapping[id(cache.index)] if cache.index else None
 
         trigger_index = context.mapping[id(cache.trigger_index)] if cache.trigger_index else last_in_index
@@ -416,14 +1001,21 @@ class Plan:
                 double_buffer_location=cache.double_buffer_location,
                 vectorization_info=vectorization_info
             )
+            if cache.hardware_level == Target.CacheLevel.REGISTERS:
+                cache.native_cache.set_register_cache()
         else:
+            allocation = cache.allocation
+            if allocation == _CacheAllocation.AUTO and self._is_under_parallel_band(cache.trigger_index or cache.index):
+                # A cache filled inside a parallel loop gets one buffer per thread instead of a buffer shared by all threads
+                allocation = _CacheAllocation.THREAD_LOCAL
+
             cache.native_cache = context.plan.add_cache(
                 target=target,
                 index=last_in_index,
                 trigger_index=trigger_index,
                 max_elements=cache.max_elements,
                 indexing=cache.indexing,
-                allocation=cache.allocation,
+                allocation=allocation,
                 location=cache.location,
                 memory_map=cache.memory_map,
                 dim_order=cache.dimension_permutation,
@@ -432,6 +1024,46 @@ class Plan:
                 double_buffer_location=cache.double_buffer_location,
                 vectorization_info=vectorization_info
             )
+            if cache.cooperative:
+                cache.native_cache.set_cooperative_copy()
+            if cache.prefetch_distance:
+                cache.native_cache.set_prefetch_distance(cache.prefetch_distance)
+            if cache.nontemporal_write_back:
+                cache.native_cache.set_nontemporal_write_back()
+            if cache.element_type is not None and cache.element_type != cache.target_element_type:
+                cache.native_cache.set_element_type(cache.element_type)
+            for step in cache.epilogue or []:
+                kind, args = step[0], step[1:]
+                if kind == "bias":
+                    bias, dim = args
+                    if id(bias) not in context.mapping:
+                        raise ValueError("A cache epilogue bias must be an argument of the function")
+                    cache.native_cache.add_epilogue_bias(context.mapping[id(bias)], dim)
+                elif kind == "scale":
+                    cache.native_cache.add_epilogue_scale(float(args[0]))
+                else:
+                    lower, upper = args
+                    cache.native_cache.add_epilogue_clamp(
+                        None if lower is None else float(lower), None if upper is None else float(upper)
+                    )
+
+        if cache.padding is AUTO:
+            cache.native_cache.set_automatic_padding()
+        elif cache.padding:
+            cache.native_cache.set_padding(cache.padding)
+
+        if cache.panel is not None:
+            panel_dim, panel_size = cache.panel
+            if panel_size is AUTO:
+                vectorized_indices = [index for index, attrs in self._index_attrs.items() if "vectorized" in attrs]
+                if not vectorized_indices:
+                    raise ValueError("An AUTO cache panel size requires a vectorized index")
+                panel_size = vectorized_indices[0]
+            if isinstance(panel_size, LoopIndex):
+                # the register tile spans the range of the index
+                start, stop, _ = self._sched.get_index_range(panel_size)
+                panel_size = stop - start
+            cache.native_cache.set_panel_layout(panel_dim, panel_size)
 
     def pack_and_embed_buffer(
         self, target, wrapper_fn_name, packed_buffer_name="", indexing=CacheIndexing.GLOBAL_TO_PHYSICAL
@@ -454,6 +1086,27 @@ class Plan:
             partial(self._pack_and_embed_buffer, target, wrapper_fn_name, packed_buffer_name, indexing)
         )
 
+    def pack_and_map_buffer(
+        self, target, wrapper_fn_name, packed_buffer_name="", indexing=CacheIndexing.GLOBAL_TO_PHYSICAL
+    ):
+        """Packs the given target like `pack_and_embed_buffer`, but writes the packed data to a `.bin` file that is
+        deployed next to the library instead of embedding it in the binary. The wrapping function memory-maps the file
+        the first time it runs, so loading the library stays fast and processes share the pages of the file.
+
+        Args:
+            target: The target being cached (e.g Array, Matrix, etc)
+            wrapper_fn_name: The name to give the wrapping function
+            packed_buffer_name: The name to give the packed constant buffer, the file is named after it
+            indexing: The cache indexing
+        """
+        if target.role != Array.Role.CONST:
+            raise ValueError("Can only pack and map constant data buffers")
+
+        # the mapping is done by the acc-runtime library
+        self._dynamic_dependencies.add(LibraryDependency.ACCERA_RUNTIME)
+
+        self._commands.append(partial(self._pack_and_map_buffer, target, wrapper_fn_name, packed_buffer_name, indexing))
+
     def emit_runtime_init_pack(
         self, target, packing_func_name, packed_buf_size_func_name, indexing=CacheIndexing.GLOBAL_TO_PHYSICAL
     ):
@@ -494,6 +1147,24 @@ class Plan:
             indexing,
         )
 
+    def _pack_and_map_buffer(
+        self,
+        target,
+        wrapper_fn_name,
+        packed_buffer_name,
+        indexing,
+        context: NativeLoopNestContext,
+    ):
+        constant_data_buffer = target
+        target = context.mapping[id(target)]
+        context.plan.pack_and_map_buffer(
+            target,
+            constant_data_buffer,
+            wrapper_fn_name,
+            packed_buffer_name,
+            indexing,
+        )
+
     def _emit_runtime_init_packing(
         self,
         target,
@@ -506,26 +1177,125 @@ class Plan:
         context.plan.emit_runtime_init_packing(target, packing_func_name, packed_buf_size_func_name, indexing)
 
     # TODO: Support parameters
-    def bind(self, mapping: Mapping[LoopIndex, GridUnits]):
+    def bind(
+        self,
+        mapping: Mapping[LoopIndex, GridUnits],
+        reduction: Mapping[LoopIndex, Union[Array, Tuple[Array]]] = None,
+        persistent: Union[bool, int] = False,
+        occupancy: float = None,
+        stream_k: bool = False
+    ):
         """Binds iteration space dimensions to GPU execution units
 
         Args:
             mapping: Mapping of indices to GPU thread or block identifiers
+            reduction: Mapping of bound indices whose iterations accumulate into the same array elements to the arrays
+                they accumulate into, for instance the output of a matrix multiplication when binding part of its
+                reduction index to a grid dimension (split-K). Each thread accumulates into its own zero-initialized
+                private cache at the index that follows the bound indices, and the caches are atomically added to
+                the arrays.
+            persistent: Whether to launch the kernel with a fixed number of blocks that loop over the blocks of its grid,
+                taking them from an atomic work counter, which saves the launch of a large grid for small problems.
+                True launches as many blocks as the multiprocessors of the target hold at once, based on the threads
+                per block, or an int sets the number of blocks. Grids that are no larger are launched as they are.
+                Only supported by the CUDA and ROCm runtimes.
+            occupancy: The fraction of the warps of a multiprocessor that the kernel should keep active, between 0 and 1,
+                which the caches at `Target.CacheLevel.SHARED` leave room for by sharing the shared memory of a
+                multiprocessor between as many blocks as that needs. Defaults to None, which gives a block all the
+                shared memory it can use.
+            stream_k: Whether to give the persistent kernel a Stream-K decomposition, for a reduction index bound to a
+                block dimension (split-K): each block runs an even share of the blocks of the grid, in which the blocks
+                of the split reduction index are consecutive, instead of taking them from a work counter. The partial
+                tiles that blocks share are fixed up by the atomic accumulation of the reduction, so the work is
+                balanced across the blocks even when the number of tiles isn't a multiple of the number of blocks.
+                Makes the kernel persistent if `persistent` isn't set. Only supported by the CUDA and ROCm runtimes.
+
+        An index bound to `GridUnits.DEVICE` is partitioned across the GPUs of the system: the function launches the
+        kernel once per iteration of the index, on device `iteration % device_count`, and waits for all the launches.
+        The arrays are neither split nor gathered, each device accesses its partition of the arrays in place, so they
+        must be accessible from all the devices, for instance managed memory. Only supported by the CUDA and ROCm
+        runtimes.
         """
 
         if self._target is not None and self._target.category == Target.Category.GPU:
-            self._commands.append(partial(self._bind, mapping))
+            device_indices = [index for index, proc in mapping.items() if proc == GridUnits.DEVICE]
+            if device_indices:
+                if self._target.runtime not in [Target.Runtime.CUDA, Target.Runtime.ROCM]:
+                    raise ValueError("Binding to devices is only supported by the CUDA and ROCm runtimes")
+                if len(device_indices) > 1:
+                    raise ValueError("Only one index can be bound to devices")
+                if reduction and device_indices[0] in reduction:
+                    raise ValueError("Indices bound to devices can't be reduction indices")
+            if stream_k and persistent is False:
+                persistent = True
+            if persistent is not False:
+                if self._target.runtime not in [Target.Runtime.CUDA, Target.Runtime.ROCM]:
+                    raise ValueError("Persistent kernels are only supported by the CUDA and ROCm runtimes")
+                if persistent is not True and (not isinstance(persistent, int) or persistent <= 0):
+                    raise ValueError("persistent must be a bool or a positive number of blocks")
+            if occupancy is not None:
+                if not 0 < occupancy <= 1:
+                    raise ValueError("occupancy must be greater than 0 and at most 1")
+                self._occupancy = occupancy
+
+            reduction = {
+                index: [arrays] if isinstance(arrays, Array) else list(arrays)
+                for index, arrays in (reduction or {}).items()
+            }
+            if reduction:
+                if any(index not in mapping for index in reduction):
+                    raise ValueError("Reduction indices must be bound to a GPU execution unit")
+                if any(
+                    array.role != Array.Role.INPUT_OUTPUT for arrays in reduction.values() for array in arrays
+                ):
+                    raise ValueError("GPU reductions are only supported for INPUT_OUTPUT arrays")
+                end = max(self._sched._indices.index(index) for index in mapping) + 1
+                if end == len(self._sched._indices):
+                    raise ValueError("GPU reductions require an index after the bound indices")
+
+            stream_k_dim = None
+            if stream_k:
+                block_units = [GridUnits.BLOCK_X, GridUnits.BLOCK_Y, GridUnits.BLOCK_Z]
+                split_indices = [index for index in reduction if mapping[index] in block_units]
+                if len(split_indices) != 1:
+                    raise ValueError("Stream-K requires exactly one reduction index bound to a block dimension")
+                stream_k_dim = block_units.index(mapping[split_indices[0]])
+
+            self._commands.append(partial(self._bind, mapping, list(reduction.keys()), persistent, stream_k_dim))
 
             for index, proc in mapping.items():
                 self._bindings[proc] = index
 
+            # the partial results of each thread are accumulated in a private cache inside the bound loops
+            reduction_arrays = []
+            for arrays in reduction.values():
+                reduction_arrays += [array for array in arrays if array not in reduction_arrays]
+            for array in reduction_arrays:
+                self.cache(array, index=self._sched._indices[end], location=_MemorySpace.PRIVATE)
+
         else:
             raise ValueError("Only supported on plans with GPU targets")
 
-    def _bind(self, mapping: Mapping[LoopIndex, GridUnits], context: NativeLoopNestContext):
+    def _bind(
+        self, mapping: Mapping[LoopIndex, GridUnits], reduction_indices: List[LoopIndex], persistent: Union[bool, int],
+        stream_k_dim: Optional[int], context: NativeLoopNestContext
+    ):
         for index, proc in mapping.items():
+            reduction = index in reduction_indices
             index = context.mapping[id(index)]
-            context.plan.map_index_to_processor(index, proc.value)
+            context.plan.map_index_to_processor(index, proc.value, reduction)
+
+        if persistent is not False:
+            grid, block = context.options.grid, context.options.block
+            num_blocks = persistent
+            if persistent is True:
+                threads_per_block = block.x * block.y * block.z
+                blocks_per_multiprocessor = max(self._target.max_threads_per_multiprocessor // threads_per_block, 1)
+                num_blocks = self._target.num_cores * blocks_per_multiprocessor
+            if 0 < num_blocks < grid.x * grid.y * grid.z:
+                context.plan.set_persistent_blocks(num_blocks)
+                if stream_k_dim is not None:
+                    context.plan.set_stream_k_dim(stream_k_dim)
 
     def kernelize(
         self,
@@ -571,6 +1341,61 @@ class Plan:
         for vidx in vindices:
             self.vectorize(vidx)
 
+    def microkernelize(self, i: LoopIndex, j: LoopIndex, k: LoopIndex, accumulator: Array) -> Tuple[LoopIndex]:
+        """Turns the innermost loops of a matrix multiplication into a register-blocked outer-product microkernel.
+
+        An accumulator tile of `mr` rows and `nr` columns is chosen from the vector registers of the target, so that
+        the tile, a vector of the second operand per tile column vector and a broadcast element of the first operand
+        fit in the registers together:
+
+            ii, jj, jjj = plan.microkernelize(i, j, k, C)
+
+        splits `i` by `mr` and `j` by `nr` and by the vector size, orders the loops as `i, j, k, ii, jj, jjj`, unrolls
+        `ii` and `jj`, vectorizes `jjj` and caches the tile of `C` at `k`, which keeps the accumulators in registers
+        across the reduction loop. Each reduction step then becomes a sequence of broadcast-FMAs.
+
+        Args:
+            i: The index of the rows of the accumulator
+            j: The index of the columns of the accumulator, which indexes its innermost dimension
+            k: The reduction index
+            accumulator: The array that is accumulated into
+
+        Returns:
+            The row, vector and vector element indices of the microkernel
+        """
+        from .._lang_python._lang import _GetMatMulMicrokernelShape
+
+        if not self._target.vectorization_info:
+            raise RuntimeError("The target does not support vectorization")
+
+        sched = self._sched
+        order = sched.get_indices()
+        if set(order[-3:]) != {i, j, k}:
+            raise ValueError("The microkernel indices must be the innermost indices of the schedule")
+
+        def extent(index):
+            begin, end, step = sched.get_index_range(index)
+            return (end - begin + step - 1) // step
+
+        rows, columns, vector_size = _GetMatMulMicrokernelShape(
+            vector_bytes=self._target.vector_bytes,
+            vector_registers=self._target.vector_registers,
+            element_bytes=_ELEMENT_BYTES[accumulator.element_type],
+            M=extent(i),
+            N=extent(j)
+        )
+
+        ii = sched.split(i, rows)
+        jj = sched.split(j, columns)
+        jjj = sched.split(jj, vector_size)
+        sched.reorder(order[:-3] + [i, j, k, ii, jj, jjj])
+
+        self.unroll(ii)
+        self.unroll(jj)
+        self.vectorize(jjj)
+        self.cache(accumulator, index=k)
+        return ii, jj, jjj
+
     def _build_native_context(self, context: NativeLoopNestContext):
 
         target = self._target
@@ -640,8 +1465,18 @@ class Plan:
         else:
             context.plan = context.schedule.create_plan()
 
-    def _build_with_native_context(self, context: NativeLoopNestContext):
+    def _build_with_native_context(self, context: NativeLoopNestContext, prepacked=()):
+        # The arrays that the function takes pre-packed are read from the packed buffer, which replaces their caches
+        for target, packing_func_name, packed_buf_size_func_name in prepacked:
+            self._emit_runtime_init_packing(
+                target, packing_func_name, packed_buf_size_func_name, CacheIndexing.GLOBAL_TO_PHYSICAL, context
+            )
+        prepacked_arrays = [target for target, _, _ in prepacked]
+
         for cmd in self._commands:
+            cached = _cached_array(cmd)
+            if cached is not None and any(cached is target for target in prepacked_arrays):
+                continue
             cmd(context)
 
     def _replay_delayed_calls(self):
@@ -670,7 +1505,17 @@ class Plan:
                 delayed_call(*resolved_params)
 
 
-def _build_native_nest(plan: "Plan", nest_args: List[Array]):
+def _cached_array(command) -> Array:
+    "Returns the array that a command of a plan caches, through the caches of caches, or None for other commands"
+    if not isinstance(command, partial) or getattr(command.func, "__name__", None) != "_add_cache":
+        return None
+    target = command.args[0].target
+    while isinstance(target, Cache):
+        target = target.target
+    return target
+
+
+def _build_native_nest(plan: "Plan", nest_args: List[Array], prepacked=()):
     from .._lang_python._lang import _Valor
 
     sched = plan._sched
@@ -701,12 +1546,20 @@ def _build_native_nest(plan: "Plan", nest_args: List[Array]):
 
         nest._build_with_native_context(loopnest_context)
         sched._build_with_native_context(loopnest_context)
-        plan._build_with_native_context(loopnest_context)
+        plan._build_with_native_context(loopnest_context, prepacked)
 
     return nest_wrapper_fn
 
 
-def _create_function(plan: "Plan", args: List[Array], public: bool = True, no_inline: bool = False) -> Function:
+def _create_function(
+    plan: "Plan", args: List[Array], public: bool = True, no_inline: bool = False, prepacked=()
+) -> Function:
+    """Creates the function of a plan.
+
+    Args:
+        prepacked: A (array, packing function name, packed buffer size function name) tuple for each argument that the
+            function takes packed in the layout of the plan's schedule, which replaces the caches of the argument.
+    """
     from secrets import token_hex
 
     name = f"nest_impl_{token_hex(16)}"
@@ -715,7 +1568,7 @@ def _create_function(plan: "Plan", args: List[Array], public: bool = True, no_in
         name=name,
         args=args,
         public=public,
-        definition=_build_native_nest(plan, args),
+        definition=_build_native_nest(plan, args, prepacked),
         no_inline=no_inline,
         target=plan._target,
     )
@@ -3,6 +3,7 @@
 # Licensed under the MIT License. See LICENSE in the project root for license information.
 ####################################################################################################
 
+import itertools
 from typing import List, Mapping, Tuple, Union, Callable, Any
 from dataclasses import dataclass, field
 from enum import Enum, auto
@@ -12,6 +13,11 @@ from .NativeLoopNestContext import NativeLoopNestContext
 from .Nest import Nest, LoopIndex
 from ..Targets import Target
 from ..Parameter import DelayedParameter
+from ..Constants import AUTO
+
+# assumed for targets that don't specify their caches
+_DEFAULT_CACHE_LINE_BYTES = 64
+_DEFAULT_L2_CACHE_KB = 256
 
 
 @dataclass
@@ -79,15 +85,27 @@ class Schedule:
     def get_indices(self):
         return self._indices.copy()
 
-    def create_plan(self, target: "accera.Target" = Target.HOST) -> "accera.Plan":
+    def create_plan(self, target: "accera.Target" = Target.HOST, auto_schedule: bool = False) -> "accera.Plan":
         """Creates a plan for running this schedule
 
         Args:
             target: Optional target specification. Defaults to the HOST
+            auto_schedule: Whether to pick the loop order, the tile sizes, the vectorized index and the caches of this
+                schedule from a model of the memory accesses of the iteration logic on the target, as a baseline for
+                nests that aren't tuned by hand. Requires a schedule that isn't transformed. Defaults to False.
         """
         from .Plan import Plan
 
-        return Plan(self, target)
+        if not auto_schedule:
+            return Plan(self, target)
+
+        vectorized_index, cached_arrays, cache_index = self._auto_schedule(target)
+        plan = Plan(self, target)
+        if vectorized_index is not None:
+            plan.vectorize(vectorized_index)
+        for arr in cached_arrays:
+            plan.cache(arr, index=cache_index)
+        return plan
 
     def get_index_range(self, index):
         return self._index_map[index].interval()
@@ -241,6 +259,12 @@ class Schedule:
                 raise ValueError("An inner dimension must not be ordered before its outer dimension")
             visited.append(i)
 
+        if self._get_violated_dependence(indices) is not None:
+            raise ValueError(
+                "The order reverses a dependence between iterations of the iteration logic that access the same "
+                "array element"
+            )
+
         self._indices = indices
 
     def tile(self, shape=Mapping[LoopIndex, Union[int, DelayedParameter]]) -> Tuple[LoopIndex]:
@@ -433,6 +457,263 @@ class Schedule:
             result += self._get_index_num_blocks(i)
         return result
 
+    def _get_dependence_directions(self) -> List[Tuple[Any, Tuple[int]]]:
+        """Returns the (array, direction) of each loop-carried dependence of the iteration logic, where the direction
+        gives the sign (-1, 0 or 1) of the distance from the source to the sink iteration along each nest index,
+        in nest order. Only the dependences between accesses that index every dimension of an array with a nest
+        index plus a constant offset, or with a constant, are known: the others are not reported.
+        """
+        from .IntrospectionUtilities import get_array_affine_accesses
+
+        nest_indices = self._nest.get_indices()
+        nest_indices = nest_indices if isinstance(nest_indices, list) else [nest_indices]
+        shape = self._nest.get_shape()
+        shape = shape if isinstance(shape, list) else [shape]
+
+        accesses = []
+        for logic_fn in self._nest.get_logic():
+            if any(logic_fn is fn for fn in self._nest._conditional_logic_fns):
+                continue
+            try:
+                accesses += get_array_affine_accesses(logic_fn)
+            except (OSError, TypeError):
+                # the source of the logic function isn't available, so nothing is known about its dependences
+                return []
+
+        directions = []
+        for a, (arr_a, dims_a, is_write_a) in enumerate(accesses):
+            for arr_b, dims_b, is_write_b in accesses[a:]:
+                if arr_a is not arr_b or not (is_write_a or is_write_b) or len(dims_a) != len(dims_b):
+                    continue
+
+                # distance from an iteration s that accesses dims_a to an iteration t that accesses the same element
+                # through dims_b: i_s + offset_a == i_t + offset_b => i_t - i_s == offset_a - offset_b
+                distances = {}
+                dependent = True
+                for dim_a, dim_b in zip(dims_a, dims_b):
+                    if isinstance(dim_a, tuple) and isinstance(dim_b, tuple) and dim_a[0] is dim_b[0]:
+                        distance = dim_a[1] - dim_b[1]
+                        dependent = distances.setdefault(dim_a[0], distance) == distance
+                    elif isinstance(dim_a, int) and isinstance(dim_b, int):
+                        dependent = dim_a == dim_b
+                    else:
+                        dependent = None    # unknown
+                    if not dependent:
+                        break
+                if not dependent:
+                    continue
+
+                # a distance that is not smaller than the range of the index never occurs
+                if any(
+                    isinstance(size, int) and abs(distances.get(index, 0)) >= size
+                    for index, size in zip(nest_indices, shape)
+                ):
+                    continue
+
+                # the indices that don't index the array take any distance
+                signs = [[(distances[index] > 0) - (distances[index] < 0)] if index in distances else [-1, 0, 1]
+                         for index in nest_indices]
+                for direction in itertools.product(*signs):
+                    for oriented in [direction, tuple(-d for d in direction)]:
+                        # the source of a dependence precedes its sink in the original order
+                        leading = next((d for d in oriented if d), 0)
+                        if leading > 0 and (arr_a, oriented) not in directions:
+                            directions.append((arr_a, oriented))
+
+        return directions
+
+    def _get_base_index_positions(self, order: List[LoopIndex]) -> Mapping[int, List[int]]:
+        # the positions of the indices derived from each nest index in the given order, which follow the order of
+        # significance of the indices since an outer split index precedes its inner indices
+        positions = {}
+        for pos, index in enumerate(order):
+            positions.setdefault(index.base_index, []).append(pos)
+        return positions
+
+    def _has_skewed_indices(self) -> bool:
+        return any(
+            entry.transform and entry.transform[0] is IndexTransform.SKEW for entry in self._index_map.values()
+        )
+
+    def _get_violated_dependence(self, order: List[LoopIndex]):
+        """Returns an array with a dependence that the given order of the indices reverses, or None.
+
+        A dependence whose direction is negative along a nest index x is reversed when an index derived from x
+        can be the first one whose value differs between the source and the sink iterations, that is when every
+        other nest index with a non-zero direction has a derived index ordered after the first index derived from x.
+        """
+        if self._has_skewed_indices():
+            return None
+
+        nest_indices = self._nest.get_indices()
+        nest_indices = nest_indices if isinstance(nest_indices, list) else [nest_indices]
+        positions = self._get_base_index_positions(order)
+        for arr, direction in self._get_dependence_directions():
+            nonzero = [index.base_index for index, d in zip(nest_indices, direction) if d]
+            for index, d in zip(nest_indices, direction):
+                if d < 0 and all(
+                    max(positions[y]) > min(positions[index.base_index]) for y in nonzero if y != index.base_index
+                ):
+                    return arr
+        return None
+
+    def _get_carried_dependences(self, order: List[LoopIndex], indices: List[LoopIndex]):
+        """Returns the arrays with a dependence that one of the given indices can carry in the given order of the
+        indices, that is a dependence between iterations that first differ in the value of one of the indices.
+        """
+        if self._has_skewed_indices():
+            return []
+
+        nest_indices = self._nest.get_indices()
+        nest_indices = nest_indices if isinstance(nest_indices, list) else [nest_indices]
+        positions = self._get_base_index_positions(order)
+        carried = []
+        for arr, direction in self._get_dependence_directions():
+            nonzero = [index.base_index for index, d in zip(nest_indices, direction) if d]
+            for index in indices:
+                pos = order.index(index)
+                if index.base_index in nonzero and all(max(positions[y]) >= pos for y in nonzero):
+                    if not any(arr is a for a in carried):
+                        carried.append(arr)
+                    break
+        return carried
+
+    def _auto_schedule(self, target: "accera.Target"):
+        """Tiles and reorders this schedule for the target, and returns the index to vectorize or None, the arrays to
+        cache and the index to cache them at.
+
+        Each nest index costs the cache lines that the accesses of the iteration logic touch per iteration of its
+        loop when it is the innermost one, and the indices are ordered by decreasing cost as far as the dependences
+        allow. The indices are then tiled with the largest power-of-two size whose tile footprint fits in half of the
+        L2 cache, and the innermost index is split again by the elements of a vector register when its accesses are
+        unit-stride. The input arrays whose tile is strided in memory and reused within the tile are cached.
+        """
+        from .Array import Array
+        from .IntrospectionUtilities import get_array_affine_accesses
+        from .Plan import _ELEMENT_BYTES
+
+        if target.category != Target.Category.CPU:
+            raise ValueError("Auto-scheduling is only supported on CPU targets")
+
+        nest_indices = self._nest.get_indices()
+        nest_indices = nest_indices if isinstance(nest_indices, list) else [nest_indices]
+        if type(self) is not Schedule or self._delayed_calls or self._indices != nest_indices:
+            raise ValueError("Auto-scheduling requires a schedule that isn't transformed")
+
+        accesses = []
+        for logic_fn in self._nest.get_logic():
+            try:
+                accesses += get_array_affine_accesses(logic_fn)
+            except (OSError, TypeError):
+                # the source of the logic function isn't available, so nothing is known about its accesses
+                return None, [], None
+        if not accesses:
+            return None, [], None
+
+        sizes = {index: self._index_map[index].stop for index in nest_indices}
+
+        def contiguous_dim(arr, dims):
+            if arr.layout == Array.Layout.FIRST_MAJOR:
+                return len(dims) - 1
+            return 0 if arr.layout == Array.Layout.LAST_MAJOR else None
+
+        def stride(arr, dims, index):
+            "0 if the access doesn't vary with the index, 1 if it varies with unit stride, 2 otherwise"
+            varying = [d for d, dim in enumerate(dims) if dim is None or (isinstance(dim, tuple) and dim[0] is index)]
+            if not varying:
+                return 0
+            return 1 if varying == [contiguous_dim(arr, dims)] and dims[varying[0]] is not None else 2
+
+        line_bytes = target.cache_lines[0] if target.cache_lines else _DEFAULT_CACHE_LINE_BYTES
+
+        def cost(index):
+            lines = 0
+            for arr, dims, _ in accesses:
+                kind = stride(arr, dims, index)
+                if kind == 0:
+                    lines += 1 / sizes[index]
+                elif kind == 1:
+                    lines += min(_ELEMENT_BYTES.get(arr.element_type, 4) / line_bytes, 1)
+                else:
+                    lines += 1
+            return lines
+
+        # place the costliest index that keeps the order legal at each position, the original order being legal
+        preferred = sorted(nest_indices, key=cost, reverse=True)
+        order = []
+        while preferred:
+            for index in preferred:
+                candidate = order + [index] + [i for i in preferred if i is not index]
+                if self._get_violated_dependence(candidate) is None:
+                    break
+            else:
+                order, preferred = list(nest_indices), []
+                break
+            order.append(index)
+            preferred.remove(index)
+
+        innermost = order[-1]
+        vector_size = 0
+        unit_stride = [arr for arr, dims, _ in accesses if stride(arr, dims, innermost) == 1]
+        if (target.vector_bytes and unit_stride and all(stride(arr, dims, innermost) != 2 for arr, dims, _ in accesses)
+                and not self._get_carried_dependences(order, [innermost])):
+            vector_size = target.vector_bytes // max(_ELEMENT_BYTES.get(arr.element_type, 4) for arr in unit_stride)
+            if vector_size < 2 or sizes[innermost] < vector_size:
+                vector_size = 0
+
+        def footprint_bytes(tile_size):
+            # the largest footprint of each array over its accesses
+            footprints = {}
+            for arr, dims, _ in accesses:
+                elements = 1
+                for d, dim in enumerate(dims):
+                    if isinstance(dim, tuple):
+                        elements *= min(tile_size, sizes[dim[0]])
+                    elif dim is None:
+                        elements *= arr.shape[d] if isinstance(arr.shape[d], int) else 1
+                elements *= _ELEMENT_BYTES.get(arr.element_type, 4)
+                footprints[id(arr)] = max(footprints.get(id(arr), 0), elements)
+            return sum(footprints.values())
+
+        l2_kb = target.cache_sizes[Target.CacheLevel.L2.value - 1] if len(target.cache_sizes) >= 2 else _DEFAULT_L2_CACHE_KB
+        tile_size = 1 << (max(sizes.values()) - 1).bit_length()
+        while tile_size > max(vector_size, 1) and footprint_bytes(tile_size) > l2_kb * 1024 // 2:
+            tile_size //= 2
+        tiled = [index for index in order if sizes[index] > tile_size]
+
+        # the tile loops, then the point loops, then the vector loop, as base indices for the dependence check
+        vector_split = vector_size and min(tile_size, sizes[innermost]) > vector_size
+        tiled_order = tiled + order + ([innermost] if vector_split else [])
+        if self._get_violated_dependence(tiled_order) is not None:
+            tiled = []
+            vector_split = vector_size and sizes[innermost] > vector_size
+
+        point_indices = {index: self.split(index, tile_size) for index in tiled}
+        point_order = [point_indices.get(index, index) for index in order]
+        vectorized_index = point_order[-1] if vector_size else None
+        if vector_split:
+            vectorized_index = self.split(point_order[-1], vector_size)
+            point_order.append(vectorized_index)
+        self.reorder(tiled + point_order)
+
+        cached_arrays = []
+        if tiled:
+            for arr, dims, _ in accesses:
+                if arr.role != Array.Role.INPUT or any(arr is a for a in cached_arrays):
+                    continue
+                contiguous = contiguous_dim(arr, dims)
+                if contiguous is None or not isinstance(dims[contiguous], tuple):
+                    continue
+                # the tile holds parts of several rows of the array
+                strided = dims[contiguous][0] in tiled and any(
+                    isinstance(dim, tuple) for d, dim in enumerate(dims) if d != contiguous
+                )
+                reused = any(stride(arr, dims, index) == 0 for index in order)
+                if strided and reused:
+                    cached_arrays.append(arr)
+
+        return vectorized_index, cached_arrays, point_order[0] if cached_arrays else None
+
     def _deep_copy_index_map(self, index_map):
         index_map_copy = {}
         for index, entry in index_map.items():
@@ -444,8 +725,66 @@ class Schedule:
         return index_map_copy
 
 
+def _get_auto_fusion_depth(schedules: List[Schedule]) -> int:
+    """Returns the number of leading dimensions of the schedules that can be fused without changing their results.
+    A dimension can be fused when it has the same range in every schedule, and when every array that one of the
+    schedules writes and another one accesses is indexed by it in the same dimension of the array in all of their
+    accesses, so that each iteration of the fused dimensions only reads what the same iteration produced.
+    """
+    from .IntrospectionUtilities import get_array_reads_and_writes
+
+    # array id => [(indices, is_write)] for each schedule
+    accesses: List[Mapping[int, list]] = []
+    for s in schedules:
+        s_accesses = {}
+        for logic_fn in s._nest.get_logic():
+            try:
+                fn_accesses = get_array_reads_and_writes(logic_fn)
+            except (OSError, TypeError):
+                # the source of the logic function isn't available, so nothing is known about its dependencies
+                return 0
+            for arr, indices, is_write in fn_accesses:
+                s_accesses.setdefault(id(arr), []).append((indices, is_write))
+        accesses.append(s_accesses)
+
+    dependencies = []
+    for producer in range(len(schedules)):
+        for consumer in range(producer + 1, len(schedules)):
+            for arr_id in accesses[producer].keys() & accesses[consumer].keys():
+                if any(is_write for _, is_write in accesses[producer][arr_id] + accesses[consumer][arr_id]):
+                    dependencies.append((producer, consumer, arr_id))
+
+    depth = 0
+    for dim_indices in zip(*(s.get_indices() for s in schedules)):
+        if len(set(s.get_index_range(i) for i, s in zip(dim_indices, schedules))) != 1:
+            break
+
+        def indexed_array_dims(s_idx, arr_id):
+            base_index = dim_indices[s_idx].base_index
+            return set(
+                tuple(d for d, index in enumerate(indices) if index is not None and index.base_index == base_index)
+                for indices, _ in accesses[s_idx][arr_id]
+            )
+
+        fusable = True
+        for producer, consumer, arr_id in dependencies:
+            array_dims = indexed_array_dims(producer, arr_id) | indexed_array_dims(consumer, arr_id)
+            if len(array_dims) != 1 or not next(iter(array_dims)):
+                fusable = False
+                break
+        if not fusable:
+            break
+        depth += 1
+
+    return depth
+
+
 class FusedSchedule(Schedule):
-    def __init__(self, schedules: List[Schedule], partial: int = None):
+    def __init__(self, schedules: List[Schedule], partial: Union[int, object] = None):
+
+        auto_fuse = partial is AUTO
+        if auto_fuse:
+            partial = _get_auto_fusion_depth(schedules)
 
         s_indices = [s.get_indices() for s in schedules]
 
@@ -539,7 +878,11 @@ class FusedSchedule(Schedule):
         self._unfused_idx_to_orig_sched_map = unfused_idx_to_orig_sched_map
         self._unfused_idx_to_orig_map = unfused_idx_to_orig_map
 
-        self._indices = ([self._fusing_index] + self._common_indices + self._unfused_indices)
+        if auto_fuse:
+            # Each iteration of the fused dimensions runs the unfused loops of every schedule in turn
+            self._indices = (self._common_indices + [self._fusing_index] + self._unfused_indices)
+        else:
+            self._indices = ([self._fusing_index] + self._common_indices + self._unfused_indices)
 
     def print(self, per_index_fn: Callable[[LoopIndex], List[str]] = None):
         # TODO
@@ -629,7 +972,7 @@ class FusedSchedule(Schedule):
         context.schedule = native_prime_sched
 
 
-def fuse(scheds: Union[Tuple[Schedule], Schedule], *args: Schedule, partial: int = None) -> FusedSchedule:
+def fuse(scheds: Union[Tuple[Schedule], Schedule], *args: Schedule, partial: Union[int, object] = None) -> FusedSchedule:
     """The `fuse` operation combines multiple iteration spaces into a single "fused" iteration space.
     The fused iteration space represents the union of the work in the original spaces.
 
@@ -639,7 +982,11 @@ def fuse(scheds: Union[Tuple[Schedule], Schedule], *args: Schedule, partial: int
     Args:
         schedules: Either the schedules to fuse if performing partial fusing, or the first schedule to fuse if fusing all dimensions
         *args: Optional variable arguments containing subsequent schedules to fuse
-        partial: The number of dimensions to fuse. If not specified, all dimensions will be fused
+        partial: The number of dimensions to fuse. If not specified, all dimensions will be fused.
+            AUTO fuses the leading dimensions that the dependencies between the schedules permit, i.e. those that have the same range
+            in all of the schedules and index the arrays that one schedule produces and another consumes the same way, such as the
+            (i, j) of a matrix multiplication followed by an elementwise nest. The fusing dimension is then ordered after the fused
+            dimensions, so that each of their iterations runs the rest of every schedule in turn.
     """
     schedules = [scheds] + list(args) if isinstance(scheds, Schedule) else list(scheds)
     return FusedSchedule(schedules, partial)
@@ -0,0 +1,103 @@
+####################################################################################################
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License. See LICENSE in the project root for license information.
+####################################################################################################
+
+from typing import *
+
+from .Array import Array
+from .Nest import Nest
+from .Schedule import Schedule, FusedSchedule, fuse
+
+
+def _stage_logic(src, dst, tile_indices, local_indices, body):
+    # Each stage gets its own logic function so that its captures aren't rebound by the next stage
+    def _():
+        body(src, dst, tile_indices, local_indices)
+
+    return _
+
+
+def overlapped_tiles(
+    input: Array, output: Array, stages: List[Tuple[Tuple[int], Callable]], tile: Tuple[int]
+) -> Union[Schedule, FusedSchedule]:
+    """Fuses a pipeline of stencil stages with overlapped tiles. Each tile computes every stage on the tile of the output
+    extended by a halo, i.e. the region that the later stages of the tile read, so that the intermediate results of a
+    tile stay in small buffers rather than going through memory between the stages. The halos of neighboring tiles are
+    computed redundantly.
+
+    Args:
+        input: The array read by the first stage. Stencils aren't padded, so its shape is the shape of `output` extended
+            by the radii of all the stages on each side.
+        output: The array written by the last stage.
+        stages: The (radius, fn) pair of each stage, in order. The radius is the reach of the stencil along each dimension
+            and `fn(read)` returns the value of the stage at a point, where `read(*offsets)` is the value of the previous
+            stage (or of `input`) at the point moved by the offsets, which must be within the radius.
+        tile: The shape of the tiles of the output. It must divide the shape of `output` and be no smaller than the halos.
+
+    Returns:
+        The fused schedule of the stages, with the loops over the tiles outermost and the fusing index after them, or the
+        schedule of the stage if there is only one. The buffers of the stages are shared by the tiles, so the loops over
+        the tiles must not be parallelized.
+    """
+    rank = len(output.shape)
+    if len(input.shape) != rank or len(tile) != rank:
+        raise ValueError("The input, the output and the tile of overlapped tiles must have the same rank")
+    if not stages:
+        raise ValueError("Overlapped tiles need at least one stage")
+    if any(len(radius) != rank or any(r < 0 for r in radius) for radius, _ in stages):
+        raise ValueError("The radius of each stage must be a non-negative reach for each dimension")
+
+    total_radius = [sum(radius[d] for radius, _ in stages) for d in range(rank)]
+    if any(input.shape[d] != output.shape[d] + 2 * total_radius[d] for d in range(rank)):
+        raise ValueError("The input must extend the output by the radii of all the stages on each side")
+    if any(t <= 0 or output.shape[d] % t for d, t in enumerate(tile)):
+        raise ValueError("The tile must divide the shape of the output")
+
+    # The halo of a stage is the reach of the stages after it: its tile is extended by that much on each side
+    halos = [[sum(radius[d] for radius, _ in stages[k + 1:]) for d in range(rank)] for k in range(len(stages))]
+    if any(halos[0][d] > tile[d] for d in range(rank)):
+        raise ValueError("The tile must be no smaller than the halos of the stages")
+
+    num_tiles = [output.shape[d] // tile[d] for d in range(rank)]
+
+    schedules = []
+    src = input
+    for k, (radius, fn) in enumerate(stages):
+        halo = halos[k]
+        extent = [tile[d] + 2 * halo[d] for d in range(rank)]
+        last = k == len(stages) - 1
+        dst = output if last else Array(role=Array.Role.TEMP, element_type=input.element_type, shape=extent)
+
+        def body(src, dst, tile_indices, local_indices, k=k, radius=radius, fn=fn, halo=halo, last=last):
+            def read(*offsets):
+                if len(offsets) != rank or any(abs(o) > r for o, r in zip(offsets, radius)):
+                    raise ValueError("Stencil offsets must be within the radius of the stage")
+                if k == 0:
+                    # position in the input, which is extended by the total radius
+                    return src[tuple(
+                        t * tile[d] + l + (total_radius[d] - halo[d]) + o
+                        for d, (t, l, o) in enumerate(zip(tile_indices, local_indices, offsets))
+                    )]
+                # position in the buffer of the previous stage, whose halo is larger by this stage's radius
+                return src[tuple(l + radius[d] + o for d, (l, o) in enumerate(zip(local_indices, offsets)))]
+
+            value = fn(read)
+            if last:
+                dst[tuple(t * tile[d] + l for d, (t, l) in enumerate(zip(tile_indices, local_indices)))] = value
+            else:
+                dst[tuple(local_indices)] = value
+
+        nest = Nest(shape=num_tiles + extent)
+        indices = nest.get_indices()
+        nest.iteration_logic(_stage_logic(src, dst, tuple(indices[:rank]), tuple(indices[rank:]), body))
+        schedules.append(nest.create_schedule())
+        src = dst
+
+    if len(schedules) == 1:
+        return schedules[0]
+
+    schedule = fuse(schedules, partial=rank)
+    fusing_index = schedule.get_fusing_index()
+    schedule.reorder(schedule.get_fused_indices() + [fusing_index] + schedule.get_unfused_indices())
+    return schedule
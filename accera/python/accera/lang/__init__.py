@@ -14,3 +14,9 @@ from .Plan import Plan
 from .Cache import Cache
 from .Function import Function
 from .LogicFunction import logic_function, LogicFunction
+from .LookupTable import lookup_table, table_lookup
+from .Stencil import overlapped_tiles
+from .Einsum import einsum
+from .Elementwise import broadcast_elementwise
+from .Permute import permute
+from .Curve import curve_tiles
@@ -0,0 +1,313 @@
+#!/usr/bin/env python3
+####################################################################################################
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License. See LICENSE in the project root for license information.
+####################################################################################################
+
+# Standard kernel benchmarks: builds GEMM, GEMV, convolution, LayerNorm, softmax and transpose over a standard set of
+# shapes and element types, times them with the benchmark harness of Package.build, and reports the GFLOP/s and GB/s
+# of each case. The GB/s count the bytes that a kernel has to read and write at least once.
+#
+# Usage: benchmarks.py [--kernels gemm gemv ...] [--types float32 float64] [--shapes standard|small] [--output_dir DIR]
+
+import argparse
+import json
+import os
+import sys
+from functools import reduce
+
+if "@CMAKE_INSTALL_PREFIX@"[1:-1] != "CMAKE_INSTALL_PREFIX":
+    sys.path.insert(1, "@CMAKE_INSTALL_PREFIX@")
+else:
+    sys.path.insert(1, os.getcwd())
+
+import accera as acc
+from accera import AUTO, Array, BenchmarkOptions, Nest, Package, ScalarType, fuse
+
+_ELEMENT_BYTES = {
+    ScalarType.float16: 2,
+    ScalarType.bfloat16: 2,
+    ScalarType.float32: 4,
+    ScalarType.float64: 8,
+}
+
+# The shapes of each kernel: the "small" set checks that the suite runs, the "standard" set is the one to track
+SHAPES = {
+    "standard": {
+        "gemm": [(256, 256, 256), (512, 512, 512), (1024, 1024, 1024), (512, 768, 768), (512, 3072, 768)],
+        "gemv": [(1024, 1024), (4096, 4096), (768, 3072), (3072, 768)],
+        # channels, height, width, filters, kernel size
+        "conv": [(64, 56, 56, 64, 3), (128, 28, 28, 128, 3), (256, 14, 14, 256, 3), (64, 56, 56, 256, 1)],
+        "layernorm": [(512, 768), (128, 4096), (2048, 1024)],
+        "softmax": [(512, 768), (128, 4096), (2048, 1024)],
+        "transpose": [(1024, 1024), (4096, 1024), (768, 3072)],
+    },
+    "small": {
+        "gemm": [(64, 64, 64)],
+        "gemv": [(256, 256)],
+        "conv": [(8, 16, 16, 8, 3)],
+        "layernorm": [(64, 128)],
+        "softmax": [(64, 128)],
+        "transpose": [(128, 256)],
+    },
+}
+
+
+def _num_bytes(element_type, *shapes):
+    return _ELEMENT_BYTES[element_type] * sum(reduce(lambda x, y: x * y, shape, 1) for shape in shapes)
+
+
+def add_gemm(package, shape, element_type):
+    M, N, K = shape
+    A = Array(role=Array.Role.INPUT, element_type=element_type, shape=(M, K))
+    B = Array(role=Array.Role.INPUT, element_type=element_type, shape=(K, N))
+    C = Array(role=Array.Role.INPUT_OUTPUT, element_type=element_type, shape=(M, N))
+
+    nest = Nest(shape=(M, N, K))
+    i, j, k = nest.get_indices()
+
+    @nest.iteration_logic
+    def _():
+        C[i, j] += A[i, k] * B[k, j]
+
+    fn = package.add(nest.create_plan(auto_schedule=True), args=(A, B, C), base_name=f"gemm_{M}_{N}_{K}")
+    return fn, 2 * M * N * K, _num_bytes(element_type, (M, K), (K, N), (M, N), (M, N))
+
+
+def add_gemv(package, shape, element_type):
+    M, K = shape
+    A = Array(role=Array.Role.INPUT, element_type=element_type, shape=(M, K))
+    x = Array(role=Array.Role.INPUT, element_type=element_type, shape=(K, ))
+    y = Array(role=Array.Role.INPUT_OUTPUT, element_type=element_type, shape=(M, ))
+
+    nest = Nest(shape=(M, K))
+    i, k = nest.get_indices()
+
+    @nest.iteration_logic
+    def _():
+        y[i] += A[i, k] * x[k]
+
+    fn = package.add(nest.create_plan(auto_schedule=True), args=(A, x, y), base_name=f"gemv_{M}_{K}")
+    return fn, 2 * M * K, _num_bytes(element_type, (M, K), (K, ), (M, ), (M, ))
+
+
+def add_conv(package, shape, element_type):
+    # a valid 2D convolution of a CHW image
+    C, H, W, F, S = shape
+    OH, OW = H - S + 1, W - S + 1
+    Input = Array(role=Array.Role.INPUT, element_type=element_type, shape=(C, H, W))
+    Weights = Array(role=Array.Role.INPUT, element_type=element_type, shape=(F, C, S, S))
+    Output = Array(role=Array.Role.INPUT_OUTPUT, element_type=element_type, shape=(F, OH, OW))
+
+    nest = Nest(shape=(F, OH, OW, C, S, S))
+    f, i, j, c, ki, kj = nest.get_indices()
+
+    @nest.iteration_logic
+    def _():
+        Output[f, i, j] += Input[c, i + ki, j + kj] * Weights[f, c, ki, kj]
+
+    fn = package.add(
+        nest.create_plan(auto_schedule=True), args=(Input, Weights, Output), base_name=f"conv_{C}_{H}_{W}_{F}_{S}"
+    )
+    flops = 2 * F * OH * OW * C * S * S
+    return fn, flops, _num_bytes(element_type, (C, H, W), (F, C, S, S), (F, OH, OW), (F, OH, OW))
+
+
+def add_layernorm(package, shape, element_type):
+    # normalizes each row, then scales and shifts it by gamma and beta
+    M, N = shape
+    X = Array(role=Array.Role.INPUT, element_type=element_type, shape=(M, N))
+    gamma = Array(role=Array.Role.INPUT, element_type=element_type, shape=(N, ))
+    beta = Array(role=Array.Role.INPUT, element_type=element_type, shape=(N, ))
+    Y = Array(role=Array.Role.INPUT_OUTPUT, element_type=element_type, shape=(M, N))
+    mean = Array(role=Array.Role.TEMP, element_type=element_type, shape=(M, ))
+    rstd = Array(role=Array.Role.TEMP, element_type=element_type, shape=(M, ))
+
+    init_nest = Nest(shape=(M, ))
+    i0 = init_nest.get_indices()
+
+    @init_nest.iteration_logic
+    def _():
+        mean[i0] = 0.
+        rstd[i0] = 0.
+
+    sum_nest = Nest(shape=(M, N))
+    i1, j1 = sum_nest.get_indices()
+
+    @sum_nest.iteration_logic
+    def _():
+        mean[i1] += X[i1, j1]
+
+    mean_nest = Nest(shape=(M, ))
+    i2 = mean_nest.get_indices()
+
+    @mean_nest.iteration_logic
+    def _():
+        mean[i2] /= float(N)
+
+    var_nest = Nest(shape=(M, N))
+    i3, j3 = var_nest.get_indices()
+
+    @var_nest.iteration_logic
+    def _():
+        rstd[i3] += (X[i3, j3] - mean[i3]) * (X[i3, j3] - mean[i3])
+
+    rstd_nest = Nest(shape=(M, ))
+    i4 = rstd_nest.get_indices()
+
+    @rstd_nest.iteration_logic
+    def _():
+        rstd[i4] = 1. / acc.sqrt(rstd[i4] / float(N) + 1e-5)
+
+    norm_nest = Nest(shape=(M, N))
+    i5, j5 = norm_nest.get_indices()
+
+    @norm_nest.iteration_logic
+    def _():
+        Y[i5, j5] = (X[i5, j5] - mean[i5]) * rstd[i5] * gamma[j5] + beta[j5]
+
+    # the rows are fused, so that each row goes through the passes in turn while it is in the cache
+    nests = [init_nest, sum_nest, mean_nest, var_nest, rstd_nest, norm_nest]
+    schedule = fuse([nest.create_schedule() for nest in nests], partial=AUTO)
+    fn = package.add(schedule.create_plan(), args=(X, gamma, beta, Y), base_name=f"layernorm_{M}_{N}")
+    return fn, 8 * M * N, _num_bytes(element_type, (M, N), (N, ), (N, ), (M, N))
+
+
+def add_softmax(package, shape, element_type):
+    # the softmax of each row, shifted by the maximum of the row
+    M, N = shape
+    X = Array(role=Array.Role.INPUT, element_type=element_type, shape=(M, N))
+    Y = Array(role=Array.Role.INPUT_OUTPUT, element_type=element_type, shape=(M, N))
+    row_max = Array(role=Array.Role.TEMP, element_type=element_type, shape=(M, ))
+    row_sum = Array(role=Array.Role.TEMP, element_type=element_type, shape=(M, ))
+
+    init_nest = Nest(shape=(M, ))
+    i0 = init_nest.get_indices()
+
+    @init_nest.iteration_logic
+    def _():
+        row_max[i0] = X[i0, 0]
+        row_sum[i0] = 0.
+
+    max_nest = Nest(shape=(M, N))
+    i1, j1 = max_nest.get_indices()
+
+    @max_nest.iteration_logic
+    def _():
+        row_max[i1] = acc.max(row_max[i1], X[i1, j1])
+
+    exp_nest = Nest(shape=(M, N))
+    i2, j2 = exp_nest.get_indices()
+
+    @exp_nest.iteration_logic
+    def _():
+        Y[i2, j2] = acc.exp(X[i2, j2] - row_max[i2])
+        row_sum[i2] += Y[i2, j2]
+
+    div_nest = Nest(shape=(M, N))
+    i3, j3 = div_nest.get_indices()
+
+    @div_nest.iteration_logic
+    def _():
+        Y[i3, j3] /= row_sum[i3]
+
+    nests = [init_nest, max_nest, exp_nest, div_nest]
+    schedule = fuse([nest.create_schedule() for nest in nests], partial=AUTO)
+    fn = package.add(schedule.create_plan(), args=(X, Y), base_name=f"softmax_{M}_{N}")
+    return fn, 5 * M * N, _num_bytes(element_type, (M, N), (M, N))
+
+
+def add_transpose(package, shape, element_type):
+    M, N = shape
+    A = Array(role=Array.Role.INPUT, element_type=element_type, shape=(M, N))
+    B = Array(role=Array.Role.INPUT_OUTPUT, element_type=element_type, shape=(N, M))
+
+    nest = Nest(shape=(M, N))
+    i, j = nest.get_indices()
+
+    @nest.iteration_logic
+    def _():
+        B[j, i] = A[i, j]
+
+    fn = package.add(nest.create_plan(auto_schedule=True), args=(A, B), base_name=f"transpose_{M}_{N}")
+    return fn, 0, _num_bytes(element_type, (M, N), (N, M))
+
+
+KERNELS = {
+    "gemm": add_gemm,
+    "gemv": add_gemv,
+    "conv": add_conv,
+    "layernorm": add_layernorm,
+    "softmax": add_softmax,
+    "transpose": add_transpose,
+}
+
+
+def run_benchmarks(kernels, element_types, shape_set, output_dir, options: BenchmarkOptions):
+    "Builds and times one package per kernel and element type, returns a record per case"
+    records = []
+    for kernel in kernels:
+        for element_type in element_types:
+            package = Package()
+            cases = {}
+            for shape in SHAPES[shape_set][kernel]:
+                fn, flops, num_bytes = KERNELS[kernel](package, shape, element_type)
+                cases[fn.name] = (shape, flops, num_bytes)
+
+            name = f"{kernel}_{element_type.name}"
+            package.build(
+                name,
+                format=Package.Format.HAT_DYNAMIC,
+                mode=Package.Mode.RELEASE,
+                output_dir=os.path.join(output_dir, name),
+                benchmark=options,
+            )
+
+            with open(os.path.join(output_dir, name, f"{name}.benchmark.json")) as results_file:
+                results = json.load(results_file)
+            for result in results["functions"]:
+                if result["name"] not in cases:
+                    continue    # e.g. the functions that a kernel calls
+                shape, flops, num_bytes = cases[result["name"]]
+                median_s = result["median_ms"] / 1e3
+                records.append({
+                    "kernel": kernel,
+                    "shape": list(shape),
+                    "element_type": element_type.name,
+                    "function": result["name"],
+                    "median_ms": result["median_ms"],
+                    "gflops": flops / median_s / 1e9 if flops else None,
+                    "gbps": num_bytes / median_s / 1e9,
+                })
+    return records
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description="Runs the standard kernel benchmarks on the host")
+    parser.add_argument("--kernels", nargs="+", choices=list(KERNELS), default=list(KERNELS))
+    parser.add_argument("--types", nargs="+", choices=[t.name for t in _ELEMENT_BYTES], default=["float32"])
+    parser.add_argument("--shapes", choices=list(SHAPES), default="standard")
+    parser.add_argument("--iterations", type=int, default=BenchmarkOptions.iterations)
+    parser.add_argument("--warmup_iterations", type=int, default=BenchmarkOptions.warmup_iterations)
+    parser.add_argument("--output_dir", default="benchmarks")
+    args = parser.parse_args(argv)
+
+    element_types = [getattr(ScalarType, t) for t in args.types]
+    options = BenchmarkOptions(warmup_iterations=args.warmup_iterations, iterations=args.iterations)
+    records = run_benchmarks(args.kernels, element_types, args.shapes, args.output_dir, options)
+
+    with open(os.path.join(args.output_dir, "benchmarks.json"), "w") as results_file:
+        json.dump({"results": records}, results_file, indent=2)
+
+    print(f"{'kernel':<10} {'type':<9} {'shape':<24} {'median ms':>10} {'GFLOP/s':>9} {'GB/s':>9}")
+    for record in records:
+        gflops = f"{record['gflops']:.2f}" if record["gflops"] is not None else "-"
+        shape = "x".join(str(s) for s in record["shape"])
+        print(
+            f"{record['kernel']:<10} {record['element_type']:<9} {shape:<24} {record['median_ms']:>10.4f} "
+            f"{gflops:>9} {record['gbps']:>9.2f}"
+        )
+
+
+if __name__ == "__main__":
+    main()
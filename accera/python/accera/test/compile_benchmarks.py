@@ -0,0 +1,242 @@
+#!/usr/bin/env python3
+####################################################################################################
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License. See LICENSE in the project root for license information.
+####################################################################################################
+
+# Compile-time benchmarks: builds representative large packages with the compile report of Package.build, and reports
+# the wall time and peak memory of each build, the time of each major stage of the lowering and the passes that took
+# the longest. Each case is built in a process of its own so that its peak memory isn't inflated by the others.
+#
+# Usage: compile_benchmarks.py [--cases deep_caches heavy_unroll many_functions] [--sizes standard|small]
+#                              [--top_passes N] [--output_dir DIR]
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import time
+
+if "@CMAKE_INSTALL_PREFIX@"[1:-1] != "CMAKE_INSTALL_PREFIX":
+    sys.path.insert(1, "@CMAKE_INSTALL_PREFIX@")
+else:
+    sys.path.insert(1, os.getcwd())
+
+# The sizes of each case: the "small" set checks that the suite runs, the "standard" set is the one to track
+SIZES = {
+    "standard": {
+        "deep_caches": 1024,    # the size of the matrices
+        "heavy_unroll": 16,    # the unrolled extent of each of the three innermost loops
+        "many_functions": 2000,    # the number of functions
+    },
+    "small": {
+        "deep_caches": 128,
+        "heavy_unroll": 4,
+        "many_functions": 20,
+    },
+}
+
+
+def _matmul_nest(M, N, K):
+    from accera import Array, Nest, ScalarType
+
+    A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+    B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+    C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+    nest = Nest(shape=(M, N, K))
+    i, j, k = nest.get_indices()
+
+    @nest.iteration_logic
+    def _():
+        C[i, j] += A[i, k] * B[k, j]
+
+    return nest, (A, B, C)
+
+
+def add_deep_caches(package, size):
+    "A matrix multiplication tiled for three cache levels, with a cache of each array at each level"
+    nest, (A, B, C) = _matmul_nest(size, size, size)
+    i, j, k = nest.get_indices()
+
+    schedule = nest.create_schedule()
+    ii, jj, kk = schedule.tile({i: 128, j: 128, k: 128})
+    iii, jjj, kkk = schedule.tile({ii: 32, jj: 32, kk: 32})
+    iiii, jjjj = schedule.tile({iii: 4, jjj: 8})
+    schedule.reorder(i, j, k, ii, jj, kk, iii, jjj, kkk, iiii, jjjj)
+
+    plan = schedule.create_plan()
+    AA = plan.cache(A, index=ii)
+    BB = plan.cache(B, index=ii)
+    CC = plan.cache(C, index=ii)
+    AAA = plan.cache(AA, index=iii)
+    BBB = plan.cache(BB, index=iii)
+    plan.cache(CC, index=iii)
+    plan.cache(AAA, index=iiii)
+    plan.cache(BBB, index=iiii)
+    plan.vectorize(jjjj)
+    package.add(plan, args=(A, B, C), base_name=f"deep_caches_{size}")
+
+
+def add_heavy_unroll(package, size):
+    "A matrix multiplication whose three innermost loops are unrolled, which emits size^3 copies of the body"
+    nest, args = _matmul_nest(256, 256, 256)
+    i, j, k = nest.get_indices()
+
+    schedule = nest.create_schedule()
+    ii, jj, kk = schedule.tile({i: size, j: size, k: size})
+    schedule.reorder(i, j, k, ii, jj, kk)
+
+    plan = schedule.create_plan()
+    for index in [ii, jj, kk]:
+        plan.unroll(index)
+    package.add(plan, args=args, base_name=f"heavy_unroll_{size}")
+
+
+def add_many_functions(package, size):
+    "Many small element-wise functions, each of a different shape so that they aren't deduplicated"
+    from accera import Array, Nest, ScalarType
+
+    for n in range(1, size + 1):
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(n, ))
+        B = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(n, ))
+
+        nest = Nest(shape=(n, ))
+        i, = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            B[i] = B[i] * 2.0 + A[i]
+
+        package.add(nest, args=(A, B), base_name=f"axpy_{n}")
+
+
+CASES = {
+    "deep_caches": add_deep_caches,
+    "heavy_unroll": add_heavy_unroll,
+    "many_functions": add_many_functions,
+}
+
+# A row of the MLIR timing report, which may have a user time column before the wall time column
+_PASS_TIMING_ROW = re.compile(r"^\s*(?:[\d.]+\s+\(\s*[\d.]+%\)\s+)*([\d.]+)\s+\(\s*[\d.]+%\)\s+(\S.*?)\s*$")
+
+
+def parse_pass_timing(report: str):
+    "The wall time of each pass in the MLIR timing report, in seconds, summed over the passes of the same name"
+    times = {}
+    for line in report.splitlines():
+        match = _PASS_TIMING_ROW.match(line)
+        if match and match.group(2) != "Total":
+            times[match.group(2)] = times.get(match.group(2), 0) + float(match.group(1))
+    return times
+
+
+def _peak_memory_mb():
+    "The peak resident memory of this process and of the tools it ran, in MB, which are unknown on Windows"
+    try:
+        import resource
+    except ImportError:
+        return None, None
+
+    # ru_maxrss is in bytes on macOS and in KB elsewhere
+    unit = 1 if sys.platform == "darwin" else 1024
+    return tuple(
+        resource.getrusage(who).ru_maxrss * unit / (1024 * 1024)
+        for who in [resource.RUSAGE_SELF, resource.RUSAGE_CHILDREN]
+    )
+
+
+def build_case(case, size, output_dir):
+    "Builds a case in this process, returns its record"
+    from accera import Package
+
+    start = time.perf_counter()
+    package = Package()
+    CASES[case](package, size)
+    emitted = time.perf_counter()
+
+    name = f"{case}_{size}"
+    case_dir = os.path.join(output_dir, name)
+    package.build(
+        name,
+        format=Package.Format.HAT_DYNAMIC,
+        mode=Package.Mode.RELEASE,
+        output_dir=case_dir,
+        compile_report=True,
+    )
+    stop = time.perf_counter()
+    peak_mb, tools_peak_mb = _peak_memory_mb()
+
+    with open(os.path.join(case_dir, f"{name}.compile_stats.json")) as stats_file:
+        stages = json.load(stats_file)["stages"]
+    with open(os.path.join(case_dir, f"{name}.pass_timing.txt")) as timing_file:
+        passes = parse_pass_timing(timing_file.read())
+
+    return {
+        "case": case,
+        "size": size,
+        "definition_s": emitted - start,
+        "build_s": stop - emitted,
+        "peak_memory_mb": peak_mb,
+        "tools_peak_memory_mb": tools_peak_mb,
+        "stages": {stage["stage"]: stage["elapsed_ms"] / 1e3 for stage in stages},
+        "passes": dict(sorted(passes.items(), key=lambda item: -item[1])),
+    }
+
+
+def run_benchmarks(cases, size_set, output_dir):
+    "Builds each case in a child process, returns a record per case"
+    records = []
+    for case in cases:
+        result_path = os.path.join(output_dir, f"{case}.json")
+        subprocess.run(
+            [
+                sys.executable, os.path.abspath(__file__), "--build_case", case, "--sizes", size_set, "--output_dir",
+                output_dir
+            ],
+            check=True
+        )
+        with open(result_path) as result_file:
+            records.append(json.load(result_file))
+    return records
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description="Runs the compile-time benchmarks of the lowering pipeline")
+    parser.add_argument("--cases", nargs="+", choices=list(CASES), default=list(CASES))
+    parser.add_argument("--sizes", choices=list(SIZES), default="standard")
+    parser.add_argument("--top_passes", type=int, default=5, help="The number of slowest passes printed per case")
+    parser.add_argument("--output_dir", default="compile_benchmarks")
+    parser.add_argument("--build_case", choices=list(CASES), help=argparse.SUPPRESS)    # run by the child processes
+    args = parser.parse_args(argv)
+
+    os.makedirs(args.output_dir, exist_ok=True)
+    if args.build_case:
+        record = build_case(args.build_case, SIZES[args.sizes][args.build_case], args.output_dir)
+        with open(os.path.join(args.output_dir, f"{args.build_case}.json"), "w") as result_file:
+            json.dump(record, result_file, indent=2)
+        return
+
+    records = run_benchmarks(args.cases, args.sizes, args.output_dir)
+    with open(os.path.join(args.output_dir, "compile_benchmarks.json"), "w") as results_file:
+        json.dump({"results": records}, results_file, indent=2)
+
+    def format_mb(mb):
+        return f"{mb:.0f}" if mb is not None else "-"
+
+    print(f"{'case':<16} {'size':>6} {'define s':>9} {'build s':>9} {'peak MB':>8} {'tools MB':>9}")
+    for record in records:
+        print(
+            f"{record['case']:<16} {record['size']:>6} {record['definition_s']:>9.2f} {record['build_s']:>9.2f} "
+            f"{format_mb(record['peak_memory_mb']):>8} {format_mb(record['tools_peak_memory_mb']):>9}"
+        )
+        for stage, seconds in record["stages"].items():
+            print(f"    stage {stage:<40} {seconds:>9.3f} s")
+        for name, seconds in list(record["passes"].items())[:args.top_passes]:
+            print(f"    pass  {name:<40} {seconds:>9.3f} s")
+
+
+if __name__ == "__main__":
+    main()
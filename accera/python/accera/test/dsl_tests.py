@@ -330,6 +330,39 @@ class DSLTest_01Arrays(unittest.TestCase):
             nest, (A, ), "test_last_major_array_access", correctness_check_values=correctness_check_values
         )
 
+    def test_blocked_layout_array_access(self) -> None:
+        layout = Array.BlockedLayout((8, 4))
+        A = Array(shape=(64, 32), role=Array.Role.INPUT, layout=layout)
+        B = Array(shape=(64, 32), role=Array.Role.INPUT_OUTPUT)
+        self.assertEqual(A.shape, [64, 32])
+        self.assertEqual(layout.get_physical_shape(A.shape), [8, 8, 8, 4])
+
+        nest = Nest(shape=(64, 32))
+        i, j = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            B[i, j] = A[i, j]
+
+        A_test = np.random.random((64, 32)).astype(np.float32)
+        B_test = np.random.random((64, 32)).astype(np.float32)
+        self.assertTrue(np.array_equal(layout.unpack(layout.pack(A_test), A_test.shape), A_test))
+        correctness_check_values = {
+            "pre": (layout.pack(A_test), B_test),
+            "post": (layout.pack(A_test), A_test)
+        }
+        self._verify_nest(
+            nest, (A, B), "test_blocked_layout_array_access", correctness_check_values=correctness_check_values
+        )
+
+        # the NCHW8c format of an NCHW tensor
+        layout = Array.BlockedLayout((1, 8, 1, 1))
+        self.assertEqual(layout.get_physical_shape((1, 64, 28, 28)), [1, 8, 28, 28, 8])
+        with self.assertRaises(ValueError):
+            Array(shape=(1, 60, 28, 28), role=Array.Role.INPUT, layout=layout)
+        with self.assertRaises(ValueError):
+            Array(shape=(1, 64, 28, 28), role=Array.Role.TEMP, layout=layout)
+
     def test_array_value_type_cast(self) -> None:
         A = Array(shape=(256, 32), role=Array.Role.INPUT, layout=Array.Layout.FIRST_MAJOR)
         B = Array(
@@ -434,6 +467,305 @@ class DSLTest_01Arrays(unittest.TestCase):
         with verifiers.VerifyPackage(self, package_name, TEST_PACKAGE_DIR):
             package.build(package_name, format=TEST_FORMAT, mode=TEST_MODE, output_dir=TEST_PACKAGE_DIR)
 
+    def test_batched_function(self) -> None:
+        package = Package()
+
+        M, N, S, batch_size = 16, 16, 8, 4
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, S))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(S, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        nest = Nest(shape=(M, N, S))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        fn = package.add(nest, args=(A, B, C), base_name="matmul")
+
+        # B is shared across the batch, A and C are packed per instance
+        batched_fn = package.add_batched(fn, batch_size, batch_strides=(M * S, 0, M * N), base_name="matmul_batched")
+        self.assertEqual(batched_fn.requested_args[0].shape, [batch_size, M, S])
+        self.assertIs(batched_fn.requested_args[1], B)
+        self.assertEqual(batched_fn.requested_args[2].shape, [batch_size, M, N])
+
+        with self.assertRaises(ValueError):
+            package.add_batched(fn, batch_size, batch_strides=(M * S, N, 0))
+
+        package_name = "test_batched_function"
+        with verifiers.VerifyPackage(self, package_name, TEST_PACKAGE_DIR) as v:
+            package.build(package_name, format=TEST_FORMAT, mode=TEST_MODE, output_dir=TEST_PACKAGE_DIR)
+
+            A_test = np.random.random((batch_size, M, S)).astype(np.float32)
+            B_test = np.random.random((S, N)).astype(np.float32)
+            C_test = np.random.random((batch_size, M, N)).astype(np.float32)
+            C_ref = C_test + A_test @ B_test
+
+            v.check_correctness(batched_fn.name, before=(A_test, B_test, C_test), after=(A_test, B_test, C_ref))
+
+    def test_batched_gemm(self) -> None:
+        package = Package()
+
+        M, N, K, batch_size = 8, 32, 16, 4
+
+        # A is stored transposed, B is shared across the batch
+        batched_fn = package.add_batched_gemm(
+            M, N, K, batch_size, batch_strides=(M * K, 0, M * N), transpose_A=True, base_name="batched_gemm"
+        )
+        self.assertEqual(batched_fn.requested_args[0].shape, [M, K, batch_size])
+        self.assertEqual(batched_fn.requested_args[1].shape, [K, N])
+        self.assertEqual(batched_fn.requested_args[2].shape, [batch_size, M, N])
+
+        package_name = "test_batched_gemm"
+        with verifiers.VerifyPackage(self, package_name, TEST_PACKAGE_DIR) as v:
+            package.build(package_name, format=TEST_FORMAT, mode=TEST_MODE, output_dir=TEST_PACKAGE_DIR)
+
+            # the last-major MxKxbatch A is a first-major batchxKxM array in memory
+            A_mem = np.random.random((batch_size, K, M)).astype(np.float32)
+            B_test = np.random.random((K, N)).astype(np.float32)
+            C_test = np.random.random((batch_size, M, N)).astype(np.float32)
+            C_ref = C_test + np.transpose(A_mem, (0, 2, 1)) @ B_test
+
+            A_test = A_mem.T    # the logical MxKxbatch view of the same memory
+            v.check_correctness(batched_fn.name, before=(A_test, B_test, C_test), after=(A_test, B_test, C_ref))
+
+    def test_quantized_gemm(self) -> None:
+        package = Package()
+
+        M, N, K = 16, 32, 128
+
+        with self.assertRaises(ValueError):
+            package.add_quantized_gemm(M, N, K, input_type=ScalarType.int16)
+
+        fn = package.add_quantized_gemm(M, N, K, base_name="quantized_gemm")
+        self.assertEqual(fn.requested_args[1].shape, [K, N])
+        self.assertEqual(fn.requested_args[5].element_type, ScalarType.int8)
+
+        package_name = "test_quantized_gemm"
+        with verifiers.VerifyPackage(self, package_name, TEST_PACKAGE_DIR) as v:
+            package.build(package_name, format=TEST_FORMAT, mode=TEST_MODE, output_dir=TEST_PACKAGE_DIR)
+
+            A_test = np.random.randint(0, 256, (M, K)).astype(np.uint8)
+            B_mem = np.random.randint(-128, 128, (N, K)).astype(np.int8)
+            B_test = B_mem.T    # the logical KxN view of the NxK weights
+            bias_test = np.random.randint(-5000, 5000, (N, )).astype(np.int32)
+            scale_test = (np.random.random((N, )) * 0.002).astype(np.float32)
+            zero_point_test = np.random.randint(-10, 10, (N, )).astype(np.int32)
+            C_test = np.zeros((M, N), dtype=np.int8)
+
+            accumulator = A_test.astype(np.int32) @ B_test.astype(np.int32) + bias_test
+            scaled = accumulator.astype(np.float32) * scale_test
+            shifted = np.floor(scaled + np.float32(0.5)) + zero_point_test.astype(np.float32)
+            C_ref = np.clip(shifted, -128, 127).astype(np.int8)
+
+            v.check_correctness(
+                fn.name,
+                before=(A_test, B_test, bias_test, scale_test, zero_point_test, C_test),
+                after=(A_test, B_test, bias_test, scale_test, zero_point_test, C_ref)
+            )
+
+    def test_int4_gemm(self) -> None:
+        package = Package()
+
+        M, N, K, group_size = 4, 32, 128, 32
+
+        with self.assertRaises(ValueError):
+            package.add_int4_gemm(M, N, K, group_size=48)
+
+        fn = package.add_int4_gemm(M, N, K, group_size=group_size, base_name="int4_gemm")
+        self.assertEqual(fn.requested_args[1].shape, [K // 2, N])
+        self.assertEqual(fn.requested_args[2].shape, [K // group_size, N])
+
+        package_name = "test_int4_gemm"
+        with verifiers.VerifyPackage(self, package_name, TEST_PACKAGE_DIR) as v:
+            package.build(package_name, format=TEST_FORMAT, mode=TEST_MODE, output_dir=TEST_PACKAGE_DIR)
+
+            quantized = np.random.randint(0, 16, (K, N)).astype(np.uint8)
+            B_test = quantized[0::2] | (quantized[1::2] << 4)    # the even rows in the low nibbles
+            scales_test = np.random.random((K // group_size, N)).astype(np.float32) * 0.1
+            A_test = np.random.random((M, K)).astype(np.float32)
+            C_test = np.random.random((M, N)).astype(np.float32)
+
+            W = (quantized.astype(np.float32) - 8) * np.repeat(scales_test, group_size, axis=0)
+            C_ref = C_test + A_test @ W
+
+            v.check_correctness(
+                fn.name, before=(A_test, B_test, scales_test, C_test), after=(A_test, B_test, scales_test, C_ref)
+            )
+
+    def test_block_sparse_gemm(self) -> None:
+        package = Package()
+
+        M, N, K = 64, 32, 64
+        block_rows, block_columns = 8, 16
+
+        # 80% of the blocks of A are zero
+        block_mask = np.random.random((M // block_rows, K // block_columns)) < 0.2
+        block_mask[0, 0] = True
+        block_row_indices, block_column_indices = np.nonzero(block_mask)
+        num_blocks = len(block_row_indices)
+
+        with self.assertRaises(ValueError):
+            package.add_block_sparse_gemm(M, N, K, block_shape=(7, block_columns), num_blocks=num_blocks)
+
+        fn = package.add_block_sparse_gemm(
+            M, N, K, block_shape=(block_rows, block_columns), num_blocks=num_blocks, base_name="block_sparse_gemm"
+        )
+        self.assertEqual(fn.requested_args[0].shape, [num_blocks, block_rows, block_columns])
+        self.assertEqual(fn.requested_args[2].shape, [M // block_rows + 1])
+
+        package_name = "test_block_sparse_gemm"
+        with verifiers.VerifyPackage(self, package_name, TEST_PACKAGE_DIR) as v:
+            package.build(package_name, format=TEST_FORMAT, mode=TEST_MODE, output_dir=TEST_PACKAGE_DIR)
+
+            values_test = np.random.random((num_blocks, block_rows, block_columns)).astype(np.float32)
+            column_indices_test = block_column_indices.astype(np.int32)
+            row_offsets_test = np.concatenate(([0], np.cumsum(block_mask.sum(axis=1)))).astype(np.int32)
+            B_test = np.random.random((K, N)).astype(np.float32)
+            C_test = np.random.random((M, N)).astype(np.float32)
+
+            A_dense = np.zeros((M, K), dtype=np.float32)
+            for block, (r, c) in enumerate(zip(block_row_indices, block_column_indices)):
+                A_dense[r * block_rows:(r + 1) * block_rows, c * block_columns:(c + 1) * block_columns] = values_test[block]
+            C_ref = C_test + A_dense @ B_test
+
+            before = (values_test, column_indices_test, row_offsets_test, B_test, C_test)
+            v.check_correctness(fn.name, before=before, after=before[:-1] + (C_ref, ))
+
+    def test_conv2d(self) -> None:
+        package = Package()
+
+        batch_size, input_channels, input_rows, input_columns, output_filters = 2, 8, 10, 12, 16
+        kernel_rows, kernel_columns = 3, 3
+
+        with self.assertRaises(ValueError):
+            package.add_conv2d(1, 1, 4, 4, 1, kernel_shape=(3, 3), layout="NCWH")
+        with self.assertRaises(ValueError):
+            package.add_conv2d(1, 1, 4, 4, 1, kernel_shape=(3, 3), dilation=(3, 3))
+        with self.assertRaises(ValueError):
+            package.add_conv2d(1, 1, 4, 4, 1, kernel_shape=(3, 3), algorithm="fft")
+        with self.assertRaises(ValueError):
+            package.add_conv2d(1, 1, 8, 8, 1, kernel_shape=(3, 3), stride=(2, 2), algorithm="winograd_2x2")
+        with self.assertRaises(ValueError):
+            package.add_conv2d(1, 1, 7, 7, 1, kernel_shape=(3, 3), padding=(1, 1), algorithm="winograd_4x4")
+
+        nchw_fn = package.add_conv2d(
+            batch_size,
+            input_channels,
+            input_rows,
+            input_columns,
+            output_filters, (kernel_rows, kernel_columns),
+            stride=(2, 2),
+            padding=(1, 1),
+            base_name="conv2d_nchw"
+        )
+        nhwc_fn = package.add_conv2d(
+            batch_size,
+            input_channels,
+            input_rows,
+            input_columns,
+            output_filters, (kernel_rows, kernel_columns),
+            dilation=(2, 2),
+            layout="NHWC",
+            base_name="conv2d_nhwc"
+        )
+        self.assertEqual(nchw_fn.requested_args[0].shape, [batch_size, input_channels, input_rows + 2, input_columns + 2])
+        self.assertEqual(nchw_fn.requested_args[2].shape, [batch_size, output_filters, 5, 6])
+        self.assertEqual(nhwc_fn.requested_args[1].shape, [kernel_rows, kernel_columns, input_channels, output_filters])
+        self.assertEqual(nhwc_fn.requested_args[2].shape, [batch_size, 6, 8, output_filters])
+
+        # the Winograd algorithms need output rows and columns that are multiples of their output tiles
+        winograd_nchw_fn = package.add_conv2d(
+            batch_size,
+            input_channels,
+            input_rows,
+            input_columns,
+            output_filters, (kernel_rows, kernel_columns),
+            padding=(1, 1),
+            algorithm="winograd_2x2",
+            base_name="conv2d_winograd_nchw"
+        )
+        winograd_nhwc_fn = package.add_conv2d(
+            batch_size,
+            input_channels,
+            8,
+            input_columns,
+            output_filters, (kernel_rows, kernel_columns),
+            padding=(1, 1),
+            layout="NHWC",
+            algorithm="winograd_4x4",
+            base_name="conv2d_winograd_nhwc"
+        )
+        self.assertEqual(winograd_nchw_fn.requested_args[2].shape, [batch_size, output_filters, input_rows, input_columns])
+        self.assertEqual(winograd_nhwc_fn.requested_args[2].shape, [batch_size, 8, input_columns, output_filters])
+
+        # computes the NCHW convolution of a padded input
+        def conv2d_ref(input, kernel, output, stride, dilation):
+            output_ref = output.copy()
+            _, _, output_rows, output_columns = output.shape
+            for kr in range(kernel_rows):
+                for kc in range(kernel_columns):
+                    row_begin, column_begin = kr * dilation[0], kc * dilation[1]
+                    window = input[:, :, row_begin:row_begin + output_rows * stride[0]:stride[0],
+                                   column_begin:column_begin + output_columns * stride[1]:stride[1]]
+                    output_ref += np.einsum("nchw,fc->nfhw", window, kernel[:, :, kr, kc])
+            return output_ref
+
+        package_name = "test_conv2d"
+        with verifiers.VerifyPackage(self, package_name, TEST_PACKAGE_DIR) as v:
+            package.build(package_name, format=TEST_FORMAT, mode=TEST_MODE, output_dir=TEST_PACKAGE_DIR)
+
+            # the padding is zero-filled
+            Input_test = np.zeros(nchw_fn.requested_args[0].shape, dtype=np.float32)
+            Input_test[:, :, 1:-1, 1:-1] = np.random.random((batch_size, input_channels, input_rows, input_columns))
+            Kernel_test, Output_test = (np.random.random(a.shape).astype(np.float32) for a in nchw_fn.requested_args[1:])
+            Output_ref = conv2d_ref(Input_test, Kernel_test, Output_test, (2, 2), (1, 1))
+            v.check_correctness(
+                nchw_fn.name,
+                before=(Input_test, Kernel_test, Output_test),
+                after=(Input_test, Kernel_test, Output_ref)
+            )
+
+            Input_test, Kernel_test, Output_test = (np.random.random(a.shape).astype(np.float32) for a in nhwc_fn.requested_args)
+            Output_ref = conv2d_ref(
+                Input_test.transpose(0, 3, 1, 2), Kernel_test.transpose(3, 2, 0, 1), Output_test.transpose(0, 3, 1, 2),
+                (1, 1), (2, 2)
+            ).transpose(0, 2, 3, 1)
+            v.check_correctness(
+                nhwc_fn.name,
+                before=(Input_test, Kernel_test, Output_test),
+                after=(Input_test, Kernel_test, np.ascontiguousarray(Output_ref))
+            )
+
+            Input_test = np.zeros(winograd_nchw_fn.requested_args[0].shape, dtype=np.float32)
+            Input_test[:, :, 1:-1, 1:-1] = np.random.random((batch_size, input_channels, input_rows, input_columns))
+            Kernel_test, Output_test = (
+                np.random.random(a.shape).astype(np.float32) for a in winograd_nchw_fn.requested_args[1:]
+            )
+            Output_ref = conv2d_ref(Input_test, Kernel_test, Output_test, (1, 1), (1, 1))
+            v.check_correctness(
+                winograd_nchw_fn.name,
+                before=(Input_test, Kernel_test, Output_test),
+                after=(Input_test, Kernel_test, Output_ref),
+                tolerance=1e-4
+            )
+
+            Input_test = np.zeros(winograd_nhwc_fn.requested_args[0].shape, dtype=np.float32)
+            Input_test[:, 1:-1, 1:-1, :] = np.random.random((batch_size, 8, input_columns, input_channels))
+            Kernel_test, Output_test = (
+                np.random.random(a.shape).astype(np.float32) for a in winograd_nhwc_fn.requested_args[1:]
+            )
+            Output_ref = conv2d_ref(
+                Input_test.transpose(0, 3, 1, 2), Kernel_test.transpose(3, 2, 0, 1), Output_test.transpose(0, 3, 1, 2),
+                (1, 1), (1, 1)
+            ).transpose(0, 2, 3, 1)
+            v.check_correctness(
+                winograd_nhwc_fn.name,
+                before=(Input_test, Kernel_test, Output_test),
+                after=(Input_test, Kernel_test, np.ascontiguousarray(Output_ref)),
+                tolerance=1e-3
+            )
 
 class DSLTest_02SimpleAffineLoopNests(unittest.TestCase):
     def _create_nest(self, shape: Tuple[int], type=ScalarType.float32) -> Tuple:
@@ -733,6 +1065,44 @@ class DSLTest_03Schedules(unittest.TestCase):
 
         self._verify_schedule(schedule, [A, B, C], "test_schedule_reorder")
 
+    def test_schedule_reorder_dependences(self) -> None:
+        N = 16
+        A = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(N, N))
+
+        nest = Nest(shape=(N - 1, N - 1))
+        i, j = nest.get_indices()
+
+        # each iteration reads the element that the previous iteration of i wrote for the next iteration of j
+        @nest.iteration_logic
+        def _():
+            A[i + 1, j] += A[i, j + 1]
+
+        schedule = nest.create_schedule()
+        with self.assertRaises(ValueError):
+            schedule.reorder(j, i)
+        self.assertEqual(schedule._indices, [i, j])
+
+        ii, jj = schedule.tile({i: 4, j: 4})
+        with self.assertRaises(ValueError):
+            schedule.reorder(i, j, ii, jj)
+        schedule.reorder(i, ii, j, jj)
+
+        plan = schedule.create_plan()
+        with self.assertRaises(ValueError):
+            plan.parallelize(indices=i)
+        plan.parallelize(indices=j)
+
+        A_test = np.random.random(A.shape).astype(np.float32)
+        A_ref = A_test.copy()
+        for r in range(N - 1):
+            for c in range(N - 1):
+                A_ref[r + 1, c] += A_ref[r, c + 1]
+        correctness_check_values = {
+            "pre": [A_test],
+            "post": [A_ref]
+        }
+        self._verify_schedule(plan, [A], "test_schedule_reorder_dependences", correctness_check_values)
+
     def test_schedule_split(self) -> None:
         nest, A, B, C = self._create_nest((16, 10, 11))
         i, j, k = nest.get_indices()
@@ -937,6 +1307,38 @@ class DSLTest_03Schedules(unittest.TestCase):
         }
         self._verify_schedule(schedule, [A, B, C], "test_schedule_pad", correctness_check_values)
 
+    def test_curve_tiles(self) -> None:
+        from accera import curve_tiles
+
+        M, N, S = 48, 40, 16
+        A = Array(role=Array.Role.INPUT, shape=(M, S))
+        B = Array(role=Array.Role.INPUT, shape=(S, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(M, N))
+
+        def gemm(A, B, C, i, j, k):
+            C[i, j] += A[i, k] * B[k, j]
+
+        with self.assertRaises(ValueError):
+            curve_tiles((A, B, C), shape=(M, N), tile=(16, 16), body=gemm, inner_shape=(S, ))
+
+        with self.assertRaises(ValueError):
+            curve_tiles((A, B, C), shape=(M, N), tile=(8, 8), body=gemm, inner_shape=(S, ), order="grouped", group=4)
+
+        A_test = np.random.random(A.shape).astype(np.float32)
+        B_test = np.random.random(B.shape).astype(np.float32)
+        C_test = np.random.random(C.shape).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test, C_test],
+            "post": [A_test, B_test, C_test + A_test @ B_test]
+        }
+
+        # 6x5 tiles, which the Morton and Hilbert orders take from the curves of the enclosing 8x8 grid
+        for order in ["morton", "hilbert", "grouped"]:
+            schedule, (t, ii, jj, k) = curve_tiles((A, B, C), shape=(M, N), tile=(8, 8), body=gemm, inner_shape=(S, ),
+                                                  order=order, group=3)
+            schedule.reorder(t, k, ii, jj)
+            self._verify_schedule(schedule, [A, B, C], f"test_curve_tiles_{order}", correctness_check_values)
+
     def test_convenience_syntax(self) -> None:
 
         nest, A, B, C = self._create_nest((16, 10, 11))
@@ -1112,6 +1514,76 @@ class DSLTest_04Fusing(unittest.TestCase):
 
         self._verify_schedule(fs, (A, B), "test_partial_iteration_space_fusing_2", correctness_check_values)
 
+    def test_automatic_iteration_space_fusing(self) -> None:
+        from accera import fuse, Nest, max, AUTO
+        from accera._lang_python._lang import Scalar
+
+        A = Array(role=Array.Role.INPUT, shape=(16, 11))
+        B = Array(role=Array.Role.INPUT, shape=(11, 10))
+        bias = Array(role=Array.Role.INPUT, shape=(10, ))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(16, 10))
+        D = Array(role=Array.Role.INPUT_OUTPUT, shape=(16, 10))
+
+        # C = relu(C + A @ B + bias)
+        nest0 = Nest(shape=(16, 10, 11))
+        i0, j0, k0 = nest0.get_indices()
+
+        @nest0.iteration_logic
+        def _():
+            C[i0, j0] += A[i0, k0] * B[k0, j0]
+
+        nest1 = Nest(shape=(16, 10))
+        i1, j1 = nest1.get_indices()
+
+        @nest1.iteration_logic
+        def _():
+            C[i1, j1] += bias[j1]
+
+        nest2 = Nest(shape=(16, 10))
+        i2, j2 = nest2.get_indices()
+
+        @nest2.iteration_logic
+        def _():
+            C[i2, j2] = max(C[i2, j2], Scalar(0.))
+
+        # (i, j) index C the same way in all the nests, k is the reduction of the matrix multiplication
+        schedule = fuse((nest0.create_schedule(), nest1.create_schedule(), nest2.create_schedule()), partial=AUTO)
+        self.assertEqual(len(schedule.get_fused_indices()), 2)
+        i, j, f, k = schedule.get_indices()
+        self.assertEqual(f, schedule.get_fusing_index())
+
+        A_test = np.random.random(A.shape).astype(np.float32) - 0.5
+        B_test = np.random.random(B.shape).astype(np.float32) - 0.5
+        bias_test = np.random.random(bias.shape).astype(np.float32) - 0.5
+        C_test = np.random.random(C.shape).astype(np.float32) - 0.5
+        correctness_check_values = {
+            "pre": [A_test, B_test, bias_test, C_test],
+            "post": [A_test, B_test, bias_test, np.maximum(C_test + A_test @ B_test + bias_test, 0.)]
+        }
+        self._verify_schedule(
+            schedule, (A, B, bias, C), "test_automatic_iteration_space_fusing", correctness_check_values
+        )
+
+        # A consumer that reads the columns of C in reverse only depends on the rows being complete
+        nest3 = Nest(shape=(16, 10))
+        i3, j3 = nest3.get_indices()
+
+        @nest3.iteration_logic
+        def _():
+            D[i3, j3] = C[i3, 9 - j3]
+
+        nest0_again = Nest(shape=(16, 10, 11))
+        i4, j4, k4 = nest0_again.get_indices()
+
+        @nest0_again.iteration_logic
+        def _():
+            C[i4, j4] += A[i4, k4] * B[k4, j4]
+
+        schedule = fuse((nest0_again.create_schedule(), nest3.create_schedule()), partial=AUTO)
+        self.assertEqual(len(schedule.get_fused_indices()), 1)
+        i, f, j, k, j3 = schedule.get_indices()
+        self.assertEqual(f, schedule.get_fusing_index())
+
     def test_unequal_iteration_space_fusing_1(self) -> None:
         from accera import fuse, Nest
 
@@ -1593,6 +2065,39 @@ class DSLTest_04Fusing(unittest.TestCase):
         }
         self._verify_schedule(fused3, (A, B, C, D), "test_multi_concat_fusing_1", correctness_check_values)
 
+    def test_overlapped_tiles_fusing(self) -> None:
+        from accera import overlapped_tiles
+
+        A = Array(role=Array.Role.INPUT, shape=(36, 36))
+        B = Array(role=Array.Role.INPUT_OUTPUT, shape=(32, 32))
+
+        def box(read):
+            value = read(-1, -1)
+            for di, dj in [(di, dj) for di in (-1, 0, 1) for dj in (-1, 0, 1)][1:]:
+                value = value + read(di, dj)
+            return value
+
+        # two 3x3 box filters, the first one is computed on 12x12 tiles so that the second can compute 8x8 tiles
+        schedule = overlapped_tiles(A, B, [((1, 1), box), ((1, 1), box)], tile=(8, 8))
+        self.assertEqual(len(schedule.get_fused_indices()), 2)
+
+        with self.assertRaises(ValueError):
+            overlapped_tiles(A, B, [((1, 1), box)], tile=(8, 8))
+
+        with self.assertRaises(ValueError):
+            overlapped_tiles(A, B, [((1, 1), box), ((1, 1), box)], tile=(7, 8))
+
+        def box_ref(x):
+            return sum(x[1 + di:x.shape[0] - 1 + di, 1 + dj:x.shape[1] - 1 + dj] for di in (-1, 0, 1) for dj in (-1, 0, 1))
+
+        A_test = np.random.random(A.shape).astype(np.float32)
+        B_test = np.random.random(B.shape).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test],
+            "post": [A_test, box_ref(box_ref(A_test))]
+        }
+        self._verify_schedule(schedule, (A, B), "test_overlapped_tiles_fusing", correctness_check_values)
+
 
 class DSLTest_05Targets(unittest.TestCase):
     def test_known_targets(self) -> None:
@@ -1610,6 +2115,42 @@ class DSLTest_05Targets(unittest.TestCase):
         self.assertEqual(pi3.num_threads, 8)
         self.assertEqual(pi3.category, Target.Category.CPU)
 
+    def test_aarch64_targets(self) -> None:
+        graviton2 = Target(Target.Model.AWS_GRAVITON2)
+        self.assertEqual(graviton2.architecture, Target.Architecture.AARCH64)
+        self.assertEqual(graviton2.vector_bytes, 16)
+        self.assertEqual(graviton2.vector_registers, 32)
+        self.assertIn("DOTPROD", graviton2.extensions)
+        self.assertEqual(graviton2._device_name, "neoverse-n1")
+
+        graviton3 = Target(Target.Model.AWS_GRAVITON3)
+        self.assertEqual(graviton3.vector_bytes, 32)
+        self.assertIn("SVE", graviton3.extensions)
+        self.assertEqual(graviton3._device_name, "neoverse-v1")
+
+        m1 = Target(Target.Model.APPLE_M1)
+        self.assertEqual(m1.cache_lines, [128, 128])
+        self.assertEqual(m1._device_name, "apple-m1")
+
+    def test_cortex_m_targets(self) -> None:
+        from accera._lang_python._lang import _IntegerDotProduct
+
+        # 8-bit and 16-bit dot products are multiplied with smlad, a pair of 16-bit multiplies per instruction
+        for model in [Target.Model.ARM_CORTEX_M4, Target.Model.ARM_CORTEX_M4F]:
+            target = Target(model)
+            self.assertIn("DSP", target.extensions)
+            self.assertEqual(target.vectorization_info.dot_product, _IntegerDotProduct.ARM_DSP)
+
+    def test_target_peak_gflops(self) -> None:
+        # 2.5 GHz * 4 lanes of float32 * 2 FMAs of 2 operations per cycle
+        graviton2 = Target(Target.Model.AWS_GRAVITON2)
+        self.assertEqual(graviton2.peak_gflops(num_cores=1), 40)
+        self.assertEqual(graviton2.peak_gflops(element_bytes=8, num_cores=1), 20)
+        self.assertEqual(graviton2.peak_gflops(), 64 * 40)
+
+        # no frequency or cores
+        self.assertIsNone(Target(category=Target.Category.CPU).peak_gflops())
+
     def test_custom_targets(self) -> None:
         my_target = Target(
             name="Custom processor",
@@ -1629,6 +2170,22 @@ class DSLTest_05Targets(unittest.TestCase):
         self.assertEqual(my_target.architecture, "x86_64")
         self.assertTrue("SSE3" in my_target.extensions)
 
+    @expectedFailure(FailedReason.NOT_IN_CORE, "host inspection reads sysfs and /proc/cpuinfo", sys.platform != "linux")
+    def test_host_target(self) -> None:
+        host = Target("HOST")
+        self.assertEqual(host.category, Target.Category.CPU)
+        self.assertEqual(host.architecture, Target.Architecture.HOST)
+        self.assertGreaterEqual(host.num_threads, host.num_cores)
+        self.assertGreaterEqual(host.num_cores, 1)
+        self.assertIn(host.vector_bytes, [16, 32, 64])
+        self.assertEqual(len(host.cache_sizes), len(host.cache_lines))
+        self.assertEqual(host.cache_sizes, sorted(host.cache_sizes))
+        self.assertEqual("AVX512" in host.extensions, host.vector_bytes == 64)
+
+        # user-specified values override the inspected ones
+        self.assertEqual(Target("HOST", cache_sizes=[4, 32], num_threads=2).cache_sizes, [4, 32])
+        self.assertEqual(Target("HOST", num_threads=2).num_threads, 2)
+
     def test_gpu_targets(self) -> None:
         v100_name = "NVidia V100"
         v100 = Target(Target.Model.NVIDIA_V100, category=Target.Category.GPU)
@@ -1665,7 +2222,7 @@ class DSLTest_06PlansCaching(unittest.TestCase):
 
         return plan, [A, B, C], [i, j, k]
 
-    def _verify_plan(self, plan, args: Tuple[Array], package_name, correctness_check_values=None) -> None:
+    def _verify_plan(self, plan, args: Tuple[Array], package_name, correctness_check_values=None, tolerance=1e-5) -> None:
         # create a HAT package and add the function to it
         package = Package()
         function = package.add(plan, args, base_name="caching_test")
@@ -1676,7 +2233,10 @@ class DSLTest_06PlansCaching(unittest.TestCase):
             package.build(package_name, format=TEST_FORMAT, mode=TEST_MODE, output_dir=output_dir)
             if correctness_check_values:
                 v.check_correctness(
-                    function.name, before=correctness_check_values["pre"], after=correctness_check_values["post"]
+                    function.name,
+                    before=correctness_check_values["pre"],
+                    after=correctness_check_values["post"],
+                    tolerance=tolerance
                 )
 
     def test_caching_by_level(self) -> None:
@@ -1723,6 +2283,73 @@ class DSLTest_06PlansCaching(unittest.TestCase):
 
         self._verify_plan(plan, [A, B, C], "test_caching_by_element_budget")
 
+    def test_caching_by_hardware_level(self) -> None:
+        A = Array(role=Array.Role.INPUT, shape=(256, 64))
+        B = Array(role=Array.Role.INPUT, shape=(64, 128))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(256, 128))
+
+        nest = Nest(shape=(256, 128, 64))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        target = Target("HOST", cache_sizes=[4, 32, 1024])
+        plan = nest.create_plan(target)
+
+        # A and B share the 4 KB L1 budget, C gets the whole L2
+        AA = plan.cache(A, level=Target.CacheLevel.L1)
+        BB = plan.cache(B, level=Target.CacheLevel.L1)
+        CC = plan.cache(C, level=Target.CacheLevel.L2)
+
+        with self.assertRaises(ValueError):
+            plan.cache(A, level=Target.CacheLevel.L1, max_elements=256)
+
+        with self.assertRaises(ValueError):
+            nest.create_plan(Target("HOST", cache_sizes=[32])).cache(A, level=Target.CacheLevel.L2)
+
+        self._verify_plan(plan, [A, B, C], "test_caching_by_hardware_level")
+        self.assertEqual(AA.max_elements, 4 * 1024 // 4 // 2)
+        self.assertEqual(BB.max_elements, 4 * 1024 // 4 // 2)
+        self.assertEqual(CC.max_elements, 32 * 1024 // 4)
+
+    def test_caching_by_hardware_hierarchy(self) -> None:
+        A = Array(role=Array.Role.INPUT, shape=(256, 64))
+        B = Array(role=Array.Role.INPUT, shape=(64, 128))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(256, 128))
+
+        nest = Nest(shape=(256, 128, 64))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        target = Target("HOST", cache_sizes=[4, 32, 1024])
+        plan = nest.create_plan(target)
+
+        A3, A2, A1 = plan.cache_hierarchy(A, layout=Array.Layout.LAST_MAJOR)
+        B3, B2, B1 = plan.cache_hierarchy(B)
+        C2, C1 = plan.cache_hierarchy(C, levels=[Target.CacheLevel.L1, Target.CacheLevel.L2])
+
+        self.assertIs(A2.target, A3)
+        self.assertIs(A1.target, A2)
+        self.assertEqual(A1.layout, Array.Layout.LAST_MAJOR)
+
+        # a level that is no larger than the level below it is skipped
+        self.assertEqual(len(nest.create_plan(Target("HOST", cache_sizes=[32, 32, 1024])).cache_hierarchy(A)), 2)
+
+        with self.assertRaises(ValueError):
+            nest.create_plan(Target("HOST", cache_sizes=[32])).cache_hierarchy(A, levels=[Target.CacheLevel.L2])
+
+        self._verify_plan(plan, [A, B, C], "test_caching_by_hardware_hierarchy")
+
+        # the three caches of the arrays share each level
+        self.assertEqual(A1.max_elements, 4 * 1024 // 4 // 3)
+        self.assertEqual(A2.max_elements, 32 * 1024 // 4 // 3)
+        self.assertEqual(A3.max_elements, 1024 * 1024 // 4 // 2)
+
     def test_thrifty_caching(self) -> None:
         plan, args, indices = self._create_plan((16, 10, 11))
         A, B, C = args
@@ -1738,55 +2365,128 @@ class DSLTest_06PlansCaching(unittest.TestCase):
 
         self._verify_plan(plan, [A, B, C], "test_thrifty_caching")
 
-    @expectedFailure(FailedReason.NOT_IN_PY, "Various target memory identifiers")
-    def test_cache_mapping(self) -> None:
-        A = Array(role=Array.Role.INPUT, shape=(1024, ))
+    def test_cache_prefetch(self) -> None:
+        A = Array(role=Array.Role.INPUT, shape=(64, 128))
+        B = Array(role=Array.Role.INPUT, shape=(128, 64))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(64, 64))
 
-        nest = Nest(shape=(64, ))
-        i = nest.get_indices()
+        nest = Nest(shape=(64, 64, 128))
+        i, j, k = nest.get_indices()
 
         @nest.iteration_logic
         def _():
-            A[i] += 2
+            C[i, j] += A[i, k] * B[k, j]
 
-        v100 = Target(Target.Model.NVIDIA_V100, category=Target.Category.GPU, num_threads=16)
-        plan = nest.create_plan(v100)
+        A_test = np.random.random(A.shape).astype(np.float32)
+        B_test = np.random.random(B.shape).astype(np.float32)
+        C_test = np.random.random(C.shape).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test, C_test],
+            "post": [A_test, B_test, C_test + A_test @ B_test]
+        }
 
-        plan.cache(i, type=v100.MemorySpace.SHARED)
-        self._verify_plan(plan, [A], "test_cache_mapping")
+        schedule = nest.create_schedule()
+        kk = schedule.split(k, 16)
+        schedule.reorder(k, i, j, kk)
 
-    def test_cache_trigger_level(self) -> None:
-        A = Array(role=Array.Role.INPUT, shape=(1024, 1024))
-        B = Array(role=Array.Role.INPUT_OUTPUT, shape=(1024, 1024))
+        plan = schedule.create_plan()
 
-        nest = Nest(shape=(1024, 1024))
+        # the panel of B for the next iteration of k is prefetched while the current one is used
+        plan.cache(B, index=i, prefetch_distance=1)
+
+        with self.assertRaises(ValueError):
+            plan.cache(A, index=i, prefetch_distance=0)
+
+        self._verify_plan(plan, [A, B, C], "test_cache_prefetch", correctness_check_values)
+
+    def test_cpu_double_buffer_cache(self) -> None:
+        A = Array(role=Array.Role.INPUT, shape=(64, 128))
+        B = Array(role=Array.Role.INPUT, shape=(128, 64))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(64, 64))
+
+        nest = Nest(shape=(64, 64, 128))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        A_test = np.random.random(A.shape).astype(np.float32)
+        B_test = np.random.random(B.shape).astype(np.float32)
+        C_test = np.random.random(C.shape).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test, C_test],
+            "post": [A_test, B_test, C_test + A_test @ B_test]
+        }
+
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, 16)
+        kk = schedule.split(k, 32)
+        schedule.reorder(i, k, j, ii, kk)
+
+        plan = schedule.create_plan()
+
+        # on CPU, the fill of the next panel of A is prefetched during the compute on the current one
+        plan.cache(A, index=j, double_buffer=True)
+        plan.cache(B, index=j, double_buffer=True, prefetch_distance=2)
+
+        self._verify_plan(plan, [A, B, C], "test_cpu_double_buffer_cache", correctness_check_values)
+
+    def test_cache_nontemporal_write_back(self) -> None:
+        A = Array(role=Array.Role.INPUT, shape=(256, 256))
+        B = Array(role=Array.Role.INPUT_OUTPUT, shape=(256, 256))
+
+        nest = Nest(shape=(256, 256))
         i, j = nest.get_indices()
 
         @nest.iteration_logic
         def _():
-            B[i, j] += A[i, j]
+            B[i, j] += A[i, j] * 2.0
+
+        A_test = np.random.random(A.shape).astype(np.float32)
+        B_test = np.random.random(B.shape).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test],
+            "post": [A_test, B_test + A_test * 2.0]
+        }
 
         schedule = nest.create_schedule()
-        ii = schedule.split(i, 128)
-        jj = schedule.split(j, 256)
-        schedule.reorder(i, j, ii, jj)
+        jj = schedule.split(j, 64)
 
         plan = schedule.create_plan()
+        plan.vectorize(jj)
 
-        plan.cache(A, index=ii, trigger_index=j)
+        with self.assertRaises(ValueError):
+            plan.cache(A, index=jj, nontemporal_write_back=True)
 
-        self._verify_plan(plan, [A, B], "test_cache_trigger_level")
+        # B is streamed back to memory rather than left in the hardware caches
+        plan.cache(B, index=jj, nontemporal_write_back=True)
 
-    def test_cache_trigger_level_matmul(self) -> None:
-        M = 1024
-        N = 1024
-        S = 1024
+        self._verify_plan(plan, [A, B], "test_cache_nontemporal_write_back", correctness_check_values)
 
-        A = Array(role=Array.Role.INPUT, shape=(M, S))
-        B = Array(role=Array.Role.INPUT, shape=(S, N))
+        # the option can also be set for all the caches of a function
+        plan = schedule.create_plan()
+        plan.cache(B, index=jj)
+
+        package = Package()
+        function = package.add(plan, args=(A, B), base_name="nontemporal_function", function_opts={"nontemporal_write_back": True})
+        package_name = "test_function_nontemporal_write_back"
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / package_name
+        with verifiers.VerifyPackage(self, package_name, output_dir) as v:
+            package.build(package_name, format=TEST_FORMAT, mode=TEST_MODE, output_dir=output_dir)
+            v.check_correctness(
+                function.name, before=correctness_check_values["pre"], after=correctness_check_values["post"]
+            )
+
+    def test_cache_partial_tiles(self) -> None:
+        # None of the split sizes divide the dimensions, so every split level has a final partial tile whose
+        # loops are versioned apart from the full tiles
+        M, N, K = 30, 29, 19
+        A = Array(role=Array.Role.INPUT, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, shape=(K, N))
         C = Array(role=Array.Role.INPUT_OUTPUT, shape=(M, N))
 
-        nest = Nest(shape=(M, N, S))
+        nest = Nest(shape=(M, N, K))
         i, j, k = nest.get_indices()
 
         @nest.iteration_logic
@@ -1794,17 +2494,17 @@ class DSLTest_06PlansCaching(unittest.TestCase):
             C[i, j] += A[i, k] * B[k, j]
 
         schedule = nest.create_schedule()
+        ii = schedule.split(i, 8)
+        iii = schedule.split(ii, 3)
+        jj = schedule.split(j, 16)
+        jjj = schedule.split(jj, 8)
+        kk = schedule.split(k, 4)
+        schedule.reorder(i, j, k, ii, jj, kk, iii, jjj)
 
-        jj = schedule.split(j, 128)
-        kk = schedule.split(k, 256)
-        kkk = schedule.split(kk, 4)
-        jjj = schedule.split(jj, 16)
-        jjjj = schedule.split(jjj, 8)
-        ii = schedule.split(i, 6)
-
-        schedule.reorder(j, k, i, jj, kk, kkk, ii, jjj, jjjj)
         plan = schedule.create_plan()
-        plan.cache(B, index=kkk, trigger_index=k, layout=Array.Layout.FIRST_MAJOR)
+        plan.cache(B, index=kk)
+        plan.cache(C, index=ii)
+        plan.vectorize(jjj)
 
         A_test = np.random.random(A.shape).astype(np.float32)
         B_test = np.random.random(B.shape).astype(np.float32)
@@ -1814,44 +2514,134 @@ class DSLTest_06PlansCaching(unittest.TestCase):
             "post": [A_test, B_test, C_test + A_test @ B_test]
         }
 
-        self._verify_plan(
-            plan, [A, B, C], "test_cache_trigger_level_matmul", correctness_check_values=correctness_check_values
-        )
-
-    def test_hierachical_caching(self) -> None:
-        M = 1024
-        N = 1024
-        S = 1024
+        self._verify_plan(plan, [A, B, C], "test_cache_partial_tiles", correctness_check_values)
 
-        A = Array(role=Array.Role.INPUT, shape=(M, S))
-        B = Array(role=Array.Role.INPUT, shape=(S, N))
+    def test_cache_epilogue(self) -> None:
+        M, N, K = 64, 64, 32
+        A = Array(role=Array.Role.INPUT, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, shape=(K, N))
+        bias = Array(role=Array.Role.INPUT, shape=(N, ))
         C = Array(role=Array.Role.INPUT_OUTPUT, shape=(M, N))
 
-        nest = Nest(shape=(M, N, S))
+        nest = Nest(shape=(M, N, K))
         i, j, k = nest.get_indices()
 
         @nest.iteration_logic
         def _():
             C[i, j] += A[i, k] * B[k, j]
 
+        A_test = np.random.random(A.shape).astype(np.float32) - 0.5
+        B_test = np.random.random(B.shape).astype(np.float32) - 0.5
+        bias_test = np.random.random(bias.shape).astype(np.float32) - 0.5
+        C_test = np.random.random(C.shape).astype(np.float32) - 0.5
+        correctness_check_values = {
+            "pre": [A_test, B_test, bias_test, C_test],
+            "post": [A_test, B_test, bias_test,
+                     np.maximum((C_test + A_test @ B_test + bias_test) * 0.5, 0)]
+        }
+
         schedule = nest.create_schedule()
+        ii = schedule.split(i, 4)
+        jj = schedule.split(j, 16)
+        schedule.reorder(i, j, k, ii, jj)
 
-        jj = schedule.split(j, 128)
-        kk = schedule.split(k, 256)
-        kkk = schedule.split(kk, 4)
-        jjj = schedule.split(jj, 16)
-        jjjj = schedule.split(jjj, 8)
-        ii = schedule.split(i, 6)
+        plan = schedule.create_plan()
+        plan.vectorize(jj)
+
+        with self.assertRaises(ValueError):
+            plan.cache(A, index=k, epilogue=["relu"])
+        with self.assertRaises(ValueError):
+            plan.cache(C, index=k, epilogue=[("bias", bias, 2)])
+        with self.assertRaises(ValueError):
+            plan.cache(C, index=k, epilogue=[("clamp", 1.0, 0.0)])
+
+        # The whole k reduction runs inside the cache, so the bias, scaling and ReLU are applied once to each element of C
+        plan.cache(C, index=k, epilogue=[("bias", bias, 1), ("scale", 0.5), "relu"])
+
+        self._verify_plan(plan, [A, B, bias, C], "test_cache_epilogue", correctness_check_values)
+
+    def test_cache_element_type(self) -> None:
+        M, N, K = 64, 64, 128
+        A = Array(role=Array.Role.INPUT, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(M, N))
+
+        nest = Nest(shape=(M, N, K))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        A_test = np.random.random(A.shape).astype(np.float32)
+        B_test = np.random.random(B.shape).astype(np.float32)
+        C_test = np.random.random(C.shape).astype(np.float32)
+        # B is rounded to float16 when the cache is filled, C is kept in float64 while the k loop runs
+        B_rounded = B_test.astype(np.float16).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test, C_test],
+            "post": [A_test, B_test, C_test + A_test @ B_rounded]
+        }
+
+        schedule = nest.create_schedule()
+        jj = schedule.split(j, 16)
+        kk = schedule.split(k, 32)
+        schedule.reorder(j, k, i, kk, jj)
 
-        schedule.reorder(j, k, i, jj, kk, kkk, ii, jjj, jjjj)
         plan = schedule.create_plan()
+        plan.vectorize(jj)
 
-        AA = plan.cache(A, level=5, trigger_level=7, layout=Array.Layout.FIRST_MAJOR)
-        AAA = plan.cache(AA, level=3, trigger_level=5, layout=Array.Layout.LAST_MAJOR)
-        BB = plan.cache(B, level=6, trigger_level=7, layout=Array.Layout.FIRST_MAJOR)
-        BBB = plan.cache(BB, level=2, trigger_level=5, layout=Array.Layout.LAST_MAJOR)
-        CC = plan.cache(C, level=8, layout=Array.Layout.FIRST_MAJOR)
-        CCC = plan.cache(CC, level=6, layout=Array.Layout.LAST_MAJOR)
+        with self.assertRaises(ValueError):
+            plan.cache(B, index=i, element_type=ScalarType.int16)
+        with self.assertRaises(ValueError):
+            plan.cache(B, index=i, thrifty=True, element_type=ScalarType.float16)
+
+        plan.cache(B, index=i, element_type=ScalarType.float16)
+        plan.cache(C, index=k, element_type=ScalarType.float64)
+
+        self._verify_plan(plan, [A, B, C], "test_cache_element_type", correctness_check_values, tolerance=1e-3)
+
+    def test_cache_accumulator_type(self) -> None:
+        M, N, K = 16, 16, 512
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float16, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float16, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float16, shape=(M, N))
+
+        nest = Nest(shape=(M, N, K))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        A_test = (np.random.random(A.shape) / 4).astype(np.float16)
+        B_test = (np.random.random(B.shape) / 4).astype(np.float16)
+        C_test = np.random.random(C.shape).astype(np.float16)
+        # The float16 products are accumulated in the float32 cache, and the sums are rounded to float16 once
+        products = (A_test[:, :, np.newaxis] * B_test[np.newaxis, :, :]).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test, C_test],
+            "post": [A_test, B_test, (C_test.astype(np.float32) + products.sum(axis=1)).astype(np.float16)]
+        }
+
+        plan = nest.create_plan()
+        plan.cache(C, index=j, element_type=ScalarType.float32)
+
+        self._verify_plan(plan, [A, B, C], "test_cache_accumulator_type", correctness_check_values, tolerance=2e-2)
+
+    def test_cache_padding(self) -> None:
+        from accera import AUTO
+
+        A = Array(role=Array.Role.INPUT, shape=(64, 128))
+        B = Array(role=Array.Role.INPUT, shape=(128, 1024))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(64, 1024))
+
+        nest = Nest(shape=(64, 1024, 128))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
 
         A_test = np.random.random(A.shape).astype(np.float32)
         B_test = np.random.random(B.shape).astype(np.float32)
@@ -1861,238 +2651,1567 @@ class DSLTest_06PlansCaching(unittest.TestCase):
             "post": [A_test, B_test, C_test + A_test @ B_test]
         }
 
-        self._verify_plan(
-            plan, [A, B, C], "test_hierarchical_caching", correctness_check_values=correctness_check_values
-        )
+        schedule = nest.create_schedule()
+        kk = schedule.split(k, 16)
+        schedule.reorder(k, i, j, kk)
 
+        plan = schedule.create_plan()
 
-class DSLTest_07PlansVectorizationParallelization(unittest.TestCase):
-    def _verify_plan(self, plan, args: Tuple[int], package_name, correctness_check_values=None) -> None:
-        package = Package()
-        function = package.add(plan, args, base_name="vectorization_parallelization_test")
+        with self.assertRaises(ValueError):
+            plan.cache(A, index=i, padding=-1)
+        with self.assertRaises(ValueError):
+            plan.cache(A, index=i, layout=(1, 16), padding=AUTO)
 
-        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / package_name
-        with verifiers.VerifyPackage(self, package_name, output_dir) as v:
-            package.build(package_name, format=TEST_FORMAT, mode=TEST_MODE, output_dir=output_dir)
-            if correctness_check_values:
-                v.check_correctness(
-                    function.name, before=correctness_check_values["pre"], after=correctness_check_values["post"]
-                )
+        # the 16x1024 panel of B has 4KiB rows, which are padded by a cache line
+        plan.cache(B, index=i, layout=Array.Layout.FIRST_MAJOR, padding=AUTO)
+        plan.cache(C, index=i, padding=8)
 
-    def test_unroll(self) -> None:
-        from accera import Target, Nest
+        self._verify_plan(plan, [A, B, C], "test_cache_padding", correctness_check_values)
 
-        A = Array(role=Array.Role.INPUT, shape=(3, 5))
+    def test_cache_panel_layout(self) -> None:
+        from accera import AUTO
 
-        my_target = Target(category=Target.Category.CPU)
+        A = Array(role=Array.Role.INPUT, shape=(64, 128))
+        B = Array(role=Array.Role.INPUT, shape=(128, 256))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(64, 256))
 
-        nest = Nest(shape=(3, 5))
-        i, j = nest.get_indices()
+        nest = Nest(shape=(64, 256, 128))
+        i, j, k = nest.get_indices()
 
         @nest.iteration_logic
         def _():
-            A[i, j] *= 2.0
+            C[i, j] += A[i, k] * B[k, j]
 
-        plan1 = nest.create_plan(my_target)
-        plan1.unroll(index=j)
-        self._verify_plan(plan1, [A], "test_unroll1")
+        A_test = np.random.random(A.shape).astype(np.float32)
+        B_test = np.random.random(B.shape).astype(np.float32)
+        C_test = np.random.random(C.shape).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test, C_test],
+            "post": [A_test, B_test, C_test + A_test @ B_test]
+        }
 
-        plan2 = nest.create_plan(my_target)
-        plan2.unroll(index=i)
-        self._verify_plan(plan2, [A], "test_unroll2")
+        schedule = nest.create_schedule()
+        jj = schedule.split(j, 64)
+        jjj = schedule.split(jj, 8)
+        ii = schedule.split(i, 4)
+        kk = schedule.split(k, 32)
+        schedule.reorder(j, k, i, jj, kk, ii, jjj)
 
-    def test_vectorize(self) -> None:
-        from accera import Target, Nest
+        plan = schedule.create_plan()
+        plan.unroll(ii)
+        plan.vectorize(jjj)
 
-        A = Array(role=Array.Role.INPUT, shape=(64, ))
-        B = Array(role=Array.Role.INPUT, shape=(64, ))
-        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(64, ))
+        with self.assertRaises(ValueError):
+            plan.cache(A, index=jj, panel=(2, ii))
+        with self.assertRaises(ValueError):
+            plan.cache(A, index=jj, panel=(0, 0))
 
-        my_target = Target(category=Target.Category.CPU, vector_bytes=16, vector_registers=2)
+        # the 32x64 block of B is packed as 8 panels of 32x8 columns, the width of the vectorized jjj
+        plan.cache(B, index=i, layout=Array.Layout.FIRST_MAJOR, panel=(1, AUTO))
+        # the 4x32 block of A is packed as a panel of 4 rows interleaved along k
+        plan.cache(A, index=jj, layout=Array.Layout.FIRST_MAJOR, panel=(0, ii))
 
-        nest = Nest(shape=(64, ))
-        i = nest.get_indices()
+        self._verify_plan(plan, [A, B, C], "test_cache_panel_layout", correctness_check_values)
+
+    def test_cache_transposed_copy(self) -> None:
+        A = Array(role=Array.Role.INPUT, shape=(64, 128))
+        B = Array(role=Array.Role.INPUT, shape=(128, 100), layout=Array.Layout.LAST_MAJOR)
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(64, 100))
+
+        nest = Nest(shape=(64, 100, 128))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        A_test = np.random.random(A.shape).astype(np.float32)
+        B_test = np.random.random(B.shape).astype(np.float32, order="F")
+        C_test = np.random.random(C.shape).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test, C_test],
+            "post": [A_test, B_test, C_test + A_test @ B_test]
+        }
+
+        schedule = nest.create_schedule()
+        jj = schedule.split(j, 32)
+        kk = schedule.split(k, 32)
+        schedule.reorder(j, k, i, jj, kk)
+
+        plan = schedule.create_plan()
+
+        # the column-major blocks of B are transposed in vector registers into the row-major cache,
+        # except for the last column of blocks, which runs past the end of B
+        plan.cache(B, index=i, layout=Array.Layout.FIRST_MAJOR)
+
+        self._verify_plan(plan, [A, B, C], "test_cache_transposed_copy", correctness_check_values)
+
+    def test_cache_memory_planning(self) -> None:
+        from accera import fuse
+
+        A = Array(role=Array.Role.INPUT, shape=(64, 64))
+        B = Array(role=Array.Role.INPUT, shape=(64, 64))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(64, 64))
+
+        nest0 = Nest(shape=(64, 64))
+        i0, j0 = nest0.get_indices()
+
+        @nest0.iteration_logic
+        def _():
+            C[i0, j0] += A[i0, j0]
+
+        nest1 = Nest(shape=(64, 64))
+        i1, j1 = nest1.get_indices()
+
+        @nest1.iteration_logic
+        def _():
+            C[i1, j1] *= B[i1, j1]
+
+        # the first stage runs over the whole iteration space before the second one starts
+        schedule = fuse(nest0.create_schedule(), nest1.create_schedule())
+        f, i, j = schedule.get_indices()
+        schedule.reorder(f, i, j)
+
+        plan = schedule.create_plan()
+
+        # the caches of A and B are never live at the same time, so they share the same scratch memory
+        plan.cache(A, index=j)
+        plan.cache(B, index=j)
+
+        A_test = np.random.random(A.shape).astype(np.float32)
+        B_test = np.random.random(B.shape).astype(np.float32)
+        C_test = np.random.random(C.shape).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test, C_test],
+            "post": [A_test, B_test, (C_test + A_test) * B_test]
+        }
+
+        self._verify_plan(plan, [A, B, C], "test_cache_memory_planning", correctness_check_values)
+
+    @expectedFailure(FailedReason.NOT_IN_PY, "Various target memory identifiers")
+    def test_cache_mapping(self) -> None:
+        A = Array(role=Array.Role.INPUT, shape=(1024, ))
+
+        nest = Nest(shape=(64, ))
+        i = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            A[i] += 2
+
+        v100 = Target(Target.Model.NVIDIA_V100, category=Target.Category.GPU, num_threads=16)
+        plan = nest.create_plan(v100)
+
+        plan.cache(i, type=v100.MemorySpace.SHARED)
+        self._verify_plan(plan, [A], "test_cache_mapping")
+
+    def test_cache_trigger_level(self) -> None:
+        A = Array(role=Array.Role.INPUT, shape=(1024, 1024))
+        B = Array(role=Array.Role.INPUT_OUTPUT, shape=(1024, 1024))
+
+        nest = Nest(shape=(1024, 1024))
+        i, j = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            B[i, j] += A[i, j]
+
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, 128)
+        jj = schedule.split(j, 256)
+        schedule.reorder(i, j, ii, jj)
+
+        plan = schedule.create_plan()
+
+        plan.cache(A, index=ii, trigger_index=j)
+
+        self._verify_plan(plan, [A, B], "test_cache_trigger_level")
+
+    def test_cache_trigger_level_matmul(self) -> None:
+        M = 1024
+        N = 1024
+        S = 1024
+
+        A = Array(role=Array.Role.INPUT, shape=(M, S))
+        B = Array(role=Array.Role.INPUT, shape=(S, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(M, N))
+
+        nest = Nest(shape=(M, N, S))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        schedule = nest.create_schedule()
+
+        jj = schedule.split(j, 128)
+        kk = schedule.split(k, 256)
+        kkk = schedule.split(kk, 4)
+        jjj = schedule.split(jj, 16)
+        jjjj = schedule.split(jjj, 8)
+        ii = schedule.split(i, 6)
+
+        schedule.reorder(j, k, i, jj, kk, kkk, ii, jjj, jjjj)
+        plan = schedule.create_plan()
+        plan.cache(B, index=kkk, trigger_index=k, layout=Array.Layout.FIRST_MAJOR)
+
+        A_test = np.random.random(A.shape).astype(np.float32)
+        B_test = np.random.random(B.shape).astype(np.float32)
+        C_test = np.random.random(C.shape).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test, C_test],
+            "post": [A_test, B_test, C_test + A_test @ B_test]
+        }
+
+        self._verify_plan(
+            plan, [A, B, C], "test_cache_trigger_level_matmul", correctness_check_values=correctness_check_values
+        )
+
+    def test_hierachical_caching(self) -> None:
+        M = 1024
+        N = 1024
+        S = 1024
+
+        A = Array(role=Array.Role.INPUT, shape=(M, S))
+        B = Array(role=Array.Role.INPUT, shape=(S, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(M, N))
+
+        nest = Nest(shape=(M, N, S))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        schedule = nest.create_schedule()
+
+        jj = schedule.split(j, 128)
+        kk = schedule.split(k, 256)
+        kkk = schedule.split(kk, 4)
+        jjj = schedule.split(jj, 16)
+        jjjj = schedule.split(jjj, 8)
+        ii = schedule.split(i, 6)
+
+        schedule.reorder(j, k, i, jj, kk, kkk, ii, jjj, jjjj)
+        plan = schedule.create_plan()
+
+        AA = plan.cache(A, level=5, trigger_level=7, layout=Array.Layout.FIRST_MAJOR)
+        AAA = plan.cache(AA, level=3, trigger_level=5, layout=Array.Layout.LAST_MAJOR)
+        BB = plan.cache(B, level=6, trigger_level=7, layout=Array.Layout.FIRST_MAJOR)
+        BBB = plan.cache(BB, level=2, trigger_level=5, layout=Array.Layout.LAST_MAJOR)
+        CC = plan.cache(C, level=8, layout=Array.Layout.FIRST_MAJOR)
+        CCC = plan.cache(CC, level=6, layout=Array.Layout.LAST_MAJOR)
+
+        A_test = np.random.random(A.shape).astype(np.float32)
+        B_test = np.random.random(B.shape).astype(np.float32)
+        C_test = np.random.random(C.shape).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test, C_test],
+            "post": [A_test, B_test, C_test + A_test @ B_test]
+        }
+
+        self._verify_plan(
+            plan, [A, B, C], "test_hierarchical_caching", correctness_check_values=correctness_check_values
+        )
+
+    def test_pack_and_map_buffer(self) -> None:
+        from accera.Platforms import LibraryDependency
+
+        B_data = np.random.random((64, 64)).astype(np.float32)
+        A = Array(role=Array.Role.INPUT, shape=(64, 64))
+        B = Array(role=Array.Role.CONST, shape=(64, 64), data=B_data)
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(64, 64))
+
+        nest = Nest(shape=(64, 64, 64))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        schedule = nest.create_schedule()
+        jj = schedule.split(j, 16)
+        schedule.reorder(j, i, k, jj)
+        plan = schedule.create_plan()
+
+        # only constant data can be packed ahead of time
+        with self.assertRaises(ValueError):
+            plan.pack_and_map_buffer(A, "test_pack_and_map_buffer_wrapper")
+
+        # the packed data of B is mapped from a file by the acc-runtime library
+        plan.pack_and_map_buffer(B, "test_pack_and_map_buffer_wrapper", "packed_B")
+        self.assertIn(LibraryDependency.ACCERA_RUNTIME, plan._dynamic_dependencies)
+
+
+class DSLTest_07PlansVectorizationParallelization(unittest.TestCase):
+    def _verify_plan(self, plan, args: Tuple[int], package_name, correctness_check_values=None) -> None:
+        package = Package()
+        function = package.add(plan, args, base_name="vectorization_parallelization_test")
+
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / package_name
+        with verifiers.VerifyPackage(self, package_name, output_dir) as v:
+            package.build(package_name, format=TEST_FORMAT, mode=TEST_MODE, output_dir=output_dir)
+            if correctness_check_values:
+                v.check_correctness(
+                    function.name, before=correctness_check_values["pre"], after=correctness_check_values["post"]
+                )
+
+    def test_unroll(self) -> None:
+        from accera import Target, Nest
+
+        A = Array(role=Array.Role.INPUT, shape=(3, 5))
+
+        my_target = Target(category=Target.Category.CPU)
+
+        nest = Nest(shape=(3, 5))
+        i, j = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            A[i, j] *= 2.0
+
+        plan1 = nest.create_plan(my_target)
+        plan1.unroll(index=j)
+        self._verify_plan(plan1, [A], "test_unroll1")
+
+        plan2 = nest.create_plan(my_target)
+        plan2.unroll(index=i)
+        self._verify_plan(plan2, [A], "test_unroll2")
+
+    def test_unroll_and_jam(self) -> None:
+        from accera import Target, Nest
+
+        M, K = 16, 32
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        x = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, ))
+        y = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, ))
+
+        my_target = Target(category=Target.Category.CPU)
+
+        nest = Nest(shape=(M, K))
+        i, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            y[i] += A[i, k] * x[k]
+
+        # 4 rows of A are accumulated in the same iterations of the reduction loop over k
+        plan = nest.create_plan(my_target)
+        plan.unroll_and_jam(i, 4)
+
+        with self.assertRaises(ValueError):
+            plan.unroll(i)
+
+        A_test = np.random.random(A.shape).astype(np.float32)
+        x_test = np.random.random(x.shape).astype(np.float32)
+        y_test = np.random.random(y.shape).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, x_test, y_test],
+            "post": [A_test, x_test, y_test + A_test @ x_test]
+        }
+        self._verify_plan(plan, [A, x, y], "test_unroll_and_jam", correctness_check_values)
+
+        # Each iteration reads the element that the previous row writes in the next column, which interleaving the
+        # rows would read before it is written
+        B = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, K))
+
+        nest = Nest(shape=(M - 1, K - 1))
+        i, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            B[i + 1, k] = B[i, k + 1]
+
+        plan = nest.create_plan(my_target)
+        with self.assertRaises(ValueError):
+            plan.unroll_and_jam(i, 2)
+
+    def test_vectorize(self) -> None:
+        from accera import Target, Nest
+
+        A = Array(role=Array.Role.INPUT, shape=(64, ))
+        B = Array(role=Array.Role.INPUT, shape=(64, ))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(64, ))
+
+        my_target = Target(category=Target.Category.CPU, vector_bytes=16, vector_registers=2)
+
+        nest = Nest(shape=(64, ))
+        i = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i] = A[i] * B[i]
+
+        plan = nest.create_plan(my_target)
+        plan.vectorize(index=i)
+        self._verify_plan(plan, [A, B, C], "test_vectorize")
+
+    def test_vectorize_masked(self) -> None:
+        from accera import Target, Nest
+
+        N = 70
+        A = Array(role=Array.Role.INPUT, shape=(N, ))
+        B = Array(role=Array.Role.INPUT, shape=(N, ))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(N, ))
+
+        my_target = Target(category=Target.Category.CPU, vector_bytes=16, vector_registers=2)
+
+        nest = Nest(shape=(N, ))
+        i = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i] = A[i] * B[i]
+
+        # 70 is not a multiple of 8, so the boundary fragment of ii has 6 iterations,
+        # which are widened to 8 lanes with the last 2 masked off
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, 8)
+
+        plan = schedule.create_plan(my_target)
+        plan.vectorize(index=ii, masked=True)
+
+        A_test = np.random.random((N, )).astype(np.float32)
+        B_test = np.random.random((N, )).astype(np.float32)
+        C_test = np.random.random((N, )).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test, C_test],
+            "post": [A_test, B_test, A_test * B_test]
+        }
+        self._verify_plan(plan, [A, B, C], "test_vectorize_masked", correctness_check_values)
+
+    def test_auto_schedule(self) -> None:
+        from accera import Target, Nest
+
+        M, N, K = 128, 128, 128
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        my_target = Target(category=Target.Category.CPU, vector_bytes=32, vector_registers=16, cache_sizes=[32, 64])
+
+        nest = Nest(shape=(M, N, K))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        schedule = nest.create_schedule()
+        plan = schedule.create_plan(my_target, auto_schedule=True)
+
+        # j is unit-stride for B and C, k for A, so the loops are ordered i, k, j and tiled by 32, the largest tile
+        # whose footprint fits in half of the L2 cache, and the innermost j loop is split by the 8 floats of a vector
+        indices = schedule.get_indices()
+        self.assertEqual(indices[:3], [i, k, j])
+        self.assertEqual([schedule.get_index_range(index)[1] for index in indices[3:]], [32, 32, 32, 8])
+        self.assertIn("vectorized", plan._index_attrs[indices[-1]])
+
+        # a transformed schedule is left as is
+        schedule = nest.create_schedule()
+        schedule.split(i, 4)
+        with self.assertRaises(ValueError):
+            schedule.create_plan(my_target, auto_schedule=True)
+
+        A_test = np.random.random(A.shape).astype(np.float32)
+        B_test = np.random.random(B.shape).astype(np.float32)
+        C_test = np.random.random(C.shape).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test, C_test],
+            "post": [A_test, B_test, C_test + A_test @ B_test]
+        }
+        self._verify_plan(plan, [A, B, C], "test_auto_schedule", correctness_check_values)
+
+    def test_vectorization_report(self) -> None:
+        import json
+        from accera import Target, Nest
+
+        A = Array(role=Array.Role.INPUT, shape=(64, ))
+        B = Array(role=Array.Role.INPUT, shape=(64, ))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(64, ))
+
+        my_target = Target(category=Target.Category.CPU, vector_bytes=16, vector_registers=2)
+
+        nest = Nest(shape=(64, ))
+        i = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i] = A[i] * B[i]
+
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, 4)
+
+        plan = schedule.create_plan(my_target)
+        plan.vectorize(index=ii)
+
+        package = Package()
+        package.add(plan, args=(A, B, C), base_name="vectorization_report_test")
+
+        package_name = "test_vectorization_report"
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / package_name
+        with verifiers.VerifyPackage(self, package_name, output_dir):
+            package.build(
+                package_name, format=TEST_FORMAT, mode=TEST_MODE, output_dir=output_dir, vectorization_report=True
+            )
+
+        with open(output_dir / f"{package_name}.vectorization.json") as f:
+            report = json.load(f)
+
+        loops = [loop for function in report["functions"] for loop in function["loops"]]
+        self.assertEqual(len(loops), 1)
+        self.assertEqual(loops[0]["outcome"], "vectorized")
+        self.assertEqual(loops[0]["vector_size"], 4)
+        self.assertEqual(loops[0]["trip_count"], 4)
+        self.assertEqual(loops[0]["scalarized_ops"], 0)
+        self.assertNotIn("blocking_op", loops[0])
+
+    def test_vectorize_int8_dot_product(self) -> None:
+        from accera import Target, Nest, _cast, _unsigned_cast
+
+        M, K = 16, 64
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.int8, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.uint8, shape=(K, ))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.int32, shape=(M, ))
+
+        def create_plan(target):
+            nest = Nest(shape=(M, K))
+            i, k = nest.get_indices()
+
+            @nest.iteration_logic
+            def _():
+                C[i] += _cast(A[i, k], ScalarType.int32) * _unsigned_cast(B[k], ScalarType.int32)
+
+            plan = nest.create_plan(target)
+            plan.vectorize(k)
+            return plan
+
+        # Without dot-product instructions, the accumulation falls back to the generic vectorization
+        A_test = np.random.randint(-128, 128, (M, K)).astype(np.int8)
+        B_test = np.random.randint(0, 256, (K, )).astype(np.uint8)
+        C_test = np.random.randint(-1000, 1000, (M, )).astype(np.int32)
+        correctness_check_values = {
+            "pre": [A_test, B_test, C_test],
+            "post": [A_test, B_test, C_test + A_test.astype(np.int32) @ B_test.astype(np.int32)]
+        }
+        plan = create_plan(Target(category=Target.Category.CPU, vector_bytes=32, vector_registers=16))
+        self._verify_plan(plan, [A, B, C], "test_vectorize_int8_dot_product", correctness_check_values)
+
+        # With VNNI, each group of 64 bytes becomes a single vpdpbusd. The host may not have it, so only the IR is emitted
+        vnni_target = Target(
+            category=Target.Category.CPU, vector_bytes=64, vector_registers=32, extensions=["AVX2", "AVX512", "AVX-VNNI"]
+        )
+        package = Package()
+        package.add(create_plan(vnni_target), args=(A, B, C), base_name="vectorization_parallelization_test")
+        package_name = "test_vectorize_int8_dot_product_vnni"
+        with verifiers.VerifyPackage(self, package_name, TEST_PACKAGE_DIR):
+            package.build(package_name, format=Package.Format.MLIR_STATIC, output_dir=TEST_PACKAGE_DIR)
+
+    def test_vectorize_bfloat16_dot_product(self) -> None:
+        from accera import Target, Nest, _cast
+
+        M, K = 16, 64
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.bfloat16, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.bfloat16, shape=(K, ))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, ))
+
+        nest = Nest(shape=(M, K))
+        i, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i] += _cast(A[i, k], ScalarType.float32) * _cast(B[k], ScalarType.float32)
+
+        # Each group of 32 bfloat16 values becomes a single vdpbf16ps. The host may not have it, so only the IR is emitted
+        bf16_target = Target(
+            category=Target.Category.CPU, vector_bytes=64, vector_registers=32, extensions=["AVX2", "AVX512", "AVX512BF16"]
+        )
+        plan = nest.create_plan(bf16_target)
+        plan.vectorize(k)
+
+        package = Package()
+        package.add(plan, args=(A, B, C), base_name="vectorization_parallelization_test")
+        package_name = "test_vectorize_bfloat16_dot_product"
+        with verifiers.VerifyPackage(self, package_name, TEST_PACKAGE_DIR):
+            package.build(package_name, format=Package.Format.MLIR_STATIC, output_dir=TEST_PACKAGE_DIR)
+
+    def test_table_lookup(self) -> None:
+        import math
+        from accera import Target, Nest, lookup_table, table_lookup
+
+        M, N = 16, 64
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.int8, shape=(M, N))
+        B = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.int8, shape=(M, N))
+
+        def gelu(x):
+            return 0.5 * x * (1 + math.erf(x / math.sqrt(2)))
+
+        scale, output_zero_point = 0.05, -10
+        table = lookup_table(gelu, scale, 0, scale, output_zero_point)
+
+        def create_plan(target=Target.HOST):
+            nest = Nest(shape=(M, N))
+            i, j = nest.get_indices()
+
+            @nest.iteration_logic
+            def _():
+                B[i, j] = table_lookup(table, A[i, j])
+
+            plan = nest.create_plan(target)
+            plan.vectorize(j)
+            return plan
+
+        entries = np.array([gelu(q * scale) for q in np.arange(256).astype(np.uint8).view(np.int8)])
+        entries = np.clip(np.floor(entries / scale + 0.5) + output_zero_point, -128, 127).astype(np.int8)
+
+        A_test = np.random.randint(-128, 128, (M, N)).astype(np.int8)
+        B_test = np.zeros((M, N)).astype(np.int8)
+        correctness_check_values = {
+            "pre": [A_test, B_test],
+            "post": [A_test, entries[A_test.view(np.uint8)]]
+        }
+        self._verify_plan(create_plan(), [A, B], "test_table_lookup", correctness_check_values)
+
+        # Each vector of indices is looked up with vpermi2b or tbl and tbx. The host may not have them, so only the IR is
+        # emitted
+        for target in [Target(Target.Model.INTEL_8490H), Target(Target.Model.AWS_GRAVITON2)]:
+            package = Package()
+            package.add(create_plan(target), args=(A, B), base_name="table_lookup_test")
+            package_name = f"test_table_lookup_{target.family.replace(' ', '_').replace('-', '_')}"
+            with verifiers.VerifyPackage(self, package_name, TEST_PACKAGE_DIR):
+                package.build(package_name, format=Package.Format.MLIR_STATIC, output_dir=TEST_PACKAGE_DIR)
+
+    def test_tensorize_amx(self) -> None:
+        from accera import Target, Nest, _cast
+
+        M, N, K = 64, 64, 128
+        target = Target(Target.Model.INTEL_8490H)
+        self.assertIn("AMX-INT8", target.extensions)
+        self.assertIn("AMX-BF16", target.extensions)
+
+        # Each 16x16 tile of C accumulates the products of a 16x64 tile of A and a 64x16 tile of B with a single tdpbssd,
+        # or of a 16x32 tile of A and a 32x16 tile of B with a single tdpbf16ps. The host may not have AMX, so only the
+        # IR is emitted
+        for operand_type, acc_type, tile_K in [(ScalarType.int8, ScalarType.int32, 64),
+                                               (ScalarType.bfloat16, ScalarType.float32, 32)]:
+            A = Array(role=Array.Role.INPUT, element_type=operand_type, shape=(M, K))
+            B = Array(role=Array.Role.INPUT, element_type=operand_type, shape=(K, N))
+            C = Array(role=Array.Role.INPUT_OUTPUT, element_type=acc_type, shape=(M, N))
+
+            nest = Nest(shape=(M, N, K))
+            i, j, k = nest.get_indices()
+
+            @nest.iteration_logic
+            def _():
+                C[i, j] += _cast(A[i, k], acc_type) * _cast(B[k, j], acc_type)
+
+            schedule = nest.create_schedule()
+            ii, jj, kk = schedule.tile({
+                i: 16,
+                j: 16,
+                k: tile_K
+            })
+            schedule.reorder(i, j, k, ii, jj, kk)
+            plan = schedule.create_plan(target)
+            plan.tensorize(indices=(ii, jj, kk))
+
+            package = Package()
+            package.add(plan, args=(A, B, C), base_name="tensorize_amx_test")
+            package_name = f"test_tensorize_amx_{operand_type.name}"
+            with verifiers.VerifyPackage(self, package_name, TEST_PACKAGE_DIR):
+                package.build(package_name, format=Package.Format.MLIR_STATIC, output_dir=TEST_PACKAGE_DIR)
+
+    def test_vectorize_float16(self) -> None:
+        M, N = 16, 64
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float16, shape=(M, N))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float16, shape=(M, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float16, shape=(M, N))
+
+        nest = Nest(shape=(M, N))
+        i, j = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, j] * B[i, j]
+
+        # Each 64-byte vector holds 32 float16 values, which stay in float16 on targets with native float16
+        # arithmetic. The host may not have it, so only the IR is emitted
+        for target, extension in [(Target(Target.Model.INTEL_8490H), "AVX512FP16"), (Target(Target.Model.AWS_GRAVITON2), "FP16")]:
+            self.assertIn(extension, target.extensions)
+
+            schedule = nest.create_schedule()
+            jj = schedule.split(j, target.vector_bytes // 2)
+            plan = schedule.create_plan(target)
+            plan.vectorize(jj)
+
+            package = Package()
+            package.add(plan, args=(A, B, C), base_name="vectorize_float16_test")
+            package_name = f"test_vectorize_float16_{extension.lower()}"
+            with verifiers.VerifyPackage(self, package_name, TEST_PACKAGE_DIR):
+                package.build(package_name, format=Package.Format.MLIR_STATIC, output_dir=TEST_PACKAGE_DIR)
+
+    def test_vectorize_strided(self) -> None:
+        from accera import Target, Nest
+
+        M = 16
+        N = 8
+        # A is column-major, so consecutive j iterations read elements M apart and are gathered
+        A = Array(role=Array.Role.INPUT, shape=(M, N), layout=Array.Layout.LAST_MAJOR)
+        B = Array(role=Array.Role.INPUT_OUTPUT, shape=(M, N))
+
+        my_target = Target(category=Target.Category.CPU, vector_bytes=32, vector_registers=16)
+
+        nest = Nest(shape=(M, N))
+        i, j = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            B[i, j] += A[i, j]
+
+        plan = nest.create_plan(my_target)
+        plan.vectorize(index=j)
+
+        A_test = np.random.random((M, N)).astype(np.float32, order="F")
+        B_test = np.random.random((M, N)).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test],
+            "post": [A_test, B_test + A_test]
+        }
+        self._verify_plan(plan, [A, B], "test_vectorize_strided", correctness_check_values)
+
+    def test_vectorize_fast_math(self) -> None:
+        from accera import Target, Nest, fast_tanh, fast_sigmoid, fast_erf, fast_gelu
+        import math
+
+        N = 64
+        A = Array(role=Array.Role.INPUT, shape=(N, ))
+        B = Array(role=Array.Role.INPUT_OUTPUT, shape=(N, ))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(N, ))
+        D = Array(role=Array.Role.INPUT_OUTPUT, shape=(N, ))
+        E = Array(role=Array.Role.INPUT_OUTPUT, shape=(N, ))
+
+        my_target = Target(category=Target.Category.CPU, vector_bytes=32, vector_registers=16)
+
+        nest = Nest(shape=(N, ))
+        i = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            B[i] = fast_tanh(A[i])
+            C[i] = fast_sigmoid(A[i])
+            D[i] = fast_erf(A[i])
+            E[i] = fast_gelu(A[i])
+
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, 8)
+
+        plan = schedule.create_plan(my_target)
+        plan.vectorize(index=ii)
+
+        A_test = np.linspace(-4.0, 4.0, N).astype(np.float32)
+        outputs = [np.random.random((N, )).astype(np.float32) for _ in range(4)]
+        erf = np.vectorize(math.erf)
+        expected = [
+            np.tanh(A_test), 1.0 / (1.0 + np.exp(-A_test)),
+            erf(A_test), 0.5 * A_test * (1.0 + erf(A_test / math.sqrt(2.0)))
+        ]
+        correctness_check_values = {
+            "pre": [A_test, *outputs],
+            "post": [A_test, *[e.astype(np.float32) for e in expected]]
+        }
+        self._verify_plan(plan, [A, B, C, D, E], "test_vectorize_fast_math", correctness_check_values)
+
+    def test_kernelize(self) -> None:
+        from accera import Target, Nest
+
+        A = Array(role=Array.Role.INPUT, shape=(16, 11))
+        B = Array(role=Array.Role.INPUT, shape=(11, 10))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(16, 10))
+
+        nest = Nest(shape=(16, 10, 11))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        my_target = Target(category=Target.Category.CPU, vector_bytes=16, vector_registers=2)
+        plan = nest.create_plan(my_target)
+
+        # Shorthand for:
+        # plan.unroll(i)
+        # plan.unroll(j)
+        # plan.vectorize(k)
+        plan.kernelize(unroll_indices=(i, j), vectorize_indices=k)
+        self._verify_plan(plan, [A, B, C], "test_kernelize")
+
+    def test_kernelize_2(self) -> None:
+        from accera import Target, Nest
+
+        A = Array(role=Array.Role.INPUT, shape=(16, 16))
+        B = Array(role=Array.Role.INPUT, shape=(16, 16))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(16, 16))
+
+        nest = Nest(shape=(16, 16, 16))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        my_target = Target(category=Target.Category.CPU, vector_bytes=16, vector_registers=2)
+        plan = nest.create_plan(my_target)
+
+        # Shorthand for:
+        # plan.unroll(i)
+        # plan.vectorize(j)
+        # plan.vectorize(k)
+        plan.kernelize(unroll_indices=(i, ), vectorize_indices=(j, k))
+        self._verify_plan(plan, [A, B, C], "test_kernelize_2")
+
+    def test_microkernelize(self) -> None:
+        from accera import Target, Nest
+
+        M, N, K = 48, 64, 32
+        A = Array(role=Array.Role.INPUT, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(M, N))
+
+        nest = Nest(shape=(M, N, K))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        # 16 AVX2 registers fit a 6x16 tile of float32 accumulators, 2 vectors of B and a broadcast element of A
+        my_target = Target(category=Target.Category.CPU, vector_bytes=32, vector_registers=16)
+        schedule = nest.create_schedule()
+        plan = schedule.create_plan(my_target)
+        ii, jj, jjj = plan.microkernelize(i, j, k, C)
+
+        self.assertEqual(schedule.get_indices(), [i, j, k, ii, jj, jjj])
+        self.assertEqual(schedule.get_index_range(ii), (0, 6, 1))
+        self.assertEqual(schedule.get_index_range(jj), (0, 16, 8))
+
+        A_test = np.random.random((M, K)).astype(np.float32)
+        B_test = np.random.random((K, N)).astype(np.float32)
+        C_test = np.random.random((M, N)).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test, C_test],
+            "post": [A_test, B_test, C_test + A_test @ B_test]
+        }
+        self._verify_plan(plan, [A, B, C], "test_microkernelize", correctness_check_values)
+
+    def test_einsum(self) -> None:
+        from accera import Target, einsum
+
+        my_target = Target(category=Target.Category.CPU, vector_bytes=32, vector_registers=16)
+
+        # A batched matrix multiplication is a GEMM over i, j and k, whose tile of C is a microkernel
+        A = Array(role=Array.Role.INPUT, shape=(2, 24, 32))
+        B = Array(role=Array.Role.INPUT, shape=(2, 32, 64))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(2, 24, 64))
+        plan = einsum("bik,bkj->bij", A, B, output=C, target=my_target, tile=(12, 32, 16))
+        self.assertEqual(len(plan._sched.get_indices()), 10)
+
+        A_test = np.random.random(A.shape).astype(np.float32)
+        B_test = np.random.random(B.shape).astype(np.float32)
+        C_test = np.random.random(C.shape).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test, C_test],
+            "post": [A_test, B_test, C_test + np.einsum("bik,bkj->bij", A_test, B_test)]
+        }
+        self._verify_plan(plan, [A, B, C], "test_einsum_batched_gemm", correctness_check_values)
+
+        # A row-wise dot product has no N dimension, so it is a direct nest
+        D = Array(role=Array.Role.INPUT, shape=(24, 32))
+        E = Array(role=Array.Role.INPUT, shape=(24, 32))
+        F = Array(role=Array.Role.INPUT_OUTPUT, shape=(24, ))
+        plan = einsum("ij,ij->i", D, E, output=F, target=my_target)
+        self.assertEqual(len(plan._sched.get_indices()), 2)
+
+        D_test = np.random.random(D.shape).astype(np.float32)
+        E_test = np.random.random(E.shape).astype(np.float32)
+        F_test = np.random.random(F.shape).astype(np.float32)
+        correctness_check_values = {
+            "pre": [D_test, E_test, F_test],
+            "post": [D_test, E_test, F_test + np.einsum("ij,ij->i", D_test, E_test)]
+        }
+        self._verify_plan(plan, [D, E, F], "test_einsum_direct", correctness_check_values)
+
+        with self.assertRaises(ValueError):
+            einsum("ij,jk->ik", A, B, output=C)
+
+    def test_broadcast_elementwise(self) -> None:
+        from accera import Target, broadcast_elementwise
+
+        my_target = Target(category=Target.Category.CPU, vector_bytes=32, vector_registers=16)
+
+        # The first two dimensions are collapsed, since B and C broadcast along both of them
+        plan, args = broadcast_elementwise(
+            lambda a, b, c: a * b + c, [(8, 16, 32), (32, ), (1, )], target=my_target
+        )
+        A, B, C, D = args
+        self.assertEqual(A.shape, (128, 32))
+        self.assertEqual(B.shape, (32, ))
+        self.assertEqual(C.shape, (1, ))
+        self.assertEqual(D.shape, (128, 32))
+
+        A_test = np.random.random((8, 16, 32)).astype(np.float32)
+        B_test = np.random.random((32, )).astype(np.float32)
+        C_test = np.random.random((1, )).astype(np.float32)
+        D_test = np.random.random((8, 16, 32)).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test.reshape(A.shape), B_test, C_test, D_test.reshape(D.shape)],
+            "post": [A_test.reshape(A.shape), B_test, C_test, (A_test * B_test + C_test).reshape(D.shape)]
+        }
+        self._verify_plan(plan, args, "test_broadcast_elementwise", correctness_check_values)
+
+        # A column and a row are broadcast against each other, so the output has a dimension that each one lacks
+        plan, args = broadcast_elementwise(lambda a, b: a - b, [(24, 1), (1, 40)], target=my_target)
+        self.assertEqual([arg.shape for arg in args], [(24, ), (40, ), (24, 40)])
+
+        A_test = np.random.random((24, 1)).astype(np.float32)
+        B_test = np.random.random((1, 40)).astype(np.float32)
+        C_test = np.random.random((24, 40)).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test.reshape(24), B_test.reshape(40), C_test],
+            "post": [A_test.reshape(24), B_test.reshape(40), A_test - B_test]
+        }
+        self._verify_plan(plan, args, "test_broadcast_elementwise_outer", correctness_check_values)
+
+        with self.assertRaises(ValueError):
+            broadcast_elementwise(lambda a, b: a + b, [(4, 3), (4, )])
+
+    def test_permute(self) -> None:
+        from accera import Target, permute
+
+        my_target = Target(category=Target.Category.CPU, vector_bytes=32, vector_registers=16)
+
+        def verify(shape, axes, collapsed_shapes, name):
+            plan, args = permute(shape, axes, target=my_target)
+            self.assertEqual([arg.shape for arg in args], collapsed_shapes)
+
+            input_test = np.random.random(shape).astype(np.float32)
+            output_test = np.random.random(np.transpose(input_test, axes).shape).astype(np.float32)
+            expected = np.ascontiguousarray(np.transpose(input_test, axes))
+            correctness_check_values = {
+                "pre": [input_test.reshape(args[0].shape), output_test.reshape(args[1].shape)],
+                "post": [input_test.reshape(args[0].shape), expected.reshape(args[1].shape)]
+            }
+            self._verify_plan(plan, args, name, correctness_check_values)
+
+        # A matrix transpose is tiled, whose cache of the input is transposed in registers
+        verify((64, 48), (1, 0), [(64, 48), (48, 64)], "test_permute_transpose")
+
+        # Swapping the heads and the sequence keeps the innermost dimension, so it is a copy of rows
+        verify((2, 16, 4, 32), (0, 2, 1, 3), [(2, 16, 4, 32), (2, 4, 16, 32)], "test_permute_rows")
+
+        # Transposing the last two dimensions of a batch collapses the batch dimensions
+        verify((2, 3, 16, 40), (0, 1, 3, 2), [(6, 16, 40), (6, 40, 16)], "test_permute_batched_transpose")
+
+        with self.assertRaises(ValueError):
+            permute((4, 5), (0, 0))
+
+    @expectedFailure(FailedReason.NOT_IN_PY, "pinning parallelization to CPU cores")
+    def test_cpu_bind(self) -> None:
+        A = Array(role=Array.Role.INPUT, shape=(16, 11))
+        B = Array(role=Array.Role.INPUT, shape=(11, 10))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(16, 10))
+
+        nest = Nest(shape=(16, 10, 11))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        target = Target("HOST", num_threads=16)
+        plan = nest.create_plan(target)
+
+        plan.parallelize(indices=(i, j, k), pin=(target.cores[0], target.cores[1]))    # TODO: confirm syntax
+        self._verify_plan(plan, [A, B, C], "test_cpu_bind")
+
+    def test_gpu_bind(self) -> None:
+        M = 128
+        N = 256
+        K = 256
+        A = Array(role=Array.Role.INPUT, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(M, N))
+
+        nest = Nest(shape=(M, N, K))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        v100 = Target(Target.Model.NVIDIA_V100, category=Target.Category.GPU)
+        plan = nest.create_plan(v100)
+
+        plan.bind(mapping={
+            i: v100.GridUnit.BLOCK_X,
+            j: v100.GridUnit.THREAD_X,
+            k: v100.GridUnit.THREAD_Y
+        })
+
+        test_name = "test_gpu_bind"
+        package = Package()
+        function = package.add(plan, args=(A, B, C), base_name=test_name)
+
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+
+        with verifiers.VerifyPackage(self, test_name, output_dir, file_list=[f"{test_name}.cu",
+                                                                             f"{test_name}.hat"]) as v:
+            package.build(
+                name=test_name,
+                format=Package.Format.MLIR | Package.Format.CUDA | Package.Format.HAT_PACKAGE,
+                mode=Package.Mode.RELEASE,    # Package.Mode.DEBUG,
+                output_dir=output_dir
+            )
+
+    def test_scheduling_strategies(self) -> None:
+        A = Array(role=Array.Role.INPUT, shape=(256, 1024))
+        B = Array(role=Array.Role.INPUT, shape=(1024, 512))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(256, 512))
+
+        nest = Nest(shape=(256, 512, 1024))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        target = Target("HOST", num_threads=16)
+
+        # disable correctness checking on windows because the
+        # install location of libomp.dll is non-standard as of now
+        if sys.platform.startswith('win'):
+            correctness_check_values = None
+        else:
+            A_test = np.random.random(A.shape).astype(np.float32)
+            B_test = np.random.random(B.shape).astype(np.float32)
+            C_test = np.random.random(C.shape).astype(np.float32)
+            correctness_check_values = {
+                "pre": [A_test, B_test, C_test],
+                "post": [A_test, B_test, C_test + A_test @ B_test]
+            }
+
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, A.shape[0] // min(4, target.num_threads))
+        # set the index (k) that cannot be parallelized as innermost
+        schedule.reorder(i, ii, j, k)
+
+        for policy in ["static", "dynamic", "work_stealing"]:
+            plan = schedule.create_plan(target)
+
+            # wrong order
+            with self.assertRaises(ValueError):
+                plan.parallelize(indices=(k, ii), policy=policy)
+
+            # non-contiguous
+            with self.assertRaises(ValueError):
+                plan.parallelize(indices=(i, j), policy=policy)
+
+            # non-collapsed
+            plan.parallelize(indices=i, policy=policy)
+            self._verify_plan(plan, [A, B, C], f"test_parallelize_i_{policy}", correctness_check_values)
+
+            # parallelizing middle index
+            plan_ii = schedule.create_plan(target)
+            plan_ii.parallelize(indices=ii, policy=policy)
+            self._verify_plan(plan_ii, [A, B, C], f"test_parallelize_ii_{policy}", correctness_check_values)
+
+            # partial collapsed
+            plan_partial = schedule.create_plan(target)
+            plan_partial.parallelize(indices=(i, ii, j), policy=policy)
+            self._verify_plan(plan_partial, [A, B, C], f"test_parallelize_i_ii_j_{policy}", correctness_check_values)
+
+            # partial collapsed inner indices
+            plan_partial_inner = schedule.create_plan(target)
+            plan_partial_inner.parallelize(indices=(ii, j), policy=policy)
+            self._verify_plan(
+                plan_partial_inner, [A, B, C], f"test_parallelize_ii_j_{policy}", correctness_check_values
+            )
+
+            # fully collapsed will result in correctness issues because parallelizing k can stomp on the C matrix
+            # where multiple threads try to update C[i, j] for different values of k
+
+    def test_nested_parallelization(self) -> None:
+        A = Array(role=Array.Role.INPUT, shape=(256, 1024))
+        B = Array(role=Array.Role.INPUT, shape=(1024, 512))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(256, 512))
+
+        nest = Nest(shape=(256, 512, 1024))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        target = Target("HOST", num_threads=16)
+
+        if sys.platform.startswith('win'):
+            correctness_check_values = None
+        else:
+            A_test = np.random.random(A.shape).astype(np.float32)
+            B_test = np.random.random(B.shape).astype(np.float32)
+            C_test = np.random.random(C.shape).astype(np.float32)
+            correctness_check_values = {
+                "pre": [A_test, B_test, C_test],
+                "post": [A_test, B_test, C_test + A_test @ B_test]
+            }
+
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, 128)
+        jj = schedule.split(j, 64)
+        schedule.reorder(i, j, ii, jj, k)
+
+        plan = schedule.create_plan(target)
+        plan.parallelize(indices=i, num_threads=2)
+
+        # an index can only belong to one parallel level
+        with self.assertRaises(ValueError):
+            plan.parallelize(indices=(i, j))
+
+        with self.assertRaises(ValueError):
+            plan.parallelize(indices=j, num_threads=0)
+
+        # the inner level gets the threads left by the outer level
+        plan.parallelize(indices=j, policy="dynamic")
+        self._verify_plan(plan, [A, B, C], "test_nested_parallelization", correctness_check_values)
+
+    def test_pinned_parallelization(self) -> None:
+        A = Array(role=Array.Role.INPUT, shape=(256, 1024))
+        B = Array(role=Array.Role.INPUT, shape=(1024, 512))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(256, 512))
+
+        nest = Nest(shape=(256, 512, 1024))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        target = Target("HOST", num_threads=16)
+
+        if sys.platform.startswith('win'):
+            correctness_check_values = None
+        else:
+            A_test = np.random.random(A.shape).astype(np.float32)
+            B_test = np.random.random(B.shape).astype(np.float32)
+            C_test = np.random.random(C.shape).astype(np.float32)
+            correctness_check_values = {
+                "pre": [A_test, B_test, C_test],
+                "post": [A_test, B_test, C_test + A_test @ B_test]
+            }
+
+        for pin in ["spread", (0, 1)]:
+            schedule = nest.create_schedule()
+            ii = schedule.split(i, 128)
+            jj = schedule.split(j, 64)
+            schedule.reorder(i, j, k, ii, jj)
+
+            plan = schedule.create_plan(target)
+
+            with self.assertRaises(ValueError):
+                plan.parallelize(indices=i, pin="nearest")
+
+            with self.assertRaises(ValueError):
+                plan.parallelize(indices=i, pin=(0, -1))
+
+            # the cache of B is private to each iteration of i, so it is allocated by the thread that fills it
+            plan.cache(B, index=k)
+            plan.parallelize(indices=i, pin=pin)
+
+            name = "test_pinned_parallelization_" + ("spread" if pin == "spread" else "processors")
+            self._verify_plan(plan, [A, B, C], name, correctness_check_values)
+
+    def test_thread_local_cache_parallelization(self) -> None:
+        A = Array(role=Array.Role.INPUT, shape=(256, 1024))
+        B = Array(role=Array.Role.INPUT, shape=(1024, 512))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(256, 512))
+
+        nest = Nest(shape=(256, 512, 1024))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        target = Target("HOST", num_threads=16)
+
+        A_test = np.random.random(A.shape).astype(np.float32)
+        B_test = np.random.random(B.shape).astype(np.float32)
+        C_test = np.random.random(C.shape).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test, C_test],
+            "post": [A_test, B_test, C_test + A_test @ B_test]
+        }
+
+        # the caches are filled inside the parallel loop, so each thread gets its own buffers
+        for cache_index in ["k", "jj"]:
+            schedule = nest.create_schedule()
+            ii = schedule.split(i, 32)
+            jj = schedule.split(j, 64)
+            schedule.reorder(i, j, k, ii, jj)
+
+            plan = schedule.create_plan(target)
+            plan.cache(B, index=k if cache_index == "k" else jj)
+            plan.cache(C, index=ii)
+            plan.parallelize(indices=(i, j))
+
+            self._verify_plan(
+                plan, [A, B, C], f"test_thread_local_cache_parallelization_{cache_index}", correctness_check_values
+            )
+
+    def test_split_k_parallelization(self) -> None:
+        M, N, K = 16, 32, 4096
+        A = Array(role=Array.Role.INPUT, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(M, N))
+
+        nest = Nest(shape=(M, N, K))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        target = Target("HOST", num_threads=8)
+
+        A_test = np.random.random(A.shape).astype(np.float32)
+        B_test = np.random.random(B.shape).astype(np.float32)
+        C_test = np.random.random(C.shape).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test, C_test],
+            "post": [A_test, B_test, C_test + A_test @ B_test]
+        }
+
+        schedule = nest.create_schedule()
+        kk = schedule.split(k, 512)
+        schedule.reorder(k, i, j, kk)
+
+        plan = schedule.create_plan(target)
+
+        with self.assertRaises(ValueError):
+            plan.parallelize(indices=(k, i, j, kk), reduction=C)
+
+        with self.assertRaises(ValueError):
+            plan.parallelize(indices=k, reduction=A)
+
+        # the iterations of k accumulate into the same elements of C
+        with self.assertRaises(ValueError):
+            plan.parallelize(indices=k)
+
+        # the slices of K are accumulated in parallel into per-thread caches of C
+        plan.parallelize(indices=k, reduction=C)
+
+        self._verify_plan(plan, [A, B, C], "test_split_k_parallelization", correctness_check_values)
+
+    def test_deterministic_split_k_parallelization(self) -> None:
+        M, N, K = 16, 32, 3072
+        A = Array(role=Array.Role.INPUT, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(M, N))
+
+        nest = Nest(shape=(M, N, K))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        A_test = np.random.random(A.shape).astype(np.float32)
+        B_test = np.random.random(B.shape).astype(np.float32)
+        C_test = np.random.random(C.shape).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test, C_test],
+            "post": [A_test, B_test, C_test + A_test @ B_test]
+        }
+
+        # the 6 slices of K are the chunks whatever the number of threads, and aren't a power of 2 so that the tree
+        # combines an unpaired slot
+        for num_threads in [2, 8]:
+            schedule = nest.create_schedule()
+            kk = schedule.split(k, K // 6)
+            schedule.reorder(k, i, j, kk)
+
+            plan = schedule.create_plan(Target("HOST", num_threads=num_threads))
+
+            with self.assertRaises(ValueError):
+                plan.parallelize(indices=k, deterministic=True)
+
+            plan.parallelize(indices=k, reduction=C, deterministic=True)
+
+            self._verify_plan(
+                plan, [A, B, C], f"test_deterministic_split_k_parallelization_{num_threads}", correctness_check_values
+            )
+
+    def test_cooperative_cache_parallelization(self) -> None:
+        A = Array(role=Array.Role.INPUT, shape=(256, 512))
+        B = Array(role=Array.Role.INPUT, shape=(512, 256))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(256, 256))
+
+        nest = Nest(shape=(256, 256, 512))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        target = Target("HOST", num_threads=16)
+
+        A_test = np.random.random(A.shape).astype(np.float32)
+        B_test = np.random.random(B.shape).astype(np.float32)
+        C_test = np.random.random(C.shape).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test, C_test],
+            "post": [A_test, B_test, C_test + A_test @ B_test]
+        }
+
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, 32)
+        jj = schedule.split(j, 64)
+        schedule.reorder(j, i, k, ii, jj)
+
+        plan = schedule.create_plan(target)
+
+        # the panel of B is filled above the parallel loop by all of its threads, C is written back the same way
+        plan.cache(B, index=i, cooperative=True)
+        plan.cache(C, index=i, cooperative=True)
+        plan.parallelize(indices=i)
+
+        self._verify_plan(plan, [A, B, C], "test_cooperative_cache_parallelization", correctness_check_values)
+
+    def test_chunked_parallelization(self) -> None:
+        from accera import create_parameters
+        from accera._lang_python._lang import _If
+
+        # a triangular update has a variable cost per iteration of i
+        A = Array(role=Array.Role.INPUT, shape=(250, 256))
+        B = Array(role=Array.Role.INPUT_OUTPUT, shape=(250, 256))
+
+        nest = Nest(shape=(250, 256))
+        i, j = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            def if_block():
+                B[i, j] += A[i, j]
+
+            _If(j <= i, if_block)
+
+        target = Target("HOST", num_threads=8)
+
+        A_test = np.random.random(A.shape).astype(np.float32)
+        B_test = np.random.random(B.shape).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test],
+            "post": [A_test, B_test + np.tril(A_test)]
+        }
+
+        for policy in ["static", "dynamic", "guided"]:
+            schedule = nest.create_schedule()
+            plan = schedule.create_plan(target)
+
+            with self.assertRaises(ValueError):
+                plan.parallelize(indices=i, policy=policy, chunk_size=0)
 
-        @nest.iteration_logic
-        def _():
-            C[i] = A[i] * B[i]
+            # chunks of 3 rows do not divide the 250 rows evenly
+            plan.parallelize(indices=i, policy=policy, chunk_size=3)
+            self._verify_plan(plan, [A, B], f"test_chunked_parallelization_{policy}", correctness_check_values)
 
-        plan = nest.create_plan(my_target)
-        plan.vectorize(index=i)
-        self._verify_plan(plan, [A, B, C], "test_vectorize")
+        # the chunk size can be swept as a parameter
+        chunk_size = create_parameters(1)
+        schedule = nest.create_schedule()
+        plan = schedule.create_plan(target)
+        plan.parallelize(indices=i, policy="dynamic", chunk_size=chunk_size)
 
-    def test_kernelize(self) -> None:
-        from accera import Target, Nest
+        package = Package()
+        package_name = "test_chunked_parallelization_parameters"
+        for size in [1, 16]:
+            package.add(plan, args=(A, B), parameters={chunk_size: size}, base_name=f"chunked_{size}")
 
-        A = Array(role=Array.Role.INPUT, shape=(16, 11))
-        B = Array(role=Array.Role.INPUT, shape=(11, 10))
-        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(16, 10))
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / package_name
+        with verifiers.VerifyPackage(self, package_name, output_dir):
+            package.build(package_name, format=TEST_FORMAT, mode=TEST_MODE, output_dir=output_dir)
 
-        nest = Nest(shape=(16, 10, 11))
+    def test_thread_pool_runtime(self) -> None:
+        A = Array(role=Array.Role.INPUT, shape=(256, 1024))
+        B = Array(role=Array.Role.INPUT, shape=(1024, 512))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(256, 512))
+
+        nest = Nest(shape=(256, 512, 1024))
         i, j, k = nest.get_indices()
 
         @nest.iteration_logic
         def _():
             C[i, j] += A[i, k] * B[k, j]
 
-        my_target = Target(category=Target.Category.CPU, vector_bytes=16, vector_registers=2)
-        plan = nest.create_plan(my_target)
+        target = Target("HOST", num_threads=16, runtime=Target.Runtime.THREAD_POOL)
 
-        # Shorthand for:
-        # plan.unroll(i)
-        # plan.unroll(j)
-        # plan.vectorize(k)
-        plan.kernelize(unroll_indices=(i, j), vectorize_indices=k)
-        self._verify_plan(plan, [A, B, C], "test_kernelize")
+        A_test = np.random.random(A.shape).astype(np.float32)
+        B_test = np.random.random(B.shape).astype(np.float32)
+        C_test = np.random.random(C.shape).astype(np.float32)
+        correctness_check_values = {
+            "pre": [A_test, B_test, C_test],
+            "post": [A_test, B_test, C_test + A_test @ B_test]
+        }
 
-    def test_kernelize_2(self) -> None:
-        from accera import Target, Nest
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, A.shape[0] // min(4, target.num_threads))
+        schedule.reorder(i, ii, j, k)
 
-        A = Array(role=Array.Role.INPUT, shape=(16, 16))
-        B = Array(role=Array.Role.INPUT, shape=(16, 16))
-        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(16, 16))
+        plan = schedule.create_plan(target)
+        plan.parallelize(indices=(i, ii))
+        self._verify_plan(plan, [A, B, C], "test_thread_pool_runtime", correctness_check_values)
 
-        nest = Nest(shape=(16, 16, 16))
+    def test_async_function(self) -> None:
+        A = Array(role=Array.Role.INPUT, shape=(256, 256))
+        B = Array(role=Array.Role.INPUT, shape=(256, 256))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(256, 256))
+
+        nest = Nest(shape=(256, 256, 256))
         i, j, k = nest.get_indices()
 
         @nest.iteration_logic
         def _():
             C[i, j] += A[i, k] * B[k, j]
 
-        my_target = Target(category=Target.Category.CPU, vector_bytes=16, vector_registers=2)
-        plan = nest.create_plan(my_target)
-
-        # Shorthand for:
-        # plan.unroll(i)
-        # plan.vectorize(j)
-        # plan.vectorize(k)
-        plan.kernelize(unroll_indices=(i, ), vectorize_indices=(j, k))
-        self._verify_plan(plan, [A, B, C], "test_kernelize_2")
+        plan = nest.create_plan()
+        plan.parallelize(indices=i)
 
-    @expectedFailure(FailedReason.NOT_IN_PY, "pinning parallelization to CPU cores")
-    def test_cpu_bind(self) -> None:
-        A = Array(role=Array.Role.INPUT, shape=(16, 11))
-        B = Array(role=Array.Role.INPUT, shape=(11, 10))
-        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(16, 10))
+        package = Package()
+        function = package.add(plan, args=(A, B, C), base_name="matmul", function_opts={"async": True})
 
-        nest = Nest(shape=(16, 10, 11))
-        i, j, k = nest.get_indices()
+        with self.assertRaises(ValueError):
+            gpu_plan = nest.create_plan(Target(Target.Model.AMD_MI100))
+            Package().add(gpu_plan, args=(A, B, C), function_opts={"async": True})
 
-        @nest.iteration_logic
-        def _():
-            C[i, j] += A[i, k] * B[k, j]
+        package_name = "test_async_function"
+        with verifiers.VerifyPackage(self, package_name, TEST_PACKAGE_DIR) as v:
+            package.build(package_name, format=TEST_FORMAT, mode=TEST_MODE, output_dir=TEST_PACKAGE_DIR)
 
-        target = Target("HOST", num_threads=16)
-        plan = nest.create_plan(target)
+            # the synchronous function is unchanged, the asynchronous variant is declared next to it
+            A_test = np.random.random(A.shape).astype(np.float32)
+            B_test = np.random.random(B.shape).astype(np.float32)
+            C_test = np.random.random(C.shape).astype(np.float32)
+            v.check_correctness(
+                function.name, before=(A_test, B_test, C_test), after=(A_test, B_test, C_test + A_test @ B_test)
+            )
 
-        plan.parallelize(indices=(i, j, k), pin=(target.cores[0], target.cores[1]))    # TODO: confirm syntax
-        self._verify_plan(plan, [A, B, C], "test_cpu_bind")
+            with open(os.path.join(TEST_PACKAGE_DIR, f"{package_name}.hat")) as f:
+                header = f.read()
+            self.assertIn(f"int64_t {function.name}_async(", header)
+            self.assertIn("void AcceraAsyncWait(int64_t handle);", header)
 
-    def test_gpu_bind(self) -> None:
-        M = 128
-        N = 256
-        K = 256
-        A = Array(role=Array.Role.INPUT, shape=(M, K))
-        B = Array(role=Array.Role.INPUT, shape=(K, N))
-        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(M, N))
+    def test_workspace_function(self) -> None:
+        A = Array(role=Array.Role.INPUT, shape=(64, 64))
+        B = Array(role=Array.Role.INPUT, shape=(64, 64))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(64, 64))
 
-        nest = Nest(shape=(M, N, K))
+        nest = Nest(shape=(64, 64, 64))
         i, j, k = nest.get_indices()
 
         @nest.iteration_logic
         def _():
             C[i, j] += A[i, k] * B[k, j]
 
-        v100 = Target(Target.Model.NVIDIA_V100, category=Target.Category.GPU)
-        plan = nest.create_plan(v100)
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, 16)
+        jj = schedule.split(j, 16)
+        schedule.reorder(i, j, k, ii, jj)
 
-        plan.bind(mapping={
-            i: v100.GridUnit.BLOCK_X,
-            j: v100.GridUnit.THREAD_X,
-            k: v100.GridUnit.THREAD_Y
-        })
+        plan = schedule.create_plan()
+        plan.cache(A, index=ii)
+        plan.cache(B, index=ii)
 
-        test_name = "test_gpu_bind"
         package = Package()
-        function = package.add(plan, args=(A, B, C), base_name=test_name)
+        function = package.add(plan, args=(A, B, C), base_name="matmul", function_opts={"workspace": True})
 
-        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        with self.assertRaises(ValueError):
+            gpu_plan = nest.create_plan(Target(Target.Model.AMD_MI100))
+            Package().add(gpu_plan, args=(A, B, C), function_opts={"workspace": True})
 
-        with verifiers.VerifyPackage(self, test_name, output_dir, file_list=[f"{test_name}.cu",
-                                                                             f"{test_name}.hat"]) as v:
-            package.build(
-                name=test_name,
-                format=Package.Format.MLIR | Package.Format.CUDA | Package.Format.HAT_PACKAGE,
-                mode=Package.Mode.RELEASE,    # Package.Mode.DEBUG,
-                output_dir=output_dir
+        package_name = "test_workspace_function"
+
+        # the debug wrappers don't know about the workspace argument
+        with self.assertRaises(ValueError):
+            package.build(package_name, format=TEST_FORMAT, mode=Package.Mode.DEBUG, output_dir=TEST_PACKAGE_DIR)
+
+        with verifiers.VerifyPackage(self, package_name, TEST_PACKAGE_DIR) as v:
+            package.build(package_name, format=TEST_FORMAT, mode=Package.Mode.RELEASE, output_dir=TEST_PACKAGE_DIR)
+
+            # the caches live in the trailing workspace argument, which only needs to be large enough
+            # for the buffers, so only the outputs are checked
+            A_test = np.random.random(A.shape).astype(np.float32)
+            B_test = np.random.random(B.shape).astype(np.float32)
+            C_test = np.random.random(C.shape).astype(np.float32)
+            workspace = np.zeros(1 << 16, dtype=np.uint8)
+            v.check_correctness(
+                function.name,
+                before=(A_test, B_test, C_test, workspace),
+                after=(A_test, B_test, C_test + A_test @ B_test)
             )
 
-    def test_scheduling_strategies(self) -> None:
-        A = Array(role=Array.Role.INPUT, shape=(256, 1024))
-        B = Array(role=Array.Role.INPUT, shape=(1024, 512))
-        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(256, 512))
+            with open(os.path.join(TEST_PACKAGE_DIR, f"{package_name}.hat")) as f:
+                header = f.read()
+            self.assertIn(f"int64_t {function.name}_workspace_size();", header)
+            self.assertIn(f"void {function.name}(float*, float*, float*, uint8_t*);", header)
 
-        nest = Nest(shape=(256, 512, 1024))
+    def test_prepacked_argument(self) -> None:
+        A = Array(role=Array.Role.INPUT, shape=(64, 64))
+        B = Array(role=Array.Role.INPUT, shape=(64, 64))
+        C = Array(role=Array.Role.INPUT_OUTPUT, shape=(64, 64))
+
+        nest = Nest(shape=(64, 64, 64))
         i, j, k = nest.get_indices()
 
         @nest.iteration_logic
         def _():
             C[i, j] += A[i, k] * B[k, j]
 
-        target = Target("HOST", num_threads=16)
-
-        # disable correctness checking on windows because the
-        # install location of libomp.dll is non-standard as of now
-        if sys.platform.startswith('win'):
-            correctness_check_values = None
-        else:
-            A_test = np.random.random(A.shape).astype(np.float32)
-            B_test = np.random.random(B.shape).astype(np.float32)
-            C_test = np.random.random(C.shape).astype(np.float32)
-            correctness_check_values = {
-                "pre": [A_test, B_test, C_test],
-                "post": [A_test, B_test, C_test + A_test @ B_test]
-            }
-
         schedule = nest.create_schedule()
-        ii = schedule.split(i, A.shape[0] // min(4, target.num_threads))
-        # set the index (k) that cannot be parallelized as innermost
-        schedule.reorder(i, ii, j, k)
-
-        for policy in ["static", "dynamic"]:
-            plan = schedule.create_plan(target)
+        jj = schedule.split(j, 16)
+        kk = schedule.split(k, 16)
+        schedule.reorder(j, k, i, jj, kk)
 
-            # wrong order
-            with self.assertRaises(ValueError):
-                plan.parallelize(indices=(k, ii), policy=policy)
-
-            # non-contiguous
-            with self.assertRaises(ValueError):
-                plan.parallelize(indices=(i, j), policy=policy)
+        plan = schedule.create_plan()
+        plan.cache(B, index=i)
 
-            # non-collapsed
-            plan.parallelize(indices=i, policy=policy)
-            self._verify_plan(plan, [A, B, C], f"test_parallelize_i_{policy}", correctness_check_values)
+        package = Package()
+        function = package.add(plan, args=(A, B, C), base_name="matmul")
+        prepacked_function = package.add(plan, args=(A, B, C), base_name="matmul", function_opts={"prepack": [B]})
+        self.assertNotEqual(function.name, prepacked_function.name)
 
-            # parallelizing middle index
-            plan_ii = schedule.create_plan(target)
-            plan_ii.parallelize(indices=ii, policy=policy)
-            self._verify_plan(plan_ii, [A, B, C], f"test_parallelize_ii_{policy}", correctness_check_values)
+        with self.assertRaises(ValueError):
+            Package().add(plan, args=(A, B, C), function_opts={"prepack": [C]})
+        with self.assertRaises(ValueError):
+            Package().add(plan, args=(A, C), function_opts={"prepack": [B]})
+        with self.assertRaises(ValueError):
+            gpu_plan = nest.create_plan(Target(Target.Model.AMD_MI100))
+            Package().add(gpu_plan, args=(A, B, C), function_opts={"prepack": [B]})
 
-            # partial collapsed
-            plan_partial = schedule.create_plan(target)
-            plan_partial.parallelize(indices=(i, ii, j), policy=policy)
-            self._verify_plan(plan_partial, [A, B, C], f"test_parallelize_i_ii_j_{policy}", correctness_check_values)
+        package_name = "test_prepacked_argument"
+        with verifiers.VerifyPackage(self, package_name, TEST_PACKAGE_DIR) as v:
+            package.build(package_name, format=TEST_FORMAT, mode=Package.Mode.RELEASE, output_dir=TEST_PACKAGE_DIR)
 
-            # partial collapsed inner indices
-            plan_partial_inner = schedule.create_plan(target)
-            plan_partial_inner.parallelize(indices=(ii, j), policy=policy)
-            self._verify_plan(
-                plan_partial_inner, [A, B, C], f"test_parallelize_ii_j_{policy}", correctness_check_values
+            A_test = np.random.random(A.shape).astype(np.float32)
+            B_test = np.random.random(B.shape).astype(np.float32)
+            C_test = np.random.random(C.shape).astype(np.float32)
+            v.check_correctness(
+                function.name, before=(A_test, B_test, C_test), after=(A_test, B_test, C_test + A_test @ B_test)
             )
 
-            # fully collapsed will result in correctness issues because parallelizing k can stomp on the C matrix
-            # where multiple threads try to update C[i, j] for different values of k
+            with open(os.path.join(TEST_PACKAGE_DIR, f"{package_name}.hat")) as f:
+                header = f.read()
+            self.assertIn(f"{prepacked_function.name}_pack_arg1(", header)
+            self.assertIn(f"int64_t {prepacked_function.name}_pack_arg1_size();", header)
+            self.assertNotIn(f"{function.name}_pack_arg1(", header)
 
 
 class DSLTest_08DeferredLayout(unittest.TestCase):
@@ -2975,6 +5094,26 @@ class DSLTest_10Packages(unittest.TestCase):
                 platform=Package.Platform.RASPBIAN
             )
 
+    def test_aarch64_HAT_packages(self) -> None:
+        from accera import Target
+
+        for model in [Target.Model.AWS_GRAVITON2, Target.Model.AWS_GRAVITON3, Target.Model.APPLE_M1]:
+            target = Target(model)
+            plan, A = self._create_plan(target)
+
+            package = Package()
+            package_name = f"MyPackage_{target._device_name.replace('-', '_')}"
+            package.add(plan, args=(A, ), base_name="func1")
+
+            with verifiers.VerifyPackage(self, package_name, TEST_PACKAGE_DIR):
+                package.build(
+                    package_name,
+                    format=Package.Format.HAT_STATIC,
+                    mode=TEST_MODE,
+                    output_dir=TEST_PACKAGE_DIR,
+                    platform=Package.Platform.MACOS if model == Target.Model.APPLE_M1 else Package.Platform.LINUX
+                )
+
     def test_MLIR_packages(self) -> None:
         plan, A = self._create_plan()
 
@@ -2997,6 +5136,50 @@ class DSLTest_10Packages(unittest.TestCase):
         with verifiers.VerifyPackage(self, package_name):
             package.build(package_name, format=TEST_FORMAT, mode=TEST_MODE)
 
+    def test_huge_page_threshold(self) -> None:
+        M = N = K = 256
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        nest = Nest(shape=(M, N, K))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        schedule = nest.create_schedule()
+        jj = schedule.split(j, 128)
+        kk = schedule.split(k, 128)
+        schedule.reorder(j, k, i, jj, kk)
+        plan = schedule.create_plan()
+
+        # the 64KB cache of B is above the threshold, the 512 byte cache of A is not
+        plan.cache(B, index=i)
+        plan.cache(A, index=jj)
+
+        package = Package()
+        package_name = "test_huge_page_threshold"
+        function = package.add(plan, args=(A, B, C), base_name="func1")
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / package_name
+
+        with self.assertRaises(ValueError):
+            package.build(package_name, format=TEST_FORMAT, output_dir=output_dir, huge_page_threshold=0)
+
+        with verifiers.VerifyPackage(self, package_name, output_dir) as v:
+            package.build(
+                package_name, format=TEST_FORMAT, mode=TEST_MODE, output_dir=output_dir, huge_page_threshold=4096
+            )
+
+            A_test = np.random.random(A.shape).astype(np.float32)
+            B_test = np.random.random(B.shape).astype(np.float32)
+            C_test = np.random.random(C.shape).astype(np.float32)
+
+            v.check_correctness(
+                function.name, before=[A_test, B_test, C_test], after=[A_test, B_test, C_test + A_test @ B_test]
+            )
+
     def test_debug_mode_1(self) -> None:
         M = N = K = 16
         A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
@@ -3054,8 +5237,11 @@ class DSLTest_10Packages(unittest.TestCase):
         schedule.reorder(i, k, j, ii)
         plan = schedule.create_plan()
         plan.unroll(ii)
+        with self.assertRaises(ValueError):
+            plan.parallelize(indices=k)
+
         # deliberately introduce a correctness issue
-        plan.parallelize(indices=k)
+        plan.parallelize(indices=k, _check_dependences=False)
 
         package = Package()
         package_name = "MyDebugPackageIncorrect"
@@ -3078,6 +5264,58 @@ class DSLTest_10Packages(unittest.TestCase):
             except Exception as e:
                 print(e)
 
+    def test_debug_mode_sampled(self) -> None:
+        M, N, K = 64, 48, 32
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        nest = Nest(shape=(M, N, K))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        schedule = nest.create_schedule()
+        jj = schedule.split(j, 8)
+        schedule.reorder(i, j, k, jj)
+        plan = schedule.create_plan()
+        plan.vectorize(jj)
+
+        package = Package()
+        package_name = "MyDebugPackageSampled"
+        function = package.add(plan, args=(A, B, C), base_name="func1")
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / package_name
+
+        with verifiers.VerifyPackage(self, package_name, output_dir) as v:
+            # the reference computes and checks every 4th row of C in parallel, the rows are independent
+            package.build(
+                package_name,
+                format=TEST_FORMAT,
+                output_dir=output_dir,
+                mode=Package.Mode.DEBUG,
+                tolerance=1e-4,
+                debug_sample_stride=4
+            )
+
+            A_test = np.random.random(A.shape).astype(np.float32)
+            B_test = np.random.random(B.shape).astype(np.float32)
+            C_test = np.random.random(C.shape).astype(np.float32)
+
+            v.check_correctness(
+                function.name, before=[A_test, B_test, C_test], after=[A_test, B_test, C_test + A_test @ B_test]
+            )
+
+        with self.assertRaises(ValueError):
+            package.build(
+                package_name + "_invalid",
+                format=TEST_FORMAT,
+                output_dir=output_dir,
+                mode=Package.Mode.DEBUG,
+                debug_sample_stride=0
+            )
+
     def test_debug_mode_fusion_1(self) -> None:
         from accera import fuse
 
@@ -1403,6 +1403,54 @@ class SmokeTest(unittest.TestCase):
                 platform=Package.Platform.RASPBIAN
             )
 
+    def test_cross_targets(self) -> None:
+        import hatlib as hat
+        from accera import Target
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(64, 64))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(64, 64))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(64, 64))
+
+        nest = Nest(shape=(64, 64, 64))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        pi3 = Target(Target.Model.RASPBERRY_PI_3B, category=Target.Category.CPU)
+        package = Package()
+        package.add(nest.create_plan(pi3), args=(A, B, C), base_name="matmul_cross_targets")
+
+        # the 64-bit targets don't share the data layout of the 32-bit ARM targets
+        with self.assertRaises(ValueError):
+            package.build(
+                name="cross_targets_mismatch",
+                format=Package.Format.HAT_STATIC,
+                output_dir=TEST_PACKAGE_DIR,
+                platform=Package.Platform.RASPBIAN,
+                cross_targets=["neoverse-n1"]
+            )
+
+        package_name = "cross_targets"
+        with verifiers.VerifyPackage(self, package_name, TEST_PACKAGE_DIR):
+            package.build(
+                name=package_name,
+                format=Package.Format.HAT_STATIC,
+                mode=self.PACKAGE_MODE,
+                output_dir=TEST_PACKAGE_DIR,
+                platform=Package.Platform.RASPBIAN,
+                cross_targets=["pi0"]
+            )
+
+        # the package of the cross target has its own HAT file and object files
+        cross_target_dir = os.path.join(TEST_PACKAGE_DIR, "pi0")
+        hat_file = hat.HATFile.Deserialize(os.path.join(cross_target_dir, package_name + ".hat"))
+        self.assertIn("matmul_cross_targets", hat_file.function_map)
+        self.assertTrue(os.path.isfile(os.path.join(cross_target_dir, hat_file.dependencies.link_target)))
+        for dependency in hat_file.dependencies.dynamic:
+            self.assertNotEqual(os.path.dirname(dependency.target_file), os.path.abspath(TEST_PACKAGE_DIR))
+
     def test_parameter_grid_no_regression(self) -> None:
 
         A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(16, 16))
@@ -1453,31 +1501,1604 @@ class SmokeTest(unittest.TestCase):
         ii = schedule.split(i, size=P3)
         schedule.reorder(order=P5)
 
-        plan = schedule.create_plan()
-        plan.cache(A, level=P4)
+        plan = schedule.create_plan()
+        plan.cache(A, level=P4)
+
+        # Create a package and add our grid of functions to it
+        package = Package()
+
+        package.add(
+            plan,
+            args=(A, B, C),
+            parameters={
+                P0: 16,
+                P1: 16,
+                P2: 16,
+                P3: 4,
+                P4: 2,
+                P5: (j, k, i, ii)
+            },
+            base_name="alternative_matmul_16_16_16"
+        )
+
+        # Build the HAT package
+        package.build("hello_matmul_parameter_grid", output_dir=TEST_PACKAGE_DIR)
+
+        # Check that the package dir exists
+        self.assertTrue(os.path.isdir(TEST_PACKAGE_DIR))
+
+    def test_parameter_grid_num_workers(self) -> None:
+        from accera import create_parameter_grid
+
+        P0, P1 = create_parameters(2)
+        M, N, K = 32, 32, 32
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        nest = Nest(shape=[M, N, K])
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, size=P0)
+        jj = schedule.split(j, size=P1)
+        schedule.reorder(i, j, k, ii, jj)
+
+        plan = schedule.create_plan()
+
+        test_name = "test_parameter_grid_num_workers"
+        package = Package()
+        functions = package.add(
+            plan, args=(A, B, C), parameters=create_parameter_grid({
+                P0: [4, 8],
+                P1: [8, 16]
+            }), base_name=test_name
+        )
+
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        with verifiers.VerifyPackage(self, test_name, output_dir) as v:
+            package.build(
+                test_name,
+                format=self.PACKAGE_FORMAT,
+                mode=Package.Mode.RELEASE,
+                output_dir=output_dir,
+                num_workers=2
+            )
+            self.assertTrue((output_dir / f"{test_name}_shard1.hat").is_file())
+
+            for function in functions:
+                A_test = np.random.random(A.shape).astype(np.float32)
+                B_test = np.random.random(B.shape).astype(np.float32)
+                C_test = np.random.random(C.shape).astype(np.float32)
+                C_ref = C_test + A_test @ B_test
+                v.check_correctness(function.name, before=(A_test, B_test, C_test), after=(A_test, B_test, C_ref))
+
+    def test_deferred_layout_between_functions(self) -> None:
+        M, N, K = 64, 64, 64
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N), layout=Array.Layout.DEFERRED)
+        D = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(N, M))
+
+        # the producer computes C, the consumer transposes it into D and caches its columns
+        producer = Nest(shape=(M, N, K))
+        i, j, k = producer.get_indices()
+
+        @producer.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        consumer = Nest(shape=(N, M))
+        n, m = consumer.get_indices()
+
+        @consumer.iteration_logic
+        def _():
+            D[n, m] = C[m, n]
+
+        consumer_plan = consumer.create_plan()
+        consumer_plan.cache(C, index=m, layout=Array.Layout.LAST_MAJOR, thrifty=True)
+
+        test_name = "test_deferred_layout_between_functions"
+        package = Package()
+        producer_fn = package.add(producer, args=(A, B, C), base_name=f"{test_name}_producer")
+        consumer_fn = package.add(consumer_plan, args=(C, D), base_name=f"{test_name}_consumer")
+        self.assertIsNone(C._get_native_array())
+
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        with verifiers.VerifyPackage(self, test_name, output_dir) as v:
+            package.build(test_name, format=self.PACKAGE_FORMAT, mode=Package.Mode.RELEASE, output_dir=output_dir)
+
+            # the producer writes C in the column-major layout of the cache of the consumer
+            A_test = np.random.random(A.shape).astype(np.float32)
+            B_test = np.random.random(B.shape).astype(np.float32)
+            C_test = np.zeros(C.shape, dtype=np.float32, order="F")
+            C_ref = np.asfortranarray(A_test @ B_test)
+            v.check_correctness(producer_fn.name, before=(A_test, B_test, C_test), after=(A_test, B_test, C_ref))
+
+            D_test = np.random.random(D.shape).astype(np.float32)
+            v.check_correctness(consumer_fn.name, before=(C_ref, D_test), after=(C_ref, C_ref.T))
+
+    def test_parameter_grid_shared_variants(self) -> None:
+        from accera import create_parameter_grid
+
+        P0, P1, P2 = create_parameters(3)
+        M, N, K = 32, 32, 32
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        nest = Nest(shape=[M, N, K])
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, size=P0)
+        jj = schedule.split(j, size=P1)
+        schedule.reorder(i, j, k, ii, jj)
+
+        plan = schedule.create_plan()
+
+        # the grid is shared with other plans, this plan doesn't read P2
+        test_name = "test_parameter_grid_shared_variants"
+        package = Package()
+        functions = package.add(
+            plan, args=(A, B, C), parameters=create_parameter_grid({
+                P0: [4, 8],
+                P1: [8],
+                P2: [1, 2, 3]
+            }), base_name=test_name
+        )
+        self.assertEqual(len(functions), 6)
+
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        with verifiers.VerifyPackage(self, test_name, output_dir) as v:
+            package.build(test_name, format=self.PACKAGE_FORMAT, mode=Package.Mode.RELEASE, output_dir=output_dir)
+
+            # the variants that only differ in P2 call the implementation of the first of them
+            self.assertEqual(len({function._impl_name for function in functions}), 2)
+
+            for function in functions:
+                A_test = np.random.random(A.shape).astype(np.float32)
+                B_test = np.random.random(B.shape).astype(np.float32)
+                C_test = np.random.random(C.shape).astype(np.float32)
+                C_ref = C_test + A_test @ B_test
+                v.check_correctness(function.name, before=(A_test, B_test, C_test), after=(A_test, B_test, C_ref))
+
+    def test_build_cache(self) -> None:
+        M, N, K = 32, 32, 32
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        def make_plan(split):
+            nest = Nest(shape=[M, N, K])
+            i, j, k = nest.get_indices()
+
+            @nest.iteration_logic
+            def _():
+                C[i, j] += A[i, k] * B[k, j]
+
+            schedule = nest.create_schedule()
+            schedule.split(i, split)
+            return schedule.create_plan()
+
+        test_name = "test_build_cache"
+        cache_dir = pathlib.Path(TEST_PACKAGE_DIR) / f"{test_name}_cache"
+        shutil.rmtree(cache_dir, ignore_errors=True)
+
+        def build(splits, build_name):
+            package = Package()
+            functions = [package.add(make_plan(split), args=(A, B, C), base_name=f"{test_name}_{split}") for split in splits]
+            output_dir = pathlib.Path(TEST_PACKAGE_DIR) / build_name
+            shutil.rmtree(output_dir, ignore_errors=True)
+
+            with verifiers.VerifyPackage(self, test_name, output_dir) as v:
+                package.build(
+                    test_name, format=self.PACKAGE_FORMAT, mode=Package.Mode.RELEASE, output_dir=output_dir, cache_dir=cache_dir
+                )
+                for function in functions:
+                    A_test = np.random.random(A.shape).astype(np.float32)
+                    B_test = np.random.random(B.shape).astype(np.float32)
+                    C_test = np.random.random(C.shape).astype(np.float32)
+                    C_ref = C_test + A_test @ B_test
+                    v.check_correctness(function.name, before=(A_test, B_test, C_test), after=(A_test, B_test, C_ref))
+
+        def cached_objects():
+            return sorted(p.name for p in cache_dir.glob("*/*") if not p.name.endswith(".tmp"))
+
+        build([4, 8], test_name)
+        objects = cached_objects()
+        self.assertEqual(len(objects), 2)
+
+        # an identical build is served from the cache, adding a function only compiles the new one
+        build([4, 8], f"{test_name}_rebuild")
+        self.assertEqual(cached_objects(), objects)
+        build([4, 8, 16], f"{test_name}_extended")
+        self.assertEqual(len(cached_objects()), 3)
+        self.assertTrue(set(objects) < set(cached_objects()))
+
+    def test_build_in_process(self) -> None:
+        M, N, K = 32, 32, 32
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        nest = Nest(shape=[M, N, K])
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        test_name = "test_build_in_process"
+
+        # packages are compiled in-process, unless the IR is dumped, which runs the tools and keeps their files
+        for format, runs_tools in [(Package.Format.HAT_DYNAMIC, False), (Package.Format.MLIR_DYNAMIC, True)]:
+            package = Package()
+            function = package.add(nest, args=(A, B, C), base_name=test_name)
+            output_dir = pathlib.Path(TEST_PACKAGE_DIR) / f"{test_name}_{format.name.lower()}"
+            shutil.rmtree(output_dir, ignore_errors=True)
+
+            with verifiers.VerifyPackage(self, test_name, output_dir) as v:
+                package.build(test_name, format=format, mode=Package.Mode.RELEASE, output_dir=output_dir)
+
+                A_test = np.random.random(A.shape).astype(np.float32)
+                B_test = np.random.random(B.shape).astype(np.float32)
+                C_test = np.random.random(C.shape).astype(np.float32)
+                C_ref = C_test + A_test @ B_test
+                v.check_correctness(function.name, before=(A_test, B_test, C_test), after=(A_test, B_test, C_ref))
+
+            translated_ll = output_dir / "_tmp" / test_name / f"{test_name}.ll"
+            self.assertEqual(translated_ll.is_file(), runs_tools)
+
+    def test_compile_report(self) -> None:
+        import json
+
+        N = 64
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(N, ))
+        B = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(N, ))
+
+        nest = Nest(shape=[N])
+        i, = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            B[i] += A[i]
+
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, 16)
+        plan = schedule.create_plan()
+        plan.unroll(ii)
+
+        test_name = "test_compile_report"
+
+        # the report is written by the in-process compilation and by the tools
+        for format in [Package.Format.HAT_DYNAMIC, Package.Format.MLIR_DYNAMIC]:
+            package = Package()
+            package.add(plan, args=(A, B), base_name=test_name)
+            output_dir = pathlib.Path(TEST_PACKAGE_DIR) / f"{test_name}_{format.name.lower()}"
+            shutil.rmtree(output_dir, ignore_errors=True)
+
+            with verifiers.VerifyPackage(self, test_name, output_dir):
+                package.build(
+                    test_name, format=format, mode=Package.Mode.RELEASE, output_dir=output_dir, compile_report=True
+                )
+
+            with open(output_dir / f"{test_name}.compile_stats.json") as f:
+                stages = {stage["stage"]: stage for stage in json.load(f)["stages"]}
+            self.assertIn("LoopNestToValueFunc", stages)
+            self.assertIn("GpuToLLVM", stages)
+            self.assertTrue(all(stage["elapsed_ms"] >= 0 for stage in stages.values()))
+
+            # the unrolled loop body is counted in the function that implements the nest once the loops are unrolled
+            self.assertGreaterEqual(
+                max(max(stage["functions"].values(), default=0) for stage in stages.values()), 16
+            )
+
+            with open(output_dir / f"{test_name}.pass_timing.txt") as f:
+                self.assertIn("Execution time report", f.read())
+
+    def test_streaming_emission(self) -> None:
+        import json
+
+        M = 64
+        N = 32
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, N))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        test_name = "test_streaming_emission"
+
+        emitter_stats = {}
+        for streaming_emission in [False, True]:
+            nest = Nest(shape=[M, N])
+            i, j = nest.get_indices()
+
+            @nest.iteration_logic
+            def _():
+                C[i, j] += A[i, j] * B[i, j]
+                C[i, j] += A[i, j] - B[i, j]
+                C[i, j] *= A[i, j]
+
+            package = Package()
+            function = package.add(nest, args=(A, B, C), base_name=test_name)
+            output_dir = pathlib.Path(TEST_PACKAGE_DIR) / f"{test_name}_{streaming_emission}"
+            shutil.rmtree(output_dir, ignore_errors=True)
+
+            with verifiers.VerifyPackage(self, test_name, output_dir) as v:
+                package.build(
+                    test_name,
+                    format=self.PACKAGE_FORMAT,
+                    mode=self.PACKAGE_MODE,
+                    output_dir=output_dir,
+                    compile_report=True,
+                    streaming_emission=streaming_emission
+                )
+
+                A_test, B_test, C_test = (np.random.random(p.shape).astype(np.float32) for p in function.args)
+                C_ref = (C_test + A_test * B_test + A_test - B_test) * A_test
+                v.check_correctness(function.name, before=(A_test, B_test, C_test), after=(A_test, B_test, C_ref))
+
+            with open(output_dir / f"{test_name}.emitter_stats.json") as f:
+                emitter_stats[streaming_emission] = json.load(f)
+
+        # only the scope of the module is left once the functions are emitted
+        self.assertEqual(emitter_stats[False]["emittable_scopes"], 1)
+        self.assertEqual(emitter_stats[True]["emittable_scopes"], 1)
+
+        # the emittables of the kernel body are released once the kernel is emitted, not with the function
+        self.assertGreater(emitter_stats[True]["released_local_emittables"], 0)
+        self.assertLessEqual(
+            emitter_stats[True]["peak_local_emittables"], emitter_stats[False]["peak_local_emittables"]
+        )
+
+    def test_update_package(self) -> None:
+        N = 64
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(N, ))
+        B = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(N, ))
+
+        def make_plan(scale):
+            nest = Nest(shape=[N])
+            i, = nest.get_indices()
+
+            @nest.iteration_logic
+            def _():
+                B[i] += A[i] * scale
+
+            return nest.create_plan()
+
+        test_name = "test_update_package"
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        package = Package()
+        add_fn = package.add(make_plan(1.0), args=(A, B), base_name="add")
+        scale_fn = package.add(make_plan(2.0), args=(A, B), base_name="scale")
+        package.build(test_name, format=self.PACKAGE_FORMAT, mode=self.PACKAGE_MODE, output_dir=output_dir, update=True)
+
+        # the changed function keeps its name and replaces the one in the package, the other one is kept
+        package = Package()
+        changed_fn = package.add(make_plan(3.0), args=(A, B), base_name="add")
+        self.assertEqual(changed_fn.name, add_fn.name)
+        package.build(test_name, format=self.PACKAGE_FORMAT, mode=self.PACKAGE_MODE, output_dir=output_dir, update=True)
+
+        v = verifiers.VerifyPackage(self, test_name, output_dir)
+        A_test, B_test = (np.random.random(p.shape).astype(np.float32) for p in add_fn.args)
+        v.check_correctness(add_fn.name, before=(A_test, B_test), after=(A_test, B_test + A_test * 3.0))
+        v.check_correctness(scale_fn.name, before=(A_test, B_test), after=(A_test, B_test + A_test * 2.0))
+
+        # a package that wasn't built with update can't be updated
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / f"{test_name}_not_updatable"
+        shutil.rmtree(output_dir, ignore_errors=True)
+        package.build(test_name, format=self.PACKAGE_FORMAT, mode=self.PACKAGE_MODE, output_dir=output_dir)
+
+        package = Package()
+        package.add(make_plan(2.0), args=(A, B), base_name="scale")
+        with self.assertRaises(ValueError):
+            package.build(
+                test_name, format=self.PACKAGE_FORMAT, mode=self.PACKAGE_MODE, output_dir=output_dir, update=True
+            )
+
+    def test_cpu_versions(self) -> None:
+        import hatlib as hat
+
+        N = 256
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(N, ))
+        B = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(N, ))
+
+        nest = Nest(shape=[N])
+        i, = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            B[i] += A[i] * A[i]
+
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, 16)
+        plan = schedule.create_plan()
+        plan.vectorize(ii)
+
+        test_name = "test_cpu_versions"
+        package = Package()
+        function = package.add(plan, args=(A, B), base_name=test_name)
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        with self.assertRaises(ValueError):
+            package.build(test_name, format=self.PACKAGE_FORMAT, output_dir=output_dir, cpu_versions=["sse4"])
+
+        with verifiers.VerifyPackage(self, test_name, output_dir) as v:
+            package.build(
+                test_name,
+                format=self.PACKAGE_FORMAT,
+                mode=self.PACKAGE_MODE,
+                output_dir=output_dir,
+                cpu_versions=["avx2", "avx512"]
+            )
+
+            # the versions are listed from the most capable, the package only requires the baseline
+            hat_file = hat.HATFile.Deserialize(output_dir / f"{test_name}.hat")
+            cpu_versions = hat_file.function_map[function.name].auxiliary["accera"]["cpu_versions"]
+            self.assertEqual([version["version"] for version in cpu_versions], ["avx512", "avx2", "baseline"])
+            self.assertEqual(hat_file.target.required.cpu.extensions, Package._BASELINE_EXTENSIONS)
+
+            A_test, B_test = (np.random.random(p.shape).astype(np.float32) for p in function.args)
+            v.check_correctness(function.name, before=(A_test, B_test), after=(A_test, B_test + A_test * A_test))
+
+    def test_llvm_bitcode(self) -> None:
+        N = 256
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(N, ))
+        B = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(N, ))
+
+        nest = Nest(shape=[N])
+        i, = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            B[i] += A[i]
+
+        test_name = "test_llvm_bitcode"
+        package = Package()
+        function = package.add(nest, args=(A, B), base_name=test_name)
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        with self.assertRaises(ValueError):
+            package.build(test_name, format=Package.Format.CPP | Package.Format.LLVM_BITCODE, output_dir=output_dir)
+
+        with verifiers.VerifyPackage(self, test_name, output_dir) as v:
+            package.build(
+                test_name,
+                format=self.PACKAGE_FORMAT | Package.Format.LLVM_BITCODE,
+                mode=self.PACKAGE_MODE,
+                output_dir=output_dir,
+                num_workers=1
+            )
+
+            # the bitcode of the package module is next to its object file, and starts with the bitcode magic
+            with open(output_dir / f"{test_name}.bc", "rb") as bitcode_file:
+                self.assertEqual(bitcode_file.read(4), b"BC\xc0\xde")
+            self.assertTrue((output_dir / f"{test_name}_Globals.bc").is_file())
+
+            A_test, B_test = (np.random.random(p.shape).astype(np.float32) for p in function.args)
+            v.check_correctness(function.name, before=(A_test, B_test), after=(A_test, B_test + A_test))
+
+    def test_cpp_header(self) -> None:
+        N = 4
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(N, N))
+        B = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(N, N))
+
+        nest = Nest(shape=(N, N))
+        i, j = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            B[i, j] += A[j, i]
+
+        test_name = "test_cpp_header"
+        package = Package()
+        function = package.add(nest, args=(A, B), base_name=test_name)
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        package.build(test_name, format=Package.Format.CPP_HEADER, mode=self.PACKAGE_MODE, output_dir=output_dir)
+
+        # the functions are defined in the header, with internal linkage
+        with open(output_dir / f"{test_name}.h") as header_file:
+            header = header_file.read()
+        self.assertTrue(header.startswith("#pragma once"))
+        self.assertIn(f"static inline void {function.name}(", header)
+        self.assertNotIn("extern \"C\"", header)
+
+    def test_argument_alignment(self) -> None:
+        import tomlkit
+
+        N = 256
+
+        with self.assertRaises(ValueError):
+            Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(N, ), alignment=48)
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(N, ), alignment=64)
+        B = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(N, ))
+
+        nest = Nest(shape=[N])
+        i, = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            B[i] += A[i] * A[i]
+
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, 16)
+        plan = schedule.create_plan()
+        plan.vectorize(ii)
+
+        test_name = "test_argument_alignment"
+        package = Package()
+        function = package.add(plan, args=(A, B), base_name=test_name)
+
+        def file_check_fn(v):
+            # only the aligned argument gets an alignment assumption
+            checker = v.file_checker("*_LoopNestToValueFunc.mlir")
+            checker.check("memref.assume_alignment %arg0, 64")
+            checker.check_not("memref.assume_alignment %arg1")
+            checker.run()
+
+        # the arguments that check_correctness allocates aren't guaranteed to be aligned
+        self._verify_matrix_multiplication_function(
+            function, package, test_name, file_check_fn=file_check_fn, check_correctness=False
+        )
+
+        hat_path = pathlib.Path(TEST_PACKAGE_DIR) / test_name / f"{test_name}.hat"
+        hat_args = tomlkit.parse(hat_path.read_text())["functions"][function.name]["arguments"]
+        self.assertEqual(hat_args[0]["alignment"], 64)
+        self.assertNotIn("alignment", hat_args[1])
+
+    def test_no_alias_arguments(self) -> None:
+        N = 256
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(N, ))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(N, ))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(N, ))
+
+        nest = Nest(shape=[N])
+        i, = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i] += A[i] * B[i]
+
+        test_name = "test_no_alias_arguments"
+        package = Package()
+        function = package.add(nest, args=(A, B, C), base_name=test_name, function_opts={"no_alias": True})
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        with verifiers.VerifyPackage(self, test_name, output_dir) as v:
+            package.build(test_name, format=self.PACKAGE_FORMAT, mode=self.PACKAGE_MODE, output_dir=output_dir)
+
+            # every array argument of the declaration is restrict-qualified
+            declaration = next(
+                line for line in (output_dir / f"{test_name}.hat").read_text().splitlines()
+                if line.startswith("void " + function.name + "(")
+            )
+            self.assertEqual(declaration.count("ACCERA_RESTRICT"), 3)
+
+            A_test, B_test, C_test = (np.random.random(p.shape).astype(np.float32) for p in function.args)
+            v.check_correctness(function.name, before=(A_test, B_test, C_test), after=(A_test, B_test, C_test + A_test * B_test))
+
+    def test_strided_view_arguments(self) -> None:
+        import tomlkit
+
+        M = 64
+        N = 64
+        LD = 1024
+
+        with self.assertRaises(ValueError):
+            Array(role=Array.Role.TEMP, element_type=ScalarType.float32, shape=(M, N), extent=(M, LD))
+
+        # A is 64 columns of a 64x1024 array, B is dense
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, N), extent=(M, LD))
+        B = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        nest = Nest(shape=[M, N])
+        i, j = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            B[i, j] += A[i, j]
+
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, 16)
+        schedule.reorder(i, j, ii)
+        plan = schedule.create_plan()
+        plan.cache(A, index=ii)
+
+        test_name = "test_strided_view_arguments"
+        package = Package()
+        function = package.add(plan, args=(A, B), base_name=test_name)
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        with verifiers.VerifyPackage(self, test_name, output_dir):
+            package.build(test_name, format=self.PACKAGE_FORMAT, mode=self.PACKAGE_MODE, output_dir=output_dir)
+
+        hat_args = tomlkit.parse((output_dir / f"{test_name}.hat").read_text())["functions"][function.name]["arguments"]
+        self.assertEqual(list(hat_args[0]["shape"]), [M, N])
+        self.assertEqual(list(hat_args[0]["affine_map"]), [LD, 1])
+        self.assertEqual(list(hat_args[1]["affine_map"]), [N, 1])
+
+    def test_code_size_budget(self) -> None:
+        import json
+
+        N = 256
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(N, ))
+        B = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(N, ))
+
+        nest = Nest(shape=[N])
+        i, = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            B[i] += A[i] * A[i]
+
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, 64)
+        plan = schedule.create_plan()
+        plan.unroll(ii)
+
+        test_name = "test_code_size_budget"
+        package = Package()
+        function = package.add(plan, args=(A, B), base_name=test_name)
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        functions = package.build(
+            test_name,
+            format=Package.Format.JIT,
+            output_dir=output_dir,
+            code_size_budget=200,
+            unroll_report=True
+        )
+
+        with open(output_dir / f"{test_name}.unroll.json") as f:
+            loops = [loop for fn in json.load(f)["functions"] for loop in fn["loops"]]
+        self.assertTrue(loops)
+
+        # the 64 copies of the body don't fit in the budget, so the loop is unrolled by a factor of its trip count
+        for loop in loops:
+            self.assertEqual(loop["requested_factor"], 64)
+            self.assertLess(loop["unroll_factor"], 64)
+            self.assertEqual(64 % loop["unroll_factor"], 0)
+
+        A_test = np.random.random(A.shape).astype(np.float32)
+        B_test = np.random.random(B.shape).astype(np.float32)
+        B_ref = B_test + A_test * A_test
+        functions[function.name](A_test, B_test)
+        np.testing.assert_allclose(B_test, B_ref, rtol=1e-5)
+
+    def test_build_jit(self) -> None:
+        M = 16
+        N = 32
+        K = 8
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        nest = Nest(shape=(M, N, K))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        schedule = nest.create_schedule()
+        jj = schedule.split(j, 8)
+        plan = schedule.create_plan()
+        plan.vectorize(jj)
+
+        test_name = "test_build_jit"
+        package = Package()
+        function = package.add(plan, args=(A, B, C), base_name=test_name)
+        functions = package.build(test_name, format=Package.Format.JIT, output_dir=TEST_PACKAGE_DIR)
+
+        A_test = np.random.random(A.shape).astype(np.float32)
+        B_test = np.random.random(B.shape).astype(np.float32)
+        C_test = np.random.random(C.shape).astype(np.float32)
+        C_ref = C_test + A_test @ B_test
+
+        functions[function.name](A_test, B_test, C_test)
+        np.testing.assert_allclose(C_test, C_ref, rtol=1e-5)
+
+        with self.assertRaises(TypeError):
+            functions[function.name](A_test.astype(np.float64), B_test, C_test)
+        with self.assertRaises(ValueError):
+            package.build(test_name, format=Package.Format.JIT | Package.Format.HAT_DYNAMIC)
+
+    def test_benchmark(self) -> None:
+        import json
+        from accera import BenchmarkOptions
+
+        M, N, K = 32, 32, 32
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        nest = Nest(shape=[M, N, K])
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        test_name = "test_benchmark"
+        package = Package()
+        function = package.add(nest, args=(A, B, C), base_name=test_name)
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        options = BenchmarkOptions(warmup_iterations=2, iterations=20, flops={test_name: 2 * M * N * K})
+        package.build(
+            test_name,
+            format=Package.Format.HAT_DYNAMIC,
+            mode=Package.Mode.RELEASE,
+            output_dir=output_dir,
+            benchmark=options
+        )
+
+        self.assertTrue((output_dir / f"{test_name}_benchmark.cpp").exists())
+        with open(output_dir / f"{test_name}.benchmark.json") as f:
+            results = json.load(f)["functions"]
+        self.assertEqual([r["name"] for r in results], [function.name])
+        result = results[0]
+        self.assertEqual(result["iterations"], 20)
+        self.assertTrue(0 < result["min_ms"] <= result["median_ms"] <= result["p99_ms"])
+        self.assertGreater(result["gflops"], 0)
+
+    def test_benchmark_mapped_inputs(self) -> None:
+        import json
+        from accera import BenchmarkOptions
+
+        M, N, K = 32, 32, 32
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        nest = Nest(shape=[M, N, K])
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        test_name = "test_benchmark_mapped_inputs"
+        package = Package()
+        function = package.add(nest, args=(A, B, C), base_name=test_name)
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+        output_dir.mkdir(parents=True)
+
+        # A is a .npy file, C a raw file that the calls write to through a copy-on-write mapping, B is random
+        A_test = np.random.random(A.shape).astype(np.float32)
+        C_test = np.random.random(C.shape).astype(np.float32)
+        np.save(output_dir / "A.npy", A_test)
+        C_test.tofile(output_dir / "C.bin")
+
+        options = BenchmarkOptions(
+            warmup_iterations=2, iterations=5, inputs={test_name: [str(output_dir / "A.npy"), None, str(output_dir / "C.bin")]}
+        )
+        package.build(
+            test_name,
+            format=Package.Format.HAT_DYNAMIC,
+            mode=Package.Mode.RELEASE,
+            output_dir=output_dir,
+            benchmark=options
+        )
+
+        harness = (output_dir / f"{test_name}_benchmark.cpp").read_text()
+        self.assertIn("MappedInput arg0(", harness)
+        self.assertIn("MappedInput arg2(", harness)
+        with open(output_dir / f"{test_name}.benchmark.json") as f:
+            results = json.load(f)["functions"]
+        self.assertEqual([r["name"] for r in results], [function.name])
+        self.assertTrue(np.array_equal(np.fromfile(output_dir / "C.bin", dtype=np.float32).reshape(C.shape), C_test))
+
+        # the shape of a .npy input must match its argument
+        np.save(output_dir / "A.npy", A_test[:16])
+        with self.assertRaises(ValueError):
+            package.build(
+                test_name,
+                format=Package.Format.HAT_DYNAMIC,
+                mode=Package.Mode.RELEASE,
+                output_dir=output_dir,
+                benchmark=options
+            )
+
+    def test_benchmark_roofline(self) -> None:
+        import json
+        from accera import BenchmarkOptions
+
+        N = 1024 * 1024
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(N, ))
+        B = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(N, ))
+
+        nest = Nest(shape=[N])
+        i = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            B[i] += A[i]
+
+        test_name = "test_benchmark_roofline"
+        package = Package()
+        function = package.add(nest, args=(A, B), base_name=test_name)
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        package.build(
+            test_name,
+            format=Package.Format.HAT_DYNAMIC,
+            mode=Package.Mode.RELEASE,
+            output_dir=output_dir,
+            benchmark=BenchmarkOptions(warmup_iterations=2, iterations=5, roofline=True)
+        )
+
+        with open(output_dir / f"{test_name}.roofline.json") as f:
+            roofline = json.load(f)
+        self.assertEqual([b["level"] for b in roofline["bandwidth"]][-1], "DRAM")
+        self.assertTrue(all(b["gbps"] > 0 for b in roofline["bandwidth"]))
+
+        entry, = roofline["functions"]
+        self.assertEqual(entry["name"], function.name)
+        self.assertGreater(entry["flops"], 0)
+        self.assertGreaterEqual(entry["bytes"], 2 * N * 4)
+        self.assertGreater(entry["achieved_gbps"], 0)
+        # the host target has no frequency, so its compute roof is unknown and the streaming add is memory-bound
+        self.assertIsNone(entry["compute_roof_gflops"])
+        self.assertEqual(entry["bound"], "memory")
+        self.assertIn("memory-bound at", entry["summary"])
+
+        with self.assertRaises(ValueError):
+            package.build(
+                test_name,
+                format=Package.Format.HAT_DYNAMIC,
+                output_dir=output_dir,
+                update=True,
+                benchmark=BenchmarkOptions(roofline=True)
+            )
+
+    def test_benchmark_cache_copies(self) -> None:
+        import json
+        from accera import BenchmarkOptions
+
+        M, N, K = 64, 64, 64
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        nest = Nest(shape=(M, N, K))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        schedule = nest.create_schedule()
+        jj, kk = schedule.tile({j: 16, k: 16})
+        schedule.reorder(j, k, i, jj, kk)
+        plan = schedule.create_plan()
+        plan.cache(B, index=i)
+
+        test_name = "test_benchmark_cache_copies"
+        package = Package()
+        function = package.add(plan, args=(A, B, C), base_name=test_name)
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        package.build(
+            test_name,
+            format=Package.Format.HAT_DYNAMIC,
+            mode=Package.Mode.RELEASE,
+            output_dir=output_dir,
+            benchmark=BenchmarkOptions(warmup_iterations=2, iterations=5, cache_copies=True)
+        )
+
+        with open(output_dir / f"{test_name}.cache_copies.json") as f:
+            cache_copies = json.load(f)
+        self.assertEqual([b["level"] for b in cache_copies["bandwidth"]][-1], "DRAM")
+
+        fills = [entry for entry in cache_copies["regions"] if entry["kind"] == "fill"]
+        self.assertTrue(fills)
+        for entry in fills:
+            self.assertEqual(entry["function"], function.name)
+            # each fill reads a 16x16 block of B and writes it to the cache
+            self.assertEqual(entry["bytes"], 2 * 16 * 16 * 4)
+            self.assertGreater(entry["count"], 0)
+            self.assertGreater(entry["achieved_gbps"], 0)
+            self.assertIn("GB/s", entry["summary"])
+
+        with self.assertRaises(ValueError):
+            package.build(
+                test_name,
+                format=Package.Format.HAT_DYNAMIC,
+                output_dir=output_dir,
+                update=True,
+                benchmark=BenchmarkOptions(cache_copies=True)
+            )
+
+    def test_benchmark_memory_traffic(self) -> None:
+        import json
+        from accera import BenchmarkOptions
+
+        M, N, K = 64, 64, 64
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        nest = Nest(shape=(M, N, K))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        schedule = nest.create_schedule()
+        jj, kk = schedule.tile({j: 16, k: 16})
+        schedule.reorder(j, k, i, jj, kk)
+        plan = schedule.create_plan()
+        plan.cache(B, index=i)
+
+        test_name = "test_benchmark_memory_traffic"
+        package = Package()
+        function = package.add(plan, args=(A, B, C), base_name=test_name)
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        package.build(
+            test_name,
+            format=Package.Format.HAT_DYNAMIC,
+            mode=Package.Mode.RELEASE,
+            output_dir=output_dir,
+            benchmark=BenchmarkOptions(warmup_iterations=2, iterations=5, memory_traffic=True)
+        )
+
+        with open(output_dir / f"{test_name}.memory_traffic.json") as f:
+            memory_traffic = json.load(f)
+        entry, = memory_traffic["functions"]
+        self.assertEqual(entry["name"], function.name)
+        arrays = {array["name"].split(":")[-1]: array for array in entry["arrays"]}
+
+        # each iteration loads an element of A and of the cache of B, the fills load each element of B once
+        self.assertEqual(arrays["arg0"]["loaded_bytes"], M * N * K * 4)
+        self.assertEqual(arrays["arg1"]["loaded_bytes"], K * N * 4)
+        self.assertEqual(arrays["arg1"]["stored_bytes"], 0)
+        self.assertEqual(arrays["cache0"]["stored_bytes"], K * N * 4)
+        self.assertEqual(arrays["cache0"]["loaded_bytes"], M * N * K * 4)
+        self.assertAlmostEqual(arrays["arg1"]["accesses_per_byte"], 1.0)
+        self.assertIn("KB per call", entry["summary"])
+
+        with self.assertRaises(ValueError):
+            package.build(test_name, format=Package.Format.HAT_DYNAMIC, output_dir=output_dir, update=True,
+                          benchmark=BenchmarkOptions(memory_traffic=True))
+
+    def test_python_module(self) -> None:
+        import importlib
+        import sys
+
+        M, N, K = 32, 32, 32
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        nest = Nest(shape=[M, N, K])
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        test_name = "test_python_module"
+        package = Package()
+        function = package.add(nest, args=(A, B, C), base_name=test_name)
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        package.build(test_name, format=Package.Format.HAT_DYNAMIC, output_dir=output_dir, python_module=True)
+        self.assertTrue((output_dir / f"{test_name}_py.cpp").exists())
+
+        sys.path.insert(0, str(output_dir))
+        try:
+            module = importlib.import_module(f"{test_name}_py")
+        finally:
+            sys.path.remove(str(output_dir))
+
+        A_test = np.random.random(A.shape).astype(np.float32)
+        B_test = np.random.random(B.shape).astype(np.float32)
+        C_test = np.random.random(C.shape).astype(np.float32)
+        C_ref = C_test + A_test @ B_test
+        getattr(module, function.name)(A_test, B_test, C_test)
+        np.testing.assert_allclose(C_test, C_ref, rtol=1e-5)
+
+        # the arguments are checked by their number, their sizes and whether the outputs can be written
+        with self.assertRaises(TypeError):
+            getattr(module, function.name)(A_test, B_test)
+        with self.assertRaises(ValueError):
+            getattr(module, function.name)(A_test, B_test, C_test[:16])
+        C_test.setflags(write=False)
+        with self.assertRaises(BufferError):
+            getattr(module, function.name)(A_test, B_test, C_test)
+
+        with self.assertRaises(ValueError):
+            package.build(test_name, format=Package.Format.HAT_STATIC, output_dir=output_dir, python_module=True)
+
+    def test_profile_regions(self) -> None:
+        M, N, K = 64, 64, 64
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        nest = Nest(shape=(M, N, K))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        schedule = nest.create_schedule()
+        jj, kk = schedule.tile({j: 16, k: 16})
+        schedule.reorder(j, k, i, jj, kk)
+        plan = schedule.create_plan()
+        plan.cache(B, index=i)
+        plan.profile(i)
+
+        test_name = "test_profile_regions"
+        package = Package()
+        function = package.add(plan, args=(A, B, C), base_name=test_name)
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        with verifiers.VerifyPackage(self, test_name, output_dir) as v:
+            package.build(
+                test_name,
+                format=Package.Format.HAT_DYNAMIC | Package.Format.MLIR,
+                mode=Package.Mode.RELEASE,
+                output_dir=output_dir,
+                profile=Package.Profile.ALL
+            )
+
+            # the regions of the function, the cache fill and the loop of i, each named after the function
+            checker = v.file_checker("*_LoopNestToValueFunc.mlir")
+            checker.check(f'"accv.enter_profile"() {{regionName = "{function.name}"}}')
+            checker.check('"accv.enter_profile"() {accxp.cache_copy_region = "fill", regionName = "{{.+}}_cache0_fill"}')
+            checker.check('"accv.enter_profile"() {regionName = "{{.+}}_i_0"}')
+            checker.check('"accv.exit_profile"() {regionName = "{{.+}}_i_0"}')
+            checker.run()
+
+            A_test, B_test, C_test = (np.random.random(p.shape).astype(np.float32) for p in function.args)
+            C_ref = C_test + A_test @ B_test
+            v.check_correctness(function.name, before=(A_test, B_test, C_test), after=(A_test, B_test, C_ref))
+
+        # the loops of a vectorized dimension are vector instructions, which can't hold the regions
+        plan = schedule.create_plan()
+        plan.vectorize(jj)
+        plan.profile(kk)
+        with self.assertRaises(ValueError):
+            package = Package()
+            package.add(plan, args=(A, B, C), base_name=f"{test_name}_vectorized")
+            package.build(f"{test_name}_vectorized", output_dir=output_dir / "vectorized", profile=Package.Profile.LOOPS)
+
+    def test_line_info_and_outlined_cache_copies(self) -> None:
+        import re
+        import subprocess
+
+        M, N, K = 64, 64, 64
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        nest = Nest(shape=(M, N, K))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        schedule = nest.create_schedule()
+        jj, kk = schedule.tile({j: 16, k: 16})
+        schedule.reorder(j, k, i, jj, kk)
+        plan = schedule.create_plan()
+        plan.cache(B, index=i)
+
+        test_name = "test_line_info_and_outlined_cache_copies"
+        package = Package()
+        function = package.add(plan, args=(A, B, C), base_name=test_name)
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        with verifiers.VerifyPackage(self, test_name, output_dir) as v:
+            package.build(
+                test_name,
+                format=Package.Format.HAT_DYNAMIC,
+                mode=Package.Mode.RELEASE,
+                output_dir=output_dir,
+                line_info=True,
+                outline_cache_copies=True
+            )
+
+            A_test, B_test, C_test = (np.random.random(p.shape).astype(np.float32) for p in function.args)
+            C_ref = C_test + A_test @ B_test
+            v.check_correctness(function.name, before=(A_test, B_test, C_test), after=(A_test, B_test, C_ref))
+
+        # the listing has the function that each cache fill was moved to
+        listing = (output_dir / f"{test_name}.lines.mlir").read_text()
+        fill_functions = set(re.findall(r"func private @(\w+_cache0_fill)\(", listing))
+        self.assertTrue(fill_functions)
+
+        # the library keeps the symbol of the fill, which isn't inlined into the function
+        library = next(output_dir.glob(f"*{test_name}*.so"), None)
+        if library and shutil.which("nm"):
+            symbols = subprocess.run(["nm", str(library)], capture_output=True, text=True, check=True).stdout
+            self.assertTrue(any(name in symbols for name in fill_functions))
+
+        with self.assertRaises(ValueError):
+            package.build(test_name, format=Package.Format.MLIR_DYNAMIC, output_dir=output_dir, line_info=True)
+
+    def test_tune_parameters(self) -> None:
+        from accera import SearchStrategy, tune
+
+        P0, P1 = create_parameters(2)
+        M, N, K = 32, 32, 32
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        nest = Nest(shape=[M, N, K])
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, size=P0)
+        jj = schedule.split(j, size=P1)
+        schedule.reorder(i, j, k, ii, jj)
+
+        plan = schedule.create_plan()
+
+        test_name = "test_tune_parameters"
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        for strategy in SearchStrategy:
+            result = tune(
+                plan,
+                args=(A, B, C),
+                parameter_choices={
+                    P0: [2, 4, 8, 16],
+                    P1: [2, 4, 8, 16]
+                },
+                budget=6,
+                strategy=strategy,
+                filter_func=lambda p0, p1: p0 * p1 <= 64,
+                batch_size=3,
+                iterations=2,
+                output_dir=output_dir,
+                base_name=f"{test_name}_{strategy.name.lower()}",
+                seed=0
+            )
+            self.assertEqual(len(result.trials), 6)
+            self.assertTrue(all(t.parameters[P0] * t.parameters[P1] <= 64 for t in result.trials))
+            self.assertEqual(len({tuple(t.parameters.values()) for t in result.trials}), 6)
+            self.assertIsNotNone(result.best_parameters)
+            self.assertEqual(result.best_time, min(t.time for t in result.trials if t.time is not None))
+
+    def test_tuning_database(self) -> None:
+        import json
+        from accera import TuningDatabase, tune
+
+        P0, P1 = create_parameters(2)
+        M, N, K = 32, 32, 32
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        nest = Nest(shape=[M, N, K])
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, size=P0)
+        jj = schedule.split(j, size=P1)
+        schedule.reorder(i, j, k, ii, jj)
+
+        plan = schedule.create_plan()
+
+        test_name = "test_tuning_database"
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+        database = TuningDatabase(output_dir / "tuning.jsonl")
+        parameter_choices = {P0: [2, 4, 8], P1: [2, 4, 8]}
+
+        first = tune(
+            plan,
+            args=(A, B, C),
+            parameter_choices=parameter_choices,
+            budget=4,
+            iterations=2,
+            output_dir=output_dir,
+            base_name=test_name,
+            seed=0,
+            database=database
+        )
+        self.assertEqual(len(database.records(test_name)), 4)
+        record = database.records(test_name)[0]
+        self.assertEqual(record["signature"], "input float32[32x32] FIRST_MAJOR, input float32[32x32] FIRST_MAJOR, "
+                         "input_output float32[32x32] FIRST_MAJOR")
+        self.assertEqual(set(record["parameters"]), {"P0", "P1"})
+        self.assertLessEqual(record["stats"]["min"], record["stats"]["median"])
+
+        # the warm-started search builds the candidates that weren't measured yet
+        second = tune(
+            plan,
+            args=(A, B, C),
+            parameter_choices=parameter_choices,
+            budget=4,
+            iterations=2,
+            output_dir=output_dir,
+            base_name=test_name,
+            seed=0,
+            database=database
+        )
+        first_points = {tuple(t.parameters.values()) for t in first.trials}
+        second_points = {tuple(t.parameters.values()) for t in second.trials}
+        self.assertFalse(first_points & second_points)
+        self.assertEqual(len(database.records(test_name)), 8)
+        self.assertLessEqual(second.best_time, first.best_time)
+
+        best = database.best(test_name, record["signature"], record["target"])
+        package = Package()
+        function = package.add(
+            plan, args=(A, B, C), parameters={
+                P0: 16,
+                P1: 16
+            }, base_name=test_name, tuning_database=database
+        )
+        self.assertEqual(function.auxiliary["accera"]["parameters"], best["parameters"])
+
+        # shapes that weren't tuned keep the given values
+        D = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float64, shape=(M, N))
+        self.assertEqual(database.choose_parameters(plan, (A, B, D), test_name, {P0: 16, P1: 16}), {P0: 16, P1: 16})
+
+    def test_estimate_costs(self) -> None:
+        M, N, K = 32, 32, 32
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        nest = Nest(shape=[M, N, K])
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, 8)
+        jj = schedule.split(j, 8)
+        schedule.reorder(i, j, k, ii, jj)
+
+        plan = schedule.create_plan()
+
+        test_name = "test_estimate_costs"
+        package = Package()
+        package.add(plan, args=(A, B, C), base_name=test_name)
+
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+        costs = package.estimate_costs(test_name, output_dir=output_dir)
+
+        # nothing is compiled to machine code
+        self.assertFalse(list(output_dir.glob("**/*.obj")) + list(output_dir.glob("**/*.o")))
+
+        # the public function calls the function that holds the loops
+        function = [f for f in costs["functions"] if f["loops"]][0]
+        self.assertEqual(function["ops"], 2 * M * N * K)
+        self.assertEqual(function["footprint_bytes"], (M * K + K * N + M * N) * 4)
+
+        loops = function["loops"]
+        self.assertEqual([loop["depth"] for loop in loops], [0, 1, 2, 3, 4])
+        self.assertEqual([loop["executions"] for loop in loops], [1, 4, 16, 512, 4096])
+
+        # one run of the outer loop touches everything once, one run of the j loop an 8-row panel of A and C and all of B
+        self.assertEqual(loops[0]["traffic_bytes"], function["footprint_bytes"])
+        self.assertEqual(loops[1]["footprint_bytes"], (8 * K + K * N + 8 * N) * 4)
+        self.assertEqual(loops[1]["traffic_bytes"], 4 * loops[1]["footprint_bytes"])
+
+        # the smaller blocks of the inner loops are moved more often
+        traffic = [loop["traffic_bytes"] for loop in loops]
+        self.assertEqual(traffic, sorted(traffic))
+        for loop in loops:
+            self.assertEqual(loop["ops"], 2 * M * N * K)
+            self.assertAlmostEqual(loop["arithmetic_intensity"], loop["ops"] / loop["traffic_bytes"])
+
+    def test_hat_function_costs(self) -> None:
+        import hatlib as hat
+
+        M, N, K = 32, 32, 32
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        nest = Nest(shape=[M, N, K])
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, 8)
+        schedule.reorder(i, j, k, ii)
+
+        plan = schedule.create_plan()
+        plan.cache(B, index=j)
+        plan.parallelize(indices=i, num_threads=2)
+
+        test_name = "test_hat_function_costs"
+        package = Package()
+        function = package.add(plan, args=(A, B, C), base_name=test_name)
+
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+        package.build(test_name, format=self.PACKAGE_FORMAT, output_dir=output_dir, cost_model_report=True)
+
+        hat_file = hat.HATFile.Deserialize(output_dir / f"{test_name}.hat")
+        cost = hat_file.function_map[function.name].auxiliary["accera"]["cost"]
+        self.assertEqual(cost["flops"], 2 * M * N * K)
+        self.assertGreaterEqual(cost["bytes"], (M * K + K * N + M * N) * 4)
+        self.assertGreater(cost["scratch_bytes"], 0)
+        self.assertEqual(cost["num_threads"], 2)
+
+    def test_hat_function_threading(self) -> None:
+        import hatlib as hat
+
+        M, N, K = 32, 32, 32
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        test_name = "test_hat_function_threading"
+        package = Package()
+
+        # the cache of B outside of any parallel loop is a global buffer, which is shared by concurrent calls
+        nest = Nest(shape=[M, N, K])
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        plan = nest.create_plan()
+        plan.cache(B, index=j)
+        cached = package.add(plan, args=(A, B, C), base_name=f"{test_name}_cached")
+
+        nest2 = Nest(shape=[M, N, K])
+        i2, j2, k2 = nest2.get_indices()
+
+        @nest2.iteration_logic
+        def _():
+            C[i2, j2] += A[i2, k2] * B[k2, j2]
+
+        plan2 = nest2.create_plan()
+        plan2.parallelize(indices=i2, num_threads=2)
+        parallel = package.add(plan2, args=(A, B, C), base_name=f"{test_name}_parallel")
+
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+        package.build(test_name, format=self.PACKAGE_FORMAT, output_dir=output_dir)
+
+        hat_file = hat.HATFile.Deserialize(output_dir / f"{test_name}.hat")
+        threading = hat_file.function_map[cached.name].auxiliary["accera"]["threading"]
+        self.assertFalse(threading["reentrant"])
+        self.assertFalse(threading["parallel"])
+        self.assertGreater(threading["static_bytes"], 0)
+
+        threading = hat_file.function_map[parallel.name].auxiliary["accera"]["threading"]
+        self.assertTrue(threading["reentrant"])
+        self.assertTrue(threading["parallel"])
+        self.assertEqual(threading["num_threads"], 2)
+        self.assertEqual(threading["static_bytes"], 0)
+
+    def test_dispatcher(self) -> None:
+        import hatlib as hat
+
+        M, N = 16, 16
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, N))
+        B = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        test_name = "test_dispatcher"
+        package = Package()
+
+        # each variant scales A by a different factor, so the output tells which one ran
+        def add_variant(factor):
+            nest = Nest(shape=(M, N))
+            i, j = nest.get_indices()
+
+            @nest.iteration_logic
+            def _():
+                B[i, j] = A[i, j] * factor
+
+            return package.add(nest, args=(A, B), base_name=f"{test_name}_x{int(factor)}")
+
+        small, aligned, generic = add_variant(1.), add_variant(2.), add_variant(3.)
+        dispatcher = package.add_dispatcher(
+            sizes=["batch"],
+            cases=[(small, {"batch": {"min": 1, "max": 8}}), (aligned, {"batch": {"multiple_of": 16}}), (generic, {})],
+            base_name=test_name
+        )
+
+        with self.assertRaises(ValueError):
+            package.add_dispatcher(sizes=["batch"], cases=[(small, {"batch": {"max": 8}})])
+        with self.assertRaises(ValueError):
+            package.add_dispatcher(sizes=["batch"], cases=[(small, {"batch": {"align": 8}}), (generic, {})])
+
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        with verifiers.VerifyPackage(self, test_name, output_dir) as v:
+            package.build(test_name, format=self.PACKAGE_FORMAT, mode=self.PACKAGE_MODE, output_dir=output_dir)
+
+            hat_file = hat.HATFile.Deserialize(output_dir / f"{test_name}.hat")
+            dispatch = hat_file.function_map[dispatcher.name].auxiliary["accera"]["dispatch"]
+            self.assertEqual(dispatch["sizes"], ["batch"])
+            self.assertEqual([case["function"] for case in dispatch["cases"]], [small.name, aligned.name, generic.name])
+
+            A_test = np.random.random(A.shape).astype(np.float32)
+            B_test = np.random.random(B.shape).astype(np.float32)
+            for batch, factor in [(4, 1.), (32, 2.), (12, 3.), (20, 3.)]:
+                sizes = np.array([batch], dtype=np.int64)
+                v.check_correctness(
+                    dispatcher.name, before=(sizes, A_test, B_test), after=(sizes, A_test, A_test * factor)
+                )
+
+    def test_specialized(self) -> None:
+        import hatlib as hat
+
+        N = 16
+        alpha = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(1, ))
+        beta = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(1, ))
+        X = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(N, ))
+        Y = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(N, ))
+
+        nest = Nest(shape=(N, ))
+        i = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            Y[i] = alpha[0] * X[i] + beta[0] * Y[i]
+
+        test_name = "test_specialized"
+        package = Package()
+        axpby = package.add(nest, args=(alpha, beta, X, Y), base_name=f"{test_name}_generic")
+        dispatcher = package.add_specialized(axpby, [{alpha: 1.0, beta: 0.0}, {beta: 0.0}], base_name=test_name)
+
+        with self.assertRaises(ValueError):
+            package.add_specialized(axpby, [{X: 1.0}])
+        with self.assertRaises(ValueError):
+            package.add_specialized(axpby, [{}])
+
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        with verifiers.VerifyPackage(self, test_name, output_dir) as v:
+            package.build(test_name, format=self.PACKAGE_FORMAT, mode=self.PACKAGE_MODE, output_dir=output_dir)
+
+            hat_file = hat.HATFile.Deserialize(output_dir / f"{test_name}.hat")
+            specializations = hat_file.function_map[dispatcher.name].auxiliary["accera"]["specializations"]
+            self.assertEqual([s["arguments"] for s in specializations], [{"0": 1.0, "1": 0.0}, {"1": 0.0}])
+
+            X_test = np.random.random(X.shape).astype(np.float32)
+            # Y holds NaNs, which the specializations for beta = 0 don't read
+            Y_test = np.full(Y.shape, np.nan, dtype=np.float32)
+            for a, b in [(1., 0.), (2., 0.)]:
+                args = (np.array([a], dtype=np.float32), np.array([b], dtype=np.float32), X_test)
+                v.check_correctness(dispatcher.name, before=args + (Y_test, ), after=args + (a * X_test, ))
+
+            Y_test = np.random.random(Y.shape).astype(np.float32)
+            args = (np.array([2.], dtype=np.float32), np.array([3.], dtype=np.float32), X_test)
+            v.check_correctness(dispatcher.name, before=args + (Y_test, ), after=args + (2. * X_test + 3. * Y_test, ))
+
+    def test_runtime_sized(self) -> None:
+        import hatlib as hat
+
+        S, N = 32, 16    # the largest sequence length, the feature size
+        W = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(N, ))
+
+        test_name = "test_runtime_sized"
+        package = Package()
+
+        def add_tile(tile_size):
+            A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(tile_size, N))
+            B = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(tile_size, N))
+            nest = Nest(shape=(tile_size, N))
+            i, j = nest.get_indices()
+
+            @nest.iteration_logic
+            def _():
+                B[i, j] = A[i, j] * W[j]
+
+            return package.add(nest, args=(A, W, B), base_name=f"{test_name}_tile{tile_size}")
 
-        # Create a package and add our grid of functions to it
-        package = Package()
+        tiles = [add_tile(8), add_tile(1)]
+        function = package.add_runtime_sized(tiles, runtime_dims=[0, None, 0], max_size=S, base_name=test_name)
 
-        package.add(
-            plan,
-            args=(A, B, C),
-            parameters={
-                P0: 16,
-                P1: 16,
-                P2: 16,
-                P3: 4,
-                P4: 2,
-                P5: (j, k, i, ii)
-            },
-            base_name="alternative_matmul_16_16_16"
-        )
+        with self.assertRaises(ValueError):
+            package.add_runtime_sized(tiles[::-1], runtime_dims=[0, None, 0], max_size=S)
+        with self.assertRaises(ValueError):
+            package.add_runtime_sized(tiles, runtime_dims=[1, None, 1], max_size=S)
 
-        # Build the HAT package
-        package.build("hello_matmul_parameter_grid", output_dir=TEST_PACKAGE_DIR)
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
 
-        # Check that the package dir exists
-        self.assertTrue(os.path.isdir(TEST_PACKAGE_DIR))
+        with verifiers.VerifyPackage(self, test_name, output_dir) as v:
+            package.build(test_name, format=self.PACKAGE_FORMAT, mode=self.PACKAGE_MODE, output_dir=output_dir)
+
+            hat_file = hat.HATFile.Deserialize(output_dir / f"{test_name}.hat")
+            runtime_size = hat_file.function_map[function.name].auxiliary["accera"]["runtime_size"]
+            self.assertEqual([tile["size"] for tile in runtime_size["tiles"]], [8, 1])
+
+            # the rows past the runtime size are left as they are
+            A_test = np.random.random((S, N)).astype(np.float32)
+            W_test = np.random.random((N, )).astype(np.float32)
+            for size in [0, 5, 16, 27, S]:
+                B_test = np.random.random((S, N)).astype(np.float32)
+                B_ref = B_test.copy()
+                B_ref[:size] = A_test[:size] * W_test
+                sizes = np.array([size], dtype=np.int64)
+                v.check_correctness(
+                    function.name, before=(sizes, A_test, W_test, B_test), after=(sizes, A_test, W_test, B_ref)
+                )
 
     def _verify_matrix_multiplication_function(
         self,
@@ -2235,6 +3856,66 @@ class SmokeTest(unittest.TestCase):
 
                 v.check_correctness(function.name, before=before, after=after)
 
+    def test_opencl_gpu_vec_add(self) -> None:
+        from accera import Array, Nest, Package, ScalarType, Target
+
+        N = 2**16
+        block_x = 256
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(N, ))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(N, ))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(N, ))
+
+        nest = Nest(shape=(N, ))
+        i = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i] = A[i] + B[i]
+
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, block_x)
+        schedule.reorder(i, ii)
+
+        target = Target(Target.Model.ARM_MALI_G78)
+        plan = schedule.create_plan(target)
+        plan.bind(mapping={
+            i: target.GridUnit.BLOCK_X,
+            ii: target.GridUnit.THREAD_X,
+        })
+
+        test_name = "test_opencl_gpu_vec_add"
+        package = Package()
+        function = package.add(plan, args=(A, B, C), base_name=test_name)
+
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        with verifiers.VerifyPackage(self, test_name, output_dir, file_list=[f"{test_name}.cl",
+                                                                             f"{test_name}.hat"]) as v:
+            package.build(
+                name=test_name,
+                format=Package.Format.CUDA | Package.Format.HAT_PACKAGE,
+                mode=Package.Mode.RELEASE,
+                output_dir=output_dir
+            )
+
+            # The OpenCL C program only holds the kernel, which uses the work-item functions
+            checker = v.file_checker(f"{test_name}.cl")
+            checker.check_label(f"// {function.name}__gpu__<<<dim3({N // block_x}, 1, 1), dim3({block_x}, 1, 1)>>>")
+            checker.check(f"// Enqueued with a global work size of ({N}, 1, 1) and a local work size of ({block_x}, 1, 1)")
+            checker.check(f"__kernel  __attribute__((reqd_work_group_size({block_x}, 1, 1))) void {function.name}__gpu__(__global float *")
+            checker.check("get_group_id(0)")
+            checker.check("get_local_id(0)")
+            checker.check_not("__global__")
+            checker.check_not("extern \"C\"")
+            checker.run()
+
+            checker = v.file_checker(f"{test_name}.hat")
+            checker.check('runtime = "OPENCL"')
+            checker.check(f'provider = "{test_name}.cl"')
+            checker.run()
+
     def _add_cuda_copy_kernel(self, package, N, block_x, block_y, target, basename="cuda_copy_kernel"):
         from accera import Array, Nest, ScalarType
         from accera._lang_python._lang import _MemorySpace
@@ -2333,6 +4014,67 @@ class SmokeTest(unittest.TestCase):
 
                     v.check_correctness(function.name, before=(Input_test, Output_test), after=(Input_ref, Output_ref))
 
+    def test_cuda_gpu_graph(self) -> None:
+        from accera import Array, Nest, Package, ScalarType, Target
+
+        N = 1024
+        target = Target(Target.Model.NVIDIA_V100)
+        test_name = "test_cuda_gpu_graph"
+        package = Package()
+        copy1 = self._add_cuda_copy_kernel(package, N, 16, 16, target, test_name)
+        copy2 = self._add_cuda_copy_kernel(package, N, 32, 32, target, test_name)
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(N, N))
+        B = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(N, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(N, N))
+
+        # both launches are captured into the graph of the function
+        def pipeline():
+            copy1(A, B)
+            copy2(B, C)
+
+        function = package.add(pipeline, args=(A, B, C), base_name=test_name, function_opts={"gpu_graph": True})
+
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        with verifiers.VerifyPackage(self, test_name, output_dir, file_list=[f"{test_name}.cu",
+                                                                             f"{test_name}.hat"]) as v:
+            package.build(
+                name=test_name,
+                format=Package.Format.CUDA | Package.Format.HAT_PACKAGE,
+                mode=Package.Mode.RELEASE,
+                output_dir=output_dir
+            )
+
+            checker = v.file_checker(f"{test_name}.cu")
+            checker.check_label(f"void {function.name}(")
+            checker.check("static accera_graph<3> accera_graph_state;")
+            checker.check("if (!accera_replay_graph(accera_graph_state, accera_graph_args))")
+            checker.check("accera_graph_stream = accera_begin_graph_capture(accera_graph_state, accera_graph_args);")
+            checker.check(f"{copy1.name}__gpu__<<<dim3(64, 64, 1), dim3(16, 16, 1), 0, accera_graph_stream>>>(")
+            checker.check(f"{copy2.name}__gpu__<<<dim3(32, 32, 1), dim3(32, 32, 1), 0, accera_graph_stream>>>(")
+            checker.check("} while (!accera_end_graph_capture(accera_graph_state));")
+            checker.run()
+
+            if CUDA_AVAILABLE:
+                A_test, B_test, C_test = (np.random.uniform(-1, 1, p.shape).astype(np.float32) for p in function.args)
+                v.check_correctness(function.name, before=(A_test, B_test, C_test), after=(A_test, A_test, A_test))
+
+        # the launches of the functions of other runtimes can't be captured
+        nest = Nest(shape=(N, N))
+        i, j = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            B[i, j] = A[i, j]
+
+        vulkan_target = Target(category=Target.Category.GPU, runtime=Target.Runtime.VULKAN)
+        plan = nest.create_plan(target=vulkan_target)
+        plan.bind(mapping={i: vulkan_target.GridUnit.BLOCK_X, j: vulkan_target.GridUnit.THREAD_X})
+        with self.assertRaises(ValueError):
+            Package().add(plan, args=(A, B), base_name=test_name, function_opts={"gpu_graph": True})
+
     def _add_rocm_copy_kernel(self, package, N, block_x, block_y, target, basename="rocm_copy_kernel"):
         from accera import Array, Nest, ScalarType
         from accera._lang_python._lang import _MemorySpace
@@ -2340,22 +4082,241 @@ class SmokeTest(unittest.TestCase):
         In = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(N, N))
         Out = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(N, N))
 
-        nest = Nest(shape=(N, N))
-        i, j = nest.get_indices()
+        nest = Nest(shape=(N, N))
+        i, j = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            Out[i, j] = In[i, j]
+
+        schedule = nest.create_schedule()
+
+        ii, jj = schedule.tile({
+            i: block_x,
+            j: block_y
+        })
+
+        schedule.reorder(i, j, ii, jj)
+
+        plan = schedule.create_plan(target=target)
+        plan.bind(
+            mapping={
+                i: target.GridUnit.BLOCK_X,
+                j: target.GridUnit.BLOCK_Y,
+                ii: target.GridUnit.THREAD_X,
+                jj: target.GridUnit.THREAD_Y
+            }
+        )
+        plan.cache(In, index=ii, location=_MemorySpace.SHARED, layout=Array.Layout.LAST_MAJOR)
+        function = package.add(plan, args=(In, Out), base_name=f"{basename}_{N}_{block_x}_{block_y}")
+        return function
+
+    def test_rocm_module_output(self) -> None:
+        from accera import Package, Target
+
+        # Define our vector sizes
+        N = 32
+        block_x = 16
+        block_y = block_x
+
+        target = Target(Target.Model.AMD_MI100)
+        test_name = "test_rocm_module_output"
+        package = Package()
+        function = self._add_rocm_copy_kernel(package, N, block_x, block_y, target, test_name)
+
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        with verifiers.VerifyPackage(self, test_name, output_dir, file_list=[f"{test_name}.cu",
+                                                                             f"{test_name}.hat"]) as v:
+            package.build(
+                name=test_name,
+                format=Package.Format.MLIR | Package.Format.CUDA | Package.Format.HAT_PACKAGE,
+                mode=Package.Mode.RELEASE,    # Package.Mode.DEBUG,
+                output_dir=output_dir
+            )
+
+            if ROCM_AVAILABLE:
+                from accera import accc
+                if accc.find_hipcc():
+                    self.assertTrue((output_dir / f"{test_name}.hsaco").is_file())
+
+                before = [np.random.rand(*p.shape).astype(np.float32) for p in function.args]
+                after = [before[0], before[0]]
+
+                v.check_correctness(function.name, before=before, after=after)
+
+    def test_gpu_stream_launcher(self) -> None:
+        from accera import Package, Target
+
+        N = 32
+        block_x = 16
+        block_y = block_x
+
+        target = Target(Target.Model.AMD_MI100)
+        test_name = "test_gpu_stream_launcher"
+        package = Package()
+        function = self._add_rocm_copy_kernel(package, N, block_x, block_y, target, test_name)
+
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        with verifiers.VerifyPackage(self, test_name, output_dir, file_list=[f"{test_name}.cu",
+                                                                             f"{test_name}.hat"]) as v:
+            package.build(
+                name=test_name,
+                format=Package.Format.CUDA | Package.Format.HAT_PACKAGE,
+                mode=Package.Mode.RELEASE,
+                output_dir=output_dir
+            )
+
+            checker = v.file_checker(f"{test_name}.cu")
+            checker.check_label(f'extern "C" __host__ void {function.name}_stream(')
+            checker.check("void* stream) {")
+            checker.check(f"{function.name}__gpu__<<<dim3(")
+            checker.check(", 0, static_cast<accera_stream_t>(stream)>>>(")
+            checker.run()
+
+            checker = v.file_checker(f"{test_name}.hat")
+            checker.check(f"{function.name}_stream(")
+            checker.check("void*);")
+            checker.run()
+
+    def test_gpu_device_partitions(self) -> None:
+        from accera import Array, Nest, Package, ScalarType, Target
+
+        N = 64
+        target = Target(Target.Model.AMD_MI100)
+        test_name = "test_gpu_device_partitions"
+
+        In = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(N, N))
+        Out = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(N, N))
+
+        nest = Nest(shape=(N, N))
+        i, j = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            Out[i, j] = In[i, j]
+
+        schedule = nest.create_schedule()
+        ii = schedule.split(i, N // 2)
+        iii = schedule.split(ii, 16)
+        jj = schedule.split(j, 16)
+        schedule.reorder(i, ii, j, iii, jj)
+
+        # each half of the rows is copied by its own device
+        plan = schedule.create_plan(target=target)
+        plan.bind(
+            mapping={
+                i: target.GridUnit.DEVICE,
+                ii: target.GridUnit.BLOCK_X,
+                j: target.GridUnit.BLOCK_Y,
+                iii: target.GridUnit.THREAD_X,
+                jj: target.GridUnit.THREAD_Y
+            }
+        )
+        package = Package()
+        function = package.add(plan, args=(In, Out), base_name=test_name)
+
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+
+        with verifiers.VerifyPackage(self, test_name, output_dir, file_list=[f"{test_name}.cu",
+                                                                             f"{test_name}.hat"]) as v:
+            package.build(
+                name=test_name,
+                format=Package.Format.CUDA | Package.Format.HAT_PACKAGE,
+                mode=Package.Mode.RELEASE,
+                output_dir=output_dir
+            )
+
+            checker = v.file_checker(f"{test_name}.cu")
+            checker.check_label("__constant__ int accera_device_partition;")
+            checker.check(f"{function.name}__gpu__(")
+            checker.check("= accera_device_partition;")
+            checker.check("const int accera_device = accera_get_device();")
+            checker.check("for (int accera_partition = 0; accera_partition < 2; ++accera_partition)")
+            checker.check("accera_set_device_partition(accera_partition);")
+            checker.check(f"{function.name}__gpu__<<<dim3(2, 4, 1), dim3(16, 16, 1)>>>(")
+            checker.check("accera_finish_device_partitions(2, accera_device);")
+            checker.run()
+
+            # a stream belongs to a single device
+            with open(output_dir / f"{test_name}.cu") as f:
+                self.assertNotIn(f"{function.name}_stream(", f.read())
+
+        # binding to devices is only supported by the CUDA and ROCm runtimes
+        plan = schedule.create_plan(target=Target(category=Target.Category.GPU, runtime=Target.Runtime.VULKAN))
+        with self.assertRaises(ValueError):
+            plan.bind(mapping={i: target.GridUnit.DEVICE})
+
+    def test_gpu_persistent_kernel(self) -> None:
+        from accera import Array, Nest, Package, ScalarType, Target
+
+        N = 256
+        target = Target(Target.Model.NVIDIA_V100)
+        test_name = "test_gpu_persistent_kernel"
+
+        In = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(N, N))
+        Out = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(N, N))
+
+        nest = Nest(shape=(N, N))
+        i, j = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            Out[i, j] = In[i, j]
+
+        schedule = nest.create_schedule()
+        ii, jj = schedule.tile({
+            i: 16,
+            j: 16
+        })
+        schedule.reorder(i, j, ii, jj)
+
+        # the 16x16 grid is run by 2 blocks
+        plan = schedule.create_plan(target=target)
+        plan.bind(
+            mapping={
+                i: target.GridUnit.BLOCK_X,
+                j: target.GridUnit.BLOCK_Y,
+                ii: target.GridUnit.THREAD_X,
+                jj: target.GridUnit.THREAD_Y
+            },
+            persistent=2
+        )
+        package = Package()
+        function = package.add(plan, args=(In, Out), base_name=test_name)
+
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
 
-        @nest.iteration_logic
-        def _():
-            Out[i, j] = In[i, j]
+        with verifiers.VerifyPackage(self, test_name, output_dir, file_list=[f"{test_name}.cu",
+                                                                             f"{test_name}.hat"]) as v:
+            package.build(
+                name=test_name,
+                format=Package.Format.CUDA | Package.Format.HAT_PACKAGE,
+                mode=Package.Mode.RELEASE,
+                output_dir=output_dir
+            )
 
-        schedule = nest.create_schedule()
+            checker = v.file_checker(f"{test_name}.cu")
+            checker.check_label(f"__device__ unsigned int {function.name}__gpu___persistent_counters[2];")
+            checker.check(f"{function.name}__gpu__(")
+            checker.check("accera_block < 256u;")
+            checker.check("accera_block_idx.x")
+            checker.check(f"accera_finish_persistent_block({function.name}__gpu___persistent_counters);")
+            checker.check(f"{function.name}__gpu__<<<dim3(2, 1, 1), dim3(16, 16, 1)>>>(")
+            checker.run()
 
-        ii, jj = schedule.tile({
-            i: block_x,
-            j: block_y
-        })
+            if CUDA_AVAILABLE:
+                Input_test, Output_test = (np.random.uniform(-1, 1, p.shape).astype(np.float32) for p in function.args)
+                Input_ref = Output_ref = Input_test
 
-        schedule.reorder(i, j, ii, jj)
+                v.check_correctness(function.name, before=(Input_test, Output_test), after=(Input_ref, Output_ref))
 
+        # a grid that fits in the resident blocks of the target is launched as it is
         plan = schedule.create_plan(target=target)
         plan.bind(
             mapping={
@@ -2363,24 +4324,58 @@ class SmokeTest(unittest.TestCase):
                 j: target.GridUnit.BLOCK_Y,
                 ii: target.GridUnit.THREAD_X,
                 jj: target.GridUnit.THREAD_Y
-            }
+            },
+            persistent=True
         )
-        plan.cache(In, index=ii, location=_MemorySpace.SHARED, layout=Array.Layout.LAST_MAJOR)
-        function = package.add(plan, args=(In, Out), base_name=f"{basename}_{N}_{block_x}_{block_y}")
-        return function
-
-    def test_rocm_module_output(self) -> None:
-        from accera import Package, Target
+        package = Package()
+        function = package.add(plan, args=(In, Out), base_name=f"{test_name}_resident")
+        test_name = f"{test_name}_resident"
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+        package.build(name=test_name, format=Package.Format.CUDA, mode=Package.Mode.RELEASE, output_dir=output_dir)
+        with open(output_dir / f"{test_name}.cu") as f:
+            self.assertNotIn("_persistent_counters", f.read())
+
+        # persistent kernels are only supported by the CUDA and ROCm runtimes
+        plan = schedule.create_plan(target=Target(category=Target.Category.GPU, runtime=Target.Runtime.VULKAN))
+        with self.assertRaises(ValueError):
+            plan.bind(mapping={i: target.GridUnit.BLOCK_X}, persistent=True)
+        plan = schedule.create_plan(target=target)
+        with self.assertRaises(ValueError):
+            plan.bind(mapping={i: target.GridUnit.BLOCK_X}, persistent=0)
 
-        # Define our vector sizes
-        N = 32
-        block_x = 16
-        block_y = block_x
+    def test_gpu_packed_16bit_vectorization(self) -> None:
+        from accera import Array, Nest, Package, ScalarType, Target
 
-        target = Target(Target.Model.AMD_MI100)
-        test_name = "test_rocm_module_output"
+        N = 1024
+        target = Target(Target.Model.NVIDIA_V100)
+        test_name = "test_gpu_packed_16bit_vectorization"
         package = Package()
-        function = self._add_rocm_copy_kernel(package, N, block_x, block_y, target, test_name)
+
+        for element_type, suffix in [(ScalarType.float16, "fp16"), (ScalarType.int16, "int16")]:
+            A = Array(role=Array.Role.INPUT, element_type=element_type, shape=(N, ))
+            B = Array(role=Array.Role.INPUT, element_type=element_type, shape=(N, ))
+            C = Array(role=Array.Role.INPUT_OUTPUT, element_type=element_type, shape=(N, ))
+
+            nest = Nest(shape=(N, ))
+            i = nest.get_indices()
+
+            @nest.iteration_logic
+            def _():
+                C[i] = A[i] + B[i]
+
+            schedule = nest.create_schedule()
+            ii = schedule.split(i, 256)
+            iii = schedule.split(ii, 2)
+
+            # each thread adds a pair of elements
+            plan = schedule.create_plan(target=target)
+            plan.bind(mapping={
+                i: target.GridUnit.BLOCK_X,
+                ii: target.GridUnit.THREAD_X
+            })
+            plan.vectorize(iii)
+            package.add(plan, args=(A, B, C), base_name=f"{test_name}_{suffix}")
 
         output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
         shutil.rmtree(output_dir, ignore_errors=True)
@@ -2389,16 +4384,21 @@ class SmokeTest(unittest.TestCase):
                                                                              f"{test_name}.hat"]) as v:
             package.build(
                 name=test_name,
-                format=Package.Format.MLIR | Package.Format.CUDA | Package.Format.HAT_PACKAGE,
-                mode=Package.Mode.RELEASE,    # Package.Mode.DEBUG,
+                format=Package.Format.CUDA | Package.Format.HAT_PACKAGE,
+                mode=Package.Mode.RELEASE,
                 output_dir=output_dir
             )
 
-            if ROCM_AVAILABLE:
-                before = [np.random.rand(*p.shape).astype(np.float32) for p in function.args]
-                after = [before[0], before[0]]
-
-                v.check_correctness(function.name, before=before, after=after)
+            # the pairs are added with the packed operators of vhalfx2_t and vint16_tx2_t
+            checker = v.file_checker(f"{test_name}.cu")
+            checker.check("ACCERA_PACKED_VECTOR_BINARY_OPERATOR(vhalf, __half2, +, __hadd2)")
+            checker.check_label(f"{test_name}_fp16")
+            checker.check("vhalfx2_t")
+            checker.check(" + ")
+            checker.check_label(f"{test_name}_int16")
+            checker.check("vint16_tx2_t")
+            checker.check(" + ")
+            checker.run()
 
     def test_rocm_multiple_funcs(self) -> None:
         from accera import Package, Target
@@ -2433,7 +4433,15 @@ class SmokeTest(unittest.TestCase):
 
                     v.check_correctness(function.name, before=(Input_test, Output_test), after=(Input_ref, Output_ref))
 
-    def _rocm_tensorize(self, M, N, K, outer_tile_x, outer_tile_y, mfma_tile, tolerance=1e-5, intype=ScalarType.float32, outtype=ScalarType.float32, verify=True) -> None:
+    def _rocm_tensorize(self, *args, **kwargs) -> None:
+        from accera import Target
+        self._gpu_tensorize(Target.Model.AMD_MI100, "test_rocm_tensorize", ROCM_AVAILABLE, *args, **kwargs)
+
+    def _cuda_tensorize(self, *args, **kwargs) -> None:
+        from accera import Target
+        self._gpu_tensorize(Target.Model.NVIDIA_A100, "test_cuda_tensorize", CUDA_AVAILABLE, *args, **kwargs)
+
+    def _gpu_tensorize(self, model, test_prefix, runtime_available, M, N, K, outer_tile_x, outer_tile_y, mfma_tile, tolerance=1e-5, intype=ScalarType.float32, outtype=ScalarType.float32, verify=True) -> None:
         from accera import Target
         A = Array(role=Array.Role.INPUT, element_type=intype, shape=(M, K))
         B = Array(role=Array.Role.INPUT, element_type=intype, shape=(K, N))
@@ -2461,7 +4469,7 @@ class SmokeTest(unittest.TestCase):
 
         schedule.reorder((i, j, ii, jj, k, iii, jjj, kk))
 
-        target = Target(Target.Model.AMD_MI100)
+        target = Target(model)
         plan = schedule.create_plan(target=target)
         plan.bind(
             mapping={
@@ -2476,10 +4484,10 @@ class SmokeTest(unittest.TestCase):
         package = Package()
         num_blocks = M * N / outer_tile_x / outer_tile_y
         num_warps = outer_tile_x * outer_tile_y / mfma_tile[2] / mfma_tile[2]
-        test_name = "test_rocm_tensorize"
+        test_name = test_prefix
         test_name += "_single_block" if num_blocks == 1 else "_multi_block"
         test_name += "_single_warp_output" if num_warps == 1 else "_multi_warp_output"
-        test_name += "_fp32" if intype == ScalarType.float32 else "_fp16"
+        test_name += {ScalarType.float32: "_fp32", ScalarType.bfloat16: "_bf16"}.get(intype, "_fp16")
         test_name += "_fp32_t" if outtype == ScalarType.float32 else "_fp16_t"
         test_name += str(mfma_tile[2]) + "_w"
         test_name += str(mfma_tile[1])
@@ -2489,7 +4497,7 @@ class SmokeTest(unittest.TestCase):
             function,
             package,
             test_name,
-            check_correctness=ROCM_AVAILABLE and verify,
+            check_correctness=runtime_available and verify,
             tolerance=tolerance,
             file_list=[f"{test_name}.cu", f"{test_name}.hat"],
             package_format=Package.Format.CUDA | Package.Format.HAT_PACKAGE
@@ -2552,109 +4560,419 @@ class SmokeTest(unittest.TestCase):
     def test_rocm_tensorize_multi_block_multi_warp_output_fp16_fp32_t64_w32(self) -> None:
         self._rocm_tensorize(2048, 2048, 2048, 128, 64, (2, 32, 64), 1e-3, ScalarType.float16)
 
-    def test_rocm_tensorize_multi_block_multi_warp_output_fp16_fp32_t64_w16(self) -> None:
-        self._rocm_tensorize(2048, 2048, 2048, 128, 128, (4, 16, 64), 1e-3, ScalarType.float16)
+    def test_rocm_tensorize_multi_block_multi_warp_output_fp16_fp32_t64_w16(self) -> None:
+        self._rocm_tensorize(2048, 2048, 2048, 128, 128, (4, 16, 64), 1e-3, ScalarType.float16)
+
+    def test_rocm_tensorize_single_block_single_warp_output_fp16_fp16_t16_w2(self) -> None:
+        self._rocm_tensorize(16, 16, 16, 16, 16, (2, 2, 16), 1e-3, ScalarType.float16, ScalarType.float16)
+
+    def test_rocm_tensorize_single_block_single_warp_output_fp16_fp16_t32_w4(self) -> None:
+        self._rocm_tensorize(32, 32, 32, 32, 32, (4, 4, 32), 1e-3, ScalarType.float16, ScalarType.float16)
+
+    def test_rocm_tensorize_single_block_single_warp_output_fp16_fp16_t64_w32(self) -> None:
+        self._rocm_tensorize(64, 64, 64, 64, 64, (2, 32, 64), 1e-3, ScalarType.float16, ScalarType.float16)
+
+    def test_rocm_tensorize_single_block_single_warp_output_fp16_fp16_t64_w16(self) -> None:
+        self._rocm_tensorize(64, 64, 64, 64, 64, (4, 16, 64), 1e-3, ScalarType.float16, ScalarType.float16)
+
+    # TODO: This requires tolerance to be set higher than the other tests (verify discrepancies)
+    def test_rocm_tensorize_single_block_multi_warp_output_fp16_fp16_t16_w2(self) -> None:
+        self._rocm_tensorize(64, 64, 64, 64, 64, (2, 2, 16), 1e-2, ScalarType.float16, ScalarType.float16)
+
+    def test_rocm_tensorize_single_block_multi_warp_output_fp16_fp16_t32_w4(self) -> None:
+        self._rocm_tensorize(64, 64, 64, 64, 64, (4, 4, 32), 1e-3, ScalarType.float16, ScalarType.float16)
+
+    def test_rocm_tensorize_multi_block_multi_warp_output_fp16_fp16_t16_w2(self) -> None:
+        self._rocm_tensorize(1024, 1024, 1024, 64, 64, (2, 2, 16), 1e-2, ScalarType.float16, ScalarType.float16)
+
+    def test_rocm_tensorize_multi_block_multi_warp_output_fp16_fp16_t32_w4(self) -> None:
+        self._rocm_tensorize(2048, 2048, 2048, 128, 128, (4, 4, 32), 1e-2, ScalarType.float16, ScalarType.float16)
+
+    def test_rocm_tensorize_multi_block_multi_warp_output_fp16_fp16_t64_w32(self) -> None:
+        self._rocm_tensorize(2048, 2048, 2048, 128, 64, (2, 32, 64), 1e-2, ScalarType.float16, ScalarType.float16)
+
+    def test_rocm_tensorize_multi_block_multi_warp_output_fp16_fp16_t64_w16(self) -> None:
+        self._rocm_tensorize(2048, 2048, 2048, 128, 128, (4, 16, 64), 1e-2, ScalarType.float16, ScalarType.float16)
+
+    @expectedFailure(FailedReason.INVALID, "the hardware does not support the requested tensorcore shape")
+    def test_rocm_tensorize_invalid_shape_output(self) -> None:
+        self._rocm_tensorize(256, 256, 256, 64, 64, (64, 64, 64),
+                             "test_rocm_tensorize_invalid_shape_output", False)
+
+    def test_cuda_tensorize_single_block_single_warp_output_fp16_fp32_t16_w2(self) -> None:
+        self._cuda_tensorize(16, 16, 16, 16, 16, (2, 2, 16), 1e-2, ScalarType.float16, ScalarType.float32)
+
+    def test_cuda_tensorize_multi_block_multi_warp_output_fp16_fp32_t16_w2(self) -> None:
+        self._cuda_tensorize(1024, 1024, 1024, 64, 64, (2, 2, 16), 1e-2, ScalarType.float16, ScalarType.float32)
+
+    def test_cuda_tensorize_multi_block_multi_warp_output_fp16_fp16_t16_w2(self) -> None:
+        self._cuda_tensorize(1024, 1024, 1024, 64, 64, (2, 2, 16), 1e-2, ScalarType.float16, ScalarType.float16)
+
+    def test_cuda_tensorize_multi_block_multi_warp_output_bf16_fp32_t16_w2(self) -> None:
+        self._cuda_tensorize(1024, 1024, 1024, 64, 64, (2, 2, 16), 1e-2, ScalarType.bfloat16, ScalarType.float32)
+
+    @expectedFailure(FailedReason.INVALID, "the hardware does not support the requested tensorcore shape")
+    def test_cuda_tensorize_invalid_shape_output(self) -> None:
+        self._cuda_tensorize(256, 256, 256, 64, 64, (4, 4, 32), 1e-2, ScalarType.float16, ScalarType.float32)
+
+    def _gpu_cache(self, M, N, K, m_tile_size, n_tile_size, k_tile_size, test_name, dBuffer=False, dBufferLoacation = Constants.AUTO, model=None, file_check_fn=None) -> None:
+        from accera import Array, Nest, Package, ScalarType, Target
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32,
+                  shape=(M, K), layout=Array.Layout.FIRST_MAJOR)
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32,
+                  shape=(K, N), layout=Array.Layout.FIRST_MAJOR)
+        C = Array(
+            role=Array.Role.INPUT_OUTPUT,
+            element_type=ScalarType.float32,
+            shape=(M, N),
+            layout=Array.Layout.FIRST_MAJOR
+        )
+
+        nest = Nest(shape=(M, N, K))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        schedule = nest.create_schedule()
+
+        ii, jj, kk = schedule.tile({
+            i: m_tile_size,
+            j: n_tile_size,
+            k: k_tile_size
+        })
+        schedule.reorder(i, j, k, ii, jj, kk)
+
+        target = Target(model or Target.Model.AMD_MI100)
+        plan = schedule.create_plan(target=target)
+        plan.bind(
+            mapping={
+                i: target.GridUnit.BLOCK_X,
+                j: target.GridUnit.BLOCK_Y,
+                ii: target.GridUnit.THREAD_X,
+                jj: target.GridUnit.THREAD_Y
+            }
+        )
+
+        plan.cache(A, index=ii, double_buffer=dBuffer,
+                   location=_MemorySpace.SHARED, double_buffer_location=dBufferLoacation, layout=Array.Layout.FIRST_MAJOR)
+        plan.cache(B, index=ii, double_buffer=dBuffer,
+                   location=_MemorySpace.SHARED, double_buffer_location=dBufferLoacation, layout=Array.Layout.FIRST_MAJOR)
+
+        package = Package()
+        function = package.add(plan, args=(A, B, C), base_name=test_name)
+
+        self._verify_matrix_multiplication_function(
+            function,
+            package,
+            test_name,
+            file_check_fn=file_check_fn,
+            check_correctness=CUDA_AVAILABLE if target.runtime == Target.Runtime.CUDA else ROCM_AVAILABLE,
+            file_list=[f"{test_name}.cu", f"{test_name}.hat"],
+            package_format=Package.Format.CUDA | Package.Format.HAT_PACKAGE
+        )
+
+    def test_gpu_cache_simple(self) -> None:
+        self._gpu_cache(1024, 1024, 1024, 16, 16, 32, "test_gpu_cache_simple")
+
+    def test_gpu_cache_double_buffering(self) -> None:
+        self._gpu_cache(2560, 1536, 2048, 16, 16, 32,
+                        "test_gpu_cache_double_buffering", True)
+
+    def test_gpu_resource_report(self) -> None:
+        import json
+        from accera import Array, Nest, Package, ScalarType, Target
+
+        M, N, K = 256, 256, 256
+        test_name = "test_gpu_resource_report"
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        nest = Nest(shape=(M, N, K))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        schedule = nest.create_schedule()
+        ii, jj, kk = schedule.tile({i: 16, j: 16, k: 32})
+        schedule.reorder(i, j, k, ii, jj, kk)
+
+        target = Target(Target.Model.NVIDIA_A100)
+        plan = schedule.create_plan(target=target)
+        plan.bind(mapping={
+            i: target.GridUnit.BLOCK_X,
+            j: target.GridUnit.BLOCK_Y,
+            ii: target.GridUnit.THREAD_X,
+            jj: target.GridUnit.THREAD_Y
+        })
+        plan.cache(A, index=ii, location=_MemorySpace.SHARED)
+        plan.cache(B, index=ii, location=_MemorySpace.SHARED)
+
+        package = Package()
+        package.add(plan, args=(A, B, C), base_name=test_name)
+
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+        package.build(
+            name=test_name,
+            format=Package.Format.CUDA | Package.Format.HAT_PACKAGE,
+            output_dir=output_dir,
+            gpu_resource_report=True
+        )
+
+        with open(output_dir / f"{test_name}.gpu_resources.json") as report_file:
+            report = json.load(report_file)
+        self.assertEqual(len(report["kernels"]), 1)
+        kernel = report["kernels"][0]
+        self.assertEqual(kernel["block_size"], [16, 16, 1])
+        self.assertEqual(kernel["grid_size"], [16, 16, 1])
+        # the 16x32 tile of A and the 32x16 tile of B
+        self.assertGreaterEqual(kernel["shared_memory_bytes"], 2 * 16 * 32 * 4)
+        compiled = kernel.get("compiled_resources", {})
+        self.assertEqual(
+            kernel["estimated_occupancy"],
+            target.estimate_occupancy(
+                256, max(kernel["shared_memory_bytes"], compiled.get("shared_memory_bytes", 0)),
+                compiled.get("registers", kernel["private_registers"])
+            )
+        )
+
+        # ptxas reports what it allocated when the CUDA toolkit is installed
+        if compiled:
+            self.assertEqual(compiled["compiler"], "ptxas")
+            self.assertGreater(compiled["registers"], 0)
+            self.assertGreaterEqual(compiled["shared_memory_bytes"], 2 * 16 * 32 * 4)
+            self.assertIn("spills", compiled)
+
+        # 8 blocks of 256 threads fill the 2048 threads of a multiprocessor until shared memory runs out
+        self.assertEqual(target.estimate_occupancy(256), 1.0)
+        self.assertEqual(target.estimate_occupancy(256, shared_memory_per_block=16384), 0.375)
+        self.assertEqual(target.estimate_occupancy(2048), 0.0)
+
+    def test_gpu_register_cache(self) -> None:
+        import json
+        from accera import Target
+
+        M, N, K = 256, 256, 256
+        test_name = "test_gpu_register_cache"
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
+
+        nest = Nest(shape=(M, N, K))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        # each of the 16x16 threads of a block computes a 4x4 fragment of C
+        schedule = nest.create_schedule()
+        ii, jj = schedule.tile({i: 64, j: 64})
+        iii, jjj = schedule.tile({ii: 4, jj: 4})
+        schedule.reorder(i, j, ii, jj, k, iii, jjj)
+
+        target = Target(Target.Model.NVIDIA_A100)
+        plan = schedule.create_plan(target=target)
+        plan.bind(mapping={
+            i: target.GridUnit.BLOCK_X,
+            j: target.GridUnit.BLOCK_Y,
+            ii: target.GridUnit.THREAD_X,
+            jj: target.GridUnit.THREAD_Y
+        })
+        AA = plan.cache(A, level=Target.CacheLevel.REGISTERS)
+        BB = plan.cache(B, level=Target.CacheLevel.REGISTERS)
+        CC = plan.cache(C, level=Target.CacheLevel.REGISTERS)
+
+        with self.assertRaises(ValueError):
+            plan.cache(A, level=Target.CacheLevel.REGISTERS, location=_MemorySpace.SHARED)
+
+        package = Package()
+        function = package.add(plan, args=(A, B, C), base_name=test_name)
+
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+        with verifiers.VerifyPackage(self, test_name, output_dir, file_list=[f"{test_name}.cu",
+                                                                             f"{test_name}.hat"]) as v:
+            package.build(
+                name=test_name,
+                format=Package.Format.CUDA | Package.Format.HAT_PACKAGE,
+                output_dir=output_dir,
+                gpu_resource_report=True
+            )
+
+            # the 255 registers of each of the 256 threads, less 32 for the rest of the kernel, are shared by the 3 caches
+            for cache in [AA, BB, CC]:
+                self.assertEqual(cache.max_elements, (255 - 32) * 4 // (4 * 3))
+
+            # the fragment of C is live across the loop over k, those of A and B are reloaded for each k
+            with open(output_dir / f"{test_name}.gpu_resources.json") as report_file:
+                kernel = json.load(report_file)["kernels"][0]
+            register_caches = kernel["register_caches"]
+            self.assertEqual([cache["placement"] for cache in register_caches], ["registers"] * 3)
+            self.assertEqual(sorted(cache["elements"] for cache in register_caches), [4, 4, 16])
+            self.assertEqual(kernel["private_memory_bytes"], (4 + 4 + 16) * 4)
+
+            if CUDA_AVAILABLE:
+                before = [np.random.rand(*p.shape).astype(np.float32) for p in function.args]
+                after = [before[0], before[1], before[2] + before[0] @ before[1]]
+                v.check_correctness(function.name, before=before, after=after)
+
+    def test_gpu_shared_memory_cache_level(self) -> None:
+        import json
+        from accera import Target
 
-    def test_rocm_tensorize_single_block_single_warp_output_fp16_fp16_t16_w2(self) -> None:
-        self._rocm_tensorize(16, 16, 16, 16, 16, (2, 2, 16), 1e-3, ScalarType.float16, ScalarType.float16)
+        M, N, K = 256, 256, 256
+        test_name = "test_gpu_shared_memory_cache_level"
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K))
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N))
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
 
-    def test_rocm_tensorize_single_block_single_warp_output_fp16_fp16_t32_w4(self) -> None:
-        self._rocm_tensorize(32, 32, 32, 32, 32, (4, 4, 32), 1e-3, ScalarType.float16, ScalarType.float16)
+        nest = Nest(shape=(M, N, K))
+        i, j, k = nest.get_indices()
 
-    def test_rocm_tensorize_single_block_single_warp_output_fp16_fp16_t64_w32(self) -> None:
-        self._rocm_tensorize(64, 64, 64, 64, 64, (2, 32, 64), 1e-3, ScalarType.float16, ScalarType.float16)
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
 
-    def test_rocm_tensorize_single_block_single_warp_output_fp16_fp16_t64_w16(self) -> None:
-        self._rocm_tensorize(64, 64, 64, 64, 64, (4, 16, 64), 1e-3, ScalarType.float16, ScalarType.float16)
+        # each of the 16x16 threads of a block computes a 4x4 fragment of C, 32 elements of k at a time
+        schedule = nest.create_schedule()
+        ii, jj, kk = schedule.tile({i: 64, j: 64, k: 32})
+        iii, jjj = schedule.tile({ii: 4, jj: 4})
+        schedule.reorder(i, j, k, ii, jj, kk, iii, jjj)
 
-    # TODO: This requires tolerance to be set higher than the other tests (verify discrepancies)
-    def test_rocm_tensorize_single_block_multi_warp_output_fp16_fp16_t16_w2(self) -> None:
-        self._rocm_tensorize(64, 64, 64, 64, 64, (2, 2, 16), 1e-2, ScalarType.float16, ScalarType.float16)
+        target = Target(Target.Model.NVIDIA_A100)
+        mapping = {
+            i: target.GridUnit.BLOCK_X,
+            j: target.GridUnit.BLOCK_Y,
+            ii: target.GridUnit.THREAD_X,
+            jj: target.GridUnit.THREAD_Y
+        }
 
-    def test_rocm_tensorize_single_block_multi_warp_output_fp16_fp16_t32_w4(self) -> None:
-        self._rocm_tensorize(64, 64, 64, 64, 64, (4, 4, 32), 1e-3, ScalarType.float16, ScalarType.float16)
+        plan = schedule.create_plan(target=target)
+        plan.bind(mapping=mapping)
+        AA = plan.cache(A, level=Target.CacheLevel.SHARED)
+        BB = plan.cache(B, level=Target.CacheLevel.SHARED)
+
+        # with half of the 64 warps of a multiprocessor active, 4 blocks of 8 warps share its shared memory, and
+        # the cache of A with a fixed budget leaves the rest to the cache of B
+        occupancy_plan = schedule.create_plan(target=target)
+        occupancy_plan.bind(mapping=mapping, occupancy=0.5)
+        occupancy_plan.cache(A, max_elements=2048, location=_MemorySpace.SHARED)
+        occupancy_BB = occupancy_plan.cache(B, level=Target.CacheLevel.SHARED)
+
+        with self.assertRaises(ValueError):
+            plan.cache(A, level=Target.CacheLevel.SHARED, location=_MemorySpace.PRIVATE)
+        with self.assertRaises(ValueError):
+            schedule.create_plan().cache(A, level=Target.CacheLevel.SHARED)
+        with self.assertRaises(ValueError):
+            schedule.create_plan(target=target).bind(mapping=mapping, occupancy=1.5)
 
-    def test_rocm_tensorize_multi_block_multi_warp_output_fp16_fp16_t16_w2(self) -> None:
-        self._rocm_tensorize(1024, 1024, 1024, 64, 64, (2, 2, 16), 1e-2, ScalarType.float16, ScalarType.float16)
+        package = Package()
+        function = package.add(plan, args=(A, B, C), base_name=test_name)
+        package.add(occupancy_plan, args=(A, B, C), base_name=f"{test_name}_occupancy")
 
-    def test_rocm_tensorize_multi_block_multi_warp_output_fp16_fp16_t32_w4(self) -> None:
-        self._rocm_tensorize(2048, 2048, 2048, 128, 128, (4, 4, 32), 1e-2, ScalarType.float16, ScalarType.float16)
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+        with verifiers.VerifyPackage(self, test_name, output_dir, file_list=[f"{test_name}.cu",
+                                                                             f"{test_name}.hat"]) as v:
+            package.build(
+                name=test_name,
+                format=Package.Format.CUDA | Package.Format.HAT_PACKAGE,
+                output_dir=output_dir,
+                gpu_resource_report=True
+            )
 
-    def test_rocm_tensorize_multi_block_multi_warp_output_fp16_fp16_t64_w32(self) -> None:
-        self._rocm_tensorize(2048, 2048, 2048, 128, 64, (2, 32, 64), 1e-2, ScalarType.float16, ScalarType.float16)
+            # the 48KB of shared memory of a block are shared by the 2 caches
+            self.assertEqual(AA.max_elements, 49152 // (4 * 2))
+            self.assertEqual(BB.max_elements, 49152 // (4 * 2))
+            self.assertEqual(occupancy_BB.max_elements, (49152 // 4 - 2048 * 4) // 4)
 
-    def test_rocm_tensorize_multi_block_multi_warp_output_fp16_fp16_t64_w16(self) -> None:
-        self._rocm_tensorize(2048, 2048, 2048, 128, 128, (4, 16, 64), 1e-2, ScalarType.float16, ScalarType.float16)
+            # the 64x32 active blocks of A and B in the loop over k fit, the 64x256 ones of the whole block don't
+            with open(output_dir / f"{test_name}.gpu_resources.json") as report_file:
+                kernels = json.load(report_file)["kernels"]
+            kernel = next(kernel for kernel in kernels if kernel["name"].startswith(f"{function.name}_"))
+            self.assertEqual(kernel["shared_memory_bytes"], (64 * 32 + 32 * 64) * 4)
 
-    @expectedFailure(FailedReason.INVALID, "the hardware does not support the requested tensorcore shape")
-    def test_rocm_tensorize_invalid_shape_output(self) -> None:
-        self._rocm_tensorize(256, 256, 256, 64, 64, (64, 64, 64),
-                             "test_rocm_tensorize_invalid_shape_output", False)
+            if CUDA_AVAILABLE:
+                before = [np.random.rand(*p.shape).astype(np.float32) for p in function.args]
+                after = [before[0], before[1], before[2] + before[0] @ before[1]]
+                v.check_correctness(function.name, before=before, after=after)
 
-    def _gpu_cache(self, M, N, K, m_tile_size, n_tile_size, k_tile_size, test_name, dBuffer=False, dBufferLoacation = Constants.AUTO) -> None:
-        from accera import Array, Nest, Package, ScalarType, Target
+    def test_gpu_uncoalesced_access_report(self) -> None:
+        import json
+        from accera import Target
 
-        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32,
-                  shape=(M, K), layout=Array.Layout.FIRST_MAJOR)
-        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32,
-                  shape=(K, N), layout=Array.Layout.FIRST_MAJOR)
-        C = Array(
-            role=Array.Role.INPUT_OUTPUT,
-            element_type=ScalarType.float32,
-            shape=(M, N),
-            layout=Array.Layout.FIRST_MAJOR
-        )
+        M, N = 256, 256
+        test_name = "test_gpu_uncoalesced_access_report"
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, N))
+        B = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N))
 
-        nest = Nest(shape=(M, N, K))
-        i, j, k = nest.get_indices()
+        nest = Nest(shape=(M, N))
+        i, j = nest.get_indices()
 
         @nest.iteration_logic
         def _():
-            C[i, j] += A[i, k] * B[k, j]
+            B[i, j] += A[i, j]
 
+        # thread x runs along the rows, so consecutive threads are a row of N elements apart
         schedule = nest.create_schedule()
+        ii, jj = schedule.tile({i: 16, j: 16})
+        schedule.reorder(i, j, ii, jj)
 
-        ii, jj, kk = schedule.tile({
-            i: m_tile_size,
-            j: n_tile_size,
-            k: k_tile_size
+        target = Target(Target.Model.NVIDIA_A100)
+        plan = schedule.create_plan(target=target)
+        plan.bind(mapping={
+            i: target.GridUnit.BLOCK_X,
+            j: target.GridUnit.BLOCK_Y,
+            ii: target.GridUnit.THREAD_X,
+            jj: target.GridUnit.THREAD_Y
         })
-        schedule.reorder(i, j, k, ii, jj, kk)
 
-        target = Target(Target.Model.AMD_MI100)
-        plan = schedule.create_plan(target=target)
-        plan.bind(
-            mapping={
-                i: target.GridUnit.BLOCK_X,
-                j: target.GridUnit.BLOCK_Y,
-                ii: target.GridUnit.THREAD_X,
-                jj: target.GridUnit.THREAD_Y
-            }
-        )
+        package = Package()
+        package.add(plan, args=(A, B), base_name=test_name)
 
-        plan.cache(A, index=ii, double_buffer=dBuffer,
-                   location=_MemorySpace.SHARED, double_buffer_location=dBufferLoacation, layout=Array.Layout.FIRST_MAJOR)
-        plan.cache(B, index=ii, double_buffer=dBuffer,
-                   location=_MemorySpace.SHARED, double_buffer_location=dBufferLoacation, layout=Array.Layout.FIRST_MAJOR)
+        output_dir = pathlib.Path(TEST_PACKAGE_DIR) / test_name
+        shutil.rmtree(output_dir, ignore_errors=True)
+        with self.assertLogs(level="WARNING") as logs:
+            package.build(
+                name=test_name,
+                format=Package.Format.CUDA | Package.Format.HAT_PACKAGE,
+                output_dir=output_dir,
+                gpu_resource_report=True
+            )
 
-        package = Package()
-        function = package.add(plan, args=(A, B, C), base_name=test_name)
+        with open(output_dir / f"{test_name}.gpu_resources.json") as report_file:
+            kernel = json.load(report_file)["kernels"][0]
+        accesses = {(access["array"], access["access"]): access for access in kernel["uncoalesced_accesses"]}
+        self.assertEqual(set(accesses.keys()), {("arg0", "load"), ("arg1", "load"), ("arg1", "store")})
+        for access in accesses.values():
+            self.assertEqual(access["thread_dim"], "x")
+            self.assertEqual(access["stride"], N)
+        self.assertTrue(any("uncoalesced" in message for message in logs.output))
 
-        self._verify_matrix_multiplication_function(
-            function,
-            package,
-            test_name,
-            check_correctness=ROCM_AVAILABLE,
-            file_list=[f"{test_name}.cu", f"{test_name}.hat"],
-            package_format=Package.Format.CUDA | Package.Format.HAT_PACKAGE
-        )
+    def test_cuda_cache_double_buffering_async_copy(self) -> None:
+        from accera import Target
+        test_name = "test_cuda_cache_double_buffering_async_copy"
 
-    def test_gpu_cache_simple(self) -> None:
-        self._gpu_cache(1024, 1024, 1024, 16, 16, 32, "test_gpu_cache_simple")
+        def file_check_fn(v):
+            # The temp buffers in shared memory are filled with asynchronous copies, which are waited for
+            # right before they are moved into the caches
+            checker = v.file_checker(f"{test_name}.cu")
+            checker.check_label("__global__")
+            checker.check("async_copy(")
+            checker.check("async_copy_commit()")
+            checker.check("async_copy_wait<0>()")
+            checker.check("__syncthreads()")
+            checker.run()
 
-    def test_gpu_cache_double_buffering(self) -> None:
-        self._gpu_cache(2560, 1536, 2048, 16, 16, 32,
-                        "test_gpu_cache_double_buffering", True)
+        self._gpu_cache(2560, 1536, 2048, 16, 16, 32, test_name, True, _MemorySpace.SHARED,
+                        model=Target.Model.NVIDIA_A100, file_check_fn=file_check_fn)
 
     def test_gpu_cache_double_buffering_trigger_index(self) -> None:
         from accera import Array, Nest, Package, ScalarType, Target
@@ -2743,6 +5061,147 @@ class SmokeTest(unittest.TestCase):
         self._gpu_cache(2560, 1536, 2048, 16, 16, 32,
                         "test_gpu_cache_double_buffering_mem_space", True, _MemorySpace.PRIVATE)
 
+    def test_cuda_split_k(self) -> None:
+        from accera import Array, Nest, Package, ScalarType, Target
+
+        # A small output with a long reduction only covers a few blocks unless the reduction index is split
+        # across the grid
+        M = 64
+        N = 64
+        K = 16384
+        block_x = 16
+        block_y = block_x
+        k_split_size = 1024
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K), layout=Array.Layout.FIRST_MAJOR)
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N), layout=Array.Layout.FIRST_MAJOR)
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N), layout=Array.Layout.FIRST_MAJOR)
+
+        nest = Nest(shape=(M, N, K))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        schedule = nest.create_schedule()
+
+        ii, jj, kk = schedule.tile({
+            i: block_x,
+            j: block_y,
+            k: k_split_size
+        })
+        schedule.reorder(i, j, k, ii, jj, kk)
+
+        target = Target(Target.Model.NVIDIA_A100)
+        plan = schedule.create_plan(target=target)
+        plan.bind(
+            mapping={
+                i: target.GridUnit.BLOCK_X,
+                j: target.GridUnit.BLOCK_Y,
+                k: target.GridUnit.BLOCK_Z,
+                ii: target.GridUnit.THREAD_X,
+                jj: target.GridUnit.THREAD_Y
+            },
+            reduction={k: C}
+        )
+
+        test_name = "test_cuda_split_k"
+        package = Package()
+        function = package.add(plan, args=(A, B, C), base_name=test_name)
+
+        def file_check_fn(v):
+            # The private partial sums of each thread are added to the output atomically
+            checker = v.file_checker(f"{test_name}.cu")
+            checker.check_label("__global__")
+            checker.check("atomicAdd(")
+            checker.run()
+
+        self._verify_matrix_multiplication_function(
+            function,
+            package,
+            test_name,
+            file_check_fn=file_check_fn,
+            check_correctness=CUDA_AVAILABLE,
+            tolerance=1e-3,
+            file_list=[f"{test_name}.cu", f"{test_name}.hat"],
+            package_format=Package.Format.CUDA | Package.Format.HAT_PACKAGE
+        )
+
+    def test_cuda_stream_k(self) -> None:
+        from accera import Array, Nest, Package, ScalarType, Target
+
+        # The 13x13 tiles split 8 ways along the reduction index make 1352 blocks, which don't fill a whole number of
+        # waves of 108 blocks
+        M = 208
+        N = 208
+        K = 4096
+        block_x = 16
+        block_y = block_x
+        k_split_size = 512
+
+        A = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(M, K), layout=Array.Layout.FIRST_MAJOR)
+        B = Array(role=Array.Role.INPUT, element_type=ScalarType.float32, shape=(K, N), layout=Array.Layout.FIRST_MAJOR)
+        C = Array(role=Array.Role.INPUT_OUTPUT, element_type=ScalarType.float32, shape=(M, N), layout=Array.Layout.FIRST_MAJOR)
+
+        nest = Nest(shape=(M, N, K))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        schedule = nest.create_schedule()
+
+        ii, jj, kk = schedule.tile({
+            i: block_x,
+            j: block_y,
+            k: k_split_size
+        })
+        schedule.reorder(i, j, k, ii, jj, kk)
+
+        target = Target(Target.Model.NVIDIA_A100)
+        mapping = {
+            i: target.GridUnit.BLOCK_X,
+            j: target.GridUnit.BLOCK_Y,
+            k: target.GridUnit.BLOCK_Z,
+            ii: target.GridUnit.THREAD_X,
+            jj: target.GridUnit.THREAD_Y
+        }
+        plan = schedule.create_plan(target=target)
+        plan.bind(mapping=mapping, reduction={k: C}, persistent=108, stream_k=True)
+
+        test_name = "test_cuda_stream_k"
+        package = Package()
+        function = package.add(plan, args=(A, B, C), base_name=test_name)
+
+        def file_check_fn(v):
+            # Each block runs 12 or 13 consecutive blocks of the grid, the 8 splits of a tile being consecutive, and
+            # the tiles shared by two blocks are fixed up by the atomic accumulation
+            checker = v.file_checker(f"{test_name}.cu")
+            checker.check_label(f"{function.name}__gpu__(")
+            checker.check("* 1352ull / 108ull")
+            checker.check("make_uint3(accera_block / 8u % 13u, accera_block / 104u, accera_block % 8u)")
+            checker.check("atomicAdd(")
+            checker.check(f"{function.name}__gpu__<<<dim3(108, 1, 1), dim3(16, 16, 1)>>>(")
+            checker.run()
+
+        self._verify_matrix_multiplication_function(
+            function,
+            package,
+            test_name,
+            file_check_fn=file_check_fn,
+            check_correctness=CUDA_AVAILABLE,
+            tolerance=1e-3,
+            file_list=[f"{test_name}.cu", f"{test_name}.hat"],
+            package_format=Package.Format.CUDA | Package.Format.HAT_PACKAGE
+        )
+
+        # Stream-K needs a reduction index bound to a block dimension
+        plan = schedule.create_plan(target=target)
+        with self.assertRaises(ValueError):
+            plan.bind(mapping=mapping, stream_k=True)
+
     def test_cpu_cache_double_buffering_trigger_index(self) -> None:
         from accera import Array, Nest, Package, ScalarType
 
@@ -3048,6 +5507,57 @@ class SmokeTest(unittest.TestCase):
             function, package, f"test_thrifty_caching_simple_output_cache_elide", run_file_check
         )
 
+    def test_thrifty_caching_long_rows_elide(self) -> None:
+        import accera as acc
+
+        package = Package()
+
+        M = 32
+        N = 256
+        K = 32
+
+        A = acc.Array(role=acc.Array.Role.INPUT, shape=(M, K), layout=acc.Array.Layout.FIRST_MAJOR)
+        B = acc.Array(role=acc.Array.Role.INPUT, shape=(K, N), layout=acc.Array.Layout.FIRST_MAJOR)
+        C = acc.Array(role=acc.Array.Role.INPUT_OUTPUT, shape=(M, N), layout=acc.Array.Layout.FIRST_MAJOR)
+
+        nest = acc.Nest(shape=(M, N, K))
+        i, j, k = nest.get_indices()
+
+        @nest.iteration_logic
+        def _():
+            C[i, j] += A[i, k] * B[k, j]
+
+        schedule = nest.create_schedule()
+
+        ii = schedule.split(i, 4)
+        jj = schedule.split(j, 128)
+        kk = schedule.split(k, 8)
+
+        order = [i, j, k, ii, jj, kk]
+        schedule.reorder(order)
+
+        plan = schedule.create_plan()
+
+        # This cache should get elided because at ii the active block has the shape 4x128, whose rows of 512 bytes
+        # are contiguous in the 32x256 base array C, so the cache would only remove the gaps between the rows
+        CC = plan.cache(C, index=ii, thrifty=True, layout=acc.Array.Layout.FIRST_MAJOR)
+
+        def run_file_check(verifier):
+            checker = verifier.file_checker(f"*_LoopNestToValueFunc.mlir")
+
+            checker.check_label('"accv.lambda"() ( {')
+            checker.check_not(
+                '%{{[0-9]}} = "accv.ref_global"() {global_name = @cache_{{[0-9]}}} : () -> memref<4x128xf32, 3>'
+            )
+            checker.check("affine.for %arg{{[0-9]}} = 0 to 32 step 4 {")
+            checker.run()
+
+        function = package.add(plan, args=(A, B, C), base_name=f"test_thrifty_caching_long_rows_elide")
+
+        self._verify_matrix_multiplication_function(
+            function, package, f"test_thrifty_caching_long_rows_elide", run_file_check
+        )
+
     # Note: The following thrifty cache tests are commented out as they increase the runtime of the smoke_test by too much
     # TODO : move these to a new exhaustive test suite that isn't run as part of the buddy build
 
@@ -5,6 +5,7 @@
 
 #include "AcceraTypes.h"
 
+#include <value/include/ArrayOperations.h>
 #include <value/include/FastMath.h>
 #include <value/include/ScalarOperations.h>
 
@@ -34,12 +35,17 @@ namespace
             .value("uint64", value::ValueType::Uint64, "8 byte unsigned integer")
             .value("index", value::ValueType::Index, "index type")
             .value("float16", value::ValueType::Float16, "2 byte floating point")
+            .value("bfloat16", value::ValueType::BFloat16, "2 byte brain floating point")
             .value("float32", value::ValueType::Float, "4 byte floating point")
             .value("float64", value::ValueType::Double, "8 byte floating point");
 
         py::enum_<value::AllocateFlags>(subModule, "AllocateFlags", "An enumeration of allocation flags")
             .value("NONE", value::AllocateFlags::None)
             .value("THREAD_LOCAL", value::AllocateFlags::ThreadLocal);
+
+        py::enum_<value::FastMathAccuracy>(module, "FastMathAccuracy", "An enumeration of the accuracy levels of the fast math functions")
+            .value("LOW", value::FastMathAccuracy::Low, "lower degree approximations, accurate to about 1e-4")
+            .value("HIGH", value::FastMathAccuracy::High, "approximations accurate to within a few float32 ulps");
     }
 
     void DefineContainerStructs(py::module& module, py::module& /*subModule*/)
@@ -130,8 +136,14 @@ Args:
         module.def("floor", &value::Floor);
         module.def("sqrt", &value::Sqrt);
         module.def("exp", &value::Exp);
-        module.def("fast_exp", &value::FastExp);
+        module.def("fast_exp", py::overload_cast<value::Scalar>(&value::FastExp));
         module.def("fast_exp_mlas", &value::FastExpMlas);
+        module.def("fast_log", &value::FastLog, "s"_a, "accuracy"_a = value::FastMathAccuracy::High);
+        module.def("fast_tanh", &value::FastTanh, "s"_a, "accuracy"_a = value::FastMathAccuracy::High);
+        module.def("fast_sigmoid", &value::FastSigmoid, "s"_a, "accuracy"_a = value::FastMathAccuracy::High);
+        module.def("fast_erf", &value::FastErf, "s"_a, "accuracy"_a = value::FastMathAccuracy::High);
+        module.def("fast_gelu", &value::FastGelu, "s"_a, "accuracy"_a = value::FastMathAccuracy::High);
+        module.def("_table_lookup", &value::TableLookup, "table"_a, "index"_a);
         module.def("log", &value::Log);
         module.def("log10", &value::Log10);
         module.def("log2", &value::Log2);
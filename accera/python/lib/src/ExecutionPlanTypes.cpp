@@ -33,7 +33,8 @@ namespace
 
         py::enum_<value::CacheAllocation>(module, "_CacheAllocation", "An enumeration of cache allocation types")
             .value("AUTO", value::CacheAllocation::Automatic)
-            .value("NONE", value::CacheAllocation::None);
+            .value("NONE", value::CacheAllocation::None)
+            .value("THREAD_LOCAL", value::CacheAllocation::ThreadLocal);
 
         py::enum_<value::MemorySpace>(module, "_MemorySpace", "An enumeration of memory space types")
             .value("NONE", value::MemorySpace::None)
@@ -49,11 +50,32 @@ namespace
             .value("THREAD_Y", ir::value::Processor::ThreadY)
             .value("THREAD_Z", ir::value::Processor::ThreadZ)
             .value("SEQUENTIAL", ir::value::Processor::Sequential)
+            .value("DEVICE", ir::value::Processor::Device)
             .export_values();
 
         py::enum_<value::ParallelizationPolicy>(module, "_ParallelizationPolicy", "Used for configuring the thread scheduling policy")
             .value("STATIC", value::ParallelizationPolicy::Static)
-            .value("DYNAMIC", value::ParallelizationPolicy::Dynamic);
+            .value("DYNAMIC", value::ParallelizationPolicy::Dynamic)
+            .value("WORK_STEALING", value::ParallelizationPolicy::WorkStealing)
+            .value("GUIDED", value::ParallelizationPolicy::Guided);
+
+        py::enum_<value::ParallelizationPinning>(module, "_ParallelizationPinning", "Used for configuring the placement of the threads")
+            .value("DEFAULT", value::ParallelizationPinning::Default)
+            .value("CLOSE", value::ParallelizationPinning::Close)
+            .value("SPREAD", value::ParallelizationPinning::Spread)
+            .value("PRIMARY", value::ParallelizationPinning::Primary);
+
+        py::enum_<ir::executionPlan::IntegerDotProductKind>(module, "_IntegerDotProduct", "Used for specifying the integer dot-product instructions of the target")
+            .value("NONE", ir::executionPlan::IntegerDotProductKind::None)
+            .value("X86_VNNI", ir::executionPlan::IntegerDotProductKind::X86VNNI)
+            .value("ARM_DOT_PRODUCT", ir::executionPlan::IntegerDotProductKind::ARMDotProduct)
+            .value("ARM_DSP", ir::executionPlan::IntegerDotProductKind::ARMDSP);
+
+        py::enum_<ir::executionPlan::TableLookupKind>(module, "_TableLookup", "Used for specifying the table lookup instructions of the target")
+            .value("NONE", ir::executionPlan::TableLookupKind::None)
+            .value("X86_VBMI", ir::executionPlan::TableLookupKind::X86VBMI)
+            .value("X86_SHUFFLE", ir::executionPlan::TableLookupKind::X86Shuffle)
+            .value("ARM_TABLE", ir::executionPlan::TableLookupKind::ARMTable);
 
         py::enum_<value::ExecutionRuntime>(module, "_ExecutionRuntime", "Used for specifying the execution runtime of the module")
             .value("DEFAULT", value::ExecutionRuntime::DEFAULT)
@@ -61,6 +83,8 @@ namespace
             .value("ROCM", value::ExecutionRuntime::ROCM)
             .value("CUDA", value::ExecutionRuntime::CUDA)
             .value("OPENMP", value::ExecutionRuntime::OPENMP)
+            .value("THREAD_POOL", value::ExecutionRuntime::THREAD_POOL)
+            .value("OPENCL", value::ExecutionRuntime::OPENCL)
             .value("NONE", value::ExecutionRuntime::NONE);
 
         py::enum_<value::GPU::BarrierScope>(module, "BarrierScope", "An enumeration of barrier scopes")
@@ -72,10 +96,14 @@ namespace
     void DefineExecutionPlanStructs(py::module& module)
     {
         py::class_<value::VectorizationInformation>(module, "_VectorizationInfo", "Used for configuring loop vectorization")
-            .def(py::init<int, int, bool>(), "vector_bytes"_a = 0, "vector_units"_a = 0, "unroll_only"_a = false)
+            .def(py::init<int, int, bool, bool, ir::executionPlan::IntegerDotProductKind, bool, ir::executionPlan::TableLookupKind>(), "vector_bytes"_a = 0, "vector_units"_a = 0, "unroll_only"_a = false, "masked"_a = false, "dot_product"_a = ir::executionPlan::IntegerDotProductKind::None, "bfloat16_dot_product"_a = false, "table_lookup"_a = ir::executionPlan::TableLookupKind::None)
             .def_readwrite("vector_bytes", &value::VectorizationInformation::vectorBytes)
             .def_readwrite("vector_units", &value::VectorizationInformation::vectorUnitCount)
-            .def_readwrite("unroll_only", &value::VectorizationInformation::unrollOnly);
+            .def_readwrite("unroll_only", &value::VectorizationInformation::unrollOnly)
+            .def_readwrite("masked", &value::VectorizationInformation::masked)
+            .def_readwrite("dot_product", &value::VectorizationInformation::dotProduct)
+            .def_readwrite("bfloat16_dot_product", &value::VectorizationInformation::bfloat16DotProduct)
+            .def_readwrite("table_lookup", &value::VectorizationInformation::tableLookup);
 
         py::class_<value::targets::Dim3>(module, "_Dim3", "Used for configuring the x, y, and z indices for a GPU processor")
             .def(py::init<int, int, int>(), "x"_a = 0, "y"_a = 0, "z"_a = 0)
@@ -97,7 +125,18 @@ namespace
 
     void DefineExecutionPlanClasses(py::module& module)
     {
-        py::class_<value::Cache>(module, "_Cache");
+        py::class_<value::Cache>(module, "_Cache")
+            .def("set_cooperative_copy", &value::Cache::SetCooperativeCopy)
+            .def("set_prefetch_distance", &value::Cache::SetPrefetchDistance, "distance"_a)
+            .def("set_padding", &value::Cache::SetPadding, "padding"_a)
+            .def("set_automatic_padding", &value::Cache::SetAutomaticPadding)
+            .def("set_panel_layout", &value::Cache::SetPanelLayout, "dimension"_a, "panel_size"_a)
+            .def("set_nontemporal_write_back", &value::Cache::SetNonTemporalWriteBack)
+            .def("set_register_cache", &value::Cache::SetRegisterCache)
+            .def("set_element_type", &value::Cache::SetElementType, "element_type"_a)
+            .def("add_epilogue_bias", &value::Cache::AddEpilogueBias, "bias"_a, "dimension"_a)
+            .def("add_epilogue_scale", &value::Cache::AddEpilogueScale, "scale"_a)
+            .def("add_epilogue_clamp", &value::Cache::AddEpilogueClamp, "min"_a, "max"_a);
 
         py::class_<value::Plan>(module, "_ExecutionPlan")
             .def(py::init([](value::Plan& plan) {
@@ -167,8 +206,11 @@ namespace
                 "vectorization_info"_a)
             .def("emit_runtime_init_packing", py::overload_cast<value::ViewAdapter, const std::string&, const std::string&, value::CacheIndexing>(&value::Plan::EmitRuntimeInitPacking), "target"_a, "packing_func_name"_a, "packed_buf_size_func_name"_a, "indexing"_a = value::CacheIndexing::GlobalToPhysical)
             .def("pack_and_embed_buffer", py::overload_cast<value::ViewAdapter, value::ViewAdapter, const std::string&, const std::string&, value::CacheIndexing>(&value::Plan::PackAndEmbedBuffer), "target"_a, "constant_data_buffer"_a, "wrapper_fn_name"_a, "packed_buffer_name"_a, "indexing"_a = value::CacheIndexing::GlobalToPhysical)
+            .def("pack_and_map_buffer", py::overload_cast<value::ViewAdapter, value::ViewAdapter, const std::string&, const std::string&, value::CacheIndexing>(&value::Plan::PackAndMapBuffer), "target"_a, "constant_data_buffer"_a, "wrapper_fn_name"_a, "packed_buffer_name"_a, "indexing"_a = value::CacheIndexing::GlobalToPhysical)
             .def("vectorize", &value::Plan::Vectorize, "i"_a, "vectorization_info"_a)
-            .def("parallelize", &value::Plan::Parallelize, "indices"_a, "num_threads"_a, "policy"_a);
+            .def("parallelize", &value::Plan::Parallelize, "indices"_a, "num_threads"_a, "policy"_a, "pinning"_a = value::ParallelizationPinning::Default, "processors"_a = std::vector<int64_t>{}, "first_touch"_a = false, "chunk_size"_a = 0, "reduction"_a = false, "deterministic"_a = false)
+            .def("tensorize", &value::Plan::Tensorize, "indices"_a, "dims"_a)
+            .def("profile", &value::Plan::Profile, "i"_a);
 
         py::class_<value::GPUPlan>(module, "_GPUExecutionPlan")
             .def(py::init([](value::GPUPlan& plan) {
@@ -196,6 +238,10 @@ namespace
                     {
                         return plan.AddCache(target, *outermostIncludedSplitIndex, resolvedTriggerIndex, *dimOrder, thrifty, doubleBuffer, vectorizationInfo, indexing, allocation, memorySpace, doubleBufferMemorySpace);
                     }
+                    else if (maxElements.has_value() && dimOrder.has_value())
+                    {
+                        return plan.AddCache(target, *maxElements, *dimOrder, thrifty, doubleBuffer, vectorizationInfo, indexing, allocation, memorySpace, doubleBufferMemorySpace);
+                    }
                     else if (maxElements.has_value())
                     {
                         // TODO : convert all GPUPlan::AddCache() impls to use manual caching rather than automatic, then plumb remaining arguments
@@ -221,7 +267,9 @@ namespace
                 "double_buffer_location"_a,
                 "vectorization_info"_a)
             .def("tensorize", &value::GPUPlan::Tensorize, "indices"_a, "dims"_a)
-            .def("map_index_to_processor", &value::GPUPlan::MapIndexToProcessor, "index"_a, "proc"_a);
+            .def("map_index_to_processor", &value::GPUPlan::MapIndexToProcessor, "index"_a, "proc"_a, "reduction"_a = false)
+            .def("set_persistent_blocks", &value::GPUPlan::SetPersistentBlocks, "num_blocks"_a)
+            .def("set_stream_k_dim", &value::GPUPlan::SetStreamKDim, "dim"_a);
     }
 
 } // namespace
@@ -4,6 +4,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "AcceraTypes.h"
+#include <value/include/ArrayOperations.h>
 #include <value/include/Debugging.h>
 
 namespace py = pybind11;
@@ -43,7 +44,7 @@ void DefineOperations(py::module& module)
             "layout"_a,
             "flags"_a = value::AllocateFlags::None)
         .def("ForRange", py::overload_cast<value::Scalar, value::Scalar, value::Scalar, std::function<void(value::Scalar)>>(&value::ForRange))
-        .def("ForRanges", py::overload_cast<std::vector<value::Scalar>, std::function<void(std::vector<value::Scalar>)>>(&value::ForRanges))
+        .def("ForRanges", py::overload_cast<const std::vector<value::Scalar>&, std::function<void(const std::vector<value::Scalar>&)>>(&value::ForRanges))
         .def("Print", py::overload_cast<value::ViewAdapter, bool>(&value::Print), "value"_a, "to_stderr"_a = false)
         .def("Print", py::overload_cast<const std::string&, bool>(&value::Print), "message"_a, "to_stderr"_a = false)
         .def("PrintRawMemory", &value::PrintRawMemory)
@@ -83,9 +84,21 @@ void DefineOperations(py::module& module)
             "init"_a,
             "map_fn"_a,
             "reduce_fn"_a)
-        .def("CheckAllClose", &value::CheckAllClose)
+        .def("MultiReduce", &value::MultiReduce, "data"_a, "init"_a, "reduce_fn"_a, "combine_fn"_a, "lanes"_a = 8)
+        .def("CheckAllClose", &value::CheckAllClose, "actual"_a, "desired"_a, "tolerance"_a, "num_threads"_a = 1, "vectorization_info"_a = std::nullopt)
         .def("Return", py::overload_cast<value::ViewAdapter>(&value::Return), "view"_a = value::ViewAdapter{})
-        .def("GetTime", &value::GetTime);
+        .def("GetTime", &value::GetTime)
+        .def(
+            "_GetMatMulMicrokernelShape",
+            [](int vectorBytes, int vectorRegisters, int elementBytes, int M, int N) {
+                auto shape = value::GetMatMulMicrokernelShape(vectorBytes, vectorRegisters, elementBytes, M, N);
+                return std::make_tuple(shape.rows, shape.columns, shape.vectorSize);
+            },
+            "vector_bytes"_a,
+            "vector_registers"_a,
+            "element_bytes"_a,
+            "M"_a = 0,
+            "N"_a = 0);
 
     auto getFromGPUIndex = [](value::GPUIndex idx, std::string pos) -> value::Scalar {
         if (pos == "x")
@@ -5,6 +5,8 @@
 
 #include "AcceraTypes.h"
 
+#include <transforms/include/AcceraCompiler.h>
+
 namespace py = pybind11;
 namespace value = accera::value;
 namespace util = accera::utilities;
@@ -72,6 +74,8 @@ ARM: fp16, neon, vfp3, d16, vfp4, hwdiv-arm, hwdiv
             .def_readwrite("gpu_only", &value::CompilerOptions::gpu_only, "Emit only the GPU device code and do not emit the GPU host code.")
             // .def_readwrite("modelFile", &value::CompilerOptions::modelFile) // doesn't apply to accera
             .def_readwrite("global_value_alignment", &value::CompilerOptions::globalValueAlignment, "The byte alignment to use for global values. Defaults to 32.")
+            .def_readwrite("huge_page_threshold", &value::CompilerOptions::hugePageThreshold, "The size in bytes from which static buffers are backed by huge pages, or 0 to disable. Defaults to 0.")
+            .def_readwrite("streaming_emission", &value::CompilerOptions::streamingEmission, "Release the values of a loop or kernel body once it is emitted, which bounds the memory of emitting very large nests. Defaults to False.")
             .def_readwrite("use_bare_ptr_call_conv", &value::CompilerOptions::useBarePtrCallConv, "Whether to bare pointer style declarations for defined functions.")
             .def_readwrite("emit_c_wrapper_decls", &value::CompilerOptions::emitCWrapperDecls, "Whether to emit C wrapper declarations for defined functions. Defaults to True.")
             .def_readwrite("c_wrapper_prefix", &value::CompilerOptions::cWrapperPrefix, "The function name prefix to give to C wrapper declarations. Defaults to '_mlir_ciface_'");
@@ -114,10 +118,101 @@ ARM: fp16, neon, vfp3, d16, vfp4, hwdiv-arm, hwdiv
             .def("Save", &value::MLIRContext::save, "filename"_a)
             .def("Verify", &value::MLIRContext::verify)
             .def("WriteHeader", &value::MLIRContext::writeHeader, "filename"_a = std::nullopt)
+            .def("WriteMappedBuffers", &value::MLIRContext::writeMappedBuffers, "directory"_a)
             .def("SetMetadata", &value::MLIRContext::setMetadata)
             .def("GetFullMetadata", &value::MLIRContext::getFullMetadata)
             .def("SetDataLayout", &value::MLIRContext::setDataLayout)
-            .def("EmitDebugFunction", &value::MLIRContext::EmitDebugFunction);
+            .def("EmitDebugFunction", &value::MLIRContext::EmitDebugFunction, "function_name"_a, "utility_function_names"_a, "num_threads"_a = 1, "vectorization_info"_a = std::nullopt, "sample_stride"_a = 1)
+            .def(
+                "GetEmitterStats",
+                [](const value::MLIRContext& c) {
+                    auto stats = c.GetStats();
+                    py::dict result;
+                    result["local_emittables"] = stats.localEmittables;
+                    result["peak_local_emittables"] = stats.peakLocalEmittables;
+                    result["released_local_emittables"] = stats.releasedLocalEmittables;
+                    result["reused_local_emittables"] = stats.reusedLocalEmittables;
+                    result["global_emittables"] = stats.globalEmittables;
+                    result["emittable_scopes"] = stats.emittableScopes;
+                    result["defined_functions"] = stats.definedFunctions;
+                    return result;
+                },
+                "Gets the number of objects that the module keeps alive for what it has emitted")
+            .def(
+                "CompileToObject",
+                [](const value::MLIRContext& c, const std::string& pipelineOptions, const std::string& triple, const std::string& cpu, unsigned optLevel, unsigned sizeLevel, bool fastFPContract, const std::string& objectPath, const std::string& asmPath, const std::string& passTimingPath) {
+                    // The module is lowered in place, so a copy is compiled to keep this one usable
+                    auto module = c.cloneModule();
+
+                    transforms::ObjectCompilerOptions options;
+                    options.pipelineOptions = pipelineOptions;
+                    options.triple = triple;
+                    options.cpu = cpu;
+                    options.optLevel = optLevel;
+                    options.sizeLevel = sizeLevel;
+                    options.fastFPContract = fastFPContract;
+                    options.objectPath = objectPath;
+                    options.asmPath = asmPath;
+                    options.passTimingPath = passTimingPath;
+
+                    // Each module has its own MLIR context, so modules are compiled concurrently by Python threads
+                    py::gil_scoped_release release;
+                    transforms::CompileToObject(*module, options);
+                },
+                "pipeline_options"_a,
+                "triple"_a,
+                "cpu"_a,
+                "opt_level"_a,
+                "size_level"_a,
+                "fast_fp_contract"_a,
+                "object_path"_a,
+                "asm_path"_a = "",
+                "pass_timing_path"_a = "",
+                "Lowers a copy of the module with the acc-to-llvm pipeline and compiles it to an object file in-process")
+            .def(
+                "JITCompile",
+                [](const value::MLIRContext& c, const std::string& pipelineOptions, const std::vector<const value::MLIRContext*>& supportingModules, unsigned optLevel, unsigned sizeLevel, const std::vector<std::string>& sharedLibraryPaths) {
+                    auto module = c.cloneModule();
+                    std::vector<mlir::OwningModuleRef> supportingModuleCopies;
+                    std::vector<mlir::ModuleOp> supportingModuleOps;
+                    for (auto supportingModule : supportingModules)
+                    {
+                        supportingModuleCopies.push_back(supportingModule->cloneModule());
+                        supportingModuleOps.push_back(*supportingModuleCopies.back());
+                    }
+
+                    transforms::JITCompilerOptions options;
+                    options.pipelineOptions = pipelineOptions;
+                    options.optLevel = optLevel;
+                    options.sizeLevel = sizeLevel;
+                    options.sharedLibraryPaths = sharedLibraryPaths;
+
+                    py::gil_scoped_release release;
+                    return transforms::JITCompile(*module, supportingModuleOps, options);
+                },
+                "pipeline_options"_a,
+                "supporting_modules"_a = std::vector<const value::MLIRContext*>{},
+                "opt_level"_a = 3,
+                "size_level"_a = 0,
+                "shared_library_paths"_a = std::vector<std::string>{},
+                "Lowers copies of the module and its supporting modules with the acc-to-llvm pipeline and compiles them for the host into the memory of the process");
+
+        py::class_<transforms::JITEngine, std::unique_ptr<transforms::JITEngine>>(module, "_JITEngine", "The functions of modules that were JIT-compiled for the host")
+            .def(
+                "Invoke",
+                [](const transforms::JITEngine& engine, const std::string& functionName, const std::vector<uintptr_t>& argumentAddresses) {
+                    std::vector<void*> addresses;
+                    for (auto address : argumentAddresses)
+                    {
+                        addresses.push_back(reinterpret_cast<void*>(address));
+                    }
+
+                    py::gil_scoped_release release;
+                    engine.Invoke(functionName, addresses);
+                },
+                "function_name"_a,
+                "argument_addresses"_a,
+                "Calls a function with the addresses of its arguments, e.g. the address of the pointer to the data of an array argument");
     }
 
     void DefineFunctionClass(py::module& module)
@@ -151,14 +246,28 @@ Args:
             .def("cWrapper", &value::FunctionDeclaration::CWrapper, "cWrapper"_a, py::return_value_policy::reference_internal, "Sets whether an MLIR C wrapper function should be emitted for this function")
             .def("headerDecl", &value::FunctionDeclaration::HeaderDecl, "headerDecl"_a, py::return_value_policy::reference_internal, "Sets whether the function should be part of the generated header file.")
             .def("rawPointerAPI", &value::FunctionDeclaration::RawPointerAPI, "rawPointerAPI"_a, py::return_value_policy::reference_internal, "Sets whether the function should provide a raw pointer API.")
+            .def("asyncAPI", &value::FunctionDeclaration::AsyncAPI, "asyncAPI"_a, py::return_value_policy::reference_internal, "Sets whether the function should also provide an asynchronous API that returns a completion handle.")
+            .def("nontemporalWriteBack", &value::FunctionDeclaration::NonTemporalWriteBack, "nontemporalWriteBack"_a, py::return_value_policy::reference_internal, "Sets whether the caches of the function write their data back with non-temporal stores.")
+            .def("workspaceAPI", &value::FunctionDeclaration::WorkspaceAPI, "workspaceAPI"_a, py::return_value_policy::reference_internal, "Sets whether the scratch buffers of the function are placed in a caller-provided workspace argument.")
+            .def("noAlias", &value::FunctionDeclaration::NoAlias, "noAlias"_a, py::return_value_policy::reference_internal, "Sets whether the callers of the function guarantee that its array arguments don't overlap.")
+            .def("gpuGraph", &value::FunctionDeclaration::GPUGraph, "gpuGraph"_a, py::return_value_policy::reference_internal, "Sets whether the kernels that the function launches are captured into a CUDA/HIP graph on the first call and replayed by the next calls.")
             .def(
                 "inlinable", [](value::FunctionDeclaration& fn, bool inlinable) {
                     (void)fn.Inlined(inlinable ? value::FunctionInlining::always : value::FunctionInlining::never);
                     return fn;
                 },
                 "inlinable"_a, py::return_value_policy::reference_internal, "Sets whether the function is allowed to be inlined.")
+            .def(
+                "autoInline", [](value::FunctionDeclaration& fn) {
+                    (void)fn.Inlined(value::FunctionInlining::automatic);
+                    return fn;
+                },
+                py::return_value_policy::reference_internal, "Sets the function to be inlined only where it is small or called once.")
             .def("addTag", &value::FunctionDeclaration::AddTag, "addTag"_a, py::return_value_policy::reference_internal, "A tag to add to a function as an attribute.")
             .def("baseName", &value::FunctionDeclaration::BaseName, "baseName"_a, py::return_value_policy::reference_internal, "Sets the base name for this function to use as an alias in the generated header file.")
+            .def("targetCPU", &value::FunctionDeclaration::TargetCPU, "cpu"_a, "features"_a, py::return_value_policy::reference_internal, "Sets the LLVM target CPU and target features that the code of the function is compiled for, instead of those of the module.")
+            .def("parameterAlignments", &value::FunctionDeclaration::ParameterAlignments, "alignments"_a, py::return_value_policy::reference_internal, "Sets the byte alignment that the callers of the function guarantee for each array parameter, 0 for no guarantee.")
+            .def("specializedArguments", &value::FunctionDeclaration::SpecializedArguments, "values"_a, py::return_value_policy::reference_internal, "Sets the constant value that the function is specialized for of each single-element array parameter, None for a parameter that is not specialized.")
             .def(
                 "define", [](value::FunctionDeclaration& fn, std::function<std::optional<value::Value>(std::vector<value::Value>)> defFn) -> value::FunctionDeclaration& {
                     (void)fn.Define(defFn);
@@ -3,7 +3,7 @@
 # Licensed under the MIT License. See LICENSE in the project root for license information.
 ####################################################################################################
 
-from typing import Sequence, NamedTuple
+from typing import Callable, Sequence, NamedTuple
 from accera import Target, Array, Scalar, Nest, fuse
 
 
@@ -211,10 +211,13 @@ def MLAS_with_bias(
     alpha=1.0,
     beta=1.0,
     opts=Options(),
-    target=Target.HOST
+    target=Target.HOST,
+    activation: Callable[[Scalar], Scalar] = None
 ):
 
     if opts.UseAlphaScalingFusion:
+        if activation:
+            raise RuntimeError("Activations are not supported with alpha scaling fusion")
         return MLAS_with_bias_and_alpha_scaling(A, B, C, Y, transA, transB, alpha, beta, opts)
 
     if not all(len(arr.shape) >= 2 and    # check rank
@@ -329,7 +332,19 @@ def MLAS_with_bias(
 
     compute_schedule = compute_nest.create_schedule()
 
-    fused_schedule = fuse((bias_schedule, compute_schedule), partial=len(stack) + 2)
+    schedules = [bias_schedule, compute_schedule]
+    if activation:
+        # Applied to each column block of Y once its reduction has completed, while the block is still in the caches
+        activation_nest = Nest(shape=Y.shape)
+        activation_idxs = activation_nest.get_indices()
+
+        @activation_nest.iteration_logic
+        def _():
+            Y[activation_idxs] = activation(Y[activation_idxs])
+
+        schedules.append(activation_nest.create_schedule())
+
+    fused_schedule = fuse(tuple(schedules), partial=len(stack) + 2)
 
     fused_idxs = fused_schedule.get_indices()
     f, fused_stack_idxs, fused_i, fused_j, k = fused_idxs[0], tuple(fused_idxs[1:-3]), *fused_idxs[-3:]
@@ -377,12 +392,14 @@ def MLAS(
     zero_C=False,
     bias: Array = None,
     opts=Options(),
-    target=Target.HOST
+    target=Target.HOST,
+    activation: Callable[[Scalar], Scalar] = None
 ):
     """Emits a Gemm-like function that performs matrix multiplication
-    with the form Y = alpha * A * B + beta * C"""
+    with the form Y = alpha * A * B + beta * C, optionally followed by an elementwise activation of Y
+    that is fused with the matrix multiplication"""
 
     if (zero_C or bias) and opts.UseBiasFusion:
-        return MLAS_with_bias(A, B, bias, C, transA, transB, alpha, beta, opts, target)
+        return MLAS_with_bias(A, B, bias, C, transA, transB, alpha, beta, opts, target, activation)
 
     raise RuntimeError("Unexpected")
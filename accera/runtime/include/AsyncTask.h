@@ -0,0 +1,45 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//
+//  Background executor used by the asynchronous variants of CPU functions
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // defined(__cplusplus)
+
+/// <summary> The signature of the task generated for the asynchronous variant of a function. </summary>
+/// <param name="context"> The arguments of the call, owned and released by the task. </param>
+typedef void (*AcceraAsyncTask)(void* context);
+
+/// <summary> Starts the executor threads. Calling this is optional, the executor is started on first use otherwise. </summary>
+/// <param name="numThreads"> The number of asynchronous calls that can run concurrently, or 0 for the default of 1. </param>
+void AcceraAsyncInitialize(int64_t numThreads);
+
+/// <summary> Enqueues a task on the executor. </summary>
+/// <param name="task"> The task to run. </param>
+/// <param name="context"> The context passed to the task. </param>
+/// <returns> An opaque handle to the enqueued call, to be passed to AcceraAsyncWait or AcceraAsyncPoll and then released. </returns>
+int64_t AcceraAsyncLaunch(AcceraAsyncTask task, void* context);
+
+/// <summary> Checks whether an asynchronous call has completed, without blocking. </summary>
+/// <param name="handle"> The handle returned by the asynchronous function. </param>
+/// <returns> 1 if the call has completed, 0 otherwise. </returns>
+int64_t AcceraAsyncPoll(int64_t handle);
+
+/// <summary> Blocks until an asynchronous call has completed. </summary>
+/// <param name="handle"> The handle returned by the asynchronous function. </param>
+void AcceraAsyncWait(int64_t handle);
+
+/// <summary> Releases the handle of an asynchronous call. A call that is still running completes in the background. </summary>
+/// <param name="handle"> The handle returned by the asynchronous function, which must not be used afterwards. </param>
+void AcceraAsyncRelease(int64_t handle);
+
+#if defined(__cplusplus)
+} // extern "C"
+#endif // defined(__cplusplus)
@@ -0,0 +1,41 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//
+//  The CPU features of the host, read by the dispatchers of functions that have a version per CPU
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // defined(__cplusplus)
+
+/// <summary> The CPU features that function versions can be selected by. A feature is only reported when the CPU has all of the instruction set extensions it names and the OS saves the registers they use. </summary>
+enum AcceraCPUFeature
+{
+    AcceraCPUFeatureAVX2 = 1 << 0, // AVX, AVX2 and FMA
+    AcceraCPUFeatureAVX512 = 1 << 1, // AVX-512 F, CD, BW, DQ and VL
+    AcceraCPUFeatureAVX512VNNI = 1 << 2, // AVX-512 VNNI
+};
+
+/// <summary> Gets the CPU features of the host, which are read with CPUID once when the library is loaded. </summary>
+/// <returns> The mask of the AcceraCPUFeature values the host has, 0 on other architectures than x86-64. </returns>
+int64_t AcceraGetCPUFeatures();
+
+/// <summary> Requests the permission to use the AMX tile registers, which Linux requires before a process first uses them.
+/// The permission is requested once per process, the later calls return the result of the first one. </summary>
+/// <returns> 0 if the process can use the AMX tile registers, -1 otherwise. </returns>
+int32_t AcceraRequestAMXTileData(void);
+
+/// <summary> Checks whether the host has an instruction set extension, such as the ones HAT files require. The extensions
+/// that use the AVX or AVX-512 registers are only reported when the OS also saves these registers. </summary>
+/// <param name="extension"> The LLVM name of the extension, such as "avx2" or "avx512vnni", with or without a leading '+'. </param>
+/// <returns> 1 if the host has the extension, 0 if it does not, -1 if the extension is unknown to the runtime or the host is not x86-64. </returns>
+int32_t AcceraHasCPUExtension(const char* extension);
+
+#if defined(__cplusplus)
+} // extern "C"
+#endif // defined(__cplusplus)
@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//
+//  Loader of dynamic HAT packages, for C and C++ clients that do not use the HAT Python tools
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // defined(__cplusplus)
+
+/// <summary> A loaded HAT package: its description and the library it links to. </summary>
+typedef struct AcceraHATPackage AcceraHATPackage;
+
+/// <summary> The options of AcceraHATLoad. </summary>
+enum AcceraHATLoadFlags
+{
+    /// <summary> Binds the imports of the library and resolves every function of the package when it is loaded, so that
+    /// a missing symbol fails the load instead of the first call. Functions are resolved on first use otherwise. </summary>
+    AcceraHATLoadEager = 1 << 0,
+
+    /// <summary> Touches the pages of the constant data of the library when it is loaded, such as the packed weights
+    /// that are embedded as globals, so that the first calls do not take their page faults. </summary>
+    AcceraHATLoadPrefault = 1 << 1,
+};
+
+/// <summary> Loads a dynamic HAT package, after checking that the host meets the requirements of its target: the OS,
+/// the CPU architecture and extensions, and the GPU runtime. </summary>
+/// <param name="hatPath"> The path of the .hat file, which names the library it links to relative to its own directory. </param>
+/// <param name="flags"> A combination of AcceraHATLoadFlags values. </param>
+/// <param name="error"> A buffer that receives the reason of a failure, or NULL. </param>
+/// <param name="errorSize"> The size of the error buffer in bytes. </param>
+/// <returns> The package, to be released with AcceraHATUnload, or NULL if it cannot be loaded on this host. </returns>
+AcceraHATPackage* AcceraHATLoad(const char* hatPath, int32_t flags, char* error, int64_t errorSize);
+
+/// <summary> Unloads a package. The functions and packed buffers of the package must not be used afterwards. </summary>
+/// <param name="package"> The package returned by AcceraHATLoad, or NULL. </param>
+void AcceraHATUnload(AcceraHATPackage* package);
+
+/// <summary> Gets a function of a package. Functions are resolved on first use and cached, this is safe to call from several threads. </summary>
+/// <param name="package"> The package returned by AcceraHATLoad. </param>
+/// <param name="name"> The name of the function in the HAT file. </param>
+/// <returns> The address of the function, NULL if the package has no such function. </returns>
+void* AcceraHATGetFunction(AcceraHATPackage* package, const char* name);
+
+/// <summary> Packs a constant input of the package on the asynchronous executor, so that the packing of weights with
+/// a runtime-initialized cache is off the critical path of the first call. </summary>
+/// <param name="package"> The package returned by AcceraHATLoad. </param>
+/// <param name="packingFunction"> The name of the packing function of the cache, which takes the input and the packed buffer. </param>
+/// <param name="sizeFunction"> The name of the function that returns the number of elements of the packed buffer. </param>
+/// <param name="input"> The input to pack, which must stay valid until the packing completes. </param>
+/// <param name="packedBuffer"> Receives the packed buffer, which is allocated by this call and released with AcceraHATFreePacked. </param>
+/// <returns> The handle of the packing, to be passed to AcceraAsyncWait or AcceraAsyncPoll and then released, or -1 if
+/// the package has no such functions. </returns>
+int64_t AcceraHATPackAsync(AcceraHATPackage* package, const char* packingFunction, const char* sizeFunction, const void* input, void** packedBuffer);
+
+/// <summary> Releases a packed buffer allocated by AcceraHATPackAsync, after its packing has completed. </summary>
+/// <param name="packedBuffer"> The packed buffer, or NULL. </param>
+void AcceraHATFreePacked(void* packedBuffer);
+
+#if defined(__cplusplus)
+} // extern "C"
+#endif // defined(__cplusplus)
@@ -0,0 +1,24 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//
+//  Lazily allocated static buffers that are backed by huge pages to reduce TLB misses
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // defined(__cplusplus)
+
+/// <summary> Allocates a zero-initialized buffer backed by huge pages on first use, later calls return the existing buffer. Explicit huge pages are used when the system has them (1GB pages for buffers of at least 1GB, 2MB pages otherwise), and transparent huge pages are requested with madvise otherwise. </summary>
+/// <param name="handle"> The slot of the generated library that holds the buffer, initially null. </param>
+/// <param name="sizeInBytes"> The size of the buffer. </param>
+/// <returns> The address of the buffer, aligned to at least 2MB. Aborts if no memory can be allocated, since the generated code cannot run without it. </returns>
+void* AcceraAllocateHugePages(void** handle, int64_t sizeInBytes);
+
+#if defined(__cplusplus)
+} // extern "C"
+#endif // defined(__cplusplus)
@@ -0,0 +1,25 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//
+//  Lazily memory-mapped packed buffers that are deployed as files next to the generated library
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // defined(__cplusplus)
+
+/// <summary> Maps a packed buffer file into memory on first use, later calls return the existing mapping. The file is mapped read-only, so processes that map the same file share its pages. </summary>
+/// <param name="handle"> The slot of the generated library that holds the mapping, initially null. </param>
+/// <param name="fileName"> The name of the file, relative to the directory of the module that contains the handle, or to ACCERA_MAPPED_BUFFER_DIR when that environment variable is set. </param>
+/// <param name="sizeInBytes"> The size of the packed buffer, the file must be at least this large. </param>
+/// <returns> The address of the mapped buffer. Aborts if the file cannot be mapped, since the generated code cannot run without it. </returns>
+void* AcceraMapPackedBuffer(void** handle, const char* fileName, int64_t sizeInBytes);
+
+#if defined(__cplusplus)
+} // extern "C"
+#endif // defined(__cplusplus)
@@ -0,0 +1,34 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//
+//  Hardware performance counters of the calling thread, read by the profile regions of generated code
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // defined(__cplusplus)
+
+/// <summary> The counters that can be read. The bit of a counter in an event mask is 1 << its value, and its value is the index of its entry in the values buffer. </summary>
+enum AcceraPerfCounter
+{
+    AcceraPerfCounterCycles = 0,
+    AcceraPerfCounterInstructions = 1,
+    AcceraPerfCounterL1DMisses = 2,
+    AcceraPerfCounterLLCMisses = 3,
+    AcceraPerfCounterBranchMisses = 4,
+    AcceraPerfCounterCount = 5
+};
+
+/// <summary> Reads the counters of the calling thread. The counters are opened on the first read of each thread with perf_event_open on Linux, as one group so that they are read together. Counters that the system doesn't support or doesn't allow to be opened, and all the counters on other platforms, read as 0. </summary>
+/// <param name="eventMask"> The counters to read. </param>
+/// <param name="values"> A buffer of AcceraPerfCounterCount entries, the entries of the counters in eventMask are set to their running totals, the others are left unchanged. </param>
+void AcceraReadPerfCounters(int32_t eventMask, int64_t* values);
+
+#if defined(__cplusplus)
+} // extern "C"
+#endif // defined(__cplusplus)
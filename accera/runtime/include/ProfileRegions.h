@@ -0,0 +1,103 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//
+//  Nested, per-thread profile regions that the profiling code of generated libraries records into
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "PerfCounters.h"
+
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // defined(__cplusplus)
+
+/// <summary> Enters a region on the calling thread. Each thread records into its own tree of regions, where the region is the child of the region the thread is in, so that the same region entered from different parents is timed separately. </summary>
+/// <param name="handle"> The slot of the generated library that holds the id of the region, initially 0. </param>
+/// <param name="name"> The name of the region, regions of the same name share their id across libraries. </param>
+/// <param name="timestamp"> The time the region is entered, in seconds or in cycles of the timestamp counter. </param>
+/// <param name="counterMask"> The hardware counters to read, see AcceraPerfCounter in PerfCounters.h. </param>
+/// <param name="cycleCounter"> Whether the timestamps are cycles of the timestamp counter, which are converted to seconds with the frequency of the counter when it is known. </param>
+void AcceraEnterProfileRegion(int64_t* handle, const char* name, double timestamp, int32_t counterMask, int32_t cycleCounter);
+
+/// <summary> Exits the innermost region of the calling thread with the id in handle. The regions it encloses that were not exited are left untimed. </summary>
+/// <param name="handle"> The slot that was passed to AcceraEnterProfileRegion. </param>
+/// <param name="timestamp"> The time the region is exited, in the units of the timestamp it was entered at. </param>
+/// <param name="counterMask"> The hardware counters to read, the same as when the region was entered. </param>
+void AcceraExitProfileRegion(int64_t* handle, double timestamp, int32_t counterMask);
+
+/// <summary> Adds to the bytes loaded from and stored to an array by the calling thread in the innermost region it is in, or outside of the regions if it is in none. The memory traffic instrumentation of generated libraries calls it for each block of accesses. </summary>
+/// <param name="handle"> The slot of the generated library that holds the id of the array, initially 0. </param>
+/// <param name="array"> The name of the array, arrays of the same name share their id across libraries. </param>
+void AcceraCountMemoryTraffic(int64_t* handle, const char* array, int64_t loadedBytes, int64_t storedBytes);
+
+/// <summary> Prints the count, the total time and the time spent outside of child regions of each region, the hardware counters read in it and the memory traffic of each array in it, as a tree per thread followed by the tree summed over all threads. The trace, the counters and the memory traffic are also written to the files named by the ACCERA_PROFILE_TRACE, ACCERA_PROFILE_COUNTERS and ACCERA_MEMORY_TRAFFIC environment variables when they are set. </summary>
+void AcceraPrintProfileResults(void);
+
+/// <summary> A region of a thread, as returned by AcceraGetProfileRecords. </summary>
+typedef struct AcceraProfileRecord
+{
+    int32_t thread; // the threads are numbered in the order they first entered a region
+    int32_t parent; // the index of the record of the enclosing region, or -1 for the outermost regions
+    const char* name; // valid until the library is unloaded
+    int64_t count;
+    double totalSeconds;
+    double selfSeconds; // the time spent outside of child regions
+    int64_t counters[AcceraPerfCounterCount]; // the hardware counters that weren't read are 0
+} AcceraProfileRecord;
+
+/// <summary> Writes the regions recorded so far as Chrome trace event JSON, which chrome://tracing and Perfetto load. Each thread records the events of its first 262144 regions, later ones are counted as dropped_events. </summary>
+/// <returns> 0 on success, -1 if the file cannot be written. </returns>
+int32_t AcceraWriteProfileTrace(const char* path);
+
+/// <summary> Formats the Chrome trace of AcceraWriteProfileTrace into a buffer, like snprintf. </summary>
+/// <returns> The length of the trace, which was truncated if it's not less than size. </returns>
+int64_t AcceraFormatProfileTrace(char* buffer, int64_t size);
+
+/// <summary> Writes the totals of the regions as CSV, with a row per region of each thread followed by the rows summed over all threads, whose thread is "all". Regions are named by the path of regions that encloses them, separated by '/'. </summary>
+/// <returns> 0 on success, -1 if the file cannot be written. </returns>
+int32_t AcceraWriteProfileCounters(const char* path);
+
+/// <summary> Formats the CSV of AcceraWriteProfileCounters into a buffer, like snprintf. </summary>
+/// <returns> The length of the CSV, which was truncated if it's not less than size. </returns>
+int64_t AcceraFormatProfileCounters(char* buffer, int64_t size);
+
+/// <summary> Gets the totals of the regions of each thread, parents before their children. </summary>
+/// <param name="records"> A buffer of capacity records, may be null if capacity is 0. </param>
+/// <returns> The number of records, of which the first capacity ones are written. </returns>
+int64_t AcceraGetProfileRecords(AcceraProfileRecord* records, int64_t capacity);
+
+/// <summary> The bytes that a thread loaded from and stored to an array in a region, as returned by AcceraGetMemoryTrafficRecords. </summary>
+typedef struct AcceraMemoryTrafficRecord
+{
+    int32_t thread;
+    int32_t region; // the index of the region's record in AcceraGetProfileRecords, or -1 for the traffic outside of the regions
+    const char* array; // valid until the library is unloaded
+    int64_t loadedBytes;
+    int64_t storedBytes;
+} AcceraMemoryTrafficRecord;
+
+/// <summary> Writes the memory traffic as CSV, with a row per array of each region of each thread followed by the rows summed over all threads, whose thread is "all". Regions are named as in AcceraWriteProfileCounters, the traffic outside of the regions has an empty region. </summary>
+/// <returns> 0 on success, -1 if the file cannot be written. </returns>
+int32_t AcceraWriteMemoryTraffic(const char* path);
+
+/// <summary> Formats the CSV of AcceraWriteMemoryTraffic into a buffer, like snprintf. </summary>
+/// <returns> The length of the CSV, which was truncated if it's not less than size. </returns>
+int64_t AcceraFormatMemoryTraffic(char* buffer, int64_t size);
+
+/// <summary> Gets the memory traffic of each array in each region of each thread, in the order of the regions in AcceraGetProfileRecords. </summary>
+/// <param name="records"> A buffer of capacity records, may be null if capacity is 0. </param>
+/// <returns> The number of records, of which the first capacity ones are written. </returns>
+int64_t AcceraGetMemoryTrafficRecords(AcceraMemoryTrafficRecord* records, int64_t capacity);
+
+/// <summary> Clears the totals, the memory traffic and the trace events of all threads. </summary>
+void AcceraResetProfileResults(void);
+
+/// The functions that read the results must not run concurrently with the regions.
+
+#if defined(__cplusplus)
+} // extern "C"
+#endif // defined(__cplusplus)
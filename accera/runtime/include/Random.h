@@ -12,11 +12,23 @@
 extern "C" {
 #endif // defined(__cplusplus)
 
+// The values are drawn from a counter-based (Philox4x32-10) stream keyed by the seed. Every value is a function of
+// the seed and of its position in the stream alone, so large buffers are filled in parallel and the results do not
+// depend on the number of threads. Each call consumes the positions of its values, rounded up to a multiple of 4.
+
+/// <summary> Restarts the stream of random values with the given seed. </summary>
 void ResetRandomEngine(unsigned int seed);
 
+/// <summary> Draws a value uniformly from [-1, 1). </summary>
 void GetNextRandomValue(float*);
+
+/// <summary> Draws an integer uniformly from [lo, hi]. </summary>
 void GetNextRandomIntValue(int*, int lo, int hi);
+
+/// <summary> Fills a buffer with values drawn uniformly from [-1, 1). </summary>
 void GetNextNRandomValues(float* buffer, unsigned int N);
+
+/// <summary> Fills a buffer with integers drawn uniformly from [lo, hi]. </summary>
 void GetNextNRandomIntValues(int* buffer, int lo, int hi, unsigned int N);
 
 #if defined(__cplusplus)
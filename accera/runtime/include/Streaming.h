@@ -0,0 +1,55 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//
+//  Double-buffered streaming of arrays that are larger than memory through functions that compute a chunk at a time
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // defined(__cplusplus)
+
+/// <summary> Fills a buffer with a chunk of the streamed array. Called on the prefetch thread. </summary>
+/// <param name="context"> The context passed to AcceraStream. </param>
+/// <param name="chunk"> The index of the chunk. </param>
+/// <param name="buffer"> The buffer to fill. </param>
+/// <param name="sizeInBytes"> The size of the buffer, which is the size of a chunk. </param>
+/// <returns> 0 on success, any other value stops the stream. </returns>
+typedef int32_t (*AcceraStreamFetch)(void* context, int64_t chunk, void* buffer, int64_t sizeInBytes);
+
+/// <summary> Computes a chunk of the streamed array, typically by calling a function of a package with the chunk as the
+/// argument that holds the rows of the outer index. Called on the calling thread, in the order of the chunks. </summary>
+/// <param name="context"> The context passed to AcceraStream. </param>
+/// <param name="chunk"> The index of the chunk. </param>
+/// <param name="data"> The chunk, which is valid until the call returns. </param>
+typedef void (*AcceraStreamCompute)(void* context, int64_t chunk, const void* data);
+
+/// <summary> Computes the chunks of an array in order, while the next chunk is fetched into a second buffer in the
+/// background. Only two chunks are in memory at a time. </summary>
+/// <param name="numChunks"> The number of chunks. </param>
+/// <param name="chunkSizeInBytes"> The size of each chunk. </param>
+/// <param name="fetch"> The function that fills a buffer with a chunk. </param>
+/// <param name="compute"> The function that computes a chunk. </param>
+/// <param name="context"> The context passed to fetch and compute. </param>
+/// <returns> 0 if every chunk was computed, otherwise the value returned by the fetch that failed, or -1 if the buffers cannot be allocated. </returns>
+int32_t AcceraStream(int64_t numChunks, int64_t chunkSizeInBytes, AcceraStreamFetch fetch, AcceraStreamCompute compute, void* context);
+
+/// <summary> Computes the chunks of an array that is stored in a file, like AcceraStream. Chunk i is read from
+/// offsetInBytes + i * chunkSizeInBytes. The chunks are read rather than mapped, and on Linux the pages of the chunks
+/// that were read are dropped from the page cache, so that streaming the file doesn't evict the memory of the process. </summary>
+/// <param name="path"> The path of the file. </param>
+/// <param name="offsetInBytes"> The offset of the first chunk in the file. </param>
+/// <param name="numChunks"> The number of chunks, the file must hold all of them. </param>
+/// <param name="chunkSizeInBytes"> The size of each chunk. </param>
+/// <param name="compute"> The function that computes a chunk. </param>
+/// <param name="context"> The context passed to compute. </param>
+/// <returns> 0 if every chunk was computed, -1 if the buffers cannot be allocated, -2 if the file cannot be opened, or -3 if a chunk cannot be read. </returns>
+int32_t AcceraStreamFile(const char* path, int64_t offsetInBytes, int64_t numChunks, int64_t chunkSizeInBytes, AcceraStreamCompute compute, void* context);
+
+#if defined(__cplusplus)
+} // extern "C"
+#endif // defined(__cplusplus)
@@ -0,0 +1,23 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//
+//  Thread affinity support used by loops that are pinned to an explicit list of processors
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // defined(__cplusplus)
+
+/// <summary> Pins the calling thread to a processor. Pinning a thread to the processor it is already pinned to is a no-op. </summary>
+/// <param name="processor"> The id of the logical processor, as numbered by the operating system. </param>
+/// <returns> 0 if the thread is pinned to the processor, -1 if the processor is invalid or pinning is not supported on this platform. </returns>
+int32_t AcceraPinCurrentThread(int64_t processor);
+
+#if defined(__cplusplus)
+} // extern "C"
+#endif // defined(__cplusplus)
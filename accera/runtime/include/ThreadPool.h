@@ -0,0 +1,53 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//
+//  Persistent thread pool used by functions compiled for the THREAD_POOL runtime
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // defined(__cplusplus)
+
+/// <summary> The signature of a parallel region outlined by the compiler. </summary>
+/// <param name="context"> The values captured by the parallel region. </param>
+/// <param name="threadIndex"> The index of the executing thread, in [0, numThreads). </param>
+/// <param name="numThreads"> The number of threads executing the parallel region. </param>
+typedef void (*AcceraThreadPoolTask)(void* context, int64_t threadIndex, int64_t numThreads);
+
+/// <summary> Starts the worker threads. Calling this is optional, the pool is started on first use otherwise. </summary>
+/// <param name="numThreads"> The number of threads, including the calling thread, or 0 to use the number of hardware threads. </param>
+/// <param name="spinMicroseconds"> How long idle workers spin waiting for work before parking, or -1 for the default. </param>
+void AcceraThreadPoolInitialize(int64_t numThreads, int64_t spinMicroseconds);
+
+/// <summary> Stops and joins the worker threads. The pool is restarted if it is used again afterwards. </summary>
+void AcceraThreadPoolShutdown(void);
+
+/// <summary> Caps the number of threads of every parallel region run on the pool, so that kernels running alongside
+/// other work do not oversubscribe the machine. The thread counts the functions were compiled with stay the default,
+/// and the regions partition their work across the threads they actually run on. </summary>
+/// <param name="maxThreads"> The maximum number of threads of a region, including the calling thread, or 0 to remove the cap. </param>
+void AcceraThreadPoolSetMaxThreads(int64_t maxThreads);
+
+/// <summary> Caps the number of threads of the parallel regions that the calling thread runs, in addition to the cap
+/// of AcceraThreadPoolSetMaxThreads, e.g. to give each of several application threads calling kernels its own share of the cores. </summary>
+/// <param name="maxThreads"> The maximum number of threads of a region, including the calling thread, or 0 to remove the cap. </param>
+void AcceraThreadPoolSetCallerMaxThreads(int64_t maxThreads);
+
+/// <summary> Runs a parallel region on the pool and returns once all threads have completed it. </summary>
+/// <param name="numThreads"> The number of threads to run the region on, including the calling thread, or 0 to use the pool size.
+/// It is reduced to the caps of AcceraThreadPoolSetMaxThreads and AcceraThreadPoolSetCallerMaxThreads. </param>
+/// <param name="task"> The outlined parallel region. </param>
+/// <param name="context"> The values captured by the parallel region. </param>
+void AcceraThreadPoolRun(int64_t numThreads, AcceraThreadPoolTask task, void* context);
+
+/// <summary> Waits until all threads of the current parallel region reach this barrier. </summary>
+void AcceraThreadPoolBarrier(void);
+
+#if defined(__cplusplus)
+} // extern "C"
+#endif // defined(__cplusplus)
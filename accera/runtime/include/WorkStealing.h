@@ -0,0 +1,34 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//
+//  Work-stealing scheduler used by loops parallelized with the WorkStealing policy
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif // defined(__cplusplus)
+
+/// <summary> Creates a scheduler that distributes the chunks [0, numChunks) over numWorkers workers. </summary>
+/// <param name="numChunks"> The number of chunks of work, must be less than 2^32. </param>
+/// <param name="numWorkers"> The number of workers that will request chunks. </param>
+/// <returns> An opaque handle to the scheduler, or 0 if the arguments are invalid. </returns>
+int64_t AcceraWorkStealingCreate(int64_t numChunks, int64_t numWorkers);
+
+/// <summary> Gets the next chunk for a worker, stealing from other workers once its own range is exhausted. </summary>
+/// <param name="handle"> The handle returned by AcceraWorkStealingCreate. </param>
+/// <param name="workerId"> The id of the calling worker, in [0, numWorkers). </param>
+/// <returns> The chunk to execute next, or -1 when there is no work left. </returns>
+int64_t AcceraWorkStealingNext(int64_t handle, int64_t workerId);
+
+/// <summary> Releases a scheduler. All workers must have stopped requesting chunks. </summary>
+/// <param name="handle"> The handle returned by AcceraWorkStealingCreate. </param>
+void AcceraWorkStealingDestroy(int64_t handle);
+
+#if defined(__cplusplus)
+} // extern "C"
+#endif // defined(__cplusplus)
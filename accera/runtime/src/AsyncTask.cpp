@@ -0,0 +1,168 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//
+//  Background executor used by the asynchronous variants of CPU functions
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "AsyncTask.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// A single executor thread by default: each call already uses every core through its parallel loops
+constexpr int64_t DefaultExecutorThreads = 1;
+
+struct AsyncCall
+{
+    AsyncCall(AcceraAsyncTask task, void* context) :
+        task(task),
+        context(context)
+    {}
+
+    AcceraAsyncTask task;
+    void* context;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::atomic<bool> done{ false };
+
+    // Shared by the handle and the executor, whichever lets go last deletes the call
+    std::atomic<int64_t> references{ 2 };
+};
+
+void ReleaseCall(AsyncCall* call)
+{
+    if (call->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        delete call;
+    }
+}
+
+class Executor
+{
+public:
+    ~Executor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _condition.notify_all();
+        for (auto& worker : _workers)
+        {
+            worker.join();
+        }
+    }
+
+    void Start(int64_t numThreads)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        GrowLocked(numThreads <= 0 ? DefaultExecutorThreads : numThreads);
+    }
+
+    AsyncCall* Launch(AcceraAsyncTask task, void* context)
+    {
+        auto call = new AsyncCall(task, context);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            GrowLocked(DefaultExecutorThreads);
+            _queue.push_back(call);
+        }
+        _condition.notify_one();
+        return call;
+    }
+
+private:
+    void GrowLocked(int64_t numThreads)
+    {
+        while (static_cast<int64_t>(_workers.size()) < numThreads)
+        {
+            _workers.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+
+    void WorkerLoop()
+    {
+        while (true)
+        {
+            AsyncCall* call = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _condition.wait(lock, [this] { return _stop || !_queue.empty(); });
+                if (_queue.empty())
+                {
+                    // Pending calls are drained before stopping so that no handle waits forever
+                    return;
+                }
+                call = _queue.front();
+                _queue.pop_front();
+            }
+
+            call->task(call->context);
+            {
+                std::lock_guard<std::mutex> lock(call->mutex);
+                call->done.store(true, std::memory_order_release);
+            }
+            call->condition.notify_all();
+            ReleaseCall(call);
+        }
+    }
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::deque<AsyncCall*> _queue;
+    std::vector<std::thread> _workers;
+    bool _stop = false;
+};
+
+Executor& GetExecutor()
+{
+    static Executor executor;
+    return executor;
+}
+
+AsyncCall* GetCall(int64_t handle)
+{
+    return reinterpret_cast<AsyncCall*>(static_cast<intptr_t>(handle));
+}
+} // namespace
+
+void AcceraAsyncInitialize(int64_t numThreads)
+{
+    GetExecutor().Start(numThreads);
+}
+
+int64_t AcceraAsyncLaunch(AcceraAsyncTask task, void* context)
+{
+    return static_cast<int64_t>(reinterpret_cast<intptr_t>(GetExecutor().Launch(task, context)));
+}
+
+int64_t AcceraAsyncPoll(int64_t handle)
+{
+    return GetCall(handle)->done.load(std::memory_order_acquire) ? 1 : 0;
+}
+
+void AcceraAsyncWait(int64_t handle)
+{
+    auto call = GetCall(handle);
+    if (call->done.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(call->mutex);
+    call->condition.wait(lock, [call] { return call->done.load(std::memory_order_acquire); });
+}
+
+void AcceraAsyncRelease(int64_t handle)
+{
+    ReleaseCall(GetCall(handle));
+}
@@ -0,0 +1,281 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//
+//  The CPU features of the host, read by the dispatchers of functions that have a version per CPU
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "CPUFeatures.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define ACCERA_X86_64 1
+#if defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#endif
+
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+#if defined(ACCERA_X86_64)
+struct CPUIDRegisters
+{
+    uint32_t eax = 0, ebx = 0, ecx = 0, edx = 0;
+};
+
+CPUIDRegisters CPUID(uint32_t leaf, uint32_t subleaf)
+{
+    CPUIDRegisters registers;
+#if defined(_MSC_VER)
+    int values[4];
+    __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+    registers = { static_cast<uint32_t>(values[0]), static_cast<uint32_t>(values[1]), static_cast<uint32_t>(values[2]), static_cast<uint32_t>(values[3]) };
+#else
+    if (!__get_cpuid_count(leaf, subleaf, &registers.eax, &registers.ebx, &registers.ecx, &registers.edx))
+    {
+        return {};
+    }
+#endif
+    return registers;
+}
+
+// The register state that the OS saves on context switches, XCR0
+uint64_t GetEnabledRegisterState()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__("xgetbv"
+            : "=a"(eax), "=d"(edx)
+            : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+bool HasBit(uint32_t value, int bit)
+{
+    return (value >> bit) & 1;
+}
+
+constexpr uint64_t NoState = 0;
+constexpr uint64_t YMMState = 0x6; // SSE and AVX
+constexpr uint64_t ZMMState = 0xE6; // SSE, AVX, opmask and both halves of the ZMM registers
+
+int64_t ReadCPUFeatures()
+{
+    auto maxLeaf = CPUID(0, 0).eax;
+    if (maxLeaf < 7)
+    {
+        return 0;
+    }
+
+    auto leaf1 = CPUID(1, 0);
+    if (!HasBit(leaf1.ecx, 27)) // OSXSAVE, xgetbv is unavailable without it
+    {
+        return 0;
+    }
+
+    auto registerState = GetEnabledRegisterState();
+    auto leaf7 = CPUID(7, 0);
+
+    int64_t features = 0;
+    if ((registerState & YMMState) == YMMState &&
+        HasBit(leaf1.ecx, 28) && // AVX
+        HasBit(leaf1.ecx, 12) && // FMA
+        HasBit(leaf7.ebx, 5)) // AVX2
+    {
+        features |= AcceraCPUFeatureAVX2;
+
+        if ((registerState & ZMMState) == ZMMState &&
+            HasBit(leaf7.ebx, 16) && // AVX512F
+            HasBit(leaf7.ebx, 17) && // AVX512DQ
+            HasBit(leaf7.ebx, 28) && // AVX512CD
+            HasBit(leaf7.ebx, 30) && // AVX512BW
+            HasBit(leaf7.ebx, 31)) // AVX512VL
+        {
+            features |= AcceraCPUFeatureAVX512;
+
+            if (HasBit(leaf7.ecx, 11)) // AVX512_VNNI
+            {
+                features |= AcceraCPUFeatureAVX512VNNI;
+            }
+        }
+    }
+    return features;
+}
+
+int32_t RequestAMXTileData()
+{
+    if (CPUID(0, 0).eax < 7 || !HasBit(CPUID(7, 0).edx, 24)) // AMX-TILE
+    {
+        return -1;
+    }
+
+#if defined(__linux__)
+    // The tile data is too large to be saved on every context switch, so Linux only enables it for the processes
+    // that ask for it, and the tile instructions fault until they do
+    constexpr int ArchRequestXCompPermission = 0x1023; // ARCH_REQ_XCOMP_PERM
+    constexpr int XFeatureXTileData = 18; // XFEATURE_XTILEDATA
+    if (syscall(SYS_arch_prctl, ArchRequestXCompPermission, XFeatureXTileData) != 0)
+    {
+        return -1;
+    }
+#endif
+
+    constexpr uint64_t TileState = 0x60000; // XTILECFG and XTILEDATA
+    return (GetEnabledRegisterState() & TileState) == TileState ? 0 : -1;
+}
+
+enum class CPUIDRegister
+{
+    EBX,
+    ECX,
+    EDX,
+    EAX,
+};
+
+struct CPUExtension
+{
+    const char* name;
+    uint32_t leaf;
+    uint32_t subleaf;
+    CPUIDRegister cpuidRegister;
+    int bit;
+    uint64_t registerState; // The XCR0 bits the OS must enable for the extension to be usable
+};
+
+// The x86-64 extensions by their LLVM feature names
+constexpr CPUExtension CPUExtensions[] = {
+    { "sse", 1, 0, CPUIDRegister::EDX, 25, NoState },
+    { "sse2", 1, 0, CPUIDRegister::EDX, 26, NoState },
+    { "sse3", 1, 0, CPUIDRegister::ECX, 0, NoState },
+    { "ssse3", 1, 0, CPUIDRegister::ECX, 9, NoState },
+    { "fma", 1, 0, CPUIDRegister::ECX, 12, YMMState },
+    { "sse4.1", 1, 0, CPUIDRegister::ECX, 19, NoState },
+    { "sse4.2", 1, 0, CPUIDRegister::ECX, 20, NoState },
+    { "popcnt", 1, 0, CPUIDRegister::ECX, 23, NoState },
+    { "avx", 1, 0, CPUIDRegister::ECX, 28, YMMState },
+    { "f16c", 1, 0, CPUIDRegister::ECX, 29, YMMState },
+    { "bmi", 7, 0, CPUIDRegister::EBX, 3, NoState },
+    { "avx2", 7, 0, CPUIDRegister::EBX, 5, YMMState },
+    { "bmi2", 7, 0, CPUIDRegister::EBX, 8, NoState },
+    { "avx512f", 7, 0, CPUIDRegister::EBX, 16, ZMMState },
+    { "avx512dq", 7, 0, CPUIDRegister::EBX, 17, ZMMState },
+    { "avx512ifma", 7, 0, CPUIDRegister::EBX, 21, ZMMState },
+    { "avx512cd", 7, 0, CPUIDRegister::EBX, 28, ZMMState },
+    { "avx512bw", 7, 0, CPUIDRegister::EBX, 30, ZMMState },
+    { "avx512vl", 7, 0, CPUIDRegister::EBX, 31, ZMMState },
+    { "avx512vbmi", 7, 0, CPUIDRegister::ECX, 1, ZMMState },
+    { "avx512vbmi2", 7, 0, CPUIDRegister::ECX, 6, ZMMState },
+    { "gfni", 7, 0, CPUIDRegister::ECX, 8, NoState },
+    { "vpclmulqdq", 7, 0, CPUIDRegister::ECX, 10, YMMState },
+    { "avx512vnni", 7, 0, CPUIDRegister::ECX, 11, ZMMState },
+    { "avx512bitalg", 7, 0, CPUIDRegister::ECX, 12, ZMMState },
+    { "avx512vpopcntdq", 7, 0, CPUIDRegister::ECX, 14, ZMMState },
+    { "amx-bf16", 7, 0, CPUIDRegister::EDX, 22, NoState },
+    { "avx512fp16", 7, 0, CPUIDRegister::EDX, 23, ZMMState },
+    { "amx-tile", 7, 0, CPUIDRegister::EDX, 24, NoState },
+    { "amx-int8", 7, 0, CPUIDRegister::EDX, 25, NoState },
+    { "avxvnni", 7, 1, CPUIDRegister::EAX, 4, YMMState },
+    { "avx512bf16", 7, 1, CPUIDRegister::EAX, 5, ZMMState },
+};
+
+int32_t HasCPUExtension(const char* extension)
+{
+    if (extension[0] == '+')
+    {
+        ++extension;
+    }
+
+    for (const auto& candidate : CPUExtensions)
+    {
+        if (std::strcmp(candidate.name, extension) != 0)
+        {
+            continue;
+        }
+
+        if (CPUID(0, 0).eax < candidate.leaf)
+        {
+            return 0;
+        }
+
+        auto registers = CPUID(candidate.leaf, candidate.subleaf);
+        uint32_t value = 0;
+        switch (candidate.cpuidRegister)
+        {
+        case CPUIDRegister::EAX:
+            value = registers.eax;
+            break;
+        case CPUIDRegister::EBX:
+            value = registers.ebx;
+            break;
+        case CPUIDRegister::ECX:
+            value = registers.ecx;
+            break;
+        case CPUIDRegister::EDX:
+            value = registers.edx;
+            break;
+        }
+        if (!HasBit(value, candidate.bit))
+        {
+            return 0;
+        }
+
+        if (candidate.registerState != NoState)
+        {
+            if (!HasBit(CPUID(1, 0).ecx, 27) || // OSXSAVE
+                (GetEnabledRegisterState() & candidate.registerState) != candidate.registerState)
+            {
+                return 0;
+            }
+        }
+        return 1;
+    }
+    return -1;
+}
+#else
+int64_t ReadCPUFeatures()
+{
+    return 0;
+}
+
+int32_t RequestAMXTileData()
+{
+    return -1;
+}
+
+int32_t HasCPUExtension(const char*)
+{
+    return -1;
+}
+#endif
+
+// Read once when the library is loaded, so that the dispatchers only load it
+const int64_t CPUFeatures = ReadCPUFeatures();
+} // namespace
+
+int64_t AcceraGetCPUFeatures()
+{
+    return CPUFeatures;
+}
+
+int32_t AcceraRequestAMXTileData()
+{
+    static const int32_t result = RequestAMXTileData();
+    return result;
+}
+
+int32_t AcceraHasCPUExtension(const char* extension)
+{
+    return extension ? HasCPUExtension(extension) : -1;
+}
@@ -0,0 +1,448 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//
+//  Loader of dynamic HAT packages, for C and C++ clients that do not use the HAT Python tools
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "HATLoader.h"
+#include "AsyncTask.h"
+#include "CPUFeatures.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <link.h>
+#endif
+#endif
+
+#include <toml++/toml.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+struct AcceraHATPackage
+{
+    toml::table hat;
+#if defined(_WIN32)
+    HMODULE library = nullptr;
+#else
+    void* library = nullptr;
+#endif
+
+    // Serializes the first use of each function
+    std::mutex functionsMutex;
+    std::unordered_map<std::string, void*> functions;
+};
+
+namespace
+{
+// The alignment of the packed buffers, a cache line and the width of the widest vector loads
+constexpr size_t PackedBufferAlignment = 64;
+
+#if defined(_WIN32)
+const char* HostOperatingSystem = "windows";
+#elif defined(__APPLE__)
+const char* HostOperatingSystem = "macos";
+#else
+const char* HostOperatingSystem = "linux";
+#endif
+
+// The names the HAT files of the host architecture can use for it
+#if defined(_M_X64) || defined(__x86_64__)
+const char* HostArchitectures[] = { "x86_64", "x86-64", "amd64", "x64" };
+#elif defined(_M_ARM64) || defined(__aarch64__)
+const char* HostArchitectures[] = { "aarch64", "arm64" };
+#else
+const char* HostArchitectures[] = { "" };
+#endif
+
+std::string ToLower(std::string value)
+{
+    std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return value;
+}
+
+void SetError(char* error, int64_t errorSize, const std::string& message)
+{
+    if (error && errorSize > 0)
+    {
+        std::snprintf(error, static_cast<size_t>(errorSize), "%s", message.c_str());
+    }
+}
+
+std::string GetDirectory(const std::string& path)
+{
+    auto separator = path.find_last_of("\\/");
+    return separator == std::string::npos ? std::string{} : path.substr(0, separator + 1);
+}
+
+#if defined(_WIN32)
+HMODULE OpenLibrary(const std::string& path, bool)
+{
+    return LoadLibraryA(path.c_str());
+}
+
+void CloseLibrary(HMODULE library)
+{
+    FreeLibrary(library);
+}
+
+void* GetSymbol(HMODULE library, const char* name)
+{
+    return reinterpret_cast<void*>(GetProcAddress(library, name));
+}
+
+std::string GetLibraryError()
+{
+    return "error " + std::to_string(GetLastError());
+}
+#else
+void* OpenLibrary(const std::string& path, bool bindNow)
+{
+    return dlopen(path.c_str(), (bindNow ? RTLD_NOW : RTLD_LAZY) | RTLD_LOCAL);
+}
+
+void CloseLibrary(void* library)
+{
+    dlclose(library);
+}
+
+void* GetSymbol(void* library, const char* name)
+{
+    return dlsym(library, name);
+}
+
+std::string GetLibraryError()
+{
+    auto error = dlerror();
+    return error ? error : "unknown error";
+}
+#endif
+
+// Returns the driver library of a GPU runtime, or nullptr for the runtimes that need none
+const char* GetGPURuntimeLibrary(const std::string& runtime)
+{
+#if defined(_WIN32)
+    if (runtime == "cuda") return "nvcuda.dll";
+    if (runtime == "rocm") return "amdhip64.dll";
+    if (runtime == "vulkan") return "vulkan-1.dll";
+    if (runtime == "opencl") return "OpenCL.dll";
+#elif defined(__APPLE__)
+    if (runtime == "vulkan") return "libvulkan.1.dylib";
+    if (runtime == "opencl") return "/System/Library/Frameworks/OpenCL.framework/OpenCL";
+#else
+    if (runtime == "cuda") return "libcuda.so.1";
+    if (runtime == "rocm") return "libamdhip64.so";
+    if (runtime == "vulkan") return "libvulkan.so.1";
+    if (runtime == "opencl") return "libOpenCL.so.1";
+#endif
+    return nullptr;
+}
+
+// Returns the first requirement of the HAT file that the host does not meet, or an empty string
+std::string CheckRequirements(const toml::table& hat)
+{
+    auto required = hat["target"]["required"];
+
+    auto os = ToLower(required["os"].value_or(std::string{}));
+    if (!os.empty() && os != HostOperatingSystem)
+    {
+        return "the package requires the " + os + " OS";
+    }
+
+    auto architecture = ToLower(required["CPU"]["architecture"].value_or(std::string{}));
+    if (!architecture.empty() && std::none_of(std::begin(HostArchitectures), std::end(HostArchitectures), [&](const char* name) { return architecture == name; }))
+    {
+        return "the package requires the " + architecture + " architecture";
+    }
+
+    if (auto extensions = required["CPU"]["extensions"].as_array())
+    {
+        for (auto&& node : *extensions)
+        {
+            // Disabled features ("-name") require nothing, the extensions the runtime does not know are assumed present
+            auto extension = node.value_or(std::string{});
+            if (!extension.empty() && extension[0] != '-' && AcceraHasCPUExtension(extension.c_str()) == 0)
+            {
+                return "the host does not have the " + extension + " CPU extension";
+            }
+        }
+    }
+
+    auto gpuRuntime = ToLower(required["GPU"]["runtime"].value_or(std::string{}));
+    if (auto driver = GetGPURuntimeLibrary(gpuRuntime))
+    {
+        auto library = OpenLibrary(driver, false);
+        if (!library)
+        {
+            return "the package requires the " + gpuRuntime + " runtime, which cannot load " + driver;
+        }
+        CloseLibrary(library);
+    }
+    return {};
+}
+
+void TouchPages(const char* begin, size_t size)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    const size_t pageSize = systemInfo.dwPageSize;
+#else
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    auto first = reinterpret_cast<uintptr_t>(begin) & ~(pageSize - 1);
+    auto last = reinterpret_cast<uintptr_t>(begin) + size;
+
+#if !defined(_WIN32)
+    // Starts the reads of the whole range before the loop below waits on each page
+    madvise(reinterpret_cast<void*>(first), last - first, MADV_WILLNEED);
+#endif
+
+    volatile char sink = 0;
+    for (auto page = first; page < last; page += pageSize)
+    {
+        sink = sink + *reinterpret_cast<const volatile char*>(std::max(page, reinterpret_cast<uintptr_t>(begin)));
+    }
+}
+
+#if defined(__linux__)
+int PrefaultSegments(dl_phdr_info* info, size_t, void* data)
+{
+    if (info->dlpi_addr != *static_cast<ElfW(Addr)*>(data))
+    {
+        return 0;
+    }
+
+    // The data segments, which hold the constant globals and the read-only data of the library
+    for (int index = 0; index < info->dlpi_phnum; ++index)
+    {
+        const auto& header = info->dlpi_phdr[index];
+        if (header.p_type == PT_LOAD && !(header.p_flags & PF_X) && header.p_memsz > 0)
+        {
+            TouchPages(reinterpret_cast<const char*>(info->dlpi_addr + header.p_vaddr), header.p_memsz);
+        }
+    }
+    return 1;
+}
+#endif
+
+void PrefaultConstantData(AcceraHATPackage& package)
+{
+#if defined(_WIN32)
+    auto base = reinterpret_cast<const char*>(package.library);
+    auto dosHeader = reinterpret_cast<const IMAGE_DOS_HEADER*>(base);
+    auto ntHeaders = reinterpret_cast<const IMAGE_NT_HEADERS*>(base + dosHeader->e_lfanew);
+    auto section = IMAGE_FIRST_SECTION(ntHeaders);
+    for (WORD index = 0; index < ntHeaders->FileHeader.NumberOfSections; ++index, ++section)
+    {
+        if (!(section->Characteristics & IMAGE_SCN_MEM_EXECUTE) && (section->Characteristics & IMAGE_SCN_MEM_READ) && section->Misc.VirtualSize > 0)
+        {
+            TouchPages(base + section->VirtualAddress, section->Misc.VirtualSize);
+        }
+    }
+#elif defined(__linux__)
+    link_map* map = nullptr;
+    if (dlinfo(package.library, RTLD_DI_LINKMAP, &map) == 0 && map)
+    {
+        ElfW(Addr) base = map->l_addr;
+        dl_iterate_phdr(PrefaultSegments, &base);
+    }
+#else
+    // The segments of a library are not enumerated on other platforms, where its pages are faulted on first use
+    (void)package;
+#endif
+}
+
+void* ResolveFunction(AcceraHATPackage& package, const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(package.functionsMutex);
+    auto it = package.functions.find(name);
+    if (it != package.functions.end())
+    {
+        return it->second;
+    }
+
+    auto function = GetSymbol(package.library, name.c_str());
+    if (function)
+    {
+        package.functions.emplace(name, function);
+    }
+    return function;
+}
+
+// Returns the size of the elements of the argument of a function of the HAT file, or 0 if it is unknown
+int64_t GetArgumentElementSize(const toml::table& hat, const char* function, size_t argument)
+{
+    static const std::unordered_map<std::string, int64_t> elementSizes = {
+        { "bool", 1 },
+        { "int8_t", 1 },
+        { "uint8_t", 1 },
+        { "int16_t", 2 },
+        { "uint16_t", 2 },
+        { "float16_t", 2 },
+        { "bfloat16_t", 2 },
+        { "int32_t", 4 },
+        { "uint32_t", 4 },
+        { "float", 4 },
+        { "int64_t", 8 },
+        { "uint64_t", 8 },
+        { "double", 8 },
+    };
+
+    auto elementType = hat["functions"][function]["arguments"][argument]["element_type"].value_or(std::string{});
+    auto it = elementSizes.find(elementType);
+    return it == elementSizes.end() ? 0 : it->second;
+}
+
+void* AllocatePackedBuffer(size_t sizeInBytes)
+{
+    // Rounded up to the alignment, which aligned_alloc requires of the size
+    sizeInBytes = (std::max<size_t>(sizeInBytes, 1) + PackedBufferAlignment - 1) & ~(PackedBufferAlignment - 1);
+#if defined(_WIN32)
+    return _aligned_malloc(sizeInBytes, PackedBufferAlignment);
+#else
+    return std::aligned_alloc(PackedBufferAlignment, sizeInBytes);
+#endif
+}
+
+using PackingFunction = void (*)(const void* input, void* packed);
+using PackedSizeFunction = int64_t (*)();
+
+struct PackingCall
+{
+    PackingFunction function;
+    const void* input;
+    void* packed;
+};
+
+void RunPackingCall(void* context)
+{
+    auto call = static_cast<PackingCall*>(context);
+    call->function(call->input, call->packed);
+    delete call;
+}
+} // namespace
+
+AcceraHATPackage* AcceraHATLoad(const char* hatPath, int32_t flags, char* error, int64_t errorSize)
+{
+    if (!hatPath)
+    {
+        SetError(error, errorSize, "no HAT file");
+        return nullptr;
+    }
+
+    auto package = std::make_unique<AcceraHATPackage>();
+    try
+    {
+        // A HAT file is both a C header and a TOML file, whose C parts are in TOML comments and strings
+        package->hat = toml::parse_file(hatPath);
+    }
+    catch (const toml::parse_error& e)
+    {
+        SetError(error, errorSize, std::string{ hatPath } + ": " + std::string{ e.description() });
+        return nullptr;
+    }
+
+    auto unmetRequirement = CheckRequirements(package->hat);
+    if (!unmetRequirement.empty())
+    {
+        SetError(error, errorSize, std::string{ hatPath } + ": " + unmetRequirement);
+        return nullptr;
+    }
+
+    auto linkTarget = package->hat["dependencies"]["link_target"].value_or(std::string{});
+    if (linkTarget.empty())
+    {
+        SetError(error, errorSize, std::string{ hatPath } + ": the package has no link target");
+        return nullptr;
+    }
+
+    auto libraryPath = GetDirectory(hatPath) + linkTarget;
+    const bool eager = flags & AcceraHATLoadEager;
+    package->library = OpenLibrary(libraryPath, eager);
+    if (!package->library)
+    {
+        SetError(error, errorSize, "cannot load " + libraryPath + ": " + GetLibraryError());
+        return nullptr;
+    }
+
+    if (eager)
+    {
+        if (auto functions = package->hat["functions"].as_table())
+        {
+            for (auto&& entry : *functions)
+            {
+                const std::string& name = entry.first.str();
+                if (!ResolveFunction(*package, name))
+                {
+                    SetError(error, errorSize, libraryPath + " does not define the function " + name);
+                    CloseLibrary(package->library);
+                    return nullptr;
+                }
+            }
+        }
+    }
+
+    if (flags & AcceraHATLoadPrefault)
+    {
+        PrefaultConstantData(*package);
+    }
+    return package.release();
+}
+
+void AcceraHATUnload(AcceraHATPackage* package)
+{
+    if (package)
+    {
+        CloseLibrary(package->library);
+        delete package;
+    }
+}
+
+void* AcceraHATGetFunction(AcceraHATPackage* package, const char* name)
+{
+    return package && name ? ResolveFunction(*package, name) : nullptr;
+}
+
+int64_t AcceraHATPackAsync(AcceraHATPackage* package, const char* packingFunction, const char* sizeFunction, const void* input, void** packedBuffer)
+{
+    auto pack = reinterpret_cast<PackingFunction>(AcceraHATGetFunction(package, packingFunction));
+    auto getPackedSize = reinterpret_cast<PackedSizeFunction>(AcceraHATGetFunction(package, sizeFunction));
+    auto elementSize = pack ? GetArgumentElementSize(package->hat, packingFunction, 1) : 0;
+    if (!pack || !getPackedSize || elementSize == 0 || !packedBuffer)
+    {
+        return -1;
+    }
+
+    auto packed = AllocatePackedBuffer(static_cast<size_t>(getPackedSize() * elementSize));
+    if (!packed)
+    {
+        return -1;
+    }
+
+    *packedBuffer = packed;
+    return AcceraAsyncLaunch(RunPackingCall, new PackingCall{ pack, input, packed });
+}
+
+void AcceraHATFreePacked(void* packedBuffer)
+{
+#if defined(_WIN32)
+    _aligned_free(packedBuffer);
+#else
+    std::free(packedBuffer);
+#endif
+}
@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//
+//  Lazily allocated static buffers that are backed by huge pages to reduce TLB misses
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "HugePages.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+
+namespace
+{
+constexpr int64_t HugePageSize = int64_t{ 2 } << 20;
+[[maybe_unused]] constexpr int64_t GiganticPageSize = int64_t{ 1 } << 30;
+
+// Serializes the first use of each buffer, later uses only read the handle
+std::mutex AllocationMutex;
+
+std::atomic<void*>* GetAtomicHandle(void** handle)
+{
+    static_assert(sizeof(std::atomic<void*>) == sizeof(void*), "std::atomic<void*> must have the layout of void*");
+    return reinterpret_cast<std::atomic<void*>*>(handle);
+}
+
+int64_t RoundUp(int64_t value, int64_t multiple)
+{
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+#if defined(_WIN32)
+void* AllocateHugePages(int64_t sizeInBytes)
+{
+    // Large pages need the SeLockMemoryPrivilege, without it the buffer falls back to ordinary pages
+    if (auto largePageSize = static_cast<int64_t>(GetLargePageMinimum()); largePageSize > 0)
+    {
+        if (auto data = VirtualAlloc(nullptr, static_cast<SIZE_T>(RoundUp(sizeInBytes, largePageSize)), MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE))
+        {
+            return data;
+        }
+    }
+    return VirtualAlloc(nullptr, static_cast<SIZE_T>(sizeInBytes), MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+}
+#else
+#if defined(MAP_HUGETLB)
+void* MapHugeTLBPages(int64_t sizeInBytes, int64_t pageSize)
+{
+#if defined(MAP_HUGE_SHIFT)
+    auto pageSizeFlag = (pageSize == GiganticPageSize ? 30 : 21) << MAP_HUGE_SHIFT;
+#else
+    auto pageSizeFlag = 0;
+#endif
+    auto data = mmap(nullptr, static_cast<size_t>(RoundUp(sizeInBytes, pageSize)), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | pageSizeFlag, -1, 0);
+    return data == MAP_FAILED ? nullptr : data;
+}
+#endif
+
+void* AllocateHugePages(int64_t sizeInBytes)
+{
+#if defined(MAP_HUGETLB)
+    // Explicit huge pages only exist when the system reserved a pool of them, e.g. with vm.nr_hugepages
+    if (sizeInBytes >= GiganticPageSize)
+    {
+        if (auto data = MapHugeTLBPages(sizeInBytes, GiganticPageSize))
+        {
+            return data;
+        }
+    }
+    if (auto data = MapHugeTLBPages(sizeInBytes, HugePageSize))
+    {
+        return data;
+    }
+#endif
+
+    // Otherwise map a 2MB-aligned range so that the kernel can back it with transparent huge pages
+    auto alignedSize = RoundUp(sizeInBytes, HugePageSize);
+    auto mappedSize = static_cast<size_t>(alignedSize + HugePageSize);
+    auto mapped = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapped == MAP_FAILED)
+    {
+        return nullptr;
+    }
+    auto start = reinterpret_cast<uintptr_t>(mapped);
+    auto alignedStart = static_cast<uintptr_t>(RoundUp(static_cast<int64_t>(start), HugePageSize));
+    if (alignedStart > start)
+    {
+        munmap(mapped, alignedStart - start);
+    }
+    if (auto tail = start + mappedSize - (alignedStart + alignedSize); tail > 0)
+    {
+        munmap(reinterpret_cast<void*>(alignedStart + alignedSize), tail);
+    }
+    auto data = reinterpret_cast<void*>(alignedStart);
+#if defined(MADV_HUGEPAGE)
+    (void)madvise(data, static_cast<size_t>(alignedSize), MADV_HUGEPAGE);
+#endif
+    return data;
+}
+#endif
+} // namespace
+
+void* AcceraAllocateHugePages(void** handle, int64_t sizeInBytes)
+{
+    auto atomicHandle = GetAtomicHandle(handle);
+    if (auto data = atomicHandle->load(std::memory_order_acquire))
+    {
+        return data;
+    }
+
+    std::lock_guard<std::mutex> lock(AllocationMutex);
+    if (auto data = atomicHandle->load(std::memory_order_relaxed))
+    {
+        return data;
+    }
+
+    // The buffer lives until the process exits, like the static buffer it replaces
+    auto data = AllocateHugePages(sizeInBytes);
+    if (!data)
+    {
+        std::fprintf(stderr, "Accera: cannot allocate a buffer of %lld bytes\n", static_cast<long long>(sizeInBytes));
+        std::abort();
+    }
+    atomicHandle->store(data, std::memory_order_release);
+    return data;
+}
@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//
+//  Lazily memory-mapped packed buffers that are deployed as files next to the generated library
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "MappedBuffer.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+
+namespace
+{
+const char* MappedBufferDirectoryEnvironmentVariable = "ACCERA_MAPPED_BUFFER_DIR";
+
+#if defined(_WIN32)
+const char PathSeparator = '\\';
+#else
+const char PathSeparator = '/';
+#endif
+
+// Serializes the first use of each mapping, later uses only read the handle
+std::mutex MappingMutex;
+
+std::atomic<void*>* GetAtomicHandle(void** handle)
+{
+    static_assert(sizeof(std::atomic<void*>) == sizeof(void*), "std::atomic<void*> must have the layout of void*");
+    return reinterpret_cast<std::atomic<void*>*>(handle);
+}
+
+[[noreturn]] void FailToMap(const std::string& path, const char* reason)
+{
+    std::fprintf(stderr, "Accera: cannot map packed buffer file %s: %s\n", path.c_str(), reason);
+    std::abort();
+}
+
+// Returns the directory of the library that contains the given address, including the trailing separator
+std::string GetModuleDirectory(const void* address)
+{
+    std::string modulePath;
+#if defined(_WIN32)
+    HMODULE module = nullptr;
+    if (GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, static_cast<LPCSTR>(address), &module))
+    {
+        char buffer[MAX_PATH];
+        auto length = GetModuleFileNameA(module, buffer, MAX_PATH);
+        if (length > 0 && length < MAX_PATH)
+        {
+            modulePath.assign(buffer, length);
+        }
+    }
+    auto separator = modulePath.find_last_of("\\/");
+#else
+    Dl_info info;
+    if (dladdr(address, &info) && info.dli_fname)
+    {
+        modulePath = info.dli_fname;
+    }
+    auto separator = modulePath.find_last_of(PathSeparator);
+#endif
+    return separator == std::string::npos ? std::string{} : modulePath.substr(0, separator + 1);
+}
+
+std::string GetMappedBufferPath(void** handle, const char* fileName)
+{
+    if (auto directory = std::getenv(MappedBufferDirectoryEnvironmentVariable); directory && *directory)
+    {
+        return std::string(directory) + PathSeparator + fileName;
+    }
+    return GetModuleDirectory(handle) + fileName;
+}
+
+void* MapFile(const std::string& path, int64_t sizeInBytes)
+{
+#if defined(_WIN32)
+    auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        FailToMap(path, "the file cannot be opened");
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < sizeInBytes)
+    {
+        CloseHandle(file);
+        FailToMap(path, "the file is smaller than the packed buffer");
+    }
+    auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping)
+    {
+        FailToMap(path, "the file cannot be mapped");
+    }
+
+    // The view keeps the mapping object alive after its handle is closed
+    auto data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, static_cast<SIZE_T>(sizeInBytes));
+    CloseHandle(mapping);
+    if (!data)
+    {
+        FailToMap(path, "the file cannot be mapped");
+    }
+    return data;
+#else
+    auto file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        FailToMap(path, "the file cannot be opened");
+    }
+    struct stat fileStat;
+    if (fstat(file, &fileStat) != 0 || fileStat.st_size < sizeInBytes)
+    {
+        close(file);
+        FailToMap(path, "the file is smaller than the packed buffer");
+    }
+
+    // The mapping keeps the file alive after its descriptor is closed
+    auto data = mmap(nullptr, static_cast<size_t>(sizeInBytes), PROT_READ, MAP_SHARED, file, 0);
+    close(file);
+    if (data == MAP_FAILED)
+    {
+        FailToMap(path, "the file cannot be mapped");
+    }
+    return data;
+#endif
+}
+} // namespace
+
+void* AcceraMapPackedBuffer(void** handle, const char* fileName, int64_t sizeInBytes)
+{
+    auto atomicHandle = GetAtomicHandle(handle);
+    if (auto data = atomicHandle->load(std::memory_order_acquire))
+    {
+        return data;
+    }
+
+    std::lock_guard<std::mutex> lock(MappingMutex);
+    if (auto data = atomicHandle->load(std::memory_order_relaxed))
+    {
+        return data;
+    }
+
+    // The mapping lives until the process exits, like the constant data of the library it replaces
+    auto data = MapFile(GetMappedBufferPath(handle, fileName), sizeInBytes);
+    atomicHandle->store(data, std::memory_order_release);
+    return data;
+}
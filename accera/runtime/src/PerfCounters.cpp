@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//
+//  Hardware performance counters of the calling thread, read by the profile regions of generated code
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "PerfCounters.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+#if defined(__linux__)
+struct PerfEvent
+{
+    uint32_t type;
+    uint64_t config;
+};
+
+// The generic events of each counter, which the kernel maps to the events of the CPU
+constexpr PerfEvent PerfEvents[AcceraPerfCounterCount] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+};
+
+class CounterGroup
+{
+public:
+    ~CounterGroup()
+    {
+        Close();
+    }
+
+    void Read(int32_t eventMask, int64_t* values)
+    {
+        if (eventMask != _eventMask)
+        {
+            Open(eventMask);
+        }
+
+        for (int counter = 0; counter < AcceraPerfCounterCount; ++counter)
+        {
+            if (eventMask & (1 << counter))
+            {
+                values[counter] = 0;
+            }
+        }
+        if (_fds.empty())
+        {
+            return;
+        }
+
+        // PERF_FORMAT_GROUP reads the number of counters followed by their values, in the order they were opened
+        std::vector<uint64_t> buffer(_fds.size() + 1);
+        auto size = static_cast<ssize_t>(buffer.size() * sizeof(uint64_t));
+        if (read(_fds.front(), buffer.data(), size) != size)
+        {
+            return;
+        }
+        for (size_t i = 0; i < _counters.size(); ++i)
+        {
+            values[_counters[i]] = static_cast<int64_t>(buffer[i + 1]);
+        }
+    }
+
+private:
+    void Open(int32_t eventMask)
+    {
+        Close();
+        _eventMask = eventMask;
+
+        for (int counter = 0; counter < AcceraPerfCounterCount; ++counter)
+        {
+            if (!(eventMask & (1 << counter)))
+            {
+                continue;
+            }
+
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = PerfEvents[counter].type;
+            attr.config = PerfEvents[counter].config;
+            attr.read_format = PERF_FORMAT_GROUP;
+            attr.disabled = _fds.empty() ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+
+            auto groupFd = _fds.empty() ? -1 : _fds.front();
+            auto fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0));
+            if (fd < 0)
+            {
+                // e.g. the CPU lacks the event or perf_event_paranoid forbids it, the counter reads as 0
+                continue;
+            }
+            _fds.push_back(fd);
+            _counters.push_back(counter);
+        }
+
+        if (!_fds.empty())
+        {
+            ioctl(_fds.front(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(_fds.front(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+    }
+
+    void Close()
+    {
+        for (auto fd : _fds)
+        {
+            close(fd);
+        }
+        _fds.clear();
+        _counters.clear();
+        _eventMask = 0;
+    }
+
+    int32_t _eventMask = 0;
+    std::vector<int> _fds;
+    std::vector<int> _counters;
+};
+
+// perf_event_open counts the thread that opens the counters, so each thread has its own group
+thread_local CounterGroup Counters;
+#endif
+} // namespace
+
+void AcceraReadPerfCounters(int32_t eventMask, int64_t* values)
+{
+#if defined(__linux__)
+    Counters.Read(eventMask, values);
+#else
+    for (int counter = 0; counter < AcceraPerfCounterCount; ++counter)
+    {
+        if (eventMask & (1 << counter))
+        {
+            values[counter] = 0;
+        }
+    }
+#endif
+}
@@ -0,0 +1,770 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//
+//  Nested, per-thread profile regions that the profiling code of generated libraries records into
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ProfileRegions.h"
+#include "PerfCounters.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+const char* const CounterNames[AcceraPerfCounterCount] = { "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses" };
+
+// Each thread keeps the events of its first regions for the trace, the totals of the regions are kept regardless
+constexpr size_t MaxTraceEventsPerThread = 1 << 18;
+
+struct RegionEvent
+{
+    int32_t node;
+    double start;
+    double duration;
+    int64_t counters[AcceraPerfCounterCount];
+};
+
+struct MemoryTraffic
+{
+    int64_t loadedBytes = 0;
+    int64_t storedBytes = 0;
+};
+
+struct RegionNode
+{
+    int32_t region = -1; // the root of a tree is not a region
+    int32_t parent = -1;
+    int64_t count = 0;
+    double time = 0;
+    double childTime = 0;
+    int64_t counters[AcceraPerfCounterCount] = {};
+    std::vector<MemoryTraffic> traffic; // indexed by the id of the array, see AcceraCountMemoryTraffic
+    std::vector<int32_t> children;
+
+    // The values when the region was last entered
+    double start = 0;
+    int64_t countersStart[AcceraPerfCounterCount] = {};
+};
+
+// The tree of the regions a thread entered, nodes[0] is the root, which holds the memory traffic outside of the regions
+struct RegionTree
+{
+    RegionTree()
+    {
+        nodes.emplace_back();
+    }
+
+    int32_t GetChild(int32_t parent, int32_t region)
+    {
+        for (auto child : nodes[parent].children)
+        {
+            if (nodes[child].region == region)
+            {
+                return child;
+            }
+        }
+        auto child = static_cast<int32_t>(nodes.size());
+        nodes.emplace_back();
+        nodes[child].region = region;
+        nodes[child].parent = parent;
+        nodes[parent].children.push_back(child);
+        return child;
+    }
+
+    std::vector<RegionNode> nodes;
+    int32_t current = 0;
+    int32_t counterMask = 0;
+    bool cycleCounter = false;
+
+    std::vector<RegionEvent> events;
+    int64_t droppedEvents = 0;
+};
+
+// Threads only take the lock the first time they enter a region and the first time each region is entered, the
+// trees outlive their threads so that the regions of thread pools are printed after the pool is gone
+std::mutex RegistryMutex;
+std::deque<std::string> RegionNames; // a deque so that the names returned by AcceraGetProfileRecords stay valid
+std::unordered_map<std::string, int32_t> RegionIds;
+std::deque<std::string> ArrayNames;
+std::unordered_map<std::string, int32_t> ArrayIds;
+std::vector<std::unique_ptr<RegionTree>> ThreadTrees;
+
+RegionTree& GetThreadTree()
+{
+    thread_local RegionTree* tree = nullptr;
+    if (!tree)
+    {
+        std::lock_guard<std::mutex> lock(RegistryMutex);
+        ThreadTrees.push_back(std::make_unique<RegionTree>());
+        tree = ThreadTrees.back().get();
+    }
+    return *tree;
+}
+
+std::atomic<int64_t>* GetAtomicHandle(int64_t* handle)
+{
+    static_assert(sizeof(std::atomic<int64_t>) == sizeof(int64_t), "std::atomic<int64_t> must have the layout of int64_t");
+    return reinterpret_cast<std::atomic<int64_t>*>(handle);
+}
+
+// The handle holds the id + 1, so that 0 is an unregistered region or array
+int32_t RegisterName(int64_t* handle, const char* name, std::deque<std::string>& names, std::unordered_map<std::string, int32_t>& ids)
+{
+    auto atomicHandle = GetAtomicHandle(handle);
+    if (auto id = atomicHandle->load(std::memory_order_acquire))
+    {
+        return static_cast<int32_t>(id - 1);
+    }
+
+    std::lock_guard<std::mutex> lock(RegistryMutex);
+    auto [it, inserted] = ids.try_emplace(name, static_cast<int32_t>(names.size()));
+    if (inserted)
+    {
+        names.push_back(name);
+    }
+    atomicHandle->store(it->second + 1, std::memory_order_release);
+    return it->second;
+}
+
+int32_t RegisterRegion(int64_t* handle, const char* name)
+{
+    return RegisterName(handle, name, RegionNames, RegionIds);
+}
+
+void AddTraffic(std::vector<MemoryTraffic>& target, const std::vector<MemoryTraffic>& source)
+{
+    if (target.size() < source.size())
+    {
+        target.resize(source.size());
+    }
+    for (size_t array = 0; array < source.size(); ++array)
+    {
+        target[array].loadedBytes += source[array].loadedBytes;
+        target[array].storedBytes += source[array].storedBytes;
+    }
+}
+
+bool HasTraffic(const MemoryTraffic& traffic)
+{
+    return traffic.loadedBytes != 0 || traffic.storedBytes != 0;
+}
+
+// The frequency of the timestamp counter, measured against the steady clock, or 0 where it can't be read
+double GetCycleCounterFrequency()
+{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    auto startTime = std::chrono::steady_clock::now();
+    auto startCycles = __rdtsc();
+    while (std::chrono::steady_clock::now() - startTime < std::chrono::milliseconds(20))
+    {
+    }
+    auto cycles = __rdtsc() - startCycles;
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - startTime;
+    return static_cast<double>(cycles) / seconds.count();
+#else
+    return 0;
+#endif
+}
+
+// The seconds per unit of the timestamps of a tree, timestamps of the timestamp counter stay in cycles when its
+// frequency is unknown
+double GetSecondsPerTick(const RegionTree& tree)
+{
+    static const double cycleCounterFrequency = GetCycleCounterFrequency();
+    return tree.cycleCounter && cycleCounterFrequency > 0 ? 1 / cycleCounterFrequency : 1;
+}
+
+bool HasUnconvertedCycles()
+{
+    for (auto& tree : ThreadTrees)
+    {
+        if (tree->cycleCounter && GetSecondsPerTick(*tree) == 1)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Adds the regions of a tree to the merged tree, in seconds
+void MergeTree(const RegionTree& tree, int32_t node, RegionTree& merged, int32_t mergedNode, double secondsPerTick)
+{
+    AddTraffic(merged.nodes[mergedNode].traffic, tree.nodes[node].traffic);
+    for (auto child : tree.nodes[node].children)
+    {
+        auto& source = tree.nodes[child];
+        auto mergedChild = merged.GetChild(mergedNode, source.region);
+        auto& target = merged.nodes[mergedChild];
+        target.count += source.count;
+        target.time += source.time * secondsPerTick;
+        target.childTime += source.childTime * secondsPerTick;
+        for (int counter = 0; counter < AcceraPerfCounterCount; ++counter)
+        {
+            target.counters[counter] += source.counters[counter];
+        }
+        MergeTree(tree, child, merged, mergedChild, secondsPerTick);
+    }
+}
+
+void PrintTraffic(const RegionNode& region, int depth)
+{
+    for (size_t array = 0; array < region.traffic.size(); ++array)
+    {
+        auto& traffic = region.traffic[array];
+        if (HasTraffic(traffic))
+        {
+            std::printf("%*s[%s]\tloaded=%lld\tstored=%lld\n",
+                        2 * depth,
+                        "",
+                        ArrayNames[array].c_str(),
+                        static_cast<long long>(traffic.loadedBytes),
+                        static_cast<long long>(traffic.storedBytes));
+        }
+    }
+}
+
+void PrintTree(const RegionTree& tree, int32_t node, int depth, double secondsPerTick)
+{
+    for (auto child : tree.nodes[node].children)
+    {
+        auto& region = tree.nodes[child];
+        std::printf("%*s%s\t%lld\t%f\t%f",
+                    2 * depth,
+                    "",
+                    RegionNames[region.region].c_str(),
+                    static_cast<long long>(region.count),
+                    region.time * secondsPerTick,
+                    (region.time - region.childTime) * secondsPerTick);
+        for (int counter = 0; counter < AcceraPerfCounterCount; ++counter)
+        {
+            if (tree.counterMask & (1 << counter))
+            {
+                std::printf("\t%s=%lld", CounterNames[counter], static_cast<long long>(region.counters[counter]));
+            }
+        }
+        std::printf("\n");
+        PrintTraffic(region, depth + 1);
+        PrintTree(tree, child, depth + 1, secondsPerTick);
+    }
+}
+
+void AppendFormat(std::string& output, const char* format, ...)
+{
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    auto length = std::vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length < 0)
+    {
+        return;
+    }
+    if (static_cast<size_t>(length) < sizeof(buffer))
+    {
+        output.append(buffer, length);
+        return;
+    }
+
+    std::vector<char> largeBuffer(length + 1);
+    va_start(args, format);
+    std::vsnprintf(largeBuffer.data(), largeBuffer.size(), format, args);
+    va_end(args);
+    output.append(largeBuffer.data(), length);
+}
+
+void AppendJsonString(std::string& output, const std::string& value)
+{
+    output += '"';
+    for (auto c : value)
+    {
+        if (c == '"' || c == '\\')
+        {
+            output += '\\';
+            output += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            AppendFormat(output, "\\u%04x", static_cast<unsigned>(c));
+        }
+        else
+        {
+            output += c;
+        }
+    }
+    output += '"';
+}
+
+void AppendCsvField(std::string& output, const std::string& value)
+{
+    if (value.find_first_of(",\"\n") == std::string::npos)
+    {
+        output += value;
+        return;
+    }
+    output += '"';
+    for (auto c : value)
+    {
+        if (c == '"')
+        {
+            output += '"';
+        }
+        output += c;
+    }
+    output += '"';
+}
+
+// The names of the regions from the outermost one to the node, separated by '/'
+std::string GetRegionPath(const RegionTree& tree, int32_t node)
+{
+    std::string path = RegionNames[tree.nodes[node].region];
+    for (auto parent = tree.nodes[node].parent; parent > 0; parent = tree.nodes[parent].parent)
+    {
+        path = RegionNames[tree.nodes[parent].region] + "/" + path;
+    }
+    return path;
+}
+
+// Chrome trace event format, see https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+std::string FormatTrace()
+{
+    // The trace starts at the first event
+    auto origin = std::numeric_limits<double>::max();
+    for (auto& tree : ThreadTrees)
+    {
+        if (!tree->events.empty())
+        {
+            origin = std::min(origin, tree->events.front().start * GetSecondsPerTick(*tree));
+        }
+    }
+
+    std::string output = "{\"traceEvents\": [";
+    const char* separator = "\n";
+    int64_t droppedEvents = 0;
+    for (size_t thread = 0; thread < ThreadTrees.size(); ++thread)
+    {
+        auto& tree = *ThreadTrees[thread];
+        auto secondsPerTick = GetSecondsPerTick(tree);
+        droppedEvents += tree.droppedEvents;
+
+        AppendFormat(output, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %zu, \"args\": {\"name\": \"thread %zu\"}}", separator, thread, thread);
+        separator = ",\n";
+        for (auto& event : tree.events)
+        {
+            output += separator;
+            output += "{\"name\": ";
+            AppendJsonString(output, RegionNames[tree.nodes[event.node].region]);
+            AppendFormat(output,
+                         ", \"cat\": \"accera\", \"ph\": \"X\", \"pid\": 0, \"tid\": %zu, \"ts\": %.3f, \"dur\": %.3f",
+                         thread,
+                         (event.start * secondsPerTick - origin) * 1e6,
+                         event.duration * secondsPerTick * 1e6);
+            if (tree.counterMask)
+            {
+                const char* argSeparator = "";
+                output += ", \"args\": {";
+                for (int counter = 0; counter < AcceraPerfCounterCount; ++counter)
+                {
+                    if (tree.counterMask & (1 << counter))
+                    {
+                        AppendFormat(output, "%s\"%s\": %lld", argSeparator, CounterNames[counter], static_cast<long long>(event.counters[counter]));
+                        argSeparator = ", ";
+                    }
+                }
+                output += "}";
+            }
+            output += "}";
+        }
+    }
+    AppendFormat(output, "\n], \"displayTimeUnit\": \"ns\", \"otherData\": {\"dropped_events\": %lld}}\n", static_cast<long long>(droppedEvents));
+    return output;
+}
+
+void FormatCounters(std::string& output, const RegionTree& tree, int32_t node, const char* thread, double secondsPerTick)
+{
+    for (auto child : tree.nodes[node].children)
+    {
+        auto& region = tree.nodes[child];
+        output += thread;
+        output += ',';
+        AppendCsvField(output, GetRegionPath(tree, child));
+        AppendFormat(output, ",%lld,%.9g,%.9g", static_cast<long long>(region.count), region.time * secondsPerTick, (region.time - region.childTime) * secondsPerTick);
+        for (auto value : region.counters)
+        {
+            AppendFormat(output, ",%lld", static_cast<long long>(value));
+        }
+        output += '\n';
+        FormatCounters(output, tree, child, thread, secondsPerTick);
+    }
+}
+
+// One row per region of each thread and of the merged tree, whose thread is "all"
+std::string FormatCounters()
+{
+    std::string output = "thread,region,count,total_seconds,self_seconds";
+    for (auto name : CounterNames)
+    {
+        output += ',';
+        output += name;
+    }
+    output += '\n';
+
+    RegionTree merged;
+    for (size_t thread = 0; thread < ThreadTrees.size(); ++thread)
+    {
+        auto& tree = *ThreadTrees[thread];
+        FormatCounters(output, tree, 0, std::to_string(thread).c_str(), GetSecondsPerTick(tree));
+        MergeTree(tree, 0, merged, 0, GetSecondsPerTick(tree));
+    }
+    FormatCounters(output, merged, 0, "all", 1);
+    return output;
+}
+
+void AddRecords(const RegionTree& tree, int32_t node, int32_t thread, int32_t parentRecord, double secondsPerTick, AcceraProfileRecord* records, int64_t capacity, int64_t& count)
+{
+    for (auto child : tree.nodes[node].children)
+    {
+        auto& region = tree.nodes[child];
+        auto index = count++;
+        if (index < capacity)
+        {
+            auto& record = records[index];
+            record.thread = thread;
+            record.parent = parentRecord;
+            record.name = RegionNames[region.region].c_str();
+            record.count = region.count;
+            record.totalSeconds = region.time * secondsPerTick;
+            record.selfSeconds = (region.time - region.childTime) * secondsPerTick;
+            std::copy(std::begin(region.counters), std::end(region.counters), record.counters);
+        }
+        AddRecords(tree, child, thread, static_cast<int32_t>(index), secondsPerTick, records, capacity, count);
+    }
+}
+
+void AddTrafficRecords(const RegionNode& region, int32_t thread, int32_t regionRecord, AcceraMemoryTrafficRecord* records, int64_t capacity, int64_t& count)
+{
+    for (size_t array = 0; array < region.traffic.size(); ++array)
+    {
+        auto& traffic = region.traffic[array];
+        if (!HasTraffic(traffic))
+        {
+            continue;
+        }
+        auto index = count++;
+        if (index < capacity)
+        {
+            auto& record = records[index];
+            record.thread = thread;
+            record.region = regionRecord;
+            record.array = ArrayNames[array].c_str();
+            record.loadedBytes = traffic.loadedBytes;
+            record.storedBytes = traffic.storedBytes;
+        }
+    }
+}
+
+// Follows the order of AddRecords, so that the regions of the traffic records are the indices of the profile records
+void AddTrafficRecords(const RegionTree& tree, int32_t node, int32_t thread, int64_t& regionCount, AcceraMemoryTrafficRecord* records, int64_t capacity, int64_t& count)
+{
+    for (auto child : tree.nodes[node].children)
+    {
+        auto regionRecord = static_cast<int32_t>(regionCount++);
+        AddTrafficRecords(tree.nodes[child], thread, regionRecord, records, capacity, count);
+        AddTrafficRecords(tree, child, thread, regionCount, records, capacity, count);
+    }
+}
+
+void FormatTraffic(std::string& output, const RegionTree& tree, int32_t node, const char* thread)
+{
+    auto& region = tree.nodes[node];
+    for (size_t array = 0; array < region.traffic.size(); ++array)
+    {
+        auto& traffic = region.traffic[array];
+        if (!HasTraffic(traffic))
+        {
+            continue;
+        }
+        output += thread;
+        output += ',';
+        AppendCsvField(output, node > 0 ? GetRegionPath(tree, node) : std::string{});
+        output += ',';
+        AppendCsvField(output, ArrayNames[array]);
+        AppendFormat(output, ",%lld,%lld\n", static_cast<long long>(traffic.loadedBytes), static_cast<long long>(traffic.storedBytes));
+    }
+    for (auto child : region.children)
+    {
+        FormatTraffic(output, tree, child, thread);
+    }
+}
+
+// One row per array of each region of each thread and of the merged tree, whose thread is "all". The traffic outside
+// of the regions has an empty region.
+std::string FormatTraffic()
+{
+    std::string output = "thread,region,array,loaded_bytes,stored_bytes\n";
+    RegionTree merged;
+    for (size_t thread = 0; thread < ThreadTrees.size(); ++thread)
+    {
+        auto& tree = *ThreadTrees[thread];
+        FormatTraffic(output, tree, 0, std::to_string(thread).c_str());
+        MergeTree(tree, 0, merged, 0, GetSecondsPerTick(tree));
+    }
+    FormatTraffic(output, merged, 0, "all");
+    return output;
+}
+
+// snprintf semantics: the output is truncated to fit the buffer and null-terminated, the full length is returned
+int64_t CopyToBuffer(const std::string& output, char* buffer, int64_t size)
+{
+    if (buffer && size > 0)
+    {
+        auto length = std::min(static_cast<int64_t>(output.size()), size - 1);
+        std::memcpy(buffer, output.data(), length);
+        buffer[length] = '\0';
+    }
+    return static_cast<int64_t>(output.size());
+}
+
+int32_t WriteToFile(const std::string& output, const char* path)
+{
+    auto file = std::fopen(path, "wb");
+    if (!file)
+    {
+        return -1;
+    }
+    auto written = std::fwrite(output.data(), 1, output.size(), file);
+    auto closed = std::fclose(file);
+    return written == output.size() && closed == 0 ? 0 : -1;
+}
+} // namespace
+
+void AcceraEnterProfileRegion(int64_t* handle, const char* name, double timestamp, int32_t counterMask, int32_t cycleCounter)
+{
+    auto region = RegisterRegion(handle, name);
+    auto& tree = GetThreadTree();
+    auto node = tree.GetChild(tree.current, region);
+    tree.current = node;
+    tree.counterMask |= counterMask;
+    tree.cycleCounter = cycleCounter != 0;
+
+    auto& regionNode = tree.nodes[node];
+    regionNode.start = timestamp;
+    if (counterMask)
+    {
+        AcceraReadPerfCounters(counterMask, regionNode.countersStart);
+    }
+}
+
+void AcceraExitProfileRegion(int64_t* handle, double timestamp, int32_t counterMask)
+{
+    auto id = GetAtomicHandle(handle)->load(std::memory_order_acquire);
+    if (id == 0)
+    {
+        return;
+    }
+    auto region = static_cast<int32_t>(id - 1);
+
+    auto& tree = GetThreadTree();
+    auto node = tree.current;
+    while (node > 0 && tree.nodes[node].region != region)
+    {
+        node = tree.nodes[node].parent;
+    }
+    if (node <= 0)
+    {
+        // the region was not entered on this thread
+        return;
+    }
+
+    auto& regionNode = tree.nodes[node];
+    int64_t counters[AcceraPerfCounterCount] = {};
+    if (counterMask)
+    {
+        AcceraReadPerfCounters(counterMask, counters);
+        for (int counter = 0; counter < AcceraPerfCounterCount; ++counter)
+        {
+            counters[counter] -= regionNode.countersStart[counter];
+            regionNode.counters[counter] += counters[counter];
+        }
+    }
+
+    auto elapsed = timestamp - regionNode.start;
+    regionNode.time += elapsed;
+    regionNode.count += 1;
+    tree.nodes[regionNode.parent].childTime += elapsed;
+    tree.current = regionNode.parent;
+
+    if (tree.events.size() < MaxTraceEventsPerThread)
+    {
+        tree.events.push_back({ node, regionNode.start, elapsed, {} });
+        std::copy(std::begin(counters), std::end(counters), tree.events.back().counters);
+    }
+    else
+    {
+        ++tree.droppedEvents;
+    }
+}
+
+void AcceraCountMemoryTraffic(int64_t* handle, const char* array, int64_t loadedBytes, int64_t storedBytes)
+{
+    auto id = static_cast<size_t>(RegisterName(handle, array, ArrayNames, ArrayIds));
+    auto& tree = GetThreadTree();
+    auto& traffic = tree.nodes[tree.current].traffic;
+    if (traffic.size() <= id)
+    {
+        traffic.resize(id + 1);
+    }
+    traffic[id].loadedBytes += loadedBytes;
+    traffic[id].storedBytes += storedBytes;
+}
+
+void AcceraPrintProfileResults()
+{
+    std::lock_guard<std::mutex> lock(RegistryMutex);
+
+    if (HasUnconvertedCycles())
+    {
+        std::printf("times are in cycles of the timestamp counter\n");
+    }
+
+    std::printf("region\tcount\ttotal\tself\n");
+    RegionTree merged;
+    for (size_t thread = 0; thread < ThreadTrees.size(); ++thread)
+    {
+        auto& tree = *ThreadTrees[thread];
+        std::printf("thread %zu\n", thread);
+        PrintTraffic(tree.nodes[0], 1);
+        PrintTree(tree, 0, 1, GetSecondsPerTick(tree));
+        MergeTree(tree, 0, merged, 0, GetSecondsPerTick(tree));
+        merged.counterMask |= tree.counterMask;
+    }
+    if (ThreadTrees.size() > 1)
+    {
+        std::printf("all threads\n");
+        PrintTraffic(merged.nodes[0], 1);
+        PrintTree(merged, 0, 1, 1);
+    }
+
+    if (auto path = std::getenv("ACCERA_PROFILE_TRACE"))
+    {
+        if (WriteToFile(FormatTrace(), path) != 0)
+        {
+            std::fprintf(stderr, "Accera: cannot write the profile trace to %s\n", path);
+        }
+    }
+    if (auto path = std::getenv("ACCERA_PROFILE_COUNTERS"))
+    {
+        if (WriteToFile(FormatCounters(), path) != 0)
+        {
+            std::fprintf(stderr, "Accera: cannot write the profile counters to %s\n", path);
+        }
+    }
+    if (auto path = std::getenv("ACCERA_MEMORY_TRAFFIC"))
+    {
+        if (WriteToFile(FormatTraffic(), path) != 0)
+        {
+            std::fprintf(stderr, "Accera: cannot write the memory traffic to %s\n", path);
+        }
+    }
+}
+
+int32_t AcceraWriteProfileTrace(const char* path)
+{
+    std::lock_guard<std::mutex> lock(RegistryMutex);
+    return WriteToFile(FormatTrace(), path);
+}
+
+int64_t AcceraFormatProfileTrace(char* buffer, int64_t size)
+{
+    std::lock_guard<std::mutex> lock(RegistryMutex);
+    return CopyToBuffer(FormatTrace(), buffer, size);
+}
+
+int32_t AcceraWriteProfileCounters(const char* path)
+{
+    std::lock_guard<std::mutex> lock(RegistryMutex);
+    return WriteToFile(FormatCounters(), path);
+}
+
+int64_t AcceraFormatProfileCounters(char* buffer, int64_t size)
+{
+    std::lock_guard<std::mutex> lock(RegistryMutex);
+    return CopyToBuffer(FormatCounters(), buffer, size);
+}
+
+int64_t AcceraGetProfileRecords(AcceraProfileRecord* records, int64_t capacity)
+{
+    std::lock_guard<std::mutex> lock(RegistryMutex);
+    int64_t count = 0;
+    for (size_t thread = 0; thread < ThreadTrees.size(); ++thread)
+    {
+        auto& tree = *ThreadTrees[thread];
+        AddRecords(tree, 0, static_cast<int32_t>(thread), -1, GetSecondsPerTick(tree), records, capacity, count);
+    }
+    return count;
+}
+
+int32_t AcceraWriteMemoryTraffic(const char* path)
+{
+    std::lock_guard<std::mutex> lock(RegistryMutex);
+    return WriteToFile(FormatTraffic(), path);
+}
+
+int64_t AcceraFormatMemoryTraffic(char* buffer, int64_t size)
+{
+    std::lock_guard<std::mutex> lock(RegistryMutex);
+    return CopyToBuffer(FormatTraffic(), buffer, size);
+}
+
+int64_t AcceraGetMemoryTrafficRecords(AcceraMemoryTrafficRecord* records, int64_t capacity)
+{
+    std::lock_guard<std::mutex> lock(RegistryMutex);
+    int64_t regionCount = 0;
+    int64_t count = 0;
+    for (size_t thread = 0; thread < ThreadTrees.size(); ++thread)
+    {
+        auto& tree = *ThreadTrees[thread];
+        AddTrafficRecords(tree.nodes[0], static_cast<int32_t>(thread), -1, records, capacity, count);
+        AddTrafficRecords(tree, 0, static_cast<int32_t>(thread), regionCount, records, capacity, count);
+    }
+    return count;
+}
+
+void AcceraResetProfileResults()
+{
+    std::lock_guard<std::mutex> lock(RegistryMutex);
+    for (auto& tree : ThreadTrees)
+    {
+        // The nodes are kept since threads may be in their regions
+        for (auto& node : tree->nodes)
+        {
+            node.count = 0;
+            node.time = 0;
+            node.childTime = 0;
+            std::fill(std::begin(node.counters), std::end(node.counters), 0);
+            std::fill(node.traffic.begin(), node.traffic.end(), MemoryTraffic{});
+        }
+        tree->events.clear();
+        tree->droppedEvents = 0;
+    }
+}
@@ -8,41 +8,174 @@
 
 #include "Random.h"
 
-#include <random>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
 
-static std::default_random_engine RandomEngine;
+namespace
+{
+// Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3"): each 128-bit counter is mapped to
+// 4 random 32-bit values by 10 rounds keyed by the seed
+constexpr uint32_t PhiloxMultiplier0 = 0xD2511F53;
+constexpr uint32_t PhiloxMultiplier1 = 0xCD9E8D57;
+constexpr uint32_t PhiloxWeyl0 = 0x9E3779B9;
+constexpr uint32_t PhiloxWeyl1 = 0xBB67AE85;
+constexpr int PhiloxRounds = 10;
+
+// The number of counters generated together. The rounds are written over arrays of this many lanes so that the
+// compiler keeps each of them in vector registers
+constexpr int64_t BatchBlocks = 16;
+constexpr int64_t ValuesPerBlock = 4;
+constexpr int64_t BatchValues = BatchBlocks * ValuesPerBlock;
+
+// Buffers are split into chunks of a fixed size, independent of the number of threads, and only buffers of several
+// chunks are filled in parallel
+constexpr int64_t ChunkValues = int64_t{ 1 } << 16;
+constexpr int64_t MinParallelValues = 4 * ChunkValues;
+
+std::atomic<uint32_t> Seed{ 0 };
+std::atomic<uint64_t> NextBlock{ 0 };
+
+// Generates the values of BatchBlocks consecutive counters, starting at `firstBlock`, into `values`
+void PhiloxBatch(uint32_t seed, uint64_t firstBlock, uint32_t* values)
+{
+    uint32_t c0[BatchBlocks], c1[BatchBlocks], c2[BatchBlocks], c3[BatchBlocks];
+    for (int64_t lane = 0; lane < BatchBlocks; ++lane)
+    {
+        auto block = firstBlock + static_cast<uint64_t>(lane);
+        c0[lane] = static_cast<uint32_t>(block);
+        c1[lane] = static_cast<uint32_t>(block >> 32);
+        c2[lane] = 0;
+        c3[lane] = 0;
+    }
+
+    uint32_t k0 = seed;
+    uint32_t k1 = 0;
+    for (int round = 0; round < PhiloxRounds; ++round)
+    {
+        for (int64_t lane = 0; lane < BatchBlocks; ++lane)
+        {
+            auto p0 = static_cast<uint64_t>(PhiloxMultiplier0) * c0[lane];
+            auto p1 = static_cast<uint64_t>(PhiloxMultiplier1) * c2[lane];
+            auto n0 = static_cast<uint32_t>(p1 >> 32) ^ c1[lane] ^ k0;
+            auto n1 = static_cast<uint32_t>(p1);
+            auto n2 = static_cast<uint32_t>(p0 >> 32) ^ c3[lane] ^ k1;
+            auto n3 = static_cast<uint32_t>(p0);
+            c0[lane] = n0;
+            c1[lane] = n1;
+            c2[lane] = n2;
+            c3[lane] = n3;
+        }
+        k0 += PhiloxWeyl0;
+        k1 += PhiloxWeyl1;
+    }
+
+    for (int64_t lane = 0; lane < BatchBlocks; ++lane)
+    {
+        values[lane * ValuesPerBlock + 0] = c0[lane];
+        values[lane * ValuesPerBlock + 1] = c1[lane];
+        values[lane * ValuesPerBlock + 2] = c2[lane];
+        values[lane * ValuesPerBlock + 3] = c3[lane];
+    }
+}
+
+// Writes the values at positions [begin, end) of the stream that starts at `firstBlock`, transformed by `convert`
+template <typename T, typename Convert>
+void FillRange(T* buffer, int64_t begin, int64_t end, uint32_t seed, uint64_t firstBlock, Convert convert)
+{
+    uint32_t values[BatchValues];
+    for (int64_t batch = begin; batch < end; batch += BatchValues)
+    {
+        PhiloxBatch(seed, firstBlock + static_cast<uint64_t>(batch / ValuesPerBlock), values);
+        auto count = std::min(BatchValues, end - batch);
+        for (int64_t idx = 0; idx < count; ++idx)
+        {
+            buffer[batch + idx] = convert(values[idx]);
+        }
+    }
+}
+
+// Reserves the positions of `size` values in the stream and fills the buffer with them, in parallel for large buffers
+template <typename T, typename Convert>
+void Fill(T* buffer, int64_t size, Convert convert)
+{
+    auto blocks = static_cast<uint64_t>((size + ValuesPerBlock - 1) / ValuesPerBlock);
+    auto firstBlock = NextBlock.fetch_add(blocks, std::memory_order_relaxed);
+    auto seed = Seed.load(std::memory_order_relaxed);
+
+    auto numChunks = (size + ChunkValues - 1) / ChunkValues;
+    auto numThreads = std::min<int64_t>(numChunks, std::max(1u, std::thread::hardware_concurrency()));
+    if (size < MinParallelValues || numThreads < 2)
+    {
+        FillRange(buffer, 0, size, seed, firstBlock, convert);
+        return;
+    }
+
+    std::atomic<int64_t> nextChunk{ 0 };
+    auto worker = [&] {
+        for (auto chunk = nextChunk.fetch_add(1); chunk < numChunks; chunk = nextChunk.fetch_add(1))
+        {
+            auto begin = chunk * ChunkValues;
+            FillRange(buffer, begin, std::min(begin + ChunkValues, size), seed, firstBlock, convert);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+    for (int64_t thread = 1; thread < numThreads; ++thread)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+void FillReals(float* buffer, int64_t size)
+{
+    // The top 24 bits give every float in [0, 1) that is a multiple of 2^-24
+    Fill(buffer, size, [](uint32_t value) {
+        return static_cast<float>(value >> 8) * (2.0f / 16777216.0f) - 1.0f;
+    });
+}
+
+void FillInts(int* buffer, int64_t size, int lo, int hi)
+{
+    // Multiplying by the size of the range maps the 32-bit values onto it without a division. The bias is at most
+    // range / 2^32, which is negligible for test data
+    auto range = static_cast<uint64_t>(static_cast<int64_t>(hi) - static_cast<int64_t>(lo) + 1);
+    Fill(buffer, size, [lo, range](uint32_t value) {
+        return static_cast<int>(static_cast<int64_t>(lo) + static_cast<int64_t>((value * range) >> 32));
+    });
+}
+} // namespace
 
 void GetNextRandomValue(float* val)
 {
-    std::uniform_real_distribution<> distribution(-1.0f, 1.0f);
-    *val = distribution(RandomEngine);
+    FillReals(val, 1);
 }
 
 void GetNextRandomIntValue(int* val, int lo, int hi)
 {
-    std::uniform_int_distribution<> distribution(lo, hi);
-    *val = distribution(RandomEngine);
+    FillInts(val, 1, lo, hi);
 }
 
 void GetNextNRandomValues(float* val, unsigned int N)
 {
-    std::uniform_real_distribution<> distribution(-1.0f, 1.0f);
-    for (unsigned int idx = 0; idx < N; ++idx)
-    {
-        val[idx] = distribution(RandomEngine);
-    }
+    FillReals(val, N);
 }
 
 void GetNextNRandomIntValues(int* val, int lo, int hi, unsigned int N)
 {
-    std::uniform_int_distribution<> distribution(lo, hi);
-    for (unsigned int idx = 0; idx < N; ++idx)
-    {
-        val[idx] = distribution(RandomEngine);
-    }
+    FillInts(val, N, lo, hi);
 }
 
 void ResetRandomEngine(unsigned int seed)
 {
-    RandomEngine.seed(seed);
+    Seed.store(seed, std::memory_order_relaxed);
+    NextBlock.store(0, std::memory_order_relaxed);
 }
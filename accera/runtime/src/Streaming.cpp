@@ -0,0 +1,232 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//
+//  Double-buffered streaming of arrays that are larger than memory through functions that compute a chunk at a time
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Streaming.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <new>
+#include <thread>
+
+namespace
+{
+// The alignment of the chunk buffers, which is enough for the arguments of any function
+constexpr std::align_val_t ChunkAlignment{ 64 };
+
+constexpr int32_t AllocationFailed = -1;
+constexpr int32_t OpenFailed = -2;
+constexpr int32_t ReadFailed = -3;
+
+struct ChunkBuffer
+{
+    explicit ChunkBuffer(int64_t sizeInBytes) :
+        data(::operator new(static_cast<size_t>(sizeInBytes), ChunkAlignment, std::nothrow))
+    {}
+
+    ChunkBuffer(const ChunkBuffer&) = delete;
+    ChunkBuffer& operator=(const ChunkBuffer&) = delete;
+
+    ~ChunkBuffer()
+    {
+        ::operator delete(data, ChunkAlignment);
+    }
+
+    void* data;
+};
+
+#if defined(_WIN32)
+class ChunkFile
+{
+public:
+    explicit ChunkFile(const char* path) :
+        _file(CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr))
+    {}
+
+    ChunkFile(const ChunkFile&) = delete;
+    ChunkFile& operator=(const ChunkFile&) = delete;
+
+    ~ChunkFile()
+    {
+        if (IsOpen())
+        {
+            CloseHandle(_file);
+        }
+    }
+
+    bool IsOpen() const { return _file != INVALID_HANDLE_VALUE; }
+
+    bool Read(int64_t offset, void* buffer, int64_t sizeInBytes)
+    {
+        auto bytes = static_cast<char*>(buffer);
+        while (sizeInBytes > 0)
+        {
+            OVERLAPPED position{};
+            position.Offset = static_cast<DWORD>(offset);
+            position.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            DWORD bytesRead = 0;
+            auto bytesToRead = static_cast<DWORD>(sizeInBytes < (1ll << 30) ? sizeInBytes : (1ll << 30));
+            if (!ReadFile(_file, bytes, bytesToRead, &bytesRead, &position) || bytesRead == 0)
+            {
+                return false;
+            }
+            bytes += bytesRead;
+            offset += bytesRead;
+            sizeInBytes -= bytesRead;
+        }
+        return true;
+    }
+
+    void Drop(int64_t, int64_t) {}
+
+private:
+    HANDLE _file;
+};
+#else
+class ChunkFile
+{
+public:
+    explicit ChunkFile(const char* path) :
+        _file(open(path, O_RDONLY))
+    {
+#if defined(POSIX_FADV_SEQUENTIAL)
+        if (IsOpen())
+        {
+            posix_fadvise(_file, 0, 0, POSIX_FADV_SEQUENTIAL);
+        }
+#endif
+    }
+
+    ChunkFile(const ChunkFile&) = delete;
+    ChunkFile& operator=(const ChunkFile&) = delete;
+
+    ~ChunkFile()
+    {
+        if (IsOpen())
+        {
+            close(_file);
+        }
+    }
+
+    bool IsOpen() const { return _file >= 0; }
+
+    bool Read(int64_t offset, void* buffer, int64_t sizeInBytes)
+    {
+        auto bytes = static_cast<char*>(buffer);
+        while (sizeInBytes > 0)
+        {
+            auto bytesRead = pread(_file, bytes, static_cast<size_t>(sizeInBytes), static_cast<off_t>(offset));
+            if (bytesRead <= 0)
+            {
+                return false;
+            }
+            bytes += bytesRead;
+            offset += bytesRead;
+            sizeInBytes -= bytesRead;
+        }
+        return true;
+    }
+
+    // The chunk is in its buffer, its pages in the page cache would only push out the memory of the process
+    void Drop(int64_t offset, int64_t sizeInBytes)
+    {
+#if defined(POSIX_FADV_DONTNEED)
+        posix_fadvise(_file, static_cast<off_t>(offset), static_cast<off_t>(sizeInBytes), POSIX_FADV_DONTNEED);
+#endif
+    }
+
+private:
+    int _file;
+};
+#endif
+
+struct FileStream
+{
+    ChunkFile file;
+    int64_t offsetInBytes;
+    AcceraStreamCompute compute;
+    void* context;
+};
+
+int32_t FetchFileChunk(void* context, int64_t chunk, void* buffer, int64_t sizeInBytes)
+{
+    auto stream = static_cast<FileStream*>(context);
+    auto offset = stream->offsetInBytes + chunk * sizeInBytes;
+    if (!stream->file.Read(offset, buffer, sizeInBytes))
+    {
+        return ReadFailed;
+    }
+    stream->file.Drop(offset, sizeInBytes);
+    return 0;
+}
+
+void ComputeFileChunk(void* context, int64_t chunk, const void* data)
+{
+    auto stream = static_cast<FileStream*>(context);
+    stream->compute(stream->context, chunk, data);
+}
+} // namespace
+
+int32_t AcceraStream(int64_t numChunks, int64_t chunkSizeInBytes, AcceraStreamFetch fetch, AcceraStreamCompute compute, void* context)
+{
+    if (numChunks <= 0)
+    {
+        return 0;
+    }
+
+    ChunkBuffer buffers[2] = { ChunkBuffer{ chunkSizeInBytes }, ChunkBuffer{ numChunks > 1 ? chunkSizeInBytes : 0 } };
+    if (!buffers[0].data || !buffers[1].data)
+    {
+        return AllocationFailed;
+    }
+
+    if (auto result = fetch(context, 0, buffers[0].data, chunkSizeInBytes))
+    {
+        return result;
+    }
+
+    // The next chunk is fetched on its own thread while the current one is computed. A thread per chunk costs
+    // microseconds, which is nothing next to the time it takes to read a chunk of a larger-than-memory array.
+    for (int64_t chunk = 0; chunk < numChunks; ++chunk)
+    {
+        int32_t nextResult = 0;
+        std::thread prefetch;
+        if (chunk + 1 < numChunks)
+        {
+            prefetch = std::thread([&, chunk] {
+                nextResult = fetch(context, chunk + 1, buffers[(chunk + 1) % 2].data, chunkSizeInBytes);
+            });
+        }
+
+        compute(context, chunk, buffers[chunk % 2].data);
+
+        if (prefetch.joinable())
+        {
+            prefetch.join();
+        }
+        if (nextResult != 0)
+        {
+            return nextResult;
+        }
+    }
+    return 0;
+}
+
+int32_t AcceraStreamFile(const char* path, int64_t offsetInBytes, int64_t numChunks, int64_t chunkSizeInBytes, AcceraStreamCompute compute, void* context)
+{
+    FileStream stream{ ChunkFile{ path }, offsetInBytes, compute, context };
+    if (!stream.file.IsOpen())
+    {
+        return OpenFailed;
+    }
+    return AcceraStream(numChunks, chunkSizeInBytes, FetchFileChunk, ComputeFileChunk, &stream);
+}
@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//
+//  Thread affinity support used by loops that are pinned to an explicit list of processors
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ThreadAffinity.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <limits>
+
+namespace
+{
+// The processor the calling thread is pinned to, so that pinning each iteration of a loop only
+// changes the affinity of a thread once
+thread_local int64_t CurrentProcessor = -1;
+
+bool SetCurrentThreadAffinity(int64_t processor)
+{
+#if defined(_WIN32)
+    // A thread affinity mask only addresses the processors of the current processor group
+    if (processor >= static_cast<int64_t>(sizeof(DWORD_PTR) * 8))
+    {
+        return false;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << processor) != 0;
+#elif defined(__linux__)
+    auto numProcessors = static_cast<int>(processor) + 1;
+    auto processorSet = CPU_ALLOC(numProcessors);
+    if (!processorSet)
+    {
+        return false;
+    }
+    auto setSize = CPU_ALLOC_SIZE(numProcessors);
+    CPU_ZERO_S(setSize, processorSet);
+    CPU_SET_S(static_cast<int>(processor), setSize, processorSet);
+    auto result = pthread_setaffinity_np(pthread_self(), setSize, processorSet);
+    CPU_FREE(processorSet);
+    return result == 0;
+#else
+    // No thread affinity API (e.g. macOS only supports affinity hints between threads)
+    (void)processor;
+    return false;
+#endif
+}
+} // namespace
+
+int32_t AcceraPinCurrentThread(int64_t processor)
+{
+    if (processor < 0 || processor > std::numeric_limits<int32_t>::max())
+    {
+        return -1;
+    }
+    if (processor == CurrentProcessor)
+    {
+        return 0;
+    }
+    if (!SetCurrentThreadAffinity(processor))
+    {
+        return -1;
+    }
+    CurrentProcessor = processor;
+    return 0;
+}
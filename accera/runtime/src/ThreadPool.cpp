@@ -0,0 +1,352 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//
+//  Persistent thread pool used by functions compiled for the THREAD_POOL runtime
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+// Idle workers spin for this long before parking, so back-to-back calls into small kernels never pay for a wake-up
+constexpr int64_t DefaultSpinMicroseconds = 1000;
+
+// The dispatch word packs the region generation with its thread count so that workers read both atomically
+constexpr uint64_t ThreadCountBits = 16;
+constexpr uint64_t ThreadCountMask = (uint64_t{ 1 } << ThreadCountBits) - 1;
+constexpr int64_t MaxThreads = static_cast<int64_t>(ThreadCountMask);
+
+void CpuRelax()
+{
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+class RegionBarrier
+{
+public:
+    explicit RegionBarrier(int64_t numThreads) :
+        _numThreads(numThreads)
+    {}
+
+    void Wait()
+    {
+        auto generation = _generation.load(std::memory_order_acquire);
+        if (_arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == _numThreads)
+        {
+            _arrived.store(0, std::memory_order_relaxed);
+            _generation.fetch_add(1, std::memory_order_release);
+            return;
+        }
+
+        // Threads of a region are all running, so the wait is expected to be short
+        for (int64_t spins = 0; _generation.load(std::memory_order_acquire) == generation; ++spins)
+        {
+            if (spins < 4096)
+            {
+                CpuRelax();
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    int64_t _numThreads;
+    std::atomic<int64_t> _arrived{ 0 };
+    std::atomic<int64_t> _generation{ 0 };
+};
+
+struct Region
+{
+    Region(AcceraThreadPoolTask task, void* context, int64_t numThreads) :
+        task(task),
+        context(context),
+        numThreads(numThreads),
+        remaining(numThreads - 1),
+        barrier(numThreads)
+    {}
+
+    AcceraThreadPoolTask task;
+    void* context;
+    int64_t numThreads;
+    std::atomic<int64_t> remaining;
+    RegionBarrier barrier;
+};
+
+// The region the current thread is executing, used by barriers and to detect nested dispatches
+thread_local Region* CurrentRegion = nullptr;
+
+// The caps of AcceraThreadPoolSetMaxThreads and AcceraThreadPoolSetCallerMaxThreads, 0 when there is none
+std::atomic<int64_t> ProcessMaxThreads{ 0 };
+thread_local int64_t CallerMaxThreads = 0;
+
+int64_t ApplyMaxThreads(int64_t numThreads)
+{
+    for (auto maxThreads : { ProcessMaxThreads.load(std::memory_order_relaxed), CallerMaxThreads })
+    {
+        if (maxThreads > 0)
+        {
+            numThreads = std::min(numThreads, maxThreads);
+        }
+    }
+    return numThreads;
+}
+
+void RunInline(AcceraThreadPoolTask task, void* context)
+{
+    // The outlined region partitions its work by the thread count it is given, so a single thread runs all of it
+    Region region(task, context, 1);
+    auto previousRegion = CurrentRegion;
+    CurrentRegion = &region;
+    task(context, 0, 1);
+    CurrentRegion = previousRegion;
+}
+
+int64_t HardwareThreads()
+{
+    return std::max<int64_t>(1, std::thread::hardware_concurrency());
+}
+
+class ThreadPool
+{
+public:
+    ~ThreadPool()
+    {
+        Stop();
+    }
+
+    void Start(int64_t numThreads, int64_t spinMicroseconds)
+    {
+        std::lock_guard<std::mutex> lifetimeLock(_lifetimeMutex);
+        if (spinMicroseconds >= 0)
+        {
+            _spinMicroseconds.store(spinMicroseconds, std::memory_order_relaxed);
+        }
+        if (numThreads <= 0)
+        {
+            numThreads = HardwareThreads();
+        }
+        _defaultThreads.store(numThreads, std::memory_order_relaxed);
+        GrowLocked(numThreads - 1);
+    }
+
+    void Stop()
+    {
+        std::lock_guard<std::mutex> dispatchLock(_dispatchMutex);
+        std::lock_guard<std::mutex> lifetimeLock(_lifetimeMutex);
+        {
+            std::lock_guard<std::mutex> parkLock(_parkMutex);
+            _stop.store(true, std::memory_order_seq_cst);
+        }
+        _parkCondition.notify_all();
+        for (auto& worker : _workers)
+        {
+            worker.join();
+        }
+        _workers.clear();
+        _stop.store(false, std::memory_order_seq_cst);
+    }
+
+    void Run(int64_t numThreads, AcceraThreadPoolTask task, void* context)
+    {
+        if (numThreads <= 0)
+        {
+            numThreads = _defaultThreads.load(std::memory_order_relaxed);
+        }
+        numThreads = std::min(ApplyMaxThreads(numThreads), MaxThreads);
+        if (numThreads <= 1 || CurrentRegion != nullptr)
+        {
+            // Nested regions run on the calling thread instead of oversubscribing the pool
+            RunInline(task, context);
+            return;
+        }
+
+        std::unique_lock<std::mutex> dispatchLock(_dispatchMutex, std::try_to_lock);
+        if (!dispatchLock.owns_lock())
+        {
+            // Another application thread is using the pool, run on the calling thread instead of waiting for it
+            RunInline(task, context);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lifetimeLock(_lifetimeMutex);
+            GrowLocked(numThreads - 1);
+        }
+
+        Region region(task, context, numThreads);
+        _region.store(&region, std::memory_order_release);
+
+        auto previousWord = _dispatch.load(std::memory_order_relaxed);
+        auto nextGeneration = (previousWord >> ThreadCountBits) + 1;
+        _dispatch.store((nextGeneration << ThreadCountBits) | static_cast<uint64_t>(numThreads), std::memory_order_seq_cst);
+        if (_parked.load(std::memory_order_seq_cst) > 0)
+        {
+            std::lock_guard<std::mutex> parkLock(_parkMutex);
+            _parkCondition.notify_all();
+        }
+
+        CurrentRegion = &region;
+        task(context, 0, numThreads);
+        CurrentRegion = nullptr;
+
+        for (int64_t spins = 0; region.remaining.load(std::memory_order_acquire) != 0; ++spins)
+        {
+            if (spins < 4096)
+            {
+                CpuRelax();
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    void GrowLocked(int64_t numWorkers)
+    {
+        auto currentWord = _dispatch.load(std::memory_order_acquire);
+        while (static_cast<int64_t>(_workers.size()) < numWorkers)
+        {
+            auto workerIndex = static_cast<int64_t>(_workers.size());
+            _workers.emplace_back([this, workerIndex, currentWord] { WorkerLoop(workerIndex, currentWord); });
+        }
+    }
+
+    uint64_t WaitForDispatch(uint64_t seenWord)
+    {
+        auto spinDuration = std::chrono::microseconds(_spinMicroseconds.load(std::memory_order_relaxed));
+        auto spinDeadline = std::chrono::steady_clock::now() + spinDuration;
+        for (int64_t spins = 0;; ++spins)
+        {
+            auto word = _dispatch.load(std::memory_order_acquire);
+            if (word != seenWord || _stop.load(std::memory_order_acquire))
+            {
+                return word;
+            }
+            if (spins < 4096)
+            {
+                CpuRelax();
+            }
+            else
+            {
+                // Give the core away while spinning so that an oversubscribed machine still makes progress
+                std::this_thread::yield();
+            }
+            if ((spins & 63) == 0 && std::chrono::steady_clock::now() > spinDeadline)
+            {
+                break;
+            }
+        }
+
+        std::unique_lock<std::mutex> parkLock(_parkMutex);
+        _parked.fetch_add(1, std::memory_order_seq_cst);
+        _parkCondition.wait(parkLock, [&] {
+            return _dispatch.load(std::memory_order_seq_cst) != seenWord || _stop.load(std::memory_order_seq_cst);
+        });
+        _parked.fetch_sub(1, std::memory_order_seq_cst);
+        return _dispatch.load(std::memory_order_acquire);
+    }
+
+    void WorkerLoop(int64_t workerIndex, uint64_t seenWord)
+    {
+        // The calling thread of a region is thread 0, so worker N is thread N + 1
+        auto threadIndex = workerIndex + 1;
+        while (true)
+        {
+            seenWord = WaitForDispatch(seenWord);
+            if (_stop.load(std::memory_order_acquire))
+            {
+                return;
+            }
+
+            auto numThreads = static_cast<int64_t>(seenWord & ThreadCountMask);
+            if (threadIndex < numThreads)
+            {
+                // The caller waits for every participating thread, so the region outlives this use of it
+                auto region = _region.load(std::memory_order_acquire);
+                CurrentRegion = region;
+                region->task(region->context, threadIndex, numThreads);
+                CurrentRegion = nullptr;
+                region->remaining.fetch_sub(1, std::memory_order_acq_rel);
+            }
+        }
+    }
+
+    std::mutex _dispatchMutex;
+    std::mutex _lifetimeMutex;
+    std::vector<std::thread> _workers;
+
+    std::atomic<uint64_t> _dispatch{ 0 };
+    std::atomic<Region*> _region{ nullptr };
+    std::atomic<bool> _stop{ false };
+    std::atomic<int64_t> _spinMicroseconds{ DefaultSpinMicroseconds };
+    std::atomic<int64_t> _defaultThreads{ HardwareThreads() };
+
+    std::mutex _parkMutex;
+    std::condition_variable _parkCondition;
+    std::atomic<int64_t> _parked{ 0 };
+};
+
+ThreadPool& GetThreadPool()
+{
+    static ThreadPool threadPool;
+    return threadPool;
+}
+} // namespace
+
+void AcceraThreadPoolInitialize(int64_t numThreads, int64_t spinMicroseconds)
+{
+    GetThreadPool().Start(numThreads, spinMicroseconds);
+}
+
+void AcceraThreadPoolShutdown(void)
+{
+    GetThreadPool().Stop();
+}
+
+void AcceraThreadPoolSetMaxThreads(int64_t maxThreads)
+{
+    ProcessMaxThreads.store(std::max<int64_t>(maxThreads, 0), std::memory_order_relaxed);
+}
+
+void AcceraThreadPoolSetCallerMaxThreads(int64_t maxThreads)
+{
+    CallerMaxThreads = std::max<int64_t>(maxThreads, 0);
+}
+
+void AcceraThreadPoolRun(int64_t numThreads, AcceraThreadPoolTask task, void* context)
+{
+    GetThreadPool().Run(numThreads, task, context);
+}
+
+void AcceraThreadPoolBarrier(void)
+{
+    if (auto region = CurrentRegion; region && region->numThreads > 1)
+    {
+        region->barrier.Wait();
+    }
+}
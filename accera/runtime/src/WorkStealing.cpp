@@ -0,0 +1,133 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//
+//  Work-stealing scheduler used by loops parallelized with the WorkStealing policy
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "WorkStealing.h"
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+
+namespace
+{
+// Each worker owns a contiguous range of chunks [lo, hi) packed into a single 64-bit word
+// so that the owner (taking from lo) and thieves (taking from hi) can update it with one CAS.
+using PackedRange = uint64_t;
+
+constexpr PackedRange Pack(uint32_t lo, uint32_t hi)
+{
+    return (static_cast<PackedRange>(hi) << 32) | lo;
+}
+
+constexpr uint32_t Lo(PackedRange range)
+{
+    return static_cast<uint32_t>(range);
+}
+
+constexpr uint32_t Hi(PackedRange range)
+{
+    return static_cast<uint32_t>(range >> 32);
+}
+
+// Pad each range to its own cache line to avoid false sharing between workers
+struct alignas(64) WorkerRange
+{
+    std::atomic<PackedRange> range{ 0 };
+};
+
+struct WorkStealingScheduler
+{
+    explicit WorkStealingScheduler(int64_t numWorkers) :
+        numWorkers(numWorkers),
+        ranges(new WorkerRange[numWorkers])
+    {}
+
+    int64_t numWorkers;
+    std::unique_ptr<WorkerRange[]> ranges;
+};
+
+int64_t TakeOwn(WorkerRange& own)
+{
+    auto range = own.range.load(std::memory_order_acquire);
+    while (Lo(range) < Hi(range))
+    {
+        if (own.range.compare_exchange_weak(range, Pack(Lo(range) + 1, Hi(range)), std::memory_order_acq_rel))
+        {
+            return Lo(range);
+        }
+    }
+    return -1;
+}
+
+int64_t Steal(WorkStealingScheduler& scheduler, int64_t workerId)
+{
+    auto& own = scheduler.ranges[workerId];
+    for (int64_t offset = 1; offset < scheduler.numWorkers; ++offset)
+    {
+        auto& victim = scheduler.ranges[(workerId + offset) % scheduler.numWorkers];
+        auto range = victim.range.load(std::memory_order_acquire);
+        while (Lo(range) < Hi(range))
+        {
+            // Steal the upper half of the victim's remaining chunks, rounded up so a single chunk can be stolen
+            auto count = (Hi(range) - Lo(range) + 1) / 2;
+            auto splitPoint = Hi(range) - count;
+            if (victim.range.compare_exchange_weak(range, Pack(Lo(range), splitPoint), std::memory_order_acq_rel))
+            {
+                // Execute the first stolen chunk now and publish the rest so they can be stolen in turn
+                own.range.store(Pack(splitPoint + 1, Hi(range)), std::memory_order_release);
+                return splitPoint;
+            }
+        }
+    }
+    return -1;
+}
+} // namespace
+
+int64_t AcceraWorkStealingCreate(int64_t numChunks, int64_t numWorkers)
+{
+    if (numChunks < 0 || numWorkers <= 0 || numChunks > std::numeric_limits<uint32_t>::max())
+    {
+        return 0;
+    }
+
+    auto scheduler = new WorkStealingScheduler(numWorkers);
+
+    // Start from a static block partitioning, stealing only corrects the imbalance
+    auto blockSize = numChunks / numWorkers;
+    auto remainder = numChunks % numWorkers;
+    int64_t lo = 0;
+    for (int64_t worker = 0; worker < numWorkers; ++worker)
+    {
+        auto hi = lo + blockSize + (worker < remainder ? 1 : 0);
+        scheduler->ranges[worker].range.store(Pack(static_cast<uint32_t>(lo), static_cast<uint32_t>(hi)), std::memory_order_relaxed);
+        lo = hi;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    return reinterpret_cast<int64_t>(scheduler);
+}
+
+int64_t AcceraWorkStealingNext(int64_t handle, int64_t workerId)
+{
+    auto scheduler = reinterpret_cast<WorkStealingScheduler*>(handle);
+    if (!scheduler || workerId < 0 || workerId >= scheduler->numWorkers)
+    {
+        return -1;
+    }
+
+    auto chunk = TakeOwn(scheduler->ranges[workerId]);
+    if (chunk < 0)
+    {
+        chunk = Steal(*scheduler, workerId);
+    }
+    return chunk;
+}
+
+void AcceraWorkStealingDestroy(int64_t handle)
+{
+    delete reinterpret_cast<WorkStealingScheduler*>(handle);
+}
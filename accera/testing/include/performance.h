@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <utilities/include/Tuner.h>
+
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace accera
+{
+namespace testing
+{
+    /// <summary> The environment variable that makes the performance checks record their measurements as the new
+    /// baselines instead of comparing against the stored ones, e.g. after an intended slowdown. </summary>
+    constexpr const char* UpdatePerformanceBaselinesEnvironmentVariable = "ACCERA_UPDATE_PERF_BASELINES";
+
+    /// <summary> The median latencies of kernels, keyed by target model and kernel name. </summary>
+    /// <remarks> The file has a line per baseline with the target model, the kernel and the median latency in ms,
+    /// separated by tabs. </remarks>
+    class PerformanceBaselines
+    {
+    public:
+        /// <summary> Loads the baselines of a file, a missing file has no baselines. </summary>
+        static PerformanceBaselines Load(const std::string& path);
+
+        void Save(const std::string& path) const;
+
+        std::optional<double> Find(const std::string& target, const std::string& kernel) const;
+
+        void Set(const std::string& target, const std::string& kernel, double medianMs);
+
+    private:
+        std::map<std::pair<std::string, std::string>, double> _baselines;
+    };
+
+    struct PerformanceCheckOptions
+    {
+        int warmupIterations = 10; // untimed calls made before the timed ones
+        int iterations = 100; // timed calls, each one timed on its own
+        double tolerance = 0.1; // the slowdown over the baseline that is tolerated, as a fraction of the baseline
+        bool failOnRegression = true; // whether a regression fails the test or only produces a warning
+
+        std::string baselinesPath;
+        std::string target; // the model of the target device, e.g. "Intel 8280"
+    };
+
+    /// <summary> Times a kernel and compares its median latency against its baseline for the target, registering a
+    /// test failure, or a warning without `failOnRegression`, when it is slower by more than the tolerance. A kernel
+    /// without a baseline, or any kernel when `ACCERA_UPDATE_PERF_BASELINES` is set, records its median latency as
+    /// the baseline. For example,
+    /// ```
+    /// PerformanceCheckOptions options;
+    /// options.baselinesPath = "perf_baselines.tsv";
+    /// options.target = "Intel 8280";
+    /// CHECK(CheckPerformance("matmul_256", JitCompile(EmitMatMul(plan)), options));
+    /// ```
+    /// </summary>
+    ///
+    /// <param name="kernel"> The name of the kernel in the baselines. </param>
+    /// <param name="run"> Runs the kernel once each time it's called. </param>
+    /// <param name="options"> The options of the check. </param>
+    ///
+    /// <returns> false if the kernel regressed and `failOnRegression` is set, otherwise true. </returns>
+    bool CheckPerformance(const std::string& kernel, const utilities::TuningRunner& run, const PerformanceCheckOptions& options);
+} // namespace testing
+} // namespace accera
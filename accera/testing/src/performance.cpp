@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "performance.h"
+#include "testing.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/Files.h>
+#include <utilities/include/StringUtil.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+namespace accera
+{
+namespace testing
+{
+    namespace
+    {
+        bool ShouldUpdateBaselines()
+        {
+            auto value = std::getenv(UpdatePerformanceBaselinesEnvironmentVariable);
+            return value && *value && std::string(value) != "0";
+        }
+
+        std::string FormatMs(double ms)
+        {
+            std::ostringstream stream;
+            stream << std::setprecision(4) << ms << " ms";
+            return stream.str();
+        }
+    } // namespace
+
+    PerformanceBaselines PerformanceBaselines::Load(const std::string& path)
+    {
+        PerformanceBaselines baselines;
+        if (!utilities::FileExists(path))
+        {
+            return baselines;
+        }
+
+        auto stream = utilities::OpenIfstream(path);
+        std::string line;
+        while (std::getline(stream, line))
+        {
+            auto fields = utilities::Split(line, '\t');
+            if (fields.size() != 3)
+            {
+                continue;
+            }
+            baselines._baselines[{ fields[0], fields[1] }] = std::stod(fields[2]);
+        }
+        return baselines;
+    }
+
+    void PerformanceBaselines::Save(const std::string& path) const
+    {
+        auto stream = utilities::OpenOfstream(path);
+        stream << std::setprecision(9);
+        for (auto& [key, medianMs] : _baselines)
+        {
+            stream << key.first << '\t' << key.second << '\t' << medianMs << '\n';
+        }
+    }
+
+    std::optional<double> PerformanceBaselines::Find(const std::string& target, const std::string& kernel) const
+    {
+        auto it = _baselines.find({ target, kernel });
+        if (it == _baselines.end())
+        {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    void PerformanceBaselines::Set(const std::string& target, const std::string& kernel, double medianMs)
+    {
+        _baselines[{ target, kernel }] = medianMs;
+    }
+
+    bool CheckPerformance(const std::string& kernel, const utilities::TuningRunner& run, const PerformanceCheckOptions& options)
+    {
+        if (options.baselinesPath.empty())
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The performance check of " + kernel + " has no baselines path");
+        }
+        if (options.tolerance < 0)
+        {
+            throw utilities::InputException(utilities::InputExceptionErrors::invalidArgument, "The tolerance of a performance check can't be negative");
+        }
+
+        auto latency = utilities::MeasureLatency(run, options.warmupIterations, options.iterations);
+        auto description = "Performance of " + kernel + " on " + options.target + ": " + FormatMs(latency.medianMs);
+
+        auto baselines = PerformanceBaselines::Load(options.baselinesPath);
+        auto baseline = baselines.Find(options.target, kernel);
+        if (!baseline || ShouldUpdateBaselines())
+        {
+            baselines.Set(options.target, kernel, latency.medianMs);
+            baselines.Save(options.baselinesPath);
+            TestWarning(description + ", recorded as the baseline");
+            return true;
+        }
+
+        auto slowdown = latency.medianMs / *baseline - 1;
+        std::ostringstream comparison;
+        comparison << std::fixed << std::setprecision(1) << std::abs(slowdown) * 100 << "% " << (slowdown > 0 ? "slower" : "faster") << " than the baseline of " << FormatMs(*baseline);
+        description += ", " + comparison.str();
+
+        if (slowdown <= options.tolerance)
+        {
+            TestSucceeded(description);
+            return true;
+        }
+        if (!options.failOnRegression)
+        {
+            TestWarning(description);
+            return true;
+        }
+        TestFailed(description);
+        return false;
+    }
+} // namespace testing
+} // namespace accera
@@ -0,0 +1,83 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mlir
+{
+class ExecutionEngine;
+class ModuleOp;
+} // namespace mlir
+
+namespace accera::transforms
+{
+
+/// <summary> The options of `CompileToObject`, the in-process equivalent of running acc-opt, mlir-translate, opt and llc </summary>
+struct ObjectCompilerOptions
+{
+    /// <summary> The options of the acc-to-llvm pipeline, as given to acc-opt's --acc-to-llvm </summary>
+    std::string pipelineOptions;
+
+    /// <summary> The target triple, the module's triple when empty, or the host's if the module doesn't have one </summary>
+    std::string triple;
+
+    /// <summary> The target CPU, "native" for the CPU and the features of the host </summary>
+    std::string cpu;
+
+    unsigned optLevel = 3;
+    unsigned sizeLevel = 0; // 2 is opt's -Oz
+    bool fastFPContract = true; // -fp-contract=fast
+
+    std::string objectPath;
+    std::string asmPath; // no assembly is written when empty
+
+    /// <summary> Where the MLIR pass timing report of the lowering is written, it isn't collected when empty </summary>
+    std::string passTimingPath;
+};
+
+/// <summary> Lowers the module with the acc-to-llvm pipeline, translates it to LLVM IR, optimizes it and writes the
+/// object file, all in-process. The module is lowered in place. </summary>
+/// <remarks> Modules of different MLIR contexts can be compiled concurrently. Throws if a step fails. </remarks>
+void CompileToObject(mlir::ModuleOp module, const ObjectCompilerOptions& options);
+
+/// <summary> The options of `JITCompile` </summary>
+struct JITCompilerOptions
+{
+    /// <summary> The options of the acc-to-llvm pipeline, as given to acc-opt's --acc-to-llvm </summary>
+    std::string pipelineOptions;
+
+    unsigned optLevel = 3;
+    unsigned sizeLevel = 0;
+
+    /// <summary> The shared libraries that the functions call into, e.g. acc-runtime, which are loaded into the process </summary>
+    std::vector<std::string> sharedLibraryPaths;
+};
+
+/// <summary> The functions of modules that were compiled for the host into the memory of the process </summary>
+class JITEngine
+{
+public:
+    JITEngine(std::unique_ptr<mlir::ExecutionEngine> engine);
+    ~JITEngine();
+
+    /// <summary> Calls a function, the arguments are passed by their addresses, e.g. the address of the pointer to
+    /// the data of an array argument. Throws if the function isn't found. </summary>
+    void Invoke(const std::string& functionName, std::vector<void*>& argumentAddresses) const;
+
+private:
+    std::unique_ptr<mlir::ExecutionEngine> _engine;
+};
+
+/// <summary> Lowers the module and its supporting modules with the acc-to-llvm pipeline, links them and compiles
+/// them for the host, all in-process. The modules are lowered in place. </summary>
+/// <remarks> The supporting modules hold what the module refers to, e.g. the package globals, and can be of other MLIR
+/// contexts. Throws if a step fails, or if the module has buffers that are memory-mapped from files. </remarks>
+std::unique_ptr<JITEngine> JITCompile(mlir::ModuleOp module, const std::vector<mlir::ModuleOp>& supportingModules, const JITCompilerOptions& options);
+
+} // namespace accera::transforms
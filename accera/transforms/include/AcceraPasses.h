@@ -6,19 +6,29 @@
 
 #pragma once
 
+#include "exec/CacheCopyReportPass.h"
+#include "exec/CacheMemoryPlanningPass.h"
+#include "exec/CostModelReportPass.h"
 #include "exec/ExecutionPlanToAffineLoweringPass.h"
+#include "exec/MemoryTrafficInstrumentationPass.h"
+#include "exec/VectorizationReportPass.h"
 #include "gpu/AcceraToGPUPass.h"
 #include "gpu/AcceraVulkanPasses.h"
 #include "ir/include/value/ValueEnums.h"
 #include "nest/LoopNestPasses.h"
 #include "nest/LoopNestToValueFunc.h"
+#include "value/AsyncEntryPointPass.h"
 #include "value/BarrierOptPass.h"
+#include "value/FunctionDeduplicationPass.h"
 #include "value/FunctionPointerResolutionPass.h"
+#include "value/IndexArithmeticOptimizePass.h"
 #include "value/RangeValueOptimizePass.h"
+#include "value/ThreadPoolDispatchPass.h"
 #include "value/ValueFuncToTargetPass.h"
 #include "value/ValueSimplifyPass.h"
 #include "value/ValueToLLVMLoweringPass.h"
 #include "value/ValueToStandardLoweringPass.h"
+#include "value/WorkspaceArgumentPass.h"
 
 #include <ir/include/exec/ExecutionPlanOps.h>
 #include <ir/include/nest/LoopNestOps.h>
@@ -69,6 +79,7 @@ struct AcceraPassPipelineOptions : mlir::PassPipelineOptions<AcceraPassPipelineO
     Option<bool> dumpIntraPassIR{ *this, "dump-intra-pass-ir", llvm::cl::init(false) };
     Option<std::string> basename{ *this, "basename", llvm::cl::init(std::string{}) };
     Option<std::string> target{ *this, "target", llvm::cl::init("host") };
+    Option<std::string> gpuChip{ *this, "gpu-chip", llvm::cl::desc("The AMDGPU architecture the ROCm kernels are compiled for"), llvm::cl::init("gfx908") };
     Option<accera::value::ExecutionRuntime> runtime{
         *this,
         "runtime",
@@ -79,15 +90,37 @@ struct AcceraPassPipelineOptions : mlir::PassPipelineOptions<AcceraPassPipelineO
             clEnumValN(accera::value::ExecutionRuntime::ROCM, "rocm", "ROCm runtime"),
             clEnumValN(accera::value::ExecutionRuntime::VULKAN, "vulkan", "Vulkan runtime"),
             clEnumValN(accera::value::ExecutionRuntime::OPENMP, "openmp", "OpenMP runtime"),
-            clEnumValN(accera::value::ExecutionRuntime::DEFAULT, "default", "default runtime")),
+            clEnumValN(accera::value::ExecutionRuntime::DEFAULT, "default", "default runtime"),
+            clEnumValN(accera::value::ExecutionRuntime::THREAD_POOL, "thread_pool", "Accera thread pool runtime"),
+            clEnumValN(accera::value::ExecutionRuntime::OPENCL, "opencl", "OpenCL runtime")),
         llvm::cl::init(accera::value::ExecutionRuntime::DEFAULT)
     };
     Option<bool> enableAsync{ *this, "enable-async", llvm::cl::init(false) };
     Option<bool> enableProfile{ *this, "enable-profiling", llvm::cl::init(false) };
+    Option<std::string> profileCounters{ *this, "profile-counters", llvm::cl::init(std::string{}) };
+    Option<std::string> profileTimer{ *this, "profile-timer", llvm::cl::init(std::string{ "clock" }) };
+    Option<bool> profileFunctions{ *this, "profile-functions", llvm::cl::desc("Time the body of each CPU function in a profile region when profiling is enabled"), llvm::cl::init(false) };
+    Option<bool> profileLoops{ *this, "profile-loops", llvm::cl::desc("Time the loops of the indices marked for profiling in a profile region when profiling is enabled"), llvm::cl::init(false) };
+    Option<bool> profileCacheCopies{ *this, "profile-cache-copies", llvm::cl::desc("Time the data movement of each CPU cache in a profile region when profiling is enabled"), llvm::cl::init(false) };
+    Option<bool> outlineCacheCopies{ *this, "outline-cache-copies", llvm::cl::desc("Move the data movement of each CPU cache to an internal function named after its profile region"), llvm::cl::init(false) };
+    Option<bool> countMemoryTraffic{ *this, "count-memory-traffic", llvm::cl::desc("Count the bytes that the CPU functions load from and store to each array at runtime, in the profile region the thread is in"), llvm::cl::init(false) };
+    Option<std::string> lineInfo{ *this, "line-info", llvm::cl::desc("Path of a listing of the IR after the loop nests are lowered, which the debug line info of the generated code refers to"), llvm::cl::init(std::string{}) };
     Option<bool> printLoops{ *this, "print-loops", llvm::cl::init(false) };
     Option<bool> printVecOpDetails{ *this, "print-vec-details", llvm::cl::init(false) };
     Option<bool> writeBarrierGraph{ *this, "barrier-opt-dot", llvm::cl::init(false) };
     Option<std::string> barrierGraphFilename{ *this, "barrier-opt-dot-filename", llvm::cl::init(std::string{}) };
+    Option<bool> planCacheMemory{ *this, "plan-cache-memory", llvm::cl::init(true) };
+    Option<bool> printMemoryPlan{ *this, "print-memory-plan", llvm::cl::init(false) };
+    Option<bool> staticArena{ *this, "static-arena", llvm::cl::desc("Carve the cache buffers and temporary arrays of all CPU functions from a single statically sized arena, for targets without a heap"), llvm::cl::init(false) };
+    Option<std::string> arenaReport{ *this, "arena-report", llvm::cl::desc("Path of a JSON report of the static arena size and the offset of each function's buffers in it"), llvm::cl::init(std::string{}) };
+    Option<std::string> vectorizationReport{ *this, "vectorization-report", llvm::cl::init(std::string{}) };
+    Option<std::string> gpuResourceReport{ *this, "gpu-resource-report", llvm::cl::init(std::string{}) };
+    Option<std::string> costModelReport{ *this, "cost-model-report", llvm::cl::init(std::string{}) };
+    Option<std::string> cacheCopyReport{ *this, "cache-copy-report", llvm::cl::desc("Path of a JSON report of the bytes moved by each cache copy, whose data movement is wrapped in profile regions that are timed even without enable-profiling"), llvm::cl::init(std::string{}) };
+    Option<std::string> compileStatsReport{ *this, "compile-stats-report", llvm::cl::desc("Path of a JSON report of the op count of each function after each stage and the time taken by the stage"), llvm::cl::init(std::string{}) };
+    Option<int64_t> unrollCodeSizeBudget{ *this, "unroll-code-size-budget", llvm::cl::desc("The number of ops that unrolling may grow a function to, loops are only partially unrolled past it (0 for no budget)"), llvm::cl::init(0) };
+    Option<std::string> unrollReport{ *this, "unroll-report", llvm::cl::desc("Path of a JSON report of the factor that each loop marked for unrolling was unrolled by"), llvm::cl::init(std::string{}) };
+    Option<bool> analysisOnly{ *this, "analysis-only", llvm::cl::init(false) };
 };
 
 void addAcceraToLLVMPassPipeline(mlir::OpPassManager& pm, const AcceraPassPipelineOptions& options);
@@ -0,0 +1,21 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+// fwd decls
+namespace mlir
+{
+class Pass;
+} // namespace mlir
+
+namespace accera::transforms::executionPlan
+{
+std::unique_ptr<mlir::Pass> createCacheMemoryPlanningPass(bool printMemoryPlan, bool staticArena = false, const std::string& arenaReport = "");
+std::unique_ptr<mlir::Pass> createCacheMemoryPlanningPass();
+} // namespace accera::transforms::executionPlan
@@ -0,0 +1,21 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+// fwd decls
+namespace mlir
+{
+class Pass;
+} // namespace mlir
+
+namespace accera::transforms::executionPlan
+{
+std::unique_ptr<mlir::Pass> createCostModelReportPass(const std::string& reportFilename);
+std::unique_ptr<mlir::Pass> createCostModelReportPass();
+} // namespace accera::transforms::executionPlan
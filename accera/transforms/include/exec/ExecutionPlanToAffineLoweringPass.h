@@ -10,6 +10,7 @@
 namespace mlir
 {
 class MLIRContext;
+class Operation;
 class RewritePatternSet;
 class Pass;
 using OwningRewritePatternList = RewritePatternSet;
@@ -27,12 +28,24 @@ void populateExecutionPlanCacheMappingPatterns(mlir::OwningRewritePatternList& p
 void populateExecutionPlanAdjustHierarchicalCacheRegionPositionPatterns(mlir::OwningRewritePatternList& patterns);
 void populateExecutionPlanAdjustCacheMappingPositionPatterns(mlir::OwningRewritePatternList& patterns);
 void populateExecutionPlanMaxElementCacheRegionPatterns(mlir::OwningRewritePatternList& patterns);
-void populateExecutionPlanVectorizePatterns(bool printVectorizationDetails, mlir::OwningRewritePatternList& patterns);
+void populateExecutionPlanVectorizePatterns(bool printVectorizationDetails, mlir::OwningRewritePatternList& patterns, bool reportVectorization = false);
 void populateExecutionPlanTensorizePatterns(mlir::OwningRewritePatternList& patterns);
 void populateExecutionPlanParallelizePatterns(mlir::OwningRewritePatternList& patterns);
+void populateExecutionPlanNestedParallelizePatterns(mlir::OwningRewritePatternList& patterns);
+void populateWorkStealingParallelPatterns(mlir::OwningRewritePatternList& patterns);
+void populateChunkedParallelPatterns(mlir::OwningRewritePatternList& patterns);
 void populateExecutionPlanScaleHoistingPatterns(mlir::OwningRewritePatternList& patterns);
 void populateOutOfBoundsAccessHandlingPatterns(mlir::OwningRewritePatternList& patterns);
+void versionOutOfBoundsAccessLoops(mlir::Operation* op);
 void populateConvergeLoadStoresPatterns(mlir::OwningRewritePatternList& patterns);
+void populateNonTemporalStorePatterns(mlir::OwningRewritePatternList& patterns);
+void promoteReductionAccumulators(mlir::Operation* op);
+void eliminateRedundantCacheFills(mlir::Operation* op);
+void hoistLoopInvariantOps(mlir::Operation* op);
+void addCacheCopyProfileRegions(mlir::Operation* op);
+void outlineCacheCopyRegions(mlir::Operation* op);
+void addLoopProfileRegions(mlir::Operation* op);
+void addFunctionProfileRegion(mlir::Operation* op);
 void populateExecutionPlanThriftyCachePatterns(mlir::OwningRewritePatternList& patterns);
 void populateExecutionPlanDelayedMappingPatterns(mlir::OwningRewritePatternList& patterns);
 void populateExecutionPlanLoopUnswitchingPatterns(mlir::OwningRewritePatternList& patterns);
@@ -45,4 +58,9 @@ std::unique_ptr<mlir::Pass> createExecutionPlanParallelizationPass();
 std::unique_ptr<mlir::Pass> createExecutionPlanTensorizationPass();
 std::unique_ptr<mlir::Pass> createExecutionPlanScaleHoistingPass();
 std::unique_ptr<mlir::Pass> createOutOfBoundsAccessHandlingPass();
+std::unique_ptr<mlir::Pass> createWorkStealingParallelLoweringPass();
+std::unique_ptr<mlir::Pass> createNonTemporalStoreLoweringPass();
+std::unique_ptr<mlir::Pass> createReductionAccumulatorPromotionPass();
+std::unique_ptr<mlir::Pass> createRedundantCacheFillEliminationPass();
+std::unique_ptr<mlir::Pass> createLoopInvariantCodeMotionPass();
 } // namespace accera::transforms::executionPlan
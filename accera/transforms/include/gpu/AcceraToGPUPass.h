@@ -10,6 +10,7 @@
 #include "value/include/FunctionDeclaration.h"
 #include <memory>
 #include <mlir/Dialect/GPU/GPUDialect.h>
+#include <string>
 
 namespace mlir
 {
@@ -50,6 +51,9 @@ void populateAcceraToROCDLPatterns(mlir::OwningRewritePatternList& patterns);
 std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createAcceraToROCDLPass();
 
 std::unique_ptr<mlir::OperationPass<mlir::gpu::GPUModuleOp>> createSerializeToHSACOPass();
+std::unique_ptr<mlir::Pass> createGPUResourceReportPass(const std::string& reportFilename);
+std::unique_ptr<mlir::Pass> createGPUResourceReportPass();
+std::unique_ptr<mlir::OperationPass<mlir::gpu::GPUModuleOp>> createSerializeToHSACOPass(const std::string& chip);
 
 // Abstract method which dispatches to SPIRV, NVVM, or ROCDL depending on the execution environment's runtime
 std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createAcceraToGPUPass(accera::value::ExecutionRuntime runtime);
@@ -36,6 +36,11 @@ namespace transforms::loopnest
         accera::transforms::IntraPassSnapshotOptions snapshotOptions;
         bool printLoops = false;
         bool printVecOpDetails = false;
+        bool reportVectorization = false;
+        bool profileCacheCopies = false;
+        bool profileLoops = false;
+        bool profileFunctions = false;
+        bool outlineCacheCopies = false;
     };
 
     void populateLoopnestToValueFuncPatterns(mlir::OwningRewritePatternList& patterns);
@@ -0,0 +1,39 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+namespace mlir
+{
+class Pass;
+}
+
+namespace accera::transforms
+{
+// Records the number of ops of each function after the major stages of a pipeline, with the wall time that each
+// stage took, and writes them as a JSON report. Stage passes only record what ran before them, so a stage covers
+// the passes added between the previous stage pass and itself.
+class CompileStatsReport
+{
+public:
+    CompileStatsReport(const std::string& reportFilename);
+
+    // The pass that starts the clock of the first stage, added at the start of the pipeline
+    std::unique_ptr<mlir::Pass> CreateStartPass();
+
+    // The pass that records a stage, the report is rewritten by each one so that it's complete up to the last stage
+    // that ran if the pipeline stops early
+    std::unique_ptr<mlir::Pass> CreateStagePass(const std::string& stageName);
+
+    struct State;
+
+private:
+    std::shared_ptr<State> _state;
+};
+
+} // namespace accera::transforms
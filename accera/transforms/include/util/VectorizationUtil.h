@@ -7,6 +7,10 @@
 
 #include "VectorizedOp.h"
 
+#include <ir/include/exec/VectorizationInfo.h>
+#include <ir/include/value/ValueDialect.h>
+
+#include <mlir/Dialect/Affine/IR/AffineOps.h>
 #include <mlir/IR/BlockAndValueMapping.h>
 #include <mlir/IR/Operation.h>
 #include <mlir/IR/PatternMatch.h>
@@ -49,6 +53,17 @@ std::optional<VectorizedOp> VectorizeOp(mlir::PatternRewriter& rewriter,
                                         int64_t step,
                                         int64_t vectorSize);
 
+// Vectorizes op into vectors of vectorSize elements of which only the first activeLanes are valid,
+// using masked loads and stores for the memory accesses
+std::optional<VectorizedOp> VectorizeOpMasked(mlir::PatternRewriter& rewriter,
+                                              mlir::Operation* op,
+                                              const VectorizedOpMap& vectorizedOps,
+                                              std::vector<mlir::BlockAndValueMapping>& laneMappings,
+                                              mlir::Value inductionVar,
+                                              int64_t step,
+                                              int64_t vectorSize,
+                                              int64_t activeLanes);
+
 bool CanVectorizeOp(mlir::Operation* op,
                     const VectorizedOpMap& vectorizedOps,
                     std::vector<mlir::BlockAndValueMapping>& laneMappings,
@@ -56,4 +71,50 @@ bool CanVectorizeOp(mlir::Operation* op,
                     int64_t step,
                     int64_t vectorSize);
 
+// An 8-bit or 16-bit integer or bfloat16 load that is extended to 32 bits before it is multiplied in a dot product
+struct DotProductOperand
+{
+    mlir::Operation* load;
+    bool isUnsigned;
+};
+
+// The scalar computation `C = C + ext(A) * ext(B)` of a dot-product loop
+struct DotProductAccumulation
+{
+    mlir::Operation* storeOp;
+    mlir::Operation* accLoadOp;
+    ir::value::BinOp sumOp;
+    ir::value::BinOp productOp;
+    DotProductOperand lhs;
+    DotProductOperand rhs;
+};
+
+// Matches `C = C + ext(A) * ext(B)` in the body of a loop, where C has the given type and is read and written at the
+// same location in every iteration, and A and B have the given element type
+std::optional<DotProductAccumulation> MatchDotProductAccumulation(mlir::AffineForOp affineForOp, mlir::Type accType, mlir::Type operandType);
+
+// Rewrites the body of a loop that accumulates the products of two 8-bit integer sequences, or on targets with the
+// ARMv7E-M DSP extension two signed 16-bit integer sequences, into one 32-bit integer with the dot-product instructions
+// of the target. Returns false, leaving the loop unchanged, if the body is any other
+// computation or the target has no instructions for it.
+bool VectorizeIntegerDotProduct(mlir::PatternRewriter& rewriter,
+                                mlir::AffineForOp affineForOp,
+                                const ir::executionPlan::VectorizationInfo& vectorInfo,
+                                std::vector<mlir::BlockAndValueMapping>& laneMappings,
+                                int64_t step,
+                                int64_t vectorSize);
+
+// Rewrites the body of a loop that accumulates the products of two bfloat16 sequences into one float32 with the
+// bfloat16 dot-product instructions of the target, in the same way as VectorizeIntegerDotProduct
+bool VectorizeBFloat16DotProduct(mlir::PatternRewriter& rewriter,
+                                 mlir::AffineForOp affineForOp,
+                                 const ir::executionPlan::VectorizationInfo& vectorInfo,
+                                 std::vector<mlir::BlockAndValueMapping>& laneMappings,
+                                 int64_t step,
+                                 int64_t vectorSize);
+
+// Transposes the square matrix held in rows, a power of 2 number of vectors with as many elements as there are
+// vectors, with shuffles. Element c of result r is element r of rows[c]
+std::vector<mlir::Value> CreateTransposedVectors(mlir::OpBuilder& builder, mlir::Location loc, const std::vector<mlir::Value>& rows);
+
 } // namespace accera::transforms
@@ -0,0 +1,23 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <memory>
+
+// fwd decls
+namespace mlir
+{
+class ModuleOp;
+class Pass;
+template <typename OpT>
+class OperationPass;
+} // namespace mlir
+
+namespace accera::transforms::value
+{
+/// <summary> Emits an asynchronous entry point, running on the Accera runtime executor, for each function that requests one </summary>
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createAsyncEntryPointPass();
+} // namespace accera::transforms::value
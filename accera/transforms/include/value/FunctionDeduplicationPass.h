@@ -0,0 +1,22 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <memory>
+
+// fwd decls
+namespace mlir
+{
+class ModuleOp;
+template <typename OpT>
+class OperationPass;
+} // namespace mlir
+
+namespace accera::transforms::value
+{
+/// <summary> Aliases the functions whose lowered bodies are structurally identical to a single implementation </summary>
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createFunctionDeduplicationPass();
+} // namespace accera::transforms::value
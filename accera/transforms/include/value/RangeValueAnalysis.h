@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//  Authors: Abdul Dakkak
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <mlir/IR/AffineExpr.h>
+#include <mlir/IR/AffineMap.h>
+#include <mlir/IR/BuiltinAttributes.h>
+#include <mlir/IR/Operation.h>
+#include <mlir/IR/Value.h>
+
+#include <llvm/ADT/APInt.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/ConstantRange.h>
+#include <llvm/IR/InstrTypes.h>
+#include <llvm/IR/Instruction.h>
+#include <llvm/Support/raw_ostream.h>
+
+namespace accera::transforms::value
+{
+/// The range of values that an integer or index value can take, as a signed 64-bit range
+struct RangeValue
+{
+    static constexpr int maxBitWidth = 64;
+    llvm::ConstantRange range = llvm::ConstantRange::getFull(maxBitWidth);
+    RangeValue()
+    {
+        range = llvm::ConstantRange::getFull(maxBitWidth);
+    }
+    RangeValue(const llvm::ConstantRange& range_) :
+        range(range_)
+    {
+    }
+    RangeValue(int64_t min_, int64_t max_)
+    {
+        range = llvm::ConstantRange::getNonEmpty(llvm::APInt(maxBitWidth, min_, true), llvm::APInt(maxBitWidth, max_ + 1, true));
+    }
+    RangeValue(llvm::APInt min_, llvm::APInt max_)
+    {
+        if (min_.isSingleWord() && max_.isSingleWord())
+        {
+            range = llvm::ConstantRange::getNonEmpty(
+                llvm::APInt(maxBitWidth, min_.getSExtValue(), true),
+                llvm::APInt(maxBitWidth, max_.getSExtValue(), true) + 1);
+        }
+        else
+        {
+            // is not an int64_t, then the range is not valid
+            range = llvm::ConstantRange::getFull(maxBitWidth);
+        }
+    }
+
+    RangeValue binaryOp(llvm::Instruction::BinaryOps op, const RangeValue& other) const
+    {
+        return range.binaryOp(op, other.range);
+    }
+
+    bool icmp(llvm::CmpInst::Predicate op, const RangeValue& other) const
+    {
+        return range.icmp(op, other.range);
+    }
+
+    bool operator==(const RangeValue& other) const
+    {
+        return range == other.range;
+    }
+
+    bool contains(llvm::APInt value) const
+    {
+        return range.contains(value);
+    }
+
+    bool isFullSet() const
+    {
+        return range.isFullSet();
+    }
+
+    bool isConstant() const
+    {
+        return !range.isFullSet() && (range.getLower() + 1 == range.getUpper());
+    }
+
+    /// Whether every value of the range is within [min, max]
+    bool isWithin(int64_t min, int64_t max) const
+    {
+        return !range.isFullSet() && !range.isSignWrappedSet() && range.getSignedMin().sge(llvm::APInt(maxBitWidth, min, true)) && range.getSignedMax().sle(llvm::APInt(maxBitWidth, max, true));
+    }
+
+    mlir::DictionaryAttr asAttr(mlir::MLIRContext* ctx) const;
+};
+
+inline llvm::raw_ostream& operator<<(llvm::raw_ostream& os, RangeValue value)
+{
+    os << value.range;
+    return os;
+}
+
+/// Resolves the ranges of the integer and index values of an op: constants, integer arithmetic, index casts, GPU
+/// thread and block ids, affine maps and the induction variables of scf and affine loops.
+///
+/// Constructed on an op, the analysis resolves the ranges of all the values in it up front. Default-constructed, it
+/// resolves the range of each value it is asked for on demand, along with the values it depends on, which suits
+/// passes that query a few values of IR that they are rewriting.
+struct RangeValueAnalysis
+{
+    RangeValueAnalysis() = default;
+    RangeValueAnalysis(mlir::Operation* rootOp);
+
+    bool hasRange(mlir::Value value) const;
+
+    RangeValue getRange(mlir::Value value) const;
+
+    /// Returns the range of a value, resolving it and the values it depends on if needed
+    RangeValue resolveRange(mlir::Value value);
+
+    /// Returns the range of an affine expression whose dims and symbols take the values of the given operands, the
+    /// dims first
+    RangeValue resolveRange(mlir::AffineExpr expr, mlir::ValueRange operands, unsigned numDims);
+
+private:
+    llvm::DenseMap<mlir::Value, RangeValue> rangeMap;
+
+    static mlir::Value getSingleInductionVar(mlir::Operation* op);
+    bool allOperandsHaveRanges(mlir::Operation* op);
+    llvm::SmallVector<mlir::Value, 4> getRangeOperands(mlir::Operation* op);
+    llvm::SmallVector<RangeValue, 3> resolveOperands(mlir::Operation* op);
+    RangeValue resolveRangeValue(mlir::Operation* op);
+    RangeValue resolveRangeValue(llvm::Instruction::BinaryOps binOp, mlir::Operation* op);
+    RangeValue resolveAffineExpr(mlir::AffineExpr expr, llvm::ArrayRef<RangeValue> operandRanges, unsigned numDims);
+    RangeValue resolveAffineMinMax(mlir::AffineMap map, llvm::ArrayRef<RangeValue> operandRanges, bool isMin);
+};
+
+} // namespace accera::transforms::value
@@ -6,11 +6,14 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <string>
 
 // fwd decls
 namespace mlir
 {
+class FuncOp;
 class MLIRContext;
 class ModuleOp;
 class Pass;
@@ -25,7 +28,12 @@ namespace accera::transforms::value
 
 void populateValueLambdaToFuncPatterns(mlir::MLIRContext* context, mlir::OwningRewritePatternList& patterns);
 void populateValueFuncToTargetPatterns(mlir::MLIRContext* context, mlir::OwningRewritePatternList& patterns);
-void populateValueLaunchFuncInlinerPatterns(mlir::MLIRContext*, mlir::OwningRewritePatternList&);
+void populateValueLaunchFuncInlinerPatterns(mlir::MLIRContext*, mlir::OwningRewritePatternList&, int64_t inlineThreshold = 0);
 
 std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createValueFuncToTargetPass();
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createValueFuncToTargetPass(int64_t inlineThreshold);
+std::unique_ptr<mlir::OperationPass<mlir::FuncOp>> createValueUnrollLoopsPass();
+std::unique_ptr<mlir::OperationPass<mlir::FuncOp>> createValueUnrollLoopsPass(int64_t codeSizeBudget, bool reportUnrolling);
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createUnrollReportPass();
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createUnrollReportPass(const std::string& reportFilename);
 } // namespace accera::transforms::value
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 // fwd decls
 namespace mlir
@@ -24,8 +25,10 @@ namespace accera::transforms::value
 {
 void populateVectorizeValueOpPatterns(mlir::RewritePatternSet& patterns);
 void populateValueToStandardPatterns(bool enableProfiling, mlir::RewritePatternSet& patterns);
+void populateValueToStandardFunctionPatterns(mlir::RewritePatternSet& patterns);
 void populateValueLaunchFuncPatterns(mlir::RewritePatternSet& patterns);
 void populateValueModuleRewritePatterns(mlir::RewritePatternSet& patterns);
 
-std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createValueToStdPass(bool enableProfiling = false);
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createValueToStdPass(bool enableProfiling = false, const std::string& profileCounters = "", const std::string& profileTimer = "clock");
+std::unique_ptr<mlir::OperationPass<mlir::FuncOp>> createValueToStdFunctionPass();
 } // namespace accera::transforms::value
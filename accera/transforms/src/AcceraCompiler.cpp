@@ -0,0 +1,319 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "AcceraCompiler.h"
+#include "AcceraPasses.h"
+
+#include <ir/include/value/ValueDialect.h>
+#include <utilities/include/Exception.h>
+
+#include <mlir/ExecutionEngine/ExecutionEngine.h>
+#include <mlir/ExecutionEngine/OptUtils.h>
+#include <mlir/IR/BuiltinOps.h>
+#include <mlir/IR/Diagnostics.h>
+#include <mlir/Pass/PassManager.h>
+#include <mlir/Support/FileUtilities.h>
+#include <mlir/Support/Timing.h>
+#include <mlir/Target/LLVMIR/Dialect/AMX/AMXToLLVMIRTranslation.h>
+#include <mlir/Target/LLVMIR/Dialect/LLVMIR/LLVMToLLVMIRTranslation.h>
+#include <mlir/Target/LLVMIR/Dialect/OpenMP/OpenMPToLLVMIRTranslation.h>
+#include <mlir/Target/LLVMIR/Export.h>
+
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/Triple.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/MC/SubtargetFeature.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/TargetRegistry.h>
+#include <llvm/Support/ToolOutputFile.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+
+#include <memory>
+#include <vector>
+
+using namespace mlir;
+
+namespace accera::transforms
+{
+namespace
+{
+    using utilities::InputException;
+    using utilities::InputExceptionErrors;
+    using utilities::LogicException;
+    using utilities::LogicExceptionErrors;
+    using utilities::SystemException;
+    using utilities::SystemExceptionErrors;
+
+    std::unique_ptr<llvm::TargetMachine> CreateTargetMachine(const std::string& tripleName, const ObjectCompilerOptions& options)
+    {
+        std::string error;
+        const llvm::Target* target = llvm::TargetRegistry::lookupTarget(tripleName, error);
+        if (target == nullptr)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "Couldn't create target " + error);
+        }
+
+        // Mirrors how llc resolves -mcpu=native
+        auto cpu = options.cpu;
+        std::string features;
+        if (cpu == "native")
+        {
+            cpu = llvm::sys::getHostCPUName().str();
+
+            llvm::SubtargetFeatures hostFeatures;
+            llvm::StringMap<bool> featureMap;
+            if (llvm::sys::getHostCPUFeatures(featureMap))
+            {
+                for (const auto& feature : featureMap)
+                {
+                    hostFeatures.AddFeature(feature.first(), feature.second);
+                }
+            }
+            features = hostFeatures.getString();
+        }
+
+        llvm::TargetOptions targetOptions;
+        if (options.fastFPContract)
+        {
+            targetOptions.AllowFPOpFusion = llvm::FPOpFusion::Fast;
+        }
+
+        auto codeGenOptLevel = options.optLevel >= 3 ? llvm::CodeGenOpt::Aggressive : (options.optLevel == 0 ? llvm::CodeGenOpt::None : llvm::CodeGenOpt::Default);
+        std::unique_ptr<llvm::TargetMachine> targetMachine(target->createTargetMachine(tripleName,
+                                                                                       cpu,
+                                                                                       features,
+                                                                                       targetOptions,
+                                                                                       llvm::Reloc::PIC_,
+                                                                                       llvm::None,
+                                                                                       codeGenOptLevel));
+        if (!targetMachine)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "Unable to allocate target machine for " + tripleName);
+        }
+        return targetMachine;
+    }
+
+    // Collects the diagnostics of a context, which the exceptions report the way acc-opt would have printed them
+    class DiagnosticCollector
+    {
+    public:
+        DiagnosticCollector(MLIRContext* context) :
+            _stream(_diagnostics),
+            _handler(context, [this](Diagnostic& diagnostic) {
+                _stream << diagnostic.getLocation() << ": " << diagnostic << "\n";
+                return success();
+            })
+        {}
+
+        std::string str() { return _stream.str(); }
+
+    private:
+        std::string _diagnostics;
+        llvm::raw_string_ostream _stream;
+        ScopedDiagnosticHandler _handler;
+    };
+
+    void RegisterLLVMTranslations(MLIRContext* context)
+    {
+        DialectRegistry registry;
+        registerLLVMDialectTranslation(registry);
+        registerOpenMPDialectTranslation(registry);
+        registerAMXDialectTranslation(registry);
+        context->appendDialectRegistry(registry);
+    }
+
+    // acc-opt --verify-each=false --acc-to-llvm="..."
+    void LowerToLLVMDialect(ModuleOp module, const std::string& options, const std::string& passTimingPath)
+    {
+        DiagnosticCollector diagnostics(module.getContext());
+
+        AcceraPassPipelineOptions pipelineOptions;
+        if (failed(pipelineOptions.parseFromString(options)))
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "Invalid acc-to-llvm options: " + options);
+        }
+
+        // acc-opt --mlir-timing --mlir-timing-display=list, into a file rather than stderr
+        std::unique_ptr<llvm::ToolOutputFile> passTimingFile;
+        if (!passTimingPath.empty())
+        {
+            std::string error;
+            passTimingFile = openOutputFile(passTimingPath, &error);
+            if (!passTimingFile)
+            {
+                throw SystemException(SystemExceptionErrors::fileNotWritable, "Couldn't open " + passTimingPath + ": " + error);
+            }
+        }
+
+        {
+            PassManager pm(module.getContext());
+            pm.enableVerifier(false);
+            if (passTimingFile)
+            {
+                auto timingManager = std::make_unique<DefaultTimingManager>();
+                timingManager->setEnabled(true);
+                timingManager->setDisplayMode(DefaultTimingManager::DisplayMode::List);
+                timingManager->setOutput(passTimingFile->os());
+                pm.enableTiming(std::move(timingManager));
+            }
+            addAcceraToLLVMPassPipeline(pm, pipelineOptions);
+            if (failed(pm.run(module)))
+            {
+                throw LogicException(LogicExceptionErrors::illegalState, "Lowering the module failed\n" + diagnostics.str());
+            }
+        } // the timing report is printed when the pass manager is destroyed
+        if (passTimingFile)
+        {
+            passTimingFile->keep();
+        }
+    }
+
+    void EmitFile(llvm::Module& llvmModule, llvm::TargetMachine& targetMachine, const std::string& path, llvm::CodeGenFileType fileType)
+    {
+        std::error_code errorCode;
+        llvm::raw_fd_ostream stream(path, errorCode, fileType == llvm::CGFT_AssemblyFile ? llvm::sys::fs::OF_Text : llvm::sys::fs::OF_None);
+        if (errorCode)
+        {
+            throw SystemException(SystemExceptionErrors::fileNotWritable, "Couldn't open " + path + ": " + errorCode.message());
+        }
+
+        llvm::legacy::PassManager codegenPasses;
+        if (targetMachine.addPassesToEmitFile(codegenPasses, stream, nullptr, fileType))
+        {
+            throw LogicException(LogicExceptionErrors::notImplemented, "The target can't emit this type of file");
+        }
+        codegenPasses.run(llvmModule);
+    }
+} // namespace
+
+void CompileToObject(ModuleOp module, const ObjectCompilerOptions& options)
+{
+    auto context = module.getContext();
+    LowerToLLVMDialect(module, options.pipelineOptions, options.passTimingPath);
+
+    // mlir-translate --mlir-to-llvmir
+    RegisterLLVMTranslations(context);
+
+    DiagnosticCollector diagnostics(context);
+    llvm::LLVMContext llvmContext;
+    auto llvmModule = translateModuleToLLVMIR(module, llvmContext);
+    if (!llvmModule)
+    {
+        throw LogicException(LogicExceptionErrors::illegalState, "Translating the module to LLVM IR failed\n" + diagnostics.str());
+    }
+
+    auto triple = options.triple;
+    if (triple.empty())
+    {
+        triple = llvmModule->getTargetTriple().empty() ? llvm::sys::getDefaultTargetTriple() : llvmModule->getTargetTriple();
+    }
+    triple = llvm::Triple::normalize(triple);
+
+    auto targetMachine = CreateTargetMachine(triple, options);
+    llvmModule->setTargetTriple(triple);
+    llvmModule->setDataLayout(targetMachine->createDataLayout());
+
+    // opt -O<n>
+    auto optimize = makeOptimizingTransformer(options.optLevel, options.sizeLevel, targetMachine.get());
+    if (auto error = optimize(llvmModule.get()))
+    {
+        throw LogicException(LogicExceptionErrors::illegalState, "Optimizing the LLVM IR failed: " + llvm::toString(std::move(error)));
+    }
+
+    // llc -filetype=asm and llc -filetype=obj, codegen changes the IR so the assembly is emitted from a copy
+    if (!options.asmPath.empty())
+    {
+        auto asmModule = llvm::CloneModule(*llvmModule);
+        EmitFile(*asmModule, *targetMachine, options.asmPath, llvm::CGFT_AssemblyFile);
+    }
+    EmitFile(*llvmModule, *targetMachine, options.objectPath, llvm::CGFT_ObjectFile);
+}
+
+JITEngine::JITEngine(std::unique_ptr<ExecutionEngine> engine) :
+    _engine(std::move(engine))
+{}
+
+JITEngine::~JITEngine() = default;
+
+void JITEngine::Invoke(const std::string& functionName, std::vector<void*>& argumentAddresses) const
+{
+    // Every function has a packed wrapper that takes the addresses of its arguments
+    if (auto error = _engine->invokePacked(functionName, argumentAddresses))
+    {
+        throw InputException(InputExceptionErrors::invalidArgument, "Couldn't call " + functionName + ": " + llvm::toString(std::move(error)));
+    }
+}
+
+std::unique_ptr<JITEngine> JITCompile(ModuleOp module, const std::vector<ModuleOp>& supportingModules, const JITCompilerOptions& options)
+{
+    std::vector<ModuleOp> modules{ module };
+    modules.insert(modules.end(), supportingModules.begin(), supportingModules.end());
+    for (auto m : modules)
+    {
+        // The packed buffers are read from files next to the library at runtime, which the JIT has no place for
+        auto isMapped = m.walk([](Operation* op) {
+                             return op->hasAttr(ir::value::MappedFileAttrName) ? WalkResult::interrupt() : WalkResult::advance();
+                         })
+                            .wasInterrupted();
+        if (isMapped)
+        {
+            throw LogicException(LogicExceptionErrors::notImplemented, "Buffers that are memory-mapped from files can't be JIT-compiled");
+        }
+    }
+    for (auto m : modules)
+    {
+        LowerToLLVMDialect(m, options.pipelineOptions, "");
+        RegisterLLVMTranslations(m.getContext());
+    }
+
+    auto tmBuilder = llvm::orc::JITTargetMachineBuilder::detectHost();
+    if (!tmBuilder)
+    {
+        throw LogicException(LogicExceptionErrors::illegalState, "Couldn't detect the host: " + llvm::toString(tmBuilder.takeError()));
+    }
+    auto targetMachine = tmBuilder->createTargetMachine();
+    if (!targetMachine)
+    {
+        throw LogicException(LogicExceptionErrors::illegalState, "Couldn't create a target machine for the host: " + llvm::toString(targetMachine.takeError()));
+    }
+
+    // The supporting modules are translated into the LLVM context of the JIT and linked into the module
+    DiagnosticCollector diagnostics(module.getContext());
+    auto buildLLVMModule = [&](ModuleOp, llvm::LLVMContext& llvmContext) -> std::unique_ptr<llvm::Module> {
+        auto llvmModule = translateModuleToLLVMIR(module, llvmContext);
+        if (!llvmModule)
+        {
+            return nullptr;
+        }
+        for (auto supportingModule : supportingModules)
+        {
+            auto supportingLLVMModule = translateModuleToLLVMIR(supportingModule, llvmContext);
+            if (!supportingLLVMModule || llvm::Linker::linkModules(*llvmModule, std::move(supportingLLVMModule)))
+            {
+                return nullptr;
+            }
+        }
+        return llvmModule;
+    };
+
+    auto optimize = makeOptimizingTransformer(options.optLevel, options.sizeLevel, targetMachine->get());
+    auto codeGenOptLevel = options.optLevel >= 3 ? llvm::CodeGenOpt::Aggressive : (options.optLevel == 0 ? llvm::CodeGenOpt::None : llvm::CodeGenOpt::Default);
+    llvm::SmallVector<llvm::StringRef, 4> sharedLibraryPaths(options.sharedLibraryPaths.begin(), options.sharedLibraryPaths.end());
+    auto engine = ExecutionEngine::create(module, buildLLVMModule, optimize, codeGenOptLevel, sharedLibraryPaths);
+    if (!engine)
+    {
+        throw LogicException(LogicExceptionErrors::illegalState, "JIT-compiling the module failed: " + llvm::toString(engine.takeError()) + "\n" + diagnostics.str());
+    }
+    return std::make_unique<JITEngine>(std::move(*engine));
+}
+
+} // namespace accera::transforms
@@ -5,6 +5,7 @@
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "AcceraPasses.h"
+#include "util/CompileStatsReport.h"
 
 #include <ir/include/InitializeAccera.h>
 #include <value/include/TargetDevice.h>
@@ -16,6 +17,8 @@
 #include <llvm/Support/CommandLine.h>
 #include <llvm/Support/FormatVariadic.h>
 
+#include <optional>
+
 using namespace llvm;
 using namespace mlir;
 
@@ -145,29 +148,106 @@ void addAcceraToLLVMPassPipeline(OpPassManager& pm, const AcceraPassPipelineOpti
 
     PassManagerAdaptor pmAdaptor(pm, options.dumpPasses.getValue(), options.basename);
 
+    // The stages are recorded between the nested pass managers, which run where they were first added
+    std::optional<CompileStatsReport> compileStats;
+    if (!options.compileStatsReport.empty())
+    {
+        compileStats.emplace(options.compileStatsReport.getValue());
+        pm.addPass(compileStats->CreateStartPass());
+    }
+    auto addCompileStatsStage = [&](const std::string& stageName) {
+        if (compileStats)
+        {
+            pm.addPass(compileStats->CreateStagePass(stageName));
+        }
+    };
+
     auto valueFuncOpPM = pmAdaptor.nestPassManager([&]() -> OpPassManager& { return pm.nest<v::ValueModuleOp>().nest<v::ValueFuncOp>(); });
 
     // Can't use ValueSimplify here because ExecToAffine doesn't know how to handle "simplified" ops (memref::SubView, etc.)
     // valueFuncOpPM.addPass(value::createValueSimplifyPass());
 
     valueFuncOpPM.addPass(createCanonicalizerPass());
-    valueFuncOpPM.addPass(loopnest::createLoopNestToValueFuncPass({ { options.dumpIntraPassIR.getValue(), options.basename + "LoopNestToValueFuncPass_Subpasses" }, options.printLoops.getValue(), options.printVecOpDetails.getValue() }));
-
+    // The profile regions are only inserted if they're timed, the cache copy report times its regions itself
+    loopnest::LoopNestToValueFuncOptions loopNestOptions{ { options.dumpIntraPassIR.getValue(), options.basename + "LoopNestToValueFuncPass_Subpasses" }, options.printLoops.getValue(), options.printVecOpDetails.getValue(), !options.vectorizationReport.empty() };
+    loopNestOptions.profileCacheCopies = (options.enableProfile && options.profileCacheCopies) || !options.cacheCopyReport.empty();
+    loopNestOptions.profileLoops = options.enableProfile && options.profileLoops;
+    loopNestOptions.profileFunctions = options.enableProfile && options.profileFunctions;
+    loopNestOptions.outlineCacheCopies = options.outlineCacheCopies;
+    valueFuncOpPM.addPass(loopnest::createLoopNestToValueFuncPass(loopNestOptions));
+    addCompileStatsStage("LoopNestToValueFunc");
+
+    if (!options.vectorizationReport.empty())
+    {
+        pmAdaptor.addPass(executionPlan::createVectorizationReportPass(options.vectorizationReport.getValue()));
+    }
+    if (!options.costModelReport.empty())
+    {
+        pmAdaptor.addPass(executionPlan::createCostModelReportPass(options.costModelReport.getValue()));
+    }
+    if (!options.cacheCopyReport.empty())
+    {
+        pmAdaptor.addPass(executionPlan::createCacheCopyReportPass(options.cacheCopyReport.getValue()));
+    }
+    if (options.analysisOnly) return;
+    if (options.countMemoryTraffic)
+    {
+        // Before the cache memory planning turns the cache globals into views of an arena
+        pmAdaptor.addPass(executionPlan::createMemoryTrafficInstrumentationPass());
+    }
+    if (options.planCacheMemory || options.staticArena)
+    {
+        pmAdaptor.addPass(executionPlan::createCacheMemoryPlanningPass(options.printMemoryPlan.getValue(), options.staticArena.getValue(), options.arenaReport.getValue()));
+    }
     pmAdaptor.addPass(value::createValueFuncToTargetPass());
     pmAdaptor.addPass(createSymbolDCEPass());
+    if (!options.lineInfo.empty())
+    {
+        // The ops are located at their line in the listing of the functions, whose loops are still marked with their
+        // indices. The lowering passes the locations on to the ops that they lower to, and the LLVM translation turns
+        // them into the debug line info, with a subprogram for each function
+        pmAdaptor.addPass(createLocationSnapshotPass(OpPrintingFlags{}, options.lineInfo.getValue()));
+    }
+    addCompileStatsStage("ValueFuncToTarget");
 
     auto funcOpPM = pmAdaptor.nestPassManager([&]() -> OpPassManager& { return pm.nest<v::ValueModuleOp>().nest<FuncOp>(); });
+    funcOpPM.addPass(value::createValueUnrollLoopsPass(options.unrollCodeSizeBudget.getValue(), !options.unrollReport.empty()));
     funcOpPM.addPass(createConvertLinalgToAffineLoopsPass());
     funcOpPM.addPass(createSimplifyAffineStructuresPass());
     funcOpPM.addPass(createCanonicalizerPass());
+    funcOpPM.addPass(executionPlan::createNonTemporalStoreLoweringPass());
+    funcOpPM.addPass(executionPlan::createReductionAccumulatorPromotionPass());
+    funcOpPM.addPass(executionPlan::createRedundantCacheFillEliminationPass());
+    funcOpPM.addPass(value::createIndexArithmeticOptimizePass());
     funcOpPM.addPass(createLowerAffinePass());
+    funcOpPM.addPass(executionPlan::createWorkStealingParallelLoweringPass());
     funcOpPM.addPass(createConvertSCFToOpenMPPass());
+    funcOpPM.addPass(value::createValueToStdFunctionPass());
 
-    pmAdaptor.addPass(value::createValueToStdPass(options.enableProfile));
+    if (!options.unrollReport.empty())
+    {
+        pmAdaptor.addPass(value::createUnrollReportPass(options.unrollReport.getValue()));
+    }
+    // The cache copy regions are only useful if they're timed
+    pmAdaptor.addPass(value::createValueToStdPass(options.enableProfile || !options.cacheCopyReport.empty(), options.profileCounters, options.profileTimer));
+    pmAdaptor.addPass(value::createWorkspaceArgumentPass());
+    addCompileStatsStage("ValueToStd");
     funcOpPM.addPass(value::createBarrierOptPass(options.writeBarrierGraph.getValue(), options.barrierGraphFilename.getValue()));
-    pmAdaptor.addPass(value::createRangeValueOptimizePass());
-    pmAdaptor.addPass(createCanonicalizerPass());
-    pmAdaptor.addPass(createCSEPass());
+
+    // The value module is gone after ValueToStd, the CPU functions are at the top level and the GPU functions are in
+    // their GPU modules. These passes only look at one function at a time, so the functions are processed concurrently
+    auto loweredFuncOpPM = pmAdaptor.nestPassManager([&]() -> OpPassManager& { return pm.nest<FuncOp>(); });
+    auto gpuFuncOpPM = pmAdaptor.nestPassManager([&]() -> OpPassManager& { return pm.nest<gpu::GPUModuleOp>().nest<gpu::GPUFuncOp>(); });
+    loweredFuncOpPM.addPass(value::createRangeValueOptimizePass());
+    loweredFuncOpPM.addPass(createCanonicalizerPass());
+    loweredFuncOpPM.addPass(createCSEPass());
+    gpuFuncOpPM.addPass(value::createRangeValueOptimizePass());
+    gpuFuncOpPM.addPass(createCanonicalizerPass());
+    gpuFuncOpPM.addPass(createCSEPass());
+    addCompileStatsStage("RangeValueOptimize");
+
+    // Variants of a parameter sweep often lower to the same code, which only needs to be compiled once
+    pmAdaptor.addPass(value::createFunctionDeduplicationPass());
 
     pmAdaptor.addPass(createGpuKernelOutliningPass());
     auto gpuPass = createAcceraToGPUPass(execRuntime);
@@ -175,6 +255,11 @@ void addAcceraToLLVMPassPipeline(OpPassManager& pm, const AcceraPassPipelineOpti
     {
         pmAdaptor.addPass(std::move(gpuPass));
     }
+    if (!options.gpuResourceReport.empty())
+    {
+        pmAdaptor.addPass(createGPUResourceReportPass(options.gpuResourceReport.getValue()));
+    }
+    addCompileStatsStage("AcceraToGPU");
 
     if (execRuntime == accera::value::ExecutionRuntime::VULKAN)
     {
@@ -195,12 +280,16 @@ void addAcceraToLLVMPassPipeline(OpPassManager& pm, const AcceraPassPipelineOpti
     funcOpPM.addPass(createConvertVectorToSCFPass(
         VectorTransferToSCFOptions{} /*.setLowerPermutationMaps(true) .setLowerTensors(true).setUnroll(true) */));
     pmAdaptor.addPass(createLowerToCFGPass());
+    addCompileStatsStage("LowerToCFG");
 
     if (execRuntime != accera::value::ExecutionRuntime::VULKAN)
     {
         PassManagerAdaptor gpuModulePM(pm.nest<gpu::GPUModuleOp>(), options.dumpPasses.getValue(), options.basename + "_rocm_module");
         gpuModulePM.addPass(createLowerGpuOpsToROCDLOpsPass(kDeriveIndexBitwidthFromDataLayout));
-        // gpuModulePM.addPass(createSerializeToHSACOPass());
+        if (execRuntime == accera::value::ExecutionRuntime::ROCM)
+        {
+            gpuModulePM.addPass(createSerializeToHSACOPass(options.gpuChip.getValue()));
+        }
 
         PassManagerAdaptor funcPm(pm.nest<FuncOp>(), options.dumpPasses.getValue(), options.basename + "_fun_op");
         if (options.enableAsync) funcPm.addPass(createGpuAsyncRegionPass());
@@ -213,6 +302,12 @@ void addAcceraToLLVMPassPipeline(OpPassManager& pm, const AcceraPassPipelineOpti
         /* useAlignedAlloc = */ true,
         /* dataLayout = */ llvm::DataLayout(accera::value::GetTargetDevice(options.target).dataLayout),
         { options.dumpIntraPassIR.getValue(), options.basename + "ValueToLLVM_Subpasses" }));
+    if (execRuntime == accera::value::ExecutionRuntime::THREAD_POOL)
+    {
+        pmAdaptor.addPass(value::createThreadPoolDispatchPass());
+    }
+    addCompileStatsStage("ValueToLLVM");
+    pmAdaptor.addPass(value::createAsyncEntryPointPass());
     pmAdaptor.addPass(createCanonicalizerPass());
     pmAdaptor.addPass(LLVM::createLegalizeForExportPass());
     pmAdaptor.addPass(value::createFunctionPointerResolutionPass());
@@ -231,6 +326,7 @@ void addAcceraToLLVMPassPipeline(OpPassManager& pm, const AcceraPassPipelineOpti
             pmAdaptor.addPass(createConvertAsyncToLLVMPass());
         }
     }
+    addCompileStatsStage("GpuToLLVM");
 }
 
 void registerAcceraToLLVMPipeline()
@@ -0,0 +1,227 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "exec/CacheCopyReportPass.h"
+#include "AcceraPasses.h"
+
+#include <ir/include/exec/ExecutionPlanOps.h>
+#include <ir/include/value/ValueDialect.h>
+
+#include <mlir/Analysis/LoopAnalysis.h>
+#include <mlir/Dialect/Affine/IR/AffineOps.h>
+#include <mlir/Dialect/Affine/IR/AffineMemoryOpInterfaces.h>
+#include <mlir/Dialect/MemRef/IR/MemRef.h>
+#include <mlir/Dialect/Vector/VectorOps.h>
+#include <mlir/IR/BuiltinTypes.h>
+#include <mlir/Pass/Pass.h>
+#include <mlir/Support/FileUtilities.h>
+
+#include <llvm/ADT/MapVector.h>
+#include <llvm/ADT/Optional.h>
+#include <llvm/Support/FormatVariadic.h>
+#include <llvm/Support/JSON.h>
+#include <llvm/Support/ToolOutputFile.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <string>
+
+using namespace mlir;
+
+using namespace accera::ir;
+using namespace accera::transforms;
+
+namespace vir = accera::ir::value;
+namespace xpir = accera::ir::executionPlan;
+
+namespace
+{
+int64_t GetSizeInBytes(Type type)
+{
+    if (auto vectorType = type.dyn_cast<VectorType>())
+    {
+        return (vectorType.getNumElements() * vectorType.getElementTypeBitWidth() + 7) / 8;
+    }
+    if (type.isIntOrFloat())
+    {
+        return (type.getIntOrFloatBitWidth() + 7) / 8;
+    }
+    // index
+    return 8;
+}
+
+// The bytes that a memory access op reads or writes, 0 for the other ops
+int64_t GetAccessBytes(Operation* op)
+{
+    if (auto readOp = dyn_cast<AffineReadOpInterface>(op))
+    {
+        return GetSizeInBytes(readOp.getValue().getType());
+    }
+    if (auto writeOp = dyn_cast<AffineWriteOpInterface>(op))
+    {
+        return GetSizeInBytes(writeOp.getValueToStore().getType());
+    }
+    if (auto loadOp = dyn_cast<memref::LoadOp>(op))
+    {
+        return GetSizeInBytes(loadOp.getType());
+    }
+    if (auto storeOp = dyn_cast<memref::StoreOp>(op))
+    {
+        return GetSizeInBytes(storeOp.getValueToStore().getType());
+    }
+    if (auto transferReadOp = dyn_cast<vector::TransferReadOp>(op))
+    {
+        return GetSizeInBytes(transferReadOp.getVectorType());
+    }
+    if (auto transferWriteOp = dyn_cast<vector::TransferWriteOp>(op))
+    {
+        return GetSizeInBytes(transferWriteOp.getVectorType());
+    }
+    return 0;
+}
+
+// The bytes that one run of a profile region reads and writes, counting each access once per iteration of the loops
+// around it in the region, or None if a loop has no constant trip count. The conditions of the boundary blocks
+// aren't evaluated, so the bytes of a region with partial blocks are an upper bound.
+llvm::Optional<int64_t> GetRegionBytes(Operation* enterOp, Operation* exitOp)
+{
+    auto regionParent = enterOp->getParentOp();
+    int64_t bytes = 0;
+    bool known = true;
+    for (auto op = enterOp->getNextNode(); op && op != exitOp; op = op->getNextNode())
+    {
+        op->walk([&](Operation* nestedOp) {
+            auto accessBytes = GetAccessBytes(nestedOp);
+            if (!accessBytes)
+            {
+                return;
+            }
+            for (auto parentOp = nestedOp->getParentOp(); parentOp != regionParent; parentOp = parentOp->getParentOp())
+            {
+                if (auto forOp = dyn_cast<AffineForOp>(parentOp))
+                {
+                    auto tripCount = getConstantTripCount(forOp);
+                    if (!tripCount)
+                    {
+                        known = false;
+                        return;
+                    }
+                    accessBytes *= static_cast<int64_t>(*tripCount);
+                }
+            }
+            bytes += accessBytes;
+        });
+    }
+    if (!known)
+    {
+        return llvm::None;
+    }
+    return bytes;
+}
+
+Operation* FindRegionExit(vir::EnterProfileRegionOp enterOp)
+{
+    for (auto op = enterOp->getNextNode(); op; op = op->getNextNode())
+    {
+        auto exitOp = dyn_cast<vir::ExitProfileRegionOp>(op);
+        if (exitOp && exitOp.regionName() == enterOp.regionName())
+        {
+            return op;
+        }
+    }
+    return nullptr;
+}
+
+struct CacheCopyRegion
+{
+    std::string function;
+    std::string kind;
+    llvm::Optional<int64_t> bytes;
+};
+
+struct CacheCopyReportPass : public CacheCopyReportBase<CacheCopyReportPass>
+{
+    CacheCopyReportPass() = default;
+    CacheCopyReportPass(const std::string& reportFilename)
+    {
+        this->reportFilename = reportFilename;
+    }
+
+    void runOnModule() final
+    {
+        auto module = getModule();
+
+        // The loops that are unswitched copy their regions, each run of the region runs one of the copies
+        llvm::MapVector<StringRef, CacheCopyRegion> regions;
+        module.walk([&](vir::EnterProfileRegionOp enterOp) {
+            auto kindAttr = enterOp->getAttrOfType<StringAttr>(xpir::CacheCopyRegionAttrName);
+            auto exitOp = FindRegionExit(enterOp);
+            if (!kindAttr || !exitOp)
+            {
+                return;
+            }
+
+            auto bytes = GetRegionBytes(enterOp, exitOp);
+            auto [it, inserted] = regions.insert({ enterOp.regionName(), CacheCopyRegion{} });
+            auto& region = it->second;
+            if (inserted)
+            {
+                if (auto funcOp = enterOp->getParentOfType<vir::ValueFuncOp>())
+                {
+                    region.function = funcOp.sym_name().str();
+                }
+                region.kind = kindAttr.getValue().str();
+                region.bytes = bytes;
+            }
+            else if (region.bytes)
+            {
+                region.bytes = bytes ? llvm::Optional<int64_t>(std::max(*region.bytes, *bytes)) : llvm::None;
+            }
+        });
+
+        llvm::json::Array regionEntries;
+        for (auto& [name, region] : regions)
+        {
+            regionEntries.push_back(llvm::json::Object{
+                { "name", name.str() },
+                { "function", region.function },
+                { "kind", region.kind },
+                { "bytes", region.bytes ? llvm::json::Value(*region.bytes) : llvm::json::Value(nullptr) } });
+        }
+
+        llvm::json::Value result = llvm::json::Object{ { "regions", std::move(regionEntries) } };
+        if (reportFilename.empty())
+        {
+            llvm::errs() << llvm::formatv("{0:2}", result) << "\n";
+            return;
+        }
+
+        std::string error;
+        auto reportFile = mlir::openOutputFile(reportFilename, &error);
+        if (!reportFile)
+        {
+            module.emitError() << error;
+            signalPassFailure();
+            return;
+        }
+        reportFile->os() << llvm::formatv("{0:2}", result) << "\n";
+        reportFile->keep();
+    }
+};
+
+} // namespace
+
+namespace accera::transforms::executionPlan
+{
+std::unique_ptr<mlir::Pass> createCacheCopyReportPass(const std::string& reportFilename)
+{
+    return std::make_unique<CacheCopyReportPass>(reportFilename);
+}
+
+std::unique_ptr<mlir::Pass> createCacheCopyReportPass()
+{
+    return std::make_unique<CacheCopyReportPass>();
+}
+} // namespace accera::transforms::executionPlan
@@ -0,0 +1,600 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "exec/CacheMemoryPlanningPass.h"
+#include "AcceraPasses.h"
+
+#include <ir/include/IRUtil.h>
+#include <ir/include/exec/ExecutionPlanOps.h>
+#include <ir/include/value/ValueDialect.h>
+
+#include <mlir/Dialect/MemRef/IR/MemRef.h>
+#include <mlir/Dialect/SCF/SCF.h>
+#include <mlir/Dialect/StandardOps/IR/Ops.h>
+#include <mlir/IR/Builders.h>
+#include <mlir/Interfaces/CallInterfaces.h>
+#include <mlir/Interfaces/LoopLikeInterface.h>
+#include <mlir/Interfaces/ViewLikeInterface.h>
+#include <mlir/Pass/Pass.h>
+#include <mlir/Support/FileUtilities.h>
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Support/FormatVariadic.h>
+#include <llvm/Support/JSON.h>
+#include <llvm/Support/ToolOutputFile.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <vector>
+
+using namespace mlir;
+
+using namespace accera::ir;
+using namespace accera::transforms;
+
+namespace vir = accera::ir::value;
+
+namespace
+{
+// The buffers are placed at offsets that are multiples of a cache line so that they don't share lines with each other
+constexpr int64_t ArenaBufferAlignment = 64;
+
+struct CacheBuffer
+{
+    // Either a cache buffer global and its references, or a temporary array
+    vir::GlobalOp global;
+    std::vector<vir::ReferenceGlobalOp> references;
+    vir::AllocOp alloc;
+    int64_t sizeInBytes = 0;
+
+    // The range of op numbers of the function during which the buffer holds live data
+    size_t liveBegin = 0;
+    size_t liveEnd = 0;
+
+    int64_t offset = 0;
+};
+
+// The range of op numbers spanned by each op and the ops nested in it
+using OpSpans = llvm::DenseMap<Operation*, std::pair<size_t, size_t>>;
+
+void NumberOps(Operation* op, OpSpans& spans, size_t& counter)
+{
+    auto begin = counter++;
+    for (auto& region : op->getRegions())
+    {
+        for (auto& block : region)
+        {
+            for (auto& nestedOp : block)
+            {
+                NumberOps(&nestedOp, spans, counter);
+            }
+        }
+    }
+    spans[op] = { begin, counter - 1 };
+}
+
+bool IsMemRefType(Type type)
+{
+    return type.isa<MemRefType, UnrankedMemRefType>();
+}
+
+bool IsViewOp(Operation* op)
+{
+    return isa<ViewLikeOpInterface,
+               vir::ViewOp,
+               vir::SliceOp,
+               vir::MergeDimOp,
+               vir::SplitDimOp,
+               vir::ReshapeOp,
+               vir::ReorderOp,
+               vir::MemRefCastOp>(op);
+}
+
+// Collects the ops that may access the memory of the given memref, directly or through the memrefs derived from it.
+// Returns false if the memref escapes the function, in which case its lifetime isn't known
+bool CollectAccesses(mlir::Value memref, std::vector<Operation*>& accesses)
+{
+    for (auto user : memref.getUsers())
+    {
+        if (user->hasTrait<OpTrait::IsTerminator>())
+        {
+            return false;
+        }
+        if (!IsViewOp(user))
+        {
+            accesses.push_back(user);
+        }
+        for (auto result : user->getResults())
+        {
+            if (IsMemRefType(result.getType()) && !CollectAccesses(result, accesses))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+Block* GetCommonAncestorBlock(const std::vector<Operation*>& ops)
+{
+    auto commonBlock = ops.front()->getBlock();
+    for (auto op : ops)
+    {
+        while (commonBlock && !commonBlock->findAncestorOpInBlock(*op))
+        {
+            auto parentOp = commonBlock->getParentOp();
+            commonBlock = parentOp ? parentOp->getBlock() : nullptr;
+        }
+    }
+    return commonBlock;
+}
+
+// Computes the range of op numbers during which the data in the buffer accessed by the given ops is live
+void ComputeLiveRange(Operation* funcOp, const OpSpans& spans, const std::vector<Operation*>& accesses, CacheBuffer& buffer)
+{
+    auto block = GetCommonAncestorBlock(accesses);
+    assert(block && "Cache buffer accesses must be nested in the function");
+
+    auto begin = std::numeric_limits<size_t>::max();
+    size_t end = 0;
+    for (auto op : accesses)
+    {
+        auto [opBegin, opEnd] = spans.lookup(block->findAncestorOpInBlock(*op));
+        begin = std::min(begin, opBegin);
+        end = std::max(end, opEnd);
+    }
+
+    // Data written in one iteration of a loop can be read in the next one, so a buffer used
+    // in a loop is live for all of the iterations of the outermost loop that contains its uses
+    for (auto parentOp = block->getParentOp(); parentOp && parentOp != funcOp; parentOp = parentOp->getParentOp())
+    {
+        if (isa<LoopLikeOpInterface, scf::WhileOp>(parentOp))
+        {
+            std::tie(begin, end) = spans.lookup(parentOp);
+        }
+    }
+
+    buffer.liveBegin = begin;
+    buffer.liveEnd = end;
+}
+
+bool IsPlannableBufferType(MemRefType type)
+{
+    auto layoutMaps = type.getAffineMaps();
+    auto hasIdentityLayout = layoutMaps.empty() || (layoutMaps.size() == 1 && layoutMaps.front().isIdentity());
+    auto elementType = type.getElementType();
+    return type.hasStaticShape() &&
+           hasIdentityLayout &&
+           elementType.isIntOrFloat() &&
+           elementType.getIntOrFloatBitWidth() % 8 == 0;
+}
+
+int64_t AlignUp(int64_t value, int64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Assigns each buffer the lowest offset that doesn't overlap the buffers already placed that are live at the same time,
+// placing the largest buffers first. Returns the size of the arena
+int64_t AssignOffsets(std::vector<CacheBuffer>& buffers)
+{
+    std::vector<CacheBuffer*> order;
+    for (auto& buffer : buffers)
+    {
+        order.push_back(&buffer);
+    }
+    std::stable_sort(order.begin(), order.end(), [](CacheBuffer* lhs, CacheBuffer* rhs) {
+        return lhs->sizeInBytes > rhs->sizeInBytes;
+    });
+
+    int64_t arenaSize = 0;
+    std::vector<CacheBuffer*> placed;
+    for (auto buffer : order)
+    {
+        std::vector<CacheBuffer*> conflicts;
+        std::copy_if(placed.begin(), placed.end(), std::back_inserter(conflicts), [&](CacheBuffer* other) {
+            return other->liveBegin <= buffer->liveEnd && buffer->liveBegin <= other->liveEnd;
+        });
+        std::sort(conflicts.begin(), conflicts.end(), [](CacheBuffer* lhs, CacheBuffer* rhs) {
+            return lhs->offset < rhs->offset;
+        });
+
+        int64_t offset = 0;
+        for (auto other : conflicts)
+        {
+            if (offset + buffer->sizeInBytes <= other->offset)
+            {
+                break;
+            }
+            offset = std::max(offset, AlignUp(other->offset + other->sizeInBytes, ArenaBufferAlignment));
+        }
+
+        buffer->offset = offset;
+        arenaSize = std::max(arenaSize, offset + buffer->sizeInBytes);
+        placed.push_back(buffer);
+    }
+    return arenaSize;
+}
+
+int64_t GetSizeInBytes(MemRefType type)
+{
+    return type.getNumElements() * type.getElementTypeBitWidth() / 8;
+}
+
+// Replaces the buffer by a view of its memory in the arena
+void ReplaceWithArenaView(OpBuilder& builder, vir::GlobalOp arenaGlobal, CacheBuffer& buffer, int64_t offset)
+{
+    auto replace = [&](Operation* op, MemRefType type) {
+        builder.setInsertionPoint(op);
+        auto loc = op->getLoc();
+        auto arena = builder.create<vir::ReferenceGlobalOp>(loc, arenaGlobal);
+        auto offsetValue = builder.create<ConstantIndexOp>(loc, offset);
+        auto view = builder.create<memref::ViewOp>(loc, type, arena, offsetValue, ValueRange{});
+        op->getResult(0).replaceAllUsesWith(view.getResult());
+        op->erase();
+    };
+
+    if (buffer.alloc)
+    {
+        replace(buffer.alloc, buffer.alloc.getType());
+        return;
+    }
+    for (auto reference : buffer.references)
+    {
+        replace(reference, reference.getType());
+    }
+    buffer.global.erase();
+}
+
+// The buffers of a function in the static arena, which start at the end of the buffers of the functions calling it
+struct FunctionArena
+{
+    vir::ValueFuncOp funcOp;
+    std::map<unsigned, std::vector<CacheBuffer>> buffersByMemorySpace;
+    std::map<unsigned, int64_t> sizeByMemorySpace;
+    std::map<unsigned, int64_t> baseByMemorySpace;
+    std::vector<size_t> callers;
+};
+
+struct CacheMemoryPlanningPass : public PlanCacheMemoryBase<CacheMemoryPlanningPass>
+{
+    CacheMemoryPlanningPass() = default;
+    CacheMemoryPlanningPass(bool printMemoryPlan, bool staticArena, const std::string& arenaReport)
+    {
+        this->printMemoryPlan = printMemoryPlan;
+        this->staticArena = staticArena;
+        this->arenaReport = arenaReport;
+    }
+
+    void runOnModule() final
+    {
+        auto module = getModule();
+
+        llvm::StringMap<std::vector<vir::ReferenceGlobalOp>> referencesByName;
+        module.walk([&](vir::ReferenceGlobalOp op) {
+            referencesByName[op.global_name()].push_back(op);
+        });
+
+        std::vector<vir::ValueFuncOp> funcOps;
+        module.walk([&](vir::ValueFuncOp op) {
+            funcOps.push_back(op);
+        });
+
+        llvm::erase_if(funcOps, [](vir::ValueFuncOp funcOp) {
+            return util::ResolveExecutionTarget(funcOp).value_or(vir::ExecutionTarget::CPU) != vir::ExecutionTarget::CPU;
+        });
+
+        if (staticArena)
+        {
+            PlanStaticArena(module, funcOps, referencesByName);
+            return;
+        }
+
+        for (auto funcOp : funcOps)
+        {
+            for (auto& [memorySpace, buffers] : CollectBuffers(funcOp, referencesByName))
+            {
+                PlanArena(funcOp, memorySpace, buffers);
+            }
+        }
+    }
+
+    std::map<unsigned, std::vector<CacheBuffer>> CollectBuffers(vir::ValueFuncOp funcOp, const llvm::StringMap<std::vector<vir::ReferenceGlobalOp>>& referencesByName)
+    {
+        OpSpans spans;
+        size_t counter = 0;
+        NumberOps(funcOp, spans, counter);
+
+        std::vector<llvm::StringRef> globalNames;
+        funcOp.walk([&](vir::ReferenceGlobalOp op) {
+            if (std::find(globalNames.begin(), globalNames.end(), op.global_name()) == globalNames.end())
+            {
+                globalNames.push_back(op.global_name());
+            }
+        });
+
+        // A view has the memory space of the memref it's taken from, so each memory space gets its own arena
+        std::map<unsigned, std::vector<CacheBuffer>> buffersByMemorySpace;
+        for (auto name : globalNames)
+        {
+            auto references = referencesByName.find(name)->second;
+            auto global = references.front().getGlobal();
+            if (!global || !global->hasAttr(executionPlan::CacheBufferAttrName) || global.constant() || global.external() || global.value() || !IsPlannableBufferType(global.getType()))
+            {
+                continue;
+            }
+
+            // A buffer shared with another function has to keep its own storage
+            if (llvm::any_of(references, [&](vir::ReferenceGlobalOp op) { return op->getParentOfType<vir::ValueFuncOp>() != funcOp; }))
+            {
+                continue;
+            }
+
+            std::vector<Operation*> accesses;
+            if (!llvm::all_of(references, [&](vir::ReferenceGlobalOp op) { return CollectAccesses(op.getResult(), accesses); }) || accesses.empty())
+            {
+                continue;
+            }
+
+            CacheBuffer buffer;
+            buffer.global = global;
+            buffer.references = references;
+            buffer.sizeInBytes = GetSizeInBytes(global.getType());
+            ComputeLiveRange(funcOp, spans, accesses, buffer);
+            buffersByMemorySpace[global.getType().getMemorySpaceAsInt()].push_back(buffer);
+        }
+
+        // Without a static arena, the temporary arrays are left to their own global or stack storage
+        if (staticArena)
+        {
+            funcOp.walk([&](vir::AllocOp op) {
+                auto type = op.getType();
+                if (op.allocType().getValueOr(vir::MemoryAllocType::Global) != vir::MemoryAllocType::Global || op.data() || op->hasAttr(HugePagesAttrName) || !IsPlannableBufferType(type))
+                {
+                    return;
+                }
+
+                std::vector<Operation*> accesses;
+                if (!CollectAccesses(op.getResult(), accesses) || accesses.empty())
+                {
+                    return;
+                }
+
+                CacheBuffer buffer;
+                buffer.alloc = op;
+                buffer.sizeInBytes = GetSizeInBytes(type);
+                ComputeLiveRange(funcOp, spans, accesses, buffer);
+                buffersByMemorySpace[type.getMemorySpaceAsInt()].push_back(buffer);
+            });
+        }
+
+        return buffersByMemorySpace;
+    }
+
+    void PlanArena(vir::ValueFuncOp funcOp, unsigned memorySpace, std::vector<CacheBuffer>& buffers)
+    {
+        if (buffers.size() < 2)
+        {
+            return;
+        }
+
+        int64_t unplannedSize = 0;
+        for (const auto& buffer : buffers)
+        {
+            unplannedSize += buffer.sizeInBytes;
+        }
+
+        auto arenaSize = AssignOffsets(buffers);
+        if (printMemoryPlan)
+        {
+            llvm::errs() << "Cache memory plan for " << funcOp.sym_name() << ": " << buffers.size() << " buffers, "
+                         << "peak scratch memory " << arenaSize << " bytes (" << unplannedSize << " bytes unplanned)\n";
+            for (const auto& buffer : buffers)
+            {
+                llvm::errs() << "  " << buffer.global.sym_name() << ": " << buffer.sizeInBytes << " bytes at offset " << buffer.offset
+                             << ", live over ops [" << buffer.liveBegin << ", " << buffer.liveEnd << "]\n";
+            }
+        }
+
+        if (arenaSize >= unplannedSize)
+        {
+            // None of the lifetimes are disjoint, so the buffers gain nothing from sharing an arena
+            return;
+        }
+
+        OpBuilder builder(funcOp);
+        auto arenaType = MemRefType::get({ arenaSize }, builder.getIntegerType(8), {}, memorySpace);
+        auto arenaGlobal = util::CreateGlobalBufferOp(builder, funcOp, arenaType, "cache_arena");
+        arenaGlobal->setAttr(executionPlan::CacheBufferAttrName, builder.getUnitAttr());
+        for (auto& buffer : buffers)
+        {
+            ReplaceWithArenaView(builder, arenaGlobal, buffer, buffer.offset);
+        }
+    }
+
+    void PlanStaticArena(ModuleOp module, const std::vector<vir::ValueFuncOp>& funcOps, const llvm::StringMap<std::vector<vir::ReferenceGlobalOp>>& referencesByName)
+    {
+        std::vector<FunctionArena> functions;
+        llvm::DenseMap<Operation*, size_t> functionIndices;
+        for (auto funcOp : funcOps)
+        {
+            FunctionArena function;
+            function.funcOp = funcOp;
+            function.buffersByMemorySpace = CollectBuffers(funcOp, referencesByName);
+            for (auto& [memorySpace, buffers] : function.buffersByMemorySpace)
+            {
+                function.sizeByMemorySpace[memorySpace] = AssignOffsets(buffers);
+            }
+            functionIndices[funcOp] = functions.size();
+            functions.push_back(std::move(function));
+        }
+
+        for (size_t caller = 0; caller < functions.size(); ++caller)
+        {
+            functions[caller].funcOp.walk([&](CallOpInterface callOp) {
+                auto it = functionIndices.find(callOp.resolveCallable());
+                if (it != functionIndices.end() && !llvm::is_contained(functions[it->second].callers, caller))
+                {
+                    functions[it->second].callers.push_back(caller);
+                }
+            });
+        }
+
+        // A callee's buffers start past the end of the buffers of each of its callers, and the callers' bases have to
+        // settle first. Without recursion, they settle after as many rounds as the longest call chain
+        bool changed = true;
+        for (size_t round = 0; changed; ++round)
+        {
+            if (round > functions.size())
+            {
+                module.emitError("The buffers of recursive functions can't be placed in a static arena");
+                signalPassFailure();
+                return;
+            }
+
+            changed = false;
+            for (auto& function : functions)
+            {
+                for (auto caller : function.callers)
+                {
+                    for (auto [memorySpace, size] : functions[caller].sizeByMemorySpace)
+                    {
+                        auto end = AlignUp(functions[caller].baseByMemorySpace[memorySpace] + size, ArenaBufferAlignment);
+                        auto& base = function.baseByMemorySpace[memorySpace];
+                        if (end > base)
+                        {
+                            base = end;
+                            changed = true;
+                        }
+                    }
+                }
+            }
+        }
+
+        std::map<unsigned, int64_t> arenaSizes;
+        for (auto& function : functions)
+        {
+            for (auto [memorySpace, size] : function.sizeByMemorySpace)
+            {
+                auto& arenaSize = arenaSizes[memorySpace];
+                arenaSize = std::max(arenaSize, function.baseByMemorySpace[memorySpace] + size);
+            }
+        }
+
+        if (printMemoryPlan)
+        {
+            for (auto& function : functions)
+            {
+                for (auto& [memorySpace, buffers] : function.buffersByMemorySpace)
+                {
+                    llvm::errs() << "Static arena plan for " << function.funcOp.sym_name() << ": " << buffers.size() << " buffers, "
+                                 << function.sizeByMemorySpace[memorySpace] << " bytes at offset " << function.baseByMemorySpace[memorySpace]
+                                 << " of memory space " << memorySpace << "\n";
+                }
+            }
+        }
+
+        WriteArenaReport(module, functions, arenaSizes);
+
+        std::map<unsigned, vir::GlobalOp> arenaGlobals;
+        for (auto& function : functions)
+        {
+            OpBuilder builder(function.funcOp);
+            for (auto& [memorySpace, buffers] : function.buffersByMemorySpace)
+            {
+                auto& arenaGlobal = arenaGlobals[memorySpace];
+                if (!arenaGlobal)
+                {
+                    auto arenaType = MemRefType::get({ arenaSizes[memorySpace] }, builder.getIntegerType(8), {}, memorySpace);
+                    arenaGlobal = util::CreateGlobalBufferOp(builder, function.funcOp, arenaType, "static_arena");
+                    arenaGlobal->setAttr(executionPlan::CacheBufferAttrName, builder.getUnitAttr());
+                }
+                for (auto& buffer : buffers)
+                {
+                    ReplaceWithArenaView(builder, arenaGlobal, buffer, function.baseByMemorySpace[memorySpace] + buffer.offset);
+                }
+            }
+        }
+    }
+
+    void WriteArenaReport(ModuleOp module, std::vector<FunctionArena>& functions, const std::map<unsigned, int64_t>& arenaSizes)
+    {
+        if (arenaReport.empty())
+        {
+            return;
+        }
+
+        int64_t totalSize = 0;
+        llvm::json::Array arenas;
+        for (auto [memorySpace, size] : arenaSizes)
+        {
+            totalSize += size;
+            arenas.push_back(llvm::json::Object{ { "memory_space", static_cast<int64_t>(memorySpace) }, { "bytes", size } });
+        }
+
+        llvm::json::Array functionEntries;
+        for (auto& function : functions)
+        {
+            llvm::json::Array buffers;
+            for (auto& [memorySpace, memorySpaceBuffers] : function.buffersByMemorySpace)
+            {
+                for (auto& buffer : memorySpaceBuffers)
+                {
+                    buffers.push_back(llvm::json::Object{
+                        { "name", buffer.global ? buffer.global.sym_name().str() : std::string{ "temp" } },
+                        { "memory_space", static_cast<int64_t>(memorySpace) },
+                        { "offset", function.baseByMemorySpace[memorySpace] + buffer.offset },
+                        { "bytes", buffer.sizeInBytes } });
+                }
+            }
+
+            int64_t bytes = 0;
+            for (auto [memorySpace, size] : function.sizeByMemorySpace)
+            {
+                bytes += size;
+            }
+            functionEntries.push_back(llvm::json::Object{
+                { "name", function.funcOp.sym_name().str() },
+                { "bytes", bytes },
+                { "buffers", std::move(buffers) } });
+        }
+
+        llvm::json::Value result = llvm::json::Object{
+            { "bytes", totalSize },
+            { "arenas", std::move(arenas) },
+            { "functions", std::move(functionEntries) }
+        };
+
+        std::string error;
+        auto reportFile = mlir::openOutputFile(arenaReport, &error);
+        if (!reportFile)
+        {
+            module.emitError() << error;
+            signalPassFailure();
+            return;
+        }
+        reportFile->os() << llvm::formatv("{0:2}", result) << "\n";
+        reportFile->keep();
+    }
+};
+
+} // namespace
+
+namespace accera::transforms::executionPlan
+{
+std::unique_ptr<mlir::Pass> createCacheMemoryPlanningPass(bool printMemoryPlan, bool staticArena, const std::string& arenaReport)
+{
+    return std::make_unique<CacheMemoryPlanningPass>(printMemoryPlan, staticArena, arenaReport);
+}
+
+std::unique_ptr<mlir::Pass> createCacheMemoryPlanningPass()
+{
+    return std::make_unique<CacheMemoryPlanningPass>();
+}
+} // namespace accera::transforms::executionPlan
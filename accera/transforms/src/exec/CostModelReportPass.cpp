@@ -0,0 +1,442 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "exec/CostModelReportPass.h"
+#include "AcceraPasses.h"
+
+#include <ir/include/nest/LoopNestAttributes.h>
+#include <ir/include/value/ValueDialect.h>
+
+#include <mlir/Analysis/AffineAnalysis.h>
+#include <mlir/Analysis/LoopAnalysis.h>
+#include <mlir/Analysis/Utils.h>
+#include <mlir/Dialect/Affine/IR/AffineOps.h>
+#include <mlir/Dialect/MemRef/IR/MemRef.h>
+#include <mlir/Dialect/OpenMP/OpenMPDialect.h>
+#include <mlir/Dialect/StandardOps/IR/Ops.h>
+#include <mlir/Dialect/Vector/VectorOps.h>
+#include <mlir/IR/BuiltinTypes.h>
+#include <mlir/Interfaces/CallInterfaces.h>
+#include <mlir/Pass/Pass.h>
+#include <mlir/Support/FileUtilities.h>
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/MapVector.h>
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/Support/FormatVariadic.h>
+#include <llvm/Support/JSON.h>
+#include <llvm/Support/ToolOutputFile.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace mlir;
+
+using namespace accera::ir;
+using namespace accera::transforms;
+
+namespace vir = accera::ir::value;
+
+namespace
+{
+int64_t GetElementSizeInBytes(MemRefType type)
+{
+    auto elementType = type.getElementType();
+    int64_t elementBits = 0;
+    if (auto vectorType = elementType.dyn_cast<VectorType>())
+    {
+        elementBits = vectorType.getNumElements() * vectorType.getElementTypeBitWidth();
+    }
+    else if (elementType.isIntOrFloat())
+    {
+        elementBits = elementType.getIntOrFloatBitWidth();
+    }
+    else
+    {
+        // index
+        elementBits = 64;
+    }
+    return (elementBits + 7) / 8;
+}
+
+// Index arithmetic computes addresses, only the arithmetic on the data is counted
+int64_t GetLanes(Type type)
+{
+    if (auto vectorType = type.dyn_cast<VectorType>())
+    {
+        return vectorType.getNumElements();
+    }
+    return type.isIndex() ? 0 : 1;
+}
+
+int64_t GetArithmeticOpCount(Operation* op)
+{
+    if (auto binOp = dyn_cast<vir::BinOp>(op))
+    {
+        return GetLanes(binOp.result().getType());
+    }
+    if (isa<AddFOp, SubFOp, MulFOp, DivFOp, AddIOp, SubIOp, MulIOp>(op))
+    {
+        return GetLanes(op->getResult(0).getType());
+    }
+    if (auto fmaOp = dyn_cast<vector::FMAOp>(op))
+    {
+        return 2 * GetLanes(fmaOp.getVectorType());
+    }
+    if (auto reductionOp = dyn_cast<vector::ReductionOp>(op))
+    {
+        return GetLanes(reductionOp.vector().getType());
+    }
+    return 0;
+}
+
+// Loops whose trip count isn't constant count as a single iteration
+int64_t GetTripCount(AffineForOp forOp)
+{
+    auto tripCount = getConstantTripCount(forOp);
+    return tripCount ? static_cast<int64_t>(*tripCount) : 1;
+}
+
+// The number of times op runs each time `outermost` runs, or each time the function runs if `outermost` is null
+int64_t GetIterationCount(Operation* op, Operation* outermost = nullptr)
+{
+    int64_t count = 1;
+    for (auto forOp = op->getParentOfType<AffineForOp>(); forOp; forOp = forOp->getParentOfType<AffineForOp>())
+    {
+        count *= GetTripCount(forOp);
+        if (forOp.getOperation() == outermost)
+        {
+            break;
+        }
+    }
+    return count;
+}
+
+std::string GetArrayName(Value memref)
+{
+    if (auto arg = memref.dyn_cast<BlockArgument>())
+    {
+        return llvm::formatv("arg{0}", arg.getArgNumber());
+    }
+    if (auto getGlobalOp = memref.getDefiningOp<memref::GetGlobalOp>())
+    {
+        return getGlobalOp.name().str();
+    }
+    if (auto op = memref.getDefiningOp())
+    {
+        return op->getName().getStringRef().str();
+    }
+    return "unknown";
+}
+
+std::string GetLocationString(Location loc)
+{
+    std::string result;
+    llvm::raw_string_ostream os(result);
+    loc.print(os);
+    return os.str();
+}
+
+void CollectLoops(Operation* op, std::vector<AffineForOp>& loops)
+{
+    for (auto& region : op->getRegions())
+    {
+        for (auto& block : region)
+        {
+            for (auto& nestedOp : block)
+            {
+                if (auto forOp = dyn_cast<AffineForOp>(nestedOp))
+                {
+                    loops.push_back(forOp);
+                }
+                CollectLoops(&nestedOp, loops);
+            }
+        }
+    }
+}
+
+struct Footprint
+{
+    llvm::json::Array arrays;
+    int64_t bytes = 0;
+    int64_t unanalyzedAccesses = 0;
+};
+
+// Computes the active blocks of the arrays that one run of `root` accesses, which are the bounding boxes of the
+// regions its affine loads and stores touch with the loops enclosing `root` held fixed
+Footprint ComputeFootprint(Operation* root, unsigned loopDepth)
+{
+    llvm::MapVector<Value, std::vector<MemRefRegion>> activeBlocks;
+    Footprint footprint;
+
+    root->walk([&](Operation* op) {
+        if (!isa<AffineReadOpInterface, AffineWriteOpInterface>(op))
+        {
+            return;
+        }
+
+        MemRefRegion region(op->getLoc());
+        if (failed(region.compute(op, loopDepth, nullptr, false)))
+        {
+            ++footprint.unanalyzedAccesses;
+            return;
+        }
+
+        // Regions whose bounds can't be combined, e.g. because they depend on different symbols, are counted separately
+        auto& regions = activeBlocks[region.memref];
+        if (regions.empty() || failed(regions.back().unionBoundingBox(region)))
+        {
+            regions.push_back(region);
+        }
+    });
+
+    for (auto& [memref, regions] : activeBlocks)
+    {
+        int64_t volume = 0;
+        for (auto& region : regions)
+        {
+            if (auto regionVolume = region.getConstantBoundingSizeAndShape())
+            {
+                volume += *regionVolume;
+            }
+            else
+            {
+                ++footprint.unanalyzedAccesses;
+            }
+        }
+
+        auto bytes = volume * GetElementSizeInBytes(memref.getType().cast<MemRefType>());
+        footprint.bytes += bytes;
+        footprint.arrays.push_back(llvm::json::Object{
+            { "name", GetArrayName(memref) },
+            { "elements", volume },
+            { "bytes", bytes } });
+    }
+    return footprint;
+}
+
+int64_t GetSizeInBytes(MemRefType type)
+{
+    return type.hasStaticShape() ? type.getNumElements() * GetElementSizeInBytes(type) : 0;
+}
+
+// The bytes of the buffers that the function uses besides its arguments and constants, such as its caches
+int64_t GetScratchBytes(vir::ValueFuncOp funcOp)
+{
+    int64_t bytes = 0;
+    llvm::SmallPtrSet<Operation*, 4> globals;
+    funcOp.walk([&](Operation* op) {
+        if (isa<vir::AllocOp, memref::AllocOp, memref::AllocaOp>(op))
+        {
+            bytes += GetSizeInBytes(op->getResult(0).getType().cast<MemRefType>());
+        }
+        else if (auto refGlobalOp = dyn_cast<vir::ReferenceGlobalOp>(op))
+        {
+            auto globalOp = refGlobalOp.getGlobal();
+            if (globalOp && !globalOp.constant() && globals.insert(globalOp).second)
+            {
+                bytes += GetSizeInBytes(globalOp.getType());
+            }
+        }
+    });
+    return bytes;
+}
+
+// The bytes of the mutable globals that the function uses, which keep their contents between calls
+int64_t GetStaticBytes(vir::ValueFuncOp funcOp)
+{
+    int64_t bytes = 0;
+    llvm::SmallPtrSet<Operation*, 4> globals;
+    funcOp.walk([&](vir::ReferenceGlobalOp refGlobalOp) {
+        auto globalOp = refGlobalOp.getGlobal();
+        if (globalOp && !globalOp.constant() && globals.insert(globalOp).second)
+        {
+            bytes += GetSizeInBytes(globalOp.getType());
+        }
+    });
+    return bytes;
+}
+
+// Whether the function can be called concurrently with itself: neither it nor the functions it calls use mutable
+// globals, such as the caches that are allocated as globals. The results are memoized in `reentrant`, where a
+// function that is being analyzed is assumed to be reentrant so that recursive calls terminate.
+bool IsReentrant(vir::ValueFuncOp funcOp, llvm::DenseMap<Operation*, bool>& reentrant)
+{
+    if (auto it = reentrant.find(funcOp); it != reentrant.end())
+    {
+        return it->second;
+    }
+    reentrant[funcOp] = true;
+
+    auto result = funcOp.walk([&](Operation* op) {
+        if (auto refGlobalOp = dyn_cast<vir::ReferenceGlobalOp>(op))
+        {
+            auto globalOp = refGlobalOp.getGlobal();
+            if (!globalOp || !globalOp.constant())
+            {
+                return WalkResult::interrupt();
+            }
+        }
+        else if (auto callOp = dyn_cast<CallOpInterface>(op))
+        {
+            auto callee = dyn_cast_or_null<vir::ValueFuncOp>(callOp.resolveCallable());
+            if (callee && !IsReentrant(callee, reentrant))
+            {
+                return WalkResult::interrupt();
+            }
+        }
+        return WalkResult::advance();
+    });
+
+    reentrant[funcOp] = !result.wasInterrupted();
+    return !result.wasInterrupted();
+}
+
+// The number of threads of the widest parallel region of the function
+int64_t GetNumThreads(vir::ValueFuncOp funcOp)
+{
+    int64_t numThreads = 1;
+    funcOp.walk([&](AffineParallelOp parallelOp) {
+        int64_t regionThreads = 1;
+        for (Operation* op = parallelOp.getOperation(); op && op != funcOp.getOperation(); op = op->getParentOp())
+        {
+            if (auto threadsAttr = op->getAttrOfType<IntegerAttr>(omp::getNumThreadsAttrName()))
+            {
+                regionThreads *= threadsAttr.getInt();
+            }
+        }
+        numThreads = std::max(numThreads, regionThreads);
+    });
+    return numThreads;
+}
+
+double GetArithmeticIntensity(int64_t ops, int64_t bytes)
+{
+    return bytes > 0 ? static_cast<double>(ops) / static_cast<double>(bytes) : 0.0;
+}
+
+struct CostModelReportPass : public CostModelReportBase<CostModelReportPass>
+{
+    CostModelReportPass() = default;
+    CostModelReportPass(const std::string& reportFilename)
+    {
+        this->reportFilename = reportFilename;
+    }
+
+    void runOnModule() final
+    {
+        auto module = getModule();
+
+        llvm::json::Array functions;
+        llvm::DenseMap<Operation*, bool> reentrant;
+        module.walk([&](vir::ValueFuncOp funcOp) {
+            if (funcOp.isExternal())
+            {
+                return;
+            }
+
+            int64_t functionOps = 0;
+            funcOp.walk([&](Operation* op) {
+                if (auto count = GetArithmeticOpCount(op))
+                {
+                    functionOps += count * GetIterationCount(op);
+                }
+            });
+
+            // Every loop level is modeled as the level whose footprint is kept in the cache: the data moved into
+            // it is its footprint, once each time the loop runs
+            std::vector<AffineForOp> forOps;
+            CollectLoops(funcOp, forOps);
+
+            llvm::json::Array loops;
+            for (auto forOp : forOps)
+            {
+                auto depth = getNestingDepth(forOp);
+                auto executions = GetIterationCount(forOp);
+                auto tripCount = getConstantTripCount(forOp);
+
+                int64_t loopOps = 0;
+                forOp.walk([&](Operation* op) {
+                    if (auto count = GetArithmeticOpCount(op))
+                    {
+                        loopOps += count * GetIterationCount(op, forOp);
+                    }
+                });
+
+                auto footprint = ComputeFootprint(forOp, depth);
+                auto trafficBytes = footprint.bytes * executions;
+                auto totalOps = loopOps * executions;
+
+                std::string loopName;
+                if (auto indexAttr = forOp->getAttrOfType<loopnest::IndexAttr>("index"))
+                {
+                    loopName = indexAttr.getValue().GetName();
+                }
+
+                loops.push_back(llvm::json::Object{
+                    { "loop", loopName },
+                    { "location", GetLocationString(forOp.getLoc()) },
+                    { "depth", static_cast<int64_t>(depth) },
+                    { "trip_count", tripCount ? llvm::json::Value(static_cast<int64_t>(*tripCount)) : llvm::json::Value(nullptr) },
+                    { "executions", executions },
+                    { "ops", totalOps },
+                    { "footprint_bytes", footprint.bytes },
+                    { "traffic_bytes", trafficBytes },
+                    { "arithmetic_intensity", GetArithmeticIntensity(totalOps, trafficBytes) },
+                    { "unanalyzed_accesses", footprint.unanalyzedAccesses },
+                    { "arrays", std::move(footprint.arrays) } });
+            }
+
+            auto footprint = ComputeFootprint(funcOp, 0);
+            functions.push_back(llvm::json::Object{
+                { "name", funcOp.sym_name().str() },
+                { "ops", functionOps },
+                { "footprint_bytes", footprint.bytes },
+                { "arithmetic_intensity", GetArithmeticIntensity(functionOps, footprint.bytes) },
+                { "unanalyzed_accesses", footprint.unanalyzedAccesses },
+                { "scratch_bytes", GetScratchBytes(funcOp) },
+                { "static_bytes", GetStaticBytes(funcOp) },
+                { "num_threads", GetNumThreads(funcOp) },
+                { "reentrant", IsReentrant(funcOp, reentrant) },
+                { "arrays", std::move(footprint.arrays) },
+                { "loops", std::move(loops) } });
+        });
+
+        llvm::json::Value result = llvm::json::Object{ { "functions", std::move(functions) } };
+        if (reportFilename.empty())
+        {
+            llvm::errs() << llvm::formatv("{0:2}", result) << "\n";
+            return;
+        }
+
+        std::string error;
+        auto reportFile = mlir::openOutputFile(reportFilename, &error);
+        if (!reportFile)
+        {
+            module.emitError() << error;
+            signalPassFailure();
+            return;
+        }
+        reportFile->os() << llvm::formatv("{0:2}", result) << "\n";
+        reportFile->keep();
+    }
+};
+
+} // namespace
+
+namespace accera::transforms::executionPlan
+{
+std::unique_ptr<mlir::Pass> createCostModelReportPass(const std::string& reportFilename)
+{
+    return std::make_unique<CostModelReportPass>(reportFilename);
+}
+
+std::unique_ptr<mlir::Pass> createCostModelReportPass()
+{
+    return std::make_unique<CostModelReportPass>();
+}
+} // namespace accera::transforms::executionPlan
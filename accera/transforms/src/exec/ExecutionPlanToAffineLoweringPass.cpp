@@ -6,6 +6,7 @@
 #include "exec/ExecutionPlanToAffineLoweringPass.h"
 #include "AcceraPasses.h"
 #include "util/VectorizationUtil.h"
+#include "value/RangeValueAnalysis.h"
 
 #include <ir/include/IRUtil.h>
 #include <ir/include/exec/ExecutionOptions.h>
@@ -23,11 +24,16 @@
 
 #include <llvm/ADT/DenseSet.h>
 #include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringMap.h>
 #include <llvm/ADT/TypeSwitch.h>
 #include <llvm/Support/raw_os_ostream.h>
 
+#include <mlir/Analysis/AffineAnalysis.h>
+#include <mlir/Analysis/AffineStructures.h>
 #include <mlir/Analysis/LoopAnalysis.h>
 #include <mlir/Analysis/Utils.h>
+#include <mlir/Conversion/AffineToStandard/AffineToStandard.h>
+#include <mlir/Dialect/AMX/AMXDialect.h>
 #include <mlir/Dialect/Affine/IR/AffineOps.h>
 #include <mlir/Dialect/Affine/Utils.h>
 #include <mlir/Dialect/GPU/GPUDialect.h>
@@ -40,9 +46,12 @@
 #include <mlir/IR/BlockAndValueMapping.h>
 #include <mlir/IR/Dominance.h>
 #include <mlir/IR/Identifier.h>
+#include <mlir/IR/Matchers.h>
 #include <mlir/IR/IntegerSet.h>
 #include <mlir/IR/Operation.h>
+#include <mlir/Interfaces/SideEffectInterfaces.h>
 #include <mlir/Pass/Pass.h>
+#include <mlir/Support/MathExtras.h>
 #include <mlir/Transforms/DialectConversion.h>
 #include <mlir/Transforms/GreedyPatternRewriteDriver.h>
 #include <mlir/Transforms/InliningUtils.h>
@@ -50,11 +59,16 @@
 #include <mlir/Transforms/Utils.h>
 
 #include <algorithm>
+#include <limits>
 #include <map>
+#include <mutex>
 #include <numeric>
+#include <optional>
 #include <queue>
+#include <set>
 #include <stack>
 #include <stdexcept>
+#include <tuple>
 
 using namespace accera::ir;
 using namespace accera::ir::executionPlan;
@@ -74,6 +88,7 @@ namespace
 // has a constructor that takes a const std::string& for convenience
 
 const std::string BoundsCheckedAttrName = "accxp_bounds_checked";
+const std::string OutOfBoundsVersionedAttrName = "accxp_out_of_bounds_versioned";
 const std::string BaseArrayAccessMapAttrName = "accxp_base_array_access_map";
 const std::string BaseArrayAccessIndicesAttrName = "accxp_base_array_access_indices";
 
@@ -98,6 +113,64 @@ const std::string ThreadZIndexName = "accxp_thread_z_loop_index";
 const std::string UnswitchPrefixItersName = "accxp_unswitch_prefix_iters";
 const std::string UnswitchSuffixItersName = "accxp_unswitch_suffix_iters";
 
+// The most iterations a loop is versioned at to take the conditions nested in it out of the loop, see
+// VersionLoopAtConditionChanges
+const size_t MaxConditionVersionSplits = 2;
+
+// Marks parallel loops that are scheduled by the work-stealing runtime instead of an OpenMP worksharing loop.
+// This is a dialect attribute so that it is carried from affine.parallel to scf.parallel by the affine lowering
+const std::string WorkStealingAttrName = "accxp.work_stealing";
+
+// The chunk size of a parallel loop, which is split into chunks after the affine lowering, see ChunkedParallelOpRewrite.
+// This is a dialect attribute so that it is carried from affine.parallel to scf.parallel by the affine lowering
+const std::string ScheduleChunkAttrName = "accxp.schedule_chunk";
+
+// Entry points of the work-stealing scheduler in accera/runtime/include/WorkStealing.h
+const std::string WorkStealingCreateFnName = "AcceraWorkStealingCreate";
+const std::string WorkStealingNextFnName = "AcceraWorkStealingNext";
+const std::string WorkStealingDestroyFnName = "AcceraWorkStealingDestroy";
+
+// Identifies the band of indices a parallel loop came from, only loops of the same band are collapsed together
+const std::string ParallelGroupAttrName = "accxp.parallel_group";
+
+// The number of nested parallel levels under an outermost parallel loop, set once its nested teams are enabled
+const std::string NestedParallelLevelsAttrName = "accxp.nested_parallel_levels";
+
+// OpenMP runtime entry point that allows inner parallel regions to create their own teams
+const std::string OMPSetMaxActiveLevelsFnName = "omp_set_max_active_levels";
+
+// Marks parallel loops whose proc_bind was chosen by the user, so that it is not overridden for nested regions
+const std::string ParallelPinnedAttrName = "accxp.parallel_pinned";
+
+// OpenMP runtime entry point that returns the number of the calling thread in its team
+const std::string OMPGetThreadNumFnName = "omp_get_thread_num";
+
+// Entry point of the thread affinity support in accera/runtime/include/ThreadAffinity.h
+const std::string PinCurrentThreadFnName = "AcceraPinCurrentThread";
+
+// Entry point of the AMX support in accera/runtime/include/CPUFeatures.h
+const std::string RequestAMXTileDataFnName = "AcceraRequestAMXTileData";
+
+// Memoizes the regions of an array that ops access below a loop depth, which the cache region patterns compute
+// over and over for the same ops as they consider each level of a cache hierarchy. An entry remembers a fingerprint
+// of the IR that the region was computed from, i.e. the access op and the ops that enclose it with their attributes
+// and operands, so that an entry isn't reused once a rewrite changes the access or the loops around it.
+// A cache is owned by a pattern, so it lives for one application of the patterns to a function.
+class ActiveBlockRegionCache
+{
+public:
+    // Returns nullptr if the op isn't an access that a region can be computed for
+    const mlir::MemRefRegion* GetRegionAccessedByOp(mlir::Value array, mlir::Operation* op, unsigned loopDepth);
+
+private:
+    struct Entry
+    {
+        llvm::hash_code fingerprint;
+        std::optional<mlir::MemRefRegion> region;
+    };
+    std::map<std::tuple<const void*, mlir::Operation*, unsigned>, Entry> _entries;
+};
+
 struct MakeCacheOpLowering : public OpRewritePattern<MakeCacheOp>
 {
     using OpRewritePattern<MakeCacheOp>::OpRewritePattern;
@@ -194,6 +267,8 @@ struct BeginCacheRegionOpRewrite : public OpRewritePattern<BeginCacheRegionOp>
     using OpRewritePattern<BeginCacheRegionOp>::OpRewritePattern;
 
     LogicalResult matchAndRewrite(BeginCacheRegionOp beginCacheRegionOp, PatternRewriter& rewriter) const final;
+
+    mutable ActiveBlockRegionCache regionCache;
 };
 
 struct HoistCacheRegionOpsRewrite : public OpRewritePattern<BeginCacheRegionOp>
@@ -215,14 +290,45 @@ struct MaxElementCacheRegionOpRewrite : public OpRewritePattern<BeginMaxElementC
     using OpRewritePattern<BeginMaxElementCacheRegionOp>::OpRewritePattern;
 
     LogicalResult matchAndRewrite(BeginMaxElementCacheRegionOp beginMaxElementCacheRegionOp, PatternRewriter& rewriter) const final;
+
+    mutable ActiveBlockRegionCache regionCache;
+};
+
+// Counts the ops of a loop that were vectorized or left as scalar ops, and remembers the first scalar op that blocked
+// the vectorization, for the vectorization report
+struct VectorizedLoopSummary
+{
+    void AddVectorizedOp() { ++vectorizedOps; }
+    void AddScalarizedOp(mlir::Operation* op, llvm::StringRef reason)
+    {
+        // Index computations are always unrolled, they only compute the positions of the vectorized accesses
+        if (op->getNumResults() > 0 && llvm::all_of(op->getResultTypes(), [](mlir::Type type) { return type.isIndex(); }))
+        {
+            return;
+        }
+        ++scalarizedOps;
+        if (!blockingOpLocation)
+        {
+            blockingOpName = op->getName().getStringRef().str();
+            blockingOpLocation = op->getLoc();
+            blockingReason = reason.str();
+        }
+    }
+
+    int64_t vectorizedOps = 0;
+    int64_t scalarizedOps = 0;
+    std::string blockingOpName;
+    std::optional<mlir::Location> blockingOpLocation;
+    std::string blockingReason;
 };
 
 struct VectorizeAffineForOpConversion : public OpRewritePattern<AffineForOp>
 {
     using OpRewritePattern<AffineForOp>::OpRewritePattern;
-    VectorizeAffineForOpConversion(MLIRContext* context, bool printVectorizationDetails = false) :
+    VectorizeAffineForOpConversion(MLIRContext* context, bool printVectorizationDetails = false, bool reportVectorization = false) :
         OpRewritePattern(context, /* benefit */ 1),
-        printVectorizationDetails(printVectorizationDetails)
+        printVectorizationDetails(printVectorizationDetails),
+        reportVectorization(reportVectorization)
     {}
 
     LogicalResult matchAndRewrite(AffineForOp affineForOp, PatternRewriter& rewriter) const final;
@@ -238,9 +344,21 @@ struct VectorizeAffineForOpConversion : public OpRewritePattern<AffineForOp>
                              VectorizedOpMap& vectorizedOps,
                              std::vector<BlockAndValueMapping>& laneMappings,
                              int64_t step,
-                             int64_t unrollMax) const;
+                             int64_t unrollMax,
+                             int64_t vectorSize,
+                             VectorizedLoopSummary* summary = nullptr) const;
+    void addVectorizationReportEntry(PatternRewriter& rewriter,
+                                     ValueFuncOp valueFuncOp,
+                                     mlir::Location loopLoc,
+                                     llvm::StringRef loopName,
+                                     uint64_t tripCount,
+                                     int64_t vectorSize,
+                                     const VectorizationInfo& vectorInfo,
+                                     bool vectorizedDotProduct,
+                                     const VectorizedLoopSummary& summary) const;
 
     bool printVectorizationDetails = false;
+    bool reportVectorization = false;
 };
 
 struct InPlaceUnrollAffineForOpConversion : public OpRewritePattern<AffineForOp>
@@ -277,6 +395,34 @@ struct CollapseAffineParallelOpsRewrite : public OpRewritePattern<AffineParallel
     LogicalResult matchAndRewrite(AffineParallelOp affineParallelOp, PatternRewriter& rewriter) const final;
 };
 
+struct NestedParallelRegionRewrite : public OpRewritePattern<AffineParallelOp>
+{
+    using OpRewritePattern<AffineParallelOp>::OpRewritePattern;
+
+    LogicalResult matchAndRewrite(AffineParallelOp affineParallelOp, PatternRewriter& rewriter) const final;
+};
+
+struct PinParallelRegionRewrite : public OpRewritePattern<AffineParallelOp>
+{
+    using OpRewritePattern<AffineParallelOp>::OpRewritePattern;
+
+    LogicalResult matchAndRewrite(AffineParallelOp affineParallelOp, PatternRewriter& rewriter) const final;
+};
+
+struct WorkStealingParallelOpRewrite : public OpRewritePattern<scf::ParallelOp>
+{
+    using OpRewritePattern<scf::ParallelOp>::OpRewritePattern;
+
+    LogicalResult matchAndRewrite(scf::ParallelOp parallelOp, PatternRewriter& rewriter) const final;
+};
+
+struct ChunkedParallelOpRewrite : public OpRewritePattern<scf::ParallelOp>
+{
+    using OpRewritePattern<scf::ParallelOp>::OpRewritePattern;
+
+    LogicalResult matchAndRewrite(scf::ParallelOp parallelOp, PatternRewriter& rewriter) const final;
+};
+
 struct HoistScalingToCacheReduceRewrite : public OpRewritePattern<mlir::AffineStoreOp>
 {
     using OpRewritePattern<mlir::AffineStoreOp>::OpRewritePattern;
@@ -340,6 +486,27 @@ struct ConvertValueStoresToAffineRewrite : public OpRewritePattern<v::StoreOp>
     LogicalResult matchAndRewrite(v::StoreOp storeOp, PatternRewriter& rewriter) const final;
 };
 
+struct NonTemporalStoreRewrite : public OpRewritePattern<mlir::memref::StoreOp>
+{
+    using OpRewritePattern<mlir::memref::StoreOp>::OpRewritePattern;
+
+    LogicalResult matchAndRewrite(mlir::memref::StoreOp storeOp, PatternRewriter& rewriter) const final;
+};
+
+struct NonTemporalAffineStoreRewrite : public OpRewritePattern<mlir::AffineStoreOp>
+{
+    using OpRewritePattern<mlir::AffineStoreOp>::OpRewritePattern;
+
+    LogicalResult matchAndRewrite(mlir::AffineStoreOp affineStoreOp, PatternRewriter& rewriter) const final;
+};
+
+struct NonTemporalTransferWriteRewrite : public OpRewritePattern<mlir::vector::TransferWriteOp>
+{
+    using OpRewritePattern<mlir::vector::TransferWriteOp>::OpRewritePattern;
+
+    LogicalResult matchAndRewrite(mlir::vector::TransferWriteOp transferWriteOp, PatternRewriter& rewriter) const final;
+};
+
 struct DelayedMappingRegionOpRewrite : public OpRewritePattern<DelayedMappingRegionOp>
 {
     using OpRewritePattern<DelayedMappingRegionOp>::OpRewritePattern;
@@ -394,6 +561,31 @@ struct OutOfBoundsAccessHandlingPass : public HandleOutOfBoundsAccessBase<OutOfB
     void runOnFunction() final;
 };
 
+struct WorkStealingParallelLoweringPass : public ConvertWorkStealingParallelBase<WorkStealingParallelLoweringPass>
+{
+    void runOnFunction() final;
+};
+
+struct NonTemporalStoreLoweringPass : public ConvertNonTemporalStoresBase<NonTemporalStoreLoweringPass>
+{
+    void runOnFunction() final;
+};
+
+struct ReductionAccumulatorPromotionPass : public PromoteReductionAccumulatorsBase<ReductionAccumulatorPromotionPass>
+{
+    void runOnFunction() final;
+};
+
+struct RedundantCacheFillEliminationPass : public EliminateRedundantCacheFillsBase<RedundantCacheFillEliminationPass>
+{
+    void runOnFunction() final;
+};
+
+struct LoopInvariantCodeMotionPass : public HoistLoopInvariantOpsBase<LoopInvariantCodeMotionPass>
+{
+    void runOnFunction() final;
+};
+
 // Vectorization-related functions and types
 
 Type GetInnerElementType(Value val)
@@ -552,6 +744,13 @@ ParallelizationInfo GetParallelizationInfo(Operation* op)
     return parallelizationInfoAttr.getValue();
 }
 
+void SetParallelizationInfo(ScheduleOp op, Index index, const ParallelizationInfo& parallelizationInfo)
+{
+    OpBuilder builder(op);
+    auto parallelizationInfoIdentifier = builder.getIdentifier(ParallelizationInfoAttr::getKeyName());
+    op.addLoopAttribute(index, parallelizationInfoIdentifier, ParallelizationInfoAttr::get(parallelizationInfo, builder.getContext()));
+}
+
 bool IsTerminalOp(mlir::Operation* op)
 {
     // TODO: change this to also look for terminator ops
@@ -637,6 +836,37 @@ bool HasOutOfBoundsAccess(LoadOrStoreOp op, mlir::Location loc)
     return outOfBounds;
 }
 
+// Returns whether the ranges of the indices of an access keep it within its memref. This proves accesses in bounds
+// where the affine constraints of their region can't, e.g. accesses indexed by GPU thread ids or by the induction
+// variables of loops whose bounds aren't affine in the enclosing loops.
+template <typename LoadOrStoreOp>
+bool IsInBoundsByRange(LoadOrStoreOp op)
+{
+    auto memRefType = op.getMemRefType();
+    if (!memRefType.hasStaticShape())
+    {
+        return false;
+    }
+
+    accera::transforms::value::RangeValueAnalysis ranges;
+    auto accessMap = op.getAffineMap();
+    for (unsigned dim = 0; dim < accessMap.getNumResults(); ++dim)
+    {
+        auto range = ranges.resolveRange(accessMap.getResult(dim), op.getMapOperands(), accessMap.getNumDims());
+        if (!range.isWithin(0, memRefType.getDimSize(dim) - 1))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename LoadOrStoreOp>
+bool NeedsBoundsCheck(LoadOrStoreOp op, mlir::Location loc)
+{
+    return HasOutOfBoundsAccess(op, loc) && !IsInBoundsByRange(op);
+}
+
 // Returns whether left and right contain the same elements (possibly reordered)
 template <typename ElementType>
 bool ContainsSameElements(const std::vector<ElementType>& left, const std::vector<ElementType>& right)
@@ -1007,12 +1237,8 @@ std::pair<mlir::Value, mlir::ValueRange> GetAccessValueAndIndices(Operation* loa
     assert(false && "Unhandled load/store case");
 }
 
-bool ComputeRegionAccessedByOp(PatternRewriter& rewriter, mlir::MemRefRegion& activeBlockRegion, mlir::Operation* op, unsigned loopDepth)
+bool ComputeRegionAccessedByOp(mlir::MemRefRegion& activeBlockRegion, mlir::Operation* op, unsigned loopDepth)
 {
-    mlir::OpBuilder::InsertionGuard insertGuard(rewriter);
-    rewriter.setInsertionPoint(op);
-    auto loc = op->getLoc();
-
     if (isa<mlir::AffineLoadOp, mlir::AffineStoreOp, v::MFMALoadOp, v::MFMAStoreOp>(op))
     {
         auto result = activeBlockRegion.compute(op, loopDepth, nullptr, false);
@@ -1022,8 +1248,64 @@ bool ComputeRegionAccessedByOp(PatternRewriter& rewriter, mlir::MemRefRegion& ac
     return false;
 }
 
+// Hashes what MemRefRegion::compute reads: the access op, the affine.apply ops its indices are composed from, and the
+// enclosing ops (their loop bounds and if conditions are attributes and operands) up to the function
+llvm::hash_code GetRegionFingerprint(mlir::Operation* op)
+{
+    auto hashOp = [](mlir::Operation* current) {
+        return llvm::hash_combine(current, current->getName().getAsOpaquePointer(), current->getAttrDictionary().getAsOpaquePointer(), llvm::hash_combine_range(current->operand_begin(), current->operand_end()));
+    };
+
+    auto fingerprint = hashOp(op);
+    std::vector<mlir::Operation*> applyOps;
+    for (auto operand : op->getOperands())
+    {
+        if (auto applyOp = operand.getDefiningOp<mlir::AffineApplyOp>())
+        {
+            applyOps.push_back(applyOp);
+        }
+    }
+    while (!applyOps.empty())
+    {
+        auto applyOp = applyOps.back();
+        applyOps.pop_back();
+        fingerprint = llvm::hash_combine(fingerprint, hashOp(applyOp));
+        for (auto operand : applyOp->getOperands())
+        {
+            if (auto operandApplyOp = operand.getDefiningOp<mlir::AffineApplyOp>())
+            {
+                applyOps.push_back(operandApplyOp);
+            }
+        }
+    }
+
+    for (auto parentOp = op->getParentOp(); parentOp && !parentOp->hasTrait<mlir::OpTrait::IsIsolatedFromAbove>(); parentOp = parentOp->getParentOp())
+    {
+        fingerprint = llvm::hash_combine(fingerprint, hashOp(parentOp));
+    }
+    return fingerprint;
+}
+
+const mlir::MemRefRegion* ActiveBlockRegionCache::GetRegionAccessedByOp(mlir::Value array, mlir::Operation* op, unsigned loopDepth)
+{
+    auto fingerprint = GetRegionFingerprint(op);
+    auto [it, inserted] = _entries.try_emplace({ array.getAsOpaquePointer(), op, loopDepth });
+    auto& entry = it->second;
+    if (inserted || entry.fingerprint != fingerprint)
+    {
+        entry.fingerprint = fingerprint;
+        entry.region.reset();
+        mlir::MemRefRegion region(op->getLoc());
+        if (ComputeRegionAccessedByOp(region, op, loopDepth))
+        {
+            entry.region = std::move(region);
+        }
+    }
+    return entry.region ? &*entry.region : nullptr;
+}
+
 // Computes the active block for the array for the ops in the graph in half-open graph interval [startOp, endOp)
-ArrayAccessInfo ComputeAccessInfoForArrayAtLevel(PatternRewriter& rewriter, mlir::Value array, mlir::Block::iterator startOp, mlir::Block::iterator endOp, bool computeActiveBlock)
+ArrayAccessInfo ComputeAccessInfoForArrayAtLevel(ActiveBlockRegionCache& regionCache, mlir::Value array, mlir::Block::iterator startOp, mlir::Block::iterator endOp, bool computeActiveBlock)
 {
     auto loc = startOp->getLoc();
     unsigned loopDepth = mlir::getNestingDepth(&(*startOp));
@@ -1035,26 +1317,15 @@ ArrayAccessInfo ComputeAccessInfoForArrayAtLevel(PatternRewriter& rewriter, mlir
     result.array = array;
     for (Operation* arrayUserOp : array.getUsers())
     {
-        // Check if this use is inside of the cache region
-        bool isInRegion = false;
-        // TODO : fix this pattern, this seems like a really inefficient way of doing this
-        parentBlock->walk(mlir::Block::iterator(startOp), mlir::Block::iterator(endOp), [&](Operation* op) {
-            if (op == arrayUserOp)
-            {
-                isInRegion = true;
-                result.cacheUsedInRegion = true;
-                return WalkResult::interrupt();
-            }
-            else
-            {
-                return WalkResult::advance();
-            }
-        });
+        // Check if this use is inside of the cache region, i.e. if the op in the parent block that contains it is in [startOp, endOp)
+        auto ancestorOp = parentBlock->findAncestorOpInBlock(*arrayUserOp);
+        bool isInRegion = ancestorOp &&
+                          !ancestorOp->isBeforeInBlock(&(*startOp)) &&
+                          (endOp == parentBlock->end() || ancestorOp->isBeforeInBlock(&(*endOp)));
 
         if (isInRegion)
         {
-            // while we're examining this op, compute the active block that is accessed by this op within the cache region
-            mlir::MemRefRegion activeBlockRegion(loc);
+            result.cacheUsedInRegion = true;
 
             // TODO : make value load/store implement load/store interfaces from std dialect
             if (isa<mlir::memref::StoreOp, mlir::AffineStoreOp, v::StoreOp, v::MFMAStoreOp>(arrayUserOp))
@@ -1132,16 +1403,17 @@ ArrayAccessInfo ComputeAccessInfoForArrayAtLevel(PatternRewriter& rewriter, mlir
             }
             if (computeActiveBlock)
             {
-                if (ComputeRegionAccessedByOp(rewriter, activeBlockRegion, arrayUserOp, loopDepth))
+                // while we're examining this op, compute the active block that is accessed by this op within the cache region
+                if (auto activeBlockRegion = regionCache.GetRegionAccessedByOp(array, arrayUserOp, loopDepth))
                 {
                     if (firstMemRefRegionSeen)
                     {
-                        result.activeBlock = activeBlockRegion;
+                        result.activeBlock = *activeBlockRegion;
                         firstMemRefRegionSeen = false;
                     }
                     else
                     {
-                        auto unionResult = result.activeBlock.unionBoundingBox(activeBlockRegion);
+                        auto unionResult = result.activeBlock.unionBoundingBox(*activeBlockRegion);
                         assert(succeeded(unionResult));
 
                         result.activeBlock.cst.removeRedundantConstraints();
@@ -1226,6 +1498,193 @@ ActiveBlockInfo ConvertMemRefRegionToActiveBlockInfo(OpBuilder& builder, const m
     return activeBlockInfo;
 }
 
+// Returns the number of elements to add to the innermost dimension of a cache so its rows start in different cache sets (CPU) or shared memory banks (GPU)
+int64_t GetCachePadding(MakeCacheOp makeCacheOp, mlir::MemRefType cacheType, int64_t innermostSize)
+{
+    auto paddingAttr = makeCacheOp->getAttrOfType<mlir::IntegerAttr>(CachePaddingAttrName);
+    if (!paddingAttr || innermostSize == DynamicSizeSentinelValue)
+    {
+        return 0;
+    }
+    if (paddingAttr.getInt() != AutomaticCachePadding)
+    {
+        return paddingAttr.getInt();
+    }
+
+    // On CPU, rows whose pitch is a multiple of 512 bytes keep returning to the same sets of a 4KiB L1 way, so they are shifted by a cache line.
+    // On GPU, shared memory rows whose pitch is a multiple of 32 4-byte banks start in the same bank, so they are shifted by one bank.
+    const int64_t cpuAliasingRowBytes = 512;
+    const int64_t cpuPaddingBytes = 64;
+    const int64_t gpuAliasingRowBytes = 128;
+    const int64_t gpuPaddingBytes = 4;
+
+    auto elementBytes = std::max<int64_t>(1, cacheType.getElementTypeBitWidth() / 8);
+    auto rowBytes = innermostSize * elementBytes;
+    auto execTarget = util::ResolveExecutionTarget(makeCacheOp);
+    if (execTarget == v::ExecutionTarget::GPU)
+    {
+        if (cacheType.getMemorySpaceAsInt() != static_cast<unsigned int>(v::MemorySpace::Shared) || rowBytes % gpuAliasingRowBytes != 0)
+        {
+            return 0;
+        }
+        return std::max<int64_t>(1, gpuPaddingBytes / elementBytes);
+    }
+    if (rowBytes % cpuAliasingRowBytes != 0)
+    {
+        return 0;
+    }
+    return std::max<int64_t>(1, cpuPaddingBytes / elementBytes);
+}
+
+struct CachePanelLayout
+{
+    int64_t dimension; // the active block dimension that is split into panels
+    int64_t size; // the number of elements of that dimension in each panel
+};
+
+std::optional<CachePanelLayout> GetCachePanelLayout(MakeCacheOp makeCacheOp)
+{
+    auto panelAttr = makeCacheOp->getAttrOfType<mlir::ArrayAttr>(CachePanelLayoutAttrName);
+    if (!panelAttr)
+    {
+        return std::nullopt;
+    }
+    auto panelValues = util::ConvertArrayAttrToIntVector(panelAttr);
+    assert(panelValues.size() == 2 && panelValues[1] > 0 && "Cache panel layouts are a dimension and a panel size");
+    return CachePanelLayout{ panelValues[0], panelValues[1] };
+}
+
+// Returns the element type that a cache buffer stores, which is the array's unless the cache converts its elements
+mlir::Type GetCacheElementType(MakeCacheOp makeCacheOp, mlir::Type arrayElementType)
+{
+    auto elementTypeAttr = makeCacheOp->getAttrOfType<mlir::TypeAttr>(CacheElementTypeAttrName);
+    return elementTypeAttr ? elementTypeAttr.getValue() : arrayElementType;
+}
+
+// Converts an element between the element type of an array and the one of a cache that converts its elements, e.g.
+// f32 <-> f16 or i8 <-> i16. Caches only convert between float types or between integer types of the same signedness
+mlir::Value ConvertElementType(mlir::OpBuilder& builder, mlir::Location loc, mlir::Value value, mlir::Type elementType)
+{
+    auto valueType = value.getType();
+    if (valueType == elementType)
+    {
+        return value;
+    }
+
+    if (auto fromFloatType = valueType.dyn_cast<mlir::FloatType>())
+    {
+        auto toFloatType = elementType.cast<mlir::FloatType>();
+        if (fromFloatType.getWidth() == toFloatType.getWidth())
+        {
+            // float16 and bfloat16 have the same width but different layouts, so convert through float32
+            value = builder.create<mlir::FPExtOp>(loc, value, builder.getF32Type());
+            fromFloatType = builder.getF32Type();
+        }
+        if (fromFloatType.getWidth() > toFloatType.getWidth())
+        {
+            return builder.create<mlir::FPTruncOp>(loc, value, toFloatType);
+        }
+        return builder.create<mlir::FPExtOp>(loc, value, toFloatType);
+    }
+
+    auto fromIntType = valueType.cast<mlir::IntegerType>();
+    auto toIntType = elementType.cast<mlir::IntegerType>();
+    auto signlessValue = util::ToSignlessMLIRValue(builder, value);
+    auto signlessType = util::ToSignlessMLIRType(builder, toIntType);
+    mlir::Value result;
+    if (fromIntType.getWidth() > toIntType.getWidth())
+    {
+        result = builder.create<mlir::TruncateIOp>(loc, signlessValue, signlessType);
+    }
+    else if (fromIntType.isUnsigned())
+    {
+        result = builder.create<mlir::ZeroExtendIOp>(loc, signlessValue, signlessType);
+    }
+    else
+    {
+        result = builder.create<mlir::SignExtendIOp>(loc, signlessValue, signlessType);
+    }
+    if (signlessType != toIntType)
+    {
+        result = builder.create<mlir::UnrealizedConversionCastOp>(loc, toIntType, result).getResult(0);
+    }
+    return result;
+}
+
+// Whether a cache stores wider elements than its array, e.g. f32 for an f16 array, which makes it the accumulator of
+// the array: the kernel's accumulations into the cache and the reduction of the cache into the array are computed in
+// the cache's element type
+bool AccumulatesInCacheElementType(mlir::Type cacheElementType, mlir::Type arrayElementType)
+{
+    return cacheElementType.getIntOrFloatBitWidth() > arrayElementType.getIntOrFloatBitWidth();
+}
+
+// Returns the value that ConvertElementType converted to `value`, if it converted a value of the given type
+mlir::Value GetUnconvertedValue(mlir::Value value, mlir::Type type)
+{
+    auto stripCasts = [](mlir::Value value) {
+        while (auto castOp = value.getDefiningOp<mlir::UnrealizedConversionCastOp>())
+        {
+            if (castOp->getNumOperands() != 1)
+            {
+                break;
+            }
+            value = castOp->getOperand(0);
+        }
+        return value;
+    };
+
+    auto convertOp = stripCasts(value).getDefiningOp();
+    if (!convertOp || !mlir::isa<mlir::FPExtOp, mlir::FPTruncOp, mlir::SignExtendIOp, mlir::ZeroExtendIOp, mlir::TruncateIOp>(convertOp))
+    {
+        return {};
+    }
+    auto unconverted = stripCasts(convertOp->getOperand(0));
+    return unconverted.getType() == type ? unconverted : mlir::Value{};
+}
+
+// Rewrites the accumulations `cache[x] = cache[x] + value` that the kernel does in the array's element type into
+// accumulations in the element type of the cache, so that the partial sums aren't rounded to the array's element type
+// each time they are stored
+void AccumulateInCacheElementType(PatternRewriter& rewriter, mlir::Value cache, mlir::Type arrayElementType)
+{
+    auto cacheElementType = cache.getType().cast<mlir::MemRefType>().getElementType();
+    std::vector<mlir::AffineStoreOp> storeOps;
+    for (auto user : cache.getUsers())
+    {
+        if (auto storeOp = mlir::dyn_cast<mlir::AffineStoreOp>(user); storeOp && storeOp.getMemRef() == cache)
+        {
+            storeOps.push_back(storeOp);
+        }
+    }
+
+    for (auto storeOp : storeOps)
+    {
+        auto sum = GetUnconvertedValue(storeOp.getValueToStore(), arrayElementType);
+        auto sumOp = sum ? sum.getDefiningOp<v::BinOp>() : v::BinOp{};
+        if (!sumOp || sumOp.getPredicate() != BinaryOpPredicate::ADD || !sumOp->hasOneUse())
+        {
+            continue;
+        }
+
+        for (auto [acc, addend] : { std::pair{ sumOp.lhs(), sumOp.rhs() }, std::pair{ sumOp.rhs(), sumOp.lhs() } })
+        {
+            auto accumulator = GetUnconvertedValue(acc, cacheElementType);
+            auto loadOp = accumulator ? accumulator.getDefiningOp<mlir::AffineLoadOp>() : mlir::AffineLoadOp{};
+            if (!loadOp || loadOp.getMemRef() != cache || loadOp->getBlock() != storeOp->getBlock() || !(mlir::MemRefAccess(loadOp) == mlir::MemRefAccess(storeOp)))
+            {
+                continue;
+            }
+
+            rewriter.setInsertionPoint(sumOp);
+            auto wideAddend = ConvertElementType(rewriter, sumOp.getLoc(), addend, cacheElementType);
+            auto wideSum = rewriter.create<v::BinOp>(sumOp.getLoc(), BinaryOpPredicate::ADD, accumulator, wideAddend);
+            rewriter.updateRootInPlace(storeOp, [&, wideSum = wideSum] { storeOp->setOperand(0, wideSum); });
+            break;
+        }
+    }
+}
+
 MakeCacheOp UpdateActiveBlockCacheShape(PatternRewriter& rewriter,
                                         MakeCacheOp baseMakeCacheOp,
                                         const CacheAccessContext& cacheAccessContext,
@@ -1238,6 +1697,9 @@ MakeCacheOp UpdateActiveBlockCacheShape(PatternRewriter& rewriter,
     auto currentCacheType = baseMakeCacheOp.cache().getType();
     assert(currentCacheType.isa<mlir::MemRefType>());
     auto currentCacheMemRefType = currentCacheType.cast<mlir::MemRefType>();
+    // The placeholder cache has the array's element type, the buffer may store another one
+    auto cacheElementType = GetCacheElementType(baseMakeCacheOp, currentCacheMemRefType.getElementType());
+    currentCacheMemRefType = mlir::MemRefType::get(currentCacheMemRefType.getShape(), cacheElementType, currentCacheMemRefType.getAffineMaps(), currentCacheMemRefType.getMemorySpace());
     if (!cacheAccessContext.dimReorderCache)
     {
         assert(currentCacheMemRefType.getRank() == 1 && "Active block caches with custom coefficients should be 1-dimensional");
@@ -1257,6 +1719,23 @@ MakeCacheOp UpdateActiveBlockCacheShape(PatternRewriter& rewriter,
         {
             cacheShape[cacheDimIdx] = std::max(cacheShape[cacheDimIdx], activeBlockInfo.shape[reorderVec[cacheDimIdx]]);
         }
+
+        // A panel cache stores { panel, remaining dims in cache order..., position in panel }, see CreateActiveBlockToCacheMap
+        if (auto panelLayout = GetCachePanelLayout(baseMakeCacheOp))
+        {
+            auto panelCacheDimIt = std::find(reorderVec.begin(), reorderVec.end(), panelLayout->dimension);
+            assert(panelCacheDimIt != reorderVec.end() && "Cache panel dimension is out of range");
+            auto panelDimSize = cacheShape[std::distance(reorderVec.begin(), panelCacheDimIt)];
+            cacheShape.erase(cacheShape.begin() + std::distance(reorderVec.begin(), panelCacheDimIt));
+            cacheShape.insert(cacheShape.begin(), (panelDimSize + panelLayout->size - 1) / panelLayout->size);
+            cacheShape.push_back(panelLayout->size);
+        }
+
+        // Padding only grows the row pitch: the copies still only touch the active block, so the access maps are unchanged
+        if (cacheShape.size() > 1)
+        {
+            cacheShape.back() += GetCachePadding(baseMakeCacheOp, currentCacheMemRefType, cacheShape.back());
+        }
     }
     else
     {
@@ -1279,10 +1758,19 @@ MakeCacheOp UpdateActiveBlockCacheShape(PatternRewriter& rewriter,
     mlir::OpBuilder::InsertionGuard insertGuard(rewriter);
     rewriter.setInsertionPoint(baseMakeCacheOp);
     auto replacementOp = rewriter.create<MakeCacheOp>(baseMakeCacheOp.getLoc(), newCacheType, baseMakeCacheOp.memorySpace());
+    replacementOp->setOperands(baseMakeCacheOp.epilogueArrays());
+    for (auto attrName : { ThreadLocalCacheAttrName, CooperativeCacheCopyAttrName, PrefetchDistanceAttrName, NonTemporalWriteBackCacheAttrName, CachePaddingAttrName, CachePanelLayoutAttrName, AsyncCopyCacheAttrName, CacheEpilogueAttrName, CacheElementTypeAttrName })
+    {
+        if (auto attr = baseMakeCacheOp->getAttr(attrName))
+        {
+            replacementOp->setAttr(attrName, attr);
+        }
+    }
     return replacementOp;
 }
 
 mlir::AffineMap CreateActiveBlockToCacheMap(PatternRewriter& rewriter,
+                                            MakeCacheOp makeCacheOp,
                                             CacheAccessContext& cacheAccessContext)
 {
     mlir::AffineMap activeBlockToCacheMap;
@@ -1291,6 +1779,23 @@ mlir::AffineMap CreateActiveBlockToCacheMap(PatternRewriter& rewriter,
         auto dimReorderVec = cacheAccessContext.accessMaps.dimOrder.ToVector();
         std::vector<unsigned int> unsignedDimReorderVec(dimReorderVec.begin(), dimReorderVec.end());
         activeBlockToCacheMap = mlir::AffineMap::getPermutationMap(unsignedDimReorderVec, rewriter.getContext());
+
+        if (auto panelLayout = GetCachePanelLayout(makeCacheOp))
+        {
+            // Interleave the panel dimension so that each panel is contiguous, e.g. a first-major ( k, j ) block with
+            // panels of nr columns maps to ( j floordiv nr, k, j mod nr ), the packed format of a GEMM microkernel
+            auto panelDimExpr = rewriter.getAffineDimExpr(panelLayout->dimension);
+            std::vector<mlir::AffineExpr> panelExprs{ panelDimExpr.floorDiv(panelLayout->size) };
+            for (auto expr : activeBlockToCacheMap.getResults())
+            {
+                if (expr != panelDimExpr)
+                {
+                    panelExprs.push_back(expr);
+                }
+            }
+            panelExprs.push_back(panelDimExpr % panelLayout->size);
+            activeBlockToCacheMap = mlir::AffineMap::get(activeBlockToCacheMap.getNumDims(), 0, panelExprs, rewriter.getContext());
+        }
     }
     else
     {
@@ -1367,7 +1872,15 @@ MakeCacheOp UpdateActiveBlockCacheAccess(PatternRewriter& rewriter,
                                                       shapedMakeCacheOp.memorySpace(),
                                                       arrayToCacheMap,
                                                       offsetAccessIndices,
-                                                      multiCacheAccessIndices);
+                                                      multiCacheAccessIndices,
+                                                      shapedMakeCacheOp.epilogueArrays());
+    for (auto attrName : { ThreadLocalCacheAttrName, CooperativeCacheCopyAttrName, PrefetchDistanceAttrName, NonTemporalWriteBackCacheAttrName, CachePaddingAttrName, CachePanelLayoutAttrName, AsyncCopyCacheAttrName, CacheEpilogueAttrName, CacheElementTypeAttrName })
+    {
+        if (auto attr = shapedMakeCacheOp->getAttr(attrName))
+        {
+            replacementOp->setAttr(attrName, attr);
+        }
+    }
 
     rewriter.eraseOp(shapedMakeCacheOp);
     return replacementOp;
@@ -1580,7 +2093,8 @@ v::MFMALoadOp CreateMFMALoad(mlir::OpBuilder& builder,
     }
 }
 
-// Create an AffineStoreOp that understands how to access caches
+// Create an AffineStoreOp that understands how to access caches, converting the value to the element type of caches
+// that store another element type than their array
 template <typename StoreOp = mlir::AffineStoreOp>
 StoreOp CreateStore(mlir::OpBuilder& builder,
                     mlir::Location loc,
@@ -1589,6 +2103,10 @@ StoreOp CreateStore(mlir::OpBuilder& builder,
                     const std::vector<mlir::Value>& baseArrayPosition,
                     const std::vector<std::pair<Index, mlir::Value>>& unrealizedLoopNestIndices = {})
 {
+    if constexpr (std::is_same_v<StoreOp, mlir::AffineStoreOp>)
+    {
+        value = ConvertElementType(builder, loc, value, dst.getType().cast<mlir::MemRefType>().getElementType());
+    }
     if (auto dstCacheOp = mlir::dyn_cast_or_null<MakeCacheOp>(dst.getDefiningOp()))
     {
         mlir::AffineValueMap storeAccessInfo = dstCacheOp.insertCachePosition(builder.getInsertionBlock(), baseArrayPosition, unrealizedLoopNestIndices);
@@ -1600,9 +2118,582 @@ StoreOp CreateStore(mlir::OpBuilder& builder,
     }
 }
 
-bool HasBaseArrayAccessAttrs(mlir::Operation* op)
+// Create an AtomicRMWOp that adds value to an element of dst, understanding how to access caches
+mlir::AtomicRMWOp CreateAtomicAccumulate(mlir::OpBuilder& builder,
+                                         mlir::Location loc,
+                                         mlir::Value value,
+                                         mlir::Value dst,
+                                         std::vector<mlir::Value> baseArrayPosition)
 {
-    return op->hasAttr(BaseArrayAccessMapAttrName) && op->hasAttr(BaseArrayAccessIndicesAttrName);
+    std::vector<mlir::Value> position = baseArrayPosition;
+    if (auto dstCacheOp = mlir::dyn_cast_or_null<MakeCacheOp>(dst.getDefiningOp()))
+    {
+        mlir::AffineValueMap accessInfo = dstCacheOp.insertCachePosition(builder.getInsertionBlock(), baseArrayPosition, {});
+        std::vector<mlir::Value> operands(accessInfo.getOperands().begin(), accessInfo.getOperands().end());
+        position = util::MultiDimAffineApply(builder, loc, accessInfo.getAffineMap(), operands);
+    }
+    auto kind = value.getType().isa<mlir::FloatType>() ? mlir::AtomicRMWKind::addf : mlir::AtomicRMWKind::addi;
+    return builder.create<mlir::AtomicRMWOp>(loc, value.getType(), kind, value, dst, position);
+}
+
+// Returns true if the op is inside a parallel loop whose iterations accumulate into the same array elements
+bool IsInParallelReduction(mlir::Operation* op)
+{
+    for (auto loop = op->getParentOfType<AffineForOp>(); loop; loop = loop->getParentOfType<AffineForOp>())
+    {
+        if (loop->hasAttr(ParallelReductionAttrName))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Returns the parallel loops of a deterministic reduction that enclose the op, outermost first
+std::vector<AffineForOp> GetDeterministicReductionBand(mlir::Operation* op)
+{
+    std::vector<AffineForOp> band;
+    for (auto loop = op->getParentOfType<AffineForOp>(); loop; loop = loop->getParentOfType<AffineForOp>())
+    {
+        if (loop->hasAttr(DeterministicReductionAttrName))
+        {
+            band.insert(band.begin(), loop);
+        }
+    }
+    return band;
+}
+
+// Creates the buffer of the partial results of a deterministic parallel reduction into the array, with a slot for each
+// iteration of the band of parallel loops. The number of slots is the trip count of the band, which doesn't depend on the
+// number of threads. The slots are zeroed before the band, and after it they are summed pairwise in a fixed tree order
+// before the sum is added to the array, so the result is the same whatever the threads and the order they finish in.
+// Returns the buffer and the slot of the current iteration, or nothing if the band or the array don't have constant shapes
+std::optional<std::pair<mlir::Value, mlir::Value>> CreateDeterministicReductionPartials(mlir::OpBuilder& builder, mlir::Location loc, const std::vector<AffineForOp>& band, mlir::Value array)
+{
+    auto arrayType = array.getType().cast<MemRefType>();
+    if (!arrayType.hasStaticShape() || array.getDefiningOp<MakeCacheOp>())
+    {
+        return std::nullopt;
+    }
+
+    // The slot of an iteration is its row-major position in the iteration space of the band
+    int64_t numSlots = 1;
+    mlir::AffineExpr slotExpr = builder.getAffineConstantExpr(0);
+    std::vector<mlir::Value> bandIVs;
+    for (auto loop : band)
+    {
+        if (!loop.hasConstantBounds())
+        {
+            return std::nullopt;
+        }
+        auto lowerBound = loop.getConstantLowerBound();
+        auto step = loop.getStep();
+        auto tripCount = (loop.getConstantUpperBound() - lowerBound + step - 1) / step;
+        slotExpr = slotExpr * tripCount + (builder.getAffineDimExpr(bandIVs.size()) - lowerBound).floorDiv(step);
+        numSlots *= tripCount;
+        bandIVs.push_back(loop.getInductionVar());
+    }
+    mlir::Value slot = builder.create<mlir::AffineApplyOp>(loc, mlir::AffineMap::get(bandIVs.size(), 0, slotExpr), bandIVs);
+
+    auto elementType = arrayType.getElementType();
+    auto arrayShape = arrayType.getShape();
+    auto rank = static_cast<unsigned>(arrayShape.size());
+    std::vector<int64_t> partialsShape{ numSlots };
+    partialsShape.insert(partialsShape.end(), arrayShape.begin(), arrayShape.end());
+
+    OpBuilder::InsertionGuard guard(builder);
+    auto outerLoop = band.front();
+    builder.setInsertionPoint(outerLoop);
+    mlir::Value partials = builder.create<mlir::memref::AllocOp>(loc, mlir::MemRefType::get(partialsShape, elementType), mlir::ValueRange{}, builder.getI64IntegerAttr(64));
+    auto zero = builder.create<mlir::ConstantOp>(loc, elementType, builder.getZeroAttr(elementType));
+    mlir::buildAffineLoopNest(builder, loc, std::vector<int64_t>(rank + 1, 0), partialsShape, std::vector<int64_t>(rank + 1, 1), [&](mlir::OpBuilder& nestBuilder, mlir::Location nestLoc, mlir::ValueRange IVs) {
+        nestBuilder.create<mlir::AffineStoreOp>(nestLoc, zero, partials, IVs);
+    });
+
+    // Each level of the tree adds the slot at the distance of the level to each slot at a multiple of twice the distance
+    builder.setInsertionPointAfter(outerLoop);
+    auto addSlot = [&](mlir::OpBuilder& nestBuilder, mlir::Location nestLoc, mlir::Value dst, std::vector<mlir::Value> dstIndices, std::vector<mlir::Value> srcIndices) {
+        mlir::Value sum = nestBuilder.create<v::BinOp>(nestLoc, BinaryOpPredicate::ADD, nestBuilder.create<mlir::AffineLoadOp>(nestLoc, dst, dstIndices), nestBuilder.create<mlir::AffineLoadOp>(nestLoc, partials, srcIndices));
+        nestBuilder.create<mlir::AffineStoreOp>(nestLoc, sum, dst, dstIndices);
+    };
+    for (int64_t distance = 1; distance < numSlots; distance *= 2)
+    {
+        std::vector<int64_t> lowerBounds(rank + 1, 0);
+        std::vector<int64_t> upperBounds{ numSlots - distance };
+        upperBounds.insert(upperBounds.end(), arrayShape.begin(), arrayShape.end());
+        std::vector<int64_t> steps(rank + 1, 1);
+        steps[0] = 2 * distance;
+        mlir::buildAffineLoopNest(builder, loc, lowerBounds, upperBounds, steps, [&](mlir::OpBuilder& nestBuilder, mlir::Location nestLoc, mlir::ValueRange IVs) {
+            std::vector<mlir::Value> dstIndices(IVs.begin(), IVs.end());
+            auto srcIndices = dstIndices;
+            srcIndices[0] = nestBuilder.create<mlir::AffineApplyOp>(nestLoc, mlir::AffineMap::get(1, 0, nestBuilder.getAffineDimExpr(0) + distance), mlir::ValueRange{ IVs[0] });
+            addSlot(nestBuilder, nestLoc, partials, dstIndices, srcIndices);
+        });
+    }
+    mlir::buildAffineLoopNest(builder, loc, std::vector<int64_t>(rank, 0), arrayShape, std::vector<int64_t>(rank, 1), [&](mlir::OpBuilder& nestBuilder, mlir::Location nestLoc, mlir::ValueRange IVs) {
+        std::vector<mlir::Value> srcIndices{ nestBuilder.create<mlir::ConstantIndexOp>(nestLoc, 0) };
+        srcIndices.insert(srcIndices.end(), IVs.begin(), IVs.end());
+        addSlot(nestBuilder, nestLoc, array, std::vector<mlir::Value>(IVs.begin(), IVs.end()), srcIndices);
+    });
+    builder.create<mlir::memref::DeallocOp>(loc, partials);
+
+    return std::make_pair(partials, slot);
+}
+
+// Returns the parallelization of the copy loops of a cooperatively copied cache, which takes the threads of the
+// outermost parallel loop that uses the cache. Copies that already run inside a parallel loop stay serial
+std::optional<ParallelizationInfo> GetCooperativeCopyParallelization(mlir::Operation* copyOp, mlir::Value cache)
+{
+    auto makeCacheOp = cache.getDefiningOp<MakeCacheOp>();
+    if (!makeCacheOp || !makeCacheOp->hasAttr(CooperativeCacheCopyAttrName))
+    {
+        return std::nullopt;
+    }
+
+    for (auto loop = copyOp->getParentOfType<AffineForOp>(); loop; loop = loop->getParentOfType<AffineForOp>())
+    {
+        if (HasParallelizationInfo(loop))
+        {
+            return std::nullopt;
+        }
+    }
+
+    std::optional<ParallelizationInfo> result;
+    for (auto user : cache.getUsers())
+    {
+        for (auto loop = user->getParentOfType<AffineForOp>(); loop; loop = loop->getParentOfType<AffineForOp>())
+        {
+            if (HasParallelizationInfo(loop))
+            {
+                auto userInfo = GetParallelizationInfo(loop);
+                result = ParallelizationInfo{ userInfo.numThreads, ParallelSchedule::Static, userInfo.group, userInfo.procBind };
+            }
+        }
+        if (result)
+        {
+            break;
+        }
+    }
+    return result;
+}
+
+// Distributes the outermost loop of a cache copy nest across the threads of a cooperative copy
+void SetCooperativeCopyParallelization(ScheduleOp copyScheduleOp, const std::optional<ParallelizationInfo>& parallelizationInfo)
+{
+    auto copyOrder = copyScheduleOp.getOrder();
+    if (!parallelizationInfo || copyOrder.empty())
+    {
+        return;
+    }
+
+    // Loops that are vectorized or unrolled in place for the vector registers are too small to be worth splitting
+    if (auto loopAttrs = copyScheduleOp.getLoopAttributes(copyOrder.front()))
+    {
+        if (loopAttrs->get(VectorizationInfoAttr::getKeyName()) || loopAttrs->get(InPlaceUnrollInfoAttr::getKeyName()))
+        {
+            return;
+        }
+    }
+    SetParallelizationInfo(copyScheduleOp, copyOrder.front(), *parallelizationInfo);
+}
+
+// Returns whether a cache is written back to its array with non-temporal stores, which is requested either for the
+// cache or for its whole function. Only CPU targets emit non-temporal stores
+bool UsesNonTemporalWriteBack(mlir::Operation* writeBackOp, mlir::Value cache)
+{
+    auto execTargetOpt = util::ResolveExecutionTarget(writeBackOp);
+    if (!execTargetOpt || *execTargetOpt != v::ExecutionTarget::CPU)
+    {
+        return false;
+    }
+    if (auto makeCacheOp = cache.getDefiningOp<MakeCacheOp>(); makeCacheOp && makeCacheOp->hasAttr(NonTemporalWriteBackCacheAttrName))
+    {
+        return true;
+    }
+    auto funcOp = writeBackOp->getParentOfType<v::ValueFuncOp>();
+    return funcOp && funcOp->hasAttr(NonTemporalWriteBackAttrName);
+}
+
+// Returns the elementwise epilogue steps that a cache applies to its output when it is reduced back into the array
+mlir::ArrayAttr GetCacheEpilogue(mlir::Value cache)
+{
+    auto makeCacheOp = cache.getDefiningOp<MakeCacheOp>();
+    return makeCacheOp ? makeCacheOp->getAttrOfType<mlir::ArrayAttr>(CacheEpilogueAttrName) : mlir::ArrayAttr{};
+}
+
+// Applies the epilogue steps of a cache to an element of the output after it was accumulated, e.g. the bias-add and
+// activation of a dense layer, while the active block is still in registers. arrayPosition is the position of the element
+mlir::Value ApplyCacheEpilogue(mlir::OpBuilder& builder, mlir::Location loc, mlir::Value cache, mlir::Value value, const std::vector<mlir::Value>& arrayPosition)
+{
+    auto epilogue = GetCacheEpilogue(cache);
+    if (!epilogue)
+    {
+        return value;
+    }
+
+    auto makeCacheOp = cache.getDefiningOp<MakeCacheOp>();
+    auto elementType = value.getType();
+    auto createConstant = [&](mlir::Attribute attr) -> mlir::Value {
+        auto constantValue = attr.cast<mlir::FloatAttr>().getValueAsDouble();
+        if (elementType.isa<mlir::FloatType>())
+        {
+            return builder.create<mlir::ConstantOp>(loc, builder.getFloatAttr(elementType, constantValue));
+        }
+        return builder.create<mlir::ConstantOp>(loc, builder.getIntegerAttr(elementType, static_cast<int64_t>(constantValue)));
+    };
+
+    for (auto step : epilogue.getAsRange<mlir::DictionaryAttr>())
+    {
+        auto kind = step.getAs<mlir::StringAttr>("kind").getValue();
+        if (kind == "bias")
+        {
+            auto bias = makeCacheOp.epilogueArrays()[step.getAs<mlir::IntegerAttr>("operand").getInt()];
+            auto dim = step.getAs<mlir::IntegerAttr>("dim").getInt();
+            mlir::Value biasValue = builder.create<mlir::AffineLoadOp>(loc, bias, mlir::ValueRange{ arrayPosition[dim] });
+            value = builder.create<v::BinOp>(loc, BinaryOpPredicate::ADD, value, biasValue);
+        }
+        else if (kind == "scale")
+        {
+            value = builder.create<v::BinOp>(loc, BinaryOpPredicate::MUL, value, createConstant(step.get("value")));
+        }
+        else if (kind == "clamp")
+        {
+            if (auto minAttr = step.get("min"))
+            {
+                auto minValue = createConstant(minAttr);
+                auto isAboveMin = builder.create<v::CmpOp>(loc, CmpOpPredicate::GT, value, minValue);
+                value = builder.create<mlir::SelectOp>(loc, isAboveMin, value, minValue);
+            }
+            if (auto maxAttr = step.get("max"))
+            {
+                auto maxValue = createConstant(maxAttr);
+                auto isBelowMax = builder.create<v::CmpOp>(loc, CmpOpPredicate::LT, value, maxValue);
+                value = builder.create<mlir::SelectOp>(loc, isBelowMax, value, maxValue);
+            }
+        }
+        else
+        {
+            assert(false && "Unknown cache epilogue step");
+        }
+    }
+    return value;
+}
+
+// Returns whether a cache is a GPU double-buffer temp array that is filled with asynchronous copies
+bool UsesAsyncCopy(mlir::Value cache)
+{
+    auto makeCacheOp = cache.getDefiningOp<MakeCacheOp>();
+    return makeCacheOp && makeCacheOp->hasAttr(AsyncCopyCacheAttrName);
+}
+
+// Returns whether the double-buffer temp array of a cache region can be filled with asynchronous copies. The copies go
+// straight from global to shared memory, which needs cp.async (CUDA, compute capability 8.0 and later, with a fallback
+// to regular copies on older devices)
+bool CanUseAsyncCopy(BeginCacheRegionOp cacheRegionOp, MakeCacheOp tempArray)
+{
+    if (util::ResolveExecutionRuntime(cacheRegionOp) != v::ExecutionRuntime::CUDA || tempArray.memorySpace() != v::MemorySpace::Shared)
+    {
+        return false;
+    }
+    auto inputMemorySpace = cacheRegionOp.input().getType().cast<mlir::MemRefType>().getMemorySpaceAsInt();
+    return inputMemorySpace == static_cast<unsigned int>(v::MemorySpace::None) || inputMemorySpace == static_cast<unsigned int>(v::MemorySpace::Global);
+}
+
+// Create a GPUAsyncCopyOp that copies an element of src to dst, understanding how to access caches
+v::GPUAsyncCopyOp CreateAsyncCopy(mlir::OpBuilder& builder,
+                                  mlir::Location loc,
+                                  mlir::Value src,
+                                  mlir::Value dst,
+                                  const std::vector<mlir::Value>& baseArrayPosition,
+                                  const std::vector<std::pair<Index, mlir::Value>>& unrealizedLoopNestIndices = {})
+{
+    auto resolvePosition = [&](mlir::Value memref) {
+        if (auto cacheOp = mlir::dyn_cast_or_null<MakeCacheOp>(memref.getDefiningOp()))
+        {
+            mlir::AffineValueMap accessInfo = cacheOp.insertCachePosition(builder.getInsertionBlock(), baseArrayPosition, unrealizedLoopNestIndices);
+            std::vector<mlir::Value> operands(accessInfo.getOperands().begin(), accessInfo.getOperands().end());
+            return util::MultiDimAffineApply(builder, loc, accessInfo.getAffineMap(), operands);
+        }
+        return baseArrayPosition;
+    };
+    auto srcPosition = resolvePosition(src);
+    auto dstPosition = resolvePosition(dst);
+    return builder.create<v::GPUAsyncCopyOp>(loc, src, srcPosition, dst, dstPosition);
+}
+
+// Prefetches the active block that a cache copy will read a given number of iterations of its closest enclosing
+// trigger loop from now, so that the next fill finds its data in the data cache. The prefetched block is found by
+// shifting the trigger loop IV in the copy's lower bound operands, clamped to the last iteration of the loop
+void CreateActiveBlockPrefetch(mlir::OpBuilder& builder, mlir::Location loc, mlir::Operation* copyOp, mlir::Value array, mlir::Value cache, const std::vector<mlir::AffineMap>& lbMaps, mlir::ValueRange lbOperands, const std::vector<int64_t>& activeBlockShape, unsigned elementByteWidth)
+{
+    auto makeCacheOp = cache.getDefiningOp<MakeCacheOp>();
+    auto prefetchDistanceAttr = makeCacheOp ? makeCacheOp->getAttrOfType<mlir::IntegerAttr>(PrefetchDistanceAttrName) : mlir::IntegerAttr{};
+    if (!prefetchDistanceAttr || activeBlockShape.empty())
+    {
+        return;
+    }
+
+    // The trigger loop is the closest enclosing loop whose IV moves the active block
+    mlir::AffineForOp triggerLoop;
+    unsigned triggerOperandIdx = 0;
+    for (auto loop = copyOp->getParentOfType<AffineForOp>(); loop && !triggerLoop; loop = loop->getParentOfType<AffineForOp>())
+    {
+        auto operandIt = llvm::find(lbOperands, loop.getInductionVar());
+        if (operandIt != lbOperands.end())
+        {
+            triggerLoop = loop;
+            triggerOperandIdx = static_cast<unsigned>(std::distance(lbOperands.begin(), operandIt));
+        }
+    }
+    if (!triggerLoop || !triggerLoop.hasConstantBounds())
+    {
+        return;
+    }
+
+    auto begin = triggerLoop.getConstantLowerBound();
+    auto end = triggerLoop.getConstantUpperBound();
+    auto step = triggerLoop.getStep();
+    if (end - begin <= step)
+    {
+        // Only one active block, so there is nothing ahead of it to prefetch
+        return;
+    }
+    auto lastIteration = begin + ((end - begin - 1) / step) * step;
+
+    auto prefetchIVExpr = builder.getAffineDimExpr(0) + prefetchDistanceAttr.getInt() * step;
+    auto prefetchIVMap = mlir::AffineMap::get(1, 0, { prefetchIVExpr, builder.getAffineConstantExpr(lastIteration) }, builder.getContext());
+    mlir::Value prefetchIV = builder.create<mlir::AffineMinOp>(loc, prefetchIVMap, mlir::ValueRange{ triggerLoop.getInductionVar() });
+
+    std::vector<mlir::Value> prefetchOperands(lbOperands.begin(), lbOperands.end());
+    prefetchOperands[triggerOperandIdx] = prefetchIV;
+    std::vector<mlir::Value> prefetchBlockLowerBounds;
+    for (auto lbMap : lbMaps)
+    {
+        prefetchBlockLowerBounds.push_back(builder.create<mlir::AffineApplyOp>(loc, lbMap, prefetchOperands));
+    }
+
+    // Touch one element per cache line along the dimension that is contiguous in memory
+    auto memRefType = array.getType().cast<mlir::MemRefType>();
+    unsigned contiguousDim = activeBlockShape.size() - 1;
+    llvm::SmallVector<int64_t, 4> strides;
+    int64_t offset;
+    if (succeeded(mlir::getStridesAndOffset(memRefType, strides, offset)))
+    {
+        auto unitStrideIt = llvm::find(strides, 1);
+        if (unitStrideIt != strides.end())
+        {
+            contiguousDim = static_cast<unsigned>(std::distance(strides.begin(), unitStrideIt));
+        }
+    }
+    const int64_t cacheLineBytes = 64;
+    std::vector<int64_t> lowerBounds(activeBlockShape.size(), 0);
+    std::vector<int64_t> steps(activeBlockShape.size(), 1);
+    steps[contiguousDim] = std::max<int64_t>(1, cacheLineBytes / std::max<int64_t>(1, elementByteWidth));
+
+    // Map from (block lower bounds..., block IVs...) to the prefetched array position
+    auto rank = static_cast<unsigned>(activeBlockShape.size());
+    std::vector<mlir::AffineExpr> positionExprs;
+    for (unsigned dim = 0; dim < rank; ++dim)
+    {
+        positionExprs.push_back(builder.getAffineDimExpr(dim) + builder.getAffineDimExpr(rank + dim));
+    }
+    auto positionMap = mlir::AffineMap::get(2 * rank, 0, positionExprs, builder.getContext());
+
+    mlir::buildAffineLoopNest(builder, loc, lowerBounds, activeBlockShape, steps, [&](mlir::OpBuilder& nestBuilder, mlir::Location nestLoc, mlir::ValueRange IVs) {
+        std::vector<mlir::Value> positionOperands(prefetchBlockLowerBounds);
+        positionOperands.insert(positionOperands.end(), IVs.begin(), IVs.end());
+        nestBuilder.create<mlir::AffinePrefetchOp>(nestLoc, array, positionMap, positionOperands, /*isWrite=*/false, /*localityHint=*/3, /*isDataCache=*/true);
+    });
+}
+
+// Describes a cache copy between an array and a cache that are contiguous in memory along different dimensions of
+// the active block, which is copied in square tiles that are transposed in vector registers
+struct TransposedCacheCopyInfo
+{
+    unsigned sourceContiguousDim;
+    unsigned destContiguousDim;
+    int64_t tileSize;
+};
+
+std::optional<unsigned> GetUnitStrideDim(mlir::MemRefType memRefType)
+{
+    llvm::SmallVector<int64_t, 4> strides;
+    int64_t offset;
+    if (failed(mlir::getStridesAndOffset(memRefType, strides, offset)))
+    {
+        return std::nullopt;
+    }
+    auto unitStrideIt = llvm::find(strides, 1);
+    if (unitStrideIt == strides.end())
+    {
+        return std::nullopt;
+    }
+    return static_cast<unsigned>(std::distance(strides.begin(), unitStrideIt));
+}
+
+// Returns how to copy the active block of a cache copy with transposed tiles, or nothing if the array and the cache
+// are contiguous along the same dimension or the tiles of one vector register per row don't fit the active block
+std::optional<TransposedCacheCopyInfo> GetTransposedCacheCopyInfo(ActiveBlockCacheCopyOp cacheCopyOp, const std::vector<mlir::AffineMap>& lbMaps, const std::vector<int64_t>& activeBlockShape, const std::optional<VectorizationInfo>& vecInfo, unsigned elementByteWidth)
+{
+    if (!vecInfo || vecInfo->unrollOnly || elementByteWidth == 0)
+    {
+        return std::nullopt;
+    }
+    int64_t tileSize = vecInfo->vectorBytes / elementByteWidth;
+    if (tileSize < 2 || !llvm::isPowerOf2_64(tileSize))
+    {
+        return std::nullopt;
+    }
+
+    // The array is indexed with the active block position, while the cache layout can order the dimensions differently
+    auto arrayType = cacheCopyOp.array().getType().cast<mlir::MemRefType>();
+    auto cacheType = cacheCopyOp.cache().getType().cast<mlir::MemRefType>();
+    if (!arrayType.hasStaticShape() || !arrayType.getElementType().isIntOrFloat() || static_cast<size_t>(arrayType.getRank()) != activeBlockShape.size() || !cacheCopyOp.cache().getDefiningOp<MakeCacheOp>())
+    {
+        return std::nullopt;
+    }
+    if (llvm::any_of(lbMaps, [&](mlir::AffineMap lbMap) { return lbMap.getNumResults() != 1 || lbMap.getNumDims() != lbMaps.front().getNumDims(); }))
+    {
+        return std::nullopt;
+    }
+
+    auto arrayDim = GetUnitStrideDim(arrayType);
+    auto cacheUnitStrideDim = GetUnitStrideDim(cacheType);
+    if (!arrayDim || !cacheUnitStrideDim || *cacheUnitStrideDim != cacheType.getRank() - 1)
+    {
+        return std::nullopt;
+    }
+
+    // The innermost cache dimension has to be a single active block dimension, e.g. not a panel of one
+    auto activeBlockToCacheMap = cacheCopyOp.activeBlockToCacheMap();
+    if (activeBlockToCacheMap.getNumResults() == 0)
+    {
+        return std::nullopt;
+    }
+    auto cacheDimExpr = activeBlockToCacheMap.getResults().back().dyn_cast<mlir::AffineDimExpr>();
+    if (!cacheDimExpr || cacheDimExpr.getPosition() >= activeBlockShape.size())
+    {
+        return std::nullopt;
+    }
+    auto cacheDim = cacheDimExpr.getPosition();
+    if (cacheDim == *arrayDim || activeBlockShape[*arrayDim] % tileSize != 0 || activeBlockShape[cacheDim] % tileSize != 0)
+    {
+        return std::nullopt;
+    }
+
+    if (cacheCopyOp.toCache())
+    {
+        return TransposedCacheCopyInfo{ *arrayDim, cacheDim, tileSize };
+    }
+    return TransposedCacheCopyInfo{ cacheDim, *arrayDim, tileSize };
+}
+
+// Returns the condition on the lower bound operands of an active block that the whole block lies inside the array
+mlir::IntegerSet GetActiveBlockInArraySet(const std::vector<mlir::AffineMap>& lbMaps, const std::vector<int64_t>& activeBlockShape, llvm::ArrayRef<int64_t> arrayShape)
+{
+    std::vector<mlir::AffineExpr> constraints;
+    for (unsigned dim = 0; dim < lbMaps.size(); ++dim)
+    {
+        auto lbExpr = lbMaps[dim].getResult(0);
+        constraints.push_back(lbExpr);
+        constraints.push_back((arrayShape[dim] - activeBlockShape[dim]) - lbExpr);
+    }
+    llvm::SmallVector<bool, 8> eqFlags(constraints.size(), false);
+    return mlir::IntegerSet::get(lbMaps.front().getNumDims(), lbMaps.front().getNumSymbols(), constraints, eqFlags);
+}
+
+// Copies an active block between an array and a cache that are contiguous along different dimensions in square tiles.
+// Each tile is read with one vector load per row, transposed with shuffles and written with one vector store per column.
+// Returns the schedule of the loops over the tiles
+ScheduleOp CreateTransposedActiveBlockCopy(mlir::OpBuilder& builder, mlir::Location loc, ActiveBlockCacheCopyOp cacheCopyOp, const TransposedCacheCopyInfo& transposeInfo, const std::vector<mlir::AffineMap>& lbMaps, mlir::ValueRange lbOperands, const std::vector<int64_t>& activeBlockShape, unsigned elementByteWidth, const v::ExecutionTarget& execTarget)
+{
+    auto array = cacheCopyOp.array();
+    auto cache = cacheCopyOp.cache();
+    bool arrayToCache = cacheCopyOp.toCache();
+    auto arrayType = array.getType().cast<mlir::MemRefType>();
+    auto rank = static_cast<unsigned>(arrayType.getRank());
+    auto tileSize = transposeInfo.tileSize;
+    auto srcDim = transposeInfo.sourceContiguousDim;
+    auto dstDim = transposeInfo.destContiguousDim;
+    auto vectorType = mlir::VectorType::get({ tileSize }, arrayType.getElementType());
+
+    // Vector transfers run along the last dimension, so e.g. a column-major array is viewed with its rows and columns swapped
+    unsigned arrayUnitStrideDim = arrayToCache ? srcDim : dstDim;
+    std::vector<unsigned> arrayPermutation;
+    for (unsigned dim = 0; dim < rank; ++dim)
+    {
+        if (dim != arrayUnitStrideDim)
+        {
+            arrayPermutation.push_back(dim);
+        }
+    }
+    arrayPermutation.push_back(arrayUnitStrideDim);
+    mlir::Value arrayView = array;
+    if (arrayUnitStrideDim != rank - 1)
+    {
+        auto permutationMap = mlir::AffineMap::getPermutationMap(arrayPermutation, builder.getContext());
+        arrayView = builder.create<mlir::memref::TransposeOp>(loc, array, mlir::AffineMapAttr::get(permutationMap));
+    }
+
+    auto getAccess = [&](mlir::OpBuilder& currentBuilder, bool accessCache, const std::vector<mlir::Value>& position) -> std::pair<mlir::Value, std::vector<mlir::Value>> {
+        if (accessCache)
+        {
+            auto cacheOp = cache.getDefiningOp<MakeCacheOp>();
+            mlir::AffineValueMap accessInfo = cacheOp.insertCachePosition(currentBuilder.getInsertionBlock(), position, {});
+            std::vector<mlir::Value> operands(accessInfo.getOperands().begin(), accessInfo.getOperands().end());
+            return { cache, util::MultiDimAffineApply(currentBuilder, loc, accessInfo.getAffineMap(), operands) };
+        }
+        std::vector<mlir::Value> indices;
+        for (auto dim : arrayPermutation)
+        {
+            indices.push_back(position[dim]);
+        }
+        return { arrayView, indices };
+    };
+
+    std::vector<int64_t> tileGridShape = activeBlockShape;
+    tileGridShape[srcDim] /= tileSize;
+    tileGridShape[dstDim] /= tileSize;
+    auto [copyNestOp, copyScheduleOp, copyExecPlanOp] = CreateActiveBlockCacheLoopnest(builder, loc, tileGridShape, {}, std::nullopt, elementByteWidth, execTarget, "transposed_copy", [&](mlir::OpBuilder& currentBuilder, const std::vector<mlir::Value>& orderedSymbolicIndexOpValues) {
+        // The position of the first element of the tile, offset by the active block lower bounds as in the element-wise copy
+        std::vector<mlir::Value> tilePosition;
+        for (unsigned dim = 0; dim < rank; ++dim)
+        {
+            int64_t scale = (dim == srcDim || dim == dstDim) ? tileSize : 1;
+            auto positionMap = mlir::AffineMap::get(2, 0, currentBuilder.getAffineDimExpr(0) + scale * currentBuilder.getAffineDimExpr(1));
+            mlir::Value lbMapApplied = currentBuilder.create<mlir::AffineApplyOp>(loc, lbMaps[dim], lbOperands);
+            tilePosition.push_back(currentBuilder.create<mlir::AffineApplyOp>(loc, positionMap, mlir::ValueRange{ lbMapApplied, orderedSymbolicIndexOpValues[dim] }));
+        }
+        auto offsetPosition = [&](unsigned dim, int64_t offset) {
+            auto position = tilePosition;
+            if (offset != 0)
+            {
+                auto offsetMap = mlir::AffineMap::get(1, 0, currentBuilder.getAffineDimExpr(0) + offset);
+                position[dim] = currentBuilder.create<mlir::AffineApplyOp>(loc, offsetMap, mlir::ValueRange{ tilePosition[dim] });
+            }
+            return position;
+        };
+
+        llvm::SmallVector<bool, 1> inBounds = { true };
+        std::vector<mlir::Value> rows;
+        for (int64_t row = 0; row < tileSize; ++row)
+        {
+            auto [buffer, indices] = getAccess(currentBuilder, !arrayToCache, offsetPosition(dstDim, row));
+            rows.push_back(currentBuilder.create<mlir::vector::TransferReadOp>(loc, vectorType, buffer, indices, inBounds));
+        }
+        auto columns = CreateTransposedVectors(currentBuilder, loc, rows);
+        for (int64_t column = 0; column < tileSize; ++column)
+        {
+            auto [buffer, indices] = getAccess(currentBuilder, arrayToCache, offsetPosition(srcDim, column));
+            currentBuilder.create<mlir::vector::TransferWriteOp>(loc, columns[column], buffer, indices, inBounds);
+        }
+    });
+    return copyScheduleOp;
+}
+
+bool HasBaseArrayAccessAttrs(mlir::Operation* op)
+{
+    return op->hasAttr(BaseArrayAccessMapAttrName) && op->hasAttr(BaseArrayAccessIndicesAttrName);
 }
 
 void SetBaseArrayAccessAttrs(mlir::Operation* op, mlir::AffineMap accessMap, const std::vector<IndexAttr>& indices)
@@ -1833,6 +2924,34 @@ bool IsCacheOp(mlir::Operation* op)
 
 } // namespace
 
+// Returns the innermost parallelized loop that contains every use of the cache, if any. Unless requireFirstTouch is false,
+// only loops parallelized with first-touch placement are considered
+AffineForOp GetCacheAllocationParallelLoop(mlir::Value cache, bool requireFirstTouch)
+{
+    auto cacheUsers = cache.getUsers();
+    for (auto loop = (*cacheUsers.begin())->getParentOfType<AffineForOp>(); loop; loop = loop->getParentOfType<AffineForOp>())
+    {
+        if (!HasParallelizationInfo(loop) || (requireFirstTouch && !GetParallelizationInfo(loop).firstTouch))
+        {
+            continue;
+        }
+
+        // Allocating in a loop that is collapsed with its child would break the perfect nesting of the band,
+        // see CollapseAffineParallelOpsRewrite
+        auto& firstOp = loop.getBody()->front();
+        if (isa<AffineForOp>(firstOp) && HasParallelizationInfo(&firstOp) && GetParallelizationInfo(&firstOp).group == GetParallelizationInfo(loop).group)
+        {
+            continue;
+        }
+
+        if (llvm::all_of(cacheUsers, [&](Operation* user) { return loop->isProperAncestor(user); }))
+        {
+            return loop;
+        }
+    }
+    return {};
+}
+
 LogicalResult MakeCacheOpLowering::matchAndRewrite(MakeCacheOp makeCacheOp, PatternRewriter& rewriter) const
 {
     auto loc = makeCacheOp.getLoc();
@@ -1871,13 +2990,31 @@ LogicalResult MakeCacheOpLowering::matchAndRewrite(MakeCacheOp makeCacheOp, Patt
             auto elementsPerVector = vecInfo.vectorBytes / elementByteWidth;
             stackAllocateBuffer = cacheType.getNumElements() <= (elementsPerVector * vecInfo.vectorUnitCount);
         }
+        auto threadLocal = makeCacheOp->hasAttr(ThreadLocalCacheAttrName);
         if (stackAllocateBuffer)
         {
+            OpBuilder::InsertionGuard guard(rewriter);
+            if (auto parallelLoop = threadLocal ? GetCacheAllocationParallelLoop(cacheArray, false) : AffineForOp{})
+            {
+                // A stack buffer allocated outside of the parallel region would be shared by the threads
+                rewriter.setInsertionPointToStart(parallelLoop.getBody());
+            }
             cacheGlobalBuffer = rewriter.create<mlir::memref::AllocaOp>(loc, cacheType, mlir::ValueRange{}, rewriter.getI64IntegerAttr(32));
         }
+        else if (auto parallelLoop = GetCacheAllocationParallelLoop(cacheArray, !threadLocal))
+        {
+            // Each iteration of the parallel loop allocates its own buffer, so the cache is private to the thread
+            // that fills and uses it and its pages are first touched by that thread instead of being shared by all the threads
+            OpBuilder::InsertionGuard guard(rewriter);
+            rewriter.setInsertionPointToStart(parallelLoop.getBody());
+            cacheGlobalBuffer = rewriter.create<mlir::memref::AllocOp>(loc, cacheType, mlir::ValueRange{}, rewriter.getI64IntegerAttr(64));
+            rewriter.setInsertionPoint(parallelLoop.getBody()->getTerminator());
+            rewriter.create<mlir::memref::DeallocOp>(loc, cacheGlobalBuffer);
+        }
         else
         {
             cacheGlobalBuffer = util::CreateGlobalBuffer(rewriter, makeCacheOp, cacheType, "cache");
+            cacheGlobalBuffer.getDefiningOp<v::ReferenceGlobalOp>().getGlobal()->setAttr(CacheBufferAttrName, rewriter.getUnitAttr());
         }
     }
     else
@@ -1886,6 +3023,12 @@ LogicalResult MakeCacheOpLowering::matchAndRewrite(MakeCacheOp makeCacheOp, Patt
         cacheGlobalBuffer = rewriter.create<v::AllocOp>(loc, cacheType, llvm::None);
     }
 
+    // Caches that aren't globals are tagged on their allocation, so that they're told apart from the other buffers
+    if (auto allocOp = cacheGlobalBuffer.getDefiningOp(); allocOp && !isa<v::ReferenceGlobalOp>(allocOp))
+    {
+        allocOp->setAttr(CacheBufferAttrName, rewriter.getUnitAttr());
+    }
+
     rewriter.replaceOp(makeCacheOp, ValueRange{ cacheGlobalBuffer });
 
     return success();
@@ -2153,10 +3296,16 @@ LogicalResult ActiveBlockCacheCopyOpRewrite::matchAndRewrite(ActiveBlockCacheCop
     auto baseCacheElementType = GetInnerElementType(cache); // e.g. f32
     unsigned fullCacheRank = cacheMemRefType.getRank();
 
-    assert(baseArrayElementType == baseCacheElementType && "Copy source and dest data types don't match");
+    assert((baseArrayElementType == baseCacheElementType || cache.getDefiningOp()->hasAttr(CacheElementTypeAttrName)) && "Copy source and dest data types don't match");
 
     bool arrayToCache = cacheCopyOp.toCache();
 
+    if (!arrayToCache && GetCacheEpilogue(cache))
+    {
+        // Only the caches of accumulated outputs, e.g. C += A * B, are written back by a reduce that applies the epilogue
+        return cacheCopyOp.emitError("Cache epilogues are only supported for caches of outputs that are accumulated into");
+    }
+
     // Similar to generatePointWiseCopy() from llvm-project\mlir\lib\Transforms\Utils\LoopUtils.cpp however
     // we have a custom mapping from the active block to the cache position
 
@@ -2202,6 +3351,13 @@ LogicalResult ActiveBlockCacheCopyOpRewrite::matchAndRewrite(ActiveBlockCacheCop
 
         if (execTarget == v::ExecutionTarget::GPU)
         {
+            // The asynchronous copies into a double-buffer temp array only need to have landed once the temp array is copied
+            // into the cache. The barrier that follows the wait makes the data of all the threads of the block visible
+            bool asyncCopy = UsesAsyncCopy(cache);
+            if (asyncCopy && !arrayToCache)
+            {
+                rewriter.create<v::GPUAsyncCopyWaitOp>(loc, rewriter.getI64IntegerAttr(0));
+            }
             if (!cacheCopyOp.skipBarriers())
             {
                 (void)util::CreateGPUControlBarrier(rewriter, "Block", loc);
@@ -2288,7 +3444,16 @@ LogicalResult ActiveBlockCacheCopyOpRewrite::matchAndRewrite(ActiveBlockCacheCop
                     return std::make_pair(dimIdxCounter++, stride);
                 });
 
+                // Consecutive threads copy consecutive elements of the array, so that their accesses of the array are coalesced.
+                // The strides that are only known at runtime come from the sizes of the dimensions that follow them, so they
+                // come after the constant strides, from the innermost dimension out
                 std::sort(activeBlockLogicalDimAndStride.begin(), activeBlockLogicalDimAndStride.end(), [](const std::pair<size_t, int64_t>& left, const std::pair<size_t, int64_t>& right) {
+                    bool leftDynamic = mlir::ShapedType::isDynamicStrideOrOffset(left.second);
+                    bool rightDynamic = mlir::ShapedType::isDynamicStrideOrOffset(right.second);
+                    if (leftDynamic || rightDynamic)
+                    {
+                        return leftDynamic == rightDynamic ? left.first > right.first : rightDynamic;
+                    }
                     return left.second < right.second;
                 });
 
@@ -2331,7 +3496,11 @@ LogicalResult ActiveBlockCacheCopyOpRewrite::matchAndRewrite(ActiveBlockCacheCop
                     auto index = indexOp.index().getValue();
                     unrealizedLoopNestIndices.emplace_back(index, loopnestIV);
                 }
-                if (arrayToCache)
+                if (arrayToCache && asyncCopy)
+                {
+                    CreateAsyncCopy(currentBuilder, loc, array, cache, lowerBoundOffsetIVs, unrealizedLoopNestIndices);
+                }
+                else if (arrayToCache)
                 {
                     mlir::Value loadedValue = CreateLoad(currentBuilder, loc, array, lowerBoundOffsetIVs, unrealizedLoopNestIndices);
                     CreateStore(currentBuilder, loc, loadedValue, cache, lowerBoundOffsetIVs, unrealizedLoopNestIndices);
@@ -2343,6 +3512,11 @@ LogicalResult ActiveBlockCacheCopyOpRewrite::matchAndRewrite(ActiveBlockCacheCop
                 }
             });
 
+            if (arrayToCache && asyncCopy)
+            {
+                rewriter.create<v::GPUAsyncCopyCommitOp>(loc);
+            }
+
             if (useThreadMappings)
             {
                 auto threadZProcStr = v::stringifyEnum(v::Processor::ThreadZ);
@@ -2372,6 +3546,24 @@ LogicalResult ActiveBlockCacheCopyOpRewrite::matchAndRewrite(ActiveBlockCacheCop
         }
         else
         {
+            auto copyParallelization = GetCooperativeCopyParallelization(cacheCopyOp, cache);
+
+            // When the cache layout transposes the array, blocks that lie inside the array are copied with transposed
+            // tiles and only the blocks on the edges of the array fall back to the bounds checked element-wise copy
+            mlir::AffineIfOp transposedCopyIfOp;
+            auto transposeInfo = UsesNonTemporalWriteBack(cacheCopyOp, cache) ? std::nullopt : GetTransposedCacheCopyInfo(cacheCopyOp, lbMaps, activeBlockShape, vecInfo, elementByteWidth);
+            if (transposeInfo)
+            {
+                auto inArraySet = GetActiveBlockInArraySet(lbMaps, activeBlockShape, memRefType.getShape());
+                transposedCopyIfOp = rewriter.create<mlir::AffineIfOp>(loc, inArraySet, lbOperands, /*withElseRegion=*/true);
+
+                rewriter.setInsertionPoint(transposedCopyIfOp.getThenBlock()->getTerminator());
+                auto transposedCopyScheduleOp = CreateTransposedActiveBlockCopy(rewriter, loc, cacheCopyOp, *transposeInfo, lbMaps, lbOperands, activeBlockShape, elementByteWidth, execTarget);
+                SetCooperativeCopyParallelization(transposedCopyScheduleOp, copyParallelization);
+
+                rewriter.setInsertionPoint(transposedCopyIfOp.getElseBlock()->getTerminator());
+            }
+
             auto [copyNestOp, copyScheduleOp, copyExecPlanOp] = CreateActiveBlockCacheLoopnest(rewriter, loc, activeBlockShape, {}, vecInfo, elementByteWidth, execTarget, "copy", [&](OpBuilder& currentBuilder, const std::vector<mlir::Value>& orderedSymbolicIndexOpValues) {
                 // The induction variables have been shifted to represent the constant iteration space
                 // however, the maps expect they are constructed based on the original mappings so we
@@ -2413,17 +3605,42 @@ LogicalResult ActiveBlockCacheCopyOpRewrite::matchAndRewrite(ActiveBlockCacheCop
             {
                 copyScheduleOp.addLoopAttribute(loopIndex, rewriter.getIdentifier(AccessBoundsCheckAttrName), rewriter.getUnitAttr());
             }
+
+            // The parallel loop ends with a barrier, so the threads only start using the cache once it is filled
+            SetCooperativeCopyParallelization(copyScheduleOp, copyParallelization);
+
+            if (transposedCopyIfOp)
+            {
+                rewriter.setInsertionPointAfter(transposedCopyIfOp);
+            }
+
+            if (arrayToCache)
+            {
+                CreateActiveBlockPrefetch(rewriter, loc, cacheCopyOp, array, cache, lbMaps, lbOperands, activeBlockShape, elementByteWidth);
+            }
+            else if (UsesNonTemporalWriteBack(cacheCopyOp, cache))
+            {
+                for (const auto& loopIndex : copyOrder)
+                {
+                    copyScheduleOp.addLoopAttribute(loopIndex, rewriter.getIdentifier(NonTemporalStoresAttrName), rewriter.getUnitAttr());
+                }
+            }
         }
     }
     else
     {
         std::vector<mlir::Value> copyIVs;
+        bool nonTemporalStores = !arrayToCache && UsesNonTemporalWriteBack(cacheCopyOp, cache);
 
         // Are we able to replace these with loopnests? we don't have a way to construct loopnests with affine map lower/upper bounds currently
         for (unsigned arrayDim = 0; arrayDim < outerArrayRank; ++arrayDim)
         {
             auto forOp = mlir::createCanonicalizedAffineForOp(currentBuilder, loc, lbOperands, lbMaps[arrayDim], ubOperands, ubMaps[arrayDim]);
             currentBuilder = mlir::OpBuilder::atBlockTerminator(forOp.getBody());
+            if (nonTemporalStores)
+            {
+                forOp->setAttr(NonTemporalStoresAttrName, rewriter.getUnitAttr());
+            }
 
             // Subscript for the slow memref being copied.
             copyIVs.push_back(forOp.getInductionVar());
@@ -2480,7 +3697,7 @@ LogicalResult ActiveBlockCacheReduceOpRewrite::matchAndRewrite(ActiveBlockCacheR
     unsigned cacheMemRefSpace = cacheMemRefType.getMemorySpaceAsInt();
     auto baseCacheElementType = GetInnerElementType(cache); // e.g. f32
 
-    assert(baseArrayElementType == baseCacheElementType && "Copy source and dest data types don't match");
+    assert((baseArrayElementType == baseCacheElementType || cache.getDefiningOp()->hasAttr(CacheElementTypeAttrName)) && "Copy source and dest data types don't match");
 
     // Similar to generatePointWiseCopy() from llvm-project\mlir\lib\Transforms\Utils\LoopUtils.cpp however
     // we have a custom mapping from the active block to the cache position
@@ -2513,13 +3730,64 @@ LogicalResult ActiveBlockCacheReduceOpRewrite::matchAndRewrite(ActiveBlockCacheR
 
     auto constantShapeOpt = GetConstantActiveBlockShape(lbMaps, ubMaps);
 
+    // Each iteration of a parallel reduction accumulates into its own cache, so the caches are merged
+    // into the shared array with atomic adds instead of racing on the load and store of each element
+    auto atomicReduce = IsInParallelReduction(cacheReduceOp);
+
+    // The iterations of a deterministic reduction accumulate into their own slot of a buffer of partial results instead,
+    // which are combined in a fixed order after the parallel loops
+    std::optional<std::pair<mlir::Value, mlir::Value>> deterministicPartials;
+    if (auto band = GetDeterministicReductionBand(cacheReduceOp); !band.empty())
+    {
+        deterministicPartials = CreateDeterministicReductionPartials(rewriter, loc, band, array);
+        if (!deterministicPartials)
+        {
+            return cacheReduceOp.emitError("Deterministic parallel reductions require constant loop bounds and arrays with a static shape");
+        }
+        atomicReduce = false;
+    }
+
+    // The epilogue transforms the final value of each output element, so it needs the reduce to write it once
+    if (GetCacheEpilogue(cache) && (atomicReduce || deterministicPartials || array.getDefiningOp<MakeCacheOp>()))
+    {
+        return cacheReduceOp.emitError("Cache epilogues can't be applied by hierarchical caches or in parallel reductions");
+    }
+
     std::optional<VectorizationInfo> vecInfo;
     auto vecInfoLLVMOpt = cacheReduceOp.vectorizationInfo();
-    if (vecInfoLLVMOpt.hasValue())
+    if (vecInfoLLVMOpt.hasValue() && !atomicReduce && !deterministicPartials)
     {
         vecInfo = vecInfoLLVMOpt.getValue().getValue();
     }
 
+    // A cache that stores wider elements than its array accumulates the array's elements in its element type, which is
+    // only rounded to the array's element type once the sum is complete. Atomic adds are done in the array's element type.
+    auto accumulateType = !atomicReduce && AccumulatesInCacheElementType(baseCacheElementType, baseArrayElementType) ? baseCacheElementType : baseArrayElementType;
+    auto accumulateScaleValue = ConvertElementType(rewriter, loc, scaleValue, accumulateType);
+    auto reduceElement = [&](OpBuilder& builder, const std::vector<mlir::Value>& IVs) {
+        mlir::Value loadedCacheValue = ConvertElementType(builder, loc, CreateLoad(builder, loc, cache, IVs), accumulateType);
+        auto scaledCacheValue = builder.create<v::BinOp>(loc, BinaryOpPredicate::MUL, accumulateScaleValue, loadedCacheValue);
+        if (atomicReduce)
+        {
+            CreateAtomicAccumulate(builder, loc, scaledCacheValue, array, IVs);
+            return;
+        }
+        if (deterministicPartials)
+        {
+            auto [partials, slot] = *deterministicPartials;
+            std::vector<mlir::Value> slotIVs{ slot };
+            slotIVs.insert(slotIVs.end(), IVs.begin(), IVs.end());
+            mlir::Value currentPartialValue = ConvertElementType(builder, loc, builder.create<mlir::memref::LoadOp>(loc, partials, slotIVs), accumulateType);
+            mlir::Value accumulatedValue = builder.create<v::BinOp>(loc, BinaryOpPredicate::ADD, currentPartialValue, scaledCacheValue);
+            builder.create<mlir::memref::StoreOp>(loc, ConvertElementType(builder, loc, accumulatedValue, baseArrayElementType), partials, slotIVs);
+            return;
+        }
+        mlir::Value currentArrayValue = ConvertElementType(builder, loc, CreateLoad(builder, loc, array, IVs), accumulateType);
+        mlir::Value accumulatedValue = builder.create<v::BinOp>(loc, BinaryOpPredicate::ADD, currentArrayValue, scaledCacheValue);
+        accumulatedValue = ApplyCacheEpilogue(builder, loc, cache, ConvertElementType(builder, loc, accumulatedValue, baseArrayElementType), IVs);
+        CreateStore(builder, loc, accumulatedValue, array, IVs);
+    };
+
     if (constantShapeOpt.has_value())
     {
         auto activeBlockShape = *constantShapeOpt;
@@ -2550,11 +3818,7 @@ LogicalResult ActiveBlockCacheReduceOpRewrite::matchAndRewrite(ActiveBlockCacheR
                 lowerBoundOffsetIVs.push_back(lbOffsetIV);
             }
 
-            mlir::Value loadedCacheValue = CreateLoad(currentBuilder, loc, cache, lowerBoundOffsetIVs);
-            auto scaledCacheValue = currentBuilder.create<v::BinOp>(loc, BinaryOpPredicate::MUL, scaleValue, loadedCacheValue);
-            mlir::Value currentArrayValue = CreateLoad(currentBuilder, loc, array, lowerBoundOffsetIVs);
-            auto accumulatedValue = currentBuilder.create<v::BinOp>(loc, BinaryOpPredicate::ADD, currentArrayValue, scaledCacheValue);
-            CreateStore(currentBuilder, loc, accumulatedValue, array, lowerBoundOffsetIVs);
+            reduceElement(currentBuilder, lowerBoundOffsetIVs);
         });
 
         // Bounds check cache copy loads/stores so we don't introduce
@@ -2564,24 +3828,35 @@ LogicalResult ActiveBlockCacheReduceOpRewrite::matchAndRewrite(ActiveBlockCacheR
         {
             reduceScheduleOp.addLoopAttribute(loopIndex, rewriter.getIdentifier(AccessBoundsCheckAttrName), rewriter.getUnitAttr());
         }
+
+        SetCooperativeCopyParallelization(reduceScheduleOp, GetCooperativeCopyParallelization(cacheReduceOp, cache));
+
+        if (!atomicReduce && !deterministicPartials && UsesNonTemporalWriteBack(cacheReduceOp, cache))
+        {
+            for (const auto& loopIndex : copyOrder)
+            {
+                reduceScheduleOp.addLoopAttribute(loopIndex, rewriter.getIdentifier(NonTemporalStoresAttrName), rewriter.getUnitAttr());
+            }
+        }
     }
     else
     {
         std::vector<mlir::Value> IVs;
+        bool nonTemporalStores = !atomicReduce && !deterministicPartials && UsesNonTemporalWriteBack(cacheReduceOp, cache);
         for (unsigned arrayDim = 0; arrayDim < rank; ++arrayDim)
         {
             auto forOp = mlir::createCanonicalizedAffineForOp(currentBuilder, loc, lbOperands, lbMaps[arrayDim], ubOperands, ubMaps[arrayDim]);
             currentBuilder = mlir::OpBuilder::atBlockTerminator(forOp.getBody());
+            if (nonTemporalStores)
+            {
+                forOp->setAttr(NonTemporalStoresAttrName, rewriter.getUnitAttr());
+            }
 
             // Subscript for the slow memref being copied.
             IVs.push_back(forOp.getInductionVar());
         }
 
-        mlir::Value loadedCacheValue = CreateLoad(currentBuilder, loc, cache, IVs);
-        auto scaledCacheValue = currentBuilder.create<v::BinOp>(loc, BinaryOpPredicate::MUL, scaleValue, loadedCacheValue);
-        mlir::Value currentArrayValue = CreateLoad(currentBuilder, loc, array, IVs);
-        auto accumulatedValue = currentBuilder.create<v::BinOp>(loc, BinaryOpPredicate::ADD, currentArrayValue, scaledCacheValue);
-        CreateStore(currentBuilder, loc, accumulatedValue, array, IVs);
+        reduceElement(currentBuilder, IVs);
     }
     rewriter.eraseOp(cacheReduceOp);
 
@@ -2979,6 +4254,155 @@ bool ThriftyCacheAllSingleElementStridesHelper(mlir::PatternRewriter& rewriter,
     return allSingleElementStrides;
 }
 
+// The length in bytes from which the runs of contiguous elements of the outer array are long enough for the hardware
+// prefetchers, so that a thrifty cache that would only remove the gaps between the runs is elided
+constexpr int64_t ThriftyCacheMinContiguousRunBytes = 512;
+
+// Returns the element stride of the outer array and of the cache along each dimension of the full cache shape, or an
+// empty optional for a stride that isn't constant
+std::vector<std::pair<std::optional<int64_t>, std::optional<int64_t>>> ThriftyCacheDimensionStridesHelper(mlir::PatternRewriter& rewriter,
+                                                                                                        mlir::OpBuilder& currentBuilder, // Builder positioned inside of the temp multicache loops (if there are any)
+                                                                                                        mlir::Location loc,
+                                                                                                        mlir::Value outerArray,
+                                                                                                        mlir::Value cacheArray,
+                                                                                                        const std::vector<mlir::Value>& multiCacheIVs,
+                                                                                                        const std::vector<int64_t>& fullCacheShape,
+                                                                                                        const std::vector<int64_t>& fullCacheStepSizes,
+                                                                                                        const std::vector<mlir::Value>& activeBlockExternalSymbols,
+                                                                                                        mlir::ArrayAttr lbMapsArrayAttr)
+{
+    mlir::ValueRange lbOperands = activeBlockExternalSymbols;
+    auto lbMaps = util::ArrayAttrToVector<mlir::AffineMap, mlir::AffineMapAttr>(lbMapsArrayAttr, [](const mlir::AffineMapAttr& mapAttr) -> mlir::AffineMap {
+        return mapAttr.getValue();
+    });
+
+    // As in ThriftyCacheAllSingleElementStridesHelper, the accesses are computed with temporary ops that are erased in
+    // the reverse order they were created
+    std::stack<mlir::Operation*> temporaryOps;
+    mlir::AffineExpr sumExpr = currentBuilder.getAffineDimExpr(0) + currentBuilder.getAffineDimExpr(1);
+    mlir::AffineMap sumMap = mlir::AffineMap::get(2, 0, sumExpr);
+
+    // Returns the positions in the outer array and in the cache of the element at the given cache IVs
+    auto getAccesses = [&](const std::vector<int64_t>& currentIVs) {
+        std::vector<mlir::Value> lowerBoundOffsetIVs;
+        for (unsigned arrayDim = 0; arrayDim < lbMaps.size(); ++arrayDim)
+        {
+            mlir::Value lbMapApplied = currentBuilder.create<mlir::AffineApplyOp>(loc, lbMaps[arrayDim], lbOperands);
+            mlir::Value constantIV = currentBuilder.create<mlir::ConstantIndexOp>(loc, currentIVs[multiCacheIVs.size() + arrayDim]);
+            mlir::Value lbOffsetIV = currentBuilder.create<mlir::AffineApplyOp>(loc, sumMap, mlir::ValueRange{ lbMapApplied, constantIV });
+            lowerBoundOffsetIVs.push_back(lbOffsetIV);
+
+            temporaryOps.push(lbMapApplied.getDefiningOp());
+            temporaryOps.push(constantIV.getDefiningOp());
+            temporaryOps.push(lbOffsetIV.getDefiningOp());
+        }
+
+        std::vector<mlir::Value> accesses;
+        for (auto array : { outerArray, cacheArray })
+        {
+            mlir::AffineLoadOp accessOp = CreateLoad(currentBuilder, loc, array, lowerBoundOffsetIVs);
+            for (unsigned multiCacheDim = 0; multiCacheDim < multiCacheIVs.size(); ++multiCacheDim)
+            {
+                mlir::Value constantIV = currentBuilder.create<mlir::ConstantIndexOp>(loc, currentIVs[multiCacheDim]);
+                accessOp->replaceUsesOfWith(multiCacheIVs[multiCacheDim], constantIV);
+                temporaryOps.push(constantIV.getDefiningOp());
+            }
+            temporaryOps.push(accessOp);
+
+            std::vector<mlir::Value> indices(accessOp.indices().begin(), accessOp.indices().end());
+            auto accessMap = util::GetIndexToMemoryLocationMap(currentBuilder.getContext(), accessOp);
+            auto access = util::MultiDimAffineApply(currentBuilder, loc, accessMap, indices);
+            assert(access.size() == 1);
+            temporaryOps.push(access[0].getDefiningOp());
+            accesses.push_back(access[0]);
+        }
+        return std::make_pair(accesses[0], accesses[1]);
+    };
+
+    auto getStride = [&](mlir::Value originAccess, mlir::Value currentAccess) -> std::optional<int64_t> {
+        mlir::AffineExpr diffExpr = currentBuilder.getAffineDimExpr(1) - currentBuilder.getAffineDimExpr(0);
+        auto diffMap = mlir::AffineMap::get(2, 0, diffExpr);
+        mlir::SmallVector<mlir::Value, 4> operands{ originAccess, currentAccess };
+        mlir::fullyComposeAffineMapAndOperands(&diffMap, &operands);
+        assert(diffMap.getNumResults() == 1);
+        if (auto constantExpr = diffMap.getResult(0).dyn_cast<mlir::AffineConstantExpr>())
+        {
+            return constantExpr.getValue();
+        }
+        return std::nullopt;
+    };
+
+    std::vector<int64_t> currentIVs(fullCacheShape.size(), 0);
+    auto [outerArrayOrigin, cacheArrayOrigin] = getAccesses(currentIVs);
+
+    std::vector<std::pair<std::optional<int64_t>, std::optional<int64_t>>> strides;
+    for (unsigned dim = 0; dim < fullCacheShape.size(); ++dim)
+    {
+        currentIVs[dim] = fullCacheStepSizes[dim];
+        auto [outerArrayAccess, cacheArrayAccess] = getAccesses(currentIVs);
+        strides.emplace_back(getStride(outerArrayOrigin, outerArrayAccess), getStride(cacheArrayOrigin, cacheArrayAccess));
+        currentIVs[dim] = 0;
+    }
+
+    while (!temporaryOps.empty())
+    {
+        auto eraseOp = temporaryOps.top();
+        assert(eraseOp->use_empty());
+        rewriter.eraseOp(eraseOp);
+        temporaryOps.pop();
+    }
+
+    return strides;
+}
+
+// Whether a thrifty cache would only remove the gaps between long runs of contiguous elements of the outer array, such
+// as the rows of a block of a wide matrix. Walking the dimensions from the innermost, the dimensions that are
+// contiguous in the outer array make up the runs, and each dimension past them must keep its order in the cache and
+// step past everything that the inner dimensions cover, so that copying the block doesn't reorganize its elements.
+bool ThriftyCacheOnlyCompactsHelper(const std::vector<int64_t>& fullCacheShape,
+                                    const std::vector<int64_t>& fullCacheStepSizes,
+                                    const std::vector<std::pair<std::optional<int64_t>, std::optional<int64_t>>>& strides,
+                                    mlir::Value outerArray)
+{
+    int64_t runLength = 1;
+    int64_t outerArraySpan = 1;
+    int64_t cacheSpan = 1;
+    bool contiguous = true;
+    for (int dim = static_cast<int>(fullCacheShape.size()) - 1; dim >= 0; --dim)
+    {
+        auto count = (fullCacheShape[dim] + fullCacheStepSizes[dim] - 1) / fullCacheStepSizes[dim];
+        if (count <= 1)
+        {
+            continue;
+        }
+
+        auto [outerArrayStride, cacheStride] = strides[dim];
+        if (!outerArrayStride || !cacheStride || *cacheStride != cacheSpan)
+        {
+            // The stride isn't known, or the cache reorders the dimensions
+            return false;
+        }
+        if (contiguous && *outerArrayStride == outerArraySpan)
+        {
+            runLength *= count;
+        }
+        else if (*outerArrayStride >= outerArraySpan)
+        {
+            contiguous = false;
+        }
+        else
+        {
+            // The elements of this dimension interleave with those of the inner dimensions, or are duplicated
+            return false;
+        }
+        outerArraySpan += (count - 1) * *outerArrayStride;
+        cacheSpan *= count;
+    }
+
+    auto elementBytes = static_cast<int64_t>(outerArray.getType().cast<mlir::MemRefType>().getElementTypeBitWidth() / 8);
+    return runLength * elementBytes >= ThriftyCacheMinContiguousRunBytes;
+}
+
 std::pair<mlir::Block::iterator, mlir::Block::iterator> GetCacheRegionIterators(MultiCacheCopyOp copyOp)
 {
     auto pairOp = GetCacheOpPair(copyOp);
@@ -3256,11 +4680,26 @@ LogicalResult ThriftyCacheMultiCopyOpRewrite::matchAndRewrite(MultiCacheCopyOp m
                                                                                      info.activeBlockExternalSymbols,
                                                                                      lbMapsArrayAttr,
                                                                                      ubMapsArrayAttr);
-
-            if (allSingleElementStrides)
+            bool onlyCompacts = !allSingleElementStrides &&
+                                ThriftyCacheOnlyCompactsHelper(fullCacheShape,
+                                                               fullCacheStepSizes,
+                                                               ThriftyCacheDimensionStridesHelper(rewriter,
+                                                                                                  currentBuilder,
+                                                                                                  loc,
+                                                                                                  outerArray,
+                                                                                                  cacheArray,
+                                                                                                  info.multiCacheIVs,
+                                                                                                  fullCacheShape,
+                                                                                                  fullCacheStepSizes,
+                                                                                                  info.activeBlockExternalSymbols,
+                                                                                                  lbMapsArrayAttr),
+                                                               outerArray);
+
+            if (allSingleElementStrides || onlyCompacts)
             {
                 // If the accesses into the arrays all had strides of 1, then the cache is a strict subbuffer of the outer array.
-                // Since it is a thrifty cache we should therefore elide this cache.
+                // If the cache would only remove the gaps between long contiguous runs of the outer array, then the copy isn't
+                // worth its cost. Since it is a thrifty cache we should therefore elide this cache.
                 EraseThriftyCache(rewriter, multiCacheCopyOp, outerArray, cacheArray);
             }
         }
@@ -3340,11 +4779,26 @@ LogicalResult ThriftyCacheCopyOpRewrite::matchAndRewrite(ActiveBlockCacheCopyOp
                                                                              lbOperandsVec,
                                                                              lbMapsArrayAttr,
                                                                              ubMapsArrayAttr);
-
-    if (allSingleElementStrides)
+    bool onlyCompacts = !allSingleElementStrides &&
+                        ThriftyCacheOnlyCompactsHelper(activeBlockShape,
+                                                       activeBlockStepSizes,
+                                                       ThriftyCacheDimensionStridesHelper(rewriter,
+                                                                                          rewriter,
+                                                                                          loc,
+                                                                                          outerArray,
+                                                                                          cacheArray,
+                                                                                          std::vector<mlir::Value>{},
+                                                                                          activeBlockShape,
+                                                                                          activeBlockStepSizes,
+                                                                                          lbOperandsVec,
+                                                                                          lbMapsArrayAttr),
+                                                       outerArray);
+
+    if (allSingleElementStrides || onlyCompacts)
     {
         // If the accesses into the arrays all had strides of 1, then the cache is a strict subbuffer of the outer array.
-        // Since it is a thrifty cache we should therefore elide this cache.
+        // If the cache would only remove the gaps between long contiguous runs of the outer array, then the copy isn't
+        // worth its cost. Since it is a thrifty cache we should therefore elide this cache.
         EraseThriftyCache(rewriter, cacheCopyOp, outerArray, cacheArray);
     }
 
@@ -3413,11 +4867,26 @@ LogicalResult ThriftyCacheReduceOpRewrite::matchAndRewrite(ActiveBlockCacheReduc
                                                                              lbOperandsVec,
                                                                              lbMapsArrayAttr,
                                                                              ubMapsArrayAttr);
-
-    if (allSingleElementStrides)
+    bool onlyCompacts = !allSingleElementStrides &&
+                        ThriftyCacheOnlyCompactsHelper(activeBlockShape,
+                                                       activeBlockStepSizes,
+                                                       ThriftyCacheDimensionStridesHelper(rewriter,
+                                                                                          rewriter,
+                                                                                          loc,
+                                                                                          outerArray,
+                                                                                          cacheArray,
+                                                                                          std::vector<mlir::Value>{},
+                                                                                          activeBlockShape,
+                                                                                          activeBlockStepSizes,
+                                                                                          lbOperandsVec,
+                                                                                          lbMapsArrayAttr),
+                                                       outerArray);
+
+    if (allSingleElementStrides || onlyCompacts)
     {
         // If the accesses into the arrays all had strides of 1, then the cache is a strict subbuffer of the outer array.
-        // Since it is a thrifty cache we should therefore elide this cache.
+        // If the cache would only remove the gaps between long contiguous runs of the outer array, then the copy isn't
+        // worth its cost. Since it is a thrifty cache we should therefore elide this cache.
         EraseThriftyCache(rewriter, cacheReduceOp, outerArray, cacheArray);
     }
 
@@ -3801,7 +5270,7 @@ LogicalResult BeginCacheMappingOpRewrite::matchAndRewrite(BeginCacheMappingOp be
                 {
                     auto baseArrayPosition = GetBaseArrayPosition(rewriter, loc, loadOp);
                     mlir::AffineLoadOp newLoadOp = CreateLoad(rewriter, loc, toValue, baseArrayPosition);
-                    loadOp.replaceAllUsesWith(newLoadOp.getResult());
+                    loadOp.replaceAllUsesWith(ConvertElementType(rewriter, loc, newLoadOp.getResult(), loadOp.getType()));
                     TransferOrSetAccessAttrs(loadOp, newLoadOp);
                     rewriter.eraseOp(loadOp);
                 }
@@ -3834,7 +5303,7 @@ LogicalResult BeginCacheMappingOpRewrite::matchAndRewrite(BeginCacheMappingOp be
                 {
                     std::vector<mlir::Value> baseArrayPosition(loadAdaptor.indices().begin(), loadAdaptor.indices().end());
                     mlir::AffineLoadOp newLoadOp = CreateLoad(rewriter, loc, toValue, baseArrayPosition);
-                    loadOp.replaceAllUsesWith(newLoadOp.getResult());
+                    loadOp.replaceAllUsesWith(ConvertElementType(rewriter, loc, newLoadOp.getResult(), loadOp.getType()));
                     rewriter.eraseOp(loadOp);
                 }
                 else
@@ -3865,7 +5334,7 @@ LogicalResult BeginCacheMappingOpRewrite::matchAndRewrite(BeginCacheMappingOp be
                 {
                     std::vector<mlir::Value> baseArrayPosition(loadAdaptor.indices().begin(), loadAdaptor.indices().end());
                     mlir::AffineLoadOp newLoadOp = CreateLoad(rewriter, loc, toValue, baseArrayPosition);
-                    loadOp.replaceAllUsesWith(newLoadOp.getResult());
+                    loadOp.replaceAllUsesWith(ConvertElementType(rewriter, loc, newLoadOp.getResult(), loadOp.getType()));
                     rewriter.eraseOp(loadOp);
                 }
                 else
@@ -4045,6 +5514,15 @@ LogicalResult BeginCacheMappingOpRewrite::matchAndRewrite(BeginCacheMappingOp be
         fromValueReplacementOps.erase(replacementOpsIter);
     }
 
+    if (auto makeCacheOp = toValue.getDefiningOp<MakeCacheOp>(); isActiveBlockCache && makeCacheOp && makeCacheOp->hasAttr(CacheElementTypeAttrName))
+    {
+        auto arrayElementType = GetInnerElementType(fromValue);
+        if (AccumulatesInCacheElementType(GetInnerElementType(toValue), arrayElementType))
+        {
+            AccumulateInCacheElementType(rewriter, toValue, arrayElementType);
+        }
+    }
+
     rewriter.eraseOp(endOp);
     rewriter.eraseOp(beginCacheMappingOp);
     return success();
@@ -4399,12 +5877,20 @@ MakeCacheOp CreateDoubleBufferTempArray(mlir::OpBuilder& builder,
     mlir::OpBuilder::InsertionGuard insertGuard(builder);
     builder.setInsertionPointToStart(&parentLambda.body().front());
     auto memorySpaceEnum = util::AttributeToMemorySpace(tempArrayMemSpaceAttr);
-    return builder.create<MakeCacheOp>(parentLambda.getLoc(),
-                                       tempArrayType,
-                                       memorySpaceEnum,
-                                       tempArrayAccessMap,
-                                       tempArrayOffsetIndices,
-                                       tempArrayMultiCacheAccessIndices);
+    auto tempArray = builder.create<MakeCacheOp>(parentLambda.getLoc(),
+                                                 tempArrayType,
+                                                 memorySpaceEnum,
+                                                 tempArrayAccessMap,
+                                                 tempArrayOffsetIndices,
+                                                 tempArrayMultiCacheAccessIndices);
+    for (auto attrName : { ThreadLocalCacheAttrName, CooperativeCacheCopyAttrName, PrefetchDistanceAttrName, NonTemporalWriteBackCacheAttrName })
+    {
+        if (auto attr = info.multiCache->getAttr(attrName))
+        {
+            tempArray->setAttr(attrName, attr);
+        }
+    }
+    return tempArray;
 }
 
 void CreateCacheMappingRegionHelper(mlir::PatternRewriter& rewriter,
@@ -4524,7 +6010,7 @@ LogicalResult BeginCacheRegionOpRewrite::matchAndRewrite(BeginCacheRegionOp begi
         mlir::Block::iterator cacheLevelEndOp(cacheLevelLoop);
         cacheLevelEndOp++;
 
-        auto arrayAccessInfo = ComputeAccessInfoForArrayAtLevel(rewriter, baseInput, cacheLevelStartOp, cacheLevelEndOp, beginCacheRegionOp.activeBlockCache());
+        auto arrayAccessInfo = ComputeAccessInfoForArrayAtLevel(regionCache, baseInput, cacheLevelStartOp, cacheLevelEndOp, beginCacheRegionOp.activeBlockCache());
         if (!arrayAccessInfo.cacheUsedInRegion)
         {
             // The cache isn't used inside this cacheLevelLoop, so don't bother computing anything else
@@ -4721,7 +6207,7 @@ LogicalResult BeginCacheRegionOpRewrite::matchAndRewrite(BeginCacheRegionOp begi
                                                                  currentMultiCacheInfo.activeBlockInfo,
                                                                  currentMultiCacheInfo.multiCacheIterationCounts);
 
-            currentMultiCacheInfo.activeBlockToCacheMap = CreateActiveBlockToCacheMap(rewriter, tempActiveBlockRegionInfo.cacheAccessContext);
+            currentMultiCacheInfo.activeBlockToCacheMap = CreateActiveBlockToCacheMap(rewriter, makeCacheOp, tempActiveBlockRegionInfo.cacheAccessContext);
 
             size_t activeBlockRank = currentMultiCacheInfo.activeBlockInfo.shape.size();
             std::vector<mlir::Value> multiCacheIVs;
@@ -4763,13 +6249,35 @@ LogicalResult BeginCacheRegionOpRewrite::matchAndRewrite(BeginCacheRegionOp begi
             // Get the next loop outside of the trigger level loop
             // We can only double-buffer if there is a loop outside of the trigger level loop
             auto triggerLoopParentLoop = util::CastOrGetParentOfType<mlir::AffineForOp>(triggerLevelBlock->getParentOp());
-            if (beginCacheRegionOp.doubleBufferCache() && triggerLoopParentLoop != nullptr)
+            bool doubleBufferCache = beginCacheRegionOp.doubleBufferCache() && triggerLoopParentLoop != nullptr;
+
+            // A CPU thread would fill the temp buffer before computing on the current active block, so nothing would
+            // overlap. Instead, each cache fill prefetches the next active block, which then arrives during the compute
+            std::optional<v::ExecutionTarget> execTargetOpt = util::ResolveExecutionTarget(beginCacheRegionOp);
+            if (doubleBufferCache && execTargetOpt == v::ExecutionTarget::CPU)
+            {
+                auto makeCacheOp = multiCacheInfo.multiCache.getDefiningOp<MakeCacheOp>();
+                if (makeCacheOp && !makeCacheOp->hasAttr(PrefetchDistanceAttrName))
+                {
+                    makeCacheOp->setAttr(PrefetchDistanceAttrName, rewriter.getI64IntegerAttr(1));
+                }
+                doubleBufferCache = false;
+            }
+
+            if (doubleBufferCache)
             {
                 [[maybe_unused]] bool inputOnlyCache = !multiCacheInfo.arrayAccessInfo.valueWritten;
                 assert(inputOnlyCache && "Double buffering is only supported for read-only caches");
 
                 auto doubleBufferTempArray = CreateDoubleBufferTempArray(rewriter, multiCacheInfo, beginCacheRegionOp);
 
+                // A temp array in shared memory is filled with asynchronous copies, so the next iteration's data is in flight
+                // during the compute on the current active block instead of being staged in registers
+                if (CanUseAsyncCopy(beginCacheRegionOp, doubleBufferTempArray))
+                {
+                    doubleBufferTempArray->setAttr(AsyncCopyCacheAttrName, rewriter.getUnitAttr());
+                }
+
                 // Create the 0'th iteration copy just before the triggerLoopParentLoop
                 auto parentLoopBlock = triggerLoopParentLoop->getBlock();
 
@@ -4988,6 +6496,35 @@ LogicalResult BeginCacheRegionOpRewrite::matchAndRewrite(BeginCacheRegionOp begi
     return success();
 }
 
+// Records where a register cache was placed, in the report attr of its function
+void AddRegisterCacheReportEntry(PatternRewriter& rewriter, mlir::Operation* regionOp, int64_t budget, int64_t elements, StringRef placement)
+{
+    auto valueFuncOp = regionOp->getParentOfType<ValueFuncOp>();
+    if (!valueFuncOp)
+    {
+        return;
+    }
+
+    llvm::SmallVector<mlir::NamedAttribute, 4> fields{
+        rewriter.getNamedAttr("id", rewriter.getI64IntegerAttr(mlir::cast<BeginCacheRegion>(regionOp).getId())),
+        rewriter.getNamedAttr("budget", rewriter.getI64IntegerAttr(budget)),
+        rewriter.getNamedAttr("elements", rewriter.getI64IntegerAttr(elements)),
+        rewriter.getNamedAttr("placement", rewriter.getStringAttr(placement))
+    };
+    if (auto indexAttr = regionOp->getAttrOfType<IndexAttr>("cacheIndex"))
+    {
+        fields.push_back(rewriter.getNamedAttr("index", rewriter.getStringAttr(indexAttr.getValue().GetName())));
+    }
+
+    llvm::SmallVector<mlir::Attribute, 4> entries;
+    if (auto report = valueFuncOp->getAttrOfType<ArrayAttr>(RegisterCacheReportAttrName))
+    {
+        entries.append(report.begin(), report.end());
+    }
+    entries.push_back(rewriter.getDictionaryAttr(fields));
+    valueFuncOp->setAttr(RegisterCacheReportAttrName, rewriter.getArrayAttr(entries));
+}
+
 LogicalResult MaxElementCacheRegionOpRewrite::matchAndRewrite(BeginMaxElementCacheRegionOp beginMaxElementCacheRegionOp, PatternRewriter& rewriter) const
 {
     // Compute where this cache region should be, based on the max element budget, then create a BeginCacheRegionOp at that level and a corresponding EndCacheRegionOp
@@ -5013,7 +6550,7 @@ LogicalResult MaxElementCacheRegionOpRewrite::matchAndRewrite(BeginMaxElementCac
     mlir::Block::iterator newBeginPoint(beginMaxElementCacheRegionOp);
     mlir::Block::iterator newEndPoint(endOp);
 
-    ArrayAccessInfo arrayAccessInfo = ComputeAccessInfoForArrayAtLevel(rewriter,
+    ArrayAccessInfo arrayAccessInfo = ComputeAccessInfoForArrayAtLevel(regionCache,
                                                                        baseInput,
                                                                        mlir::Block::iterator(beginMaxElementCacheRegionOp),
                                                                        mlir::Block::iterator(endOp),
@@ -5030,6 +6567,43 @@ LogicalResult MaxElementCacheRegionOpRewrite::matchAndRewrite(BeginMaxElementCac
 
     mlir::AffineForOp cacheLevelLoop;
 
+    auto makeCacheOp = cache.getDefiningOp<MakeCacheOp>();
+    bool registerCache = makeCacheOp && makeCacheOp->hasAttr(RegisterCacheAttrName);
+    if (registerCache && initialActiveBlockVolume > maxElementBudget)
+    {
+        // Even the innermost active block would spill out of the registers, so the accesses read the source instead
+        AddRegisterCacheReportEntry(rewriter, beginMaxElementCacheRegionOp, maxElementBudget, initialActiveBlockVolume, "source");
+        rewriter.eraseOp(endOp);
+        rewriter.eraseOp(beginMaxElementCacheRegionOp);
+        return success();
+    }
+
+    // A register cache holds the data of a single thread, and is only valid while its source cache is. A shared memory
+    // cache holds the data of a block.
+    bool sharedCache = makeCacheOp && makeCacheOp.memorySpace() == v::MemorySpace::Shared;
+    auto isCacheBoundary = [&](mlir::AffineForOp loop) {
+        if (sharedCache)
+        {
+            auto gpuMapAttr = loop->getAttrOfType<mlir::StringAttr>("accv_gpu_map");
+            auto processor = gpuMapAttr ? v::symbolizeProcessor(gpuMapAttr.getValue()) : llvm::None;
+            return processor && (*processor == v::Processor::BlockX || *processor == v::Processor::BlockY ||
+                                 *processor == v::Processor::BlockZ || *processor == v::Processor::Device);
+        }
+        if (!registerCache)
+        {
+            return false;
+        }
+        if (loop->hasAttr("accv_gpu_map"))
+        {
+            return true;
+        }
+        auto sourceRegion = loop.walk([&](BeginCacheRegionOp regionOp) {
+            return regionOp.cache() == input ? WalkResult::interrupt() : WalkResult::advance();
+        });
+        return sourceRegion.wasInterrupted();
+    };
+
+    int64_t cacheVolume = initialActiveBlockVolume;
     if (initialActiveBlockVolume > maxElementBudget)
     {
         // If the max element budget is so small that even the innermost loop is too much, then create a dummy loop inside of it
@@ -5090,13 +6664,18 @@ LogicalResult MaxElementCacheRegionOpRewrite::matchAndRewrite(BeginMaxElementCac
             newEndPoint = nextEnd;
 
             cacheLevelLoop = parentOp;
+            cacheVolume = nextActiveBlockVolume;
 
             parentOp = parentOp->getParentOfType<mlir::AffineForOp>();
+            if (parentOp && isCacheBoundary(parentOp))
+            {
+                break;
+            }
             if (parentOp)
             {
                 nextStart = mlir::Block::iterator(parentOp);
                 nextEnd = ++mlir::Block::iterator(parentOp);
-                ArrayAccessInfo nextArrayAccessInfo = ComputeAccessInfoForArrayAtLevel(rewriter, baseInput, nextStart, nextEnd, true /* computeActiveBlock */);
+                ArrayAccessInfo nextArrayAccessInfo = ComputeAccessInfoForArrayAtLevel(regionCache, baseInput, nextStart, nextEnd, true /* computeActiveBlock */);
                 nextActiveBlockVolume = GetActiveBlockVolume(nextArrayAccessInfo.activeBlock);
             }
         }
@@ -5138,6 +6717,11 @@ LogicalResult MaxElementCacheRegionOpRewrite::matchAndRewrite(BeginMaxElementCac
     // This new cache region op has already been hoisted as high as we want to hoist it
     newBeginOp->setAttr("hoisted", rewriter.getUnitAttr());
 
+    if (registerCache)
+    {
+        AddRegisterCacheReportEntry(rewriter, newBeginOp, maxElementBudget, cacheVolume, "registers");
+    }
+
     // Replace uses and erase the original BeginCacheRegionOp
     rewriter.replaceOp(beginMaxElementCacheRegionOp, newBeginOp.getResult());
 
@@ -5152,7 +6736,9 @@ void VectorizeAffineForOpConversion::vectorizeOpsInBlock(PatternRewriter& rewrit
                                                          VectorizedOpMap& vectorizedOps,
                                                          std::vector<BlockAndValueMapping>& laneMappings,
                                                          int64_t step,
-                                                         int64_t unrollMax) const
+                                                         int64_t unrollMax,
+                                                         int64_t vectorSize,
+                                                         VectorizedLoopSummary* summary) const
 {
     std::stack<Operation*> opsToErase;
     // Note: this loop needs to check std::next(endPrevSentinel) on every iteration since the vectorized ops are being inserted
@@ -5165,21 +6751,43 @@ void VectorizeAffineForOpConversion::vectorizeOpsInBlock(PatternRewriter& rewrit
         // If this op can be vectorized, do it
         // Clone the op and then delete it if we were successful in vectorizing it.
         // When cloning, use a BlockAndValueMapping to remap the induction variable
-        if (!vectorInfo.unrollOnly && CanVectorizeOp(sourceOp, vectorizedOps, laneMappings, unrollingIV, step, unrollMax))
+        if (!vectorInfo.unrollOnly && CanVectorizeOp(sourceOp, vectorizedOps, laneMappings, unrollingIV, step, vectorSize))
         {
-            auto result = VectorizeOp(rewriter, sourceOp, vectorizedOps, laneMappings, unrollingIV, step, unrollMax);
+            // Vectors wider than the number of iterations mask off the lanes past the end of the loop
+            auto result = vectorSize > unrollMax ? VectorizeOpMasked(rewriter, sourceOp, vectorizedOps, laneMappings, unrollingIV, step, vectorSize, unrollMax)
+                                                 : VectorizeOp(rewriter, sourceOp, vectorizedOps, laneMappings, unrollingIV, step, unrollMax);
             if (result.has_value())
             {
                 vectorizedOps.Map(sourceOp, *result);
                 didVectorizeOp(sourceOp, *result);
+                if (summary)
+                {
+                    summary->AddVectorizedOp();
+                }
+            }
+            else if (summary)
+            {
+                summary->AddScalarizedOp(sourceOp, "the operands or memory accesses of this op can't be vectorized");
             }
         }
+        else if (summary && !vectorInfo.unrollOnly)
+        {
+            summary->AddScalarizedOp(sourceOp, "this op has no vector form for these operands");
+        }
 
         emitVectorizationRemark(sourceOp, "Unrolling op if needed");
 
         // Unroll the contents of 'forOpToUnroll' by replacing its contents with vectorSize mapped copies of it.
-        for (int64_t unrollIdx = 0; unrollIdx < unrollMax; unrollIdx++)
+        // The masked-off lanes only get copies of the side-effect free ops, so that their lane mappings
+        // can be used to check the memory accesses of the masked lanes
+        bool hasNoEffect = sourceOp->getNumRegions() == 0 && mlir::isa<mlir::MemoryEffectOpInterface>(sourceOp) && mlir::MemoryEffectOpInterface::hasNoEffect(sourceOp);
+        for (int64_t unrollIdx = 0; unrollIdx < vectorSize; unrollIdx++)
         {
+            if (unrollIdx >= unrollMax && !hasNoEffect)
+            {
+                break;
+            }
+
             auto& operandMap = laneMappings[unrollIdx];
             if (unrollIdx == 0)
             {
@@ -5214,6 +6822,47 @@ void VectorizeAffineForOpConversion::vectorizeOpsInBlock(PatternRewriter& rewrit
     }
 }
 
+// Returns the number of lanes of the vectors that a masked vectorized loop is widened to, which is the loop's unrollMax
+// if the loop isn't masked or its iterations already fill whole vectors
+int64_t GetMaskedVectorSize(AffineForOp affineForOp, const VectorizationInfo& vectorInfo, int64_t unrollMax)
+{
+    if (!vectorInfo.masked || vectorInfo.unrollOnly || vectorInfo.vectorBytes <= 0)
+    {
+        return unrollMax;
+    }
+
+    // Size the vectors for the widest element type accessed in the loop body
+    unsigned elementBits = 0;
+    for (auto& op : affineForOp.getBody()->without_terminator())
+    {
+        MemRefType memRefType;
+        if (auto loadOp = dyn_cast<AffineLoadOp>(op))
+            memRefType = loadOp.getMemRefType();
+        else if (auto storeOp = dyn_cast<AffineStoreOp>(op))
+            memRefType = storeOp.getMemRefType();
+        else if (auto loadOp = dyn_cast<memref::LoadOp>(op))
+            memRefType = loadOp.getMemRefType();
+        else if (auto storeOp = dyn_cast<memref::StoreOp>(op))
+            memRefType = storeOp.getMemRefType();
+
+        if (memRefType && memRefType.getElementType().isIntOrFloat() && memRefType.getElementTypeBitWidth() >= 8)
+        {
+            elementBits = std::max(elementBits, memRefType.getElementTypeBitWidth());
+        }
+    }
+    if (elementBits == 0)
+    {
+        return unrollMax;
+    }
+
+    int64_t vectorWidth = vectorInfo.vectorBytes * 8 / elementBits;
+    if (vectorWidth <= 1 || unrollMax % vectorWidth == 0)
+    {
+        return unrollMax;
+    }
+    return CeilDiv(unrollMax, vectorWidth) * vectorWidth;
+}
+
 LogicalResult VectorizeAffineForOpConversion::matchAndRewrite(AffineForOp affineForOp, PatternRewriter& rewriter) const
 {
     if (!HasVectorizationInfo(affineForOp))
@@ -5249,6 +6898,15 @@ LogicalResult VectorizeAffineForOpConversion::matchAndRewrite(AffineForOp affine
 
     rewriter.startRootUpdate(affineForOp);
 
+    // The loop may be promoted away below, so grab what the vectorization report needs first
+    auto loopLoc = affineForOp.getLoc();
+    std::string loopName;
+    if (auto indexAttr = affineForOp->getAttrOfType<IndexAttr>("index"))
+    {
+        loopName = indexAttr.getValue().GetName();
+    }
+    auto valueFuncOp = affineForOp->getParentOfType<ValueFuncOp>();
+
     assert(affineForOp.hasConstantLowerBound() && "Vectorized loops must have a constant lower bound");
     assert(affineForOp.hasConstantUpperBound() && "Vectorized loops must have a constant upper bound");
 
@@ -5276,15 +6934,18 @@ LogicalResult VectorizeAffineForOpConversion::matchAndRewrite(AffineForOp affine
     // so that we know what to clone (since we are doing this in-place).
     Block::iterator srcBlockEnd = std::prev(affineForOp.getBody()->end(), 2);
 
+    // Remainder loops that don't fill a whole vector are widened to full vectors with masked-off lanes if requested
+    auto vectorSize = GetMaskedVectorSize(affineForOp, vectorInfo, unrollMax);
+
     VectorizedOpMap vectorizedOps;
-    std::vector<BlockAndValueMapping> laneMappings(unrollMax);
+    std::vector<BlockAndValueMapping> laneMappings(vectorSize);
 
     if (!affineForOpIV.use_empty())
     {
         // Initialize the mappings with an offset version of the induction variable
         auto loc = affineForOp.getLoc();
         auto inductionVarMap = AffineMap::get(1, 1, rewriter.getAffineDimExpr(0) + step * rewriter.getAffineSymbolExpr(0));
-        for (int64_t i = 0; i < unrollMax; ++i)
+        for (int64_t i = 0; i < vectorSize; ++i)
         {
             auto offset = rewriter.create<mlir::ConstantIndexOp>(loc, i);
             auto offsetInductionVar = rewriter.create<AffineApplyOp>(loc, inductionVarMap, ValueRange{ affineForOpIV, offset });
@@ -5294,7 +6955,31 @@ LogicalResult VectorizeAffineForOpConversion::matchAndRewrite(AffineForOp affine
         }
     }
 
-    vectorizeOpsInBlock(rewriter, affineForOp.getBody()->begin(), srcBlockEnd, affineForOpIV, vectorInfo, vectorizedOps, laneMappings, step, unrollMax);
+    // Accumulations of 8-bit integer or bfloat16 products use the dot-product instructions of the target, if it has any
+    bool vectorizedDotProduct = !vectorInfo.unrollOnly && vectorSize == unrollMax &&
+                                (VectorizeIntegerDotProduct(rewriter, affineForOp, vectorInfo, laneMappings, step, vectorSize) ||
+                                 VectorizeBFloat16DotProduct(rewriter, affineForOp, vectorInfo, laneMappings, step, vectorSize));
+    VectorizedLoopSummary summary;
+    if (!vectorizedDotProduct)
+    {
+        vectorizeOpsInBlock(rewriter, affineForOp.getBody()->begin(), srcBlockEnd, affineForOpIV, vectorInfo, vectorizedOps, laneMappings, step, unrollMax, vectorSize, &summary);
+
+        // Vector table lookups select their entries with the lookup instructions of the target, if it has any
+        if (vectorInfo.tableLookup != TableLookupKind::None)
+        {
+            affineForOp.getBody()->walk([&](v::TableLookupOp tableLookupOp) {
+                if (tableLookupOp.index().getType().isa<VectorType>())
+                {
+                    tableLookupOp->setAttr("kind", rewriter.getI64IntegerAttr(static_cast<int64_t>(vectorInfo.tableLookup)));
+                }
+            });
+        }
+    }
+
+    if (reportVectorization && valueFuncOp)
+    {
+        addVectorizationReportEntry(rewriter, valueFuncOp, loopLoc, loopName, constantTripCount, vectorSize, vectorInfo, vectorizedDotProduct, summary);
+    }
 
     if (!erasedBaseLoop)
     {
@@ -5306,6 +6991,63 @@ LogicalResult VectorizeAffineForOpConversion::matchAndRewrite(AffineForOp affine
     return success();
 }
 
+void VectorizeAffineForOpConversion::addVectorizationReportEntry(PatternRewriter& rewriter,
+                                                                 ValueFuncOp valueFuncOp,
+                                                                 mlir::Location loopLoc,
+                                                                 llvm::StringRef loopName,
+                                                                 uint64_t tripCount,
+                                                                 int64_t vectorSize,
+                                                                 const VectorizationInfo& vectorInfo,
+                                                                 bool vectorizedDotProduct,
+                                                                 const VectorizedLoopSummary& summary) const
+{
+    auto locationString = [](mlir::Location loc) {
+        std::string result;
+        llvm::raw_string_ostream os(result);
+        loc.print(os);
+        return os.str();
+    };
+
+    std::string outcome;
+    if (vectorizedDotProduct)
+        outcome = "dot_product";
+    else if (vectorInfo.unrollOnly || summary.vectorizedOps == 0)
+        outcome = "unrolled";
+    else if (summary.scalarizedOps > 0)
+        outcome = "partially_vectorized";
+    else
+        outcome = "vectorized";
+
+    llvm::SmallVector<mlir::NamedAttribute, 12> fields{
+        rewriter.getNamedAttr("loop", rewriter.getStringAttr(loopName)),
+        rewriter.getNamedAttr("location", rewriter.getStringAttr(locationString(loopLoc))),
+        rewriter.getNamedAttr("trip_count", rewriter.getI64IntegerAttr(static_cast<int64_t>(tripCount))),
+        rewriter.getNamedAttr("vector_size", rewriter.getI64IntegerAttr(vectorSize)),
+        rewriter.getNamedAttr("vector_bytes", rewriter.getI64IntegerAttr(vectorInfo.vectorBytes)),
+        rewriter.getNamedAttr("outcome", rewriter.getStringAttr(outcome)),
+        rewriter.getNamedAttr("vectorized_ops", rewriter.getI64IntegerAttr(summary.vectorizedOps)),
+        rewriter.getNamedAttr("scalarized_ops", rewriter.getI64IntegerAttr(summary.scalarizedOps)),
+    };
+    if (vectorInfo.unrollOnly)
+    {
+        fields.push_back(rewriter.getNamedAttr("reason", rewriter.getStringAttr("the loop was only marked for unrolling")));
+    }
+    else if (summary.blockingOpLocation)
+    {
+        fields.push_back(rewriter.getNamedAttr("blocking_op", rewriter.getStringAttr(summary.blockingOpName)));
+        fields.push_back(rewriter.getNamedAttr("blocking_op_location", rewriter.getStringAttr(locationString(*summary.blockingOpLocation))));
+        fields.push_back(rewriter.getNamedAttr("reason", rewriter.getStringAttr(summary.blockingReason)));
+    }
+
+    llvm::SmallVector<mlir::Attribute, 4> entries;
+    if (auto report = valueFuncOp->getAttrOfType<ArrayAttr>(VectorizationReportAttrName))
+    {
+        entries.append(report.begin(), report.end());
+    }
+    entries.push_back(rewriter.getDictionaryAttr(fields));
+    valueFuncOp->setAttr(VectorizationReportAttrName, rewriter.getArrayAttr(entries));
+}
+
 void VectorizeAffineForOpConversion::didVectorizeOp(mlir::Operation* sourceOp, VectorizedOp& vectorizedOp) const
 {
     if (printVectorizationDetails)
@@ -5548,34 +7290,361 @@ LogicalResult InPlaceUnrollAffineForOpConversion::matchAndRewrite(AffineForOp af
     return success();
 }
 
-LogicalResult TensorizeAffineForOpConversion::matchAndRewrite(AffineForOp affineForOp, PatternRewriter& rewriter) const
+// The coefficients of the induction variables in each result of an affine access, or std::nullopt if a result isn't
+// linear in them or uses other values that are defined inside `scopeOp`
+std::optional<std::vector<std::vector<int64_t>>> GetAccessCoefficients(AffineMap map, ValueRange mapOperands, ArrayRef<Value> inductionVars, Operation* scopeOp)
 {
-    if (!HasTensorizationInfo(affineForOp))
+    SmallVector<Value, 4> operands(mapOperands.begin(), mapOperands.end());
+    fullyComposeAffineMapAndOperands(&map, &operands);
+
+    for (auto operand : operands)
     {
-        // This isn't an AffineForOp marked for tensorization so just return without modifying it
-        return success();
+        if (!llvm::is_contained(inductionVars, operand) && scopeOp->isAncestor(operand.getParentRegion()->getParentOp()))
+        {
+            return std::nullopt;
+        }
     }
 
-    // currently only available for rocm target
-    if (util::ResolveExecutionRuntime(affineForOp) != ExecutionRuntime::ROCM)
+    std::vector<std::vector<int64_t>> coefficients;
+    for (auto expr : map.getResults())
     {
-        return failure();
-    }
+        SmallVector<int64_t, 8> flattened;
+        if (failed(getFlattenedAffineExpr(expr, map.getNumDims(), map.getNumSymbols(), &flattened)) || flattened.size() != operands.size() + 1)
+        {
+            return std::nullopt;
+        }
 
-    auto tensorizationInfo = GetTensorizationInfo(affineForOp);
+        std::vector<int64_t> resultCoefficients(inductionVars.size(), 0);
+        for (auto en : llvm::enumerate(operands))
+        {
+            auto inductionVarIter = llvm::find(inductionVars, en.value());
+            if (inductionVarIter != inductionVars.end())
+            {
+                resultCoefficients[inductionVarIter - inductionVars.begin()] += flattened[en.index()];
+            }
+        }
+        coefficients.push_back(resultCoefficients);
+    }
+    return coefficients;
+}
 
-    SmallVector<AffineForOp, 4> loops;
-    mlir::getPerfectlyNestedLoops(loops, affineForOp);
-    if (loops.size() != 3) // there should be 3 loops in the nest
+// Whether an array is laid out row-major with contiguous rows, which is how the AMX tile loads and stores compute
+// the stride between the rows of a tile
+bool HasContiguousRows(MemRefType memRefType)
+{
+    SmallVector<int64_t, 4> strides;
+    int64_t offset;
+    if (memRefType.getRank() < 2 || memRefType.isDynamicDim(memRefType.getRank() - 1) || failed(getStridesAndOffset(memRefType, strides, offset)))
     {
-        return failure();
+        return false;
     }
-    for (auto& en : llvm::enumerate(loops))
-    {
-        auto loop = en.value();
-        if (!HasTensorizationInfo(loop))
+    return strides.back() == 1 && strides[strides.size() - 2] == memRefType.getShape().back();
+}
+
+// Whether an op in a loop may write to an array, which is the case for the ops whose effects are unknown
+bool MayWriteTo(AffineForOp affineForOp, Value memref)
+{
+    auto result = affineForOp.walk([&](Operation* op) {
+        if (op->getNumRegions() != 0)
         {
-            return failure();
+            return WalkResult::advance();
+        }
+        auto effectsOp = dyn_cast<MemoryEffectOpInterface>(op);
+        if (!effectsOp)
+        {
+            return WalkResult::interrupt();
+        }
+        SmallVector<MemoryEffects::EffectInstance, 4> effects;
+        effectsOp.getEffects(effects);
+        auto writesToMemref = llvm::any_of(effects, [&](const MemoryEffects::EffectInstance& effect) {
+            return isa<MemoryEffects::Write>(effect.getEffect()) && (!effect.getValue() || effect.getValue() == memref);
+        });
+        return writesToMemref ? WalkResult::interrupt() : WalkResult::advance();
+    });
+    return result.wasInterrupted();
+}
+
+// Requests the permission to use the AMX tile registers when a function is entered, since Linux faults on the first tile
+// instruction of a process that didn't
+void RequestAMXTileData(v::ValueFuncOp valueFuncOp, PatternRewriter& rewriter)
+{
+    auto& entryBlock = valueFuncOp.body().front();
+    auto isRequest = [](v::CallOp callOp) { return callOp.getCallee() == RequestAMXTileDataFnName; };
+    if (llvm::any_of(entryBlock.getOps<v::CallOp>(), isRequest))
+    {
+        return;
+    }
+
+    auto vModuleOp = valueFuncOp->getParentOfType<v::ValueModuleOp>();
+    auto loc = valueFuncOp.getLoc();
+    v::ValueFuncOp requestFuncOp;
+    {
+        // Lock before accessing the enclosing module since sibling functions are lowered in parallel
+        static std::mutex requestFuncInsertMutex;
+        std::lock_guard<std::mutex> lock(requestFuncInsertMutex);
+        requestFuncOp = dyn_cast_or_null<v::ValueFuncOp>(SymbolTable::lookupSymbolIn(vModuleOp, RequestAMXTileDataFnName));
+        if (!requestFuncOp)
+        {
+            OpBuilder::InsertionGuard guard(rewriter);
+            rewriter.setInsertionPoint(vModuleOp.getBody()->getTerminator());
+            requestFuncOp = rewriter.create<v::ValueFuncOp>(loc, RequestAMXTileDataFnName, rewriter.getFunctionType({}, { rewriter.getI32Type() }), v::ExecutionTarget::CPU, v::ValueFuncOp::ExternalFuncTag{});
+            requestFuncOp.setPrivate();
+        }
+    }
+
+    OpBuilder::InsertionGuard guard(rewriter);
+    rewriter.setInsertionPointToStart(&entryBlock);
+    rewriter.create<v::CallOp>(loc, requestFuncOp, ValueRange{});
+}
+
+// Rewrites a GEMM tile loop nest of a CPU target into AMX tile operations, which compute `C += A * B` on tiles of up to 16 rows
+// of 64 bytes each. A and C are loaded from and stored to their arrays directly, B is repacked into the layout that the
+// AMX instructions read it in, where each row holds `4 / sizeof(element)` consecutive rows of B interleaved.
+LogicalResult TensorizeForAMX(AffineForOp affineForOp, ArrayRef<AffineForOp> loops, PatternRewriter& rewriter)
+{
+    auto innerLoop = loops.back();
+    auto i32Type = rewriter.getI32Type();
+    auto f32Type = rewriter.getF32Type();
+    auto match = MatchDotProductAccumulation(innerLoop, i32Type, rewriter.getIntegerType(8));
+    auto isFloat = !match.has_value();
+    if (isFloat)
+    {
+        match = MatchDotProductAccumulation(innerLoop, f32Type, rewriter.getBF16Type());
+    }
+    if (!match)
+    {
+        return rewriter.notifyMatchFailure(affineForOp, "AMX tensorization requires C += A * B with 8-bit integer or bfloat16 A and B");
+    }
+
+    auto storeC = dyn_cast<AffineStoreOp>(match->storeOp);
+    auto loadA = dyn_cast<AffineLoadOp>(match->lhs.load);
+    auto loadB = dyn_cast<AffineLoadOp>(match->rhs.load);
+    auto isUnsignedA = match->lhs.isUnsigned;
+    auto isUnsignedB = match->rhs.isUnsigned;
+    if (!storeC || !loadA || !loadB)
+    {
+        return rewriter.notifyMatchFailure(affineForOp, "AMX tensorization requires affine loads and stores");
+    }
+
+    // The induction variables are in the order of the rows of C, the columns of C and the reduction
+    std::vector<Value> inductionVars;
+    for (auto loop : loops)
+    {
+        inductionVars.push_back(loop.getInductionVar());
+    }
+    auto getCoefficients = [&](AffineMap map, ValueRange operands) {
+        return GetAccessCoefficients(map, operands, inductionVars, affineForOp);
+    };
+    auto coefficientsC = getCoefficients(storeC.getAffineMap(), storeC.getMapOperands());
+    if (!coefficientsC || coefficientsC->size() < 2)
+    {
+        return rewriter.notifyMatchFailure(affineForOp, "Failed to match the access of C");
+    }
+    auto rowsC = (*coefficientsC)[coefficientsC->size() - 2];
+    auto colsC = (*coefficientsC)[coefficientsC->size() - 1];
+    if (rowsC[1] == 1 && colsC[0] == 1)
+    {
+        std::swap(inductionVars[0], inductionVars[1]);
+        coefficientsC = getCoefficients(storeC.getAffineMap(), storeC.getMapOperands());
+    }
+
+    // Each access must step through the last two dimensions of its array with a pair of the loops
+    auto isTileAccess = [&](const std::optional<std::vector<std::vector<int64_t>>>& coefficients, int rowLoop, int colLoop) {
+        if (!coefficients || coefficients->size() < 2)
+        {
+            return false;
+        }
+        for (size_t resultIndex = 0; resultIndex < coefficients->size(); ++resultIndex)
+        {
+            for (int loopIndex = 0; loopIndex < 3; ++loopIndex)
+            {
+                auto isRow = resultIndex == coefficients->size() - 2 && loopIndex == rowLoop;
+                auto isCol = resultIndex == coefficients->size() - 1 && loopIndex == colLoop;
+                if ((*coefficients)[resultIndex][loopIndex] != ((isRow || isCol) ? 1 : 0))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+    auto coefficientsA = getCoefficients(loadA.getAffineMap(), loadA.getMapOperands());
+    if (!isTileAccess(coefficientsA, 0, 2))
+    {
+        std::swap(loadA, loadB);
+        std::swap(isUnsignedA, isUnsignedB);
+        coefficientsA = getCoefficients(loadA.getAffineMap(), loadA.getMapOperands());
+    }
+    auto coefficientsB = getCoefficients(loadB.getAffineMap(), loadB.getMapOperands());
+    if (!isTileAccess(coefficientsC, 0, 1) || !isTileAccess(coefficientsA, 0, 2) || !isTileAccess(coefficientsB, 2, 1))
+    {
+        return rewriter.notifyMatchFailure(affineForOp, "AMX tensorization requires the accesses C[i, j], A[i, k] and B[k, j]");
+    }
+
+    auto memRefTypeA = loadA.getMemRefType();
+    auto memRefTypeC = storeC.getMemRefType();
+    if (!HasContiguousRows(memRefTypeA) || !HasContiguousRows(memRefTypeC) || !memRefTypeC.getElementType().isSignlessIntOrFloat())
+    {
+        return rewriter.notifyMatchFailure(affineForOp, "AMX tensorization requires A and C to have contiguous rows");
+    }
+
+    auto getTripCount = [&](Value inductionVar) {
+        auto loop = getForInductionVarOwner(inductionVar);
+        return loop.getConstantUpperBound();
+    };
+    auto M = getTripCount(inductionVars[0]);
+    auto N = getTripCount(inductionVars[1]);
+    auto K = getTripCount(inductionVars[2]);
+
+    // Each row of the B tile holds 32 bits of each column
+    auto operandType = isFloat ? Type(rewriter.getBF16Type()) : Type(rewriter.getIntegerType(8));
+    auto operandBytes = isFloat ? 2 : 1;
+    auto interleave = 4 / operandBytes;
+    if (M > 16 || N > 16 || K * operandBytes > 64 || K % interleave != 0)
+    {
+        return rewriter.notifyMatchFailure(affineForOp, "The tile exceeds the AMX tile registers, which hold 16 rows of 64 bytes");
+    }
+
+    OpBuilder::InsertionGuard guard(rewriter);
+    auto loc = affineForOp.getLoc();
+    rewriter.setInsertionPoint(affineForOp);
+    auto zero = rewriter.create<ConstantIndexOp>(loc, 0);
+
+    // The origin of the tile of an access is where it is at the first iteration of the tile loops
+    auto getTileIndices = [&](AffineMap map, ValueRange mapOperands) {
+        SmallVector<Value, 4> operands(mapOperands.begin(), mapOperands.end());
+        fullyComposeAffineMapAndOperands(&map, &operands);
+        SmallVector<Value, 4> tileOperands;
+        for (auto operand : operands)
+        {
+            tileOperands.push_back(llvm::is_contained(inductionVars, operand) ? Value(zero) : operand);
+        }
+        SmallVector<Value, 4> indices;
+        for (unsigned resultIndex = 0; resultIndex < map.getNumResults(); ++resultIndex)
+        {
+            indices.push_back(rewriter.create<AffineApplyOp>(loc, map.getSubMap({ resultIndex }), tileOperands));
+        }
+        return indices;
+    };
+
+    // Casts the arrays of unsigned integers to the signless type of the tiles
+    auto toSignless = [&](Value memref) -> Value {
+        auto memRefType = memref.getType().cast<MemRefType>();
+        if (memRefType.getElementType().isSignlessIntOrFloat())
+        {
+            return memref;
+        }
+        auto signlessType = MemRefType::get(memRefType.getShape(), operandType, memRefType.getAffineMaps(), memRefType.getMemorySpace());
+        return rewriter.create<UnrealizedConversionCastOp>(loc, TypeRange{ signlessType }, ValueRange{ memref }).getResult(0);
+    };
+
+    // Pack B before the outermost enclosing loop that it doesn't change in, as long as nothing in that loop writes to B.
+    // The packed tile is placed where each thread allocates its own stack memory.
+    auto mapB = loadB.getAffineMap();
+    SmallVector<Value, 4> operandsB(loadB.getMapOperands().begin(), loadB.getMapOperands().end());
+    fullyComposeAffineMapAndOperands(&mapB, &operandsB);
+    Operation* packInsertionOp = affineForOp;
+    while (auto parentLoop = dyn_cast<AffineForOp>(packInsertionOp->getParentOp()))
+    {
+        auto dependsOnLoop = llvm::any_of(operandsB, [&](Value operand) {
+            return !llvm::is_contained(inductionVars, operand) && parentLoop->isAncestor(operand.getParentRegion()->getParentOp());
+        });
+        if (dependsOnLoop || HasParallelizationInfo(parentLoop) || MayWriteTo(parentLoop, loadB.getMemRef()))
+        {
+            break;
+        }
+        packInsertionOp = parentLoop;
+    }
+
+    Operation* allocaScopeOp = affineForOp->getParentOp();
+    while (!allocaScopeOp->hasTrait<OpTrait::IsIsolatedFromAbove>() && !(isa<AffineForOp>(allocaScopeOp) && HasParallelizationInfo(allocaScopeOp)))
+    {
+        allocaScopeOp = allocaScopeOp->getParentOp();
+    }
+    rewriter.setInsertionPointToStart(&allocaScopeOp->getRegion(0).front());
+    auto packedBType = MemRefType::get({ K / interleave, N * interleave }, operandType);
+    auto packedB = rewriter.create<memref::AllocaOp>(loc, packedBType, ValueRange{}, rewriter.getI64IntegerAttr(64));
+
+    rewriter.setInsertionPoint(packInsertionOp);
+    auto packKLoop = rewriter.create<AffineForOp>(loc, 0, K);
+    rewriter.setInsertionPointToStart(packKLoop.getBody());
+    auto packNLoop = rewriter.create<AffineForOp>(loc, 0, N);
+    rewriter.setInsertionPointToStart(packNLoop.getBody());
+    {
+        BlockAndValueMapping packMapping;
+        packMapping.map(inductionVars[0], rewriter.create<ConstantIndexOp>(loc, 0).getResult());
+        packMapping.map(inductionVars[1], packNLoop.getInductionVar());
+        packMapping.map(inductionVars[2], packKLoop.getInductionVar());
+        SmallVector<Value, 4> packOperands;
+        for (auto operand : operandsB)
+        {
+            packOperands.push_back(packMapping.lookupOrDefault(operand));
+        }
+        Value element = rewriter.create<AffineLoadOp>(loc, loadB.getMemRef(), mapB, packOperands);
+        if (element.getType() != operandType)
+        {
+            element = rewriter.create<UnrealizedConversionCastOp>(loc, TypeRange{ operandType }, ValueRange{ element }).getResult(0);
+        }
+        auto d0 = rewriter.getAffineDimExpr(0);
+        auto d1 = rewriter.getAffineDimExpr(1);
+        auto packedMap = AffineMap::get(2, 0, { d0.floorDiv(interleave), d1 * interleave + d0 % interleave }, rewriter.getContext());
+        rewriter.create<AffineStoreOp>(loc, element, packedB, packedMap, ValueRange{ packKLoop.getInductionVar(), packNLoop.getInductionVar() });
+    }
+
+    // The tile operations replace the loop nest
+    rewriter.setInsertionPoint(affineForOp);
+    auto accType = isFloat ? f32Type : i32Type;
+    auto tileTypeA = VectorType::get({ M, K }, operandType);
+    auto tileTypeB = VectorType::get({ K / interleave, N * interleave }, operandType);
+    auto tileTypeC = VectorType::get({ M, N }, accType);
+    auto memrefC = storeC.getMemRef();
+    auto indicesA = getTileIndices(loadA.getAffineMap(), loadA.getMapOperands());
+    auto indicesC = getTileIndices(storeC.getAffineMap(), storeC.getMapOperands());
+    auto tileA = rewriter.create<amx::TileLoadOp>(loc, tileTypeA, toSignless(loadA.getMemRef()), indicesA);
+    auto tileB = rewriter.create<amx::TileLoadOp>(loc, tileTypeB, packedB, ValueRange{ zero, zero });
+    auto tileC = rewriter.create<amx::TileLoadOp>(loc, tileTypeC, memrefC, indicesC);
+    Value result;
+    if (isFloat)
+    {
+        result = rewriter.create<amx::TileMulFOp>(loc, tileTypeC, tileA, tileB, tileC);
+    }
+    else
+    {
+        auto zextAttr = [&](bool isUnsigned) { return isUnsigned ? rewriter.getUnitAttr() : UnitAttr{}; };
+        result = rewriter.create<amx::TileMulIOp>(loc, tileTypeC, tileA, tileB, tileC, zextAttr(isUnsignedA), zextAttr(isUnsignedB));
+    }
+    rewriter.create<amx::TileStoreOp>(loc, memrefC, indicesC, result);
+
+    if (auto valueFuncOp = affineForOp->getParentOfType<v::ValueFuncOp>())
+    {
+        RequestAMXTileData(valueFuncOp, rewriter);
+    }
+    rewriter.eraseOp(affineForOp);
+    return success();
+}
+
+LogicalResult TensorizeAffineForOpConversion::matchAndRewrite(AffineForOp affineForOp, PatternRewriter& rewriter) const
+{
+    if (!HasTensorizationInfo(affineForOp))
+    {
+        // This isn't an AffineForOp marked for tensorization so just return without modifying it
+        return success();
+    }
+
+    auto tensorizationInfo = GetTensorizationInfo(affineForOp);
+
+    SmallVector<AffineForOp, 4> loops;
+    mlir::getPerfectlyNestedLoops(loops, affineForOp);
+    if (loops.size() != 3) // there should be 3 loops in the nest
+    {
+        return failure();
+    }
+    for (auto& en : llvm::enumerate(loops))
+    {
+        auto loop = en.value();
+        if (!HasTensorizationInfo(loop))
+        {
+            return failure();
         }
         if (!loop.hasConstantBounds())
         {
@@ -5595,6 +7664,18 @@ LogicalResult TensorizeAffineForOpConversion::matchAndRewrite(AffineForOp affine
         }
     }
 
+    // CPU targets tensorize with the AMX tile operations. The MFMA ops lower to the matrix core instructions of AMD GPUs,
+    // to the tensor core instructions of NVIDIA GPUs, and to the cooperative matrices of SPV_NV_cooperative_matrix on Vulkan.
+    if (util::ResolveExecutionTarget(affineForOp) == v::ExecutionTarget::CPU)
+    {
+        return TensorizeForAMX(affineForOp, loops, rewriter);
+    }
+    auto runtime = util::ResolveExecutionRuntime(affineForOp);
+    if (runtime != ExecutionRuntime::ROCM && runtime != ExecutionRuntime::CUDA && runtime != ExecutionRuntime::VULKAN)
+    {
+        return failure();
+    }
+
     auto innerLoop = loops[2]; // the inner most loop
     auto innerLoopBodyIter = innerLoop.getBody()->begin();
     auto innerLoopBodyEnd = innerLoop.getBody()->end();
@@ -5724,7 +7805,12 @@ LogicalResult TensorizeAffineForOpConversion::matchAndRewrite(AffineForOp affine
     };
 
     const auto mfmaType = getMatrixTypeOfMemref(loadAOp.getMemRefType(), tensorizationInfo.dim, "AOp"); // A, B and C have same mfma type
-    const auto& [warpSizeX, warpSizeY] = util::ResolveWarpSize(affineForOp).value();
+
+    // The tiles are assigned to groups of 64 threads, which are the wavefronts of AMD GPUs. A warp of an NVIDIA GPU computes a
+    // whole tile with the tensor core instructions, so only the first of the two warps of each group does the work. The
+    // same holds on Vulkan, where the devices that have cooperative matrices run subgroups of 32 threads
+    const bool isTilePerWarp = runtime == ExecutionRuntime::CUDA || runtime == ExecutionRuntime::VULKAN;
+    const auto [warpSizeX, warpSizeY] = isTilePerWarp ? std::make_pair(8, 8) : util::ResolveWarpSize(affineForOp).value();
     auto warpSize = rewriter.create<ConstantIndexOp>(loc, warpSizeX * warpSizeY);
     auto i32Ty = rewriter.getI32Type();
     auto int0 = rewriter.create<ConstantOp>(loc, i32Ty, rewriter.getZeroAttr(i32Ty));
@@ -5755,6 +7841,15 @@ LogicalResult TensorizeAffineForOpConversion::matchAndRewrite(AffineForOp affine
                                              rewriter.create<MulIOp>(loc, warpIdX, leadingDim),
                                              rewriter.create<MulIOp>(loc, bidX, singleBlockOffsetCol));
 
+    if (isTilePerWarp)
+    {
+        const auto [cudaWarpSizeX, cudaWarpSizeY] = runtime == ExecutionRuntime::VULKAN ? std::make_pair(8, 4) : util::ResolveWarpSize(affineForOp).value();
+        auto groupTid = rewriter.create<UnsignedRemIOp>(loc, blockTid, warpSize);
+        auto isFirstWarp = rewriter.create<CmpIOp>(loc, CmpIPredicate::ult, groupTid, rewriter.create<ConstantIndexOp>(loc, cudaWarpSizeX * cudaWarpSizeY));
+        auto firstWarpIfOp = rewriter.create<scf::IfOp>(loc, isFirstWarp, /*withElseRegion=*/false);
+        rewriter.setInsertionPoint(firstWarpIfOp.thenBlock()->getTerminator());
+    }
+
     auto loadMatrixOp = [&](AffineLoadOp loadOp, StringRef kind, auto mfma_block_offset) {
         auto mfmaMatrixType = getMatrixTypeOfMemref(loadOp.getMemRefType(), tensorizationInfo.dim, kind);
         if (kind == "AOp")
@@ -5867,6 +7962,37 @@ LogicalResult TensorizeAffineForOpConversion::matchAndRewrite(AffineForOp affine
     return success();
 }
 
+StringRef GetScheduleClause(ParallelSchedule schedule)
+{
+    switch (schedule)
+    {
+    case ParallelSchedule::Dynamic:
+        return "Dynamic";
+    case ParallelSchedule::Guided:
+        return "Guided";
+    case ParallelSchedule::Static:
+    case ParallelSchedule::WorkStealing:
+    default:
+        return "Static";
+    }
+}
+
+StringRef GetProcBindClause(ParallelProcBind procBind)
+{
+    // Valid clause values: llvm\include\llvm\Frontend\OpenMP\OMP.td ("primary" is spelled "master" in this version)
+    switch (procBind)
+    {
+    case ParallelProcBind::Spread:
+        return "spread";
+    case ParallelProcBind::Primary:
+        return "master";
+    case ParallelProcBind::Default:
+    case ParallelProcBind::Close:
+    default:
+        return "close";
+    }
+}
+
 LogicalResult ParallelizeAffineForOpConversion::matchAndRewrite(AffineForOp affineForOp, PatternRewriter& rewriter) const
 {
     if (!HasParallelizationInfo(affineForOp))
@@ -5895,8 +8021,28 @@ LogicalResult ParallelizeAffineForOpConversion::matchAndRewrite(AffineForOp affi
     newParallelOp->setAttr(mlir::omp::getNumThreadsAttrName(), rewriter.getI64IntegerAttr(parallelizationInfo.numThreads));
 
     // Valid clause values: llvm\include\llvm\Frontend\OpenMP\OMP.td
-    newParallelOp->setAttr(mlir::omp::getScheduleAttrName(), rewriter.getStringAttr(parallelizationInfo.isDynamicPolicy ? "Dynamic" : "Static"));
-    newParallelOp->setAttr(mlir::omp::getProcBindAttrName(), rewriter.getStringAttr("close"));
+    newParallelOp->setAttr(mlir::omp::getScheduleAttrName(), rewriter.getStringAttr(GetScheduleClause(parallelizationInfo.schedule)));
+    if (parallelizationInfo.chunkSize > 0)
+    {
+        newParallelOp->setAttr(ScheduleChunkAttrName, rewriter.getI64IntegerAttr(parallelizationInfo.chunkSize));
+    }
+    newParallelOp->setAttr(mlir::omp::getProcBindAttrName(), rewriter.getStringAttr(GetProcBindClause(parallelizationInfo.procBind)));
+    newParallelOp->setAttr(ParallelGroupAttrName, rewriter.getI64IntegerAttr(parallelizationInfo.group));
+    if (parallelizationInfo.procBind != ParallelProcBind::Default)
+    {
+        newParallelOp->setAttr(ParallelPinnedAttrName, rewriter.getUnitAttr());
+    }
+    if (auto processorsAttr = affineForOp->getAttr(ParallelProcessorsAttrName))
+    {
+        // The threads are pinned once the loops of the band are collapsed, see PinParallelRegionRewrite
+        newParallelOp->setAttr(ParallelProcessorsAttrName, processorsAttr);
+    }
+
+    if (parallelizationInfo.schedule == ParallelSchedule::WorkStealing)
+    {
+        // The chunks are handed out by the work-stealing runtime after the affine lowering, see WorkStealingParallelOpRewrite
+        newParallelOp->setAttr(WorkStealingAttrName, rewriter.getUnitAttr());
+    }
 
     rewriter.eraseOp(affineForOp);
     rewriter.finalizeRootUpdate(affineForOp);
@@ -5938,6 +8084,12 @@ LogicalResult CollapseAffineParallelOpsRewrite::matchAndRewrite(AffineParallelOp
         return failure();
     }
 
+    // Loops from different bands are separate parallel levels, see NestedParallelRegionRewrite
+    if (affineParallelOp->getAttr(ParallelGroupAttrName) != childOp->getAttr(ParallelGroupAttrName))
+    {
+        return failure();
+    }
+
     // Merge the current op with its perfectly nested child. For example:
     //   affine.parallel (%arg3) = (0) to (256) step (64) {
     //      affine.parallel (%arg4) = (0) to (256) {
@@ -6022,6 +8174,23 @@ LogicalResult CollapseAffineParallelOpsRewrite::matchAndRewrite(AffineParallelOp
     mergedParallelOp->setAttr(mlir::omp::getNumThreadsAttrName(), affineParallelOp->getAttr(mlir::omp::getNumThreadsAttrName()));
     mergedParallelOp->setAttr(mlir::omp::getScheduleAttrName(), affineParallelOp->getAttr(mlir::omp::getScheduleAttrName()));
     mergedParallelOp->setAttr(mlir::omp::getProcBindAttrName(), affineParallelOp->getAttr(mlir::omp::getProcBindAttrName()));
+    mergedParallelOp->setAttr(ParallelGroupAttrName, affineParallelOp->getAttr(ParallelGroupAttrName));
+    if (affineParallelOp->hasAttr(WorkStealingAttrName))
+    {
+        mergedParallelOp->setAttr(WorkStealingAttrName, rewriter.getUnitAttr());
+    }
+    if (affineParallelOp->hasAttr(ParallelPinnedAttrName))
+    {
+        mergedParallelOp->setAttr(ParallelPinnedAttrName, rewriter.getUnitAttr());
+    }
+    if (auto chunkSizeAttr = affineParallelOp->getAttr(ScheduleChunkAttrName))
+    {
+        mergedParallelOp->setAttr(ScheduleChunkAttrName, chunkSizeAttr);
+    }
+    if (auto processorsAttr = affineParallelOp->getAttr(ParallelProcessorsAttrName))
+    {
+        mergedParallelOp->setAttr(ParallelProcessorsAttrName, processorsAttr);
+    }
 
     // Merge and set the collapse attribute
     int64_t collapse = (affineParallelOp->hasAttrOfType<IntegerAttr>(mlir::omp::getCollapseAttrName())) ? affineParallelOp->getAttrOfType<IntegerAttr>(mlir::omp::getCollapseAttrName()).getInt() : 1;
@@ -6039,100 +8208,478 @@ LogicalResult CollapseAffineParallelOpsRewrite::matchAndRewrite(AffineParallelOp
     return success();
 }
 
-LogicalResult HoistScalingToCacheReduceRewrite::matchAndRewrite(mlir::AffineStoreOp affineStoreOp, PatternRewriter& rewriter) const
+FuncOp GetOrInsertRuntimeFunction(PatternRewriter& rewriter, Operation* anchorOp, const std::string& name, FunctionType type)
 {
-    // Find if the cache has a CacheReduceOp within the current scope or a parent scope
+    auto symbolTableOp = SymbolTable::getNearestSymbolTable(anchorOp);
+    assert(symbolTableOp && "Expected the function to be nested in a symbol table");
 
-    // This assumes that there is one relevant CacheReduceOp associated with this AffineStoreOp,
-    // however there can be multiple CacheReduceOps in the graph as a whole in separate branches
-    // i.e. the graph is assumed to look like:
-    // loops... {
-    //     loops... {
-    //         loop {
-    //             loops... {
-    //                 AffineStoreOp(myCache, ...)
-    //             }
-    //         }
-    //         CacheReduceOp(myCache, ...)
-    //     }
-    //     loops... {
-    //         loop {
-    //             loops... {
-    //                 AffineStoreOp(myCache, ...)
-    //             }
-    //         }
-    //         CacheReduceOp(myCache, ...)
-    //     }
-    //     ...
-    // }
+    // Lock before accessing the enclosing symbol table since sibling functions are lowered in parallel
+    static std::mutex runtimeFunctionInsertMutex;
+    std::lock_guard<std::mutex> lock(runtimeFunctionInsertMutex);
+    if (auto existingFuncOp = dyn_cast_or_null<FuncOp>(SymbolTable::lookupSymbolIn(symbolTableOp, name)))
+    {
+        return existingFuncOp;
+    }
 
-    auto loc = affineStoreOp.getLoc();
-    auto valueFuncOp = affineStoreOp->getParentOfType<ValueFuncOp>();
-    DominanceInfo domInfo(valueFuncOp);
+    OpBuilder::InsertionGuard guard(rewriter);
+    rewriter.setInsertionPointToStart(&symbolTableOp->getRegion(0).front());
+    auto runtimeFuncOp = rewriter.create<FuncOp>(anchorOp->getLoc(), name, type);
+    runtimeFuncOp.setPrivate();
+    return runtimeFuncOp;
+}
 
-    auto elementType = affineStoreOp.value().getType();
+bool IsParallelRegion(Operation* op)
+{
+    return isa<AffineParallelOp>(op) && op->hasAttr(mlir::omp::getNumThreadsAttrName());
+}
 
-    std::vector<ActiveBlockCacheReduceOp> activeBlockCacheReduceOps = util::getUsesOfType<ActiveBlockCacheReduceOp>(affineStoreOp.memref());
-    std::vector<ActiveElementCacheReduceOp> activeElementCacheReduceOps = util::getUsesOfType<ActiveElementCacheReduceOp>(affineStoreOp.memref());
-    assert((activeBlockCacheReduceOps.empty() || activeElementCacheReduceOps.empty()) && "At most one type of cache can be active for a store op in a kernel");
-    Operation* targetCacheReduceOpOperation = nullptr;
-    for (auto& cacheReduceOp : activeBlockCacheReduceOps)
+LogicalResult NestedParallelRegionRewrite::matchAndRewrite(AffineParallelOp affineParallelOp, PatternRewriter& rewriter) const
+{
+    // Enables the nested teams of the outermost of a set of nested parallel loops:
+    //   affine.parallel (%i) = ... {
+    //      affine.parallel (%j) = ... {
+    //      } {omp.num_threads = 8, omp.proc_bind = "close"}
+    //   } {omp.num_threads = 2, omp.proc_bind = "close"}
+    // Becomes:
+    //   call @omp_set_max_active_levels(%c2_i32)
+    //   affine.parallel (%i) = ... {
+    //      affine.parallel (%j) = ... {
+    //      } {omp.num_threads = 8, omp.proc_bind = "close"}
+    //   } {accxp.nested_parallel_levels = 2, omp.num_threads = 2, omp.proc_bind = "spread"}
+    //
+    // The outer team spreads over the machine (e.g. one thread per socket) and each inner team stays
+    // close to its parent thread, so the inner loop runs on cores that share a cache.
+    // An outer level that was pinned by the user keeps its proc_bind
+    if (!IsParallelRegion(affineParallelOp) || affineParallelOp->hasAttr(NestedParallelLevelsAttrName))
     {
-        auto cacheReduceBlock = cacheReduceOp->getBlock();
-        auto ancestorOp = cacheReduceBlock->findAncestorOpInBlock(*affineStoreOp.getOperation());
-        if (ancestorOp)
-        {
-            assert(targetCacheReduceOpOperation == nullptr); // Only expect one cache reduce op to be a candidate
-            targetCacheReduceOpOperation = cacheReduceOp;
-        }
+        return failure();
     }
-    for (auto& cacheReduceOp : activeElementCacheReduceOps)
+    for (auto parentOp = affineParallelOp->getParentOp(); parentOp; parentOp = parentOp->getParentOp())
     {
-        auto cacheReduceBlock = cacheReduceOp->getBlock();
-        auto ancestorOp = cacheReduceBlock->findAncestorOpInBlock(*affineStoreOp.getOperation());
-        if (ancestorOp)
+        if (IsParallelRegion(parentOp))
         {
-            assert(targetCacheReduceOpOperation == nullptr); // Only expect one cache reduce op to be a candidate
-            targetCacheReduceOpOperation = cacheReduceOp;
+            return failure();
         }
     }
-    if (!targetCacheReduceOpOperation)
+
+    int64_t numLevels = 1;
+    affineParallelOp.getLoopBody().walk([&](AffineParallelOp nestedOp) {
+        if (!IsParallelRegion(nestedOp))
+        {
+            return;
+        }
+        int64_t level = 1;
+        for (auto parentOp = nestedOp->getParentOp(); parentOp; parentOp = parentOp->getParentOp())
+        {
+            level += IsParallelRegion(parentOp) ? 1 : 0;
+        }
+        numLevels = std::max(numLevels, level);
+    });
+    if (numLevels < 2)
     {
-        // No corresponding cache reduce op for this store so nothing to do here
         return failure();
     }
 
-    // We found a corresponding CacheReduceOp, now check:
-    // 1) If the value being stored is a simple accumulation sum (i.e. a sum where one operand is a loaded element from the same position as the store)
-    // 2) If the value being added to the loaded data is only a product of other values
-    // 3) If any of those values in the product dominate the CacheReduceOp, such as a constant, a function argument, or just something defined at a higher loop layer
-    // Then:
-    // 1) replace the CacheReduceOp with a new CacheReduceOp that has the chosen values appended to its scaling list
-    // 2) replace uses of the multiplication result for each chosen value with the multiplication operand that wasn't the chosen value
+    auto loc = affineParallelOp.getLoc();
+    auto i32Type = rewriter.getI32Type();
+    auto setMaxActiveLevelsFn = GetOrInsertRuntimeFunction(rewriter, affineParallelOp, OMPSetMaxActiveLevelsFnName, rewriter.getFunctionType({ i32Type }, {}));
 
-    // 1) Check if it's a simple accumulation sum
-    auto storeValue = affineStoreOp.value();
-    Operation* currentOp = storeValue.getDefiningOp();
-    auto currentBinOp = dyn_cast_or_null<v::BinOp>(currentOp);
-    if (!currentBinOp)
+    rewriter.startRootUpdate(affineParallelOp);
+    rewriter.setInsertionPoint(affineParallelOp);
+    auto numLevelsValue = rewriter.create<ConstantIntOp>(loc, numLevels, i32Type);
+    rewriter.create<CallOp>(loc, setMaxActiveLevelsFn, ValueRange{ numLevelsValue });
+    affineParallelOp->setAttr(NestedParallelLevelsAttrName, rewriter.getI64IntegerAttr(numLevels));
+    if (!affineParallelOp->hasAttr(ParallelPinnedAttrName))
     {
-        // Not a simple accumulation sum if the last operation wasn't a binary op
-        return failure();
+        affineParallelOp->setAttr(mlir::omp::getProcBindAttrName(), rewriter.getStringAttr("spread"));
     }
-    if (currentBinOp.predicate() != v::BinaryOpPredicate::ADD)
+    rewriter.finalizeRootUpdate(affineParallelOp);
+
+    return success();
+}
+
+LogicalResult PinParallelRegionRewrite::matchAndRewrite(AffineParallelOp affineParallelOp, PatternRewriter& rewriter) const
+{
+    // Pins each thread of a parallel loop to a processor of an explicit list:
+    //   affine.parallel (%i) = ... {
+    //      body(%i)
+    //   } {accxp.parallel_processors = [0, 2, 4, 6], omp.num_threads = 4}
+    // Becomes:
+    //   affine.parallel (%i) = ... {
+    //      %tid = call @omp_get_thread_num() : () -> i32
+    //      %slot = remi_unsigned %tid, %c4_i32
+    //      %processor = select(%slot == 1, 2, select(%slot == 2, 4, ...))
+    //      call @AcceraPinCurrentThread(%processor) : (i64) -> i32
+    //      body(%i)
+    //   } {omp.num_threads = 4}
+    //
+    // The runtime remembers the processor each thread is pinned to, so only the first iteration of a thread
+    // changes its affinity
+    auto processorsAttr = affineParallelOp->getAttrOfType<ArrayAttr>(ParallelProcessorsAttrName);
+    if (!processorsAttr)
     {
-        // Not a simple accumulation sum if the last operation wasn't an add
         return failure();
     }
-    // Check if either the lhs or the rhs defining op is an AffineLoadOp from the same location as the store
-    auto lhsOp = currentBinOp.lhs().getDefiningOp();
-    auto rhsOp = currentBinOp.rhs().getDefiningOp();
-    auto lhsLoadOp = dyn_cast_or_null<mlir::AffineLoadOp>(lhsOp);
-    auto rhsLoadOp = dyn_cast_or_null<mlir::AffineLoadOp>(rhsOp);
-    if (!lhsLoadOp && !rhsLoadOp)
+    auto processors = util::ConvertArrayAttrToIntVector(processorsAttr);
+
+    auto loc = affineParallelOp.getLoc();
+    auto i32Type = rewriter.getI32Type();
+    auto i64Type = rewriter.getI64Type();
+    auto getThreadNumFn = GetOrInsertRuntimeFunction(rewriter, affineParallelOp, OMPGetThreadNumFnName, rewriter.getFunctionType({}, { i32Type }));
+    auto pinCurrentThreadFn = GetOrInsertRuntimeFunction(rewriter, affineParallelOp, PinCurrentThreadFnName, rewriter.getFunctionType({ i64Type }, { i32Type }));
+
+    rewriter.startRootUpdate(affineParallelOp);
+    affineParallelOp->removeAttr(ParallelProcessorsAttrName);
+    rewriter.setInsertionPointToStart(affineParallelOp.getBody());
+
+    auto threadNum = rewriter.create<CallOp>(loc, getThreadNumFn, ValueRange{}).getResult(0);
+    auto numProcessors = rewriter.create<ConstantIntOp>(loc, static_cast<int64_t>(processors.size()), i32Type);
+    auto slot = rewriter.create<UnsignedRemIOp>(loc, threadNum, numProcessors);
+    mlir::Value processor = rewriter.create<ConstantIntOp>(loc, processors[0], i64Type);
+    for (size_t index = 1; index < processors.size(); ++index)
     {
-        // Neither are load ops so it's not a simple accumulate
-        return failure();
+        auto slotIndex = rewriter.create<ConstantIntOp>(loc, static_cast<int64_t>(index), i32Type);
+        auto isSlot = rewriter.create<CmpIOp>(loc, CmpIPredicate::eq, slot, slotIndex);
+        auto slotProcessor = rewriter.create<ConstantIntOp>(loc, processors[index], i64Type);
+        processor = rewriter.create<SelectOp>(loc, isSlot, slotProcessor, processor);
+    }
+    rewriter.create<CallOp>(loc, pinCurrentThreadFn, ValueRange{ processor });
+    rewriter.finalizeRootUpdate(affineParallelOp);
+
+    return success();
+}
+
+// Computes the trip count of each dimension of a (possibly collapsed) parallel loop, and returns the total trip count
+Value GetParallelTripCounts(PatternRewriter& rewriter, scf::ParallelOp parallelOp, SmallVectorImpl<Value>& tripCounts)
+{
+    auto loc = parallelOp.getLoc();
+    Value totalTripCount = rewriter.create<ConstantIndexOp>(loc, 1);
+    for (auto [lb, ub, step] : llvm::zip(parallelOp.lowerBound(), parallelOp.upperBound(), parallelOp.step()))
+    {
+        auto range = rewriter.create<SubIOp>(loc, ub, lb);
+        auto tripCount = rewriter.create<SignedCeilDivIOp>(loc, range, step);
+        tripCounts.push_back(tripCount);
+        totalTripCount = rewriter.create<MulIOp>(loc, totalTripCount, tripCount);
+    }
+    return totalTripCount;
+}
+
+// Clones the body of a parallel loop for one linearized iteration, recovering the induction variables
+// of the original loop from the linear index, innermost dimension first
+void CloneParallelBodyAtLinearIndex(PatternRewriter& rewriter, scf::ParallelOp parallelOp, ArrayRef<Value> tripCounts, Value linearIndex)
+{
+    auto loc = parallelOp.getLoc();
+    Value remaining = linearIndex;
+    auto numDims = parallelOp.getNumLoops();
+    SmallVector<Value, 4> inductionVars(numDims);
+    for (int64_t dim = static_cast<int64_t>(numDims) - 1; dim >= 0; --dim)
+    {
+        Value dimIndex = remaining;
+        if (dim > 0)
+        {
+            dimIndex = rewriter.create<SignedRemIOp>(loc, remaining, tripCounts[dim]);
+            remaining = rewriter.create<SignedDivIOp>(loc, remaining, tripCounts[dim]);
+        }
+        auto offset = rewriter.create<MulIOp>(loc, dimIndex, parallelOp.step()[dim]);
+        inductionVars[dim] = rewriter.create<AddIOp>(loc, parallelOp.lowerBound()[dim], offset);
+    }
+
+    BlockAndValueMapping mapping;
+    mapping.map(parallelOp.getInductionVars(), inductionVars);
+    for (auto& op : parallelOp.getBody()->without_terminator())
+    {
+        rewriter.clone(op, mapping);
+    }
+}
+
+LogicalResult WorkStealingParallelOpRewrite::matchAndRewrite(scf::ParallelOp parallelOp, PatternRewriter& rewriter) const
+{
+    // Rewrites a (possibly collapsed) parallel loop marked for work-stealing:
+    //   scf.parallel (%i, %j) = (%lb0, %lb1) to (%ub0, %ub1) step (%s0, %s1) {
+    //      body(%i, %j)
+    //   } {accxp.work_stealing, omp.num_threads = N}
+    // Into one loop iteration per worker, each of which pulls linearized iterations from the runtime:
+    //   %handle = call @AcceraWorkStealingCreate(%tripCount, N)
+    //   scf.parallel (%w) = (0) to (N) step (1) {
+    //      scf.while : () -> () {
+    //          %chunk = call @AcceraWorkStealingNext(%handle, %w)
+    //          scf.condition(%chunk >= 0) %chunk
+    //      } do {
+    //      ^bb0(%chunk):
+    //          %i, %j = delinearize(%chunk)
+    //          body(%i, %j)
+    //      }
+    //   } {omp.num_threads = N, omp.schedule_val = "Static"}
+    //   call @AcceraWorkStealingDestroy(%handle)
+    // This runs after the affine lowering because the induction variables computed from the runtime
+    // call results are not valid affine dimensions
+    if (!parallelOp->hasAttr(WorkStealingAttrName) || parallelOp->hasAttr(ScheduleChunkAttrName))
+    {
+        // Chunked loops are first split into chunks, see ChunkedParallelOpRewrite
+        return failure();
+    }
+
+    if (parallelOp.getNumResults() != 0)
+    {
+        return rewriter.notifyMatchFailure(parallelOp, "Work-stealing parallel loops with reductions are not supported");
+    }
+
+    auto loc = parallelOp.getLoc();
+    auto i64Type = rewriter.getI64Type();
+    auto indexType = rewriter.getIndexType();
+
+    auto createFn = GetOrInsertRuntimeFunction(rewriter, parallelOp, WorkStealingCreateFnName, rewriter.getFunctionType({ i64Type, i64Type }, { i64Type }));
+    auto nextFn = GetOrInsertRuntimeFunction(rewriter, parallelOp, WorkStealingNextFnName, rewriter.getFunctionType({ i64Type, i64Type }, { i64Type }));
+    auto destroyFn = GetOrInsertRuntimeFunction(rewriter, parallelOp, WorkStealingDestroyFnName, rewriter.getFunctionType({ i64Type }, {}));
+
+    auto numThreadsAttr = parallelOp->getAttrOfType<IntegerAttr>(mlir::omp::getNumThreadsAttrName());
+    int64_t numWorkers = numThreadsAttr ? numThreadsAttr.getInt() : 1;
+
+    rewriter.setInsertionPoint(parallelOp);
+    auto zero = rewriter.create<ConstantIndexOp>(loc, 0);
+    auto one = rewriter.create<ConstantIndexOp>(loc, 1);
+
+    // Compute the per-dimension trip counts and the total number of chunks (one chunk per parallel iteration)
+    SmallVector<Value, 4> tripCounts;
+    auto numChunks = GetParallelTripCounts(rewriter, parallelOp, tripCounts);
+
+    auto numChunksI64 = rewriter.create<IndexCastOp>(loc, numChunks, i64Type);
+    auto numWorkersI64 = rewriter.create<ConstantIntOp>(loc, numWorkers, i64Type);
+    auto handle = rewriter.create<CallOp>(loc, createFn, ValueRange{ numChunksI64, numWorkersI64 }).getResult(0);
+
+    // One iteration per worker, so the static OpenMP schedule gives each thread exactly one worker id
+    auto numWorkersIndex = rewriter.create<ConstantIndexOp>(loc, numWorkers);
+    auto workersOp = rewriter.create<scf::ParallelOp>(loc, ValueRange{ zero }, ValueRange{ numWorkersIndex }, ValueRange{ one });
+    workersOp->setAttr(mlir::omp::getNumThreadsAttrName(), rewriter.getI64IntegerAttr(numWorkers));
+    workersOp->setAttr(mlir::omp::getScheduleAttrName(), rewriter.getStringAttr("Static"));
+    if (auto procBind = parallelOp->getAttr(mlir::omp::getProcBindAttrName()))
+    {
+        workersOp->setAttr(mlir::omp::getProcBindAttrName(), procBind);
+    }
+
+    {
+        OpBuilder::InsertionGuard guard(rewriter);
+        rewriter.setInsertionPoint(workersOp.getBody()->getTerminator());
+        auto workerId = rewriter.create<IndexCastOp>(loc, workersOp.getInductionVars()[0], i64Type);
+
+        auto whileOp = rewriter.create<scf::WhileOp>(loc, TypeRange{ i64Type }, ValueRange{});
+
+        // Request the next chunk and exit once the runtime reports that all work is done
+        rewriter.createBlock(&whileOp.before());
+        auto chunk = rewriter.create<CallOp>(loc, nextFn, ValueRange{ handle, workerId }).getResult(0);
+        auto zeroI64 = rewriter.create<ConstantIntOp>(loc, 0, i64Type);
+        auto hasChunk = rewriter.create<CmpIOp>(loc, CmpIPredicate::sge, chunk, zeroI64);
+        rewriter.create<scf::ConditionOp>(loc, hasChunk, ValueRange{ chunk });
+
+        // Recover the induction variables of the original loop from the chunk index
+        auto afterBlock = rewriter.createBlock(&whileOp.after(), {}, TypeRange{ i64Type });
+        auto chunkIndex = rewriter.create<IndexCastOp>(loc, afterBlock->getArgument(0), indexType);
+        CloneParallelBodyAtLinearIndex(rewriter, parallelOp, tripCounts, chunkIndex);
+        rewriter.create<scf::YieldOp>(loc);
+    }
+
+    rewriter.create<CallOp>(loc, destroyFn, ValueRange{ handle });
+    rewriter.eraseOp(parallelOp);
+
+    return success();
+}
+
+LogicalResult ChunkedParallelOpRewrite::matchAndRewrite(scf::ParallelOp parallelOp, PatternRewriter& rewriter) const
+{
+    // Splits the linearized iterations of a (possibly collapsed) parallel loop with a chunk size C into chunks,
+    // so that each iteration of the parallel loop that remains runs one chunk:
+    //   scf.parallel (%i, %j) = (%lb0, %lb1) to (%ub0, %ub1) step (%s0, %s1) {
+    //      body(%i, %j)
+    //   } {accxp.schedule_chunk = C, omp.schedule_val = "Dynamic"}
+    // Becomes:
+    //   scf.parallel (%c) = (0) to (ceildiv(%tripCount, C)) step (1) {
+    //      scf.for %l = %c * C to min(%c * C + C, %tripCount) step 1 {
+    //          %i, %j = delinearize(%l)
+    //          body(%i, %j)
+    //      }
+    //   } {omp.schedule_val = "Dynamic"}
+    // The dynamic and guided schedules (and the work-stealing runtime) then hand out whole chunks.
+    //
+    // The static schedule gives each thread a contiguous block of the parallel iterations, so static
+    // chunks are instead dealt round-robin to one parallel iteration per thread:
+    //   scf.parallel (%t) = (0) to (N) step (1) {
+    //      scf.for %c = %t * C to %tripCount step N * C {
+    //          scf.for %l = %c to min(%c + C, %tripCount) step 1 {
+    //              ...
+    //          }
+    //      }
+    //   } {omp.num_threads = N, omp.schedule_val = "Static"}
+    //
+    // The OpenMP dialect of this LLVM version does not forward a chunk operand from scf.parallel to omp.wsloop,
+    // and its static worksharing loop ignores the chunk, so the chunks are made explicit instead
+    auto chunkSizeAttr = parallelOp->getAttrOfType<IntegerAttr>(ScheduleChunkAttrName);
+    if (!chunkSizeAttr)
+    {
+        return failure();
+    }
+
+    if (parallelOp.getNumResults() != 0)
+    {
+        return rewriter.notifyMatchFailure(parallelOp, "Chunked parallel loops with reductions are not supported");
+    }
+
+    auto loc = parallelOp.getLoc();
+    auto scheduleAttr = parallelOp->getAttrOfType<StringAttr>(mlir::omp::getScheduleAttrName());
+    auto isStatic = !parallelOp->hasAttr(WorkStealingAttrName) && (!scheduleAttr || scheduleAttr.getValue() == "Static");
+    auto numThreadsAttr = parallelOp->getAttrOfType<IntegerAttr>(mlir::omp::getNumThreadsAttrName());
+    int64_t numThreads = numThreadsAttr ? numThreadsAttr.getInt() : 1;
+
+    rewriter.setInsertionPoint(parallelOp);
+    auto zero = rewriter.create<ConstantIndexOp>(loc, 0);
+    auto one = rewriter.create<ConstantIndexOp>(loc, 1);
+    auto chunkSize = rewriter.create<ConstantIndexOp>(loc, chunkSizeAttr.getInt());
+
+    SmallVector<Value, 4> tripCounts;
+    auto totalTripCount = GetParallelTripCounts(rewriter, parallelOp, tripCounts);
+
+    Value numParallelIterations;
+    if (isStatic)
+    {
+        numParallelIterations = rewriter.create<ConstantIndexOp>(loc, numThreads);
+    }
+    else
+    {
+        numParallelIterations = rewriter.create<SignedCeilDivIOp>(loc, totalTripCount, chunkSize);
+    }
+
+    auto chunksOp = rewriter.create<scf::ParallelOp>(loc, ValueRange{ zero }, ValueRange{ numParallelIterations }, ValueRange{ one });
+    chunksOp->setDialectAttrs(parallelOp->getDialectAttrs());
+    chunksOp->removeAttr(ScheduleChunkAttrName);
+    chunksOp->removeAttr(mlir::omp::getCollapseAttrName());
+
+    OpBuilder::InsertionGuard guard(rewriter);
+    rewriter.setInsertionPoint(chunksOp.getBody()->getTerminator());
+    auto parallelIndex = chunksOp.getInductionVars()[0];
+    auto firstChunkBegin = rewriter.create<MulIOp>(loc, parallelIndex, chunkSize);
+
+    // Runs the chunk of iterations that begins at chunkBegin
+    auto buildChunk = [&](Value chunkBegin) {
+        auto chunkEnd = rewriter.create<AddIOp>(loc, chunkBegin, chunkSize);
+        auto isLastChunk = rewriter.create<CmpIOp>(loc, CmpIPredicate::slt, totalTripCount, chunkEnd);
+        auto clampedChunkEnd = rewriter.create<SelectOp>(loc, isLastChunk, totalTripCount, chunkEnd);
+        auto iterationsOp = rewriter.create<scf::ForOp>(loc, chunkBegin, clampedChunkEnd, one);
+
+        OpBuilder::InsertionGuard bodyGuard(rewriter);
+        rewriter.setInsertionPoint(iterationsOp.getBody()->getTerminator());
+        CloneParallelBodyAtLinearIndex(rewriter, parallelOp, tripCounts, iterationsOp.getInductionVar());
+    };
+
+    if (isStatic)
+    {
+        auto threadsStride = rewriter.create<ConstantIndexOp>(loc, numThreads * chunkSizeAttr.getInt());
+        auto chunksOfThreadOp = rewriter.create<scf::ForOp>(loc, firstChunkBegin, totalTripCount, threadsStride);
+        rewriter.setInsertionPoint(chunksOfThreadOp.getBody()->getTerminator());
+        buildChunk(chunksOfThreadOp.getInductionVar());
+    }
+    else
+    {
+        buildChunk(firstChunkBegin);
+    }
+
+    rewriter.eraseOp(parallelOp);
+
+    return success();
+}
+
+LogicalResult HoistScalingToCacheReduceRewrite::matchAndRewrite(mlir::AffineStoreOp affineStoreOp, PatternRewriter& rewriter) const
+{
+    // Find if the cache has a CacheReduceOp within the current scope or a parent scope
+
+    // This assumes that there is one relevant CacheReduceOp associated with this AffineStoreOp,
+    // however there can be multiple CacheReduceOps in the graph as a whole in separate branches
+    // i.e. the graph is assumed to look like:
+    // loops... {
+    //     loops... {
+    //         loop {
+    //             loops... {
+    //                 AffineStoreOp(myCache, ...)
+    //             }
+    //         }
+    //         CacheReduceOp(myCache, ...)
+    //     }
+    //     loops... {
+    //         loop {
+    //             loops... {
+    //                 AffineStoreOp(myCache, ...)
+    //             }
+    //         }
+    //         CacheReduceOp(myCache, ...)
+    //     }
+    //     ...
+    // }
+
+    auto loc = affineStoreOp.getLoc();
+    auto valueFuncOp = affineStoreOp->getParentOfType<ValueFuncOp>();
+    DominanceInfo domInfo(valueFuncOp);
+
+    auto elementType = affineStoreOp.value().getType();
+
+    std::vector<ActiveBlockCacheReduceOp> activeBlockCacheReduceOps = util::getUsesOfType<ActiveBlockCacheReduceOp>(affineStoreOp.memref());
+    std::vector<ActiveElementCacheReduceOp> activeElementCacheReduceOps = util::getUsesOfType<ActiveElementCacheReduceOp>(affineStoreOp.memref());
+    assert((activeBlockCacheReduceOps.empty() || activeElementCacheReduceOps.empty()) && "At most one type of cache can be active for a store op in a kernel");
+    Operation* targetCacheReduceOpOperation = nullptr;
+    for (auto& cacheReduceOp : activeBlockCacheReduceOps)
+    {
+        auto cacheReduceBlock = cacheReduceOp->getBlock();
+        auto ancestorOp = cacheReduceBlock->findAncestorOpInBlock(*affineStoreOp.getOperation());
+        if (ancestorOp)
+        {
+            assert(targetCacheReduceOpOperation == nullptr); // Only expect one cache reduce op to be a candidate
+            targetCacheReduceOpOperation = cacheReduceOp;
+        }
+    }
+    for (auto& cacheReduceOp : activeElementCacheReduceOps)
+    {
+        auto cacheReduceBlock = cacheReduceOp->getBlock();
+        auto ancestorOp = cacheReduceBlock->findAncestorOpInBlock(*affineStoreOp.getOperation());
+        if (ancestorOp)
+        {
+            assert(targetCacheReduceOpOperation == nullptr); // Only expect one cache reduce op to be a candidate
+            targetCacheReduceOpOperation = cacheReduceOp;
+        }
+    }
+    if (!targetCacheReduceOpOperation)
+    {
+        // No corresponding cache reduce op for this store so nothing to do here
+        return failure();
+    }
+
+    // We found a corresponding CacheReduceOp, now check:
+    // 1) If the value being stored is a simple accumulation sum (i.e. a sum where one operand is a loaded element from the same position as the store)
+    // 2) If the value being added to the loaded data is only a product of other values
+    // 3) If any of those values in the product dominate the CacheReduceOp, such as a constant, a function argument, or just something defined at a higher loop layer
+    // Then:
+    // 1) replace the CacheReduceOp with a new CacheReduceOp that has the chosen values appended to its scaling list
+    // 2) replace uses of the multiplication result for each chosen value with the multiplication operand that wasn't the chosen value
+
+    // 1) Check if it's a simple accumulation sum
+    auto storeValue = affineStoreOp.value();
+    Operation* currentOp = storeValue.getDefiningOp();
+    auto currentBinOp = dyn_cast_or_null<v::BinOp>(currentOp);
+    if (!currentBinOp)
+    {
+        // Not a simple accumulation sum if the last operation wasn't a binary op
+        return failure();
+    }
+    if (currentBinOp.predicate() != v::BinaryOpPredicate::ADD)
+    {
+        // Not a simple accumulation sum if the last operation wasn't an add
+        return failure();
+    }
+    // Check if either the lhs or the rhs defining op is an AffineLoadOp from the same location as the store
+    auto lhsOp = currentBinOp.lhs().getDefiningOp();
+    auto rhsOp = currentBinOp.rhs().getDefiningOp();
+    auto lhsLoadOp = dyn_cast_or_null<mlir::AffineLoadOp>(lhsOp);
+    auto rhsLoadOp = dyn_cast_or_null<mlir::AffineLoadOp>(rhsOp);
+    if (!lhsLoadOp && !rhsLoadOp)
+    {
+        // Neither are load ops so it's not a simple accumulate
+        return failure();
     }
     auto simpleAccumulateLoadOp = lhsLoadOp ? lhsLoadOp : rhsLoadOp;
     mlir::AffineStoreOpAdaptor storeAdaptor{ affineStoreOp };
@@ -6303,7 +8850,7 @@ LogicalResult OutOfBoundsLoadRewriteCommon(mlir::AffineLoadOp affineLoadOp, Patt
     auto loc = affineLoadOp.getLoc();
     mlir::AffineLoadOp::Adaptor adaptor{ affineLoadOp };
 
-    if (HasOutOfBoundsAccess(affineLoadOp, loc))
+    if (NeedsBoundsCheck(affineLoadOp, loc))
     {
         // This load has a potential out-of-bounds access, so replace it with a conditional load
 
@@ -6419,7 +8966,7 @@ LogicalResult OutOfBoundsStoreRewriteCommon(mlir::AffineStoreOp affineStoreOp, P
     auto loc = affineStoreOp.getLoc();
     mlir::AffineStoreOp::Adaptor adaptor{ affineStoreOp };
 
-    if (HasOutOfBoundsAccess(affineStoreOp, loc))
+    if (NeedsBoundsCheck(affineStoreOp, loc))
     {
         // This store has a potential out-of-bounds access, so replace it with a conditional store
 
@@ -6491,6 +9038,149 @@ LogicalResult OutOfBoundsAffineStoreRewrite::matchAndRewrite(mlir::AffineStoreOp
     return OutOfBoundsStoreRewriteCommon(affineStoreOp, rewriter);
 }
 
+// Returns whether an affine expression is linear in a dim or symbol of it, and so takes its extreme values over a
+// range of that dim or symbol at the ends of the range
+bool IsLinearIn(mlir::AffineExpr expr, mlir::AffineExpr var)
+{
+    bool involvesVar = false;
+    expr.walk([&](mlir::AffineExpr subExpr) { involvesVar |= subExpr == var; });
+    if (!involvesVar || expr == var)
+    {
+        return true;
+    }
+    auto binaryExpr = expr.cast<mlir::AffineBinaryOpExpr>();
+    switch (expr.getKind())
+    {
+    case mlir::AffineExprKind::Add:
+    case mlir::AffineExprKind::Mul: // the other side doesn't involve var in pure affine expressions
+        return IsLinearIn(binaryExpr.getLHS(), var) && IsLinearIn(binaryExpr.getRHS(), var);
+    default:
+        return false;
+    }
+}
+
+// Versions an innermost loop whose accesses need bounds checks into a guard-free loop, which runs when every
+// access is in bounds at the first and the last iteration of the loop, and the original loop, whose accesses get
+// guarded. The indices of the accesses must be linear in the induction variable, so that an access that is in bounds
+// at both ends of the loop is in bounds throughout it, and must otherwise only depend on values from outside the
+// loop, so that the condition is evaluated once before the loop instead of once per iteration.
+void VersionOutOfBoundsLoop(mlir::AffineForOp loop)
+{
+    if (loop->getAttr(OutOfBoundsVersionedAttrName) || loop.getNumIterOperands() != 0 ||
+        loop.getLowerBoundMap().getNumResults() != 1 || loop.getUpperBoundMap().getNumResults() != 1)
+    {
+        return;
+    }
+
+    auto loc = loop.getLoc();
+    auto iv = loop.getInductionVar();
+    OpBuilder builder(loop);
+
+    // The operands of the condition are the values from outside the loop that the bounds and the accesses use
+    SmallVector<mlir::Value, 4> conditionOperands;
+    bool versionable = true;
+    auto remapExpr = [&](mlir::AffineExpr expr, unsigned numDims, ValueRange exprOperands, mlir::AffineExpr ivReplacement) {
+        SmallVector<mlir::AffineExpr, 4> replacements;
+        for (auto operand : exprOperands)
+        {
+            if (operand == iv)
+            {
+                replacements.push_back(ivReplacement);
+                continue;
+            }
+            if (loop->isAncestor(operand.getParentRegion()->getParentOp()) || !mlir::isValidDim(operand))
+            {
+                versionable = false;
+            }
+            auto it = llvm::find(conditionOperands, operand);
+            if (it == conditionOperands.end())
+            {
+                it = conditionOperands.insert(conditionOperands.end(), operand);
+            }
+            replacements.push_back(builder.getAffineDimExpr(std::distance(conditionOperands.begin(), it)));
+        }
+        return expr.replaceDimsAndSymbols(llvm::makeArrayRef(replacements).take_front(numDims), llvm::makeArrayRef(replacements).drop_front(numDims));
+    };
+
+    auto lbMap = loop.getLowerBoundMap();
+    auto ubMap = loop.getUpperBoundMap();
+    auto firstIndex = remapExpr(lbMap.getResult(0), lbMap.getNumDims(), loop.getLowerBoundOperands(), {});
+    auto lastIndex = remapExpr(ubMap.getResult(0), ubMap.getNumDims(), loop.getUpperBoundOperands(), {}) - 1;
+
+    std::vector<mlir::AffineExpr> constraintExprs;
+    loop.getBody()->walk([&](Operation* op) {
+        if (IsBoundsChecked(op))
+        {
+            return;
+        }
+        if (isa<mlir::memref::LoadOp, mlir::memref::StoreOp>(op))
+        {
+            // these accesses are only checked once they are affine, they may stay guarded in either loop
+            versionable = false;
+            return;
+        }
+
+        mlir::AffineMap accessMap;
+        mlir::MemRefType memRefType;
+        SmallVector<mlir::Value, 4> accessOperands;
+        if (auto loadOp = dyn_cast<mlir::AffineLoadOp>(op); loadOp && NeedsBoundsCheck(loadOp, loc))
+        {
+            accessMap = loadOp.getAffineMap();
+            memRefType = loadOp.getMemRefType();
+            accessOperands.append(loadOp.getMapOperands().begin(), loadOp.getMapOperands().end());
+        }
+        else if (auto storeOp = dyn_cast<mlir::AffineStoreOp>(op); storeOp && NeedsBoundsCheck(storeOp, loc))
+        {
+            accessMap = storeOp.getAffineMap();
+            memRefType = storeOp.getMemRefType();
+            accessOperands.append(storeOp.getMapOperands().begin(), storeOp.getMapOperands().end());
+        }
+        else
+        {
+            return;
+        }
+
+        auto ivPos = std::distance(accessOperands.begin(), llvm::find(accessOperands, iv));
+        auto ivExpr = ivPos < (int64_t)accessMap.getNumDims() ? builder.getAffineDimExpr(ivPos) : builder.getAffineSymbolExpr(ivPos - accessMap.getNumDims());
+        for (unsigned dim = 0; dim < accessMap.getNumResults(); ++dim)
+        {
+            auto indexExpr = accessMap.getResult(dim);
+            if (!IsLinearIn(indexExpr, ivExpr))
+            {
+                versionable = false;
+                return;
+            }
+            for (auto endIndex : { firstIndex, lastIndex })
+            {
+                auto endExpr = remapExpr(indexExpr, accessMap.getNumDims(), accessOperands, endIndex);
+                constraintExprs.push_back(endExpr); // endExpr >= 0
+                constraintExprs.push_back(memRefType.getDimSize(dim) - 1 - endExpr); // endExpr <= dimSize - 1
+            }
+        }
+    });
+
+    if (!versionable || constraintExprs.empty())
+    {
+        return;
+    }
+
+    SmallVector<bool, 4> constraintEqFlags(constraintExprs.size(), false);
+    auto inBoundsSet = mlir::IntegerSet::get(conditionOperands.size(), 0, constraintExprs, constraintEqFlags);
+    auto ifOp = builder.create<mlir::AffineIfOp>(loc, inBoundsSet, ValueRange{ conditionOperands }, true); // true indicating we want an "else" region
+
+    auto thenBuilder = ifOp.getThenBodyBuilder();
+    auto guardFreeLoop = thenBuilder.clone(*loop.getOperation());
+    guardFreeLoop->walk([&](Operation* op) {
+        if (isa<mlir::AffineLoadOp, mlir::AffineStoreOp>(op))
+        {
+            SetBoundsChecked(thenBuilder, op);
+        }
+    });
+
+    loop->moveBefore(ifOp.getElseBlock()->getTerminator());
+    loop->setAttr(OutOfBoundsVersionedAttrName, builder.getUnitAttr());
+}
+
 template <typename OpType>
 LogicalResult ConvertStoreToAffine(PatternRewriter& rewriter, OpType op)
 {
@@ -6532,43 +9222,833 @@ LogicalResult ConvertValueStoresToAffineRewrite::matchAndRewrite(v::StoreOp stor
     return ConvertStoreToAffine(rewriter, storeOp);
 }
 
-LogicalResult DelayedMappingRegionOpRewrite::matchAndRewrite(DelayedMappingRegionOp mappingRegionOp, PatternRewriter& rewriter) const
+// The stores of loops marked for non-temporal stores are tagged only once the loops are about to be lowered, as
+// affine and vector rewrites before then recreate the store ops and would drop the tag. Tagged stores are lowered
+// to LLVM stores with the nontemporal flag by the ValueToLLVM pass
+bool IsUntaggedNonTemporalStore(mlir::Operation* storeOp)
 {
-    auto fromValue = mappingRegionOp.from();
-    auto toValue = mappingRegionOp.to();
-    mappingRegionOp.region().walk([&](mlir::Operation* op) {
-        op->replaceUsesOfWith(fromValue, toValue);
-    });
-    util::InlineAllRegionOpsBeforeOp(rewriter, mappingRegionOp.region(), mappingRegionOp);
-    rewriter.eraseOp(mappingRegionOp);
-    return success();
+    return !storeOp->hasAttr(NonTemporalAttrName) && AncestorOpContainsAttrOfName(storeOp, NonTemporalStoresAttrName);
 }
 
-// Returns the second loop, which goes from [n, end), and changes the given loop to go from [begin, n)
-mlir::AffineForOp SegmentLoopAtIteration(mlir::AffineForOp forOp, int64_t n)
+LogicalResult NonTemporalStoreRewrite::matchAndRewrite(mlir::memref::StoreOp storeOp, PatternRewriter& rewriter) const
 {
-    // To segment the loop into two loops at the n'th iteration
-    // 1) Compute the loop IV value at the n'th iteration
-    // 2) Clone the loop
-    // 3) Update the original loop's end value to be the n'th iteration value
-    // 4) Update the cloned loop's begin value to be the n'th iteration value
-
-    // Position a builder in the block containing this forOp just after the loop
-    auto iter = forOp->getIterator();
-    iter++;
-    auto loopParentBlock = forOp->getBlock();
-    mlir::OpBuilder builder(loopParentBlock, iter);
-
-    auto constantTripCountOpt = mlir::getConstantTripCount(forOp);
-
-    assert(constantTripCountOpt.hasValue() && "AffineForOps in Accera loop nests must have constant trip counts");
-    auto constantTripCount = constantTripCountOpt.getValue();
-    if (constantTripCount < n)
+    if (!IsUntaggedNonTemporalStore(storeOp))
     {
-        // Can't unswitch more iterations than this loop has, so don't bother unswitching
-        return nullptr;
+        return failure();
     }
-
+    rewriter.updateRootInPlace(storeOp, [&] { storeOp->setAttr(NonTemporalAttrName, rewriter.getUnitAttr()); });
+    return success();
+}
+
+LogicalResult NonTemporalAffineStoreRewrite::matchAndRewrite(mlir::AffineStoreOp affineStoreOp, PatternRewriter& rewriter) const
+{
+    if (!IsUntaggedNonTemporalStore(affineStoreOp))
+    {
+        return failure();
+    }
+
+    // Resolve the affine map here, since the affine lowering would create an untagged memref store
+    mlir::AffineStoreOp::Adaptor adaptor{ affineStoreOp };
+    auto indices = mlir::expandAffineMap(rewriter, affineStoreOp.getLoc(), affineStoreOp.getAffineMap(), adaptor.indices());
+    if (!indices)
+    {
+        return failure();
+    }
+    auto storeOp = rewriter.create<mlir::memref::StoreOp>(affineStoreOp.getLoc(), adaptor.value(), adaptor.memref(), *indices);
+    storeOp->setAttr(NonTemporalAttrName, rewriter.getUnitAttr());
+    rewriter.eraseOp(affineStoreOp);
+    return success();
+}
+
+LogicalResult NonTemporalTransferWriteRewrite::matchAndRewrite(mlir::vector::TransferWriteOp transferWriteOp, PatternRewriter& rewriter) const
+{
+    if (!IsUntaggedNonTemporalStore(transferWriteOp))
+    {
+        return failure();
+    }
+
+    // Only contiguous, unmasked writes of a 1-D vector map onto a single vector store
+    auto vectorType = transferWriteOp.getVectorType();
+    if (vectorType.getRank() != 1 || transferWriteOp.mask() || !transferWriteOp.isDimInBounds(0) ||
+        !transferWriteOp.permutation_map().isMinorIdentity() || !transferWriteOp.source().getType().isa<mlir::MemRefType>())
+    {
+        return failure();
+    }
+    auto storeOp = rewriter.create<mlir::vector::StoreOp>(transferWriteOp.getLoc(), transferWriteOp.vector(), transferWriteOp.source(), transferWriteOp.indices());
+    storeOp->setAttr(NonTemporalAttrName, rewriter.getUnitAttr());
+    rewriter.eraseOp(transferWriteOp);
+    return success();
+}
+
+// The load and store of a reduction accumulator, e.g. C[i, j] in a loop over k, that a loop keeps in an iteration
+// argument instead of memory
+struct AccumulatorAccess
+{
+    mlir::Operation* loadOp;
+    mlir::Operation* storeOp;
+};
+
+// Whether a load and a store access the same element, or the same vector of elements, at an address that doesn't
+// change with the iterations of a loop
+bool IsLoopInvariantAccessPair(mlir::AffineForOp forOp, mlir::Operation* loadOp, mlir::Operation* storeOp)
+{
+    auto isDefinedOutside = [&](mlir::Value value) { return forOp.isDefinedOutsideOfLoop(value); };
+    if (auto affineLoadOp = mlir::dyn_cast<mlir::AffineLoadOp>(loadOp))
+    {
+        auto affineStoreOp = mlir::dyn_cast<mlir::AffineStoreOp>(storeOp);
+        return affineStoreOp && affineLoadOp.getMemRef() == affineStoreOp.getMemRef() &&
+               llvm::all_of(affineLoadOp.getMapOperands(), isDefinedOutside) &&
+               mlir::MemRefAccess(affineLoadOp) == mlir::MemRefAccess(affineStoreOp);
+    }
+    if (auto readOp = mlir::dyn_cast<mlir::vector::TransferReadOp>(loadOp))
+    {
+        auto writeOp = mlir::dyn_cast<mlir::vector::TransferWriteOp>(storeOp);
+        return writeOp && !readOp.mask() && !writeOp.mask() && readOp.source() == writeOp.source() &&
+               readOp.getVectorType() == writeOp.getVectorType() && readOp.permutation_map() == writeOp.permutation_map() &&
+               readOp.in_bounds() == writeOp.in_bounds() && llvm::equal(readOp.indices(), writeOp.indices()) &&
+               isDefinedOutside(readOp.source()) && isDefinedOutside(readOp.padding()) && llvm::all_of(readOp.indices(), isDefinedOutside);
+    }
+    return false;
+}
+
+mlir::Value GetAccessedMemRef(mlir::Operation* op)
+{
+    return TypeSwitch<mlir::Operation*, mlir::Value>(op)
+        .Case([](mlir::AffineLoadOp loadOp) { return loadOp.getMemRef(); })
+        .Case([](mlir::AffineStoreOp storeOp) { return storeOp.getMemRef(); })
+        .Case([](mlir::vector::TransferReadOp readOp) { return readOp.source(); })
+        .Case([](mlir::vector::TransferWriteOp writeOp) { return writeOp.source(); })
+        .Default([](mlir::Operation*) { return mlir::Value{}; });
+}
+
+// The array that a memref is a view of, looking through the ops that derive a memref from another one, e.g. subviews
+// and the views of the Value dialect
+mlir::Value GetRootMemRef(mlir::Value memref)
+{
+    while (auto op = memref.getDefiningOp())
+    {
+        auto sourceIt = llvm::find_if(op->getOperands(), [](mlir::Value operand) { return operand.getType().isa<mlir::MemRefType, mlir::UnrankedMemRefType>(); });
+        if (sourceIt == op->operand_end())
+        {
+            break;
+        }
+        memref = *sourceIt;
+    }
+    return memref;
+}
+
+// Whether the only ops of a loop that touch an array are the given load and store. The other ops may only access
+// other arrays, any op whose effects are unknown, e.g. a barrier or a call, could access the array behind the loop's
+// back
+bool IsOnlyAccessedBy(mlir::AffineForOp forOp, mlir::Value memref, const AccumulatorAccess& access)
+{
+    auto rootMemRef = GetRootMemRef(memref);
+    auto result = forOp.getBody()->walk([&](mlir::Operation* op) {
+        if (op == access.loadOp || op == access.storeOp)
+        {
+            return WalkResult::advance();
+        }
+        if (llvm::is_contained(op->getOperands(), memref))
+        {
+            return WalkResult::interrupt();
+        }
+        if (op->getNumRegions() != 0)
+        {
+            return WalkResult::advance();
+        }
+        auto effectsOp = dyn_cast<MemoryEffectOpInterface>(op);
+        if (!effectsOp)
+        {
+            return WalkResult::interrupt();
+        }
+        SmallVector<MemoryEffects::EffectInstance, 4> effects;
+        effectsOp.getEffects(effects);
+        auto mayAccessArray = llvm::any_of(effects, [&](const MemoryEffects::EffectInstance& effect) {
+            if (isa<MemoryEffects::Allocate>(effect.getEffect()))
+            {
+                return false;
+            }
+            return !effect.getValue() || GetRootMemRef(effect.getValue()) == rootMemRef;
+        });
+        return mayAccessArray ? WalkResult::interrupt() : WalkResult::advance();
+    });
+    return !result.wasInterrupted();
+}
+
+// Keeps the accumulators of a loop that each iteration loads, updates and stores back at the same address in iteration
+// arguments of the loop, i.e. in registers: the accumulators are loaded once before the loop and stored once after it.
+// This is the register blocking of a GEMM-like kernel without an output cache placed at the reduction loop, e.g. the
+// unrolled C[i, j] accumulators of an innermost loop over k.
+bool PromoteLoopAccumulators(mlir::AffineForOp forOp)
+{
+    // Hoisting the loads and stores out of a loop that doesn't run would access memory that the loop never accesses.
+    // GPU-mapped loops run their iterations concurrently
+    auto tripCount = mlir::getConstantTripCount(forOp);
+    if (!tripCount || *tripCount == 0 || forOp->getAttr("accv_gpu_map") || HasParallelizationInfo(forOp))
+    {
+        return false;
+    }
+
+    auto body = forOp.getBody();
+    std::vector<AccumulatorAccess> accesses;
+    for (auto& op : body->without_terminator())
+    {
+        if (!mlir::isa<mlir::AffineLoadOp, mlir::vector::TransferReadOp>(op))
+        {
+            continue;
+        }
+        auto memref = GetAccessedMemRef(&op);
+        auto storeIt = llvm::find_if(llvm::make_range(std::next(op.getIterator()), body->end()), [&](mlir::Operation& storeOp) {
+            return mlir::isa<mlir::AffineStoreOp, mlir::vector::TransferWriteOp>(storeOp) && GetAccessedMemRef(&storeOp) == memref;
+        });
+        if (storeIt == body->end() || !IsLoopInvariantAccessPair(forOp, &op, &*storeIt))
+        {
+            continue;
+        }
+        AccumulatorAccess access{ &op, &*storeIt };
+        if (IsOnlyAccessedBy(forOp, memref, access))
+        {
+            accesses.push_back(access);
+        }
+    }
+    if (accesses.empty())
+    {
+        return false;
+    }
+
+    // The accumulators are loaded before the loop, carried through its iterations and stored after it
+    mlir::OpBuilder builder(forOp);
+    SmallVector<mlir::Value, 4> iterOperands(forOp.getIterOperands());
+    for (auto& access : accesses)
+    {
+        iterOperands.push_back(builder.clone(*access.loadOp)->getResult(0));
+    }
+    auto newForOp = builder.create<mlir::AffineForOp>(forOp.getLoc(), forOp.getLowerBoundOperands(), forOp.getLowerBoundMap(), forOp.getUpperBoundOperands(), forOp.getUpperBoundMap(), forOp.getStep(), iterOperands);
+    newForOp->setAttrs(forOp->getAttrs());
+    newForOp.getLoopBody().takeBody(forOp.getLoopBody());
+    for (auto [originalResult, newResult] : llvm::zip(forOp.getResults(), newForOp.getResults()))
+    {
+        originalResult.replaceAllUsesWith(newResult);
+    }
+    forOp.erase();
+
+    auto yieldOp = mlir::cast<mlir::AffineYieldOp>(body->getTerminator());
+    SmallVector<mlir::Value, 4> yieldOperands(yieldOp.getOperands());
+    builder.setInsertionPointAfter(newForOp);
+    for (auto en : llvm::enumerate(accesses))
+    {
+        auto& access = en.value();
+        auto iterArg = body->addArgument(access.loadOp->getResult(0).getType());
+        access.loadOp->getResult(0).replaceAllUsesWith(iterArg);
+        access.loadOp->erase();
+
+        auto storedValue = access.storeOp->getOperand(0);
+        yieldOperands.push_back(storedValue);
+        BlockAndValueMapping mapping;
+        mapping.map(storedValue, newForOp.getResult(newForOp.getNumResults() - accesses.size() + en.index()));
+        builder.clone(*access.storeOp, mapping);
+        access.storeOp->erase();
+    }
+    yieldOp->setOperands(yieldOperands);
+    return true;
+}
+
+// An access of an array at an affine function of the loop indices, with the number of consecutive elements of the
+// innermost dimension that it covers, which is the size of the vector of a vector access
+struct AffineArrayAccess
+{
+    mlir::Value memref;
+    mlir::AffineMap map;
+    SmallVector<mlir::Value, 4> operands;
+    int64_t vectorSize = 1;
+    bool isWrite = false;
+};
+
+std::optional<AffineArrayAccess> GetAffineArrayAccess(mlir::Operation* op)
+{
+    AffineArrayAccess access;
+    auto setIndices = [&](mlir::Value memref, mlir::ValueRange indices) {
+        access.memref = memref;
+        access.map = mlir::AffineMap::getMultiDimIdentityMap(indices.size(), op->getContext());
+        access.operands.assign(indices.begin(), indices.end());
+    };
+    auto setVectorSize = [&](mlir::VectorType vectorType) {
+        access.vectorSize = vectorType.getRank() == 1 ? vectorType.getNumElements() : 0;
+    };
+    auto isContiguousTransfer = [](auto transferOp) {
+        return transferOp.getVectorType().getRank() == 1 && !transferOp.mask() && transferOp.isDimInBounds(0) &&
+               transferOp.permutation_map().isMinorIdentity() && transferOp.source().getType().template isa<mlir::MemRefType>();
+    };
+
+    auto isAccess = TypeSwitch<mlir::Operation*, bool>(op)
+                        .Case<mlir::AffineLoadOp, mlir::AffineStoreOp>([&](auto affineOp) {
+                            access.memref = affineOp.getMemRef();
+                            access.map = affineOp.getAffineMap();
+                            access.operands.assign(affineOp.getMapOperands().begin(), affineOp.getMapOperands().end());
+                            return true;
+                        })
+                        .Case<mlir::AffineVectorLoadOp, mlir::AffineVectorStoreOp>([&](auto affineOp) {
+                            access.memref = affineOp.getMemRef();
+                            access.map = affineOp.getAffineMap();
+                            access.operands.assign(affineOp.getMapOperands().begin(), affineOp.getMapOperands().end());
+                            setVectorSize(affineOp.getVectorType());
+                            return true;
+                        })
+                        .Case<mlir::memref::LoadOp, mlir::memref::StoreOp>([&](auto memrefOp) {
+                            setIndices(memrefOp.getMemRef(), memrefOp.getIndices());
+                            return true;
+                        })
+                        .Case<mlir::vector::TransferReadOp, mlir::vector::TransferWriteOp>([&](auto transferOp) {
+                            if (!isContiguousTransfer(transferOp))
+                            {
+                                return false;
+                            }
+                            setIndices(transferOp.source(), transferOp.indices());
+                            setVectorSize(transferOp.getVectorType());
+                            return true;
+                        })
+                        .Default([](mlir::Operation*) { return false; });
+    if (!isAccess || access.vectorSize == 0)
+    {
+        return std::nullopt;
+    }
+
+    access.isWrite = mlir::isa<mlir::AffineStoreOp, mlir::AffineVectorStoreOp, mlir::memref::StoreOp, mlir::vector::TransferWriteOp>(op);
+    mlir::fullyComposeAffineMapAndOperands(&access.map, &access.operands);
+    mlir::canonicalizeMapAndOperands(&access.map, &access.operands);
+    return access;
+}
+
+bool IsSameAccess(const AffineArrayAccess& lhs, const AffineArrayAccess& rhs)
+{
+    return lhs.memref == rhs.memref && lhs.map == rhs.map && lhs.operands == rhs.operands && lhs.vectorSize == rhs.vectorSize;
+}
+
+// The addends of a sum, e.g. d0 * 4, d1 and 2 for d0 * 4 + d1 + 2
+void CollectAffineAddends(mlir::AffineExpr expr, SmallVectorImpl<mlir::AffineExpr>& addends)
+{
+    if (expr.getKind() == mlir::AffineExprKind::Add)
+    {
+        auto sumExpr = expr.cast<mlir::AffineBinaryOpExpr>();
+        CollectAffineAddends(sumExpr.getLHS(), addends);
+        CollectAffineAddends(sumExpr.getRHS(), addends);
+    }
+    else
+    {
+        addends.push_back(expr);
+    }
+}
+
+// Whether a group of accesses in the same block touches each element of its array exactly once over the iterations of
+// the loops around the block, up to and including the given loop. For example, the C[i * 8 + ii, j] and
+// C[i * 8 + ii, j + 1] accesses of an unrolled loop over j cover a 32x8 array over loops over i, ii and j with 4, 8
+// and 4 iterations. Each loop has to advance the accesses, and the loop indices, the vector elements and the offsets
+// between the accesses of each dimension have to tile it like the digits of a number.
+bool AccessesEachElementOnce(mlir::Operation* op, ArrayRef<AffineArrayAccess> accesses, mlir::AffineForOp outermostLoop)
+{
+    auto memRefType = accesses.front().memref.getType().cast<mlir::MemRefType>();
+    if (!memRefType.hasStaticShape())
+    {
+        return false;
+    }
+    auto shape = memRefType.getShape();
+    const auto& base = accesses.front();
+
+    // The strides and counts of the terms that index each dimension
+    std::vector<std::vector<std::pair<int64_t, int64_t>>> dimTerms(shape.size());
+    if (base.vectorSize > 1)
+    {
+        dimTerms.back().push_back({ 1, base.vectorSize });
+    }
+
+    // The offsets of the accesses from each other
+    std::vector<std::set<int64_t>> dimOffsets(shape.size());
+    std::set<std::vector<int64_t>> offsets;
+    for (const auto& access : accesses)
+    {
+        if (access.operands != base.operands || access.vectorSize != base.vectorSize)
+        {
+            return false;
+        }
+        std::vector<int64_t> offset;
+        for (unsigned dim = 0; dim < base.map.getNumResults(); ++dim)
+        {
+            auto difference = mlir::simplifyAffineExpr(access.map.getResult(dim) - base.map.getResult(dim), base.map.getNumDims(), base.map.getNumSymbols()).dyn_cast<mlir::AffineConstantExpr>();
+            if (!difference)
+            {
+                return false;
+            }
+            offset.push_back(difference.getValue());
+            dimOffsets[dim].insert(difference.getValue());
+        }
+        offsets.insert(offset);
+    }
+    size_t numOffsetCombinations = 1;
+    for (size_t dim = 0; dim < dimOffsets.size(); ++dim)
+    {
+        const auto& values = dimOffsets[dim];
+        numOffsetCombinations *= values.size();
+        if (values.size() > 1)
+        {
+            auto first = *values.begin();
+            auto stride = *std::next(values.begin()) - first;
+            int64_t index = 0;
+            for (auto value : values)
+            {
+                if (value != first + index++ * stride)
+                {
+                    return false;
+                }
+            }
+            dimTerms[dim].push_back({ stride, static_cast<int64_t>(values.size()) });
+        }
+    }
+    if (offsets.size() != accesses.size() || offsets.size() != numOffsetCombinations)
+    {
+        return false;
+    }
+
+    // The accesses have to run in every iteration of the loops, without conditions
+    std::vector<mlir::AffineForOp> loops;
+    for (auto parentOp = op->getParentOp();; parentOp = parentOp->getParentOp())
+    {
+        auto loop = mlir::dyn_cast<mlir::AffineForOp>(parentOp);
+        if (!loop || !loop.hasConstantBounds() || loop->getAttr("accv_gpu_map"))
+        {
+            return false;
+        }
+        loops.push_back(loop);
+        if (loop == outermostLoop)
+        {
+            break;
+        }
+    }
+
+    std::vector<bool> loopUsed(loops.size(), false);
+    auto numDims = base.map.getNumDims();
+    for (unsigned dim = 0; dim < base.map.getNumResults(); ++dim)
+    {
+        SmallVector<mlir::AffineExpr, 4> addends;
+        CollectAffineAddends(base.map.getResult(dim), addends);
+        for (auto addend : addends)
+        {
+            if (addend.isa<mlir::AffineConstantExpr>())
+            {
+                continue;
+            }
+            int64_t coefficient = 1;
+            auto indexExpr = addend;
+            if (auto productExpr = addend.dyn_cast<mlir::AffineBinaryOpExpr>(); productExpr && addend.getKind() == mlir::AffineExprKind::Mul)
+            {
+                auto constantExpr = productExpr.getRHS().dyn_cast<mlir::AffineConstantExpr>();
+                if (!constantExpr)
+                {
+                    return false;
+                }
+                coefficient = constantExpr.getValue();
+                indexExpr = productExpr.getLHS();
+            }
+
+            mlir::Value operand;
+            if (auto dimExpr = indexExpr.dyn_cast<mlir::AffineDimExpr>())
+            {
+                operand = base.operands[dimExpr.getPosition()];
+            }
+            else if (auto symbolExpr = indexExpr.dyn_cast<mlir::AffineSymbolExpr>())
+            {
+                operand = base.operands[numDims + symbolExpr.getPosition()];
+            }
+            else
+            {
+                return false;
+            }
+
+            // The values defined outside of the loops offset all the accesses alike
+            if (outermostLoop.isDefinedOutsideOfLoop(operand))
+            {
+                continue;
+            }
+            auto loopIt = llvm::find_if(loops, [&](mlir::AffineForOp loop) { return loop.getInductionVar() == operand; });
+            if (loopIt == loops.end() || loopUsed[loopIt - loops.begin()])
+            {
+                return false;
+            }
+            loopUsed[loopIt - loops.begin()] = true;
+            auto tripCount = static_cast<int64_t>(mlir::getConstantTripCount(*loopIt).getValueOr(0));
+            dimTerms[dim].push_back({ std::abs(coefficient * loopIt->getStep()), tripCount });
+        }
+    }
+    for (size_t index = 0; index < loops.size(); ++index)
+    {
+        if (!loopUsed[index] && mlir::getConstantTripCount(loops[index]).getValueOr(0) != 1)
+        {
+            return false;
+        }
+    }
+
+    for (size_t dim = 0; dim < dimTerms.size(); ++dim)
+    {
+        auto& terms = dimTerms[dim];
+        std::sort(terms.begin(), terms.end());
+        int64_t expectedStride = 1;
+        for (auto [stride, count] : terms)
+        {
+            if (stride != expectedStride)
+            {
+                return false;
+            }
+            expectedStride *= count;
+        }
+        if (expectedStride != shape[dim])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The array that a loop nest fills, e.g. with the zeros of a CacheZeroOp or the data of a cache copy, if the nest writes
+// to a single buffer allocated by the function and doesn't read it, with the value that it fills the array with if it
+// is a constant
+std::optional<std::pair<mlir::Value, mlir::Attribute>> GetFilledArray(mlir::AffineForOp fillLoop)
+{
+    mlir::Value array;
+    mlir::Attribute fillValue;
+    bool isConstantFill = true;
+    std::vector<mlir::Value> readArrays;
+    auto result = fillLoop.walk([&](mlir::Operation* op) {
+        if (op->getNumRegions() != 0)
+        {
+            return WalkResult::advance();
+        }
+        auto effectsOp = dyn_cast<MemoryEffectOpInterface>(op);
+        if (!effectsOp)
+        {
+            return WalkResult::interrupt();
+        }
+        SmallVector<MemoryEffects::EffectInstance, 4> effects;
+        effectsOp.getEffects(effects);
+        for (auto& effect : effects)
+        {
+            if (isa<MemoryEffects::Allocate>(effect.getEffect()))
+            {
+                continue;
+            }
+            if (!effect.getValue())
+            {
+                return WalkResult::interrupt();
+            }
+            if (!isa<MemoryEffects::Write>(effect.getEffect()))
+            {
+                readArrays.push_back(effect.getValue());
+                continue;
+            }
+            if (array && effect.getValue() != array)
+            {
+                return WalkResult::interrupt();
+            }
+            array = effect.getValue();
+
+            mlir::Attribute storedValue;
+            if (!GetAffineArrayAccess(op) || !mlir::matchPattern(op->getOperand(0), mlir::m_Constant(&storedValue)) || (fillValue && storedValue != fillValue))
+            {
+                isConstantFill = false;
+            }
+            fillValue = storedValue;
+        }
+        return WalkResult::advance();
+    });
+    if (result.wasInterrupted() || !array)
+    {
+        return std::nullopt;
+    }
+
+    // The fill is only dead if nothing outside of the function can see the array, and if only the thread that fills it
+    // accesses it
+    auto memorySpace = array.getType().cast<mlir::MemRefType>().getMemorySpaceAsInt();
+    if (!array.getDefiningOp<v::AllocOp>() || (memorySpace != static_cast<unsigned>(v::MemorySpace::None) && memorySpace != static_cast<unsigned>(v::MemorySpace::Private)))
+    {
+        return std::nullopt;
+    }
+
+    // The nest must not read the array it fills
+    if (llvm::any_of(readArrays, [&](mlir::Value readArray) { return GetRootMemRef(readArray) == array; }))
+    {
+        return std::nullopt;
+    }
+    return std::pair{ array, isConstantFill ? fillValue : mlir::Attribute{} };
+}
+
+// Removes the loop nest that fills a buffer, e.g. a cache, when the loop nest that comes after it overwrites every
+// element of the buffer before reading it, e.g. the output cache of a kernel that assigns to its output. When the
+// buffer is filled with a constant, e.g. the zeros of an output cache that the kernel accumulates into, and the next
+// nest reads each element once before its only write to it, as the accumulators that PromoteLoopAccumulators hoists out
+// of the reduction loop do, the reads are replaced with the constant, which makes the fill dead as well.
+bool EliminateRedundantFill(mlir::AffineForOp fillLoop)
+{
+    auto filledArray = GetFilledArray(fillLoop);
+    if (!filledArray)
+    {
+        return false;
+    }
+    auto [array, fillValue] = *filledArray;
+
+    // The next op that has memory effects has to be the loop nest that overwrites the buffer
+    auto nextOpIt = std::next(mlir::Block::iterator(fillLoop));
+    while (nextOpIt != fillLoop->getBlock()->end() && MemoryEffectOpInterface::hasNoEffect(&*nextOpIt))
+    {
+        ++nextOpIt;
+    }
+    auto loop = nextOpIt != fillLoop->getBlock()->end() ? mlir::dyn_cast<mlir::AffineForOp>(&*nextOpIt) : mlir::AffineForOp{};
+    if (!loop)
+    {
+        return false;
+    }
+
+    std::vector<std::pair<mlir::Operation*, AffineArrayAccess>> reads;
+    std::vector<std::pair<mlir::Operation*, AffineArrayAccess>> writes;
+    auto result = loop.walk([&](mlir::Operation* op) {
+        if (op->getNumRegions() != 0)
+        {
+            return WalkResult::advance();
+        }
+        auto effectsOp = dyn_cast<MemoryEffectOpInterface>(op);
+        if (!effectsOp)
+        {
+            return WalkResult::interrupt();
+        }
+        SmallVector<MemoryEffects::EffectInstance, 4> effects;
+        effectsOp.getEffects(effects);
+        auto mayAccessArray = llvm::any_of(effects, [&](const MemoryEffects::EffectInstance& effect) {
+            return !isa<MemoryEffects::Allocate>(effect.getEffect()) && (!effect.getValue() || GetRootMemRef(effect.getValue()) == array);
+        });
+        if (!mayAccessArray && !llvm::is_contained(op->getOperands(), array))
+        {
+            return WalkResult::advance();
+        }
+        auto access = GetAffineArrayAccess(op);
+        if (!access || access->memref != array)
+        {
+            return WalkResult::interrupt();
+        }
+        (access->isWrite ? writes : reads).push_back({ op, *access });
+        return WalkResult::advance();
+    });
+    if (result.wasInterrupted() || writes.empty())
+    {
+        return false;
+    }
+
+    auto block = writes.front().first->getBlock();
+    std::vector<AffineArrayAccess> writeAccesses;
+    for (auto& [writeOp, access] : writes)
+    {
+        if (writeOp->getBlock() != block)
+        {
+            return false;
+        }
+        writeAccesses.push_back(access);
+    }
+    if (!AccessesEachElementOnce(writes.front().first, writeAccesses, loop))
+    {
+        return false;
+    }
+
+    // Each read has to follow the write of the same element in the same iteration, in which case it reads what the
+    // write wrote, or precede it as the first access to the element if the fill is a constant
+    std::vector<mlir::Operation*> fillReads;
+    for (auto& [readOp, readAccess] : reads)
+    {
+        auto writeIt = llvm::find_if(writes, [&, &readAccess = readAccess](const auto& write) { return IsSameAccess(write.second, readAccess); });
+        if (readOp->getBlock() != block || writeIt == writes.end())
+        {
+            return false;
+        }
+        if (readOp->isBeforeInBlock(writeIt->first))
+        {
+            fillReads.push_back(readOp);
+        }
+    }
+    if (!fillReads.empty())
+    {
+        // Another read of the same element before the write would read the fill value too, but one read per element
+        // keeps the check simple
+        std::set<mlir::Operation*> precededWrites;
+        for (auto readOp : fillReads)
+        {
+            auto readAccess = GetAffineArrayAccess(readOp);
+            auto writeIt = llvm::find_if(writes, [&](const auto& write) { return IsSameAccess(write.second, *readAccess); });
+            if (!fillValue || !precededWrites.insert(writeIt->first).second)
+            {
+                return false;
+            }
+        }
+
+        for (auto readOp : fillReads)
+        {
+            mlir::OpBuilder builder(readOp);
+            auto resultType = readOp->getResult(0).getType();
+            mlir::Attribute constantValue = fillValue;
+            if (auto vectorType = resultType.dyn_cast<mlir::VectorType>())
+            {
+                constantValue = mlir::DenseElementsAttr::get(vectorType, fillValue);
+            }
+            auto constantOp = builder.create<mlir::ConstantOp>(readOp->getLoc(), resultType, constantValue);
+            readOp->getResult(0).replaceAllUsesWith(constantOp.getResult());
+            readOp->erase();
+        }
+    }
+
+    fillLoop.erase();
+    return true;
+}
+
+// Whether an op computes its results from its operands alone, so that it can move anywhere its operands are defined.
+// The ops on memrefs, e.g. the views and element reads of accv, are left in place: they depend on the contents of the
+// array at their position, and a cache region maps the array it caches to the cache within its bounds
+bool IsHoistableOp(mlir::Operation* op)
+{
+    if (op->getNumResults() == 0 || op->getNumRegions() != 0 || op->hasTrait<mlir::OpTrait::IsTerminator>())
+    {
+        return false;
+    }
+    auto isMemRef = [](mlir::Type type) { return type.isa<mlir::MemRefType, mlir::UnrankedMemRefType>(); };
+    if (llvm::any_of(op->getOperandTypes(), isMemRef) || llvm::any_of(op->getResultTypes(), isMemRef))
+    {
+        return false;
+    }
+    return MemoryEffectOpInterface::hasNoEffect(op);
+}
+
+// Whether an op divides integers by a value that isn't known to be non-zero, which can trap when it is moved out of a
+// loop that doesn't run
+bool MayTrap(mlir::Operation* op)
+{
+    mlir::Value divisor;
+    if (auto binOp = mlir::dyn_cast<v::BinOp>(op))
+    {
+        auto predicate = binOp.getPredicate();
+        if ((predicate == v::BinaryOpPredicate::DIV || predicate == v::BinaryOpPredicate::MOD) && !mlir::getElementTypeOrSelf(binOp.result().getType()).isa<mlir::FloatType>())
+        {
+            divisor = binOp.rhs();
+        }
+    }
+    else if (mlir::isa<mlir::SignedDivIOp, mlir::UnsignedDivIOp, mlir::SignedRemIOp, mlir::UnsignedRemIOp, mlir::SignedFloorDivIOp, mlir::SignedCeilDivIOp>(op))
+    {
+        divisor = op->getOperand(1);
+    }
+    if (!divisor)
+    {
+        return false;
+    }
+
+    mlir::Attribute divisorAttr;
+    if (!mlir::matchPattern(divisor, mlir::m_Constant(&divisorAttr)))
+    {
+        return true;
+    }
+    if (auto intAttr = divisorAttr.dyn_cast<mlir::IntegerAttr>())
+    {
+        return intAttr.getValue().isNullValue();
+    }
+    if (auto splatAttr = divisorAttr.dyn_cast<mlir::SplatElementsAttr>())
+    {
+        auto splatValue = splatAttr.getSplatValue().dyn_cast<mlir::IntegerAttr>();
+        return !splatValue || splatValue.getValue().isNullValue();
+    }
+    return true;
+}
+
+// Moves the ops of the body of a loop whose operands are all defined outside of it to before the loop, e.g. the scales
+// and offsets that the iteration logic computes from the indices of the outer loops. Returns whether an op moved
+bool HoistLoopInvariantOps(mlir::AffineForOp loop)
+{
+    auto tripCount = mlir::getConstantTripCount(loop);
+    bool runs = tripCount && *tripCount > 0;
+
+    bool changed = false;
+    for (auto& op : llvm::make_early_inc_range(loop.getBody()->without_terminator()))
+    {
+        // The ops that moved before are defined outside of the loop now, so their users can follow them
+        if (IsHoistableOp(&op) && (runs || !MayTrap(&op)) &&
+            llvm::all_of(op.getOperands(), [&](mlir::Value operand) { return loop.isDefinedOutsideOfLoop(operand); }))
+        {
+            op.moveBefore(loop);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+// The kind of data movement of a cache op, which names its profile region, or an empty string for the other ops
+std::string GetCacheCopyKind(mlir::Operation* op)
+{
+    return mlir::TypeSwitch<mlir::Operation*, std::string>(op)
+        .Case([](MultiCacheCopyOp copyOp) { return copyOp.toCache() ? "fill" : "write_back"; })
+        .Case([](ActiveBlockCacheCopyOp copyOp) { return copyOp.toCache() ? "fill" : "write_back"; })
+        .Case([](ActiveElementCacheCopyOp copyOp) { return copyOp.dst().getDefiningOp<MakeCacheOp>() ? "fill" : "write_back"; })
+        .Case<ActiveBlockCacheReduceOp, ActiveElementCacheReduceOp>([](mlir::Operation*) { return "reduce"; })
+        .Case([](CacheZeroOp) { return "zero"; })
+        .Default([](mlir::Operation*) { return ""; });
+}
+
+// Whether an op is between the enter and exit ops of a cache copy profile region, e.g. an op that was profiled before or
+// one of the copies that the lowering of a profiled multi-cache copy emits
+bool IsInCacheCopyProfileRegion(mlir::Operation* op)
+{
+    for (auto ancestor = op; ancestor && !isa<v::ValueFuncOp>(ancestor); ancestor = ancestor->getParentOp())
+    {
+        for (auto prevOp = ancestor->getPrevNode(); prevOp; prevOp = prevOp->getPrevNode())
+        {
+            if (prevOp->hasAttr(CacheCopyRegionAttrName))
+            {
+                if (isa<v::ExitProfileRegionOp>(prevOp))
+                {
+                    break;
+                }
+                return true;
+            }
+        }
+    }
+    return false;
+}
+DelayedMappingRegionOp mappingRegionOp, PatternRewriter& rewriter) const
+{
+    auto fromValue = mappingRegionOp.from();
+    auto toValue = mappingRegionOp.to();
+    mappingRegionOp.region().walk([&](mlir::Operation* op) {
+        op->replaceUsesOfWith(fromValue, toValue);
+    });
+    util::InlineAllRegionOpsBeforeOp(rewriter, mappingRegionOp.region(), mappingRegionOp);
+    rewriter.eraseOp(mappingRegionOp);
+    return success();
+}
+
+// Returns the second loop, which goes from [n, end), and changes the given loop to go from [begin, n)
+mlir::AffineForOp SegmentLoopAtIteration(mlir::AffineForOp forOp, int64_t n)
+{
+    // To segment the loop into two loops at the n'th iteration
+    // 1) Compute the loop IV value at the n'th iteration
+    // 2) Clone the loop
+    // 3) Update the original loop's end value to be the n'th iteration value
+    // 4) Update the cloned loop's begin value to be the n'th iteration value
+
+    // Position a builder in the block containing this forOp just after the loop
+    auto iter = forOp->getIterator();
+    iter++;
+    auto loopParentBlock = forOp->getBlock();
+    mlir::OpBuilder builder(loopParentBlock, iter);
+
+    auto constantTripCountOpt = mlir::getConstantTripCount(forOp);
+
+    assert(constantTripCountOpt.hasValue() && "AffineForOps in Accera loop nests must have constant trip counts");
+    auto constantTripCount = constantTripCountOpt.getValue();
+    if (constantTripCount < n)
+    {
+        // Can't unswitch more iterations than this loop has, so don't bother unswitching
+        return nullptr;
+    }
+
     assert(forOp.hasConstantBounds() && "Only constant-bounded AffineForOps are supported for unswitching");
 
     auto nthIterValue = forOp.getConstantLowerBound() + (forOp.getStep() * n);
@@ -6580,8 +10060,177 @@ mlir::AffineForOp SegmentLoopAtIteration(mlir::AffineForOp forOp, int64_t n)
     return segmentedSecondLoop;
 }
 
+// Returns the values of a loop's induction variable at which the outcome of a condition nested in the loop may change.
+// Each constraint of the condition must be linear in the induction variable, the rest of it taking any value in its
+// range: between the returned values the condition is either true or false for all of those values.
+std::vector<int64_t> GetConditionChangePoints(mlir::AffineForOp forOp, mlir::AffineIfOp ifOp, accera::transforms::value::RangeValueAnalysis& ranges)
+{
+    std::vector<int64_t> changePoints;
+    auto set = ifOp.getIntegerSet();
+    auto operands = ifOp.getOperands();
+    auto ivPos = llvm::find(operands, forOp.getInductionVar());
+    if (ivPos == operands.end() || std::count(operands.begin(), operands.end(), forOp.getInductionVar()) != 1)
+    {
+        return changePoints;
+    }
+    auto pos = static_cast<unsigned>(std::distance(operands.begin(), ivPos));
+    auto ivExpr = pos < set.getNumDims() ? getAffineDimExpr(pos, set.getContext()) : getAffineSymbolExpr(pos - set.getNumDims(), set.getContext());
+
+    for (unsigned i = 0; i < set.getNumConstraints(); ++i)
+    {
+        auto constraint = set.getConstraint(i);
+        if (!IsLinearIn(constraint, ivExpr))
+        {
+            continue;
+        }
+
+        // constraint == coefficient * iv + rest
+        auto rest = simplifyAffineExpr(constraint.replace(ivExpr, getAffineConstantExpr(0, set.getContext())), set.getNumDims(), set.getNumSymbols());
+        auto coefficientExpr = simplifyAffineExpr(constraint.replace(ivExpr, getAffineConstantExpr(1, set.getContext())) - rest, set.getNumDims(), set.getNumSymbols()).dyn_cast<AffineConstantExpr>();
+        if (!coefficientExpr || coefficientExpr.getValue() == 0)
+        {
+            continue;
+        }
+        auto coefficient = coefficientExpr.getValue();
+
+        auto restRange = ranges.resolveRange(rest, operands, set.getNumDims());
+        if (restRange.isFullSet() || restRange.range.isSignWrappedSet())
+        {
+            continue;
+        }
+        auto restMin = restRange.range.getSignedMin().getSExtValue();
+        auto restMax = restRange.range.getSignedMax().getSExtValue();
+
+        if (set.isEq(i))
+        {
+            // Only an exact value of the induction variable satisfies an equality with a constant rest
+            if (restMin == restMax && restMin % coefficient == 0)
+            {
+                changePoints.push_back(-restMin / coefficient);
+                changePoints.push_back(-restMin / coefficient + 1);
+            }
+        }
+        else if (coefficient > 0)
+        {
+            // coefficient * iv + rest >= 0 holds for every rest from ceil(-restMin / coefficient) on, and for none
+            // below ceil(-restMax / coefficient)
+            changePoints.push_back(mlir::ceilDiv(-restMax, coefficient));
+            changePoints.push_back(mlir::ceilDiv(-restMin, coefficient));
+        }
+        else
+        {
+            // rest >= -coefficient * iv holds for every rest up to floor(restMin / -coefficient), and for none above
+            // floor(restMax / -coefficient)
+            changePoints.push_back(mlir::floorDiv(restMin, -coefficient) + 1);
+            changePoints.push_back(mlir::floorDiv(restMax, -coefficient) + 1);
+        }
+    }
+    return changePoints;
+}
+
+// Replaces the affine.if ops nested in an op whose outcome the ranges of their operands decide by the ops of the
+// branch they take. Returns whether any affine.if was replaced.
+bool FoldDecidedConditions(mlir::Operation* op, PatternRewriter& rewriter)
+{
+    std::vector<mlir::AffineIfOp> ifOps;
+    op->walk([&](mlir::AffineIfOp ifOp) {
+        if (ifOp.getNumResults() == 0)
+        {
+            ifOps.push_back(ifOp);
+        }
+    });
+
+    bool changed = false;
+    accera::transforms::value::RangeValueAnalysis ranges;
+    for (auto ifOp : ifOps)
+    {
+        auto set = ifOp.getIntegerSet();
+        bool alwaysTrue = true;
+        bool alwaysFalse = false;
+        for (unsigned i = 0; i < set.getNumConstraints() && !alwaysFalse; ++i)
+        {
+            auto range = ranges.resolveRange(set.getConstraint(i), ifOp.getOperands(), set.getNumDims());
+            auto zero = llvm::APInt(accera::transforms::value::RangeValue::maxBitWidth, 0);
+            if (set.isEq(i))
+            {
+                alwaysTrue &= range.isWithin(0, 0);
+                alwaysFalse |= !range.isFullSet() && !range.contains(zero);
+            }
+            else
+            {
+                alwaysTrue &= range.isWithin(0, std::numeric_limits<int64_t>::max());
+                alwaysFalse |= range.isWithin(std::numeric_limits<int64_t>::min(), -1);
+            }
+        }
+
+        if (!alwaysTrue && !alwaysFalse)
+        {
+            continue;
+        }
+
+        if (alwaysFalse && !ifOp.hasElse())
+        {
+            rewriter.eraseOp(ifOp);
+        }
+        else
+        {
+            auto block = alwaysFalse ? ifOp.getElseBlock() : ifOp.getThenBlock();
+            rewriter.eraseOp(block->getTerminator());
+            rewriter.mergeBlockBefore(block, ifOp);
+            rewriter.eraseOp(ifOp);
+        }
+        changed = true;
+    }
+    return changed;
+}
+
+// Versions a loop at the iterations where the outcome of the affine.if ops nested in it changes, e.g. the final
+// partial tile of a split whose size doesn't divide the range, so that each version of the loop runs without the
+// conditions. The versions are separate loops that are vectorized and unrolled independently of each other. The
+// nested loops are versioned in turn when the pattern visits them, which versions the boundary fragments of every
+// split level.
+bool VersionLoopAtConditionChanges(mlir::AffineForOp forOp)
+{
+    if (!forOp.hasConstantBounds() || forOp.getNumIterOperands() != 0 || forOp->getAttr("accv_gpu_map") || HasParallelizationInfo(forOp))
+    {
+        return false;
+    }
+
+    auto lowerBound = forOp.getConstantLowerBound();
+    auto step = forOp.getStep();
+    auto tripCount = mlir::getConstantTripCount(forOp).getValueOr(0);
+
+    accera::transforms::value::RangeValueAnalysis ranges;
+    std::set<int64_t> splitIters;
+    forOp.getBody()->walk([&](mlir::AffineIfOp ifOp) {
+        for (auto changePoint : GetConditionChangePoints(forOp, ifOp, ranges))
+        {
+            // The first iteration whose induction variable value reaches the change point
+            auto iter = mlir::ceilDiv(changePoint - lowerBound, step);
+            if (iter > 0 && iter < static_cast<int64_t>(tripCount))
+            {
+                splitIters.insert(iter);
+            }
+        }
+    });
+
+    if (splitIters.empty() || splitIters.size() > MaxConditionVersionSplits)
+    {
+        return false;
+    }
+
+    // Segment from the last split down, so that forOp keeps covering the iterations before the next split
+    for (auto it = splitIters.rbegin(); it != splitIters.rend(); ++it)
+    {
+        [[maybe_unused]] auto secondLoop = SegmentLoopAtIteration(forOp, *it);
+    }
+    return true;
+}
+
 LogicalResult LoopUnswitchingOpRewrite::matchAndRewrite(mlir::AffineForOp forOp, PatternRewriter& rewriter) const
 {
+    bool changed = false;
+    auto nextOp = forOp->getNextNode();
     if (forOp->hasAttrOfType<IntegerAttr>(UnswitchSuffixItersName) ||
         forOp->hasAttrOfType<IntegerAttr>(UnswitchPrefixItersName))
     {
@@ -6604,8 +10253,25 @@ LogicalResult LoopUnswitchingOpRewrite::matchAndRewrite(mlir::AffineForOp forOp,
             forOp->removeAttr(UnswitchPrefixItersName);
             [[maybe_unused]] auto secondLoop = SegmentLoopAtIteration(forOp, unswitchPrefix.getInt());
         }
+        changed = true;
     }
-    return success();
+
+    if (VersionLoopAtConditionChanges(forOp))
+    {
+        changed = true;
+    }
+
+    // Fold the conditions that the (possibly segmented) loops around them now decide, in this loop and in the loops
+    // segmented from it that follow it
+    for (auto op = forOp.getOperation(); op != nullptr && op != nextOp; op = op->getNextNode())
+    {
+        if (FoldDecidedConditions(op, rewriter))
+        {
+            changed = true;
+        }
+    }
+
+    return success(changed);
 }
 
 void ExecutionPlanCacheRegionLoweringPass::runOnOperation()
@@ -6671,6 +10337,44 @@ void ExecutionPlanParallelizationPass::runOnOperation()
     accera::transforms::executionPlan::populateExecutionPlanParallelizePatterns(patterns);
 
     (void)applyPatternsAndFoldGreedily(operation, std::move(patterns));
+
+    // Nested regions and the loops to pin are only known once the loops of each band have been collapsed
+    OwningRewritePatternList nestedPatterns(&getContext());
+    accera::transforms::executionPlan::populateExecutionPlanNestedParallelizePatterns(nestedPatterns);
+
+    (void)applyPatternsAndFoldGreedily(operation, std::move(nestedPatterns));
+}
+
+void WorkStealingParallelLoweringPass::runOnFunction()
+{
+    OwningRewritePatternList patterns(&getContext());
+    accera::transforms::executionPlan::populateChunkedParallelPatterns(patterns);
+    accera::transforms::executionPlan::populateWorkStealingParallelPatterns(patterns);
+
+    (void)applyPatternsAndFoldGreedily(getFunction(), std::move(patterns));
+}
+
+void NonTemporalStoreLoweringPass::runOnFunction()
+{
+    OwningRewritePatternList patterns(&getContext());
+    accera::transforms::executionPlan::populateNonTemporalStorePatterns(patterns);
+
+    (void)applyPatternsAndFoldGreedily(getFunction(), std::move(patterns));
+}
+
+void ReductionAccumulatorPromotionPass::runOnFunction()
+{
+    accera::transforms::executionPlan::promoteReductionAccumulators(getFunction());
+}
+
+void RedundantCacheFillEliminationPass::runOnFunction()
+{
+    accera::transforms::executionPlan::eliminateRedundantCacheFills(getFunction());
+}
+
+void LoopInvariantCodeMotionPass::runOnFunction()
+{
+    accera::transforms::executionPlan::hoistLoopInvariantOps(getFunction());
 }
 
 void ExecutionPlanTensorizationPass::runOnOperation()
@@ -6739,6 +10443,8 @@ void ExecutionPlanScaleHoistingPass::runOnFunction()
 
 void OutOfBoundsAccessHandlingPass::runOnFunction()
 {
+    accera::transforms::executionPlan::versionOutOfBoundsAccessLoops(getFunction());
+
     ConversionTarget target(getContext());
 
     OwningRewritePatternList patterns(&getContext());
@@ -6791,6 +10497,31 @@ std::unique_ptr<mlir::Pass> createOutOfBoundsAccessHandlingPass()
     return std::make_unique<OutOfBoundsAccessHandlingPass>();
 }
 
+std::unique_ptr<mlir::Pass> createWorkStealingParallelLoweringPass()
+{
+    return std::make_unique<WorkStealingParallelLoweringPass>();
+}
+
+std::unique_ptr<mlir::Pass> createNonTemporalStoreLoweringPass()
+{
+    return std::make_unique<NonTemporalStoreLoweringPass>();
+}
+
+std::unique_ptr<mlir::Pass> createReductionAccumulatorPromotionPass()
+{
+    return std::make_unique<ReductionAccumulatorPromotionPass>();
+}
+
+std::unique_ptr<mlir::Pass> createRedundantCacheFillEliminationPass()
+{
+    return std::make_unique<RedundantCacheFillEliminationPass>();
+}
+
+std::unique_ptr<mlir::Pass> createLoopInvariantCodeMotionPass()
+{
+    return std::make_unique<LoopInvariantCodeMotionPass>();
+}
+
 void populateExecutionPlanMakeCachePatterns(mlir::OwningRewritePatternList& patterns)
 {
     patterns.insert<MakeCacheOpLowering>(patterns.getContext());
@@ -6862,10 +10593,10 @@ void populateExecutionPlanAdjustCacheMappingPositionPatterns(mlir::OwningRewrite
     patterns.insert<AdjustCacheMappingPositionRewrite>(patterns.getContext());
 }
 
-void populateExecutionPlanVectorizePatterns(bool printVectorizationDetails, mlir::OwningRewritePatternList& patterns)
+void populateExecutionPlanVectorizePatterns(bool printVectorizationDetails, mlir::OwningRewritePatternList& patterns, bool reportVectorization)
 {
-    patterns.insert<VectorizeAffineForOpConversion,
-                    InPlaceUnrollAffineForOpConversion>(patterns.getContext(), printVectorizationDetails);
+    patterns.insert<VectorizeAffineForOpConversion>(patterns.getContext(), printVectorizationDetails, reportVectorization);
+    patterns.insert<InPlaceUnrollAffineForOpConversion>(patterns.getContext(), printVectorizationDetails);
 }
 
 void populateExecutionPlanTensorizePatterns(mlir::OwningRewritePatternList& patterns)
@@ -6879,6 +10610,21 @@ void populateExecutionPlanParallelizePatterns(mlir::OwningRewritePatternList& pa
                     CollapseAffineParallelOpsRewrite>(patterns.getContext());
 }
 
+void populateExecutionPlanNestedParallelizePatterns(mlir::OwningRewritePatternList& patterns)
+{
+    patterns.insert<NestedParallelRegionRewrite, PinParallelRegionRewrite>(patterns.getContext());
+}
+
+void populateWorkStealingParallelPatterns(mlir::OwningRewritePatternList& patterns)
+{
+    patterns.insert<WorkStealingParallelOpRewrite>(patterns.getContext());
+}
+
+void populateChunkedParallelPatterns(mlir::OwningRewritePatternList& patterns)
+{
+    patterns.insert<ChunkedParallelOpRewrite>(patterns.getContext());
+}
+
 void populateExecutionPlanScaleHoistingPatterns(mlir::OwningRewritePatternList& patterns)
 {
     patterns.insert<HoistScalingToCacheReduceRewrite>(patterns.getContext());
@@ -6892,6 +10638,22 @@ void populateOutOfBoundsAccessHandlingPatterns(mlir::OwningRewritePatternList& p
                     OutOfBoundsAffineStoreRewrite>(patterns.getContext());
 }
 
+void versionOutOfBoundsAccessLoops(mlir::Operation* op)
+{
+    std::vector<mlir::AffineForOp> innermostLoops;
+    op->walk([&](mlir::AffineForOp loop) {
+        auto hasNestedLoop = loop.getBody()->walk([](mlir::AffineForOp) { return WalkResult::interrupt(); }).wasInterrupted();
+        if (!hasNestedLoop && AncestorOpContainsAttrOfName(loop, AccessBoundsCheckAttrName))
+        {
+            innermostLoops.push_back(loop);
+        }
+    });
+    for (auto loop : innermostLoops)
+    {
+        VersionOutOfBoundsLoop(loop);
+    }
+}
+
 void populateConvergeLoadStoresPatterns(mlir::OwningRewritePatternList& patterns)
 {
     patterns.insert<ConvertLoadsToAffineRewrite,
@@ -6900,4 +10662,215 @@ void populateConvergeLoadStoresPatterns(mlir::OwningRewritePatternList& patterns
                     ConvertValueStoresToAffineRewrite>(patterns.getContext());
 }
 
+void populateNonTemporalStorePatterns(mlir::OwningRewritePatternList& patterns)
+{
+    patterns.insert<NonTemporalStoreRewrite,
+                    NonTemporalAffineStoreRewrite,
+                    NonTemporalTransferWriteRewrite>(patterns.getContext());
+}
+
+void promoteReductionAccumulators(mlir::Operation* op)
+{
+    // The inner loops come first, so that the accumulators hoisted out of a loop are promoted again by the loops
+    // around it when they are invariant in them too
+    std::vector<mlir::AffineForOp> loops;
+    op->walk([&](mlir::AffineForOp loop) { loops.push_back(loop); });
+    for (auto loop : loops)
+    {
+        PromoteLoopAccumulators(loop);
+    }
+}
+
+void eliminateRedundantCacheFills(mlir::Operation* op)
+{
+    std::vector<mlir::AffineForOp> loops;
+    op->walk([&](mlir::AffineForOp loop) { loops.push_back(loop); });
+    for (auto loop : loops)
+    {
+        EliminateRedundantFill(loop);
+    }
+}
+
+void hoistLoopInvariantOps(mlir::Operation* op)
+{
+    // The inner loops come first, so that the ops hoisted out of a loop move further out of the loops around it when
+    // they are invariant in them too
+    std::vector<mlir::AffineForOp> loops;
+    op->walk([&](mlir::AffineForOp loop) { loops.push_back(loop); });
+    for (auto loop : loops)
+    {
+        HoistLoopInvariantOps(loop);
+    }
+}
+
+void addCacheCopyProfileRegions(mlir::Operation* op)
+{
+    // The regions are numbered in the order of their ops, after the regions of the earlier runs
+    int64_t regionCount = 0;
+    std::vector<std::pair<mlir::Operation*, std::string>> cacheOps;
+    op->walk([&](mlir::Operation* nestedOp) {
+        if (isa<v::EnterProfileRegionOp>(nestedOp) && nestedOp->hasAttr(CacheCopyRegionAttrName))
+        {
+            ++regionCount;
+        }
+        else if (auto kind = GetCacheCopyKind(nestedOp); !kind.empty())
+        {
+            cacheOps.emplace_back(nestedOp, kind);
+        }
+    });
+
+    mlir::OpBuilder builder(op->getContext());
+    for (auto& [cacheOp, kind] : cacheOps)
+    {
+        // GPU caches are copied by all the threads of a block, whose regions can't be timed on the host
+        auto execTarget = util::ResolveExecutionTarget(cacheOp);
+        if (!execTarget || *execTarget != v::ExecutionTarget::CPU || IsInCacheCopyProfileRegion(cacheOp))
+        {
+            continue;
+        }
+
+        auto funcOp = cacheOp->getParentOfType<v::ValueFuncOp>();
+        auto regionName = (funcOp.sym_name() + "_cache" + std::to_string(regionCount++) + "_" + kind).str();
+        auto kindAttr = builder.getStringAttr(kind);
+
+        builder.setInsertionPoint(cacheOp);
+        auto enterOp = builder.create<v::EnterProfileRegionOp>(cacheOp->getLoc(), regionName);
+        enterOp->setAttr(CacheCopyRegionAttrName, kindAttr);
+        builder.setInsertionPointAfter(cacheOp);
+        auto exitOp = builder.create<v::ExitProfileRegionOp>(cacheOp->getLoc(), regionName);
+        exitOp->setAttr(CacheCopyRegionAttrName, kindAttr);
+    }
+}
+
+void outlineCacheCopyRegions(mlir::Operation* op)
+{
+    std::vector<std::pair<v::EnterProfileRegionOp, mlir::Operation*>> regions;
+    op->walk([&](v::EnterProfileRegionOp enterOp) {
+        if (!enterOp->hasAttr(CacheCopyRegionAttrName))
+        {
+            return;
+        }
+        for (auto nextOp = enterOp->getNextNode(); nextOp; nextOp = nextOp->getNextNode())
+        {
+            auto exitOp = dyn_cast<v::ExitProfileRegionOp>(nextOp);
+            if (exitOp && exitOp.regionName() == enterOp.regionName())
+            {
+                regions.emplace_back(enterOp, exitOp);
+                break;
+            }
+        }
+    });
+
+    // The copies of a region that the loop unswitching made get a function each
+    llvm::StringMap<int64_t> nameCounts;
+    mlir::OpBuilder builder(op->getContext());
+    for (auto& [enterOp, exitOp] : regions)
+    {
+        auto block = enterOp->getBlock();
+        if (enterOp->getNextNode() == exitOp)
+        {
+            continue;
+        }
+
+        // A value that the region defines and the ops after it use would have to be returned by the function
+        bool escapes = false;
+        for (auto regionOp = enterOp->getNextNode(); regionOp != exitOp && !escapes; regionOp = regionOp->getNextNode())
+        {
+            escapes = llvm::any_of(regionOp->getUsers(), [&](mlir::Operation* user) {
+                auto userAncestor = block->findAncestorOpInBlock(*user);
+                return !userAncestor || exitOp->isBeforeInBlock(userAncestor);
+            });
+        }
+        if (escapes)
+        {
+            continue;
+        }
+
+        auto regionName = enterOp.regionName().str();
+        auto count = nameCounts[regionName]++;
+        auto lambdaName = count ? regionName + "_" + std::to_string(count) : regionName;
+
+        // ValueFuncToTarget turns the lambda into a function that takes the values the region uses from around it
+        builder.setInsertionPoint(exitOp);
+        auto lambdaOp = builder.create<v::ValueLambdaOp>(enterOp.getLoc(), lambdaName, builder.getFunctionType(llvm::None, llvm::None), v::ExecutionTarget::CPU);
+        lambdaOp->setAttr(accera::ir::NoInlineAttrName, builder.getUnitAttr());
+
+        auto& body = lambdaOp.front();
+        while (enterOp->getNextNode() != lambdaOp)
+        {
+            enterOp->getNextNode()->moveBefore(&body, body.end());
+        }
+        builder.setInsertionPointToEnd(&body);
+        builder.create<v::ReturnOp>(enterOp.getLoc());
+    }
+}
+
+void addLoopProfileRegions(mlir::Operation* op)
+{
+    std::vector<mlir::AffineForOp> loops;
+    op->walk([&](mlir::AffineForOp loop) {
+        if (loop->hasAttr(ProfileLoopAttrName))
+        {
+            loops.push_back(loop);
+        }
+    });
+
+    mlir::OpBuilder builder(op->getContext());
+    for (auto loop : loops)
+    {
+        // The loop is only wrapped once, even if it is cloned afterwards
+        loop->removeAttr(ProfileLoopAttrName);
+
+        // GPU loops run on all the threads of a block, whose regions can't be timed on the host
+        auto execTarget = util::ResolveExecutionTarget(loop);
+        auto indexAttr = loop->getAttrOfType<IndexAttr>("index");
+        auto funcOp = loop->getParentOfType<v::ValueFuncOp>();
+        if (!execTarget || *execTarget != v::ExecutionTarget::CPU || !indexAttr || !funcOp)
+        {
+            continue;
+        }
+
+        // The loops of an index that was split into several loops, e.g. the boundary blocks, share the region
+        auto regionName = (funcOp.sym_name() + "_" + indexAttr.getValue().GetName()).str();
+        builder.setInsertionPoint(loop);
+        builder.create<v::EnterProfileRegionOp>(loop.getLoc(), regionName);
+        builder.setInsertionPointAfter(loop);
+        builder.create<v::ExitProfileRegionOp>(loop.getLoc(), regionName);
+    }
+}
+
+void addFunctionProfileRegion(mlir::Operation* op)
+{
+    auto funcOp = dyn_cast<v::ValueFuncOp>(op);
+    if (!funcOp || funcOp.isExternal())
+    {
+        return;
+    }
+    auto execTarget = util::ResolveExecutionTarget(funcOp);
+    if (!execTarget || *execTarget != v::ExecutionTarget::CPU)
+    {
+        return;
+    }
+
+    auto regionName = funcOp.sym_name().str();
+    auto loc = funcOp.getLoc();
+    mlir::OpBuilder builder(funcOp.getContext());
+    builder.setInsertionPointToStart(&funcOp.front());
+    builder.create<v::EnterProfileRegionOp>(loc, regionName);
+
+    // The returns of the lambdas nested in the function don't leave it
+    std::vector<v::ReturnOp> returnOps;
+    funcOp.walk([&](v::ReturnOp returnOp) {
+        if (returnOp->getParentOp() == funcOp)
+        {
+            returnOps.push_back(returnOp);
+        }
+    });
+    for (auto returnOp : returnOps)
+    {
+        builder.setInsertionPoint(returnOp);
+        builder.create<v::ExitProfileRegionOp>(loc, regionName);
+    }
+}
+
 } // namespace accera::transforms::executionPlan
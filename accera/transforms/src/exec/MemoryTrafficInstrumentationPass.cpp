@@ -0,0 +1,231 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "exec/MemoryTrafficInstrumentationPass.h"
+#include "AcceraPasses.h"
+
+#include <ir/include/IRUtil.h>
+#include <ir/include/exec/ExecutionPlanOps.h>
+#include <ir/include/value/ValueDialect.h>
+
+#include <mlir/Dialect/Affine/IR/AffineMemoryOpInterfaces.h>
+#include <mlir/Dialect/MemRef/IR/MemRef.h>
+#include <mlir/Dialect/Vector/VectorOps.h>
+#include <mlir/IR/Builders.h>
+#include <mlir/IR/BuiltinTypes.h>
+#include <mlir/Pass/Pass.h>
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/MapVector.h>
+#include <llvm/Support/FormatVariadic.h>
+
+#include <string>
+#include <vector>
+
+using namespace mlir;
+
+using namespace accera::ir;
+using namespace accera::transforms;
+
+namespace vir = accera::ir::value;
+namespace xpir = accera::ir::executionPlan;
+
+namespace
+{
+int64_t GetSizeInBytes(Type type)
+{
+    if (auto vectorType = type.dyn_cast<VectorType>())
+    {
+        return (vectorType.getNumElements() * vectorType.getElementTypeBitWidth() + 7) / 8;
+    }
+    if (type.isIntOrFloat())
+    {
+        return (type.getIntOrFloatBitWidth() + 7) / 8;
+    }
+    // index
+    return 8;
+}
+
+struct MemoryAccess
+{
+    Value memref;
+    int64_t loadedBytes = 0;
+    int64_t storedBytes = 0;
+};
+
+// The array that a memory access op reads or writes and the bytes it moves, a null memref for the other ops
+MemoryAccess GetMemoryAccess(Operation* op)
+{
+    if (auto readOp = dyn_cast<AffineReadOpInterface>(op))
+    {
+        return { readOp.getMemRef(), GetSizeInBytes(readOp.getValue().getType()), 0 };
+    }
+    if (auto writeOp = dyn_cast<AffineWriteOpInterface>(op))
+    {
+        return { writeOp.getMemRef(), 0, GetSizeInBytes(writeOp.getValueToStore().getType()) };
+    }
+    if (auto loadOp = dyn_cast<memref::LoadOp>(op))
+    {
+        return { loadOp.memref(), GetSizeInBytes(loadOp.getType()), 0 };
+    }
+    if (auto storeOp = dyn_cast<memref::StoreOp>(op))
+    {
+        return { storeOp.memref(), 0, GetSizeInBytes(storeOp.getValueToStore().getType()) };
+    }
+    if (auto loadOp = dyn_cast<vector::LoadOp>(op))
+    {
+        return { loadOp.base(), GetSizeInBytes(loadOp.getVectorType()), 0 };
+    }
+    if (auto storeOp = dyn_cast<vector::StoreOp>(op))
+    {
+        return { storeOp.base(), 0, GetSizeInBytes(storeOp.getVectorType()) };
+    }
+    if (auto transferReadOp = dyn_cast<vector::TransferReadOp>(op))
+    {
+        return { transferReadOp.source(), GetSizeInBytes(transferReadOp.getVectorType()), 0 };
+    }
+    if (auto transferWriteOp = dyn_cast<vector::TransferWriteOp>(op))
+    {
+        return { transferWriteOp.source(), 0, GetSizeInBytes(transferWriteOp.getVectorType()) };
+    }
+
+    // accv.load and accv.store move a single element, whatever the type of the value they load
+    if (auto loadOp = dyn_cast<vir::LoadOp>(op); loadOp && loadOp.getMemRef().getType().isa<MemRefType>())
+    {
+        return { loadOp.getMemRef(), GetSizeInBytes(loadOp.getMemRefType().getElementType()), 0 };
+    }
+    if (auto storeOp = dyn_cast<vir::StoreOp>(op))
+    {
+        return { storeOp.getMemRef(), 0, GetSizeInBytes(storeOp.getMemRefType().getElementType()) };
+    }
+    return {};
+}
+
+// The array that a memref is a view of, views are followed through their first memref operand to the function
+// argument, the global or the allocation that they view
+Value GetArray(Value memref)
+{
+    while (auto op = memref.getDefiningOp())
+    {
+        auto source = llvm::find_if(op->getOperands(), [](Value operand) { return operand.getType().isa<MemRefType>(); });
+        if (source == op->operand_end())
+        {
+            break;
+        }
+        memref = *source;
+    }
+    return memref;
+}
+
+bool IsCacheBuffer(Value array)
+{
+    if (auto refGlobalOp = array.getDefiningOp<vir::ReferenceGlobalOp>())
+    {
+        auto globalOp = refGlobalOp.getGlobal();
+        return globalOp && globalOp->hasAttr(xpir::CacheBufferAttrName);
+    }
+    auto op = array.getDefiningOp();
+    return op && op->hasAttr(xpir::CacheBufferAttrName);
+}
+
+// Names the arrays of a function: the arguments by their position, the caches and the other buffers it allocates
+// by the order they're first accessed in, and the other globals by their symbol
+class ArrayNames
+{
+public:
+    explicit ArrayNames(vir::ValueFuncOp funcOp) :
+        _prefix((funcOp.sym_name() + ":").str()) {}
+
+    const std::string& GetName(Value array)
+    {
+        auto [it, inserted] = _names.try_emplace(array);
+        if (!inserted)
+        {
+            return it->second;
+        }
+
+        if (auto arg = array.dyn_cast<BlockArgument>())
+        {
+            it->second = _prefix + llvm::formatv("arg{0}", arg.getArgNumber()).str();
+        }
+        else if (IsCacheBuffer(array))
+        {
+            it->second = _prefix + llvm::formatv("cache{0}", _cacheCount++).str();
+        }
+        else if (auto refGlobalOp = array.getDefiningOp<vir::ReferenceGlobalOp>())
+        {
+            it->second = _prefix + refGlobalOp.global_name().str();
+        }
+        else
+        {
+            it->second = _prefix + llvm::formatv("buffer{0}", _bufferCount++).str();
+        }
+        return it->second;
+    }
+
+private:
+    std::string _prefix;
+    llvm::DenseMap<Value, std::string> _names;
+    int64_t _cacheCount = 0;
+    int64_t _bufferCount = 0;
+};
+
+struct MemoryTrafficInstrumentationPass : public MemoryTrafficInstrumentationBase<MemoryTrafficInstrumentationPass>
+{
+    void runOnModule() final
+    {
+        auto module = getModule();
+        module.walk([&](vir::ValueFuncOp funcOp) {
+            if (!funcOp.isExternal() && util::ResolveExecutionTarget(funcOp).value_or(vir::ExecutionTarget::CPU) == vir::ExecutionTarget::CPU)
+            {
+                InstrumentFunction(funcOp);
+            }
+        });
+    }
+
+    // Each block that accesses an array counts the bytes of all its accesses of the array at once, when it starts
+    void InstrumentFunction(vir::ValueFuncOp funcOp)
+    {
+        ArrayNames arrayNames(funcOp);
+        llvm::MapVector<Block*, llvm::MapVector<Value, std::pair<int64_t, int64_t>>> blockTraffic;
+        funcOp.walk([&](Operation* op) {
+            auto access = GetMemoryAccess(op);
+            if (!access.memref || !access.memref.getType().isa<MemRefType>())
+            {
+                return;
+            }
+
+            // GPU kernels can't call into the runtime
+            if (util::ResolveExecutionTarget(op).value_or(vir::ExecutionTarget::CPU) != vir::ExecutionTarget::CPU)
+            {
+                return;
+            }
+
+            auto& [loadedBytes, storedBytes] = blockTraffic[op->getBlock()][GetArray(access.memref)];
+            loadedBytes += access.loadedBytes;
+            storedBytes += access.storedBytes;
+        });
+
+        OpBuilder builder(funcOp.getContext());
+        for (auto& [block, arrays] : blockTraffic)
+        {
+            builder.setInsertionPointToStart(block);
+            for (auto& [array, bytes] : arrays)
+            {
+                builder.create<vir::CountMemoryTrafficOp>(funcOp.getLoc(), arrayNames.GetName(array), bytes.first, bytes.second);
+            }
+        }
+    }
+};
+
+} // namespace
+
+namespace accera::transforms::executionPlan
+{
+std::unique_ptr<mlir::Pass> createMemoryTrafficInstrumentationPass()
+{
+    return std::make_unique<MemoryTrafficInstrumentationPass>();
+}
+} // namespace accera::transforms::executionPlan
@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "exec/VectorizationReportPass.h"
+#include "AcceraPasses.h"
+
+#include <ir/include/exec/ExecutionPlanOps.h>
+#include <ir/include/value/ValueDialect.h>
+
+#include <mlir/IR/BuiltinAttributes.h>
+#include <mlir/Pass/Pass.h>
+#include <mlir/Support/FileUtilities.h>
+
+#include <llvm/Support/FormatVariadic.h>
+#include <llvm/Support/JSON.h>
+#include <llvm/Support/ToolOutputFile.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <string>
+
+using namespace mlir;
+
+using namespace accera::ir;
+using namespace accera::transforms;
+
+namespace vir = accera::ir::value;
+
+namespace
+{
+llvm::json::Value ToJSON(Attribute attr)
+{
+    if (auto stringAttr = attr.dyn_cast<StringAttr>())
+    {
+        return stringAttr.getValue().str();
+    }
+    if (auto intAttr = attr.dyn_cast<IntegerAttr>())
+    {
+        return intAttr.getInt();
+    }
+    if (auto dictAttr = attr.dyn_cast<DictionaryAttr>())
+    {
+        llvm::json::Object object;
+        for (auto namedAttr : dictAttr)
+        {
+            object[namedAttr.first.strref()] = ToJSON(namedAttr.second);
+        }
+        return std::move(object);
+    }
+    return nullptr;
+}
+
+struct VectorizationReportPass : public VectorizationReportBase<VectorizationReportPass>
+{
+    VectorizationReportPass() = default;
+    VectorizationReportPass(const std::string& reportFilename)
+    {
+        this->reportFilename = reportFilename;
+    }
+
+    void runOnModule() final
+    {
+        auto module = getModule();
+
+        // The loops record their outcome on their function while they are vectorized, collect and drop those records here
+        llvm::json::Array functions;
+        module.walk([&](vir::ValueFuncOp funcOp) {
+            auto report = funcOp->getAttrOfType<ArrayAttr>(executionPlan::VectorizationReportAttrName);
+            if (!report)
+            {
+                return;
+            }
+
+            llvm::json::Array loops;
+            for (auto entry : report)
+            {
+                loops.push_back(ToJSON(entry));
+            }
+            functions.push_back(llvm::json::Object{ { "name", funcOp.sym_name().str() }, { "loops", std::move(loops) } });
+            funcOp->removeAttr(executionPlan::VectorizationReportAttrName);
+        });
+
+        llvm::json::Value result = llvm::json::Object{ { "functions", std::move(functions) } };
+        if (reportFilename.empty())
+        {
+            llvm::errs() << llvm::formatv("{0:2}", result) << "\n";
+            return;
+        }
+
+        std::string error;
+        auto reportFile = mlir::openOutputFile(reportFilename, &error);
+        if (!reportFile)
+        {
+            module.emitError() << error;
+            signalPassFailure();
+            return;
+        }
+        reportFile->os() << llvm::formatv("{0:2}", result) << "\n";
+        reportFile->keep();
+    }
+};
+
+} // namespace
+
+namespace accera::transforms::executionPlan
+{
+std::unique_ptr<mlir::Pass> createVectorizationReportPass(const std::string& reportFilename)
+{
+    return std::make_unique<VectorizationReportPass>(reportFilename);
+}
+
+std::unique_ptr<mlir::Pass> createVectorizationReportPass()
+{
+    return std::make_unique<VectorizationReportPass>();
+}
+} // namespace accera::transforms::executionPlan
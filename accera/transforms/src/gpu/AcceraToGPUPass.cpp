@@ -28,6 +28,8 @@
 #include <mlir/Dialect/SPIRV/IR/SPIRVDialect.h>
 #include <mlir/Dialect/SPIRV/IR/SPIRVEnums.h>
 #include <mlir/Dialect/SPIRV/IR/SPIRVOps.h>
+#include <mlir/Dialect/SPIRV/IR/SPIRVTypes.h>
+#include <mlir/Dialect/SPIRV/IR/TargetAndABI.h>
 #include <mlir/Dialect/SPIRV/Transforms/SPIRVConversion.h>
 #include <mlir/Dialect/StandardOps/IR/Ops.h>
 #include <mlir/Dialect/Vector/VectorOps.h>
@@ -678,6 +680,39 @@ struct ValueMFMAComputeToRocDLConversion final : public OpConversionPattern<vir:
     }
 };
 
+// Returns the fragment type of the NVIDIA tensor core (WMMA) instructions that holds the tile of an MFMA matrix,
+// or nothing if no tensor core instruction computes a tile of that shape and type
+std::optional<gpu::MMAMatrixType> GetWMMAMatrixType(vir::MFMAMatrixType mfmaMatrixType)
+{
+    // The 16x16x16 MFMA tiles map to the m16n16k16 instructions, which multiply FP16 matrices into FP16 or FP32 accumulators
+    // and BF16 matrices (sm80 and later) into FP32 accumulators
+    if (mfmaMatrixType.getShapeType() != vir::MFMAMatrixType::Shape::T2x2x16)
+    {
+        return std::nullopt;
+    }
+    auto elementType = mfmaMatrixType.getElementType();
+    auto isAccumulator = mfmaMatrixType.getOperand() == "COp";
+    if (!elementType.isF16() && !(elementType.isBF16() && !isAccumulator) && !(elementType.isF32() && isAccumulator))
+    {
+        return std::nullopt;
+    }
+    auto tileSize = mfmaMatrixType.getLeadingDim();
+    return gpu::MMAMatrixType::get({ tileSize, tileSize }, elementType, mfmaMatrixType.getOperand());
+}
+
+// Returns the stride between the rows of the tiles that the tensor core instructions load from and store to memref
+std::optional<int64_t> GetWMMALeadingDimension(MemRefType memrefType)
+{
+    int64_t offset;
+    SmallVector<int64_t, 4> strides;
+    if (memrefType.getRank() < 2 || failed(getStridesAndOffset(memrefType, strides, offset)) ||
+        strides.back() != 1 || ShapedType::isDynamicStrideOrOffset(strides[strides.size() - 2]))
+    {
+        return std::nullopt;
+    }
+    return strides[strides.size() - 2];
+}
+
 struct ValueMFMAStoreOpToGPUConversion final : public OpConversionPattern<vir::MFMAStoreOp>
 {
     using OpConversionPattern<vir::MFMAStoreOp>::OpConversionPattern;
@@ -686,6 +721,23 @@ struct ValueMFMAStoreOpToGPUConversion final : public OpConversionPattern<vir::M
                                   ArrayRef<mlir::Value> operands,
                                   ConversionPatternRewriter& rewriter) const final
     {
+        auto loc = op.getLoc();
+        vir::MFMAStoreOp::Adaptor mfmaStoreOpAdaptor(operands, op->getAttrDictionary());
+        auto memref = mfmaStoreOpAdaptor.memref();
+        if (!GetWMMAMatrixType(op.getMFMAMatrixType()))
+        {
+            return rewriter.notifyMatchFailure(op, "no tensor core instruction for this matrix shape and type");
+        }
+        auto leadingDim = GetWMMALeadingDimension(memref.getType().cast<MemRefType>());
+        if (!leadingDim)
+        {
+            return rewriter.notifyMatchFailure(op, "the tile must be stored to rows of contiguous elements");
+        }
+
+        // The warp stores the whole tile starting at the position that the map gives
+        std::vector<mlir::Value> mapOperands(mfmaStoreOpAdaptor.indices().begin(), mfmaStoreOpAdaptor.indices().end());
+        auto indices = utilir::MultiDimAffineApply(rewriter, loc, op.getAffineMap(), mapOperands);
+        rewriter.replaceOpWithNewOp<gpu::SubgroupMmaStoreMatrixOp>(op, mfmaStoreOpAdaptor.value(), memref, indices, rewriter.getIndexAttr(*leadingDim));
         return success();
     }
 };
@@ -698,7 +750,24 @@ struct ValueMFMALoadOpToGPUConversion final : public OpConversionPattern<vir::MF
                                   ArrayRef<mlir::Value> operands,
                                   ConversionPatternRewriter& rewriter) const final
     {
-        rewriter.eraseOp(op);
+        auto loc = op.getLoc();
+        vir::MFMALoadOp::Adaptor MFMALoadOpAdaptor(operands, op->getAttrDictionary());
+        auto memref = MFMALoadOpAdaptor.memref();
+        auto wmmaMatrixType = GetWMMAMatrixType(op.getMFMAMatrixType());
+        if (!wmmaMatrixType)
+        {
+            return rewriter.notifyMatchFailure(op, "no tensor core instruction for this matrix shape and type");
+        }
+        auto leadingDim = GetWMMALeadingDimension(memref.getType().cast<MemRefType>());
+        if (!leadingDim)
+        {
+            return rewriter.notifyMatchFailure(op, "the tile must be loaded from rows of contiguous elements");
+        }
+
+        // The warp loads the whole tile starting at the position that the map gives
+        std::vector<mlir::Value> mapOperands(MFMALoadOpAdaptor.indices().begin(), MFMALoadOpAdaptor.indices().end());
+        auto indices = utilir::MultiDimAffineApply(rewriter, loc, MFMALoadOpAdaptor.map().getValue(), mapOperands);
+        rewriter.replaceOpWithNewOp<gpu::SubgroupMmaLoadMatrixOp>(op, *wmmaMatrixType, memref, indices, rewriter.getIndexAttr(*leadingDim));
         return success();
     }
 };
@@ -711,7 +780,12 @@ struct ValueMFMAConstantOpToGPUConversion final : public OpConversionPattern<vir
                                   ArrayRef<mlir::Value> operands,
                                   ConversionPatternRewriter& rewriter) const final
     {
-        rewriter.eraseOp(op);
+        auto wmmaMatrixType = GetWMMAMatrixType(op.getMFMAMatrixType());
+        if (!wmmaMatrixType)
+        {
+            return rewriter.notifyMatchFailure(op, "no tensor core instruction for this matrix shape and type");
+        }
+        rewriter.replaceOpWithNewOp<gpu::SubgroupMmaConstantMatrixOp>(op, *wmmaMatrixType, operands[0]);
         return success();
     }
 };
@@ -723,7 +797,259 @@ struct ValueMFMAComputeToGPUConversion final : public OpConversionPattern<vir::M
                                   ArrayRef<mlir::Value> operands,
                                   ConversionPatternRewriter& rewriter) const final
     {
-        rewriter.replaceOpWithNewOp<gpu::SubgroupMmaComputeOp>(op, operands[2].getType(), operands, op->getAttrs());
+        vir::MFMAComputeOp::Adaptor mfmaComputeMatrixOpAdaptor(operands, op->getAttrDictionary());
+        auto opA = mfmaComputeMatrixOpAdaptor.opA();
+        auto opB = mfmaComputeMatrixOpAdaptor.opB();
+        auto opC = mfmaComputeMatrixOpAdaptor.opC();
+        if (!opA.getType().isa<gpu::MMAMatrixType>() || !opB.getType().isa<gpu::MMAMatrixType>() || !opC.getType().isa<gpu::MMAMatrixType>())
+        {
+            return rewriter.notifyMatchFailure(op, "expecting tensor core fragments for the operands");
+        }
+
+        // The cbsz, abid and blgp broadcast controls of the MFMA instructions have no tensor core equivalent,
+        // the tensorization only sets them for the multi-block shapes that have no tensor core instruction
+        rewriter.replaceOpWithNewOp<gpu::SubgroupMmaComputeOp>(op, opC.getType(), opA, opB, opC);
+        return success();
+    }
+};
+
+// Returns whether the SPIR-V target environment of op allows the capability, and the extension that provides it if any
+static bool isSPIRVCapabilityAllowed(Operation* op, spirv::Capability capability, std::optional<spirv::Extension> extension = std::nullopt)
+{
+    spirv::TargetEnv targetEnv(spirv::lookupTargetEnvOrDefault(op));
+    return targetEnv.allows(capability) && (!extension || targetEnv.allows(*extension));
+}
+
+static bool isCooperativeMatrixAllowed(Operation* op)
+{
+    return isSPIRVCapabilityAllowed(op, spirv::Capability::CooperativeMatrixNV, spirv::Extension::SPV_NV_cooperative_matrix);
+}
+
+// Returns the cooperative matrix type that holds the tile of an MFMA matrix on Vulkan devices, or nothing if no
+// cooperative matrix instruction computes a tile of that shape and type
+std::optional<spirv::CooperativeMatrixNVType> GetCooperativeMatrixType(vir::MFMAMatrixType mfmaMatrixType)
+{
+    // The 16x16x16 MFMA tiles map to the 16x16x16 cooperative matrices, which multiply FP16 matrices into FP16 or FP32
+    // accumulators on the devices that expose tensor cores through SPV_NV_cooperative_matrix
+    if (mfmaMatrixType.getShapeType() != vir::MFMAMatrixType::Shape::T2x2x16)
+    {
+        return std::nullopt;
+    }
+    auto elementType = mfmaMatrixType.getElementType();
+    if (!elementType.isF16() && !(elementType.isF32() && mfmaMatrixType.getOperand() == "COp"))
+    {
+        return std::nullopt;
+    }
+    auto tileSize = static_cast<unsigned>(mfmaMatrixType.getLeadingDim());
+    return spirv::CooperativeMatrixNVType::get(elementType, spirv::Scope::Subgroup, tileSize, tileSize);
+}
+
+// Applies map to operands that are already converted to SPIR-V integers, affine.apply ops would not be legalized
+// at this point of the conversion
+SmallVector<mlir::Value, 4> ExpandAffineMapToSPIRV(OpBuilder& builder, Location loc, AffineMap map, ValueRange operands, Type indexType)
+{
+    std::function<mlir::Value(AffineExpr)> expand = [&](AffineExpr expr) -> mlir::Value {
+        if (auto dimExpr = expr.dyn_cast<AffineDimExpr>())
+        {
+            return operands[dimExpr.getPosition()];
+        }
+        if (auto symbolExpr = expr.dyn_cast<AffineSymbolExpr>())
+        {
+            return operands[map.getNumDims() + symbolExpr.getPosition()];
+        }
+        if (auto constantExpr = expr.dyn_cast<AffineConstantExpr>())
+        {
+            return builder.create<spirv::ConstantOp>(loc, indexType, builder.getIntegerAttr(indexType, constantExpr.getValue()));
+        }
+        auto binaryExpr = expr.cast<AffineBinaryOpExpr>();
+        auto lhs = expand(binaryExpr.getLHS());
+        auto rhs = expand(binaryExpr.getRHS());
+        switch (expr.getKind())
+        {
+        case AffineExprKind::Add:
+            return builder.create<spirv::IAddOp>(loc, indexType, lhs, rhs);
+        case AffineExprKind::Mul:
+            return builder.create<spirv::IMulOp>(loc, indexType, lhs, rhs);
+        case AffineExprKind::Mod:
+            return builder.create<spirv::SModOp>(loc, indexType, lhs, rhs);
+        case AffineExprKind::FloorDiv:
+            // The tile positions are never negative, so the truncating division is the floor division
+            return builder.create<spirv::SDivOp>(loc, indexType, lhs, rhs);
+        case AffineExprKind::CeilDiv: {
+            auto one = builder.create<spirv::ConstantOp>(loc, indexType, builder.getIntegerAttr(indexType, 1));
+            auto numerator = builder.create<spirv::ISubOp>(loc, indexType, builder.create<spirv::IAddOp>(loc, indexType, lhs, rhs), one);
+            return builder.create<spirv::SDivOp>(loc, indexType, numerator, rhs);
+        }
+        default:
+            llvm_unreachable("unexpected affine expression");
+        }
+    };
+
+    SmallVector<mlir::Value, 4> results;
+    for (auto expr : map.getResults())
+    {
+        results.push_back(expand(expr));
+    }
+    return results;
+}
+
+// Returns the pointer to the first element of the tile at the position that map gives, and the stride between the
+// rows of the tile
+FailureOr<std::pair<mlir::Value, mlir::Value>> GetCooperativeMatrixTilePointer(SPIRVTypeConverter& typeConverter, OpBuilder& builder, Location loc, mlir::Value originalMemref, mlir::Value memref, AffineMap map, ValueRange mapOperands)
+{
+    auto memrefType = originalMemref.getType().cast<MemRefType>();
+    auto leadingDim = GetWMMALeadingDimension(memrefType);
+    if (!leadingDim)
+    {
+        return failure();
+    }
+    auto indexType = typeConverter.getIndexType();
+    auto indices = ExpandAffineMapToSPIRV(builder, loc, map, mapOperands, indexType);
+    mlir::Value pointer = spirv::getElementPtr(typeConverter, memrefType, memref, indices, loc, builder);
+    mlir::Value stride = builder.create<spirv::ConstantOp>(loc, indexType, builder.getIntegerAttr(indexType, *leadingDim));
+    return std::make_pair(pointer, stride);
+}
+
+struct ValueMFMALoadOpToSPIRVConversion final : public OpConversionPattern<vir::MFMALoadOp>
+{
+    ValueMFMALoadOpToSPIRVConversion(SPIRVTypeConverter& typeConverter, MLIRContext* context) :
+        OpConversionPattern(typeConverter, context, kAcceraGPUPatternBenefit)
+    {}
+
+    LogicalResult matchAndRewrite(vir::MFMALoadOp op, ArrayRef<mlir::Value> operands, ConversionPatternRewriter& rewriter) const final
+    {
+        auto loc = op.getLoc();
+        vir::MFMALoadOp::Adaptor mfmaLoadOpAdaptor(operands, op->getAttrDictionary());
+        auto cooperativeMatrixType = GetCooperativeMatrixType(op.getMFMAMatrixType());
+        if (!cooperativeMatrixType || !isCooperativeMatrixAllowed(op))
+        {
+            return rewriter.notifyMatchFailure(op, "no cooperative matrix instruction for this matrix shape and type on the target");
+        }
+
+        // The subgroup loads the whole tile starting at the position that the map gives
+        auto tilePointer = GetCooperativeMatrixTilePointer(*getTypeConverter<SPIRVTypeConverter>(), rewriter, loc, op.memref(), mfmaLoadOpAdaptor.memref(), mfmaLoadOpAdaptor.map().getValue(), mfmaLoadOpAdaptor.indices());
+        if (failed(tilePointer))
+        {
+            return rewriter.notifyMatchFailure(op, "the tile must be loaded from rows of contiguous elements");
+        }
+        auto [pointer, stride] = *tilePointer;
+        auto columnMajor = rewriter.create<spirv::ConstantOp>(loc, rewriter.getI1Type(), rewriter.getBoolAttr(false));
+        rewriter.replaceOpWithNewOp<spirv::CooperativeMatrixLoadNVOp>(op, TypeRange{ *cooperativeMatrixType }, ValueRange{ pointer, stride, columnMajor });
+        return success();
+    }
+};
+
+struct ValueMFMAStoreOpToSPIRVConversion final : public OpConversionPattern<vir::MFMAStoreOp>
+{
+    ValueMFMAStoreOpToSPIRVConversion(SPIRVTypeConverter& typeConverter, MLIRContext* context) :
+        OpConversionPattern(typeConverter, context, kAcceraGPUPatternBenefit)
+    {}
+
+    LogicalResult matchAndRewrite(vir::MFMAStoreOp op, ArrayRef<mlir::Value> operands, ConversionPatternRewriter& rewriter) const final
+    {
+        auto loc = op.getLoc();
+        vir::MFMAStoreOp::Adaptor mfmaStoreOpAdaptor(operands, op->getAttrDictionary());
+        if (!GetCooperativeMatrixType(op.getMFMAMatrixType()) || !isCooperativeMatrixAllowed(op))
+        {
+            return rewriter.notifyMatchFailure(op, "no cooperative matrix instruction for this matrix shape and type on the target");
+        }
+
+        // The subgroup stores the whole tile starting at the position that the map gives
+        auto tilePointer = GetCooperativeMatrixTilePointer(*getTypeConverter<SPIRVTypeConverter>(), rewriter, loc, op.memref(), mfmaStoreOpAdaptor.memref(), op.getAffineMap(), mfmaStoreOpAdaptor.indices());
+        if (failed(tilePointer))
+        {
+            return rewriter.notifyMatchFailure(op, "the tile must be stored to rows of contiguous elements");
+        }
+        auto [pointer, stride] = *tilePointer;
+        auto columnMajor = rewriter.create<spirv::ConstantOp>(loc, rewriter.getI1Type(), rewriter.getBoolAttr(false));
+        rewriter.create<spirv::CooperativeMatrixStoreNVOp>(loc, TypeRange{}, ValueRange{ pointer, mfmaStoreOpAdaptor.value(), stride, columnMajor });
+        rewriter.eraseOp(op);
+        return success();
+    }
+};
+
+struct ValueMFMAConstantOpToSPIRVConversion final : public OpConversionPattern<vir::MFMAConstantOp>
+{
+    ValueMFMAConstantOpToSPIRVConversion(SPIRVTypeConverter& typeConverter, MLIRContext* context) :
+        OpConversionPattern(typeConverter, context, kAcceraGPUPatternBenefit)
+    {}
+
+    LogicalResult matchAndRewrite(vir::MFMAConstantOp op, ArrayRef<mlir::Value> operands, ConversionPatternRewriter& rewriter) const final
+    {
+        auto cooperativeMatrixType = GetCooperativeMatrixType(op.getMFMAMatrixType());
+        if (!cooperativeMatrixType || !isCooperativeMatrixAllowed(op))
+        {
+            return rewriter.notifyMatchFailure(op, "no cooperative matrix instruction for this matrix shape and type on the target");
+        }
+
+        // A cooperative matrix is constructed from the single value that fills it
+        rewriter.replaceOpWithNewOp<spirv::CompositeConstructOp>(op, *cooperativeMatrixType, ValueRange{ operands[0] });
+        return success();
+    }
+};
+
+struct ValueMFMAComputeToSPIRVConversion final : public OpConversionPattern<vir::MFMAComputeOp>
+{
+    ValueMFMAComputeToSPIRVConversion(SPIRVTypeConverter& typeConverter, MLIRContext* context) :
+        OpConversionPattern(typeConverter, context, kAcceraGPUPatternBenefit)
+    {}
+
+    LogicalResult matchAndRewrite(vir::MFMAComputeOp op, ArrayRef<mlir::Value> operands, ConversionPatternRewriter& rewriter) const final
+    {
+        vir::MFMAComputeOp::Adaptor mfmaComputeMatrixOpAdaptor(operands, op->getAttrDictionary());
+        auto opA = mfmaComputeMatrixOpAdaptor.opA();
+        auto opB = mfmaComputeMatrixOpAdaptor.opB();
+        auto opC = mfmaComputeMatrixOpAdaptor.opC();
+        if (!opA.getType().isa<spirv::CooperativeMatrixNVType>() || !opB.getType().isa<spirv::CooperativeMatrixNVType>() || !opC.getType().isa<spirv::CooperativeMatrixNVType>())
+        {
+            return rewriter.notifyMatchFailure(op, "expecting cooperative matrices for the operands");
+        }
+
+        // As with the tensor core instructions, the broadcast controls of the MFMA instructions have no equivalent
+        rewriter.replaceOpWithNewOp<spirv::CooperativeMatrixMulAddNVOp>(op, TypeRange{ opC.getType() }, ValueRange{ opA, opB, opC });
+        return success();
+    }
+};
+
+template <typename SPIRVOp>
+static void replaceWithSubgroupReduce(vir::GPUReduceOp op, mlir::Value value, ConversionPatternRewriter& rewriter)
+{
+    rewriter.replaceOpWithNewOp<SPIRVOp>(op, value.getType(), spirv::Scope::Subgroup, spirv::GroupOperation::Reduce, value, mlir::Value{});
+}
+
+struct ValueGPUReduceToSPIRVConversion final : public OpConversionPattern<vir::GPUReduceOp>
+{
+    ValueGPUReduceToSPIRVConversion(SPIRVTypeConverter& typeConverter, MLIRContext* context) :
+        OpConversionPattern(typeConverter, context, kAcceraGPUPatternBenefit)
+    {}
+
+    LogicalResult matchAndRewrite(vir::GPUReduceOp op, ArrayRef<mlir::Value> operands, ConversionPatternRewriter& rewriter) const final
+    {
+        // Vulkan limits the scope of the non-uniform group operations to the subgroup
+        if (op.scope() != vir::BarrierScope::Warp)
+        {
+            return rewriter.notifyMatchFailure(op, "only the reductions within a subgroup have a SPIR-V equivalent");
+        }
+        if (!isSPIRVCapabilityAllowed(op, spirv::Capability::GroupNonUniformArithmetic))
+        {
+            return rewriter.notifyMatchFailure(op, "the target does not allow subgroup arithmetic");
+        }
+
+        auto value = operands[0];
+        auto isSum = op.kind() == vir::ReductionKind::Sum;
+        if (value.getType().isa<FloatType>())
+        {
+            isSum ? replaceWithSubgroupReduce<spirv::GroupNonUniformFAddOp>(op, value, rewriter) : replaceWithSubgroupReduce<spirv::GroupNonUniformFMaxOp>(op, value, rewriter);
+        }
+        else if (isSum)
+        {
+            replaceWithSubgroupReduce<spirv::GroupNonUniformIAddOp>(op, value, rewriter);
+        }
+        else
+        {
+            // SPIR-V integers are signless, the signedness of the original type picks the comparison
+            op.value().getType().isUnsignedInteger() ? replaceWithSubgroupReduce<spirv::GroupNonUniformUMaxOp>(op, value, rewriter) : replaceWithSubgroupReduce<spirv::GroupNonUniformSMaxOp>(op, value, rewriter);
+        }
         return success();
     }
 };
@@ -902,7 +1228,8 @@ struct AcceraToNVVMPass : public accera::transforms::ConvertAcceraToNVVMBase<Acc
         auto module = getOperation();
         ConversionTarget target(*context);
 
-        if (!hasRuntimeTarget<vir::ExecutionRuntime::CUDA>(module))
+        // OpenCL kernels are printed from the same GPU dialect form as the CUDA kernels
+        if (!hasRuntimeTarget<vir::ExecutionRuntime::CUDA>(module) && !hasRuntimeTarget<vir::ExecutionRuntime::OPENCL>(module))
         {
             return;
         }
@@ -935,7 +1262,7 @@ struct AcceraToNVVMPass : public accera::transforms::ConvertAcceraToNVVMBase<Acc
         }
         {
             RewritePatternSet patterns(context);
-            patterns.insert<CreateDeviceFuncLauncherPairPattern>(vir::ExecutionRuntime::CUDA, context);
+            patterns.insert<CreateDeviceFuncLauncherPairPattern>(*getGPURuntimeTarget(module), context);
             (void)applyPatternsAndFoldGreedily(module, std::move(patterns));
         }
         {
@@ -954,11 +1281,25 @@ namespace accera::transforms
 
 void populateAcceraToSPIRVPatterns(mlir::SPIRVTypeConverter& typeConverter, mlir::MLIRContext* context, mlir::OwningRewritePatternList& patterns)
 {
+    // The MFMA tiles live in cooperative matrices, which the loops that accumulate them carry as well
+    typeConverter.addConversion([](vir::MFMAMatrixType type) -> Optional<Type> {
+        if (auto cooperativeMatrixType = GetCooperativeMatrixType(type))
+        {
+            return Type{ *cooperativeMatrixType };
+        }
+        return llvm::None;
+    });
+
     patterns.insert<
         EarlyReturnToSPIRVReturnPattern,
         ValueBarrierToSPIRVBarrierConversion,
         PrivateAllocToSPIRVConversion,
-        PrivateDeallocToSPIRVConversion>(typeConverter, context);
+        PrivateDeallocToSPIRVConversion,
+        ValueMFMALoadOpToSPIRVConversion,
+        ValueMFMAComputeToSPIRVConversion,
+        ValueMFMAStoreOpToSPIRVConversion,
+        ValueMFMAConstantOpToSPIRVConversion,
+        ValueGPUReduceToSPIRVConversion>(typeConverter, context);
 }
 
 void populateAcceraToROCDLPatterns(mlir::OwningRewritePatternList& patterns)
@@ -1016,6 +1357,8 @@ std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createAcceraToGPUPass(accer
     case ExecutionRuntime::ROCM:
         return createAcceraToROCDLPass();
     case ExecutionRuntime::CUDA:
+        [[fallthrough]];
+    case ExecutionRuntime::OPENCL:
         return createAcceraToNVVMPass();
     case ExecutionRuntime::VULKAN:
         return createAcceraToSPIRVPass();
@@ -1023,6 +1366,8 @@ std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createAcceraToGPUPass(accer
         [[fallthrough]];
     case ExecutionRuntime::OPENMP:
         [[fallthrough]];
+    case ExecutionRuntime::THREAD_POOL:
+        [[fallthrough]];
     default:
         return {};
     }
@@ -35,6 +35,7 @@
 #include <mlir/IR/Attributes.h>
 #include <mlir/IR/Builders.h>
 #include <mlir/IR/BuiltinOps.h>
+#include <mlir/Interfaces/SideEffectInterfaces.h>
 
 #include <llvm/ADT/SmallString.h>
 #include <llvm/Support/FormatVariadic.h>
@@ -61,6 +62,8 @@ static constexpr const char* kDestroyVulkanEmittedFunc = "destroyVulkanUtilities
 static constexpr const char* kInitializeFuncAttrName = "rc_gpu_init";
 static constexpr const char* kDeInitializeFuncAttrName = "rc_gpu_deinit";
 static constexpr const char* kVulkanRuntimeHandleAccessor = "getVulkanRuntimeInstance";
+static constexpr const char* kBeginVulkanBatch = "beginVulkanBatch";
+static constexpr const char* kSubmitVulkanBatch = "submitVulkanBatch";
 
 namespace
 {
@@ -77,6 +80,11 @@ namespace
 /// * runOnVulkan                       -- runs vulkan runtime
 /// * deinitVulkan                      -- deinitializes vulkan runtime
 ///
+/// When the launches aren't timed, each run of launches that follow each other
+/// in a block without the host accessing memory between them is wrapped in
+/// beginVulkanBatch / submitVulkanBatch calls, so that their dispatches are
+/// submitted to the device at once.
+///
 class VulkanLaunchFuncToVulkanCallsWithTimingPass
     : public accera::transforms::ConvertVulkanLaunchFuncToVulkanCallsWithTimingBase<VulkanLaunchFuncToVulkanCallsWithTimingPass>
 {
@@ -166,6 +174,14 @@ private:
         return funcTags.get(kDeInitializeFuncAttrName) != nullptr;
     }
 
+    /// Checks whether the given op can sit between two batched vulkan launch
+    /// calls: it must not access memory that a launch may bind.
+    bool isBatchableHostOp(Operation* op);
+
+    /// Wraps the runs of consecutive vulkan launch calls in calls that batch
+    /// their dispatches.
+    void batchVulkanLaunchCalls();
+
     /// Translates the given `vulkanLaunchCallOp` to the sequence of Vulkan
     /// runtime calls.
     void translateVulkanLaunchCall(LLVM::CallOp vulkanLaunchCallOp);
@@ -267,6 +283,12 @@ void VulkanLaunchFuncToVulkanCallsWithTimingPass::runOnModule()
             collectSPIRVAttributes(op);
     });
 
+    // Batching the launches leaves nothing to time them with
+    if (!printTimings && warmupCount == 0 && runCount == 1)
+    {
+        batchVulkanLaunchCalls();
+    }
+
     // Convert vulkan launch call op into a sequence of Vulkan runtime calls.
     getOperation().walk([this](LLVM::CallOp op) {
         if (isCInterfaceVulkanLaunchCallOp(op))
@@ -444,6 +466,20 @@ void VulkanLaunchFuncToVulkanCallsWithTimingPass::declareVulkanFunctions(Locatio
                                                            /*isVarArg=*/false));
     }
 
+    if (!module.lookupSymbol(kBeginVulkanBatch))
+    {
+        builder.create<LLVM::LLVMFuncOp>(
+            loc, kBeginVulkanBatch, LLVM::LLVMFunctionType::get(getVoidType(), { getPointerType() },
+                                                                /*isVarArg=*/false));
+    }
+
+    if (!module.lookupSymbol(kSubmitVulkanBatch))
+    {
+        builder.create<LLVM::LLVMFuncOp>(
+            loc, kSubmitVulkanBatch, LLVM::LLVMFunctionType::get(getVoidType(), { getPointerType() },
+                                                                 /*isVarArg=*/false));
+    }
+
     if (!module.lookupSymbol(kSetRepeatedRunCharacteristics))
     {
         builder.create<LLVM::LLVMFuncOp>(
@@ -503,6 +539,69 @@ Value VulkanLaunchFuncToVulkanCallsWithTimingPass::createEntryPointNameConstant(
     return LLVM::createGlobalString(loc, builder, entryPointGlobalName, shaderName, LLVM::Linkage::Internal);
 }
 
+bool VulkanLaunchFuncToVulkanCallsWithTimingPass::isBatchableHostOp(Operation* op)
+{
+    // The memref descriptors of the launch arguments are built on the stack, which the launches don't bind
+    auto isStackAddress = [](Value address) {
+        while (auto definingOp = address.getDefiningOp())
+        {
+            if (isa<LLVM::AllocaOp>(definingOp))
+                return true;
+            if (!isa<LLVM::GEPOp, LLVM::BitcastOp>(definingOp))
+                return false;
+            address = definingOp->getOperand(0);
+        }
+        return false;
+    };
+    if (isa<LLVM::AllocaOp>(op))
+        return true;
+    if (auto loadOp = dyn_cast<LLVM::LoadOp>(op))
+        return isStackAddress(loadOp.addr());
+    if (auto storeOp = dyn_cast<LLVM::StoreOp>(op))
+        return isStackAddress(storeOp.addr());
+    return op->getNumRegions() == 0 && isa<MemoryEffectOpInterface>(op) && MemoryEffectOpInterface::hasNoEffect(op);
+}
+
+void VulkanLaunchFuncToVulkanCallsWithTimingPass::batchVulkanLaunchCalls()
+{
+    // The host arrays are only updated when a batch is submitted, so a batch ends before any host access to memory
+    std::vector<std::vector<LLVM::CallOp>> batches;
+    getOperation().walk([&](LLVM::LLVMFuncOp funcOp) {
+        for (auto& block : funcOp.getBody())
+        {
+            std::vector<LLVM::CallOp> batch;
+            auto endBatch = [&] {
+                if (batch.size() > 1)
+                    batches.push_back(batch);
+                batch.clear();
+            };
+            for (auto& op : block)
+            {
+                auto callOp = dyn_cast<LLVM::CallOp>(op);
+                if (callOp && isVulkanLaunchCallOp(callOp))
+                    batch.push_back(callOp);
+                else if (!batch.empty() && !isBatchableHostOp(&op))
+                    endBatch();
+            }
+            endBatch();
+        }
+    });
+
+    for (auto& batch : batches)
+    {
+        Location loc = batch.front().getLoc();
+        declareVulkanFunctions(loc);
+
+        OpBuilder builder(batch.front());
+        auto vulkanRuntime = getVulkanRuntimeHandle(loc, builder);
+        builder.create<LLVM::CallOp>(loc, ArrayRef<Type>{ getVoidType() }, builder.getSymbolRefAttr(kBeginVulkanBatch), ArrayRef<Value>{ vulkanRuntime });
+
+        builder.setInsertionPointAfter(batch.back());
+        vulkanRuntime = getVulkanRuntimeHandle(loc, builder);
+        builder.create<LLVM::CallOp>(loc, ArrayRef<Type>{ getVoidType() }, builder.getSymbolRefAttr(kSubmitVulkanBatch), ArrayRef<Value>{ vulkanRuntime });
+    }
+}
+
 void VulkanLaunchFuncToVulkanCallsWithTimingPass::translateVulkanLaunchCall(
     LLVM::CallOp cInterfaceVulkanLaunchCallOp)
 {
@@ -0,0 +1,429 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "gpu/AcceraToGPUPass.h"
+#include "AcceraPasses.h"
+
+#include <ir/include/IRUtil.h>
+#include <ir/include/exec/ExecutionPlanOps.h>
+
+#include <mlir/Dialect/GPU/GPUDialect.h>
+#include <mlir/Dialect/MemRef/IR/MemRef.h>
+#include <mlir/Dialect/SCF/SCF.h>
+#include <mlir/Dialect/StandardOps/IR/Ops.h>
+#include <mlir/Dialect/Vector/VectorOps.h>
+#include <mlir/IR/BuiltinAttributes.h>
+#include <mlir/IR/BuiltinTypes.h>
+#include <mlir/IR/SymbolTable.h>
+#include <mlir/Pass/Pass.h>
+#include <mlir/Support/FileUtilities.h>
+#include <mlir/Support/MathExtras.h>
+
+#include <llvm/ADT/MapVector.h>
+#include <llvm/ADT/Optional.h>
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/ADT/StringSwitch.h>
+#include <llvm/Support/FormatVariadic.h>
+#include <llvm/Support/JSON.h>
+#include <llvm/Support/ToolOutputFile.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <string>
+
+using namespace mlir;
+
+namespace utilir = accera::ir::util;
+
+namespace
+{
+int64_t GetSizeInBytes(MemRefType type)
+{
+    auto elementType = type.getElementType();
+    int64_t elementBits = 0;
+    if (auto vectorType = elementType.dyn_cast<VectorType>())
+    {
+        elementBits = vectorType.getNumElements() * vectorType.getElementTypeBitWidth();
+    }
+    else if (elementType.isIntOrFloat())
+    {
+        elementBits = elementType.getIntOrFloatBitWidth();
+    }
+    else
+    {
+        // index
+        elementBits = 64;
+    }
+    return type.getNumElements() * ((elementBits + 7) / 8);
+}
+
+llvm::json::Array GetDims(gpu::GPUFuncOp funcOp, StringRef attrName)
+{
+    llvm::json::Array dims;
+    if (auto arrayAttr = funcOp->getAttrOfType<ArrayAttr>(attrName))
+    {
+        for (auto dim : utilir::ArrayAttrToVector<IntegerAttr>(arrayAttr))
+        {
+            dims.push_back(dim.getInt());
+        }
+    }
+    return dims;
+}
+
+// The placement of each register cache of the kernel, see ExecutionPlanToAffineLoweringPass
+llvm::json::Array GetRegisterCaches(gpu::GPUFuncOp funcOp)
+{
+    llvm::json::Array caches;
+    if (auto report = funcOp->getAttrOfType<ArrayAttr>(accera::ir::executionPlan::RegisterCacheReportAttrName))
+    {
+        for (auto entry : report.getAsRange<DictionaryAttr>())
+        {
+            llvm::json::Object cache;
+            for (auto field : entry)
+            {
+                if (auto intAttr = field.second.dyn_cast<IntegerAttr>())
+                {
+                    cache[field.first.strref()] = intAttr.getInt();
+                }
+                else if (auto strAttr = field.second.dyn_cast<StringAttr>())
+                {
+                    cache[field.first.strref()] = strAttr.getValue().str();
+                }
+            }
+            caches.push_back(std::move(cache));
+        }
+    }
+    return caches;
+}
+
+// The value of an index in the first iteration of the loops around it, for a block whose threads are all 0 except the
+// thread `threadId` along `threadDim`, or None if it depends on a value that isn't known at compile time
+llvm::Optional<int64_t> EvaluateIndex(Value value, StringRef threadDim, int64_t threadId, llvm::ArrayRef<int64_t> blockSize)
+{
+    if (auto arg = value.dyn_cast<BlockArgument>())
+    {
+        auto forOp = dyn_cast_or_null<scf::ForOp>(arg.getOwner()->getParentOp());
+        if (forOp && arg == forOp.getInductionVar())
+        {
+            return EvaluateIndex(forOp.lowerBound(), threadDim, threadId, blockSize);
+        }
+        return llvm::None;
+    }
+
+    auto op = value.getDefiningOp();
+    if (auto constantOp = dyn_cast<ConstantOp>(op))
+    {
+        if (auto intAttr = constantOp.getValue().dyn_cast<IntegerAttr>())
+        {
+            return intAttr.getInt();
+        }
+        return llvm::None;
+    }
+    if (auto threadIdOp = dyn_cast<gpu::ThreadIdOp>(op))
+    {
+        return threadIdOp.dimension() == threadDim ? threadId : 0;
+    }
+    if (isa<gpu::BlockIdOp>(op))
+    {
+        return 0;
+    }
+    if (auto blockDimOp = dyn_cast<gpu::BlockDimOp>(op))
+    {
+        auto dim = llvm::StringSwitch<size_t>(blockDimOp.dimension()).Case("x", 0).Case("y", 1).Default(2);
+        return dim < blockSize.size() ? llvm::Optional<int64_t>(blockSize[dim]) : llvm::None;
+    }
+    if (isa<IndexCastOp>(op))
+    {
+        return EvaluateIndex(op->getOperand(0), threadDim, threadId, blockSize);
+    }
+    if (!isa<AddIOp, SubIOp, MulIOp, SignedDivIOp, UnsignedDivIOp, SignedFloorDivIOp, SignedCeilDivIOp, SignedRemIOp, UnsignedRemIOp>(op))
+    {
+        return llvm::None;
+    }
+
+    auto lhs = EvaluateIndex(op->getOperand(0), threadDim, threadId, blockSize);
+    auto rhs = EvaluateIndex(op->getOperand(1), threadDim, threadId, blockSize);
+    if (!lhs || !rhs)
+    {
+        return llvm::None;
+    }
+    if (isa<AddIOp>(op)) return *lhs + *rhs;
+    if (isa<SubIOp>(op)) return *lhs - *rhs;
+    if (isa<MulIOp>(op)) return *lhs * *rhs;
+    if (*rhs == 0)
+    {
+        return llvm::None;
+    }
+    if (isa<SignedDivIOp, UnsignedDivIOp>(op)) return *lhs / *rhs;
+    if (isa<SignedFloorDivIOp>(op)) return floorDiv(*lhs, *rhs);
+    if (isa<SignedCeilDivIOp>(op)) return ceilDiv(*lhs, *rhs);
+    return *lhs % *rhs;
+}
+
+struct GlobalAccess
+{
+    Value memref;
+    ValueRange indices;
+    int64_t elementsPerAccess = 1;
+    bool isStore = false;
+};
+
+llvm::Optional<GlobalAccess> GetGlobalAccess(Operation* op)
+{
+    GlobalAccess access;
+    if (auto loadOp = dyn_cast<memref::LoadOp>(op))
+    {
+        access = { loadOp.memref(), loadOp.indices() };
+    }
+    else if (auto storeOp = dyn_cast<memref::StoreOp>(op))
+    {
+        access = { storeOp.memref(), storeOp.indices(), 1, true };
+    }
+    else if (auto loadOp = dyn_cast<vector::LoadOp>(op))
+    {
+        access = { loadOp.base(), loadOp.indices(), loadOp.getVectorType().getNumElements() };
+    }
+    else if (auto storeOp = dyn_cast<vector::StoreOp>(op))
+    {
+        access = { storeOp.base(), storeOp.indices(), storeOp.getVectorType().getNumElements(), true };
+    }
+    else if (auto transferReadOp = dyn_cast<vector::TransferReadOp>(op))
+    {
+        access = { transferReadOp.source(), transferReadOp.indices(), transferReadOp.getVectorType().getNumElements() };
+    }
+    else if (auto transferWriteOp = dyn_cast<vector::TransferWriteOp>(op))
+    {
+        access = { transferWriteOp.source(), transferWriteOp.indices(), transferWriteOp.getVectorType().getNumElements(), true };
+    }
+    else
+    {
+        return llvm::None;
+    }
+
+    auto type = access.memref.getType().dyn_cast<MemRefType>();
+    if (!type || type.getMemorySpaceAsInt() != 0)
+    {
+        return llvm::None;
+    }
+    return access;
+}
+
+// The kernel argument that a memref is a view of, views are followed through their first memref operand
+llvm::Optional<unsigned> GetKernelArgNumber(gpu::GPUFuncOp funcOp, Value memref)
+{
+    while (auto op = memref.getDefiningOp())
+    {
+        auto source = llvm::find_if(op->getOperands(), [](Value operand) { return operand.getType().isa<MemRefType>(); });
+        if (source == op->operand_end())
+        {
+            return llvm::None;
+        }
+        memref = *source;
+    }
+    auto arg = memref.cast<BlockArgument>();
+    if (arg.getOwner() != &funcOp.body().front())
+    {
+        return llvm::None;
+    }
+    return arg.getArgNumber();
+}
+
+// The global memory accesses of the kernel whose consecutive threads are further apart than the elements that each
+// thread accesses, so that a warp needs more memory transactions than the bytes it moves. Consecutive threads run
+// along the first block dimension with more than one thread. The distance is measured between the first two threads
+// of the first block in the first iteration of the loops around the access, and the accesses whose distance isn't
+// known at compile time aren't reported.
+llvm::json::Array GetUncoalescedAccesses(gpu::GPUFuncOp funcOp)
+{
+    std::vector<int64_t> blockSize;
+    if (auto arrayAttr = funcOp->getAttrOfType<ArrayAttr>("blockSize"))
+    {
+        for (auto dim : utilir::ArrayAttrToVector<IntegerAttr>(arrayAttr))
+        {
+            blockSize.push_back(dim.getInt());
+        }
+    }
+    StringRef threadDim = "x";
+    auto fastestDim = llvm::find_if(blockSize, [](int64_t size) { return size > 1; });
+    if (fastestDim != blockSize.end())
+    {
+        threadDim = StringRef("xyz").substr(std::distance(blockSize.begin(), fastestDim), 1);
+    }
+
+    // the largest distance of the loads and of the stores of each array
+    llvm::MapVector<std::pair<unsigned, bool>, std::pair<int64_t, int64_t>> uncoalesced;
+    funcOp.walk([&](Operation* op) {
+        auto access = GetGlobalAccess(op);
+        if (!access)
+        {
+            return;
+        }
+        auto argNumber = GetKernelArgNumber(funcOp, access->memref);
+        llvm::SmallVector<int64_t, 4> strides;
+        int64_t offset;
+        if (!argNumber || failed(getStridesAndOffset(access->memref.getType().cast<MemRefType>(), strides, offset)))
+        {
+            return;
+        }
+
+        int64_t distance = 0;
+        for (auto [index, stride] : llvm::zip(access->indices, strides))
+        {
+            auto first = EvaluateIndex(index, threadDim, 0, blockSize);
+            auto second = EvaluateIndex(index, threadDim, 1, blockSize);
+            if (!first || !second)
+            {
+                return;
+            }
+            if (*first == *second)
+            {
+                continue;
+            }
+            if (ShapedType::isDynamicStrideOrOffset(stride))
+            {
+                return;
+            }
+            distance += (*second - *first) * stride;
+        }
+        distance = std::abs(distance);
+        if (distance <= access->elementsPerAccess)
+        {
+            return;
+        }
+
+        auto& [maxDistance, elementsPerAccess] = uncoalesced[{ *argNumber, access->isStore }];
+        if (distance > maxDistance)
+        {
+            maxDistance = distance;
+            elementsPerAccess = access->elementsPerAccess;
+        }
+    });
+
+    llvm::json::Array accesses;
+    for (auto& [key, value] : uncoalesced)
+    {
+        accesses.push_back(llvm::json::Object{
+            { "array", llvm::formatv("arg{0}", key.first).str() },
+            { "access", key.second ? "store" : "load" },
+            { "thread_dim", threadDim.str() },
+            { "stride", value.first },
+            { "elements_per_access", value.second } });
+    }
+    return accesses;
+}
+
+struct GPUResourceReportPass : public accera::transforms::GPUResourceReportBase<GPUResourceReportPass>
+{
+    GPUResourceReportPass() = default;
+    GPUResourceReportPass(const std::string& reportFilename)
+    {
+        this->reportFilename = reportFilename;
+    }
+
+    void runOnModule() final
+    {
+        auto module = getModule();
+        const auto workgroupMemorySpace = gpu::GPUDialect::getWorkgroupAddressSpace();
+        const auto privateMemorySpace = gpu::GPUDialect::getPrivateAddressSpace();
+
+        llvm::json::Array kernels;
+        module.walk([&](gpu::GPUFuncOp funcOp) {
+            if (!funcOp.isKernel())
+            {
+                return;
+            }
+
+            // Statically-shaped buffers are all the kernels allocate, so their sizes are exact. The registers
+            // that hold scalars are only known once the device compiler has run.
+            int64_t sharedMemoryBytes = 0;
+            int64_t privateMemoryBytes = 0;
+            auto addBuffer = [&](MemRefType type) {
+                if (!type || !type.hasStaticShape())
+                {
+                    return;
+                }
+                if (type.getMemorySpaceAsInt() == workgroupMemorySpace)
+                {
+                    sharedMemoryBytes += GetSizeInBytes(type);
+                }
+                else if (type.getMemorySpaceAsInt() == privateMemorySpace)
+                {
+                    privateMemoryBytes += GetSizeInBytes(type);
+                }
+            };
+
+            for (auto attribution : funcOp.getWorkgroupAttributions())
+            {
+                addBuffer(attribution.getType().dyn_cast<MemRefType>());
+            }
+            for (auto attribution : funcOp.getPrivateAttributions())
+            {
+                addBuffer(attribution.getType().dyn_cast<MemRefType>());
+            }
+
+            llvm::SmallPtrSet<Operation*, 4> globals;
+            funcOp.walk([&](Operation* op) {
+                if (auto allocOp = dyn_cast<memref::AllocOp>(op))
+                {
+                    addBuffer(allocOp.getType());
+                }
+                else if (auto allocaOp = dyn_cast<memref::AllocaOp>(op))
+                {
+                    addBuffer(allocaOp.getType());
+                }
+                else if (auto getGlobalOp = dyn_cast<memref::GetGlobalOp>(op))
+                {
+                    // Shared buffers are globals of the GPU module, count each one once
+                    auto globalOp = dyn_cast_or_null<memref::GlobalOp>(SymbolTable::lookupNearestSymbolFrom(op, getGlobalOp.nameAttr()));
+                    if (globalOp && globals.insert(globalOp).second)
+                    {
+                        addBuffer(globalOp.type().dyn_cast<MemRefType>());
+                    }
+                }
+            });
+
+            kernels.push_back(llvm::json::Object{
+                { "name", funcOp.getName().str() },
+                { "grid_size", GetDims(funcOp, "gridSize") },
+                { "block_size", GetDims(funcOp, "blockSize") },
+                { "shared_memory_bytes", sharedMemoryBytes },
+                { "private_memory_bytes", privateMemoryBytes },
+                { "register_caches", GetRegisterCaches(funcOp) },
+                { "uncoalesced_accesses", GetUncoalescedAccesses(funcOp) } });
+        });
+
+        llvm::json::Value result = llvm::json::Object{ { "kernels", std::move(kernels) } };
+        if (reportFilename.empty())
+        {
+            llvm::errs() << llvm::formatv("{0:2}", result) << "\n";
+            return;
+        }
+
+        std::string error;
+        auto reportFile = mlir::openOutputFile(reportFilename, &error);
+        if (!reportFile)
+        {
+            module.emitError() << error;
+            signalPassFailure();
+            return;
+        }
+        reportFile->os() << llvm::formatv("{0:2}", result) << "\n";
+        reportFile->keep();
+    }
+};
+
+} // namespace
+
+namespace accera::transforms
+{
+std::unique_ptr<mlir::Pass> createGPUResourceReportPass(const std::string& reportFilename)
+{
+    return std::make_unique<GPUResourceReportPass>(reportFilename);
+}
+
+std::unique_ptr<mlir::Pass> createGPUResourceReportPass()
+{
+    return std::make_unique<GPUResourceReportPass>();
+}
+} // namespace accera::transforms
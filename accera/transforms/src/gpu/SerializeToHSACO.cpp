@@ -8,18 +8,168 @@
 
 #include <value/include/MLIREmitterContext.h>
 
+#include <mlir/Dialect/GPU/GPUDialect.h>
 #include <mlir/Dialect/GPU/Passes.h>
+#include <mlir/Target/LLVMIR/Dialect/LLVMIR/LLVMToLLVMIRTranslation.h>
+#include <mlir/Target/LLVMIR/Dialect/ROCDL/ROCDLToLLVMIRTranslation.h>
+#include <mlir/Target/LLVMIR/Export.h>
+
+#include <lld/Common/Driver.h>
+
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/FileUtilities.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/TargetRegistry.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
 
 #include <memory>
+#include <mutex>
+#include <optional>
+
+using namespace mlir;
+
+namespace
+{
+// ref: mlir/lib/Dialect/GPU/Transforms/SerializeToHsaco.cpp
+constexpr auto kAMDGPUTriple = "amdgcn-amd-amdhsa";
 
 class SerializeToHsacoPass : public accera::transforms::SerializeToHSACOBase<SerializeToHsacoPass>
 {
 public:
+    SerializeToHsacoPass() = default;
+    SerializeToHsacoPass(std::string chip_)
+    {
+        chip = chip_;
+    }
+
+    void getDependentDialects(DialectRegistry& registry) const override
+    {
+        SerializeToHSACOBase::getDependentDialects(registry);
+        registerLLVMDialectTranslation(registry);
+        registerROCDLDialectTranslation(registry);
+    }
+
     void runOnOperation() override
     {
-        // noop
+        auto gpuModule = getOperation();
+
+        llvm::LLVMContext llvmContext;
+        auto llvmModule = translateModuleToLLVMIR(gpuModule, llvmContext, "LLVMDialectModule");
+        if (!llvmModule)
+        {
+            gpuModule.emitError("Failed to translate the GPU module to LLVM IR");
+            return signalPassFailure();
+        }
+
+        auto targetMachine = CreateTargetMachine();
+        if (!targetMachine)
+        {
+            return signalPassFailure();
+        }
+        llvmModule->setTargetTriple(kAMDGPUTriple);
+        llvmModule->setDataLayout(targetMachine->createDataLayout());
+
+        auto object = EmitObject(*llvmModule, *targetMachine);
+        if (!object)
+        {
+            gpuModule.emitError("Failed to emit the AMDGPU object");
+            return signalPassFailure();
+        }
+
+        auto hsaco = LinkHsaco(*object);
+        if (!hsaco)
+        {
+            gpuModule.emitError("Failed to link the HSACO code object");
+            return signalPassFailure();
+        }
+
+        // The code object is embedded in the host module by the GPU to LLVM conversion, which
+        // loads it with hipModuleLoadData through the ROCm runtime wrappers
+        gpuModule->setAttr(gpu::getDefaultGpuBinaryAnnotation(), StringAttr::get(&getContext(), *hsaco));
+    }
+
+private:
+    std::unique_ptr<llvm::TargetMachine> CreateTargetMachine()
+    {
+        std::string error;
+        const llvm::Target* target = llvm::TargetRegistry::lookupTarget(kAMDGPUTriple, error);
+        if (target == nullptr)
+        {
+            getOperation().emitError("Couldn't create the AMDGPU target: ") << error;
+            return {};
+        }
+        return std::unique_ptr<llvm::TargetMachine>(target->createTargetMachine(kAMDGPUTriple,
+                                                                                chip,
+                                                                                /* features */ "",
+                                                                                llvm::TargetOptions{},
+                                                                                llvm::Reloc::PIC_,
+                                                                                llvm::None,
+                                                                                llvm::CodeGenOpt::Aggressive));
+    }
+
+    std::optional<std::string> EmitObject(llvm::Module& llvmModule, llvm::TargetMachine& targetMachine)
+    {
+        std::string object;
+        {
+            llvm::raw_string_ostream stream(object);
+            llvm::buffer_ostream bufferStream(stream);
+            llvm::legacy::PassManager codegenPasses;
+            if (targetMachine.addPassesToEmitFile(codegenPasses, bufferStream, nullptr, llvm::CGFT_ObjectFile))
+            {
+                return std::nullopt;
+            }
+            codegenPasses.run(llvmModule);
+        }
+        return object;
+    }
+
+    std::optional<std::string> LinkHsaco(const std::string& object)
+    {
+        // lld only links files, so the object and the code object go through temporary files
+        int objectFd = -1;
+        llvm::SmallString<128> objectPath;
+        if (llvm::sys::fs::createTemporaryFile("kernel", "o", objectFd, objectPath))
+        {
+            return std::nullopt;
+        }
+        llvm::FileRemover objectRemover(objectPath);
+        {
+            llvm::raw_fd_ostream objectStream(objectFd, /* shouldClose */ true);
+            objectStream << object;
+        }
+
+        llvm::SmallString<128> hsacoPath;
+        if (llvm::sys::fs::createTemporaryFile("kernel", "hsaco", hsacoPath))
+        {
+            return std::nullopt;
+        }
+        llvm::FileRemover hsacoRemover(hsacoPath);
+
+        {
+            // lld is not thread-safe
+            static std::mutex lldMutex;
+            std::lock_guard<std::mutex> lock(lldMutex);
+            if (!lld::elf::link({ "ld.lld", "-shared", objectPath.c_str(), "-o", hsacoPath.c_str() },
+                                /* canExitEarly */ false,
+                                llvm::outs(),
+                                llvm::errs()))
+            {
+                return std::nullopt;
+            }
+        }
+
+        auto hsacoBuffer = llvm::MemoryBuffer::getFile(hsacoPath, /* isText */ false);
+        if (!hsacoBuffer)
+        {
+            return std::nullopt;
+        }
+        return (*hsacoBuffer)->getBuffer().str();
     }
 };
+} // namespace
 
 namespace accera::transforms
 {
@@ -27,4 +177,9 @@ std::unique_ptr<mlir::OperationPass<mlir::gpu::GPUModuleOp>> createSerializeToHS
 {
     return std::make_unique<SerializeToHsacoPass>();
 }
+
+std::unique_ptr<mlir::OperationPass<mlir::gpu::GPUModuleOp>> createSerializeToHSACOPass(const std::string& chip)
+{
+    return std::make_unique<SerializeToHsacoPass>(chip);
+}
 } // namespace accera::transforms
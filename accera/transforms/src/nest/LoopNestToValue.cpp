@@ -819,6 +819,9 @@ LogicalResult GPUMappedAffineForOpRewrite::matchAndRewrite(mlir::AffineForOp aff
                 return rewriter.create<gpu::BlockIdOp>(loc, rewriter.getIndexType(), "y");
             case Processor::BlockZ:
                 return rewriter.create<gpu::BlockIdOp>(loc, rewriter.getIndexType(), "z");
+            case Processor::Device:
+                // Each device runs the iterations of its partition of the loop
+                return rewriter.create<vir::GPUDevicePartitionOp>(loc, (end - begin) / step);
             case Processor::Sequential:
                 [[fallthrough]];
             default:
@@ -43,6 +43,11 @@ struct LoopNestToValueFuncPass : public accera::transforms::LoopNestToValueFuncB
     {
         printVecOpDetails = options.printVecOpDetails;
         printLoops = options.printLoops;
+        reportVectorization = options.reportVectorization;
+        profileCacheCopies = options.profileCacheCopies;
+        profileLoops = options.profileLoops;
+        profileFunctions = options.profileFunctions;
+        outlineCacheCopies = options.outlineCacheCopies;
     }
 
     void runOnOperation() final
@@ -227,6 +232,13 @@ struct LoopNestToValueFuncPass : public accera::transforms::LoopNestToValueFuncB
                 snapshotter.Snapshot("Canonicalize", vFuncOp);
             }
 
+            if (profileCacheCopies || outlineCacheCopies)
+            {
+                // The cache copies are lowered to loops next, the regions keep the loops of each copy together
+                xptr::addCacheCopyProfileRegions(vFuncOp);
+                snapshotter.Snapshot("CacheCopyProfileRegions", vFuncOp);
+            }
+
             {
                 OwningRewritePatternList patterns(context);
                 xptr::populateExecutionPlanMultiCachePatterns(patterns);
@@ -267,7 +279,24 @@ struct LoopNestToValueFuncPass : public accera::transforms::LoopNestToValueFuncB
 
         snapshotter.Snapshot("PostLoop", vFuncOp);
 
+        if (profileLoops || profileFunctions)
         {
+            // The loops are wrapped before they are versioned, vectorized or parallelized, so that each region times
+            // all the versions of its loop
+            if (profileLoops)
+            {
+                xptr::addLoopProfileRegions(vFuncOp);
+            }
+            if (profileFunctions)
+            {
+                xptr::addFunctionProfileRegion(vFuncOp);
+            }
+            snapshotter.Snapshot("ProfileRegions", vFuncOp);
+        }
+
+        {
+            // Loops whose accesses can be checked once before the loop get a guard-free version first
+            xptr::versionOutOfBoundsAccessLoops(vFuncOp);
             OwningRewritePatternList patterns(context);
             xptr::populateOutOfBoundsAccessHandlingPatterns(patterns);
             (void)applyPatternsAndFoldGreedily(vFuncOp, std::move(patterns));
@@ -289,9 +318,15 @@ struct LoopNestToValueFuncPass : public accera::transforms::LoopNestToValueFuncB
             snapshotter.Snapshot("ExecutionPlanTensorize", vFuncOp);
         }
 
+        {
+            // The values that only depend on outer loops are computed once, and broadcast by the vectorized loops
+            xptr::hoistLoopInvariantOps(vFuncOp);
+            snapshotter.Snapshot("LoopInvariantCodeMotion", vFuncOp);
+        }
+
         {
             OwningRewritePatternList patterns(context);
-            xptr::populateExecutionPlanVectorizePatterns(printVecOpDetails, patterns);
+            xptr::populateExecutionPlanVectorizePatterns(printVecOpDetails, patterns, reportVectorization);
             utilir::FillCanonicalPatternsRecursively(vFuncOp, patterns);
             (void)applyPatternsAndFoldGreedily(vFuncOp, std::move(patterns));
             snapshotter.Snapshot("ExecutionPlanVectorize_Canonicalize", vFuncOp);
@@ -318,6 +353,20 @@ struct LoopNestToValueFuncPass : public accera::transforms::LoopNestToValueFuncB
             (void)applyPatternsAndFoldGreedily(vFuncOp, std::move(patterns));
             snapshotter.Snapshot("ExecutionPlanParallelize", vFuncOp);
         }
+
+        {
+            OwningRewritePatternList patterns(context);
+            xptr::populateExecutionPlanNestedParallelizePatterns(patterns);
+            (void)applyPatternsAndFoldGreedily(vFuncOp, std::move(patterns));
+            snapshotter.Snapshot("ExecutionPlanNestedParallelize", vFuncOp);
+        }
+
+        if (outlineCacheCopies)
+        {
+            // The copies get symbols of their own, which sampling profilers attribute their time to
+            xptr::outlineCacheCopyRegions(vFuncOp);
+            snapshotter.Snapshot("CacheCopyOutlining", vFuncOp);
+        }
     }
 
     tr::IRSnapshotter _intrapassSnapshotter;
@@ -358,6 +407,14 @@ struct NestOpLowering : OpRewritePattern<lnir::NestOp>
         {
             nestFuncOp->setAttr(nestFuncOp.getGPULaunchAttrName(), launchAttr);
         }
+        if (auto persistentBlocksAttr = execPlanOp->getAttr(accera::ir::GPUPersistentBlocksAttrName))
+        {
+            nestFuncOp->setAttr(accera::ir::GPUPersistentBlocksAttrName, persistentBlocksAttr);
+        }
+        if (auto streamKDimAttr = execPlanOp->getAttr(accera::ir::GPUStreamKDimAttrName))
+        {
+            nestFuncOp->setAttr(accera::ir::GPUStreamKDimAttrName, streamKDimAttr);
+        }
 
         auto vectorizationInfoIdentifier = rewriter.getIdentifier(xpir::VectorizationInfoAttr::getKeyName());
         if (auto vectorizationInfoAttr = execPlanOp->getAttr(vectorizationInfoIdentifier))
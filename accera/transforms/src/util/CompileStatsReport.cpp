@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "util/CompileStatsReport.h"
+
+#include <mlir/Dialect/GPU/GPUDialect.h>
+#include <mlir/IR/BuiltinOps.h>
+#include <mlir/IR/FunctionSupport.h>
+#include <mlir/IR/SymbolTable.h>
+#include <mlir/Pass/Pass.h>
+#include <mlir/Support/FileUtilities.h>
+
+#include <llvm/Support/FormatVariadic.h>
+#include <llvm/Support/JSON.h>
+#include <llvm/Support/ToolOutputFile.h>
+
+#include <chrono>
+
+using namespace mlir;
+
+namespace accera::transforms
+{
+struct CompileStatsReport::State
+{
+    std::string reportFilename;
+    std::chrono::steady_clock::time_point stageStart;
+    llvm::json::Array stages;
+};
+
+namespace
+{
+    std::string GetFunctionName(Operation* op)
+    {
+        auto name = op->getAttrOfType<StringAttr>(SymbolTable::getSymbolAttrName()).getValue().str();
+
+        // Kernels are named after their GPU module, since the host function that launches them can have the same name
+        if (auto gpuModule = dyn_cast_or_null<gpu::GPUModuleOp>(op->getParentOp()))
+        {
+            name = gpuModule.getName().str() + "::" + name;
+        }
+        return name;
+    }
+
+    struct CompileStatsStartPass : public PassWrapper<CompileStatsStartPass, OperationPass<ModuleOp>>
+    {
+        CompileStatsStartPass(std::shared_ptr<CompileStatsReport::State> state) :
+            _state(std::move(state)) {}
+
+        void runOnOperation() final
+        {
+            _state->stages = {};
+            _state->stageStart = std::chrono::steady_clock::now();
+            markAllAnalysesPreserved();
+        }
+
+        std::shared_ptr<CompileStatsReport::State> _state;
+    };
+
+    struct CompileStatsStagePass : public PassWrapper<CompileStatsStagePass, OperationPass<ModuleOp>>
+    {
+        CompileStatsStagePass(std::shared_ptr<CompileStatsReport::State> state, const std::string& stageName) :
+            _state(std::move(state)), _stageName(stageName) {}
+
+        void runOnOperation() final
+        {
+            auto stageEnd = std::chrono::steady_clock::now();
+            auto module = getOperation();
+            markAllAnalysesPreserved();
+
+            int64_t totalOps = 0;
+            llvm::json::Object functions;
+            module.walk([&](Operation* op) {
+                if (!op->hasTrait<OpTrait::FunctionLike>() || op->getRegion(0).empty())
+                {
+                    return;
+                }
+
+                int64_t functionOps = 0;
+                op->walk([&](Operation*) { ++functionOps; });
+                --functionOps; // the function itself
+                functions[GetFunctionName(op)] = functionOps;
+                totalOps += functionOps;
+            });
+
+            _state->stages.push_back(llvm::json::Object{
+                { "stage", _stageName },
+                { "elapsed_ms", std::chrono::duration<double, std::milli>(stageEnd - _state->stageStart).count() },
+                { "total_ops", totalOps },
+                { "functions", std::move(functions) } });
+
+            std::string error;
+            auto reportFile = openOutputFile(_state->reportFilename, &error);
+            if (!reportFile)
+            {
+                module.emitError() << error;
+                signalPassFailure();
+                return;
+            }
+            reportFile->os() << llvm::formatv("{0:2}", llvm::json::Value(llvm::json::Object{ { "stages", llvm::json::Array(_state->stages) } })) << "\n";
+            reportFile->keep();
+
+            // The report isn't part of the stage that follows
+            _state->stageStart = std::chrono::steady_clock::now();
+        }
+
+        std::shared_ptr<CompileStatsReport::State> _state;
+        std::string _stageName;
+    };
+} // namespace
+
+CompileStatsReport::CompileStatsReport(const std::string& reportFilename) :
+    _state(std::make_shared<State>())
+{
+    _state->reportFilename = reportFilename;
+}
+
+std::unique_ptr<mlir::Pass> CompileStatsReport::CreateStartPass()
+{
+    return std::make_unique<CompileStatsStartPass>(_state);
+}
+
+std::unique_ptr<mlir::Pass> CompileStatsReport::CreateStagePass(const std::string& stageName)
+{
+    return std::make_unique<CompileStatsStagePass>(_state, stageName);
+}
+
+} // namespace accera::transforms
@@ -20,9 +20,13 @@
 #include <mlir/Dialect/Vector/VectorOps.h>
 #include <mlir/Dialect/Vector/VectorUtils.h>
 
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/SetVector.h>
 #include <llvm/ADT/TypeSwitch.h>
+#include <llvm/Support/MathExtras.h>
 
 #include <algorithm>
+#include <limits>
 #include <map>
 #include <stdexcept>
 
@@ -109,7 +113,12 @@ bool CanVectorizeOp(mlir::Operation* op,
             .Case([](mlir::AffineStoreOp) { return true; })
             .Case([](mlir::SelectOp) { return true; })
             .Case([](mlir::ShiftLeftOp) { return true; })
+            .Case([](mlir::SignedShiftRightOp) { return true; })
+            .Case([](mlir::UnsignedShiftRightOp) { return true; })
             .Case([](mlir::FPToSIOp) { return true; })
+            .Case([](mlir::SIToFPOp) { return true; })
+            .Case([](mlir::FPExtOp) { return true; })
+            .Case([](mlir::FPTruncOp) { return true; })
             .Case([](mlir::AbsFOp) { return true; })
             // .Case([&](mlir::AffineApplyOp) { return true; }) // TODO: either enable or remove this
             .Case([](mlir::math::ExpOp) { return true; })
@@ -117,6 +126,7 @@ bool CanVectorizeOp(mlir::Operation* op,
             .Case([](v::BinOp) { return true; })
             .Case([](v::CmpOp) { return true; })
             .Case([](v::ReferenceGlobalOp) { return true; })
+            .Case([](v::TableLookupOp) { return true; })
             .Default([&](mlir::Operation* defaultOp) {
                 return false;
             });
@@ -253,13 +263,61 @@ std::optional<mlir::Operation*> VectorizeConstantOp(mlir::PatternRewriter& rewri
     return constVec;
 }
 
+// The memory offsets of the unrolled lanes of an access relative to the first lane's access, in elements.
+// Each offset is an affine map over the operands that the lanes index the memref with.
+struct UnrolledAccessOffsets
+{
+    std::vector<mlir::AffineMap> maps;
+    std::vector<llvm::SmallVector<mlir::Value, 4>> operands;
+
+    std::optional<int64_t> GetConstantOffset(size_t lane) const
+    {
+        auto resultExpr = maps[lane].getResult(0);
+        if (auto constExpr = resultExpr.dyn_cast<mlir::AffineConstantExpr>())
+        {
+            return constExpr.getValue();
+        }
+        return std::nullopt;
+    }
+
+    bool AreConstant() const
+    {
+        for (size_t lane = 0; lane < maps.size(); ++lane)
+        {
+            if (!GetConstantOffset(lane))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Returns the distance between the accesses of consecutive lanes, if the lanes are evenly spaced in memory
+    std::optional<int64_t> GetConstantStride() const
+    {
+        if (maps.size() < 2)
+        {
+            return 1;
+        }
+        auto stride = GetConstantOffset(1);
+        for (size_t lane = 2; stride && lane < maps.size(); ++lane)
+        {
+            if (GetConstantOffset(lane) != static_cast<int64_t>(lane) * *stride)
+            {
+                return std::nullopt;
+            }
+        }
+        return stride;
+    }
+};
+
 template <typename OpType>
-bool IsUnrolledAccessSequential(mlir::PatternRewriter& rewriter,
-                                OpType op,
-                                std::vector<mlir::BlockAndValueMapping>& laneMappings,
-                                int64_t vectorSize)
+std::optional<UnrolledAccessOffsets> GetUnrolledAccessOffsets(mlir::PatternRewriter& rewriter,
+                                                              OpType op,
+                                                              std::vector<mlir::BlockAndValueMapping>& laneMappings,
+                                                              int64_t vectorSize)
 {
-    // Create some unrolled clones in-memory and see whether they are accessing memory-sequential elements in the MemRef
+    // Create some unrolled clones in-memory and see which memory locations they access in the MemRef
     auto loc = op.getLoc();
     std::vector<OpType> temporaryClones;
     temporaryClones.reserve(vectorSize);
@@ -268,65 +326,208 @@ bool IsUnrolledAccessSequential(mlir::PatternRewriter& rewriter,
         temporaryClones.push_back(mlir::dyn_cast<OpType>(rewriter.clone(*op.getOperation(), laneMappings[i])));
     }
 
-    // Check if the temporary clones are all accessing sequential memory
     auto accessMapComposition = ir::util::GetIndexToMemoryLocationMap(rewriter.getContext(), op);
 
-    if (accessMapComposition.getNumSymbols() > 0)
+    std::optional<UnrolledAccessOffsets> result;
+    // TODO : support for memref maps with symbols
+    // The memref maps can have symbols in them following some SubView / linalg.slice uses,
+    // however the symbol that ought to be used isn't plumbed through so we don't know what
+    // to provide for that here when composing maps
+    // So to favor safety, don't compute offsets here so we're left with a simple unroll
+    if (accessMapComposition.getNumSymbols() == 0)
     {
-        // TODO : support for this case
-        // The memref maps can have symbols in them following some SubView / linalg.slice uses,
-        // however the symbol that ought to be used isn't plumbed through so we don't know what
-        // to provide for that here when composing maps
-        // So to favor safety, return false here so we're left with a simple unroll
-        return false;
+        result = UnrolledAccessOffsets{};
+        std::vector<mlir::Value> firstIndicesVec(temporaryClones[0].indices().begin(), temporaryClones[0].indices().end());
+        auto firstAccess = ir::util::MultiDimAffineApply(rewriter, loc, accessMapComposition, firstIndicesVec);
+        assert(firstAccess.size() == 1);
+        for (int64_t unrollIdx = 0; unrollIdx < vectorSize; ++unrollIdx)
+        {
+            std::vector<mlir::Value> currentIndicesVec(temporaryClones[unrollIdx].indices().begin(), temporaryClones[unrollIdx].indices().end());
+            auto currentAccess = ir::util::MultiDimAffineApply(rewriter, loc, accessMapComposition, currentIndicesVec);
+            assert(currentAccess.size() == 1);
+
+            mlir::AffineExpr diffExpr = rewriter.getAffineDimExpr(1) - rewriter.getAffineDimExpr(0);
+            auto diffMap = mlir::AffineMap::get(2, 0, diffExpr);
+
+            llvm::SmallVector<mlir::Value, 4> compareAccesses{ firstAccess[0], currentAccess[0] };
+            mlir::fullyComposeAffineMapAndOperands(&diffMap, &compareAccesses);
+            assert(diffMap.getNumResults() == 1);
+
+            result->maps.push_back(diffMap);
+            result->operands.push_back(compareAccesses);
+        }
     }
 
-    bool sequential = true;
-    for (size_t unrollIdx = 1; unrollIdx < vectorSize; ++unrollIdx)
+    // Clean up the temporary clones
+    for (auto& clone : temporaryClones)
     {
-        std::vector<mlir::Value> prevIndicesVec(temporaryClones[unrollIdx - 1].indices().begin(), temporaryClones[unrollIdx - 1].indices().end());
-        std::vector<mlir::Value> currentIndicesVec(temporaryClones[unrollIdx].indices().begin(), temporaryClones[unrollIdx].indices().end());
-        auto prevAccess = ir::util::MultiDimAffineApply(rewriter, loc, accessMapComposition, prevIndicesVec);
-        auto currentAccess = ir::util::MultiDimAffineApply(rewriter, loc, accessMapComposition, currentIndicesVec);
-        assert(prevAccess.size() == 1);
-        assert(currentAccess.size() == 1);
+        rewriter.eraseOp(clone);
+    }
+    return result;
+}
 
-        mlir::AffineExpr diffExpr = rewriter.getAffineDimExpr(1) - rewriter.getAffineDimExpr(0);
-        auto diffMap = mlir::AffineMap::get(2, 0, diffExpr);
+template <typename OpType>
+bool IsUnrolledAccessSequential(mlir::PatternRewriter& rewriter,
+                                OpType op,
+                                std::vector<mlir::BlockAndValueMapping>& laneMappings,
+                                int64_t vectorSize)
+{
+    // Only a constant stride of 1 between the lanes' accesses makes the memory contiguous, so that
+    // it's safe to replace all of the memory ops with a single vector op
+    auto offsets = GetUnrolledAccessOffsets(rewriter, op, laneMappings, vectorSize);
+    return offsets && offsets->GetConstantStride() == 1;
+}
+
+// The ways to vectorize the unrolled lanes of a memory access
+enum class VectorAccessKind
+{
+    Contiguous, // a single vector transfer
+    Shuffled, // a contiguous transfer of the span of the lanes, permuted to or from the lanes
+    GatherScatter, // a gather or scatter with per-lane offsets
+    Unrolled // a scalar access per lane
+};
+
+// Returns the cheapest way to vectorize a load or store with the given lane offsets
+VectorAccessKind GetVectorAccessKind(mlir::MemRefType memRefType, const std::optional<UnrolledAccessOffsets>& offsets, int64_t vectorSize, bool isStore)
+{
+    if (!offsets)
+    {
+        return VectorAccessKind::Unrolled;
+    }
 
-        mlir::SmallVector<mlir::Value, 4> compareAccesses{ prevAccess[0], currentAccess[0] };
-        mlir::fullyComposeAffineMapAndOperands(&diffMap, &compareAccesses);
+    auto stride = offsets->GetConstantStride();
+    if (stride == 1)
+    {
+        return VectorAccessKind::Contiguous;
+    }
+
+    // Masked transfers, gathers and scatters are lowered off of a pointer to the first lane's element in the
+    // default memory space, so the lanes' offsets have to be offsets in memory
+    int64_t memRefOffset;
+    llvm::SmallVector<int64_t, 4> strides;
+    if (failed(mlir::getStridesAndOffset(memRefType, strides, memRefOffset)) || strides.empty() || strides.back() != 1 || memRefType.getMemorySpaceAsInt() != 0)
+    {
+        return VectorAccessKind::Unrolled;
+    }
 
-        assert(diffMap.getNumResults() == 1);
-        auto resultExpr = diffMap.getResult(0);
-        if (resultExpr.isa<mlir::AffineConstantExpr>())
+    // Rough costs in instructions per vector:
+    //  - unrolled: a scalar memory op and an insert / extract per lane
+    //  - shuffled: the whole vectors spanned by the lanes, plus about as many permutes or blends
+    //  - gather: about two elements per instruction on targets with hardware gathers (AVX2, AVX-512)
+    //  - scatter: about one element per instruction on targets with hardware scatters (AVX-512)
+    //  - gathers and scatters also compute and insert the lane offsets that aren't known at compile time
+    // Targets without hardware gathers or scatters lower them back to about the unrolled sequence
+    // Ties keep the earlier of these
+    auto bestKind = VectorAccessKind::Unrolled;
+    int64_t bestCost = 2 * vectorSize;
+
+    if (stride && *stride > 1)
+    {
+        auto span = (vectorSize - 1) * *stride + 1;
+        auto shuffledCost = 2 * ((span + vectorSize - 1) / vectorSize);
+        if (shuffledCost < bestCost)
         {
-            auto constExpr = resultExpr.dyn_cast<mlir::AffineConstantExpr>();
-            if (constExpr.getValue() != 1)
-            {
-                // There is a constant difference between sequential op memory accesses
-                // but the stride is not 1, so the memory isn't contiguous and therefore
-                // it's not safe to replace all of the memory ops with a single vector op
-                sequential = false;
-                break;
-            }
+            bestKind = VectorAccessKind::Shuffled;
+            bestCost = shuffledCost;
         }
-        else
+    }
+
+    auto offsetsCost = offsets->AreConstant() ? 0 : vectorSize;
+    auto gatherScatterCost = (isStore ? vectorSize : vectorSize / 2) + offsetsCost;
+    if (gatherScatterCost < bestCost)
+    {
+        bestKind = VectorAccessKind::GatherScatter;
+        bestCost = gatherScatterCost;
+    }
+    return bestKind;
+}
+
+mlir::Value CreateConstantMask(mlir::PatternRewriter& rewriter, mlir::Location loc, llvm::ArrayRef<bool> maskValues)
+{
+    auto maskType = mlir::VectorType::get({ static_cast<int64_t>(maskValues.size()) }, rewriter.getI1Type());
+    return rewriter.create<mlir::ConstantOp>(loc, maskType, mlir::DenseElementsAttr::get(maskType, maskValues));
+}
+
+// Reads the span of memory between the first and last lane and picks out every stride-th element of it
+mlir::Value CreateShuffledLoad(mlir::PatternRewriter& rewriter, mlir::Location loc, mlir::Value memref, mlir::ValueRange indices, mlir::VectorType vectorType, int64_t stride)
+{
+    auto vectorSize = vectorType.getNumElements();
+    auto spanType = mlir::VectorType::get({ (vectorSize - 1) * stride + 1 }, vectorType.getElementType());
+    llvm::SmallVector<bool, 4> inBounds = { true };
+    mlir::Value span = rewriter.create<mlir::vector::TransferReadOp>(loc, spanType, memref, indices, inBounds);
+
+    llvm::SmallVector<int64_t, 16> laneElements;
+    for (int64_t i = 0; i < vectorSize; ++i)
+    {
+        laneElements.push_back(i * stride);
+    }
+    return rewriter.create<mlir::vector::ShuffleOp>(loc, span, span, laneElements);
+}
+
+// Spreads the lanes out over the span of memory between the first and last lane, and only writes the lanes' elements
+mlir::Operation* CreateShuffledStore(mlir::PatternRewriter& rewriter, mlir::Location loc, mlir::Value valueToStore, mlir::Value memref, mlir::ValueRange indices, int64_t stride)
+{
+    auto vectorSize = valueToStore.getType().cast<mlir::VectorType>().getNumElements();
+    auto spanSize = (vectorSize - 1) * stride + 1;
+    llvm::SmallVector<int64_t, 16> spanElements;
+    llvm::SmallVector<bool, 16> spanMask;
+    for (int64_t i = 0; i < spanSize; ++i)
+    {
+        bool isLane = i % stride == 0;
+        spanElements.push_back(isLane ? i / stride : 0);
+        spanMask.push_back(isLane);
+    }
+    auto span = rewriter.create<mlir::vector::ShuffleOp>(loc, valueToStore, valueToStore, spanElements);
+    auto mask = CreateConstantMask(rewriter, loc, spanMask);
+    return rewriter.create<mlir::vector::MaskedStoreOp>(loc, memref, indices, mask, span);
+}
+
+// Returns a vector of the lanes' offsets relative to the first lane, for a gather or scatter
+mlir::Value CreateLaneOffsetVector(mlir::PatternRewriter& rewriter, mlir::Location loc, mlir::MemRefType memRefType, const UnrolledAccessOffsets& offsets)
+{
+    // 32-bit offsets let AVX2 / AVX-512 gather twice as many lanes per instruction as 64-bit ones
+    int64_t vectorSize = offsets.maps.size();
+    bool fitsInI32 = memRefType.hasStaticShape() && memRefType.getAffineMaps().empty() && memRefType.getNumElements() <= std::numeric_limits<int32_t>::max();
+    auto offsetType = fitsInI32 ? rewriter.getI32Type() : rewriter.getI64Type();
+    auto offsetVectorType = mlir::VectorType::get({ vectorSize }, offsetType);
+
+    if (offsets.AreConstant())
+    {
+        llvm::SmallVector<mlir::Attribute, 16> offsetValues;
+        for (int64_t lane = 0; lane < vectorSize; ++lane)
         {
-            // There isn't a constant difference between sequential op memory accesses
-            // so it's not necessarily safe to convert all of the memory ops into a single
-            // vector op
-            sequential = false;
-            break;
+            offsetValues.push_back(rewriter.getIntegerAttr(offsetType, *offsets.GetConstantOffset(lane)));
         }
+        return rewriter.create<mlir::ConstantOp>(loc, offsetVectorType, mlir::DenseElementsAttr::get(offsetVectorType, offsetValues));
     }
 
-    // Clean up the temporary clones
-    for (auto& clone : temporaryClones)
+    mlir::Value result = rewriter.create<mlir::ConstantOp>(loc, offsetVectorType, rewriter.getZeroAttr(offsetVectorType));
+    for (int64_t lane = 0; lane < vectorSize; ++lane)
     {
-        rewriter.eraseOp(clone);
+        mlir::Value offset = rewriter.create<mlir::AffineApplyOp>(loc, offsets.maps[lane], offsets.operands[lane]);
+        offset = rewriter.create<mlir::IndexCastOp>(loc, offset, offsetType);
+        result = rewriter.create<mlir::vector::InsertElementOp>(loc, offset, result, lane);
     }
-    return sequential;
+    return result;
+}
+
+mlir::Value CreateGather(mlir::PatternRewriter& rewriter, mlir::Location loc, mlir::Value memref, mlir::ValueRange indices, mlir::VectorType vectorType, const UnrolledAccessOffsets& offsets)
+{
+    auto memRefType = memref.getType().cast<mlir::MemRefType>();
+    auto offsetVector = CreateLaneOffsetVector(rewriter, loc, memRefType, offsets);
+    auto mask = CreateConstantMask(rewriter, loc, llvm::SmallVector<bool, 16>(vectorType.getNumElements(), true));
+    auto zero = rewriter.create<mlir::ConstantOp>(loc, vectorType.getElementType(), rewriter.getZeroAttr(vectorType.getElementType()));
+    auto passThru = rewriter.create<mlir::vector::BroadcastOp>(loc, vectorType, zero);
+    return rewriter.create<mlir::vector::GatherOp>(loc, vectorType, memref, indices, offsetVector, mask, passThru);
+}
+
+mlir::Operation* CreateScatter(mlir::PatternRewriter& rewriter, mlir::Location loc, mlir::Value valueToStore, mlir::Value memref, mlir::ValueRange indices, const UnrolledAccessOffsets& offsets)
+{
+    auto memRefType = memref.getType().cast<mlir::MemRefType>();
+    auto vectorSize = valueToStore.getType().cast<mlir::VectorType>().getNumElements();
+    auto offsetVector = CreateLaneOffsetVector(rewriter, loc, memRefType, offsets);
+    auto mask = CreateConstantMask(rewriter, loc, llvm::SmallVector<bool, 16>(vectorSize, true));
+    return rewriter.create<mlir::vector::ScatterOp>(loc, memref, indices, offsetVector, mask, valueToStore);
 }
 
 std::optional<VectorizedOp> VectorizeLoadOp(mlir::PatternRewriter& rewriter,
@@ -344,15 +545,24 @@ std::optional<VectorizedOp> VectorizeLoadOp(mlir::PatternRewriter& rewriter,
     mlir::memref::LoadOpAdaptor adaptor{ op };
 
     std::vector<mlir::Value> indices(adaptor.indices().begin(), adaptor.indices().end());
-    bool isSequential = IsUnrolledAccessSequential(rewriter, op, laneMappings, vectorSize);
+    auto offsets = GetUnrolledAccessOffsets(rewriter, op, laneMappings, vectorSize);
+    auto accessKind = GetVectorAccessKind(memRefType, offsets, vectorSize, /*isStore=*/false);
 
     mlir::Value result;
 
-    if (isSequential)
+    if (accessKind == VectorAccessKind::Contiguous)
     {
         llvm::SmallVector<bool, 4> inBounds = { true };
         result = rewriter.create<mlir::vector::TransferReadOp>(op.getLoc(), vectorType, op.memref(), indices, inBounds);
     }
+    else if (accessKind == VectorAccessKind::Shuffled)
+    {
+        result = CreateShuffledLoad(rewriter, loc, op.memref(), indices, vectorType, *offsets->GetConstantStride());
+    }
+    else if (accessKind == VectorAccessKind::GatherScatter)
+    {
+        result = CreateGather(rewriter, loc, op.memref(), indices, vectorType, *offsets);
+    }
     else
     {
         // Fall back to many loads and stores into a vector
@@ -384,7 +594,7 @@ std::optional<VectorizedOp> VectorizeStoreOp(mlir::PatternRewriter& rewriter,
         return std::nullopt;
     }
 
-    [[maybe_unused]] auto loc = op.getLoc();
+    auto loc = op.getLoc();
     auto memRefType = op.getMemRefType();
     [[maybe_unused]] auto elementType = memRefType.getElementType();
 
@@ -392,14 +602,23 @@ std::optional<VectorizedOp> VectorizeStoreOp(mlir::PatternRewriter& rewriter,
     auto vectorizedValueToStore = vecOp->GetVectorResult();
 
     std::vector<mlir::Value> indices(adaptor.indices().begin(), adaptor.indices().end());
-    bool isSequential = IsUnrolledAccessSequential(rewriter, op, laneMappings, vectorSize);
+    auto offsets = GetUnrolledAccessOffsets(rewriter, op, laneMappings, vectorSize);
+    auto accessKind = GetVectorAccessKind(memRefType, offsets, vectorSize, /*isStore=*/true);
 
-    if (isSequential)
+    if (accessKind == VectorAccessKind::Contiguous)
     {
         llvm::SmallVector<bool, 4> inBounds = { true };
         mlir::Operation* storeOp = rewriter.create<mlir::vector::TransferWriteOp>(op.getLoc(), vectorizedValueToStore, op.memref(), indices, inBounds);
         return storeOp;
     }
+    else if (accessKind == VectorAccessKind::Shuffled)
+    {
+        return CreateShuffledStore(rewriter, loc, vectorizedValueToStore, op.memref(), indices, *offsets->GetConstantStride());
+    }
+    else if (accessKind == VectorAccessKind::GatherScatter)
+    {
+        return CreateScatter(rewriter, loc, vectorizedValueToStore, op.memref(), indices, *offsets);
+    }
     else
     {
         std::vector<mlir::Operation*> storeOps;
@@ -431,15 +650,24 @@ std::optional<VectorizedOp> VectorizeAffineLoadOp(mlir::PatternRewriter& rewrite
     std::vector<mlir::Value> baseIndices(adaptor.indices().begin(), adaptor.indices().end());
     auto indices = ir::util::MultiDimAffineApply(rewriter, loc, op.getAffineMap(), baseIndices);
 
-    bool isSequential = IsUnrolledAccessSequential(rewriter, op, laneMappings, vectorSize);
+    auto offsets = GetUnrolledAccessOffsets(rewriter, op, laneMappings, vectorSize);
+    auto accessKind = GetVectorAccessKind(memRefType, offsets, vectorSize, /*isStore=*/false);
 
     mlir::Value result;
 
-    if (isSequential)
+    if (accessKind == VectorAccessKind::Contiguous)
     {
         llvm::SmallVector<bool, 4> inBounds = { true };
         result = rewriter.create<mlir::vector::TransferReadOp>(op.getLoc(), vectorType, op.memref(), indices, inBounds);
     }
+    else if (accessKind == VectorAccessKind::Shuffled)
+    {
+        result = CreateShuffledLoad(rewriter, loc, op.memref(), indices, vectorType, *offsets->GetConstantStride());
+    }
+    else if (accessKind == VectorAccessKind::GatherScatter)
+    {
+        result = CreateGather(rewriter, loc, op.memref(), indices, vectorType, *offsets);
+    }
     else
     {
         // Fall back to many loads and stores into a vector
@@ -471,7 +699,7 @@ std::optional<VectorizedOp> VectorizeAffineStoreOp(mlir::PatternRewriter& rewrit
         return std::nullopt;
     }
 
-    [[maybe_unused]] auto loc = op.getLoc();
+    auto loc = op.getLoc();
     auto memRefType = op.getMemRefType();
     [[maybe_unused]] auto elementType = memRefType.getElementType();
 
@@ -481,14 +709,23 @@ std::optional<VectorizedOp> VectorizeAffineStoreOp(mlir::PatternRewriter& rewrit
     std::vector<mlir::Value> baseIndices(adaptor.indices().begin(), adaptor.indices().end());
     auto indices = ir::util::MultiDimAffineApply(rewriter, loc, op.getAffineMap(), baseIndices);
 
-    bool isSequential = IsUnrolledAccessSequential(rewriter, op, laneMappings, vectorSize);
+    auto offsets = GetUnrolledAccessOffsets(rewriter, op, laneMappings, vectorSize);
+    auto accessKind = GetVectorAccessKind(memRefType, offsets, vectorSize, /*isStore=*/true);
 
-    if (isSequential)
+    if (accessKind == VectorAccessKind::Contiguous)
     {
         llvm::SmallVector<bool, 4> inBounds = { true };
         mlir::Operation* storeOp = rewriter.create<mlir::vector::TransferWriteOp>(op.getLoc(), vectorizedValueToStore, op.memref(), indices, inBounds);
         return storeOp;
     }
+    else if (accessKind == VectorAccessKind::Shuffled)
+    {
+        return CreateShuffledStore(rewriter, loc, vectorizedValueToStore, op.memref(), indices, *offsets->GetConstantStride());
+    }
+    else if (accessKind == VectorAccessKind::GatherScatter)
+    {
+        return CreateScatter(rewriter, loc, vectorizedValueToStore, op.memref(), indices, *offsets);
+    }
     else
     {
         std::vector<mlir::Operation*> storeOps;
@@ -575,6 +812,53 @@ std::optional<mlir::Operation*> VectorizeShiftLeftOp(mlir::PatternRewriter& rewr
     return result;
 }
 
+template <typename ShiftOpType>
+std::optional<mlir::Operation*> VectorizeShiftRightOp(mlir::PatternRewriter& rewriter,
+                                                      ShiftOpType op,
+                                                      const VectorizedOpMap& vectorizedOps,
+                                                      std::vector<mlir::BlockAndValueMapping>& laneMappings,
+                                                      mlir::Value inductionVar,
+                                                      int64_t step,
+                                                      int64_t vectorSize)
+{
+    // Get (vector) arguments from map
+    auto lhs = GetVectorizedPredecessor(rewriter, op.lhs(), vectorizedOps, laneMappings, inductionVar, step, vectorSize);
+    auto rhs = GetVectorizedPredecessor(rewriter, op.rhs(), vectorizedOps, laneMappings, inductionVar, step, vectorSize);
+    if (!lhs || !rhs)
+    {
+        return std::nullopt;
+    }
+
+    auto loc = op.getLoc();
+    auto result = rewriter.create<ShiftOpType>(loc, lhs->GetVectorResult(), rhs->GetVectorResult());
+    return result;
+}
+
+// Vectorizes the int-to-float and float-to-float casts
+template <typename CastOpType>
+std::optional<mlir::Operation*> VectorizeCastOp(mlir::PatternRewriter& rewriter,
+                                                CastOpType op,
+                                                const VectorizedOpMap& vectorizedOps,
+                                                std::vector<mlir::BlockAndValueMapping>& laneMappings,
+                                                mlir::Value inductionVar,
+                                                int64_t step,
+                                                int64_t vectorSize)
+{
+    // Get (vector) arguments from map
+    auto inputOp = op.in();
+    auto input = GetVectorizedPredecessor(rewriter, inputOp, vectorizedOps, laneMappings, inductionVar, step, vectorSize);
+    if (!input)
+    {
+        return std::nullopt;
+    }
+
+    auto loc = op.getLoc();
+    auto scalarResultType = op.getResult().getType();
+    auto resultType = mlir::VectorType::get({ vectorSize }, scalarResultType);
+    auto result = rewriter.create<CastOpType>(loc, input->GetVectorResult(), resultType);
+    return result;
+}
+
 std::optional<mlir::Operation*> VectorizeFPToSIOp(mlir::PatternRewriter& rewriter,
                                                   mlir::FPToSIOp op,
                                                   const VectorizedOpMap& vectorizedOps,
@@ -756,6 +1040,35 @@ std::optional<mlir::Operation*> VectorizeReferenceGlobalOp(mlir::PatternRewriter
     return clonedOp;
 }
 
+std::optional<mlir::Operation*> VectorizeTableLookupOp(mlir::PatternRewriter& rewriter,
+                                                       v::TableLookupOp op,
+                                                       const VectorizedOpMap& vectorizedOps,
+                                                       std::vector<mlir::BlockAndValueMapping>& laneMappings,
+                                                       mlir::Value inductionVar,
+                                                       int64_t step,
+                                                       int64_t vectorSize)
+{
+    // The lanes look up their indices in the same table
+    auto tableOp = op.table().getDefiningOp();
+    if (tableOp && inductionVar && ir::util::hasRecursiveUseOfOp(inductionVar, tableOp))
+    {
+        return std::nullopt;
+    }
+
+    auto index = GetVectorizedPredecessor(rewriter, op.index(), vectorizedOps, laneMappings, inductionVar, step, vectorSize);
+    if (!index || !index->HasVectorType())
+    {
+        return std::nullopt;
+    }
+
+    // The lookup instructions of the target are selected by the vectorized loop, see VectorizeAffineForOpConversion
+    auto loc = op.getLoc();
+    auto table = laneMappings[0].lookupOrDefault(op.table());
+    auto resultType = mlir::VectorType::get({ vectorSize }, op.result().getType());
+    auto result = rewriter.create<v::TableLookupOp>(loc, resultType, table, index->GetVectorResult(), op.kind());
+    return result;
+}
+
 std::optional<VectorizedOp> VectorizeOp(mlir::PatternRewriter& rewriter,
                                         mlir::Operation* op,
                                         const VectorizedOpMap& vectorizedOps,
@@ -795,9 +1108,24 @@ std::optional<VectorizedOp> VectorizeOp(mlir::PatternRewriter& rewriter,
             .Case([&](mlir::ShiftLeftOp shiftLeftOp) {
                 return VectorizeShiftLeftOp(rewriter, shiftLeftOp, vectorizedOps, laneMappings, inductionVar, step, vectorSize);
             })
+            .Case([&](mlir::SignedShiftRightOp shiftRightOp) {
+                return VectorizeShiftRightOp(rewriter, shiftRightOp, vectorizedOps, laneMappings, inductionVar, step, vectorSize);
+            })
+            .Case([&](mlir::UnsignedShiftRightOp shiftRightOp) {
+                return VectorizeShiftRightOp(rewriter, shiftRightOp, vectorizedOps, laneMappings, inductionVar, step, vectorSize);
+            })
             .Case([&](mlir::FPToSIOp castOp) {
                 return VectorizeFPToSIOp(rewriter, castOp, vectorizedOps, laneMappings, inductionVar, step, vectorSize);
             })
+            .Case([&](mlir::SIToFPOp castOp) {
+                return VectorizeCastOp(rewriter, castOp, vectorizedOps, laneMappings, inductionVar, step, vectorSize);
+            })
+            .Case([&](mlir::FPExtOp castOp) {
+                return VectorizeCastOp(rewriter, castOp, vectorizedOps, laneMappings, inductionVar, step, vectorSize);
+            })
+            .Case([&](mlir::FPTruncOp castOp) {
+                return VectorizeCastOp(rewriter, castOp, vectorizedOps, laneMappings, inductionVar, step, vectorSize);
+            })
             .Case([&](mlir::AbsFOp absOp) {
                 return VectorizeAbsFOp(rewriter, absOp, vectorizedOps, laneMappings, inductionVar, step, vectorSize);
             })
@@ -816,6 +1144,9 @@ std::optional<VectorizedOp> VectorizeOp(mlir::PatternRewriter& rewriter,
             .Case([&](v::ReferenceGlobalOp refGlobalOp) {
                 return VectorizeReferenceGlobalOp(rewriter, refGlobalOp, vectorizedOps, laneMappings, inductionVar, step, vectorSize);
             })
+            .Case([&](v::TableLookupOp tableLookupOp) {
+                return VectorizeTableLookupOp(rewriter, tableLookupOp, vectorizedOps, laneMappings, inductionVar, step, vectorSize);
+            })
             .Default([&](mlir::Operation* defaultOp) -> std::optional<VectorizedOp> {
                 if (op->getNumResults() > 0)
                 {
@@ -833,4 +1164,473 @@ std::optional<VectorizedOp> VectorizeOp(mlir::PatternRewriter& rewriter,
     return resultOp;
 }
 
+mlir::Value CreateLaneMask(mlir::PatternRewriter& rewriter, mlir::Location loc, int64_t vectorSize, int64_t activeLanes)
+{
+    llvm::SmallVector<bool, 16> maskValues(vectorSize, false);
+    std::fill_n(maskValues.begin(), std::min(activeLanes, vectorSize), true);
+    return CreateConstantMask(rewriter, loc, maskValues);
+}
+
+std::vector<mlir::Value> GetAccessIndices(mlir::PatternRewriter& rewriter, mlir::memref::LoadOp op)
+{
+    return { op.indices().begin(), op.indices().end() };
+}
+
+std::vector<mlir::Value> GetAccessIndices(mlir::PatternRewriter& rewriter, mlir::memref::StoreOp op)
+{
+    return { op.indices().begin(), op.indices().end() };
+}
+
+std::vector<mlir::Value> GetAccessIndices(mlir::PatternRewriter& rewriter, mlir::AffineLoadOp op)
+{
+    std::vector<mlir::Value> baseIndices(op.getMapOperands().begin(), op.getMapOperands().end());
+    return ir::util::MultiDimAffineApply(rewriter, op.getLoc(), op.getAffineMap(), baseIndices);
+}
+
+std::vector<mlir::Value> GetAccessIndices(mlir::PatternRewriter& rewriter, mlir::AffineStoreOp op)
+{
+    std::vector<mlir::Value> baseIndices(op.getMapOperands().begin(), op.getMapOperands().end());
+    return ir::util::MultiDimAffineApply(rewriter, op.getLoc(), op.getAffineMap(), baseIndices);
+}
+
+template <typename OpType>
+std::optional<VectorizedOp> VectorizeMaskedLoadOp(mlir::PatternRewriter& rewriter,
+                                                  OpType op,
+                                                  std::vector<mlir::BlockAndValueMapping>& laneMappings,
+                                                  int64_t vectorSize,
+                                                  int64_t activeLanes)
+{
+    // Only contiguous accesses can be masked, the others are left to be unrolled over the active lanes
+    if (!IsUnrolledAccessSequential(rewriter, op, laneMappings, vectorSize))
+    {
+        return std::nullopt;
+    }
+
+    auto loc = op.getLoc();
+    auto elementType = op.getMemRefType().getElementType();
+    auto vectorType = mlir::VectorType::get({ vectorSize }, elementType);
+    auto indices = GetAccessIndices(rewriter, op);
+    auto mask = CreateLaneMask(rewriter, loc, vectorSize, activeLanes);
+
+    // The masked-off lanes are zero-filled
+    auto zero = rewriter.create<mlir::ConstantOp>(loc, elementType, rewriter.getZeroAttr(elementType));
+    auto passThru = rewriter.create<mlir::vector::BroadcastOp>(loc, vectorType, zero);
+    mlir::Value result = rewriter.create<mlir::vector::MaskedLoadOp>(loc, vectorType, op.memref(), indices, mask, passThru);
+    return result;
+}
+
+template <typename OpType>
+std::optional<VectorizedOp> VectorizeMaskedStoreOp(mlir::PatternRewriter& rewriter,
+                                                   OpType op,
+                                                   const VectorizedOpMap& vectorizedOps,
+                                                   std::vector<mlir::BlockAndValueMapping>& laneMappings,
+                                                   int64_t vectorSize,
+                                                   int64_t activeLanes)
+{
+    auto vecOp = vectorizedOps.Lookup(op.getValueToStore());
+    if (!vecOp || !vecOp->HasVectorType() || !IsUnrolledAccessSequential(rewriter, op, laneMappings, vectorSize))
+    {
+        return std::nullopt;
+    }
+
+    auto loc = op.getLoc();
+    auto indices = GetAccessIndices(rewriter, op);
+    auto mask = CreateLaneMask(rewriter, loc, vectorSize, activeLanes);
+    mlir::Operation* storeOp = rewriter.create<mlir::vector::MaskedStoreOp>(loc, op.memref(), indices, mask, vecOp->GetVectorResult());
+    return storeOp;
+}
+
+std::optional<VectorizedOp> VectorizeOpMasked(mlir::PatternRewriter& rewriter,
+                                              mlir::Operation* op,
+                                              const VectorizedOpMap& vectorizedOps,
+                                              std::vector<mlir::BlockAndValueMapping>& laneMappings,
+                                              mlir::Value inductionVar,
+                                              int64_t step,
+                                              int64_t vectorSize,
+                                              int64_t activeLanes)
+{
+    // Loads that vary with the induction variable must have been vectorized with a mask already, otherwise
+    // vectorizing them here would read the elements of the masked-off lanes
+    for (auto operand : op->getOperands())
+    {
+        auto definingOp = operand.getDefiningOp();
+        if (definingOp && mlir::isa<mlir::memref::LoadOp, mlir::AffineLoadOp>(definingOp) && inductionVar &&
+            ir::util::hasRecursiveUseOfOp(inductionVar, definingOp) && !vectorizedOps.HasMapping(definingOp))
+        {
+            return std::nullopt;
+        }
+    }
+
+    namespace memref = mlir::memref;
+    return mlir::TypeSwitch<mlir::Operation*, std::optional<VectorizedOp>>(op)
+        .Case([&](memref::LoadOp loadOp) {
+            return VectorizeMaskedLoadOp(rewriter, loadOp, laneMappings, vectorSize, activeLanes);
+        })
+        .Case([&](memref::StoreOp storeOp) {
+            return VectorizeMaskedStoreOp(rewriter, storeOp, vectorizedOps, laneMappings, vectorSize, activeLanes);
+        })
+        .Case([&](mlir::AffineLoadOp affineLoadOp) {
+            return VectorizeMaskedLoadOp(rewriter, affineLoadOp, laneMappings, vectorSize, activeLanes);
+        })
+        .Case([&](mlir::AffineStoreOp affineStoreOp) {
+            return VectorizeMaskedStoreOp(rewriter, affineStoreOp, vectorizedOps, laneMappings, vectorSize, activeLanes);
+        })
+        .Case([&](v::BinOp binOp) -> std::optional<VectorizedOp> {
+            // The masked-off lanes hold zeros, so an integer division would trap on them
+            auto predicate = binOp.getPredicate();
+            if ((predicate == v::BinaryOpPredicate::DIV || predicate == v::BinaryOpPredicate::MOD) && !binOp.result().getType().isa<mlir::FloatType>())
+            {
+                return std::nullopt;
+            }
+            return VectorizeBinOp(rewriter, binOp, vectorizedOps, laneMappings, inductionVar, step, vectorSize);
+        })
+        .Default([&](mlir::Operation* defaultOp) {
+            return VectorizeOp(rewriter, defaultOp, vectorizedOps, laneMappings, inductionVar, step, vectorSize);
+        });
+}
+
+std::optional<DotProductOperand> MatchDotProductOperand(mlir::Value value, mlir::Value inductionVar)
+{
+    mlir::Value extended;
+    bool isUnsigned = false;
+    if (auto extOp = value.getDefiningOp<mlir::SignExtendIOp>())
+    {
+        extended = extOp.value();
+    }
+    else if (auto extOp = value.getDefiningOp<mlir::ZeroExtendIOp>())
+    {
+        extended = extOp.value();
+        isUnsigned = true;
+    }
+    else if (auto extOp = value.getDefiningOp<mlir::FPExtOp>())
+    {
+        extended = extOp.in();
+    }
+    else
+    {
+        return std::nullopt;
+    }
+
+    // Loads of unsigned integers are made signless before they are extended
+    while (auto castOp = extended.getDefiningOp<mlir::UnrealizedConversionCastOp>())
+    {
+        if (castOp->getNumOperands() != 1)
+        {
+            return std::nullopt;
+        }
+        extended = castOp->getOperand(0);
+    }
+
+    auto loadOp = extended.getDefiningOp();
+    if (!loadOp || !mlir::isa<mlir::AffineLoadOp, mlir::memref::LoadOp>(loadOp) || !(extended.getType().isInteger(8) || extended.getType().isInteger(16) || extended.getType().isBF16()) ||
+        !ir::util::hasRecursiveUseOfOp(inductionVar, loadOp))
+    {
+        return std::nullopt;
+    }
+    return DotProductOperand{ loadOp, isUnsigned };
+}
+
+bool IsSameAccess(mlir::Operation* loadOp, mlir::Operation* storeOp)
+{
+    if (auto affineLoadOp = mlir::dyn_cast<mlir::AffineLoadOp>(loadOp))
+    {
+        auto affineStoreOp = mlir::dyn_cast<mlir::AffineStoreOp>(storeOp);
+        return affineStoreOp && affineLoadOp.memref() == affineStoreOp.memref() && affineLoadOp.getAffineMap() == affineStoreOp.getAffineMap() &&
+               llvm::equal(affineLoadOp.getMapOperands(), affineStoreOp.getMapOperands());
+    }
+    if (auto memrefLoadOp = mlir::dyn_cast<mlir::memref::LoadOp>(loadOp))
+    {
+        auto memrefStoreOp = mlir::dyn_cast<mlir::memref::StoreOp>(storeOp);
+        return memrefStoreOp && memrefLoadOp.memref() == memrefStoreOp.memref() && llvm::equal(memrefLoadOp.indices(), memrefStoreOp.indices());
+    }
+    return false;
+}
+
+std::optional<DotProductAccumulation> MatchDotProductAccumulation(mlir::AffineForOp affineForOp, mlir::Type accType, mlir::Type operandType)
+{
+    auto inductionVar = affineForOp.getInductionVar();
+    mlir::Operation* storeOp = nullptr;
+    for (auto& op : affineForOp.getBody()->without_terminator())
+    {
+        if (mlir::isa<mlir::AffineStoreOp, mlir::memref::StoreOp>(op))
+        {
+            if (storeOp)
+            {
+                return std::nullopt;
+            }
+            storeOp = &op;
+        }
+    }
+    if (!storeOp || ir::util::hasRecursiveUseOfOp(inductionVar, storeOp))
+    {
+        return std::nullopt;
+    }
+
+    auto sumOp = storeOp->getOperand(0).getDefiningOp<v::BinOp>();
+    if (!sumOp || sumOp.getPredicate() != v::BinaryOpPredicate::ADD || sumOp.result().getType() != accType || !sumOp->hasOneUse())
+    {
+        return std::nullopt;
+    }
+
+    mlir::Operation* accLoadOp = nullptr;
+    v::BinOp productOp;
+    for (auto [acc, product] : { std::pair{ sumOp.lhs(), sumOp.rhs() }, std::pair{ sumOp.rhs(), sumOp.lhs() } })
+    {
+        auto candidateLoadOp = acc.getDefiningOp();
+        if (candidateLoadOp && IsSameAccess(candidateLoadOp, storeOp) && product.getDefiningOp<v::BinOp>())
+        {
+            accLoadOp = candidateLoadOp;
+            productOp = product.getDefiningOp<v::BinOp>();
+            break;
+        }
+    }
+    if (!accLoadOp || productOp.getPredicate() != v::BinaryOpPredicate::MUL || !productOp->hasOneUse())
+    {
+        return std::nullopt;
+    }
+
+    // Integer operands may be signed or unsigned
+    auto hasOperandType = [&](const DotProductOperand& operand) {
+        auto type = operand.load->getResult(0).getType();
+        return type == operandType || (operandType.isa<mlir::IntegerType>() && type.isInteger(operandType.getIntOrFloatBitWidth()));
+    };
+    auto lhs = MatchDotProductOperand(productOp.lhs(), inductionVar);
+    auto rhs = MatchDotProductOperand(productOp.rhs(), inductionVar);
+    if (!lhs || !rhs || !hasOperandType(*lhs) || !hasOperandType(*rhs))
+    {
+        return std::nullopt;
+    }
+
+    // Anything else in the loop that touches memory would have to keep its order with the accumulation
+    for (auto& op : affineForOp.getBody()->without_terminator())
+    {
+        if (&op == storeOp || &op == accLoadOp || &op == lhs->load || &op == rhs->load)
+        {
+            continue;
+        }
+        if (op.getNumRegions() != 0 || !mlir::isa<mlir::MemoryEffectOpInterface>(op) || !mlir::MemoryEffectOpInterface::hasNoEffect(&op))
+        {
+            return std::nullopt;
+        }
+    }
+    return DotProductAccumulation{ storeOp, accLoadOp, sumOp, productOp, *lhs, *rhs };
+}
+
+// Replaces the matched computation with a sequence of dot-product instructions that each read `instructionElements`
+// elements of A and B and accumulate into a vector of accElementType, which is reduced into C after the loop
+void RewriteDotProductAccumulation(mlir::PatternRewriter& rewriter,
+                                   mlir::AffineForOp affineForOp,
+                                   const DotProductAccumulation& match,
+                                   std::vector<mlir::BlockAndValueMapping>& laneMappings,
+                                   int64_t step,
+                                   int64_t vectorSize,
+                                   int64_t instructionElements,
+                                   mlir::VectorType accType,
+                                   llvm::function_ref<mlir::Value(mlir::Value, mlir::Value, mlir::Value)> buildInstruction)
+{
+    // Accumulate into a vector whose first element starts out as C, and reduce it into C after the loop
+    auto loc = match.storeOp->getLoc();
+    auto inductionVar = affineForOp.getInductionVar();
+    mlir::Value acc = rewriter.create<mlir::ConstantOp>(loc, accType, rewriter.getZeroAttr(accType));
+    acc = rewriter.create<mlir::vector::InsertElementOp>(loc, match.accLoadOp->getResult(0), acc, 0);
+
+    // The operands are loaded whole, as for any other vectorized load, and split into one slice per instruction
+    VectorizedOpMap noVectorizedOps;
+    auto loadOperand = [&](const DotProductOperand& operand) -> mlir::Value {
+        auto vectorized = VectorizeOp(rewriter, operand.load, noVectorizedOps, laneMappings, inductionVar, step, vectorSize);
+        mlir::Value result = vectorized->GetVectorResult();
+        auto signlessType = mlir::VectorType::get({ vectorSize }, ir::util::ToSignlessMLIRType(rewriter, operand.load->getResult(0).getType()));
+        if (result.getType() != signlessType)
+        {
+            result = rewriter.create<mlir::UnrealizedConversionCastOp>(loc, signlessType, result).getResult(0);
+        }
+        return result;
+    };
+    auto lhsVector = loadOperand(match.lhs);
+    auto rhsVector = loadOperand(match.rhs);
+    for (int64_t begin = 0; begin < vectorSize; begin += instructionElements)
+    {
+        auto sliceOperand = [&](mlir::Value vector) -> mlir::Value {
+            if (vectorSize == instructionElements)
+            {
+                return vector;
+            }
+            return rewriter.create<mlir::vector::ExtractStridedSliceOp>(loc, vector, llvm::ArrayRef<int64_t>{ begin }, llvm::ArrayRef<int64_t>{ instructionElements }, llvm::ArrayRef<int64_t>{ 1 });
+        };
+        acc = buildInstruction(acc, sliceOperand(lhsVector), sliceOperand(rhsVector));
+    }
+    mlir::Value sum = rewriter.create<mlir::vector::ReductionOp>(loc, accType.getElementType(), rewriter.getStringAttr("add"), acc, llvm::None);
+
+    auto newStoreOp = rewriter.clone(*match.storeOp);
+    newStoreOp->setOperand(0, sum);
+
+    // Erase the scalar computation, from the store up to the loads of A and B
+    llvm::SetVector<mlir::Operation*> opsToErase;
+    opsToErase.insert(match.storeOp);
+    opsToErase.insert(match.sumOp);
+    opsToErase.insert(match.productOp);
+    for (auto [productOperand, load] : { std::pair{ match.productOp.lhs(), match.lhs.load }, std::pair{ match.productOp.rhs(), match.rhs.load } })
+    {
+        for (auto op = productOperand.getDefiningOp(); op != load; op = op->getOperand(0).getDefiningOp())
+        {
+            opsToErase.insert(op);
+        }
+        opsToErase.insert(load);
+    }
+    for (auto op : opsToErase)
+    {
+        if (op->use_empty())
+        {
+            rewriter.eraseOp(op);
+        }
+    }
+}
+
+// Returns the number of bytes each dot-product instruction reads from each operand, for the widest instruction of
+// the target that supports the operands' signedness and evenly divides the loop
+std::optional<int64_t> GetDotProductVectorBytes(ir::executionPlan::IntegerDotProductKind kind, bool lhsUnsigned, bool rhsUnsigned, int64_t vectorBytes, int64_t tripCount)
+{
+    using ir::executionPlan::IntegerDotProductKind;
+    std::vector<int64_t> instructionBytes;
+    if (kind == IntegerDotProductKind::X86VNNI && lhsUnsigned != rhsUnsigned)
+    {
+        instructionBytes = { 64, 32, 16 };
+    }
+    else if (kind == IntegerDotProductKind::ARMDotProduct && lhsUnsigned == rhsUnsigned)
+    {
+        instructionBytes = { 16, 8 };
+    }
+    else if (kind == IntegerDotProductKind::ARMDSP)
+    {
+        // The DSP instructions work on the general purpose registers, whatever the vector width of the target
+        return tripCount % 4 == 0 ? std::optional<int64_t>{ 4 } : std::nullopt;
+    }
+
+    for (auto bytes : instructionBytes)
+    {
+        if (bytes <= vectorBytes && tripCount % bytes == 0)
+        {
+            return bytes;
+        }
+    }
+    return std::nullopt;
+}
+
+bool VectorizeIntegerDotProduct(mlir::PatternRewriter& rewriter,
+                                mlir::AffineForOp affineForOp,
+                                const ir::executionPlan::VectorizationInfo& vectorInfo,
+                                std::vector<mlir::BlockAndValueMapping>& laneMappings,
+                                int64_t step,
+                                int64_t vectorSize)
+{
+    if (vectorInfo.dotProduct == ir::executionPlan::IntegerDotProductKind::None)
+    {
+        return false;
+    }
+
+    auto i32Type = rewriter.getI32Type();
+    int64_t operandBytes = 1;
+    auto match = MatchDotProductAccumulation(affineForOp, i32Type, rewriter.getIntegerType(8));
+    if (!match && vectorInfo.dotProduct == ir::executionPlan::IntegerDotProductKind::ARMDSP)
+    {
+        // smlad multiplies pairs of signed 16-bit integers without unpacking them first
+        match = MatchDotProductAccumulation(affineForOp, i32Type, rewriter.getIntegerType(16));
+        operandBytes = 2;
+        if (match && (match->lhs.isUnsigned || match->rhs.isUnsigned))
+        {
+            return false;
+        }
+    }
+    if (!match)
+    {
+        return false;
+    }
+
+    auto instructionBytes = GetDotProductVectorBytes(vectorInfo.dotProduct, match->lhs.isUnsigned, match->rhs.isUnsigned, vectorInfo.vectorBytes, vectorSize * operandBytes);
+    if (!instructionBytes)
+    {
+        return false;
+    }
+
+    auto loc = match->storeOp->getLoc();
+    auto accType = mlir::VectorType::get({ *instructionBytes / 4 }, i32Type);
+    RewriteDotProductAccumulation(rewriter, affineForOp, *match, laneMappings, step, vectorSize, *instructionBytes / operandBytes, accType, [&](mlir::Value acc, mlir::Value lhs, mlir::Value rhs) -> mlir::Value {
+        return rewriter.create<v::VectorDotProductOp>(loc, accType, acc, lhs, rhs, static_cast<int64_t>(vectorInfo.dotProduct), match->lhs.isUnsigned, match->rhs.isUnsigned);
+    });
+    return true;
+}
+
+bool VectorizeBFloat16DotProduct(mlir::PatternRewriter& rewriter,
+                                 mlir::AffineForOp affineForOp,
+                                 const ir::executionPlan::VectorizationInfo& vectorInfo,
+                                 std::vector<mlir::BlockAndValueMapping>& laneMappings,
+                                 int64_t step,
+                                 int64_t vectorSize)
+{
+    if (!vectorInfo.bfloat16DotProduct)
+    {
+        return false;
+    }
+
+    auto f32Type = rewriter.getF32Type();
+    auto match = MatchDotProductAccumulation(affineForOp, f32Type, rewriter.getBF16Type());
+    if (!match)
+    {
+        return false;
+    }
+
+    // vdpbf16ps reads 128, 256 or 512 bits of each operand
+    std::optional<int64_t> instructionElements;
+    for (int64_t bytes : { 64, 32, 16 })
+    {
+        if (bytes <= vectorInfo.vectorBytes && vectorSize % (bytes / 2) == 0)
+        {
+            instructionElements = bytes / 2;
+            break;
+        }
+    }
+    if (!instructionElements)
+    {
+        return false;
+    }
+
+    auto loc = match->storeOp->getLoc();
+    auto accType = mlir::VectorType::get({ *instructionElements / 2 }, f32Type);
+    RewriteDotProductAccumulation(rewriter, affineForOp, *match, laneMappings, step, vectorSize, *instructionElements, accType, [&](mlir::Value acc, mlir::Value lhs, mlir::Value rhs) -> mlir::Value {
+        return rewriter.create<v::VectorBFloat16DotProductOp>(loc, accType, acc, lhs, rhs);
+    });
+    return true;
+}
+
+std::vector<mlir::Value> CreateTransposedVectors(mlir::OpBuilder& builder, mlir::Location loc, const std::vector<mlir::Value>& rows)
+{
+    // Each stage interleaves row i with row i + n/2 and after log2(n) stages every element (r, c) has moved to (c, r).
+    // Every stage is a zip of two vectors, which is a zip1 / zip2 on NEON and an unpack / permute on x86
+    auto vectorSize = static_cast<int64_t>(rows.size());
+    assert(llvm::isPowerOf2_64(vectorSize) && "Transposes need a power of 2 number of rows");
+    assert(llvm::all_of(rows, [&](mlir::Value row) { return row.getType().cast<mlir::VectorType>().getNumElements() == vectorSize; }));
+
+    auto half = vectorSize / 2;
+    llvm::SmallVector<int64_t, 16> lowElements;
+    llvm::SmallVector<int64_t, 16> highElements;
+    for (int64_t i = 0; i < half; ++i)
+    {
+        lowElements.append({ i, vectorSize + i });
+        highElements.append({ half + i, vectorSize + half + i });
+    }
+
+    std::vector<mlir::Value> result = rows;
+    for (int64_t stageSize = 1; stageSize < vectorSize; stageSize *= 2)
+    {
+        std::vector<mlir::Value> stage(vectorSize);
+        for (int64_t i = 0; i < half; ++i)
+        {
+            stage[2 * i] = builder.create<mlir::vector::ShuffleOp>(loc, result[i], result[i + half], lowElements);
+            stage[2 * i + 1] = builder.create<mlir::vector::ShuffleOp>(loc, result[i], result[i + half], highElements);
+        }
+        result = std::move(stage);
+    }
+    return result;
+}
+
 } // namespace accera::transforms
@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "AcceraPasses.h"
+
+#include <ir/include/value/ValueDialect.h>
+
+#include <mlir/Dialect/LLVMIR/FunctionCallUtils.h>
+#include <mlir/Dialect/LLVMIR/LLVMDialect.h>
+#include <mlir/IR/Builders.h>
+#include <mlir/IR/BuiltinOps.h>
+
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/SmallVector.h>
+
+#include <string>
+
+using namespace mlir;
+
+namespace
+{
+// These names match the C API in accera/runtime/include/AsyncTask.h
+const char* AsyncLaunchFunctionName = "AcceraAsyncLaunch";
+
+Value CreateConstant(OpBuilder& builder, Location loc, Type type, int64_t value)
+{
+    return builder.create<LLVM::ConstantOp>(loc, type, builder.getIntegerAttr(type, value));
+}
+
+class AsyncEntryPointPass : public accera::transforms::GenerateAsyncEntryPointsBase<AsyncEntryPointPass>
+{
+public:
+    void runOnModule() final;
+
+private:
+    LLVM::LLVMFuncOp CreateTask(LLVM::LLVMFuncOp funcOp, LLVM::LLVMStructType contextType, LLVM::LLVMFuncOp freeFunc);
+    void CreateEntryPoint(LLVM::LLVMFuncOp funcOp, LLVM::LLVMStructType contextType, LLVM::LLVMFuncOp taskFunc, LLVM::LLVMFuncOp mallocFunc);
+};
+
+void AsyncEntryPointPass::runOnModule()
+{
+    auto module = getOperation();
+    auto* context = &getContext();
+
+    llvm::SmallVector<LLVM::LLVMFuncOp, 4> funcOps;
+    module.walk([&](LLVM::LLVMFuncOp funcOp) {
+        if (funcOp->hasAttr(accera::ir::AsyncAPIAttrName) && !funcOp.isExternal())
+        {
+            funcOps.push_back(funcOp);
+        }
+    });
+    if (funcOps.empty())
+    {
+        return;
+    }
+
+    auto i64Type = IntegerType::get(context, 64);
+    auto i8PtrType = LLVM::LLVMPointerType::get(IntegerType::get(context, 8));
+    auto taskType = LLVM::LLVMFunctionType::get(LLVM::LLVMVoidType::get(context), { i8PtrType });
+    if (!module.lookupSymbol<LLVM::LLVMFuncOp>(AsyncLaunchFunctionName))
+    {
+        OpBuilder builder(module.getBodyRegion());
+        builder.create<LLVM::LLVMFuncOp>(module.getLoc(), AsyncLaunchFunctionName, LLVM::LLVMFunctionType::get(i64Type, { LLVM::LLVMPointerType::get(taskType), i8PtrType }));
+    }
+    auto mallocFunc = LLVM::lookupOrCreateMallocFn(module, i64Type);
+    auto freeFunc = LLVM::lookupOrCreateFreeFn(module);
+
+    for (auto funcOp : funcOps)
+    {
+        if (!funcOp.getType().getReturnType().isa<LLVM::LLVMVoidType>())
+        {
+            // The handle replaces the return value, results would need to be written through it instead
+            funcOp.emitError("Asynchronous entry points are only supported for functions that return void");
+            return signalPassFailure();
+        }
+
+        // The arguments of the call are copied into a heap context that the task releases when it is done
+        auto contextType = LLVM::LLVMStructType::getLiteral(context, llvm::to_vector<8>(funcOp.getType().getParams()));
+        auto taskFunc = CreateTask(funcOp, contextType, freeFunc);
+        CreateEntryPoint(funcOp, contextType, taskFunc, mallocFunc);
+    }
+}
+
+LLVM::LLVMFuncOp AsyncEntryPointPass::CreateTask(LLVM::LLVMFuncOp funcOp, LLVM::LLVMStructType contextType, LLVM::LLVMFuncOp freeFunc)
+{
+    auto* context = &getContext();
+    auto loc = funcOp.getLoc();
+    auto i32Type = IntegerType::get(context, 32);
+    auto i8PtrType = LLVM::LLVMPointerType::get(IntegerType::get(context, 8));
+    auto taskType = LLVM::LLVMFunctionType::get(LLVM::LLVMVoidType::get(context), { i8PtrType });
+
+    OpBuilder builder(funcOp);
+    auto taskFunc = builder.create<LLVM::LLVMFuncOp>(loc, (funcOp.getName() + "_async_task").str(), taskType, LLVM::Linkage::Internal);
+    auto entryBlock = taskFunc.addEntryBlock();
+    builder.setInsertionPointToStart(entryBlock);
+
+    auto contextArg = entryBlock->getArgument(0);
+    Value contextPtr = builder.create<LLVM::BitcastOp>(loc, LLVM::LLVMPointerType::get(contextType), contextArg);
+    auto zero = CreateConstant(builder, loc, i32Type, 0);
+    llvm::SmallVector<Value, 8> args;
+    for (auto en : llvm::enumerate(contextType.getBody()))
+    {
+        auto fieldIndex = CreateConstant(builder, loc, i32Type, static_cast<int64_t>(en.index()));
+        Value fieldPtr = builder.create<LLVM::GEPOp>(loc, LLVM::LLVMPointerType::get(en.value()), contextPtr, ValueRange{ zero, fieldIndex });
+        args.push_back(builder.create<LLVM::LoadOp>(loc, fieldPtr));
+    }
+
+    builder.create<LLVM::CallOp>(loc, funcOp, args);
+    builder.create<LLVM::CallOp>(loc, freeFunc, ValueRange{ contextArg });
+    builder.create<LLVM::ReturnOp>(loc, ValueRange{});
+    return taskFunc;
+}
+
+void AsyncEntryPointPass::CreateEntryPoint(LLVM::LLVMFuncOp funcOp, LLVM::LLVMStructType contextType, LLVM::LLVMFuncOp taskFunc, LLVM::LLVMFuncOp mallocFunc)
+{
+    auto* context = &getContext();
+    auto loc = funcOp.getLoc();
+    auto i32Type = IntegerType::get(context, 32);
+    auto i64Type = IntegerType::get(context, 64);
+    auto i8PtrType = LLVM::LLVMPointerType::get(IntegerType::get(context, 8));
+    auto contextPtrType = LLVM::LLVMPointerType::get(contextType);
+
+    // Same parameters as the synchronous function, with the handle of the call as the result
+    OpBuilder builder(funcOp);
+    auto entryType = LLVM::LLVMFunctionType::get(i64Type, funcOp.getType().getParams());
+    auto entryFunc = builder.create<LLVM::LLVMFuncOp>(loc, (funcOp.getName() + "_async").str(), entryType, LLVM::Linkage::External);
+    auto entryBlock = entryFunc.addEntryBlock();
+    builder.setInsertionPointToStart(entryBlock);
+
+    // sizeof(context) is the address of the second element of a null array of contexts
+    Value nullContext = builder.create<LLVM::NullOp>(loc, contextPtrType);
+    Value contextEnd = builder.create<LLVM::GEPOp>(loc, contextPtrType, nullContext, ValueRange{ CreateConstant(builder, loc, i64Type, 1) });
+    Value contextSize = builder.create<LLVM::PtrToIntOp>(loc, i64Type, contextEnd);
+    Value contextArg = builder.create<LLVM::CallOp>(loc, mallocFunc, ValueRange{ contextSize }).getResult(0);
+
+    Value contextPtr = builder.create<LLVM::BitcastOp>(loc, contextPtrType, contextArg);
+    auto zero = CreateConstant(builder, loc, i32Type, 0);
+    for (auto en : llvm::enumerate(entryBlock->getArguments()))
+    {
+        auto fieldIndex = CreateConstant(builder, loc, i32Type, static_cast<int64_t>(en.index()));
+        Value fieldPtr = builder.create<LLVM::GEPOp>(loc, LLVM::LLVMPointerType::get(en.value().getType()), contextPtr, ValueRange{ zero, fieldIndex });
+        builder.create<LLVM::StoreOp>(loc, en.value(), fieldPtr);
+    }
+
+    Value taskPtr = builder.create<LLVM::AddressOfOp>(loc, taskFunc);
+    auto launchOp = builder.create<LLVM::CallOp>(loc, TypeRange{ i64Type }, SymbolRefAttr::get(context, AsyncLaunchFunctionName), ValueRange{ taskPtr, contextArg });
+    builder.create<LLVM::ReturnOp>(loc, launchOp.getResults());
+}
+
+} // namespace
+
+namespace accera::transforms::value
+{
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createAsyncEntryPointPass()
+{
+    return std::make_unique<AsyncEntryPointPass>();
+}
+} // namespace accera::transforms::value
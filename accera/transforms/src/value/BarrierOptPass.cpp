@@ -12,8 +12,11 @@
 
 #include <mlir/Analysis/LoopAnalysis.h>
 
+#include <mlir/IR/FunctionSupport.h>
 #include <mlir/IR/Visitors.h>
 
+#include <mlir/Interfaces/SideEffectInterfaces.h>
+
 #include <mlir/Pass/Pass.h>
 #include <mlir/Pass/PassManager.h>
 
@@ -67,8 +70,10 @@ struct BarrierOptPass : public BarrierOptBase<BarrierOptPass>
         mlir::ValueRange accessMapOperands;
         MemoryAccessType accessType;
         int nodeId = -1;
-        // TODO: integer set or something to indicate the subset of the memory being accessed?
-        // TODO: loop level?
+
+        // Whether the access reached the point being analyzed through a loop back edge, in which case it may come from
+        // a different iteration of the loops around it than the accesses it is compared with
+        bool loopCarried = false;
         // TODO: deal with views
     };
 
@@ -123,13 +128,172 @@ struct BarrierOptPass : public BarrierOptBase<BarrierOptPass>
         return access1.baseMemRef == access2.baseMemRef;
     }
 
+    static bool IsSameAccess(const MemoryAccessInfo& access1, const MemoryAccessInfo& access2)
+    {
+        return access1.op == access2.op && access1.loopCarried == access2.loopCarried;
+    }
+
     static bool Contains(const std::vector<MemoryAccessInfo>& activeAccesses, const MemoryAccessInfo& access)
     {
         return std::find_if(activeAccesses.begin(), activeAccesses.end(), [&](const MemoryAccessInfo& activeAccess) {
-                   return UsesSameMemory(access, activeAccess);
+                   return IsSameAccess(access, activeAccess);
+               }) != activeAccesses.end();
+    }
+
+    static bool HasHazard(const std::vector<MemoryAccessInfo>& activeAccesses, const MemoryAccessInfo& access)
+    {
+        return std::find_if(activeAccesses.begin(), activeAccesses.end(), [&](const MemoryAccessInfo& activeAccess) {
+                   return MayAccessSameMemory(access, activeAccess);
                }) != activeAccesses.end();
     }
 
+    static MemoryAccessInfo AsLoopCarried(MemoryAccessInfo access)
+    {
+        access.loopCarried = true;
+        return access;
+    }
+
+    // Whether a value is the same for every thread in a block: constants, function arguments, block ids and dims, the
+    // induction variables of sequential loops with uniform bounds, and side-effect free computations on them
+    static bool IsUniform(mlir::Value value)
+    {
+        if (auto blockArg = value.dyn_cast<mlir::BlockArgument>())
+        {
+            auto parentOp = blockArg.getOwner()->getParentOp();
+            if (!parentOp || parentOp->getAttr("accv_gpu_map"))
+                return false;
+
+            if (parentOp->hasTrait<mlir::OpTrait::FunctionLike>())
+                return blockArg.getOwner()->isEntryBlock();
+
+            if (auto affineForOp = dyn_cast<mlir::AffineForOp>(parentOp))
+                return blockArg == affineForOp.getInductionVar() && llvm::all_of(affineForOp.getLowerBoundOperands(), IsUniform) && llvm::all_of(affineForOp.getUpperBoundOperands(), IsUniform);
+
+            if (auto forOp = dyn_cast<mlir::scf::ForOp>(parentOp))
+                return blockArg == forOp.getInductionVar() && IsUniform(forOp.lowerBound()) && IsUniform(forOp.upperBound()) && IsUniform(forOp.step());
+
+            return false;
+        }
+
+        auto op = value.getDefiningOp();
+        if (isa<mlir::ConstantOp, gpu::BlockIdOp, gpu::BlockDimOp, gpu::GridDimOp>(op))
+            return true;
+
+        // Ops with no operands that aren't listed above (e.g. thread ids) may differ between threads
+        return op->getNumOperands() > 0 && op->getNumRegions() == 0 && mlir::MemoryEffectOpInterface::hasNoEffect(op) && llvm::all_of(op->getOperands(), IsUniform);
+    }
+
+    // Whether two index expressions over the same (uniform) dims can never be equal
+    static bool AreDistinct(mlir::AffineExpr lhs, mlir::AffineExpr rhs, unsigned numDims)
+    {
+        auto difference = mlir::simplifyAffineExpr(lhs - rhs, numDims, 0);
+        if (auto constantDifference = difference.dyn_cast<mlir::AffineConstantExpr>())
+            return constantDifference.getValue() != 0;
+
+        // Buffer indices of the form `x mod n` and `(x + d) mod n`, as used to alternate between the halves of a
+        // double buffer, are distinct if `d` isn't a multiple of `n`
+        auto lhsMod = lhs.dyn_cast<mlir::AffineBinaryOpExpr>();
+        auto rhsMod = rhs.dyn_cast<mlir::AffineBinaryOpExpr>();
+        if (lhsMod && rhsMod && lhsMod.getKind() == mlir::AffineExprKind::Mod && rhsMod.getKind() == mlir::AffineExprKind::Mod && lhsMod.getRHS() == rhsMod.getRHS())
+        {
+            if (auto modulus = lhsMod.getRHS().dyn_cast<mlir::AffineConstantExpr>())
+            {
+                auto offset = mlir::simplifyAffineExpr(lhsMod.getLHS() - rhsMod.getLHS(), numDims, 0).dyn_cast<mlir::AffineConstantExpr>();
+                return offset && modulus.getValue() > 0 && offset.getValue() % modulus.getValue() != 0;
+            }
+        }
+
+        return false;
+    }
+
+    // Whether two accesses may touch the same element of shared memory. Accesses in the same iteration of their common
+    // loops that differ in an index computed from uniform values touch different elements in every thread, e.g. the
+    // write to one half of a double buffer and the read from the other half.
+    static bool MayAccessSameMemory(const MemoryAccessInfo& access1, const MemoryAccessInfo& access2)
+    {
+        if (!UsesSameMemory(access1, access2))
+            return false;
+
+        if (access1.loopCarried || access2.loopCarried || !access1.accessMap || !access2.accessMap)
+            return true;
+
+        // Only compare the indices of accesses to the base memref itself, not to views of it
+        auto getMemRef = [](Operation* op) -> mlir::Value {
+            if (auto readOp = dyn_cast<mlir::AffineReadOpInterface>(op))
+                return readOp.getMemRef();
+            if (auto writeOp = dyn_cast<mlir::AffineWriteOpInterface>(op))
+                return writeOp.getMemRef();
+            return {};
+        };
+        if (getMemRef(access1.op) != access1.baseMemRef || getMemRef(access2.op) != access2.baseMemRef)
+            return true;
+
+        if (access1.accessMap.getNumResults() != access2.accessMap.getNumResults())
+            return true;
+
+        // Rewrite both access maps in terms of a common list of dims, one per distinct operand value
+        llvm::SmallVector<mlir::Value, 8> commonOperands;
+        auto getCommonExprs = [&](mlir::AffineMap map, mlir::ValueRange operands) {
+            llvm::SmallVector<mlir::AffineExpr, 8> replacements;
+            for (auto operand : operands)
+            {
+                auto it = llvm::find(commonOperands, operand);
+                if (it == commonOperands.end())
+                {
+                    commonOperands.push_back(operand);
+                    it = std::prev(commonOperands.end());
+                }
+                replacements.push_back(mlir::getAffineDimExpr(std::distance(commonOperands.begin(), it), map.getContext()));
+            }
+
+            llvm::SmallVector<mlir::AffineExpr, 4> exprs;
+            auto dimReplacements = llvm::makeArrayRef(replacements).take_front(map.getNumDims());
+            auto symbolReplacements = llvm::makeArrayRef(replacements).drop_front(map.getNumDims());
+            for (auto expr : map.getResults())
+                exprs.push_back(expr.replaceDimsAndSymbols(dimReplacements, symbolReplacements));
+            return exprs;
+        };
+        auto exprs1 = getCommonExprs(access1.accessMap, access1.accessMapOperands);
+        auto exprs2 = getCommonExprs(access2.accessMap, access2.accessMapOperands);
+
+        for (auto [expr1, expr2] : llvm::zip(exprs1, exprs2))
+        {
+            auto usesOnlyUniformValues = [&](mlir::AffineExpr expr) {
+                for (unsigned dim = 0; dim < commonOperands.size(); ++dim)
+                {
+                    if (expr.isFunctionOfDim(dim) && !IsUniform(commonOperands[dim]))
+                        return false;
+                }
+                return true;
+            };
+
+            if (usesOnlyUniformValues(expr1) && usesOnlyUniformValues(expr2) && AreDistinct(expr1, expr2, commonOperands.size()))
+                return false;
+        }
+
+        return true;
+    }
+
+    // Accesses that flow along a loop back edge (an edge to a node created before its source) may come from another
+    // iteration
+    static ActiveMemoryState AsLoopCarried(const ActiveMemoryState& state)
+    {
+        ActiveMemoryState result;
+        for (const auto& access : state.activeReads)
+        {
+            if (!Contains(result.activeReads, AsLoopCarried(access)))
+                result.activeReads.push_back(AsLoopCarried(access));
+        }
+
+        for (const auto& access : state.activeWrites)
+        {
+            if (!Contains(result.activeWrites, AsLoopCarried(access)))
+                result.activeWrites.push_back(AsLoopCarried(access));
+        }
+
+        return result;
+    }
+
     static bool IsSame(const std::vector<MemoryAccessInfo>& lhs, const std::vector<MemoryAccessInfo>& rhs)
     {
         if (lhs.size() != rhs.size())
@@ -214,13 +378,13 @@ struct BarrierOptPass : public BarrierOptBase<BarrierOptPass>
             // check for a conflict between reachability and liveAccesses
             for (auto& memOpInfo : reachingDefs.in.activeReads)
             {
-                if (Contains(liveAccesses.out.activeWrites, memOpInfo))
+                if (HasHazard(liveAccesses.out.activeWrites, memOpInfo))
                     return true;
             }
 
             for (auto& memOpInfo : reachingDefs.in.activeWrites)
             {
-                if (Contains(liveAccesses.out.activeReads, memOpInfo))
+                if (HasHazard(liveAccesses.out.activeReads, memOpInfo))
                     return true;
             }
 
@@ -435,7 +599,8 @@ struct BarrierOptPass : public BarrierOptBase<BarrierOptPass>
                 for (auto& weakPred : node->prev)
                 {
                     auto pred = weakPred;
-                    for (auto& predRead : pred->reachingDefs.out.activeReads)
+                    auto predState = pred->id > node->id ? AsLoopCarried(pred->reachingDefs.out) : pred->reachingDefs.out;
+                    for (auto& predRead : predState.activeReads)
                     {
                         if (!Contains(node->reachingDefs.in.activeReads, predRead))
                         {
@@ -443,7 +608,7 @@ struct BarrierOptPass : public BarrierOptBase<BarrierOptPass>
                         }
                     }
 
-                    for (auto& predWrite : pred->reachingDefs.out.activeWrites)
+                    for (auto& predWrite : predState.activeWrites)
                     {
                         if (!Contains(node->reachingDefs.in.activeWrites, predWrite))
                         {
@@ -513,7 +678,7 @@ struct BarrierOptPass : public BarrierOptBase<BarrierOptPass>
                 ActiveMemoryState outgoingState;
                 for (auto& succ : node->next)
                 {
-                    outgoingState = Union(outgoingState, succ->liveAccesses.in);
+                    outgoingState = Union(outgoingState, succ->id < node->id ? AsLoopCarried(succ->liveAccesses.in) : succ->liveAccesses.in);
                 }
 
                 // incoming state = union(Generated, Out-Killed)
@@ -802,6 +967,18 @@ private:
             .Case<mlir::memref::StoreOp>([&](mlir::memref::StoreOp storeOp) {
                 return getAccessInfo(storeOp, MemoryAccessType::Write);
             })
+            .Case<GPUAsyncCopyOp>([&](GPUAsyncCopyOp copyOp) -> llvm::Optional<MemoryAccessInfo> {
+                // Only the destination of an asynchronous copy can be in shared memory
+                if (copyOp.dst().getType().cast<MemRefType>().getMemorySpaceAsInt() == gpu::GPUDialect::getWorkgroupAddressSpace())
+                {
+                    MemoryAccessInfo info;
+                    info.op = copyOp.getOperation();
+                    info.baseMemRef = GetBaseMemRef(copyOp.dst());
+                    info.accessType = MemoryAccessType::Write;
+                    return info;
+                }
+                return llvm::None;
+            })
             .Default([](Operation*) { return llvm::None; });
 
         // TODO:
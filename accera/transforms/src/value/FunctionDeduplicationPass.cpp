@@ -0,0 +1,237 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "AcceraPasses.h"
+
+#include <ir/include/value/ValueDialect.h>
+
+#include <mlir/Dialect/StandardOps/IR/Ops.h>
+#include <mlir/IR/BlockAndValueMapping.h>
+#include <mlir/IR/Builders.h>
+#include <mlir/IR/BuiltinOps.h>
+#include <mlir/IR/SymbolTable.h>
+
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/Hashing.h>
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/SmallVector.h>
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace mlir;
+
+namespace
+{
+// The attributes that name a function or select the API wrappers generated around it, which don't change the code
+// of its body. A duplicate that isn't erased keeps its own.
+bool IsInterfaceAttribute(StringRef name)
+{
+    return name == SymbolTable::getSymbolAttrName() ||
+           name == SymbolTable::getVisibilityAttrName() ||
+           name == accera::ir::BaseNameAttrName ||
+           name == accera::ir::FunctionTagsAttrName ||
+           name == accera::ir::HeaderDeclAttrName ||
+           name == accera::ir::RawPointerAPIAttrName ||
+           name == accera::ir::CInterfaceAttrName ||
+           name == accera::ir::AsyncAPIAttrName;
+}
+
+bool HasAPIAttributes(FuncOp funcOp)
+{
+    return funcOp->hasAttr(accera::ir::HeaderDeclAttrName) ||
+           funcOp->hasAttr(accera::ir::RawPointerAPIAttrName) ||
+           funcOp->hasAttr(accera::ir::CInterfaceAttrName) ||
+           funcOp->hasAttr(accera::ir::AsyncAPIAttrName);
+}
+
+llvm::SmallVector<NamedAttribute, 4> GetCodeAttributes(FuncOp funcOp)
+{
+    return llvm::to_vector<4>(llvm::make_filter_range(funcOp->getAttrs(), [](NamedAttribute attr) {
+        return !IsInterfaceAttribute(attr.first.strref());
+    }));
+}
+
+// Only hashes what doesn't depend on the values an op uses, which AreEquivalent checks
+size_t HashFunction(FuncOp funcOp)
+{
+    auto hash = llvm::hash_value(funcOp.getType().getAsOpaquePointer());
+    funcOp.getBody().walk([&](Operation* op) {
+        hash = llvm::hash_combine(hash, op->getName().getAsOpaquePointer(), op->getAttrDictionary().getAsOpaquePointer(), op->getNumOperands(), op->getNumSuccessors(), op->getNumRegions());
+        for (auto type : op->getResultTypes())
+        {
+            hash = llvm::hash_combine(hash, type.getAsOpaquePointer());
+        }
+    });
+    return static_cast<size_t>(hash);
+}
+
+// Maps the blocks, block arguments and results of lhs to those of rhs, as long as they have the same structure. The ops
+// are collected so that their operands are compared once everything is mapped, since a value can be used in a block
+// that comes before the one that defines it.
+bool MapRegions(Region& lhs, Region& rhs, BlockAndValueMapping& mapping, std::vector<std::pair<Operation*, Operation*>>& ops)
+{
+    if (lhs.getBlocks().size() != rhs.getBlocks().size())
+    {
+        return false;
+    }
+
+    for (auto [lhsBlock, rhsBlock] : llvm::zip(lhs, rhs))
+    {
+        if (lhsBlock.getNumArguments() != rhsBlock.getNumArguments() ||
+            lhsBlock.getOperations().size() != rhsBlock.getOperations().size() ||
+            lhsBlock.getArgumentTypes() != rhsBlock.getArgumentTypes())
+        {
+            return false;
+        }
+        mapping.map(&lhsBlock, &rhsBlock);
+        mapping.map(lhsBlock.getArguments(), rhsBlock.getArguments());
+    }
+
+    for (auto [lhsBlock, rhsBlock] : llvm::zip(lhs, rhs))
+    {
+        for (auto [lhsOp, rhsOp] : llvm::zip(lhsBlock, rhsBlock))
+        {
+            if (lhsOp.getName() != rhsOp.getName() ||
+                lhsOp.getAttrDictionary() != rhsOp.getAttrDictionary() ||
+                lhsOp.getResultTypes() != rhsOp.getResultTypes() ||
+                lhsOp.getNumOperands() != rhsOp.getNumOperands() ||
+                lhsOp.getNumSuccessors() != rhsOp.getNumSuccessors() ||
+                lhsOp.getNumRegions() != rhsOp.getNumRegions())
+            {
+                return false;
+            }
+            mapping.map(lhsOp.getResults(), rhsOp.getResults());
+            ops.emplace_back(&lhsOp, &rhsOp);
+
+            for (auto [lhsRegion, rhsRegion] : llvm::zip(lhsOp.getRegions(), rhsOp.getRegions()))
+            {
+                if (!MapRegions(lhsRegion, rhsRegion, mapping, ops))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool AreEquivalent(FuncOp lhs, FuncOp rhs)
+{
+    if (lhs.getType() != rhs.getType() || GetCodeAttributes(lhs) != GetCodeAttributes(rhs))
+    {
+        return false;
+    }
+
+    BlockAndValueMapping mapping;
+    std::vector<std::pair<Operation*, Operation*>> ops;
+    if (!MapRegions(lhs.getBody(), rhs.getBody(), mapping, ops))
+    {
+        return false;
+    }
+
+    return llvm::all_of(ops, [&](const std::pair<Operation*, Operation*>& opPair) {
+        auto [lhsOp, rhsOp] = opPair;
+        for (auto [lhsOperand, rhsOperand] : llvm::zip(lhsOp->getOperands(), rhsOp->getOperands()))
+        {
+            if (mapping.lookupOrNull(lhsOperand) != rhsOperand)
+            {
+                return false;
+            }
+        }
+        for (auto [lhsSuccessor, rhsSuccessor] : llvm::zip(lhsOp->getSuccessors(), rhsOp->getSuccessors()))
+        {
+            if (mapping.lookupOrNull(lhsSuccessor) != rhsSuccessor)
+            {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
+// Replaces the body of the duplicate with a call to the function it duplicates
+void MakeAlias(FuncOp duplicate, FuncOp original)
+{
+    duplicate.eraseBody();
+    auto entryBlock = duplicate.addEntryBlock();
+    auto builder = OpBuilder::atBlockEnd(entryBlock);
+    auto callOp = builder.create<CallOp>(duplicate.getLoc(), original, entryBlock->getArguments());
+    builder.create<ReturnOp>(duplicate.getLoc(), callOp.getResults());
+}
+
+class FunctionDeduplicationPass : public accera::transforms::DeduplicateFunctionsBase<FunctionDeduplicationPass>
+{
+public:
+    void runOnModule() final;
+};
+
+void FunctionDeduplicationPass::runOnModule()
+{
+    auto module = getOperation();
+
+    // Callers only become identical once the functions they call were deduplicated, e.g. the API functions of
+    // variants whose implementations are identical, so this repeats until nothing changes
+    llvm::DenseSet<Operation*> aliases;
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+
+        std::unordered_map<size_t, std::vector<FuncOp>> functionsByHash;
+        std::vector<std::pair<FuncOp, FuncOp>> duplicates;
+        for (auto funcOp : module.getOps<FuncOp>())
+        {
+            if (funcOp.isExternal() || aliases.count(funcOp))
+            {
+                continue;
+            }
+
+            auto& candidates = functionsByHash[HashFunction(funcOp)];
+            auto original = llvm::find_if(candidates, [&](FuncOp candidate) { return AreEquivalent(candidate, funcOp); });
+            if (original != candidates.end())
+            {
+                duplicates.emplace_back(funcOp, *original);
+            }
+            else
+            {
+                candidates.push_back(funcOp);
+            }
+        }
+
+        for (auto [duplicate, original] : duplicates)
+        {
+            if (failed(SymbolTable::replaceAllSymbolUses(duplicate, original.getName(), module)))
+            {
+                duplicate.emitError("Failed to replace the uses of a duplicate function");
+                signalPassFailure();
+                return;
+            }
+
+            // Functions that can be called from outside of the module keep their symbol
+            if (!duplicate.isPublic() && !HasAPIAttributes(duplicate))
+            {
+                duplicate.erase();
+            }
+            else
+            {
+                MakeAlias(duplicate, original);
+                aliases.insert(duplicate);
+            }
+            changed = true;
+        }
+    }
+}
+
+} // namespace
+
+namespace accera::transforms::value
+{
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createFunctionDeduplicationPass()
+{
+    return std::make_unique<FunctionDeduplicationPass>();
+}
+} // namespace accera::transforms::value
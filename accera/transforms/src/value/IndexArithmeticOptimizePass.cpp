@@ -0,0 +1,302 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "AcceraPasses.h"
+#include "value/RangeValueAnalysis.h"
+
+#include <mlir/Dialect/Affine/IR/AffineOps.h>
+#include <mlir/IR/AffineExpr.h>
+#include <mlir/IR/AffineMap.h>
+#include <mlir/IR/Builders.h>
+#include <mlir/Pass/Pass.h>
+#include <mlir/Support/MathExtras.h>
+
+#include <llvm/ADT/SmallVector.h>
+
+#include <vector>
+
+using namespace mlir;
+
+using accera::transforms::value::RangeValueAnalysis;
+
+namespace
+{
+// The name of the affine map attribute of the affine ops that compute or access with indices
+const llvm::StringRef MapAttrName = "map";
+
+bool HasIndexMap(Operation* op)
+{
+    return isa<AffineApplyOp, AffineLoadOp, AffineStoreOp, AffineVectorLoadOp, AffineVectorStoreOp>(op);
+}
+
+// The operands of an op's index map, which are its last operands
+SmallVector<Value, 4> GetMapOperands(Operation* op, AffineMap map)
+{
+    return SmallVector<Value, 4>(op->operand_end() - map.getNumInputs(), op->operand_end());
+}
+
+void SetIndexMap(Operation* op, AffineMap oldMap, AffineMap newMap, ValueRange newOperands)
+{
+    op->setAttr(MapAttrName, AffineMapAttr::get(newMap));
+    op->setOperands(op->getNumOperands() - oldMap.getNumInputs(), oldMap.getNumInputs(), newOperands);
+}
+
+// The addends of a sum, e.g. d0 * 4, d1 and 2 for d0 * 4 + d1 + 2
+void CollectAddends(AffineExpr expr, SmallVectorImpl<AffineExpr>& addends)
+{
+    if (expr.getKind() == AffineExprKind::Add)
+    {
+        auto sumExpr = expr.cast<AffineBinaryOpExpr>();
+        CollectAddends(sumExpr.getLHS(), addends);
+        CollectAddends(sumExpr.getRHS(), addends);
+    }
+    else
+    {
+        addends.push_back(expr);
+    }
+}
+
+AffineExpr Sum(ArrayRef<AffineExpr> addends, MLIRContext* context)
+{
+    auto sum = getAffineConstantExpr(0, context);
+    for (auto addend : addends)
+    {
+        sum = sum + addend;
+    }
+    return sum;
+}
+
+AffineExpr Combine(AffineExprKind kind, AffineExpr lhs, AffineExpr rhs)
+{
+    switch (kind)
+    {
+    case AffineExprKind::Add:
+        return lhs + rhs;
+    case AffineExprKind::Mul:
+        return lhs * rhs;
+    case AffineExprKind::FloorDiv:
+        return lhs.floorDiv(rhs);
+    case AffineExprKind::CeilDiv:
+        return lhs.ceilDiv(rhs);
+    default:
+        return lhs % rhs;
+    }
+}
+
+// Replaces the floor divisions, ceiling divisions and modulos by a constant whose quotient the ranges of the operands
+// decide with additions, e.g. (d0 * 4 + d1) floordiv 4 with d0 and (d0 * 4 + d1) mod 4 with d1 when d1 is in [0, 4).
+// This is what an index of a split, padded or skewed schedule looks like when it is composed back into the index it
+// was derived from.
+AffineExpr SimplifyDivisions(AffineExpr expr, ValueRange operands, unsigned numDims, RangeValueAnalysis& ranges)
+{
+    auto binaryExpr = expr.dyn_cast<AffineBinaryOpExpr>();
+    if (!binaryExpr)
+    {
+        return expr;
+    }
+
+    auto kind = expr.getKind();
+    auto lhs = SimplifyDivisions(binaryExpr.getLHS(), operands, numDims, ranges);
+    auto rhs = SimplifyDivisions(binaryExpr.getRHS(), operands, numDims, ranges);
+    auto divisorExpr = rhs.dyn_cast<AffineConstantExpr>();
+    if (kind == AffineExprKind::Add || kind == AffineExprKind::Mul || !divisorExpr || divisorExpr.getValue() <= 0)
+    {
+        return Combine(kind, lhs, rhs);
+    }
+
+    // Only the addends of the dividend that aren't multiples of the divisor contribute to the remainder
+    auto divisor = divisorExpr.getValue();
+    SmallVector<AffineExpr, 4> addends;
+    SmallVector<AffineExpr, 4> multiples;
+    SmallVector<AffineExpr, 4> rest;
+    CollectAddends(lhs, addends);
+    for (auto addend : addends)
+    {
+        (addend.isMultipleOf(divisor) ? multiples : rest).push_back(addend);
+    }
+    auto remainder = Sum(rest, expr.getContext());
+    if (kind == AffineExprKind::CeilDiv)
+    {
+        // x ceildiv c == (x + c - 1) floordiv c
+        remainder = remainder + (divisor - 1);
+    }
+
+    auto range = ranges.resolveRange(remainder, operands, numDims).range;
+    if (range.isFullSet() || range.isEmptySet() || range.isSignWrappedSet())
+    {
+        return Combine(kind, lhs, rhs);
+    }
+    auto quotient = mlir::floorDiv(range.getSignedMin().getSExtValue(), divisor);
+    if (quotient != mlir::floorDiv(range.getSignedMax().getSExtValue(), divisor))
+    {
+        return Combine(kind, lhs, rhs);
+    }
+
+    if (kind == AffineExprKind::Mod)
+    {
+        return remainder - quotient * divisor;
+    }
+    return Sum(multiples, expr.getContext()).floorDiv(divisor) + quotient;
+}
+
+void SimplifyIndexMap(Operation* op, RangeValueAnalysis& ranges)
+{
+    auto map = op->getAttrOfType<AffineMapAttr>(MapAttrName).getValue();
+    auto operands = GetMapOperands(op, map);
+
+    SmallVector<AffineExpr, 4> results;
+    for (auto result : map.getResults())
+    {
+        results.push_back(SimplifyDivisions(result, operands, map.getNumDims(), ranges));
+    }
+    auto newMap = AffineMap::get(map.getNumDims(), map.getNumSymbols(), results, op->getContext());
+    if (newMap != map)
+    {
+        canonicalizeMapAndOperands(&newMap, &operands);
+        SetIndexMap(op, map, newMap, operands);
+    }
+}
+
+// The GPU-mapped loops become thread and block ids when the GPU kernels are created, the computations that are
+// invariant in them stay in them
+bool CanHoistOutOf(AffineForOp loop)
+{
+    return !loop->getAttr("accv_gpu_map");
+}
+
+// Moves an index computation in front of the outermost of the loops around it that it doesn't depend on
+void HoistLoopInvariantIndexOp(Operation* op)
+{
+    AffineForOp target;
+    for (auto loop = dyn_cast<AffineForOp>(op->getParentOp()); loop && CanHoistOutOf(loop); loop = dyn_cast<AffineForOp>(loop->getParentOp()))
+    {
+        if (!llvm::all_of(op->getOperands(), [&](Value operand) { return loop.isDefinedOutsideOfLoop(operand); }))
+        {
+            break;
+        }
+        target = loop;
+    }
+    if (target)
+    {
+        op->moveBefore(target);
+    }
+}
+
+// Computes the sum of the addends of an index that don't depend on the innermost loop around an op before the loop,
+// e.g. the i * 64 + j * 8 of the i * 64 + j * 8 + k index of a loop over k, so that the loop only adds the index of
+// its own iteration to it
+void HoistLoopInvariantIndexTerms(Operation* op)
+{
+    auto loop = op->getParentOfType<AffineForOp>();
+    if (!loop || !CanHoistOutOf(loop))
+    {
+        return;
+    }
+
+    auto context = op->getContext();
+    auto map = op->getAttrOfType<AffineMapAttr>(MapAttrName).getValue();
+    auto operands = GetMapOperands(op, map);
+    auto numDims = map.getNumDims();
+    auto isLoopInvariant = [&](AffineExpr expr) {
+        bool invariant = true;
+        expr.walk([&](AffineExpr subExpr) {
+            if (auto dimExpr = subExpr.dyn_cast<AffineDimExpr>())
+            {
+                invariant &= loop.isDefinedOutsideOfLoop(operands[dimExpr.getPosition()]);
+            }
+            else if (auto symbolExpr = subExpr.dyn_cast<AffineSymbolExpr>())
+            {
+                invariant &= loop.isDefinedOutsideOfLoop(operands[numDims + symbolExpr.getPosition()]);
+            }
+        });
+        return invariant;
+    };
+
+    OpBuilder builder(loop);
+    SmallVector<AffineExpr, 4> results;
+    SmallVector<Value, 4> hoistedTerms;
+    for (auto result : map.getResults())
+    {
+        SmallVector<AffineExpr, 4> addends;
+        SmallVector<AffineExpr, 4> invariantAddends;
+        SmallVector<AffineExpr, 4> variantAddends;
+        CollectAddends(result, addends);
+        for (auto addend : addends)
+        {
+            (!addend.isa<AffineConstantExpr>() && isLoopInvariant(addend) ? invariantAddends : variantAddends).push_back(addend);
+        }
+
+        // A lone index costs nothing to add, and the indices that don't depend on the loop at all are hoisted whole
+        auto hasVariantIndex = llvm::any_of(variantAddends, [](AffineExpr addend) { return !addend.isa<AffineConstantExpr>(); });
+        if (!hasVariantIndex || invariantAddends.empty() || (invariantAddends.size() == 1 && (invariantAddends[0].isa<AffineDimExpr>() || invariantAddends[0].isa<AffineSymbolExpr>())))
+        {
+            results.push_back(result);
+            continue;
+        }
+
+        auto termMap = AffineMap::get(numDims, map.getNumSymbols(), Sum(invariantAddends, context));
+        SmallVector<Value, 4> termOperands(operands);
+        canonicalizeMapAndOperands(&termMap, &termOperands);
+        hoistedTerms.push_back(builder.create<AffineApplyOp>(op->getLoc(), termMap, termOperands));
+        results.push_back(Sum(variantAddends, context) + getAffineDimExpr(numDims + hoistedTerms.size() - 1, context));
+    }
+    if (hoistedTerms.empty())
+    {
+        return;
+    }
+
+    // The hoisted terms are new dims, which come before the symbols in the operands
+    auto newMap = AffineMap::get(numDims + hoistedTerms.size(), map.getNumSymbols(), results, context);
+    SmallVector<Value, 4> newOperands(operands.begin(), operands.begin() + numDims);
+    newOperands.append(hoistedTerms.begin(), hoistedTerms.end());
+    newOperands.append(operands.begin() + numDims, operands.end());
+    canonicalizeMapAndOperands(&newMap, &newOperands);
+    SetIndexMap(op, map, newMap, newOperands);
+}
+
+struct IndexArithmeticOptimizePass : public OptimizeIndexArithmeticBase<IndexArithmeticOptimizePass>
+{
+    void runOnFunction() final
+    {
+        RangeValueAnalysis ranges;
+        std::vector<Operation*> indexOps;
+        getFunction().walk([&](Operation* op) {
+            if (HasIndexMap(op))
+            {
+                indexOps.push_back(op);
+            }
+        });
+
+        for (auto op : indexOps)
+        {
+            SimplifyIndexMap(op, ranges);
+            HoistLoopInvariantIndexTerms(op);
+        }
+
+        // The ops are visited in the order of their blocks, so the computations an op depends on are hoisted before it
+        std::vector<Operation*> hoistableOps;
+        getFunction().walk([&](Operation* op) {
+            if (isa<AffineApplyOp, AffineMinOp, AffineMaxOp>(op))
+            {
+                hoistableOps.push_back(op);
+            }
+        });
+        for (auto op : hoistableOps)
+        {
+            HoistLoopInvariantIndexOp(op);
+        }
+    }
+};
+} // namespace
+
+namespace accera::transforms::value
+{
+
+std::unique_ptr<mlir::Pass> createIndexArithmeticOptimizePass()
+{
+    return std::make_unique<IndexArithmeticOptimizePass>();
+}
+
+} // namespace accera::transforms::value
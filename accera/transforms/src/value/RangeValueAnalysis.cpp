@@ -0,0 +1,399 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+//  Authors: Abdul Dakkak
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "value/RangeValueAnalysis.h"
+
+#include <ir/include/value/ValueDialect.h>
+
+#include <mlir/Dialect/Affine/IR/AffineOps.h>
+#include <mlir/Dialect/GPU/GPUDialect.h>
+#include <mlir/Dialect/SCF/SCF.h>
+#include <mlir/Dialect/StandardOps/IR/Ops.h>
+#include <mlir/IR/Builders.h>
+#include <mlir/IR/BuiltinTypes.h>
+#include <mlir/Support/MathExtras.h>
+
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/ADT/StringSwitch.h>
+#include <llvm/ADT/TypeSwitch.h>
+
+#include <algorithm>
+#include <optional>
+
+using namespace mlir;
+
+using llvm::APInt;
+using llvm::ConstantRange;
+using llvm::Instruction;
+
+namespace vir = accera::ir::value;
+
+namespace accera::transforms::value
+{
+namespace
+{
+    // The signed bounds of a range, if it has any
+    std::optional<std::pair<int64_t, int64_t>> getSignedBounds(const RangeValue& value)
+    {
+        if (value.range.isFullSet() || value.range.isEmptySet() || value.range.isSignWrappedSet())
+        {
+            return std::nullopt;
+        }
+        return std::make_pair(value.range.getSignedMin().getSExtValue(), value.range.getSignedMax().getSExtValue());
+    }
+
+    int dimIndexToInteger(llvm::StringRef dim)
+    {
+        return ::llvm::StringSwitch<int>(dim)
+            .Case("x", 0)
+            .Case("y", 1)
+            .Case("z", 2)
+            .Default(-1);
+    }
+
+    // The size of the grid or of the blocks of the kernel that contains an op in a dimension: the launch
+    // configuration of the GPU function, or of the value function before it is outlined, whose attribute holds the
+    // grid sizes followed by the block sizes
+    std::optional<int64_t> getLaunchSize(Operation* op, llvm::StringRef gpuFuncAttrName, unsigned launchAttrOffset, llvm::StringRef dim)
+    {
+        auto dimIdx = dimIndexToInteger(dim);
+        if (dimIdx == -1)
+        {
+            return std::nullopt;
+        }
+        if (auto gpuFunc = op->getParentOfType<gpu::GPUFuncOp>())
+        {
+            if (auto sizeAttr = gpuFunc->getAttrOfType<ArrayAttr>(gpuFuncAttrName))
+            {
+                return sizeAttr.getValue()[dimIdx].cast<IntegerAttr>().getInt();
+            }
+            return std::nullopt;
+        }
+        for (auto parentOp = op->getParentOp(); parentOp != nullptr; parentOp = parentOp->getParentOp())
+        {
+            if (auto launchAttr = parentOp->getAttrOfType<ArrayAttr>(vir::ValueFuncOp::getGPULaunchAttrName()))
+            {
+                if (launchAttr.size() != 6)
+                {
+                    return std::nullopt;
+                }
+                return launchAttr.getValue()[launchAttrOffset + dimIdx].cast<IntegerAttr>().getInt();
+            }
+        }
+        return std::nullopt;
+    }
+
+    // The range of ids in [0, size)
+    RangeValue getIdRange(std::optional<int64_t> size)
+    {
+        return size && *size > 0 ? RangeValue(0, *size - 1) : RangeValue();
+    }
+} // namespace
+
+mlir::DictionaryAttr RangeValue::asAttr(MLIRContext* ctx) const
+{
+    mlir::NamedAttrList entries;
+    entries.set("lower_bound", mlir::IntegerAttr::get(mlir::IntegerType::get(ctx, 64), range.getLower()));
+    entries.set("upper_bound", mlir::IntegerAttr::get(mlir::IntegerType::get(ctx, 64), range.getUpper()));
+    return DictionaryAttr::get(ctx, entries);
+}
+
+RangeValueAnalysis::RangeValueAnalysis(Operation* rootOp)
+{
+    llvm::SmallPtrSet<Operation*, 16> worklist;
+    rootOp->walk([&](Operation* op) {
+        if (!op->hasTrait<OpTrait::SymbolTable>())
+        {
+            worklist.insert(op);
+        }
+    });
+
+    while (!worklist.empty())
+    {
+        auto nextOp = llvm::find_if(worklist, [&, this](Operation* op) {
+            return allOperandsHaveRanges(op);
+        });
+        if (nextOp == worklist.end())
+            break;
+        Operation* op = *nextOp;
+        worklist.erase(op);
+
+        auto range = resolveRangeValue(op);
+
+        mlir::TypeSwitch<Operation*>(op)
+            .Case([&](scf::ForOp op) { rangeMap.insert({ op.getInductionVar(), range }); })
+            .Case([&](AffineForOp op) { rangeMap.insert({ op.getInductionVar(), range }); })
+            .Default([&](Operation* op) {
+                for (auto res : op->getResults())
+                {
+                    rangeMap.insert({ res, range });
+                }
+            });
+    }
+}
+
+bool RangeValueAnalysis::hasRange(Value value) const
+{
+    return rangeMap.find(value) != rangeMap.end();
+}
+
+RangeValue RangeValueAnalysis::getRange(Value value) const
+{
+    if (!hasRange(value))
+    {
+        return RangeValue();
+    }
+    auto it = rangeMap.find(value);
+    assert(it != rangeMap.end());
+    return it->second;
+}
+
+RangeValue RangeValueAnalysis::resolveRange(Value value)
+{
+    if (auto it = rangeMap.find(value); it != rangeMap.end())
+    {
+        return it->second;
+    }
+
+    // The value is full range until it is resolved, which also ends the recursion if the IR has a cycle
+    rangeMap.insert({ value, RangeValue() });
+
+    Operation* op = value.getDefiningOp();
+    bool isLoop = false;
+    if (!op)
+    {
+        op = value.cast<BlockArgument>().getOwner()->getParentOp();
+    }
+    if (op)
+    {
+        isLoop = isa<AffineForOp, scf::ForOp>(op);
+    }
+
+    // The loops give a range to their induction variable only, and the other block arguments have none
+    bool hasRangeOp = op && (isLoop ? (value == getSingleInductionVar(op)) : value.getDefiningOp() == op);
+    if (!hasRangeOp)
+    {
+        return RangeValue();
+    }
+
+    for (auto operand : getRangeOperands(op))
+    {
+        (void)resolveRange(operand);
+    }
+    auto range = resolveRangeValue(op);
+    rangeMap[value] = range;
+    return range;
+}
+
+RangeValue RangeValueAnalysis::resolveRange(AffineExpr expr, ValueRange operands, unsigned numDims)
+{
+    SmallVector<RangeValue, 4> operandRanges;
+    for (auto operand : operands)
+    {
+        operandRanges.push_back(resolveRange(operand));
+    }
+    return resolveAffineExpr(expr, operandRanges, numDims);
+}
+
+Value RangeValueAnalysis::getSingleInductionVar(Operation* op)
+{
+    return mlir::TypeSwitch<Operation*, Value>(op)
+        .Case([&](scf::ForOp op) { return op.getInductionVar(); })
+        .Case([&](AffineForOp op) { return op.getInductionVar(); })
+        .Default([&](Operation*) { return Value(); });
+}
+
+bool RangeValueAnalysis::allOperandsHaveRanges(Operation* op)
+{
+    return llvm::all_of(getRangeOperands(op), [&, this](Value operand) {
+        return rangeMap.find(operand) != rangeMap.end();
+    });
+}
+
+SmallVector<Value, 4> RangeValueAnalysis::getRangeOperands(Operation* op)
+{
+    // The range of a loop only depends on its bounds, not on its step or its loop-carried values
+    return mlir::TypeSwitch<Operation*, SmallVector<Value, 4>>(op)
+        .Case([&](scf::ForOp op) { return SmallVector<Value, 4>{ op.lowerBound(), op.upperBound() }; })
+        .Case([&](AffineForOp op) {
+            SmallVector<Value, 4> operands(op.getLowerBoundOperands());
+            operands.append(op.getUpperBoundOperands().begin(), op.getUpperBoundOperands().end());
+            return operands;
+        })
+        .Default([&](Operation* op) { return SmallVector<Value, 4>(op->getOperands()); });
+}
+
+SmallVector<RangeValue, 3> RangeValueAnalysis::resolveOperands(Operation* op)
+{
+    SmallVector<RangeValue, 3> operands;
+    transform(op->getOperands(), std::back_inserter(operands), [&](Value operand) {
+        if (hasRange(operand))
+        {
+            return rangeMap[operand];
+        }
+        return RangeValue();
+    });
+    return operands;
+}
+
+RangeValue RangeValueAnalysis::resolveRangeValue(Operation* op)
+{
+    return mlir::TypeSwitch<Operation*, RangeValue>(op)
+        .Case([&](ConstantOp op) {
+            if (auto value = op.getValue().dyn_cast<IntegerAttr>())
+            {
+                return RangeValue(value.getValue(), value.getValue());
+            }
+            return RangeValue();
+        })
+        .Case([&](IndexCastOp op) { return getRange(op.in()); })
+        .Case([&](gpu::ThreadIdOp op) { return getIdRange(getLaunchSize(op, "blockSize", 3, op.dimension())); })
+        .Case([&](gpu::BlockIdOp op) { return getIdRange(getLaunchSize(op, "gridSize", 0, op.dimension())); })
+        .Case([&](AddIOp op) { return resolveRangeValue(Instruction::BinaryOps::Add, op); })
+        .Case([&](SubIOp op) { return resolveRangeValue(Instruction::BinaryOps::Sub, op); })
+        .Case([&](MulIOp op) { return resolveRangeValue(Instruction::BinaryOps::Mul, op); })
+        .Case([&](SignedRemIOp op) { return resolveRangeValue(Instruction::BinaryOps::SRem, op); })
+        .Case([&](UnsignedRemIOp op) { return resolveRangeValue(Instruction::BinaryOps::URem, op); })
+        .Case([&](SignedDivIOp op) { return resolveRangeValue(Instruction::BinaryOps::SDiv, op); })
+        .Case([&](UnsignedDivIOp op) { return resolveRangeValue(Instruction::BinaryOps::UDiv, op); })
+        .Case([&](AffineApplyOp op) { return resolveAffineExpr(op.getAffineMap().getResult(0), resolveOperands(op), op.getAffineMap().getNumDims()); })
+        .Case([&](AffineMinOp op) { return resolveAffineMinMax(op.getAffineMap(), resolveOperands(op), /*isMin=*/true); })
+        .Case([&](AffineMaxOp op) { return resolveAffineMinMax(op.getAffineMap(), resolveOperands(op), /*isMin=*/false); })
+        .Case([&](scf::ForOp op) {
+            auto lowerBound = getSignedBounds(getRange(op.lowerBound()));
+            auto upperBound = getSignedBounds(getRange(op.upperBound()));
+            if (!lowerBound || !upperBound || upperBound->second - 1 < lowerBound->first)
+            {
+                return RangeValue();
+            }
+            return RangeValue(lowerBound->first, upperBound->second - 1);
+        })
+        .Case([&](AffineForOp op) {
+            if (op.hasConstantBounds())
+            {
+                return op.getConstantUpperBound() - 1 < op.getConstantLowerBound() ? RangeValue() : RangeValue(op.getConstantLowerBound(), op.getConstantUpperBound() - 1);
+            }
+
+            // The induction variable is at least each lower bound and less than each upper bound, which bound it
+            // as soon as one of each has a range
+            std::optional<int64_t> min, max;
+            auto lbMap = op.getLowerBoundMap();
+            for (auto expr : lbMap.getResults())
+            {
+                SmallVector<RangeValue, 4> operandRanges;
+                for (auto operand : op.getLowerBoundOperands())
+                {
+                    operandRanges.push_back(getRange(operand));
+                }
+                if (auto bounds = getSignedBounds(resolveAffineExpr(expr, operandRanges, lbMap.getNumDims())))
+                {
+                    min = std::max(min.value_or(bounds->first), bounds->first);
+                }
+            }
+            auto ubMap = op.getUpperBoundMap();
+            for (auto expr : ubMap.getResults())
+            {
+                SmallVector<RangeValue, 4> operandRanges;
+                for (auto operand : op.getUpperBoundOperands())
+                {
+                    operandRanges.push_back(getRange(operand));
+                }
+                if (auto bounds = getSignedBounds(resolveAffineExpr(expr, operandRanges, ubMap.getNumDims())))
+                {
+                    max = std::min(max.value_or(bounds->second - 1), bounds->second - 1);
+                }
+            }
+            if (!min || !max || *max < *min)
+            {
+                return RangeValue();
+            }
+            return RangeValue(*min, *max);
+        })
+        .Default([&](Operation*) { return RangeValue(); });
+}
+
+RangeValue RangeValueAnalysis::resolveRangeValue(Instruction::BinaryOps binOp, Operation* op)
+{
+    auto operands = resolveOperands(op);
+    return operands[0].binaryOp(binOp, operands[1]);
+}
+
+RangeValue RangeValueAnalysis::resolveAffineExpr(AffineExpr expr, ArrayRef<RangeValue> operandRanges, unsigned numDims)
+{
+    if (auto constExpr = expr.dyn_cast<AffineConstantExpr>())
+    {
+        return RangeValue(constExpr.getValue(), constExpr.getValue());
+    }
+    if (auto dimExpr = expr.dyn_cast<AffineDimExpr>())
+    {
+        return operandRanges[dimExpr.getPosition()];
+    }
+    if (auto symbolExpr = expr.dyn_cast<AffineSymbolExpr>())
+    {
+        return operandRanges[numDims + symbolExpr.getPosition()];
+    }
+
+    auto binaryExpr = expr.cast<AffineBinaryOpExpr>();
+    auto lhs = resolveAffineExpr(binaryExpr.getLHS(), operandRanges, numDims);
+    auto rhs = resolveAffineExpr(binaryExpr.getRHS(), operandRanges, numDims);
+    switch (expr.getKind())
+    {
+    case AffineExprKind::Add:
+        return lhs.binaryOp(Instruction::BinaryOps::Add, rhs);
+    case AffineExprKind::Mul:
+        return lhs.binaryOp(Instruction::BinaryOps::Mul, rhs);
+    default:
+        break;
+    }
+
+    // The right hand side of mod, floordiv and ceildiv is a positive constant in pure affine expressions
+    auto divisor = binaryExpr.getRHS().dyn_cast<AffineConstantExpr>();
+    if (!divisor || divisor.getValue() <= 0)
+    {
+        return RangeValue();
+    }
+    auto c = divisor.getValue();
+    auto bounds = getSignedBounds(lhs);
+    switch (expr.getKind())
+    {
+    case AffineExprKind::Mod:
+        return bounds && bounds->first >= 0 && bounds->second < c ? lhs : RangeValue(0, c - 1);
+    case AffineExprKind::FloorDiv:
+        return bounds ? RangeValue(mlir::floorDiv(bounds->first, c), mlir::floorDiv(bounds->second, c)) : RangeValue();
+    case AffineExprKind::CeilDiv:
+        return bounds ? RangeValue(mlir::ceilDiv(bounds->first, c), mlir::ceilDiv(bounds->second, c)) : RangeValue();
+    default:
+        return RangeValue();
+    }
+}
+
+RangeValue RangeValueAnalysis::resolveAffineMinMax(AffineMap map, ArrayRef<RangeValue> operandRanges, bool isMin)
+{
+    std::optional<std::pair<int64_t, int64_t>> result;
+    for (auto expr : map.getResults())
+    {
+        auto bounds = getSignedBounds(resolveAffineExpr(expr, operandRanges, map.getNumDims()));
+        if (!bounds)
+        {
+            return RangeValue();
+        }
+        if (!result)
+        {
+            result = bounds;
+        }
+        else if (isMin)
+        {
+            result = std::make_pair(std::min(result->first, bounds->first), std::min(result->second, bounds->second));
+        }
+        else
+        {
+            result = std::make_pair(std::max(result->first, bounds->first), std::max(result->second, bounds->second));
+        }
+    }
+    return result ? RangeValue(result->first, result->second) : RangeValue();
+}
+
+} // namespace accera::transforms::value
@@ -0,0 +1,401 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "AcceraPasses.h"
+
+#include <mlir/Dialect/LLVMIR/LLVMDialect.h>
+#include <mlir/Dialect/OpenMP/OpenMPDialect.h>
+#include <mlir/IR/BlockAndValueMapping.h>
+#include <mlir/IR/Builders.h>
+#include <mlir/IR/BuiltinOps.h>
+#include <mlir/Transforms/RegionUtils.h>
+
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/SetVector.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/Twine.h>
+
+#include <string>
+
+using namespace mlir;
+
+namespace
+{
+// These names match the C API in accera/runtime/include/ThreadPool.h
+const char* ThreadPoolRunFunctionName = "AcceraThreadPoolRun";
+const char* ThreadPoolBarrierFunctionName = "AcceraThreadPoolBarrier";
+
+Value CreateConstant(OpBuilder& builder, Location loc, Type type, int64_t value)
+{
+    return builder.create<LLVM::ConstantOp>(loc, type, builder.getIntegerAttr(type, value));
+}
+
+Value CastInteger(OpBuilder& builder, Location loc, Value value, Type type)
+{
+    auto sourceWidth = value.getType().cast<IntegerType>().getWidth();
+    auto targetWidth = type.cast<IntegerType>().getWidth();
+    if (sourceWidth == targetWidth)
+    {
+        return value;
+    }
+    if (sourceWidth < targetWidth)
+    {
+        return builder.create<LLVM::SExtOp>(loc, type, value);
+    }
+    return builder.create<LLVM::TruncOp>(loc, type, value);
+}
+
+Value CreateMin(OpBuilder& builder, Location loc, Value lhs, Value rhs)
+{
+    auto isLess = builder.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::slt, lhs, rhs);
+    return builder.create<LLVM::SelectOp>(loc, isLess, lhs, rhs);
+}
+
+bool IsThreadPoolCompatible(omp::ParallelOp parallelOp)
+{
+    if (!parallelOp->getParentOfType<LLVM::LLVMFuncOp>())
+    {
+        return false;
+    }
+
+    auto result = parallelOp.region().walk([](Operation* op) {
+        if (auto callOp = dyn_cast<LLVM::CallOp>(op))
+        {
+            // Queries of the OpenMP team (e.g. the thread number used to pin threads) need an OpenMP region
+            auto callee = callOp.callee();
+            return (callee && callee->startswith("omp_")) ? WalkResult::interrupt() : WalkResult::advance();
+        }
+        if (op->getName().getDialectNamespace() != omp::OpenMPDialect::getDialectNamespace())
+        {
+            return WalkResult::advance();
+        }
+        if (auto wsLoopOp = dyn_cast<omp::WsLoopOp>(op))
+        {
+            // Only plain worksharing loops over integers can be partitioned by the outlined region
+            auto hasIntegerBounds = llvm::all_of(wsLoopOp.lowerBound().getTypes(), [](Type type) { return type.isa<IntegerType>(); });
+            if (!hasIntegerBounds || !wsLoopOp.reduction_vars().empty() || !wsLoopOp.linear_vars().empty() || wsLoopOp.ordered_valAttr())
+            {
+                return WalkResult::interrupt();
+            }
+            return WalkResult::advance();
+        }
+        if (isa<omp::YieldOp, omp::TerminatorOp, omp::BarrierOp>(op))
+        {
+            return WalkResult::advance();
+        }
+
+        // Nested parallel regions and other constructs stay on the OpenMP runtime
+        return WalkResult::interrupt();
+    });
+    return !result.wasInterrupted();
+}
+
+LLVM::LLVMFuncOp GetOrInsertRuntimeFunction(ModuleOp module, StringRef name, LLVM::LLVMFunctionType type)
+{
+    if (auto func = module.lookupSymbol<LLVM::LLVMFuncOp>(name))
+    {
+        return func;
+    }
+
+    OpBuilder builder(module.getBodyRegion());
+    return builder.create<LLVM::LLVMFuncOp>(module.getLoc(), name, type);
+}
+
+class ThreadPoolDispatchPass : public accera::transforms::ConvertOMPToThreadPoolBase<ThreadPoolDispatchPass>
+{
+public:
+    void runOnModule() final;
+
+private:
+    LLVM::LLVMFuncOp OutlineParallelRegion(omp::ParallelOp parallelOp, llvm::ArrayRef<Value> capturedValues, llvm::ArrayRef<Operation*> clonedOps, const std::string& taskName);
+    void LowerWsLoop(omp::WsLoopOp wsLoopOp, Value threadIndex, Value numThreads);
+    void DispatchParallelRegion(omp::ParallelOp parallelOp, int64_t regionIndex);
+};
+
+void ThreadPoolDispatchPass::runOnModule()
+{
+    auto module = getOperation();
+    auto* context = &getContext();
+
+    llvm::SmallVector<omp::ParallelOp, 4> parallelOps;
+    module.walk([&](omp::ParallelOp parallelOp) {
+        if (!parallelOp->getParentOfType<omp::ParallelOp>() && IsThreadPoolCompatible(parallelOp))
+        {
+            parallelOps.push_back(parallelOp);
+        }
+    });
+    if (parallelOps.empty())
+    {
+        return;
+    }
+
+    auto voidType = LLVM::LLVMVoidType::get(context);
+    auto i64Type = IntegerType::get(context, 64);
+    auto i8PtrType = LLVM::LLVMPointerType::get(IntegerType::get(context, 8));
+    auto taskType = LLVM::LLVMFunctionType::get(voidType, { i8PtrType, i64Type, i64Type });
+    GetOrInsertRuntimeFunction(module, ThreadPoolRunFunctionName, LLVM::LLVMFunctionType::get(voidType, { i64Type, LLVM::LLVMPointerType::get(taskType), i8PtrType }));
+    GetOrInsertRuntimeFunction(module, ThreadPoolBarrierFunctionName, LLVM::LLVMFunctionType::get(voidType, {}));
+
+    for (auto en : llvm::enumerate(parallelOps))
+    {
+        DispatchParallelRegion(en.value(), static_cast<int64_t>(en.index()));
+    }
+}
+
+LLVM::LLVMFuncOp ThreadPoolDispatchPass::OutlineParallelRegion(omp::ParallelOp parallelOp, llvm::ArrayRef<Value> capturedValues, llvm::ArrayRef<Operation*> clonedOps, const std::string& taskName)
+{
+    auto* context = &getContext();
+    auto loc = parallelOp.getLoc();
+    auto parentFunc = parallelOp->getParentOfType<LLVM::LLVMFuncOp>();
+
+    auto i32Type = IntegerType::get(context, 32);
+    auto i64Type = IntegerType::get(context, 64);
+    auto i8PtrType = LLVM::LLVMPointerType::get(IntegerType::get(context, 8));
+    auto taskType = LLVM::LLVMFunctionType::get(LLVM::LLVMVoidType::get(context), { i8PtrType, i64Type, i64Type });
+
+    OpBuilder builder(parentFunc);
+    auto taskFunc = builder.create<LLVM::LLVMFuncOp>(loc, taskName, taskType, LLVM::Linkage::Internal);
+    auto entryBlock = taskFunc.addEntryBlock();
+    builder.setInsertionPointToStart(entryBlock);
+
+    // Constants and symbol addresses are rematerialized, everything else is read from the context struct
+    BlockAndValueMapping mapping;
+    for (auto op : clonedOps)
+    {
+        builder.clone(*op, mapping);
+    }
+    if (!capturedValues.empty())
+    {
+        llvm::SmallVector<Type, 8> capturedTypes;
+        for (auto value : capturedValues)
+        {
+            capturedTypes.push_back(value.getType());
+        }
+        auto contextPtrType = LLVM::LLVMPointerType::get(LLVM::LLVMStructType::getLiteral(context, capturedTypes));
+        Value contextPtr = builder.create<LLVM::BitcastOp>(loc, contextPtrType, entryBlock->getArgument(0));
+        auto zero = CreateConstant(builder, loc, i32Type, 0);
+        for (auto en : llvm::enumerate(capturedValues))
+        {
+            auto fieldIndex = CreateConstant(builder, loc, i32Type, static_cast<int64_t>(en.index()));
+            Value fieldPtr = builder.create<LLVM::GEPOp>(loc, LLVM::LLVMPointerType::get(en.value().getType()), contextPtr, ValueRange{ zero, fieldIndex });
+            mapping.map(en.value(), builder.create<LLVM::LoadOp>(loc, fieldPtr).getResult());
+        }
+    }
+
+    auto& parallelRegion = parallelOp.region();
+    parallelRegion.cloneInto(&taskFunc.getBody(), mapping);
+    builder.create<LLVM::BrOp>(loc, ValueRange{}, mapping.lookup(&parallelRegion.front()));
+
+    auto threadIndex = entryBlock->getArgument(1);
+    auto numThreads = entryBlock->getArgument(2);
+
+    llvm::SmallVector<omp::WsLoopOp, 4> wsLoopOps;
+    taskFunc.walk([&](omp::WsLoopOp wsLoopOp) { wsLoopOps.push_back(wsLoopOp); });
+    for (auto wsLoopOp : wsLoopOps)
+    {
+        LowerWsLoop(wsLoopOp, threadIndex, numThreads);
+    }
+
+    auto barrierCallee = SymbolRefAttr::get(context, ThreadPoolBarrierFunctionName);
+    taskFunc.walk([&](Operation* op) {
+        if (isa<omp::BarrierOp>(op))
+        {
+            OpBuilder opBuilder(op);
+            opBuilder.create<LLVM::CallOp>(op->getLoc(), TypeRange{}, barrierCallee, ValueRange{});
+            op->erase();
+        }
+        else if (isa<omp::TerminatorOp>(op))
+        {
+            OpBuilder opBuilder(op);
+            opBuilder.create<LLVM::ReturnOp>(op->getLoc(), ValueRange{});
+            op->erase();
+        }
+    });
+
+    return taskFunc;
+}
+
+void ThreadPoolDispatchPass::LowerWsLoop(omp::WsLoopOp wsLoopOp, Value threadIndex, Value numThreads)
+{
+    auto loc = wsLoopOp.getLoc();
+    auto& loopRegion = wsLoopOp.region();
+    auto ivType = loopRegion.front().getArgument(0).getType();
+    auto lowerBounds = llvm::to_vector<4>(wsLoopOp.lowerBound());
+    auto upperBounds = llvm::to_vector<4>(wsLoopOp.upperBound());
+    auto steps = llvm::to_vector<4>(wsLoopOp.step());
+    auto numDims = lowerBounds.size();
+
+    OpBuilder builder(wsLoopOp);
+    auto zero = CreateConstant(builder, loc, ivType, 0);
+    auto one = CreateConstant(builder, loc, ivType, 1);
+
+    // Linearize the iteration space so that collapsed loops are partitioned as a whole
+    llvm::SmallVector<Value, 4> dimTripCounts;
+    Value tripCount = one;
+    for (unsigned dim = 0; dim < numDims; ++dim)
+    {
+        Value span = builder.create<LLVM::SubOp>(loc, ivType, upperBounds[dim], lowerBounds[dim]);
+        if (wsLoopOp.inclusive())
+        {
+            span = builder.create<LLVM::AddOp>(loc, ivType, span, one);
+        }
+        Value roundedSpan = builder.create<LLVM::AddOp>(loc, ivType, span, builder.create<LLVM::SubOp>(loc, ivType, steps[dim], one));
+        Value dimTripCount = builder.create<LLVM::SDivOp>(loc, ivType, roundedSpan, steps[dim]);
+        Value isEmpty = builder.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::slt, dimTripCount, zero);
+        dimTripCount = builder.create<LLVM::SelectOp>(loc, isEmpty, zero, dimTripCount);
+        dimTripCounts.push_back(dimTripCount);
+        tripCount = builder.create<LLVM::MulOp>(loc, ivType, tripCount, dimTripCount);
+    }
+
+    // Each thread runs one contiguous block of the linearized iteration space, as with a static OpenMP schedule
+    auto castThreadIndex = CastInteger(builder, loc, threadIndex, ivType);
+    auto castNumThreads = CastInteger(builder, loc, numThreads, ivType);
+    Value roundedTripCount = builder.create<LLVM::AddOp>(loc, ivType, tripCount, builder.create<LLVM::SubOp>(loc, ivType, castNumThreads, one));
+    Value chunkSize = builder.create<LLVM::SDivOp>(loc, ivType, roundedTripCount, castNumThreads);
+    auto begin = CreateMin(builder, loc, builder.create<LLVM::MulOp>(loc, ivType, castThreadIndex, chunkSize), tripCount);
+    auto end = CreateMin(builder, loc, builder.create<LLVM::AddOp>(loc, ivType, begin, chunkSize), tripCount);
+
+    auto currentBlock = wsLoopOp->getBlock();
+    auto continueBlock = currentBlock->splitBlock(std::next(Block::iterator(wsLoopOp)));
+    auto parentRegion = currentBlock->getParent();
+    auto headerBlock = builder.createBlock(parentRegion, continueBlock->getIterator(), TypeRange{ ivType });
+    auto bodyBlock = builder.createBlock(parentRegion, continueBlock->getIterator());
+    auto latchBlock = builder.createBlock(parentRegion, continueBlock->getIterator());
+
+    builder.setInsertionPoint(wsLoopOp);
+    builder.create<LLVM::BrOp>(loc, ValueRange{ begin }, headerBlock);
+
+    builder.setInsertionPointToStart(headerBlock);
+    auto index = headerBlock->getArgument(0);
+    auto inRange = builder.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::slt, index, end);
+    builder.create<LLVM::CondBrOp>(loc, inRange, bodyBlock, ValueRange{}, continueBlock, ValueRange{});
+
+    // Recover the induction variables, the innermost dimension varying fastest
+    builder.setInsertionPointToStart(bodyBlock);
+    llvm::SmallVector<Value, 4> ivs(numDims);
+    Value remaining = index;
+    for (auto dim = static_cast<int64_t>(numDims) - 1; dim >= 0; --dim)
+    {
+        Value dimIndex = dim == 0 ? remaining : builder.create<LLVM::SRemOp>(loc, ivType, remaining, dimTripCounts[dim]);
+        ivs[dim] = builder.create<LLVM::AddOp>(loc, ivType, lowerBounds[dim], builder.create<LLVM::MulOp>(loc, ivType, dimIndex, steps[dim]));
+        if (dim > 0)
+        {
+            remaining = builder.create<LLVM::SDivOp>(loc, ivType, remaining, dimTripCounts[dim]);
+        }
+    }
+    builder.create<LLVM::BrOp>(loc, ivs, &loopRegion.front());
+
+    llvm::SmallVector<omp::YieldOp, 2> yieldOps;
+    for (auto& block : loopRegion)
+    {
+        if (auto yieldOp = dyn_cast<omp::YieldOp>(block.getTerminator()))
+        {
+            yieldOps.push_back(yieldOp);
+        }
+    }
+    parentRegion->getBlocks().splice(latchBlock->getIterator(), loopRegion.getBlocks());
+    for (auto yieldOp : yieldOps)
+    {
+        OpBuilder yieldBuilder(yieldOp);
+        yieldBuilder.create<LLVM::BrOp>(yieldOp.getLoc(), ValueRange{}, latchBlock);
+        yieldOp.erase();
+    }
+
+    builder.setInsertionPointToStart(latchBlock);
+    Value nextIndex = builder.create<LLVM::AddOp>(loc, ivType, index, one);
+    builder.create<LLVM::BrOp>(loc, ValueRange{ nextIndex }, headerBlock);
+
+    // The implicit barrier at the end of the loop is only needed if the region does more work afterwards,
+    // AcceraThreadPoolRun already waits for all threads at the end of the region
+    if (!wsLoopOp.nowait() && !isa<omp::TerminatorOp>(continueBlock->front()))
+    {
+        builder.setInsertionPointToStart(continueBlock);
+        builder.create<LLVM::CallOp>(loc, TypeRange{}, SymbolRefAttr::get(&getContext(), ThreadPoolBarrierFunctionName), ValueRange{});
+    }
+
+    wsLoopOp.erase();
+}
+
+void ThreadPoolDispatchPass::DispatchParallelRegion(omp::ParallelOp parallelOp, int64_t regionIndex)
+{
+    auto* context = &getContext();
+    auto loc = parallelOp.getLoc();
+    auto parentFunc = parallelOp->getParentOfType<LLVM::LLVMFuncOp>();
+    auto i32Type = IntegerType::get(context, 32);
+    auto i64Type = IntegerType::get(context, 64);
+    auto i8PtrType = LLVM::LLVMPointerType::get(IntegerType::get(context, 8));
+
+    llvm::SetVector<Value> usedValues;
+    getUsedValuesDefinedAbove(parallelOp.region(), usedValues);
+    llvm::SmallVector<Value, 8> capturedValues;
+    llvm::SmallVector<Operation*, 8> clonedOps;
+    for (auto value : usedValues)
+    {
+        auto definingOp = value.getDefiningOp();
+        if (definingOp && isa<LLVM::ConstantOp, LLVM::AddressOfOp>(definingOp))
+        {
+            clonedOps.push_back(definingOp);
+        }
+        else
+        {
+            capturedValues.push_back(value);
+        }
+    }
+
+    auto taskName = (parentFunc.getName() + "_thread_pool_task_" + llvm::Twine(regionIndex)).str();
+    auto taskFunc = OutlineParallelRegion(parallelOp, capturedValues, clonedOps, taskName);
+
+    OpBuilder builder(parallelOp);
+    Value contextArg;
+    if (capturedValues.empty())
+    {
+        contextArg = builder.create<LLVM::NullOp>(loc, i8PtrType);
+    }
+    else
+    {
+        llvm::SmallVector<Type, 8> capturedTypes;
+        for (auto value : capturedValues)
+        {
+            capturedTypes.push_back(value.getType());
+        }
+        auto contextPtrType = LLVM::LLVMPointerType::get(LLVM::LLVMStructType::getLiteral(context, capturedTypes));
+
+        // Allocate the context in the entry block so that regions inside loops don't grow the stack
+        auto& funcEntryBlock = parentFunc.getBody().front();
+        OpBuilder allocaBuilder(&funcEntryBlock, funcEntryBlock.begin());
+        auto arraySize = CreateConstant(allocaBuilder, loc, i64Type, 1);
+        Value contextPtr = allocaBuilder.create<LLVM::AllocaOp>(loc, contextPtrType, arraySize, /* alignment */ 0);
+
+        auto zero = CreateConstant(builder, loc, i32Type, 0);
+        for (auto en : llvm::enumerate(capturedValues))
+        {
+            auto fieldIndex = CreateConstant(builder, loc, i32Type, static_cast<int64_t>(en.index()));
+            Value fieldPtr = builder.create<LLVM::GEPOp>(loc, LLVM::LLVMPointerType::get(en.value().getType()), contextPtr, ValueRange{ zero, fieldIndex });
+            builder.create<LLVM::StoreOp>(loc, en.value(), fieldPtr);
+        }
+        contextArg = builder.create<LLVM::BitcastOp>(loc, i8PtrType, contextPtr);
+    }
+
+    // A thread count of 0 runs the region on every thread of the pool
+    Value numThreads = parallelOp.num_threads_var() ? CastInteger(builder, loc, parallelOp.num_threads_var(), i64Type) : CreateConstant(builder, loc, i64Type, 0);
+    if (auto condition = parallelOp.if_expr_var())
+    {
+        numThreads = builder.create<LLVM::SelectOp>(loc, condition, numThreads, CreateConstant(builder, loc, i64Type, 1));
+    }
+
+    Value taskPtr = builder.create<LLVM::AddressOfOp>(loc, taskFunc);
+    builder.create<LLVM::CallOp>(loc, TypeRange{}, SymbolRefAttr::get(context, ThreadPoolRunFunctionName), ValueRange{ numThreads, taskPtr, contextArg });
+    parallelOp.erase();
+}
+
+} // namespace
+
+namespace accera::transforms::value
+{
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createThreadPoolDispatchPass()
+{
+    return std::make_unique<ThreadPoolDispatchPass>();
+}
+} // namespace accera::transforms::value
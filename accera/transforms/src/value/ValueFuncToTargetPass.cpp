@@ -14,24 +14,34 @@
 #include <mlir/Analysis/LoopAnalysis.h>
 #include <mlir/Dialect/Affine/IR/AffineOps.h>
 #include <mlir/Dialect/GPU/GPUDialect.h>
+#include <mlir/Dialect/LLVMIR/LLVMDialect.h>
 #include <mlir/Dialect/Linalg/IR/LinalgOps.h>
+#include <mlir/Dialect/MemRef/IR/MemRef.h>
 #include <mlir/Dialect/SPIRV/IR/SPIRVDialect.h>
 #include <mlir/Dialect/SPIRV/IR/SPIRVOps.h>
 #include <mlir/Dialect/SPIRV/IR/TargetAndABI.h>
 #include <mlir/Dialect/StandardOps/IR/Ops.h>
 #include <mlir/Pass/Pass.h>
 #include <mlir/Pass/PassManager.h>
+#include <mlir/Support/FileUtilities.h>
 #include <mlir/Transforms/GreedyPatternRewriteDriver.h>
 #include <mlir/Transforms/LoopUtils.h>
 #include <mlir/Transforms/RegionUtils.h>
 
 #include <llvm/ADT/STLExtras.h>
 #include <llvm/ADT/SetVector.h>
+#include <llvm/ADT/StringSet.h>
 #include <llvm/ADT/TypeSwitch.h>
 #include <llvm/Support/FormatVariadic.h>
+#include <llvm/Support/JSON.h>
+#include <llvm/Support/ToolOutputFile.h>
+#include <llvm/Support/raw_ostream.h>
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
+#include <string>
+#include <vector>
 
 using namespace mlir;
 namespace ir = accera::ir;
@@ -70,11 +80,182 @@ void HoistGPUBlockThreadIds(vir::ValueModuleOp vModule)
     });
 }
 
+// Returns the attr of a constant of the element type of a specialized argument, or null if the type has no constants
+Attribute GetSpecializedValueAttr(Builder& builder, Type elementType, double value)
+{
+    if (auto floatType = elementType.dyn_cast<FloatType>())
+    {
+        return builder.getFloatAttr(floatType, value);
+    }
+    if (elementType.isSignlessInteger() || elementType.isIndex())
+    {
+        return builder.getIntegerAttr(elementType, static_cast<int64_t>(value));
+    }
+    return {};
+}
+
+bool IsConstantValue(Attribute attr, double value)
+{
+    if (auto floatAttr = attr.dyn_cast<FloatAttr>())
+    {
+        return floatAttr.getValueAsDouble() == value;
+    }
+    if (auto intAttr = attr.dyn_cast<IntegerAttr>())
+    {
+        return static_cast<double>(intAttr.getValue().getSExtValue()) == value;
+    }
+    return false;
+}
+
+// Replaces the scalar loads of a memref that holds a specialized value with a constant. Multiplications by a
+// specialized 1 are replaced by their other operand, and multiplications by a specialized 0 and additions of their
+// result by the other operand of the addition, which follows the BLAS convention that data scaled by a zero factor
+// isn't read, e.g. C when beta is 0 in GEMM
+void ReplaceSpecializedLoads(Value memref, Attribute valueAttr)
+{
+    OpBuilder builder(memref.getContext());
+    if (auto blockArg = memref.dyn_cast<BlockArgument>())
+    {
+        builder.setInsertionPointToStart(blockArg.getOwner());
+    }
+    else
+    {
+        builder.setInsertionPointAfter(memref.getDefiningOp());
+    }
+
+    Value constant;
+    for (auto user : llvm::make_early_inc_range(memref.getUsers()))
+    {
+        if (isa<vir::LoadOp, memref::LoadOp, AffineLoadOp>(user) && user->getOperand(0) == memref)
+        {
+            if (!constant)
+            {
+                constant = builder.create<ConstantOp>(memref.getLoc(), valueAttr);
+            }
+            user->getResult(0).replaceAllUsesWith(constant);
+            user->erase();
+        }
+    }
+    if (!constant || !(IsConstantValue(valueAttr, 0) || IsConstantValue(valueAttr, 1)))
+    {
+        return;
+    }
+
+    llvm::SmallVector<Value, 4> worklist{ constant };
+    while (!worklist.empty())
+    {
+        auto value = worklist.pop_back_val();
+        for (auto user : llvm::make_early_inc_range(value.getUsers()))
+        {
+            auto binOp = dyn_cast<vir::BinOp>(user);
+            if (!binOp)
+            {
+                continue;
+            }
+            auto other = binOp.lhs() == value ? binOp.rhs() : binOp.lhs();
+            Value replacement;
+            if (binOp.getPredicate() == vir::BinaryOpPredicate::MUL)
+            {
+                replacement = IsConstantValue(valueAttr, 1) ? other : constant;
+            }
+            else if (binOp.getPredicate() == vir::BinaryOpPredicate::ADD && IsConstantValue(valueAttr, 0))
+            {
+                replacement = other;
+            }
+            if (replacement)
+            {
+                binOp.result().replaceAllUsesWith(replacement);
+                binOp.erase();
+                if (replacement == constant)
+                {
+                    worklist.push_back(constant);
+                }
+            }
+        }
+    }
+}
+
+// Replaces the single-element array arguments of the function specializations with the constants they are
+// specialized for. The loads of an argument are replaced by the constant, and the other uses, such as passing it to
+// another function, by a constant global. Returns the names of the constant globals.
+llvm::StringSet<> SpecializeArguments(vir::ValueModuleOp vModule)
+{
+    llvm::StringSet<> specializedGlobals;
+    vModule.walk([&](vir::ValueFuncOp funcOp) {
+        auto values = funcOp->getAttrOfType<ArrayAttr>(ir::SpecializedArgumentsAttrName);
+        if (!values || funcOp.isExternal())
+        {
+            return;
+        }
+
+        OpBuilder builder(funcOp);
+        for (auto [index, value] : llvm::enumerate(values))
+        {
+            auto floatValue = value.dyn_cast<FloatAttr>();
+            if (!floatValue || index >= funcOp.getNumArguments())
+            {
+                continue;
+            }
+            auto arg = funcOp.getArgument(index);
+            auto memrefType = arg.getType().dyn_cast<MemRefType>();
+            if (!memrefType || !memrefType.hasStaticShape() || memrefType.getNumElements() != 1)
+            {
+                funcOp.emitWarning() << "Argument " << index << " is not a single-element array and is not specialized";
+                continue;
+            }
+            auto valueAttr = GetSpecializedValueAttr(builder, memrefType.getElementType(), floatValue.getValueAsDouble());
+            if (!valueAttr)
+            {
+                continue;
+            }
+
+            ReplaceSpecializedLoads(arg, valueAttr);
+            if (arg.use_empty() || !memrefType.getAffineMaps().empty())
+            {
+                continue;
+            }
+
+            OpBuilder::InsertionGuard guard(builder);
+            builder.setInsertionPointToStart(vModule.getBody());
+            auto globalName = (funcOp.sym_name() + "_specialized_arg" + std::to_string(index)).str();
+            auto tensorType = RankedTensorType::get(memrefType.getShape(), memrefType.getElementType());
+            auto globalOp = builder.create<vir::GlobalOp>(funcOp.getLoc(), memrefType, /*isConstant=*/true, globalName, DenseElementsAttr::get(tensorType, valueAttr));
+            specializedGlobals.insert(globalName);
+
+            builder.setInsertionPointToStart(&funcOp.front());
+            auto reference = builder.create<vir::ReferenceGlobalOp>(funcOp.getLoc(), globalOp);
+            arg.replaceAllUsesWith(reference.getResult());
+        }
+    });
+    return specializedGlobals;
+}
+
+// The specialized arguments that are passed to other functions reach their loads once the calls are inlined
+void ReplaceSpecializedGlobalLoads(vir::ValueModuleOp vModule, const llvm::StringSet<>& specializedGlobals)
+{
+    vModule.walk([&](vir::ReferenceGlobalOp op) {
+        if (!specializedGlobals.contains(op.global_name()))
+        {
+            return;
+        }
+        if (auto value = op.getGlobal().getValueOrNull().dyn_cast_or_null<DenseElementsAttr>(); value && value.isSplat())
+        {
+            ReplaceSpecializedLoads(op.getResult(), value.getSplatValue());
+        }
+    });
+}
+
 constexpr auto kDefaultExecutionTarget = vir::ExecutionTarget::CPU;
 constexpr size_t kLaunchConfigNumDims = 6;
 
 struct ValueFuncToTargetPass : public tr::ValueFuncToTargetBase<ValueFuncToTargetPass>
 {
+    ValueFuncToTargetPass() = default;
+    ValueFuncToTargetPass(int64_t inlineThreshold)
+    {
+        this->inlineThreshold = inlineThreshold;
+    }
+
     void runOnOperation() final
     {
         auto module = getOperation();
@@ -82,6 +263,8 @@ struct ValueFuncToTargetPass : public tr::ValueFuncToTargetBase<ValueFuncToTarge
 
         for (auto vModule : make_early_inc_range(module.getOps<vir::ValueModuleOp>()))
         {
+            auto specializedGlobals = SpecializeArguments(vModule);
+
             {
                 OwningRewritePatternList patterns(context);
                 vtr::populateValueLambdaToFuncPatterns(context, patterns);
@@ -90,10 +273,15 @@ struct ValueFuncToTargetPass : public tr::ValueFuncToTargetBase<ValueFuncToTarge
 
             {
                 OwningRewritePatternList patterns(context);
-                vtr::populateValueLaunchFuncInlinerPatterns(context, patterns);
+                vtr::populateValueLaunchFuncInlinerPatterns(context, patterns, inlineThreshold);
                 (void)applyPatternsAndFoldGreedily(vModule, std::move(patterns));
             }
 
+            if (!specializedGlobals.empty())
+            {
+                ReplaceSpecializedGlobalLoads(vModule, specializedGlobals);
+            }
+
             {
                 OwningRewritePatternList patterns(context);
                 vtr::populateValueFuncToTargetPatterns(context, patterns);
@@ -102,23 +290,174 @@ struct ValueFuncToTargetPass : public tr::ValueFuncToTargetBase<ValueFuncToTarge
 
             HoistGPUBlockThreadIds(vModule);
         }
+    }
+};
+
+int64_t CountNestedOps(Operation* op)
+{
+    int64_t count = 0;
+    op->walk([&](Operation*) { ++count; });
+    return count - 1;
+}
+
+// Unrolling only touches the loops of one function, so it runs in a function pass that the pass manager runs on
+// the functions concurrently, after ValueFuncToTarget has turned them into FuncOps
+struct ValueUnrollLoopsPass : public tr::ValueUnrollLoopsBase<ValueUnrollLoopsPass>
+{
+    ValueUnrollLoopsPass() = default;
+    ValueUnrollLoopsPass(int64_t codeSizeBudget, bool reportUnrolling)
+    {
+        this->codeSizeBudget = codeSizeBudget;
+        this->reportUnrolling = reportUnrolling;
+    }
+
+    void runOnFunction() final
+    {
+        auto funcOp = getFunction();
+        _functionSize = CountNestedOps(funcOp);
+        _records.clear();
 
-        module.walk([&](AffineForOp op) {
+        funcOp.walk([&](AffineForOp op) {
             if (op->getAttrOfType<UnitAttr>("accv_unrolled"))
             {
                 auto tripCount = mlir::getConstantTripCount(op);
                 if (tripCount && *tripCount >= 1)
-                    (void)mlir::loopUnrollFull(op);
+                {
+                    auto factor = GetBudgetedFactor(op, *tripCount, *tripCount);
+                    if (factor == *tripCount)
+                        (void)mlir::loopUnrollFull(op);
+                    else if (factor > 1)
+                        (void)mlir::loopUnrollByFactor(op, factor);
+                }
             }
             else if (auto jammed = op->getAttrOfType<IntegerAttr>("accv_unroll_jam"))
             {
-                (void)mlir::loopUnrollJamByFactor(op, (uint64_t)jammed.getInt());
+                auto tripCount = mlir::getConstantTripCount(op);
+                auto factor = tripCount ? GetBudgetedFactor(op, *tripCount, (uint64_t)jammed.getInt()) : (uint64_t)jammed.getInt();
+                if (factor > 1)
+                    (void)mlir::loopUnrollJamByFactor(op, factor);
             }
             else
             {
                 (void)mlir::promoteIfSingleIteration(op);
             }
         });
+
+        if (!_records.empty())
+        {
+            funcOp->setAttr(ir::UnrollReportAttrName, ArrayAttr::get(&getContext(), _records));
+        }
+    }
+
+private:
+    // Returns the factor to unroll the loop by, which is the requested factor unless the unrolled copies of the loop
+    // body would take the function past the code size budget. The smaller factor divides the trip count, so that no
+    // cleanup loop is needed.
+    uint64_t GetBudgetedFactor(AffineForOp op, uint64_t tripCount, uint64_t requestedFactor)
+    {
+        auto bodySize = CountNestedOps(op) - 1; // the terminator
+        auto factor = requestedFactor;
+        if (codeSizeBudget > 0 && bodySize > 0 && _functionSize + static_cast<int64_t>(requestedFactor - 1) * bodySize > codeSizeBudget)
+        {
+            auto affordableFactor = std::max<int64_t>(1, (codeSizeBudget - _functionSize) / bodySize + 1);
+            factor = std::min<uint64_t>(requestedFactor, affordableFactor);
+            while (factor > 1 && tripCount % factor != 0)
+            {
+                --factor;
+            }
+
+            op.emitWarning() << "Unrolling this loop by " << requestedFactor << " would exceed the code size budget of "
+                             << codeSizeBudget.getValue() << " ops, it is unrolled by " << factor << " instead";
+        }
+        _functionSize += static_cast<int64_t>(factor - 1) * bodySize;
+
+        if (reportUnrolling)
+        {
+            auto locationString = [](mlir::Location loc) {
+                std::string result;
+                llvm::raw_string_ostream os(result);
+                loc.print(os);
+                return os.str();
+            };
+
+            Builder builder(&getContext());
+            llvm::SmallVector<NamedAttribute, 6> fields{
+                builder.getNamedAttr("location", builder.getStringAttr(locationString(op.getLoc()))),
+                builder.getNamedAttr("trip_count", builder.getI64IntegerAttr(static_cast<int64_t>(tripCount))),
+                builder.getNamedAttr("requested_factor", builder.getI64IntegerAttr(static_cast<int64_t>(requestedFactor))),
+                builder.getNamedAttr("unroll_factor", builder.getI64IntegerAttr(static_cast<int64_t>(factor))),
+                builder.getNamedAttr("body_ops", builder.getI64IntegerAttr(bodySize)),
+            };
+            if (auto index = op->getAttr("index"))
+            {
+                std::string indexName;
+                llvm::raw_string_ostream os(indexName);
+                index.print(os);
+                fields.push_back(builder.getNamedAttr("loop", builder.getStringAttr(os.str())));
+            }
+            _records.push_back(builder.getDictionaryAttr(fields));
+        }
+        return factor;
+    }
+
+    int64_t _functionSize = 0;
+    std::vector<Attribute> _records;
+};
+
+struct UnrollReportPass : public tr::UnrollReportBase<UnrollReportPass>
+{
+    UnrollReportPass() = default;
+    UnrollReportPass(const std::string& reportFilename)
+    {
+        this->reportFilename = reportFilename;
+    }
+
+    void runOnModule() final
+    {
+        auto module = getModule();
+
+        llvm::json::Array functions;
+        module.walk([&](FuncOp funcOp) {
+            auto report = funcOp->getAttrOfType<ArrayAttr>(ir::UnrollReportAttrName);
+            if (!report)
+            {
+                return;
+            }
+
+            llvm::json::Array loops;
+            for (auto entry : report.getAsRange<DictionaryAttr>())
+            {
+                llvm::json::Object loop;
+                for (auto field : entry)
+                {
+                    if (auto intAttr = field.second.dyn_cast<IntegerAttr>())
+                        loop[field.first.strref()] = intAttr.getInt();
+                    else if (auto stringAttr = field.second.dyn_cast<StringAttr>())
+                        loop[field.first.strref()] = stringAttr.getValue().str();
+                }
+                loops.push_back(std::move(loop));
+            }
+            functions.push_back(llvm::json::Object{ { "name", funcOp.getName().str() }, { "loops", std::move(loops) } });
+            funcOp->removeAttr(ir::UnrollReportAttrName);
+        });
+
+        llvm::json::Value result = llvm::json::Object{ { "functions", std::move(functions) } };
+        if (reportFilename.empty())
+        {
+            llvm::errs() << llvm::formatv("{0:2}", result) << "\n";
+            return;
+        }
+
+        std::string error;
+        auto reportFile = mlir::openOutputFile(reportFilename, &error);
+        if (!reportFile)
+        {
+            module.emitError() << error;
+            signalPassFailure();
+            return;
+        }
+        reportFile->os() << llvm::formatv("{0:2}", result) << "\n";
+        reportFile->keep();
     }
 };
 
@@ -162,9 +501,38 @@ struct ValueFuncToTargetPattern : OpRewritePattern<vir::ValueFuncOp>
 
         // Carry forward attributes
         newFuncOp->setAttrs(funcOp->getAttrs());
+
+        // LLVM function attributes, the target CPU and features override those of the module for this function
+        llvm::SmallVector<mlir::Attribute, 3> passthrough;
         if (funcOp->getAttr(accera::ir::NoInlineAttrName))
         {
-            newFuncOp->setAttr("passthrough", rewriter.getArrayAttr({ rewriter.getStringAttr("noinline") }));
+            passthrough.push_back(rewriter.getStringAttr("noinline"));
+        }
+        if (auto targetCPU = funcOp->getAttrOfType<mlir::StringAttr>(accera::ir::TargetCPUAttrName))
+        {
+            passthrough.push_back(rewriter.getStrArrayAttr({ "target-cpu", targetCPU.getValue() }));
+            if (auto targetFeatures = funcOp->getAttrOfType<mlir::StringAttr>(accera::ir::TargetFeaturesAttrName);
+                targetFeatures && !targetFeatures.getValue().empty())
+            {
+                passthrough.push_back(rewriter.getStrArrayAttr({ "target-features", targetFeatures.getValue() }));
+            }
+        }
+        if (!passthrough.empty())
+        {
+            newFuncOp->setAttr("passthrough", rewriter.getArrayAttr(passthrough));
+        }
+
+        // Only the raw pointer API passes each array as a single pointer, the other arguments that an array is
+        // expanded to can't be marked as noalias
+        if (funcOp->getAttr(accera::ir::NoAliasAttrName) && funcOp->getAttr(accera::ir::RawPointerAPIAttrName))
+        {
+            for (auto it : llvm::enumerate(newFuncOp.getType().getInputs()))
+            {
+                if (it.value().isa<mlir::MemRefType>())
+                {
+                    newFuncOp.setArgAttr(it.index(), mlir::LLVM::LLVMDialect::getNoAliasAttrName(), rewriter.getUnitAttr());
+                }
+            }
         }
 
         rewriter.eraseOp(funcOp);
@@ -221,6 +589,22 @@ struct ValueLambdaRewritePattern : mlir::OpRewritePattern<vir::ValueLambdaOp>
             auto loc = accera::ir::util::GetLocation(rewriter, __FILE__, __LINE__);
             vir::ValueFuncOp vFuncOp = rewriter.create<vir::ValueFuncOp>(loc, op.sym_name(), fnType, op.exec_target());
             vFuncOp.setPrivate();
+            if (auto noInlineAttr = op->getAttr(accera::ir::NoInlineAttrName))
+            {
+                vFuncOp->setAttr(accera::ir::NoInlineAttrName, noInlineAttr);
+            }
+
+            // The outlined lambda is compiled for the same CPU as the function it was defined in
+            if (auto parentFnOp = op->getParentOfType<vir::ValueFuncOp>())
+            {
+                for (auto attrName : { accera::ir::TargetCPUAttrName, accera::ir::TargetFeaturesAttrName })
+                {
+                    if (auto attr = parentFnOp->getAttr(attrName))
+                    {
+                        vFuncOp->setAttr(attrName, attr);
+                    }
+                }
+            }
 
             return vFuncOp;
         }();
@@ -263,6 +647,14 @@ struct ValueLambdaRewritePattern : mlir::OpRewritePattern<vir::ValueLambdaOp>
             launchFuncOp->setAttr(vir::ValueFuncOp::getGPULaunchAttrName(), launchAttr);
             vFuncOp->setAttr(vir::ValueFuncOp::getGPULaunchAttrName(), launchAttr);
         }
+        if (auto persistentBlocksAttr = op->getAttr(ir::GPUPersistentBlocksAttrName))
+        {
+            vFuncOp->setAttr(ir::GPUPersistentBlocksAttrName, persistentBlocksAttr);
+        }
+        if (auto streamKDimAttr = op->getAttr(ir::GPUStreamKDimAttrName))
+        {
+            vFuncOp->setAttr(ir::GPUStreamKDimAttrName, streamKDimAttr);
+        }
 
         rewriter.eraseOp(op);
     }
@@ -270,7 +662,10 @@ struct ValueLambdaRewritePattern : mlir::OpRewritePattern<vir::ValueLambdaOp>
 
 struct ValueLaunchFuncOpInlinerPattern : OpRewritePattern<vir::LaunchFuncOp>
 {
-    using OpRewritePattern::OpRewritePattern;
+    ValueLaunchFuncOpInlinerPattern(MLIRContext* context, int64_t inlineThreshold, PatternBenefit benefit = 1) :
+        OpRewritePattern(context, benefit), inlineThreshold(inlineThreshold)
+    {}
+
     LogicalResult matchAndRewrite(vir::LaunchFuncOp op, PatternRewriter& rewriter) const final
     {
         auto target = op.exec_targetAttr();
@@ -301,6 +696,10 @@ struct ValueLaunchFuncOpInlinerPattern : OpRewritePattern<vir::LaunchFuncOp>
             {
                 return failure();
             }
+            if (callable->getAttr(ir::InlineAutoAttrName) && !IsWorthInlining(callable, parentFnOp->getParentOp()))
+            {
+                return failure();
+            }
 
             auto& body = callable->getRegion(0);
 
@@ -320,6 +719,25 @@ struct ValueLaunchFuncOpInlinerPattern : OpRewritePattern<vir::LaunchFuncOp>
 
         return failure();
     }
+
+private:
+    // A function that the heuristic is applied to is inlined into its callers if it is small, or if it is only called
+    // once and its body isn't kept for other callers
+    bool IsWorthInlining(Operation* callee, Operation* symbolTableOp) const
+    {
+        if (CountNestedOps(callee) <= inlineThreshold)
+        {
+            return true;
+        }
+        if (auto symbol = dyn_cast<SymbolOpInterface>(callee); symbol && symbol.isPublic())
+        {
+            return false;
+        }
+        auto uses = SymbolTable::getSymbolUses(callee, symbolTableOp);
+        return uses && llvm::hasSingleElement(*uses);
+    }
+
+    int64_t inlineThreshold;
 };
 
 } // namespace
@@ -339,10 +757,10 @@ void populateValueLambdaToFuncPatterns(mlir::MLIRContext* context, mlir::OwningR
     patterns.insert<ValueLambdaRewritePattern>(context, benefit++);
 }
 
-void populateValueLaunchFuncInlinerPatterns(mlir::MLIRContext* context, mlir::OwningRewritePatternList& patterns)
+void populateValueLaunchFuncInlinerPatterns(mlir::MLIRContext* context, mlir::OwningRewritePatternList& patterns, int64_t inlineThreshold)
 {
     uint16_t benefit = 1;
-    patterns.insert<ValueLaunchFuncOpInlinerPattern>(context, benefit++);
+    patterns.insert<ValueLaunchFuncOpInlinerPattern>(context, inlineThreshold, benefit++);
 }
 
 std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createValueFuncToTargetPass()
@@ -350,4 +768,29 @@ std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createValueFuncToTargetPass
     return std::make_unique<ValueFuncToTargetPass>();
 }
 
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createValueFuncToTargetPass(int64_t inlineThreshold)
+{
+    return std::make_unique<ValueFuncToTargetPass>(inlineThreshold);
+}
+
+std::unique_ptr<mlir::OperationPass<mlir::FuncOp>> createValueUnrollLoopsPass()
+{
+    return std::make_unique<ValueUnrollLoopsPass>();
+}
+
+std::unique_ptr<mlir::OperationPass<mlir::FuncOp>> createValueUnrollLoopsPass(int64_t codeSizeBudget, bool reportUnrolling)
+{
+    return std::make_unique<ValueUnrollLoopsPass>(codeSizeBudget, reportUnrolling);
+}
+
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createUnrollReportPass()
+{
+    return std::make_unique<UnrollReportPass>();
+}
+
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createUnrollReportPass(const std::string& reportFilename)
+{
+    return std::make_unique<UnrollReportPass>(reportFilename);
+}
+
 } // namespace accera::transforms::value
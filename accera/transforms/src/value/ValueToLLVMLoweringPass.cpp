@@ -7,9 +7,11 @@
 #include "AcceraPasses.h"
 
 #include <ir/include/IRUtil.h>
+#include <ir/include/exec/VectorizationInfo.h>
 #include <ir/include/value/ValueDialect.h>
 #include <mlir/Dialect/LLVMIR/LLVMTypes.h>
 #include <mlir/IR/BuiltinTypes.h>
+#include <mlir/IR/Dominance.h>
 #include <mlir/IR/Types.h>
 #include <transforms/include/util/SnapshotUtilities.h>
 #include <value/include/Debugging.h>
@@ -27,6 +29,7 @@
 #include <mlir/Conversion/StandardToLLVM/ConvertStandardToLLVMPass.h>
 #include <mlir/Conversion/VectorToLLVM/ConvertVectorToLLVM.h>
 
+#include <mlir/Dialect/AMX/Transforms.h>
 #include <mlir/Dialect/Affine/IR/AffineOps.h>
 #include <mlir/Dialect/LLVMIR/FunctionCallUtils.h>
 #include <mlir/Dialect/LLVMIR/LLVMDialect.h>
@@ -42,10 +45,13 @@
 #include <mlir/Transforms/GreedyPatternRewriteDriver.h>
 #include <mlir/Transforms/Passes.h>
 
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/StringSet.h>
 #include <llvm/IR/DataLayout.h>
 #include <llvm/Support/raw_os_ostream.h>
 
 #include <iostream>
+#include <optional>
 
 #ifndef _MSC_VER
 #include <time.h>
@@ -248,6 +254,26 @@ struct CPUEarlyReturnRewritePattern : ValueLLVMOpConversionPattern<EarlyReturnOp
     }
 };
 
+struct VectorDotProductOpLowering : public ValueLLVMOpConversionPattern<VectorDotProductOp>
+{
+    using ValueLLVMOpConversionPattern::ValueLLVMOpConversionPattern;
+
+    LogicalResult matchAndRewrite(
+        VectorDotProductOp op,
+        ArrayRef<mlir::Value> operands,
+        ConversionPatternRewriter& rewriter) const override;
+};
+
+struct VectorBFloat16DotProductOpLowering : public ValueLLVMOpConversionPattern<VectorBFloat16DotProductOp>
+{
+    using ValueLLVMOpConversionPattern::ValueLLVMOpConversionPattern;
+
+    LogicalResult matchAndRewrite(
+        VectorBFloat16DotProductOp op,
+        ArrayRef<mlir::Value> operands,
+        ConversionPatternRewriter& rewriter) const override;
+};
+
 struct GetTimeOpLowering : public ValueLLVMOpConversionPattern<GetTimeOp>
 {
     using ValueLLVMOpConversionPattern::ValueLLVMOpConversionPattern;
@@ -257,7 +283,7 @@ struct GetTimeOpLowering : public ValueLLVMOpConversionPattern<GetTimeOp>
         ArrayRef<mlir::Value> operands,
         ConversionPatternRewriter& rewriter) const override;
 
-    mlir::Value GetTime(ConversionPatternRewriter& rewriter, mlir::Location loc, ModuleOp& parentModule) const;
+    static mlir::Value GetTime(ConversionPatternRewriter& rewriter, mlir::Location loc, ModuleOp& parentModule, bool cycleCounter = false);
 
     static FlatSymbolRefAttr getOrInsertQueryPerfFrequency(PatternRewriter& rewriter,
                                                            ModuleOp module,
@@ -647,6 +673,545 @@ struct RawPointerAPIUnusedUndefRemoval : public OpRewritePattern<LLVM::UndefOp>
     }
 };
 
+// Lowers memref stores tagged as non-temporal to LLVM stores with the nontemporal flag,
+// cf. StoreOpLowering in mlir\lib\Conversion\MemRefToLLVM\MemRefToLLVM.cpp
+struct NonTemporalStoreOpLowering : public ConvertOpToLLVMPattern<memref::StoreOp>
+{
+    using ConvertOpToLLVMPattern<memref::StoreOp>::ConvertOpToLLVMPattern;
+
+    LogicalResult matchAndRewrite(memref::StoreOp op, ArrayRef<Value> operands, ConversionPatternRewriter& rewriter) const override
+    {
+        if (!op->hasAttr(NonTemporalAttrName))
+        {
+            return failure();
+        }
+        memref::StoreOp::Adaptor adaptor(operands);
+        auto memRefType = op.getMemRefType();
+        Value dataPtr = getStridedElementPtr(op.getLoc(), memRefType, adaptor.memref(), adaptor.indices(), rewriter);
+        rewriter.replaceOpWithNewOp<LLVM::StoreOp>(op, adaptor.value(), dataPtr, /*alignment=*/0, /*isVolatile=*/false, /*isNonTemporal=*/true);
+        return success();
+    }
+};
+
+// Lowers vector stores tagged as non-temporal to LLVM vector stores with the nontemporal flag, which become
+// streaming stores such as movntps or stnp, cf. VectorLoadStoreConversion in mlir\lib\Conversion\VectorToLLVM\ConvertVectorToLLVM.cpp
+struct NonTemporalVectorStoreOpLowering : public ConvertOpToLLVMPattern<vector::StoreOp>
+{
+    using ConvertOpToLLVMPattern<vector::StoreOp>::ConvertOpToLLVMPattern;
+
+    LogicalResult matchAndRewrite(vector::StoreOp op, ArrayRef<Value> operands, ConversionPatternRewriter& rewriter) const override
+    {
+        if (!op->hasAttr(NonTemporalAttrName))
+        {
+            return failure();
+        }
+        vector::StoreOp::Adaptor adaptor(operands);
+        auto loc = op.getLoc();
+        auto memRefType = op.getMemRefType();
+        auto vectorType = getTypeConverter()->convertType(op.getVectorType());
+        if (!vectorType)
+        {
+            return failure();
+        }
+        Value dataPtr = getStridedElementPtr(loc, memRefType, adaptor.base(), adaptor.indices(), rewriter);
+        auto vectorPtrType = LLVM::LLVMPointerType::get(vectorType, memRefType.getMemorySpaceAsInt());
+        Value vectorPtr = rewriter.create<LLVM::BitcastOp>(loc, vectorPtrType, dataPtr);
+        unsigned alignment = memRefType.getElementTypeBitWidth() / 8;
+        rewriter.replaceOpWithNewOp<LLVM::StoreOp>(op, adaptor.valueToStore(), vectorPtr, alignment, /*isVolatile=*/false, /*isNonTemporal=*/true);
+        return success();
+    }
+};
+
+// Lowers vector table lookups to the lookup instructions of the target, which hold the table in registers and select
+// the entries of a whole vector of indices at once, and scalar lookups to a load of the entry
+struct TableLookupOpLowering : public ConvertOpToLLVMPattern<TableLookupOp>
+{
+    using ConvertOpToLLVMPattern<TableLookupOp>::ConvertOpToLLVMPattern;
+
+    LogicalResult matchAndRewrite(TableLookupOp op, ArrayRef<Value> operands, ConversionPatternRewriter& rewriter) const override;
+
+private:
+    // Looks up the indices of a vector that the lookup instructions of the op's kind read at once
+    Value LookupVector(TableLookupOp op, Value tablePtr, Value indices, ConversionPatternRewriter& rewriter) const;
+
+    // Looks up each index with a load of its entry
+    Value LookupElements(Location loc, Value tablePtr, Value indices, ConversionPatternRewriter& rewriter) const;
+};
+
+// Implemented by the acc-runtime library, see accera/runtime/include/MappedBuffer.h, HugePages.h and ProfileRegions.h
+const std::string MapPackedBufferFnName = "AcceraMapPackedBuffer";
+const std::string AllocateHugePagesFnName = "AcceraAllocateHugePages";
+const std::string EnterProfileRegionFnName = "AcceraEnterProfileRegion";
+const std::string ExitProfileRegionFnName = "AcceraExitProfileRegion";
+const std::string PrintProfileResultsFnName = "AcceraPrintProfileResults";
+const std::string CountMemoryTrafficFnName = "AcceraCountMemoryTraffic";
+
+int32_t GetProfileCounterMask(Operation* op)
+{
+    auto maskAttr = op->getAttrOfType<IntegerAttr>(ProfileCounterMaskAttrName);
+    return maskAttr ? static_cast<int32_t>(maskAttr.getInt()) : 0;
+}
+
+// Returns the address of the slot in which the runtime keeps the id of the region, which lets it find the region
+// without looking its name up each time
+Value GetProfileRegionHandle(Location loc, OpBuilder& builder, StringRef regionName, ModuleOp module)
+{
+    auto i64Type = builder.getI64Type();
+    auto handleName = ("profile_region_" + regionName + "_handle").str();
+    auto handle = module.lookupSymbol<LLVM::GlobalOp>(handleName);
+    if (!handle)
+    {
+        OpBuilder::InsertionGuard insertGuard(builder);
+        builder.setInsertionPointToStart(module.getBody());
+        handle = builder.create<LLVM::GlobalOp>(loc, i64Type, /*isConstant=*/false, LLVM::Linkage::Internal, handleName, builder.getI64IntegerAttr(0));
+    }
+    return builder.create<LLVM::AddressOfOp>(loc, handle);
+}
+
+// Lowers accv.enter_profile to AcceraEnterProfileRegion(handle, name, timestamp, counterMask, cycleCounter)
+struct EnterProfileRegionOpLowering : public PrintOpLoweringBase<EnterProfileRegionOp>
+{
+    using PrintOpLoweringBase<EnterProfileRegionOp>::PrintOpLoweringBase;
+
+    LogicalResult matchAndRewrite(EnterProfileRegionOp op, ArrayRef<Value> operands, ConversionPatternRewriter& rewriter) const override
+    {
+        auto loc = op.getLoc();
+        auto module = op->getParentOfType<ModuleOp>();
+        auto i32Type = rewriter.getI32Type();
+        auto i8PtrType = LLVM::LLVMPointerType::get(rewriter.getIntegerType(8));
+        auto i64PtrType = LLVM::LLVMPointerType::get(rewriter.getI64Type());
+        auto regionName = op.regionName().str();
+
+        auto enterFn = LLVM::lookupOrCreateFn(module, EnterProfileRegionFnName, { i64PtrType, i8PtrType, rewriter.getF64Type(), i32Type, i32Type }, LLVM::LLVMVoidType::get(rewriter.getContext()));
+        Value handle = GetProfileRegionHandle(loc, rewriter, regionName, module);
+        Value name = getOrCreateGlobalString(loc, rewriter, ("profile_region_" + regionName + "_name").str(), StringRef(regionName.c_str(), regionName.length() + 1), module);
+        Value counterMask = rewriter.create<LLVM::ConstantOp>(loc, i32Type, rewriter.getI32IntegerAttr(GetProfileCounterMask(op)));
+        auto useCycleCounter = op->hasAttr(ProfileCycleCounterAttrName);
+        Value cycleCounter = rewriter.create<LLVM::ConstantOp>(loc, i32Type, rewriter.getI32IntegerAttr(useCycleCounter ? 1 : 0));
+
+        // The timestamp is taken last so that the time spent in the runtime isn't attributed to the region
+        Value timestamp = GetTimeOpLowering::GetTime(rewriter, loc, module, useCycleCounter);
+        rewriter.create<LLVM::CallOp>(loc, enterFn, ValueRange{ handle, name, timestamp, counterMask, cycleCounter });
+        rewriter.eraseOp(op);
+        return success();
+    }
+};
+
+// Lowers accv.exit_profile to AcceraExitProfileRegion(handle, timestamp, counterMask)
+struct ExitProfileRegionOpLowering : public ValueLLVMOpConversionPattern<ExitProfileRegionOp>
+{
+    using ValueLLVMOpConversionPattern::ValueLLVMOpConversionPattern;
+
+    LogicalResult matchAndRewrite(ExitProfileRegionOp op, ArrayRef<Value> operands, ConversionPatternRewriter& rewriter) const override
+    {
+        auto loc = op.getLoc();
+        auto module = op->getParentOfType<ModuleOp>();
+        auto i32Type = rewriter.getI32Type();
+        auto i64PtrType = LLVM::LLVMPointerType::get(rewriter.getI64Type());
+
+        auto exitFn = LLVM::lookupOrCreateFn(module, ExitProfileRegionFnName, { i64PtrType, rewriter.getF64Type(), i32Type }, LLVM::LLVMVoidType::get(rewriter.getContext()));
+        Value timestamp = GetTimeOpLowering::GetTime(rewriter, loc, module, op->hasAttr(ProfileCycleCounterAttrName));
+        Value handle = GetProfileRegionHandle(loc, rewriter, op.regionName(), module);
+        Value counterMask = rewriter.create<LLVM::ConstantOp>(loc, i32Type, rewriter.getI32IntegerAttr(GetProfileCounterMask(op)));
+        rewriter.create<LLVM::CallOp>(loc, exitFn, ValueRange{ handle, timestamp, counterMask });
+        rewriter.eraseOp(op);
+        return success();
+    }
+};
+
+// Lowers accv.print_profile to AcceraPrintProfileResults()
+struct PrintProfileResultsOpLowering : public ValueLLVMOpConversionPattern<PrintProfileResultsOp>
+{
+    using ValueLLVMOpConversionPattern::ValueLLVMOpConversionPattern;
+
+    LogicalResult matchAndRewrite(PrintProfileResultsOp op, ArrayRef<Value> operands, ConversionPatternRewriter& rewriter) const override
+    {
+        auto module = op->getParentOfType<ModuleOp>();
+        auto printFn = LLVM::lookupOrCreateFn(module, PrintProfileResultsFnName, {}, LLVM::LLVMVoidType::get(rewriter.getContext()));
+        rewriter.create<LLVM::CallOp>(op.getLoc(), printFn, ValueRange{});
+        rewriter.eraseOp(op);
+        return success();
+    }
+};
+
+// Lowers accv.count_memory_traffic to AcceraCountMemoryTraffic(handle, arrayName, loadedBytes, storedBytes), where the
+// handle is the slot in which the runtime keeps the id of the array, like the handles of the profile regions
+struct CountMemoryTrafficOpLowering : public PrintOpLoweringBase<CountMemoryTrafficOp>
+{
+    using PrintOpLoweringBase<CountMemoryTrafficOp>::PrintOpLoweringBase;
+
+    LogicalResult matchAndRewrite(CountMemoryTrafficOp op, ArrayRef<Value> operands, ConversionPatternRewriter& rewriter) const override
+    {
+        auto loc = op.getLoc();
+        auto module = op->getParentOfType<ModuleOp>();
+        auto i64Type = rewriter.getI64Type();
+        auto i8PtrType = LLVM::LLVMPointerType::get(rewriter.getIntegerType(8));
+        auto i64PtrType = LLVM::LLVMPointerType::get(i64Type);
+        auto arrayName = op.arrayName().str();
+
+        auto handleName = "memory_traffic_" + arrayName + "_handle";
+        auto handle = module.lookupSymbol<LLVM::GlobalOp>(handleName);
+        if (!handle)
+        {
+            OpBuilder::InsertionGuard insertGuard(rewriter);
+            rewriter.setInsertionPointToStart(module.getBody());
+            handle = rewriter.create<LLVM::GlobalOp>(loc, i64Type, /*isConstant=*/false, LLVM::Linkage::Internal, handleName, rewriter.getI64IntegerAttr(0));
+        }
+
+        auto countFn = LLVM::lookupOrCreateFn(module, CountMemoryTrafficFnName, { i64PtrType, i8PtrType, i64Type, i64Type }, LLVM::LLVMVoidType::get(rewriter.getContext()));
+        Value handleAddress = rewriter.create<LLVM::AddressOfOp>(loc, handle);
+        Value name = getOrCreateGlobalString(loc, rewriter, "memory_traffic_" + arrayName + "_name", StringRef(arrayName.c_str(), arrayName.length() + 1), module);
+        Value loadedBytes = rewriter.create<LLVM::ConstantOp>(loc, i64Type, rewriter.getI64IntegerAttr(op.loadedBytes()));
+        Value storedBytes = rewriter.create<LLVM::ConstantOp>(loc, i64Type, rewriter.getI64IntegerAttr(op.storedBytes()));
+        rewriter.create<LLVM::CallOp>(loc, countFn, ValueRange{ handleAddress, name, loadedBytes, storedBytes });
+        rewriter.eraseOp(op);
+        return success();
+    }
+};
+
+std::string GetRuntimeBufferHandleName(StringRef globalName)
+{
+    return (globalName + "_mapping").str();
+}
+
+std::string GetMappedBufferFileName(StringRef globalName)
+{
+    return (globalName + "_file").str();
+}
+
+// Lowers the get_global ops of buffers that the runtime provides to a call that creates the buffer the first time it
+// runs and returns it from the handle afterwards, see PrepareRuntimeGlobals:
+//   - memory-mapped packed buffers call AcceraMapPackedBuffer(handle, fileName, size)
+//   - huge page buffers call AcceraAllocateHugePages(handle, size)
+struct RuntimeGetGlobalOpLowering : public ConvertOpToLLVMPattern<memref::GetGlobalOp>
+{
+    using ConvertOpToLLVMPattern<memref::GetGlobalOp>::ConvertOpToLLVMPattern;
+
+    LogicalResult matchAndRewrite(memref::GetGlobalOp op, ArrayRef<Value> operands, ConversionPatternRewriter& rewriter) const override
+    {
+        auto isMapped = op->hasAttr(MappedFileAttrName);
+        if (!isMapped && !op->hasAttr(HugePagesAttrName))
+        {
+            return failure();
+        }
+        auto memRefType = op.getType();
+        auto handleGlobal = SymbolTable::lookupNearestSymbolFrom<LLVM::GlobalOp>(op, GetRuntimeBufferHandleName(op.name()));
+        auto fileGlobal = isMapped ? SymbolTable::lookupNearestSymbolFrom<LLVM::GlobalOp>(op, GetMappedBufferFileName(op.name())) : LLVM::GlobalOp{};
+        if (!handleGlobal || (isMapped && !fileGlobal) || !memRefType.hasStaticShape())
+        {
+            return failure();
+        }
+
+        auto loc = op.getLoc();
+        auto i8PtrType = getVoidPtrType();
+        auto i64Type = rewriter.getI64Type();
+        auto module = op->getParentOfType<ModuleOp>();
+
+        Value handle = rewriter.create<LLVM::AddressOfOp>(loc, handleGlobal);
+        Value size = rewriter.create<LLVM::ConstantOp>(loc, i64Type, rewriter.getI64IntegerAttr(memRefType.getSizeInBits() / 8));
+        Value data;
+        if (isMapped)
+        {
+            auto mapFn = LLVM::lookupOrCreateFn(module, MapPackedBufferFnName, { LLVM::LLVMPointerType::get(i8PtrType), i8PtrType, i64Type }, i8PtrType);
+            Value fileArray = rewriter.create<LLVM::AddressOfOp>(loc, fileGlobal);
+            Value zero = rewriter.create<LLVM::ConstantOp>(loc, i64Type, rewriter.getI64IntegerAttr(0));
+            Value fileName = rewriter.create<LLVM::GEPOp>(loc, i8PtrType, fileArray, ValueRange{ zero, zero });
+            data = rewriter.create<LLVM::CallOp>(loc, mapFn, ValueRange{ handle, fileName, size }).getResult(0);
+        }
+        else
+        {
+            auto allocateFn = LLVM::lookupOrCreateFn(module, AllocateHugePagesFnName, { LLVM::LLVMPointerType::get(i8PtrType), i64Type }, i8PtrType);
+            data = rewriter.create<LLVM::CallOp>(loc, allocateFn, ValueRange{ handle, size }).getResult(0);
+        }
+
+        auto elementPtrType = LLVM::LLVMPointerType::get(typeConverter->convertType(memRefType.getElementType()), memRefType.getMemorySpaceAsInt());
+        Value memory = rewriter.create<LLVM::BitcastOp>(loc, elementPtrType, data);
+        auto descriptor = MemRefDescriptor::fromStaticShape(rewriter, loc, *getTypeConverter(), memRefType, memory);
+        rewriter.replaceOp(op, { descriptor });
+        return success();
+    }
+};
+
+// Replaces the globals of buffers that the runtime provides with a null handle for the buffer, so that memory-mapped
+// packed data stays out of the binary and huge page buffers are not placed in the ordinary pages of the binary, and
+// tags their get_global ops for RuntimeGetGlobalOpLowering. Memory-mapped buffers also get the name of their file.
+void PrepareRuntimeGlobals(ModuleOp moduleOp)
+{
+    llvm::SmallVector<memref::GlobalOp, 4> runtimeGlobals;
+    moduleOp.walk([&](memref::GlobalOp globalOp) {
+        if (globalOp->hasAttr(MappedFileAttrName) || globalOp->hasAttr(HugePagesAttrName))
+        {
+            runtimeGlobals.push_back(globalOp);
+        }
+    });
+
+    llvm::StringMap<NamedAttribute> runtimeBufferTags;
+    for (auto globalOp : runtimeGlobals)
+    {
+        auto loc = globalOp.getLoc();
+        auto fileAttr = globalOp->getAttrOfType<StringAttr>(MappedFileAttrName);
+
+        OpBuilder builder(globalOp);
+        runtimeBufferTags.try_emplace(globalOp.sym_name(), fileAttr ? builder.getNamedAttr(MappedFileAttrName, fileAttr) : builder.getNamedAttr(HugePagesAttrName, builder.getUnitAttr()));
+
+        auto i8Type = builder.getIntegerType(8);
+        auto i8PtrType = LLVM::LLVMPointerType::get(i8Type);
+        auto handleGlobal = builder.create<LLVM::GlobalOp>(loc, i8PtrType, /*isConstant=*/false, LLVM::Linkage::Internal, GetRuntimeBufferHandleName(globalOp.sym_name()), Attribute{});
+        {
+            OpBuilder::InsertionGuard guard(builder);
+            builder.createBlock(&handleGlobal.getInitializerRegion());
+            Value null = builder.create<LLVM::NullOp>(loc, i8PtrType);
+            builder.create<LLVM::ReturnOp>(loc, null);
+        }
+
+        if (fileAttr)
+        {
+            auto fileName = fileAttr.getValue().str();
+            fileName.push_back('\0');
+            builder.create<LLVM::GlobalOp>(loc, LLVM::LLVMArrayType::get(i8Type, fileName.size()), /*isConstant=*/true, LLVM::Linkage::Internal, GetMappedBufferFileName(globalOp.sym_name()), builder.getStringAttr(fileName));
+        }
+    }
+
+    moduleOp.walk([&](memref::GetGlobalOp getGlobalOp) {
+        if (auto it = runtimeBufferTags.find(getGlobalOp.name()); it != runtimeBufferTags.end())
+        {
+            getGlobalOp->setAttr(it->second.first, it->second.second);
+        }
+    });
+
+    for (auto globalOp : runtimeGlobals)
+    {
+        globalOp.erase();
+    }
+}
+
+// Non-temporal stores are weakly ordered with respect to other stores, so they are fenced before returning
+// from a function or leaving a parallel region, after which other code may read the data they wrote
+void FenceNonTemporalStores(ModuleOp moduleOp)
+{
+    std::vector<Operation*> exits;
+    moduleOp.walk([&](Operation* op) {
+        if (!isa<LLVM::ReturnOp, omp::TerminatorOp>(op))
+        {
+            return;
+        }
+        auto hasNonTemporalStore = op->getParentOp()->walk([](LLVM::StoreOp storeOp) {
+                                                         return storeOp.nontemporal() ? WalkResult::interrupt() : WalkResult::advance();
+                                                     })
+                                       .wasInterrupted();
+        if (hasNonTemporalStore)
+        {
+            exits.push_back(op);
+        }
+    });
+
+    for (auto exit : exits)
+    {
+        OpBuilder builder(exit);
+        builder.create<LLVM::FenceOp>(exit->getLoc(), LLVM::AtomicOrdering::seq_cst, "");
+    }
+}
+
+// Accera has already unrolled and vectorized the loops that are left as it was asked to, so LLVM is told not to
+// unroll or interleave them again. A loop is found by a branch back to a block that dominates the branch
+void AddLoopMetadata(LLVM::LLVMFuncOp funcOp)
+{
+    if (funcOp.isExternal())
+    {
+        return;
+    }
+
+    auto context = funcOp.getContext();
+    LLVM::LoopOptionsAttrBuilder options;
+    options.setDisableUnroll(true).setInterleaveCount(1);
+    auto loopAttr = DictionaryAttr::get(context, { NamedAttribute(Identifier::get(LLVM::LLVMDialect::getLoopOptionsAttrName(), context), LLVM::LoopOptionsAttr::get(context, options)) });
+
+    DominanceInfo dominance(funcOp);
+    funcOp.walk([&](Operation* op) {
+        if (!isa<LLVM::BrOp, LLVM::CondBrOp>(op) || op->hasAttr(LLVM::LLVMDialect::getLoopAttrName()))
+        {
+            return;
+        }
+        auto isBackEdge = llvm::any_of(op->getSuccessors(), [&](Block* successor) {
+            return dominance.dominates(successor, op->getBlock());
+        });
+        if (isBackEdge)
+        {
+            op->setAttr(LLVM::LLVMDialect::getLoopAttrName(), loopAttr);
+        }
+    });
+}
+
+// Follows a pointer back through address arithmetic and memref descriptors to the function argument or global
+// that it points into, returning a null value if it comes from anywhere else
+Value GetPointerRoot(Value pointer)
+{
+    auto value = pointer;
+    while (true)
+    {
+        if (auto arg = value.dyn_cast<BlockArgument>())
+        {
+            auto owner = arg.getOwner();
+            return owner->isEntryBlock() && isa<LLVM::LLVMFuncOp>(owner->getParentOp()) ? value : Value{};
+        }
+
+        auto op = value.getDefiningOp();
+        if (isa<LLVM::AddressOfOp>(op))
+        {
+            return value;
+        }
+        if (isa<LLVM::GEPOp, LLVM::BitcastOp, LLVM::AddrSpaceCastOp>(op))
+        {
+            value = op->getOperand(0);
+            continue;
+        }
+        if (auto extractOp = dyn_cast<LLVM::ExtractValueOp>(op))
+        {
+            // The fields of a memref descriptor are inserted one at a time, so the chain is searched for the field
+            auto container = extractOp.container();
+            auto insertOp = container.getDefiningOp<LLVM::InsertValueOp>();
+            while (insertOp && insertOp.position() != extractOp.position())
+            {
+                insertOp = insertOp.container().getDefiningOp<LLVM::InsertValueOp>();
+            }
+            if (!insertOp)
+            {
+                return {};
+            }
+            value = insertOp.value();
+            continue;
+        }
+        return {};
+    }
+}
+
+// Tells LLVM which of the arrays accessed by a function can't overlap, with an alias scope for each argument or
+// global that loads and stores go through. Different globals never overlap, the arguments of a function marked
+// as not aliasing don't overlap each other, and the internal globals that hold caches and temporary arrays can't
+// be passed to a function that is only called from outside the module
+void AddAliasScopes(ModuleOp moduleOp)
+{
+    auto context = moduleOp.getContext();
+    OpBuilder builder(context);
+    LLVM::MetadataOp metadataOp;
+    auto metadataName = "accera_alias_scopes";
+
+    auto calledFunctions = llvm::StringSet<>{};
+    moduleOp.walk([&](LLVM::CallOp callOp) {
+        if (auto callee = callOp.callee())
+        {
+            calledFunctions.insert(*callee);
+        }
+    });
+
+    for (auto funcOp : moduleOp.getOps<LLVM::LLVMFuncOp>())
+    {
+        if (funcOp.isExternal())
+        {
+            continue;
+        }
+
+        std::vector<std::pair<Operation*, Value>> accesses;
+        std::vector<Value> roots;
+        funcOp.walk([&](Operation* op) {
+            Value address;
+            if (auto loadOp = dyn_cast<LLVM::LoadOp>(op))
+                address = loadOp.addr();
+            else if (auto storeOp = dyn_cast<LLVM::StoreOp>(op))
+                address = storeOp.addr();
+            else
+                return;
+
+            if (auto root = GetPointerRoot(address))
+            {
+                accesses.emplace_back(op, root);
+                if (llvm::find(roots, root) == roots.end())
+                {
+                    roots.push_back(root);
+                }
+            }
+        });
+
+        auto isInternalGlobal = [&](Value root) {
+            auto addressOfOp = root.getDefiningOp<LLVM::AddressOfOp>();
+            if (!addressOfOp)
+            {
+                return false;
+            }
+            auto globalOp = moduleOp.lookupSymbol<LLVM::GlobalOp>(addressOfOp.global_name());
+            return globalOp && (globalOp.linkage() == LLVM::Linkage::Internal || globalOp.linkage() == LLVM::Linkage::Private);
+        };
+        auto argumentsDontAlias = funcOp->hasAttr(ir::NoAliasAttrName);
+        auto calledFromOutsideOnly = !calledFunctions.contains(funcOp.getName());
+        auto isDistinct = [&](Value lhs, Value rhs) {
+            auto lhsAddressOf = lhs.getDefiningOp<LLVM::AddressOfOp>();
+            auto rhsAddressOf = rhs.getDefiningOp<LLVM::AddressOfOp>();
+            if (lhsAddressOf && rhsAddressOf)
+            {
+                return lhsAddressOf.global_name() != rhsAddressOf.global_name();
+            }
+            if (!lhsAddressOf && !rhsAddressOf)
+            {
+                return argumentsDontAlias && lhs != rhs;
+            }
+            return calledFromOutsideOnly && (isInternalGlobal(lhs) || isInternalGlobal(rhs));
+        };
+
+        std::vector<std::vector<size_t>> distinctRoots(roots.size());
+        auto hasDistinctRoots = false;
+        for (size_t i = 0; i < roots.size(); ++i)
+        {
+            for (size_t j = 0; j < roots.size(); ++j)
+            {
+                if (i != j && isDistinct(roots[i], roots[j]))
+                {
+                    distinctRoots[i].push_back(j);
+                    hasDistinctRoots = true;
+                }
+            }
+        }
+        if (!hasDistinctRoots)
+        {
+            continue;
+        }
+
+        if (!metadataOp)
+        {
+            builder.setInsertionPointToEnd(moduleOp.getBody());
+            metadataOp = builder.create<LLVM::MetadataOp>(moduleOp.getLoc(), metadataName);
+            builder.createBlock(&metadataOp.body());
+            builder.create<LLVM::ReturnOp>(moduleOp.getLoc(), ValueRange{});
+        }
+        builder.setInsertionPoint(metadataOp.getBody()->getTerminator());
+
+        auto domainName = (funcOp.getName() + "_alias_domain").str();
+        builder.create<LLVM::AliasScopeDomainMetadataOp>(funcOp.getLoc(), domainName, StringAttr{});
+        std::vector<Attribute> scopes;
+        for (size_t i = 0; i < roots.size(); ++i)
+        {
+            auto scopeName = (funcOp.getName() + "_alias_scope_" + std::to_string(i)).str();
+            builder.create<LLVM::AliasScopeMetadataOp>(funcOp.getLoc(), scopeName, domainName, StringAttr{});
+            scopes.push_back(SymbolRefAttr::get(context, metadataName, { FlatSymbolRefAttr::get(context, scopeName) }));
+        }
+
+        for (auto& [op, root] : accesses)
+        {
+            auto index = std::distance(roots.begin(), llvm::find(roots, root));
+            if (distinctRoots[index].empty())
+            {
+                continue;
+            }
+            std::vector<Attribute> noAliasScopes;
+            for (auto other : distinctRoots[index])
+            {
+                noAliasScopes.push_back(scopes[other]);
+            }
+            op->setAttr("alias_scopes", builder.getArrayAttr({ scopes[index] }));
+            op->setAttr("noalias_scopes", builder.getArrayAttr(noAliasScopes));
+        }
+    }
+}
+
 } // namespace
 
 using namespace accera::transforms::value;
@@ -882,11 +1447,20 @@ LogicalResult BitcastOpLowering::matchAndRewrite(
     return success();
 }
 
-mlir::Value GetTimeOpLowering::GetTime(ConversionPatternRewriter& rewriter, mlir::Location loc, ModuleOp& parentModule) const
+mlir::Value GetTimeOpLowering::GetTime(ConversionPatternRewriter& rewriter, mlir::Location loc, ModuleOp& parentModule, bool cycleCounter)
 {
     auto* llvmDialect = rewriter.getContext()->getOrLoadDialect<LLVM::LLVMDialect>();
     assert(llvmDialect && "expected llvm dialect to be registered");
 
+    if (cycleCounter)
+    {
+        // The cycle counter, e.g. rdtsc on x86, takes a few cycles to read instead of the call into the OS
+        auto i64Type = rewriter.getI64Type();
+        auto readCycleCounterFn = getOrInsertLibraryFunction(rewriter, "llvm.readcyclecounter", LLVM::LLVMFunctionType::get(i64Type, {}), parentModule, llvmDialect);
+        auto cycles = rewriter.create<LLVM::CallOp>(loc, std::vector<Type>{ i64Type }, readCycleCounterFn, ValueRange{}).getResult(0);
+        return rewriter.create<LLVM::UIToFPOp>(loc, rewriter.getF64Type(), cycles);
+    }
+
     // call the platform-specific time function and convert to seconds
     // TODO: encode the target platform in the module or platform somehow, so we can query it instead
     // of having the runtime environment being based on the compile-time environment
@@ -957,11 +1531,356 @@ LogicalResult GetTimeOpLowering::matchAndRewrite(
     ConversionPatternRewriter& rewriter) const
 {
     ModuleOp parentModule = op->getParentOfType<ModuleOp>();
-    auto currentTime = GetTime(rewriter, op.getLoc(), parentModule);
+    auto currentTime = GetTime(rewriter, op.getLoc(), parentModule, op.cycleCounter());
     rewriter.replaceOp(op, { currentTime });
     return success();
 }
 
+LogicalResult VectorDotProductOpLowering::matchAndRewrite(
+    VectorDotProductOp op,
+    ArrayRef<mlir::Value> operands,
+    ConversionPatternRewriter& rewriter) const
+{
+    using accera::ir::executionPlan::IntegerDotProductKind;
+
+    VectorDotProductOp::Adaptor adaptor(operands, op->getAttrDictionary());
+    auto loc = op.getLoc();
+    auto accType = op.acc().getType().cast<VectorType>();
+    auto operandType = op.lhs().getType().cast<VectorType>();
+    auto groupSize = 32 / operandType.getElementTypeBitWidth();
+    if (operandType.getNumElements() != groupSize * accType.getNumElements())
+    {
+        return op.emitError("expected ") << groupSize << " times as many operand elements as accumulator elements";
+    }
+
+    auto parentModule = op->getParentOfType<ModuleOp>();
+    if (static_cast<IntegerDotProductKind>(op.kind()) == IntegerDotProductKind::ARMDSP)
+    {
+        if (operandType.getElementTypeBitWidth() == 16 && (op.lhs_unsigned() || op.rhs_unsigned()))
+        {
+            return op.emitError("smlad multiplies signed 16-bit integers");
+        }
+
+        // The DSP instructions work on the 32-bit general purpose registers, each of which holds a group
+        auto i32Type = rewriter.getI32Type();
+        auto wordsType = VectorType::get({ accType.getNumElements() }, i32Type);
+        auto smlad = LLVM::lookupOrCreateFn(parentModule, "llvm.arm.smlad", { i32Type, i32Type, i32Type }, i32Type);
+        auto sxtb16 = LLVM::lookupOrCreateFn(parentModule, "llvm.arm.sxtb16", { i32Type }, i32Type);
+        auto uxtb16 = LLVM::lookupOrCreateFn(parentModule, "llvm.arm.uxtb16", { i32Type }, i32Type);
+        auto call = [&](LLVM::LLVMFuncOp fn, ValueRange args) {
+            return rewriter.create<LLVM::CallOp>(loc, fn, args).getResult(0);
+        };
+
+        Value lhsWords = rewriter.create<LLVM::BitcastOp>(loc, wordsType, adaptor.lhs());
+        Value rhsWords = rewriter.create<LLVM::BitcastOp>(loc, wordsType, adaptor.rhs());
+        Value result = adaptor.acc();
+        Value eight = rewriter.create<LLVM::ConstantOp>(loc, i32Type, rewriter.getI32IntegerAttr(8));
+        for (int64_t i = 0; i < accType.getNumElements(); ++i)
+        {
+            Value position = rewriter.create<LLVM::ConstantOp>(loc, i32Type, rewriter.getI32IntegerAttr(i));
+            Value lhs = rewriter.create<LLVM::ExtractElementOp>(loc, i32Type, lhsWords, position);
+            Value rhs = rewriter.create<LLVM::ExtractElementOp>(loc, i32Type, rhsWords, position);
+            Value acc = rewriter.create<LLVM::ExtractElementOp>(loc, i32Type, result, position);
+            if (operandType.getElementTypeBitWidth() == 16)
+            {
+                acc = call(smlad, { lhs, rhs, acc });
+            }
+            else
+            {
+                // sxtb16 and uxtb16 extend bytes 0 and 2 into a pair of 16-bit integers, and bytes 1 and 3 once
+                // they are shifted down by a byte
+                auto extend = [&](Value word, bool isUnsigned) {
+                    return call(isUnsigned ? uxtb16 : sxtb16, { word });
+                };
+                auto lhsOdd = rewriter.create<LLVM::LShrOp>(loc, i32Type, lhs, eight);
+                auto rhsOdd = rewriter.create<LLVM::LShrOp>(loc, i32Type, rhs, eight);
+                acc = call(smlad, { extend(lhs, op.lhs_unsigned()), extend(rhs, op.rhs_unsigned()), acc });
+                acc = call(smlad, { extend(lhsOdd, op.lhs_unsigned()), extend(rhsOdd, op.rhs_unsigned()), acc });
+            }
+            result = rewriter.create<LLVM::InsertElementOp>(loc, result.getType(), result, acc, position);
+        }
+        rewriter.replaceOp(op, result);
+        return success();
+    }
+
+    if (operandType.getElementTypeBitWidth() != 8)
+    {
+        return op.emitError("vpdpbusd, sdot and udot multiply 8-bit integers");
+    }
+
+    Value lhs = adaptor.lhs();
+    Value rhs = adaptor.rhs();
+    std::string intrinsicName;
+    switch (static_cast<IntegerDotProductKind>(op.kind()))
+    {
+    case IntegerDotProductKind::X86VNNI:
+        if (op.lhs_unsigned() == op.rhs_unsigned())
+        {
+            return op.emitError("vpdpbusd multiplies unsigned by signed integers");
+        }
+        // vpdpbusd takes the unsigned bytes first, and both operands packed into 32-bit integers
+        if (!op.lhs_unsigned())
+        {
+            std::swap(lhs, rhs);
+        }
+        lhs = rewriter.create<LLVM::BitcastOp>(loc, accType, lhs);
+        rhs = rewriter.create<LLVM::BitcastOp>(loc, accType, rhs);
+        intrinsicName = "llvm.x86.avx512.vpdpbusd." + std::to_string(operandType.getNumElements() * 8);
+        break;
+    case IntegerDotProductKind::ARMDotProduct:
+        if (op.lhs_unsigned() != op.rhs_unsigned())
+        {
+            return op.emitError("sdot and udot multiply integers of the same signedness");
+        }
+        intrinsicName = std::string("llvm.aarch64.neon.") + (op.lhs_unsigned() ? "udot" : "sdot") + ".v" + std::to_string(accType.getNumElements()) + "i32.v" + std::to_string(operandType.getNumElements()) + "i8";
+        break;
+    default:
+        return op.emitError("unknown integer dot-product instructions");
+    }
+
+    // Functions named after LLVM intrinsics are translated to the intrinsics themselves
+    auto intrinsic = LLVM::lookupOrCreateFn(parentModule, intrinsicName, { accType, lhs.getType(), rhs.getType() }, accType);
+    rewriter.replaceOpWithNewOp<LLVM::CallOp>(op, intrinsic, ValueRange{ adaptor.acc(), lhs, rhs });
+    return success();
+}
+
+LogicalResult VectorBFloat16DotProductOpLowering::matchAndRewrite(
+    VectorBFloat16DotProductOp op,
+    ArrayRef<mlir::Value> operands,
+    ConversionPatternRewriter& rewriter) const
+{
+    VectorBFloat16DotProductOp::Adaptor adaptor(operands, op->getAttrDictionary());
+    auto loc = op.getLoc();
+    auto accType = op.acc().getType().cast<VectorType>();
+    auto operandType = op.lhs().getType().cast<VectorType>();
+    if (operandType.getNumElements() != 2 * accType.getNumElements())
+    {
+        return op.emitError("expected twice as many operand elements as accumulator elements");
+    }
+
+    // vdpbf16ps takes the pairs of bfloat16 values packed into 32-bit integers
+    auto packedType = VectorType::get({ accType.getNumElements() }, rewriter.getI32Type());
+    Value lhs = rewriter.create<LLVM::BitcastOp>(loc, packedType, adaptor.lhs());
+    Value rhs = rewriter.create<LLVM::BitcastOp>(loc, packedType, adaptor.rhs());
+    auto intrinsicName = "llvm.x86.avx512bf16.dpbf16ps." + std::to_string(accType.getNumElements() * 32);
+
+    auto parentModule = op->getParentOfType<ModuleOp>();
+    auto intrinsic = LLVM::lookupOrCreateFn(parentModule, intrinsicName, { accType, packedType, packedType }, accType);
+    rewriter.replaceOpWithNewOp<LLVM::CallOp>(op, intrinsic, ValueRange{ adaptor.acc(), lhs, rhs });
+    return success();
+}
+
+namespace
+{
+Value CreateByteSplat(ConversionPatternRewriter& rewriter, Location loc, VectorType vectorType, int64_t value)
+{
+    auto attr = rewriter.getIntegerAttr(vectorType.getElementType(), value);
+    return rewriter.create<LLVM::ConstantOp>(loc, vectorType, DenseElementsAttr::get(vectorType, llvm::makeArrayRef<Attribute>(attr)));
+}
+
+// Loads `count` consecutive entries of the table, starting at `first`
+Value LoadTableEntries(ConversionPatternRewriter& rewriter, Location loc, Value tablePtr, int64_t first, int64_t count)
+{
+    auto ptrType = tablePtr.getType().cast<LLVM::LLVMPointerType>();
+    auto vectorType = VectorType::get({ count }, ptrType.getElementType());
+    Value offset = rewriter.create<LLVM::ConstantOp>(loc, rewriter.getI64Type(), rewriter.getI64IntegerAttr(first));
+    Value entriesPtr = rewriter.create<LLVM::GEPOp>(loc, ptrType, tablePtr, ValueRange{ offset });
+    entriesPtr = rewriter.create<LLVM::BitcastOp>(loc, LLVM::LLVMPointerType::get(vectorType, ptrType.getAddressSpace()), entriesPtr);
+    return rewriter.create<LLVM::LoadOp>(loc, entriesPtr, /*alignment=*/1);
+}
+
+Value CallIntrinsic(ConversionPatternRewriter& rewriter, Location loc, Operation* op, StringRef name, ValueRange args, Type resultType)
+{
+    // Functions named after LLVM intrinsics are translated to the intrinsics themselves
+    auto parentModule = op->getParentOfType<ModuleOp>();
+    auto argTypes = llvm::to_vector<6>(args.getTypes());
+    auto intrinsic = LLVM::lookupOrCreateFn(parentModule, name, argTypes, resultType);
+    return rewriter.create<LLVM::CallOp>(loc, intrinsic, args).getResult(0);
+}
+
+// Returns the number of indices that each lookup of the kind reads, for the widest lookup that splits the vector
+// into a power of 2 number of parts
+std::optional<int64_t> GetTableLookupWidth(accera::ir::executionPlan::TableLookupKind kind, int64_t vectorSize)
+{
+    using accera::ir::executionPlan::TableLookupKind;
+    std::vector<int64_t> widths;
+    switch (kind)
+    {
+    case TableLookupKind::X86VBMI:
+        widths = { 64, 32, 16 };
+        break;
+    case TableLookupKind::X86Shuffle:
+        widths = { 32, 16 };
+        break;
+    case TableLookupKind::ARMTable:
+        widths = { 16, 8 };
+        break;
+    default:
+        break;
+    }
+
+    for (auto width : widths)
+    {
+        if (vectorSize % width == 0 && llvm::isPowerOf2_64(vectorSize / width))
+        {
+            return width;
+        }
+    }
+    return std::nullopt;
+}
+} // namespace
+
+LogicalResult TableLookupOpLowering::matchAndRewrite(TableLookupOp op, ArrayRef<Value> operands, ConversionPatternRewriter& rewriter) const
+{
+    using accera::ir::executionPlan::TableLookupKind;
+
+    TableLookupOp::Adaptor adaptor(operands, op->getAttrDictionary());
+    auto loc = op.getLoc();
+    auto tableType = op.table().getType().cast<MemRefType>();
+    Value zero = createIndexConstant(rewriter, loc, 0);
+    Value tablePtr = getStridedElementPtr(loc, tableType, adaptor.table(), { zero }, rewriter);
+
+    auto indexType = op.index().getType().dyn_cast<VectorType>();
+    if (!indexType)
+    {
+        Value index = rewriter.create<LLVM::ZExtOp>(loc, getIndexType(), adaptor.index());
+        Value entryPtr = getStridedElementPtr(loc, tableType, adaptor.table(), { index }, rewriter);
+        rewriter.replaceOpWithNewOp<LLVM::LoadOp>(op, entryPtr);
+        return success();
+    }
+
+    auto kind = static_cast<TableLookupKind>(op.kind());
+    auto vectorSize = indexType.getNumElements();
+    auto width = GetTableLookupWidth(kind, vectorSize);
+    if (!width)
+    {
+        rewriter.replaceOp(op, LookupElements(loc, tablePtr, adaptor.index(), rewriter));
+        return success();
+    }
+
+    // Wider vectors are looked up in parts, whose results are concatenated back
+    std::vector<Value> parts;
+    for (int64_t first = 0; first < vectorSize; first += *width)
+    {
+        Value indices = adaptor.index();
+        if (*width != vectorSize)
+        {
+            auto positions = llvm::to_vector<64>(llvm::seq<int32_t>(first, first + *width));
+            indices = rewriter.create<LLVM::ShuffleVectorOp>(loc, indices, indices, rewriter.getI32ArrayAttr(positions));
+        }
+        parts.push_back(LookupVector(op, tablePtr, indices, rewriter));
+    }
+    while (parts.size() > 1)
+    {
+        std::vector<Value> concatenated;
+        for (size_t i = 0; i < parts.size(); i += 2)
+        {
+            auto partSize = parts[i].getType().cast<VectorType>().getNumElements();
+            auto positions = llvm::to_vector<64>(llvm::seq<int32_t>(0, 2 * partSize));
+            concatenated.push_back(rewriter.create<LLVM::ShuffleVectorOp>(loc, parts[i], parts[i + 1], rewriter.getI32ArrayAttr(positions)));
+        }
+        parts = std::move(concatenated);
+    }
+    rewriter.replaceOp(op, parts.front());
+    return success();
+}
+
+Value TableLookupOpLowering::LookupVector(TableLookupOp op, Value tablePtr, Value indices, ConversionPatternRewriter& rewriter) const
+{
+    using accera::ir::executionPlan::TableLookupKind;
+
+    auto loc = op.getLoc();
+    auto vectorType = indices.getType().cast<VectorType>();
+    auto width = vectorType.getNumElements();
+    auto bits = std::to_string(width * 8);
+
+    // Each lookup selects from a group of entries with the low bits of the indices, and the high bits of the indices
+    // select the group
+    auto selectGroups = [&](int64_t groupSize, Value groupIndices, auto&& lookupGroup) {
+        Value result = lookupGroup(0, groupIndices);
+        Value groups = rewriter.create<LLVM::LShrOp>(loc, vectorType, indices, CreateByteSplat(rewriter, loc, vectorType, llvm::Log2_64(groupSize)));
+        for (int64_t group = 1; group < 256 / groupSize; ++group)
+        {
+            Value isInGroup = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, groups, CreateByteSplat(rewriter, loc, vectorType, group));
+            result = rewriter.create<LLVM::SelectOp>(loc, vectorType, isInGroup, lookupGroup(group, groupIndices), result);
+        }
+        return result;
+    };
+
+    switch (static_cast<TableLookupKind>(op.kind()))
+    {
+    case TableLookupKind::X86VBMI:
+        // vpermi2b selects from the 2 registers of entries with the low bits of the indices
+        return selectGroups(2 * width, indices, [&](int64_t group, Value groupIndices) -> Value {
+            auto first = LoadTableEntries(rewriter, loc, tablePtr, group * 2 * width, width);
+            auto second = LoadTableEntries(rewriter, loc, tablePtr, group * 2 * width + width, width);
+            return CallIntrinsic(rewriter, loc, op, "llvm.x86.avx512.vpermi2var.qi." + bits, ValueRange{ first, groupIndices, second }, vectorType);
+        });
+
+    case TableLookupKind::X86Shuffle: {
+        // vpshufb selects from the 16 entries of each 128-bit lane with the low 4 bits of the indices, so the entries
+        // are repeated in every lane. The indices are masked, since vpshufb zeroes the lanes whose index has bit 7 set
+        auto intrinsicName = width == 16 ? "llvm.x86.ssse3.pshuf.b.128" : "llvm.x86.avx2.pshuf.b";
+        Value lowIndices = rewriter.create<LLVM::AndOp>(loc, vectorType, indices, CreateByteSplat(rewriter, loc, vectorType, 15));
+        return selectGroups(16, lowIndices, [&](int64_t group, Value groupIndices) -> Value {
+            Value entries = LoadTableEntries(rewriter, loc, tablePtr, group * 16, 16);
+            if (width != 16)
+            {
+                llvm::SmallVector<int32_t, 32> positions;
+                for (int64_t i = 0; i < width; ++i)
+                {
+                    positions.push_back(static_cast<int32_t>(i % 16));
+                }
+                entries = rewriter.create<LLVM::ShuffleVectorOp>(loc, entries, entries, rewriter.getI32ArrayAttr(positions));
+            }
+            return CallIntrinsic(rewriter, loc, op, intrinsicName, ValueRange{ entries, groupIndices }, vectorType);
+        });
+    }
+
+    case TableLookupKind::ARMTable: {
+        // tbl selects from 4 registers of 16 entries, and returns 0 for the indices past the 64th entry. Each tbx
+        // selects from the next 64 entries, with the indices offset to them, and keeps the lanes whose offset index
+        // is past them
+        auto suffix = ".v" + std::to_string(width) + "i8";
+        Value result;
+        for (int64_t group = 0; group < 4; ++group)
+        {
+            llvm::SmallVector<Value, 6> args;
+            if (group > 0)
+            {
+                args.push_back(result);
+            }
+            for (int64_t i = 0; i < 4; ++i)
+            {
+                args.push_back(LoadTableEntries(rewriter, loc, tablePtr, group * 64 + i * 16, 16));
+            }
+            args.push_back(group == 0 ? indices : rewriter.create<LLVM::SubOp>(loc, vectorType, indices, CreateByteSplat(rewriter, loc, vectorType, group * 64)).getResult());
+            result = CallIntrinsic(rewriter, loc, op, std::string("llvm.aarch64.neon.") + (group == 0 ? "tbl4" : "tbx4") + suffix, args, vectorType);
+        }
+        return result;
+    }
+
+    default:
+        return LookupElements(loc, tablePtr, indices, rewriter);
+    }
+}
+
+Value TableLookupOpLowering::LookupElements(Location loc, Value tablePtr, Value indices, ConversionPatternRewriter& rewriter) const
+{
+    auto vectorType = indices.getType().cast<VectorType>();
+    Value result = rewriter.create<LLVM::UndefOp>(loc, vectorType);
+    for (int64_t i = 0; i < vectorType.getNumElements(); ++i)
+    {
+        Value position = rewriter.create<LLVM::ConstantOp>(loc, rewriter.getI32Type(), rewriter.getI32IntegerAttr(static_cast<int32_t>(i)));
+        Value index = rewriter.create<LLVM::ExtractElementOp>(loc, vectorType.getElementType(), indices, position);
+        index = rewriter.create<LLVM::ZExtOp>(loc, getIndexType(), index);
+        Value entryPtr = rewriter.create<LLVM::GEPOp>(loc, tablePtr.getType(), tablePtr, ValueRange{ index });
+        Value entry = rewriter.create<LLVM::LoadOp>(loc, entryPtr);
+        result = rewriter.create<LLVM::InsertElementOp>(loc, vectorType, result, entry, position);
+    }
+    return result;
+}
+
 void ValueToLLVMLoweringPass::runOnModule()
 {
     llvm::DebugFlag =
@@ -978,6 +1897,8 @@ void ValueToLLVMLoweringPass::runOnModule()
     auto snapshotter = _intrapassSnapshotter.MakeSnapshotPipe();
     snapshotter.Snapshot("Initial", moduleOp);
 
+    PrepareRuntimeGlobals(moduleOp);
+
     target.addLegalOp<ModuleOp>();
 
     // Set pass parameter values with command line options inherited from ConvertValueToLLVMBase
@@ -1034,6 +1955,7 @@ void ValueToLLVMLoweringPass::runOnModule()
         populateVectorToLLVMConversionPatterns(llvmTypeConverter, patterns, /*reassociateFPReductions*/ true);
         vector::populateVectorContractLoweringPatterns(patterns, vector::VectorTransformsOptions{}.setVectorTransferSplit(mlir::vector::VectorTransferSplit::VectorTransfer));
         vector::populateVectorMaskMaterializationPatterns(patterns, true);
+        patterns.insert<NonTemporalVectorStoreOpLowering>(llvmTypeConverter, 100);
 
         if (failed(applyPartialConversion(moduleOp, target, std::move(patterns))))
         {
@@ -1050,10 +1972,13 @@ void ValueToLLVMLoweringPass::runOnModule()
         populateMathToLLVMConversionPatterns(llvmTypeConverter, patterns);
         populateMemRefToLLVMConversionPatterns(llvmTypeConverter, patterns);
         populateStdToLLVMConversionPatterns(llvmTypeConverter, patterns);
+        patterns.insert<NonTemporalStoreOpLowering>(llvmTypeConverter, 100);
+        patterns.insert<RuntimeGetGlobalOpLowering>(llvmTypeConverter, 100);
 
         populateVectorToLLVMConversionPatterns(llvmTypeConverter, patterns, /*reassociateFPReductions*/ true);
         vector::populateVectorContractLoweringPatterns(patterns, vector::VectorTransformsOptions{}.setVectorTransferSplit(mlir::vector::VectorTransferSplit::VectorTransfer));
         vector::populateVectorMaskMaterializationPatterns(patterns, true);
+        patterns.insert<NonTemporalVectorStoreOpLowering>(llvmTypeConverter, 100);
 
         // cf. mlir\lib\Conversion\OpenMPToLLVM\OpenMPToLLVM.cpp
         target.addDynamicallyLegalOp<mlir::omp::ParallelOp, mlir::omp::WsLoopOp>(
@@ -1062,6 +1987,10 @@ void ValueToLLVMLoweringPass::runOnModule()
 
         populateOpenMPToLLVMConversionPatterns(llvmTypeConverter, patterns);
 
+        // The AMX tile ops take memrefs, so they are lowered with the memory ops
+        configureAMXLegalizeForExportTarget(target);
+        populateAMXLegalizeForLLVMExportPatterns(llvmTypeConverter, patterns);
+
         toLLVMPatterns = std::move(patterns);
         if (failed(applyPartialConversion(moduleOp, target, toLLVMPatterns)))
         {
@@ -1069,6 +1998,20 @@ void ValueToLLVMLoweringPass::runOnModule()
         }
     }
 
+    FenceNonTemporalStores(moduleOp);
+
+    if (emitLoopMetadata)
+    {
+        for (auto funcOp : moduleOp.getOps<LLVM::LLVMFuncOp>())
+        {
+            AddLoopMetadata(funcOp);
+        }
+    }
+    if (emitAliasScopes)
+    {
+        AddAliasScopes(moduleOp);
+    }
+
     snapshotter.Snapshot("ToLLVM_Mem", moduleOp);
 
     {
@@ -1108,7 +2051,14 @@ void populateLocalValueToLLVMPatterns(mlir::LLVMTypeConverter& typeConverter, ml
         BitcastOpLowering,
         CallOpLowering,
         PrintFOpLowering,
-        GetTimeOpLowering>(typeConverter, context);
+        VectorDotProductOpLowering,
+        VectorBFloat16DotProductOpLowering,
+        GetTimeOpLowering,
+        EnterProfileRegionOpLowering,
+        ExitProfileRegionOpLowering,
+        PrintProfileResultsOpLowering,
+        CountMemoryTrafficOpLowering>(typeConverter, context);
+    patterns.insert<TableLookupOpLowering>(typeConverter);
 }
 
 void populateValueToLLVMPatterns(mlir::LLVMTypeConverter& typeConverter, mlir::OwningRewritePatternList& patterns)
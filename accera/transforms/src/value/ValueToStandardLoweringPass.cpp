@@ -10,6 +10,7 @@
 
 #include <ir/include/IRUtil.h>
 #include <ir/include/exec/ExecutionPlanAttributes.h>
+#include <ir/include/exec/ExecutionPlanOps.h>
 #include <ir/include/exec/VectorizationInfo.h>
 #include <ir/include/value/ValueDialect.h>
 
@@ -36,8 +37,11 @@
 #include <mlir/Transforms/Passes.h>
 
 #include <llvm/Support/FormatVariadic.h>
+#include <llvm/Support/MathExtras.h>
 
 #include <algorithm>
+#include <iterator>
+#include <numeric>
 #include <unordered_set>
 
 #ifndef RC_FILE_LOC
@@ -76,92 +80,28 @@ namespace
 constexpr auto kDefaultExecutionTarget = vir::ExecutionTarget::CPU;
 const char kGlobalOpSymNameFormat[] = "allocated_memref_{0}";
 
-const char kProfileRegionSymNameFormat[] = "profile_region_{0}_{1}";
-const char kProfileRegionNameIdentifier[] = "profile_region_name";
-const char kProfileRegionTypeIdentifier[] = "profile_region_type";
+// The hardware counters that profile regions can read, in the order of AcceraPerfCounter in
+// accera/runtime/include/PerfCounters.h
+const char* const kHardwareCounterNames[] = { "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses" };
 
-enum class ProfileCounterType
+// GPU launches return once their kernel has completed, so a region around each launch records the kernel's
+// time in the same counters as the CPU regions
+void AddGPULaunchProfileRegions(mlir::ModuleOp module, mlir::OpBuilder& builder)
 {
-    count = 0,
-    time = 1,
-    startTime = 2,
-};
-
-void InitializeProfileRegions(mlir::ModuleOp module, mlir::OpBuilder& builder)
-{
-    std::unordered_set<std::string> regionNames;
-    module.walk([&](vir::EnterProfileRegionOp op) {
-        auto regionName = op.regionName().str();
-        regionNames.insert(regionName);
-    });
-
-    auto loc = module.getLoc();
-    auto body = module.getBody();
-
     OpBuilder::InsertionGuard guard(builder);
-    builder.setInsertionPoint(body, body->begin());
-    auto int64Type = builder.getI64Type();
-    auto doubleType = builder.getF64Type();
-    auto executionCounterType = mlir::MemRefType::get({ 1 }, int64Type);
-    auto timeType = mlir::MemRefType::get({ 1 }, doubleType);
-    auto timeTensorType = mlir::RankedTensorType::get({ 1 }, doubleType);
-    // TODO: maybe make a new "profile region" type that holds a reference to the counters?
-
-    for (auto name : regionNames)
-    {
-        auto nameAttr = builder.getStringAttr(name);
-
-        auto count = builder.create<vir::GlobalOp>(loc, executionCounterType, false, llvm::formatv(kProfileRegionSymNameFormat, name, "count").str(), builder.getI64TensorAttr({ 0 }));
-        count->setAttr(kProfileRegionNameIdentifier, nameAttr);
-        count->setAttr(kProfileRegionTypeIdentifier, builder.getI32IntegerAttr(static_cast<int>(ProfileCounterType::count)));
-
-        auto time = builder.create<vir::GlobalOp>(loc, timeType, false, llvm::formatv(kProfileRegionSymNameFormat, name, "time").str(), mlir::DenseFPElementsAttr::get(timeTensorType, { 0.0 }));
-        time->setAttr(kProfileRegionNameIdentifier, nameAttr);
-        time->setAttr(kProfileRegionTypeIdentifier, builder.getI32IntegerAttr(static_cast<int>(ProfileCounterType::time)));
-
-        auto startTime = builder.create<vir::GlobalOp>(loc, timeType, false, llvm::formatv(kProfileRegionSymNameFormat, name, "start").str(), mlir::DenseFPElementsAttr::get(timeTensorType, { 0.0 }));
-        startTime->setAttr(kProfileRegionNameIdentifier, nameAttr);
-        startTime->setAttr(kProfileRegionTypeIdentifier, builder.getI32IntegerAttr(static_cast<int>(ProfileCounterType::startTime)));
-    }
+    module.walk([&](vir::LaunchFuncOp op) {
+        if (op.exec_target() != vir::ExecutionTarget::GPU)
+        {
+            return;
+        }
+        auto regionName = op.callee().getLeafReference().str() + "_gpu";
+        builder.setInsertionPoint(op);
+        builder.create<vir::EnterProfileRegionOp>(op.getLoc(), regionName);
+        builder.setInsertionPointAfter(op);
+        builder.create<vir::ExitProfileRegionOp>(op.getLoc(), regionName);
+    });
 }
 
-struct ProfileCounter
-{
-    vir::GlobalOp count;
-    vir::GlobalOp time;
-    vir::GlobalOp startTime;
-};
-
-struct ProfileRegions
-{
-    ProfileRegions(mlir::Operation* op) // must be a module
-    {
-        auto module = mlir::cast<mlir::ModuleOp>(op);
-        module.walk([&](vir::GlobalOp op) {
-            if (auto regionNameAttr = op->getAttrOfType<mlir::StringAttr>(kProfileRegionNameIdentifier))
-            {
-                switch (static_cast<ProfileCounterType>(op->getAttrOfType<mlir::IntegerAttr>(kProfileRegionTypeIdentifier).getInt()))
-                {
-                case ProfileCounterType::count:
-                    counters[regionNameAttr.getValue().str()].count = op;
-                    break;
-                case ProfileCounterType::time:
-                    counters[regionNameAttr.getValue().str()].time = op;
-                    break;
-                case ProfileCounterType::startTime:
-                    counters[regionNameAttr.getValue().str()].startTime = op;
-                    break;
-                default:
-                    op.emitError("Error: bad counter type");
-                    break;
-                }
-            }
-        });
-    }
-
-    std::map<std::string, ProfileCounter> counters;
-};
-
 std::string GetFormatStringForElementType(mlir::Type elementType)
 {
     if (elementType.isa<mlir::FloatType>())
@@ -390,7 +330,28 @@ public:
         PatternRewriter& rewriter) const override;
 };
 
+using ValueMultiReduceOp = vir::MultiReduceOp;
+class MultiReduceOpLowering : public OpRewritePattern<ValueMultiReduceOp>
+{
+public:
+    using OpRewritePattern<ValueMultiReduceOp>::OpRewritePattern;
+
+    LogicalResult matchAndRewrite(
+        ValueMultiReduceOp op,
+        PatternRewriter& rewriter) const override;
+};
+
 using ValueReduceMaxOp = vir::ReduceMaxOp;
+class ReduceMaxOpVectorization : public OpRewritePattern<ValueReduceMaxOp>
+{
+public:
+    using OpRewritePattern<ValueReduceMaxOp>::OpRewritePattern;
+
+    LogicalResult matchAndRewrite(
+        ValueReduceMaxOp op,
+        PatternRewriter& rewriter) const override;
+};
+
 class ReduceMaxOpLowering : public OpRewritePattern<ValueReduceMaxOp>
 {
 public:
@@ -402,6 +363,16 @@ public:
 };
 
 using ValueReduceSumOp = vir::ReduceSumOp;
+class ReduceSumOpVectorization : public OpRewritePattern<ValueReduceSumOp>
+{
+public:
+    using OpRewritePattern<ValueReduceSumOp>::OpRewritePattern;
+
+    LogicalResult matchAndRewrite(
+        ValueReduceSumOp op,
+        PatternRewriter& rewriter) const override;
+};
+
 class ReduceSumOpLowering : public OpRewritePattern<ValueReduceSumOp>
 {
 public:
@@ -476,6 +447,10 @@ struct AllocOpLowering : public OpRewritePattern<ValueAllocOp>
             {
             case vir::MemoryAllocType::Global: {
                 auto globalOp = irutil::CreateGlobalBufferOp(rewriter, op, MemRefType::Builder{ memrefType }.setAffineMaps({}), kGlobalOpSymNameFormat);
+                if (op->hasAttr(ir::HugePagesAttrName))
+                {
+                    globalOp->setAttr(ir::HugePagesAttrName, rewriter.getUnitAttr());
+                }
                 rewriter.replaceOpWithNewOp<vir::ReferenceGlobalOp>(op, memrefType, globalOp.sym_name());
             }
             break;
@@ -499,15 +474,22 @@ struct AllocOpLowering : public OpRewritePattern<ValueAllocOp>
 struct ValueToStdLoweringPass : public ConvertValueToStdBase<ValueToStdLoweringPass>
 {
     ValueToStdLoweringPass() = default;
-    ValueToStdLoweringPass(bool enableProfiling) :
+    ValueToStdLoweringPass(bool enableProfiling, const std::string& profileCounters, const std::string& profileTimer) :
         ValueToStdLoweringPass()
     {
         this->enableProfiling = enableProfiling;
+        this->profileCounters = profileCounters;
+        this->profileTimer = profileTimer;
     }
 
     void runOnModule() final;
 };
 
+struct ValueToStdFunctionLoweringPass : public ConvertValueToStdFunctionBase<ValueToStdFunctionLoweringPass>
+{
+    void runOnFunction() final;
+};
+
 struct ValueModuleOpRewritePattern : OpRewritePattern<vir::ValueModuleOp>
 {
     using OpRewritePattern::OpRewritePattern;
@@ -539,17 +521,40 @@ struct ValueModuleOpRewritePattern : OpRewritePattern<vir::ValueModuleOp>
                               ir::value::ExecutionRuntimeAttr::get(getContext(), vir::ExecutionRuntime::CUDA));
         }
     }
+    void AddOpenCLAnnotations(vir::ValueModuleOp module, PatternRewriter& rewriter) const
+    {
+        // OpenCL kernels are emitted as OpenCL C, which the driver compiles, so there is no binary to annotate
+        auto gpuModOps = module.getOps<gpu::GPUModuleOp>();
+        for (auto gpuModOp : gpuModOps)
+        {
+            gpuModOp->setAttr(vir::ValueModuleOp::getExecRuntimeAttrName(),
+                              ir::value::ExecutionRuntimeAttr::get(getContext(), vir::ExecutionRuntime::OPENCL));
+        }
+    }
 
     void AddVulkanAnnotations(ModuleOp module, PatternRewriter& rewriter) const
     {
         auto context = module.getContext();
         namespace spirv = mlir::spirv;
-        auto triple = spirv::VerCapExtAttr::get(
-            spirv::Version::V_1_0,
-            { spirv::Capability::Shader },
-            // TODO: figure out best way to customize this
-            llvm::makeArrayRef(spirv::Extension::SPV_KHR_storage_buffer_storage_class),
-            context);
+        auto version = spirv::Version::V_1_0;
+        std::vector<spirv::Capability> capabilities{ spirv::Capability::Shader };
+        // TODO: figure out best way to customize this
+        std::vector<spirv::Extension> extensions{ spirv::Extension::SPV_KHR_storage_buffer_storage_class };
+
+        // The tensorized kernels need cooperative matrices of FP16 elements, and the subgroup reductions need SPIR-V 1.3,
+        // the Vulkan runtime checks that the device supports what the kernels use
+        if (module.walk([](vir::MFMAComputeOp) { return WalkResult::interrupt(); }).wasInterrupted())
+        {
+            capabilities.insert(capabilities.end(), { spirv::Capability::CooperativeMatrixNV, spirv::Capability::Float16, spirv::Capability::StorageBuffer16BitAccess });
+            extensions.insert(extensions.end(), { spirv::Extension::SPV_NV_cooperative_matrix, spirv::Extension::SPV_KHR_16bit_storage });
+        }
+        if (module.walk([](vir::GPUReduceOp) { return WalkResult::interrupt(); }).wasInterrupted())
+        {
+            version = spirv::Version::V_1_3;
+            capabilities.insert(capabilities.end(), { spirv::Capability::GroupNonUniform, spirv::Capability::GroupNonUniformArithmetic });
+        }
+
+        auto triple = spirv::VerCapExtAttr::get(version, capabilities, extensions, context);
         auto defaultTargetEnvAttr = spirv::getDefaultTargetEnv(context);
         auto targetEnvAttr = spirv::TargetEnvAttr::get(
             triple,
@@ -587,6 +592,10 @@ struct ValueModuleOpRewritePattern : OpRewritePattern<vir::ValueModuleOp>
             {
                 AddRocmAnnotations(vModuleOp, rewriter);
             }
+            else if (runtime == vir::ExecutionRuntime::OPENCL)
+            {
+                AddOpenCLAnnotations(vModuleOp, rewriter);
+            }
         }
 
         Operation* modEnd = &(module.getBody()->back());
@@ -679,6 +688,11 @@ struct GPUTargetedFuncRewritePattern : OpRewritePattern<FuncOp>
 
         fnAttrs.emplace_back(rewriter.getIdentifier(mlir::gpu::GPUDialect::getKernelFuncAttrName()),
                              rewriter.getUnitAttr());
+        // Read back by the GPU resource report
+        if (auto report = funcOp->getAttr(accera::ir::executionPlan::RegisterCacheReportAttrName))
+        {
+            fnAttrs.emplace_back(rewriter.getIdentifier(accera::ir::executionPlan::RegisterCacheReportAttrName), report);
+        }
         if (gpuRuntime == vir::ExecutionRuntime::VULKAN)
         {
             auto entryPointLocalSize = blockDimsLaunchConfig;
@@ -702,6 +716,14 @@ struct GPUTargetedFuncRewritePattern : OpRewritePattern<FuncOp>
                 rewriter.getIdentifier("gridSize"), rewriter.getArrayAttr(gridDimsLaunchConfigAttrs));
             fnAttrs.emplace_back(
                 rewriter.getIdentifier("blockSize"), rewriter.getArrayAttr(blockDimsLaunchConfigAttrs));
+            if (auto persistentBlocksAttr = funcOp->getAttr(ir::GPUPersistentBlocksAttrName))
+            {
+                fnAttrs.emplace_back(rewriter.getIdentifier(ir::GPUPersistentBlocksAttrName), persistentBlocksAttr);
+            }
+            if (auto streamKDimAttr = funcOp->getAttr(ir::GPUStreamKDimAttrName))
+            {
+                fnAttrs.emplace_back(rewriter.getIdentifier(ir::GPUStreamKDimAttrName), streamKDimAttr);
+            }
         }
 
         auto newFuncOp = rewriter.create<gpu::GPUFuncOp>(
@@ -1019,7 +1041,7 @@ LogicalResult GlobalOpLowering::matchAndRewrite(
     auto loc = rewriter.getFusedLoc({ op.getLoc(), RC_FILE_LOC(rewriter) });
 
     ValueGlobalOp::Adaptor adaptor(op);
-    rewriter.replaceOpWithNewOp<memref::GlobalOp>(
+    auto globalOp = rewriter.replaceOpWithNewOp<memref::GlobalOp>(
         op,
         adaptor.sym_name(),
         rewriter.getStringAttr(op.external() ? "public" : "nested"),
@@ -1027,6 +1049,28 @@ LogicalResult GlobalOpLowering::matchAndRewrite(
         adaptor.value(),
         adaptor.constant());
 
+    // Keep cache buffers recognizable as scratch memory for the workspace API, see WorkspaceArgumentPass
+    if (op->hasAttr(ir::executionPlan::CacheBufferAttrName))
+    {
+        globalOp->setAttr(ir::executionPlan::CacheBufferAttrName, rewriter.getUnitAttr());
+    }
+
+    // Keep memory-mapped packed buffers recognizable so their data stays out of the binary, see ValueToLLVMLoweringPass
+    if (auto mappedFileAttr = op->getAttr(ir::MappedFileAttrName))
+    {
+        globalOp->setAttr(ir::MappedFileAttrName, mappedFileAttr);
+    }
+
+    // Large scratch buffers are backed by huge pages when they reach the threshold of the module, see ValueToLLVMLoweringPass
+    auto memrefType = op.type().cast<MemRefType>();
+    auto vModuleOp = op->getParentOfType<vir::ValueModuleOp>();
+    auto thresholdAttr = vModuleOp ? vModuleOp->getAttrOfType<IntegerAttr>(ir::HugePageThresholdAttrName) : IntegerAttr{};
+    auto aboveThreshold = thresholdAttr && memrefType.hasStaticShape() && memrefType.getSizeInBits() / 8 >= thresholdAttr.getInt();
+    if (!op.constant() && !op.external() && !op.value() && (aboveThreshold || op->hasAttr(ir::HugePagesAttrName)))
+    {
+        globalOp->setAttr(ir::HugePagesAttrName, rewriter.getUnitAttr());
+    }
+
     return success();
 }
 
@@ -1141,6 +1185,42 @@ static ValueCmpOpPredicate NegateCmpOpPredicate(ValueCmpOpPredicate pred)
 #undef MAP_PREDICATE
 }
 
+// Returns the number of independent vector accumulators of a vectorized reduction over size elements, which is the count
+// requested on the op, or by default half of the vector registers so that the others hold the loaded input
+static int64_t GetReductionAccumulatorCount(Operation* op, int vectorUnits, int64_t size, int64_t elementsPerVector)
+{
+    int64_t numAccumulators = std::max(1, vectorUnits / 2);
+    if (auto accumulatorsAttr = op->getAttrOfType<IntegerAttr>(ir::ReductionAccumulatorsAttrName))
+    {
+        numAccumulators = accumulatorsAttr.getInt();
+    }
+
+    // Accumulators that would never see a whole vector of the input are dropped
+    auto numVectors = elementsPerVector > 0 ? size / elementsPerVector : 0;
+    return std::clamp<int64_t>(numAccumulators, 1, std::max<int64_t>(1, numVectors));
+}
+
+// Reduces a vector whose size is a power of 2 by repeatedly combining its lower and upper halves, so that
+// the combining ops form a tree of depth log2(size) instead of a single dependency chain
+static mlir::Value TreeReduce(PatternRewriter& rewriter, mlir::Location loc, mlir::Value vector, llvm::function_ref<mlir::Value(mlir::Value, mlir::Value)> combine)
+{
+    auto size = vector.getType().cast<mlir::VectorType>().getShape()[0];
+    while (size > 1)
+    {
+        auto halfSize = size / 2;
+        SmallVector<int64_t, 16> lowerHalf(halfSize);
+        SmallVector<int64_t, 16> upperHalf(halfSize);
+        std::iota(lowerHalf.begin(), lowerHalf.end(), 0);
+        std::iota(upperHalf.begin(), upperHalf.end(), halfSize);
+        auto lower = rewriter.create<mlir::vector::ShuffleOp>(loc, vector, vector, lowerHalf);
+        auto upper = rewriter.create<mlir::vector::ShuffleOp>(loc, vector, vector, upperHalf);
+        vector = combine(lower, upper);
+        size = halfSize;
+    }
+    int64_t firstLane = 0;
+    return rewriter.create<mlir::vector::ExtractElementOp>(loc, vector, firstLane);
+}
+
 static CmpFPredicate CmpOpPredicateToCmpFPredicate(ValueCmpOpPredicate pred)
 {
 #define MAP_PREDICATE(v)         \
@@ -1543,7 +1623,7 @@ LogicalResult ReduceOpVectorization::matchAndRewrite(
     }
 
     [[maybe_unused]] int vectorBytes = vectorizationInfoAttr.getValue().vectorBytes;
-    [[maybe_unused]] int vectorUnits = vectorizationInfoAttr.getValue().vectorUnitCount;
+    int vectorUnits = vectorizationInfoAttr.getValue().vectorUnitCount;
 
     auto loc = op.getLoc();
     auto input = op.input();
@@ -1616,6 +1696,7 @@ LogicalResult ReduceOpVectorization::matchAndRewrite(
         }
     }
     parallelReduce->setAttr("parallelReduction", rewriter.getUnitAttr());
+    parallelReduce->setAttr(ir::ReductionAccumulatorsAttrName, rewriter.getI64IntegerAttr(GetReductionAccumulatorCount(op, vectorUnits, inputType.getShape()[0], elementsPerVector)));
 
     auto horizontalReduce = rewriter.create<ValueReduceOp>(loc, parallelReduce.getResult(), initialValue);
     {
@@ -1716,8 +1797,20 @@ LogicalResult ReduceOpLowering::matchAndRewrite(
 
                     if (!opName.empty())
                     {
+                        auto inputSize = inputType.getShape()[0];
+                        bool isFloatAddOrMul = initialValueType.isa<mlir::FloatType>() && (pred == BinaryOpPredicate::ADD || pred == BinaryOpPredicate::MUL);
+                        if (isFloatAddOrMul && inputSize > 1 && llvm::isPowerOf2_64(inputSize))
+                        {
+                            // Floating-point vector.reduction ops keep the order of the elements, and so are lowered
+                            // to a sequential chain, so reassociate them into a shuffle tree instead
+                            auto combine = [&](mlir::Value lhs, mlir::Value rhs) -> mlir::Value {
+                                return rewriter.create<ValueBinOp>(loc, pred, lhs, rhs);
+                            };
+                            auto result = combine(op.initArg(), TreeReduce(rewriter, loc, op.input(), combine));
+                            rewriter.replaceOp(op, { result });
+                        }
                         // We can use the init value for floating-point add and mul
-                        if (initialValueType.isa<mlir::FloatType>() && (pred == BinaryOpPredicate::ADD || pred == BinaryOpPredicate::MUL))
+                        else if (isFloatAddOrMul)
                         {
                             auto result = rewriter.create<mlir::vector::ReductionOp>(loc, op.result().getType(), rewriter.getStringAttr(opName), op.input(), op.initArg());
                             rewriter.replaceOp(op, { result });
@@ -1785,62 +1878,114 @@ LogicalResult ReduceOpLowering::matchAndRewrite(
         // TODO: manually unroll the loop or do a logN reduction
     }
 
+    // Parallel reductions keep several independent vector accumulators, so that consecutive
+    // chunks of the input don't wait on each other's results
+    int64_t numAccumulators = 1;
+    if (isParallelReduction)
+    {
+        if (auto accumulatorsAttr = op->getAttrOfType<IntegerAttr>(ir::ReductionAccumulatorsAttrName))
+        {
+            numAccumulators = std::max<int64_t>(1, accumulatorsAttr.getInt());
+        }
+    }
+
     auto size = inputType.getShape()[0];
-    auto loopSize = isParallelReduction ? RoundDownToMultiple(size, vectorSize) : size;
-    auto remainder = size - loopSize;
+    auto loopSize = isParallelReduction ? RoundDownToMultiple(size, stepValue * numAccumulators) : size;
+    auto vectorLoopSize = isParallelReduction ? RoundDownToMultiple(size, vectorSize) : size;
+    auto remainder = size - vectorLoopSize;
     auto lowerBound = rewriter.create<ConstantIndexOp>(loc, 0);
     auto upperBound = rewriter.create<ConstantIndexOp>(loc, loopSize);
-    auto step = rewriter.create<ConstantIndexOp>(loc, stepValue);
-    auto loop = rewriter.create<scf::ForOp>(loc, lowerBound, upperBound, step, initialValue);
-    auto loopBody = loop.getBody();
-    {
-        OpBuilder::InsertionGuard guard(rewriter);
-        rewriter.setInsertionPointToStart(loopBody);
+    auto step = rewriter.create<ConstantIndexOp>(loc, stepValue * numAccumulators);
 
-        // map the "input element value" to "input[i]"
-        BlockAndValueMapping operandMap;
-        mlir::Value element;
+    // Returns the "input element value" at the given index of the input
+    auto loadElement = [&](mlir::Value index) -> mlir::Value {
         if (isParallelReduction)
         {
             auto elementType = inputType.getElementType();
             auto zero = rewriter.create<mlir::ConstantOp>(loc, elementType, rewriter.getZeroAttr(elementType));
             auto vectorType = initialValueType;
-            element = rewriter.create<mlir::vector::BroadcastOp>(loc, vectorType, zero);
+            mlir::Value element = rewriter.create<mlir::vector::BroadcastOp>(loc, vectorType, zero);
             for (int64_t i = 0; i < vectorSize; ++i)
             {
                 auto offset = rewriter.create<mlir::ConstantIndexOp>(loc, i);
-                auto offsetInductionVar = rewriter.create<mlir::AddIOp>(loc, loop.getInductionVar(), offset);
+                auto offsetInductionVar = rewriter.create<mlir::AddIOp>(loc, index, offset);
                 auto elementLoad = rewriter.create<memref::LoadOp>(loc, input, ValueRange{ offsetInductionVar });
                 element = rewriter.create<mlir::vector::InsertElementOp>(loc, elementLoad.getResult(), element, i);
             }
+            return element;
         }
         else if (isHorizontalReduction)
         {
             // extract element from input vector
-            auto laneIndex = rewriter.create<mlir::IndexCastOp>(loc, loop.getInductionVar(), rewriter.getI32Type()).getResult();
-            element = rewriter.create<mlir::vector::ExtractElementOp>(loc, input, laneIndex).getResult();
+            auto laneIndex = rewriter.create<mlir::IndexCastOp>(loc, index, rewriter.getI32Type()).getResult();
+            return rewriter.create<mlir::vector::ExtractElementOp>(loc, input, laneIndex).getResult();
         }
         else
         {
-            element = rewriter.create<memref::LoadOp>(loc, input, loop.getInductionVar()).getResult();
+            return rewriter.create<memref::LoadOp>(loc, input, index).getResult();
         }
+    };
 
-        auto newInductionValue = loop.getRegionIterArgs()[0];
+    // Copies the reduction op body to combine an element with the value carried over so far
+    auto reduceElement = [&](mlir::Value element, mlir::Value carriedValue) -> mlir::Value {
+        BlockAndValueMapping operandMap;
         operandMap.map(oldInputValue, element);
-        operandMap.map(oldInductionValue, newInductionValue);
+        operandMap.map(oldInductionValue, carriedValue);
+        for (auto& bodyOp : op.getBody()->without_terminator())
+        {
+            rewriter.clone(bodyOp, operandMap);
+        }
+        return operandMap.lookupOrDefault(oldYieldValue);
+    };
+
+    SmallVector<mlir::Value, 4> initialValues(numAccumulators, initialValue);
+    auto loop = rewriter.create<scf::ForOp>(loc, lowerBound, upperBound, step, initialValues);
+    auto loopBody = loop.getBody();
+    {
+        OpBuilder::InsertionGuard guard(rewriter);
+        rewriter.setInsertionPointToStart(loopBody);
 
-        // Copy reduction op body
-        for (auto& op : op.getBody()->without_terminator())
+        SmallVector<mlir::Value, 4> newYieldValues;
+        for (int64_t accumulatorIdx = 0; accumulatorIdx < numAccumulators; ++accumulatorIdx)
         {
-            rewriter.clone(op, operandMap);
+            mlir::Value index = loop.getInductionVar();
+            if (accumulatorIdx > 0)
+            {
+                auto offset = rewriter.create<mlir::ConstantIndexOp>(loc, accumulatorIdx * stepValue);
+                index = rewriter.create<mlir::AddIOp>(loc, index, offset);
+            }
+            newYieldValues.push_back(reduceElement(loadElement(index), loop.getRegionIterArgs()[accumulatorIdx]));
         }
 
         // now add an appropriate yield operation
-        auto newYieldValue = operandMap.lookupOrDefault(oldYieldValue);
-        rewriter.create<scf::YieldOp>(loc, newYieldValue);
+        rewriter.create<scf::YieldOp>(loc, newYieldValues);
     }
 
-    mlir::Value result = loop.getResults()[0];
+    SmallVector<mlir::Value, 4> accumulators(loop.getResults().begin(), loop.getResults().end());
+
+    // The whole vectors left over after the loop go into their own accumulators
+    for (int64_t offset = loopSize, accumulatorIdx = 0; offset < vectorLoopSize; offset += stepValue, ++accumulatorIdx)
+    {
+        auto index = rewriter.create<mlir::ConstantIndexOp>(loc, offset);
+        accumulators[accumulatorIdx] = reduceElement(loadElement(index), accumulators[accumulatorIdx]);
+    }
+
+    // Combine the accumulators pairwise
+    while (accumulators.size() > 1)
+    {
+        SmallVector<mlir::Value, 4> combined;
+        for (size_t i = 0; i + 1 < accumulators.size(); i += 2)
+        {
+            combined.push_back(reduceElement(accumulators[i + 1], accumulators[i]));
+        }
+        if (accumulators.size() % 2 == 1)
+        {
+            combined.push_back(accumulators.back());
+        }
+        accumulators = std::move(combined);
+    }
+
+    mlir::Value result = accumulators[0];
 
     // Add remainder to value yielded by the vectorized loop
     if (remainder > 0)
@@ -1850,23 +1995,12 @@ LogicalResult ReduceOpLowering::matchAndRewrite(
         mlir::Value element = initialValue;
         for (int64_t i = 0; i < remainder; ++i)
         {
-            auto offset = rewriter.create<mlir::ConstantIndexOp>(loc, i);
-            auto offsetInductionVar = rewriter.create<mlir::AddIOp>(loc, upperBound, offset);
+            auto offsetInductionVar = rewriter.create<mlir::ConstantIndexOp>(loc, vectorLoopSize + i);
             auto elementLoad = rewriter.create<memref::LoadOp>(loc, input, ValueRange{ offsetInductionVar });
             element = rewriter.create<mlir::vector::InsertElementOp>(loc, elementLoad.getResult(), element, i);
         }
 
-        BlockAndValueMapping operandMap;
-        operandMap.map(oldInputValue, element);
-        operandMap.map(oldInductionValue, result);
-
-        // Copy reduction op body
-        for (auto& op : op.getBody()->without_terminator())
-        {
-            rewriter.clone(op, operandMap);
-        }
-
-        result = operandMap.lookupOrNull(oldYieldValue);
+        result = reduceElement(element, result);
         assert(result);
     }
 
@@ -1936,7 +2070,7 @@ LogicalResult MapReduceOpVectorization::matchAndRewrite(
     }
 
     [[maybe_unused]] int vectorBytes = vectorizationInfoAttr.getValue().vectorBytes;
-    [[maybe_unused]] int vectorUnits = vectorizationInfoAttr.getValue().vectorUnitCount;
+    int vectorUnits = vectorizationInfoAttr.getValue().vectorUnitCount;
 
     auto loc = op.getLoc();
     auto input = op.input();
@@ -2053,6 +2187,7 @@ LogicalResult MapReduceOpVectorization::matchAndRewrite(
         }
     }
     parallelReduce->setAttr("parallelReduction", rewriter.getUnitAttr());
+    parallelReduce->setAttr(ir::ReductionAccumulatorsAttrName, rewriter.getI64IntegerAttr(GetReductionAccumulatorCount(op, vectorUnits, inputType.getShape()[0], elementsPerVector)));
 
     auto horizontalReduce = rewriter.create<ValueReduceOp>(loc, parallelReduce.getResult(), initialValue);
     {
@@ -2107,12 +2242,24 @@ LogicalResult MapReduceOpLowering::matchAndRewrite(
     }
     auto stepValue = isParallelReduction ? vectorSize : 1;
 
+    // Parallel reductions keep several independent vector accumulators, so that consecutive
+    // chunks of the input don't wait on each other's results
+    int64_t numAccumulators = 1;
+    if (isParallelReduction)
+    {
+        if (auto accumulatorsAttr = op->getAttrOfType<IntegerAttr>(ir::ReductionAccumulatorsAttrName))
+        {
+            numAccumulators = std::max<int64_t>(1, accumulatorsAttr.getInt());
+        }
+    }
+
     auto size = inputType.getShape()[0];
-    auto loopSize = isParallelReduction ? RoundDownToMultiple(size, vectorSize) : size;
-    auto remainder = size - loopSize;
+    auto loopSize = isParallelReduction ? RoundDownToMultiple(size, stepValue * numAccumulators) : size;
+    auto vectorLoopSize = isParallelReduction ? RoundDownToMultiple(size, vectorSize) : size;
+    auto remainder = size - vectorLoopSize;
     auto lowerBound = rewriter.create<ConstantIndexOp>(loc, 0);
     auto upperBound = rewriter.create<ConstantIndexOp>(loc, loopSize);
-    auto step = rewriter.create<ConstantIndexOp>(loc, stepValue);
+    auto step = rewriter.create<ConstantIndexOp>(loc, stepValue * numAccumulators);
 
     // Map loop values
     auto oldMapInputValue = op.getMapInputValueVar();
@@ -2125,40 +2272,36 @@ LogicalResult MapReduceOpLowering::matchAndRewrite(
     auto oldReduceTerminator = op.getReduceBody()->getTerminator();
     auto oldReduceYieldValue = oldReduceTerminator->getOperand(0);
 
-    auto mapReduceLoop = rewriter.create<scf::ForOp>(loc, lowerBound, upperBound, step, initialValue);
-    auto mapReduceLoopBody = mapReduceLoop.getBody();
-    {
-        OpBuilder::InsertionGuard guard(rewriter);
-        rewriter.setInsertionPointToStart(mapReduceLoopBody);
-
+    // Applies the map op body to the element(s) at the given index of the input, and stores the mapped value back to memory
+    auto mapElement = [&](mlir::Value index) -> mlir::Value {
         // map the "input element value" to "input[i]"
         BlockAndValueMapping mapOperandMap;
-        mlir::Value mapElement;
+        mlir::Value element;
         if (isParallelReduction)
         {
             auto elementType = inputType.getElementType();
             auto zero = rewriter.create<mlir::ConstantOp>(loc, elementType, rewriter.getZeroAttr(elementType));
             auto vectorType = initialValueType;
-            mapElement = rewriter.create<mlir::vector::BroadcastOp>(loc, vectorType, zero);
+            element = rewriter.create<mlir::vector::BroadcastOp>(loc, vectorType, zero);
             for (int64_t i = 0; i < vectorSize; ++i)
             {
                 auto offset = rewriter.create<mlir::ConstantIndexOp>(loc, i);
-                auto offsetInductionVar = rewriter.create<mlir::AddIOp>(loc, mapReduceLoop.getInductionVar(), offset);
+                auto offsetInductionVar = rewriter.create<mlir::AddIOp>(loc, index, offset);
                 auto elementLoad = rewriter.create<memref::LoadOp>(loc, input, ValueRange{ offsetInductionVar });
-                mapElement = rewriter.create<mlir::vector::InsertElementOp>(loc, elementLoad.getResult(), mapElement, i);
+                element = rewriter.create<mlir::vector::InsertElementOp>(loc, elementLoad.getResult(), element, i);
             }
         }
         else
         {
-            mapElement = rewriter.create<memref::LoadOp>(loc, input, mapReduceLoop.getInductionVar()).getResult();
+            element = rewriter.create<memref::LoadOp>(loc, input, index).getResult();
         }
 
-        mapOperandMap.map(oldMapInputValue, mapElement);
+        mapOperandMap.map(oldMapInputValue, element);
 
         // Clone map op body
-        for (auto& op : op.getMapBody()->without_terminator())
+        for (auto& bodyOp : op.getMapBody()->without_terminator())
         {
-            rewriter.clone(op, mapOperandMap);
+            rewriter.clone(bodyOp, mapOperandMap);
         }
 
         auto newMapYieldValue = mapOperandMap.lookupOrDefault(oldMapYieldValue);
@@ -2168,59 +2311,101 @@ LogicalResult MapReduceOpLowering::matchAndRewrite(
         {
             for (int64_t i = 0; i < vectorSize; ++i)
             {
-                auto element = rewriter.create<mlir::vector::ExtractElementOp>(op.getLoc(), newMapYieldValue, i);
+                auto mappedElement = rewriter.create<mlir::vector::ExtractElementOp>(op.getLoc(), newMapYieldValue, i);
                 auto offset = rewriter.create<mlir::ConstantIndexOp>(loc, i);
-                auto offsetInductionVar = rewriter.create<mlir::AddIOp>(loc, mapReduceLoop.getInductionVar(), offset);
-                rewriter.create<memref::StoreOp>(loc, element, input, ValueRange{ offsetInductionVar });
+                auto offsetInductionVar = rewriter.create<mlir::AddIOp>(loc, index, offset);
+                rewriter.create<memref::StoreOp>(loc, mappedElement, input, ValueRange{ offsetInductionVar });
             }
         }
         else
         {
-            rewriter.create<memref::StoreOp>(loc, newMapYieldValue, input, mapReduceLoop.getInductionVar());
+            rewriter.create<memref::StoreOp>(loc, newMapYieldValue, input, index);
         }
+        return newMapYieldValue;
+    };
 
-        // End of "map" part
-
-        // map the "input element value" to the output of the "map" part
+    // Copies the reduction op body to combine an element with the value carried over so far
+    auto reduceElement = [&](mlir::Value element, mlir::Value carriedValue) -> mlir::Value {
         BlockAndValueMapping reduceOperandMap;
-        auto reduceElement = newMapYieldValue;
+        reduceOperandMap.map(oldReduceInputValue, element);
+        reduceOperandMap.map(oldInductionValue, carriedValue);
+        for (auto& bodyOp : op.getReduceBody()->without_terminator())
+        {
+            rewriter.clone(bodyOp, reduceOperandMap);
+        }
+        return reduceOperandMap.lookupOrDefault(oldReduceYieldValue);
+    };
 
-        auto newInductionValue = mapReduceLoop.getRegionIterArgs()[0];
-        reduceOperandMap.map(oldReduceInputValue, reduceElement);
-        reduceOperandMap.map(oldInductionValue, newInductionValue);
+    SmallVector<mlir::Value, 4> initialValues(numAccumulators, initialValue);
+    auto mapReduceLoop = rewriter.create<scf::ForOp>(loc, lowerBound, upperBound, step, initialValues);
+    auto mapReduceLoopBody = mapReduceLoop.getBody();
+    {
+        OpBuilder::InsertionGuard guard(rewriter);
+        rewriter.setInsertionPointToStart(mapReduceLoopBody);
 
-        // Clone reduction op body
-        for (auto& op : op.getReduceBody()->without_terminator())
+        SmallVector<mlir::Value, 4> newReduceYieldValues;
+        for (int64_t accumulatorIdx = 0; accumulatorIdx < numAccumulators; ++accumulatorIdx)
         {
-            rewriter.clone(op, reduceOperandMap);
+            mlir::Value index = mapReduceLoop.getInductionVar();
+            if (accumulatorIdx > 0)
+            {
+                auto offset = rewriter.create<mlir::ConstantIndexOp>(loc, accumulatorIdx * stepValue);
+                index = rewriter.create<mlir::AddIOp>(loc, index, offset);
+            }
+            newReduceYieldValues.push_back(reduceElement(mapElement(index), mapReduceLoop.getRegionIterArgs()[accumulatorIdx]));
         }
 
         // now add an appropriate yield operation
-        auto newReduceYieldValue = reduceOperandMap.lookupOrDefault(oldReduceYieldValue);
-        rewriter.create<scf::YieldOp>(loc, newReduceYieldValue);
+        rewriter.create<scf::YieldOp>(loc, newReduceYieldValues);
     }
 
-    mlir::Value result = mapReduceLoop.getResults()[0];
+    SmallVector<mlir::Value, 4> accumulators(mapReduceLoop.getResults().begin(), mapReduceLoop.getResults().end());
+
+    // The whole vectors left over after the loop go into their own accumulators
+    for (int64_t offset = loopSize, accumulatorIdx = 0; offset < vectorLoopSize; offset += stepValue, ++accumulatorIdx)
+    {
+        auto index = rewriter.create<mlir::ConstantIndexOp>(loc, offset);
+        accumulators[accumulatorIdx] = reduceElement(mapElement(index), accumulators[accumulatorIdx]);
+    }
+
+    // Combine the accumulators pairwise
+    while (accumulators.size() > 1)
+    {
+        SmallVector<mlir::Value, 4> combined;
+        for (size_t i = 0; i + 1 < accumulators.size(); i += 2)
+        {
+            combined.push_back(reduceElement(accumulators[i + 1], accumulators[i]));
+        }
+        if (accumulators.size() % 2 == 1)
+        {
+            combined.push_back(accumulators.back());
+        }
+        accumulators = std::move(combined);
+    }
+
+    mlir::Value result = accumulators[0];
 
     if (remainder > 0)
     {
         assert(isParallelReduction);
 
+        auto remainderStart = rewriter.create<ConstantIndexOp>(loc, vectorLoopSize);
+
         // map the "input element value" to "input[i]"
         BlockAndValueMapping mapOperandMap;
         auto elementType = inputType.getElementType();
         auto zero = rewriter.create<mlir::ConstantOp>(loc, elementType, rewriter.getZeroAttr(elementType));
         auto vectorType = initialValueType;
-        mlir::Value mapElement = rewriter.create<mlir::vector::BroadcastOp>(loc, vectorType, zero);
+        mlir::Value remainderElement = rewriter.create<mlir::vector::BroadcastOp>(loc, vectorType, zero);
         for (int64_t i = 0; i < remainder; ++i)
         {
             auto offset = rewriter.create<mlir::ConstantIndexOp>(loc, i);
-            auto offsetInductionVar = rewriter.create<mlir::AddIOp>(loc, upperBound, offset);
+            auto offsetInductionVar = rewriter.create<mlir::AddIOp>(loc, remainderStart, offset);
             auto elementLoad = rewriter.create<memref::LoadOp>(loc, input, ValueRange{ offsetInductionVar });
-            mapElement = rewriter.create<mlir::vector::InsertElementOp>(loc, elementLoad.getResult(), mapElement, i);
+            remainderElement = rewriter.create<mlir::vector::InsertElementOp>(loc, elementLoad.getResult(), remainderElement, i);
         }
 
-        mapOperandMap.map(oldMapInputValue, mapElement);
+        mapOperandMap.map(oldMapInputValue, remainderElement);
 
         // Clone map op body
         for (auto& op : op.getMapBody()->without_terminator())
@@ -2235,34 +2420,186 @@ LogicalResult MapReduceOpLowering::matchAndRewrite(
         {
             auto element = rewriter.create<mlir::vector::ExtractElementOp>(op.getLoc(), newMapYieldValue, i);
             auto offset = rewriter.create<mlir::ConstantIndexOp>(loc, i);
-            auto offsetInductionVar = rewriter.create<mlir::AddIOp>(loc, upperBound, offset);
+            auto offsetInductionVar = rewriter.create<mlir::AddIOp>(loc, remainderStart, offset);
             rewriter.create<memref::StoreOp>(loc, element, input, ValueRange{ offsetInductionVar });
 
             maskedMapYieldValue = rewriter.create<mlir::vector::InsertElementOp>(loc, element, maskedMapYieldValue, i);
         }
 
         // Add remainder to value yielded by the vectorized loop
-        mlir::Value reduceElement = maskedMapYieldValue;
+        result = reduceElement(maskedMapYieldValue, result);
+        assert(result);
+    }
 
-        BlockAndValueMapping reduceOperandMap;
-        reduceOperandMap.map(oldReduceInputValue, reduceElement);
-        reduceOperandMap.map(oldInductionValue, result);
+    rewriter.replaceOp(op, result);
+    return success();
+}
 
-        // Copy reduction op body
-        for (auto& op : op.getReduceBody()->without_terminator())
+LogicalResult MultiReduceOpLowering::matchAndRewrite(
+    ValueMultiReduceOp op,
+    PatternRewriter& rewriter) const
+{
+    auto loc = op.getLoc();
+    auto input = op.input();
+    auto inputType = op.getShapedType();
+    if (inputType.getRank() != 1)
+    {
+        return op.emitError("Can only reduce a rank-1 memref");
+    }
+    if (inputType.isDynamicDim(0))
+    {
+        return op.emitError("Can only reduce a memref with a static size");
+    }
+
+    auto numReductions = op.getNumReductions();
+    auto size = inputType.getShape()[0];
+    auto lanes = std::max<int64_t>(1, std::min<int64_t>(static_cast<int64_t>(op.lanes()), size));
+    auto loopSize = RoundDownToMultiple(size, lanes);
+
+    // Copies a region of the op with its arguments mapped to the given values, and returns the values it yields
+    auto cloneBody = [&](Block* body, ArrayRef<mlir::Value> arguments) -> SmallVector<mlir::Value, 4> {
+        BlockAndValueMapping operandMap;
+        for (auto [argument, value] : llvm::zip(body->getArguments(), arguments))
+        {
+            operandMap.map(argument, value);
+        }
+        for (auto& bodyOp : body->without_terminator())
         {
-            rewriter.clone(op, reduceOperandMap);
+            rewriter.clone(bodyOp, operandMap);
         }
+        return llvm::to_vector<4>(llvm::map_range(body->getTerminator()->getOperands(), [&](mlir::Value value) { return operandMap.lookupOrDefault(value); }));
+    };
 
-        result = reduceOperandMap.lookupOrNull(oldReduceYieldValue);
-        assert(result);
+    auto reduceElement = [&](mlir::Value element, ValueRange carriedValues) {
+        SmallVector<mlir::Value, 8> arguments{ element };
+        arguments.append(carriedValues.begin(), carriedValues.end());
+        return cloneBody(op.getReduceBody(), arguments);
+    };
+
+    auto combine = [&](ValueRange lhs, ValueRange rhs) {
+        SmallVector<mlir::Value, 8> arguments(lhs.begin(), lhs.end());
+        arguments.append(rhs.begin(), rhs.end());
+        return cloneBody(op.getCombineBody(), arguments);
+    };
+
+    auto loadElement = [&](mlir::Value index) -> mlir::Value {
+        return rewriter.create<memref::LoadOp>(loc, input, ValueRange{ index });
+    };
+
+    // Each lane reduces every lanes'th element into its own set of values. The lanes don't depend on each other
+    // within an iteration, so that the loop body can be vectorized across them.
+    SmallVector<mlir::Value, 16> initialValues;
+    for (int64_t lane = 0; lane < lanes; ++lane)
+    {
+        initialValues.append(op.initArgs().begin(), op.initArgs().end());
+    }
+
+    auto lowerBound = rewriter.create<ConstantIndexOp>(loc, 0);
+    auto upperBound = rewriter.create<ConstantIndexOp>(loc, loopSize);
+    auto step = rewriter.create<ConstantIndexOp>(loc, lanes);
+    auto loop = rewriter.create<scf::ForOp>(loc, lowerBound, upperBound, step, initialValues);
+    {
+        OpBuilder::InsertionGuard guard(rewriter);
+        rewriter.setInsertionPointToStart(loop.getBody());
+
+        SmallVector<mlir::Value, 16> newYieldValues;
+        for (int64_t lane = 0; lane < lanes; ++lane)
+        {
+            mlir::Value index = loop.getInductionVar();
+            if (lane > 0)
+            {
+                auto offset = rewriter.create<mlir::ConstantIndexOp>(loc, lane);
+                index = rewriter.create<mlir::AddIOp>(loc, index, offset);
+            }
+            auto laneValues = reduceElement(loadElement(index), loop.getRegionIterArgs().slice(lane * numReductions, numReductions));
+            newYieldValues.append(laneValues.begin(), laneValues.end());
+        }
+
+        rewriter.create<scf::YieldOp>(loc, newYieldValues);
+    }
+
+    std::vector<SmallVector<mlir::Value, 4>> accumulators;
+    for (int64_t lane = 0; lane < lanes; ++lane)
+    {
+        auto laneResults = loop.getResults().slice(lane * numReductions, numReductions);
+        accumulators.emplace_back(laneResults.begin(), laneResults.end());
+    }
+
+    // Combine the lanes pairwise
+    while (accumulators.size() > 1)
+    {
+        std::vector<SmallVector<mlir::Value, 4>> combined;
+        for (size_t i = 0; i + 1 < accumulators.size(); i += 2)
+        {
+            combined.push_back(combine(accumulators[i], accumulators[i + 1]));
+        }
+        if (accumulators.size() % 2 == 1)
+        {
+            combined.push_back(accumulators.back());
+        }
+        accumulators = std::move(combined);
+    }
+
+    // The elements left over after the loop go into the combined values
+    auto result = accumulators[0];
+    for (auto index = loopSize; index < size; ++index)
+    {
+        result = reduceElement(loadElement(rewriter.create<mlir::ConstantIndexOp>(loc, index)), result);
     }
 
     rewriter.replaceOp(op, result);
     return success();
 }
 
+/// We vectorize `reduce_max` and `reduce_sum` ops that carry vectorization info by rewriting them
+/// to the equivalent `reduce` op, which is then vectorized by ReduceOpVectorization
 using ValueReduceMaxOp = vir::ReduceMaxOp;
+LogicalResult ReduceMaxOpVectorization::matchAndRewrite(
+    ValueReduceMaxOp op,
+    PatternRewriter& rewriter) const
+{
+    auto vectorizationInfoIdentifier = rewriter.getIdentifier(ir::executionPlan::VectorizationInfoAttr::getKeyName());
+    if (!op->getAttrOfType<ir::executionPlan::VectorizationInfoAttr>(vectorizationInfoIdentifier) || op.input().getType().cast<mlir::MemRefType>().getRank() != 1)
+    {
+        return failure();
+    }
+
+    // The first element is the initial value since the max doesn't change when it's seen twice
+    auto loc = op.getLoc();
+    auto zero = rewriter.create<ConstantIndexOp>(loc, 0);
+    mlir::Value initialValue = rewriter.create<memref::LoadOp>(loc, op.input(), ValueRange{ zero });
+    auto reduceOp = rewriter.create<ValueReduceOp>(loc, op.input(), initialValue, [](OpBuilder& builder, Location loc, mlir::Value element, mlir::Value max) {
+        auto isGreater = builder.create<vir::CmpOp>(loc, vir::CmpOpPredicate::GT, element, max);
+        mlir::Value result = builder.create<mlir::SelectOp>(loc, isGreater, element, max);
+        builder.create<vir::YieldOp>(loc, result);
+    });
+    reduceOp->setAttrs(op->getAttrs());
+    rewriter.replaceOp(op, reduceOp.getResult());
+    return success();
+}
+
+LogicalResult ReduceSumOpVectorization::matchAndRewrite(
+    ValueReduceSumOp op,
+    PatternRewriter& rewriter) const
+{
+    auto vectorizationInfoIdentifier = rewriter.getIdentifier(ir::executionPlan::VectorizationInfoAttr::getKeyName());
+    if (!op->getAttrOfType<ir::executionPlan::VectorizationInfoAttr>(vectorizationInfoIdentifier) || op.input().getType().cast<mlir::MemRefType>().getRank() != 1)
+    {
+        return failure();
+    }
+
+    auto loc = op.getLoc();
+    auto elementType = op.result().getType();
+    mlir::Value initialValue = rewriter.create<mlir::ConstantOp>(loc, elementType, rewriter.getZeroAttr(elementType));
+    auto reduceOp = rewriter.create<ValueReduceOp>(loc, op.input(), initialValue, [](OpBuilder& builder, Location loc, mlir::Value element, mlir::Value sum) {
+        mlir::Value result = builder.create<vir::BinOp>(loc, vir::BinaryOpPredicate::ADD, element, sum);
+        builder.create<vir::YieldOp>(loc, result);
+    });
+    reduceOp->setAttrs(op->getAttrs());
+    rewriter.replaceOp(op, reduceOp.getResult());
+    return success();
+}
+
 LogicalResult ReduceMaxOpLowering::matchAndRewrite(
     ValueReduceMaxOp op,
     PatternRewriter& rewriter) const
@@ -2297,109 +2634,35 @@ LogicalResult ReduceMaxOpLowering::matchAndRewrite(
     return success();
 }
 
+// Profile regions are lowered to calls to the acc-runtime library by the value to LLVM lowering, which keeps the
+// regions of each thread in a tree of its own. They're removed here when profiling is disabled.
 LogicalResult EnterProfileRegionOpLowering::matchAndRewrite(EnterProfileRegionOp op, PatternRewriter& rewriter) const
 {
-    if (!enableProfiling)
-    {
-        // if profiling is disabled, just remove this op
-        rewriter.eraseOp(op);
-        return success();
-    }
-
-    auto loc = op.getLoc();
-    auto module = op->getParentOfType<mlir::ModuleOp>();
-
-    ProfileRegions regions(module);
-    auto regionName = op.regionName().str();
-    if (regions.counters.count(regionName) == 0)
+    if (enableProfiling)
     {
-        op.emitError("No counters exist for region");
         return failure();
     }
 
-    auto startTimeGlobal = regions.counters[regionName].startTime;
-    mlir::Value startTimeRef = rewriter.create<vir::ReferenceGlobalOp>(loc, startTimeGlobal);
-
-    // get current time and store it in the startTime entry
-    mlir::Value currentTime = rewriter.create<vir::GetTimeOp>(loc);
-    rewriter.create<vir::CopyOp>(loc, currentTime, startTimeRef);
     rewriter.eraseOp(op);
     return success();
 }
 
 LogicalResult ExitProfileRegionOpLowering::matchAndRewrite(ExitProfileRegionOp op, PatternRewriter& rewriter) const
 {
-    if (!enableProfiling)
+    if (enableProfiling)
     {
-        // if profiling is disabled, just remove this op
-        rewriter.eraseOp(op);
-        return success();
-    }
-
-    auto loc = op.getLoc();
-    auto module = op->getParentOfType<mlir::ModuleOp>();
-
-    ProfileRegions regions(module);
-    auto regionName = op.regionName().str();
-    if (regions.counters.count(regionName) == 0)
-    {
-        op.emitError("No counters exist for region");
         return failure();
     }
 
-    auto startTimeGlobal = regions.counters[regionName].startTime;
-    mlir::Value startTimeRef = rewriter.create<vir::ReferenceGlobalOp>(loc, startTimeGlobal);
-
-    auto totalTimeGlobal = regions.counters[regionName].time;
-    mlir::Value totalTimeRef = rewriter.create<vir::ReferenceGlobalOp>(loc, totalTimeGlobal);
-
-    auto countGlobal = regions.counters[regionName].count;
-    mlir::Value countRef = rewriter.create<vir::ReferenceGlobalOp>(loc, countGlobal);
-
-    mlir::Value startTime = rewriter.create<vir::GetElementOp>(loc, startTimeRef);
-    mlir::Value currentTime = rewriter.create<vir::GetTimeOp>(loc);
-    mlir::Value duration = rewriter.create<vir::BinOp>(loc, vir::BinaryOpPredicate::SUB, currentTime, startTime);
-    mlir::Value prevTotalTime = rewriter.create<vir::GetElementOp>(loc, totalTimeRef);
-    mlir::Value totalTime = rewriter.create<vir::BinOp>(loc, vir::BinaryOpPredicate::ADD, prevTotalTime, duration);
-    rewriter.create<vir::CopyOp>(loc, totalTime, totalTimeRef);
-
-    mlir::Value prevCount = rewriter.create<vir::GetElementOp>(loc, countRef);
-    auto one = rewriter.create<ConstantOp>(loc, rewriter.getI64Type(), rewriter.getI64IntegerAttr(1));
-    mlir::Value newCount = rewriter.create<vir::BinOp>(loc, vir::BinaryOpPredicate::ADD, prevCount, one);
-    rewriter.create<vir::CopyOp>(loc, newCount, countRef);
-
     rewriter.eraseOp(op);
     return success();
 }
 
 LogicalResult PrintProfileResultsOpLowering::matchAndRewrite(PrintProfileResultsOp op, PatternRewriter& rewriter) const
 {
-    if (!enableProfiling)
+    if (enableProfiling)
     {
-        // if profiling is disabled, just remove this op
-        rewriter.eraseOp(op);
-        return success();
-    }
-
-    auto loc = op.getLoc();
-    auto module = op->getParentOfType<mlir::ModuleOp>();
-
-    ProfileRegions regions(module);
-
-    // foreach region, print count and number
-    for (auto [name, counters] : regions.counters)
-    {
-        auto totalTimeGlobal = counters.time;
-        mlir::Value totalTimeRef = rewriter.create<vir::ReferenceGlobalOp>(loc, totalTimeGlobal);
-
-        auto countGlobal = counters.count;
-        mlir::Value countRef = rewriter.create<vir::ReferenceGlobalOp>(loc, countGlobal);
-
-        mlir::Value totalTime = rewriter.create<vir::GetElementOp>(loc, totalTimeRef);
-        mlir::Value count = rewriter.create<vir::GetElementOp>(loc, countRef);
-
-        std::string formatStr = name + "\t%ld\t%f\n";
-        rewriter.create<vir::PrintFOp>(loc, formatStr, ValueRange{ count, totalTime }, /*toStderr=*/false);
+        return failure();
     }
 
     rewriter.eraseOp(op);
@@ -2520,9 +2783,43 @@ void ValueToStdLoweringPass::runOnModule()
 
     OpBuilder passBuilder(module);
 
+    int32_t hardwareCounterMask = 0;
     if (this->enableProfiling)
     {
-        InitializeProfileRegions(module, passBuilder);
+        llvm::SmallVector<llvm::StringRef, 4> counterNames;
+        llvm::StringRef(this->profileCounters).split(counterNames, ',', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+        for (auto counterName : counterNames)
+        {
+            auto it = llvm::find(kHardwareCounterNames, counterName.trim());
+            if (it == std::end(kHardwareCounterNames))
+            {
+                module.emitError("Unknown profile counter ") << counterName;
+                return signalPassFailure();
+            }
+            hardwareCounterMask |= 1 << std::distance(std::begin(kHardwareCounterNames), it);
+        }
+
+        if (this->profileTimer != "clock" && this->profileTimer != "tsc")
+        {
+            module.emitError("Unknown profile timer ") << this->profileTimer;
+            return signalPassFailure();
+        }
+
+        AddGPULaunchProfileRegions(module, passBuilder);
+
+        // The value to LLVM lowering reads the counters and the timer of each region from its attributes
+        auto counterMaskAttr = passBuilder.getI32IntegerAttr(hardwareCounterMask);
+        auto useCycleCounter = this->profileTimer == "tsc";
+        module.walk([&](Operation* op) {
+            if (isa<vir::EnterProfileRegionOp, vir::ExitProfileRegionOp>(op))
+            {
+                op->setAttr(ir::ProfileCounterMaskAttrName, counterMaskAttr);
+                if (useCycleCounter)
+                {
+                    op->setAttr(ir::ProfileCycleCounterAttrName, passBuilder.getUnitAttr());
+                }
+            }
+        });
     }
 
     for (auto vModule : make_early_inc_range(module.getOps<vir::ValueModuleOp>()))
@@ -2588,6 +2885,23 @@ void ValueToStdLoweringPass::runOnModule()
     }
 }
 
+void ValueToStdFunctionLoweringPass::runOnFunction()
+{
+    auto func = getFunction();
+    auto context = func.getContext();
+
+    OwningRewritePatternList vecPatterns(context);
+    vtr::populateVectorizeValueOpPatterns(vecPatterns);
+    (void)applyPatternsAndFoldGreedily(func, std::move(vecPatterns));
+
+    OwningRewritePatternList patterns(context);
+    vtr::populateValueToStandardFunctionPatterns(patterns);
+    vtr::populateValueSimplifyPatterns(patterns);
+    utilir::FillCanonicalPatternsRecursively(func, patterns);
+    mlir::populateExpandTanhPattern(patterns);
+    (void)applyPatternsAndFoldGreedily(func, std::move(patterns));
+}
+
 namespace accera::transforms::value
 {
 void populateValueModuleRewritePatterns(mlir::OwningRewritePatternList& patterns)
@@ -2610,28 +2924,43 @@ void populateVectorizeValueOpPatterns(mlir::OwningRewritePatternList& patterns)
     accera::generated::populateWithGenerated(patterns);
     patterns.insert<
         ReduceOpVectorization,
-        MapReduceOpVectorization>(context);
+        MapReduceOpVectorization,
+        ReduceMaxOpVectorization,
+        ReduceSumOpVectorization>(context);
 }
 
 void populateValueToStandardPatterns(bool enableProfiling, mlir::OwningRewritePatternList& patterns)
 {
     mlir::MLIRContext* context = patterns.getContext();
-    accera::generated::populateWithGenerated(patterns);
+    populateValueToStandardFunctionPatterns(patterns);
     patterns.insert<
         GPUTargetedFuncRewritePattern,
         GPUTargetedFuncTerminatorRewritePattern,
         AllocOpLowering,
+        GlobalOpLowering,
+        PrintOpLowering,
+        ReferenceGlobalOpLowering>(context);
+
+    patterns.insert<EnterProfileRegionOpLowering,
+                    PrintProfileResultsOpLowering,
+                    ExitProfileRegionOpLowering>(context, enableProfiling);
+}
+
+// The patterns that only rewrite ops within their function, which convert-value-to-std-function runs concurrently
+void populateValueToStandardFunctionPatterns(mlir::OwningRewritePatternList& patterns)
+{
+    mlir::MLIRContext* context = patterns.getContext();
+    accera::generated::populateWithGenerated(patterns);
+    patterns.insert<
         BinOpLowering,
         CmpOpLowering,
         GetElementOpLowering,
-        GlobalOpLowering,
         LoadOpLowering,
         MapReduceOpLowering,
         MergeDimOpLowering,
+        MultiReduceOpLowering,
         OffsetOpLowering,
-        PrintOpLowering,
         ReduceOpLowering,
-        ReferenceGlobalOpLowering,
         ReduceMaxOpLowering,
         ReduceSumOpLowering,
         ReorderOpLowering,
@@ -2642,15 +2971,16 @@ void populateValueToStandardPatterns(bool enableProfiling, mlir::OwningRewritePa
         TerminatorLowering,
         UnaryOpLowering,
         ViewOpLowering>(context);
-
-    patterns.insert<EnterProfileRegionOpLowering,
-                    PrintProfileResultsOpLowering,
-                    ExitProfileRegionOpLowering>(context, enableProfiling);
 }
 
-std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createValueToStdPass(bool enableProfiling)
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createValueToStdPass(bool enableProfiling, const std::string& profileCounters, const std::string& profileTimer)
 {
-    auto pass = std::make_unique<ValueToStdLoweringPass>(enableProfiling);
+    auto pass = std::make_unique<ValueToStdLoweringPass>(enableProfiling, profileCounters, profileTimer);
     return pass;
 }
+
+std::unique_ptr<mlir::OperationPass<mlir::FuncOp>> createValueToStdFunctionPass()
+{
+    return std::make_unique<ValueToStdFunctionLoweringPass>();
+}
 } // namespace accera::transforms::value
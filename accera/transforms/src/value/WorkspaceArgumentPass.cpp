@@ -0,0 +1,227 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "AcceraPasses.h"
+
+#include <ir/include/exec/ExecutionPlanOps.h>
+#include <ir/include/value/ValueDialect.h>
+
+#include <mlir/Dialect/MemRef/IR/MemRef.h>
+#include <mlir/Dialect/StandardOps/IR/Ops.h>
+#include <mlir/IR/Builders.h>
+#include <mlir/IR/BuiltinOps.h>
+#include <mlir/IR/SymbolTable.h>
+
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/SetVector.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringMap.h>
+
+#include <string>
+
+using namespace mlir;
+
+namespace
+{
+// Matches the alignment of the cache arenas, see CacheMemoryPlanningPass
+constexpr int64_t WorkspaceAlignment = 64;
+
+int64_t AlignUp(int64_t value, int64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+bool IsWorkspaceBufferType(MemRefType type)
+{
+    auto elementType = type.getElementType();
+    if (!type.hasStaticShape() || !(elementType.isIntOrFloat() || elementType.isa<VectorType>()))
+    {
+        return false;
+    }
+    return llvm::all_of(type.getAffineMaps(), [](AffineMap map) { return map.isIdentity(); });
+}
+
+// Returns the functions reachable through direct calls from funcOp, starting with funcOp itself
+llvm::SetVector<FuncOp> GetCalledFunctions(ModuleOp module, FuncOp funcOp)
+{
+    llvm::SetVector<FuncOp> functions;
+    functions.insert(funcOp);
+    for (unsigned i = 0; i < functions.size(); ++i)
+    {
+        FuncOp current = functions[i];
+        current.walk([&](CallOp callOp) {
+            auto callee = module.lookupSymbol<FuncOp>(callOp.getCallee());
+            if (callee && !callee.isExternal())
+            {
+                functions.insert(callee);
+            }
+        });
+    }
+    return functions;
+}
+
+class WorkspaceArgumentPass : public accera::transforms::ConvertScratchToWorkspaceBase<WorkspaceArgumentPass>
+{
+public:
+    void runOnModule() final;
+
+private:
+    LogicalResult ConvertToWorkspaceAPI(FuncOp funcOp);
+};
+
+void WorkspaceArgumentPass::runOnModule()
+{
+    auto module = getOperation();
+
+    auto funcOps = llvm::to_vector<4>(llvm::make_filter_range(module.getOps<FuncOp>(), [](FuncOp funcOp) {
+        return funcOp->hasAttr(accera::ir::WorkspaceAPIAttrName) && !funcOp.isExternal();
+    }));
+    for (auto funcOp : funcOps)
+    {
+        if (failed(ConvertToWorkspaceAPI(funcOp)))
+        {
+            signalPassFailure();
+            return;
+        }
+    }
+}
+
+LogicalResult WorkspaceArgumentPass::ConvertToWorkspaceAPI(FuncOp funcOp)
+{
+    auto module = getOperation();
+    auto* context = &getContext();
+    auto loc = funcOp.getLoc();
+
+    auto functions = GetCalledFunctions(module, funcOp);
+
+    // Lay out the scratch buffers used by any of these functions back to back in the workspace
+    llvm::StringMap<int64_t> offsets;
+    llvm::SmallVector<memref::GlobalOp, 4> globalOps;
+    int64_t workspaceSize = 0;
+    for (auto function : functions)
+    {
+        auto result = function.walk([&](memref::GetGlobalOp getGlobalOp) {
+            auto globalOp = module.lookupSymbol<memref::GlobalOp>(getGlobalOp.name());
+            if (!globalOp || !globalOp->hasAttr(accera::ir::executionPlan::CacheBufferAttrName) || offsets.count(globalOp.sym_name()))
+            {
+                return WalkResult::advance();
+            }
+
+            auto type = globalOp.type().cast<MemRefType>();
+            if (!IsWorkspaceBufferType(type))
+            {
+                globalOp.emitError("cannot place this scratch buffer in the workspace of ") << funcOp.getName();
+                return WalkResult::interrupt();
+            }
+
+            workspaceSize = AlignUp(workspaceSize, WorkspaceAlignment);
+            offsets[globalOp.sym_name()] = workspaceSize;
+            workspaceSize += type.getSizeInBits() / 8;
+            globalOps.push_back(globalOp);
+            return WalkResult::advance();
+        });
+        if (result.wasInterrupted())
+        {
+            return failure();
+        }
+    }
+
+    // Other functions can still call the callees, so each callee is rewritten as a copy that takes the workspace
+    auto workspaceType = MemRefType::get({ workspaceSize }, IntegerType::get(context, 8));
+    SymbolTable symbolTable(module);
+    llvm::StringMap<FuncOp> workspaceFunctions;
+    for (auto callee : llvm::drop_begin(functions))
+    {
+        auto workspaceFunction = callee.clone();
+        workspaceFunction->removeAttr(accera::ir::WorkspaceAPIAttrName);
+        workspaceFunction.setName(callee.getName().str() + "_workspace");
+        workspaceFunction.setPrivate();
+        symbolTable.insert(workspaceFunction, std::next(Block::iterator(callee.getOperation())));
+        workspaceFunction.insertArgument(workspaceFunction.getNumArguments(), workspaceType, DictionaryAttr{});
+        workspaceFunctions[callee.getName()] = workspaceFunction;
+    }
+    funcOp.insertArgument(funcOp.getNumArguments(), workspaceType, DictionaryAttr{});
+
+    OpBuilder builder(context);
+    auto rewriteFunction = [&](FuncOp function) {
+        auto workspace = function.getArgument(function.getNumArguments() - 1);
+
+        llvm::SmallVector<CallOp, 4> callOps;
+        function.walk([&](CallOp callOp) {
+            if (workspaceFunctions.count(callOp.getCallee()))
+            {
+                callOps.push_back(callOp);
+            }
+        });
+        for (auto callOp : callOps)
+        {
+            builder.setInsertionPoint(callOp);
+            auto operands = llvm::to_vector<4>(callOp.getOperands());
+            operands.push_back(workspace);
+            auto newCallOp = builder.create<CallOp>(callOp.getLoc(), workspaceFunctions[callOp.getCallee()], operands);
+            callOp.replaceAllUsesWith(newCallOp.getResults());
+            callOp.erase();
+        }
+
+        llvm::SmallVector<memref::GetGlobalOp, 4> getGlobalOps;
+        function.walk([&](memref::GetGlobalOp getGlobalOp) {
+            if (offsets.count(getGlobalOp.name()))
+            {
+                getGlobalOps.push_back(getGlobalOp);
+            }
+        });
+        for (auto getGlobalOp : getGlobalOps)
+        {
+            builder.setInsertionPoint(getGlobalOp);
+            Value offset = builder.create<ConstantIndexOp>(getGlobalOp.getLoc(), offsets.lookup(getGlobalOp.name()));
+            Value view = builder.create<memref::ViewOp>(getGlobalOp.getLoc(), getGlobalOp.getType(), workspace, offset, ValueRange{});
+            getGlobalOp.replaceAllUsesWith(view);
+            getGlobalOp.erase();
+        }
+    };
+    rewriteFunction(funcOp);
+    for (auto& entry : workspaceFunctions)
+    {
+        rewriteFunction(entry.second);
+    }
+
+    // Drop the internal functions and static buffers that are no longer used by anything
+    for (auto callee : llvm::drop_begin(functions))
+    {
+        if (!callee.isPublic() && SymbolTable::symbolKnownUseEmpty(callee, module))
+        {
+            callee.erase();
+        }
+    }
+    for (auto globalOp : globalOps)
+    {
+        if (SymbolTable::symbolKnownUseEmpty(globalOp, module))
+        {
+            globalOp.erase();
+        }
+    }
+
+    // The workspace size is only known after lowering, so the caller queries it at runtime
+    builder.setInsertionPointAfter(funcOp);
+    auto sizeFuncType = builder.getFunctionType({}, { builder.getI64Type() });
+    auto sizeFuncOp = builder.create<FuncOp>(loc, funcOp.getName().str() + "_workspace_size", sizeFuncType);
+    sizeFuncOp->setAttr(accera::ir::RawPointerAPIAttrName, builder.getUnitAttr());
+
+    builder.setInsertionPointToStart(sizeFuncOp.addEntryBlock());
+    Value size = builder.create<ConstantIntOp>(loc, workspaceSize, builder.getI64Type());
+    builder.create<ReturnOp>(loc, size);
+
+    return success();
+}
+
+} // namespace
+
+namespace accera::transforms::value
+{
+std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>> createWorkspaceArgumentPass()
+{
+    return std::make_unique<WorkspaceArgumentPass>();
+}
+} // namespace accera::transforms::value
@@ -0,0 +1,215 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Exception.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace accera
+{
+namespace utilities
+{
+    /// <summary> A memory layout whose rank is known at compile time. It describes the same layouts as MemoryLayout
+    /// (size, extent and offset in logical dimensions, plus a dimension order), but it doesn't allocate and all of its
+    /// members are constexpr, so that offsets into layouts that are constant fold away entirely. </summary>
+    ///
+    /// <typeparam name="Rank"> The number of dimensions </typeparam>
+    template <size_t Rank>
+    class FixedMemoryLayout
+    {
+    public:
+        static_assert(Rank > 0, "FixedMemoryLayout requires at least one dimension");
+
+        using Shape = std::array<int64_t, Rank>;
+        using Order = std::array<int64_t, Rank>;
+
+        /// <summary> Constructor from size only (no padding), in the canonical order. </summary>
+        ///
+        /// <param name="size"> The shape of the active area of the memory region. </param>
+        constexpr FixedMemoryLayout(const Shape& size) :
+            FixedMemoryLayout(size, size, Shape{}, CanonicalOrder())
+        {}
+
+        /// <summary> Constructor from size and ordering (no padding). </summary>
+        ///
+        /// <param name="size"> The shape of the active area of the memory region, in logical dimensions. </param>
+        /// <param name="order"> The ordering of the logical dimensions in memory, outermost first. </param>
+        constexpr FixedMemoryLayout(const Shape& size, const Order& order) :
+            FixedMemoryLayout(size, size, Shape{}, order)
+        {}
+
+        /// <summary> General constructor. </summary>
+        ///
+        /// <param name="size"> The shape of the active area of the memory region, in logical dimensions. </param>
+        /// <param name="extent"> The extent of the allocated memory of the memory region. </param>
+        /// <param name="offset"> The offset into memory to the active area of the memory region. </param>
+        /// <param name="order"> The ordering of the logical dimensions in memory, outermost first. </param>
+        constexpr FixedMemoryLayout(const Shape& size, const Shape& extent, const Shape& offset, const Order& order = CanonicalOrder()) :
+            _size(size),
+            _extent(extent),
+            _offset(offset),
+            _increment(),
+            _order(order)
+        {
+            bool seen[Rank] = {};
+            for (size_t index = 0; index < Rank; ++index)
+            {
+                if (order[index] < 0 || order[index] >= static_cast<int64_t>(Rank) || seen[order[index]])
+                {
+                    throw InputException(InputExceptionErrors::invalidArgument, "Dimension order must be a valid permutation vector.");
+                }
+                seen[order[index]] = true;
+
+                if (size[index] + offset[index] > extent[index])
+                {
+                    throw InputException(InputExceptionErrors::invalidArgument, "Extent must be larger or equal to the size plus offset.");
+                }
+            }
+
+            int64_t scale = 1;
+            for (size_t index = Rank; index-- > 0;)
+            {
+                _increment[order[index]] = scale;
+                scale *= extent[order[index]];
+            }
+        }
+
+        /// <summary> Returns the number of dimensions in this memory layout </summary>
+        static constexpr size_t NumDimensions() { return Rank; }
+
+        /// <summary> Returns the number of active elements in this memory layout </summary>
+        constexpr int64_t NumElements() const
+        {
+            int64_t result = 1;
+            for (auto size : _size)
+            {
+                result *= size;
+            }
+            return result;
+        }
+
+        /// <summary> Returns the number of total (active plus extra extent) elements in this memory layout </summary>
+        constexpr int64_t GetMemorySize() const { return _extent[_order[0]] * _increment[_order[0]]; }
+
+        /// <summary> Returns the size of the active area for the given logical dimension </summary>
+        constexpr int64_t GetActiveSize(size_t index) const { return _size[index]; }
+
+        /// <summary> Returns the allocated size for the given logical dimension </summary>
+        constexpr int64_t GetExtent(size_t index) const { return _extent[index]; }
+
+        /// <summary> Returns the offset to the active area for the given logical dimension </summary>
+        constexpr int64_t GetOffset(size_t index) const { return _offset[index]; }
+
+        /// <summary> Returns the distance in memory between consecutive entries of the given logical dimension </summary>
+        constexpr int64_t GetIncrement(size_t index) const { return _increment[index]; }
+
+        /// <summary> Returns the logical dimension at the given position in memory, outermost first </summary>
+        constexpr int64_t GetLogicalDimension(size_t physicalDimension) const { return _order[physicalDimension]; }
+
+        /// <summary> Checks if the memory defined by this layout is in the canonical memory order (0, 1, 2, ...) </summary>
+        constexpr bool IsCanonicalOrder() const
+        {
+            for (size_t index = 0; index < Rank; ++index)
+            {
+                if (_order[index] != static_cast<int64_t>(index))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// <summary> Indicates if this layout has any extra padding </summary>
+        constexpr bool HasPadding() const
+        {
+            for (size_t index = 0; index < Rank; ++index)
+            {
+                if (_size[index] != _extent[index])
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /// <summary> Gets the offset into memory for an entry </summary>
+        ///
+        /// <param name="logicalCoordinates"> The logical coordinates of the entry </param>
+        /// <returns> The offset to the entry, in elements, from the beginning of memory </returns>
+        constexpr int64_t GetEntryOffset(const Shape& logicalCoordinates) const
+        {
+            int64_t result = 0;
+            for (size_t index = 0; index < Rank; ++index)
+            {
+                result += _increment[index] * (logicalCoordinates[index] + _offset[index]);
+            }
+            return result;
+        }
+
+        /// <summary> Gets the offset into memory for an entry </summary>
+        ///
+        /// <param name="indices"> The logical coordinates of the entry, one per dimension </param>
+        /// <returns> The offset to the entry, in elements, from the beginning of memory </returns>
+        template <typename... IndexType, std::enable_if_t<sizeof...(IndexType) == Rank && (std::is_integral_v<IndexType> && ...), int> = 0>
+        constexpr int64_t operator()(IndexType... indices) const
+        {
+            return GetEntryOffset(Shape{ static_cast<int64_t>(indices)... });
+        }
+
+        /// <summary> Gets the offset into memory for the first active entry </summary>
+        constexpr int64_t GetFirstEntryOffset() const { return GetEntryOffset(Shape{}); }
+
+        constexpr bool operator==(const FixedMemoryLayout& other) const
+        {
+            for (size_t index = 0; index < Rank; ++index)
+            {
+                if (_size[index] != other._size[index] || _extent[index] != other._extent[index] ||
+                    _offset[index] != other._offset[index] || _order[index] != other._order[index])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        constexpr bool operator!=(const FixedMemoryLayout& other) const { return !(*this == other); }
+
+        /// <summary> Returns the dimension order (0, 1, 2, ...) </summary>
+        static constexpr Order CanonicalOrder()
+        {
+            Order result{};
+            for (size_t index = 0; index < Rank; ++index)
+            {
+                result[index] = static_cast<int64_t>(index);
+            }
+            return result;
+        }
+
+        /// <summary> Returns the dimension order (Rank - 1, ..., 1, 0), which is column-major for 2D arrays </summary>
+        static constexpr Order ReversedOrder()
+        {
+            Order result{};
+            for (size_t index = 0; index < Rank; ++index)
+            {
+                result[index] = static_cast<int64_t>(Rank - 1 - index);
+            }
+            return result;
+        }
+
+    private:
+        Shape _size;
+        Shape _extent;
+        Shape _offset;
+        Shape _increment;
+        Order _order;
+    };
+
+} // namespace utilities
+} // namespace accera
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "FixedMemoryLayout.h"
 #include "FunctionUtils.h"
 #include "TypeTraits.h"
 
@@ -302,6 +303,12 @@ namespace utilities
             MemoryLayout(MemoryShape(sizes...))
         {}
 
+        /// <summary> Constructor from a layout whose rank is known at compile time. </summary>
+        ///
+        /// <param name="layout"> The layout </param>
+        template <size_t Rank>
+        MemoryLayout(const FixedMemoryLayout<Rank>& layout);
+
         /// <summary> General constructor. </summary>
         ///
         /// <param name="size"> The shape of the active area of the memory region (the first element is the size of
@@ -702,6 +709,29 @@ namespace utilities
         return GetEntryOffset(coords);
     }
 
+    namespace detail
+    {
+        template <size_t Rank, typename Getter>
+        std::vector<int64_t> FixedLayoutToVector(Getter&& get)
+        {
+            std::vector<int64_t> result(Rank);
+            for (size_t index = 0; index < Rank; ++index)
+            {
+                result[index] = get(index);
+            }
+            return result;
+        }
+    } // namespace detail
+
+    template <size_t Rank>
+    MemoryLayout::MemoryLayout(const FixedMemoryLayout<Rank>& layout) :
+        MemoryLayout(MemoryShape{ detail::FixedLayoutToVector<Rank>([&](size_t i) { return layout.GetActiveSize(i); }) },
+                     MemoryShape{ detail::FixedLayoutToVector<Rank>([&](size_t i) { return layout.GetExtent(i); }) },
+                     MemoryShape{ detail::FixedLayoutToVector<Rank>([&](size_t i) { return layout.GetOffset(i); }) },
+                     MemoryShape{ detail::FixedLayoutToVector<Rank>([&](size_t i) { return layout.GetIncrement(i); }) },
+                     DimensionOrder{ detail::FixedLayoutToVector<Rank>([&](size_t i) { return layout.GetLogicalDimension(i); }) })
+    {}
+
 } // namespace utilities
 } // namespace accera
 namespace std
@@ -0,0 +1,130 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "TunableParameters.h"
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace accera
+{
+namespace utilities
+{
+    /// <summary> A compiled candidate, which runs the function once each time it's called. </summary>
+    using TuningRunner = std::function<void()>;
+
+    /// <summary> Compiles a candidate, e.g. by JIT-compiling the module that was emitted for it. </summary>
+    using TuningCompiler = std::function<TuningRunner()>;
+
+    /// <summary> A point of the search space, the values of the tunable parameters by name. </summary>
+    using TuningValues = std::map<std::string, std::string>;
+
+    struct TuningCandidate
+    {
+        TuningValues values;
+        TuningCompiler compile;
+    };
+
+    struct TuningLatency
+    {
+        double minMs = 0;
+        double medianMs = 0;
+        double p99Ms = 0; // nearest-rank percentile
+    };
+
+    struct TuningCandidateResult
+    {
+        TuningValues values;
+        TuningLatency latency;
+        std::string error; // why the candidate couldn't be compiled or run, empty when it was timed
+    };
+
+    struct TuningReport
+    {
+        std::vector<TuningCandidateResult> candidates;
+        std::optional<size_t> best; // the candidate of the lowest median latency, unset if none could be timed
+    };
+
+    struct TunerOptions
+    {
+        int warmupIterations = 10; // untimed calls made before the timed ones
+        int iterations = 100; // timed calls, each one timed on its own
+        int numCompileThreads = 0; // threads that compile candidates, 0 for one per hardware thread
+
+        // When set, the winner is persisted to this file under the target and the function
+        std::string resultsPath;
+        std::string target; // e.g. the model of the target device
+        std::string function;
+    };
+
+    /// <summary> Times a function the way the benchmark harness of `Package.build` does. </summary>
+    TuningLatency MeasureLatency(const TuningRunner& run, int warmupIterations, int iterations);
+
+    /// <summary> Compiles the candidates in parallel, then times them one at a time so that they don't
+    /// disturb each other's timings. Candidates that throw while being compiled or run are reported with
+    /// their error and skipped. </summary>
+    TuningReport TuneCandidates(const std::vector<TuningCandidate>& candidates, const TunerOptions& options = {});
+
+    /// <summary> Tunes over the combinations of the parameters that the engine iterates over. The
+    /// `generate` callable is called once per combination, on the calling thread since the parameters hold the
+    /// combination, and returns the `TuningCompiler` of the candidate, which must not depend on the parameters.
+    /// For example,
+    /// ```
+    /// TunableParameter split = std::vector{ 4, 8, 16 }, unroll = std::vector{ 1, 2 };
+    /// TuningEngine engine(split, unroll);
+    /// auto report = Tune(engine, [&]() -> TuningCompiler {
+    ///     auto module = EmitCandidate(split, unroll);
+    ///     return [module] { return JitCompile(module); };
+    /// });
+    /// ```
+    /// </summary>
+    template <typename... Ts, typename Generate>
+    TuningReport Tune(TuningEngine<Ts...>& engine, Generate&& generate, const TunerOptions& options = {})
+    {
+        std::vector<TuningCandidate> candidates;
+        engine.Reset();
+        do
+        {
+            candidates.push_back({ engine.CurrentValues(), generate() });
+        } while (engine.Next());
+
+        return TuneCandidates(candidates, options);
+    }
+
+    struct TuningResult
+    {
+        TuningValues values;
+        double medianMs = 0;
+    };
+
+    /// <summary> The winners of previous tuning runs, keyed by target and function. </summary>
+    /// <remarks> The file has a line per winner with the target, the function, the median latency in ms and
+    /// the name=value pairs of the parameters, separated by tabs. </remarks>
+    class TuningResults
+    {
+    public:
+        /// <summary> Loads the results of a file, a missing file has no results. </summary>
+        static TuningResults Load(const std::string& path);
+
+        void Save(const std::string& path) const;
+
+        std::optional<TuningResult> Find(const std::string& target, const std::string& function) const;
+
+        /// <summary> Records a result, unless a faster one is already recorded. </summary>
+        /// <returns> Whether the result was recorded. </returns>
+        bool Update(const std::string& target, const std::string& function, const TuningResult& result);
+
+    private:
+        std::map<std::pair<std::string, std::string>, TuningResult> _results;
+    };
+} // namespace utilities
+} // namespace accera
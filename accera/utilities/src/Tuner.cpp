@@ -0,0 +1,228 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Tuner.h"
+#include "Exception.h"
+#include "Files.h"
+#include "StringUtil.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+namespace accera
+{
+namespace utilities
+{
+    namespace
+    {
+        std::string GetErrorMessage(std::exception_ptr error)
+        {
+            try
+            {
+                std::rethrow_exception(error);
+            }
+            catch (const std::exception& e)
+            {
+                return e.what();
+            }
+            catch (...)
+            {
+                return "unknown error";
+            }
+        }
+
+        std::string FormatValues(const TuningValues& values)
+        {
+            std::vector<std::string> pairs;
+            for (auto& [name, value] : values)
+            {
+                pairs.push_back(name + "=" + value);
+            }
+            return Join(pairs, ";");
+        }
+
+        TuningValues ParseValues(const std::string& s)
+        {
+            TuningValues values;
+            for (auto& pair : Split(s, ';'))
+            {
+                auto separator = pair.find('=');
+                if (separator != std::string::npos)
+                {
+                    values[pair.substr(0, separator)] = pair.substr(separator + 1);
+                }
+            }
+            return values;
+        }
+    } // namespace
+
+    TuningLatency MeasureLatency(const TuningRunner& run, int warmupIterations, int iterations)
+    {
+        if (iterations < 1)
+        {
+            throw InputException(InputExceptionErrors::invalidArgument, "iterations must be positive");
+        }
+
+        for (int i = 0; i < warmupIterations; ++i)
+        {
+            run();
+        }
+
+        std::vector<double> latencies(iterations);
+        for (auto& latency : latencies)
+        {
+            auto start = std::chrono::steady_clock::now();
+            run();
+            auto stop = std::chrono::steady_clock::now();
+            latency = std::chrono::duration<double, std::milli>(stop - start).count();
+        }
+        std::sort(latencies.begin(), latencies.end());
+
+        TuningLatency result;
+        result.minMs = latencies.front();
+        result.medianMs = iterations % 2 ? latencies[iterations / 2] : (latencies[iterations / 2 - 1] + latencies[iterations / 2]) / 2;
+        result.p99Ms = latencies[static_cast<size_t>(std::ceil(0.99 * iterations)) - 1];
+        return result;
+    }
+
+    TuningReport TuneCandidates(const std::vector<TuningCandidate>& candidates, const TunerOptions& options)
+    {
+        TuningReport report;
+        report.candidates.resize(candidates.size());
+        std::vector<TuningRunner> runners(candidates.size());
+
+        // Compilation is the expensive part of tuning and candidates compile independently
+        auto numThreads = options.numCompileThreads > 0 ? static_cast<size_t>(options.numCompileThreads) : std::max<size_t>(1, std::thread::hardware_concurrency());
+        numThreads = std::min(numThreads, candidates.size());
+        std::atomic<size_t> next = 0;
+        auto compile = [&] {
+            for (auto index = next++; index < candidates.size(); index = next++)
+            {
+                try
+                {
+                    runners[index] = candidates[index].compile();
+                }
+                catch (...)
+                {
+                    report.candidates[index].error = GetErrorMessage(std::current_exception());
+                }
+            }
+        };
+        std::vector<std::thread> threads;
+        for (size_t thread = 1; thread < numThreads; ++thread)
+        {
+            threads.emplace_back(compile);
+        }
+        compile();
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        for (size_t index = 0; index < candidates.size(); ++index)
+        {
+            auto& result = report.candidates[index];
+            result.values = candidates[index].values;
+            if (!result.error.empty())
+            {
+                continue;
+            }
+            if (!runners[index])
+            {
+                result.error = "the candidate was not compiled";
+                continue;
+            }
+
+            try
+            {
+                result.latency = MeasureLatency(runners[index], options.warmupIterations, options.iterations);
+            }
+            catch (...)
+            {
+                result.error = GetErrorMessage(std::current_exception());
+                continue;
+            }
+
+            if (!report.best || result.latency.medianMs < report.candidates[*report.best].latency.medianMs)
+            {
+                report.best = index;
+            }
+        }
+
+        if (report.best && !options.resultsPath.empty())
+        {
+            auto results = TuningResults::Load(options.resultsPath);
+            auto& best = report.candidates[*report.best];
+            if (results.Update(options.target, options.function, { best.values, best.latency.medianMs }))
+            {
+                results.Save(options.resultsPath);
+            }
+        }
+        return report;
+    }
+
+    TuningResults TuningResults::Load(const std::string& path)
+    {
+        TuningResults results;
+        if (!FileExists(path))
+        {
+            return results;
+        }
+
+        auto stream = OpenIfstream(path);
+        std::string line;
+        while (std::getline(stream, line))
+        {
+            auto fields = Split(line, '\t');
+            if (fields.size() != 4)
+            {
+                continue;
+            }
+            results._results[{ fields[0], fields[1] }] = { ParseValues(fields[3]), std::stod(fields[2]) };
+        }
+        return results;
+    }
+
+    void TuningResults::Save(const std::string& path) const
+    {
+        auto stream = OpenOfstream(path);
+        stream << std::setprecision(9);
+        for (auto& [key, result] : _results)
+        {
+            stream << key.first << '\t' << key.second << '\t' << result.medianMs << '\t' << FormatValues(result.values) << '\n';
+        }
+    }
+
+    std::optional<TuningResult> TuningResults::Find(const std::string& target, const std::string& function) const
+    {
+        auto it = _results.find({ target, function });
+        if (it == _results.end())
+        {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    bool TuningResults::Update(const std::string& target, const std::string& function, const TuningResult& result)
+    {
+        auto [it, inserted] = _results.try_emplace({ target, function }, result);
+        if (!inserted)
+        {
+            if (it->second.medianMs <= result.medianMs)
+            {
+                return false;
+            }
+            it->second = result;
+        }
+        return true;
+    }
+} // namespace utilities
+} // namespace accera
@@ -374,4 +374,37 @@ TEST_CASE("TestInflateNullMemoryLayout")
         CHECK(layout3.GetDimensionOrder() == DimensionOrder{ 0, 1 });
     }
 }
+
+TEST_CASE("TestFixedMemoryLayout")
+{
+    constexpr FixedMemoryLayout<2> rowMajor({ 4, 8 });
+    constexpr FixedMemoryLayout<2> columnMajor({ 4, 8 }, FixedMemoryLayout<2>::ReversedOrder());
+    constexpr FixedMemoryLayout<3> padded({ 2, 3, 4 }, { 3, 4, 6 }, { 1, 0, 2 });
+
+    static_assert(rowMajor(1, 2) == 10);
+    static_assert(columnMajor(1, 2) == 9);
+    static_assert(padded.GetFirstEntryOffset() == 26);
+    static_assert(padded.GetMemorySize() == 72);
+    static_assert(padded.HasPadding() && !rowMajor.HasPadding());
+    static_assert(!columnMajor.IsCanonicalOrder());
+
+    SECTION("Matches MemoryLayout")
+    {
+        MemoryLayout layout(padded);
+        CHECK(layout == MemoryLayout(MemoryShape{ 2, 3, 4 }, MemoryShape{ 3, 4, 6 }, MemoryShape{ 1, 0, 2 }));
+        CHECK(MemoryLayout(columnMajor) == MemoryLayout(MemoryShape{ 4, 8 }, DimensionOrder{ 1, 0 }));
+        for (int64_t i = 0; i < 2; ++i)
+            for (int64_t j = 0; j < 3; ++j)
+                for (int64_t k = 0; k < 4; ++k)
+                {
+                    CHECK(padded(i, j, k) == layout.GetEntryOffset({ i, j, k }));
+                }
+    }
+
+    SECTION("Invalid layouts")
+    {
+        CHECK_THROWS_AS(FixedMemoryLayout<2>({ 4, 8 }, { 0, 0 }), InputException);
+        CHECK_THROWS_AS(FixedMemoryLayout<2>({ 4, 8 }, { 4, 4 }, { 0, 0 }), InputException);
+    }
+}
 } // namespace accera
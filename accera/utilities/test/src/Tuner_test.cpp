@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include <utilities/include/Tuner.h>
+
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace accera
+{
+
+using namespace utilities;
+
+TEST_CASE("Tuner_test1")
+{
+    TunableParameter delay{ std::vector{ 3, 1, 2 }, "delay" };
+    TunableParameter fail{ std::vector{ 0, 1 }, "fail" };
+    TuningEngine engine(delay, fail);
+
+    TunerOptions options;
+    options.warmupIterations = 1;
+    options.iterations = 3;
+    auto generate = [&]() -> TuningCompiler {
+        int delayMs = delay;
+        bool shouldFail = static_cast<int>(fail) != 0;
+        return [=]() -> TuningRunner {
+            if (shouldFail)
+            {
+                throw std::runtime_error("compilation failed");
+            }
+            return [=] { std::this_thread::sleep_for(std::chrono::milliseconds(delayMs)); };
+        };
+    };
+    auto report = Tune(engine, generate, options);
+
+    REQUIRE(report.candidates.size() == 6);
+    REQUIRE(report.best.has_value());
+    CHECK(report.candidates[*report.best].values.at("delay") == "1");
+    CHECK(report.candidates[*report.best].values.at("fail") == "0");
+    for (auto& candidate : report.candidates)
+    {
+        CHECK(candidate.error.empty() == (candidate.values.at("fail") == "0"));
+    }
+}
+
+TEST_CASE("Tuner_test2")
+{
+    auto path = std::string("Tuner_test2_results.txt");
+    std::remove(path.c_str());
+
+    TuningResults results;
+    CHECK(results.Update("target", "fn", { { { "m", "4" }, { "n", "8" } }, 2.0 }));
+    CHECK_FALSE(results.Update("target", "fn", { { { "m", "2" } }, 3.0 }));
+    CHECK(results.Update("other_target", "fn", { { { "m", "2" } }, 3.0 }));
+    results.Save(path);
+
+    auto loaded = TuningResults::Load(path);
+    auto result = loaded.Find("target", "fn");
+    REQUIRE(result.has_value());
+    CHECK(result->medianMs == 2.0);
+    CHECK(result->values == TuningValues{ { "m", "4" }, { "n", "8" } });
+    CHECK(loaded.Find("other_target", "fn")->values == TuningValues{ { "m", "2" } });
+    CHECK_FALSE(loaded.Find("target", "other_fn").has_value());
+
+    std::remove(path.c_str());
+}
+
+} // namespace accera
@@ -74,7 +74,7 @@ namespace value
         /// <param name="slicedDimensions"> The dimensions to remove from the domain. </param>
         /// <param name="sliceOffsets"> The index of the slice to keep for each of the sliced dimensions. </param>
         /// <returns> The resulting slice of the array </returns>
-        Array Slice(std::vector<int64_t> slicedDimensions, std::vector<Scalar> sliceOffsets) const;
+        Array Slice(const std::vector<int64_t>& slicedDimensions, const std::vector<Scalar>& sliceOffsets) const;
 
 // TODO: Enable when functionality is needed and semantics are fully cleared
 #if 0
@@ -20,9 +20,36 @@ namespace value
     Scalar VectorMax(Array v);
     Scalar VectorSum(Array v);
 
+    /// <summary> Returns the entry of a table of 256 8-bit integers at an 8-bit index, which is read as unsigned, so that
+    /// every index has an entry. In vectorized loops, the entries of a whole vector of indices are selected at once with
+    /// the lookup instructions of the target. </summary>
+    Scalar TableLookup(Array table, Scalar index);
+
     void ClearMatrix(Array A);
     void TransposeMatrix(Array A, Array B);
 
+    /// <summary> The accumulator tile of a register-blocked matrix multiplication microkernel </summary>
+    struct MatMulMicrokernelShape
+    {
+        /// <summary> The number of rows of the tile, whose elements of A are broadcast every reduction step </summary>
+        int rows;
+        /// <summary> The number of columns of the tile, a multiple of the vector size </summary>
+        int columns;
+        /// <summary> The number of elements in a vector register </summary>
+        int vectorSize;
+    };
+
+    /// <summary> Picks the largest accumulator tile of a broadcast-FMA outer-product microkernel that fits in the vector registers </summary>
+    /// <param name="vectorBytes"> The size of a vector register, in bytes </param>
+    /// <param name="vectorRegisters"> The number of vector registers </param>
+    /// <param name="elementBytes"> The size of the matrix elements, in bytes </param>
+    /// <param name="M"> If positive, the tile has at most this many rows </param>
+    /// <param name="N"> If positive, the tile has at most this many columns, unless a single vector is wider </param>
+    /// <remarks> The accumulators, one vector of B per tile column vector and one broadcast element of A have to fit in the
+    /// registers together. Of the tiles that are limited by FMA throughput rather than by their loads, the one with the most
+    /// accumulators is picked, preferring taller tiles on ties. </remarks>
+    MatMulMicrokernelShape GetMatMulMicrokernelShape(int vectorBytes, int vectorRegisters, int elementBytes, int M = 0, int N = 0);
+
     void MatMulBasic(Array A, Array B, Array C, bool clearC = true);
     void MatMulSimpleTiled(Array A, Array B, Array C, bool clearC = true);
     void MatMulMlas(Array A, Array B, Array C, bool clearC = true);
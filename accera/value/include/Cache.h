@@ -18,6 +18,7 @@
 #include <ir/include/value/ValueEnums.h>
 
 #include <memory>
+#include <optional>
 #include <variant>
 #include <vector>
 
@@ -100,7 +101,8 @@ namespace value
               ViewAdapter constantData,
               const std::string& wrapperFnName,
               const std::string& packedBufferName,
-              CacheIndexing mapping = CacheIndexing::GlobalToPhysical);
+              CacheIndexing mapping = CacheIndexing::GlobalToPhysical,
+              bool mapFromFile = false);
 
         Cache(const Cache&) = delete;
         Cache(Cache&&) noexcept;
@@ -110,6 +112,41 @@ namespace value
 
         Value GetBaseValue();
 
+        // Copies the cache data in and out with all the threads of the parallel loop that uses the cache
+        void SetCooperativeCopy();
+
+        // Prefetches the active block the cache copy reads the given number of trigger loop iterations ahead
+        void SetPrefetchDistance(int64_t distance);
+
+        // Pads the innermost dimension of the cache buffer with the given number of elements
+        void SetPadding(int64_t padding);
+
+        // Pads the innermost dimension of the cache buffer when its rows would map onto the same cache sets or memory banks
+        void SetAutomaticPadding();
+
+        // Stores the cache buffer as contiguous panels of panelSize elements of the given dimension, e.g. the packed A and B panels of a GEMM microkernel
+        void SetPanelLayout(int64_t dimension, int64_t panelSize);
+
+        // Writes the cache data back to the array with non-temporal stores that bypass the hardware caches
+        void SetNonTemporalWriteBack();
+
+        // Holds the cache buffer in the registers of each GPU thread: the max element budget of the cache is the registers available to the thread, and a cache that would exceed it isn't created
+        void SetRegisterCache();
+
+        // Stores the cache buffer as the given element type, e.g. float16 for a float32 array. The elements are converted when the cache is filled and converted back when it is written back or reduced into the array
+        void SetElementType(ValueType type);
+
+        // The epilogue steps that are applied in order to each element of an accumulated output when the cache is reduced back into the array
+
+        // Adds the element of the rank-1 bias array at the position of the output's given dimension
+        void AddEpilogueBias(ViewAdapter bias, int64_t dimension);
+
+        // Multiplies by a constant
+        void AddEpilogueScale(double scale);
+
+        // Clamps to the given bounds, e.g. a ReLU is a clamp with a minimum of 0 and no maximum
+        void AddEpilogueClamp(std::optional<double> min, std::optional<double> max);
+
     private:
         std::unique_ptr<CacheImpl> _impl;
     };
@@ -79,6 +79,12 @@ namespace value
         /// <summary> The byte alignment to use for global values. </summary>
         unsigned globalValueAlignment = 32;
 
+        /// <summary> The size in bytes from which static buffers are backed by huge pages, or 0 to only use huge pages for allocations that request them. </summary>
+        int64_t hugePageThreshold = 0;
+
+        /// <summary> Release the emittables of the values of a loop or kernel body once the body is emitted, and reuse the emittable of a value that is emitted again, which bounds the memory of emitting very large nests. Values defined in such a body must not be used after it. </summary>
+        bool streamingEmission = false;
+
         /// <summary> Whether to bare pointer style declarations for defined functions. </summary>
         bool useBarePtrCallConv = false;
 
@@ -8,12 +8,14 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 
 #include <mlir/IR/Builders.h>
 #include <mlir/IR/Location.h>
 
 #include "Array.h"
+#include "VectorizationInformation.h"
 
 #define GET_LOCATION() \
     FileLocation { __FILE__, __LINE__ }
@@ -40,7 +42,13 @@ namespace value
         std::unique_ptr<LocationGuardImpl> _impl;
     };
 
-    void CheckAllClose(Array actual, Array desired, float tolerance);
+    /// <summary> Prints whether two arrays are equal up to a tolerance, and their differences if they are not </summary>
+    /// <param name="numThreads"> The number of threads that compare the slices along the outermost dimension </param>
+    /// <param name="vectorizationInfo"> How to vectorize the comparison along the innermost dimension, if at all </param>
+    void CheckAllClose(Array actual, Array desired, float tolerance, int64_t numThreads = 1, const std::optional<VectorizationInformation>& vectorizationInfo = std::nullopt);
+
+    /// <summary> Copies the slices of an array along a dimension whose index is not a multiple of a stride </summary>
+    void CopyUnsampledSlices(Array source, Array destination, int64_t dimension, int64_t stride);
 
 } // namespace value
 
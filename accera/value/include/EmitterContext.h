@@ -10,6 +10,7 @@
 #include "Scalar.h"
 #include "Value.h"
 #include "ValueType.h"
+#include "VectorizationInformation.h"
 
 #include <value/include/CompilerOptions.h>
 
@@ -45,9 +46,35 @@ namespace value
         None = 0,
         ThreadLocal = 1 << 0,
         Stack = 1 << 1,
+        HugePages = 1 << 2,
     };
     ACCERA_DEFINE_ENUM_FLAG_OPERATORS(AllocateFlags);
 
+    /// <summary> The number of objects that an emitter context keeps alive for what it has emitted </summary>
+    struct EmitterStats
+    {
+        /// <summary> The emittables of the values of the functions that are being emitted </summary>
+        size_t localEmittables = 0;
+
+        /// <summary> The most local emittables that were alive at once </summary>
+        size_t peakLocalEmittables = 0;
+
+        /// <summary> The local emittables that were released when the function, loop or kernel body they belong to was emitted </summary>
+        size_t releasedLocalEmittables = 0;
+
+        /// <summary> The times a value reused the local emittable of a value that was already emitted </summary>
+        size_t reusedLocalEmittables = 0;
+
+        /// <summary> The emittables of the global buffers </summary>
+        size_t globalEmittables = 0;
+
+        /// <summary> The scopes that own the local emittables, one per function, loop or kernel body being emitted </summary>
+        size_t emittableScopes = 0;
+
+        /// <summary> The functions that were defined, which are kept to be called </summary>
+        size_t definedFunctions = 0;
+    };
+
     /// <summary> An interface describing the global context that's used by the Value library </summary>
     /// <remarks> This class employs the non-virtual interface pattern to provide an easy to use API while
     /// minimizing the functions needed to be overloaded. </remarks>
@@ -230,7 +257,7 @@ namespace value
         /// <param name="layout"> The layout used to describe the iteration characteristics. Only active elements are iterated over </param>
         /// <param name="fn"> The function to be called for each coordinate where there is an active element </param>
         /// <param name="name"> Optional, a name that can be used by the emitter context to tag this loop in the emitted code </param>
-        void For(MemoryLayout layout, std::function<void(std::vector<Scalar>)> fn, const std::string& name = "");
+        void For(MemoryLayout layout, std::function<void(const std::vector<Scalar>&)> fn, const std::string& name = "");
 
         /// <summary> Creates a for loop beggining at `start`, ending at `stop`, and incrementing by `step` </summary>
         /// <param name="start"> The value used to initialize the loop counter </param>
@@ -267,7 +294,7 @@ namespace value
         /// <param name="sliceOffsets"> The index of the slice to keep for each of the sliced dimensions. </param>
         /// <returns> A Value instance that refers to the sliced portion of the input </returns>
         /// <remarks> source must be constrained </remarks>
-        Value Slice(Value source, std::vector<int64_t> slicedDimensions, std::vector<Scalar> sliceOffsets);
+        Value Slice(Value source, const std::vector<int64_t>& slicedDimensions, const std::vector<Scalar>& sliceOffsets);
 
         /// <summary> Get a view of a memory buffer where 2 (contiguous) dimensions are merged </summary>
         /// <param name="source"> The source location </param>
@@ -339,9 +366,17 @@ namespace value
         /// <returns> The result destination mfma matrix </returns>
         Matrix MFMACompute(Matrix A, Matrix B, Matrix C); 
 
-        Scalar Max(Vector input);
+        /// <summary> Returns the largest element of a vector </summary>
+        /// <param name="input"> The vector to reduce </param>
+        /// <param name="vectorizationInfo"> If set, the reduction is vectorized for the given vector size and registers </param>
+        /// <param name="accumulators"> The number of independent vector accumulators of a vectorized reduction, 0 for half of the vector registers </param>
+        Scalar Max(Vector input, const std::optional<VectorizationInformation>& vectorizationInfo = std::nullopt, int64_t accumulators = 0);
 
-        Scalar Sum(Vector input);
+        /// <summary> Returns the sum of the elements of a vector </summary>
+        /// <param name="input"> The vector to reduce </param>
+        /// <param name="vectorizationInfo"> If set, the reduction is vectorized for the given vector size and registers </param>
+        /// <param name="accumulators"> The number of independent vector accumulators of a vectorized reduction, 0 for half of the vector registers </param>
+        Scalar Sum(Vector input, const std::optional<VectorizationInformation>& vectorizationInfo = std::nullopt, int64_t accumulators = 0);
 
         Scalar Cast(Scalar value, ValueType type);
 
@@ -400,6 +435,9 @@ namespace value
         [[nodiscard]] const CompilerOptions& GetCompilerOptions() const { return _compilerOptions; }
         [[nodiscard]] const TargetDevice& GetTargetDevice() const { return _compilerOptions.targetDevice; }
 
+        /// <summary> Gets the number of objects that the context keeps alive for what it has emitted </summary>
+        [[nodiscard]] EmitterStats GetStats() const;
+
         /// <summary> Set the MemoryLayout for the Value instance </summary>
         /// <param name="v"> The Value instance to update </param>
         /// <param name="l"> The MemoryLayout to be set on the Value instance </param>
@@ -412,6 +450,7 @@ namespace value
         virtual ViewAdapter ReduceN(Scalar begin, Scalar end, Scalar increment, std::vector<ViewAdapter> initArgs, std::function<ViewAdapter(Scalar, std::vector<ViewAdapter>)>) = 0;
         virtual ViewAdapter Reduce(Array a, std::vector<ViewAdapter> initArgs, std::function<ViewAdapter(ViewAdapter, std::vector<ViewAdapter>)>) = 0;
         virtual ViewAdapter MapReduce(Array a, std::vector<ViewAdapter> initArgs, std::function<ViewAdapter(ViewAdapter)> mapFn, std::function<ViewAdapter(ViewAdapter, std::vector<ViewAdapter>)> reduceFn) = 0;
+        virtual std::vector<ViewAdapter> MultiReduce(Array a, std::vector<ViewAdapter> initArgs, std::function<std::vector<ViewAdapter>(ViewAdapter, std::vector<ViewAdapter>)> reduceFn, std::function<std::vector<ViewAdapter>(std::vector<ViewAdapter>, std::vector<ViewAdapter>)> combineFn, int64_t lanes) = 0;
 
         virtual void ReturnValue(ViewAdapter view) = 0;
 
@@ -442,7 +481,7 @@ namespace value
         virtual Value StoreConstantDataImpl(ConstantData data, MemoryLayout layout, const std::string& name) = 0;
         virtual Value ResolveConstantDataReferenceImpl(Value constantDataSource) = 0;
 
-        virtual void ForImpl(MemoryLayout layout, std::function<void(std::vector<Scalar>)> fn, const std::string& name) = 0;
+        virtual void ForImpl(const MemoryLayout& layout, std::function<void(const std::vector<Scalar>&)> fn, const std::string& name) = 0;
         virtual void ForImpl(Scalar start, Scalar stop, Scalar step, std::function<void(Scalar)> fn, const std::string& name) = 0;
 
         virtual void MoveDataImpl(Value& source, Value& destination) = 0;
@@ -451,7 +490,7 @@ namespace value
 
         virtual Value ViewImpl(Value source, const std::vector<Scalar>& offsets, const utilities::MemoryShape& newShape, const std::vector<int64_t>& strides) = 0;
 
-        virtual Value SliceImpl(Value source, std::vector<int64_t> slicedDimensions, std::vector<Scalar> sliceOffsets) = 0;
+        virtual Value SliceImpl(Value source, const std::vector<int64_t>& slicedDimensions, const std::vector<Scalar>& sliceOffsets) = 0;
 
         virtual Value MergeDimensionsImpl(Value source, int64_t dim1, int64_t dim2) = 0;
 
@@ -473,9 +512,9 @@ namespace value
 
         virtual Matrix MFMAComputeImpl(Matrix A, Matrix B, Matrix C) = 0;
 
-        virtual Scalar MaxImpl(Vector input) = 0;
+        virtual Scalar MaxImpl(Vector input, const std::optional<VectorizationInformation>& vectorizationInfo, int64_t accumulators) = 0;
 
-        virtual Scalar SumImpl(Vector input) = 0;
+        virtual Scalar SumImpl(Vector input, const std::optional<VectorizationInformation>& vectorizationInfo, int64_t accumulators) = 0;
 
         virtual Scalar CastImpl(Scalar value, ValueType type) = 0;
 
@@ -508,6 +547,8 @@ namespace value
 
         virtual void ImportCodeFileImpl(std::string filename) = 0;
 
+        virtual EmitterStats GetStatsImpl() const { return {}; }
+
         friend void swap(EmitterContext&, EmitterContext&) noexcept;
 
         CompilerOptions _compilerOptions;
@@ -776,7 +817,7 @@ namespace value
     void ForRange(Scalar start, Scalar end, std::function<void(Scalar)> fn);
     void ForRange(Scalar start, Scalar end, Scalar step, std::function<void(Scalar)> fn);
 
-    void ForRanges(std::vector<Scalar> range_ends, std::function<void(std::vector<Scalar>)> fn);
+    void ForRanges(const std::vector<Scalar>& range_ends, std::function<void(const std::vector<Scalar>&)> fn);
 
     Matrix MFMALoad(Value source, const std::vector<int64_t> & shape, const std::string & operand);
     void MFMAStore(Matrix source, Value target);
@@ -935,6 +976,15 @@ namespace value
             .GetValue();
     }
 
+    /// <summary> Reduces a vector into several values in a single pass over it, like the sum and sum of squares of a row </summary>
+    /// <param name="a"> The vector to reduce </param>
+    /// <param name="init"> The initial values, which must be the identities of the reduction </param>
+    /// <param name="reduceFn"> Returns the new values from an element and the values so far </param>
+    /// <param name="combineFn"> Returns the values of two partial reductions combined </param>
+    /// <param name="lanes"> The number of interleaved partial reductions that the vector is reduced in, so that the reduction can be vectorized </param>
+    /// <returns> The reduced values, in the order of the initial values </returns>
+    std::vector<Scalar> MultiReduce(const Array& a, std::vector<Scalar> init, std::function<std::vector<Scalar>(Scalar, std::vector<Scalar>)> reduceFn, std::function<std::vector<Scalar>(std::vector<Scalar>, std::vector<Scalar>)> combineFn, int64_t lanes = 8);
+
     inline void Return(ViewAdapter view = {}) { GetContext().ReturnValue(view); }
 
     inline Scalar GetTime() { return GetContext().GetTime(); }
@@ -12,8 +12,39 @@ namespace value
 {
     class Scalar;
 
+    /// <summary> The accuracy levels of the fast math functions </summary>
+    enum class FastMathAccuracy
+    {
+        /// <summary> Lower degree approximations, accurate to about 1e-4, for activations that tolerate float16 precision </summary>
+        Low,
+        /// <summary> Approximations accurate to within a few float32 ulps over the whole range </summary>
+        High
+    };
+
     Scalar FastExp(Scalar s);
     Scalar FastExpMlas(Scalar s);
 
+    // The following functions are built from vectorizable arithmetic, compare and select ops, so that they are lowered inline
+    // and vectorized with the loops that use them. float16 inputs are evaluated in float32.
+
+    /// <summary> Approximates exp(s) </summary>
+    Scalar FastExp(Scalar s, FastMathAccuracy accuracy);
+
+    /// <summary> Approximates the natural logarithm of s </summary>
+    Scalar FastLog(Scalar s, FastMathAccuracy accuracy = FastMathAccuracy::High);
+
+    /// <summary> Approximates tanh(s) </summary>
+    Scalar FastTanh(Scalar s, FastMathAccuracy accuracy = FastMathAccuracy::High);
+
+    /// <summary> Approximates the logistic sigmoid 1 / (1 + exp(-s)) </summary>
+    Scalar FastSigmoid(Scalar s, FastMathAccuracy accuracy = FastMathAccuracy::High);
+
+    /// <summary> Approximates the error function erf(s) </summary>
+    Scalar FastErf(Scalar s, FastMathAccuracy accuracy = FastMathAccuracy::High);
+
+    /// <summary> Approximates the GELU activation s * (1 + erf(s / sqrt(2))) / 2 </summary>
+    /// <remarks> The Low accuracy level uses the tanh form of GELU </remarks>
+    Scalar FastGelu(Scalar s, FastMathAccuracy accuracy = FastMathAccuracy::High);
+
 } // namespace value
 } // namespace accera
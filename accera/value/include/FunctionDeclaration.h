@@ -30,7 +30,8 @@ namespace value
     {
         defaultInline,
         always,
-        never
+        never,
+        automatic // inlined only where the compiler's heuristic finds it worthwhile
     };
 
     /// <summary> Helper enum to indicate the usage of a parameter </summary>
@@ -99,6 +100,26 @@ namespace value
         /// <param name="rawPointerAPI"> True if the raw pointer API should be emitted. </param>
         FunctionDeclaration& RawPointerAPI(bool rawPointerAPI);
 
+        /// <summary> Sets whether this function should also emit an asynchronous API that returns a completion handle. </summary>
+        /// <param name="asyncAPI"> True if the asynchronous API should be emitted. </param>
+        FunctionDeclaration& AsyncAPI(bool asyncAPI);
+
+        /// <summary> Sets whether the caches of this function write their data back with non-temporal stores. </summary>
+        /// <param name="nonTemporalWriteBack"> True if the cache write-backs should bypass the hardware caches. </param>
+        FunctionDeclaration& NonTemporalWriteBack(bool nonTemporalWriteBack);
+
+        /// <summary> Sets whether the scratch buffers of this function are placed in a caller-provided workspace argument. </summary>
+        /// <param name="workspaceAPI"> True if the function should take a workspace argument instead of using static buffers. </param>
+        FunctionDeclaration& WorkspaceAPI(bool workspaceAPI);
+
+        /// <summary> Sets whether the callers of this function guarantee that the data of its array arguments don't overlap. </summary>
+        /// <param name="noAlias"> True if the array arguments can be assumed not to alias each other. </param>
+        FunctionDeclaration& NoAlias(bool noAlias);
+
+        /// <summary> Sets whether the kernels that this function launches are captured into a CUDA/HIP graph on the first call and replayed by the next calls. </summary>
+        /// <param name="gpuGraph"> True if the launches of the function should be replayed from a graph. </param>
+        FunctionDeclaration& GPUGraph(bool gpuGraph);
+
         /// <summary> A tag to add to a function as an attribute. </summary>
         /// <param name="tag"> The tag to add to the function. </param>
         FunctionDeclaration& AddTag(const std::string& tag);
@@ -107,6 +128,19 @@ namespace value
         /// <param name="baseName"> The base name. </param>
         FunctionDeclaration& BaseName(const std::string& baseName);
 
+        /// <summary> Sets the LLVM target CPU and target features that the code of this function is compiled for, instead of those of the module. </summary>
+        /// <param name="cpu"> The LLVM CPU name, e.g. "skylake-avx512". </param>
+        /// <param name="features"> The LLVM features string, e.g. "+avx512f,+avx512dq", or empty for the features of the CPU. </param>
+        FunctionDeclaration& TargetCPU(const std::string& cpu, const std::string& features);
+
+        /// <summary> Sets the byte alignment that the callers of this function guarantee for the data of each of its array parameters. </summary>
+        /// <param name="alignments"> The alignment of each parameter, a power of two, or 0 for a parameter without a guarantee. </param>
+        FunctionDeclaration& ParameterAlignments(const std::vector<int64_t>& alignments);
+
+        /// <summary> Sets the constant values that this function is specialized for, which the code of the function assumes for its single-element parameters. </summary>
+        /// <param name="values"> The value of each parameter, or empty for a parameter that is not specialized. </param>
+        FunctionDeclaration& SpecializedArguments(const std::vector<std::optional<double>>& values);
+
         /// <summary> Specifies a function definition for this declaration </summary>
         /// <param name="fn"> A function object that takes zero or more Value library observer types and returns void or a Value library observer type.
         /// This function object defines this function. </param>
@@ -192,10 +226,28 @@ namespace value
 
         [[nodiscard]] bool UseRawPointerAPI() const { return _rawPointerAPI; }
 
+        [[nodiscard]] bool EmitsAsyncAPI() const { return _asyncAPI; }
+
+        [[nodiscard]] bool UsesNonTemporalWriteBack() const { return _nonTemporalWriteBack; }
+
+        [[nodiscard]] bool HasNoAliasArguments() const { return _noAlias; }
+
+        [[nodiscard]] bool UsesWorkspaceAPI() const { return _workspaceAPI; }
+
+        [[nodiscard]] bool CapturesGPUGraph() const { return _gpuGraph; }
+
         [[nodiscard]] std::vector<std::string> GetTags() const { return _tags; }
 
         [[nodiscard]] std::string GetBaseName() const { return _baseName; }
 
+        [[nodiscard]] std::string GetTargetCPU() const { return _targetCPU; }
+
+        [[nodiscard]] std::string GetTargetFeatures() const { return _targetFeatures; }
+
+        [[nodiscard]] std::vector<int64_t> GetParameterAlignments() const { return _paramAlignments; }
+
+        [[nodiscard]] std::vector<std::optional<double>> GetSpecializedArguments() const { return _specializedArgs; }
+
         static std::string GetTemporaryFunctionPointerPrefix() { return "__ACCERA_TEMPORARY__"; }
 
     private:
@@ -234,8 +286,17 @@ namespace value
         bool _emitCWrapper = false;
         bool _emitHeaderDecl = false;
         bool _rawPointerAPI = false;
+        bool _asyncAPI = false;
+        bool _nonTemporalWriteBack = false;
+        bool _noAlias = false;
+        bool _workspaceAPI = false;
+        bool _gpuGraph = false;
         std::vector<std::string> _tags;
         std::string _baseName;
+        std::string _targetCPU;
+        std::string _targetFeatures;
+        std::vector<int64_t> _paramAlignments;
+        std::vector<std::optional<double>> _specializedArgs;
     };
 
     [[nodiscard]] FunctionDeclaration DeclareFunction(std::string name);
@@ -10,6 +10,8 @@
 #include <forward_list>
 #include <functional>
 #include <iostream>
+#include <list>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <numeric>
@@ -32,6 +34,7 @@
 namespace mlir
 {
 class ModuleOp;
+class Operation;
 class Value;
 } // namespace mlir
 
@@ -93,13 +96,27 @@ namespace value
 
         void writeHeader(std::optional<std::string> filename = std::nullopt) const;
 
+        /// <summary> Writes the data of the packed buffers that are memory-mapped at runtime to their files </summary>
+        /// <param name="directory"> The directory the library is deployed to, the generated code maps the files from there </param>
+        void writeMappedBuffers(const std::string& directory) const;
+
         void setMetadata(const std::string& key, const accera::ir::MetadataValueType& value);
         accera::ir::Metadata getFullMetadata();
 
         void setDataLayout(const CompilerOptions& options);
 
+        void setExecutionRuntime(ExecutionRuntime runtime);
+
         void setDebugMode(bool enable);
-        void EmitDebugFunction(const std::string& functionName, const std::vector<std::string>& utilityFunctionNames);
+
+        void setHugePageThreshold(int64_t threshold);
+        /// <summary> Replaces a function with one that also runs the default schedule of its nest and checks the results against it </summary>
+        /// <param name="functionName"> The base name of the function </param>
+        /// <param name="utilityFunctionNames"> The functions that check each INPUT_OUTPUT argument </param>
+        /// <param name="numThreads"> The number of threads that run the outermost loop of the reference, if its iterations are independent </param>
+        /// <param name="vectorizationInfo"> How to vectorize the innermost loop of the reference, if its iterations are independent </param>
+        /// <param name="sampleStride"> Computes and checks only every sampleStride-th iteration of the outermost loop of the reference, if its iterations are independent </param>
+        void EmitDebugFunction(const std::string& functionName, const std::vector<std::string>& utilityFunctionNames, int64_t numThreads = 1, const std::optional<VectorizationInformation>& vectorizationInfo = std::nullopt, int64_t sampleStride = 1);
 
         struct EmittableInfo
         {
@@ -116,6 +133,10 @@ namespace value
 
         mlir::OpBuilder& GetOpBuilder();
 
+        /// <summary> Emits the body of an op whose values aren't used outside of it, e.g. a loop or a kernel </summary>
+        /// <remarks> In streaming emission, the emittables of the values that the body defines are released once it's emitted </remarks>
+        void EmitScopedBody(mlir::Operation* scopeOp, std::function<void()> fn);
+
     private:
         void SetLayoutImpl(Value&, const MemoryLayout&) override;
 
@@ -135,7 +156,7 @@ namespace value
         Value StoreConstantDataImpl(ConstantData data, MemoryLayout layout, const std::string& name) override;
         Value ResolveConstantDataReferenceImpl(Value constantDataSource) override;
 
-        void ForImpl(MemoryLayout layout, std::function<void(std::vector<Scalar>)> fn, const std::string& name) override;
+        void ForImpl(const MemoryLayout& layout, std::function<void(const std::vector<Scalar>&)> fn, const std::string& name) override;
         void ForImpl(Scalar start, Scalar stop, Scalar step, std::function<void(Scalar)> fn, const std::string& name) override;
 
         ViewAdapter ReduceN(Scalar begin, Scalar end, Scalar increment, std::vector<ViewAdapter> initArgs, std::function<ViewAdapter(Scalar, std::vector<ViewAdapter>)>) override;
@@ -143,13 +164,15 @@ namespace value
 
         ViewAdapter MapReduce(Array a, std::vector<ViewAdapter> initArgs, std::function<ViewAdapter(ViewAdapter)> mapFn, std::function<ViewAdapter(ViewAdapter, std::vector<ViewAdapter>)> reduceFn) override;
 
+        std::vector<ViewAdapter> MultiReduce(Array a, std::vector<ViewAdapter> initArgs, std::function<std::vector<ViewAdapter>(ViewAdapter, std::vector<ViewAdapter>)> reduceFn, std::function<std::vector<ViewAdapter>(std::vector<ViewAdapter>, std::vector<ViewAdapter>)> combineFn, int64_t lanes) override;
+
         void MoveDataImpl(Value& source, Value& destination) override;
 
         void CopyDataImpl(const Value& source, Value& destination) override;
 
         Value ViewImpl(Value source, const std::vector<Scalar>& offsets, const utilities::MemoryShape& shape, const std::vector<int64_t>& strides) override;
 
-        Value SliceImpl(Value source, std::vector<int64_t> slicedDimensions, std::vector<Scalar> sliceOffsets) override;
+        Value SliceImpl(Value source, const std::vector<int64_t>& slicedDimensions, const std::vector<Scalar>& sliceOffsets) override;
 
         Value MergeDimensionsImpl(Value source, int64_t dim1, int64_t dim2) override;
 
@@ -208,9 +231,9 @@ namespace value
 
         void ImportCodeFileImpl(std::string) override;
 
-        Scalar MaxImpl(Vector input) override;
+        Scalar MaxImpl(Vector input, const std::optional<VectorizationInformation>& vectorizationInfo, int64_t accumulators) override;
 
-        Scalar SumImpl(Vector input) override;
+        Scalar SumImpl(Vector input, const std::optional<VectorizationInformation>& vectorizationInfo, int64_t accumulators) override;
 
         Value IntrinsicCall(FunctionDeclaration intrinsic, std::vector<Value> args);
 
@@ -229,15 +252,37 @@ namespace value
         EmittableInfo& StoreGlobalEmittable(EmittableInfo);
         EmittableInfo& StoreLocalEmittable(EmittableInfo);
 
-        void EmitNestDebugFunction(FunctionDeclaration func, const std::vector<std::string>& utilityFunctionNames);
+        // Local emittables belong to the innermost scope, which is a function body, or a loop or kernel body in streaming emission
+        void PushLocalEmittableScope();
+
+        // Releases the local emittables of the innermost scope. Those of values that are defined outside of scopeOp,
+        // e.g. a loop, are moved to the enclosing scope instead.
+        void PopLocalEmittableScope(mlir::Operation* scopeOp = nullptr);
+
+        EmitterStats GetStatsImpl() const override;
+
+        void EmitNestDebugFunction(FunctionDeclaration func, const std::vector<std::string>& utilityFunctionNames, int64_t numThreads, const std::optional<VectorizationInformation>& vectorizationInfo, int64_t sampleStride);
 
         class IfContextImpl;
         struct FunctionScope;
 
         mutable std::mutex _mutex;
 
+        struct LocalEmittableScope
+        {
+            std::list<EmittableInfo> emittables;
+
+            // The emittable of each value, which is reused when the value is emitted again in streaming emission
+            std::map<std::pair<void*, detail::ValueTypeDescription>, EmittableInfo*> index;
+        };
+
         std::forward_list<EmittableInfo> _globalEmittables;
-        std::stack<std::forward_list<EmittableInfo>> _localEmittables;
+        std::stack<LocalEmittableScope> _localEmittables;
+        size_t _numGlobalEmittables = 0;
+        size_t _numLocalEmittables = 0;
+        size_t _peakLocalEmittables = 0;
+        size_t _releasedLocalEmittables = 0;
+        size_t _reusedLocalEmittables = 0;
         std::map<std::string, std::pair<Emittable, MemoryLayout>> _globals;
         std::unordered_map<FunctionDeclaration, DefinedFunction> _definedFunctions;
     };
@@ -263,6 +308,18 @@ namespace value
         static GPUIndex GridDim();
         static GPUIndex ThreadId();
         static void Barrier(BarrierScope scope = BarrierScope::Block);
+
+        /// <summary> Sums a value across the threads of the current warp, the result is returned to every thread </summary>
+        static Scalar WarpSum(Scalar value);
+
+        /// <summary> Computes the maximum of a value across the threads of the current warp, the result is returned to every thread </summary>
+        static Scalar WarpMax(Scalar value);
+
+        /// <summary> Sums a value across the threads of the current block, the result is returned to every thread </summary>
+        static Scalar BlockSum(Scalar value);
+
+        /// <summary> Computes the maximum of a value across the threads of the current block, the result is returned to every thread </summary>
+        static Scalar BlockMax(Scalar value);
     };
 
     void FillResource(ViewAdapter, Scalar);
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "Array.h"
+#include "FastMath.h"
 #include "Scalar.h"
 
 namespace accera
@@ -14,16 +15,49 @@ namespace accera
 namespace value
 {
     void SoftmaxifyRows(Array m);
-    void SoftmaxifyRowsVectorized(Array m);
+    /// <summary> Softmax of each row, with the max and the sum of the exponentials of a row-major matrix computed in one pass.
+    /// Rows of a row-major matrix are split across numThreads threads. </summary>
+    void SoftmaxifyRowsVectorized(Array m, int numThreads = 1);
 
     void LayerNormalize(Array m, Array alpha, Array beta);
     void LayerNormalizeFused(Array m, Array alpha, Array beta, Array residual);
-    void LayerNormalizeVectorized(Array m, Array alpha, Array beta);
-    void LayerNormalizeVectorizedFused(Array m, Array alpha, Array beta, Array residual);
+    /// <summary> Layer normalization of each row, with the mean and variance of a row-major matrix computed in one pass.
+    /// Rows of a row-major matrix are split across numThreads threads. The fused version adds the residual into m first. </summary>
+    void LayerNormalizeVectorized(Array m, Array alpha, Array beta, int numThreads = 1);
+    void LayerNormalizeVectorizedFused(Array m, Array alpha, Array beta, Array residual, int numThreads = 1);
 
     void ReLU(Array m);
+    void GELU(Array m, FastMathAccuracy accuracy = FastMathAccuracy::High);
 
     void Feedforward(Array attn, Array Wff1, Array Wff2, Array ffTemp, Array output);
     void FusedFeedforward(Array attn, Array Wff1, Array Wff2, Array ffTemp, Array output);
+
+    /// <summary> Computes output = softmax(Q * K^T / sqrt(d)) * V, one block of keys at a time with an online softmax, so
+    /// that only a block of the score matrix is held at once </summary>
+    /// <param name="Q"> The M x d queries </param>
+    /// <param name="K"> The N x d keys </param>
+    /// <param name="V"> The N x dv values </param>
+    /// <param name="output"> The M x dv result </param>
+    /// <param name="blockSize"> The number of keys per block, which must divide N. It is clamped to N. </param>
+    void FusedAttention(Array Q, Array K, Array V, Array output, int blockSize = 64);
+
+    /// <summary> The index of the max of each row of m, the first one if there are several. The columns are split into
+    /// numPartitions partitions, whose max is found with a vectorized reduction on numThreads threads, and the
+    /// partitions are then merged. </summary>
+    /// <param name="m"> The rows x columns input, e.g. the logits of a batch of tokens </param>
+    /// <param name="indices"> The integer vector that receives the index of the max of each row </param>
+    /// <param name="numPartitions"> The number of partitions of the columns, which must divide their number. It is clamped to the number of columns. </param>
+    /// <param name="numThreads"> The number of threads that the partitions of all of the rows are split across </param>
+    void ArgMaxRows(Array m, Array indices, int numPartitions = 1, int numThreads = 1);
+
+    /// <summary> The k largest values of each row of m and their indices, largest first, with equal values in the order of
+    /// their indices. Each of numPartitions partitions of the columns keeps its own top k on numThreads threads, skipping
+    /// the blocks of elements whose vectorized max can't make it into its top k, and the partitions are then merged. </summary>
+    /// <param name="m"> The rows x columns input, e.g. the logits of a batch of tokens </param>
+    /// <param name="values"> The rows x k matrix that receives the top k values of each row </param>
+    /// <param name="indices"> The rows x k integer matrix that receives the indices of the top k values of each row </param>
+    /// <param name="numPartitions"> The number of partitions of the columns, which must divide their number. It is clamped to the number of columns. </param>
+    /// <param name="numThreads"> The number of threads that the partitions of all of the rows are split across </param>
+    void TopKRows(Array m, Array values, Array indices, int numPartitions = 1, int numThreads = 1);
 } // namespace value
 } // namespace accera
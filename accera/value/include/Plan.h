@@ -49,7 +49,17 @@ namespace value
     enum class ParallelizationPolicy : int
     {
         Static,
-        Dynamic
+        Dynamic,
+        WorkStealing,
+        Guided
+    };
+
+    enum class ParallelizationPinning : int
+    {
+        Default,
+        Close,
+        Spread,
+        Primary
     };
 
     class Plan
@@ -162,16 +172,40 @@ namespace value
         /// <returns> An instance of Cache </returns>
         Cache PackAndEmbedBuffer(ViewAdapter target, ViewAdapter constantData, const std::string& wrapperFnName, const std::string& packedBufferName, CacheIndexing indexing = CacheIndexing::GlobalToPhysical);
 
+        /// <summary> Packs the given buffer of data following the offline packing format for the given target like PackAndEmbedBuffer, but stores the packed data in a separate file that is memory-mapped the first time the wrapping function runs instead of in the binary </summary>
+        /// <param name="target"> The target being cached (e.g Array, Matrix, etc) </param>
+        /// <param name="constantData"> The data to pack and cache </param>
+        /// <param name="wrapperFnName"> The name to give the wrapping function that calls the base function with the packed data </param>
+        /// <param name="packedBufferName"> The string name to give the buffer, the file is named after it </param>
+        /// <param name="indexing"> The cache indexing </param>
+        /// <returns> An instance of Cache </returns>
+        Cache PackAndMapBuffer(ViewAdapter target, ViewAdapter constantData, const std::string& wrapperFnName, const std::string& packedBufferName, CacheIndexing indexing = CacheIndexing::GlobalToPhysical);
+
         /// <summary> Vectorizes along an index </summary>
         /// <param name="i"> The scalar index indicating the axis to vectorize </param>
         /// <param name="vectorizationInfo"> The vectorization configuration </param>
         void Vectorize(ScalarIndex i, const VectorizationInformation& vectorizationInfo); // `i` must be backed by a SymbolicIndexOp
 
         /// <summary> Parallelizes one or more iteration space dimensions </summary>
-        /// <param name="indices"> The scalar indices to parallelize. Specifying multiple indices is equivalent to the `collapse` argument in OpenMP. Therefore, the dimensions must be contiguous in the iteration space dimension order. </param>
+        /// <param name="indices"> The scalar indices to parallelize. Specifying multiple indices is equivalent to the `collapse` argument in OpenMP. Therefore, the dimensions must be contiguous in the iteration space dimension order. Indices parallelized by a later call are nested parallel regions if they are inside this band. </param>
         /// <param name="numThreads"> The number of threads to schedule. </param>
         /// <param name="policy"> The policy used to schedule work across the threads. </param>
-        void Parallelize(std::vector<ScalarIndex> indices, int64_t numThreads, ParallelizationPolicy policy);
+        /// <param name="pinning"> The placement of the threads relative to the thread that starts the parallel region. </param>
+        /// <param name="processors"> The processors to pin each thread to, in thread order. Threads wrap around the list if there are more threads than processors. </param>
+        /// <param name="firstTouch"> Whether caches that are private to an iteration of the parallel loop are allocated by the thread that runs the iteration. </param>
+        /// <param name="chunkSize"> The number of iterations that are handed to a thread at a time, or 0 for the default of the policy. For the Guided policy, this is the minimum number of iterations. </param>
+        /// <param name="reduction"> Whether the iterations of the parallelized indices accumulate into the same array elements. The caches that accumulate inside the band are then merged atomically. </param>
+        /// <param name="deterministic"> Whether the caches of a reduction are instead accumulated into a partial result per iteration of the band, which are summed in a fixed tree order after the band, so that the result doesn't depend on the threads. </param>
+        void Parallelize(std::vector<ScalarIndex> indices, int64_t numThreads, ParallelizationPolicy policy, ParallelizationPinning pinning = ParallelizationPinning::Default, std::vector<int64_t> processors = {}, bool firstTouch = false, int64_t chunkSize = 0, bool reduction = false, bool deterministic = false);
+
+        /// <summary> Tensorize three iteration space dimensions with the AMX tile instructions </summary>
+        /// <param name="indices"> The scalar indices to tensorize, the rows and columns of C and the reduction dimension. Their dimensions must be contiguous in the iteration space dimension order. </param>
+        /// <param name="dims"> The dimension of the tile operation. </param>
+        void Tensorize(std::vector<ScalarIndex> indices, std::array<int64_t, 3> dims);
+
+        /// <summary> Times the loops of an index in a profile region, when the package is built with loop profiling </summary>
+        /// <param name="i"> The scalar index whose loops are profiled </param>
+        void Profile(ScalarIndex i);
 
     private:
         friend class Schedule;
@@ -211,16 +245,43 @@ namespace value
         /// <returns> An instance of Cache </returns>
         Cache AddCache(ViewAdapter target, int64_t maxElements, MemorySpace memorySpace = MemorySpace::Shared);
 
+        /// <summary> Adds a cache for a view target or a cache </summary>
+        /// <param name="target"> The target being cached (e.g Array, Matrix, etc) or the cache it is copied from </param>
+        /// <param name="maxElements"> A cutoff budget that will be used to select the outermost index in one of the cached dimensions to include in the cache (in order not to exceed the budget) </param>
+        /// <param name="dimOrder"> The dimension order permutation to use to map from active block position to cache position in the cache buffer </param>
+        /// <param name="thrifty"> Whether to make this a thrifty cache </param>
+        /// <param name="doubleBuffer"> Whether or not to use double-buffering to fill this cache </param>
+        /// <param name="vectorizationInfo"> Optional vectorization configuration for the cache ops </param>
+        /// <param name="mapping"> The cache mapping </param>
+        /// <param name="allocation"> The cache allocation </param>
+        /// <param name="memorySpace"> The memory space</param>
+        /// <param name="doubleBufferMemorySpace"> The memory space to put the double buffer temporary buffer in </param>
+        /// <returns> An instance of Cache </returns>
+        Cache AddCache(std::variant<ViewAdapter, Cache*> target, int64_t maxElements, const DimensionOrder& dimOrder, bool thrifty, bool doubleBuffer, const std::optional<VectorizationInformation>& vectorizationInfo, CacheIndexing mapping, CacheAllocation allocation, MemorySpace memorySpace, MemorySpace doubleBufferMemorySpace = MemorySpace::None);
+
         /// <summary> Assigns a loop index to a GPU processor </summary>
         /// <param name="index"> The loop index </param>
         /// <param name="proc"> The GPU processor, indicating a block or thread </param>
-        void MapIndexToProcessor(ScalarIndex index, Processor proc);
+        /// <param name="reduction"> Whether the iterations of the index accumulate into the same array elements. The caches that accumulate inside the bound loop are then merged atomically. </param>
+        void MapIndexToProcessor(ScalarIndex index, Processor proc, bool reduction = false);
+
+        /// <summary> Makes the kernel persistent: it is launched with a fixed number of blocks that take the blocks of its grid from a work counter, one at a time </summary>
+        /// <param name="numBlocks"> The number of blocks the kernel is launched with </param>
+        void SetPersistentBlocks(int64_t numBlocks);
+
+        /// <summary> Gives a persistent kernel a Stream-K decomposition: each of its blocks runs an even share of the blocks of its grid, in which the blocks of the split reduction index are consecutive </summary>
+        /// <param name="dim"> The grid dimension that the split reduction index is bound to </param>
+        void SetStreamKDim(int64_t dim);
 
         /// <summary> Tensorize three iteration space dimensions </summary>
         /// <param name="indices"> The scalar indices to tensorize. Three indices must be specified whose dimensions must be contiguous in the iteration space dimension order. </param>
         /// <param name="numThreads"> The dimension of the tensor operation. </param>
         void Tensorize(std::vector<ScalarIndex> indices, std::array<int64_t, 3> dims);
 
+        /// <summary> Times the loops of an index in a profile region, when the package is built with loop profiling </summary>
+        /// <param name="i"> The scalar index whose loops are profiled </param>
+        void Profile(ScalarIndex i);
+
     private:
         friend class Schedule;
         GPUPlan(targets::GPU gpuOptions, Schedule& sched, ExecutionRuntime execRuntime = ExecutionRuntime::DEFAULT);
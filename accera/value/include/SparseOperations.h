@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Array.h"
+#include "Scalar.h"
+
+namespace accera
+{
+namespace value
+{
+    /// <summary> A sparse matrix in the compressed sparse row (CSR) format. The nonzeros of row r are at the positions
+    /// rowOffsets(r) to rowOffsets(r + 1) of values and columns, so the number of nonzeros is only known when the
+    /// function runs, up to the size of values. </summary>
+    struct CSRMatrix
+    {
+        /// <summary> The rows + 1 integer offsets of the rows in values and columns </summary>
+        Array rowOffsets;
+        /// <summary> The integer column of each nonzero </summary>
+        Array columns;
+        /// <summary> The value of each nonzero </summary>
+        Array values;
+        /// <summary> The number of columns </summary>
+        int64_t numColumns;
+    };
+
+    /// <summary> Computes y = A * x for a CSR matrix A. The rows are split into numPartitions partitions that have about
+    /// the same number of nonzeros, found with a binary search of the row offsets, and the partitions are split across
+    /// numThreads threads, so that rows with many nonzeros don't leave the other threads idle. </summary>
+    /// <param name="A"> The rows x columns sparse matrix </param>
+    /// <param name="x"> The vector of columns elements </param>
+    /// <param name="y"> The vector of rows elements that receives the product </param>
+    /// <param name="numPartitions"> The number of partitions of the nonzeros. It is clamped to the number of rows. </param>
+    /// <param name="numThreads"> The number of threads that the partitions are split across </param>
+    void SpMV(CSRMatrix A, Array x, Array y, int numPartitions = 1, int numThreads = 1);
+
+    /// <summary> Computes Y = A * X for a CSR matrix A and a dense matrix X, e.g. the aggregation of the embeddings of
+    /// a batch of sparse features. The rows of A are partitioned by nonzeros as in SpMV, and each nonzero of a row
+    /// scales a row of X into the row of Y, so that the rows of X and Y are read contiguously. </summary>
+    /// <param name="A"> The rows x columns sparse matrix </param>
+    /// <param name="X"> The columns x n row-major matrix </param>
+    /// <param name="Y"> The rows x n row-major matrix that receives the product </param>
+    /// <param name="numPartitions"> The number of partitions of the nonzeros. It is clamped to the number of rows. </param>
+    /// <param name="numThreads"> The number of threads that the partitions are split across </param>
+    void SpMM(CSRMatrix A, Array X, Array Y, int numPartitions = 1, int numThreads = 1);
+
+    /// <summary> Computes the sum of the rows of an embedding table that each bag of indices looks up, e.g. the pooled
+    /// embedding of each multi-hot feature of a batch. The rows are added with vectors over the embedding dimension,
+    /// the rows that a bag looks up prefetchDistance indices later are prefetched while a row is added, and the bags
+    /// are split across numThreads threads. </summary>
+    /// <param name="table"> The rows x d embedding table </param>
+    /// <param name="indices"> The integer indices of the rows of all of the bags </param>
+    /// <param name="offsets"> The bags + 1 integer offsets of the bags in indices </param>
+    /// <param name="output"> The bags x d matrix that receives the sum of each bag </param>
+    /// <param name="prefetchDistance"> The number of indices ahead to prefetch the rows of, or 0 for no prefetching </param>
+    /// <param name="numThreads"> The number of threads that the bags are split across </param>
+    void EmbeddingBagSum(Array table, Array indices, Array offsets, Array output, int prefetchDistance = 8, int numThreads = 1);
+
+    /// <summary> The backward pass of EmbeddingBagSum: adds the gradient of the sum of each bag into the gradient of
+    /// each row that the bag looks up. The rows of the table are split into numPartitions partitions, split across
+    /// numThreads threads, and each partition only adds into its own rows, so that no two threads add into the same
+    /// row and no atomics are needed. </summary>
+    /// <param name="gradOutput"> The bags x d gradient of the sums </param>
+    /// <param name="indices"> The integer indices of the rows of all of the bags </param>
+    /// <param name="offsets"> The bags + 1 integer offsets of the bags in indices </param>
+    /// <param name="gradTable"> The rows x d gradient of the embedding table, which the gradients are added into </param>
+    /// <param name="numPartitions"> The number of partitions of the rows. It is clamped to the number of rows. </param>
+    /// <param name="numThreads"> The number of threads that the partitions are split across </param>
+    void EmbeddingBagScatterAdd(Array gradOutput, Array indices, Array offsets, Array gradTable, int numPartitions = 1, int numThreads = 1);
+} // namespace value
+} // namespace accera
@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Array.h"
+#include "Scalar.h"
+
+#include <functional>
+
+namespace accera
+{
+namespace value
+{
+    /// <summary> The triangle of a square matrix that a triangular or symmetric operation reads or writes </summary>
+    enum class TriangularPart
+    {
+        /// <summary> The diagonal and the elements below it </summary>
+        Lower,
+        /// <summary> The diagonal and the elements above it </summary>
+        Upper
+    };
+
+    /// <summary> Iterates the triangular domain of the blocks of a square matrix of numBlocks x numBlocks blocks, so that
+    /// only the blocks of the triangle are visited. The blocks strictly inside the triangle are full rectangular tiles,
+    /// whose loop bounds depend on the row of blocks, and only the blocks of the diagonal are triangular themselves.
+    /// The rows of blocks are visited from the first for the lower triangle and from the last for the upper one, with
+    /// the full tiles of a row before its diagonal tile, which is the order of the substitutions of a triangular solve.
+    /// Independent rows can instead be split across numThreads threads, with a dynamic policy since the number of tiles
+    /// of a row grows along the triangle. </summary>
+    /// <param name="numBlocks"> The number of rows and columns of blocks </param>
+    /// <param name="part"> The triangle to visit </param>
+    /// <param name="fullTile"> Called with the row and the column of each block strictly inside the triangle </param>
+    /// <param name="diagonalTile"> Called with the row of each block of the diagonal </param>
+    /// <param name="numThreads"> The number of threads that the rows of blocks are split across </param>
+    void ForTriangularTiles(int64_t numBlocks, TriangularPart part, std::function<void(Scalar, Scalar)> fullTile, std::function<void(Scalar)> diagonalTile, int numThreads = 1);
+
+    /// <summary> Computes the symmetric rank-k update C += A * A^T (SYRK) on one triangle of C, whose other triangle isn't
+    /// written. The triangle is tiled by ForTriangularTiles: a full tile is a matrix multiplication of a block of rows of
+    /// A with a block of columns of A^T, which is packed once up front, and a diagonal tile only computes its triangle. </summary>
+    /// <param name="A"> The n x k row-major matrix </param>
+    /// <param name="C"> The n x n row-major symmetric matrix, which the product is added into </param>
+    /// <param name="part"> The triangle of C to update </param>
+    /// <param name="blockSize"> The rows and columns of the tiles, which must divide n. It is clamped to n. </param>
+    /// <param name="numThreads"> The number of threads that the rows of tiles are split across </param>
+    void SymmetricRankKUpdate(Array A, Array C, TriangularPart part = TriangularPart::Lower, int blockSize = 64, int numThreads = 1);
+
+    /// <summary> Computes C += T * B for a triangular matrix T (TRMM), of which only the triangle is read. A full tile
+    /// of T is a matrix multiplication into a block of rows of C, and a diagonal tile only reads its triangle, with each
+    /// of its elements scaling a row of B into a row of C with vectors. </summary>
+    /// <param name="T"> The m x m row-major triangular matrix </param>
+    /// <param name="B"> The m x n row-major matrix </param>
+    /// <param name="C"> The m x n row-major matrix that the product is added into </param>
+    /// <param name="part"> The triangle of T </param>
+    /// <param name="unitDiagonal"> Whether the diagonal of T is taken to be ones, and not read </param>
+    /// <param name="blockSize"> The rows and columns of the tiles of T, which must divide m. It is clamped to m. </param>
+    /// <param name="numThreads"> The number of threads that the rows of tiles are split across </param>
+    void TriangularMatMul(Array T, Array B, Array C, TriangularPart part = TriangularPart::Lower, bool unitDiagonal = false, int blockSize = 64, int numThreads = 1);
+
+    /// <summary> Solves T * X = B for X in place of B, for a triangular matrix T (TRSM), of which only the triangle is
+    /// read. Each block of rows of X is found after the blocks it depends on: the products of its full tiles of T with
+    /// them are subtracted from it, and the diagonal tile is then solved by substitution, each row of X updating the
+    /// next ones with vectors. </summary>
+    /// <param name="T"> The m x m row-major triangular matrix, whose diagonal must not have zeros </param>
+    /// <param name="B"> The m x n row-major right-hand sides, which receive the solutions </param>
+    /// <param name="part"> The triangle of T </param>
+    /// <param name="unitDiagonal"> Whether the diagonal of T is taken to be ones, and not read </param>
+    /// <param name="blockSize"> The rows and columns of the tiles of T, which must divide m. It is clamped to m. </param>
+    void TriangularSolve(Array T, Array B, TriangularPart part = TriangularPart::Lower, bool unitDiagonal = false, int blockSize = 64);
+} // namespace value
+} // namespace accera
@@ -23,6 +23,10 @@ namespace value
         using underlying_type = float;
         float data;
     };
+    struct bfloat16_t {
+        using underlying_type = float;
+        float data;
+    };
 
     /// <summary> An enumeration of primitive types supported by the value library </summary>
     enum class ValueType
@@ -53,6 +57,8 @@ namespace value
         Uint64,
         /// <summary> 2 byte floating point </summary>
         Float16,
+        /// <summary> 2 byte brain floating point, with the exponent range of a 4 byte floating point </summary>
+        BFloat16,
         /// <summary> 4 byte floating point </summary>
         Float,
         /// <summary> 8 byte floating point </summary>
@@ -145,6 +151,10 @@ namespace value
         {
             return ValueType::Float16;
         }
+        else if constexpr (std::is_same_v<T, bfloat16_t>)
+        {
+            return ValueType::BFloat16;
+        }
         else if constexpr (std::is_same_v<T, float>)
         {
             return ValueType::Float;
@@ -9,10 +9,12 @@
 #include "Scalar.h"
 #include "Value.h"
 #include "Vector.h"
+#include "VectorizationInformation.h"
 
 #include <utilities/include/MemoryLayout.h>
 
 #include <functional>
+#include <optional>
 
 namespace accera
 {
@@ -36,9 +38,17 @@ namespace value
 
     Scalar Dot(Vector, Vector);
 
-    Scalar Sum(Vector input);
-
-    Scalar Max(Vector input);
+    /// <summary> Returns the sum of the elements of a vector </summary>
+    /// <param name="input"> The vector to reduce </param>
+    /// <param name="vectorizationInfo"> If set, the reduction is vectorized for the given vector size and registers </param>
+    /// <param name="accumulators"> The number of independent vector accumulators of a vectorized reduction, 0 for half of the vector registers </param>
+    Scalar Sum(Vector input, const std::optional<VectorizationInformation>& vectorizationInfo = std::nullopt, int64_t accumulators = 0);
+
+    /// <summary> Returns the largest element of a vector </summary>
+    /// <param name="input"> The vector to reduce </param>
+    /// <param name="vectorizationInfo"> If set, the reduction is vectorized for the given vector size and registers </param>
+    /// <param name="accumulators"> The number of independent vector accumulators of a vectorized reduction, 0 for half of the vector registers </param>
+    Scalar Max(Vector input, const std::optional<VectorizationInformation>& vectorizationInfo = std::nullopt, int64_t accumulators = 0);
 
     /// todo pending for PR 1352 to merge
     /// <summary> Turn whatever the data memory layout is into a flat vector </summary>
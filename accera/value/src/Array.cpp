@@ -22,26 +22,10 @@ using namespace utilities;
 
 namespace value
 {
-    namespace
-    {
-        MemoryLayout GetSliceLayout(const MemoryLayout& originalLayout, std::vector<int64_t> slicedDimensions)
-        {
-            std::sort(slicedDimensions.begin(), slicedDimensions.end(), std::greater<int64_t>());
-
-            MemoryLayout result = originalLayout;
-            for (auto dim : slicedDimensions)
-            {
-                result = result.GetSliceLayout(dim);
-            }
-            return result;
-        }
-
-    } // namespace
-
     Array::Array() = default;
 
     Array::Array(Value value, const std::string& name) :
-        _value(value)
+        _value(std::move(value))
     {
         if (!_value.IsDefined() || !_value.IsConstrained())
         {
@@ -115,9 +99,8 @@ namespace value
         return GetContext().View(_value, offsets, shape, *strides);
     }
 
-    Array Array::Slice(std::vector<int64_t> slicedDimensions, std::vector<Scalar> sliceOffsets) const
+    Array Array::Slice(const std::vector<int64_t>& slicedDimensions, const std::vector<Scalar>& sliceOffsets) const
     {
-        auto newLayout = GetSliceLayout(_value.GetLayout(), slicedDimensions);
         return GetContext().Slice(_value, slicedDimensions, sliceOffsets);
     }
 
@@ -166,7 +149,7 @@ namespace value
     void For(Array array, std::function<void(const std::vector<Scalar>&)> fn)
     {
         auto layout = array.GetValue().GetLayout();
-        GetContext().For(layout, [fn = std::move(fn), &layout](std::vector<Scalar> coordinates) {
+        GetContext().For(layout, [fn = std::move(fn), &layout](const std::vector<Scalar>& coordinates) {
             if (layout.NumDimensions() != static_cast<int>(coordinates.size()))
             {
                 throw InputException(InputExceptionErrors::invalidSize);
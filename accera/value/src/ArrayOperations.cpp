@@ -9,14 +9,18 @@
 #include "Cache.h"
 #include "Kernel.h"
 #include "KernelPredicate.h"
+#include "MLIREmitterContext.h"
 #include "Matrix.h"
 #include "Nest.h"
 #include "Plan.h"
 #include "Schedule.h"
 #include "Vector.h"
 
+#include <ir/include/value/ValueDialect.h>
+
 #include <utilities/include/Exception.h>
 
+#include <algorithm>
 #include <limits>
 
 namespace accera
@@ -38,6 +42,19 @@ namespace value
         return Reduce(v, Cast(Scalar(0.0f), elementType), [](Scalar a, Scalar s) { return a + s; });
     }
 
+    Scalar TableLookup(Array table, Scalar index)
+    {
+        auto isByte = [](ValueType type) { return type == ValueType::Int8 || type == ValueType::Byte; };
+        ThrowIf(table.Shape() != MemoryShape{ 256 }, InputExceptionErrors::invalidSize, "Lookup tables must have 256 entries");
+        ThrowIf(!isByte(table.GetType()) || !isByte(index.GetType()), InputExceptionErrors::typeMismatch, "Lookup tables and their indices must be 8-bit integers");
+
+        auto& builder = GetMLIRContext().GetOpBuilder();
+        auto tableValue = Unwrap(table);
+        auto resultType = tableValue.getType().cast<mlir::MemRefType>().getElementType();
+        auto lookup = builder.create<ir::value::TableLookupOp>(builder.getUnknownLoc(), resultType, tableValue, UnwrapScalar(index));
+        return Wrap(lookup.result());
+    }
+
     void ClearArray(Array A)
     {
         Nest nest(A.Shape());
@@ -195,6 +212,38 @@ namespace value
         schedule.SetOrder({ iOuter, jOuter, k, iInner, jInner });
     }
 
+    MatMulMicrokernelShape GetMatMulMicrokernelShape(int vectorBytes, int vectorRegisters, int elementBytes, int M, int N)
+    {
+        const int vectorSize = std::max(1, vectorBytes / std::max(1, elementBytes));
+        MatMulMicrokernelShape best{ 1, vectorSize, vectorSize };
+        int bestAccumulators = 0;
+        bool bestFmaBound = false;
+        for (int vectorColumns = 1; vectorColumns < vectorRegisters; ++vectorColumns)
+        {
+            // Every reduction step broadcasts one element of A into a register and loads vectorColumns vectors of B
+            int rows = (vectorRegisters - vectorColumns - 1) / vectorColumns;
+            if (rows < 1 || (N > 0 && vectorColumns > 1 && vectorColumns * vectorSize > N))
+            {
+                break;
+            }
+            if (M > 0)
+            {
+                rows = std::min(rows, M);
+            }
+
+            auto accumulators = rows * vectorColumns;
+            auto loads = rows + vectorColumns;
+            bool fmaBound = loads <= accumulators;
+            if ((fmaBound && !bestFmaBound) || (fmaBound == bestFmaBound && accumulators > bestAccumulators))
+            {
+                best = { rows, vectorColumns * vectorSize, vectorSize };
+                bestAccumulators = accumulators;
+                bestFmaBound = fmaBound;
+            }
+        }
+        return best;
+    }
+
     // MLAS Value MatrixMatrixMultiply
     void MatMulMlas(Array A, Array B, Array C, bool clearC)
     {
@@ -229,8 +278,9 @@ namespace value
         int vectorUnits = 16; // AVX-2 has 16 256-bit registers
         int kUnroll = 4;
 
-        int NumRowsInKernel = 6;
-        int NumColumnsInKernel = 2 * vectorSize;
+        auto kernelShape = GetMatMulMicrokernelShape(vectorSize * 4, vectorUnits, 4);
+        int NumRowsInKernel = kernelShape.rows;
+        int NumColumnsInKernel = kernelShape.columns;
 
         int columnBlock = 256;
         int innerDimensionBlock = 128;
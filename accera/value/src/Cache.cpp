@@ -53,6 +53,40 @@ namespace value
             return underlyingIndices;
         }
 
+        // The types that the elements of a cache can be stored as, or a null type
+        mlir::Type GetCacheElementType(mlir::OpBuilder& builder, ValueType type)
+        {
+            switch (type)
+            {
+            case ValueType::Int8:
+                return builder.getIntegerType(8);
+            case ValueType::Int16:
+                return builder.getIntegerType(16);
+            case ValueType::Int32:
+                return builder.getIntegerType(32);
+            case ValueType::Int64:
+                return builder.getIntegerType(64);
+            case ValueType::Byte:
+                return builder.getIntegerType(8, /*isSigned=*/false);
+            case ValueType::Uint16:
+                return builder.getIntegerType(16, /*isSigned=*/false);
+            case ValueType::Uint32:
+                return builder.getIntegerType(32, /*isSigned=*/false);
+            case ValueType::Uint64:
+                return builder.getIntegerType(64, /*isSigned=*/false);
+            case ValueType::Float16:
+                return builder.getF16Type();
+            case ValueType::BFloat16:
+                return builder.getBF16Type();
+            case ValueType::Float:
+                return builder.getF32Type();
+            case ValueType::Double:
+                return builder.getF64Type();
+            default:
+                return {};
+            }
+        }
+
         enum class CopyDirection : int
         {
             SourceToCache,
@@ -68,6 +102,196 @@ namespace value
             return _input;
         }
 
+        void SetCooperativeCopy()
+        {
+            auto makeCacheOp = _cacheValue ? _cacheValue.getDefiningOp<MakeCacheOp>() : MakeCacheOp{};
+            if (!makeCacheOp)
+            {
+                throw accera::utilities::InputException(accera::utilities::InputExceptionErrors::invalidArgument, "Only caches that allocate a buffer can be copied cooperatively");
+            }
+            makeCacheOp->setAttr(CooperativeCacheCopyAttrName, mlir::UnitAttr::get(makeCacheOp.getContext()));
+        }
+
+        void SetPrefetchDistance(int64_t distance)
+        {
+            auto makeCacheOp = _cacheValue ? _cacheValue.getDefiningOp<MakeCacheOp>() : MakeCacheOp{};
+            if (!makeCacheOp)
+            {
+                throw accera::utilities::InputException(accera::utilities::InputExceptionErrors::invalidArgument, "Only caches that allocate a buffer can prefetch their active block");
+            }
+            if (distance <= 0)
+            {
+                throw accera::utilities::InputException(accera::utilities::InputExceptionErrors::invalidArgument, "Prefetch distance must be positive");
+            }
+            mlir::OpBuilder builder(makeCacheOp);
+            makeCacheOp->setAttr(PrefetchDistanceAttrName, builder.getI64IntegerAttr(distance));
+        }
+
+        void SetPadding(int64_t padding)
+        {
+            auto makeCacheOp = _cacheValue ? _cacheValue.getDefiningOp<MakeCacheOp>() : MakeCacheOp{};
+            if (!makeCacheOp)
+            {
+                throw accera::utilities::InputException(accera::utilities::InputExceptionErrors::invalidArgument, "Only caches that allocate a buffer can be padded");
+            }
+            if (padding < 0 && padding != AutomaticCachePadding)
+            {
+                throw accera::utilities::InputException(accera::utilities::InputExceptionErrors::invalidArgument, "Cache padding must not be negative");
+            }
+            mlir::OpBuilder builder(makeCacheOp);
+            makeCacheOp->setAttr(CachePaddingAttrName, builder.getI64IntegerAttr(padding));
+        }
+
+        void SetPanelLayout(int64_t dimension, int64_t panelSize)
+        {
+            auto makeCacheOp = _cacheValue ? _cacheValue.getDefiningOp<MakeCacheOp>() : MakeCacheOp{};
+            if (!makeCacheOp)
+            {
+                throw accera::utilities::InputException(accera::utilities::InputExceptionErrors::invalidArgument, "Only caches that allocate a buffer can be stored as panels");
+            }
+            auto rank = _baseMlirValueInput.getType().cast<mlir::MemRefType>().getRank();
+            if (dimension < 0 || dimension >= rank)
+            {
+                throw accera::utilities::InputException(accera::utilities::InputExceptionErrors::indexOutOfRange, "Cache panel dimension is out of range");
+            }
+            if (panelSize <= 0)
+            {
+                throw accera::utilities::InputException(accera::utilities::InputExceptionErrors::invalidArgument, "Cache panel size must be positive");
+            }
+            mlir::OpBuilder builder(makeCacheOp);
+            makeCacheOp->setAttr(CachePanelLayoutAttrName, builder.getI64ArrayAttr({ dimension, panelSize }));
+        }
+
+        void SetNonTemporalWriteBack()
+        {
+            auto makeCacheOp = _cacheValue ? _cacheValue.getDefiningOp<MakeCacheOp>() : MakeCacheOp{};
+            if (!makeCacheOp)
+            {
+                throw accera::utilities::InputException(accera::utilities::InputExceptionErrors::invalidArgument, "Only caches that allocate a buffer can be written back with non-temporal stores");
+            }
+            makeCacheOp->setAttr(NonTemporalWriteBackCacheAttrName, mlir::UnitAttr::get(makeCacheOp.getContext()));
+        }
+
+        void SetRegisterCache()
+        {
+            auto makeCacheOp = _cacheValue ? _cacheValue.getDefiningOp<MakeCacheOp>() : MakeCacheOp{};
+            if (!makeCacheOp || makeCacheOp.memorySpace() != vir::MemorySpace::Private)
+            {
+                throw accera::utilities::InputException(accera::utilities::InputExceptionErrors::invalidArgument, "Only caches that allocate a private buffer can be held in registers");
+            }
+            makeCacheOp->setAttr(RegisterCacheAttrName, mlir::UnitAttr::get(makeCacheOp.getContext()));
+        }
+
+        void AddEpilogueStep(mlir::DictionaryAttr step, std::optional<mlir::Value> array = std::nullopt)
+        {
+            auto makeCacheOp = _cacheValue ? _cacheValue.getDefiningOp<MakeCacheOp>() : MakeCacheOp{};
+            if (!makeCacheOp)
+            {
+                throw accera::utilities::InputException(accera::utilities::InputExceptionErrors::invalidArgument, "Only caches that allocate a buffer can apply an epilogue");
+            }
+            if (_hierarchicalCacheLevel > 0)
+            {
+                throw accera::utilities::InputException(accera::utilities::InputExceptionErrors::invalidArgument, "Only the outermost cache of an array can apply an epilogue");
+            }
+
+            mlir::OpBuilder builder(makeCacheOp);
+            if (array)
+            {
+                auto arrayType = array->getType().dyn_cast<mlir::MemRefType>();
+                if (!arrayType || arrayType.getRank() != 1 || arrayType.getElementType() != GetElementType())
+                {
+                    throw accera::utilities::InputException(accera::utilities::InputExceptionErrors::invalidArgument, "A cache epilogue bias must be a rank-1 array of the element type of the cached array");
+                }
+                auto operands = llvm::to_vector<4>(makeCacheOp->getOperands());
+                operands.push_back(*array);
+                makeCacheOp->setOperands(operands);
+            }
+
+            llvm::SmallVector<mlir::Attribute, 4> steps;
+            if (auto epilogue = makeCacheOp->getAttrOfType<mlir::ArrayAttr>(CacheEpilogueAttrName))
+            {
+                steps.append(epilogue.begin(), epilogue.end());
+            }
+            steps.push_back(step);
+            makeCacheOp->setAttr(CacheEpilogueAttrName, builder.getArrayAttr(steps));
+        }
+
+        void AddEpilogueBias(mlir::Value bias, int64_t dimension)
+        {
+            if (dimension < 0 || dimension >= GetInputType().getRank())
+            {
+                throw accera::utilities::InputException(accera::utilities::InputExceptionErrors::indexOutOfRange, "Cache epilogue bias dimension is out of range");
+            }
+            mlir::OpBuilder builder(bias.getContext());
+            auto operand = _cacheValue.getDefiningOp() ? static_cast<int64_t>(_cacheValue.getDefiningOp()->getNumOperands()) : 0;
+            AddEpilogueStep(builder.getDictionaryAttr({ builder.getNamedAttr("kind", builder.getStringAttr("bias")),
+                                                        builder.getNamedAttr("operand", builder.getI64IntegerAttr(operand)),
+                                                        builder.getNamedAttr("dim", builder.getI64IntegerAttr(dimension)) }),
+                            bias);
+        }
+
+        void AddEpilogueScale(double scale)
+        {
+            mlir::OpBuilder builder(_scheduleOp);
+            AddEpilogueStep(builder.getDictionaryAttr({ builder.getNamedAttr("kind", builder.getStringAttr("scale")),
+                                                        builder.getNamedAttr("value", builder.getF64FloatAttr(scale)) }));
+        }
+
+        void AddEpilogueClamp(std::optional<double> min, std::optional<double> max)
+        {
+            if (!min && !max)
+            {
+                throw accera::utilities::InputException(accera::utilities::InputExceptionErrors::invalidArgument, "A cache epilogue clamp needs a minimum or a maximum");
+            }
+            if (min && max && *min > *max)
+            {
+                throw accera::utilities::InputException(accera::utilities::InputExceptionErrors::invalidArgument, "A cache epilogue clamp minimum must not be greater than its maximum");
+            }
+            mlir::OpBuilder builder(_scheduleOp);
+            llvm::SmallVector<mlir::NamedAttribute, 3> attrs{ builder.getNamedAttr("kind", builder.getStringAttr("clamp")) };
+            if (min)
+            {
+                attrs.push_back(builder.getNamedAttr("min", builder.getF64FloatAttr(*min)));
+            }
+            if (max)
+            {
+                attrs.push_back(builder.getNamedAttr("max", builder.getF64FloatAttr(*max)));
+            }
+            AddEpilogueStep(builder.getDictionaryAttr(attrs));
+        }
+
+        void SetElementType(ValueType type)
+        {
+            auto makeCacheOp = _cacheValue ? _cacheValue.getDefiningOp<MakeCacheOp>() : MakeCacheOp{};
+            if (!makeCacheOp || !_activeBlockCache)
+            {
+                throw accera::utilities::InputException(accera::utilities::InputExceptionErrors::invalidArgument, "Only active block caches that allocate a buffer can convert their element type");
+            }
+            if (_hierarchicalCacheLevel > 0)
+            {
+                throw accera::utilities::InputException(accera::utilities::InputExceptionErrors::invalidArgument, "Only the outermost cache of an array can convert its element type");
+            }
+
+            mlir::OpBuilder builder(makeCacheOp);
+            auto arrayElementType = GetElementType();
+            auto cacheElementType = GetCacheElementType(builder, type);
+            auto arrayIntType = arrayElementType.dyn_cast<mlir::IntegerType>();
+            auto cacheIntType = cacheElementType ? cacheElementType.dyn_cast<mlir::IntegerType>() : mlir::IntegerType{};
+            bool bothFloats = cacheElementType && arrayElementType.isa<mlir::FloatType>() && cacheElementType.isa<mlir::FloatType>();
+            bool bothInts = arrayIntType && cacheIntType && arrayIntType.getWidth() > 1 && arrayIntType.isUnsigned() == cacheIntType.isUnsigned();
+            if (!bothFloats && !bothInts)
+            {
+                throw accera::utilities::InputException(accera::utilities::InputExceptionErrors::invalidArgument, "A cache can only convert between floating-point types, or between integer types of the same signedness");
+            }
+
+            if (cacheElementType == arrayElementType)
+            {
+                makeCacheOp->removeAttr(CacheElementTypeAttrName);
+                return;
+            }
+            makeCacheOp->setAttr(CacheElementTypeAttrName, mlir::TypeAttr::get(cacheElementType));
+        }
+
     protected:
         CacheImpl(ScheduleOp schedule, std::variant<Value, CacheImpl*> input, CacheIndexing cacheIndexMapping) :
             _scheduleOp(schedule),
@@ -143,6 +367,7 @@ namespace value
         int64_t _hierarchicalCacheLevel;
         CacheInfo _cacheInfo; // Subclasses set this manually
         mlir::Value _cacheValue; // Subclasses set this manually
+        bool _activeBlockCache = false; // Subclasses set this manually
     };
 
     class AutomaticCacheImpl : public CacheImpl
@@ -166,10 +391,14 @@ namespace value
 
             _cacheInfo = MakeAutomaticCacheInfo(builder, _mlirValueInput, allocation, schedule, outermostIncludedSplitIndex, maxElements, memorySpace);
 
-            if (allocation == CacheAllocation::Automatic)
+            if (allocation == CacheAllocation::Automatic || allocation == CacheAllocation::ThreadLocal)
             {
                 auto makeCache = builder.create<MakeCacheOp>(loc, _cacheInfo.cacheType, memorySpace);
                 _cacheValue = makeCache;
+                if (allocation == CacheAllocation::ThreadLocal)
+                {
+                    makeCache->setAttr(ThreadLocalCacheAttrName, builder.getUnitAttr());
+                }
                 auto op = makeCache;
                 op->moveBefore(schedule.getOperation());
             }
@@ -230,6 +459,7 @@ namespace value
             auto doubleBufferMemorySpace = *ir::value::symbolizeMemorySpace((uint64_t)dslDoubleBufferMemorySpace);
 
             _cacheInfo = MakeManualCacheInfo(builder, _baseMlirValueInput, allocation, schedule, keySliceIndex, triggerIndex, maxElements, cacheMapping, memorySpace);
+            _activeBlockCache = true;
 
             VectorizationInfo vectorizationInfo;
             if (vecInfo.has_value())
@@ -237,10 +467,14 @@ namespace value
                 vectorizationInfo = vecInfo.value();
             }
 
-            if (allocation == CacheAllocation::Automatic)
+            if (allocation == CacheAllocation::Automatic || allocation == CacheAllocation::ThreadLocal)
             {
                 auto makeCache = builder.create<MakeCacheOp>(loc, _cacheInfo.cacheType, memorySpace);
                 _cacheValue = makeCache.getResult();
+                if (allocation == CacheAllocation::ThreadLocal)
+                {
+                    makeCache->setAttr(ThreadLocalCacheAttrName, builder.getUnitAttr());
+                }
                 auto op = makeCache;
                 op->moveBefore(schedule.getOperation());
             }
@@ -562,7 +796,7 @@ namespace value
     class EmitTimePackedCacheImpl : public OfflineCacheImpl
     {
     public:
-        EmitTimePackedCacheImpl(ScheduleOp schedule, Value value, Value constantData, const std::string& wrapperFnName, const std::string& packedBufferName, CacheIndexing mapping) :
+        EmitTimePackedCacheImpl(ScheduleOp schedule, Value value, Value constantData, const std::string& wrapperFnName, const std::string& packedBufferName, CacheIndexing mapping, bool mapFromFile) :
             OfflineCacheImpl(schedule, value, mapping)
         {
             auto builder = GetBuilder();
@@ -601,6 +835,8 @@ namespace value
                 _packedBuffer = EmbedPackedBuffer<uint64_t>(builder, constData, packedBufferName);
                 break;
             case ValueType::Float16:
+                [[fallthrough]];
+            case ValueType::BFloat16:
                 _packedBuffer = EmbedPackedBuffer<short>(builder, constData, packedBufferName);
                 break;
             case ValueType::Float:
@@ -614,6 +850,15 @@ namespace value
             }
             _packedBufferMlirValue = mlir::Value::getFromOpaquePointer(_packedBuffer.GetValue().Get<Emittable>().GetDataAs<MLIRContext::EmittableInfo*>()->data);
 
+            if (mapFromFile)
+            {
+                // Keep the packed data out of the binary: it is written to a file that is deployed with the library
+                // and memory-mapped on first use, see MLIRContext::writeMappedBuffers
+                auto packedGlobalRef = mlir::cast<vir::ReferenceGlobalOp>(_packedBufferMlirValue.getDefiningOp());
+                auto packedGlobal = packedGlobalRef.getGlobal();
+                packedGlobal->setAttr(ir::MappedFileAttrName, builder.getStringAttr(packedGlobal.sym_name().str() + ".bin"));
+            }
+
             // Create a wrapper function that calls the accera function with the schedule op but hard-codes the arg corresponding
             // to the packed buffer and removes it as an arg in the wrapper function
             CreateWrapperFunction(builder, wrapperFnName);
@@ -929,8 +1174,9 @@ namespace value
                  ViewAdapter constantData,
                  const std::string& wrapperFnName,
                  const std::string& packedBufferName,
-                 CacheIndexing mapping) :
-        _impl(std::make_unique<EmitTimePackedCacheImpl>(schedule, value, constantData, wrapperFnName, packedBufferName, mapping))
+                 CacheIndexing mapping,
+                 bool mapFromFile) :
+        _impl(std::make_unique<EmitTimePackedCacheImpl>(schedule, value, constantData, wrapperFnName, packedBufferName, mapping, mapFromFile))
     {
     }
 
@@ -955,5 +1201,61 @@ namespace value
         return _impl->GetBaseValue();
     }
 
+    void Cache::SetCooperativeCopy()
+    {
+        _impl->SetCooperativeCopy();
+    }
+
+    void Cache::SetPrefetchDistance(int64_t distance)
+    {
+        _impl->SetPrefetchDistance(distance);
+    }
+
+    void Cache::SetPadding(int64_t padding)
+    {
+        _impl->SetPadding(padding);
+    }
+
+    void Cache::SetAutomaticPadding()
+    {
+        _impl->SetPadding(AutomaticCachePadding);
+    }
+
+    void Cache::SetPanelLayout(int64_t dimension, int64_t panelSize)
+    {
+        _impl->SetPanelLayout(dimension, panelSize);
+    }
+
+    void Cache::SetNonTemporalWriteBack()
+    {
+        _impl->SetNonTemporalWriteBack();
+    }
+
+    void Cache::SetRegisterCache()
+    {
+        _impl->SetRegisterCache();
+    }
+
+    void Cache::SetElementType(ValueType type)
+    {
+        _impl->SetElementType(type);
+    }
+
+    void Cache::AddEpilogueBias(ViewAdapter bias, int64_t dimension)
+    {
+        Value biasValue = bias;
+        _impl->AddEpilogueBias(mlir::Value::getFromOpaquePointer(biasValue.Get<Emittable>().GetDataAs<MLIRContext::EmittableInfo*>()->data), dimension);
+    }
+
+    void Cache::AddEpilogueScale(double scale)
+    {
+        _impl->AddEpilogueScale(scale);
+    }
+
+    void Cache::AddEpilogueClamp(std::optional<double> min, std::optional<double> max)
+    {
+        _impl->AddEpilogueClamp(min, max);
+    }
+
 } // namespace value
 } // namespace accera
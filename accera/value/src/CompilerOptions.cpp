@@ -27,6 +27,8 @@ namespace value
             .Case("CUDA", ExecutionRuntime::CUDA)
             .Case("None", ExecutionRuntime::NONE)
             .Case("OpenMP", ExecutionRuntime::OPENMP)
+            .Case("ThreadPool", ExecutionRuntime::THREAD_POOL)
+            .Case("OpenCL", ExecutionRuntime::OPENCL)
             .Default(ExecutionRuntime::DEFAULT);
     }
 
@@ -62,6 +64,8 @@ namespace value
         debug = properties.GetOrParseEntry<bool>("debug", debug);
         gpu_only = properties.GetOrParseEntry<bool>("gpu_only", gpu_only);
         globalValueAlignment = properties.GetOrParseEntry<int>("globalValueAlignment", globalValueAlignment);
+        hugePageThreshold = properties.GetOrParseEntry<int64_t>("hugePageThreshold", hugePageThreshold);
+        streamingEmission = properties.GetOrParseEntry<bool>("streamingEmission", streamingEmission);
 
         if (properties.HasEntry("deviceName"))
         {
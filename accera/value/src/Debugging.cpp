@@ -7,7 +7,9 @@
 #include "Debugging.h"
 #include "MLIREmitterContext.h"
 #include "Nest.h"
+#include "Plan.h"
 #include "Schedule.h"
+#include "ValueOperations.h"
 
 #include <ir/include/IRUtil.h>
 
@@ -47,7 +49,7 @@ namespace value
     // Compares two arrays by checking whether they are equal up to the specified tolerance
     // Outputs mismatches to stderr
     // Inspired by numpy.testing.assert_allclose
-    void CheckAllClose(Array actual, Array desired, float tolerance)
+    void CheckAllClose(Array actual, Array desired, float tolerance, int64_t numThreads, const std::optional<VectorizationInformation>& vectorizationInfo)
     {
         using namespace std::string_literals;
 
@@ -55,6 +57,12 @@ namespace value
         auto atol = Scalar(tolerance);
         auto diff = MakeArray(actual.Shape(), ValueType::Float, "diff");
 
+        // Each slice along the outermost dimension is reduced into its own maximum and count, so that the slices
+        // are compared in parallel
+        auto numSlices = actual.Shape()[0];
+        auto sliceMaxAbsoluteDiff = MakeArray(MemoryShape{ numSlices }, diff.GetType(), "sliceMaxAbsoluteDiff");
+        auto sliceCount = MakeArray(MemoryShape{ numSlices }, ValueType::Int32, "sliceCount");
+
         // BUGBUG: Scalar binary ops pointer deferencing error, using Arrays as a workaround
         auto maxAbsoluteDiff = MakeArray(MemoryShape{ 1 }, diff.GetType(), "maxAbsoluteDiff");
         auto count = MakeArray(MemoryShape{ 1 }, ValueType::Int32, "count");
@@ -65,13 +73,62 @@ namespace value
         auto oneCount = Cast(Scalar(1), count.GetType());
         auto total = Cast(Scalar(actual.Size()), count.GetType());
 
-        Nest nest(actual.Shape());
-        auto indices = nest.GetIndices();
-        nest.Set([&]() {
-            diff(indices) = Cast(actual(indices) - desired(indices), diff.GetType());
-            diff(indices) = Clamp(Abs(diff(indices)), zero, max); // over/underflow
-            maxAbsoluteDiff(0) = Select(maxAbsoluteDiff(0) >= diff(indices), maxAbsoluteDiff(0), diff(indices));
-            count(0) += Select(diff(indices) <= atol, zeroCount, oneCount);
+        // The differences are independent, so they are computed in parallel and vectorized along the innermost dimension
+        {
+            Nest nest(actual.Shape());
+            auto indices = nest.GetIndices();
+            nest.Set([&]() {
+                diff(indices) = Cast(actual(indices) - desired(indices), diff.GetType());
+                diff(indices) = Clamp(Abs(diff(indices)), zero, max); // over/underflow
+            });
+
+            auto schedule = nest.CreateSchedule();
+            auto innermost = indices.back();
+            auto innermostSize = actual.Shape()[actual.Rank() - 1];
+            auto vectorSize = vectorizationInfo ? vectorizationInfo->vectorBytes / static_cast<int64_t>(sizeof(float)) : 0;
+            std::optional<ScalarIndex> vectorIndex;
+            if (vectorSize > 1 && innermostSize > vectorSize)
+            {
+                auto [innermostOuter, innermostInner] = schedule.Split(innermost, static_cast<int>(vectorSize));
+                vectorIndex = innermostInner;
+                if (actual.Rank() == 1)
+                {
+                    indices.front() = innermostOuter;
+                }
+            }
+
+            auto plan = schedule.CreatePlan();
+            if (vectorIndex)
+            {
+                plan.Vectorize(*vectorIndex, *vectorizationInfo);
+            }
+            if (numThreads > 1)
+            {
+                plan.Parallelize({ indices.front() }, numThreads, ParallelizationPolicy::Static);
+            }
+        }
+
+        // The differences of each slice are reduced in parallel with the other slices
+        {
+            Nest nest(actual.Shape());
+            auto indices = nest.GetIndices();
+            auto slice = indices.front();
+            nest.Set([&]() {
+                sliceMaxAbsoluteDiff(slice) = Select(sliceMaxAbsoluteDiff(slice) >= diff(indices), sliceMaxAbsoluteDiff(slice), diff(indices));
+                sliceCount(slice) += Select(diff(indices) <= atol, zeroCount, oneCount);
+            });
+
+            auto schedule = nest.CreateSchedule();
+            auto plan = schedule.CreatePlan();
+            if (numThreads > 1)
+            {
+                plan.Parallelize({ slice }, numThreads, ParallelizationPolicy::Static);
+            }
+        }
+
+        For(0, static_cast<int>(numSlices), 1, [&](Scalar slice) {
+            maxAbsoluteDiff(0) = Select(maxAbsoluteDiff(0) >= sliceMaxAbsoluteDiff(slice), maxAbsoluteDiff(0), sliceMaxAbsoluteDiff(slice));
+            count(0) += sliceCount(slice);
         });
 
         If(count(0) > zeroCount, [&]() {
@@ -97,6 +154,20 @@ namespace value
         .Else([&] {
             Print("\nOK (no mismatches detected)\n"s);
         });
+    }
+
+    void CopyUnsampledSlices(Array source, Array destination, int64_t dimension, int64_t stride)
+    {
+        ThrowIfNot(source.Shape() == destination.Shape());
+
+        Nest nest(destination.Shape());
+        auto indices = nest.GetIndices();
+        nest.Set([&]() {
+            auto index = indices[dimension];
+            If(index % Cast(Scalar(stride), index.GetType()) != Cast(Scalar(0), index.GetType()), [&]() {
+                destination(indices) = source(indices);
+            });
+        });
 
         auto schedule = nest.CreateSchedule();
     }
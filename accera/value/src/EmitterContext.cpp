@@ -140,14 +140,14 @@ namespace value
 
     Value EmitterContext::ResolveConstantDataReference(Value source) { return ResolveConstantDataReferenceImpl(source); }
 
-    void EmitterContext::For(MemoryLayout layout, std::function<void(std::vector<Scalar>)> fn, const std::string& name)
+    void EmitterContext::For(MemoryLayout layout, std::function<void(const std::vector<Scalar>&)> fn, const std::string& name)
     {
         if (layout.NumElements() == 0)
         {
             return;
         }
 
-        return ForImpl(layout, fn, name);
+        return ForImpl(layout, std::move(fn), name);
     }
 
     void EmitterContext::For(Scalar start, Scalar stop, Scalar step, std::function<void(Scalar)> fn, const std::string& name)
@@ -162,7 +162,7 @@ namespace value
             throw InputException(InputExceptionErrors::invalidArgument, "start/stop/step must not be boolean");
         }
 
-        return ForImpl(start, stop, step, fn, name);
+        return ForImpl(start, stop, step, std::move(fn), name);
     }
 
     void EmitterContext::MoveData(Value& source, Value& destination) { return MoveDataImpl(source, destination); }
@@ -171,12 +171,12 @@ namespace value
 
     Value EmitterContext::View(Value source, const std::vector<Scalar>& offsets, const MemoryShape& newShape, const std::vector<int64_t>& strides)
     {
-        return ViewImpl(source, offsets, newShape, strides);
+        return ViewImpl(std::move(source), offsets, newShape, strides);
     }
 
-    Value EmitterContext::Slice(Value source, std::vector<int64_t> slicedDimensions, std::vector<Scalar> sliceOffsets)
+    Value EmitterContext::Slice(Value source, const std::vector<int64_t>& slicedDimensions, const std::vector<Scalar>& sliceOffsets)
     {
-        return SliceImpl(source, slicedDimensions, sliceOffsets);
+        return SliceImpl(std::move(source), slicedDimensions, sliceOffsets);
     }
 
     Value EmitterContext::MergeDimensions(Value source, int64_t dim1, int64_t dim2)
@@ -362,20 +362,25 @@ namespace value
         ImportCodeFileImpl(file);
     }
 
+    EmitterStats EmitterContext::GetStats() const
+    {
+        return GetStatsImpl();
+    }
+
     std::string EmitterContext::UniqueName(const std::string& prefix)
     {
         auto uniqueId = _uniqueNames[prefix]++;
         return prefix + "_" + std::to_string(uniqueId);
     }
 
-    Scalar EmitterContext::Max(Vector input)
+    Scalar EmitterContext::Max(Vector input, const std::optional<VectorizationInformation>& vectorizationInfo, int64_t accumulators)
     {
-        return MaxImpl(input);
+        return MaxImpl(input, vectorizationInfo, accumulators);
     }
 
-    Scalar EmitterContext::Sum(Vector input)
+    Scalar EmitterContext::Sum(Vector input, const std::optional<VectorizationInformation>& vectorizationInfo, int64_t accumulators)
     {
-        return SumImpl(input);
+        return SumImpl(input, vectorizationInfo, accumulators);
     }
 
     void swap(EmitterContext& l, EmitterContext& r) noexcept
@@ -467,7 +472,7 @@ namespace value
         GetContext().For(start, end, step, fn, name);
     }
 
-    void ForRanges(std::vector<Scalar> range_ends, std::function<void(std::vector<Scalar>)> fn)
+    void ForRanges(const std::vector<Scalar>& range_ends, std::function<void(const std::vector<Scalar>&)> fn)
     {
         const auto N = range_ends.size();
         std::vector<Scalar> iter_idxs(N);
@@ -561,5 +566,33 @@ namespace value
         return GetContext().UniqueName(prefix);
     }
 
+    std::vector<Scalar> MultiReduce(const Array& a, std::vector<Scalar> init, std::function<std::vector<Scalar>(Scalar, std::vector<Scalar>)> reduceFn, std::function<std::vector<Scalar>(std::vector<Scalar>, std::vector<Scalar>)> combineFn, int64_t lanes)
+    {
+        auto toScalars = [](const std::vector<ViewAdapter>& views) {
+            std::vector<Scalar> scalars;
+            scalars.reserve(views.size());
+            for (const auto& view : views)
+            {
+                scalars.emplace_back(view.GetValue());
+            }
+            return scalars;
+        };
+        auto toViews = [](const std::vector<Scalar>& scalars) {
+            return std::vector<ViewAdapter>(scalars.begin(), scalars.end());
+        };
+
+        auto results = GetContext().MultiReduce(
+            a,
+            toViews(init),
+            [&](ViewAdapter value, std::vector<ViewAdapter> iterValues) {
+                return toViews(reduceFn(value.GetValue(), toScalars(iterValues)));
+            },
+            [&](std::vector<ViewAdapter> lhs, std::vector<ViewAdapter> rhs) {
+                return toViews(combineFn(toScalars(lhs), toScalars(rhs)));
+            },
+            lanes);
+        return toScalars(results);
+    }
+
 } // namespace value
 } // namespace accera
@@ -68,6 +68,150 @@ namespace value
             // TODO: assert f is float32
             return Bitcast(f, ValueType::Int32);
         }
+
+        // The approximations rely on the float32 bit layout, so float16 and bfloat16 values are evaluated in float32
+        template <typename Fn>
+        Scalar EvaluateInFloat32(Scalar s, Fn&& fn)
+        {
+            if (auto type = s.GetType(); type == ValueType::Float16 || type == ValueType::BFloat16)
+            {
+                return Cast(fn(Cast(s, ValueType::Float)), type);
+            }
+            return fn(s);
+        }
+
+        Scalar ExpFloat32Low(Scalar a)
+        {
+            // exp(a) = 2**m * exp(f); m = rintf (a / log(2)), with a clamped so that 2**m is a normal float
+            auto x = Clamp(a, -87.3f, 88.3f);
+            auto biased = Fma(x, MlasExpConstants.Log2Reciprocal, MlasExpConstants.RoundingBias);
+            auto m = biased - MlasExpConstants.RoundingBias;
+            auto f = Fma(m, MlasExpConstants.Log2High, x);
+            f = Fma(m, MlasExpConstants.Log2Low, f);
+
+            // degree 4 Taylor polynomial of exp(f) on [-log(2)/2, +log(2)/2], relative error below 5e-5
+            Scalar p = 4.16666667e-2f;
+            p = Fma(p, f, 1.66666667e-1f);
+            p = Fma(p, f, 5.00000000e-1f);
+            p = Fma(p, f, 1.00000000e+0f);
+            p = Fma(p, f, 1.00000000e+0f);
+
+            // the low bits of biased hold m, shift them to the exponent field
+            auto scale = ShiftLeft(FloatAsInt(biased), 23) + MlasExpConstants.MaximumExponent;
+            return p * IntAsFloat(scale);
+        }
+
+        Scalar ExpFloat32(Scalar a, FastMathAccuracy accuracy)
+        {
+            return accuracy == FastMathAccuracy::Low ? ExpFloat32Low(a) : FastExp(a);
+        }
+
+        Scalar LogFloat32(Scalar a, FastMathAccuracy accuracy)
+        {
+            // log(a) = e * log(2) + log(m); a = 2**e * m, with m in [sqrt(2)/2, sqrt(2))
+            auto ia = FloatAsInt(a);
+            auto biasedExponent = SignedShiftRight(ia, 23);
+            auto m = IntAsFloat(ia - ShiftLeft(biasedExponent, 23) + MlasExpConstants.MaximumExponent);
+            auto e = Cast(biasedExponent - 127, ValueType::Float);
+            auto isLarge = m > 1.41421356f;
+            m = Select(isLarge, m * 0.5f, m);
+            e = Select(isLarge, e + 1.0f, e);
+
+            // log(m) = 2 * atanh(t); t = (m - 1) / (m + 1) in [-0.1716, 0.1716]
+            // The odd Taylor series of atanh(t) has an error below 2e-6 after the t**5 term, and below 1e-9 after the t**9 term
+            auto t = (m - 1.0f) / (m + 1.0f);
+            auto t2 = t * t;
+            Scalar p = 2.00000000e-1f;
+            if (accuracy == FastMathAccuracy::High)
+            {
+                p = 1.11111111e-1f;
+                p = Fma(p, t2, 1.42857143e-1f);
+                p = Fma(p, t2, 2.00000000e-1f);
+            }
+            p = Fma(p, t2, 3.33333333e-1f);
+            p = Fma(p, t2, 1.00000000e+0f);
+            auto logM = (t + t) * p;
+
+            // log(2) is split into 0.693359375, which multiplies e exactly, and a small remainder
+            auto r = Fma(e, -2.12194440e-4f, logM);
+            r = Fma(e, 0.693359375f, r);
+
+            if (accuracy == FastMathAccuracy::High)
+            {
+                // handle special cases: log(0) = -inf, log(a < 0) = nan
+                auto negativeResult = IntAsFloat(Select(a == 0.0f, Scalar((int32_t)0xff800000), Scalar((int32_t)0x7fc00000)));
+                r = Select(a <= 0.0f, negativeResult, r);
+            }
+            return r;
+        }
+
+        Scalar TanhFloat32(Scalar a, FastMathAccuracy accuracy)
+        {
+            // tanh(|a|) = 1 - 2 / (exp(2|a|) + 1), which rounds to 1 for |a| > 9
+            auto absA = Min(Abs(a), 9.0f);
+            auto r = 1.0f - 2.0f / (ExpFloat32(absA + absA, accuracy) + 1.0f);
+            r = Select(a < 0.0f, -r, r);
+            if (accuracy == FastMathAccuracy::Low)
+            {
+                return r;
+            }
+
+            // the subtraction above cancels for small |a|, which uses the odd polynomial of Cephes' tanhf instead
+            auto a2 = a * a;
+            Scalar p = -5.70498872745e-3f;
+            p = Fma(p, a2, 2.06390887954e-2f);
+            p = Fma(p, a2, -5.37397155531e-2f);
+            p = Fma(p, a2, 1.33314422036e-1f);
+            p = Fma(p, a2, -3.33332819422e-1f);
+            auto smallResult = Fma(p * a2, a, a);
+            return Select(absA < 0.625f, smallResult, r);
+        }
+
+        Scalar SigmoidFloat32(Scalar a, FastMathAccuracy accuracy)
+        {
+            return 1.0f / (1.0f + ExpFloat32(-a, accuracy));
+        }
+
+        Scalar ErfFloat32(Scalar a, FastMathAccuracy accuracy)
+        {
+            // Abramowitz and Stegun 7.1.26, absolute error below 1.5e-7
+            auto absA = Abs(a);
+            auto t = 1.0f / Fma(absA, 0.3275911f, 1.0f);
+            Scalar p = 1.061405429f;
+            p = Fma(p, t, -1.453152027f);
+            p = Fma(p, t, 1.421413741f);
+            p = Fma(p, t, -0.284496736f);
+            p = Fma(p, t, 0.254829592f);
+            auto r = 1.0f - p * t * ExpFloat32(-(absA * absA), accuracy);
+            r = Select(a < 0.0f, -r, r);
+            if (accuracy == FastMathAccuracy::Low)
+            {
+                return r;
+            }
+
+            // the absolute error above is a large relative error for small |a|, which uses the Taylor series of erf instead:
+            // erf(a) = 2 / sqrt(pi) * (a - a**3 / 3 + a**5 / 10 - a**7 / 42 + a**9 / 216 - a**11 / 1320 ...)
+            auto a2 = a * a;
+            Scalar s = -7.57575758e-4f;
+            s = Fma(s, a2, 4.62962963e-3f);
+            s = Fma(s, a2, -2.38095238e-2f);
+            s = Fma(s, a2, 1.00000000e-1f);
+            s = Fma(s, a2, -3.33333333e-1f);
+            s = Fma(s, a2, 1.00000000e+0f);
+            auto smallResult = s * a * 1.12837917f;
+            return Select(absA < 0.5f, smallResult, r);
+        }
+
+        Scalar GeluFloat32(Scalar a, FastMathAccuracy accuracy)
+        {
+            if (accuracy == FastMathAccuracy::Low)
+            {
+                // gelu(a) ~= a * (1 + tanh(sqrt(2 / pi) * (a + 0.044715 * a**3))) / 2
+                auto inner = a * Fma(a * a, 3.56774081e-2f, 7.97884561e-1f);
+                return a * 0.5f * (1.0f + TanhFloat32(inner, accuracy));
+            }
+            return a * 0.5f * (1.0f + ErfFloat32(a * 7.07106781e-1f, accuracy));
+        }
     } // namespace
 
     Scalar FastExp(Scalar a)
@@ -179,5 +323,35 @@ namespace value
 #endif
         return p;
     }
+
+    Scalar FastExp(Scalar s, FastMathAccuracy accuracy)
+    {
+        return EvaluateInFloat32(s, [=](Scalar x) { return ExpFloat32(x, accuracy); });
+    }
+
+    Scalar FastLog(Scalar s, FastMathAccuracy accuracy)
+    {
+        return EvaluateInFloat32(s, [=](Scalar x) { return LogFloat32(x, accuracy); });
+    }
+
+    Scalar FastTanh(Scalar s, FastMathAccuracy accuracy)
+    {
+        return EvaluateInFloat32(s, [=](Scalar x) { return TanhFloat32(x, accuracy); });
+    }
+
+    Scalar FastSigmoid(Scalar s, FastMathAccuracy accuracy)
+    {
+        return EvaluateInFloat32(s, [=](Scalar x) { return SigmoidFloat32(x, accuracy); });
+    }
+
+    Scalar FastErf(Scalar s, FastMathAccuracy accuracy)
+    {
+        return EvaluateInFloat32(s, [=](Scalar x) { return ErfFloat32(x, accuracy); });
+    }
+
+    Scalar FastGelu(Scalar s, FastMathAccuracy accuracy)
+    {
+        return EvaluateInFloat32(s, [=](Scalar x) { return GeluFloat32(x, accuracy); });
+    }
 } // namespace value
 } // namespace accera
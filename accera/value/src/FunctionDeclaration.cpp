@@ -141,6 +141,46 @@ namespace value
         return *this;
     }
 
+    FunctionDeclaration& FunctionDeclaration::AsyncAPI(bool asyncAPI)
+    {
+        CheckNonEmpty();
+
+        _asyncAPI = asyncAPI;
+        return *this;
+    }
+
+    FunctionDeclaration& FunctionDeclaration::NonTemporalWriteBack(bool nonTemporalWriteBack)
+    {
+        CheckNonEmpty();
+
+        _nonTemporalWriteBack = nonTemporalWriteBack;
+        return *this;
+    }
+
+    FunctionDeclaration& FunctionDeclaration::WorkspaceAPI(bool workspaceAPI)
+    {
+        CheckNonEmpty();
+
+        _workspaceAPI = workspaceAPI;
+        return *this;
+    }
+
+    FunctionDeclaration& FunctionDeclaration::NoAlias(bool noAlias)
+    {
+        CheckNonEmpty();
+
+        _noAlias = noAlias;
+        return *this;
+    }
+
+    FunctionDeclaration& FunctionDeclaration::GPUGraph(bool gpuGraph)
+    {
+        CheckNonEmpty();
+
+        _gpuGraph = gpuGraph;
+        return *this;
+    }
+
     FunctionDeclaration& FunctionDeclaration::AddTag(const std::string& tag)
     {
         CheckNonEmpty();
@@ -157,6 +197,38 @@ namespace value
         return *this;
     }
 
+    FunctionDeclaration& FunctionDeclaration::TargetCPU(const std::string& cpu, const std::string& features)
+    {
+        CheckNonEmpty();
+
+        _targetCPU = cpu;
+        _targetFeatures = features;
+        return *this;
+    }
+
+    FunctionDeclaration& FunctionDeclaration::ParameterAlignments(const std::vector<int64_t>& alignments)
+    {
+        CheckNonEmpty();
+
+        for (auto alignment : alignments)
+        {
+            if (alignment < 0 || (alignment & (alignment - 1)) != 0)
+            {
+                throw InputException(InputExceptionErrors::invalidArgument, "Parameter alignments must be powers of two");
+            }
+        }
+        _paramAlignments = alignments;
+        return *this;
+    }
+
+    FunctionDeclaration& FunctionDeclaration::SpecializedArguments(const std::vector<std::optional<double>>& values)
+    {
+        CheckNonEmpty();
+
+        _specializedArgs = values;
+        return *this;
+    }
+
     std::optional<Value> FunctionDeclaration::Call(std::vector<ViewAdapter> arguments) const
     {
         CheckNonEmpty();
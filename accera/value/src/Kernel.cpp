@@ -30,7 +30,7 @@ namespace value
             auto realKernelFn = [&](mlir::OpBuilder& bodyBuilder, mlir::Location) {
                 mlir::OpBuilder::InsertionGuard guard(builder);
                 builder.restoreInsertionPoint(bodyBuilder.saveInsertionPoint());
-                kernelFn();
+                ::accera::value::GetMLIRContext().EmitScopedBody(bodyBuilder.getInsertionBlock()->getParentOp(), kernelFn);
             };
 
             _op = MakeKernel(builder, id, realKernelFn);
@@ -53,11 +53,15 @@
 #include <mlir/Support/LLVM.h>
 #include <mlir/Support/LogicalResult.h>
 
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/SmallString.h>
 #include <llvm/ADT/SmallVector.h>
 #include <llvm/ADT/StringRef.h>
 #include <llvm/ADT/TypeSwitch.h>
 #include <llvm/Support/Debug.h>
 #include <llvm/Support/ErrorHandling.h>
+#include <llvm/Support/Path.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/raw_os_ostream.h>
 
@@ -125,6 +129,8 @@ mlir::Type ToMLIRType(mlir::OpBuilder& builder, ValueType type)
         return builder.getIndexType();
     case ValueType::Float16:
         return builder.getF16Type();
+    case ValueType::BFloat16:
+        return builder.getBF16Type();
     case ValueType::Float:
         return builder.getF32Type();
     case ValueType::Double:
@@ -416,6 +422,14 @@ void SetOpNameAttr(mlir::Operation* op, std::string name)
     }
 }
 
+llvm::APFloat ToBFloat16(bfloat16_t value)
+{
+    bool losesInfo = false;
+    auto f = llvm::APFloat(value.data);
+    f.convert(llvm::APFloat::BFloat(), llvm::APFloat::rmNearestTiesToEven, &losesInfo);
+    return f;
+}
+
 auto GetConstantDataElementType(const ConstantData& data)
 {
     return std::visit(
@@ -454,6 +468,13 @@ auto ConstantDataToDenseElementAttr(mlir::ShapedType shape, const ConstantData&
 
                 return mlir::DenseElementsAttr::get(shape, llvm::makeArrayRef(fp16Data));
             }
+            else if constexpr (std::is_same_v<ElementType, bfloat16_t>)
+            {
+                std::vector<llvm::APFloat> bf16Data;
+                std::transform(data.begin(), data.end(), std::back_inserter(bf16Data), [](bfloat16_t value) { return ToBFloat16(value); });
+
+                return mlir::DenseElementsAttr::get(shape, llvm::makeArrayRef(bf16Data));
+            }
             else
             {
                 return mlir::DenseElementsAttr::get(shape, llvm::makeArrayRef(data));
@@ -664,6 +685,7 @@ MLIRContext::EmittableInfo& MLIRContext::StoreGlobalEmittable(EmittableInfo emit
     std::lock_guard lock{ _mutex };
 
     _globalEmittables.push_front(emittable);
+    ++_numGlobalEmittables;
     return _globalEmittables.front();
 }
 
@@ -671,8 +693,89 @@ MLIRContext::EmittableInfo& MLIRContext::StoreLocalEmittable(EmittableInfo emitt
 {
     std::lock_guard lock{ _mutex };
     assert(!_localEmittables.empty());
-    _localEmittables.top().push_front(emittable);
-    return _localEmittables.top().front();
+    auto& scope = _localEmittables.top();
+
+    // The info of an emittable doesn't change once it's stored, so the values that wrap the same value can share it
+    auto streaming = GetCompilerOptions().streamingEmission;
+    if (streaming)
+    {
+        if (auto it = scope.index.find({ emittable.data, emittable.desc }); it != scope.index.end())
+        {
+            ++_reusedLocalEmittables;
+            return *it->second;
+        }
+    }
+
+    auto& info = scope.emittables.emplace_front(emittable);
+    if (streaming)
+    {
+        scope.index[{ info.data, info.desc }] = &info;
+    }
+    _peakLocalEmittables = std::max(_peakLocalEmittables, ++_numLocalEmittables);
+    return info;
+}
+
+void MLIRContext::PushLocalEmittableScope()
+{
+    std::lock_guard lock{ _mutex };
+    _localEmittables.push({});
+}
+
+void MLIRContext::PopLocalEmittableScope(mlir::Operation* scopeOp)
+{
+    std::lock_guard lock{ _mutex };
+    assert(!_localEmittables.empty());
+    auto scope = std::move(_localEmittables.top());
+    _localEmittables.pop();
+
+    if (scopeOp)
+    {
+        assert(!_localEmittables.empty());
+        auto& parentScope = _localEmittables.top();
+        for (auto it = scope.emittables.begin(); it != scope.emittables.end();)
+        {
+            auto next = std::next(it);
+            auto value = mlir::Value::getFromOpaquePointer(it->data);
+            if (!scopeOp->isAncestor(value.getParentRegion()->getParentOp()))
+            {
+                // Splicing keeps the info where it is, so the values that refer to it stay valid
+                parentScope.emittables.splice(parentScope.emittables.begin(), scope.emittables, it);
+                parentScope.index.try_emplace({ it->data, it->desc }, &*it);
+            }
+            it = next;
+        }
+    }
+
+    _releasedLocalEmittables += scope.emittables.size();
+    _numLocalEmittables -= scope.emittables.size();
+}
+
+void MLIRContext::EmitScopedBody(mlir::Operation* scopeOp, std::function<void()> fn)
+{
+    if (!GetCompilerOptions().streamingEmission)
+    {
+        fn();
+        return;
+    }
+
+    PushLocalEmittableScope();
+    fn();
+    PopLocalEmittableScope(scopeOp);
+}
+
+EmitterStats MLIRContext::GetStatsImpl() const
+{
+    std::lock_guard lock{ _mutex };
+
+    EmitterStats stats;
+    stats.localEmittables = _numLocalEmittables;
+    stats.peakLocalEmittables = _peakLocalEmittables;
+    stats.releasedLocalEmittables = _releasedLocalEmittables;
+    stats.reusedLocalEmittables = _reusedLocalEmittables;
+    stats.globalEmittables = _numGlobalEmittables;
+    stats.emittableScopes = _localEmittables.size();
+    stats.definedFunctions = _definedFunctions.size();
+    return stats;
 }
 
 MLIRContext::MLIRContext(const std::string& moduleName, const CompilerOptions& options) :
@@ -680,8 +783,10 @@ MLIRContext::MLIRContext(const std::string& moduleName, const CompilerOptions& o
     EmitterContext(options)
 {
     setDataLayout(options);
+    setExecutionRuntime(options.executionRuntime);
     setDebugMode(options.debug);
-    _localEmittables.push({});
+    setHugePageThreshold(options.hugePageThreshold);
+    PushLocalEmittableScope();
 }
 
 MLIRContext::MLIRContext(mlir::ModuleOp& existingModule, const CompilerOptions& options) :
@@ -689,8 +794,10 @@ MLIRContext::MLIRContext(mlir::ModuleOp& existingModule, const CompilerOptions&
     EmitterContext(options)
 {
     setDataLayout(options);
+    setExecutionRuntime(options.executionRuntime);
     setDebugMode(options.debug);
-    _localEmittables.push({});
+    setHugePageThreshold(options.hugePageThreshold);
+    PushLocalEmittableScope();
 }
 
 MLIRContext::~MLIRContext() = default;
@@ -745,6 +852,36 @@ void MLIRContext::writeHeader(std::optional<std::string> filename) const
     (void)ir::TranslateToHeader(_impl->_mlirModule, stream);
 }
 
+void MLIRContext::writeMappedBuffers(const std::string& directory) const
+{
+    _impl->_mlirModule.walk([&](ir::value::GlobalOp globalOp) {
+        auto fileAttr = globalOp->getAttrOfType<mlir::StringAttr>(ir::MappedFileAttrName);
+        if (!fileAttr)
+        {
+            return;
+        }
+
+        llvm::SmallString<256> path(directory);
+        llvm::sys::path::append(path, fileAttr.getValue());
+
+        std::error_code ec;
+        llvm::raw_fd_ostream fstream(path, ec);
+        if (ec)
+        {
+            throw SystemException(SystemExceptionErrors::fileNotWritable, "Cannot write packed buffer file " + path.str().str());
+        }
+
+        // The file holds the elements in the packed layout, the same bytes the constant global would have had in the binary
+        auto data = globalOp.value()->cast<mlir::DenseElementsAttr>();
+        auto rawData = data.getRawData();
+        auto numCopies = data.isSplat() ? data.getNumElements() : 1;
+        for (int64_t copy = 0; copy < numCopies; ++copy)
+        {
+            fstream.write(rawData.data(), rawData.size());
+        }
+    });
+}
+
 void MLIRContext::setMetadata(const std::string& key, const accera::ir::MetadataValueType& value)
 {
     auto context = _impl->_valueModuleOp.getContext();
@@ -779,6 +916,27 @@ void MLIRContext::setDataLayout(const CompilerOptions& options)
     }
 }
 
+void MLIRContext::setExecutionRuntime(ExecutionRuntime runtime)
+{
+    // GPU runtimes are recorded when a function is targeted at the GPU, only the thread pool applies module-wide
+    if (runtime == ExecutionRuntime::THREAD_POOL)
+    {
+        auto context = _impl->_valueModuleOp.getContext();
+        _impl->_valueModuleOp->setAttr(
+            ir::value::ValueModuleOp::getExecRuntimeAttrName(),
+            ir::value::ExecutionRuntimeAttr::get(context, (ir::value::ExecutionRuntime)runtime));
+    }
+}
+
+void MLIRContext::setHugePageThreshold(int64_t threshold)
+{
+    if (threshold > 0)
+    {
+        auto& builder = _impl->builder;
+        _impl->_valueModuleOp->setAttr(ir::HugePageThresholdAttrName, builder.getI64IntegerAttr(threshold));
+    }
+}
+
 void MLIRContext::setDebugMode(bool enable)
 {
     auto& builder = _impl->builder;
@@ -794,7 +952,7 @@ void MLIRContext::setDebugMode(bool enable)
     }
 }
 
-void MLIRContext::EmitDebugFunction(const std::string& functionName, const std::vector<std::string>& utilityFunctionNames)
+void MLIRContext::EmitDebugFunction(const std::string& functionName, const std::vector<std::string>& utilityFunctionNames, int64_t numThreads, const std::optional<VectorizationInformation>& vectorizationInfo, int64_t sampleStride)
 {
     for (const auto& fn : _definedFunctions)
     {
@@ -802,7 +960,7 @@ void MLIRContext::EmitDebugFunction(const std::string& functionName, const std::
         if (fn.first.GetFunctionName().compare(0, functionName.length(), functionName) == 0)
         {
             // Do a best effort emitting of the debug function
-            EmitNestDebugFunction(fn.first, utilityFunctionNames);
+            EmitNestDebugFunction(fn.first, utilityFunctionNames, numThreads, vectorizationInfo, sampleStride);
         }
     }
 }
@@ -868,6 +1026,10 @@ Value MLIRContext::AllocateImpl(ValueType valueType, MemoryLayout layout, size_t
                                                       static_cast<bool>(flags & AllocateFlags::Stack)
                                                           ? llvm::Optional{ accera::ir::value::MemoryAllocType::Stack }
                                                           : llvm::None);
+    if (static_cast<bool>(flags & AllocateFlags::HugePages))
+    {
+        result.getDefiningOp()->setAttr(ir::HugePagesAttrName, b.getUnitAttr());
+    }
 
     EmittableInfo& emittableInfo = StoreLocalEmittable({ result.getAsOpaquePointer(), { valueType, 1 } });
     Emittable emittable{ &emittableInfo };
@@ -933,6 +1095,10 @@ Value MLIRContext::GlobalAllocateImpl(GlobalAllocationScope allocScope, std::str
     auto memrefType = MemoryLayoutToMemRefType(builder, layout, type);
 
     auto global = builder.create<ir::value::GlobalOp>(loc, memrefType, /*isConstant=*/false, adjustedName, mlir::Attribute{});
+    if (static_cast<bool>(flags & AllocateFlags::HugePages))
+    {
+        global->setAttr(ir::HugePagesAttrName, builder.getUnitAttr());
+    }
 
     EmittableInfo& emittableInfo = StoreGlobalEmittable({ global, { type, 1 } });
     Emittable emittable(&emittableInfo);
@@ -1011,10 +1177,34 @@ EmitterContext::DefinedFunction MLIRContext::CreateFunctionImpl(FunctionDeclarat
             {
                 fnOp->setAttr(ir::HeaderDeclAttrName, b.getUnitAttr());
             }
+            if (decl.EmitsAsyncAPI())
+            {
+                fnOp->setAttr(ir::AsyncAPIAttrName, b.getUnitAttr());
+            }
+            if (decl.UsesNonTemporalWriteBack())
+            {
+                fnOp->setAttr(ir::NonTemporalWriteBackAttrName, b.getUnitAttr());
+            }
+            if (decl.UsesWorkspaceAPI())
+            {
+                fnOp->setAttr(ir::WorkspaceAPIAttrName, b.getUnitAttr());
+            }
+            if (decl.HasNoAliasArguments())
+            {
+                fnOp->setAttr(ir::NoAliasAttrName, b.getUnitAttr());
+            }
+            if (decl.CapturesGPUGraph())
+            {
+                fnOp->setAttr(ir::GPUGraphAttrName, b.getUnitAttr());
+            }
             if (decl.InlineState() == FunctionInlining::never)
             {
                 fnOp->setAttr(ir::NoInlineAttrName, b.getUnitAttr());
             }
+            else if (decl.InlineState() == FunctionInlining::automatic)
+            {
+                fnOp->setAttr(ir::InlineAutoAttrName, b.getUnitAttr());
+            }
 
             // Collect function tags into a dictionary
             auto tags = decl.GetTags();
@@ -1034,6 +1224,27 @@ EmitterContext::DefinedFunction MLIRContext::CreateFunctionImpl(FunctionDeclarat
                 fnOp->setAttr(ir::BaseNameAttrName, b.getStringAttr(baseName));
             }
 
+            if (auto targetCPU = decl.GetTargetCPU(); !targetCPU.empty())
+            {
+                fnOp->setAttr(ir::TargetCPUAttrName, b.getStringAttr(targetCPU));
+                fnOp->setAttr(ir::TargetFeaturesAttrName, b.getStringAttr(decl.GetTargetFeatures()));
+            }
+
+            if (auto alignments = decl.GetParameterAlignments(); !alignments.empty())
+            {
+                fnOp->setAttr(ir::ArgumentAlignmentsAttrName, b.getI64ArrayAttr(alignments));
+            }
+
+            if (auto specializedArgs = decl.GetSpecializedArguments(); !specializedArgs.empty())
+            {
+                std::vector<mlir::Attribute> values;
+                for (const auto& value : specializedArgs)
+                {
+                    values.push_back(value ? mlir::Attribute{ b.getF64FloatAttr(*value) } : mlir::Attribute{ b.getUnitAttr() });
+                }
+                fnOp->setAttr(ir::SpecializedArgumentsAttrName, b.getArrayAttr(values));
+            }
+
             if constexpr (std::is_same_v<decltype(target), targets::GPU>)
             {
                 if (funcRuntime != ExecutionRuntime::DEFAULT)
@@ -1064,10 +1275,7 @@ EmitterContext::DefinedFunction MLIRContext::CreateFunctionImpl(FunctionDeclarat
         mlir::OpBuilder::InsertionGuard guard(b);
         b.restoreInsertionPoint({ entryBlock, entryBlock->begin() });
 
-        {
-            std::lock_guard lock{ _mutex };
-            _localEmittables.push({});
-        }
+        PushLocalEmittableScope();
 
         for (auto zipped : llvm::zip(argValuesCopy, entryBlock->getArguments()))
         {
@@ -1077,6 +1285,16 @@ EmitterContext::DefinedFunction MLIRContext::CreateFunctionImpl(FunctionDeclarat
             value.SetData(emittable);
         }
 
+        // Lets LLVM assume the alignment of the data of the arguments, so that the vector loads and stores of them,
+        // e.g. those of the cache copies, are emitted as aligned
+        for (auto [alignment, arg] : llvm::zip(decl.GetParameterAlignments(), entryBlock->getArguments()))
+        {
+            if (alignment > 1 && !isGpu && arg.getType().isa<mlir::MemRefType>())
+            {
+                (void)b.create<mlir::memref::AssumeAlignmentOp>(loc, arg, static_cast<uint32_t>(alignment));
+            }
+        }
+
         auto returnValueCopy = returnValue;
         returnValueCopy = fn(argValuesCopy);
         if (returnValueCopy)
@@ -1090,10 +1308,7 @@ EmitterContext::DefinedFunction MLIRContext::CreateFunctionImpl(FunctionDeclarat
             (void)b.create<accera::ir::value::ReturnOp>(loc);
         }
 
-        {
-            std::lock_guard lock{ _mutex };
-            _localEmittables.pop();
-        }
+        PopLocalEmittableScope();
     }
 
     DefinedFunction returnFn = [this, fnOp = fnOp, decl, mlirExpectedValues = argValuesCopy, isGpu](std::vector<Value> args) -> std::optional<Value> {
@@ -1283,6 +1498,10 @@ Value MLIRContext::StoreConstantDataImpl(ConstantData data, MemoryLayout layout,
                     f.convert(llvm::APFloat::IEEEhalf(), llvm::APFloat::rmNearestTiesToEven, &losesInfo);
                     op = b.create<mlir::ConstantFloatOp>(loc, f, mlirElemTy.cast<mlir::Float16Type>());
                 }
+                else if constexpr (std::is_same_v<ElementType, bfloat16_t>)
+                {
+                    op = b.create<mlir::ConstantFloatOp>(loc, ToBFloat16(data[0]), mlirElemTy.cast<mlir::BFloat16Type>());
+                }
                 else if constexpr (std::is_integral_v<ElementType> || std::is_same_v<ElementType, Boolean>)
                 {
                     auto elem = static_cast<int64_t>(data[0]);
@@ -1339,6 +1558,13 @@ Value MLIRContext::StoreConstantDataImpl(ConstantData data, MemoryLayout layout,
 
                     dataAttribute = mlir::DenseElementsAttr::get(flattenedTensorShapeTy, llvm::makeArrayRef(fp16Data));
                 }
+                else if constexpr (std::is_same_v<ElementType, bfloat16_t>)
+                {
+                    std::vector<llvm::APFloat> bf16Data;
+                    std::transform(data.begin(), data.end(), std::back_inserter(bf16Data), [](bfloat16_t value) { return ToBFloat16(value); });
+
+                    dataAttribute = mlir::DenseElementsAttr::get(flattenedTensorShapeTy, llvm::makeArrayRef(bf16Data));
+                }
                 else
                 {
                     dataAttribute = mlir::DenseElementsAttr::get(flattenedTensorShapeTy, llvm::makeArrayRef(data));
@@ -1417,7 +1643,7 @@ Value MLIRContext::ResolveConstantDataReferenceImpl(Value constantDataSource)
     return Value(emittable, constantDataSource.GetLayout());
 }
 
-void MLIRContext::ForImpl(MemoryLayout layout, std::function<void(std::vector<Scalar>)> fn, const std::string& name)
+void MLIRContext::ForImpl(const MemoryLayout& layout, std::function<void(const std::vector<Scalar>&)> fn, const std::string& name)
 {
     auto& builder = _impl->builder;
     auto loc = builder.getUnknownLoc();
@@ -1445,14 +1671,17 @@ void MLIRContext::ForImpl(MemoryLayout layout, std::function<void(std::vector<Sc
         mlir::ValueRange{ UBs },
         steps,
         [&](mlir::OpBuilder&, mlir::Location, mlir::ValueRange IVs) {
-            std::vector<Scalar> logicalIndices(dim);
-            for (unsigned i = 0; i < dim; ++i)
-            {
-                EmittableInfo& emittableInfo = StoreLocalEmittable({ IVs[i].getAsOpaquePointer(), { ValueType::Index, 1 } });
-                Emittable emittable{ &emittableInfo };
-                logicalIndices[i] = Scalar(Value(emittable, ScalarLayout));
-            }
-            fn(logicalIndices);
+            EmitScopedBody(IVs[0].getParentRegion()->getParentOp(), [&] {
+                std::vector<Scalar> logicalIndices;
+                logicalIndices.reserve(dim);
+                for (unsigned i = 0; i < dim; ++i)
+                {
+                    EmittableInfo& emittableInfo = StoreLocalEmittable({ IVs[i].getAsOpaquePointer(), { ValueType::Index, 1 } });
+                    Emittable emittable{ &emittableInfo };
+                    logicalIndices.emplace_back(Value(emittable, ScalarLayout));
+                }
+                fn(logicalIndices);
+            });
         });
 }
 
@@ -1472,11 +1701,14 @@ void MLIRContext::ForImpl(Scalar start, Scalar stop, Scalar step, std::function<
     }
     mlir::scf::buildLoopNest(builder, loc, mlirStart, mlirStop, mlirStep, [&](mlir::OpBuilder&, mlir::Location, mlir::ValueRange IVs) {
         auto iv = IVs[0];
-        SetOpNameAttr(iv.getParentRegion()->getParentOp(), loopSymName);
-        EmittableInfo& emittableInfo = StoreLocalEmittable({ iv.getAsOpaquePointer(), { ValueType::Index, 1 } });
-        Emittable emittable{ &emittableInfo };
-        Scalar index(Value(emittable, ScalarLayout));
-        fn(index);
+        auto loopOp = iv.getParentRegion()->getParentOp();
+        SetOpNameAttr(loopOp, loopSymName);
+        EmitScopedBody(loopOp, [&] {
+            EmittableInfo& emittableInfo = StoreLocalEmittable({ iv.getAsOpaquePointer(), { ValueType::Index, 1 } });
+            Emittable emittable{ &emittableInfo };
+            Scalar index(Value(emittable, ScalarLayout));
+            fn(index);
+        });
     });
 }
 
@@ -1568,6 +1800,38 @@ ViewAdapter MLIRContext::MapReduce(Array a, std::vector<ViewAdapter> initArgs, s
     return Wrap(mapReduceOp.getResult());
 }
 
+std::vector<ViewAdapter> MLIRContext::MultiReduce(Array a, std::vector<ViewAdapter> initArgs, std::function<std::vector<ViewAdapter>(ViewAdapter, std::vector<ViewAdapter>)> reduceFn, std::function<std::vector<ViewAdapter>(std::vector<ViewAdapter>, std::vector<ViewAdapter>)> combineFn, int64_t lanes)
+{
+    auto& builder = _impl->builder;
+    auto loc = builder.getUnknownLoc();
+
+    auto mlirInitArgs = llvm::to_vector<4>(llvm::map_range(initArgs, [&builder](ViewAdapter view) { return ResolveMLIRScalar(builder, ToMLIRValue(builder, view)); }));
+    auto toMLIRValues = [](mlir::OpBuilder& builder, const std::vector<ViewAdapter>& views) {
+        return llvm::to_vector<4>(llvm::map_range(views, [&builder](const ViewAdapter& view) { return ResolveMLIRScalar(builder, ToMLIRValue(builder, view)); }));
+    };
+    auto multiReduceOp = builder.create<ir::value::MultiReduceOp>(
+        loc,
+        ToMLIRValue(builder, a.GetValue()),
+        mlirInitArgs,
+        lanes,
+        [&](mlir::OpBuilder& builder, mlir::Location loc, mlir::Value val, mlir::ValueRange iterValues) {
+            loc = builder.getFusedLoc({ loc, ir::util::GetLocation(builder, __FILE__, __LINE__) });
+            auto wrappedVal = Wrap(val);
+            std::vector<ViewAdapter> iterWrappedValues = Wrap(std::vector<mlir::Value>(iterValues.begin(), iterValues.end()));
+            auto results = reduceFn(wrappedVal, iterWrappedValues);
+            builder.create<ir::value::YieldOp>(loc, toMLIRValues(builder, results));
+        },
+        [&](mlir::OpBuilder& builder, mlir::Location loc, mlir::ValueRange lhsValues, mlir::ValueRange rhsValues) {
+            loc = builder.getFusedLoc({ loc, ir::util::GetLocation(builder, __FILE__, __LINE__) });
+            std::vector<ViewAdapter> lhsWrappedValues = Wrap(std::vector<mlir::Value>(lhsValues.begin(), lhsValues.end()));
+            std::vector<ViewAdapter> rhsWrappedValues = Wrap(std::vector<mlir::Value>(rhsValues.begin(), rhsValues.end()));
+            auto results = combineFn(lhsWrappedValues, rhsWrappedValues);
+            builder.create<ir::value::YieldOp>(loc, toMLIRValues(builder, results));
+        });
+
+    return Wrap(std::vector<mlir::Value>(multiReduceOp.getResults().begin(), multiReduceOp.getResults().end()));
+}
+
 void MLIRContext::MoveDataImpl(Value& source, Value& destination)
 {
     // we treat a move the same as a copy, except we clear out the source
@@ -1647,7 +1911,7 @@ Value MLIRContext::ViewImpl(Value sourceValue, const std::vector<Scalar>& offset
     return { emittable, destLayout };
 }
 
-Value MLIRContext::SliceImpl(Value sourceValue, std::vector<int64_t> slicedDimensions, std::vector<Scalar> sliceOffsets)
+Value MLIRContext::SliceImpl(Value sourceValue, const std::vector<int64_t>& slicedDimensions, const std::vector<Scalar>& sliceOffsets)
 {
     auto& builder = _impl->builder;
     auto loc = builder.getUnknownLoc();
@@ -1659,7 +1923,7 @@ Value MLIRContext::SliceImpl(Value sourceValue, std::vector<int64_t> slicedDimen
         sliceOffsets.begin(),
         sliceOffsets.end(),
         std::back_inserter(offsets),
-        [&builder](Scalar s) { return ResolveMLIRIndex(builder, ResolveMLIRScalar(builder, ToMLIRValue(builder, s))); });
+        [&builder](const Scalar& s) { return ResolveMLIRIndex(builder, ResolveMLIRScalar(builder, ToMLIRValue(builder, s))); });
 
     auto resultMemRefType = MemoryLayoutToMemRefType(builder, destLayout, sourceValue.GetBaseType(), true);
     auto source = ToMLIRValue(builder, sourceValue);
@@ -1956,7 +2220,7 @@ Scalar MLIRContext::CastImpl(Scalar value, ValueType type, bool doSignedCast)
                     }
                     else
                     {
-                        Wrap(builder.create<mlir::ZeroExtendIOp>(loc, signlessMlirValue, toIntTypeSignless));
+                        return Wrap(builder.create<mlir::ZeroExtendIOp>(loc, signlessMlirValue, toIntTypeSignless));
                     }
                 })
                 .Case([&](mlir::IndexType) {
@@ -1996,6 +2260,12 @@ Scalar MLIRContext::CastImpl(Scalar value, ValueType type, bool doSignedCast)
                         Wrap(builder.create<mlir::FPToSIOp>(loc, mlirValue, toIntTypeSignless));
                 })
                 .Case([&](mlir::FloatType toFloatType) {
+                    if (fromFloatType.getWidth() == toFloatType.getWidth())
+                    {
+                        // float16 and bfloat16 have the same width but different layouts, so convert through float32
+                        auto f32Value = builder.create<mlir::FPExtOp>(loc, mlirValue, builder.getF32Type());
+                        return Wrap(builder.create<mlir::FPTruncOp>(loc, f32Value, toType));
+                    }
                     return fromFloatType.getWidth() > toFloatType.getWidth() ? Wrap(builder.create<mlir::FPTruncOp>(loc, mlirValue, toType)) :
                         Wrap(builder.create<mlir::FPExtOp>(loc, mlirValue, toType));
                 })
@@ -2246,7 +2516,19 @@ void MLIRContext::PrintProfileResults()
 
 void MLIRContext::PrefetchImpl(Value data, PrefetchType type, PrefetchLocality locality)
 {
-    throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, __FILE__ " : " + std::to_string(__LINE__));
+    auto& builder = _impl->builder;
+    auto loc = builder.getUnknownLoc();
+    auto mem = ToMLIRValue(builder, data);
+    auto memType = mem.getType().dyn_cast<mlir::MemRefType>();
+    if (!memType)
+    {
+        throw InputException(InputExceptionErrors::invalidArgument, "Prefetch requires an array");
+    }
+
+    // Prefetches the cache line of the first element of the view, the locality hints map onto the hints of llvm.prefetch
+    mlir::Value zero = builder.create<mlir::ConstantIndexOp>(loc, 0);
+    llvm::SmallVector<mlir::Value, 4> indices(memType.getRank(), zero);
+    builder.create<mlir::memref::PrefetchOp>(loc, mem, indices, type == PrefetchType::Write, static_cast<uint32_t>(locality), /*isDataCache=*/true);
 }
 
 void MLIRContext::PrintImpl(ViewAdapter value, bool toStderr)
@@ -2350,7 +2632,23 @@ void MLIRContext::ImportCodeFileImpl(std::string)
     throw utilities::LogicException(utilities::LogicExceptionErrors::notImplemented, __FILE__ " : " + std::to_string(__LINE__));
 }
 
-Scalar MLIRContext::MaxImpl(Vector input)
+// Tags a reduce_max or reduce_sum op for vectorization with the given number of vector accumulators
+static void SetReductionVectorizationInfo(mlir::OpBuilder& builder, mlir::Operation* op, const std::optional<VectorizationInformation>& vectorizationInfo, int64_t accumulators)
+{
+    if (!vectorizationInfo)
+    {
+        return;
+    }
+
+    auto vectorizationInfoIdentifier = builder.getIdentifier(ir::executionPlan::VectorizationInfoAttr::getKeyName());
+    op->setAttr(vectorizationInfoIdentifier, ir::executionPlan::VectorizationInfoAttr::get(*vectorizationInfo, builder.getContext()));
+    if (accumulators > 0)
+    {
+        op->setAttr(ir::ReductionAccumulatorsAttrName, builder.getI64IntegerAttr(accumulators));
+    }
+}
+
+Scalar MLIRContext::MaxImpl(Vector input, const std::optional<VectorizationInformation>& vectorizationInfo, int64_t accumulators)
 {
     auto& builder = _impl->builder;
     auto mlirValue = ToMLIRValue(builder, input);
@@ -2361,10 +2659,11 @@ Scalar MLIRContext::MaxImpl(Vector input)
     auto resultType = memRefType.getElementType();
     auto loc = mlirValue.getLoc();
     auto max = builder.create<ir::value::ReduceMaxOp>(loc, resultType, mlirValue);
+    SetReductionVectorizationInfo(builder, max, vectorizationInfo, accumulators);
     return Wrap(max, ScalarLayout);
 }
 
-Scalar MLIRContext::SumImpl(Vector input)
+Scalar MLIRContext::SumImpl(Vector input, const std::optional<VectorizationInformation>& vectorizationInfo, int64_t accumulators)
 {
     auto& builder = _impl->builder;
     auto mlirValue = ToMLIRValue(builder, input);
@@ -2375,6 +2674,7 @@ Scalar MLIRContext::SumImpl(Vector input)
     auto resultType = memRefType.getElementType();
     auto loc = mlirValue.getLoc();
     auto sum = builder.create<ir::value::ReduceSumOp>(loc, resultType, mlirValue);
+    SetReductionVectorizationInfo(builder, sum, vectorizationInfo, accumulators);
     return Wrap(sum, ScalarLayout);
 }
 
@@ -2428,9 +2728,83 @@ ir::value::ValueFuncOp FindValueFuncOp(mlir::ModuleOp mod, const std::string& na
     return fnOp;
 }
 
+// Returns the dimension that every access to each memref written by the kernels of a nest indexes with `index`
+// itself. The iterations of `index` then write disjoint elements and never read what another iteration writes, so
+// they can run in any order. Returns std::nullopt if some access to a written memref does not, or if a memref is
+// accessed other than element by element.
+std::optional<llvm::DenseMap<mlir::Value, int64_t>> GetIndependentAccessDimensions(ir::loopnest::NestOp nestOp, const ir::loopnest::Index& index)
+{
+    auto isIndex = [&index](mlir::Value offset) {
+        while (auto castOp = offset.getDefiningOp<mlir::IndexCastOp>())
+        {
+            offset = castOp.getOperand();
+        }
+        auto indexOp = offset.getDefiningOp<ir::loopnest::SymbolicIndexOp>();
+        return indexOp && indexOp.getValue() == index;
+    };
+
+    // The dimension indexed by `index` in each access, -1 if an access doesn't index it
+    llvm::DenseMap<mlir::Value, llvm::SmallVector<int64_t, 4>> accessDimensions;
+    llvm::DenseSet<mlir::Value> writtenMemrefs;
+    auto result = nestOp.walk([&](mlir::Operation* op) {
+        for (auto operand : op->getOperands())
+        {
+            // Only memrefs defined outside of the nest are shared by its iterations
+            if (!operand.getType().isa<mlir::MemRefType>() || nestOp->isAncestor(operand.getParentRegion()->getParentOp()))
+            {
+                continue;
+            }
+
+            auto sliceOp = mlir::dyn_cast<ir::value::SliceOp>(op);
+            if (!sliceOp || operand != sliceOp.source())
+            {
+                return mlir::WalkResult::interrupt();
+            }
+
+            int64_t dimension = -1;
+            auto slicedDimensions = sliceOp.sliceDimensions().getValue();
+            for (auto [offset, slicedDimension] : llvm::zip(sliceOp.offsets(), slicedDimensions))
+            {
+                if (isIndex(offset))
+                {
+                    dimension = slicedDimension.cast<mlir::IntegerAttr>().getInt();
+                    break;
+                }
+            }
+            accessDimensions[operand].push_back(dimension);
+
+            for (auto user : sliceOp.result().getUsers())
+            {
+                auto copyOp = mlir::dyn_cast<ir::value::CopyOp>(user);
+                if (!mlir::isa<ir::value::GetElementOp>(user) && !(copyOp && copyOp.input() != sliceOp.result()))
+                {
+                    writtenMemrefs.insert(operand);
+                }
+            }
+        }
+        return mlir::WalkResult::advance();
+    });
+    if (result.wasInterrupted())
+    {
+        return std::nullopt;
+    }
+
+    llvm::DenseMap<mlir::Value, int64_t> dimensions;
+    for (auto memref : writtenMemrefs)
+    {
+        const auto& accesses = accessDimensions[memref];
+        if (accesses.front() < 0 || llvm::any_of(accesses, [&](int64_t dimension) { return dimension != accesses.front(); }))
+        {
+            return std::nullopt;
+        }
+        dimensions[memref] = accesses.front();
+    }
+    return dimensions;
+}
+
 // Emit a wrapper function that will invoke the target function with debugging checks
 // This is best effort. If there is no ScheduleOp, we will skip the function.
-void MLIRContext::EmitNestDebugFunction(FunctionDeclaration targetFunc, const std::vector<std::string>& utilityFunctionNames)
+void MLIRContext::EmitNestDebugFunction(FunctionDeclaration targetFunc, const std::vector<std::string>& utilityFunctionNames, int64_t numThreads, const std::optional<VectorizationInformation>& vectorizationInfo, int64_t sampleStride)
 {
     auto& builder = _impl->builder;
     auto loc = builder.getUnknownLoc();
@@ -2481,7 +2855,11 @@ void MLIRContext::EmitNestDebugFunction(FunctionDeclaration targetFunc, const st
             //          Copy output targetFnArgs to output args
             //      }
             // TODO: The last copy can be avoided if we wrap the default schedule impl within its own ValueFuncOp
-            auto dbgFnOp = [this, &builder, loc, &targetFnOp, &scheduleOp, dbgFnName]() -> ir::value::ValueFuncOp {
+            // The dimension indexed by the outermost loop of the reference in each memref it writes, if the reference
+            // only computes some iterations of the loop
+            std::optional<llvm::DenseMap<mlir::Value, int64_t>> sampledDimensions;
+
+            auto dbgFnOp = [this, &builder, loc, &targetFnOp, &scheduleOp, dbgFnName, numThreads, &vectorizationInfo, sampleStride, &sampledDimensions]() -> ir::value::ValueFuncOp {
                 mlir::OpBuilder::InsertionGuard guard(builder);
                 builder.restoreInsertionPoint(_impl->getFunctionInsertPt());
 
@@ -2562,6 +2940,22 @@ void MLIRContext::EmitNestDebugFunction(FunctionDeclaration targetFunc, const st
                 {
                     // Non-fusing case: duplicate the nest with its kernel(s)
                     auto domain = targetNestOp.getDomain().getValue();
+                    auto dimensions = domain.GetDimensions();
+
+                    // The default schedule runs the loops in the order of the dimensions. When the iterations of the
+                    // outermost loop are independent, it is parallelized and may be sampled, and when those of the
+                    // innermost loop are, it is vectorized
+                    auto outerAccesses = GetIndependentAccessDimensions(targetNestOp, dimensions.front());
+                    auto innerAccesses = GetIndependentAccessDimensions(targetNestOp, dimensions.back());
+                    auto outerRange = domain.GetDimensionRange(0).GetRange();
+                    if (outerAccesses && sampleStride > 1 && outerRange.HasConstantEnd() && outerRange.Begin() == 0 && outerRange.Increment() == 1)
+                    {
+                        auto ranges = domain.GetRanges();
+                        ranges.front() = ir::loopnest::IndexRange(dimensions.front(), ir::loopnest::Range(0, outerRange.End(), sampleStride));
+                        domain = ir::loopnest::IterationDomain(ranges);
+                        sampledDimensions = outerAccesses;
+                    }
+
                     auto nest = ir::loopnest::MakeNest(builder, domain);
                     auto nestBuilder = nest.getBodyBuilder();
 
@@ -2587,6 +2981,45 @@ void MLIRContext::EmitNestDebugFunction(FunctionDeclaration targetFunc, const st
                     {
                         defaultSchedule.addKernel(kernel);
                     }
+
+                    std::optional<ir::loopnest::Index> parallelIndex;
+                    if (outerAccesses && numThreads > 1)
+                    {
+                        parallelIndex = dimensions.front();
+                    }
+
+                    auto innerRange = domain.GetDimensionRange(static_cast<int>(dimensions.size()) - 1).GetRange();
+                    if (innerAccesses && !innerAccesses->empty() && vectorizationInfo && vectorizationInfo->vectorBytes > 0 &&
+                        innerRange.HasConstantEnd() && innerRange.Begin() == 0 && innerRange.Increment() == 1)
+                    {
+                        // Each vector holds the elements of the widest memref that is written
+                        int64_t elementBytes = 1;
+                        for (const auto& access : *innerAccesses)
+                        {
+                            auto memrefType = access.first.getType().cast<mlir::MemRefType>();
+                            elementBytes = std::max<int64_t>(elementBytes, memrefType.getElementTypeBitWidth() / 8);
+                        }
+                        auto vectorSize = vectorizationInfo->vectorBytes / elementBytes;
+                        if (vectorSize > 1 && innerRange.End() > vectorSize)
+                        {
+                            auto vectorIndices = defaultSchedule.split(dimensions.back(), static_cast<int>(vectorSize));
+                            defaultSchedule.addLoopAttribute(vectorIndices.inner,
+                                                             builder.getIdentifier(ir::executionPlan::VectorizationInfoAttr::getKeyName()),
+                                                             ir::executionPlan::VectorizationInfoAttr::get(*vectorizationInfo, builder.getContext()));
+                            if (parallelIndex && *parallelIndex == dimensions.back())
+                            {
+                                parallelIndex = vectorIndices.outer;
+                            }
+                        }
+                    }
+
+                    if (parallelIndex)
+                    {
+                        ir::executionPlan::ParallelizationInfo parallelizationInfo{ numThreads, ir::executionPlan::ParallelSchedule::Static };
+                        defaultSchedule.addLoopAttribute(*parallelIndex,
+                                                         builder.getIdentifier(ir::executionPlan::ParallelizationInfoAttr::getKeyName()),
+                                                         ir::executionPlan::ParallelizationInfoAttr::get(parallelizationInfo, builder.getContext()));
+                    }
                 }
                 return wrapperFnOp;
             }();
@@ -2652,10 +3085,21 @@ void MLIRContext::EmitNestDebugFunction(FunctionDeclaration targetFunc, const st
 
                     // For each output arg, call its designated utility function to check that the expected values match
                     unsigned utilityFnIndex = 0;
-                    for (auto [targetArg, debugArg, usage] : llvm::zip(targetFnArgs, dbgFnOp.getArguments(), targetFunc.GetParameterUsages()))
+                    for (auto [targetArg, debugArg, fnArg, usage] : llvm::zip(targetFnArgs, dbgFnOp.getArguments(), targetFnOp.getArguments(), targetFunc.GetParameterUsages()))
                     {
                         if (usage == FunctionParameterUsage::inputOutput)
                         {
+                            // The reference only computed the sampled slices, the others are taken from the results
+                            if (sampledDimensions)
+                            {
+                                if (auto it = sampledDimensions->find(fnArg); it != sampledDimensions->end())
+                                {
+                                    Value targetValue = Wrap(targetArg);
+                                    Value debugValue = Wrap(debugArg);
+                                    CopyUnsampledSlices(targetValue, debugValue, it->second, sampleStride);
+                                }
+                            }
+
                             // Expect the number of utility functions to match the number of outputs
                             assert(utilityFnIndex < utilityFunctionNames.size() && "Too few debug utility functions were generated");
                             if (auto utilityFnOp = FindValueFuncOp(moduleOp, utilityFunctionNames[utilityFnIndex++]))
@@ -2755,6 +3199,8 @@ ValueType MLIRTypeToValueType(mlir::Type ty)
         .Case<mlir::FloatType>([](mlir::FloatType fTy) {
             if (fTy.isF16())
                 return ValueType::Float16;
+            else if (fTy.isBF16())
+                return ValueType::BFloat16;
             else if (fTy.isF32())
                 return ValueType::Float;
             else if (fTy.isF64())
@@ -2869,6 +3315,36 @@ static std::string GPUBarrierScopeToValueIRBarrierScope(GPU::BarrierScope scope)
     (void)ir::util::CreateGPUControlBarrier(b, GPUBarrierScopeToValueIRBarrierScope(scope), loc);
 }
 
+static Scalar GPUReduce(Scalar value, ir::value::ReductionKind kind, ir::value::BarrierScope scope)
+{
+    auto& b = GetMLIRContext().GetOpBuilder();
+    auto loc = b.getUnknownLoc();
+
+    auto mlirValue = UnwrapScalar(value);
+    auto reduceOp = b.create<ir::value::GPUReduceOp>(loc, mlirValue.getType(), mlirValue, kind, scope);
+    return Wrap(reduceOp.result(), ScalarLayout);
+}
+
+/*static*/ Scalar GPU::WarpSum(Scalar value)
+{
+    return GPUReduce(value, ir::value::ReductionKind::Sum, ir::value::BarrierScope::Warp);
+}
+
+/*static*/ Scalar GPU::WarpMax(Scalar value)
+{
+    return GPUReduce(value, ir::value::ReductionKind::Max, ir::value::BarrierScope::Warp);
+}
+
+/*static*/ Scalar GPU::BlockSum(Scalar value)
+{
+    return GPUReduce(value, ir::value::ReductionKind::Sum, ir::value::BarrierScope::Block);
+}
+
+/*static*/ Scalar GPU::BlockMax(Scalar value)
+{
+    return GPUReduce(value, ir::value::ReductionKind::Max, ir::value::BarrierScope::Block);
+}
+
 // this is declaring externs to reference the fillResource fn's in
 // mlir/tools/mlir-vulkan-runner/vulkan-runtime-wrappers.cpp and then proceeds
 // to emit calls to these functions
@@ -22,6 +22,8 @@
 #include <utilities/include/Exception.h>
 #include <utilities/include/MemoryLayout.h>
 
+#include <cmath>
+#include <limits>
 #include <optional>
 
 namespace accera
@@ -32,6 +34,24 @@ namespace value
 {
     namespace
     {
+        // The max of a row and the sum of exp(x_i-max), in a single pass over the row that rescales the sum whenever
+        // the max grows
+        std::vector<Scalar> RowMaxAndExpSum(Array row)
+        {
+            auto elementType = row.GetType();
+            return MultiReduce(
+                row,
+                { Cast(Scalar(std::numeric_limits<float>::lowest()), elementType), Cast(Scalar(0.0f), elementType) },
+                [](Scalar val, std::vector<Scalar> maxAndSum) -> std::vector<Scalar> {
+                    auto newMax = Max(maxAndSum[0], val);
+                    return { newMax, maxAndSum[1] * Exp(maxAndSum[0] - newMax) + Exp(val - newMax) };
+                },
+                [](std::vector<Scalar> lhs, std::vector<Scalar> rhs) -> std::vector<Scalar> {
+                    auto newMax = Max(lhs[0], rhs[0]);
+                    return { newMax, lhs[1] * Exp(lhs[0] - newMax) + rhs[1] * Exp(rhs[0] - newMax) };
+                });
+        }
+
         void SoftmaxifyRowsRowMajor(Array m)
         {
             auto elementType = m.GetType();
@@ -45,19 +65,13 @@ namespace value
 
             nest.Set([&]() {
                 auto row = m.Slice({ 0 }, { i });
-                auto maxVal = VectorMax(row);
-                Scalar sum = Allocate(elementType, ScalarLayout);
-                sum = Cast(Scalar(0.0f), elementType);
+                auto maxAndSum = RowMaxAndExpSum(row);
+                auto maxVal = maxAndSum[0];
+                auto sum = Select(maxAndSum[1] < epsilon, Cast(Scalar(1.0f), elementType), maxAndSum[1]);
 
                 For(0, numColumns, 1, [&](Scalar j) {
-                    auto eulerVal = Exp(row(j) - maxVal);
-                    row(j) = eulerVal;
-                    sum += eulerVal;
+                    row(j) = Exp(row(j) - maxVal) / sum;
                 });
-
-                sum = Select(sum < epsilon, Cast(Scalar(1.0f), elementType), sum);
-
-                row /= sum;
             });
 
             nest.CreateSchedule();
@@ -77,26 +91,35 @@ namespace value
 
             nest.Set([&]() {
                 auto row = m.Slice({ 1 }, { i });
-                auto maxVal = VectorMax(row);
-                Scalar sum = Allocate(elementType, ScalarLayout);
-                sum = Cast(Scalar(0.0f), elementType);
+                auto maxAndSum = RowMaxAndExpSum(row);
+                auto maxVal = maxAndSum[0];
+                auto sum = Select(maxAndSum[1] < epsilon, Cast(Scalar(1.0f), elementType), maxAndSum[1]);
 
                 For(0, numColumns, 1, [&](Scalar j) {
-                    auto eulerVal = Exp(row(j) - maxVal);
-                    row(j) = eulerVal;
-                    sum += eulerVal;
+                    row(j) = Exp(row(j) - maxVal) / sum;
                 });
-
-                sum = Select(sum < epsilon, Cast(Scalar(1.0f), elementType), sum);
-
-                row /= sum;
             });
 
             nest.CreateSchedule();
         }
 
+        // The number of lanes that a row is reduced in, so that the reduction is vectorized: one vector when the row is
+        // a whole number of vectors, otherwise a single lane
+        int GetReductionLanes(int numColumns, int vectorSize)
+        {
+            return numColumns % vectorSize == 0 ? vectorSize : 1;
+        }
+
+        void ParallelizeRows(Plan& plan, ScalarIndex i, int numThreads)
+        {
+            if (numThreads > 1)
+            {
+                plan.Parallelize({ i }, numThreads, ParallelizationPolicy::Static);
+            }
+        }
+
         template <typename ExpFnType>
-        void SoftmaxifyRowsVectorizedRowMajor(Array m, ExpFnType ExpFn)
+        void SoftmaxifyRowsVectorizedRowMajor(Array m, ExpFnType ExpFn, int numThreads)
         {
             LocationGuard region(GET_LOCATION());
             ProfileRegion profileRegion("softmax_0_all");
@@ -104,10 +127,11 @@ namespace value
             const int vectorSize = 8; // AVX-2 gives 256-bit registers, which can hold 8 floats
             const int vectorUnits = 16; // AVX-2 has 16 256-bit registers
             auto elementType = m.GetType();
-            auto epsilon = Cast(Scalar(1e-7f), elementType);
+            auto minFloat = Cast(Scalar(std::numeric_limits<float>::lowest()), elementType);
 
             int numRows = static_cast<int>(m.Shape()[0]);
             int numColumns = static_cast<int>(m.Shape()[1]);
+            const int lanes = GetReductionLanes(numColumns, vectorSize);
 
             Nest nest(MemoryShape{ numRows });
             auto i = nest.GetIndices()[0];
@@ -115,45 +139,62 @@ namespace value
             nest.Set([&]() {
                 auto row = m.Slice({ 0 }, { i });
 
-                // loop 1: VectorMax
-                Scalar maxVal;
-                {
-                    LocationGuard region(GET_LOCATION());
-                    ProfileRegion profileRegion("softmax_1_vecmax");
-                    maxVal = VectorMax(row);
-                }
+                // The running max and sum of exp(x_i-max) of each lane, allocated per row so that rows can run in parallel
+                auto laneMax = MakeArray({ lanes }, elementType, "laneMax", AllocateFlags::Stack);
+                auto laneSum = MakeArray({ lanes }, elementType, "laneSum", AllocateFlags::Stack);
+                FillArray(laneMax, minFloat);
+                ClearArray(laneSum);
 
-                // loop 2: Compute exp(x_i-max), and sum of exp(x_i-max)
-                Scalar sum;
+                // loop 1: online max and sum of exp(x_i-max), rescaling the sum whenever the max grows
                 {
                     LocationGuard region(GET_LOCATION());
-                    ProfileRegion profileRegion("softmax_2_expsum");
-                    sum = MapReduce(
-                        row,
-                        Scalar(0.0f),
-                        [&](Scalar a) { return ExpFn(a - maxVal); },
-                        [&](Scalar a, Scalar p) { return a + p; });
+                    ProfileRegion profileRegion("softmax_1_maxsum");
+                    Nest nest1(MemoryShape{ numColumns / lanes, lanes });
+                    auto [jOuter, jLane] = nest1.GetIndices<2>();
+                    nest1.Set([&, jOuter = jOuter, jLane = jLane]() {
+                        auto val = row(jOuter * lanes + jLane);
+                        auto oldMax = laneMax(jLane);
+                        auto newMax = Max(oldMax, val);
+                        laneSum(jLane) = laneSum(jLane) * ExpFn(oldMax - newMax) + ExpFn(val - newMax);
+                        laneMax(jLane) = newMax;
+                    });
+                    auto schedule1 = nest1.CreateSchedule();
+                    auto plan1 = schedule1.CreatePlan();
+                    if (lanes > 1)
+                    {
+                        plan1.Vectorize(jLane, { vectorSize, vectorUnits, true });
+                    }
                 }
 
-                // loop 3: Scale to sum to 1
+                // Combine the lanes
+                auto maxVal = VectorMax(laneMax);
+                Scalar sum = Allocate(elementType, ScalarLayout);
+                sum = Cast(Scalar(0.0f), elementType);
+                For(0, lanes, 1, [&](Scalar lane) {
+                    sum += laneSum(lane) * ExpFn(laneMax(lane) - maxVal);
+                });
+
+                // loop 2: write exp(x_i-max) scaled to sum to 1
                 {
                     LocationGuard region(GET_LOCATION());
-                    ProfileRegion profileRegion("softmax_3_scale");
+                    ProfileRegion profileRegion("softmax_2_scale");
 
                     auto reciprocal = Cast(Scalar(1.0), sum.GetType()) / sum;
 
-                    Nest nest4(numColumns);
-                    auto j4 = nest4.GetIndices()[0];
-                    nest4.Set([&] {
-                        row(j4) *= reciprocal;
+                    Nest nest2(numColumns);
+                    auto j2 = nest2.GetIndices()[0];
+                    nest2.Set([&] {
+                        row(j2) = ExpFn(row(j2) - maxVal) * reciprocal;
                     });
-                    auto nest4Schedule = nest4.CreateSchedule();
-                    auto nest4Plan = nest4Schedule.CreatePlan();
-                    nest4Plan.Vectorize(j4, { vectorSize, vectorUnits, true });
+                    auto nest2Schedule = nest2.CreateSchedule();
+                    auto nest2Plan = nest2Schedule.CreatePlan();
+                    nest2Plan.Vectorize(j2, { vectorSize, vectorUnits, true });
                 }
             });
 
             auto schedule = nest.CreateSchedule();
+            auto plan = schedule.CreatePlan();
+            ParallelizeRows(plan, i, numThreads);
         }
 
         template <typename ExpFnType>
@@ -434,11 +475,11 @@ namespace value
         }
     }
 
-    void SoftmaxifyRowsVectorized(Array m)
+    void SoftmaxifyRowsVectorized(Array m, int numThreads)
     {
         if (m.GetLayout().GetDimensionOrder() == DimensionOrder{ 0, 1 })
         {
-            SoftmaxifyRowsVectorizedRowMajor(m, FastExpMlas);
+            SoftmaxifyRowsVectorizedRowMajor(m, FastExpMlas, numThreads);
         }
         else if (m.GetLayout().GetDimensionOrder() == DimensionOrder{ 1, 0 })
         {
@@ -456,7 +497,7 @@ namespace value
 
     namespace
     {
-        void LayerNormalizeRowsVectorizedRowMajor(Array m, Array alpha, Array beta, std::optional<Array> residual)
+        void LayerNormalizeRowsVectorizedRowMajor(Array m, Array alpha, Array beta, std::optional<Array> residual, int numThreads)
         {
             // Computes LayerNormalize(m) or LayerNormalize(m + residual)
             auto elementType = m.GetType();
@@ -466,31 +507,46 @@ namespace value
 
             int numRows = static_cast<int>(m.Shape()[0]);
             int numColumns = static_cast<int>(m.Shape()[1]);
+            const int lanes = GetReductionLanes(numColumns, vectorSize);
 
             Nest nest({ Range{ 0, numRows, 1 } });
             auto i = nest.GetIndices()[0];
 
             const float epsilon = 1e-7f;
 
-            Scalar sum = Allocate(elementType, ScalarLayout);
-            Scalar sumSquares = Allocate(elementType, ScalarLayout);
             nest.Set([&]() {
-                sum = 0.0f;
-                sumSquares = 0.0f;
                 auto row = m.Slice({ 0 }, { i });
                 auto residualRow = residual ? std::optional<Array>{ residual->Slice({ 0 }, { i }) } : std::nullopt;
-                For(0, numColumns, 1, [&](Scalar j) {
+
+                // Single pass over the row for the sum and sum of squares of each lane, which also adds the residual in place.
+                // The partial sums are allocated per row so that rows can run in parallel.
+                auto laneSum = MakeArray({ lanes }, elementType, "laneSum", AllocateFlags::Stack);
+                auto laneSumSquares = MakeArray({ lanes }, elementType, "laneSumSquares", AllocateFlags::Stack);
+                ClearArray(laneSum);
+                ClearArray(laneSumSquares);
+
+                Nest nest1(MemoryShape{ numColumns / lanes, lanes });
+                auto [jOuter, jLane] = nest1.GetIndices<2>();
+                nest1.Set([&, jOuter = jOuter, jLane = jLane]() {
+                    auto j = jOuter * lanes + jLane;
                     auto val = row(j);
                     if (residualRow)
                     {
                         val = val + (*residualRow)(j);
+                        row(j) = val;
                     }
-                    sum += val;
-                    sumSquares += val * val;
+                    laneSum(jLane) += val;
+                    laneSumSquares(jLane) += val * val;
                 });
+                auto schedule1 = nest1.CreateSchedule();
+                auto plan1 = schedule1.CreatePlan();
+                if (lanes > 1)
+                {
+                    plan1.Vectorize(jLane, { vectorSize, vectorUnits, true });
+                }
 
-                sum = Max(sum, epsilon);
-                sumSquares = Max(sumSquares, epsilon);
+                auto sum = Max(VectorSum(laneSum), epsilon);
+                auto sumSquares = Max(VectorSum(laneSumSquares), epsilon);
 
                 auto mean = sum / Scalar((float)numColumns);
                 auto variance = (sumSquares - ((sum * sum) / Scalar((float)numColumns))) / Scalar((float)numColumns); // == (sumSquares - mean*mean*N) / N
@@ -508,6 +564,8 @@ namespace value
             });
 
             auto schedule = nest.CreateSchedule();
+            auto plan = schedule.CreatePlan();
+            ParallelizeRows(plan, i, numThreads);
         }
 
         void LayerNormalizeRowsVectorizedColumnMajor(Array m, Array alpha, Array beta, std::optional<Array> residual)
@@ -585,11 +643,11 @@ namespace value
             plan3.Vectorize(i3, { vectorSize, vectorUnits, true });
         }
 
-        void LayerNormalizeVectorized(Array m, Array alpha, Array beta, std::optional<Array> residual)
+        void LayerNormalizeVectorized(Array m, Array alpha, Array beta, std::optional<Array> residual, int numThreads)
         {
             if (m.GetLayout().GetDimensionOrder() == DimensionOrder{ 0, 1 })
             {
-                LayerNormalizeRowsVectorizedRowMajor(m, alpha, beta, residual);
+                LayerNormalizeRowsVectorizedRowMajor(m, alpha, beta, residual, numThreads);
             }
             else if (m.GetLayout().GetDimensionOrder() == DimensionOrder{ 1, 0 })
             {
@@ -619,19 +677,33 @@ namespace value
                 auto row = m.Slice({ 0 }, { i });
                 auto residualRow = residual ? std::optional<Array>{ residual->Slice({ 0 }, { i }) } : std::nullopt;
 
-                sum = 0.0f;
-                sumSquares = 0.0f;
-                For(0, numColumns, 1, [&](Scalar j) {
-                    auto val = row(j);
-                    if (residual)
-                    {
-                        val = val + (*residualRow)(j);
-                    }
-
-                    sum += val;
-                    sumSquares += val * val;
-                    row(j) = val;
-                });
+                if (residual)
+                {
+                    sum = 0.0f;
+                    sumSquares = 0.0f;
+                    For(0, numColumns, 1, [&](Scalar j) {
+                        auto val = row(j) + (*residualRow)(j);
+                        sum += val;
+                        sumSquares += val * val;
+                        row(j) = val;
+                    });
+                }
+                else
+                {
+                    // Nothing to write back, so both sums come from one read-only pass over the row
+                    auto zero = Cast(Scalar(0.0f), elementType);
+                    auto sums = MultiReduce(
+                        row,
+                        { zero, zero },
+                        [](Scalar val, std::vector<Scalar> sums) -> std::vector<Scalar> {
+                            return { sums[0] + val, sums[1] + val * val };
+                        },
+                        [](std::vector<Scalar> lhs, std::vector<Scalar> rhs) -> std::vector<Scalar> {
+                            return { lhs[0] + rhs[0], lhs[1] + rhs[1] };
+                        });
+                    sum = sums[0];
+                    sumSquares = sums[1];
+                }
 
                 sum = Max(sum, epsilon);
                 sumSquares = Max(sumSquares, epsilon);
@@ -648,6 +720,51 @@ namespace value
 
             nest.CreateSchedule();
         }
+
+        // The row partitions that argmax and top-k split the columns into, which must divide the number of columns
+        int GetColumnPartitions(int numColumns, int numPartitions, const std::string& opName)
+        {
+            numPartitions = std::min(numPartitions, numColumns);
+            if (numPartitions < 1 || numColumns % numPartitions != 0)
+            {
+                throw InputException(InputExceptionErrors::invalidSize, opName + " requires a number of partitions that divides the number of columns");
+            }
+            return numPartitions;
+        }
+
+        // The first index of a vector that holds the given value, or the size of the vector if none does
+        Scalar FirstIndexOf(Array v, Scalar value, ValueType indexType)
+        {
+            auto size = static_cast<int>(v.Shape()[0]);
+            return ReduceN(size, Cast(Scalar(size), indexType), [&](Scalar j, Scalar first) {
+                return Select(v(j) == value, Min(first, Cast(j, indexType)), first);
+            });
+        }
+
+        // Inserts a value and its index into the top values, which are sorted largest first, dropping the smallest. The
+        // value is carried down the list, swapping places with every smaller value, so that equal values stay in the
+        // order they are inserted in. The carried scalars are allocated by the caller, outside of any loop.
+        void InsertTopK(Array topValues, Array topIndices, Scalar value, Scalar index, Scalar carriedValue, Scalar carriedIndex)
+        {
+            auto k = static_cast<int>(topValues.Shape()[0]);
+            If(value > topValues(k - 1), [&] {
+                carriedValue = value;
+                carriedIndex = index;
+                For(0, k, 1, [&](Scalar s) {
+                    auto current = topValues(s);
+                    auto currentIndex = topIndices(s);
+                    auto greater = carriedValue > current;
+                    auto newValue = Select(greater, carriedValue, current);
+                    auto newIndex = Select(greater, carriedIndex, currentIndex);
+                    auto nextValue = Select(greater, current, carriedValue);
+                    auto nextIndex = Select(greater, currentIndex, carriedIndex);
+                    topValues(s) = newValue;
+                    topIndices(s) = newIndex;
+                    carriedValue = nextValue;
+                    carriedIndex = nextIndex;
+                });
+            });
+        }
     } // namespace
 
     void LayerNormalize(Array m, Array alpha, Array beta)
@@ -660,14 +777,14 @@ namespace value
         LayerNormalize(m, alpha, beta, residual);
     }
 
-    void LayerNormalizeVectorized(Array m, Array alpha, Array beta)
+    void LayerNormalizeVectorized(Array m, Array alpha, Array beta, int numThreads)
     {
-        LayerNormalizeVectorized(m, alpha, beta, std::nullopt);
+        LayerNormalizeVectorized(m, alpha, beta, std::nullopt, numThreads);
     }
 
-    void LayerNormalizeVectorizedFused(Array m, Array alpha, Array beta, Array residual)
+    void LayerNormalizeVectorizedFused(Array m, Array alpha, Array beta, Array residual, int numThreads)
     {
-        LayerNormalizeVectorized(m, alpha, beta, residual);
+        LayerNormalizeVectorized(m, alpha, beta, residual, numThreads);
     }
 
     void ReLU(Array m)
@@ -690,6 +807,24 @@ namespace value
         plan.Vectorize(j, { vectorSize, vectorUnits });
     }
 
+    void GELU(Array m, FastMathAccuracy accuracy)
+    {
+        const int vectorSize = 8; // AVX-2 gives 256-bit registers, which can hold 8 floats
+        const int vectorUnits = 16; // AVX-2 has 16 256-bit registers
+
+        Nest nest(m.Shape());
+        auto i = nest.GetIndices()[0];
+        auto j = nest.GetIndices()[1];
+
+        nest.Set([&]() {
+            m(i, j) = FastGelu(m(i, j), accuracy);
+        });
+
+        auto schedule = nest.CreateSchedule();
+        auto plan = schedule.CreatePlan();
+        plan.Vectorize(j, { vectorSize, vectorUnits });
+    }
+
     void Feedforward(Array attn, Array Wff1, Array Wff2, Array ffTemp, Array output)
     {
         ProfileRegion profileRegion("feedforward_0_all");
@@ -795,5 +930,261 @@ namespace value
         schedule.AddKernel(cKernel, First(iInner) && First(jInner) && First(kInner) && First(lInner) && First(s), IsDefined(iOuter) && IsDefined(jOuter) && IsDefined(kOuter) && IsDefined(lOuter) && IsDefined(s));
         schedule.AddKernel(eKernel, First(iInner) && First(lInner) && First(jInner) && Last(kInner) && Last(s), IsDefined(iOuter) && IsDefined(jOuter) && IsDefined(kOuter) && IsDefined(lOuter) && IsDefined(s));
     }
+
+    void FusedAttention(Array Q, Array K, Array V, Array output, int blockSize)
+    {
+        ProfileRegion profileRegion("fusedattention_0_all");
+
+        const int vectorSize = 8; // AVX-2 gives 256-bit registers, which can hold 8 floats
+        const int vectorUnits = 16; // AVX-2 has 16 256-bit registers
+
+        auto elementType = Q.GetType();
+
+        const int M = (int)(Q.Shape()[0]);
+        const int d = (int)(Q.Shape()[1]);
+        const int N = (int)(K.Shape()[0]);
+        const int dv = (int)(V.Shape()[1]);
+        if ((int)K.Shape()[1] != d || (int)V.Shape()[0] != N || (int)output.Shape()[0] != M || (int)output.Shape()[1] != dv)
+        {
+            throw InputException(InputExceptionErrors::sizeMismatch, "FusedAttention requires M x d queries, N x d keys, N x dv values and an M x dv output");
+        }
+
+        blockSize = std::min(blockSize, N);
+        if (blockSize < 1 || N % blockSize != 0)
+        {
+            throw InputException(InputExceptionErrors::invalidSize, "FusedAttention requires a block size that divides the number of keys");
+        }
+
+        // A block of query rows shares each block of keys and values, the largest that divides M up to the rows of a
+        // matmul microkernel
+        int rowBlock = std::min(M, 8);
+        while (M % rowBlock != 0)
+        {
+            --rowBlock;
+        }
+
+        auto scale = Cast(Scalar(1.0f / std::sqrt(static_cast<float>(d))), elementType);
+        auto minFloat = Cast(Scalar(std::numeric_limits<float>::lowest()), elementType);
+
+        // The running max and sum of the exponentials of the scores of each query row, in the units of the unscaled scores
+        auto rowMax = MakeArray({ rowBlock }, elementType, "rowMax");
+        auto rowSum = MakeArray({ rowBlock }, elementType, "rowSum");
+        auto scores = MakeArray({ rowBlock, blockSize }, elementType, "scores");
+
+        Nest nest({ Range{ 0, M, rowBlock } });
+        auto i = nest.GetIndices()[0];
+
+        nest.Set([&]() {
+            auto queries = Q.SubArray({ i, 0 }, { rowBlock, d });
+            auto outputRows = output.SubArray({ i, 0 }, { rowBlock, dv });
+
+            FillArray(rowMax, minFloat);
+            ClearArray(rowSum);
+            ClearArray(outputRows);
+
+            For(0, N, blockSize, [&](Scalar j) {
+                auto keys = K.SubArray({ j, 0 }, { blockSize, d });
+                auto values = V.SubArray({ j, 0 }, { blockSize, dv });
+
+                {
+                    ProfileRegion profileRegion("fusedattention_1_scores");
+                    MatMulMlas(queries, keys.Reorder({ 1, 0 }), scores);
+                }
+
+                // Replaces the scores by their exponentials relative to the new row max, and rescales what was
+                // accumulated for the previous blocks to the new max
+                {
+                    ProfileRegion profileRegion("fusedattention_2_softmax");
+                    Nest rowNest(MemoryShape{ rowBlock });
+                    auto r = rowNest.GetIndices()[0];
+                    rowNest.Set([&]() {
+                        auto scoreRow = scores.Slice({ 0 }, { r });
+                        auto newMax = Max(rowMax(r), VectorMax(scoreRow));
+                        auto correction = FastExpMlas((rowMax(r) - newMax) * scale);
+
+                        Scalar sum = Allocate(elementType, ScalarLayout);
+                        sum = Cast(Scalar(0.0f), elementType);
+                        For(0, blockSize, 1, [&](Scalar c) {
+                            auto eulerVal = FastExpMlas((scoreRow(c) - newMax) * scale);
+                            scoreRow(c) = eulerVal;
+                            sum += eulerVal;
+                        });
+                        rowSum(r) = rowSum(r) * correction + sum;
+                        rowMax(r) = newMax;
+
+                        auto outputRow = outputRows.Slice({ 0 }, { r });
+                        Nest scaleNest(dv);
+                        auto c = scaleNest.GetIndices()[0];
+                        scaleNest.Set([&] {
+                            outputRow(c) *= correction;
+                        });
+                        auto scaleSchedule = scaleNest.CreateSchedule();
+                        auto scalePlan = scaleSchedule.CreatePlan();
+                        scalePlan.Vectorize(c, { vectorSize, vectorUnits, true });
+                    });
+                    rowNest.CreateSchedule();
+                }
+
+                {
+                    ProfileRegion profileRegion("fusedattention_3_values");
+                    MatMulMlas(scores, values, outputRows, false);
+                }
+            });
+
+            // Normalize by the sums once all of the keys are seen
+            Nest normalizeNest(MemoryShape{ rowBlock, dv });
+            auto [r, c] = normalizeNest.GetIndices<2>();
+            normalizeNest.Set([&, r = r, c = c]() {
+                outputRows(r, c) /= rowSum(r);
+            });
+            auto normalizeSchedule = normalizeNest.CreateSchedule();
+            auto normalizePlan = normalizeSchedule.CreatePlan();
+            normalizePlan.Vectorize(c, { vectorSize, vectorUnits, true });
+        });
+
+        nest.CreateSchedule();
+    }
+
+    void ArgMaxRows(Array m, Array indices, int numPartitions, int numThreads)
+    {
+        ProfileRegion profileRegion("argmax_0_all");
+
+        auto elementType = m.GetType();
+        auto indexType = indices.GetType();
+
+        const int numRows = static_cast<int>(m.Shape()[0]);
+        const int numColumns = static_cast<int>(m.Shape()[1]);
+        if (static_cast<int>(indices.Shape()[0]) != numRows)
+        {
+            throw InputException(InputExceptionErrors::sizeMismatch, "ArgMaxRows requires an index for each row");
+        }
+        numPartitions = GetColumnPartitions(numColumns, numPartitions, "ArgMaxRows");
+        const int partitionSize = numColumns / numPartitions;
+
+        // The max of each partition of each row, and the first index where it is
+        auto partitionMax = MakeArray({ numRows, numPartitions }, elementType, "partitionMax");
+        auto partitionArgMax = MakeArray({ numRows, numPartitions }, indexType, "partitionArgMax");
+
+        {
+            ProfileRegion profileRegion("argmax_1_partitions");
+            Nest nest(MemoryShape{ numRows, numPartitions });
+            auto [i, p] = nest.GetIndices<2>();
+            nest.Set([&, i = i, p = p]() {
+                auto begin = p * partitionSize;
+                auto partition = m.Slice({ 0 }, { i }).SubArray({ begin }, { partitionSize });
+
+                // The vectorized max, then a search for it in the partition, which is still in the cache
+                auto maxVal = VectorMax(partition);
+                partitionMax(i, p) = maxVal;
+                partitionArgMax(i, p) = Cast(begin, indexType) + FirstIndexOf(partition, maxVal, indexType);
+            });
+            auto schedule = nest.CreateSchedule();
+            auto plan = schedule.CreatePlan();
+            if (numThreads > 1)
+            {
+                plan.Parallelize({ i, p }, numThreads, ParallelizationPolicy::Static);
+            }
+        }
+
+        // Merge the partitions, which are in the order of the columns, so that the first index of the max wins
+        {
+            ProfileRegion profileRegion("argmax_2_merge");
+            Nest nest(MemoryShape{ numRows });
+            auto i = nest.GetIndices()[0];
+            nest.Set([&]() {
+                auto maxVal = VectorMax(partitionMax.Slice({ 0 }, { i }));
+                indices(i) = ReduceN(numPartitions, Cast(Scalar(numColumns), indexType), [&](Scalar p, Scalar first) {
+                    return Select(partitionMax(i, p) == maxVal, Min(first, partitionArgMax(i, p)), first);
+                });
+            });
+            nest.CreateSchedule();
+        }
+    }
+
+    void TopKRows(Array m, Array values, Array indices, int numPartitions, int numThreads)
+    {
+        ProfileRegion profileRegion("topk_0_all");
+
+        const int vectorSize = 8; // AVX-2 gives 256-bit registers, which can hold 8 floats
+
+        auto elementType = m.GetType();
+        auto indexType = indices.GetType();
+        auto minFloat = Cast(Scalar(std::numeric_limits<float>::lowest()), elementType);
+        auto noIndex = Cast(Scalar(-1), indexType);
+
+        const int numRows = static_cast<int>(m.Shape()[0]);
+        const int numColumns = static_cast<int>(m.Shape()[1]);
+        const int k = static_cast<int>(values.Shape()[1]);
+        if (static_cast<int>(values.Shape()[0]) != numRows || indices.Shape() != values.Shape())
+        {
+            throw InputException(InputExceptionErrors::sizeMismatch, "TopKRows requires k values and k indices for each row");
+        }
+        if (k < 1 || k > numColumns)
+        {
+            throw InputException(InputExceptionErrors::invalidSize, "TopKRows requires k to be between 1 and the number of columns");
+        }
+        numPartitions = GetColumnPartitions(numColumns, numPartitions, "TopKRows");
+        const int partitionSize = numColumns / numPartitions;
+        const int blockSize = GetReductionLanes(partitionSize, vectorSize);
+
+        // The top k of each partition of each row
+        auto partitionValues = MakeArray({ numRows, numPartitions * k }, elementType, "partitionValues");
+        auto partitionIndices = MakeArray({ numRows, numPartitions * k }, indexType, "partitionIndices");
+
+        {
+            ProfileRegion profileRegion("topk_1_partitions");
+            Nest nest(MemoryShape{ numRows, numPartitions });
+            auto [i, p] = nest.GetIndices<2>();
+            nest.Set([&, i = i, p = p]() {
+                auto begin = p * partitionSize;
+                auto partition = m.Slice({ 0 }, { i }).SubArray({ begin }, { partitionSize });
+                auto topValues = partitionValues.Slice({ 0 }, { i }).SubArray({ p * k }, { k });
+                auto topIndices = partitionIndices.Slice({ 0 }, { i }).SubArray({ p * k }, { k });
+                FillArray(topValues, minFloat);
+                FillArray(topIndices, noIndex);
+
+                Scalar carriedValue = Allocate(elementType, ScalarLayout);
+                Scalar carriedIndex = Allocate(indexType, ScalarLayout);
+
+                // Once the list fills up, few elements are larger than its smallest, so a block is only searched
+                // when its vectorized max is
+                For(0, partitionSize, blockSize, [&](Scalar blockBegin) {
+                    auto block = partition.SubArray({ blockBegin }, { blockSize });
+                    If(VectorMax(block) > topValues(k - 1), [&] {
+                        For(0, blockSize, 1, [&](Scalar j) {
+                            auto index = Cast(begin, indexType) + Cast(blockBegin + j, indexType);
+                            InsertTopK(topValues, topIndices, block(j), index, carriedValue, carriedIndex);
+                        });
+                    });
+                });
+            });
+            auto schedule = nest.CreateSchedule();
+            auto plan = schedule.CreatePlan();
+            if (numThreads > 1)
+            {
+                plan.Parallelize({ i, p }, numThreads, ParallelizationPolicy::Static);
+            }
+        }
+
+        // Merge the partitions in the order of the columns, so that equal values stay in the order of their indices
+        {
+            ProfileRegion profileRegion("topk_2_merge");
+            Nest nest(MemoryShape{ numRows });
+            auto i = nest.GetIndices()[0];
+            nest.Set([&]() {
+                auto topValues = values.Slice({ 0 }, { i });
+                auto topIndices = indices.Slice({ 0 }, { i });
+                FillArray(topValues, minFloat);
+                FillArray(topIndices, noIndex);
+
+                Scalar carriedValue = Allocate(elementType, ScalarLayout);
+                Scalar carriedIndex = Allocate(indexType, ScalarLayout);
+                For(0, numPartitions * k, 1, [&](Scalar c) {
+                    InsertTopK(topValues, topIndices, partitionValues(i, c), partitionIndices(i, c), carriedValue, carriedIndex);
+                });
+            });
+            nest.CreateSchedule();
+        }
+    }
 } // namespace value
 } // namespace accera
@@ -24,6 +24,7 @@
 #include <mlir/IR/Attributes.h>
 #include <mlir/IR/Identifier.h>
 
+#include <algorithm>
 #include <cassert>
 #include <functional>
 #include <tuple>
@@ -167,13 +168,18 @@ namespace value
             return { _scheduleOp, target, constantData, wrapperFnName, packedBufferName, indexing };
         }
 
+        Cache PackAndMapBuffer(ViewAdapter target, ViewAdapter constantData, const std::string& wrapperFnName, const std::string& packedBufferName, CacheIndexing indexing)
+        {
+            return { _scheduleOp, target, constantData, wrapperFnName, packedBufferName, indexing, /*mapFromFile=*/true };
+        }
+
         void Vectorize(ScalarIndex i, const VectorizationInformation& dslVectorizationInfo)
         {
             auto& builder = GetBuilder();
             auto symbolicIndexOp = GetIndexOp(i);
             auto index = symbolicIndexOp.getValue();
 
-            VectorizationInfo vectorizationInfo{ dslVectorizationInfo.vectorBytes, dslVectorizationInfo.vectorUnitCount, dslVectorizationInfo.unrollOnly };
+            VectorizationInfo vectorizationInfo{ dslVectorizationInfo.vectorBytes, dslVectorizationInfo.vectorUnitCount, dslVectorizationInfo.unrollOnly, dslVectorizationInfo.masked, dslVectorizationInfo.dotProduct, dslVectorizationInfo.bfloat16DotProduct, dslVectorizationInfo.tableLookup };
             auto vectorizationInfoIdentifier = builder.getIdentifier(VectorizationInfoAttr::getKeyName());
             auto vectorizationInfoAttr = VectorizationInfoAttr::get(vectorizationInfo, builder.getContext());
             _scheduleOp.addLoopAttribute(index, vectorizationInfoIdentifier, vectorizationInfoAttr);
@@ -183,13 +189,69 @@ namespace value
             _execPlanOp->setAttr(vectorizationInfoIdentifier, vectorizationInfoAttr);
         }
 
-        void Parallelize(std::vector<ScalarIndex> indices, int64_t numThreads, ParallelizationPolicy policy)
+        void Parallelize(std::vector<ScalarIndex> indices, int64_t numThreads, ParallelizationPolicy policy, ParallelizationPinning pinning, const std::vector<int64_t>& processors, bool firstTouch, int64_t chunkSize, bool reduction, bool deterministic)
         {
             auto& builder = GetBuilder();
 
-            ParallelizationInfo parallelizationInfo{ numThreads, policy == ParallelizationPolicy::Dynamic };
+            ParallelSchedule schedule = ParallelSchedule::Static;
+            switch (policy)
+            {
+            case ParallelizationPolicy::Static:
+                schedule = ParallelSchedule::Static;
+                break;
+            case ParallelizationPolicy::Dynamic:
+                schedule = ParallelSchedule::Dynamic;
+                break;
+            case ParallelizationPolicy::WorkStealing:
+                schedule = ParallelSchedule::WorkStealing;
+                break;
+            case ParallelizationPolicy::Guided:
+                schedule = ParallelSchedule::Guided;
+                break;
+            default:
+                throw LogicException(LogicExceptionErrors::illegalState, "Unknown parallelization policy");
+            }
+
+            ParallelProcBind procBind = ParallelProcBind::Default;
+            switch (pinning)
+            {
+            case ParallelizationPinning::Default:
+                procBind = ParallelProcBind::Default;
+                break;
+            case ParallelizationPinning::Close:
+                procBind = ParallelProcBind::Close;
+                break;
+            case ParallelizationPinning::Spread:
+                procBind = ParallelProcBind::Spread;
+                break;
+            case ParallelizationPinning::Primary:
+                procBind = ParallelProcBind::Primary;
+                break;
+            default:
+                throw LogicException(LogicExceptionErrors::illegalState, "Unknown parallelization pinning");
+            }
+
+            if (std::any_of(processors.begin(), processors.end(), [](int64_t processor) { return processor < 0; }))
+            {
+                throw InputException(InputExceptionErrors::invalidArgument, "Processor ids must be non-negative");
+            }
+
+            if (chunkSize < 0)
+            {
+                throw InputException(InputExceptionErrors::invalidArgument, "Chunk size must be non-negative");
+            }
+
+            if (deterministic && !reduction)
+            {
+                throw InputException(InputExceptionErrors::invalidArgument, "Only parallel reductions can be deterministic");
+            }
+
+            // Each call parallelizes its own band of indices, so bands nested in each other stay separate parallel levels
+            ParallelizationInfo parallelizationInfo{ numThreads, schedule, _numParallelGroups++, procBind, firstTouch, chunkSize };
             auto parallelizationInfoIdentifier = builder.getIdentifier(ParallelizationInfoAttr::getKeyName());
             auto parallelizationInfoAttr = ParallelizationInfoAttr::get(parallelizationInfo, builder.getContext());
+            auto processorsIdentifier = builder.getIdentifier(ParallelProcessorsAttrName);
+            auto processorsAttr = builder.getI64ArrayAttr(processors);
 
             // mark each index as parallelized
             // during lowering, indices are continguous in the schedule ordering will be collapsed
@@ -198,6 +260,18 @@ namespace value
                 auto symbolicIndexOp = GetIndexOp(i);
                 auto index = symbolicIndexOp.getValue();
                 _scheduleOp.addLoopAttribute(index, parallelizationInfoIdentifier, parallelizationInfoAttr);
+                if (!processors.empty())
+                {
+                    _scheduleOp.addLoopAttribute(index, processorsIdentifier, processorsAttr);
+                }
+                if (reduction)
+                {
+                    _scheduleOp.addLoopAttribute(index, builder.getIdentifier(ParallelReductionAttrName), builder.getUnitAttr());
+                }
+                if (deterministic)
+                {
+                    _scheduleOp.addLoopAttribute(index, builder.getIdentifier(DeterministicReductionAttrName), builder.getUnitAttr());
+                }
             }
         }
 
@@ -219,7 +293,15 @@ namespace value
             }
         }
 
-        void MapIndexToProcessor(ScalarIndex i, Processor proc)
+        void Profile(ScalarIndex i)
+        {
+            auto& builder = GetBuilder();
+            auto symbolicIndexOp = GetIndexOp(i);
+            auto index = symbolicIndexOp.getValue();
+            _scheduleOp.addLoopAttribute(index, builder.getIdentifier(ProfileLoopAttrName), builder.getUnitAttr());
+        }
+
+        void MapIndexToProcessor(ScalarIndex i, Processor proc, bool reduction)
         {
             auto& builder = GetBuilder();
             auto symbolicIndexOp = GetIndexOp(i);
@@ -242,6 +324,25 @@ namespace value
                     builder.getIdentifier(procStr), IndexAttr::get(index, builder.getContext()));
                 planOp->setAttr(procMapAttrName, builder.getDictionaryAttr(mapArray));
             }
+
+            if (reduction)
+            {
+                _scheduleOp.addLoopAttribute(index, builder.getIdentifier(ParallelReductionAttrName), builder.getUnitAttr());
+            }
+        }
+
+        void SetPersistentBlocks(int64_t numBlocks)
+        {
+            auto& builder = GetBuilder();
+            auto planOp = _scheduleOp.getOrCreateExecPlan();
+            planOp->setAttr(ir::GPUPersistentBlocksAttrName, builder.getI64IntegerAttr(numBlocks));
+        }
+
+        void SetStreamKDim(int64_t dim)
+        {
+            auto& builder = GetBuilder();
+            auto planOp = _scheduleOp.getOrCreateExecPlan();
+            planOp->setAttr(ir::GPUStreamKDimAttrName, builder.getI64IntegerAttr(dim));
         }
 
     private:
@@ -266,6 +367,7 @@ namespace value
         value::ExecutionTarget _execTarget;
         ScheduleOp _scheduleOp;
         ExecPlanOp _execPlanOp;
+        int64_t _numParallelGroups = 0;
     };
 
     //
@@ -364,14 +466,29 @@ namespace value
         return _impl->PackAndEmbedBuffer(target, constantData, wrapperFnName, packedBufferName, indexing);
     }
 
+    Cache Plan::PackAndMapBuffer(ViewAdapter target, ViewAdapter constantData, const std::string& wrapperFnName, const std::string& packedBufferName, CacheIndexing indexing)
+    {
+        return _impl->PackAndMapBuffer(target, constantData, wrapperFnName, packedBufferName, indexing);
+    }
+
     void Plan::Vectorize(ScalarIndex i, const VectorizationInformation& vectorizationInfo)
     {
         _impl->Vectorize(i, vectorizationInfo);
     }
 
-    void Plan::Parallelize(std::vector<ScalarIndex> indices, int64_t numThreads, ParallelizationPolicy policy)
+    void Plan::Parallelize(std::vector<ScalarIndex> indices, int64_t numThreads, ParallelizationPolicy policy, ParallelizationPinning pinning, std::vector<int64_t> processors, bool firstTouch, int64_t chunkSize, bool reduction, bool deterministic)
+    {
+        _impl->Parallelize(indices, numThreads, policy, pinning, processors, firstTouch, chunkSize, reduction, deterministic);
+    }
+
+    void Plan::Tensorize(std::vector<ScalarIndex> indices, std::array<int64_t, 3> dims)
     {
-        _impl->Parallelize(indices, numThreads, policy);
+        _impl->Tensorize(indices, dims);
+    }
+
+    void Plan::Profile(ScalarIndex i)
+    {
+        _impl->Profile(i);
     }
 
     //
@@ -408,14 +525,29 @@ namespace value
         return _impl->AddAutomaticCache(target, std::nullopt, maxElements, CacheIndexing::GlobalToPhysical, CacheAllocation::Automatic, memorySpace);
     }
 
+    Cache GPUPlan::AddCache(std::variant<ViewAdapter, Cache*> target, int64_t maxElements, const DimensionOrder& dimOrder, bool thrifty, bool doubleBuffer, const std::optional<VectorizationInformation>& vectorizationInfo, CacheIndexing mapping, CacheAllocation allocation, MemorySpace memorySpace, MemorySpace doubleBufferMemorySpace)
+    {
+        return _impl->AddManualCache(target, std::nullopt, std::nullopt, maxElements, thrifty, doubleBuffer, vectorizationInfo, mapping, allocation, memorySpace, doubleBufferMemorySpace, dimOrder);
+    }
+
     void GPUPlan::Tensorize(std::vector<ScalarIndex> indices, std::array<int64_t, 3> dims)
     {
         _impl->Tensorize(indices, dims);
     }
 
-    void GPUPlan::MapIndexToProcessor(ScalarIndex index, Processor proc)
+    void GPUPlan::MapIndexToProcessor(ScalarIndex index, Processor proc, bool reduction)
+    {
+        _impl->MapIndexToProcessor(index, proc, reduction);
+    }
+
+    void GPUPlan::SetPersistentBlocks(int64_t numBlocks)
+    {
+        _impl->SetPersistentBlocks(numBlocks);
+    }
+
+    void GPUPlan::SetStreamKDim(int64_t dim)
     {
-        _impl->MapIndexToProcessor(index, proc);
+        _impl->SetStreamKDim(dim);
     }
 } // namespace value
 } // namespace accera
@@ -139,6 +139,8 @@ namespace value
         {
         case ValueType::Float16:
             [[fallthrough]];
+        case ValueType::BFloat16:
+            [[fallthrough]];
         case ValueType::Float:
             [[fallthrough]];
         case ValueType::Double:
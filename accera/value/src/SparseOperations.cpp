@@ -0,0 +1,242 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SparseOperations.h"
+#include "EmitterContext.h"
+#include "Nest.h"
+#include "Plan.h"
+#include "Profiling.h"
+#include "ScalarOperations.h"
+#include "Schedule.h"
+#include "ValueOperations.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/MemoryLayout.h>
+
+#include <algorithm>
+
+namespace accera
+{
+using namespace utilities;
+
+namespace value
+{
+    namespace
+    {
+        int64_t GetNumRows(const CSRMatrix& A, const std::string& opName)
+        {
+            if (A.rowOffsets.Shape().NumDimensions() != 1 || A.columns.Shape() != A.values.Shape() || A.values.Shape().NumDimensions() != 1)
+            {
+                throw InputException(InputExceptionErrors::invalidArgument, opName + " requires vectors of row offsets, columns and values, with a column for each value");
+            }
+            return A.rowOffsets.Shape()[0] - 1;
+        }
+
+        // The number of rows whose offset is less than the given nonzero, i.e. the first row of the partition that
+        // begins at that nonzero. The offsets are sorted, so this is a binary search, whose steps are unrolled since
+        // the number of rows is known
+        Scalar CountRowsBefore(Array rowOffsets, int64_t numRows, Scalar nonzero)
+        {
+            auto count = Scalar(int64_t{ 0 });
+            int64_t step = 1;
+            while (step * 2 <= numRows)
+            {
+                step *= 2;
+            }
+            for (; step > 0; step /= 2)
+            {
+                auto candidate = Min(count + Scalar(step), Scalar(numRows));
+                auto offset = Cast(rowOffsets(Cast(candidate - Scalar(int64_t{ 1 }), ValueType::Index)), ValueType::Int64);
+                count = Select(offset < nonzero, candidate, count);
+            }
+            return count;
+        }
+
+        // Runs fn on each row of the partitions of the rows of A with about the same number of nonzeros
+        void ForEachPartitionedRow(const CSRMatrix& A, int64_t numRows, int numPartitions, int numThreads, std::function<void(Scalar)> fn)
+        {
+            auto rowOffsets = A.rowOffsets;
+            Nest nest(MemoryShape{ numPartitions });
+            auto p = nest.GetIndices()[0];
+            nest.Set([&]() {
+                auto numNonzeros = Cast(rowOffsets(numRows), ValueType::Int64);
+                auto partition = Cast(p, ValueType::Int64);
+                auto partitions = Scalar(int64_t{ numPartitions });
+                auto one = Scalar(int64_t{ 1 });
+                auto begin = CountRowsBefore(rowOffsets, numRows, numNonzeros * partition / partitions);
+
+                // The empty rows at the end have the offset of the end of the nonzeros, and go to the last partition
+                auto end = Select(partition == partitions - one,
+                                  Scalar(numRows),
+                                  CountRowsBefore(rowOffsets, numRows, numNonzeros * (partition + one) / partitions));
+                ForRange(begin, end, fn);
+            });
+            auto schedule = nest.CreateSchedule();
+            auto plan = schedule.CreatePlan();
+            if (numThreads > 1)
+            {
+                plan.Parallelize({ p }, numThreads, ParallelizationPolicy::Dynamic);
+            }
+        }
+
+        void ValidateEmbeddingBags(Array table, Array indices, Array offsets, Array bags, const std::string& opName)
+        {
+            if (table.Shape().NumDimensions() != 2 || bags.Shape().NumDimensions() != 2 || table.Shape()[1] != bags.Shape()[1])
+            {
+                throw InputException(InputExceptionErrors::sizeMismatch, opName + " requires a table and a matrix of bags with the same number of columns");
+            }
+            if (indices.Shape().NumDimensions() != 1 || offsets.Shape().NumDimensions() != 1 || offsets.Shape()[0] != bags.Shape()[0] + 1)
+            {
+                throw InputException(InputExceptionErrors::sizeMismatch, opName + " requires a vector of indices and a vector of an offset for each bag and its end");
+            }
+        }
+
+        // Runs fn on each element of a row with vectors
+        void ForEachVectorized(int64_t size, std::function<void(Scalar)> fn)
+        {
+            const int vectorSize = 8; // AVX-2 gives 256-bit registers, which can hold 8 floats
+            const int vectorUnits = 16; // AVX-2 has 16 256-bit registers
+
+            Nest nest(MemoryShape{ size });
+            auto j = nest.GetIndices()[0];
+            nest.Set([&]() { fn(j); });
+            auto schedule = nest.CreateSchedule();
+            auto plan = schedule.CreatePlan();
+            plan.Vectorize(j, { vectorSize, vectorUnits, true });
+        }
+    } // namespace
+
+    void SpMV(CSRMatrix A, Array x, Array y, int numPartitions, int numThreads)
+    {
+        ProfileRegion profileRegion("spmv");
+
+        auto numRows = GetNumRows(A, "SpMV");
+        if (x.Shape().NumDimensions() != 1 || x.Shape()[0] != A.numColumns || y.Shape().NumDimensions() != 1 || y.Shape()[0] != numRows)
+        {
+            throw InputException(InputExceptionErrors::sizeMismatch, "SpMV requires a vector of the columns of A and a vector of its rows");
+        }
+        numPartitions = static_cast<int>(std::clamp<int64_t>(numPartitions, 1, std::max<int64_t>(numRows, 1)));
+
+        auto elementType = y.GetType();
+        ForEachPartitionedRow(A, numRows, numPartitions, numThreads, [&](Scalar row) {
+            auto begin = A.rowOffsets(row);
+            auto end = A.rowOffsets(row + 1);
+            y(row) = ReduceN(begin, end, Cast(Scalar(0), elementType), [&](Scalar k, Scalar sum) {
+                return sum + A.values(k) * x(Cast(A.columns(k), ValueType::Index));
+            });
+        });
+    }
+
+    void SpMM(CSRMatrix A, Array X, Array Y, int numPartitions, int numThreads)
+    {
+        ProfileRegion profileRegion("spmm");
+
+        auto numRows = GetNumRows(A, "SpMM");
+        if (X.Shape().NumDimensions() != 2 || X.Shape()[0] != A.numColumns || Y.Shape().NumDimensions() != 2 || Y.Shape()[0] != numRows || Y.Shape()[1] != X.Shape()[1])
+        {
+            throw InputException(InputExceptionErrors::sizeMismatch, "SpMM requires a matrix with a row for each column of A and a matrix with a row for each row of A");
+        }
+        numPartitions = static_cast<int>(std::clamp<int64_t>(numPartitions, 1, std::max<int64_t>(numRows, 1)));
+
+        auto n = X.Shape()[1];
+        auto zero = Cast(Scalar(0), Y.GetType());
+        ForEachPartitionedRow(A, numRows, numPartitions, numThreads, [&](Scalar row) {
+            ForRange(n, [&](Scalar j) {
+                Y(row, j) = zero;
+            });
+            ForRange(A.rowOffsets(row), A.rowOffsets(row + 1), [&](Scalar k) {
+                auto value = A.values(k);
+                auto column = Cast(A.columns(k), ValueType::Index);
+                ForRange(n, [&](Scalar j) {
+                    Y(row, j) += value * X(column, j);
+                });
+            });
+        });
+    }
+
+    void EmbeddingBagSum(Array table, Array indices, Array offsets, Array output, int prefetchDistance, int numThreads)
+    {
+        ProfileRegion profileRegion("embedding_bag_sum");
+
+        const int elementsPerCacheLine = 16; // 64-byte cache lines of 32-bit elements
+
+        ValidateEmbeddingBags(table, indices, offsets, output, "EmbeddingBagSum");
+        auto numBags = output.Shape()[0];
+        auto d = output.Shape()[1];
+        auto zero = Cast(Scalar(0), output.GetType());
+
+        Nest nest(MemoryShape{ numBags });
+        auto b = nest.GetIndices()[0];
+        nest.Set([&]() {
+            auto sum = output.Slice({ 0 }, { b });
+            ForEachVectorized(d, [&](Scalar j) { sum(j) = zero; });
+
+            auto begin = Cast(offsets(b), ValueType::Index);
+            auto end = Cast(offsets(b + 1), ValueType::Index);
+            ForRange(begin, end, [&](Scalar k) {
+                if (prefetchDistance > 0)
+                {
+                    // The last row of the bag is prefetched again rather than reading past the bag
+                    auto ahead = Min(k + prefetchDistance, end - 1);
+                    auto aheadRow = table.Slice({ 0 }, { Cast(indices(ahead), ValueType::Index) });
+                    for (int64_t j = 0; j < d; j += elementsPerCacheLine)
+                    {
+                        Prefetch(aheadRow.SubArray({ j }, { 1 }), PrefetchType::Read, PrefetchLocality::Low);
+                    }
+                }
+
+                auto row = table.Slice({ 0 }, { Cast(indices(k), ValueType::Index) });
+                ForEachVectorized(d, [&](Scalar j) { sum(j) += row(j); });
+            });
+        });
+        auto schedule = nest.CreateSchedule();
+        auto plan = schedule.CreatePlan();
+        if (numThreads > 1)
+        {
+            // The bags have different sizes
+            plan.Parallelize({ b }, numThreads, ParallelizationPolicy::Dynamic);
+        }
+    }
+
+    void EmbeddingBagScatterAdd(Array gradOutput, Array indices, Array offsets, Array gradTable, int numPartitions, int numThreads)
+    {
+        ProfileRegion profileRegion("embedding_bag_scatter_add");
+
+        ValidateEmbeddingBags(gradTable, indices, offsets, gradOutput, "EmbeddingBagScatterAdd");
+        auto numRows = gradTable.Shape()[0];
+        auto numBags = gradOutput.Shape()[0];
+        auto d = gradOutput.Shape()[1];
+        numPartitions = static_cast<int>(std::clamp<int64_t>(numPartitions, 1, std::max<int64_t>(numRows, 1)));
+        auto partitionSize = (numRows + numPartitions - 1) / numPartitions;
+
+        Nest nest(MemoryShape{ numPartitions });
+        auto p = nest.GetIndices()[0];
+        nest.Set([&]() {
+            auto first = Cast(p * partitionSize, ValueType::Int64);
+            auto last = first + Scalar(partitionSize);
+
+            // Every partition reads all of the indices, which are much smaller than the rows they add into
+            ForRange(Scalar(numBags), [&](Scalar bag) {
+                auto grad = gradOutput.Slice({ 0 }, { bag });
+                ForRange(Cast(offsets(bag), ValueType::Index), Cast(offsets(bag + 1), ValueType::Index), [&](Scalar k) {
+                    auto index = Cast(indices(k), ValueType::Int64);
+                    If(index >= first, [&] {
+                        If(index < last, [&] {
+                            auto row = gradTable.Slice({ 0 }, { Cast(index, ValueType::Index) });
+                            ForEachVectorized(d, [&](Scalar j) { row(j) += grad(j); });
+                        });
+                    });
+                });
+            });
+        });
+        auto schedule = nest.CreateSchedule();
+        auto plan = schedule.CreatePlan();
+        if (numThreads > 1)
+        {
+            plan.Parallelize({ p }, numThreads, ParallelizationPolicy::Static);
+        }
+    }
+} // namespace value
+} // namespace accera
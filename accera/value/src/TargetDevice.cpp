@@ -57,12 +57,16 @@ namespace value
         std::string c_armv7Triple = "armv7--linux-gnueabihf"; // raspberry pi 3 and orangepi0
         std::string c_arm64Triple = "aarch64-unknown-linux-gnu"; // DragonBoard
         std::string c_iosTriple = "aarch64-apple-ios"; // alternates: "arm64-apple-ios7.0.0", "thumbv7-apple-ios7.0"
+        std::string c_appleSiliconTriple = "arm64-apple-macosx11.0.0";
 
         // CPUs
         std::string c_armCortexM4 = "cortex-m4";
         std::string c_pi0Cpu = "arm1136jf-s";
         std::string c_pi3Cpu = "cortex-a53";
         std::string c_orangePi0Cpu = "cortex-a7";
+        std::string c_neoverseN1Cpu = "neoverse-n1"; // AWS Graviton2, Ampere Altra
+        std::string c_neoverseV1Cpu = "neoverse-v1"; // AWS Graviton3
+        std::string c_appleM1Cpu = "apple-m1";
 
         // clang settings:
         // target=armv7-apple-darwin
@@ -124,6 +128,30 @@ namespace value
                  targetDevice.dataLayout = c_arm64DataLayout;
                  targetDevice.numBits = 64;
              } },
+            { "neoverse-n1", [](TargetDevice& targetDevice) {
+                 targetDevice.triple = c_arm64Triple;
+                 targetDevice.dataLayout = c_arm64DataLayout;
+                 targetDevice.architecture = "aarch64";
+                 targetDevice.numBits = 64;
+                 targetDevice.cpu = c_neoverseN1Cpu;
+                 targetDevice.features = "+neon,+dotprod,+fullfp16";
+             } },
+            { "neoverse-v1", [](TargetDevice& targetDevice) {
+                 targetDevice.triple = c_arm64Triple;
+                 targetDevice.dataLayout = c_arm64DataLayout;
+                 targetDevice.architecture = "aarch64";
+                 targetDevice.numBits = 64;
+                 targetDevice.cpu = c_neoverseV1Cpu;
+                 targetDevice.features = "+neon,+dotprod,+fullfp16,+bf16,+sve";
+             } },
+            { "apple-m1", [](TargetDevice& targetDevice) {
+                 targetDevice.triple = c_appleSiliconTriple;
+                 targetDevice.dataLayout = c_iosDataLayout;
+                 targetDevice.architecture = "aarch64";
+                 targetDevice.numBits = 64;
+                 targetDevice.cpu = c_appleM1Cpu;
+                 targetDevice.features = "+neon,+dotprod,+fullfp16";
+             } },
             { "ios", [](TargetDevice& targetDevice) {
                  targetDevice.triple = c_iosTriple;
                  targetDevice.dataLayout = c_iosDataLayout;
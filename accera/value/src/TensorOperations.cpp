@@ -42,7 +42,7 @@ namespace value
 
         GetContext().For(
             layout,
-            [fn = std::move(fn)](std::vector<Scalar> coordinates) {
+            [fn = std::move(fn)](const std::vector<Scalar>& coordinates) {
                 fn(coordinates[0], coordinates[1], coordinates[2]);
             },
             name);
@@ -0,0 +1,244 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Copyright (c) Microsoft Corporation. All rights reserved.
+//  Licensed under the MIT License. See LICENSE in the project root for license information.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "TriangularOperations.h"
+#include "ArrayOperations.h"
+#include "EmitterContext.h"
+#include "Nest.h"
+#include "Plan.h"
+#include "Profiling.h"
+#include "ScalarOperations.h"
+#include "Schedule.h"
+
+#include <utilities/include/Exception.h>
+#include <utilities/include/MemoryLayout.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace accera
+{
+using namespace utilities;
+
+namespace value
+{
+    namespace
+    {
+        int64_t GetBlockSize(int64_t size, int blockSize, const std::string& opName)
+        {
+            auto block = std::min<int64_t>(blockSize, size);
+            if (block < 1 || size % block != 0)
+            {
+                throw InputException(InputExceptionErrors::invalidSize, opName + " requires a block size that divides the size of the triangular matrix");
+            }
+            return block;
+        }
+
+        void CheckSquare(Array T, const std::string& opName)
+        {
+            if (T.Shape().NumDimensions() != 2 || T.Shape()[0] != T.Shape()[1])
+            {
+                throw InputException(InputExceptionErrors::sizeMismatch, opName + " requires a square triangular matrix");
+            }
+        }
+
+        // The columns [first, last) of row i of the triangle of a diagonal tile, with or without the diagonal itself
+        std::pair<Scalar, Scalar> GetTriangleColumns(Scalar i, int64_t size, TriangularPart part, bool withDiagonal)
+        {
+            if (part == TriangularPart::Lower)
+            {
+                return { Cast(Scalar(int64_t{ 0 }), ValueType::Index), withDiagonal ? i + 1 : i };
+            }
+            return { withDiagonal ? i : i + 1, Cast(Scalar(size), ValueType::Index) };
+        }
+
+        // Runs fn on each element of a row with vectors
+        void ForEachVectorized(int64_t size, std::function<void(Scalar)> fn)
+        {
+            const int vectorSize = 8; // AVX-2 gives 256-bit registers, which can hold 8 floats
+            const int vectorUnits = 16; // AVX-2 has 16 256-bit registers
+
+            Nest nest(MemoryShape{ size });
+            auto j = nest.GetIndices()[0];
+            nest.Set([&]() { fn(j); });
+            auto schedule = nest.CreateSchedule();
+            auto plan = schedule.CreatePlan();
+            plan.Vectorize(j, { vectorSize, vectorUnits, true });
+        }
+    } // namespace
+
+    void ForTriangularTiles(int64_t numBlocks, TriangularPart part, std::function<void(Scalar, Scalar)> fullTile, std::function<void(Scalar)> diagonalTile, int numThreads)
+    {
+        Nest nest(MemoryShape{ numBlocks });
+        auto step = nest.GetIndices()[0];
+        nest.Set([&]() {
+            auto end = Cast(Scalar(numBlocks), ValueType::Index);
+            if (part == TriangularPart::Lower)
+            {
+                Scalar row = step;
+                ForRange(row, [&](Scalar column) { fullTile(row, column); });
+                diagonalTile(row);
+            }
+            else
+            {
+                auto row = (end - 1) - step;
+                ForRange(row + 1, end, [&](Scalar column) { fullTile(row, column); });
+                diagonalTile(row);
+            }
+        });
+        auto schedule = nest.CreateSchedule();
+        auto plan = schedule.CreatePlan();
+        if (numThreads > 1)
+        {
+            plan.Parallelize({ step }, numThreads, ParallelizationPolicy::Dynamic);
+        }
+    }
+
+    void SymmetricRankKUpdate(Array A, Array C, TriangularPart part, int blockSize, int numThreads)
+    {
+        ProfileRegion profileRegion("syrk");
+
+        if (A.Shape().NumDimensions() != 2 || C.Shape().NumDimensions() != 2 || C.Shape()[0] != A.Shape()[0] || C.Shape()[1] != A.Shape()[0])
+        {
+            throw InputException(InputExceptionErrors::sizeMismatch, "SymmetricRankKUpdate requires an n x k matrix A and an n x n matrix C");
+        }
+        const int64_t n = A.Shape()[0];
+        const int64_t k = A.Shape()[1];
+        const int64_t block = GetBlockSize(n, blockSize, "SymmetricRankKUpdate");
+
+        // The blocks of columns of A^T are the right operands of the tiles, so A is transposed once rather than by each tile
+        auto At = MakeArray({ k, n }, A.GetType(), "At");
+        TransposeMatrix(A, At);
+
+        ForTriangularTiles(
+            n / block,
+            part,
+            [&](Scalar row, Scalar column) {
+                auto rowBegin = row * block;
+                auto columnBegin = column * block;
+                MatMulMlas(A.SubArray({ rowBegin, 0 }, { block, k }),
+                           At.SubArray({ 0, columnBegin }, { k, block }),
+                           C.SubArray({ rowBegin, columnBegin }, { block, block }),
+                           false);
+            },
+            [&](Scalar row) {
+                auto begin = row * block;
+                auto rowsA = A.SubArray({ begin, 0 }, { block, k });
+                auto columnsAt = At.SubArray({ 0, begin }, { k, block });
+                auto tile = C.SubArray({ begin, begin }, { block, block });
+                ForRange(block, [&](Scalar i) {
+                    auto columns = GetTriangleColumns(i, block, part, true);
+                    ForRange(k, [&](Scalar p) {
+                        auto a = rowsA(i, p);
+                        ForRange(columns.first, columns.second, [&](Scalar j) {
+                            tile(i, j) += a * columnsAt(p, j);
+                        });
+                    });
+                });
+            },
+            numThreads);
+    }
+
+    void TriangularMatMul(Array T, Array B, Array C, TriangularPart part, bool unitDiagonal, int blockSize, int numThreads)
+    {
+        ProfileRegion profileRegion("trmm");
+
+        CheckSquare(T, "TriangularMatMul");
+        const int64_t m = T.Shape()[0];
+        if (B.Shape().NumDimensions() != 2 || B.Shape()[0] != m || C.Shape() != B.Shape())
+        {
+            throw InputException(InputExceptionErrors::sizeMismatch, "TriangularMatMul requires m x n matrices B and C for an m x m matrix T");
+        }
+        const int64_t n = B.Shape()[1];
+        const int64_t block = GetBlockSize(m, blockSize, "TriangularMatMul");
+
+        ForTriangularTiles(
+            m / block,
+            part,
+            [&](Scalar row, Scalar column) {
+                auto rowBegin = row * block;
+                auto columnBegin = column * block;
+                MatMulMlas(T.SubArray({ rowBegin, columnBegin }, { block, block }),
+                           B.SubArray({ columnBegin, 0 }, { block, n }),
+                           C.SubArray({ rowBegin, 0 }, { block, n }),
+                           false);
+            },
+            [&](Scalar row) {
+                auto begin = row * block;
+                auto tile = T.SubArray({ begin, begin }, { block, block });
+                auto rowsB = B.SubArray({ begin, 0 }, { block, n });
+                auto rowsC = C.SubArray({ begin, 0 }, { block, n });
+                ForRange(block, [&](Scalar i) {
+                    auto columns = GetTriangleColumns(i, block, part, !unitDiagonal);
+                    ForRange(columns.first, columns.second, [&](Scalar p) {
+                        auto t = tile(i, p);
+                        ForEachVectorized(n, [&](Scalar j) { rowsC(i, j) += t * rowsB(p, j); });
+                    });
+                    if (unitDiagonal)
+                    {
+                        ForEachVectorized(n, [&](Scalar j) { rowsC(i, j) += rowsB(i, j); });
+                    }
+                });
+            },
+            numThreads);
+    }
+
+    void TriangularSolve(Array T, Array B, TriangularPart part, bool unitDiagonal, int blockSize)
+    {
+        ProfileRegion profileRegion("trsm");
+
+        CheckSquare(T, "TriangularSolve");
+        const int64_t m = T.Shape()[0];
+        if (B.Shape().NumDimensions() != 2 || B.Shape()[0] != m)
+        {
+            throw InputException(InputExceptionErrors::sizeMismatch, "TriangularSolve requires an m x n matrix B for an m x m matrix T");
+        }
+        const int64_t n = B.Shape()[1];
+        const int64_t block = GetBlockSize(m, blockSize, "TriangularSolve");
+        auto zero = Cast(Scalar(0), B.GetType());
+
+        // The products of the full tiles of a row of blocks with the solved blocks are summed here, and subtracted
+        // from the row once before its diagonal tile
+        auto update = MakeArray({ block, n }, B.GetType(), "update");
+        ClearArray(update);
+
+        ForTriangularTiles(
+            m / block,
+            part,
+            [&](Scalar row, Scalar column) {
+                MatMulMlas(T.SubArray({ row * block, column * block }, { block, block }),
+                           B.SubArray({ column * block, 0 }, { block, n }),
+                           update,
+                           false);
+            },
+            [&](Scalar row) {
+                auto begin = row * block;
+                auto tile = T.SubArray({ begin, begin }, { block, block });
+                auto rows = B.SubArray({ begin, 0 }, { block, n });
+                ForRange(block, [&](Scalar i) {
+                    ForEachVectorized(n, [&](Scalar j) {
+                        rows(i, j) -= update(i, j);
+                        update(i, j) = zero;
+                    });
+                });
+
+                // Forward substitution down the rows of a lower triangle, back substitution up the rows of an upper one
+                ForRange(block, [&](Scalar step) {
+                    Scalar i = part == TriangularPart::Lower ? step : Cast(Scalar(block - 1), ValueType::Index) - step;
+                    auto columns = GetTriangleColumns(i, block, part, false);
+                    ForRange(columns.first, columns.second, [&](Scalar p) {
+                        auto t = tile(i, p);
+                        ForEachVectorized(n, [&](Scalar j) { rows(i, j) -= t * rows(p, j); });
+                    });
+                    if (!unitDiagonal)
+                    {
+                        auto diagonal = tile(i, i);
+                        ForEachVectorized(n, [&](Scalar j) { rows(i, j) = rows(i, j) / diagonal; });
+                    }
+                });
+            });
+    }
+} // namespace value
+} // namespace accera
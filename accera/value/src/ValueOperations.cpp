@@ -18,7 +18,7 @@ namespace value
 
     namespace detail
     {
-        Scalar CalculateOffset(const MemoryLayout& layout, std::vector<Scalar> coordinates)
+        Scalar CalculateOffset(const MemoryLayout& layout, const std::vector<Scalar>& coordinates)
         {
             if (layout == ScalarLayout)
             {
@@ -50,7 +50,7 @@ namespace value
 
     void For(MemoryLayout layout, std::function<void(Scalar)> fn)
     {
-        GetContext().For(layout, [&layout, fn = std::move(fn)](std::vector<Scalar> coords) {
+        GetContext().For(layout, [&layout, fn = std::move(fn)](const std::vector<Scalar>& coords) {
             fn(detail::CalculateOffset(layout, coords));
         });
     }
@@ -16,9 +16,9 @@ using namespace utilities;
 
 namespace value
 {
-    Scalar Sum(Vector input)
+    Scalar Sum(Vector input, const std::optional<VectorizationInformation>& vectorizationInfo, int64_t accumulators)
     {
-        return GetContext().Sum(input);
+        return GetContext().Sum(input, vectorizationInfo, accumulators);
     }
 
     Vector ToVector(Value data)
@@ -51,9 +51,9 @@ namespace value
         return defaultImpl(v1, v2);
     }
 
-    Scalar Max(Vector input)
+    Scalar Max(Vector input, const std::optional<VectorizationInformation>& vectorizationInfo, int64_t accumulators)
     {
-        return GetContext().Max(input);
+        return GetContext().Max(input, vectorizationInfo, accumulators);
     }
 
     void For(Vector v, std::function<void(Scalar)> fn)
@@ -73,7 +73,7 @@ namespace value
 
         GetContext().For(
             layout,
-            [fn = std::move(fn)](std::vector<Scalar> coordinates) { fn(coordinates[0]); },
+            [fn = std::move(fn)](const std::vector<Scalar>& coordinates) { fn(coordinates[0]); },
             name);
     }
 
@@ -23,7 +23,13 @@
 
 #include "mlir/Support/LogicalResult.h"
 
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 #include <vulkan/vulkan.h>
 
@@ -43,6 +49,31 @@ struct VulkanDeviceMemoryBuffer
     VkBuffer deviceBuffer{ VK_NULL_HANDLE };
     VkDeviceMemory deviceMemory{ VK_NULL_HANDLE };
     uint32_t bufferSize{ 0 };
+    VkBufferUsageFlags bufferUsage{ 0 };
+    /// Persistent mapping of deviceMemory when it is host visible, in which case
+    /// there is no staging (host) buffer.
+    void* mappedDeviceMemory{ nullptr };
+    /// Buffer over the imported memory of the resource's host pointer, which the
+    /// descriptor is bound to instead of deviceBuffer while importedHostPointer is set.
+    /// Both are null when the host pointer is that of a resident buffer, which the
+    /// descriptor is bound to instead.
+    VkBuffer importedBuffer{ VK_NULL_HANDLE };
+    VkDeviceMemory importedMemory{ VK_NULL_HANDLE };
+    void* importedHostPointer{ nullptr };
+};
+
+/// Device buffer that stays allocated across runs, so that the output of a kernel
+/// can be the input of the next one without a round trip through the host. The
+/// host accesses it through hostPointer, which is the mapped device memory when it
+/// is host visible and the mapped staging memory otherwise.
+struct VulkanResidentBuffer
+{
+    VkBuffer deviceBuffer{ VK_NULL_HANDLE };
+    VkDeviceMemory deviceMemory{ VK_NULL_HANDLE };
+    VkBuffer stagingBuffer{ VK_NULL_HANDLE };
+    VkDeviceMemory stagingMemory{ VK_NULL_HANDLE };
+    VkDeviceSize size{ 0 };
+    void* hostPointer{ nullptr };
 };
 
 /// Struct containing information regarding to a host memory buffer.
@@ -63,6 +94,21 @@ struct NumWorkGroups
     uint32_t z{ 1 };
 };
 
+/// Timings of the dispatches of one kernel, in microseconds.
+struct VulkanDispatchTimings
+{
+    /// Number of timed dispatches.
+    uint64_t count{ 0 };
+    /// Device execution time of the compute shader, measured with timestamp
+    /// queries. Zero when the queue doesn't support timestamps.
+    double totalShaderTime{ 0 };
+    double minShaderTime{ 0 };
+    double maxShaderTime{ 0 };
+    /// Host time spent submitting the command buffers and waiting for them.
+    double totalSubmitTime{ 0 };
+    double totalIdleTime{ 0 };
+};
+
 /// Struct containing information regarding a descriptor set.
 struct DescriptorSetInfo
 {
@@ -94,6 +140,44 @@ using ResourceStorageClassBindingMap =
     std::unordered_map<DescriptorSetIndex,
                        std::unordered_map<BindingIndex, SPIRVStorageClass>>;
 
+/// The Vulkan objects needed to dispatch one kernel: its shader and pipeline, the device buffers bound to it and the
+/// command buffers that dispatch it. They are created on the first launch of a kernel and reused by the launches with
+/// the same shader, entry point, buffer sizes and number of work groups.
+struct VulkanPipelineState
+{
+    /// Specifies VulkanDeviceMemoryBuffers divided into sets.
+    std::unordered_map<DescriptorSetIndex, std::vector<VulkanDeviceMemoryBuffer>>
+        deviceMemoryBufferMap;
+
+    /// Specifies shader module.
+    VkShaderModule shaderModule{ VK_NULL_HANDLE };
+
+    /// Specifies layout bindings.
+    std::unordered_map<DescriptorSetIndex,
+                       std::vector<VkDescriptorSetLayoutBinding>>
+        descriptorSetLayoutBindingMap;
+
+    /// Specifies layouts of descriptor sets.
+    std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
+    VkPipelineLayout pipelineLayout{ VK_NULL_HANDLE };
+
+    /// Specifies descriptor sets.
+    std::vector<VkDescriptorSet> descriptorSets;
+
+    /// Specifies a pool of descriptor set info, each descriptor set must have
+    /// information such as type, index and amount of bindings.
+    std::vector<DescriptorSetInfo> descriptorSetInfoPool;
+    VkDescriptorPool descriptorPool{ VK_NULL_HANDLE };
+
+    /// Computation pipeline.
+    VkPipeline pipeline{ VK_NULL_HANDLE };
+    std::vector<VkCommandBuffer> commandBuffers;
+
+    /// Whether a buffer bound to the descriptors was destroyed since the command
+    /// buffers were recorded.
+    bool bindingsChanged{ false };
+};
+
 /// Vulkan runtime.
 /// The purpose of this class is to run SPIR-V compute shader on Vulkan
 /// device.
@@ -103,6 +187,10 @@ using ResourceStorageClassBindingMap =
 /// sequence: initRuntime(), run(), updateHostMemoryBuffers(), destroy();
 /// each method in the sequence returns success or failure depends on the Vulkan
 /// result code.
+/// The device connection lives from initRuntime() to destroy(), and the pipeline
+/// state of each kernel is kept from one run() to the next. When the
+/// ACCERA_VULKAN_PIPELINE_CACHE environment variable names a file, the compiled
+/// pipelines are also saved to it and reloaded by the next process.
 class VulkanRuntime
 {
 public:
@@ -130,9 +218,31 @@ public:
     /// Runs runtime.
     LogicalResult run();
 
+    /// Returns the timings of the timed dispatches of the last run.
+    const VulkanDispatchTimings& getLastRunTimings() const { return lastRunTimings; }
+    const char* getEntryPoint() const { return entryPoint; }
+
     /// Updates host memory buffers.
     LogicalResult updateHostMemoryBuffers();
 
+    /// Starts a batch: the following runs record their dispatches into one
+    /// command buffer instead of submitting them, and endBatch() submits it once
+    /// and waits for it. A dispatch that binds a host pointer bound by an earlier
+    /// dispatch of the batch waits for it behind a pipeline barrier and reads its
+    /// result on the device, and the host memory is only updated by endBatch().
+    /// Timed runs are submitted on their own, after the dispatches recorded so far.
+    LogicalResult beginBatch();
+    LogicalResult endBatch();
+
+    /// Allocates a resident buffer of the given size and returns the host pointer
+    /// that identifies it. Resources bound with that pointer use the resident
+    /// buffer directly, without being copied to or from the host.
+    LogicalResult createResidentBuffer(VkDeviceSize size, void*& hostPointer);
+    /// Copies the staging memory of a resident buffer to its device memory or back.
+    /// Does nothing when the device memory is host visible.
+    LogicalResult copyResidentBuffer(void* hostPointer, bool deviceToHost);
+    void destroyResidentBuffer(void* hostPointer);
+
     /// Destroys all created vulkan objects and resources.
     LogicalResult destroy();
 
@@ -144,7 +254,14 @@ private:
     LogicalResult createInstance();
     LogicalResult createDevice();
     LogicalResult getBestComputeQueue();
+    LogicalResult getHostPointerImportSupport();
+    LogicalResult getOptionalDeviceFeatures();
+    LogicalResult checkShaderCapabilities();
     LogicalResult createMemoryBuffers();
+    LogicalResult createPipelineState();
+    void destroyPipelineState(VulkanPipelineState& state);
+    LogicalResult createPipelineCache();
+    LogicalResult savePipelineCache();
     LogicalResult createShaderModule();
     void initDescriptorSetLayoutBindingMap();
     LogicalResult createDescriptorSetLayout();
@@ -157,9 +274,32 @@ private:
     LogicalResult createQueryPool();
     LogicalResult createComputeCommandBuffer();
     LogicalResult submitCommandBuffersToQueue();
+    // Create the pipeline state of the current run and bind its resources.
+    LogicalResult preparePipelineState();
+    // Record the dispatch of the current run into the batch command buffer.
+    LogicalResult recordBatchedRun();
+    LogicalResult beginBatchCommandBuffer();
+    // Submit the batch command buffer, wait for it and update the host memory
+    // of the resources of the batch.
+    LogicalResult submitBatch();
+    // Copy between a host memory buffer and the device memory or staging memory
+    // of a resource.
+    LogicalResult copyHostMemory(VulkanDeviceMemoryBuffer& memoryBuffer, const VulkanHostMemoryBuffer& hostMemoryBuffer, bool deviceToHost);
+    // Record the commands of recordCommands into a one-time command buffer,
+    // submit it and wait for it to complete.
+    LogicalResult submitOneTimeCommands(const std::function<void(VkCommandBuffer)>& recordCommands);
     // Copy resources from host (staging buffer) to device buffer or from device
     // buffer to host buffer.
     LogicalResult copyResource(bool deviceToHost);
+    // Copy the resource data to the host (staging) buffers.
+    LogicalResult updateStagingMemoryBuffers();
+    // Bind the resident buffers and the resources whose host memory can be
+    // imported to the device directly, re-recording the command buffers if a
+    // binding changed.
+    LogicalResult importHostMemoryBuffers();
+    LogicalResult importHostMemoryBuffer(VulkanDeviceMemoryBuffer& memoryBuffer, const VulkanHostMemoryBuffer& hostMemoryBuffer, bool& imported);
+    void releaseImportedMemoryBuffer(VulkanDeviceMemoryBuffer& memoryBuffer);
+    void releaseResidentBuffer(VulkanResidentBuffer& residentBuffer);
 
     //===--------------------------------------------------------------------===//
     // Helper methods.
@@ -177,6 +317,10 @@ private:
 
     LogicalResult countDeviceMemorySize();
 
+    /// Returns the key of the pipeline state used by the current shader, entry
+    /// point, resources and number of work groups.
+    std::string getPipelineStateKey() const;
+
     //===--------------------------------------------------------------------===//
     // Vulkan objects.
     //===--------------------------------------------------------------------===//
@@ -186,39 +330,24 @@ private:
     VkDevice device{ VK_NULL_HANDLE };
     VkQueue queue{ VK_NULL_HANDLE };
 
-    /// Specifies VulkanDeviceMemoryBuffers divided into sets.
-    std::unordered_map<DescriptorSetIndex, std::vector<VulkanDeviceMemoryBuffer>>
-        deviceMemoryBufferMap;
+    /// Pipeline states of the kernels launched so far, by key, and their keys from
+    /// the least to the most recently created one.
+    std::unordered_map<std::string, std::unique_ptr<VulkanPipelineState>> pipelineStates;
+    std::deque<std::string> pipelineStateKeys;
 
-    /// Specifies shader module.
-    VkShaderModule shaderModule{ VK_NULL_HANDLE };
+    /// Pipeline state of the current run.
+    VulkanPipelineState* pipelineState{ nullptr };
 
-    /// Specifies layout bindings.
-    std::unordered_map<DescriptorSetIndex,
-                       std::vector<VkDescriptorSetLayoutBinding>>
-        descriptorSetLayoutBindingMap;
-
-    /// Specifies layouts of descriptor sets.
-    std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
-    VkPipelineLayout pipelineLayout{ VK_NULL_HANDLE };
-
-    /// Specifies descriptor sets.
-    std::vector<VkDescriptorSet> descriptorSets;
-
-    /// Specifies a pool of descriptor set info, each descriptor set must have
-    /// information such as type, index and amount of bindings.
-    std::vector<DescriptorSetInfo> descriptorSetInfoPool;
-    VkDescriptorPool descriptorPool{ VK_NULL_HANDLE };
+    /// Cache of the compiled pipelines, persisted to pipelineCachePath if set.
+    VkPipelineCache pipelineCache{ VK_NULL_HANDLE };
+    std::string pipelineCachePath;
 
     /// Timestamp query.
     VkQueryPool queryPool{ VK_NULL_HANDLE };
     // Number of nonoseconds for timestamp to increase 1
     float timestampPeriod{ 0.f };
 
-    /// Computation pipeline.
-    VkPipeline pipeline{ VK_NULL_HANDLE };
     VkCommandPool commandPool{ VK_NULL_HANDLE };
-    std::vector<VkCommandBuffer> commandBuffers;
 
     //===--------------------------------------------------------------------===//
     // Vulkan memory context.
@@ -229,6 +358,40 @@ private:
     uint32_t hostMemoryTypeIndex{ VK_MAX_MEMORY_TYPES };
     uint32_t deviceMemoryTypeIndex{ VK_MAX_MEMORY_TYPES };
     VkDeviceSize memorySize{ 0 };
+    /// Whether deviceMemoryTypeIndex is also host visible and coherent (integrated GPUs),
+    /// so that resources don't need staging buffers.
+    bool deviceMemoryHostVisible{ false };
+
+    /// Host pointer import (VK_EXT_external_memory_host).
+    bool hostPointerImportSupported{ false };
+    VkDeviceSize minImportedHostPointerAlignment{ 0 };
+    VkDeviceSize minStorageBufferOffsetAlignment{ 1 };
+    VkPhysicalDeviceMemoryProperties memoryProperties{};
+    PFN_vkGetMemoryHostPointerPropertiesEXT getMemoryHostPointerProperties{ nullptr };
+
+    /// Optional features that the tensorized kernels (VK_NV_cooperative_matrix,
+    /// FP16 arithmetic and storage) and the subgroup reductions need, enabled on
+    /// the device when it supports them.
+    bool cooperativeMatrixSupported{ false };
+    bool shaderFloat16Supported{ false };
+    bool storageBuffer16BitAccessSupported{ false };
+    bool subgroupArithmeticSupported{ false };
+
+    /// Resident buffers, by host pointer.
+    std::unordered_map<void*, VulkanResidentBuffer> residentBuffers;
+
+    //===--------------------------------------------------------------------===//
+    // Vulkan batch context.
+    //===--------------------------------------------------------------------===//
+
+    /// Command buffer that the dispatches of the open batch are recorded into.
+    VkCommandBuffer batchCommandBuffer{ VK_NULL_HANDLE };
+    /// The device buffer that each host pointer of the batch was last bound to,
+    /// which holds its latest contents, and its size.
+    std::unordered_map<void*, std::pair<VulkanDeviceMemoryBuffer*, uint32_t>> batchResources;
+    /// The pipeline states recorded into the batch, whose buffers and
+    /// descriptors must not change until it is submitted.
+    std::unordered_set<VulkanPipelineState*> batchPipelineStates;
 
     //===--------------------------------------------------------------------===//
     // Vulkan execution context.
@@ -253,5 +416,6 @@ private:
     bool shouldPrintTimings{ false };
     uint32_t timingWarmupCount{ 0 };
     uint32_t timingRunCount{ 1 };
+    VulkanDispatchTimings lastRunTimings;
 };
 #endif
@@ -21,17 +21,27 @@
 
 #include "VulkanRuntime.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
 #include <cstring>
+#include <fstream>
+#include <functional>
 // TODO: It's generally bad to access stdout/stderr in a library.
 // Figure out a better way for error reporting.
 #include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <string_view>
+#include <tuple>
 #include <vector>
 
 #define ACCERA_WARMUP_RUN_COUNT 5
 #define ACCERA_TIMING_RUN_COUNT 10
 
+// Number of kernel pipeline states kept alive, each holds the device buffers of its kernel
+static constexpr size_t kMaxPipelineStates = 16;
+
 inline void emitVulkanError(const char* api, VkResult error)
 {
     std::cerr << " failed with error code " << error << " when executing " << api;
@@ -86,10 +96,6 @@ void VulkanRuntime::setShaderModule(uint8_t* shader, uint32_t size)
     {
         std::cerr << "binary shader size must be greater than zero";
     }
-    if (failed(createShaderModule()))
-    {
-        std::cerr << "CreateShaderModule failed!";
-    }
 }
 
 void VulkanRuntime::setRepeatedRunCharacteristics(bool printTimings, uint32_t warmupCount, uint32_t runCount)
@@ -133,6 +139,7 @@ LogicalResult VulkanRuntime::mapStorageClassToBufferUsageFlag(
 
 LogicalResult VulkanRuntime::countDeviceMemorySize()
 {
+    memorySize = 0;
     for (const auto& resourceDataMapPair : resourceData)
     {
         const auto& resourceDataMap = resourceDataMapPair.second;
@@ -158,17 +165,21 @@ LogicalResult VulkanRuntime::initRuntime()
     if (failed(createInstance()) ||
         failed(createDevice()) ||
         failed(createCommandPool()) ||
-        failed(createQueryPool()))
+        failed(createQueryPool()) ||
+        failed(createPipelineCache()))
     {
         return failure();
     }
 
+    // Get working queue.
+    vkGetDeviceQueue(device, queueFamilyIndex, 0, &queue);
+
     return success();
 }
 
 LogicalResult VulkanRuntime::destroy()
 {
-    // Destroy runtime components constructed in initRuntime()
+    // Destroy runtime components constructed in initRuntime() and the pipeline states of the runs
 
     // According to Vulkan spec:
     // "To ensure that no work is active on the device, vkDeviceWaitIdle can be
@@ -178,12 +189,34 @@ LogicalResult VulkanRuntime::destroy()
     // corresponding vkCreate* or vkAllocate* command."
     RETURN_ON_VULKAN_ERROR(vkDeviceWaitIdle(device), "vkDeviceWaitIdle");
 
+    // A batch that was never submitted is dropped with the command pool
+    batchCommandBuffer = VK_NULL_HANDLE;
+    batchResources.clear();
+    batchPipelineStates.clear();
+
+    for (auto& [key, state] : pipelineStates)
+    {
+        destroyPipelineState(*state);
+    }
+    pipelineStates.clear();
+    pipelineStateKeys.clear();
+    pipelineState = nullptr;
+
+    for (auto& [hostPointer, residentBuffer] : residentBuffers)
+    {
+        releaseResidentBuffer(residentBuffer);
+    }
+    residentBuffers.clear();
+
+    // A cache that cannot be saved only costs the next process a recompilation
+    (void)savePipelineCache();
+    vkDestroyPipelineCache(device, pipelineCache, nullptr);
+    pipelineCache = VK_NULL_HANDLE;
+
     vkDestroyQueryPool(device, queryPool, nullptr);
     queryPool = VK_NULL_HANDLE;
     vkDestroyCommandPool(device, commandPool, nullptr);
     commandPool = VK_NULL_HANDLE;
-    vkDestroyShaderModule(device, shaderModule, nullptr);
-    shaderModule = VK_NULL_HANDLE;
 
     vkDestroyDevice(device, nullptr);
     device = VK_NULL_HANDLE;
@@ -192,15 +225,51 @@ LogicalResult VulkanRuntime::destroy()
     return success();
 }
 
-LogicalResult VulkanRuntime::run()
+std::string VulkanRuntime::getPipelineStateKey() const
 {
-    // Initialize memory buffers for this run
-    if (resourceData.empty())
+    // Everything recorded into the command buffers of a pipeline state is
+    // determined by the shader, its entry point, the buffer bound to each
+    // descriptor and the number of work groups
+    std::string key = std::to_string(std::hash<std::string_view>{}(std::string_view(reinterpret_cast<const char*>(binary), binarySize)));
+    key += ":" + std::to_string(binarySize) + ":" + entryPoint;
+    for (const auto& [descriptorSetIndex, resourceDataMap] : resourceData)
     {
-        std::cerr << "Vulkan runtime needs at least one resource";
-        return failure();
+        for (const auto& [bindingIndex, hostMemoryBuffer] : resourceDataMap)
+        {
+            key += ":" + std::to_string(descriptorSetIndex) + "." + std::to_string(bindingIndex) + "=" + std::to_string(hostMemoryBuffer.size);
+        }
+    }
+    key += ":" + std::to_string(numWorkGroups.x) + "x" + std::to_string(numWorkGroups.y) + "x" + std::to_string(numWorkGroups.z);
+    return key;
+}
+
+LogicalResult VulkanRuntime::createPipelineState()
+{
+    pipelineState = nullptr;
+    auto key = getPipelineStateKey();
+    if (auto it = pipelineStates.find(key); it != pipelineStates.end())
+    {
+        pipelineState = it->second.get();
+        return success();
     }
-    if (failed(countDeviceMemorySize()) || failed(createMemoryBuffers()))
+
+    // Keep the device memory held by the cached states bounded
+    if (pipelineStates.size() == kMaxPipelineStates)
+    {
+        auto& oldestKey = pipelineStateKeys.front();
+        destroyPipelineState(*pipelineStates[oldestKey]);
+        pipelineStates.erase(oldestKey);
+        pipelineStateKeys.pop_front();
+    }
+
+    auto& state = pipelineStates[key];
+    state = std::make_unique<VulkanPipelineState>();
+    pipelineStateKeys.push_back(key);
+    pipelineState = state.get();
+
+    // Initialize memory buffers for this pipeline state
+    if (failed(countDeviceMemorySize()) || failed(createMemoryBuffers()) ||
+        failed(createShaderModule()))
     {
         return failure();
     }
@@ -218,10 +287,131 @@ LogicalResult VulkanRuntime::run()
         return failure();
     }
 
-    // Get working queue.
-    vkGetDeviceQueue(device, queueFamilyIndex, 0, &queue);
+    return success();
+}
+
+void VulkanRuntime::destroyPipelineState(VulkanPipelineState& state)
+{
+    vkFreeCommandBuffers(device, commandPool, state.commandBuffers.size(), state.commandBuffers.data());
+    state.commandBuffers.clear();
+    vkDestroyDescriptorPool(device, state.descriptorPool, nullptr);
+    state.descriptorPool = VK_NULL_HANDLE;
+    state.descriptorSets.clear();
+    state.descriptorSetInfoPool.clear();
+    vkDestroyPipeline(device, state.pipeline, nullptr);
+    state.pipeline = VK_NULL_HANDLE;
+    vkDestroyPipelineLayout(device, state.pipelineLayout, nullptr);
+    state.pipelineLayout = VK_NULL_HANDLE;
+    for (auto& descriptorSetLayout : state.descriptorSetLayouts)
+    {
+        vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+    }
+    state.descriptorSetLayouts.clear();
+    vkDestroyShaderModule(device, state.shaderModule, nullptr);
+    state.shaderModule = VK_NULL_HANDLE;
+
+    // For each descriptor set.
+    for (auto& deviceMemoryBufferMapPair : state.deviceMemoryBufferMap)
+    {
+        auto& deviceMemoryBuffers = deviceMemoryBufferMapPair.second;
+        // For each descriptor binding.
+        for (auto& memoryBuffer : deviceMemoryBuffers)
+        {
+            releaseImportedMemoryBuffer(memoryBuffer);
+            vkFreeMemory(device, memoryBuffer.deviceMemory, nullptr);
+            vkFreeMemory(device, memoryBuffer.hostMemory, nullptr);
+            vkDestroyBuffer(device, memoryBuffer.hostBuffer, nullptr);
+            vkDestroyBuffer(device, memoryBuffer.deviceBuffer, nullptr);
+        }
+    }
+    state.deviceMemoryBufferMap.clear();
+}
+
+LogicalResult VulkanRuntime::createPipelineCache()
+{
+    std::vector<char> initialData;
+    if (auto path = std::getenv("ACCERA_VULKAN_PIPELINE_CACHE"))
+    {
+        pipelineCachePath = path;
+
+        // The driver validates the header of the data and ignores data written
+        // by another driver or device
+        std::ifstream file(pipelineCachePath, std::ios::binary);
+        initialData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {};
+    pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    pipelineCacheCreateInfo.pNext = nullptr;
+    pipelineCacheCreateInfo.flags = 0;
+    pipelineCacheCreateInfo.initialDataSize = initialData.size();
+    pipelineCacheCreateInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+    RETURN_ON_VULKAN_ERROR(vkCreatePipelineCache(device, &pipelineCacheCreateInfo,
+                                                 /*pAllocator=*/nullptr,
+                                                 &pipelineCache),
+                           "vkCreatePipelineCache");
+    return success();
+}
+
+LogicalResult VulkanRuntime::savePipelineCache()
+{
+    if (pipelineCachePath.empty())
+        return success();
+
+    size_t dataSize = 0;
+    RETURN_ON_VULKAN_ERROR(vkGetPipelineCacheData(device, pipelineCache, &dataSize, nullptr),
+                           "vkGetPipelineCacheData");
+    std::vector<char> data(dataSize);
+    RETURN_ON_VULKAN_ERROR(vkGetPipelineCacheData(device, pipelineCache, &dataSize, data.data()),
+                           "vkGetPipelineCacheData");
+
+    std::ofstream file(pipelineCachePath, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), dataSize);
+    if (!file)
+    {
+        std::cerr << "cannot write the pipeline cache to " << pipelineCachePath;
+        return failure();
+    }
+    return success();
+}
+
+LogicalResult VulkanRuntime::preparePipelineState()
+{
+    if (resourceData.empty())
+    {
+        std::cerr << "Vulkan runtime needs at least one resource";
+        return failure();
+    }
+    if (failed(createPipelineState()))
+    {
+        // Don't leave a partially created state behind for the next run to pick up
+        if (pipelineState)
+        {
+            destroyPipelineState(*pipelineState);
+            pipelineStates.erase(pipelineStateKeys.back());
+            pipelineStateKeys.pop_back();
+            pipelineState = nullptr;
+        }
+        return failure();
+    }
+    return importHostMemoryBuffers();
+}
+
+LogicalResult VulkanRuntime::run()
+{
+    if (batchCommandBuffer != VK_NULL_HANDLE)
+    {
+        if (!shouldPrintTimings && timingWarmupCount == 0 && timingRunCount == 1)
+            return recordBatchedRun();
+
+        // Timed runs are submitted on their own, after the dispatches recorded so far
+        if (failed(submitBatch()) || failed(beginBatchCommandBuffer()))
+            return failure();
+    }
 
-    if (failed(copyResource(/*deviceToHost=*/false)))
+    if (failed(preparePipelineState()) ||
+        failed(updateStagingMemoryBuffers()) ||
+        failed(copyResource(/*deviceToHost=*/false)))
         return failure();
 
     // TODO : refactor this run code better
@@ -242,12 +432,7 @@ LogicalResult VulkanRuntime::run()
             execEnd - submitEnd);
     }
 
-    std::vector<std::chrono::microseconds> submitDurations;
-    std::vector<std::chrono::microseconds> idleDurations;
-    std::vector<float> shaderExecDurations;
-    submitDurations.reserve(timingRunCount);
-    idleDurations.reserve(timingRunCount);
-    shaderExecDurations.reserve(timingRunCount);
+    lastRunTimings = {};
     for (uint32_t runIdx = 0; runIdx < timingRunCount; ++runIdx)
     {
         auto submitStart = std::chrono::high_resolution_clock::now();
@@ -263,8 +448,9 @@ LogicalResult VulkanRuntime::run()
             submitEnd - submitStart);
         auto idleDuration = std::chrono::duration_cast<std::chrono::microseconds>(
             idleEnd - submitEnd);
-        submitDurations.push_back(submitDuration);
-        idleDurations.push_back(idleDuration);
+        lastRunTimings.count++;
+        lastRunTimings.totalSubmitTime += submitDuration.count();
+        lastRunTimings.totalIdleTime += idleDuration.count();
 
         if (queryPool != VK_NULL_HANDLE)
         {
@@ -278,77 +464,229 @@ LogicalResult VulkanRuntime::run()
                     VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT),
                 "vkGetQueryPoolResults");
 
-            float microsec = (timestamps[1] - timestamps[0]) * timestampPeriod / 1000;
-            shaderExecDurations.push_back(microsec);
+            double microsec = (timestamps[1] - timestamps[0]) * timestampPeriod / 1000;
+            lastRunTimings.totalShaderTime += microsec;
+            lastRunTimings.minShaderTime = lastRunTimings.count == 1 ? microsec : std::min(lastRunTimings.minShaderTime, microsec);
+            lastRunTimings.maxShaderTime = std::max(lastRunTimings.maxShaderTime, microsec);
         }
     }
 
-    double shaderExecDurationsSum = 0.0;
-    double submitDurationSum = 0.0;
-    double idleDurationsSum = 0.0;
-    for (size_t idx = 0; idx < timingRunCount; ++idx)
+    if (shouldPrintTimings && lastRunTimings.count > 0)
     {
-        shaderExecDurationsSum += shaderExecDurations[idx];
-        submitDurationSum += submitDurations[idx].count();
-        idleDurationsSum += idleDurations[idx].count();
-    }
-    double shaderExecDurationsAvg = shaderExecDurationsSum / timingRunCount;
-    double submitDurationAvg = submitDurationSum / timingRunCount;
-    double idleDurationsAvg = idleDurationsSum / timingRunCount;
+        double shaderExecDurationsAvg = lastRunTimings.totalShaderTime / lastRunTimings.count;
+        double submitDurationAvg = lastRunTimings.totalSubmitTime / lastRunTimings.count;
+        double idleDurationsAvg = lastRunTimings.totalIdleTime / lastRunTimings.count;
 
-    if (shouldPrintTimings)
-    {
         std::cout << "Average Compute shader execution time: " << std::setprecision(10) << shaderExecDurationsAvg << "us" << std::endl;
         std::cout << "Average Command buffer submit time: " << std::setprecision(10) << submitDurationAvg << "us" << std::endl;
         std::cout << "Average Wait idle time: " << std::setprecision(10) << idleDurationsAvg << "us" << std::endl;
     }
 
     // update host memory buffers
-    updateHostMemoryBuffers();
+    return updateHostMemoryBuffers();
+}
 
-    // Destroy the memory buffer components created as part of this run
+LogicalResult VulkanRuntime::beginBatch()
+{
+    if (batchCommandBuffer != VK_NULL_HANDLE)
+        return success();
+    return beginBatchCommandBuffer();
+}
 
-    // According to Vulkan spec:
-    // "To ensure that no work is active on the device, vkDeviceWaitIdle can be
-    // used to gate the destruction of the device. Prior to destroying a device,
-    // an application is responsible for destroying/freeing any Vulkan objects
-    // that were created using that device as the first parameter of the
-    // corresponding vkCreate* or vkAllocate* command."
-    RETURN_ON_VULKAN_ERROR(vkDeviceWaitIdle(device), "vkDeviceWaitIdle");
+LogicalResult VulkanRuntime::endBatch()
+{
+    if (batchCommandBuffer == VK_NULL_HANDLE)
+        return success();
+    return submitBatch();
+}
+
+LogicalResult VulkanRuntime::beginBatchCommandBuffer()
+{
+    VkCommandBufferAllocateInfo commandBufferAllocateInfo = {};
+    commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    commandBufferAllocateInfo.pNext = nullptr;
+    commandBufferAllocateInfo.commandPool = commandPool;
+    commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    commandBufferAllocateInfo.commandBufferCount = 1;
+    RETURN_ON_VULKAN_ERROR(vkAllocateCommandBuffers(device, &commandBufferAllocateInfo, &batchCommandBuffer),
+                           "vkAllocateCommandBuffers");
+
+    VkCommandBufferBeginInfo commandBufferBeginInfo = {};
+    commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    commandBufferBeginInfo.pNext = nullptr;
+    commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    commandBufferBeginInfo.pInheritanceInfo = nullptr;
+    RETURN_ON_VULKAN_ERROR(vkBeginCommandBuffer(batchCommandBuffer, &commandBufferBeginInfo),
+                           "vkBeginCommandBuffer");
+    return success();
+}
+
+LogicalResult VulkanRuntime::recordBatchedRun()
+{
+    // The buffers and descriptors of a pipeline state can only be recorded once per batch, and a state that is evicted
+    // can't stay recorded, so the batch so far is submitted first when this run would reuse or evict one
+    auto key = getPipelineStateKey();
+    auto stateIt = pipelineStates.find(key);
+    bool reusesState = stateIt != pipelineStates.end() && batchPipelineStates.count(stateIt->second.get());
+    bool evictsState = stateIt == pipelineStates.end() && pipelineStates.size() == kMaxPipelineStates &&
+                       batchPipelineStates.count(pipelineStates[pipelineStateKeys.front()].get());
+    if ((reusesState || evictsState) && (failed(submitBatch()) || failed(beginBatchCommandBuffer())))
+        return failure();
+
+    if (failed(preparePipelineState()))
+        return failure();
+    batchPipelineStates.insert(pipelineState);
+
+    // A resource that an earlier dispatch of the batch bound is read from the device buffer that dispatch used, and
+    // the others are uploaded from the host
+    bool dependent = false;
+    std::vector<std::tuple<VkBuffer, VkBuffer, VkBufferCopy>> copies;
+    std::unordered_map<void*, std::pair<VulkanDeviceMemoryBuffer*, uint32_t>> boundResources;
+    for (auto& resourceDataMapPair : resourceData)
+    {
+        auto& resourceDataMap = resourceDataMapPair.second;
+        auto& deviceMemoryBuffers = pipelineState->deviceMemoryBufferMap[resourceDataMapPair.first];
+        for (auto& deviceMemoryBuffer : deviceMemoryBuffers)
+        {
+            auto hostMemoryBufferIt = resourceDataMap.find(deviceMemoryBuffer.bindingIndex);
+            if (hostMemoryBufferIt == resourceDataMap.end())
+                continue;
+            auto& hostMemoryBuffer = hostMemoryBufferIt->second;
 
-    // Free and destroy.
-    vkFreeCommandBuffers(device, commandPool, commandBuffers.size(), commandBuffers.data());
-    commandBuffers.clear();
-    vkFreeDescriptorSets(device, descriptorPool, descriptorSets.size(), descriptorSets.data());
-    descriptorSets.clear();
-    descriptorSetInfoPool.clear();
-    vkDestroyDescriptorPool(device, descriptorPool, nullptr);
-    descriptorPool = VK_NULL_HANDLE;
-    vkDestroyPipeline(device, pipeline, nullptr);
-    pipeline = VK_NULL_HANDLE;
-    vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
-    pipelineLayout = VK_NULL_HANDLE;
-    for (auto& descriptorSetLayout : descriptorSetLayouts)
+            if (auto previousIt = batchResources.find(hostMemoryBuffer.ptr); previousIt != batchResources.end())
+            {
+                dependent = true;
+                auto& previous = *previousIt->second.first;
+                // Buffers bound to the host pointer itself, imported or resident, share its memory
+                if (!(previous.importedHostPointer && deviceMemoryBuffer.importedHostPointer))
+                {
+                    VkBufferCopy copy = { previous.bufferInfo.offset, deviceMemoryBuffer.bufferInfo.offset, hostMemoryBuffer.size };
+                    copies.emplace_back(previous.bufferInfo.buffer, deviceMemoryBuffer.bufferInfo.buffer, copy);
+                }
+            }
+            else if (!deviceMemoryBuffer.importedHostPointer)
+            {
+                if (failed(copyHostMemory(deviceMemoryBuffer, hostMemoryBuffer, /*deviceToHost=*/false)))
+                    return failure();
+                if (!deviceMemoryBuffer.mappedDeviceMemory)
+                {
+                    VkBufferCopy copy = { 0, 0, hostMemoryBuffer.size };
+                    copies.emplace_back(deviceMemoryBuffer.hostBuffer, deviceMemoryBuffer.deviceBuffer, copy);
+                }
+            }
+            boundResources[hostMemoryBuffer.ptr] = { &deviceMemoryBuffer, hostMemoryBuffer.size };
+        }
+    }
+    for (auto& boundResource : boundResources)
     {
-        vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+        batchResources[boundResource.first] = boundResource.second;
     }
-    descriptorSetLayouts.clear();
 
-    // For each descriptor set.
-    for (auto& deviceMemoryBufferMapPair : deviceMemoryBufferMap)
+    // Only the dispatches that share a resource with an earlier one wait for the dispatches before them, the others
+    // can overlap them
+    if (dependent)
     {
-        auto& deviceMemoryBuffers = deviceMemoryBufferMapPair.second;
-        // For each descriptor binding.
-        for (auto& memoryBuffer : deviceMemoryBuffers)
+        VkMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+        vkCmdPipelineBarrier(batchCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+    if (!copies.empty())
+    {
+        for (auto& [source, destination, copy] : copies)
         {
-            vkFreeMemory(device, memoryBuffer.deviceMemory, nullptr);
-            vkFreeMemory(device, memoryBuffer.hostMemory, nullptr);
-            vkDestroyBuffer(device, memoryBuffer.hostBuffer, nullptr);
-            vkDestroyBuffer(device, memoryBuffer.deviceBuffer, nullptr);
+            vkCmdCopyBuffer(batchCommandBuffer, source, destination, 1, &copy);
         }
+        VkMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(batchCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
     }
-    deviceMemoryBufferMap.clear();
 
+    vkCmdBindPipeline(batchCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineState->pipeline);
+    vkCmdBindDescriptorSets(batchCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineState->pipelineLayout, 0, pipelineState->descriptorSets.size(), pipelineState->descriptorSets.data(), 0, 0);
+    vkCmdDispatch(batchCommandBuffer, numWorkGroups.x, numWorkGroups.y, numWorkGroups.z);
+
+    // The dispatch isn't timed on its own
+    lastRunTimings = {};
+    return success();
+}
+
+LogicalResult VulkanRuntime::submitBatch()
+{
+    auto commandBuffer = batchCommandBuffer;
+    batchCommandBuffer = VK_NULL_HANDLE;
+    auto resources = std::move(batchResources);
+    batchResources.clear();
+    batchPipelineStates.clear();
+
+    // The resources that went through staging buffers are copied back to them after the last dispatch
+    if (!resources.empty())
+    {
+        VkMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_HOST_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+        for (auto& [hostPointer, resource] : resources)
+        {
+            auto& memoryBuffer = *resource.first;
+            if (memoryBuffer.importedHostPointer || memoryBuffer.mappedDeviceMemory)
+                continue;
+            VkBufferCopy copy = { 0, 0, resource.second };
+            vkCmdCopyBuffer(commandBuffer, memoryBuffer.deviceBuffer, memoryBuffer.hostBuffer, 1, &copy);
+        }
+    }
+
+    auto freeCommandBuffer = [&] { vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer); };
+    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+    {
+        freeCommandBuffer();
+        std::cerr << "vkEndCommandBuffer failed";
+        return failure();
+    }
+    if (!resources.empty())
+    {
+        VkSubmitInfo submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &commandBuffer;
+        if (vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS || vkQueueWaitIdle(queue) != VK_SUCCESS)
+        {
+            freeCommandBuffer();
+            std::cerr << "Vulkan batch submission failed";
+            return failure();
+        }
+    }
+    freeCommandBuffer();
+
+    for (auto& [hostPointer, resource] : resources)
+    {
+        auto& memoryBuffer = *resource.first;
+        if (memoryBuffer.importedHostPointer)
+            continue;
+        if (failed(copyHostMemory(memoryBuffer, { hostPointer, resource.second }, /*deviceToHost=*/true)))
+            return failure();
+    }
+    return success();
+}
+
+LogicalResult VulkanRuntime::copyHostMemory(VulkanDeviceMemoryBuffer& memoryBuffer, const VulkanHostMemoryBuffer& hostMemoryBuffer, bool deviceToHost)
+{
+    void* payload = memoryBuffer.mappedDeviceMemory;
+    if (!payload)
+    {
+        RETURN_ON_VULKAN_ERROR(vkMapMemory(device, memoryBuffer.hostMemory, 0, hostMemoryBuffer.size, 0, &payload),
+                               "vkMapMemory");
+    }
+    if (deviceToHost)
+        std::memcpy(hostMemoryBuffer.ptr, payload, hostMemoryBuffer.size);
+    else
+        std::memcpy(payload, hostMemoryBuffer.ptr, hostMemoryBuffer.size);
+    if (!memoryBuffer.mappedDeviceMemory)
+        vkUnmapMemory(device, memoryBuffer.hostMemory);
     return success();
 }
 
@@ -361,7 +699,16 @@ LogicalResult VulkanRuntime::createInstance()
     applicationInfo.applicationVersion = 0;
     applicationInfo.pEngineName = "mlir";
     applicationInfo.engineVersion = 0;
+    // Vulkan 1.1 is needed to import host memory, which is optional
     applicationInfo.apiVersion = VK_MAKE_VERSION(1, 0, 0);
+    auto enumerateInstanceVersion = reinterpret_cast<PFN_vkEnumerateInstanceVersion>(
+        vkGetInstanceProcAddr(VK_NULL_HANDLE, "vkEnumerateInstanceVersion"));
+    uint32_t instanceVersion = VK_MAKE_VERSION(1, 0, 0);
+    if (enumerateInstanceVersion && enumerateInstanceVersion(&instanceVersion) == VK_SUCCESS &&
+        instanceVersion >= VK_MAKE_VERSION(1, 1, 0))
+    {
+        applicationInfo.apiVersion = VK_MAKE_VERSION(1, 1, 0);
+    }
 
     VkInstanceCreateInfo instanceCreateInfo = {};
     instanceCreateInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -417,16 +764,66 @@ LogicalResult VulkanRuntime::createDevice()
     deviceCreateInfo.pQueueCreateInfos = &deviceQueueCreateInfo;
     deviceCreateInfo.enabledLayerCount = 0;
     deviceCreateInfo.ppEnabledLayerNames = nullptr;
-    deviceCreateInfo.enabledExtensionCount = 0;
-    deviceCreateInfo.ppEnabledExtensionNames = nullptr;
+    std::vector<const char*> enabledExtensionNames;
+    if (failed(getHostPointerImportSupport()))
+        return failure();
+    if (hostPointerImportSupported)
+    {
+        enabledExtensionNames.push_back(VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME);
+    }
+
+    // Enable the supported optional features, chained to the device creation info
+    if (failed(getOptionalDeviceFeatures()))
+        return failure();
+    VkPhysicalDeviceFeatures2 features2 = {};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    VkPhysicalDeviceCooperativeMatrixFeaturesNV cooperativeMatrixFeatures = {};
+    cooperativeMatrixFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_COOPERATIVE_MATRIX_FEATURES_NV;
+    VkPhysicalDeviceShaderFloat16Int8FeaturesKHR float16Features = {};
+    float16Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES_KHR;
+    VkPhysicalDevice16BitStorageFeatures storage16BitFeatures = {};
+    storage16BitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES;
+    void** nextFeatures = &features2.pNext;
+    auto chainFeatures = [&nextFeatures](auto& features) {
+        *nextFeatures = &features;
+        nextFeatures = &features.pNext;
+    };
+    if (cooperativeMatrixSupported)
+    {
+        cooperativeMatrixFeatures.cooperativeMatrix = VK_TRUE;
+        chainFeatures(cooperativeMatrixFeatures);
+        enabledExtensionNames.push_back(VK_NV_COOPERATIVE_MATRIX_EXTENSION_NAME);
+    }
+    if (shaderFloat16Supported)
+    {
+        float16Features.shaderFloat16 = VK_TRUE;
+        chainFeatures(float16Features);
+        enabledExtensionNames.push_back(VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME);
+    }
+    if (storageBuffer16BitAccessSupported)
+    {
+        storage16BitFeatures.storageBuffer16BitAccess = VK_TRUE;
+        chainFeatures(storage16BitFeatures);
+    }
+    deviceCreateInfo.pNext = features2.pNext ? &features2 : nullptr;
+
+    deviceCreateInfo.enabledExtensionCount = enabledExtensionNames.size();
+    deviceCreateInfo.ppEnabledExtensionNames = enabledExtensionNames.empty() ? nullptr : enabledExtensionNames.data();
     deviceCreateInfo.pEnabledFeatures = nullptr;
 
     RETURN_ON_VULKAN_ERROR(
         vkCreateDevice(physicalDevice, &deviceCreateInfo, 0, &device),
         "vkCreateDevice");
 
-    VkPhysicalDeviceMemoryProperties properties = {};
-    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &properties);
+    if (hostPointerImportSupported)
+    {
+        getMemoryHostPointerProperties = reinterpret_cast<PFN_vkGetMemoryHostPointerPropertiesEXT>(
+            vkGetDeviceProcAddr(device, "vkGetMemoryHostPointerPropertiesEXT"));
+        hostPointerImportSupported = getMemoryHostPointerProperties != nullptr;
+    }
+
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+    const auto& properties = memoryProperties;
 
     // Try to find memory type with following properties:
     // VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT bit specifies that memory allocated
@@ -464,6 +861,26 @@ LogicalResult VulkanRuntime::createDevice()
         }
     }
 
+    // Integrated GPUs share the host memory, so a device local memory type that
+    // is also host visible lets the host read and write resources in place
+    VkPhysicalDeviceProperties deviceProperties = {};
+    vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+    if (deviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU)
+    {
+        const VkMemoryPropertyFlags unifiedFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                                                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                   VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        for (uint32_t i = 0, e = properties.memoryTypeCount; i < e; ++i)
+        {
+            if ((properties.memoryTypes[i].propertyFlags & unifiedFlags) == unifiedFlags)
+            {
+                deviceMemoryTypeIndex = i;
+                deviceMemoryHostVisible = true;
+                break;
+            }
+        }
+    }
+
     RETURN_ON_VULKAN_ERROR((hostMemoryTypeIndex == VK_MAX_MEMORY_TYPES ||
                             deviceMemoryTypeIndex == VK_MAX_MEMORY_TYPES)
                                ? VK_INCOMPLETE
@@ -472,6 +889,160 @@ LogicalResult VulkanRuntime::createDevice()
     return success();
 }
 
+LogicalResult VulkanRuntime::getHostPointerImportSupport()
+{
+    VkPhysicalDeviceProperties deviceProperties = {};
+    vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+    minStorageBufferOffsetAlignment = deviceProperties.limits.minStorageBufferOffsetAlignment;
+    if (deviceProperties.apiVersion < VK_MAKE_VERSION(1, 1, 0))
+        return success();
+
+    uint32_t extensionCount = 0;
+    RETURN_ON_VULKAN_ERROR(vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr),
+                           "vkEnumerateDeviceExtensionProperties");
+    std::vector<VkExtensionProperties> extensions(extensionCount);
+    RETURN_ON_VULKAN_ERROR(vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, extensions.data()),
+                           "vkEnumerateDeviceExtensionProperties");
+    hostPointerImportSupported = std::any_of(extensions.begin(), extensions.end(), [](const VkExtensionProperties& extension) {
+        return std::strcmp(extension.extensionName, VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME) == 0;
+    });
+    if (!hostPointerImportSupported)
+        return success();
+
+    VkPhysicalDeviceExternalMemoryHostPropertiesEXT hostProperties = {};
+    hostProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT;
+    VkPhysicalDeviceProperties2 properties2 = {};
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties2.pNext = &hostProperties;
+    vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+    minImportedHostPointerAlignment = hostProperties.minImportedHostPointerAlignment;
+    return success();
+}
+
+LogicalResult VulkanRuntime::getOptionalDeviceFeatures()
+{
+    VkPhysicalDeviceProperties deviceProperties = {};
+    vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+    if (deviceProperties.apiVersion < VK_MAKE_VERSION(1, 1, 0))
+        return success();
+
+    uint32_t extensionCount = 0;
+    RETURN_ON_VULKAN_ERROR(vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr),
+                           "vkEnumerateDeviceExtensionProperties");
+    std::vector<VkExtensionProperties> extensions(extensionCount);
+    RETURN_ON_VULKAN_ERROR(vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, extensions.data()),
+                           "vkEnumerateDeviceExtensionProperties");
+    auto hasExtension = [&extensions](const char* name) {
+        return std::any_of(extensions.begin(), extensions.end(), [name](const VkExtensionProperties& extension) {
+            return std::strcmp(extension.extensionName, name) == 0;
+        });
+    };
+
+    // The structures of the extensions that the device lacks are left out of the query and read as unsupported
+    VkPhysicalDevice16BitStorageFeatures storage16BitFeatures = {};
+    storage16BitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES;
+    VkPhysicalDeviceShaderFloat16Int8FeaturesKHR float16Features = {};
+    float16Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES_KHR;
+    VkPhysicalDeviceCooperativeMatrixFeaturesNV cooperativeMatrixFeatures = {};
+    cooperativeMatrixFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_COOPERATIVE_MATRIX_FEATURES_NV;
+    VkPhysicalDeviceFeatures2 features2 = {};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = &storage16BitFeatures;
+    if (hasExtension(VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME))
+    {
+        float16Features.pNext = features2.pNext;
+        features2.pNext = &float16Features;
+    }
+    if (hasExtension(VK_NV_COOPERATIVE_MATRIX_EXTENSION_NAME))
+    {
+        cooperativeMatrixFeatures.pNext = features2.pNext;
+        features2.pNext = &cooperativeMatrixFeatures;
+    }
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+    storageBuffer16BitAccessSupported = storage16BitFeatures.storageBuffer16BitAccess == VK_TRUE;
+    shaderFloat16Supported = float16Features.shaderFloat16 == VK_TRUE;
+    cooperativeMatrixSupported = cooperativeMatrixFeatures.cooperativeMatrix == VK_TRUE;
+
+    // The tensorized kernels use the 16x16x16 cooperative matrices of FP16 elements
+    auto getCooperativeMatrixProperties = reinterpret_cast<PFN_vkGetPhysicalDeviceCooperativeMatrixPropertiesNV>(
+        vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceCooperativeMatrixPropertiesNV"));
+    if (cooperativeMatrixSupported && getCooperativeMatrixProperties)
+    {
+        uint32_t propertyCount = 0;
+        RETURN_ON_VULKAN_ERROR(getCooperativeMatrixProperties(physicalDevice, &propertyCount, nullptr),
+                               "vkGetPhysicalDeviceCooperativeMatrixPropertiesNV");
+        VkCooperativeMatrixPropertiesNV emptyProperties = {};
+        emptyProperties.sType = VK_STRUCTURE_TYPE_COOPERATIVE_MATRIX_PROPERTIES_NV;
+        std::vector<VkCooperativeMatrixPropertiesNV> properties(propertyCount, emptyProperties);
+        RETURN_ON_VULKAN_ERROR(getCooperativeMatrixProperties(physicalDevice, &propertyCount, properties.data()),
+                               "vkGetPhysicalDeviceCooperativeMatrixPropertiesNV");
+        cooperativeMatrixSupported = std::any_of(properties.begin(), properties.end(), [](const VkCooperativeMatrixPropertiesNV& property) {
+            return property.MSize == 16 && property.NSize == 16 && property.KSize == 16 &&
+                   property.AType == VK_COMPONENT_TYPE_FLOAT16_NV && property.scope == VK_SCOPE_SUBGROUP_NV;
+        });
+    }
+    else
+    {
+        cooperativeMatrixSupported = false;
+    }
+
+    VkPhysicalDeviceSubgroupProperties subgroupProperties = {};
+    subgroupProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES;
+    VkPhysicalDeviceProperties2 properties2 = {};
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties2.pNext = &subgroupProperties;
+    vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+    subgroupArithmeticSupported = (subgroupProperties.supportedStages & VK_SHADER_STAGE_COMPUTE_BIT) &&
+                                  (subgroupProperties.supportedOperations & VK_SUBGROUP_FEATURE_ARITHMETIC_BIT);
+    return success();
+}
+
+LogicalResult VulkanRuntime::checkShaderCapabilities()
+{
+    // cf the SPIR-V specification for the numbers of the instructions and capabilities
+    constexpr uint32_t kOpCapability = 17;
+    constexpr uint32_t kCapabilityFloat16 = 9;
+    constexpr uint32_t kCapabilityGroupNonUniformArithmetic = 63;
+    constexpr uint32_t kCapabilityStorageBuffer16BitAccess = 4433;
+    constexpr uint32_t kCapabilityCooperativeMatrixNV = 5357;
+    constexpr uint32_t kHeaderWordCount = 5;
+
+    // The capabilities that the module declares are its first instructions
+    auto words = reinterpret_cast<const uint32_t*>(binary);
+    const uint32_t wordCount = binarySize / sizeof(uint32_t);
+    for (uint32_t i = kHeaderWordCount; i + 1 < wordCount;)
+    {
+        const uint32_t instructionWordCount = words[i] >> 16;
+        if ((words[i] & 0xffff) != kOpCapability || instructionWordCount < 2)
+            break;
+
+        const char* unsupportedCapability = nullptr;
+        switch (words[i + 1])
+        {
+        case kCapabilityFloat16:
+            unsupportedCapability = shaderFloat16Supported ? nullptr : "Float16";
+            break;
+        case kCapabilityGroupNonUniformArithmetic:
+            unsupportedCapability = subgroupArithmeticSupported ? nullptr : "GroupNonUniformArithmetic";
+            break;
+        case kCapabilityStorageBuffer16BitAccess:
+            unsupportedCapability = storageBuffer16BitAccessSupported ? nullptr : "StorageBuffer16BitAccess";
+            break;
+        case kCapabilityCooperativeMatrixNV:
+            unsupportedCapability = cooperativeMatrixSupported ? nullptr : "CooperativeMatrixNV";
+            break;
+        }
+        if (unsupportedCapability)
+        {
+            std::cerr << "the Vulkan device does not support the " << unsupportedCapability
+                      << " capability required by the kernel " << entryPoint;
+            return failure();
+        }
+        i += instructionWordCount;
+    }
+    return success();
+}
+
 LogicalResult VulkanRuntime::getBestComputeQueue()
 {
     uint32_t queueFamilyPropertiesCount = 0;
@@ -569,6 +1140,7 @@ LogicalResult VulkanRuntime::createMemoryBuffers()
 
             // Set descriptor type for the specific device memory buffer.
             memoryBuffer.descriptorType = descriptorType;
+            memoryBuffer.bufferUsage = bufferUsage;
             const auto bufferSize = resourceDataBindingPair.second.size;
             memoryBuffer.bufferSize = bufferSize;
             // Specify memory allocation info.
@@ -576,22 +1148,11 @@ LogicalResult VulkanRuntime::createMemoryBuffers()
             memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
             memoryAllocateInfo.pNext = nullptr;
             memoryAllocateInfo.allocationSize = bufferSize;
-            memoryAllocateInfo.memoryTypeIndex = hostMemoryTypeIndex;
+            memoryAllocateInfo.memoryTypeIndex = deviceMemoryTypeIndex;
 
             // Allocate device memory.
-            RETURN_ON_VULKAN_ERROR(vkAllocateMemory(device, &memoryAllocateInfo, 0, &memoryBuffer.hostMemory),
-                                   "vkAllocateMemory");
-            memoryAllocateInfo.memoryTypeIndex = deviceMemoryTypeIndex;
             RETURN_ON_VULKAN_ERROR(vkAllocateMemory(device, &memoryAllocateInfo, 0, &memoryBuffer.deviceMemory),
                                    "vkAllocateMemory");
-            void* payload;
-            RETURN_ON_VULKAN_ERROR(vkMapMemory(device, memoryBuffer.hostMemory, 0, bufferSize, 0, reinterpret_cast<void**>(&payload)),
-                                   "vkMapMemory");
-
-            // Copy host memory into the mapped area.
-            std::memcpy(payload, resourceDataBindingPair.second.ptr, bufferSize);
-            vkUnmapMemory(device, memoryBuffer.hostMemory);
-
             VkBufferCreateInfo bufferCreateInfo = {};
             bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
             bufferCreateInfo.pNext = nullptr;
@@ -602,14 +1163,29 @@ LogicalResult VulkanRuntime::createMemoryBuffers()
             bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
             bufferCreateInfo.queueFamilyIndexCount = 1;
             bufferCreateInfo.pQueueFamilyIndices = &queueFamilyIndex;
-            RETURN_ON_VULKAN_ERROR(vkCreateBuffer(device, &bufferCreateInfo, 0, &memoryBuffer.hostBuffer),
-                                   "vkCreateBuffer");
             RETURN_ON_VULKAN_ERROR(vkCreateBuffer(device, &bufferCreateInfo, 0, &memoryBuffer.deviceBuffer),
                                    "vkCreateBuffer");
 
+            if (deviceMemoryHostVisible)
+            {
+                // The host reads and writes the device memory directly, which
+                // stays mapped for the lifetime of the buffer
+                RETURN_ON_VULKAN_ERROR(vkMapMemory(device, memoryBuffer.deviceMemory, 0, bufferSize, 0, &memoryBuffer.mappedDeviceMemory),
+                                       "vkMapMemory");
+            }
+            else
+            {
+                // Staging buffer to copy the resource through
+                memoryAllocateInfo.memoryTypeIndex = hostMemoryTypeIndex;
+                RETURN_ON_VULKAN_ERROR(vkAllocateMemory(device, &memoryAllocateInfo, 0, &memoryBuffer.hostMemory),
+                                       "vkAllocateMemory");
+                RETURN_ON_VULKAN_ERROR(vkCreateBuffer(device, &bufferCreateInfo, 0, &memoryBuffer.hostBuffer),
+                                       "vkCreateBuffer");
+                RETURN_ON_VULKAN_ERROR(vkBindBufferMemory(device, memoryBuffer.hostBuffer, memoryBuffer.hostMemory, 0),
+                                       "vkBindBufferMemory");
+            }
+
             // Bind buffer and device memory.
-            RETURN_ON_VULKAN_ERROR(vkBindBufferMemory(device, memoryBuffer.hostBuffer, memoryBuffer.hostMemory, 0),
-                                   "vkBindBufferMemory");
             RETURN_ON_VULKAN_ERROR(vkBindBufferMemory(device,
                                                       memoryBuffer.deviceBuffer,
                                                       memoryBuffer.deviceMemory,
@@ -624,12 +1200,43 @@ LogicalResult VulkanRuntime::createMemoryBuffers()
         }
 
         // Associate device memory buffers with a descriptor set.
-        deviceMemoryBufferMap[descriptorSetIndex] = deviceMemoryBuffers;
+        pipelineState->deviceMemoryBufferMap[descriptorSetIndex] = deviceMemoryBuffers;
     }
     return success();
 }
 
 LogicalResult VulkanRuntime::copyResource(bool deviceToHost)
+{
+    // Only the resources that go through staging buffers need to be copied
+    auto isStaged = [](const VulkanDeviceMemoryBuffer& memBuffer) {
+        return memBuffer.hostBuffer != VK_NULL_HANDLE && memBuffer.importedHostPointer == nullptr;
+    };
+    if (std::none_of(pipelineState->deviceMemoryBufferMap.begin(), pipelineState->deviceMemoryBufferMap.end(), [&](const auto& deviceMemoryBufferMapPair) {
+            return std::any_of(deviceMemoryBufferMapPair.second.begin(), deviceMemoryBufferMapPair.second.end(), isStaged);
+        }))
+    {
+        return success();
+    }
+
+    return submitOneTimeCommands([&](VkCommandBuffer commandBuffer) {
+        for (const auto& deviceMemoryBufferMapPair : pipelineState->deviceMemoryBufferMap)
+        {
+            const auto& deviceMemoryBuffers = deviceMemoryBufferMapPair.second;
+            for (const auto& memBuffer : deviceMemoryBuffers)
+            {
+                if (!isStaged(memBuffer))
+                    continue;
+                VkBufferCopy copy = { 0, 0, memBuffer.bufferSize };
+                if (deviceToHost)
+                    vkCmdCopyBuffer(commandBuffer, memBuffer.deviceBuffer, memBuffer.hostBuffer, 1, &copy);
+                else
+                    vkCmdCopyBuffer(commandBuffer, memBuffer.hostBuffer, memBuffer.deviceBuffer, 1, &copy);
+            }
+        }
+    });
+}
+
+LogicalResult VulkanRuntime::submitOneTimeCommands(const std::function<void(VkCommandBuffer)>& recordCommands)
 {
     VkCommandBufferAllocateInfo commandBufferAllocateInfo = {
         VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
@@ -647,26 +1254,14 @@ LogicalResult VulkanRuntime::copyResource(bool deviceToHost)
     VkCommandBufferBeginInfo commandBufferBeginInfo = {
         VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
         NULL,
-        0,
+        VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
         NULL,
     };
     RETURN_ON_VULKAN_ERROR(
         vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo),
         "vkBeginCommandBuffer");
 
-    for (const auto& deviceMemoryBufferMapPair : deviceMemoryBufferMap)
-    {
-        std::vector<VkDescriptorSetLayoutBinding> descriptorSetLayoutBindings;
-        const auto& deviceMemoryBuffers = deviceMemoryBufferMapPair.second;
-        for (const auto& memBuffer : deviceMemoryBuffers)
-        {
-            VkBufferCopy copy = { 0, 0, memBuffer.bufferSize };
-            if (deviceToHost)
-                vkCmdCopyBuffer(commandBuffer, memBuffer.deviceBuffer, memBuffer.hostBuffer, 1, &copy);
-            else
-                vkCmdCopyBuffer(commandBuffer, memBuffer.hostBuffer, memBuffer.deviceBuffer, 1, &copy);
-        }
-    }
+    recordCommands(commandBuffer);
 
     RETURN_ON_VULKAN_ERROR(vkEndCommandBuffer(commandBuffer),
                            "vkEndCommandBuffer");
@@ -681,7 +1276,6 @@ LogicalResult VulkanRuntime::copyResource(bool deviceToHost)
         0,
         NULL,
     };
-    submitInfo.pCommandBuffers = &commandBuffer;
     RETURN_ON_VULKAN_ERROR(vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE),
                            "vkQueueSubmit");
     RETURN_ON_VULKAN_ERROR(vkQueueWaitIdle(queue), "vkQueueWaitIdle");
@@ -690,8 +1284,123 @@ LogicalResult VulkanRuntime::copyResource(bool deviceToHost)
     return success();
 }
 
+LogicalResult VulkanRuntime::createResidentBuffer(VkDeviceSize size, void*& hostPointer)
+{
+    hostPointer = nullptr;
+    VulkanResidentBuffer residentBuffer;
+    residentBuffer.size = size;
+
+    VkBufferCreateInfo bufferCreateInfo = {};
+    bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferCreateInfo.size = size;
+    bufferCreateInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                             VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    bufferCreateInfo.queueFamilyIndexCount = 1;
+    bufferCreateInfo.pQueueFamilyIndices = &queueFamilyIndex;
+
+    VkMemoryAllocateInfo memoryAllocateInfo = {};
+    memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    memoryAllocateInfo.allocationSize = size;
+    memoryAllocateInfo.memoryTypeIndex = deviceMemoryTypeIndex;
+
+    auto result = vkAllocateMemory(device, &memoryAllocateInfo, 0, &residentBuffer.deviceMemory);
+    if (result == VK_SUCCESS)
+        result = vkCreateBuffer(device, &bufferCreateInfo, 0, &residentBuffer.deviceBuffer);
+    if (result == VK_SUCCESS)
+        result = vkBindBufferMemory(device, residentBuffer.deviceBuffer, residentBuffer.deviceMemory, 0);
+    if (result == VK_SUCCESS)
+    {
+        if (deviceMemoryHostVisible)
+        {
+            result = vkMapMemory(device, residentBuffer.deviceMemory, 0, size, 0, &residentBuffer.hostPointer);
+        }
+        else
+        {
+            memoryAllocateInfo.memoryTypeIndex = hostMemoryTypeIndex;
+            result = vkAllocateMemory(device, &memoryAllocateInfo, 0, &residentBuffer.stagingMemory);
+            if (result == VK_SUCCESS)
+                result = vkCreateBuffer(device, &bufferCreateInfo, 0, &residentBuffer.stagingBuffer);
+            if (result == VK_SUCCESS)
+                result = vkBindBufferMemory(device, residentBuffer.stagingBuffer, residentBuffer.stagingMemory, 0);
+            if (result == VK_SUCCESS)
+                result = vkMapMemory(device, residentBuffer.stagingMemory, 0, size, 0, &residentBuffer.hostPointer);
+        }
+    }
+    if (result != VK_SUCCESS)
+    {
+        releaseResidentBuffer(residentBuffer);
+        emitVulkanError("createResidentBuffer", result);
+        return failure();
+    }
+
+    hostPointer = residentBuffer.hostPointer;
+    residentBuffers[hostPointer] = residentBuffer;
+    return success();
+}
+
+LogicalResult VulkanRuntime::copyResidentBuffer(void* hostPointer, bool deviceToHost)
+{
+    auto it = residentBuffers.find(hostPointer);
+    if (it == residentBuffers.end())
+    {
+        std::cerr << "not a resident buffer";
+        return failure();
+    }
+    const auto& residentBuffer = it->second;
+    if (residentBuffer.stagingBuffer == VK_NULL_HANDLE)
+        return success();
+
+    return submitOneTimeCommands([&](VkCommandBuffer commandBuffer) {
+        VkBufferCopy copy = { 0, 0, residentBuffer.size };
+        if (deviceToHost)
+            vkCmdCopyBuffer(commandBuffer, residentBuffer.deviceBuffer, residentBuffer.stagingBuffer, 1, &copy);
+        else
+            vkCmdCopyBuffer(commandBuffer, residentBuffer.stagingBuffer, residentBuffer.deviceBuffer, 1, &copy);
+    });
+}
+
+void VulkanRuntime::destroyResidentBuffer(void* hostPointer)
+{
+    auto it = residentBuffers.find(hostPointer);
+    if (it == residentBuffers.end())
+        return;
+
+    // The pipeline states that bind the buffer go back to their own device buffers, and re-write their
+    // descriptors on their next run
+    for (auto& [key, state] : pipelineStates)
+    {
+        for (auto& [descriptorSetIndex, deviceMemoryBuffers] : state->deviceMemoryBufferMap)
+        {
+            for (auto& deviceMemoryBuffer : deviceMemoryBuffers)
+            {
+                if (deviceMemoryBuffer.importedHostPointer == hostPointer)
+                {
+                    releaseImportedMemoryBuffer(deviceMemoryBuffer);
+                    state->bindingsChanged = true;
+                }
+            }
+        }
+    }
+
+    releaseResidentBuffer(it->second);
+    residentBuffers.erase(it);
+}
+
+void VulkanRuntime::releaseResidentBuffer(VulkanResidentBuffer& residentBuffer)
+{
+    vkDestroyBuffer(device, residentBuffer.deviceBuffer, nullptr);
+    vkFreeMemory(device, residentBuffer.deviceMemory, nullptr);
+    vkDestroyBuffer(device, residentBuffer.stagingBuffer, nullptr);
+    vkFreeMemory(device, residentBuffer.stagingMemory, nullptr);
+    residentBuffer = {};
+}
+
 LogicalResult VulkanRuntime::createShaderModule()
 {
+    if (failed(checkShaderCapabilities()))
+        return failure();
+
     VkShaderModuleCreateInfo shaderModuleCreateInfo = {};
     shaderModuleCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
     shaderModuleCreateInfo.pNext = nullptr;
@@ -701,14 +1410,14 @@ LogicalResult VulkanRuntime::createShaderModule()
     // Set pointer to the binary shader.
     shaderModuleCreateInfo.pCode = reinterpret_cast<uint32_t*>(binary);
     RETURN_ON_VULKAN_ERROR(
-        vkCreateShaderModule(device, &shaderModuleCreateInfo, 0, &shaderModule),
+        vkCreateShaderModule(device, &shaderModuleCreateInfo, 0, &pipelineState->shaderModule),
         "vkCreateShaderModule");
     return success();
 }
 
 void VulkanRuntime::initDescriptorSetLayoutBindingMap()
 {
-    for (const auto& deviceMemoryBufferMapPair : deviceMemoryBufferMap)
+    for (const auto& deviceMemoryBufferMapPair : pipelineState->deviceMemoryBufferMap)
     {
         std::vector<VkDescriptorSetLayoutBinding> descriptorSetLayoutBindings;
         const auto& deviceMemoryBuffers = deviceMemoryBufferMapPair.second;
@@ -725,14 +1434,14 @@ void VulkanRuntime::initDescriptorSetLayoutBindingMap()
             descriptorSetLayoutBinding.pImmutableSamplers = 0;
             descriptorSetLayoutBindings.push_back(descriptorSetLayoutBinding);
         }
-        descriptorSetLayoutBindingMap[descriptorSetIndex] =
+        pipelineState->descriptorSetLayoutBindingMap[descriptorSetIndex] =
             descriptorSetLayoutBindings;
     }
 }
 
 LogicalResult VulkanRuntime::createDescriptorSetLayout()
 {
-    for (const auto& deviceMemoryBufferMapPair : deviceMemoryBufferMap)
+    for (const auto& deviceMemoryBufferMapPair : pipelineState->deviceMemoryBufferMap)
     {
         const auto descriptorSetIndex = deviceMemoryBufferMapPair.first;
         const auto& deviceMemoryBuffers = deviceMemoryBufferMapPair.second;
@@ -741,9 +1450,9 @@ LogicalResult VulkanRuntime::createDescriptorSetLayout()
             deviceMemoryBuffers.front().descriptorType;
         const uint32_t descriptorSize = deviceMemoryBuffers.size();
         const auto descriptorSetLayoutBindingIt =
-            descriptorSetLayoutBindingMap.find(descriptorSetIndex);
+            pipelineState->descriptorSetLayoutBindingMap.find(descriptorSetIndex);
 
-        if (descriptorSetLayoutBindingIt == descriptorSetLayoutBindingMap.end())
+        if (descriptorSetLayoutBindingIt == pipelineState->descriptorSetLayoutBindingMap.end())
         {
             std::cerr << "cannot find layout bindings for the set with number: "
                       << descriptorSetIndex;
@@ -769,8 +1478,8 @@ LogicalResult VulkanRuntime::createDescriptorSetLayout()
             vkCreateDescriptorSetLayout(device, &descriptorSetLayoutCreateInfo, 0, &descriptorSetLayout),
             "vkCreateDescriptorSetLayout");
 
-        descriptorSetLayouts.push_back(descriptorSetLayout);
-        descriptorSetInfoPool.push_back(
+        pipelineState->descriptorSetLayouts.push_back(descriptorSetLayout);
+        pipelineState->descriptorSetInfoPool.push_back(
             { descriptorSetIndex, descriptorSize, descriptorType });
     }
     return success();
@@ -784,14 +1493,14 @@ LogicalResult VulkanRuntime::createPipelineLayout()
         VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
     pipelineLayoutCreateInfo.pNext = nullptr;
     pipelineLayoutCreateInfo.flags = 0;
-    pipelineLayoutCreateInfo.setLayoutCount = descriptorSetLayouts.size();
-    pipelineLayoutCreateInfo.pSetLayouts = descriptorSetLayouts.data();
+    pipelineLayoutCreateInfo.setLayoutCount = pipelineState->descriptorSetLayouts.size();
+    pipelineLayoutCreateInfo.pSetLayouts = pipelineState->descriptorSetLayouts.data();
     pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
     pipelineLayoutCreateInfo.pPushConstantRanges = 0;
     RETURN_ON_VULKAN_ERROR(vkCreatePipelineLayout(device,
                                                   &pipelineLayoutCreateInfo,
                                                   0,
-                                                  &pipelineLayout),
+                                                  &pipelineState->pipelineLayout),
                            "vkCreatePipelineLayout");
     return success();
 }
@@ -803,7 +1512,7 @@ LogicalResult VulkanRuntime::createComputePipeline()
     stageInfo.pNext = nullptr;
     stageInfo.flags = 0;
     stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
-    stageInfo.module = shaderModule;
+    stageInfo.module = pipelineState->shaderModule;
     // Set entry point.
     stageInfo.pName = entryPoint;
     stageInfo.pSpecializationInfo = 0;
@@ -814,10 +1523,10 @@ LogicalResult VulkanRuntime::createComputePipeline()
     computePipelineCreateInfo.pNext = nullptr;
     computePipelineCreateInfo.flags = 0;
     computePipelineCreateInfo.stage = stageInfo;
-    computePipelineCreateInfo.layout = pipelineLayout;
+    computePipelineCreateInfo.layout = pipelineState->pipelineLayout;
     computePipelineCreateInfo.basePipelineHandle = 0;
     computePipelineCreateInfo.basePipelineIndex = 0;
-    RETURN_ON_VULKAN_ERROR(vkCreateComputePipelines(device, 0, 1, &computePipelineCreateInfo, 0, &pipeline),
+    RETURN_ON_VULKAN_ERROR(vkCreateComputePipelines(device, pipelineCache, 1, &computePipelineCreateInfo, 0, &pipelineState->pipeline),
                            "vkCreateComputePipelines");
     return success();
 }
@@ -825,7 +1534,7 @@ LogicalResult VulkanRuntime::createComputePipeline()
 LogicalResult VulkanRuntime::createDescriptorPool()
 {
     std::vector<VkDescriptorPoolSize> descriptorPoolSizes;
-    for (const auto& descriptorSetInfo : descriptorSetInfoPool)
+    for (const auto& descriptorSetInfo : pipelineState->descriptorSetInfoPool)
     {
         // For each descriptor set populate descriptor pool size.
         VkDescriptorPoolSize descriptorPoolSize = {};
@@ -845,7 +1554,7 @@ LogicalResult VulkanRuntime::createDescriptorPool()
     RETURN_ON_VULKAN_ERROR(vkCreateDescriptorPool(device,
                                                   &descriptorPoolCreateInfo,
                                                   0,
-                                                  &descriptorPool),
+                                                  &pipelineState->descriptorPool),
                            "vkCreateDescriptorPool");
     return success();
 }
@@ -854,35 +1563,35 @@ LogicalResult VulkanRuntime::allocateDescriptorSets()
 {
     VkDescriptorSetAllocateInfo descriptorSetAllocateInfo = {};
     // Size of descriptor sets and descriptor layout sets is the same.
-    descriptorSets.resize(descriptorSetLayouts.size());
+    pipelineState->descriptorSets.resize(pipelineState->descriptorSetLayouts.size());
     descriptorSetAllocateInfo.sType =
         VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
     descriptorSetAllocateInfo.pNext = nullptr;
-    descriptorSetAllocateInfo.descriptorPool = descriptorPool;
-    descriptorSetAllocateInfo.descriptorSetCount = descriptorSetLayouts.size();
-    descriptorSetAllocateInfo.pSetLayouts = descriptorSetLayouts.data();
+    descriptorSetAllocateInfo.descriptorPool = pipelineState->descriptorPool;
+    descriptorSetAllocateInfo.descriptorSetCount = pipelineState->descriptorSetLayouts.size();
+    descriptorSetAllocateInfo.pSetLayouts = pipelineState->descriptorSetLayouts.data();
     RETURN_ON_VULKAN_ERROR(vkAllocateDescriptorSets(device,
                                                     &descriptorSetAllocateInfo,
-                                                    descriptorSets.data()),
+                                                    pipelineState->descriptorSets.data()),
                            "vkAllocateDescriptorSets");
     return success();
 }
 
 LogicalResult VulkanRuntime::setWriteDescriptors()
 {
-    if (descriptorSets.size() != descriptorSetInfoPool.size())
+    if (pipelineState->descriptorSets.size() != pipelineState->descriptorSetInfoPool.size())
     {
         std::cerr << "Each descriptor set must have descriptor set information";
         return failure();
     }
     // For each descriptor set.
-    auto descriptorSetIt = descriptorSets.begin();
+    auto descriptorSetIt = pipelineState->descriptorSets.begin();
     // Each descriptor set is associated with descriptor set info.
-    for (const auto& descriptorSetInfo : descriptorSetInfoPool)
+    for (const auto& descriptorSetInfo : pipelineState->descriptorSetInfoPool)
     {
         // For each device memory buffer in the descriptor set.
         const auto& deviceMemoryBuffers =
-            deviceMemoryBufferMap[descriptorSetInfo.descriptorSet];
+            pipelineState->deviceMemoryBufferMap[descriptorSetInfo.descriptorSet];
         for (const auto& memoryBuffer : deviceMemoryBuffers)
         {
             // Structure describing descriptor sets to write to.
@@ -966,7 +1675,8 @@ LogicalResult VulkanRuntime::createComputeCommandBuffer()
     VkCommandBufferBeginInfo commandBufferBeginInfo = {};
     commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
     commandBufferBeginInfo.pNext = nullptr;
-    commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    // The command buffer is submitted again by every run that uses this pipeline state
+    commandBufferBeginInfo.flags = 0;
     commandBufferBeginInfo.pInheritanceInfo = nullptr;
 
     // Commands begin.
@@ -977,8 +1687,8 @@ LogicalResult VulkanRuntime::createComputeCommandBuffer()
     if (queryPool != VK_NULL_HANDLE)
         vkCmdResetQueryPool(commandBuffer, queryPool, 0, 2);
 
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
-    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, descriptorSets.size(), descriptorSets.data(), 0, 0);
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineState->pipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineState->pipelineLayout, 0, pipelineState->descriptorSets.size(), pipelineState->descriptorSets.data(), 0, 0);
     // Get a timestamp before invoking the compute shader.
     if (queryPool != VK_NULL_HANDLE)
         vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, 0);
@@ -991,7 +1701,7 @@ LogicalResult VulkanRuntime::createComputeCommandBuffer()
     RETURN_ON_VULKAN_ERROR(vkEndCommandBuffer(commandBuffer),
                            "vkEndCommandBuffer");
 
-    commandBuffers.push_back(commandBuffer);
+    pipelineState->commandBuffers.push_back(commandBuffer);
     return success();
 }
 
@@ -1003,8 +1713,8 @@ LogicalResult VulkanRuntime::submitCommandBuffersToQueue()
     submitInfo.waitSemaphoreCount = 0;
     submitInfo.pWaitSemaphores = 0;
     submitInfo.pWaitDstStageMask = 0;
-    submitInfo.commandBufferCount = commandBuffers.size();
-    submitInfo.pCommandBuffers = commandBuffers.data();
+    submitInfo.commandBufferCount = pipelineState->commandBuffers.size();
+    submitInfo.pCommandBuffers = pipelineState->commandBuffers.data();
     submitInfo.signalSemaphoreCount = 0;
     submitInfo.pSignalSemaphores = nullptr;
     RETURN_ON_VULKAN_ERROR(vkQueueSubmit(queue, 1, &submitInfo, 0),
@@ -1012,6 +1722,197 @@ LogicalResult VulkanRuntime::submitCommandBuffersToQueue()
     return success();
 }
 
+LogicalResult VulkanRuntime::updateStagingMemoryBuffers()
+{
+    // For each descriptor set.
+    for (auto& resourceDataMapPair : resourceData)
+    {
+        auto& resourceDataMap = resourceDataMapPair.second;
+        auto& deviceMemoryBuffers =
+            pipelineState->deviceMemoryBufferMap[resourceDataMapPair.first];
+        // For each device memory buffer in the set.
+        for (auto& deviceMemoryBuffer : deviceMemoryBuffers)
+        {
+            if (resourceDataMap.count(deviceMemoryBuffer.bindingIndex) && !deviceMemoryBuffer.importedHostPointer)
+            {
+                auto& hostMemoryBuffer =
+                    resourceDataMap[deviceMemoryBuffer.bindingIndex];
+                if (deviceMemoryBuffer.mappedDeviceMemory)
+                {
+                    std::memcpy(deviceMemoryBuffer.mappedDeviceMemory, hostMemoryBuffer.ptr, hostMemoryBuffer.size);
+                    continue;
+                }
+
+                void* payload;
+                RETURN_ON_VULKAN_ERROR(vkMapMemory(device,
+                                                   deviceMemoryBuffer.hostMemory,
+                                                   0,
+                                                   hostMemoryBuffer.size,
+                                                   0,
+                                                   reinterpret_cast<void**>(&payload)),
+                                       "vkMapMemory");
+                // Copy host memory into the mapped area.
+                std::memcpy(payload, hostMemoryBuffer.ptr, hostMemoryBuffer.size);
+                vkUnmapMemory(device, deviceMemoryBuffer.hostMemory);
+            }
+        }
+    }
+    return success();
+}
+
+LogicalResult VulkanRuntime::importHostMemoryBuffers()
+{
+    bool bindingsChanged = pipelineState->bindingsChanged;
+    pipelineState->bindingsChanged = false;
+    // For each descriptor set.
+    for (auto& resourceDataMapPair : resourceData)
+    {
+        auto& resourceDataMap = resourceDataMapPair.second;
+        auto& deviceMemoryBuffers =
+            pipelineState->deviceMemoryBufferMap[resourceDataMapPair.first];
+        // For each device memory buffer in the set.
+        for (auto& deviceMemoryBuffer : deviceMemoryBuffers)
+        {
+            auto hostMemoryBufferIt = resourceDataMap.find(deviceMemoryBuffer.bindingIndex);
+            if (hostMemoryBufferIt == resourceDataMap.end() ||
+                hostMemoryBufferIt->second.ptr == deviceMemoryBuffer.importedHostPointer)
+            {
+                continue;
+            }
+
+            bool wasImported = deviceMemoryBuffer.importedHostPointer != nullptr;
+            bool imported = false;
+            if (auto residentBufferIt = residentBuffers.find(hostMemoryBufferIt->second.ptr);
+                residentBufferIt != residentBuffers.end() && residentBufferIt->second.size >= hostMemoryBufferIt->second.size)
+            {
+                // The resource already lives on the device
+                releaseImportedMemoryBuffer(deviceMemoryBuffer);
+                deviceMemoryBuffer.importedHostPointer = hostMemoryBufferIt->second.ptr;
+                deviceMemoryBuffer.bufferInfo.buffer = residentBufferIt->second.deviceBuffer;
+                deviceMemoryBuffer.bufferInfo.range = hostMemoryBufferIt->second.size;
+                imported = true;
+            }
+            else if (hostPointerImportSupported)
+            {
+                if (failed(importHostMemoryBuffer(deviceMemoryBuffer, hostMemoryBufferIt->second, imported)))
+                    return failure();
+            }
+            else if (wasImported)
+            {
+                releaseImportedMemoryBuffer(deviceMemoryBuffer);
+            }
+            bindingsChanged |= imported || wasImported;
+        }
+    }
+
+    if (bindingsChanged)
+    {
+        // The descriptor sets are re-written with the new buffers, which invalidates the recorded command buffers
+        vkFreeCommandBuffers(device, commandPool, pipelineState->commandBuffers.size(), pipelineState->commandBuffers.data());
+        pipelineState->commandBuffers.clear();
+        if (failed(setWriteDescriptors()) || failed(createComputeCommandBuffer()))
+            return failure();
+    }
+    return success();
+}
+
+LogicalResult VulkanRuntime::importHostMemoryBuffer(VulkanDeviceMemoryBuffer& memoryBuffer, const VulkanHostMemoryBuffer& hostMemoryBuffer, bool& imported)
+{
+    releaseImportedMemoryBuffer(memoryBuffer);
+    imported = false;
+
+    // The imported range must start and end on the import alignment (typically
+    // a page), and the resource is then bound at its offset in the range
+    auto address = reinterpret_cast<uintptr_t>(hostMemoryBuffer.ptr);
+    auto alignment = static_cast<uintptr_t>(minImportedHostPointerAlignment);
+    auto rangeStart = address / alignment * alignment;
+    auto offset = static_cast<VkDeviceSize>(address - rangeStart);
+    auto rangeSize = static_cast<VkDeviceSize>((address + hostMemoryBuffer.size + alignment - 1) / alignment * alignment - rangeStart);
+    if (offset % minStorageBufferOffsetAlignment != 0)
+    {
+        return success();
+    }
+
+    auto rangePointer = reinterpret_cast<void*>(rangeStart);
+    VkMemoryHostPointerPropertiesEXT hostPointerProperties = {};
+    hostPointerProperties.sType = VK_STRUCTURE_TYPE_MEMORY_HOST_POINTER_PROPERTIES_EXT;
+    if (getMemoryHostPointerProperties(device, VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT, rangePointer, &hostPointerProperties) != VK_SUCCESS)
+    {
+        return success();
+    }
+
+    // The host reads the resource back without invalidating caches, so the memory must be coherent
+    uint32_t memoryTypeIndex = VK_MAX_MEMORY_TYPES;
+    for (uint32_t i = 0, e = memoryProperties.memoryTypeCount; i < e; ++i)
+    {
+        if ((hostPointerProperties.memoryTypeBits & (1u << i)) &&
+            (memoryProperties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+        {
+            memoryTypeIndex = i;
+            break;
+        }
+    }
+    if (memoryTypeIndex == VK_MAX_MEMORY_TYPES)
+    {
+        return success();
+    }
+
+    VkExternalMemoryBufferCreateInfo externalMemoryBufferCreateInfo = {};
+    externalMemoryBufferCreateInfo.sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO;
+    externalMemoryBufferCreateInfo.handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+
+    VkBufferCreateInfo bufferCreateInfo = {};
+    bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferCreateInfo.pNext = &externalMemoryBufferCreateInfo;
+    bufferCreateInfo.flags = 0;
+    bufferCreateInfo.size = rangeSize;
+    bufferCreateInfo.usage = memoryBuffer.bufferUsage;
+    bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    bufferCreateInfo.queueFamilyIndexCount = 1;
+    bufferCreateInfo.pQueueFamilyIndices = &queueFamilyIndex;
+    RETURN_ON_VULKAN_ERROR(vkCreateBuffer(device, &bufferCreateInfo, 0, &memoryBuffer.importedBuffer),
+                           "vkCreateBuffer");
+
+    VkImportMemoryHostPointerInfoEXT importInfo = {};
+    importInfo.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT;
+    importInfo.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+    importInfo.pHostPointer = rangePointer;
+
+    VkMemoryAllocateInfo memoryAllocateInfo = {};
+    memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    memoryAllocateInfo.pNext = &importInfo;
+    memoryAllocateInfo.allocationSize = rangeSize;
+    memoryAllocateInfo.memoryTypeIndex = memoryTypeIndex;
+    if (vkAllocateMemory(device, &memoryAllocateInfo, 0, &memoryBuffer.importedMemory) != VK_SUCCESS)
+    {
+        // Fall back to copying the resource
+        releaseImportedMemoryBuffer(memoryBuffer);
+        return success();
+    }
+    RETURN_ON_VULKAN_ERROR(vkBindBufferMemory(device, memoryBuffer.importedBuffer, memoryBuffer.importedMemory, 0),
+                           "vkBindBufferMemory");
+
+    memoryBuffer.importedHostPointer = hostMemoryBuffer.ptr;
+    memoryBuffer.bufferInfo.buffer = memoryBuffer.importedBuffer;
+    memoryBuffer.bufferInfo.offset = offset;
+    memoryBuffer.bufferInfo.range = hostMemoryBuffer.size;
+    imported = true;
+    return success();
+}
+
+void VulkanRuntime::releaseImportedMemoryBuffer(VulkanDeviceMemoryBuffer& memoryBuffer)
+{
+    vkDestroyBuffer(device, memoryBuffer.importedBuffer, nullptr);
+    memoryBuffer.importedBuffer = VK_NULL_HANDLE;
+    vkFreeMemory(device, memoryBuffer.importedMemory, nullptr);
+    memoryBuffer.importedMemory = VK_NULL_HANDLE;
+    memoryBuffer.importedHostPointer = nullptr;
+
+    memoryBuffer.bufferInfo.buffer = memoryBuffer.deviceBuffer;
+    memoryBuffer.bufferInfo.offset = 0;
+    memoryBuffer.bufferInfo.range = VK_WHOLE_SIZE;
+}
+
 LogicalResult VulkanRuntime::updateHostMemoryBuffers()
 {
     // First copy back the data to the staging buffer.
@@ -1022,15 +1923,21 @@ LogicalResult VulkanRuntime::updateHostMemoryBuffers()
     {
         auto& resourceDataMap = resourceDataMapPair.second;
         auto& deviceMemoryBuffers =
-            deviceMemoryBufferMap[resourceDataMapPair.first];
+            pipelineState->deviceMemoryBufferMap[resourceDataMapPair.first];
         // For each device memory buffer in the set.
         for (auto& deviceMemoryBuffer : deviceMemoryBuffers)
         {
-            if (resourceDataMap.count(deviceMemoryBuffer.bindingIndex))
+            if (resourceDataMap.count(deviceMemoryBuffer.bindingIndex) && !deviceMemoryBuffer.importedHostPointer)
             {
-                void* payload;
                 auto& hostMemoryBuffer =
                     resourceDataMap[deviceMemoryBuffer.bindingIndex];
+                if (deviceMemoryBuffer.mappedDeviceMemory)
+                {
+                    std::memcpy(hostMemoryBuffer.ptr, deviceMemoryBuffer.mappedDeviceMemory, hostMemoryBuffer.size);
+                    continue;
+                }
+
+                void* payload;
                 RETURN_ON_VULKAN_ERROR(vkMapMemory(device,
                                                    deviceMemoryBuffer.hostMemory,
                                                    0,
@@ -18,9 +18,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <numeric>
+#include <string>
 
 #include "VulkanRuntime.h"
 
@@ -35,9 +40,103 @@
 namespace
 {
 
+/// Timings of the dispatches of each kernel, accumulated across the modules of the process so that the host
+/// can query them
+class DispatchTimingRecords
+{
+public:
+    static DispatchTimingRecords& get()
+    {
+        static DispatchTimingRecords records;
+        return records;
+    }
+
+    void record(const std::string& kernel, const VulkanDispatchTimings& timings)
+    {
+        if (timings.count == 0)
+            return;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& entry = records[kernel];
+        entry.minShaderTime = entry.count == 0 ? timings.minShaderTime : std::min(entry.minShaderTime, timings.minShaderTime);
+        entry.maxShaderTime = std::max(entry.maxShaderTime, timings.maxShaderTime);
+        entry.count += timings.count;
+        entry.totalShaderTime += timings.totalShaderTime;
+        entry.totalSubmitTime += timings.totalSubmitTime;
+        entry.totalIdleTime += timings.totalIdleTime;
+    }
+
+    bool lookup(const std::string& kernel, VulkanDispatchTimings& timings)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = records.find(kernel);
+        if (it == records.end())
+            return false;
+        timings = it->second;
+        return true;
+    }
+
+    bool write(const char* path)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::ofstream file(path);
+        if (!file)
+            return false;
+        file << "kernel,count,total_shader_us,min_shader_us,max_shader_us,total_submit_us,total_idle_us\n";
+        for (const auto& [kernel, timings] : records)
+        {
+            file << kernel << "," << timings.count << "," << timings.totalShaderTime << "," << timings.minShaderTime << ","
+                 << timings.maxShaderTime << "," << timings.totalSubmitTime << "," << timings.totalIdleTime << "\n";
+        }
+        return static_cast<bool>(file);
+    }
+
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        records.clear();
+    }
+
+private:
+    std::map<std::string, VulkanDispatchTimings> records;
+    std::mutex mutex;
+};
+
+/// The Vulkan runtime of the process, shared by the modules that use it so that their kernels run on the same device
+/// and can bind the same resident buffers
 class VulkanRuntimeManager
 {
 public:
+    /// Returns the runtime manager, creating it on the first acquisition
+    static VulkanRuntimeManager* acquire()
+    {
+        std::lock_guard<std::mutex> lock(instanceMutex());
+        auto& instance = instanceStorage();
+        if (instance.referenceCount++ == 0)
+        {
+            instance.manager = std::make_unique<VulkanRuntimeManager>();
+        }
+        return instance.manager.get();
+    }
+
+    /// Returns the runtime manager if it has been acquired, null otherwise
+    static VulkanRuntimeManager* current()
+    {
+        std::lock_guard<std::mutex> lock(instanceMutex());
+        return instanceStorage().manager.get();
+    }
+
+    /// Destroys the runtime manager once each acquisition has been released
+    static void release()
+    {
+        std::lock_guard<std::mutex> lock(instanceMutex());
+        auto& instance = instanceStorage();
+        if (instance.referenceCount > 0 && --instance.referenceCount == 0)
+        {
+            instance.manager.reset();
+        }
+    }
+
     VulkanRuntimeManager()
     {
         if (failed(vulkanRuntime.initRuntime()))
@@ -92,10 +191,72 @@ public:
         if (failed(vulkanRuntime.run()))
         {
             std::cerr << "runOnVulkan failed";
+            return;
+        }
+        DispatchTimingRecords::get().record(vulkanRuntime.getEntryPoint(), vulkanRuntime.getLastRunTimings());
+    }
+
+    void beginBatch()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (failed(vulkanRuntime.beginBatch()))
+        {
+            std::cerr << "beginVulkanBatch failed";
+        }
+    }
+
+    void submitBatch()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (failed(vulkanRuntime.endBatch()))
+        {
+            std::cerr << "submitVulkanBatch failed";
+        }
+    }
+
+    void* allocateResidentBuffer(uint64_t size)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        void* hostPointer = nullptr;
+        if (failed(vulkanRuntime.createResidentBuffer(size, hostPointer)))
+        {
+            std::cerr << "allocateVulkanResidentBuffer failed";
+            return nullptr;
         }
+        return hostPointer;
+    }
+
+    bool copyResidentBuffer(void* hostPointer, bool deviceToHost)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return succeeded(vulkanRuntime.copyResidentBuffer(hostPointer, deviceToHost));
+    }
+
+    void freeResidentBuffer(void* hostPointer)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        vulkanRuntime.destroyResidentBuffer(hostPointer);
     }
 
 private:
+    struct Instance
+    {
+        std::unique_ptr<VulkanRuntimeManager> manager;
+        uint64_t referenceCount{ 0 };
+    };
+
+    static Instance& instanceStorage()
+    {
+        static Instance instance;
+        return instance;
+    }
+
+    static std::mutex& instanceMutex()
+    {
+        static std::mutex instanceMutex;
+        return instanceMutex;
+    }
+
     VulkanRuntime vulkanRuntime;
     std::mutex mutex;
 };
@@ -124,16 +285,54 @@ void bindMemRef(void* vkRuntimeManager, DescriptorSetIndex setIndex, BindingInde
 }
 
 extern "C" {
-/// Initializes `VulkanRuntimeManager` and returns a pointer to it.
+/// Acquires the `VulkanRuntimeManager` of the process and returns a pointer to it.
 VULKAN_WRAPPER_SYMBOL_EXPORT void* initVulkan()
 {
-    return new VulkanRuntimeManager();
+    return VulkanRuntimeManager::acquire();
 }
 
-/// Deinitializes `VulkanRuntimeManager` by the given pointer.
+/// Releases the `VulkanRuntimeManager` acquired by `initVulkan`.
 VULKAN_WRAPPER_SYMBOL_EXPORT void deinitVulkan(void* vkRuntimeManager)
 {
-    delete reinterpret_cast<VulkanRuntimeManager*>(vkRuntimeManager);
+    VulkanRuntimeManager::release();
+}
+
+/// Allocates a buffer of the given size in bytes that stays on the device across kernel launches. The returned pointer
+/// identifies the buffer and gives the host access to its contents: an array argument passed as this pointer is bound
+/// to the buffer instead of being copied to the device before the launch and back after it. Returns null on failure.
+VULKAN_WRAPPER_SYMBOL_EXPORT void* allocateVulkanResidentBuffer(uint64_t size)
+{
+    // Each resident buffer keeps the runtime alive until it is freed
+    auto buffer = VulkanRuntimeManager::acquire()->allocateResidentBuffer(size);
+    if (!buffer)
+    {
+        VulkanRuntimeManager::release();
+    }
+    return buffer;
+}
+
+/// Copies the contents the host wrote to a resident buffer to the device. Returns 0 on failure.
+VULKAN_WRAPPER_SYMBOL_EXPORT uint32_t uploadVulkanResidentBuffer(void* buffer)
+{
+    auto manager = VulkanRuntimeManager::current();
+    return manager && manager->copyResidentBuffer(buffer, /*deviceToHost=*/false) ? 1 : 0;
+}
+
+/// Copies the contents of a resident buffer on the device to the host. Returns 0 on failure.
+VULKAN_WRAPPER_SYMBOL_EXPORT uint32_t downloadVulkanResidentBuffer(void* buffer)
+{
+    auto manager = VulkanRuntimeManager::current();
+    return manager && manager->copyResidentBuffer(buffer, /*deviceToHost=*/true) ? 1 : 0;
+}
+
+/// Frees a resident buffer allocated by `allocateVulkanResidentBuffer`.
+VULKAN_WRAPPER_SYMBOL_EXPORT void freeVulkanResidentBuffer(void* buffer)
+{
+    if (auto manager = VulkanRuntimeManager::current(); manager && buffer)
+    {
+        manager->freeResidentBuffer(buffer);
+        VulkanRuntimeManager::release();
+    }
 }
 
 VULKAN_WRAPPER_SYMBOL_EXPORT void runOnVulkan(void* vkRuntimeManager)
@@ -141,6 +340,21 @@ VULKAN_WRAPPER_SYMBOL_EXPORT void runOnVulkan(void* vkRuntimeManager)
     reinterpret_cast<VulkanRuntimeManager*>(vkRuntimeManager)->runOnVulkan();
 }
 
+/// Starts recording the following `runOnVulkan` launches into one command buffer, so that they are submitted together
+/// by `submitVulkanBatch`. The launches of a batch read each other's results on the device, with a pipeline barrier
+/// before a launch that binds an array bound by an earlier one, and the host arrays are only updated once the batch
+/// has been submitted.
+VULKAN_WRAPPER_SYMBOL_EXPORT void beginVulkanBatch(void* vkRuntimeManager)
+{
+    reinterpret_cast<VulkanRuntimeManager*>(vkRuntimeManager)->beginBatch();
+}
+
+/// Submits the launches recorded since `beginVulkanBatch`, waits for them and copies their results to the host.
+VULKAN_WRAPPER_SYMBOL_EXPORT void submitVulkanBatch(void* vkRuntimeManager)
+{
+    reinterpret_cast<VulkanRuntimeManager*>(vkRuntimeManager)->submitBatch();
+}
+
 VULKAN_WRAPPER_SYMBOL_EXPORT void setEntryPoint(void* vkRuntimeManager,
                                                 const char* entryPoint)
 {
@@ -168,6 +382,36 @@ void setRepeatedRunCharacteristics(void* vkRuntimeManager, uint32_t printTimings
     reinterpret_cast<VulkanRuntimeManager*>(vkRuntimeManager)
         ->setRepeatedRunCharacteristics(printTimings, warmupCount, runCount);
 }
+
+/// Returns the timings of the dispatches of the given kernel entry point, in microseconds, accumulated since the
+/// process started or the timings were last reset. Returns 0 if the kernel hasn't been dispatched.
+VULKAN_WRAPPER_SYMBOL_EXPORT
+uint32_t getVulkanDispatchTimings(const char* entryPoint, uint64_t* count, double* totalShaderTime, double* minShaderTime, double* maxShaderTime)
+{
+    VulkanDispatchTimings timings;
+    if (!DispatchTimingRecords::get().lookup(entryPoint, timings))
+        return 0;
+    *count = timings.count;
+    *totalShaderTime = timings.totalShaderTime;
+    *minShaderTime = timings.minShaderTime;
+    *maxShaderTime = timings.maxShaderTime;
+    return 1;
+}
+
+/// Writes the timings of the dispatches of all kernels to the given CSV file. Returns 0 if the file can't be written.
+VULKAN_WRAPPER_SYMBOL_EXPORT
+uint32_t writeVulkanDispatchTimings(const char* path)
+{
+    return DispatchTimingRecords::get().write(path) ? 1 : 0;
+}
+
+/// Clears the timings of the dispatches of all kernels.
+VULKAN_WRAPPER_SYMBOL_EXPORT
+void resetVulkanDispatchTimings()
+{
+    DispatchTimingRecords::get().reset();
+}
+
 /// Binds the given memref to the given descriptor set and descriptor
 /// index.
 #define DECLARE_BIND_MEMREF(size, type, typeName)                                                                       \